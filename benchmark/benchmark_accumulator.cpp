@@ -0,0 +1,73 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xaccumulator.hpp"
+#include "xtensor/xmath.hpp"
+
+namespace xt
+{
+    namespace accumulator
+    {
+        template <class E>
+        void accumulator_cumsum(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                xarray<double> res = cumsum(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void accumulator_cumsum_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                xarray<double> res = cumsum(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void accumulator_cumprod(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                xarray<double> res = cumprod(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void accumulator_nancumsum_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                xarray<double> res = nancumsum(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        xarray<double> a = ones<double>({ 10000000 });
+        xarray<double> u = ones<double>({ 10, 1000000 });
+        xarray<double> v = ones<double>({ 1000000, 10 });
+
+        BENCHMARK_CAPTURE(accumulator_cumsum, 10000000, a);
+        BENCHMARK_CAPTURE(accumulator_cumprod, 10000000, a);
+        BENCHMARK_CAPTURE(accumulator_cumsum_axis, 10x1000000/axis 0, u, 0);
+        BENCHMARK_CAPTURE(accumulator_cumsum_axis, 10x1000000/axis 1, u, 1);
+        BENCHMARK_CAPTURE(accumulator_cumsum_axis, 1000000x10/axis 0, v, 0);
+        BENCHMARK_CAPTURE(accumulator_cumsum_axis, 1000000x10/axis 1, v, 1);
+        BENCHMARK_CAPTURE(accumulator_nancumsum_axis, 10x1000000/axis 1, u, 1);
+        BENCHMARK_CAPTURE(accumulator_nancumsum_axis, 1000000x10/axis 0, v, 0);
+    }
+}
@@ -12,7 +12,9 @@
 #include "xtensor/xstorage.hpp"
 #include "xtensor/xutils.hpp"
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor.hpp"
 
 namespace xt
 {
@@ -105,6 +107,42 @@ namespace xt
         }
     }
 
+    // Adapted buffers starting `offset` elements after an aligned address,
+    // mixed with an aligned xtensor.
+    template <std::size_t offset>
+    void mixed_alignment_adapter(benchmark::State& state)
+    {
+        std::size_t size = static_cast<std::size_t>(state.range(0));
+        xt::uvector<double, xsimd::aligned_allocator<double, XTENSOR_DEFAULT_ALIGNMENT>> buffer(size + offset, 1.);
+        xtensor<double, 1> b = xt::ones<double>({size});
+        xtensor<double, 1> result = xt::zeros<double>({size});
+        std::array<std::size_t, 1> shape = {size};
+        auto aa = xt::adapt(buffer.data() + offset, size, xt::no_ownership(), shape);
+
+        for (auto _ : state)
+        {
+            xt::noalias(result) = 2. * aa + b;
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+
+    template <std::size_t offset>
+    void mixed_alignment_adapter_result(benchmark::State& state)
+    {
+        std::size_t size = static_cast<std::size_t>(state.range(0));
+        xt::uvector<double, xsimd::aligned_allocator<double, XTENSOR_DEFAULT_ALIGNMENT>> buffer(size + offset, 0.);
+        xtensor<double, 1> a = xt::ones<double>({size});
+        xtensor<double, 1> b = xt::ones<double>({size});
+        std::array<std::size_t, 1> shape = {size};
+        auto ar = xt::adapt(buffer.data() + offset, size, xt::no_ownership(), shape);
+
+        for (auto _ : state)
+        {
+            xt::noalias(ar) = 2. * a + b;
+            benchmark::DoNotOptimize(ar.data());
+        }
+    }
+
     using array_type = std::array<std::size_t, 4>;
     // using array_type_ll = std::array<int64_t, 4>;
     using array_type_ll = std::array<double, 4>;
@@ -132,6 +170,10 @@ namespace xt
     BENCHMARK_TEMPLATE(shape_array_adapter_result_transform, array_type);
     // // BENCHMARK_TEMPLATE(shape_array_adapter_result_2, array_type_ll);
     BENCHMARK_TEMPLATE(shape_no_adapter, array_type);
+    BENCHMARK_TEMPLATE(mixed_alignment_adapter, 0)->Range(64, 64 << 10);
+    BENCHMARK_TEMPLATE(mixed_alignment_adapter, 1)->Range(64, 64 << 10);
+    BENCHMARK_TEMPLATE(mixed_alignment_adapter_result, 0)->Range(64, 64 << 10);
+    BENCHMARK_TEMPLATE(mixed_alignment_adapter_result, 1)->Range(64, 64 << 10);
     // BENCHMARK_TEMPLATE(shape_no_adapter, std::vector<int64_t>);
     // BENCHMARK_TEMPLATE(shape_no_adapter, uvector_type_i64);
     // BENCHMARK_TEMPLATE(shape_no_adapter, uvector_type_i64_ra);
@@ -0,0 +1,248 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+// Reports, next to the timings, the allocations made by each operation:
+// the number of allocations, the bytes allocated and the peak of live
+// bytes per iteration. The benchmarks are built with XTENSOR_ALLOC_TRACKING
+// and the count policy, so that the buffers of the xtensor containers,
+// temporaries included, go through xt::tracking_allocator. Allocations made
+// with other allocators (e.g. std::vector in sort) are not counted, and the
+// timings include the cost of the tracking.
+
+#ifndef XTENSOR_ALLOC_TRACKING
+#error "benchmark_allocations.cpp must be compiled with XTENSOR_ALLOC_TRACKING"
+#endif
+
+#include <cstddef>
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xutils.hpp"
+
+namespace xt
+{
+    namespace allocations
+    {
+        // Tracks the allocations of the benchmark loop and reports them
+        // per iteration when destroyed. The inputs must be created before.
+        class allocation_scope
+        {
+        public:
+
+            explicit allocation_scope(benchmark::State& state)
+                : m_state(state)
+            {
+                alloc_tracking::reset_stats();
+                alloc_tracking::enable();
+            }
+
+            ~allocation_scope()
+            {
+                alloc_tracking::disable();
+                alloc_tracking::statistics s = alloc_tracking::stats();
+                m_state.counters["allocs"] = benchmark::Counter(static_cast<double>(s.allocations),
+                                                                benchmark::Counter::kAvgIterations);
+                m_state.counters["bytes"] = benchmark::Counter(static_cast<double>(s.allocated_bytes),
+                                                               benchmark::Counter::kAvgIterations,
+                                                               benchmark::Counter::OneK::kIs1024);
+                m_state.counters["peak"] = benchmark::Counter(static_cast<double>(s.peak_live_bytes),
+                                                              benchmark::Counter::kDefaults,
+                                                              benchmark::Counter::OneK::kIs1024);
+            }
+
+            allocation_scope(const allocation_scope&) = delete;
+            allocation_scope& operator=(const allocation_scope&) = delete;
+
+        private:
+
+            benchmark::State& m_state;
+        };
+
+        xarray<double> make_data(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            random::seed(0);
+            xarray<double> res = random::rand<double>({n, n});
+            return res;
+        }
+
+        /**************
+         * assignment *
+         **************/
+
+        void assign_temporary(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            xarray<double> res = a;
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                res = 2. * a + 1.;
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void assign_noalias(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            xarray<double> res = a;
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                noalias(res) = 2. * a + 1.;
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void assign_new(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = 2. * a + 1.;
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        /*********
+         * sorts *
+         *********/
+
+        template <std::ptrdiff_t Axis>
+        void sort_axis(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::sort(a, Axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void argsort_axis(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                auto res = xt::argsort(a, 0);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        /**************
+         * reductions *
+         **************/
+
+        void sum_axis(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::sum(a, {0});
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void variance_all(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::variance(a);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void variance_axis(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::variance(a, {0});
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        /****************
+         * manipulation *
+         ****************/
+
+        void concatenate_arrays(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            xarray<double> b = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::concatenate(xtuple(a, b), 0);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void stack_arrays(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            xarray<double> b = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::stack(xtuple(a, b), 0);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void transpose_eval(benchmark::State& state)
+        {
+            xarray<double> a = make_data(state);
+            allocation_scope scope(state);
+            for (auto _ : state)
+            {
+                auto res = xt::eval(xt::transpose(a));
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        BENCHMARK(assign_temporary)->Range(32, 1024);
+        BENCHMARK(assign_noalias)->Range(32, 1024);
+        BENCHMARK(assign_new)->Range(32, 1024);
+        BENCHMARK_TEMPLATE(sort_axis, 0)->Range(32, 1024);
+        BENCHMARK_TEMPLATE(sort_axis, 1)->Range(32, 1024);
+        BENCHMARK(argsort_axis)->Range(32, 1024);
+        BENCHMARK(sum_axis)->Range(32, 1024);
+        BENCHMARK(variance_all)->Range(32, 1024);
+        BENCHMARK(variance_axis)->Range(32, 1024);
+        BENCHMARK(concatenate_arrays)->Range(32, 1024);
+        BENCHMARK(stack_arrays)->Range(32, 1024);
+        BENCHMARK(transpose_eval)->Range(32, 1024);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "ALLOCATION TRACKING: allocs and bytes per iteration, peak live bytes\n\n";
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -9,12 +9,20 @@
 #ifndef BENCHMARK_ASSIGN_HPP
 #define BENCHMARK_ASSIGN_HPP
 
+#include <limits>
+#include <tuple>
+#include <vector>
+
 #include <benchmark/benchmark.h>
 
+#include "xtensor/xadapt.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
 
+#include "benchmark_counters.hpp"
+
 namespace xt
 {
     namespace assign
@@ -60,6 +68,15 @@ namespace xt
             init_benchmark_data(lhs, rhs, size0, size1);
         }
 
+        // Bytes moved by one iteration of a loop reading n_in arrays shaped
+        // like res and writing res. Write allocations are not counted, so
+        // that the roofline counter shows the benefit of streaming stores.
+        template <class E>
+        inline std::size_t assign_bytes(const E& res, std::size_t n_in)
+        {
+            return (n_in + 1) * res.size() * sizeof(typename E::value_type);
+        }
+
         template <class E>
         inline auto assign_c_assign(benchmark::State& state)
         {
@@ -68,6 +85,7 @@ namespace xt
             E x, y, res;
             init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
 
+            bench::counter_scope counters(state, assign_bytes(res, 2), res.size());
             for (auto _ : state)
             {
                 size_type csize = x.size();
@@ -84,6 +102,7 @@ namespace xt
         {
             E x, y, res;
             init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            bench::counter_scope counters(state, assign_bytes(res, 2), res.size());
             for (auto _ : state)
             {
                 xt::noalias(res) = 3.0 * x - 2.0 * y;
@@ -99,6 +118,7 @@ namespace xt
             E x, y, res;
             init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
 
+            bench::counter_scope counters(state, assign_bytes(res, 1), res.size());
             for (auto _ : state)
             {
                 size_type csize = x.size();
@@ -115,6 +135,7 @@ namespace xt
         {
             E x, y, res;
             init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            bench::counter_scope counters(state, assign_bytes(res, 1), res.size());
             for (auto _ : state)
             {
                 xt::noalias(res) = 3.0 * x;
@@ -127,6 +148,7 @@ namespace xt
         {
             E x, y, res;
             init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            bench::counter_scope counters(state, assign_bytes(res, 2), res.size());
             for (auto _ : state)
             {
                 xt::noalias(res) = y * x;
@@ -142,6 +164,7 @@ namespace xt
             E x, y, res;
             init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
 
+            bench::counter_scope counters(state, assign_bytes(res, 2), res.size());
             for (auto _ : state)
             {
                 size_type csize = x.size();
@@ -210,6 +233,79 @@ namespace xt
             }
         }
 
+        // Destination and first operand are aligned, the second operand is an
+        // adapted std::vector whose alignment is only known at runtime.
+        template <class E>
+        inline auto assign_x_adapted_operand(benchmark::State& state)
+        {
+            E x, y, res;
+            init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            std::vector<double> buffer(y.storage().cbegin(), y.storage().cend());
+            auto ay = xt::adapt(buffer, y.shape());
+            for (auto _ : state)
+            {
+                xt::noalias(res) = 3.0 * x - 2.0 * ay;
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        inline auto assign_x_cached_store(benchmark::State& state)
+        {
+            E x, y, res;
+            init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            std::size_t threshold = exec::streaming_threshold();
+            exec::set_streaming_threshold(std::numeric_limits<std::size_t>::max());
+            bench::counter_scope counters(state, assign_bytes(res, 2), res.size());
+            for (auto _ : state)
+            {
+                xt::noalias(res) = 3.0 * x - 2.0 * y;
+                benchmark::DoNotOptimize(res.data());
+            }
+            exec::set_streaming_threshold(threshold);
+        }
+
+        template <class E>
+        inline auto assign_x_streaming_store(benchmark::State& state)
+        {
+            E x, y, res;
+            init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            bench::counter_scope counters(state, assign_bytes(res, 2), res.size());
+            for (auto _ : state)
+            {
+                xt::noalias(res).assign(3.0 * x - 2.0 * y, exec::streaming());
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        inline auto assign_x_separate(benchmark::State& state)
+        {
+            E x, y, res;
+            init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            E res2 = res;
+            for (auto _ : state)
+            {
+                xt::noalias(res) = 3.0 * x - 2.0 * y;
+                xt::noalias(res2) = x * y + 1.0;
+                benchmark::DoNotOptimize(res.data());
+                benchmark::DoNotOptimize(res2.data());
+            }
+        }
+
+        template <class E>
+        inline auto assign_x_assign_all(benchmark::State& state)
+        {
+            E x, y, res;
+            init_xtensor_benchmark(x, y, res, state.range(0), state.range(0));
+            E res2 = res;
+            for (auto _ : state)
+            {
+                xt::assign_all(std::tie(res, res2), std::make_tuple(3.0 * x - 2.0 * y, x * y + 1.0));
+                benchmark::DoNotOptimize(res.data());
+                benchmark::DoNotOptimize(res2.data());
+            }
+        }
 
         BENCHMARK_TEMPLATE(assign_c_assign, xt::xtensor<double, 2>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_x_assign, xt::xtensor<double, 2>)->Range(32, 32<<3);
@@ -224,6 +320,11 @@ namespace xt
         BENCHMARK_TEMPLATE(assign_x_assign, xt::xtensor<double, 2, layout_type::dynamic>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_c_scalar_computed, xt::xtensor<double, 2>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_x_scalar_computed, xt::xtensor<double, 2>)->Range(32, 32<<3);
+        BENCHMARK_TEMPLATE(assign_x_adapted_operand, xt::xtensor<double, 2>)->Range(32, 32<<3);
+        BENCHMARK_TEMPLATE(assign_x_cached_store, xt::xtensor<double, 2>)->Range(1024, 4096);
+        BENCHMARK_TEMPLATE(assign_x_streaming_store, xt::xtensor<double, 2>)->Range(1024, 4096);
+        BENCHMARK_TEMPLATE(assign_x_separate, xt::xtensor<double, 2>)->Range(1024, 2048);
+        BENCHMARK_TEMPLATE(assign_x_assign_all, xt::xtensor<double, 2>)->Range(1024, 2048);
     }
 }
 
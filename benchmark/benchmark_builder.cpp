@@ -8,6 +8,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
@@ -194,6 +196,64 @@ namespace xt
         }
     }
 
+    template <class T>
+    inline auto builder_concatenate(benchmark::State& state)
+    {
+        T a = xt::ones<double>({300, 400});
+        T b = xt::ones<double>({300, 400}) * 2.;
+        T c = xt::ones<double>({300, 400}) * 3.;
+        for (auto _ : state)
+        {
+            T res = xt::concatenate(xt::xtuple(a, b, c), std::size_t(state.range(0)));
+            benchmark::DoNotOptimize(res.storage().data());
+        }
+    }
+
+    template <class T>
+    inline auto builder_stack(benchmark::State& state)
+    {
+        xt::xtensor<double, 1> a = xt::ones<double>({100000});
+        xt::xtensor<double, 1> b = a, c = a, d = a;
+        for (auto _ : state)
+        {
+            T res = xt::stack(xt::xtuple(a, b, c, d), std::size_t(state.range(0)));
+            benchmark::DoNotOptimize(res.storage().data());
+        }
+    }
+
+    template <class T>
+    inline auto builder_concatenate_vector(benchmark::State& state)
+    {
+        std::vector<T> v = {xt::ones<double>({300, 400}), xt::ones<double>({300, 400}) * 2., xt::ones<double>({300, 400}) * 3.};
+        for (auto _ : state)
+        {
+            T res = xt::concatenate(v, std::size_t(state.range(0)));
+            benchmark::DoNotOptimize(res.storage().data());
+        }
+    }
+
+    template <class T>
+    inline auto builder_stack_vector(benchmark::State& state)
+    {
+        std::vector<xt::xtensor<double, 1>> v(4, xt::ones<double>({100000}));
+        for (auto _ : state)
+        {
+            T res = xt::stack(v, std::size_t(state.range(0)));
+            benchmark::DoNotOptimize(res.storage().data());
+        }
+    }
+
+    template <class T>
+    inline auto builder_linspace_expr(benchmark::State& state)
+    {
+        T res = T::from_shape({10000});
+        for (auto _ : state)
+        {
+            xt::noalias(res) = xt::sin(xt::linspace(0., 10., 10000)) * 2.;
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+
     BENCHMARK_TEMPLATE(builder_xarange, xarray<double>);
     BENCHMARK_TEMPLATE(builder_xarange, xtensor<double, 1>);
     BENCHMARK_TEMPLATE(builder_xarange_manual, xarray<double>);
@@ -215,4 +275,14 @@ namespace xt
     BENCHMARK(builder_ones_expr_fill);
     BENCHMARK(builder_ones_expr_for);
     BENCHMARK(builder_std_fill);
+    BENCHMARK_TEMPLATE(builder_linspace_expr, xarray<double>);
+    BENCHMARK_TEMPLATE(builder_linspace_expr, xtensor<double, 1>);
+    BENCHMARK_TEMPLATE(builder_concatenate, xarray<double>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_concatenate, xtensor<double, 2>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_stack, xarray<double>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_stack, xtensor<double, 2>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_concatenate_vector, xarray<double>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_concatenate_vector, xtensor<double, 2>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_stack_vector, xarray<double>)->Arg(0)->Arg(1);
+    BENCHMARK_TEMPLATE(builder_stack_vector, xtensor<double, 2>)->Arg(0)->Arg(1);
 }
@@ -0,0 +1,253 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xblockwise_reducer.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunked_array.hpp"
+#include "xtensor/xchunked_view.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xreducer.hpp"
+
+namespace xt
+{
+    namespace chunked
+    {
+        // The chunked cases run on a N x N array split in square chunks
+        // whose edge is range(0); the xarray cases do the same operation on
+        // an in-memory array, so that the difference is the cost of the
+        // chunk abstraction for that chunk shape.
+        constexpr std::size_t N = 1024;
+
+        std::vector<std::size_t> shape()
+        {
+            return {N, N};
+        }
+
+        std::vector<std::size_t> chunk_shape(benchmark::State& state)
+        {
+            std::size_t edge = static_cast<std::size_t>(state.range(0));
+            return {edge, edge};
+        }
+
+        xarray<double> make_data()
+        {
+            xarray<double> res = arange<double>(double(N * N)).reshape({N, N});
+            return res;
+        }
+
+        void set_bytes(benchmark::State& state, std::size_t arrays)
+        {
+            state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(arrays * N * N * sizeof(double)));
+        }
+
+        template <class E>
+        void access(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                double s = 0.;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    for (std::size_t j = 0; j < N; ++j)
+                    {
+                        s += x(i, j);
+                    }
+                }
+                benchmark::DoNotOptimize(s);
+            }
+            set_bytes(state, 1);
+        }
+
+        template <class E>
+        void iterate(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                double s = 0.;
+                for (auto v : x)
+                {
+                    s += v;
+                }
+                benchmark::DoNotOptimize(s);
+            }
+            set_bytes(state, 1);
+        }
+
+        void chunked_access(benchmark::State& state)
+        {
+            auto x = chunked_array<double>(shape(), chunk_shape(state));
+            noalias(x) = make_data();
+            access(state, x);
+        }
+
+        void xarray_access(benchmark::State& state)
+        {
+            access(state, make_data());
+        }
+
+        void chunked_iterate(benchmark::State& state)
+        {
+            auto x = chunked_array<double>(shape(), chunk_shape(state));
+            noalias(x) = make_data();
+            iterate(state, x);
+        }
+
+        void xarray_iterate(benchmark::State& state)
+        {
+            iterate(state, make_data());
+        }
+
+        // Chunk-wise assignment of an expression to a chunked array
+        void chunked_assign(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            auto res = chunked_array<double>(shape(), chunk_shape(state));
+            for (auto _ : state)
+            {
+                noalias(res) = 2. * a + 1.;
+                benchmark::ClobberMemory();
+            }
+            set_bytes(state, 2);
+        }
+
+        // Same assignment to an in-memory array, through a chunked view
+        void chunked_view_assign(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            xarray<double> res = xarray<double>::from_shape(shape());
+            auto cs = chunk_shape(state);
+            for (auto _ : state)
+            {
+                as_chunked(res, cs) = 2. * a + 1.;
+                benchmark::ClobberMemory();
+            }
+            set_bytes(state, 2);
+        }
+
+        void xarray_assign(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            xarray<double> res = xarray<double>::from_shape(shape());
+            for (auto _ : state)
+            {
+                noalias(res) = 2. * a + 1.;
+                benchmark::ClobberMemory();
+            }
+            set_bytes(state, 2);
+        }
+
+        void chunked_sum(benchmark::State& state)
+        {
+            auto x = chunked_array<double>(shape(), chunk_shape(state));
+            noalias(x) = make_data();
+            for (auto _ : state)
+            {
+                double s = sum(x)();
+                benchmark::DoNotOptimize(s);
+            }
+            set_bytes(state, 1);
+        }
+
+        // Reduction over all the axes, then over axis 1, block after block
+        void blockwise_sum(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            auto cs = chunk_shape(state);
+            auto res = xarray<double>::from_shape(blockwise::sum(a, cs).shape());
+            for (auto _ : state)
+            {
+                blockwise::sum(a, cs).assign_to(res);
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_bytes(state, 1);
+        }
+
+        void blockwise_sum_axis(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            auto cs = chunk_shape(state);
+            auto res = xarray<double>::from_shape(blockwise::sum(a, cs, {1}).shape());
+            for (auto _ : state)
+            {
+                blockwise::sum(a, cs, {1}).assign_to(res);
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_bytes(state, 1);
+        }
+
+        void blockwise_norm_l2(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            auto cs = chunk_shape(state);
+            auto res = xarray<double>::from_shape(blockwise::norm_l2(a, cs).shape());
+            for (auto _ : state)
+            {
+                blockwise::norm_l2(a, cs).assign_to(res);
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_bytes(state, 1);
+        }
+
+        void xarray_sum(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            for (auto _ : state)
+            {
+                xarray<double> res = sum(a, evaluation_strategy::immediate);
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_bytes(state, 1);
+        }
+
+        void xarray_sum_axis(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            for (auto _ : state)
+            {
+                xarray<double> res = sum(a, {1}, evaluation_strategy::immediate);
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_bytes(state, 1);
+        }
+
+        void xarray_norm_l2(benchmark::State& state)
+        {
+            xarray<double> a = make_data();
+            for (auto _ : state)
+            {
+                xarray<double> res = norm_l2(a);
+                benchmark::DoNotOptimize(res.data());
+            }
+            set_bytes(state, 1);
+        }
+
+        BENCHMARK(chunked_access)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(xarray_access);
+        BENCHMARK(chunked_iterate)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(xarray_iterate);
+        BENCHMARK(chunked_assign)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(chunked_view_assign)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(xarray_assign);
+        BENCHMARK(chunked_sum)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(blockwise_sum)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(blockwise_sum_axis)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(blockwise_norm_l2)->RangeMultiplier(4)->Range(16, 1024);
+        BENCHMARK(xarray_sum);
+        BENCHMARK(xarray_sum_axis);
+        BENCHMARK(xarray_norm_l2);
+    }
+}
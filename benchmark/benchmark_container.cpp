@@ -8,11 +8,17 @@
 
 #include <cstddef>
 #include <chrono>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xchunked_array.hpp"
+#include "xtensor/xfixed.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xreducer.hpp"
 #include "xtensor/xtensor.hpp"
 
 namespace xt
@@ -109,4 +115,213 @@ namespace xt
         BENCHMARK_TEMPLATE(container_indexing, xtensor_container<std::vector<double>, 1>)->Arg(1000);
         BENCHMARK_TEMPLATE(container_indexing, xtensor_container<xt::uvector<double>, 1>)->Arg(1000);
     }
+
+    namespace chunked_access
+    {
+        inline auto make_chunked(std::size_t n, std::size_t chunk)
+        {
+            std::vector<std::size_t> shape = {n, n};
+            std::vector<std::size_t> chunk_shape = {chunk, chunk};
+            auto a = chunked_array<double>(shape, chunk_shape);
+            a = xt::ones<double>({n, n});
+            return a;
+        }
+
+        inline void chunked_random_access(benchmark::State& state, std::size_t chunk)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto a = make_chunked(n, chunk);
+            std::mt19937 gen(0);
+            std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+            std::vector<std::size_t> idx(2 * 4096);
+            for (auto& i : idx)
+            {
+                i = dist(gen);
+            }
+            for (auto _ : state)
+            {
+                double sum = 0.;
+                for (std::size_t k = 0; k < idx.size(); k += 2)
+                {
+                    sum += a(idx[k], idx[k + 1]);
+                }
+                benchmark::DoNotOptimize(sum);
+            }
+        }
+
+        inline void chunked_iteration(benchmark::State& state, std::size_t chunk)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto a = make_chunked(n, chunk);
+            for (auto _ : state)
+            {
+                double sum = 0.;
+                for (auto it = a.cbegin(); it != a.cend(); ++it)
+                {
+                    sum += *it;
+                }
+                benchmark::DoNotOptimize(sum);
+            }
+        }
+
+        BENCHMARK_CAPTURE(chunked_random_access, power_of_two, 64)->Arg(1000);
+        BENCHMARK_CAPTURE(chunked_random_access, arbitrary, 100)->Arg(1000);
+        BENCHMARK_CAPTURE(chunked_iteration, power_of_two, 64)->Arg(1000);
+        BENCHMARK_CAPTURE(chunked_iteration, arbitrary, 100)->Arg(1000);
+    }
+
+    namespace container_kind
+    {
+        // The same N x N operations on xtensor_fixed, xtensor and xarray,
+        // to compare the compile-time shapes with the runtime ones across
+        // shape sizes. Each case is named after the container kind and N.
+
+        template <std::size_t N>
+        struct fixed_kind
+        {
+            using type = xtensor_fixed<double, xshape<N, N>>;
+
+            static type make()
+            {
+                return type();
+            }
+        };
+
+        template <std::size_t N>
+        struct tensor_kind
+        {
+            using type = xtensor<double, 2>;
+
+            static type make()
+            {
+                return type::from_shape({N, N});
+            }
+        };
+
+        template <std::size_t N>
+        struct array_kind
+        {
+            using type = xarray<double>;
+
+            static type make()
+            {
+                return type::from_shape({N, N});
+            }
+        };
+
+        template <class K>
+        inline auto make_filled(double start)
+        {
+            auto res = K::make();
+            double v = start;
+            for (auto& e : res)
+            {
+                e = v;
+                v += 0.5;
+            }
+            return res;
+        }
+
+        template <class K>
+        inline void kind_creation(benchmark::State& state)
+        {
+            for (auto _ : state)
+            {
+                auto res = K::make();
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class K>
+        inline void kind_access(benchmark::State& state)
+        {
+            auto a = make_filled<K>(1.);
+            std::size_t n = a.shape()[0];
+            for (auto _ : state)
+            {
+                double sum = 0.;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        sum += a(i, j);
+                    }
+                }
+                benchmark::DoNotOptimize(sum);
+            }
+        }
+
+        template <class K>
+        inline void kind_elementwise(benchmark::State& state)
+        {
+            auto a = make_filled<K>(1.);
+            auto b = make_filled<K>(2.);
+            auto res = K::make();
+            for (auto _ : state)
+            {
+                noalias(res) = 2.5 * a + b;
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class K>
+        inline void kind_eval(benchmark::State& state)
+        {
+            auto a = make_filled<K>(1.);
+            auto b = make_filled<K>(2.);
+            for (auto _ : state)
+            {
+                auto res = xt::eval(2.5 * a + b);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class K>
+        inline void kind_sum(benchmark::State& state)
+        {
+            auto a = make_filled<K>(1.);
+            for (auto _ : state)
+            {
+                double res = xt::sum(a)();
+                benchmark::DoNotOptimize(res);
+            }
+        }
+
+        template <class K>
+        inline void kind_sum_axis(benchmark::State& state)
+        {
+            auto a = make_filled<K>(1.);
+            for (auto _ : state)
+            {
+                auto res = xt::eval(xt::sum(a, {1}));
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+#define XTENSOR_CONTAINER_KIND_BENCHMARKS(NAME)             \
+        BENCHMARK_TEMPLATE(NAME, fixed_kind<3>);            \
+        BENCHMARK_TEMPLATE(NAME, tensor_kind<3>);           \
+        BENCHMARK_TEMPLATE(NAME, array_kind<3>);            \
+        BENCHMARK_TEMPLATE(NAME, fixed_kind<4>);            \
+        BENCHMARK_TEMPLATE(NAME, tensor_kind<4>);           \
+        BENCHMARK_TEMPLATE(NAME, array_kind<4>);            \
+        BENCHMARK_TEMPLATE(NAME, fixed_kind<8>);            \
+        BENCHMARK_TEMPLATE(NAME, tensor_kind<8>);           \
+        BENCHMARK_TEMPLATE(NAME, array_kind<8>);            \
+        BENCHMARK_TEMPLATE(NAME, fixed_kind<16>);           \
+        BENCHMARK_TEMPLATE(NAME, tensor_kind<16>);          \
+        BENCHMARK_TEMPLATE(NAME, array_kind<16>);           \
+        BENCHMARK_TEMPLATE(NAME, fixed_kind<64>);           \
+        BENCHMARK_TEMPLATE(NAME, tensor_kind<64>);          \
+        BENCHMARK_TEMPLATE(NAME, array_kind<64>)
+
+        XTENSOR_CONTAINER_KIND_BENCHMARKS(kind_creation);
+        XTENSOR_CONTAINER_KIND_BENCHMARKS(kind_access);
+        XTENSOR_CONTAINER_KIND_BENCHMARKS(kind_elementwise);
+        XTENSOR_CONTAINER_KIND_BENCHMARKS(kind_eval);
+        XTENSOR_CONTAINER_KIND_BENCHMARKS(kind_sum);
+        XTENSOR_CONTAINER_KIND_BENCHMARKS(kind_sum_axis);
+
+#undef XTENSOR_CONTAINER_KIND_BENCHMARKS
+    }
 }
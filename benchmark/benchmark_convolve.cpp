@@ -0,0 +1,97 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace convolution
+    {
+        // Former implementation, kept as a reference
+        template <class T>
+        inline xtensor<T, 1> naive_convolve_full(const xtensor<T, 1>& a, const xtensor<T, 1>& v)
+        {
+            std::size_t const na = a.size();
+            std::size_t const nv = v.size();
+            std::size_t const n = na + nv - 1;
+            xtensor<T, 1> out = zeros<T>({n});
+            for (std::size_t i = 0; i < n; i++)
+            {
+                std::size_t const jmn = (i >= nv - 1) ? i - (nv - 1) : 0;
+                std::size_t const jmx = (i < na - 1) ? i : na - 1;
+                for (std::size_t j = jmn; j <= jmx; ++j)
+                {
+                    out(i) += a(j) * v(i - j);
+                }
+            }
+            return out;
+        }
+
+        template <class T>
+        inline void make_operands(benchmark::State& state, xtensor<T, 1>& a, xtensor<T, 1>& v)
+        {
+            std::size_t na = static_cast<std::size_t>(state.range(0));
+            std::size_t nv = static_cast<std::size_t>(state.range(1));
+            a = xt::cos(xt::arange<T>(static_cast<T>(na)) * T(0.01));
+            v = xt::arange<T>(static_cast<T>(nv)) / static_cast<T>(nv);
+        }
+
+        template <class T>
+        void convolve_naive(benchmark::State& state)
+        {
+            xtensor<T, 1> a, v;
+            make_operands(state, a, v);
+            for (auto _ : state)
+            {
+                auto res = naive_convolve_full(a, v);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void convolve_full(benchmark::State& state)
+        {
+            xtensor<T, 1> a, v;
+            make_operands(state, a, v);
+            for (auto _ : state)
+            {
+                auto res = xt::convolve(a, v, convolve_mode::full());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void convolve_valid(benchmark::State& state)
+        {
+            xtensor<T, 1> a, v;
+            make_operands(state, a, v);
+            for (auto _ : state)
+            {
+                auto res = xt::convolve(a, v, convolve_mode::valid());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // Short kernels use the direct convolution, long ones the FFT
+        BENCHMARK_TEMPLATE(convolve_naive, double)->Args({1 << 16, 16})->Args({1 << 16, 256})->Args({1 << 16, 4096});
+        BENCHMARK_TEMPLATE(convolve_full, double)->Args({1 << 16, 16})->Args({1 << 16, 256})->Args({1 << 16, 4096});
+        BENCHMARK_TEMPLATE(convolve_full, float)->Args({1 << 16, 16})->Args({1 << 16, 256})->Args({1 << 16, 4096});
+        BENCHMARK_TEMPLATE(convolve_valid, double)->Args({1 << 20, 16})->Args({1 << 20, 64})->Args({1 << 20, 4096});
+        BENCHMARK_TEMPLATE(convolve_full, int)->Args({1 << 16, 16})->Args({1 << 16, 256});
+    }
+}
@@ -0,0 +1,285 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_COUNTERS_HPP
+#define BENCHMARK_COUNTERS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#if defined(XTENSOR_BENCHMARK_PERF_COUNTERS) && defined(__linux__)
+#define XTENSOR_BENCHMARK_HAS_PERF_EVENTS
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace xt
+{
+    namespace bench
+    {
+        /***************
+         * perf_events *
+         ***************/
+
+        struct counter_values
+        {
+            std::uint64_t cycles = 0;
+            std::uint64_t llc_misses = 0;
+        };
+
+        // Group of the cycle and last level cache miss counters of the
+        // calling thread, in user space. valid() is false if the kernel
+        // refuses them (perf_event_paranoid, virtual machines...) or if the
+        // benchmarks are built without XTENSOR_BENCHMARK_PERF_COUNTERS.
+        class perf_events
+        {
+        public:
+
+            perf_events();
+            ~perf_events();
+
+            perf_events(const perf_events&) = delete;
+            perf_events& operator=(const perf_events&) = delete;
+
+            bool valid() const noexcept;
+
+            void start();
+            counter_values stop();
+
+        private:
+
+            int m_cycles;
+            int m_misses;
+        };
+
+        perf_events& thread_perf_events();
+
+        /*******************
+         * roofline models *
+         *******************/
+
+        double stream_bandwidth();
+
+        /*****************
+         * counter_scope *
+         *****************/
+
+        // Measures the benchmark loop following its construction and, when
+        // destroyed, sets the counters of state:
+        // - GB/s: memory traffic per second, from the bytes moved by one
+        //   iteration;
+        // - roofline: the same bandwidth relative to the STREAM triad, close
+        //   to 1 for bandwidth-bound kernels;
+        // - cycles/elem, LLC-miss/elem: when the hardware counters are available.
+        class counter_scope
+        {
+        public:
+
+            counter_scope(benchmark::State& state, std::size_t bytes, std::size_t elements);
+            ~counter_scope();
+
+            counter_scope(const counter_scope&) = delete;
+            counter_scope& operator=(const counter_scope&) = delete;
+
+        private:
+
+            using clock_type = std::chrono::steady_clock;
+
+            benchmark::State& m_state;
+            std::size_t m_bytes;
+            std::size_t m_elements;
+            clock_type::time_point m_start;
+        };
+
+        /******************************
+         * perf_events implementation *
+         ******************************/
+
+#if defined(XTENSOR_BENCHMARK_HAS_PERF_EVENTS)
+        namespace detail
+        {
+            inline int open_perf_event(std::uint64_t config, int group)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = config;
+                attr.disabled = group == -1 ? 1 : 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+                return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+            }
+        }
+
+        inline perf_events::perf_events()
+            : m_cycles(detail::open_perf_event(PERF_COUNT_HW_CPU_CYCLES, -1)), m_misses(-1)
+        {
+            if (m_cycles != -1)
+            {
+                m_misses = detail::open_perf_event(PERF_COUNT_HW_CACHE_MISSES, m_cycles);
+                if (m_misses == -1)
+                {
+                    close(m_cycles);
+                    m_cycles = -1;
+                }
+            }
+        }
+
+        inline perf_events::~perf_events()
+        {
+            if (valid())
+            {
+                close(m_misses);
+                close(m_cycles);
+            }
+        }
+
+        inline bool perf_events::valid() const noexcept
+        {
+            return m_cycles != -1;
+        }
+
+        inline void perf_events::start()
+        {
+            if (valid())
+            {
+                ioctl(m_cycles, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(m_cycles, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+        }
+
+        inline counter_values perf_events::stop()
+        {
+            counter_values res;
+            if (valid())
+            {
+                ioctl(m_cycles, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+                // PERF_FORMAT_GROUP: number of events, then their values
+                std::uint64_t data[3] = {0, 0, 0};
+                if (read(m_cycles, data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[0] == 2)
+                {
+                    res.cycles = data[1];
+                    res.llc_misses = data[2];
+                }
+            }
+            return res;
+        }
+#else
+        inline perf_events::perf_events()
+            : m_cycles(-1), m_misses(-1)
+        {
+        }
+
+        inline perf_events::~perf_events()
+        {
+        }
+
+        inline bool perf_events::valid() const noexcept
+        {
+            return false;
+        }
+
+        inline void perf_events::start()
+        {
+        }
+
+        inline counter_values perf_events::stop()
+        {
+            return counter_values();
+        }
+#endif
+
+        inline perf_events& thread_perf_events()
+        {
+            static thread_local perf_events events;
+            return events;
+        }
+
+        /**********************************
+         * roofline models implementation *
+         **********************************/
+
+        // Best bandwidth of the STREAM triad a = b + s * c, in bytes per
+        // second, over arrays much larger than the last level cache. It is
+        // measured once, on first use.
+        inline double stream_bandwidth()
+        {
+            static const double bandwidth = []()
+            {
+                const std::size_t n = std::size_t(1) << 23;
+                std::vector<double> a(n, 0.), b(n, 1.), c(n, 2.);
+                double s = 3.;
+                double best = 0.;
+                for (int k = 0; k < 5; ++k)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        a[i] = b[i] + s * c[i];
+                    }
+                    benchmark::DoNotOptimize(a.data());
+                    benchmark::ClobberMemory();
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    best = (std::max)(best, 3. * sizeof(double) * static_cast<double>(n) / seconds);
+                }
+                return best;
+            }();
+            return bandwidth;
+        }
+
+        /********************************
+         * counter_scope implementation *
+         ********************************/
+
+        /**
+         * @param state the state of the benchmark
+         * @param bytes the bytes read and written by one iteration
+         * @param elements the elements processed by one iteration
+         */
+        inline counter_scope::counter_scope(benchmark::State& state, std::size_t bytes, std::size_t elements)
+            : m_state(state), m_bytes(bytes), m_elements(elements)
+        {
+            stream_bandwidth();
+            thread_perf_events().start();
+            m_start = clock_type::now();
+        }
+
+        inline counter_scope::~counter_scope()
+        {
+            double seconds = std::chrono::duration<double>(clock_type::now() - m_start).count();
+            counter_values values = thread_perf_events().stop();
+            double iterations = static_cast<double>(m_state.iterations());
+            if (iterations == 0. || seconds <= 0.)
+            {
+                return;
+            }
+            double bandwidth = static_cast<double>(m_bytes) * iterations / seconds;
+            m_state.counters["GB/s"] = bandwidth * 1e-9;
+            m_state.counters["roofline"] = bandwidth / stream_bandwidth();
+            if (thread_perf_events().valid() && m_elements != 0)
+            {
+                double elements = static_cast<double>(m_elements) * iterations;
+                m_state.counters["cycles/elem"] = static_cast<double>(values.cycles) / elements;
+                m_state.counters["LLC-miss/elem"] = static_cast<double>(values.llc_misses) / elements;
+            }
+        }
+    }
+}
+
+#endif
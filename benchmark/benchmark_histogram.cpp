@@ -0,0 +1,130 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xhistogram.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace histogram_bench
+    {
+        template <class T>
+        xtensor<T, 1> make_data(std::size_t n, double upper)
+        {
+            xtensor<T, 1> res = xt::cast<T>(xt::fmod(arange<double>(static_cast<double>(n)) * 7919., upper));
+            return res;
+        }
+
+        // range(0) is the number of elements, range(1) the number of bins
+        template <class T>
+        void histogram_bins(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t bins = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_data<T>(n, 10000.);
+            for (auto _ : state)
+            {
+                xtensor<double, 1> res = xt::histogram(x, bins);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void histogram_range(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t bins = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_data<T>(n, 10000.);
+            for (auto _ : state)
+            {
+                xtensor<double, 1> res = xt::histogram(x, bins, T(0), T(10000));
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void histogram_edges(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t bins = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_data<T>(n, 10000.);
+            // Uneven edges, which cannot be found by a division
+            xtensor<T, 1> edges = xt::cast<T>(xt::square(xt::linspace<double>(0., 100., bins + 1)));
+            for (auto _ : state)
+            {
+                xtensor<double, 1> res = xt::histogram(x, edges);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void histogram_weights_density(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t bins = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_data<T>(n, 10000.);
+            xtensor<T, 1> weights = make_data<T>(n, 3.);
+            for (auto _ : state)
+            {
+                xtensor<double, 1> res = xt::histogram(x, bins, weights, T(0), T(10000), true);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // range(0) is the number of elements, range(1) the number of bins
+        template <class T>
+        void histogram_bincount(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 1> x = make_data<T>(n, static_cast<double>(state.range(1)));
+            for (auto _ : state)
+            {
+                auto res = xt::bincount(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void histogram_bincount_weights(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 1> x = make_data<T>(n, static_cast<double>(state.range(1)));
+            xtensor<double, 1> weights = make_data<double>(n, 3.);
+            for (auto _ : state)
+            {
+                auto res = xt::bincount(x, weights);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        BENCHMARK_TEMPLATE(histogram_bins, float)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_bins, double)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_range, float)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_range, double)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_edges, float)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_edges, double)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_weights_density, double)->Args({1 << 10, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000});
+        BENCHMARK_TEMPLATE(histogram_bincount, std::int32_t)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 16});
+        BENCHMARK_TEMPLATE(histogram_bincount, std::int64_t)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 16});
+        BENCHMARK_TEMPLATE(histogram_bincount_weights, std::int32_t)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 16});
+    }
+}
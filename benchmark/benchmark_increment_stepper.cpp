@@ -10,6 +10,7 @@
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
 
 #define SHAPE 30, 30
 #define RANGE 3, 100
@@ -44,6 +45,32 @@ namespace xt
         }
         BENCHMARK(stepper_stepper)->Range(RANGE);
 
+        void stepper_stepper_static(benchmark::State& state)
+        {
+            std::array<std::size_t, 3> shape = {SHAPE, std::size_t(state.range(0))};
+            xt::xtensor<double, 3> a = xt::random::rand<double>(shape);
+            xt::xtensor<double, 3> b = xt::random::rand<double>(shape);
+            volatile double c = 0;
+            for (auto _ : state)
+            {
+                auto end = compute_size(shape);
+                auto it = a.stepper_begin(shape);
+                auto bit = b.stepper_begin(shape);
+
+                std::array<std::size_t, 3> index = {};
+                std::array<std::size_t, 3> bindex = {};
+
+                for (std::size_t i = 0; i < end; ++i)
+                {
+                    c += *it + *bit;
+                    stepper_tools<layout_type::row_major>::increment_stepper(bit, bindex, shape);
+                    stepper_tools<layout_type::row_major>::increment_stepper(it, index, shape);
+                }
+                benchmark::DoNotOptimize(c);
+            }
+        }
+        BENCHMARK(stepper_stepper_static)->Range(RANGE);
+
         void stepper_stepper_ref(benchmark::State& state)
         {
             std::vector<std::size_t> shape = {SHAPE, std::size_t(state.range(0))};
@@ -0,0 +1,208 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xcsv.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace io
+    {
+        // The npy cases report the throughput of the binary data, the csv
+        // ones the throughput of the text. range(0) is the number of
+        // elements, stored as (range(0) / 16) x 16 arrays.
+        const char* npy_filename = "xtensor_benchmark_io.npy";
+        const char* csv_filename = "xtensor_benchmark_io.csv";
+
+        template <class T, layout_type L = layout_type::row_major>
+        xarray<T, L> make_data(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xarray<T, L> res = xt::cast<T>(xt::reshape_view(xt::fmod(arange<double>(static_cast<double>(n)) * 0.7919, 1e4),
+                                                            {n / 16, std::size_t(16)}));
+            return res;
+        }
+
+        template <class T, layout_type L>
+        void npy_dump_string(benchmark::State& state)
+        {
+            auto x = make_data<T, L>(state);
+            for (auto _ : state)
+            {
+                std::string res = dump_npy(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+        }
+
+        template <class T, layout_type L>
+        void npy_load_stream(benchmark::State& state)
+        {
+            std::istringstream stream(dump_npy(make_data<T, L>(state)));
+            for (auto _ : state)
+            {
+                stream.clear();
+                stream.seekg(0);
+                auto res = load_npy<T, L>(stream);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+        }
+
+        template <class T, layout_type L>
+        void npy_dump_file(benchmark::State& state)
+        {
+            auto x = make_data<T, L>(state);
+            for (auto _ : state)
+            {
+                dump_npy(npy_filename, x);
+            }
+            std::remove(npy_filename);
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+        }
+
+        template <class T, layout_type L>
+        void npy_load_file(benchmark::State& state)
+        {
+            dump_npy(npy_filename, make_data<T, L>(state));
+            for (auto _ : state)
+            {
+                auto res = load_npy<T, L>(npy_filename);
+                benchmark::DoNotOptimize(res.data());
+            }
+            std::remove(npy_filename);
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+        }
+
+        // Positioned reads, with io_uring when built with XTENSOR_USE_IO_URING
+        template <class T>
+        void npy_load_file_options(benchmark::State& state)
+        {
+            dump_npy(npy_filename, make_data<T>(state));
+            npy_read_options options;
+            for (auto _ : state)
+            {
+                auto res = load_npy<T>(npy_filename, options);
+                benchmark::DoNotOptimize(res.data());
+            }
+            std::remove(npy_filename);
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+        }
+
+        // Files of type F read as T
+        template <class T, class F>
+        void npy_load_as(benchmark::State& state)
+        {
+            std::istringstream stream(dump_npy(make_data<F>(state)));
+            for (auto _ : state)
+            {
+                stream.clear();
+                stream.seekg(0);
+                auto res = load_npy_as<T>(stream);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(F)));
+        }
+
+        template <class T>
+        void npy_sum_source(benchmark::State& state)
+        {
+            dump_npy(npy_filename, make_data<T>(state));
+            for (auto _ : state)
+            {
+                benchmark::DoNotOptimize(xt::sum(npy_source<T>(npy_filename))());
+            }
+            std::remove(npy_filename);
+            state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+        }
+
+        template <class T>
+        void csv_dump_string(benchmark::State& state)
+        {
+            auto x = make_data<T>(state);
+            std::int64_t bytes = 0;
+            for (auto _ : state)
+            {
+                std::ostringstream stream;
+                dump_csv(stream, x);
+                bytes += static_cast<std::int64_t>(stream.tellp());
+                benchmark::DoNotOptimize(bytes);
+            }
+            state.SetBytesProcessed(bytes);
+        }
+
+        template <class T>
+        void csv_load_stream(benchmark::State& state)
+        {
+            std::ostringstream out;
+            dump_csv(out, make_data<T>(state));
+            std::istringstream stream(out.str());
+            std::int64_t size = static_cast<std::int64_t>(out.str().size());
+            for (auto _ : state)
+            {
+                stream.clear();
+                stream.seekg(0);
+                auto res = load_csv<T>(stream);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * size);
+        }
+
+        template <class T>
+        void csv_load_file(benchmark::State& state)
+        {
+            std::int64_t size = 0;
+            {
+                std::ofstream out(csv_filename);
+                dump_csv(out, make_data<T>(state));
+                size = static_cast<std::int64_t>(out.tellp());
+            }
+            for (auto _ : state)
+            {
+                auto res = load_csv<T>(std::string(csv_filename));
+                benchmark::DoNotOptimize(res.data());
+            }
+            std::remove(csv_filename);
+            state.SetBytesProcessed(state.iterations() * size);
+        }
+
+        BENCHMARK_TEMPLATE(npy_dump_string, double, layout_type::row_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_dump_string, float, layout_type::row_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_dump_string, double, layout_type::column_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_stream, double, layout_type::row_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_stream, std::int32_t, layout_type::row_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_stream, double, layout_type::column_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_dump_file, double, layout_type::row_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_file, double, layout_type::row_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_file, double, layout_type::column_major)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_file_options, double)->Range(1 << 10, 1 << 24);
+        BENCHMARK_TEMPLATE(npy_load_as, double, float)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_as, float, double)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_load_as, double, std::int16_t)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(npy_sum_source, double)->Range(1 << 10, 1 << 24);
+        BENCHMARK_TEMPLATE(csv_dump_string, double)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(csv_dump_string, std::int32_t)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(csv_load_stream, double)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(csv_load_stream, std::int32_t)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(csv_load_file, double)->Range(1 << 10, 1 << 20);
+    }
+}
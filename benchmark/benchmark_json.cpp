@@ -0,0 +1,89 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <nlohmann/json.hpp>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xjson.hpp"
+#include "xtensor/xmath.hpp"
+
+namespace xt
+{
+    namespace json
+    {
+        // The cases report the throughput of the JSON text. range(0) is the
+        // number of elements, stored as (range(0) / 16) x 16 arrays.
+        template <class T>
+        xarray<T> make_data(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xarray<T> res = xt::cast<T>(xt::reshape_view(xt::fmod(arange<double>(static_cast<double>(n)) * 0.7919, 1e4),
+                                                         {n / 16, std::size_t(16)}));
+            return res;
+        }
+
+        template <class T>
+        void json_to_json_dump(benchmark::State& state)
+        {
+            auto x = make_data<T>(state);
+            std::int64_t bytes = 0;
+            for (auto _ : state)
+            {
+                nlohmann::json j = x;
+                std::string res = j.dump();
+                bytes += static_cast<std::int64_t>(res.size());
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(bytes);
+        }
+
+        template <class T>
+        void json_dump_json(benchmark::State& state)
+        {
+            auto x = make_data<T>(state);
+            std::int64_t bytes = 0;
+            for (auto _ : state)
+            {
+                std::ostringstream stream;
+                dump_json(stream, x);
+                bytes += static_cast<std::int64_t>(stream.tellp());
+                benchmark::DoNotOptimize(bytes);
+            }
+            state.SetBytesProcessed(bytes);
+        }
+
+        template <class T>
+        void json_parse_from_json(benchmark::State& state)
+        {
+            nlohmann::json j = make_data<T>(state);
+            std::string text = j.dump();
+            for (auto _ : state)
+            {
+                xarray<T> res;
+                from_json(nlohmann::json::parse(text), res);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+        }
+
+        BENCHMARK_TEMPLATE(json_to_json_dump, double)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(json_to_json_dump, std::int32_t)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(json_dump_json, double)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(json_dump_json, std::int32_t)->Range(1 << 10, 1 << 20);
+        BENCHMARK_TEMPLATE(json_parse_from_json, double)->Range(1 << 10, 1 << 20);
+    }
+}
@@ -14,6 +14,9 @@
 #include <benchmark/benchmark.h>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xmemoize.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xtensor.hpp"
 
@@ -364,6 +367,186 @@ namespace xt
         }
     }
 
+    /*****************************
+     * Narrow integer benchmarks *
+     *****************************/
+
+    namespace integer
+    {
+        template <class T>
+        inline void init_integer_benchmark(xtensor<T, 2>& lhs, xtensor<T, 2>& rhs, xtensor<T, 2>& res, std::size_t size)
+        {
+            lhs.resize({ size, size });
+            rhs.resize({ size, size });
+            res.resize({ size, size });
+            for (std::size_t i = 0; i < lhs.size(); ++i)
+            {
+                lhs.data()[i] = static_cast<T>(i * 7u);
+                rhs.data()[i] = static_cast<T>(i * 13u + 5u);
+            }
+        }
+
+        template <class F, class T>
+        inline void integer_xtensor(benchmark::State& state)
+        {
+            xtensor<T, 2> lhs, rhs, res;
+            init_integer_benchmark(lhs, rhs, res, static_cast<std::size_t>(state.range(0)));
+            auto f = F();
+
+            for (auto _ : state)
+            {
+                xt::noalias(res) = f(lhs, rhs);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class F, class T>
+        inline void integer_ref(benchmark::State& state)
+        {
+            xtensor<T, 2> lhs, rhs, res;
+            init_integer_benchmark(lhs, rhs, res, static_cast<std::size_t>(state.range(0)));
+            auto f = F();
+            std::size_t size = res.size();
+
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    res.data()[i] = static_cast<T>(f(lhs.data()[i], rhs.data()[i]));
+                }
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        // The functors are called on expressions and, by the reference
+        // loops, on scalars
+        struct bitwise_and_fn
+        {
+            template <class T1, class T2>
+            auto operator()(const T1& lhs, const T2& rhs) const { return lhs & rhs; }
+        };
+
+        struct bitwise_or_shift_fn
+        {
+            template <class T1, class T2>
+            auto operator()(const T1& lhs, const T2& rhs) const { return (lhs << 1) | rhs; }
+        };
+
+        struct add_fn
+        {
+            template <class T1, class T2>
+            auto operator()(const T1& lhs, const T2& rhs) const { return lhs + rhs; }
+        };
+
+        struct shift_fn
+        {
+            template <class T1, class T2>
+            auto operator()(const T1& lhs, const T2&) const { return lhs >> 2; }
+        };
+
+        struct clip_fn
+        {
+            template <class T1, class T2>
+            auto operator()(const T1& lhs, const T2&) const { return clip_impl(lhs, std::is_arithmetic<T1>()); }
+
+            template <class T1>
+            static auto clip_impl(const T1& lhs, std::true_type) { return (std::min)((std::max)(lhs, T1(16)), T1(235)); }
+
+            template <class T1>
+            static auto clip_impl(const T1& lhs, std::false_type)
+            {
+                using value_type = typename T1::value_type;
+                return xt::clip(lhs, value_type(16), value_type(235));
+            }
+        };
+
+        // The scalar saturating operations are those of the functors
+        template <class F>
+        struct saturating_fn
+        {
+            template <class T1, class T2>
+            auto operator()(const T1& lhs, const T2& rhs) const { return impl(lhs, rhs, std::is_arithmetic<T1>()); }
+
+            template <class T1, class T2>
+            static auto impl(const T1& lhs, const T2& rhs, std::true_type) { return F()(lhs, rhs); }
+
+            template <class T1, class T2>
+            static auto impl(const T1& lhs, const T2& rhs, std::false_type)
+            {
+                return detail::make_xfunction<F>(lhs, rhs);
+            }
+        };
+
+        using saturating_add_fn = saturating_fn<math::saturating_add_fun>;
+        using saturating_sub_fn = saturating_fn<math::saturating_sub_fun>;
+
+#define INTEGER_BENCHMARKS(FN, T)                                                   \
+        BENCHMARK_TEMPLATE(integer_ref, FN, T)->Range(MATH_RANGE);                \
+        BENCHMARK_TEMPLATE(integer_xtensor, FN, T)->Range(MATH_RANGE)
+
+        INTEGER_BENCHMARKS(bitwise_and_fn, uint8_t);
+        INTEGER_BENCHMARKS(bitwise_or_shift_fn, uint8_t);
+        INTEGER_BENCHMARKS(add_fn, uint8_t);
+        INTEGER_BENCHMARKS(shift_fn, uint8_t);
+        INTEGER_BENCHMARKS(clip_fn, uint8_t);
+        INTEGER_BENCHMARKS(saturating_add_fn, uint8_t);
+        INTEGER_BENCHMARKS(saturating_sub_fn, uint8_t);
+        INTEGER_BENCHMARKS(add_fn, uint16_t);
+        INTEGER_BENCHMARKS(saturating_add_fn, uint16_t);
+
+#undef INTEGER_BENCHMARKS
+    }
+
+    /*****************************
+     * Common subexpressions     *
+     *****************************/
+
+    namespace memoize_bench
+    {
+        inline auto common_subexpression(benchmark::State& state)
+        {
+            xtensor<double, 1> a = xt::linspace<double>(0.5, 2., 100000);
+            xtensor<double, 1> b = xt::linspace<double>(1., 3., 100000);
+            xtensor<double, 1> res(a.shape());
+            for (auto _ : state)
+            {
+                auto d = xt::exp(a) - xt::log(b);
+                noalias(res) = d * d + xt::abs(d);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline auto common_subexpression_memoize(benchmark::State& state)
+        {
+            xtensor<double, 1> a = xt::linspace<double>(0.5, 2., 100000);
+            xtensor<double, 1> b = xt::linspace<double>(1., 3., 100000);
+            xtensor<double, 1> res(a.shape());
+            for (auto _ : state)
+            {
+                auto d = xt::memoize(xt::exp(a) - xt::log(b));
+                noalias(res) = d * d + xt::abs(d);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline auto common_subexpression_eval(benchmark::State& state)
+        {
+            xtensor<double, 1> a = xt::linspace<double>(0.5, 2., 100000);
+            xtensor<double, 1> b = xt::linspace<double>(1., 3., 100000);
+            xtensor<double, 1> res(a.shape());
+            for (auto _ : state)
+            {
+                xtensor<double, 1> d = xt::exp(a) - xt::log(b);
+                noalias(res) = d * d + xt::abs(d);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        BENCHMARK(common_subexpression);
+        BENCHMARK(common_subexpression_memoize);
+        BENCHMARK(common_subexpression_eval);
+    }
+
     BENCHMARK_TEMPLATE(scalar_assign, xtensor<double, 2>)->Range(MATH_RANGE);
     BENCHMARK_TEMPLATE(scalar_assign_ref, xtensor<double, 2>)->Range(MATH_RANGE);
     BENCHMARK_TEMPLATE(boolean_func, xtensor<double, 2>)->Range(MATH_RANGE);
@@ -14,6 +14,7 @@
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xrandom.hpp"
 
 namespace xt
@@ -54,9 +55,112 @@ namespace xt
             }
         }
 
+        void random_assign_philox(benchmark::State& state)
+        {
+            xt::random::philox4x32 engine(0);
+            for (auto _ : state)
+            {
+                xtensor<double, 2> result = xt::random::rand<double>({20, 20}, 0., 1., engine);
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void randn_assign(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            for (auto _ : state)
+            {
+                xtensor<double, 1> result = xt::random::randn<double>({n});
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void randn_assign_philox(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xt::random::philox4x32 engine(0);
+            for (auto _ : state)
+            {
+                xtensor<double, 1> result = xt::random::randn<double>({n}, 0., 1., engine);
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void randn_refill(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 1> result = zeros<double>({n});
+            for (auto _ : state)
+            {
+                noalias(result) = xt::random::randn<double>({n});
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void fill_randn(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 1> result = zeros<double>({n});
+            for (auto _ : state)
+            {
+                xt::random::fill_randn(result, 0., 1.);
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void shuffle_1d(benchmark::State& state)
+        {
+            xtensor<double, 1> a = arange<double>(double(state.range(0)));
+            for (auto _ : state)
+            {
+                xt::random::shuffle(a);
+                benchmark::DoNotOptimize(a.data());
+            }
+        }
+
+        void shuffle_1d_philox(benchmark::State& state)
+        {
+            xtensor<double, 1> a = arange<double>(double(state.range(0)));
+            xt::random::philox4x32 engine(0);
+            for (auto _ : state)
+            {
+                xt::random::shuffle(a, engine);
+                benchmark::DoNotOptimize(a.data());
+            }
+        }
+
+        void shuffle_rows(benchmark::State& state)
+        {
+            xtensor<double, 2> a = zeros<double>({std::size_t(state.range(0)), std::size_t(8)});
+            for (auto _ : state)
+            {
+                xt::random::shuffle(a);
+                benchmark::DoNotOptimize(a.data());
+            }
+        }
+
+        void choice_without_replacement(benchmark::State& state)
+        {
+            xtensor<double, 1> a = arange<double>(double(state.range(0)));
+            for (auto _ : state)
+            {
+                auto res = xt::random::choice(a, 1000, false);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
         BENCHMARK(random_assign_xarray);
         BENCHMARK(random_assign_xtensor);
         BENCHMARK(random_assign_forloop);
+        BENCHMARK(random_assign_philox);
+        BENCHMARK(randn_assign)->Arg(100000);
+        BENCHMARK(randn_assign_philox)->Arg(100000);
+        BENCHMARK(randn_refill)->Arg(100000);
+        BENCHMARK(fill_randn)->Arg(100000);
+        BENCHMARK(shuffle_1d)->Arg(10000000);
+        BENCHMARK(shuffle_1d_philox)->Arg(10000000);
+        BENCHMARK(shuffle_rows)->Arg(100000);
+        BENCHMARK(choice_without_replacement)->Arg(1000000);
     }
 }
 
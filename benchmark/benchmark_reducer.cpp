@@ -9,6 +9,7 @@
 #include <benchmark/benchmark.h>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xreducer.hpp"
 
 namespace xt
@@ -96,5 +97,78 @@ namespace xt
         BENCHMARK_CAPTURE(reducer_manual_strided_reducer, 10x100000/axis 1, u, res1, axis1);
         BENCHMARK_CAPTURE(reducer_manual_strided_reducer, 100000x10/axis 1, v, res1, axis0);
         BENCHMARK_CAPTURE(reducer_manual_strided_reducer, 100000x10/axis 0, v, res0, axis1);
+
+        template <class E, class X>
+        void reducer_immediate_amax(benchmark::State& state, const E& x, E& res, const X& axes)
+        {
+            for (auto _ : state)
+            {
+                res = amax(x, axes, evaluation_strategy::immediate);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E, class X>
+        void reducer_immediate_prod(benchmark::State& state, const E& x, E& res, const X& axes)
+        {
+            for (auto _ : state)
+            {
+                res = prod(x, axes, evaluation_strategy::immediate);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        xarray<double> w = ones<double>({ 100, 100, 100 });
+        std::vector<std::size_t> axis2 = { 2 };
+        std::vector<std::size_t> axis12 = { 1, 2 };
+        std::vector<std::size_t> axis012 = { 0, 1, 2 };
+
+        static auto res_w2 = xarray<double>::from_shape({ 100, 100 });
+        static auto res_w12 = xarray<double>::from_shape({ 100 });
+
+        BENCHMARK_CAPTURE(reducer_immediate_reducer, 100x100x100/axis 2, w, res_w2, axis2);
+        BENCHMARK_CAPTURE(reducer_immediate_reducer, 100x100x100/axis 1 2, w, res_w12, axis12);
+        BENCHMARK_CAPTURE(reducer_immediate_reducer, 100x100x100/axis all, w, res2, axis012);
+        BENCHMARK_CAPTURE(reducer_immediate_amax, 10x100000/axis 1, u, res1, axis1);
+        BENCHMARK_CAPTURE(reducer_immediate_amax, 100x100x100/axis 2, w, res_w2, axis2);
+        BENCHMARK_CAPTURE(reducer_immediate_prod, 10x100000/axis 1, u, res1, axis1);
+        BENCHMARK_CAPTURE(reducer_immediate_prod, 100x100x100/axis 1 2, w, res_w12, axis12);
+
+        template <class E>
+        void reducer_fused_lazy(benchmark::State& state, const E& x, const E& y)
+        {
+            for (auto _ : state)
+            {
+                double res = sum(square(x - y))();
+                benchmark::DoNotOptimize(res);
+            }
+        }
+
+        template <class E>
+        void reducer_fused_immediate(benchmark::State& state, const E& x, const E& y)
+        {
+            for (auto _ : state)
+            {
+                double res = sum(square(x - y), evaluation_strategy::immediate)();
+                benchmark::DoNotOptimize(res);
+            }
+        }
+
+        template <class E>
+        void reducer_fused_temporary(benchmark::State& state, const E& x, const E& y)
+        {
+            for (auto _ : state)
+            {
+                E tmp = square(x - y);
+                double res = sum(tmp, evaluation_strategy::immediate)();
+                benchmark::DoNotOptimize(res);
+            }
+        }
+
+        xarray<double> w2 = ones<double>({ 100, 100, 100 }) * 0.5;
+
+        BENCHMARK_CAPTURE(reducer_fused_lazy, 100x100x100, w, w2);
+        BENCHMARK_CAPTURE(reducer_fused_immediate, 100x100x100, w, w2);
+        BENCHMARK_CAPTURE(reducer_fused_temporary, 100x100x100, w, w2);
     }
 }
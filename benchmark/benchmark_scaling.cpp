@@ -0,0 +1,291 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+// Runs the same cases with 1 to N threads and reports, next to the usual
+// timings, the speedup over the single-threaded run of the same case and
+// the parallel efficiency (speedup / threads). The parallel backend is the
+// one selected at compile time: TBB, OpenMP, or the xthread_pool of
+// xexecution.hpp when neither XTENSOR_USE_TBB nor XTENSOR_USE_OPENMP is
+// defined. Arguments are {size, threads}; the thread counts are the powers
+// of two up to the hardware concurrency.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/global_control.h>
+#endif
+
+namespace xt
+{
+    namespace scaling
+    {
+        /**********************
+         * backend management *
+         **********************/
+
+        const char* backend_name()
+        {
+#if defined(XTENSOR_USE_TBB)
+            return "TBB";
+#elif defined(XTENSOR_USE_OPENMP)
+            return "OpenMP";
+#else
+            return "xthread_pool";
+#endif
+        }
+
+        // XTENSOR_SCALING_MAX_THREADS overrides the hardware concurrency
+        std::size_t max_threads()
+        {
+            if (const char* env = std::getenv("XTENSOR_SCALING_MAX_THREADS"))
+            {
+                long n = std::strtol(env, nullptr, 10);
+                if (n > 0)
+                {
+                    return static_cast<std::size_t>(n);
+                }
+            }
+            return (std::max)(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+        }
+
+        // Limits the parallel backend to n threads while alive, and provides
+        // the policy running the assignments on these threads.
+        class thread_limit
+        {
+        public:
+
+            explicit thread_limit(std::size_t n);
+            ~thread_limit();
+
+            thread_limit(const thread_limit&) = delete;
+            thread_limit& operator=(const thread_limit&) = delete;
+
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            exec::default_policy policy() const noexcept
+            {
+                return exec::default_policy();
+            }
+#else
+            exec::parallel_policy policy() const noexcept
+            {
+                return exec::par(m_pool);
+            }
+#endif
+
+        private:
+
+#if defined(XTENSOR_USE_TBB)
+            tbb::global_control m_control;
+#elif defined(XTENSOR_USE_OPENMP)
+            int m_previous;
+#else
+            // The calling thread takes part in the loops
+            mutable xthread_pool m_pool;
+#endif
+        };
+
+#if defined(XTENSOR_USE_TBB)
+        thread_limit::thread_limit(std::size_t n)
+            : m_control(tbb::global_control::max_allowed_parallelism, n)
+        {
+        }
+
+        thread_limit::~thread_limit()
+        {
+        }
+#elif defined(XTENSOR_USE_OPENMP)
+        thread_limit::thread_limit(std::size_t n)
+            : m_previous(omp_get_max_threads())
+        {
+            omp_set_num_threads(static_cast<int>(n));
+        }
+
+        thread_limit::~thread_limit()
+        {
+            omp_set_num_threads(m_previous);
+        }
+#else
+        thread_limit::thread_limit(std::size_t n)
+            : m_pool(n - 1)
+        {
+        }
+
+        thread_limit::~thread_limit()
+        {
+        }
+#endif
+
+        /*********************
+         * speedup reporting *
+         *********************/
+
+        // Mean time per iteration of the single-threaded runs, by case and size
+        std::map<std::string, double>& baselines()
+        {
+            static std::map<std::string, double> res;
+            return res;
+        }
+
+        // Times the loop of state, calling f on each iteration, and sets the
+        // speedup and efficiency counters.
+        template <class F>
+        void run_scaling(benchmark::State& state, const std::string& name, F&& f)
+        {
+            std::size_t threads = static_cast<std::size_t>(state.range(1));
+            auto start = std::chrono::steady_clock::now();
+            for (auto _ : state)
+            {
+                f();
+            }
+            auto stop = std::chrono::steady_clock::now();
+
+            double mean = std::chrono::duration<double>(stop - start).count() / static_cast<double>(state.iterations());
+            std::string key = name + "/" + std::to_string(state.range(0));
+            if (threads == 1)
+            {
+                baselines()[key] = mean;
+            }
+            auto it = baselines().find(key);
+            if (it != baselines().end() && mean > 0.)
+            {
+                double speedup = it->second / mean;
+                state.counters["threads"] = static_cast<double>(threads);
+                state.counters["speedup"] = speedup;
+                state.counters["efficiency"] = speedup / static_cast<double>(threads);
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        void scaling_args(benchmark::internal::Benchmark* b)
+        {
+            std::size_t n_max = max_threads();
+            for (std::int64_t size : {1 << 14, 1 << 18, 1 << 22})
+            {
+                for (std::size_t n = 1; n < 2 * n_max; n *= 2)
+                {
+                    b->Args({size, static_cast<std::int64_t>((std::min)(n, n_max))});
+                    if (n >= n_max)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+
+        /*********
+         * cases *
+         *********/
+
+        xtensor<double, 1> make_data(benchmark::State& state)
+        {
+            random::seed(0);
+            return random::rand<double>({std::size_t(state.range(0))});
+        }
+
+        void scaling_assign(benchmark::State& state)
+        {
+            auto a = make_data(state);
+            xtensor<double, 1> b = a * 0.5;
+            xtensor<double, 1> res = xtensor<double, 1>::from_shape(a.shape());
+            thread_limit limit(static_cast<std::size_t>(state.range(1)));
+            run_scaling(state, "assign", [&]()
+            {
+                noalias(res).assign(a + b * a, limit.policy());
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        void scaling_transcendental(benchmark::State& state)
+        {
+            auto a = make_data(state);
+            xtensor<double, 1> res = xtensor<double, 1>::from_shape(a.shape());
+            thread_limit limit(static_cast<std::size_t>(state.range(1)));
+            run_scaling(state, "transcendental", [&]()
+            {
+                noalias(res).assign(xt::exp(a) * xt::sin(a), limit.policy());
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        void scaling_sort(benchmark::State& state)
+        {
+            auto a = make_data(state);
+            thread_limit limit(static_cast<std::size_t>(state.range(1)));
+            run_scaling(state, "sort", [&]()
+            {
+                auto res = xt::sort(a, xnone(), limit.policy());
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        BENCHMARK(scaling_assign)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_transcendental)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_sort)->Apply(scaling_args)->UseRealTime();
+
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+        // The reductions only go parallel through the compile time backend
+
+        void scaling_sum(benchmark::State& state)
+        {
+            auto a = make_data(state);
+            thread_limit limit(static_cast<std::size_t>(state.range(1)));
+            run_scaling(state, "sum", [&]()
+            {
+                double res = xt::sum(a, evaluation_strategy::immediate)();
+                benchmark::DoNotOptimize(res);
+            });
+        }
+
+        void scaling_sum_axis(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<double, 2> a = xt::reshape_view(make_data(state), {n / 64, std::size_t(64)});
+            thread_limit limit(static_cast<std::size_t>(state.range(1)));
+            run_scaling(state, "sum_axis", [&]()
+            {
+                xtensor<double, 1> res = xt::sum(a, {1}, evaluation_strategy::immediate);
+                benchmark::DoNotOptimize(res.data());
+            });
+        }
+
+        BENCHMARK(scaling_sum)->Apply(scaling_args)->UseRealTime();
+        BENCHMARK(scaling_sum_axis)->Apply(scaling_args)->UseRealTime();
+#endif
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "PARALLEL BACKEND: " << xt::scaling::backend_name()
+              << "\nMAX THREADS: " << xt::scaling::max_threads()
+              << "\nDEFAULT THRESHOLD: " << xt::exec::default_threshold() << "\n\n";
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+}
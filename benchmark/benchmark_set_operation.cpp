@@ -0,0 +1,144 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xset_operation.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xsorted_index.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace set_operation
+    {
+        // n values among about m distinct ones
+        template <class T>
+        xtensor<T, 1> make_values(std::size_t n, std::size_t m)
+        {
+            xtensor<T, 1> res = xt::cast<T>(xt::fmod(arange<double>(static_cast<double>(n)) * 7919., static_cast<double>(m)));
+            return res;
+        }
+
+        // range(0) is the number of elements, range(1) the number of test
+        // elements, half of which are found in the elements
+        template <class T>
+        void set_isin(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t m = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_values<T>(n, 2 * m);
+            xtensor<T, 1> test = xt::cast<T>(arange<double>(static_cast<double>(m)) * 2.);
+            for (auto _ : state)
+            {
+                xtensor<bool, 1> res = xt::isin(x, test);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void set_in1d(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t m = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_values<T>(n, 2 * m);
+            xtensor<T, 1> test = xt::cast<T>(arange<double>(static_cast<double>(m)) * 2.);
+            for (auto _ : state)
+            {
+                xtensor<bool, 1> res = xt::in1d(x, test);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // range(0) is the number of searched values, range(1) the number of
+        // sorted elements
+        template <class T>
+        void set_searchsorted(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t m = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_values<T>(n, 4 * m);
+            xtensor<T, 1> sorted = xt::cast<T>(arange<double>(static_cast<double>(m)) * 4.);
+            for (auto _ : state)
+            {
+                xtensor<std::size_t, 1> res = xt::searchsorted(sorted, x);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void set_searchsorted_index(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t m = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_values<T>(n, 4 * m);
+            xtensor<T, 1> sorted = xt::cast<T>(arange<double>(static_cast<double>(m)) * 4.);
+            auto index = xt::make_sorted_index(sorted);
+            for (auto _ : state)
+            {
+                xtensor<std::size_t, 1> res = xt::searchsorted(index, x);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // range(0) is the number of elements, range(1) the number of
+        // distinct values
+        template <class T>
+        void set_unique(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t m = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_values<T>(n, m);
+            for (auto _ : state)
+            {
+                auto res = xt::unique(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        template <class T>
+        void set_unique_inverse_counts(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::size_t m = static_cast<std::size_t>(state.range(1));
+            xtensor<T, 1> x = make_values<T>(n, m);
+            for (auto _ : state)
+            {
+                auto res = xt::unique(x, true, true);
+                benchmark::DoNotOptimize(res.inverse.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        BENCHMARK_TEMPLATE(set_isin, std::int32_t)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 14});
+        BENCHMARK_TEMPLATE(set_isin, std::int64_t)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 14});
+        BENCHMARK_TEMPLATE(set_isin, double)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 14});
+        BENCHMARK_TEMPLATE(set_in1d, std::int32_t)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 14});
+        BENCHMARK_TEMPLATE(set_in1d, double)->Args({1 << 10, 16})->Args({1 << 20, 16})->Args({1 << 20, 1 << 14});
+        BENCHMARK_TEMPLATE(set_searchsorted, std::int32_t)->Args({1 << 10, 64})->Args({1 << 20, 64})->Args({1 << 20, 1 << 16});
+        BENCHMARK_TEMPLATE(set_searchsorted, float)->Args({1 << 10, 64})->Args({1 << 20, 64})->Args({1 << 20, 1 << 16});
+        BENCHMARK_TEMPLATE(set_searchsorted, double)->Args({1 << 10, 64})->Args({1 << 20, 64})->Args({1 << 20, 1 << 16});
+        BENCHMARK_TEMPLATE(set_searchsorted_index, double)->Args({1 << 10, 64})->Args({1 << 20, 64})->Args({1 << 20, 1 << 16});
+        BENCHMARK_TEMPLATE(set_unique, std::int32_t)->Args({1 << 10, 100})->Args({1 << 20, 100})->Args({1 << 20, 1 << 18});
+        BENCHMARK_TEMPLATE(set_unique, std::int64_t)->Args({1 << 10, 100})->Args({1 << 20, 100})->Args({1 << 20, 1 << 18});
+        BENCHMARK_TEMPLATE(set_unique, double)->Args({1 << 10, 100})->Args({1 << 20, 100})->Args({1 << 20, 1 << 18});
+        BENCHMARK_TEMPLATE(set_unique_inverse_counts, std::int32_t)->Args({1 << 10, 100})->Args({1 << 20, 100})->Args({1 << 20, 1 << 18});
+        BENCHMARK_TEMPLATE(set_unique_inverse_counts, double)->Args({1 << 10, 100})->Args({1 << 20, 100})->Args({1 << 20, 1 << 18});
+    }
+}
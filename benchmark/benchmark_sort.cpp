@@ -0,0 +1,410 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xhistogram.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xset_operation.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace sorting
+    {
+        template <class E>
+        void sort_argmin(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                auto res = argmin(x);
+                benchmark::DoNotOptimize(res());
+            }
+        }
+
+        template <class E>
+        void sort_argmax(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                auto res = argmax(x);
+                benchmark::DoNotOptimize(res());
+            }
+        }
+
+        template <class E>
+        void sort_argmax_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                auto res = argmax(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_sort_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                xarray<double> res = xt::sort(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E, class P>
+        void sort_flat(benchmark::State& state, const E& x, const P& policy)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::sort(x, xnone(), policy);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_argsort_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::argsort(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_median_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::median(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_quantile_axis(benchmark::State& state, const E& x, std::ptrdiff_t axis)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::quantile(x, {0.5, 0.9, 0.99}, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_argtopk(benchmark::State& state, const E& x, std::size_t k)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::argtopk(x, k, 1);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        // Former way of getting the k largest elements of each row
+        template <class E>
+        void sort_argpartition_topk(benchmark::State& state, const E& x, std::size_t k)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::argpartition(-x, k - 1, 1);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_unique(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::unique(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_unique_counts(benchmark::State& state, const E& x)
+        {
+            for (auto _ : state)
+            {
+                auto res = xt::unique(x, true, true);
+                benchmark::DoNotOptimize(res.counts.data());
+            }
+        }
+
+        template <class E, class T>
+        void sort_isin(benchmark::State& state, const E& x, const T& test)
+        {
+            for (auto _ : state)
+            {
+                xtensor<bool, 1> res = xt::isin(x, test);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E, class T>
+        void sort_searchsorted(benchmark::State& state, const E& x, const T& edges)
+        {
+            for (auto _ : state)
+            {
+                xtensor<std::size_t, 1> res = xt::searchsorted(edges, x);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E, class T>
+        void sort_searchsorted_index(benchmark::State& state, const E& x, const T& edges)
+        {
+            auto index = xt::make_sorted_index(edges);
+            for (auto _ : state)
+            {
+                xtensor<std::size_t, 1> res = xt::searchsorted(index, x);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        void sort_histogram(benchmark::State& state, const E& x, std::size_t bins)
+        {
+            for (auto _ : state)
+            {
+                xtensor<double, 1> res = xt::histogram(x, bins);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E, class T>
+        void sort_histogram_edges(benchmark::State& state, const E& x, const T& edges)
+        {
+            for (auto _ : state)
+            {
+                xtensor<double, 1> res = xt::histogram(x, edges);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        void sort_lexsort(benchmark::State& state)
+        {
+            int n = static_cast<int>(state.range(0));
+            xtensor<int, 1> k1 = xt::arange<int>(n) * 7919 % 100003;
+            xtensor<int, 1> k2 = xt::arange<int>(n) * 31 % 1009;
+            xtensor<std::int64_t, 1> k3 = xt::arange<std::int64_t>(n) % 17;
+            for (auto _ : state)
+            {
+                auto res = xt::lexsort(k1, k2, k3);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        // std::sort against the radix sort used by xt::sort above
+        // detail::radix_threshold<T>(), to locate the crossover point
+        template <class T>
+        xtensor<T, 1> make_keys(std::size_t n)
+        {
+            xtensor<T, 1> keys = xt::cast<T>(xt::fmod(arange<double>(static_cast<double>(n)) * 7919., 1e6) - 5e5);
+            return keys;
+        }
+
+        template <class T>
+        void sort_std_sort(benchmark::State& state)
+        {
+            xtensor<T, 1> keys = make_keys<T>(static_cast<std::size_t>(state.range(0)));
+            for (auto _ : state)
+            {
+                xtensor<T, 1> res = keys;
+                std::sort(res.begin(), res.end());
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class T>
+        void sort_radix_sort(benchmark::State& state)
+        {
+            xtensor<T, 1> keys = make_keys<T>(static_cast<std::size_t>(state.range(0)));
+            for (auto _ : state)
+            {
+                xtensor<T, 1> res = keys;
+                detail::radix_sort(res.data(), res.size());
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class T>
+        void sort_stable_argsort(benchmark::State& state)
+        {
+            xtensor<T, 1> keys = make_keys<T>(static_cast<std::size_t>(state.range(0)));
+            for (auto _ : state)
+            {
+                auto res = xt::argsort(keys, 0, sorting_method::stable);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        // Sort, argsort, partition and median along an axis of a n x n
+        // array, for the value type and the layout of the arguments;
+        // range(0) is n and range(1) the axis.
+        template <class T, layout_type L>
+        xarray<T, L> make_square(std::size_t n)
+        {
+            xarray<T, L> res = xt::reshape_view(make_keys<T>(n * n), {n, n});
+            return res;
+        }
+
+        template <class T, layout_type L>
+        void sort_square_sort(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            xarray<T, L> x = make_square<T, L>(n);
+            for (auto _ : state)
+            {
+                xarray<T, L> res = xt::sort(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+
+        template <class T, layout_type L>
+        void sort_square_argsort(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            xarray<T, L> x = make_square<T, L>(n);
+            for (auto _ : state)
+            {
+                auto res = xt::argsort(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+
+        template <class T, layout_type L>
+        void sort_square_partition(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            xarray<T, L> x = make_square<T, L>(n);
+            for (auto _ : state)
+            {
+                auto res = xt::partition(x, n / 2, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+
+        template <class T, layout_type L>
+        void sort_square_argpartition(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            xarray<T, L> x = make_square<T, L>(n);
+            for (auto _ : state)
+            {
+                auto res = xt::argpartition(x, n / 2, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+
+        template <class T, layout_type L>
+        void sort_square_median(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+            xarray<T, L> x = make_square<T, L>(n);
+            for (auto _ : state)
+            {
+                auto res = xt::median(x, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+        }
+
+        template <class T>
+        void sort_flat_median(benchmark::State& state)
+        {
+            xtensor<T, 1> keys = make_keys<T>(static_cast<std::size_t>(state.range(0)));
+            for (auto _ : state)
+            {
+                benchmark::DoNotOptimize(xt::median(keys));
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        BENCHMARK_TEMPLATE(sort_square_sort, std::int32_t, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_sort, std::int32_t, layout_type::column_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_sort, float, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_sort, float, layout_type::column_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_sort, double, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_argsort, std::int32_t, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_argsort, double, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_argsort, double, layout_type::column_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_partition, float, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_partition, double, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_partition, double, layout_type::column_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_argpartition, double, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_median, float, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_median, double, layout_type::row_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_square_median, double, layout_type::column_major)->Args({64, 0})->Args({64, 1})->Args({1024, 0})->Args({1024, 1});
+        BENCHMARK_TEMPLATE(sort_flat_median, std::int32_t)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_flat_median, double)->Range(64, 1 << 20);
+
+        BENCHMARK_TEMPLATE(sort_std_sort, std::int32_t)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_radix_sort, std::int32_t)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_std_sort, std::int64_t)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_radix_sort, std::int64_t)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_std_sort, float)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_radix_sort, float)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_stable_argsort, std::int32_t)->Range(64, 1 << 20);
+        BENCHMARK_TEMPLATE(sort_stable_argsort, float)->Range(64, 1 << 20);
+        BENCHMARK(sort_lexsort)->Range(64, 1 << 20);
+
+        xarray<double> a = xt::fmod(arange<double>(10000000.) * 7., 9973.);
+        xarray<double> u = xt::reshape_view(a, { 10, 1000000 });
+        xarray<double> v = xt::reshape_view(a, { 1000000, 10 });
+        xarray<double> w = xt::reshape_view(xt::view(a, xt::range(0, 1000000)), { 1000, 1000 });
+
+        BENCHMARK_CAPTURE(sort_argmin, 10000000, a);
+        BENCHMARK_CAPTURE(sort_argmax, 10000000, a);
+        BENCHMARK_CAPTURE(sort_argmax_axis, 10x1000000/axis 0, u, 0);
+        BENCHMARK_CAPTURE(sort_argmax_axis, 10x1000000/axis 1, u, 1);
+        BENCHMARK_CAPTURE(sort_argmax_axis, 1000000x10/axis 0, v, 0);
+        BENCHMARK_CAPTURE(sort_argmax_axis, 1000000x10/axis 1, v, 1);
+        BENCHMARK_CAPTURE(sort_flat, 10000000/seq, a, exec::seq);
+        BENCHMARK_CAPTURE(sort_flat, 10000000/par, a, exec::par());
+        BENCHMARK_CAPTURE(sort_sort_axis, 1000x1000/axis 0, w, 0);
+        BENCHMARK_CAPTURE(sort_sort_axis, 1000x1000/axis 1, w, 1);
+        BENCHMARK_CAPTURE(sort_argsort_axis, 1000x1000/axis 0, w, 0);
+        BENCHMARK_CAPTURE(sort_median_axis, 1000x1000/axis 0, w, 0);
+        BENCHMARK_CAPTURE(sort_quantile_axis, 10x1000000/axis 1, u, 1);
+        BENCHMARK_CAPTURE(sort_argtopk, 10x1000000/k 100, u, 100);
+        BENCHMARK_CAPTURE(sort_unique, 10000000/9973 values, a);
+        BENCHMARK_CAPTURE(sort_unique_counts, 10000000/9973 values, a);
+
+        xtensor<double, 1> t = xt::arange<double>(0., 200000., 2.);
+        BENCHMARK_CAPTURE(sort_isin, 10000000x100000, a, t);
+        BENCHMARK_CAPTURE(sort_argpartition_topk, 10x1000000/k 100, u, 100);
+
+        xtensor<double, 1> edges = xt::arange<double>(0., 9973., 0.01);
+        BENCHMARK_CAPTURE(sort_searchsorted, 10000000/997300 edges, a, edges);
+        BENCHMARK_CAPTURE(sort_searchsorted_index, 10000000/997300 edges, a, edges);
+
+        xtensor<double, 1> hist_edges = xt::linspace<double>(0., 9973., 101);
+        BENCHMARK_CAPTURE(sort_histogram, 10000000/100 bins, a, 100);
+        BENCHMARK_CAPTURE(sort_histogram_edges, 10000000/100 bins, a, hist_edges);
+    }
+}
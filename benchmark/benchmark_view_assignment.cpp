@@ -13,6 +13,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -147,6 +148,72 @@ namespace xt
         }
     }
 
+    // Assignments to a row of a 3-D tensor, whose trailing slices are
+    // full (implicit or explicit) ranges, are contiguous
+    inline void assign_contiguous_view(benchmark::State& state)
+    {
+        xt::xtensor<double, 3> tens = xt::random::rand<double>({8, 256, 256});
+        xt::xtensor<double, 2> a = xt::random::rand<double>({256, 256});
+        xt::xtensor<double, 2> b = xt::random::rand<double>({256, 256});
+        for (auto _ : state)
+        {
+            noalias(xt::view(tens, 3, all(), all())) = a + b;
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void assign_contiguous_view_full_range(benchmark::State& state)
+    {
+        xt::xtensor<double, 3> tens = xt::random::rand<double>({8, 256, 256});
+        xt::xtensor<double, 2> a = xt::random::rand<double>({256, 256});
+        xt::xtensor<double, 2> b = xt::random::rand<double>({256, 256});
+        for (auto _ : state)
+        {
+            noalias(xt::view(tens, 3, all(), range(0, 256))) = a + b;
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void assign_contiguous_view_manual(benchmark::State& state)
+    {
+        xt::xtensor<double, 3> tens = xt::random::rand<double>({8, 256, 256});
+        xt::xtensor<double, 2> a = xt::random::rand<double>({256, 256});
+        xt::xtensor<double, 2> b = xt::random::rand<double>({256, 256});
+        for (auto _ : state)
+        {
+            double* dst = tens.data() + 3 * tens.strides()[0];
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                dst[i] = a.data()[i] + b.data()[i];
+            }
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void scalar_assign_contiguous_view(benchmark::State& state)
+    {
+        xt::xtensor<double, 3> tens = xt::random::rand<double>({8, 256, 256});
+        for (auto _ : state)
+        {
+            auto v = xt::view(tens, 3, all(), range(0, 256));
+            v = 1.;
+            v *= 2.;
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void scalar_assign_strided_view(benchmark::State& state)
+    {
+        xt::xtensor<double, 3> tens = xt::random::rand<double>({8, 256, 256});
+        for (auto _ : state)
+        {
+            auto v = xt::view(tens, 3, all(), range(0, 255));
+            v = 1.;
+            v *= 2.;
+            benchmark::ClobberMemory();
+        }
+    }
+
     BENCHMARK(create_xview);
     BENCHMARK(create_strided_view_outofplace);
     BENCHMARK(create_strided_view_inplace);
@@ -156,4 +223,9 @@ namespace xt
     BENCHMARK(assign_create_manual_view);
     BENCHMARK(data_offset);
     BENCHMARK(data_offset_view);
+    BENCHMARK(assign_contiguous_view);
+    BENCHMARK(assign_contiguous_view_full_range);
+    BENCHMARK(assign_contiguous_view_manual);
+    BENCHMARK(scalar_assign_contiguous_view);
+    BENCHMARK(scalar_assign_strided_view);
 }
\ No newline at end of file
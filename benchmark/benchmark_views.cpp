@@ -14,6 +14,7 @@
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xpad.hpp"
 #include "xtensor/xstrided_view.hpp"
 #include "xtensor/xmanipulation.hpp"
 #include "xtensor/xstrides.hpp"
@@ -223,5 +224,89 @@ namespace xt
         BENCHMARK_CAPTURE(transpose_assign_cm_cm, 10x20x500, {10, 20, 500});
         BENCHMARK_CAPTURE(transpose_assign_rm_cm, 10x20x500, {10, 20, 500});
         BENCHMARK_CAPTURE(transpose_assign_cm_rm, 10x20x500, {10, 20, 500});
+        BENCHMARK_CAPTURE(transpose_assign_rm_rm, 2048x2048, {2048, 2048});
+        BENCHMARK_CAPTURE(transpose_assign_rm_cm, 2048x2048, {2048, 2048});
+
+        inline auto transpose_inplace_bench(benchmark::State& state, std::vector<std::size_t> shape)
+        {
+            xarray<double> x = xt::arange<double>(compute_size(shape));
+            x.resize(shape);
+
+            for (auto _ : state)
+            {
+                transpose_inplace(x);
+                benchmark::DoNotOptimize(x.data());
+            }
+        }
+
+        BENCHMARK_CAPTURE(transpose_inplace_bench, 2048x2048, {2048, 2048});
+        BENCHMARK_CAPTURE(transpose_inplace_bench, 2048x1536, {2048, 1536});
+    }
+
+    namespace repeat_benchmarks
+    {
+        inline auto repeat_assign(benchmark::State& state)
+        {
+            xtensor<double, 2> x = xt::ones<double>({500, 500});
+            std::size_t axis = static_cast<std::size_t>(state.range(0));
+            for (auto _ : state)
+            {
+                xtensor<double, 2> res = xt::repeat(x, 3, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline auto tile_assign(benchmark::State& state)
+        {
+            xtensor<double, 2> x = xt::ones<double>({500, 500});
+            for (auto _ : state)
+            {
+                xtensor<double, 2> res = xt::tile(x, {2, 3});
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        BENCHMARK(repeat_assign)->Arg(0)->Arg(1);
+        BENCHMARK(tile_assign);
+    }
+
+    namespace flip_benchmarks
+    {
+        inline auto flip_assign(benchmark::State& state)
+        {
+            xtensor<double, 2> x = xt::ones<double>({1000, 1000});
+            xtensor<double, 2> res(x.shape());
+            for (auto _ : state)
+            {
+                res = xt::flip(x, 1);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline auto rot90_assign(benchmark::State& state)
+        {
+            xtensor<double, 2> x = xt::ones<double>({1000, 1000});
+            xtensor<double, 2> res(x.shape());
+            for (auto _ : state)
+            {
+                res = xt::rot90<2>(x);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline auto roll_axis(benchmark::State& state)
+        {
+            xtensor<double, 2> x = xt::ones<double>({1000, 1000});
+            std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(0));
+            for (auto _ : state)
+            {
+                xtensor<double, 2> res = xt::roll(x, 17, axis);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        BENCHMARK(flip_assign);
+        BENCHMARK(rot90_assign);
+        BENCHMARK(roll_axis)->Arg(0)->Arg(1);
     }
 }
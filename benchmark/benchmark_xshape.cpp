@@ -12,8 +12,11 @@
 
 #include <benchmark/benchmark.h>
 
+#include "xtensor/xarray.hpp"
+#include "xtensor/xfixed.hpp"
 #include "xtensor/xshape.hpp"
 #include "xtensor/xstorage.hpp"
+#include "xtensor/xtensor.hpp"
 
 
 namespace xt
@@ -54,6 +57,36 @@ namespace xt
             }
         }
 
+        // Shape of a binary expression: known at compile time for
+        // xtensor_fixed, broadcast at runtime for xtensor and xarray
+        template <class E>
+        void xshape_expression(benchmark::State& state)
+        {
+            E a = E::from_shape({3, 4, 2});
+            E b = E::from_shape({3, 4, 2});
+            for (auto _ : state)
+            {
+                auto f = a + b;
+                const auto& s = f.shape();
+                std::size_t last = s[2];
+                benchmark::DoNotOptimize(last);
+            }
+        }
+
+        template <class E>
+        void xshape_broadcast_expression(benchmark::State& state)
+        {
+            E a = E::from_shape({3, 4, 2});
+            auto b = xt::xtensor<double, 1>::from_shape({2});
+            for (auto _ : state)
+            {
+                auto f = a + b;
+                const auto& s = f.shape();
+                std::size_t last = s[2];
+                benchmark::DoNotOptimize(last);
+            }
+        }
+
         BENCHMARK_TEMPLATE(xshape_initializer, std::vector<std::size_t>);
         BENCHMARK_TEMPLATE(xshape_initializer, xt::svector<std::size_t, 4>);
         BENCHMARK_TEMPLATE(xshape_initializer, std::array<std::size_t, 4>);
@@ -64,6 +97,12 @@ namespace xt
         BENCHMARK_TEMPLATE(xshape_access, std::vector<double>);
         BENCHMARK_TEMPLATE(xshape_access, xt::svector<std::size_t, 4>);
         BENCHMARK_TEMPLATE(xshape_access, std::array<std::size_t, 4>);
+        BENCHMARK_TEMPLATE(xshape_expression, xt::xtensor_fixed<double, xt::xshape<3, 4, 2>>);
+        BENCHMARK_TEMPLATE(xshape_expression, xt::xtensor<double, 3>);
+        BENCHMARK_TEMPLATE(xshape_expression, xt::xarray<double>);
+        BENCHMARK_TEMPLATE(xshape_broadcast_expression, xt::xtensor_fixed<double, xt::xshape<3, 4, 2>>);
+        BENCHMARK_TEMPLATE(xshape_broadcast_expression, xt::xtensor<double, 3>);
+        BENCHMARK_TEMPLATE(xshape_broadcast_expression, xt::xarray<double>);
     }
 }
 
@@ -13,6 +13,8 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
 
+#include "benchmark_counters.hpp"
+
 #ifdef XTENSOR_USE_XSIMD
 #ifdef __GNUC__
 template <class T>
@@ -37,10 +39,17 @@ void print_stats()
 #endif
 
 
-// Custom main function to print SIMD config
+void print_counters()
+{
+    std::cout << "STREAM TRIAD: " << xt::bench::stream_bandwidth() * 1e-9 << " GB/s\n"
+              << "HARDWARE COUNTERS: " << (xt::bench::thread_perf_events().valid() ? "ON" : "OFF") << "\n\n";
+}
+
+// Custom main function to print SIMD config and the roofline baseline
 int main(int argc, char** argv)
 {
     print_stats();
+    print_counters();
     benchmark::Initialize(&argc, argv);
     if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
     benchmark::RunSpecifiedBenchmarks();
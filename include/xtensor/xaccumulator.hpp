@@ -15,10 +15,12 @@
 #include <numeric>
 #include <type_traits>
 
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xstrides.hpp"
 #include "xtensor_config.hpp"
 #include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
 
 namespace xt
 {
@@ -150,6 +152,241 @@ namespace xt
         template <class T, class R>
         using xaccumulator_linear_return_type_t = typename xaccumulator_linear_return_type<T, R>::type;
 
+        /***************
+         * scan engine *
+         ***************/
+
+        /**
+         * Describes how a scan with the accumulate functor AF and the init
+         * functor IF can be computed by blocks: there is a combine functor
+         * c such that AF(a, x) == c(a, IF(x)). The partial scans of the
+         * blocks, whose first elements go through IF, are then combined with
+         * c. combine_type is void when the scan must remain sequential;
+         * specializations for the functors of cumsum, cumprod, nancumsum and
+         * nancumprod are provided in xmath.hpp.
+         */
+        template <class AF, class IF>
+        struct scan_traits
+        {
+            using combine_type = void;
+            static constexpr bool simd_plus = false;
+        };
+
+        // Length of the blocks scanned independently in parallel. It does not
+        // depend on the number of threads, so that results are reproducible.
+        constexpr std::size_t scan_block_size = 16384;
+
+        inline bool use_parallel_scan(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            return size >= 2 * scan_block_size && size >= exec::default_threshold();
+#else
+            (void) size;
+            return false;
+#endif
+        }
+
+        template <class T, class AF>
+        inline void scan_serial_impl(T* first, std::size_t n, AF& f, std::false_type)
+        {
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                first[i] = f(first[i - 1], first[i]);
+            }
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        // In-register inclusive prefix sum, in log2(N) shifted additions
+        template <class T, std::size_t I, std::size_t N>
+        struct simd_prefix_sum
+        {
+            template <class B>
+            static B run(const B& b)
+            {
+                return simd_prefix_sum<T, 2 * I, N>::run(b + xsimd::slide_left<I * sizeof(T)>(b));
+            }
+        };
+
+        template <class T, std::size_t N>
+        struct simd_prefix_sum<T, N, N>
+        {
+            template <class B>
+            static B run(const B& b)
+            {
+                return b;
+            }
+        };
+
+        template <class T, class AF>
+        inline void scan_serial_impl(T* first, std::size_t n, AF& f, std::true_type)
+        {
+            using batch_type = xt_simd::simd_type<T>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            if (n < 2 * simd_size)
+            {
+                scan_serial_impl(first, n, f, std::false_type());
+                return;
+            }
+            batch_type carry(T(0));
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                batch_type b = xt_simd::load_as<T>(first + i, unaligned_mode());
+                b = simd_prefix_sum<T, 1, simd_size>::run(b) + carry;
+                xt_simd::store_as(first + i, b, unaligned_mode());
+                carry = batch_type(first[i + simd_size - 1]);
+            }
+            scan_serial_impl(first + i - 1, n - i + 1, f, std::false_type());
+        }
+#endif
+
+        template <class T, class AF, class IF>
+        inline void scan_serial(T* first, std::size_t n, AF& f, IF&)
+        {
+#if defined(XTENSOR_USE_XSIMD)
+            using use_simd = std::integral_constant<bool, scan_traits<std::decay_t<AF>, std::decay_t<IF>>::simd_plus &&
+                                                          std::is_arithmetic<T>::value &&
+                                                          (xt_simd::simd_traits<T>::size > 1)>;
+#else
+            using use_simd = std::false_type;
+#endif
+            scan_serial_impl(first, n, f, use_simd());
+        }
+
+        template <class T, class AF, class IF, class CF>
+        inline void scan_blocks(T* first, std::size_t n, AF& f, IF& init, CF combine)
+        {
+            std::size_t n_blocks = (n + scan_block_size - 1) / scan_block_size;
+            uvector<T> offsets(n_blocks);
+            auto policy = exec::default_policy();
+            // First pass: independent scans of the blocks
+            policy.for_range(std::size_t(0), n_blocks, std::size_t(1), [&](std::size_t block_begin, std::size_t block_end)
+            {
+                for (std::size_t b = block_begin; b < block_end; ++b)
+                {
+                    T* block = first + b * scan_block_size;
+                    std::size_t size = (std::min)(scan_block_size, n - b * scan_block_size);
+                    if (b != 0)
+                    {
+                        *block = init(*block);
+                    }
+                    scan_serial(block, size, f, init);
+                }
+            });
+            // Carries of the blocks, in order
+            offsets[0] = first[scan_block_size - 1];
+            for (std::size_t b = 1; b < n_blocks - 1; ++b)
+            {
+                offsets[b] = combine(offsets[b - 1], first[(b + 1) * scan_block_size - 1]);
+            }
+            // Second pass: adds the carry of the preceding blocks
+            policy.for_range(std::size_t(1), n_blocks, std::size_t(1), [&](std::size_t block_begin, std::size_t block_end)
+            {
+                for (std::size_t b = block_begin; b < block_end; ++b)
+                {
+                    T* block = first + b * scan_block_size;
+                    std::size_t size = (std::min)(scan_block_size, n - b * scan_block_size);
+                    T carry = offsets[b - 1];
+                    std::transform(block, block + size, block, [&combine, carry](const T& v) { return combine(carry, v); });
+                }
+            });
+        }
+
+        template <class T, class AF, class IF>
+        inline void scan_contiguous(T* first, std::size_t n, AF& f, IF& init, bool parallel, std::false_type)
+        {
+            (void) parallel;
+            scan_serial(first, n, f, init);
+        }
+
+        template <class T, class AF, class IF>
+        inline void scan_contiguous(T* first, std::size_t n, AF& f, IF& init, bool parallel, std::true_type)
+        {
+            if (parallel && n >= 2 * scan_block_size)
+            {
+                using combine_type = typename scan_traits<std::decay_t<AF>, std::decay_t<IF>>::combine_type;
+                scan_blocks(first, n, f, init, combine_type());
+            }
+            else
+            {
+                scan_serial(first, n, f, init);
+            }
+        }
+
+        /**
+         * Inclusive scan, in place, of the n contiguous elements starting at
+         * first, whose first element has already been initialized.
+         */
+        template <class T, class AF, class IF>
+        inline void scan_contiguous(T* first, std::size_t n, AF& f, IF& init, bool parallel)
+        {
+            using combine_type = typename scan_traits<std::decay_t<AF>, std::decay_t<IF>>::combine_type;
+            scan_contiguous(first, n, f, init, parallel, std::integral_constant<bool, !std::is_void<combine_type>::value>());
+        }
+
+        /**
+         * Inclusive scan, in place, of the regions of n_rows rows of
+         * row_size contiguous elements starting at first, along the rows.
+         * Regions and groups of columns are independent and are distributed
+         * over the threads.
+         */
+        template <class T, class AF, class IF>
+        inline void scan_rows(T* first, std::size_t n_regions, std::size_t n_rows, std::size_t row_size,
+                              AF& f, IF& init, bool parallel)
+        {
+            std::size_t region_size = n_rows * row_size;
+            if (row_size == 1)
+            {
+                bool parallel_regions = parallel && n_regions > 1 && n_rows < 2 * scan_block_size;
+                auto scan_regions = [&](std::size_t region_begin, std::size_t region_end)
+                {
+                    for (std::size_t r = region_begin; r < region_end; ++r)
+                    {
+                        scan_contiguous(first + r * region_size, n_rows, f, init, parallel && !parallel_regions);
+                    }
+                };
+                if (parallel_regions)
+                {
+                    exec::default_policy().for_range(std::size_t(0), n_regions, std::size_t(1), scan_regions);
+                }
+                else
+                {
+                    scan_regions(0, n_regions);
+                }
+                return;
+            }
+
+            // Columns are split in groups, processed row after row
+            std::size_t group_size = (std::max)(scan_block_size / n_rows, std::size_t(64));
+            std::size_t n_groups = (row_size + group_size - 1) / group_size;
+            auto scan_groups = [&](std::size_t task_begin, std::size_t task_end)
+            {
+                for (std::size_t t = task_begin; t < task_end; ++t)
+                {
+                    T* region = first + (t / n_groups) * region_size;
+                    std::size_t col_begin = (t % n_groups) * group_size;
+                    std::size_t col_end = (std::min)(col_begin + group_size, row_size);
+                    for (std::size_t k = 1; k < n_rows; ++k)
+                    {
+                        T* prev = region + (k - 1) * row_size;
+                        T* cur = region + k * row_size;
+                        for (std::size_t c = col_begin; c < col_end; ++c)
+                        {
+                            cur[c] = f(prev[c], cur[c]);
+                        }
+                    }
+                }
+            };
+            if (parallel && n_regions * n_groups > 1)
+            {
+                exec::default_policy().for_range(std::size_t(0), n_regions * n_groups, std::size_t(1), scan_groups);
+            }
+            else
+            {
+                scan_groups(0, n_regions * n_groups);
+            }
+        }
+
         template <class F, class E>
         inline auto accumulator_init_with_f(F&& f, E& e, std::size_t axis)
         {
@@ -215,36 +452,6 @@ namespace xt
 
             if(result.shape(axis) != std::size_t(0))
             {
-                std::size_t inner_stride = static_cast<std::size_t>(result.strides()[axis]);
-                std::size_t outer_stride = 1;  // this is either going row- or column-wise (strides.back / strides.front)
-                std::size_t outer_loop_size = 0;
-                std::size_t inner_loop_size = 0;
-                std::size_t init_size = e.shape()[axis] != std::size_t(1) ? std::size_t(1) : std::size_t(0);
-
-                auto set_loop_sizes = [&outer_loop_size, &inner_loop_size, init_size](auto first, auto last, std::ptrdiff_t ax) {
-                    outer_loop_size = std::accumulate(first,
-                                                      first + ax,
-                                                      init_size, std::multiplies<std::size_t>());
-
-                    inner_loop_size = std::accumulate(first + ax,
-                                                      last,
-                                                      std::size_t(1), std::multiplies<std::size_t>());
-                };
-
-                if (result_type::static_layout == layout_type::row_major)
-                {
-                    set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis));
-                }
-                else
-                {
-                    set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis + 1));
-                    std::swap(inner_loop_size, outer_loop_size);
-                }
-
-                std::size_t pos = 0;
-
-                inner_loop_size = inner_loop_size - inner_stride;
-
                 // activate the init loop if we have an init function other than identity
                 if (!std::is_same<std::decay_t<typename F::init_functor_type>,
                                   typename detail::accumulator_identity<init_type>>::value)
@@ -252,16 +459,16 @@ namespace xt
                     accumulator_init_with_f(xt::get<1>(f), result, axis);
                 }
 
-                pos = 0;
-                for (std::size_t i = 0; i < outer_loop_size; ++i)
+                // The result is contiguous: each region holds shape(axis) rows
+                // of inner_stride elements, scanned along the rows.
+                if (result.shape(axis) != std::size_t(1) && result.size() != std::size_t(0))
                 {
-                    for (std::size_t j = 0; j < inner_loop_size; ++j)
-                    {
-                        result.storage()[pos + inner_stride] = xt::get<0>(f)(result.storage()[pos],
-                                                                             result.storage()[pos + inner_stride]);
-                        pos += outer_stride;
-                    }
-                    pos += inner_stride;
+                    std::size_t inner_stride = static_cast<std::size_t>(result.strides()[axis]);
+                    std::size_t n_regions = result.size() / (result.shape(axis) * inner_stride);
+                    auto accumulate_fct = xt::get<0>(f);
+                    auto init_fct = xt::get<1>(f);
+                    detail::scan_rows(result.data(), n_regions, result.shape(axis), inner_stride,
+                                      accumulate_fct, init_fct, detail::use_parallel_scan(result.size()));
                 }
             }
             return result;
@@ -283,15 +490,12 @@ namespace xt
 
             if(sz != std::size_t(0))
             {
-                auto it = e.template begin<XTENSOR_DEFAULT_TRAVERSAL>();
-                result.storage()[0] = xt::get<1>(f)(*it);
-                ++it;
-
-                for (std::size_t idx = 0; it != e.template end<XTENSOR_DEFAULT_TRAVERSAL>(); ++it)
-                {
-                    result.storage()[idx + 1] = xt::get<0>(f)(result.storage()[idx], *it);
-                    ++idx;
-                }
+                auto accumulate_fct = xt::get<0>(f);
+                auto init_fct = xt::get<1>(f);
+                std::transform(e.template begin<XTENSOR_DEFAULT_TRAVERSAL>(), e.template end<XTENSOR_DEFAULT_TRAVERSAL>(),
+                               result.data(), [](const auto& v) { return static_cast<return_type>(v); });
+                result.data()[0] = init_fct(result.data()[0]);
+                detail::scan_contiguous(result.data(), sz, accumulate_fct, init_fct, detail::use_parallel_scan(sz));
             }
             return result;
         }
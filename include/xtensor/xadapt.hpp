@@ -13,7 +13,9 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
@@ -726,6 +728,119 @@ namespace xt
             l
         );
     }
+
+    /*****************
+     * adopt builder *
+     *****************/
+
+    namespace detail
+    {
+        template <class S>
+        inline void check_adopted_size(std::size_t size, const S& shape)
+        {
+            if (size != compute_size(shape))
+            {
+                XTENSOR_THROW(std::runtime_error, "adopt: the size of the buffer does not match the shape");
+            }
+        }
+    }
+
+    /**
+     * Constructs an xarray_container owning the elements of a moved
+     * std::vector, without copying them: the vector becomes the storage
+     * of the container, which has the value semantics of an xarray and
+     * can be resized. The vector can be moved back out of the container
+     * with std::move(a.storage()), which makes producer to consumer
+     * handoffs O(1) in both directions.
+     *
+     * \code{.cpp}
+     * std::vector<float> v = produce();
+     * auto a = xt::adopt(std::move(v), std::vector<std::size_t>{n_rows, n_cols});
+     * \endcode
+     *
+     * @param v the vector to adopt, whose size must be the size of the shape
+     * @param shape the shape of the container
+     * @tparam L the layout of the container, row_major or column_major
+     * @return xarray_container on std::vector<T, A>
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class T, class A, class SC,
+              XTL_REQUIRES(detail::not_an_array<std::decay_t<SC>>)>
+    inline auto adopt(std::vector<T, A>&& v, const SC& shape)
+    {
+        static_assert(L == layout_type::row_major || L == layout_type::column_major,
+                      "adopted containers must be row_major or column_major");
+        using return_type = xarray_container<std::vector<T, A>, L>;
+        using shape_type = typename return_type::inner_shape_type;
+        using strides_type = typename return_type::inner_strides_type;
+        detail::check_adopted_size(v.size(), shape);
+        shape_type sh(std::begin(shape), std::end(shape));
+        strides_type strides(sh.size());
+        compute_strides(sh, L, strides);
+        return return_type(std::move(v), std::move(sh), std::move(strides));
+    }
+
+    /**
+     * Constructs an xtensor_container owning the elements of a moved
+     * std::vector, without copying them.
+     *
+     * @param v the vector to adopt, whose size must be the size of the shape
+     * @param shape the shape of the container
+     * @tparam L the layout of the container, row_major or column_major
+     * @return xtensor_container on std::vector<T, A>
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class T, class A, class I, std::size_t N>
+    inline auto adopt(std::vector<T, A>&& v, const I (&shape)[N])
+    {
+        static_assert(L == layout_type::row_major || L == layout_type::column_major,
+                      "adopted containers must be row_major or column_major");
+        using return_type = xtensor_container<std::vector<T, A>, N, L>;
+        using shape_type = typename return_type::inner_shape_type;
+        using strides_type = typename return_type::inner_strides_type;
+        shape_type sh = xtl::forward_sequence<shape_type, decltype(shape)>(shape);
+        detail::check_adopted_size(v.size(), sh);
+        strides_type strides;
+        compute_strides(sh, L, strides);
+        return return_type(std::move(v), std::move(sh), std::move(strides));
+    }
+
+    /**
+     * Constructs an xarray_adaptor owning an array allocated by a producer,
+     * without copying its elements. The array is released with the deleter
+     * of the unique_ptr when the last copy of the adaptor is destroyed;
+     * the adaptor cannot be resized.
+     *
+     * @param ptr the array to adopt, holding at least the size of the shape
+     * @param shape the shape of the adaptor
+     * @param l the layout of the adaptor
+     * @return xarray_adaptor owning the array
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class T, class D, class SC,
+              XTL_REQUIRES(detail::not_an_array<std::decay_t<SC>>)>
+    inline auto adopt(std::unique_ptr<T[], D>&& ptr, const SC& shape, layout_type l = L)
+    {
+        D deleter = std::move(ptr.get_deleter());
+        T* data = ptr.release();
+        std::shared_ptr<T> owner(data, std::move(deleter));
+        return adapt_smart_ptr<L>(std::move(data), shape, std::move(owner), l);
+    }
+
+    /**
+     * Constructs an xtensor_adaptor owning an array allocated by a producer,
+     * without copying its elements.
+     *
+     * @param ptr the array to adopt, holding at least the size of the shape
+     * @param shape the shape of the adaptor
+     * @param l the layout of the adaptor
+     * @return xtensor_adaptor owning the array
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class T, class D, class I, std::size_t N>
+    inline auto adopt(std::unique_ptr<T[], D>&& ptr, const I (&shape)[N], layout_type l = L)
+    {
+        D deleter = std::move(ptr.get_deleter());
+        T* data = ptr.release();
+        std::shared_ptr<T> owner(data, std::move(deleter));
+        return adapt_smart_ptr<L>(std::move(data), shape, std::move(owner), l);
+    }
 }
 
 #endif
@@ -0,0 +1,395 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ARENA_HPP
+#define XTENSOR_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "xstorage.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /**********
+     * xarena *
+     **********/
+
+    /**
+     * @class xarena
+     * @brief Bump allocator handing out memory from a list of blocks.
+     *
+     * Allocations only move an offset in the current block; the memory is
+     * given back all at once by rewinding the arena to a previous marker.
+     * The blocks are kept when the arena is rewound, so that an arena used
+     * repeatedly for the same work stops allocating after the first run.
+     * An arena is not thread-safe; each thread uses its own through
+     * arena_scope.
+     */
+    class xarena
+    {
+    public:
+
+        struct marker
+        {
+            std::size_t block;
+            std::size_t offset;
+        };
+
+        explicit xarena(std::size_t block_size = std::size_t(1) << 16);
+
+        xarena(const xarena&) = delete;
+        xarena& operator=(const xarena&) = delete;
+
+        xarena(xarena&&) = default;
+        xarena& operator=(xarena&&) = default;
+
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        marker mark() const noexcept;
+        void rewind(const marker& m) noexcept;
+        void reset();
+        void release() noexcept;
+
+        std::size_t used() const noexcept;
+        std::size_t capacity() const noexcept;
+        std::size_t block_count() const noexcept;
+
+        static xarena* current() noexcept;
+
+    private:
+
+        struct block
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t size;
+        };
+
+        static xarena*& current_ptr() noexcept;
+
+        std::vector<block> m_blocks;
+        std::size_t m_block_size;
+        std::size_t m_current;
+        std::size_t m_offset;
+
+        friend class arena_scope;
+    };
+
+    xarena& thread_arena();
+
+    /***************
+     * arena_scope *
+     ***************/
+
+    /**
+     * @class arena_scope
+     * @brief Makes an arena the source of the arena allocations of the
+     * calling thread until the end of the scope.
+     *
+     * The memory allocated from the arena in the scope is given back when
+     * the scope exits; scopes can be nested, each one releasing its own
+     * allocations only. The containers allocated in the scope must not
+     * outlive it.
+     */
+    class arena_scope
+    {
+    public:
+
+        arena_scope();
+        explicit arena_scope(xarena& arena) noexcept;
+        ~arena_scope();
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+
+        xarena& arena() const noexcept;
+
+    private:
+
+        xarena* p_arena;
+        xarena* p_previous;
+        xarena::marker m_mark;
+    };
+
+    /*******************
+     * arena_allocator *
+     *******************/
+
+    /**
+     * @class arena_allocator
+     * @brief Allocator taking its memory from the arena of the innermost
+     * arena_scope of the calling thread, and from the heap outside of any
+     * scope.
+     *
+     * Deallocating memory that comes from an arena does nothing, it is
+     * given back at the end of the scope; memory obtained from the heap
+     * is freed as usual, so that containers created outside of a scope
+     * can be resized or destroyed in it. xtensor uses it for the internal
+     * buffers of sorts and reductions, through arena_uvector.
+     */
+    template <class T>
+    class arena_allocator
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        arena_allocator() noexcept = default;
+
+        template <class U>
+        arena_allocator(const arena_allocator<U>&) noexcept;
+
+        T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n) noexcept;
+    };
+
+    template <class T, class U>
+    bool operator==(const arena_allocator<T>&, const arena_allocator<U>&) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&) noexcept;
+
+    template <class T>
+    using arena_uvector = uvector<T, arena_allocator<T>>;
+
+    /*************************
+     * xarena implementation *
+     *************************/
+
+    inline xarena::xarena(std::size_t block_size)
+        : m_block_size((std::max)(block_size, std::size_t(1))), m_current(0), m_offset(0)
+    {
+    }
+
+    /**
+     * Returns \c size bytes aligned on \c alignment, a power of two not
+     * greater than alignof(std::max_align_t). A new block is added when the
+     * free blocks are too small, at least twice as large as the last one.
+     */
+    inline void* xarena::allocate(std::size_t size, std::size_t alignment)
+    {
+        while (m_current < m_blocks.size())
+        {
+            std::size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+            if (offset <= m_blocks[m_current].size && size <= m_blocks[m_current].size - offset)
+            {
+                m_offset = offset + size;
+                return m_blocks[m_current].data.get() + offset;
+            }
+            if (m_current + 1 == m_blocks.size())
+            {
+                break;
+            }
+            ++m_current;
+            m_offset = 0;
+        }
+
+        std::size_t block_size = m_blocks.empty() ? m_block_size : 2 * m_blocks.back().size;
+        block_size = (std::max)(block_size, size);
+        m_blocks.push_back(block{std::unique_ptr<char[]>(new char[block_size]), block_size});
+        m_current = m_blocks.size() - 1;
+        m_offset = size;
+        return m_blocks.back().data.get();
+    }
+
+    inline auto xarena::mark() const noexcept -> marker
+    {
+        return {m_current, m_offset};
+    }
+
+    /**
+     * Gives back the memory allocated since \c m was taken.
+     */
+    inline void xarena::rewind(const marker& m) noexcept
+    {
+        m_current = m.block;
+        m_offset = m.offset;
+    }
+
+    /**
+     * Gives back all the memory of the arena. When it is made of several
+     * blocks, they are replaced with a single one of their total size.
+     */
+    inline void xarena::reset()
+    {
+        if (m_blocks.size() > 1)
+        {
+            std::size_t size = capacity();
+            m_blocks.clear();
+            m_blocks.push_back(block{std::unique_ptr<char[]>(new char[size]), size});
+        }
+        m_current = 0;
+        m_offset = 0;
+    }
+
+    /**
+     * Frees the blocks of the arena.
+     */
+    inline void xarena::release() noexcept
+    {
+        m_blocks.clear();
+        m_current = 0;
+        m_offset = 0;
+    }
+
+    inline std::size_t xarena::used() const noexcept
+    {
+        std::size_t res = m_offset;
+        for (std::size_t i = 0; i < m_current && i < m_blocks.size(); ++i)
+        {
+            res += m_blocks[i].size;
+        }
+        return res;
+    }
+
+    inline std::size_t xarena::capacity() const noexcept
+    {
+        std::size_t res = 0;
+        for (const auto& b : m_blocks)
+        {
+            res += b.size;
+        }
+        return res;
+    }
+
+    inline std::size_t xarena::block_count() const noexcept
+    {
+        return m_blocks.size();
+    }
+
+    /**
+     * Returns the arena of the innermost arena_scope of the calling thread,
+     * or nullptr outside of any scope.
+     */
+    inline xarena* xarena::current() noexcept
+    {
+        return current_ptr();
+    }
+
+    inline xarena*& xarena::current_ptr() noexcept
+    {
+        static thread_local xarena* p_current = nullptr;
+        return p_current;
+    }
+
+    /**
+     * Returns the arena of the calling thread used by the default arena_scope.
+     */
+    inline xarena& thread_arena()
+    {
+        static thread_local xarena arena;
+        return arena;
+    }
+
+    /******************************
+     * arena_scope implementation *
+     ******************************/
+
+    inline arena_scope::arena_scope()
+        : arena_scope(thread_arena())
+    {
+    }
+
+    inline arena_scope::arena_scope(xarena& arena) noexcept
+        : p_arena(&arena), p_previous(xarena::current_ptr()), m_mark(arena.mark())
+    {
+        xarena::current_ptr() = p_arena;
+    }
+
+    inline arena_scope::~arena_scope()
+    {
+        xarena::current_ptr() = p_previous;
+        if (m_mark.block == 0 && m_mark.offset == 0)
+        {
+            p_arena->reset();
+        }
+        else
+        {
+            p_arena->rewind(m_mark);
+        }
+    }
+
+    inline xarena& arena_scope::arena() const noexcept
+    {
+        return *p_arena;
+    }
+
+    /**********************************
+     * arena_allocator implementation *
+     **********************************/
+
+    namespace detail
+    {
+        // Each allocation is preceded by a header telling whether it comes
+        // from an arena or from the heap
+        constexpr std::size_t arena_header_size = alignof(std::max_align_t);
+
+        enum class arena_origin : unsigned char
+        {
+            heap,
+            arena
+        };
+    }
+
+    template <class T>
+    template <class U>
+    inline arena_allocator<T>::arena_allocator(const arena_allocator<U>&) noexcept
+    {
+    }
+
+    template <class T>
+    inline T* arena_allocator<T>::allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= detail::arena_header_size, "arena_allocator does not support over-aligned types");
+        if (n > (std::numeric_limits<std::size_t>::max() - detail::arena_header_size) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        std::size_t size = n * sizeof(T) + detail::arena_header_size;
+        xarena* arena = xarena::current();
+        char* p = static_cast<char*>(arena == nullptr ? ::operator new(size) : arena->allocate(size, detail::arena_header_size));
+        *reinterpret_cast<detail::arena_origin*>(p) = arena == nullptr ? detail::arena_origin::heap : detail::arena_origin::arena;
+        return reinterpret_cast<T*>(p + detail::arena_header_size);
+    }
+
+    template <class T>
+    inline void arena_allocator<T>::deallocate(T* p, std::size_t) noexcept
+    {
+        char* q = reinterpret_cast<char*>(p) - detail::arena_header_size;
+        if (*reinterpret_cast<detail::arena_origin*>(q) == detail::arena_origin::heap)
+        {
+            ::operator delete(q);
+        }
+    }
+
+    template <class T, class U>
+    inline bool operator==(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
@@ -11,28 +11,100 @@
 #define XTENSOR_ASSIGN_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
-#include <functional>
+#include <vector>
 
 #include <xtl/xcomplex.hpp>
 #include <xtl/xsequence.hpp>
 
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xiterator.hpp"
 #include "xstrides.hpp"
 #include "xtensor_config.hpp"
 #include "xtensor_forward.hpp"
 #include "xutils.hpp"
+#include "xbit_vector.hpp"
+#include "xdispatch.hpp"
 #include "xfunction.hpp"
-
-#if defined(XTENSOR_USE_TBB)
-#include <tbb/tbb.h>
-#endif
+#include "xhalf.hpp"
 
 namespace xt
 {
 
+    /******************
+     * assign_tracing *
+     ******************/
+
+    /**
+     * Instrumentation of the assignment path. When xtensor is compiled with
+     * XTENSOR_ASSIGN_TRACING defined and tracing is enabled, every assignment
+     * of an xtensor expression reports the assigner that ran, the number of
+     * elements and bytes written and its duration to the registered
+     * callbacks. Without the macro, assignments are not instrumented.
+     */
+    namespace assign_tracing
+    {
+        enum class strategy
+        {
+            linear_simd,
+            linear,
+            fixed,
+            tiled,
+            reversed,
+            strided_loop,
+            stepper,
+            device
+        };
+
+        const char* to_string(strategy s) noexcept;
+
+        struct record
+        {
+            /// Assigner that performed the assignment.
+            strategy kind = strategy::stepper;
+            /// Type of the assigned expression.
+            const std::type_info* lhs_type = nullptr;
+            /// Type of the expression being assigned, identifying the call site.
+            const std::type_info* rhs_type = nullptr;
+            /// Number of elements written.
+            std::size_t size = 0;
+            /// Number of bytes written.
+            std::size_t bytes = 0;
+            /// Whether the shapes were broadcast trivially.
+            bool trivial_broadcast = false;
+            /// Wall time of the assignment loop.
+            std::chrono::nanoseconds duration = std::chrono::nanoseconds(0);
+        };
+
+        using callback_type = std::function<void(const record&)>;
+        using callback_id = std::size_t;
+
+        callback_id add_callback(callback_type callback);
+        void remove_callback(callback_id id);
+        void clear_callbacks();
+
+        bool enabled() noexcept;
+        void enable() noexcept;
+        void disable() noexcept;
+    }
+
+#if defined(XTENSOR_ASSIGN_TRACING)
+#define XTENSOR_ASSIGN_TRACE(kind) ::xt::assign_tracing::detail::set_strategy(::xt::assign_tracing::strategy::kind)
+#else
+#define XTENSOR_ASSIGN_TRACE(kind)
+#endif
+
     /********************
      * Assign functions *
      ********************/
@@ -40,9 +112,15 @@ namespace xt
     template <class E1, class E2>
     void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
 
+    template <class E1, class E2, class P>
+    void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, const P& policy);
+
     template <class E1, class E2>
     void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2);
 
+    template <class E1, class E2, class P>
+    void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2, const P& policy);
+
     template <class E1, class E2>
     void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2);
 
@@ -58,6 +136,12 @@ namespace xt
     template <class E1, class E2>
     void strided_assign(E1& e1, const E2& e2, std::true_type /*enable*/);
 
+    template <class... E1, class... E2>
+    void assign_all(std::tuple<E1&...> e1, const std::tuple<E2...>& e2);
+
+    template <class... E1, class... E2, class P>
+    void assign_all(std::tuple<E1&...> e1, const std::tuple<E2...>& e2, const P& policy);
+
     /************************
      * xexpression_assigner *
      ************************/
@@ -72,6 +156,9 @@ namespace xt
 
         template <class E1, class E2>
         static void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
+
+        template <class E1, class E2, class P>
+        static void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, const P& policy);
     };
 
     template <class Tag>
@@ -84,6 +171,9 @@ namespace xt
         template <class E1, class E2>
         static void assign_xexpression(E1& e1, const E2& e2);
 
+        template <class E1, class E2, class P>
+        static void assign_xexpression(E1& e1, const E2& e2, const P& policy);
+
         template <class E1, class E2>
         static void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2);
 
@@ -93,14 +183,13 @@ namespace xt
         template <class E1, class E2>
         static void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2);
 
-    private:
-
+        // Resizes e1 to the broadcast shape of e2 and returns whether the
+        // broadcasting is trivial.
         template <class E1, class E2>
         static bool resize(E1& e1, const E2& e2);
 
         template <class E1, class F, class... CT>
         static bool resize(E1& e1, const xfunction<F, CT...>& e2);
-
     };
 
     /********************
@@ -150,6 +239,9 @@ namespace xt
 
         template <class E1, class E2>
         static void run(E1& e1, const E2& e2);
+
+        template <class E1, class E2, class P>
+        static void run(E1& e1, const E2& e2, const P& policy);
     };
 
     template <>
@@ -160,13 +252,66 @@ namespace xt
         template <class E1, class E2>
         static void run(E1& e1, const E2& e2);
 
+        template <class E1, class E2, class P>
+        static void run(E1& e1, const E2& e2, const P& policy);
+
+    private:
+
+        template <class E1, class E2, class P>
+        static void run_impl(E1& e1, const E2& e2, const P& policy, std::true_type);
+
+        template <class E1, class E2, class P>
+        static void run_impl(E1& e1, const E2& e2, const P& policy, std::false_type);
+    };
+
+    /*************************
+     * fixed_linear_assigner *
+     *************************/
+
+    // Linear assignment to a destination whose size is known at compile
+    // time and does not exceed XTENSOR_FIXED_ASSIGN_MAX_SIZE, such as a
+    // small xtensor_fixed. The loops run over a constant number of elements,
+    // without alignment peeling nor splitting for an execution policy, so
+    // that the compiler unrolls them completely.
+    // run returns false when the destination is not eligible, in which case
+    // nothing is assigned.
+    template <bool fixed>
+    class fixed_linear_assigner
+    {
+    public:
+
+        template <class E1, class E2>
+        static bool run(E1& e1, const E2& e2);
+
     private:
 
         template <class E1, class E2>
-        static void run_impl(E1& e1, const E2& e2, std::true_type);
+        static void run_impl(E1& e1, const E2& e2, std::true_type /*simd*/);
+
+        template <class E1, class E2>
+        static void run_impl(E1& e1, const E2& e2, std::false_type /*simd*/);
+    };
+
+    /*******************
+     * device_assigner *
+     *******************/
+
+    // Linear assignment of an expression of device containers, lowered to
+    // a kernel run by the device of the destination (see xdevice.hpp, which
+    // specializes is_device_assignable). run returns false when the
+    // expression is not eligible, in which case nothing is assigned.
+    template <class E1, class E2, class = void>
+    struct is_device_assignable : std::false_type
+    {
+    };
+
+    template <bool device>
+    class device_assigner
+    {
+    public:
 
         template <class E1, class E2>
-        static void run_impl(E1& e1, const E2& e2, std::false_type);
+        static bool run(E1& e1, const E2& e2);
     };
 
     /*************************
@@ -180,6 +325,48 @@ namespace xt
 
         template <class E1, class E2>
         static void run(E1& e1, const E2& e2);
+
+        template <class E1, class E2, class P>
+        static void run(E1& e1, const E2& e2, const P& policy);
+    };
+
+    /******************
+     * tiled_assigner *
+     ******************/
+
+    // Copies between two expressions with a data interface whose fastest
+    // varying dimensions differ (e.g. row_major to column_major, or a
+    // transposed view into a fresh container), walking both sides in
+    // XTENSOR_ASSIGN_TILE_SIZE x XTENSOR_ASSIGN_TILE_SIZE blocks.
+    // run returns false when the expressions are not eligible, in which
+    // case nothing is assigned.
+    template <bool tiled>
+    class tiled_assigner
+    {
+    public:
+
+        template <class E1, class E2, class P>
+        static bool run(E1& e1, const E2& e2, const P& policy);
+    };
+
+    /*********************
+     * reversed_assigner *
+     *********************/
+
+    // Copies between two expressions with a data interface sharing their
+    // fastest varying dimension, when one of them walks it with a stride
+    // of -1 (e.g. a flipped view, or a destination reversed along its
+    // last axis). Each row is copied by a plain loop over pointers, that
+    // the compiler vectorizes with a permutation of the registers.
+    // run returns false when the expressions are not eligible, in which
+    // case nothing is assigned.
+    template <bool reversed>
+    class reversed_assigner
+    {
+    public:
+
+        template <class E1, class E2, class P>
+        static bool run(E1& e1, const E2& e2, const P& policy);
     };
 
     /***********************************
@@ -193,6 +380,20 @@ namespace xt
         xexpression_assigner<tag>::assign_data(e1, e2, trivial);
     }
 
+    /**
+     * Assigns \c e2 to \c e1 and distributes the work according to \c policy.
+     * @param e1 the destination expression.
+     * @param e2 the expression to assign.
+     * @param trivial true if the broadcasting of \c e2 in \c e1 is trivial.
+     * @param policy the execution policy, one of \c exec::seq or the result of \c exec::par.
+     */
+    template <class E1, class E2, class P>
+    inline void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, const P& policy)
+    {
+        using tag = xexpression_tag_t<E1, E2>;
+        xexpression_assigner<tag>::assign_data(e1, e2, trivial, policy);
+    }
+
     template <class E1, class E2>
     inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
@@ -206,6 +407,24 @@ namespace xt
         });
     }
 
+    /**
+     * Resizes \c e1 to the shape of \c e2 and assigns \c e2 to it,
+     * distributing the work according to \c policy. Expressions that
+     * provide their own assign_to method ignore the policy.
+     */
+    template <class E1, class E2, class P>
+    inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2, const P& policy)
+    {
+        xtl::mpl::static_if<has_assign_to<E1, E2>::value>([&](auto self)
+        {
+            self(e2).derived_cast().assign_to(e1);
+        }, /*else*/ [&](auto /*self*/)
+        {
+            using tag = xexpression_tag_t<E1, E2>;
+            xexpression_assigner<tag>::assign_xexpression(e1, e2, policy);
+        });
+    }
+
     template <class E1, class E2>
     inline void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
@@ -294,6 +513,30 @@ namespace xt
             static constexpr bool value = xtl::conjunction<use_strided_loop<std::decay_t<CT>>...>::value;
         };
 
+        // The steppers of a broadcast are the ones of its expression,
+        // which already step over the broadcast dimensions
+        template <class CT, class X>
+        struct use_strided_loop<xbroadcast<CT, X>>
+        {
+            static constexpr bool value = use_strided_loop<std::decay_t<CT>>::value;
+        };
+
+        template <class T, class = void>
+        struct use_tiled_assign : std::false_type
+        {
+        };
+
+        // The storage itself must expose a raw pointer: some adaptors only
+        // provide an iterator-returning data() method.
+        template <class T>
+        struct use_tiled_assign<T, void_t<decltype(std::declval<const T&>().data()),
+                                          decltype(std::declval<const T&>().data_offset()),
+                                          decltype(std::declval<const T&>().strides()),
+                                          decltype(std::declval<const T&>().storage().data())>>
+            : std::is_pointer<decltype(std::declval<const T&>().storage().data())>
+        {
+        };
+
         /**
          * Considering the assigment LHS = RHS, if the requested value type used for
          * loading simd from RHS is not complex while LHS value_type is complex,
@@ -320,6 +563,56 @@ namespace xt
 
         template <class T1, class T2>
         using conditional_promote_to_complex_t = typename conditional_promote_to_complex<T1, T2>::type;
+
+        /**
+         * The operators promote the integers narrower than int, so that
+         * xt::xarray<uint8_t> = a & b would be vectorized on batches of int.
+         * When the RHS only combines operands of the value type of the LHS
+         * and integral scalars with wrapping functors, its truncation is
+         * computed in the type of the LHS instead, which packs more elements
+         * in each batch.
+         */
+        template <class T, class E>
+        struct is_wrapping_expression : std::is_same<T, typename E::value_type>
+        {
+        };
+
+        template <class T, class CT>
+        struct is_wrapping_expression<T, xscalar<CT>> : std::is_integral<std::decay_t<CT>>
+        {
+        };
+
+        template <class T, class F, class... CT>
+        struct is_wrapping_expression<T, xfunction<F, CT...>>
+            : xtl::conjunction<is_wrapping_functor<F>, is_wrapping_expression<T, std::decay_t<CT>>...>
+        {
+        };
+
+        template <class T, class E>
+        struct use_narrow_integer_load
+            : xtl::conjunction<std::is_integral<T>,
+                               xtl::negation<std::is_same<T, bool>>,
+                               std::integral_constant<bool, (sizeof(T) < sizeof(int))>,
+                               is_wrapping_expression<T, E>>
+        {
+        };
+    }
+
+    namespace detail
+    {
+        template <class S>
+        struct fixed_compute_size;
+
+        template <class S>
+        struct is_small_fixed : std::false_type
+        {
+        };
+
+        template <std::size_t... X>
+        struct is_small_fixed<fixed_shape<X...>>
+            : std::integral_constant<bool, (fixed_compute_size<fixed_shape<X...>>::value <= XTENSOR_FIXED_ASSIGN_MAX_SIZE)>
+        {
+        };
     }
 
     template <class E1, class E2>
@@ -356,20 +649,235 @@ namespace xt
         static constexpr bool strided_assign() { return detail::use_strided_loop<E1>::value && detail::use_strided_loop<E2>::value; }
         static constexpr bool simd_linear_assign() { return contiguous_layout() && simd_assign(); }
         static constexpr bool simd_strided_assign() { return strided_assign() && simd_assign(); }
+        static constexpr bool tiled_assign() { return detail::use_tiled_assign<E1>::value && detail::use_tiled_assign<E2>::value
+                                                        && std::is_convertible<e2_value_type, e1_value_type>::value; }
 
         static constexpr bool simd_linear_assign(const E1& e1, const E2& e2) { return simd_assign()
                                                                                 && detail::linear_dynamic_layout(e1, e2); }
+        static constexpr bool fixed_assign() { return detail::is_small_fixed<typename E1::shape_type>::value
+                                                        && std::is_convertible<e2_value_type, e1_value_type>::value; }
+        static constexpr bool device_assign() { return is_device_assignable<E1, E2>::value; }
 
         using e2_requested_value_type = std::conditional_t<is_bool<e2_value_type>::value,
                                                            typename E2::bool_load_type,
                                                            e2_value_type>;
-        using requested_value_type = detail::conditional_promote_to_complex_t<e1_value_type,
-                                                                              e2_requested_value_type>;
+        using requested_value_type = std::conditional_t<detail::use_narrow_integer_load<e1_value_type, E2>::value,
+                                                        e1_value_type,
+                                                        detail::conditional_promote_to_complex_t<e1_value_type,
+                                                                                                 e2_requested_value_type>>;
 
     };
 
+    /*********************************
+     * assign_tracing implementation *
+     *********************************/
+
+    namespace assign_tracing
+    {
+        namespace detail
+        {
+            struct registry
+            {
+                std::mutex m_mutex;
+                // Copied on write so that notifications do not hold the lock
+                // while running the callbacks.
+                std::shared_ptr<const std::vector<std::pair<callback_id, callback_type>>> p_callbacks
+                    = std::make_shared<const std::vector<std::pair<callback_id, callback_type>>>();
+                callback_id m_next_id = 0;
+                std::atomic<bool> m_enabled{false};
+            };
+
+            inline registry& get_registry()
+            {
+                static registry r;
+                return r;
+            }
+
+            inline void notify(const record& r)
+            {
+                registry& reg = get_registry();
+                std::shared_ptr<const std::vector<std::pair<callback_id, callback_type>>> callbacks;
+                {
+                    std::lock_guard<std::mutex> lock(reg.m_mutex);
+                    callbacks = reg.p_callbacks;
+                }
+                for (const auto& c : *callbacks)
+                {
+                    c.second(r);
+                }
+            }
+
+            /**
+             * Measures an assignment. Assigners deeper in the call refine
+             * the strategy through set_strategy. Nothing is reported if the
+             * assignment throws.
+             */
+            class trace_scope
+            {
+            public:
+
+                template <class E1, class E2>
+                trace_scope(const E1& e1, const E2& e2, bool trivial);
+                ~trace_scope();
+
+                trace_scope(const trace_scope&) = delete;
+                trace_scope& operator=(const trace_scope&) = delete;
+
+                void finish();
+
+                static trace_scope*& current() noexcept;
+
+                record m_record;
+
+            private:
+
+                trace_scope* p_previous;
+                std::chrono::steady_clock::time_point m_start;
+                bool m_active;
+            };
+
+            template <class E1, class E2>
+            inline trace_scope::trace_scope(const E1& e1, const E2&, bool trivial)
+                : m_record(), p_previous(nullptr), m_start(), m_active(enabled())
+            {
+                if (m_active)
+                {
+                    m_record.lhs_type = &typeid(E1);
+                    m_record.rhs_type = &typeid(E2);
+                    m_record.size = static_cast<std::size_t>(e1.size());
+                    m_record.bytes = m_record.size * sizeof(typename E1::value_type);
+                    m_record.trivial_broadcast = trivial;
+                    p_previous = current();
+                    current() = this;
+                    m_start = std::chrono::steady_clock::now();
+                }
+            }
+
+            inline trace_scope::~trace_scope()
+            {
+                if (m_active)
+                {
+                    current() = p_previous;
+                }
+            }
+
+            inline void trace_scope::finish()
+            {
+                if (m_active)
+                {
+                    m_record.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+                    current() = p_previous;
+                    m_active = false;
+                    notify(m_record);
+                }
+            }
+
+            inline trace_scope*& trace_scope::current() noexcept
+            {
+                static thread_local trace_scope* p = nullptr;
+                return p;
+            }
+
+            inline void set_strategy(strategy s) noexcept
+            {
+                trace_scope* scope = trace_scope::current();
+                if (scope != nullptr)
+                {
+                    scope->m_record.kind = s;
+                }
+            }
+        }
+
+        /**
+         * Returns the name of the assigner \c s.
+         */
+        inline const char* to_string(strategy s) noexcept
+        {
+            switch (s)
+            {
+                case strategy::linear_simd:
+                    return "linear_simd";
+                case strategy::linear:
+                    return "linear";
+                case strategy::fixed:
+                    return "fixed";
+                case strategy::tiled:
+                    return "tiled";
+                case strategy::reversed:
+                    return "reversed";
+                case strategy::strided_loop:
+                    return "strided_loop";
+                case strategy::device:
+                    return "device";
+                default:
+                    return "stepper";
+            }
+        }
+
+        /**
+         * Registers \c callback, called after every traced assignment on the
+         * thread that performed it. Callbacks must not throw.
+         * @return an identifier to pass to remove_callback.
+         */
+        inline callback_id add_callback(callback_type callback)
+        {
+            detail::registry& reg = detail::get_registry();
+            std::lock_guard<std::mutex> lock(reg.m_mutex);
+            auto callbacks = std::make_shared<std::vector<std::pair<callback_id, callback_type>>>(*reg.p_callbacks);
+            callback_id id = reg.m_next_id++;
+            callbacks->emplace_back(id, std::move(callback));
+            reg.p_callbacks = std::move(callbacks);
+            return id;
+        }
+
+        /**
+         * Unregisters the callback identified by \c id.
+         */
+        inline void remove_callback(callback_id id)
+        {
+            detail::registry& reg = detail::get_registry();
+            std::lock_guard<std::mutex> lock(reg.m_mutex);
+            auto callbacks = std::make_shared<std::vector<std::pair<callback_id, callback_type>>>(*reg.p_callbacks);
+            callbacks->erase(std::remove_if(callbacks->begin(), callbacks->end(),
+                                            [id](const std::pair<callback_id, callback_type>& c) { return c.first == id; }),
+                             callbacks->end());
+            reg.p_callbacks = std::move(callbacks);
+        }
+
+        /**
+         * Unregisters all the callbacks.
+         */
+        inline void clear_callbacks()
+        {
+            detail::registry& reg = detail::get_registry();
+            std::lock_guard<std::mutex> lock(reg.m_mutex);
+            reg.p_callbacks = std::make_shared<const std::vector<std::pair<callback_id, callback_type>>>();
+        }
+
+        inline bool enabled() noexcept
+        {
+            return detail::get_registry().m_enabled.load(std::memory_order_relaxed);
+        }
+
+        inline void enable() noexcept
+        {
+            detail::get_registry().m_enabled.store(true, std::memory_order_relaxed);
+        }
+
+        inline void disable() noexcept
+        {
+            detail::get_registry().m_enabled.store(false, std::memory_order_relaxed);
+        }
+    }
+
     template <class E1, class E2>
     inline void xexpression_assigner_base<xtensor_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
+    {
+        assign_data(e1, e2, trivial, exec::default_policy());
+    }
+
+    template <class E1, class E2, class P>
+    inline void xexpression_assigner_base<xtensor_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, const P& policy)
     {
         E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
@@ -379,7 +887,18 @@ namespace xt
         constexpr bool simd_assign = traits::simd_assign();
         constexpr bool simd_linear_assign = traits::simd_linear_assign();
         constexpr bool simd_strided_assign = traits::simd_strided_assign();
-        if (linear_assign)
+#if defined(XTENSOR_ASSIGN_TRACING)
+        assign_tracing::detail::trace_scope trace(de1, de2, trivial);
+#endif
+        if (linear_assign && device_assigner<traits::device_assign()>::run(de1, de2))
+        {
+            XTENSOR_ASSIGN_TRACE(device);
+        }
+        else if (linear_assign && fixed_linear_assigner<traits::fixed_assign()>::run(de1, de2))
+        {
+            XTENSOR_ASSIGN_TRACE(fixed);
+        }
+        else if (linear_assign)
         {
             if(simd_linear_assign || traits::simd_linear_assign(de1, de2))
             {
@@ -388,22 +907,37 @@ namespace xt
                 // in compilation error for expressions that do not provide a SIMD interface.
                 // simd_assign is true if simd_linear_assign() or simd_linear_assign(de1, de2)
                 // is true.
-                linear_assigner<simd_assign>::run(de1, de2);
+                XTENSOR_ASSIGN_TRACE(linear_simd);
+                linear_assigner<simd_assign>::run(de1, de2, policy);
             }
             else
             {
-                linear_assigner<false>::run(de1, de2);
+                XTENSOR_ASSIGN_TRACE(linear);
+                linear_assigner<false>::run(de1, de2, policy);
             }
         }
+        else if (tiled_assigner<traits::tiled_assign()>::run(de1, de2, policy))
+        {
+            XTENSOR_ASSIGN_TRACE(tiled);
+        }
+        else if (reversed_assigner<traits::tiled_assign()>::run(de1, de2, policy))
+        {
+            XTENSOR_ASSIGN_TRACE(reversed);
+        }
         else if (simd_strided_assign)
         {
-            strided_loop_assigner<simd_strided_assign>::run(de1, de2);
+            XTENSOR_ASSIGN_TRACE(strided_loop);
+            strided_loop_assigner<simd_strided_assign>::run(de1, de2, policy);
         }
         else
         {
+            XTENSOR_ASSIGN_TRACE(stepper);
             stepper_assigner<E1, E2, default_assignable_layout(E1::static_layout)> assigner(de1, de2);
             assigner.run();
         }
+#if defined(XTENSOR_ASSIGN_TRACING)
+        trace.finish();
+#endif
     }
 
     template <class Tag>
@@ -414,6 +948,14 @@ namespace xt
         base_type::assign_data(e1, e2, trivial_broadcast);
     }
 
+    template <class Tag>
+    template <class E1, class E2, class P>
+    inline void xexpression_assigner<Tag>::assign_xexpression(E1& e1, const E2& e2, const P& policy)
+    {
+        bool trivial_broadcast = resize(e1.derived_cast(), e2.derived_cast());
+        base_type::assign_data(e1, e2, trivial_broadcast, policy);
+    }
+
     template <class Tag>
     template <class E1, class E2>
     inline void xexpression_assigner<Tag>::computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
@@ -616,76 +1158,298 @@ namespace xt
      * linear_assigner implementation *
      **********************************/
 
-    template <bool simd_assign>
-    template <class E1, class E2>
-    inline void linear_assigner<simd_assign>::run(E1& e1, const E2& e2)
+    namespace linear_assign_detail
     {
-        using lhs_align_mode = xt_simd::container_alignment_t<E1>;
-        constexpr bool is_aligned = std::is_same<lhs_align_mode, aligned_mode>::value;
-        using rhs_align_mode = std::conditional_t<is_aligned, inner_aligned_mode, unaligned_mode>;
-        using e1_value_type = typename E1::value_type;
-        using e2_value_type = typename E2::value_type;
-        using value_type = typename xassign_traits<E1, E2>::requested_value_type;
-        using simd_type = xt_simd::simd_type<value_type>;
-        using size_type = typename E1::size_type;
-        size_type size = e1.size();
-        constexpr size_type simd_size = simd_type::size;
-        constexpr bool needs_cast = has_assign_conversion<e1_value_type, e2_value_type>::value;
-
-        size_type align_begin = is_aligned ? 0 : xt_simd::get_alignment_offset(e1.data(), size, simd_size);
-        size_type align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
-
-        for (size_type i = 0; i < align_begin; ++i)
+        /**
+         * Checks whether every buffer accessed by load_simd and store_simd
+         * at index i is aligned on XTENSOR_DEFAULT_ALIGNMENT. Containers
+         * are checked, scalars, generators and views, which compute their
+         * values or always load unaligned from their underlying expression,
+         * do not constrain the result. Any other expression makes the check
+         * fail.
+         */
+        template <class E, class = void>
+        struct simd_alignment_checker
         {
-            e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
-        }
+            static bool run(const E&, std::size_t) noexcept
+            {
+                return false;
+            }
+        };
 
-#if defined(XTENSOR_USE_TBB)
-        if (size >= XTENSOR_TBB_THRESHOLD)
+        template <class E>
+        struct simd_alignment_checker<E, std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value
+                                                          && detail::use_tiled_assign<E>::value>>
         {
-            tbb::parallel_for(align_begin, align_end, simd_size, [&e1, &e2](size_t i)
+            static bool run(const E& e, std::size_t i) noexcept
             {
-                e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
-            });
-        }
-        else
+                constexpr std::size_t alignment = XTENSOR_DEFAULT_ALIGNMENT != 0 ? XTENSOR_DEFAULT_ALIGNMENT : 1;
+                return reinterpret_cast<std::uintptr_t>(e.data() + i) % alignment == 0;
+            }
+        };
+
+        template <class CT>
+        struct simd_alignment_checker<xscalar<CT>>
         {
-            for (size_type i = align_begin; i < align_end; i += simd_size)
+            static bool run(const xscalar<CT>&, std::size_t) noexcept
             {
-                e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+                return true;
             }
-        }
-#elif defined(XTENSOR_USE_OPENMP)
-        if (size >= XTENSOR_OPENMP_TRESHOLD)
+        };
+
+        template <class CT, class... S>
+        struct simd_alignment_checker<xview<CT, S...>>
         {
-            #pragma omp parallel for default(none) shared(align_begin, align_end, e1, e2)
-    #ifndef _WIN32
-            for (size_type i = align_begin; i < align_end; i += simd_size)
+            static bool run(const xview<CT, S...>&, std::size_t) noexcept
             {
-                e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+                return true;
             }
-    #else
-            for(auto i = static_cast<std::ptrdiff_t>(align_begin); i < static_cast<std::ptrdiff_t>(align_end);
-                i += static_cast<std::ptrdiff_t>(simd_size))
+        };
+
+        template <class F, class R, class S>
+        struct simd_alignment_checker<xgenerator<F, R, S>>
+        {
+            static bool run(const xgenerator<F, R, S>&, std::size_t) noexcept
             {
-                size_type ui = static_cast<size_type>(i);
-                e1.template store_simd<lhs_align_mode>(ui, e2.template load_simd<rhs_align_mode, value_type>(ui));
+                return true;
             }
-    #endif
-        }
-        else
+        };
+
+        template <class CT, class X>
+        struct simd_alignment_checker<xbroadcast<CT, X>>
         {
-            for (size_type i = align_begin; i < align_end; i += simd_size)
+            static bool run(const xbroadcast<CT, X>& b, std::size_t i) noexcept
             {
-                e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+                return simd_alignment_checker<std::decay_t<CT>>::run(b.expression(), i);
             }
+        };
+
+        template <class F, class... CT>
+        struct simd_alignment_checker<xfunction<F, CT...>>
+        {
+            static bool run(const xfunction<F, CT...>& f, std::size_t i) noexcept
+            {
+                bool res = true;
+                for_each([&res, i](const auto& arg)
+                {
+                    res = res && simd_alignment_checker<std::decay_t<decltype(arg)>>::run(arg, i);
+                }, f.arguments());
+                return res;
+            }
+        };
+
+        template <class E>
+        inline bool is_simd_aligned_at(const E& e, std::size_t i) noexcept
+        {
+            return XTENSOR_DEFAULT_ALIGNMENT != 0 && simd_alignment_checker<E>::run(e, i);
         }
-#else
-        for (size_type i = align_begin; i < align_end; i += simd_size)
+
+        template <class LM, class RM, class V, class E1, class E2, class P>
+        inline void simd_loop(E1& e1, const E2& e2, std::size_t align_begin, std::size_t align_end, const P& policy)
         {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+            constexpr std::size_t simd_size = xt_simd::simd_type<V>::size;
+            policy.for_range(align_begin, align_end, simd_size, [&e1, &e2](std::size_t first, std::size_t last)
+            {
+                for (std::size_t i = first; i < last; i += simd_size)
+                {
+                    e1.template store_simd<LM>(i, e2.template load_simd<RM, V>(i));
+                }
+            });
         }
-#endif
+
+        template <class E1, class E2>
+        struct can_stream
+        {
+            using e1_value_type = typename E1::value_type;
+            using value_type = typename xassign_traits<E1, E2>::requested_value_type;
+            // Streaming writes the raw registers to the buffer of the
+            // destination, which requires the batch layout to match its
+            // memory layout.
+            static constexpr bool value = detail::use_tiled_assign<E1>::value
+                && std::is_same<e1_value_type, value_type>::value
+                && std::is_arithmetic<e1_value_type>::value
+                && has_simd_type<e1_value_type>::value;
+        };
+
+        template <class RM, class E1, class E2, class P>
+        inline bool stream_simd(E1&, const E2&, std::size_t, std::size_t, const P&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class RM, class E1, class E2, class P>
+        inline bool stream_simd(E1& e1, const E2& e2, std::size_t align_begin, std::size_t align_end,
+                                const P& policy, std::true_type)
+        {
+            using value_type = typename E1::value_type;
+            using simd_type = xt_simd::simd_type<value_type>;
+            constexpr std::size_t simd_size = simd_type::size;
+
+            if (align_begin == align_end
+                || !exec::detail::use_streaming_store(policy, e1.size() * sizeof(value_type)))
+            {
+                return false;
+            }
+            value_type* dst = e1.data() + e1.data_offset() + align_begin;
+            if (reinterpret_cast<std::uintptr_t>(dst) % sizeof(simd_type) != 0)
+            {
+                return false;
+            }
+
+            policy.for_range(align_begin, align_end, simd_size, [dst, align_begin, &e2](std::size_t first, std::size_t last)
+            {
+                for (std::size_t i = first; i < last; i += simd_size)
+                {
+                    xt_simd::stream_as(dst + (i - align_begin), e2.template load_simd<RM, value_type>(i));
+                }
+                // Non-temporal stores are weakly ordered, each thread must
+                // fence its own before the loop is considered complete.
+                xt_simd::stream_fence<value_type>();
+            });
+            return true;
+        }
+
+        // Returns false when the destination cannot be written with
+        // non-temporal stores, in which case nothing has been assigned.
+        template <class RM, class E1, class E2, class P>
+        inline bool stream_simd(E1& e1, const E2& e2, std::size_t align_begin, std::size_t align_end, const P& policy)
+        {
+            return stream_simd<RM>(e1, e2, align_begin, align_end, policy,
+                                   std::integral_constant<bool, can_stream<E1, E2>::value>());
+        }
+
+        template <class T, class I, class O>
+        inline void convert_range(I src, O dst, std::size_t n)
+        {
+            for (; n > std::size_t(0); --n)
+            {
+                *dst = static_cast<T>(*src);
+                ++src;
+                ++dst;
+            }
+        }
+
+        // Contiguous buffers of float and half precision values are
+        // converted in bulk with the F16C and AVX512-BF16 instructions
+        template <class T>
+        inline void convert_range(const float* src, float16* dst, std::size_t n)
+        {
+            convert_n(src, n, dst);
+        }
+
+        template <class T>
+        inline void convert_range(const float16* src, float* dst, std::size_t n)
+        {
+            convert_n(src, n, dst);
+        }
+
+        template <class T>
+        inline void convert_range(const float* src, bfloat16* dst, std::size_t n)
+        {
+            convert_n(src, n, dst);
+        }
+
+        template <class T>
+        inline void convert_range(const bfloat16* src, float* dst, std::size_t n)
+        {
+            convert_n(src, n, dst);
+        }
+
+        // Bits are packed a block at a time, the chunks of a parallel
+        // assignment starting on a block boundary
+        template <class T, class I>
+        inline void convert_range(I src, xbit_iterator<false> dst, std::size_t n)
+        {
+            using block_type = xbit_iterator<false>::block_type;
+            constexpr std::size_t block_bits = xbit_iterator<false>::block_bits;
+            for (; n > std::size_t(0) && static_cast<std::size_t>(dst.index()) % block_bits != 0; --n, ++src, ++dst)
+            {
+                *dst = static_cast<bool>(*src);
+            }
+            block_type* block = dst.blocks() + static_cast<std::size_t>(dst.index()) / block_bits;
+            for (; n >= block_bits; n -= block_bits, ++block)
+            {
+                block_type word = 0;
+                for (std::size_t j = 0; j < block_bits; ++j, ++src)
+                {
+                    word |= static_cast<block_type>(static_cast<bool>(*src)) << j;
+                }
+                *block = word;
+            }
+            dst = xbit_iterator<false>(dst.blocks(), (block - dst.blocks()) * static_cast<std::ptrdiff_t>(block_bits));
+            for (; n > std::size_t(0); --n, ++src, ++dst)
+            {
+                *dst = static_cast<bool>(*src);
+            }
+        }
+
+        template <class I>
+        struct convert_step : std::integral_constant<std::size_t, 1>
+        {
+        };
+
+        template <>
+        struct convert_step<xbit_iterator<false>> : std::integral_constant<std::size_t, xbit_iterator<false>::block_bits>
+        {
+        };
+    }
+
+    template <bool simd_assign>
+    template <class E1, class E2>
+    inline void linear_assigner<simd_assign>::run(E1& e1, const E2& e2)
+    {
+        run(e1, e2, exec::default_policy());
+    }
+
+    template <bool simd_assign>
+    template <class E1, class E2, class P>
+    inline void linear_assigner<simd_assign>::run(E1& e1, const E2& e2, const P& policy)
+    {
+        using lhs_align_mode = xt_simd::container_alignment_t<E1>;
+        constexpr bool is_aligned = std::is_same<lhs_align_mode, aligned_mode>::value;
+        using rhs_align_mode = std::conditional_t<is_aligned, inner_aligned_mode, unaligned_mode>;
+        using e1_value_type = typename E1::value_type;
+        using e2_value_type = typename E2::value_type;
+        using value_type = typename xassign_traits<E1, E2>::requested_value_type;
+        using simd_type = xt_simd::simd_type<value_type>;
+        using size_type = typename E1::size_type;
+        size_type size = e1.size();
+        constexpr size_type simd_size = simd_type::size;
+        constexpr bool needs_cast = has_assign_conversion<e1_value_type, e2_value_type>::value;
+
+        // The scalar prologue brings the destination to an aligned address;
+        // the operands whose type does not guarantee alignment are then
+        // checked at runtime, e.g. adapted buffers that happen to be aligned
+        // or that share the offset of the destination.
+        size_type align_begin = is_aligned ? 0 : xt_simd::get_alignment_offset(e1.data(), size, simd_size);
+        size_type align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+        bool lhs_aligned = is_aligned || linear_assign_detail::is_simd_aligned_at(e1, align_begin);
+        bool rhs_aligned = lhs_aligned && linear_assign_detail::is_simd_aligned_at(e2, align_begin);
+
+        for (size_type i = 0; i < align_begin; ++i)
+        {
+            e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
+        }
+
+        if (rhs_aligned)
+        {
+            if (!linear_assign_detail::stream_simd<runtime_aligned_mode>(e1, e2, align_begin, align_end, policy))
+            {
+                linear_assign_detail::simd_loop<runtime_aligned_mode, runtime_aligned_mode, value_type>(e1, e2, align_begin, align_end, policy);
+            }
+        }
+        else if (!linear_assign_detail::stream_simd<rhs_align_mode>(e1, e2, align_begin, align_end, policy))
+        {
+            if (lhs_aligned && !is_aligned)
+            {
+                linear_assign_detail::simd_loop<runtime_aligned_mode, rhs_align_mode, value_type>(e1, e2, align_begin, align_end, policy);
+            }
+            else
+            {
+                linear_assign_detail::simd_loop<lhs_align_mode, rhs_align_mode, value_type>(e1, e2, align_begin, align_end, policy);
+            }
+        }
+
         for (size_type i = align_end; i < size; ++i)
         {
             e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
@@ -694,51 +1458,102 @@ namespace xt
 
     template <class E1, class E2>
     inline void linear_assigner<false>::run(E1& e1, const E2& e2)
+    {
+        run(e1, e2, exec::default_policy());
+    }
+
+    template <class E1, class E2, class P>
+    inline void linear_assigner<false>::run(E1& e1, const E2& e2, const P& policy)
     {
         using is_convertible = std::is_convertible<typename std::decay_t<E2>::value_type,
                                                    typename std::decay_t<E1>::value_type>;
         // If the types are not compatible, this function is still instantiated but never called.
         // To avoid compilation problems in effectively unused code trivial_assigner_run_impl is
         // empty in this case.
-        run_impl(e1, e2, is_convertible());
+        run_impl(e1, e2, policy, is_convertible());
     }
 
-    template <class E1, class E2>
-    inline void linear_assigner<false>::run_impl(E1& e1, const E2& e2, std::true_type /*is_convertible*/)
+    template <class E1, class E2, class P>
+    inline void linear_assigner<false>::run_impl(E1& e1, const E2& e2, const P& policy, std::true_type /*is_convertible*/)
     {
         using value_type = typename E1::value_type;
-        using size_type = typename E1::size_type;
-        auto src = linear_begin(e2);
-        auto dst = linear_begin(e1);
-        size_type n = e1.size();
+        auto src_begin = linear_begin(e2);
+        auto dst_begin = linear_begin(e1);
 
-#if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(std::ptrdiff_t(0), static_cast<std::ptrdiff_t>(n), [&](std::ptrdiff_t i)
+        policy.for_range(std::size_t(0), static_cast<std::size_t>(e1.size()),
+                         linear_assign_detail::convert_step<decltype(dst_begin)>::value,
+                         [&src_begin, &dst_begin](std::size_t first, std::size_t last)
         {
-            *(dst + i) = static_cast<value_type>(*(src + i));
+            dispatch_for<value_type>([&]()
+            {
+                linear_assign_detail::convert_range<value_type>(src_begin + static_cast<std::ptrdiff_t>(first),
+                                                                dst_begin + static_cast<std::ptrdiff_t>(first),
+                                                                last - first);
+            });
         });
-#elif defined(XTENSOR_USE_OPENMP)
-        #pragma omp parallel for default(none) shared(src, dst, n)
-        for (std::ptrdiff_t i = std::ptrdiff_t(0); i < static_cast<std::ptrdiff_t>(n) ; i++)
+    }
+
+    template <class E1, class E2, class P>
+    inline void linear_assigner<false>::run_impl(E1&, const E2&, const P&, std::false_type /*is_convertible*/)
+    {
+        XTENSOR_PRECONDITION(false,
+            "Internal error: linear_assigner called with unrelated types.");
+
+    }
+
+    /****************************************
+     * fixed_linear_assigner implementation *
+     ****************************************/
+
+    template <bool fixed>
+    template <class E1, class E2>
+    inline bool fixed_linear_assigner<fixed>::run(E1& e1, const E2& e2)
+    {
+        run_impl(e1, e2, std::integral_constant<bool, xassign_traits<E1, E2>::simd_linear_assign()>());
+        return true;
+    }
+
+    template <bool fixed>
+    template <class E1, class E2>
+    inline void fixed_linear_assigner<fixed>::run_impl(E1& e1, const E2& e2, std::true_type /*simd*/)
+    {
+        using e1_value_type = typename E1::value_type;
+        using value_type = typename xassign_traits<E1, E2>::requested_value_type;
+        constexpr std::size_t size = detail::fixed_compute_size<typename E1::shape_type>::value;
+        constexpr std::size_t simd_size = xt_simd::simd_type<value_type>::size;
+        constexpr std::size_t simd_end = size - size % simd_size;
+        constexpr bool needs_cast = has_assign_conversion<e1_value_type, typename E2::value_type>::value;
+        for (std::size_t i = 0; i < simd_end; i += simd_size)
         {
-            *(dst + i) = static_cast<value_type>(*(src + i));
+            e1.template store_simd<unaligned_mode>(i, e2.template load_simd<unaligned_mode, value_type>(i));
         }
-#else
-        for (; n > size_type(0); --n)
+        for (std::size_t i = simd_end; i < size; ++i)
         {
-            *dst = static_cast<value_type>(*src);
-            ++src;
-            ++dst;
+            e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
         }
-#endif
     }
 
+    template <bool fixed>
     template <class E1, class E2>
-    inline void linear_assigner<false>::run_impl(E1&, const E2&, std::false_type /*is_convertible*/)
+    inline void fixed_linear_assigner<fixed>::run_impl(E1& e1, const E2& e2, std::false_type /*simd*/)
     {
-        XTENSOR_PRECONDITION(false,
-            "Internal error: linear_assigner called with unrelated types.");
+        using value_type = typename E1::value_type;
+        constexpr std::size_t size = detail::fixed_compute_size<typename E1::shape_type>::value;
+        linear_assign_detail::convert_range<value_type>(linear_begin(e2), linear_begin(e1), size);
+    }
 
+    template <>
+    template <class E1, class E2>
+    inline bool fixed_linear_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+        return false;
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline bool device_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+        return false;
     }
 
     /****************************************
@@ -796,6 +1611,61 @@ namespace xt
             }
         };
 
+        // Returns the cut beyond which an operand of strides s is broadcast,
+        // i.e. has null strides over the inner dimensions of the loop, the
+        // dimensions it lacks included. Such an operand is constant over
+        // the inner loop and does not need to match the strides of the
+        // assigned expression there.
+        template <layout_type L, class S>
+        std::size_t broadcast_cut(std::size_t dimension, const S& s)
+        {
+            std::size_t offset = dimension - s.size();
+            if (L == layout_type::row_major)
+            {
+                std::size_t i = dimension;
+                while (i > offset && s[i - 1 - offset] == 0)
+                {
+                    --i;
+                }
+                return i == offset ? 0 : i;
+            }
+            else
+            {
+                std::size_t i = offset;
+                while (i < dimension && s[i - offset] == 0)
+                {
+                    ++i;
+                }
+                return i;
+            }
+        }
+
+        // Returns the innermost dimension that is not of extent one among
+        // the inner dimensions of the loop; the steppers detect whether
+        // their operand is broadcast from their stride along it.
+        template <class S>
+        std::size_t leading_dimension(const S& shape, std::size_t cut, bool is_row_major)
+        {
+            if (is_row_major)
+            {
+                std::size_t i = shape.size();
+                while (i > cut + 1 && shape[i - 1] == 1)
+                {
+                    --i;
+                }
+                return i - 1;
+            }
+            else
+            {
+                std::size_t i = 0;
+                while (i + 1 < cut && shape[i] == 1)
+                {
+                    ++i;
+                }
+                return i;
+            }
+        }
+
         template <layout_type L, class S>
         struct check_strides_functor
         {
@@ -812,6 +1682,14 @@ namespace xt
             operator()(const T& el)
             {
                 auto var = check_strides_overlap<layout_type::row_major>::get(m_strides, el.strides());
+                var = (std::min)(var, broadcast_cut<layout_type::row_major>(m_strides.size(), el.strides()));
+                // An operand whose innermost stride differs, such as a view
+                // with a step, is gathered along the innermost dimension
+                // when the assigned expression is contiguous along it
+                if (var == m_strides.size() && var != 0 && m_strides[var - 1] == 1)
+                {
+                    var = var - 1;
+                }
                 if (var > m_cut)
                 {
                     m_cut = var;
@@ -824,6 +1702,11 @@ namespace xt
             operator()(const T& el)
             {
                 auto var = check_strides_overlap<layout_type::column_major>::get(m_strides, el.strides());
+                var = (std::max)(var, broadcast_cut<layout_type::column_major>(m_strides.size(), el.strides()));
+                if (var == 0 && m_strides.size() != 0 && m_strides[0] == 1)
+                {
+                    var = 1;
+                }
                 if (var < m_cut)
                 {
                     m_cut = var;
@@ -844,6 +1727,12 @@ namespace xt
                 return m_cut;
             }
 
+            template <class CT, class X>
+            std::size_t operator()(const xt::xbroadcast<CT, X>& xb)
+            {
+                return (*this)(xb.expression());
+            }
+
         private:
 
             std::size_t m_cut;
@@ -882,11 +1771,32 @@ namespace xt
 
             return std::make_tuple(inner_loop_size, outer_loop_size, cut);
         }
+
+        // Computes the outer index of the n-th iteration of the outer loop,
+        // i.e. the index that n calls to next_idx would produce.
+        template <class T>
+        void unravel_outer_index(std::size_t n, T& outer_index, const T& outer_shape, bool is_row_major)
+        {
+            std::size_t sz = outer_index.size();
+            for (std::size_t k = 0; k < sz; ++k)
+            {
+                std::size_t i = is_row_major ? sz - 1 - k : k;
+                outer_index[i] = n % outer_shape[i];
+                n /= outer_shape[i];
+            }
+        }
     }
 
     template <bool simd>
     template <class E1, class E2>
     inline void strided_loop_assigner<simd>::run(E1& e1, const E2& e2)
+    {
+        run(e1, e2, exec::default_policy());
+    }
+
+    template <bool simd>
+    template <class E1, class E2, class P>
+    inline void strided_loop_assigner<simd>::run(E1& e1, const E2& e2, const P& policy)
     {
         bool is_row_major = true;
         using fallback_assigner = stepper_assigner<E1, E2, default_assignable_layout(E1::static_layout)>;
@@ -903,6 +1813,7 @@ namespace xt
                     is_row_major = false;
                     break;
                 default:
+                    XTENSOR_ASSIGN_TRACE(stepper);
                     return fallback_assigner(e1, e2).run();
             }
         }
@@ -924,25 +1835,22 @@ namespace xt
 
         if ((is_row_major && cut == e1.dimension()) || (!is_row_major && cut == 0))
         {
+            XTENSOR_ASSIGN_TRACE(stepper);
             return fallback_assigner(e1, e2).run();
         }
 
         // TODO can we get rid of this and use `shape_type`?
-        dynamic_shape<std::size_t> idx, max_shape;
+        dynamic_shape<std::size_t> max_shape;
 
         if (is_row_major)
         {
-            xt::resize_container(idx, cut);
             max_shape.assign(e1.shape().begin(), e1.shape().begin() + static_cast<std::ptrdiff_t>(cut));
         }
         else
         {
-            xt::resize_container(idx, e1.shape().size() - cut);
             max_shape.assign(e1.shape().begin() + static_cast<std::ptrdiff_t>(cut), e1.shape().end());
         }
 
-        // add this when we have std::array index!
-        // std::fill(idx.begin(), idx.end(), 0);
         using e1_value_type = typename E1::value_type;
         using e2_value_type = typename E2::value_type;
         constexpr bool needs_cast = has_assign_conversion<e1_value_type, e2_value_type>::value;
@@ -954,9 +1862,6 @@ namespace xt
         std::size_t simd_size = inner_loop_size / simd_type::size;
         std::size_t simd_rest = inner_loop_size % simd_type::size;
 
-        auto fct_stepper = e2.stepper_begin(e1.shape());
-        auto res_stepper = e1.stepper_begin(e1.shape());
-
         // TODO in 1D case this is ambigous -- could be RM or CM.
         //      Use default layout to make decision
         std::size_t step_dim = 0;
@@ -965,49 +1870,467 @@ namespace xt
             step_dim = cut;
         }
 
-        for (std::size_t ox = 0; ox < outer_loop_size; ++ox)
+        // Operands broadcast over the inner loop, such as a row of means
+        // subtracted from each column, are splatted instead of loaded
+        std::size_t leading_dim = strided_assign_detail::leading_dimension(e1.shape(), cut, is_row_major);
+
+        // The outer loop is split into independent ranges; each range owns
+        // its index and steppers, which are moved to the first iteration of
+        // the range before running the same loop as the serial assignment.
+        policy.for_range(std::size_t(0), outer_loop_size, std::size_t(1), [&](std::size_t first, std::size_t last)
         {
-            for (std::size_t i = 0; i < simd_size; ++i)
+            dynamic_shape<std::size_t> idx;
+            xt::resize_container(idx, max_shape.size());
+            strided_assign_detail::unravel_outer_index(first, idx, max_shape, is_row_major);
+
+            auto fct_stepper = e2.stepper_begin(e1.shape());
+            auto res_stepper = e1.stepper_begin(e1.shape());
+
+            for (std::size_t i = 0; i < idx.size(); ++i)
             {
-                res_stepper.store_simd(fct_stepper.template step_simd<value_type>());
+                fct_stepper.step(i + step_dim, idx[i]);
+                res_stepper.step(i + step_dim, idx[i]);
             }
-            for (std::size_t i = 0; i < simd_rest; ++i)
+
+            for (std::size_t ox = first; ox < last; ++ox)
             {
-                *(res_stepper) = conditional_cast<needs_cast, e1_value_type>(*(fct_stepper));
-                res_stepper.step_leading();
-                fct_stepper.step_leading();
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    res_stepper.store_simd(fct_stepper.template step_simd<value_type>(leading_dim));
+                }
+                for (std::size_t i = 0; i < simd_rest; ++i)
+                {
+                    *(res_stepper) = conditional_cast<needs_cast, e1_value_type>(*(fct_stepper));
+                    res_stepper.step_leading();
+                    fct_stepper.step_leading(leading_dim);
+                }
+
+                is_row_major ?
+                    strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
+                    strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
+
+                fct_stepper.to_begin();
+
+                // need to step E1 as well if not contigous assign (e.g. view)
+                if (!E1::contiguous_layout)
+                {
+                    res_stepper.to_begin();
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, idx[i]);
+                        res_stepper.step(i + step_dim, idx[i]);
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, idx[i]);
+                    }
+                }
             }
+        });
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+    }
 
-            is_row_major ?
-                strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
-                strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
+    template <>
+    template <class E1, class E2, class P>
+    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/, const P& /*policy*/)
+    {
+    }
 
-            fct_stepper.to_begin();
+    /*********************************
+     * tiled_assigner implementation *
+     *********************************/
 
-            // need to step E1 as well if not contigous assign (e.g. view)
-            if (!E1::contiguous_layout)
+    namespace tiled_assign_detail
+    {
+        // Returns the dimension of extent greater than one with the smallest
+        // non-zero stride, or shape.size() if there is none.
+        template <class S, class ST>
+        std::size_t fastest_dimension(const S& shape, const ST& strides)
+        {
+            std::size_t dim = shape.size();
+            std::size_t res = dim;
+            std::size_t best = 0;
+            for (std::size_t i = 0; i < dim; ++i)
             {
-                res_stepper.to_begin();
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                std::ptrdiff_t st = static_cast<std::ptrdiff_t>(strides[i]);
+                std::size_t abs_st = static_cast<std::size_t>(st < 0 ? -st : st);
+                if (shape[i] > 1 && abs_st != 0 && (res == dim || abs_st < best))
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
-                    res_stepper.step(i + step_dim, idx[i]);
+                    res = i;
+                    best = abs_st;
                 }
             }
-            else
+            return res;
+        }
+    }
+
+    template <bool tiled>
+    template <class E1, class E2, class P>
+    inline bool tiled_assigner<tiled>::run(E1& e1, const E2& e2, const P& policy)
+    {
+        using e1_value_type = typename E1::value_type;
+        using e2_value_type = typename E2::value_type;
+        constexpr bool needs_cast = has_assign_conversion<e2_value_type, e1_value_type>::value;
+        constexpr std::size_t tile = XTENSOR_ASSIGN_TILE_SIZE;
+
+        const auto& shape = e1.shape();
+        std::size_t dim = shape.size();
+        if (dim < 2 || e2.dimension() != dim || !std::equal(shape.cbegin(), shape.cend(), e2.shape().cbegin()))
+        {
+            return false;
+        }
+
+        const auto& dst_strides = e1.strides();
+        const auto& src_strides = e2.strides();
+        // dim_i is the fastest dimension of the destination, dim_j the one of the source
+        std::size_t dim_i = tiled_assign_detail::fastest_dimension(shape, dst_strides);
+        std::size_t dim_j = tiled_assign_detail::fastest_dimension(shape, src_strides);
+        if (dim_i == dim || dim_j == dim || dim_i == dim_j)
+        {
+            return false;
+        }
+
+        svector<std::size_t, 4> outer_dims;
+        std::size_t outer_size = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            if (d != dim_i && d != dim_j)
             {
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                outer_dims.push_back(d);
+                outer_size *= static_cast<std::size_t>(shape[d]);
+            }
+        }
+
+        std::size_t size_i = static_cast<std::size_t>(shape[dim_i]);
+        std::size_t size_j = static_cast<std::size_t>(shape[dim_j]);
+        std::ptrdiff_t dst_si = static_cast<std::ptrdiff_t>(dst_strides[dim_i]);
+        std::ptrdiff_t dst_sj = static_cast<std::ptrdiff_t>(dst_strides[dim_j]);
+        std::ptrdiff_t src_si = static_cast<std::ptrdiff_t>(src_strides[dim_i]);
+        std::ptrdiff_t src_sj = static_cast<std::ptrdiff_t>(src_strides[dim_j]);
+        std::size_t nb_j = (size_j + tile - 1) / tile;
+
+        auto dst = e1.data() + static_cast<std::ptrdiff_t>(e1.data_offset());
+        auto src = e2.data() + static_cast<std::ptrdiff_t>(e2.data_offset());
+
+        // Each work item is a strip of tiles spanning dim_i, for a given
+        // block of dim_j and a given position in the remaining dimensions.
+        policy.for_range(0, outer_size * nb_j, 1, [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t n = first; n < last; ++n)
+            {
+                std::size_t outer = n / nb_j;
+                std::size_t j0 = (n % nb_j) * tile;
+                std::size_t j1 = std::min(j0 + tile, size_j);
+
+                std::ptrdiff_t dst_offset = 0;
+                std::ptrdiff_t src_offset = 0;
+                for (std::size_t k = outer_dims.size(); k > 0; --k)
+                {
+                    std::size_t d = outer_dims[k - 1];
+                    std::size_t extent = static_cast<std::size_t>(shape[d]);
+                    std::ptrdiff_t idx = static_cast<std::ptrdiff_t>(outer % extent);
+                    outer /= extent;
+                    dst_offset += idx * static_cast<std::ptrdiff_t>(dst_strides[d]);
+                    src_offset += idx * static_cast<std::ptrdiff_t>(src_strides[d]);
+                }
+
+                for (std::size_t i0 = 0; i0 < size_i; i0 += tile)
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
+                    std::size_t i1 = std::min(i0 + tile, size_i);
+                    for (std::size_t j = j0; j < j1; ++j)
+                    {
+                        std::ptrdiff_t sj = static_cast<std::ptrdiff_t>(j);
+                        auto d = dst + dst_offset + sj * dst_sj;
+                        auto s = src + src_offset + sj * src_sj;
+                        for (std::size_t i = i0; i < i1; ++i)
+                        {
+                            std::ptrdiff_t si = static_cast<std::ptrdiff_t>(i);
+                            d[si * dst_si] = conditional_cast<needs_cast, e1_value_type>(s[si * src_si]);
+                        }
+                    }
                 }
             }
+        });
+        return true;
+    }
+
+    template <>
+    template <class E1, class E2, class P>
+    inline bool tiled_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/, const P& /*policy*/)
+    {
+        return false;
+    }
+
+    /************************************
+     * reversed_assigner implementation *
+     ************************************/
+
+    template <bool reversed>
+    template <class E1, class E2, class P>
+    inline bool reversed_assigner<reversed>::run(E1& e1, const E2& e2, const P& policy)
+    {
+        using e1_value_type = typename E1::value_type;
+        using e2_value_type = typename E2::value_type;
+        constexpr bool needs_cast = has_assign_conversion<e2_value_type, e1_value_type>::value;
+
+        const auto& shape = e1.shape();
+        std::size_t dim = shape.size();
+        if (dim == 0 || e2.dimension() != dim || !std::equal(shape.cbegin(), shape.cend(), e2.shape().cbegin()))
+        {
+            return false;
+        }
+
+        const auto& dst_strides = e1.strides();
+        const auto& src_strides = e2.strides();
+        std::size_t dim_i = tiled_assign_detail::fastest_dimension(shape, dst_strides);
+        if (dim_i == dim)
+        {
+            return false;
+        }
+        std::ptrdiff_t dst_si = static_cast<std::ptrdiff_t>(dst_strides[dim_i]);
+        std::ptrdiff_t src_si = static_cast<std::ptrdiff_t>(src_strides[dim_i]);
+        if ((dst_si != 1 && dst_si != -1) || (src_si != 1 && src_si != -1) || (dst_si == 1 && src_si == 1))
+        {
+            return false;
         }
+
+        std::size_t size_i = static_cast<std::size_t>(shape[dim_i]);
+        std::size_t outer_size = size_i == 0 ? 0 : e1.size() / size_i;
+        auto dst = e1.data() + static_cast<std::ptrdiff_t>(e1.data_offset());
+        auto src = e2.data() + static_cast<std::ptrdiff_t>(e2.data_offset());
+        // Rows walked backward in the destination are written from their
+        // last element, so that the destination always moves forward.
+        std::ptrdiff_t last = static_cast<std::ptrdiff_t>(size_i) - 1;
+        std::ptrdiff_t dst_start = dst_si < 0 ? -last : 0;
+        std::ptrdiff_t src_start = dst_si < 0 ? src_si * last : 0;
+        bool forward = src_si == dst_si;
+
+        policy.for_range(0, outer_size, 1, [&](std::size_t first, std::size_t end)
+        {
+            for (std::size_t n = first; n < end; ++n)
+            {
+                std::size_t outer = n;
+                std::ptrdiff_t dst_offset = dst_start;
+                std::ptrdiff_t src_offset = src_start;
+                for (std::size_t k = dim; k > 0; --k)
+                {
+                    std::size_t d = k - 1;
+                    if (d == dim_i)
+                    {
+                        continue;
+                    }
+                    std::size_t extent = static_cast<std::size_t>(shape[d]);
+                    std::ptrdiff_t idx = static_cast<std::ptrdiff_t>(outer % extent);
+                    outer /= extent;
+                    dst_offset += idx * static_cast<std::ptrdiff_t>(dst_strides[d]);
+                    src_offset += idx * static_cast<std::ptrdiff_t>(src_strides[d]);
+                }
+
+                auto d = dst + dst_offset;
+                auto s = src + src_offset;
+                if (forward)
+                {
+                    for (std::ptrdiff_t i = 0; i <= last; ++i)
+                    {
+                        d[i] = conditional_cast<needs_cast, e1_value_type>(s[i]);
+                    }
+                }
+                else
+                {
+                    for (std::ptrdiff_t i = 0; i <= last; ++i)
+                    {
+                        d[i] = conditional_cast<needs_cast, e1_value_type>(s[-i]);
+                    }
+                }
+            }
+        });
+        return true;
     }
 
     template <>
-    template <class E1, class E2>
-    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    template <class E1, class E2, class P>
+    inline bool reversed_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/, const P& /*policy*/)
+    {
+        return false;
+    }
+
+    /*****************************
+     * assign_all implementation *
+     *****************************/
+
+    namespace assign_all_detail
+    {
+        template <class E1, class E2>
+        struct is_fusable
+            : std::integral_constant<bool, std::is_same<xexpression_tag_t<E1, E2>, xtensor_expression_tag>::value
+                                           && has_strides<E1>::value
+                                           && !has_assign_to<E1, E2>::value>
+        {
+        };
+
+        template <class F, class T1, class T2, std::size_t... I>
+        inline void for_each_pair(F&& f, T1& e1, const T2& e2, std::index_sequence<I...>)
+        {
+            using expand = int[];
+            (void)expand{0, (f(std::get<I>(e1), std::get<I>(e2)), 0)...};
+        }
+
+        // Two outputs are traversed in the same order by their linear
+        // iterators when they have the same shape and the same strides
+        // along their non-broadcast dimensions.
+        template <class E1, class E2>
+        inline bool same_traversal(const E1& e1, const E2& e2)
+        {
+            if (e1.dimension() != e2.dimension()
+                || !std::equal(e1.shape().cbegin(), e1.shape().cend(), e2.shape().cbegin()))
+            {
+                return false;
+            }
+            for (std::size_t i = 0; i < e1.dimension(); ++i)
+            {
+                if (e1.shape()[i] != 1 && e1.strides()[i] != e2.strides()[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class E1, class E2>
+        inline void assign_range(E1& e1, const E2& e2, std::size_t first, std::size_t n, std::false_type /*simd*/)
+        {
+            using value_type = typename E1::value_type;
+            linear_assign_detail::convert_range<value_type>(linear_begin(e2) + static_cast<std::ptrdiff_t>(first),
+                                                            linear_begin(e1) + static_cast<std::ptrdiff_t>(first),
+                                                            n);
+        }
+
+        template <class E1, class E2>
+        inline void assign_range(E1& e1, const E2& e2, std::size_t first, std::size_t n, std::true_type /*simd*/)
+        {
+            using e1_value_type = typename E1::value_type;
+            using value_type = typename xassign_traits<E1, E2>::requested_value_type;
+            constexpr std::size_t simd_size = xt_simd::simd_type<value_type>::size;
+            constexpr bool needs_cast = has_assign_conversion<e1_value_type, typename E2::value_type>::value;
+            std::size_t simd_last = first + (n / simd_size) * simd_size;
+            for (std::size_t i = first; i < simd_last; i += simd_size)
+            {
+                e1.template store_simd<unaligned_mode>(i, e2.template load_simd<unaligned_mode, value_type>(i));
+            }
+            for (std::size_t i = simd_last; i < first + n; ++i)
+            {
+                e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
+            }
+        }
+
+        template <class E1, class E2>
+        inline void assign_range(E1& e1, const E2& e2, std::size_t first, std::size_t n)
+        {
+            assign_range(e1, e2, first, n, std::integral_constant<bool, xassign_traits<E1, E2>::simd_linear_assign()>());
+        }
+
+        template <class T1, class T2, class P>
+        inline void run(T1& e1, const T2& e2, const P& policy, std::false_type /*fusable*/)
+        {
+            for_each_pair([&policy](auto& out, const auto& expr)
+            {
+                assign_xexpression(out, expr, policy);
+            }, e1, e2, std::make_index_sequence<std::tuple_size<T2>::value>());
+        }
+
+        template <class T1, class T2, class P>
+        inline void run(T1& e1, const T2& e2, const P& policy, std::true_type /*fusable*/)
+        {
+            std::size_t block_size = XTENSOR_ASSIGN_ALL_BLOCK_SIZE;
+            using sequence = std::make_index_sequence<std::tuple_size<T2>::value>;
+
+            std::array<bool, std::tuple_size<T2>::value> trivial;
+            std::size_t index = 0;
+            for_each_pair([&trivial, &index](auto& out, const auto& expr)
+            {
+                using tag = xexpression_tag_t<std::decay_t<decltype(out)>, std::decay_t<decltype(expr)>>;
+                trivial[index++] = xexpression_assigner<tag>::resize(out, expr);
+            }, e1, e2, sequence());
+
+            const auto& front = std::get<0>(e1);
+            bool fused = true;
+            index = 0;
+            for_each_pair([&trivial, &index, &fused, &front](const auto& out, const auto& expr)
+            {
+                using traits = xassign_traits<std::decay_t<decltype(out)>, std::decay_t<decltype(expr)>>;
+                fused = fused && traits::linear_assign(out, expr, trivial[index]) && same_traversal(out, front);
+                ++index;
+            }, e1, e2, sequence());
+
+            if (fused)
+            {
+                policy.for_range(std::size_t(0), static_cast<std::size_t>(front.size()), block_size,
+                                 [&e1, &e2, block_size](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t block = first; block < last; block += block_size)
+                    {
+                        std::size_t n = (std::min)(block_size, last - block);
+                        for_each_pair([block, n](auto& out, const auto& expr)
+                        {
+                            assign_range(out, expr, block, n);
+                        }, e1, e2, sequence());
+                    }
+                });
+            }
+            else
+            {
+                index = 0;
+                for_each_pair([&trivial, &index, &policy](auto& out, const auto& expr)
+                {
+                    using tag = xexpression_tag_t<std::decay_t<decltype(out)>, std::decay_t<decltype(expr)>>;
+                    xexpression_assigner<tag>::assign_data(out, expr, trivial[index++], policy);
+                }, e1, e2, sequence());
+            }
+        }
+    }
+
+    template <class... E1, class... E2>
+    inline void assign_all(std::tuple<E1&...> e1, const std::tuple<E2...>& e2)
+    {
+        assign_all(e1, e2, exec::default_policy());
+    }
+
+    /**
+     * Resizes each expression of \c e1 to the shape of the corresponding
+     * expression of \c e2 and assigns them in a single pass. When all the
+     * assignments are linear and the destinations share their shape and
+     * strides, the loop computes a block of XTENSOR_ASSIGN_ALL_BLOCK_SIZE
+     * elements of each destination in turn, so that the operands shared by
+     * the expressions are read from memory once. Otherwise the expressions
+     * are assigned one after the other.
+     *
+     * As with noalias, no temporary is involved: a destination may only
+     * appear in the expression of a later destination through element-wise
+     * operations.
+     *
+     * \code{.cpp}
+     * xt::assign_all(std::tie(sum, diff), std::make_tuple(a + b, a - b));
+     * \endcode
+     *
+     * @param e1 the destination expressions, usually built with std::tie.
+     * @param e2 the expressions to assign.
+     * @param policy the execution policy, one of \c exec::seq or the result of \c exec::par.
+     */
+    template <class... E1, class... E2, class P>
+    inline void assign_all(std::tuple<E1&...> e1, const std::tuple<E2...>& e2, const P& policy)
     {
+        static_assert(sizeof...(E1) == sizeof...(E2), "assign_all requires one expression per destination");
+        static_assert(sizeof...(E1) != 0, "assign_all requires at least one destination");
+        using fusable = xtl::conjunction<assign_all_detail::is_fusable<E1, std::decay_t<E2>>...>;
+        assign_all_detail::run(e1, e2, policy, fusable());
     }
 }
 
@@ -0,0 +1,235 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ASYNC_HPP
+#define XTENSOR_ASYNC_HPP
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xclosure.hpp>
+
+#include "xexecution.hpp"
+#include "xnoalias.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define XTENSOR_HAS_COROUTINES
+#endif
+#endif
+
+namespace xt
+{
+
+    /****************
+     * async_assign *
+     ****************/
+
+    template <class D, class E, class X>
+    std::future<void> async_assign(D&& dst, E&& e, X& executor);
+
+    template <class D, class E, class X, class P>
+    std::future<void> async_assign(D&& dst, E&& e, X& executor, const P& policy);
+
+#if defined(XTENSOR_HAS_COROUTINES)
+
+    /**
+     * @class xassign_awaitable
+     * @brief Awaitable running an assignment on an executor.
+     *
+     * The awaiting coroutine is suspended until the assignment completes and
+     * is then resumed on the worker that ran it. Exceptions thrown by the
+     * assignment are rethrown by the co_await expression.
+     */
+    template <class D, class E, class X, class P>
+    class xassign_awaitable
+    {
+    public:
+
+        template <class DA, class EA>
+        xassign_awaitable(DA&& dst, EA&& e, X& executor, const P& policy);
+
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume();
+
+    private:
+
+        D m_dst;
+        E m_e;
+        X* p_executor;
+        P m_policy;
+        std::exception_ptr m_exception;
+    };
+
+    template <class D, class E, class X>
+    auto co_assign(D&& dst, E&& e, X& executor);
+
+    template <class D, class E, class X, class P>
+    auto co_assign(D&& dst, E&& e, X& executor, const P& policy);
+
+#endif
+
+    /*******************************
+     * async_assign implementation *
+     *******************************/
+
+    namespace detail
+    {
+        template <class D, class E, class P>
+        inline void run_async_assign(D& dst, const E& e, const P& policy)
+        {
+            noalias(dst).assign(e, policy);
+        }
+    }
+
+    /**
+     * Assigns \c e to \c dst on a worker of \c executor, without temporary,
+     * and returns a future becoming ready when the assignment has completed.
+     * Expressions and containers passed as lvalues are held by reference and
+     * must outlive the assignment; temporaries are moved into the task.
+     * Exceptions thrown by the assignment are stored in the future.
+     * @param dst the expression to assign to.
+     * @param e the xexpression to assign.
+     * @param executor the object running the assignment, any type providing
+     *        a \c submit method accepting a callable, e.g. xthread_pool.
+     */
+    template <class D, class E, class X>
+    inline std::future<void> async_assign(D&& dst, E&& e, X& executor)
+    {
+        return async_assign(std::forward<D>(dst), std::forward<E>(e), executor, exec::default_policy());
+    }
+
+    /**
+     * Assigns \c e to \c dst on a worker of \c executor, distributing the
+     * assignment loop according to \c policy.
+     * @param dst the expression to assign to.
+     * @param e the xexpression to assign.
+     * @param executor the object running the assignment.
+     * @param policy the execution policy of the assignment loop.
+     * @sa async_assign(D&&, E&&, X&)
+     */
+    template <class D, class E, class X, class P>
+    inline std::future<void> async_assign(D&& dst, E&& e, X& executor, const P& policy)
+    {
+        using dst_closure = xtl::closure_type_t<D>;
+        using expression_closure = xtl::closure_type_t<E>;
+
+        struct task
+        {
+            dst_closure m_dst;
+            expression_closure m_e;
+            P m_policy;
+            std::promise<void> m_promise;
+        };
+
+        // The executor may require copyable callables such as std::function.
+        auto t = std::make_shared<task>(task{std::forward<D>(dst), std::forward<E>(e), policy, std::promise<void>()});
+        std::future<void> res = t->m_promise.get_future();
+        executor.submit([t]()
+        {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+            detail::run_async_assign(t->m_dst, t->m_e, t->m_policy);
+            t->m_promise.set_value();
+#else
+            try
+            {
+                detail::run_async_assign(t->m_dst, t->m_e, t->m_policy);
+                t->m_promise.set_value();
+            }
+            catch (...)
+            {
+                t->m_promise.set_exception(std::current_exception());
+            }
+#endif
+        });
+        return res;
+    }
+
+#if defined(XTENSOR_HAS_COROUTINES)
+
+    /************************************
+     * xassign_awaitable implementation *
+     ************************************/
+
+    template <class D, class E, class X, class P>
+    template <class DA, class EA>
+    inline xassign_awaitable<D, E, X, P>::xassign_awaitable(DA&& dst, EA&& e, X& executor, const P& policy)
+        : m_dst(std::forward<DA>(dst)), m_e(std::forward<EA>(e)), p_executor(&executor), m_policy(policy), m_exception()
+    {
+    }
+
+    template <class D, class E, class X, class P>
+    inline bool xassign_awaitable<D, E, X, P>::await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <class D, class E, class X, class P>
+    inline void xassign_awaitable<D, E, X, P>::await_suspend(std::coroutine_handle<> handle)
+    {
+        // The awaitable lives in the frame of the suspended coroutine until
+        // it is resumed, so the task can refer to it.
+        p_executor->submit([this, handle]()
+        {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+            detail::run_async_assign(m_dst, m_e, m_policy);
+#else
+            try
+            {
+                detail::run_async_assign(m_dst, m_e, m_policy);
+            }
+            catch (...)
+            {
+                m_exception = std::current_exception();
+            }
+#endif
+            handle.resume();
+        });
+    }
+
+    template <class D, class E, class X, class P>
+    inline void xassign_awaitable<D, E, X, P>::await_resume()
+    {
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    /**
+     * Returns an awaitable assigning \c e to \c dst on a worker of
+     * \c executor, to be used with \c co_await in a coroutine. Lvalues are
+     * held by reference as in async_assign.
+     */
+    template <class D, class E, class X>
+    inline auto co_assign(D&& dst, E&& e, X& executor)
+    {
+        return co_assign(std::forward<D>(dst), std::forward<E>(e), executor, exec::default_policy());
+    }
+
+    /**
+     * Returns an awaitable assigning \c e to \c dst on a worker of
+     * \c executor, distributing the assignment loop according to \c policy.
+     */
+    template <class D, class E, class X, class P>
+    inline auto co_assign(D&& dst, E&& e, X& executor, const P& policy)
+    {
+        using awaitable_type = xassign_awaitable<xtl::closure_type_t<D>, xtl::closure_type_t<E>, X, P>;
+        return awaitable_type(std::forward<D>(dst), std::forward<E>(e), executor, policy);
+    }
+
+#endif
+}
+
+#endif
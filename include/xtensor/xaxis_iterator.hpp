@@ -10,6 +10,11 @@
 #ifndef XTENSOR_AXIS_ITERATOR_HPP
 #define XTENSOR_AXIS_ITERATOR_HPP
 
+#include <array>
+#include <cstddef>
+
+#include <xtl/xsequence.hpp>
+
 #include "xstrided_view.hpp"
 
 namespace xt
@@ -19,6 +24,25 @@ namespace xt
      * xaxis_iterator *
      ******************/
 
+    namespace detail
+    {
+        // Shape of the (N-1)-dimensional slices of an expression of shape S
+        template <class S>
+        struct axis_view_shape
+        {
+            using type = S;
+        };
+
+        template <class T, std::size_t N>
+        struct axis_view_shape<std::array<T, N>>
+        {
+            using type = std::array<T, N - 1>;
+        };
+
+        template <class S>
+        using axis_view_shape_t = typename axis_view_shape<S>::type;
+    }
+
     /**
      * @class xaxis_iterator
      * @brief Class for iteration over (N-1)-dimensional slices, where
@@ -26,6 +50,8 @@ namespace xt
      *
      * If N is the number of dimensions of an expression, the xaxis_iterator
      * iterates over (N-1)-dimensional slices oriented along the specified axis.
+     * The iterator holds a single strided view whose data offset is moved on
+     * increment, dereferencing it does not build a new view.
      *
      * @tparam CT the closure type of the \ref xexpression
      */
@@ -39,7 +65,7 @@ namespace xt
         using xexpression_type = std::decay_t<CT>;
         using size_type = typename xexpression_type::size_type;
         using difference_type = typename xexpression_type::difference_type;
-        using shape_type = typename xexpression_type::shape_type;
+        using shape_type = detail::axis_view_shape_t<typename xexpression_type::shape_type>;
         using value_type = xstrided_view<CT, shape_type>;
         using reference = std::remove_reference_t<apply_cv_t<CT, value_type>>;
         using pointer = xtl::xclosure_pointer<std::remove_reference_t<apply_cv_t<CT, value_type>>>;
@@ -104,16 +130,16 @@ namespace xt
         auto derive_xstrided_view(CT&& e, typename std::decay_t<CT>::size_type axis, typename std::decay_t<CT>::size_type offset)
         {
             using xexpression_type = std::decay_t<CT>;
-            using shape_type = typename xexpression_type::shape_type;
-            using strides_type = typename xexpression_type::strides_type;
+            using shape_type = axis_view_shape_t<typename xexpression_type::shape_type>;
+            using strides_type = axis_view_shape_t<typename xexpression_type::strides_type>;
 
             const auto& e_shape = e.shape();
-            shape_type shape(e_shape.size() - 1);
+            shape_type shape = xtl::make_sequence<shape_type>(e_shape.size() - 1);
             auto nxt = std::copy(e_shape.cbegin(), e_shape.cbegin() + axis, shape.begin());
             std::copy(e_shape.cbegin() + axis + 1, e_shape.end(), nxt);
 
             const auto& e_strides = e.strides();
-            strides_type strides(e_strides.size() - 1);
+            strides_type strides = xtl::make_sequence<strides_type>(e_strides.size() - 1);
             auto nxt_strides = std::copy(e_strides.cbegin(), e_strides.cbegin() + axis, strides.begin());
             std::copy(e_strides.cbegin() + axis + 1, e_strides.end(), nxt_strides);
 
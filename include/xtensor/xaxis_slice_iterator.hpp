@@ -10,17 +10,41 @@
 #ifndef XTENSOR_AXIS_SLICE_ITERATOR_HPP
 #define XTENSOR_AXIS_SLICE_ITERATOR_HPP
 
+#include <array>
+#include <cstddef>
+
 #include "xstrided_view.hpp"
 
 namespace xt
 {
 
+    namespace detail
+    {
+        // Shape of the one-dimensional slices of an expression of shape S
+        template <class S>
+        struct axis_slice_shape
+        {
+            using type = S;
+        };
+
+        template <class T, std::size_t N>
+        struct axis_slice_shape<std::array<T, N>>
+        {
+            using type = std::array<T, 1>;
+        };
+
+        template <class S>
+        using axis_slice_shape_t = typename axis_slice_shape<S>::type;
+    }
+
     /**
      * @class xaxis_slice_iterator
      * @brief Class for iteration over one-dimensional slices
      *
      * The xaxis_slice_iterator iterates over one-dimensional slices
-     * oriented along the specified axis
+     * oriented along the specified axis. The iterator holds a single
+     * strided view whose data offset is moved on increment, dereferencing
+     * it does not build a new view.
      *
      * @tparam CT the closure type of the \ref xexpression
      */
@@ -34,8 +58,8 @@ namespace xt
         using xexpression_type = std::decay_t<CT>;
         using size_type = typename xexpression_type::size_type;
         using difference_type = typename xexpression_type::difference_type;
-        using shape_type = typename xexpression_type::shape_type;
-        using strides_type = typename xexpression_type::strides_type;
+        using shape_type = detail::axis_slice_shape_t<typename xexpression_type::shape_type>;
+        using strides_type = detail::axis_slice_shape_t<typename xexpression_type::strides_type>;
         using value_type = xstrided_view<CT, shape_type>;
         using reference = std::remove_reference_t<apply_cv_t<CT, value_type>>;
         using pointer = xtl::xclosure_pointer<std::remove_reference_t<apply_cv_t<CT, value_type>>>;
@@ -63,9 +87,7 @@ namespace xt
         size_type m_offset;
         size_type m_axis_stride;
         size_type m_lower_shape;
-        size_type m_upper_shape;
-        size_type m_iter_size;
-        bool m_is_target_axis;
+        size_type m_lower_index;
         value_type m_sv;
 
         template <class T, class CTA>
@@ -145,24 +167,18 @@ namespace xt
     inline xaxis_slice_iterator<CT>::xaxis_slice_iterator(CTA&& e, size_type axis, size_type index, size_type offset) :
         p_expression(get_storage_init<storing_type>(std::forward<CTA>(e))), m_index(index),
         m_offset(offset), m_axis_stride(static_cast<size_type>(e.strides()[axis]) * (e.shape()[axis] - 1u)),
-        m_lower_shape(0), m_upper_shape(0), m_iter_size(0), m_is_target_axis(false),
-        m_sv(strided_view(std::forward<CT>(e), std::forward<shape_type>({ e.shape()[axis] }),
-            std::forward<strides_type>({ e.strides()[axis] }), offset, e.layout()))
+        m_lower_shape(0), m_lower_index(0),
+        m_sv(strided_view(std::forward<CT>(e), shape_type({ e.shape()[axis] }),
+            strides_type({ e.strides()[axis] }), offset, e.layout()))
     {
         if (e.layout() == layout_type::row_major)
         {
-            m_is_target_axis = axis == e.dimension() - 1;
             m_lower_shape = std::accumulate(e.shape().begin() + axis + 1, e.shape().end(), size_t(1), std::multiplies<>());
-            m_iter_size = std::accumulate(e.shape().begin() + 1, e.shape().end(), size_t(1), std::multiplies<>());
-
         }
         else
         {
-            m_is_target_axis = axis == 0;
             m_lower_shape = std::accumulate(e.shape().begin(), e.shape().begin() + axis, size_t(1), std::multiplies<>());
-            m_iter_size = std::accumulate(e.shape().begin(), e.shape().end() - 1, size_t(1), std::multiplies<>());
         }
-        m_upper_shape = m_lower_shape + m_axis_stride;
     }
     //@}
 
@@ -176,10 +192,13 @@ namespace xt
     template <class CT>
     inline auto xaxis_slice_iterator<CT>::operator++() -> self_type&
     {
+        // The slices start at the elements whose index along the axis is 0,
+        // they form blocks of m_lower_shape consecutive offsets separated by
+        // the rest of the axis.
         ++m_index; ++m_offset;
-        auto index_compare = (m_offset % m_iter_size);
-        if (m_is_target_axis || (m_upper_shape >= index_compare && index_compare >= m_lower_shape))
+        if (++m_lower_index == m_lower_shape)
         {
+            m_lower_index = 0;
             m_offset += m_axis_stride;
         }
         m_sv.set_offset(m_offset);
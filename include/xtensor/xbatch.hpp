@@ -0,0 +1,407 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BATCH_HPP
+#define XTENSOR_BATCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xexpression.hpp"
+#include "xfixed.hpp"
+#include "xmanipulation.hpp"
+#include "xshape.hpp"
+#include "xtensor.hpp"
+#include "xtensor_forward.hpp"
+
+namespace xt
+{
+
+    /**********
+     * xbatch *
+     **********/
+
+    /**
+     * @class xbatch
+     * @brief Batch of small tensors of a fixed shape, stored as a structure
+     * of arrays.
+     *
+     * The tensors of shape \c S are stored in an xtensor of shape
+     * <tt>{S..., size()}</tt>: the batch axis is the last one, so that each
+     * element of the small tensors is a contiguous array over the batch.
+     * Element-wise expressions of the storages returned by soa() are
+     * therefore assigned with linear, vectorized loops across the batch,
+     * and batch_matmul and batch_det compute one small operation on whole
+     * SIMD registers of tensors at a time.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam S The shape of the tensors, an xshape.
+     */
+    template <class T, class S>
+    class xbatch
+    {
+    public:
+
+        static_assert(detail::is_fixed<S>::value, "The shape of the batched tensors must be an xshape");
+
+        static constexpr std::size_t rank = S::size();
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using item_type = xtensor_fixed<T, S, layout_type::row_major>;
+        using container_type = xtensor<T, rank + 1, layout_type::row_major>;
+        using item_shape_type = S;
+
+        xbatch() = default;
+        explicit xbatch(size_type n);
+
+        template <class E>
+        explicit xbatch(const xexpression<E>& soa);
+
+        template <class E>
+        static xbatch from_aos(const xexpression<E>& aos);
+
+        size_type size() const noexcept;
+        void resize(size_type n);
+
+        container_type& soa() noexcept;
+        const container_type& soa() const noexcept;
+
+        item_type get(size_type i) const;
+        void set(size_type i, const item_type& item);
+
+        xtensor<T, rank + 1, layout_type::row_major> to_aos() const;
+
+    private:
+
+        static constexpr size_type item_size = detail::fixed_compute_size<S>::value;
+
+        std::array<size_type, rank + 1> soa_shape(size_type n) const;
+        void check_index(size_type i) const;
+
+        container_type m_data;
+    };
+
+    template <class T, std::size_t M, std::size_t K, std::size_t P>
+    xbatch<T, xshape<M, P>> batch_matmul(const xbatch<T, xshape<M, K>>& a, const xbatch<T, xshape<K, P>>& b);
+
+    template <class T, std::size_t M, std::size_t K>
+    xbatch<T, xshape<M>> batch_matmul(const xbatch<T, xshape<M, K>>& a, const xbatch<T, xshape<K>>& b);
+
+    template <class T>
+    xtensor<T, 1> batch_det(const xbatch<T, xshape<2, 2>>& a);
+
+    template <class T>
+    xtensor<T, 1> batch_det(const xbatch<T, xshape<3, 3>>& a);
+
+    /*************************
+     * xbatch implementation *
+     *************************/
+
+    /**
+     * Builds a batch of \c n uninitialized tensors.
+     * @param n the number of tensors
+     */
+    template <class T, class S>
+    inline xbatch<T, S>::xbatch(size_type n)
+        : m_data(soa_shape(n))
+    {
+    }
+
+    /**
+     * Builds a batch from an expression in the layout of the storage, of
+     * shape <tt>{S..., n}</tt>.
+     * @param soa the expression holding the batch
+     */
+    template <class T, class S>
+    template <class E>
+    inline xbatch<T, S>::xbatch(const xexpression<E>& soa)
+        : m_data(soa)
+    {
+        const S item_shape{};
+        if (!std::equal(m_data.shape().cbegin(), m_data.shape().cend() - 1, item_shape.cbegin()))
+        {
+            XTENSOR_THROW(std::runtime_error, "xbatch: the leading dimensions must be the shape of the tensors");
+        }
+    }
+
+    /**
+     * Builds a batch from an expression holding the tensors one after the
+     * other, of shape <tt>{n, S...}</tt>.
+     * @param aos the expression holding the tensors
+     */
+    template <class T, class S>
+    template <class E>
+    inline auto xbatch<T, S>::from_aos(const xexpression<E>& aos) -> xbatch
+    {
+        std::array<size_type, rank + 1> permutation;
+        for (size_type i = 0; i < rank; ++i)
+        {
+            permutation[i] = i + 1;
+        }
+        permutation[rank] = 0;
+        return xbatch(transpose(aos.derived_cast(), permutation));
+    }
+
+    /**
+     * Returns the number of tensors of the batch.
+     */
+    template <class T, class S>
+    inline auto xbatch<T, S>::size() const noexcept -> size_type
+    {
+        return m_data.shape()[rank];
+    }
+
+    /**
+     * Resizes the batch to \c n tensors. The tensors are not preserved.
+     * @param n the number of tensors
+     */
+    template <class T, class S>
+    inline void xbatch<T, S>::resize(size_type n)
+    {
+        m_data.resize(soa_shape(n));
+    }
+
+    /**
+     * Returns a reference to the storage of the batch, of shape
+     * <tt>{S..., size()}</tt>, to be used in expressions.
+     */
+    template <class T, class S>
+    inline auto xbatch<T, S>::soa() noexcept -> container_type&
+    {
+        return m_data;
+    }
+
+    /**
+     * Returns a constant reference to the storage of the batch, of shape
+     * <tt>{S..., size()}</tt>, to be used in expressions.
+     */
+    template <class T, class S>
+    inline auto xbatch<T, S>::soa() const noexcept -> const container_type&
+    {
+        return m_data;
+    }
+
+    /**
+     * Returns a copy of the tensor at index \c i of the batch.
+     */
+    template <class T, class S>
+    inline auto xbatch<T, S>::get(size_type i) const -> item_type
+    {
+        check_index(i);
+        item_type res;
+        const size_type n = size();
+        const T* src = m_data.data() + i;
+        for (size_type j = 0; j < item_size; ++j)
+        {
+            res.data()[j] = src[j * n];
+        }
+        return res;
+    }
+
+    /**
+     * Replaces the tensor at index \c i of the batch with \c item.
+     */
+    template <class T, class S>
+    inline void xbatch<T, S>::set(size_type i, const item_type& item)
+    {
+        check_index(i);
+        const size_type n = size();
+        T* dst = m_data.data() + i;
+        for (size_type j = 0; j < item_size; ++j)
+        {
+            dst[j * n] = item.data()[j];
+        }
+    }
+
+    /**
+     * Returns the tensors of the batch one after the other, in a tensor of
+     * shape <tt>{size(), S...}</tt>.
+     */
+    template <class T, class S>
+    inline auto xbatch<T, S>::to_aos() const -> xtensor<T, rank + 1, layout_type::row_major>
+    {
+        std::array<size_type, rank + 1> permutation;
+        permutation[0] = rank;
+        for (size_type i = 0; i < rank; ++i)
+        {
+            permutation[i + 1] = i;
+        }
+        return transpose(m_data, permutation);
+    }
+
+    template <class T, class S>
+    inline auto xbatch<T, S>::soa_shape(size_type n) const -> std::array<size_type, rank + 1>
+    {
+        const S item_shape{};
+        std::array<size_type, rank + 1> shape;
+        std::copy(item_shape.cbegin(), item_shape.cend(), shape.begin());
+        shape[rank] = n;
+        return shape;
+    }
+
+    template <class T, class S>
+    inline void xbatch<T, S>::check_index(size_type i) const
+    {
+        if (i >= size())
+        {
+            XTENSOR_THROW(std::out_of_range, "xbatch: index out of the batch");
+        }
+    }
+
+    /*******************
+     * Batched kernels *
+     *******************/
+
+    namespace detail
+    {
+        template <class T, class S1, class S2>
+        inline void check_batch_sizes(const xbatch<T, S1>& a, const xbatch<T, S2>& b)
+        {
+            if (a.size() != b.size())
+            {
+                XTENSOR_THROW(std::runtime_error, "The batches must hold the same number of tensors");
+            }
+        }
+
+        // Computes the products of the batches of M x K and K x P matrices
+        // stored in a and b into res, for the tensors [first, last). The
+        // range is split in blocks that stay in cache, each step being a
+        // loop over a block, vectorized by the compiler.
+        template <class T>
+        inline void batch_matmul_range(const T* a, const T* b, T* res, std::size_t m, std::size_t k, std::size_t p,
+                                       std::size_t n, std::size_t first, std::size_t last)
+        {
+            constexpr std::size_t block_size = 256;
+            for (std::size_t block = first; block < last; block += block_size)
+            {
+                std::size_t block_end = (std::min)(block + block_size, last);
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    for (std::size_t j = 0; j < p; ++j)
+                    {
+                        T* out = res + (i * p + j) * n;
+                        std::fill(out + block, out + block_end, T(0));
+                        for (std::size_t l = 0; l < k; ++l)
+                        {
+                            const T* lhs = a + (i * k + l) * n;
+                            const T* rhs = b + (l * p + j) * n;
+                            for (std::size_t t = block; t < block_end; ++t)
+                            {
+                                out[t] += lhs[t] * rhs[t];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns the batch of the products of the M x K matrices of \c a and
+     * of the K x P matrices of \c b.
+     */
+    template <class T, std::size_t M, std::size_t K, std::size_t P>
+    inline xbatch<T, xshape<M, P>> batch_matmul(const xbatch<T, xshape<M, K>>& a, const xbatch<T, xshape<K, P>>& b)
+    {
+        detail::check_batch_sizes(a, b);
+        std::size_t n = a.size();
+        xbatch<T, xshape<M, P>> res(n);
+        const T* pa = a.soa().data();
+        const T* pb = b.soa().data();
+        T* pres = res.soa().data();
+        exec::default_policy().for_range(std::size_t(0), n, std::size_t(1), [=](std::size_t first, std::size_t last)
+        {
+            detail::batch_matmul_range(pa, pb, pres, M, K, P, n, first, last);
+        });
+        return res;
+    }
+
+    /**
+     * Returns the batch of the products of the M x K matrices of \c a and
+     * of the vectors of size K of \c b.
+     */
+    template <class T, std::size_t M, std::size_t K>
+    inline xbatch<T, xshape<M>> batch_matmul(const xbatch<T, xshape<M, K>>& a, const xbatch<T, xshape<K>>& b)
+    {
+        detail::check_batch_sizes(a, b);
+        std::size_t n = a.size();
+        xbatch<T, xshape<M>> res(n);
+        const T* pa = a.soa().data();
+        const T* pb = b.soa().data();
+        T* pres = res.soa().data();
+        exec::default_policy().for_range(std::size_t(0), n, std::size_t(1), [=](std::size_t first, std::size_t last)
+        {
+            detail::batch_matmul_range(pa, pb, pres, M, K, std::size_t(1), n, first, last);
+        });
+        return res;
+    }
+
+    /**
+     * Returns the determinants of the 2 x 2 matrices of \c a.
+     */
+    template <class T>
+    inline xtensor<T, 1> batch_det(const xbatch<T, xshape<2, 2>>& a)
+    {
+        std::size_t n = a.size();
+        xtensor<T, 1> res = xtensor<T, 1>::from_shape({n});
+        const T* p = a.soa().data();
+        T* out = res.data();
+        exec::default_policy().for_range(std::size_t(0), n, std::size_t(1), [=](std::size_t first, std::size_t last)
+        {
+            const T* a00 = p;
+            const T* a01 = p + n;
+            const T* a10 = p + 2 * n;
+            const T* a11 = p + 3 * n;
+            for (std::size_t t = first; t < last; ++t)
+            {
+                out[t] = a00[t] * a11[t] - a01[t] * a10[t];
+            }
+        });
+        return res;
+    }
+
+    /**
+     * Returns the determinants of the 3 x 3 matrices of \c a.
+     */
+    template <class T>
+    inline xtensor<T, 1> batch_det(const xbatch<T, xshape<3, 3>>& a)
+    {
+        std::size_t n = a.size();
+        xtensor<T, 1> res = xtensor<T, 1>::from_shape({n});
+        const T* p = a.soa().data();
+        T* out = res.data();
+        exec::default_policy().for_range(std::size_t(0), n, std::size_t(1), [=](std::size_t first, std::size_t last)
+        {
+            const T* a00 = p;
+            const T* a01 = p + n;
+            const T* a02 = p + 2 * n;
+            const T* a10 = p + 3 * n;
+            const T* a11 = p + 4 * n;
+            const T* a12 = p + 5 * n;
+            const T* a20 = p + 6 * n;
+            const T* a21 = p + 7 * n;
+            const T* a22 = p + 8 * n;
+            for (std::size_t t = first; t < last; ++t)
+            {
+                out[t] = a00[t] * (a11[t] * a22[t] - a12[t] * a21[t])
+                       - a01[t] * (a10[t] * a22[t] - a12[t] * a20[t])
+                       + a02[t] * (a10[t] * a21[t] - a11[t] * a20[t]);
+            }
+        });
+        return res;
+    }
+}
+
+#endif
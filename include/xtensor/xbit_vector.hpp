@@ -0,0 +1,1263 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BIT_VECTOR_HPP
+#define XTENSOR_BIT_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "xbuffer_adaptor.hpp"
+#include "xstorage.hpp"
+#include "xtensor_forward.hpp"
+#include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
+
+namespace xt
+{
+
+    /******************
+     * xbit_reference *
+     ******************/
+
+    /**
+     * @class xbit_reference
+     * @brief Proxy on a bit of an xbit_vector, behaving as a bool.
+     *
+     * @tparam B The type of the blocks holding the bits.
+     */
+    template <class B = std::uint64_t>
+    class xbit_reference
+    {
+    public:
+
+        using block_type = B;
+
+        xbit_reference(block_type* block, block_type mask) noexcept;
+        xbit_reference(const xbit_reference&) noexcept = default;
+
+        operator bool() const noexcept;
+
+        xbit_reference& operator=(bool value) noexcept;
+        xbit_reference& operator=(const xbit_reference& rhs) noexcept;
+
+        xbit_reference& operator|=(bool value) noexcept;
+        xbit_reference& operator&=(bool value) noexcept;
+        xbit_reference& operator^=(bool value) noexcept;
+
+        bool operator~() const noexcept;
+        xbit_reference& flip() noexcept;
+
+    private:
+
+        block_type* p_block;
+        block_type m_mask;
+    };
+
+    template <class B>
+    void swap(xbit_reference<B> lhs, xbit_reference<B> rhs) noexcept;
+
+    /*****************
+     * xbit_iterator *
+     *****************/
+
+    /**
+     * @class xbit_iterator
+     * @brief Random access iterator on the bits of an xbit_vector.
+     *
+     * @tparam C true for a constant iterator.
+     * @tparam B The type of the blocks holding the bits.
+     */
+    template <bool C, class B = std::uint64_t>
+    class xbit_iterator
+    {
+    public:
+
+        using block_type = B;
+        using block_pointer = std::conditional_t<C, const block_type*, block_type*>;
+        using value_type = bool;
+        using reference = std::conditional_t<C, bool, xbit_reference<B>>;
+        using pointer = xbit_iterator<C, B>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+
+        static constexpr std::size_t block_bits = 8 * sizeof(B);
+
+        xbit_iterator() noexcept;
+        xbit_iterator(block_pointer blocks, difference_type index) noexcept;
+
+        template <bool RC, class = std::enable_if_t<C && !RC>>
+        xbit_iterator(const xbit_iterator<RC, B>& rhs) noexcept;
+
+        reference operator*() const noexcept;
+
+        template <class N, class = std::enable_if_t<std::is_integral<N>::value>>
+        reference operator[](N n) const noexcept;
+
+        xbit_iterator& operator++() noexcept;
+        xbit_iterator operator++(int) noexcept;
+        xbit_iterator& operator--() noexcept;
+        xbit_iterator operator--(int) noexcept;
+
+        // The offsets may be unsigned, as the offsets of the pointers the
+        // iterator stands for
+        template <class N, class = std::enable_if_t<std::is_integral<N>::value>>
+        xbit_iterator& operator+=(N n) noexcept;
+
+        template <class N, class = std::enable_if_t<std::is_integral<N>::value>>
+        xbit_iterator& operator-=(N n) noexcept;
+
+        template <class N, class = std::enable_if_t<std::is_integral<N>::value>>
+        xbit_iterator operator+(N n) const noexcept;
+
+        template <class N, class = std::enable_if_t<std::is_integral<N>::value>>
+        xbit_iterator operator-(N n) const noexcept;
+
+        difference_type operator-(const xbit_iterator& rhs) const noexcept;
+
+        bool operator==(const xbit_iterator& rhs) const noexcept;
+        bool operator!=(const xbit_iterator& rhs) const noexcept;
+        bool operator<(const xbit_iterator& rhs) const noexcept;
+        bool operator<=(const xbit_iterator& rhs) const noexcept;
+        bool operator>(const xbit_iterator& rhs) const noexcept;
+        bool operator>=(const xbit_iterator& rhs) const noexcept;
+
+        block_pointer blocks() const noexcept;
+        difference_type index() const noexcept;
+
+    private:
+
+        block_pointer p_blocks;
+        difference_type m_index;
+    };
+
+    template <class N, bool C, class B, class = std::enable_if_t<std::is_integral<N>::value>>
+    xbit_iterator<C, B> operator+(N n, const xbit_iterator<C, B>& it) noexcept;
+
+    /***************
+     * xbit_vector *
+     ***************/
+
+    /**
+     * @class xbit_vector
+     * @brief Container of bools packed in 64-bit blocks.
+     *
+     * xbit_vector stores one bit per element and can be used as the storage
+     * of an xarray_container, see xbit_array, to hold masks eight times
+     * smaller than an array of bool. The elements are accessed through
+     * xbit_reference proxies; assigning an expression to an xbit_array packs
+     * a whole block at a time, and count_nonzero, argwhere and filter work
+     * on the blocks directly. The padding bits of the last block are always
+     * zero.
+     *
+     * @tparam A The allocator of the blocks.
+     */
+    template <class A = std::allocator<std::uint64_t>>
+    class xbit_vector
+    {
+    public:
+
+        using block_type = std::uint64_t;
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<block_type>;
+        using block_storage = uvector<block_type, allocator_type>;
+
+        using value_type = bool;
+        using reference = xbit_reference<>;
+        using const_reference = bool;
+        using iterator = xbit_iterator<false>;
+        using const_iterator = xbit_iterator<true>;
+        using pointer = iterator;
+        using const_pointer = const_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        static constexpr size_type block_bits = 64;
+
+        xbit_vector() noexcept = default;
+        explicit xbit_vector(size_type count, const allocator_type& alloc = allocator_type());
+        xbit_vector(size_type count, bool value, const allocator_type& alloc = allocator_type());
+
+        template <class InputIt, class = detail::require_input_iter<InputIt>>
+        xbit_vector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type());
+
+        xbit_vector(std::initializer_list<bool> init, const allocator_type& alloc = allocator_type());
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        void resize(size_type size);
+
+        reference operator[](size_type i) noexcept;
+        const_reference operator[](size_type i) const noexcept;
+
+        reference front() noexcept;
+        const_reference front() const noexcept;
+        reference back() noexcept;
+        const_reference back() const noexcept;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        size_type block_count() const noexcept;
+        block_type* blocks() noexcept;
+        const block_type* blocks() const noexcept;
+
+        size_type count() const noexcept;
+        void fill(bool value) noexcept;
+
+        allocator_type get_allocator() const noexcept;
+        void swap(xbit_vector& rhs) noexcept;
+
+    private:
+
+        void clear_padding() noexcept;
+
+        block_storage m_blocks;
+        size_type m_size = 0;
+    };
+
+    template <class A>
+    bool operator==(const xbit_vector<A>& lhs, const xbit_vector<A>& rhs) noexcept;
+
+    template <class A>
+    bool operator!=(const xbit_vector<A>& lhs, const xbit_vector<A>& rhs) noexcept;
+
+    template <class A>
+    void swap(xbit_vector<A>& lhs, xbit_vector<A>& rhs) noexcept;
+
+    template <class A>
+    void load_bitmap(xbit_vector<A>& v, const std::uint8_t* bitmap, std::size_t offset = 0) noexcept;
+
+    template <class A>
+    void store_bitmap(const xbit_vector<A>& v, std::uint8_t* bitmap) noexcept;
+
+    template <class A>
+    struct forbid_simd<xbit_vector<A>> : std::true_type
+    {
+    };
+
+    template <class A>
+    struct forbid_simd<const xbit_vector<A>> : std::true_type
+    {
+    };
+
+    /*******************
+     * xbitmap_adaptor *
+     *******************/
+
+    /**
+     * @class xbitmap_adaptor
+     * @brief Adaptor on an external bitmap, behaving as a container of bools.
+     *
+     * xbitmap_adaptor exposes without copying the bits of a buffer of bytes
+     * in the layout of the Apache Arrow validity bitmaps: least significant
+     * bit first, starting at an arbitrary bit offset. It can be used as the
+     * storage of an xarray_adaptor, for instance to hold the missing mask of
+     * an xoptional_assembly_adaptor, see adapt_bitmap. An owner of the
+     * bitmap can be shared with the adaptor to keep the buffer alive.
+     *
+     * @tparam T The type of the bytes, const std::uint8_t for a read-only
+     *           bitmap.
+     */
+    template <class T = std::uint8_t>
+    class xbitmap_adaptor
+    {
+    public:
+
+        static_assert(std::is_same<std::remove_const_t<T>, std::uint8_t>::value,
+                      "xbitmap_adaptor holds a bitmap of std::uint8_t");
+
+        using block_type = std::uint8_t;
+        using allocator_type = std::allocator<block_type>;
+        using owner_type = std::shared_ptr<const void>;
+        using temporary_type = xbit_vector<>;
+
+        using value_type = bool;
+        using reference = std::conditional_t<std::is_const<T>::value, bool, xbit_reference<block_type>>;
+        using const_reference = bool;
+        using iterator = xbit_iterator<std::is_const<T>::value, block_type>;
+        using const_iterator = xbit_iterator<true, block_type>;
+        using pointer = iterator;
+        using const_pointer = const_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        xbitmap_adaptor() noexcept = default;
+        xbitmap_adaptor(T* bitmap, size_type size, size_type offset = 0, owner_type owner = owner_type()) noexcept;
+
+        xbitmap_adaptor& operator=(temporary_type&& tmp);
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        void resize(size_type size);
+
+        reference operator[](size_type i) noexcept;
+        const_reference operator[](size_type i) const noexcept;
+
+        reference front() noexcept;
+        const_reference front() const noexcept;
+        reference back() noexcept;
+        const_reference back() const noexcept;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        T* bitmap() const noexcept;
+        size_type offset() const noexcept;
+        const owner_type& owner() const noexcept;
+
+        size_type count() const noexcept;
+
+        void swap(xbitmap_adaptor& rhs) noexcept;
+
+    private:
+
+        T* p_bitmap = nullptr;
+        size_type m_offset = 0;
+        size_type m_size = 0;
+        owner_type m_owner;
+    };
+
+    template <class T>
+    void swap(xbitmap_adaptor<T>& lhs, xbitmap_adaptor<T>& rhs) noexcept;
+
+    template <class T>
+    struct forbid_simd<xbitmap_adaptor<T>> : std::true_type
+    {
+    };
+
+    template <class T>
+    struct forbid_simd<const xbitmap_adaptor<T>> : std::true_type
+    {
+    };
+
+    template <class T>
+    struct temporary_container<xbitmap_adaptor<T>>
+    {
+        using type = typename xbitmap_adaptor<T>::temporary_type;
+    };
+
+    template <class T>
+    struct is_bit_vector : std::false_type
+    {
+    };
+
+    template <class A>
+    struct is_bit_vector<xbit_vector<A>> : std::true_type
+    {
+    };
+
+    namespace detail
+    {
+        template <class E, class = void>
+        struct is_bit_array_impl : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_bit_array_impl<E, void_t<typename E::storage_type>>
+            : xtl::conjunction<std::is_base_of<xcontainer<E>, E>,
+                               is_bit_vector<std::decay_t<typename E::storage_type>>>
+        {
+        };
+    }
+
+    /**
+     * Checks whether E is a container whose elements are held in an
+     * xbit_vector.
+     */
+    template <class E>
+    struct is_bit_array : detail::is_bit_array_impl<std::decay_t<E>>
+    {
+    };
+
+    namespace detail
+    {
+        inline std::size_t popcount(std::uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<std::size_t>(__builtin_popcountll(x));
+#else
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return static_cast<std::size_t>((x * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        inline std::size_t count_trailing_zeros(std::uint64_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<std::size_t>(__builtin_ctzll(x));
+#else
+            std::size_t res = 0;
+            while ((x & 1u) == 0u)
+            {
+                x >>= 1;
+                ++res;
+            }
+            return res;
+#endif
+        }
+
+        /**
+         * Calls f with the index of each set bit of the n first bits of
+         * blocks, in increasing order.
+         */
+        template <class F>
+        inline void for_each_set_bit(const std::uint64_t* blocks, std::size_t n, F&& f)
+        {
+            std::size_t block_count = (n + 63) / 64;
+            for (std::size_t b = 0; b < block_count; ++b)
+            {
+                std::uint64_t word = blocks[b];
+                while (word != 0u)
+                {
+                    f(b * 64 + count_trailing_zeros(word));
+                    word &= word - 1u;
+                }
+            }
+        }
+    }
+
+    /*********************************
+     * xbit_reference implementation *
+     *********************************/
+
+    template <class B>
+    inline xbit_reference<B>::xbit_reference(block_type* block, block_type mask) noexcept
+        : p_block(block), m_mask(mask)
+    {
+    }
+
+    template <class B>
+    inline xbit_reference<B>::operator bool() const noexcept
+    {
+        return (*p_block & m_mask) != 0u;
+    }
+
+    template <class B>
+    inline xbit_reference<B>& xbit_reference<B>::operator=(bool value) noexcept
+    {
+        if (value)
+        {
+            *p_block |= m_mask;
+        }
+        else
+        {
+            *p_block &= static_cast<block_type>(~m_mask);
+        }
+        return *this;
+    }
+
+    template <class B>
+    inline xbit_reference<B>& xbit_reference<B>::operator=(const xbit_reference& rhs) noexcept
+    {
+        return *this = bool(rhs);
+    }
+
+    template <class B>
+    inline xbit_reference<B>& xbit_reference<B>::operator|=(bool value) noexcept
+    {
+        return *this = bool(*this) || value;
+    }
+
+    template <class B>
+    inline xbit_reference<B>& xbit_reference<B>::operator&=(bool value) noexcept
+    {
+        return *this = bool(*this) && value;
+    }
+
+    template <class B>
+    inline xbit_reference<B>& xbit_reference<B>::operator^=(bool value) noexcept
+    {
+        return *this = bool(*this) != value;
+    }
+
+    template <class B>
+    inline bool xbit_reference<B>::operator~() const noexcept
+    {
+        return !bool(*this);
+    }
+
+    template <class B>
+    inline xbit_reference<B>& xbit_reference<B>::flip() noexcept
+    {
+        *p_block ^= m_mask;
+        return *this;
+    }
+
+    template <class B>
+    inline void swap(xbit_reference<B> lhs, xbit_reference<B> rhs) noexcept
+    {
+        bool tmp = lhs;
+        lhs = bool(rhs);
+        rhs = tmp;
+    }
+
+    /********************************
+     * xbit_iterator implementation *
+     ********************************/
+
+    template <bool C, class B>
+    inline xbit_iterator<C, B>::xbit_iterator() noexcept
+        : p_blocks(nullptr), m_index(0)
+    {
+    }
+
+    template <bool C, class B>
+    inline xbit_iterator<C, B>::xbit_iterator(block_pointer blocks, difference_type index) noexcept
+        : p_blocks(blocks), m_index(index)
+    {
+    }
+
+    template <bool C, class B>
+    template <bool RC, class>
+    inline xbit_iterator<C, B>::xbit_iterator(const xbit_iterator<RC, B>& rhs) noexcept
+        : p_blocks(rhs.blocks()), m_index(rhs.index())
+    {
+    }
+
+    namespace detail
+    {
+        template <class B>
+        inline xbit_reference<B> make_bit_reference(B* blocks, std::ptrdiff_t index) noexcept
+        {
+            constexpr std::size_t block_bits = 8 * sizeof(B);
+            std::size_t i = static_cast<std::size_t>(index);
+            return xbit_reference<B>(blocks + i / block_bits, static_cast<B>(B(1) << (i % block_bits)));
+        }
+
+        template <class B>
+        inline bool make_bit_reference(const B* blocks, std::ptrdiff_t index) noexcept
+        {
+            constexpr std::size_t block_bits = 8 * sizeof(B);
+            std::size_t i = static_cast<std::size_t>(index);
+            return ((blocks[i / block_bits] >> (i % block_bits)) & 1u) != 0u;
+        }
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::operator*() const noexcept -> reference
+    {
+        return detail::make_bit_reference(p_blocks, m_index);
+    }
+
+    template <bool C, class B>
+    template <class N, class>
+    inline auto xbit_iterator<C, B>::operator[](N n) const noexcept -> reference
+    {
+        return detail::make_bit_reference(p_blocks, m_index + static_cast<difference_type>(n));
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::operator++() noexcept -> xbit_iterator&
+    {
+        ++m_index;
+        return *this;
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::operator++(int) noexcept -> xbit_iterator
+    {
+        xbit_iterator tmp(*this);
+        ++m_index;
+        return tmp;
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::operator--() noexcept -> xbit_iterator&
+    {
+        --m_index;
+        return *this;
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::operator--(int) noexcept -> xbit_iterator
+    {
+        xbit_iterator tmp(*this);
+        --m_index;
+        return tmp;
+    }
+
+    template <bool C, class B>
+    template <class N, class>
+    inline auto xbit_iterator<C, B>::operator+=(N n) noexcept -> xbit_iterator&
+    {
+        m_index += static_cast<difference_type>(n);
+        return *this;
+    }
+
+    template <bool C, class B>
+    template <class N, class>
+    inline auto xbit_iterator<C, B>::operator-=(N n) noexcept -> xbit_iterator&
+    {
+        m_index -= static_cast<difference_type>(n);
+        return *this;
+    }
+
+    template <bool C, class B>
+    template <class N, class>
+    inline auto xbit_iterator<C, B>::operator+(N n) const noexcept -> xbit_iterator
+    {
+        return xbit_iterator(p_blocks, m_index + static_cast<difference_type>(n));
+    }
+
+    template <bool C, class B>
+    template <class N, class>
+    inline auto xbit_iterator<C, B>::operator-(N n) const noexcept -> xbit_iterator
+    {
+        return xbit_iterator(p_blocks, m_index - static_cast<difference_type>(n));
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::operator-(const xbit_iterator& rhs) const noexcept -> difference_type
+    {
+        return m_index - rhs.m_index;
+    }
+
+    template <bool C, class B>
+    inline bool xbit_iterator<C, B>::operator==(const xbit_iterator& rhs) const noexcept
+    {
+        return p_blocks == rhs.p_blocks && m_index == rhs.m_index;
+    }
+
+    template <bool C, class B>
+    inline bool xbit_iterator<C, B>::operator!=(const xbit_iterator& rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    template <bool C, class B>
+    inline bool xbit_iterator<C, B>::operator<(const xbit_iterator& rhs) const noexcept
+    {
+        return m_index < rhs.m_index;
+    }
+
+    template <bool C, class B>
+    inline bool xbit_iterator<C, B>::operator<=(const xbit_iterator& rhs) const noexcept
+    {
+        return m_index <= rhs.m_index;
+    }
+
+    template <bool C, class B>
+    inline bool xbit_iterator<C, B>::operator>(const xbit_iterator& rhs) const noexcept
+    {
+        return m_index > rhs.m_index;
+    }
+
+    template <bool C, class B>
+    inline bool xbit_iterator<C, B>::operator>=(const xbit_iterator& rhs) const noexcept
+    {
+        return m_index >= rhs.m_index;
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::blocks() const noexcept -> block_pointer
+    {
+        return p_blocks;
+    }
+
+    template <bool C, class B>
+    inline auto xbit_iterator<C, B>::index() const noexcept -> difference_type
+    {
+        return m_index;
+    }
+
+    template <class N, bool C, class B, class>
+    inline xbit_iterator<C, B> operator+(N n, const xbit_iterator<C, B>& it) noexcept
+    {
+        return it + n;
+    }
+
+    /******************************
+     * xbit_vector implementation *
+     ******************************/
+
+    template <class A>
+    inline xbit_vector<A>::xbit_vector(size_type count, const allocator_type& alloc)
+        : xbit_vector(count, false, alloc)
+    {
+    }
+
+    template <class A>
+    inline xbit_vector<A>::xbit_vector(size_type count, bool value, const allocator_type& alloc)
+        : m_blocks((count + block_bits - 1) / block_bits, value ? ~block_type(0) : block_type(0), alloc), m_size(count)
+    {
+        clear_padding();
+    }
+
+    template <class A>
+    template <class InputIt, class>
+    inline xbit_vector<A>::xbit_vector(InputIt first, InputIt last, const allocator_type& alloc)
+        : xbit_vector(static_cast<size_type>(std::distance(first, last)), false, alloc)
+    {
+        std::copy(first, last, begin());
+    }
+
+    template <class A>
+    inline xbit_vector<A>::xbit_vector(std::initializer_list<bool> init, const allocator_type& alloc)
+        : xbit_vector(init.begin(), init.end(), alloc)
+    {
+    }
+
+    template <class A>
+    inline bool xbit_vector<A>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Resizes the vector; the new elements are false.
+     */
+    template <class A>
+    inline void xbit_vector<A>::resize(size_type size)
+    {
+        size_type count = (size + block_bits - 1) / block_bits;
+        if (count != m_blocks.size())
+        {
+            block_storage tmp(count, block_type(0), m_blocks.get_allocator());
+            std::copy(m_blocks.cbegin(), m_blocks.cbegin() + static_cast<difference_type>((std::min)(count, m_blocks.size())), tmp.begin());
+            m_blocks.swap(tmp);
+        }
+        m_size = size;
+        clear_padding();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::operator[](size_type i) noexcept -> reference
+    {
+        return reference(m_blocks.data() + i / block_bits, block_type(1) << (i % block_bits));
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::operator[](size_type i) const noexcept -> const_reference
+    {
+        return ((m_blocks[i / block_bits] >> (i % block_bits)) & 1u) != 0u;
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::front() noexcept -> reference
+    {
+        return (*this)[0];
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::front() const noexcept -> const_reference
+    {
+        return (*this)[0];
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::back() noexcept -> reference
+    {
+        return (*this)[m_size - 1];
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::back() const noexcept -> const_reference
+    {
+        return (*this)[m_size - 1];
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::data() noexcept -> pointer
+    {
+        return begin();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::data() const noexcept -> const_pointer
+    {
+        return begin();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::begin() noexcept -> iterator
+    {
+        return iterator(m_blocks.data(), 0);
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::end() noexcept -> iterator
+    {
+        return iterator(m_blocks.data(), static_cast<difference_type>(m_size));
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(m_blocks.data(), 0);
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::cend() const noexcept -> const_iterator
+    {
+        return const_iterator(m_blocks.data(), static_cast<difference_type>(m_size));
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::block_count() const noexcept -> size_type
+    {
+        return m_blocks.size();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::blocks() noexcept -> block_type*
+    {
+        return m_blocks.data();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::blocks() const noexcept -> const block_type*
+    {
+        return m_blocks.data();
+    }
+
+    /**
+     * Returns the number of elements set to true.
+     */
+    template <class A>
+    inline auto xbit_vector<A>::count() const noexcept -> size_type
+    {
+        size_type res = 0;
+        for (block_type b : m_blocks)
+        {
+            res += detail::popcount(b);
+        }
+        return res;
+    }
+
+    template <class A>
+    inline void xbit_vector<A>::fill(bool value) noexcept
+    {
+        std::fill(m_blocks.begin(), m_blocks.end(), value ? ~block_type(0) : block_type(0));
+        clear_padding();
+    }
+
+    template <class A>
+    inline auto xbit_vector<A>::get_allocator() const noexcept -> allocator_type
+    {
+        return m_blocks.get_allocator();
+    }
+
+    template <class A>
+    inline void xbit_vector<A>::swap(xbit_vector& rhs) noexcept
+    {
+        m_blocks.swap(rhs.m_blocks);
+        std::swap(m_size, rhs.m_size);
+    }
+
+    template <class A>
+    inline void xbit_vector<A>::clear_padding() noexcept
+    {
+        size_type used = m_size % block_bits;
+        if (used != 0)
+        {
+            m_blocks[m_blocks.size() - 1] &= (block_type(1) << used) - 1u;
+        }
+    }
+
+    template <class A>
+    inline bool operator==(const xbit_vector<A>& lhs, const xbit_vector<A>& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.blocks(), lhs.blocks() + lhs.block_count(), rhs.blocks());
+    }
+
+    template <class A>
+    inline bool operator!=(const xbit_vector<A>& lhs, const xbit_vector<A>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class A>
+    inline void swap(xbit_vector<A>& lhs, xbit_vector<A>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /**
+     * Reads the v.size() bits of v from a validity bitmap in the layout of
+     * Apache Arrow: the bit i of the bitmap is the bit i % 8 of its byte
+     * i / 8, the least significant bit first. The bits are read starting
+     * at the bit offset of the bitmap, as the bitmaps of sliced Arrow
+     * arrays; the bitmap must hold at least (offset + v.size() + 7) / 8 bytes.
+     */
+    template <class A>
+    inline void load_bitmap(xbit_vector<A>& v, const std::uint8_t* bitmap, std::size_t offset) noexcept
+    {
+        using block_type = typename xbit_vector<A>::block_type;
+        constexpr std::size_t block_bits = xbit_vector<A>::block_bits;
+
+        block_type* blocks = v.blocks();
+        const std::size_t n = v.size();
+        for (std::size_t b = 0; b < v.block_count(); ++b)
+        {
+            const std::size_t first = offset + b * block_bits;
+            const std::size_t bits = (std::min)(block_bits, n - b * block_bits);
+            const std::size_t shift = first % 8;
+            const std::size_t bytes = (shift + bits + 7) / 8;
+            const std::uint8_t* src = bitmap + first / 8;
+            block_type word = 0;
+            for (std::size_t k = 0; k < (std::min)(bytes, std::size_t(8)); ++k)
+            {
+                word |= block_type(src[k]) << (8 * k);
+            }
+            word >>= shift;
+            if (bytes > 8)
+            {
+                word |= block_type(src[8]) << (block_bits - shift);
+            }
+            if (bits < block_bits)
+            {
+                word &= (block_type(1) << bits) - 1u;
+            }
+            blocks[b] = word;
+        }
+    }
+
+    /**
+     * Writes the v.size() bits of v to a validity bitmap in the layout of
+     * Apache Arrow, see load_bitmap. The bitmap must hold at least
+     * (v.size() + 7) / 8 bytes; the padding bits of its last byte are zero.
+     */
+    template <class A>
+    inline void store_bitmap(const xbit_vector<A>& v, std::uint8_t* bitmap) noexcept
+    {
+        const auto* blocks = v.blocks();
+        const std::size_t bytes = (v.size() + 7) / 8;
+        for (std::size_t j = 0; j < bytes; ++j)
+        {
+            bitmap[j] = static_cast<std::uint8_t>(blocks[j / 8] >> (8 * (j % 8)));
+        }
+    }
+
+    /**********************************
+     * xbitmap_adaptor implementation *
+     **********************************/
+
+    /**
+     * Builds an adaptor on the bits [offset, offset + size) of bitmap.
+     * @param bitmap the bytes of the bitmap
+     * @param size the number of bits adapted
+     * @param offset the index of the first adapted bit in the bitmap
+     * @param owner optional owner of the bitmap, kept alive by the adaptor
+     */
+    template <class T>
+    inline xbitmap_adaptor<T>::xbitmap_adaptor(T* bitmap, size_type size, size_type offset, owner_type owner) noexcept
+        : p_bitmap(bitmap), m_offset(offset), m_size(size), m_owner(std::move(owner))
+    {
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::operator=(temporary_type&& tmp) -> xbitmap_adaptor&
+    {
+        resize(tmp.size());
+        std::copy(tmp.cbegin(), tmp.cend(), begin());
+        return *this;
+    }
+
+    template <class T>
+    inline bool xbitmap_adaptor<T>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    template <class T>
+    inline void xbitmap_adaptor<T>::resize(size_type size)
+    {
+        if (size != m_size)
+        {
+            XTENSOR_THROW(std::runtime_error, "xbitmap_adaptor not resizable");
+        }
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::operator[](size_type i) noexcept -> reference
+    {
+        return begin()[i];
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::operator[](size_type i) const noexcept -> const_reference
+    {
+        return cbegin()[i];
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::front() noexcept -> reference
+    {
+        return begin()[0];
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::front() const noexcept -> const_reference
+    {
+        return cbegin()[0];
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::back() noexcept -> reference
+    {
+        return begin()[m_size - 1];
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::back() const noexcept -> const_reference
+    {
+        return cbegin()[m_size - 1];
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::data() noexcept -> pointer
+    {
+        return begin();
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::data() const noexcept -> const_pointer
+    {
+        return cbegin();
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::begin() noexcept -> iterator
+    {
+        return iterator(p_bitmap, static_cast<difference_type>(m_offset));
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::end() noexcept -> iterator
+    {
+        return begin() + m_size;
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(p_bitmap, static_cast<difference_type>(m_offset));
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::cend() const noexcept -> const_iterator
+    {
+        return cbegin() + m_size;
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    /**
+     * Returns the bytes of the adapted bitmap.
+     */
+    template <class T>
+    inline T* xbitmap_adaptor<T>::bitmap() const noexcept
+    {
+        return p_bitmap;
+    }
+
+    /**
+     * Returns the index of the first adapted bit in the bitmap.
+     */
+    template <class T>
+    inline auto xbitmap_adaptor<T>::offset() const noexcept -> size_type
+    {
+        return m_offset;
+    }
+
+    template <class T>
+    inline auto xbitmap_adaptor<T>::owner() const noexcept -> const owner_type&
+    {
+        return m_owner;
+    }
+
+    /**
+     * Returns the number of set bits, counted a byte at a time.
+     */
+    template <class T>
+    inline auto xbitmap_adaptor<T>::count() const noexcept -> size_type
+    {
+        size_type res = 0;
+        size_type first = m_offset;
+        const size_type last = m_offset + m_size;
+        for (; first < last && first % 8 != 0; ++first)
+        {
+            res += (p_bitmap[first / 8] >> (first % 8)) & 1u;
+        }
+        for (; first + 8 <= last; first += 8)
+        {
+            res += detail::popcount(p_bitmap[first / 8]);
+        }
+        for (; first < last; ++first)
+        {
+            res += (p_bitmap[first / 8] >> (first % 8)) & 1u;
+        }
+        return res;
+    }
+
+    template <class T>
+    inline void xbitmap_adaptor<T>::swap(xbitmap_adaptor& rhs) noexcept
+    {
+        using std::swap;
+        swap(p_bitmap, rhs.p_bitmap);
+        swap(m_offset, rhs.m_offset);
+        swap(m_size, rhs.m_size);
+        swap(m_owner, rhs.m_owner);
+    }
+
+    template <class T>
+    inline void swap(xbitmap_adaptor<T>& lhs, xbitmap_adaptor<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
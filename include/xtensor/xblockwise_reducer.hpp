@@ -4,6 +4,8 @@
 #include "xtl/xclosure.hpp"
 #include "xtl/xsequence.hpp"
 
+#include <vector>
+
 #include "xshape.hpp"
 #include "xblockwise_reducer_functors.hpp"
 #include "xmultiindex_iterator.hpp"
@@ -46,6 +48,9 @@ public:
     template<class R>
     void assign_to(R & result) const;
 
+    template<class R, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    void assign_to(R & result, const P & policy) const;
+
 private:
     using mapping_type = filter_fixed_shape_t<shape_type>;
     using input_chunked_view_type = xchunked_view<const std::decay_t<CT> &>;
@@ -55,6 +60,11 @@ private:
     template<class CI>
     void assign_to_chunk(CI & result_chunk_iter) const;
 
+    template<class CI, class P>
+    void assign_to_chunk(CI & result_chunk_iter, const P & policy) const;
+
+    std::size_t input_chunks_per_result_chunk() const;
+
     template<class CI>
     input_chunk_range_type compute_input_chunk_range(CI & result_chunk_iter) const;
 
@@ -138,6 +148,60 @@ inline void xblockwise_reducer<CT, F, X, O>::assign_to(R & result) const
     }
 }
 
+/**
+ * Assigns the reduction to \c result, computing the blocks according to
+ * \c policy. When the result has at least as many chunks as there are input
+ * blocks reduced into each of them, the result chunks are computed
+ * concurrently; otherwise the blocks reduced into a result chunk are computed
+ * concurrently and their partial results are merged in order. In both cases
+ * the partial results are merged in the same order as by the sequential
+ * assignment. The reduced expression must support concurrent reads.
+ * @param result the container to assign to, with the shape of the reducer.
+ * @param policy the execution policy, e.g. the result of \c exec::par.
+ */
+template<class CT, class F, class X, class O>
+template<class R, class P, class>
+inline void xblockwise_reducer<CT, F, X, O>::assign_to(R & result, const P & policy) const
+{
+    auto result_chunked_view = as_chunked(result, m_result_chunk_shape);
+    using result_chunk_iterator = decltype(result_chunked_view.chunk_begin());
+    std::vector<result_chunk_iterator> result_chunks;
+    for(auto chunk_iter = result_chunked_view.chunk_begin(); chunk_iter != result_chunked_view.chunk_end(); ++chunk_iter)
+    {
+        result_chunks.push_back(chunk_iter);
+    }
+
+    if(result_chunks.size() >= input_chunks_per_result_chunk())
+    {
+        policy.for_range(std::size_t(0), result_chunks.size(), std::size_t(1), [&](std::size_t begin, std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                auto chunk_iter = result_chunks[i];
+                assign_to_chunk(chunk_iter);
+            }
+        });
+    }
+    else
+    {
+        for(auto & chunk_iter : result_chunks)
+        {
+            assign_to_chunk(chunk_iter, policy);
+        }
+    }
+}
+
+template<class CT, class F, class X, class O>
+inline std::size_t xblockwise_reducer<CT, F, X, O>::input_chunks_per_result_chunk() const
+{
+    std::size_t n = 1;
+    for(auto a : m_axes)
+    {
+        n *= m_e_chunked_view.grid_shape()[a];
+    }
+    return n;
+}
+
 template<class CT, class F, class X, class O>
 auto xblockwise_reducer<CT, F, X, O>::get_input_chunk_iter(input_chunk_index_type  input_chunk_index) const ->input_const_chunked_iterator_type
 {
@@ -183,6 +247,47 @@ void xblockwise_reducer<CT, F, X, O>::assign_to_chunk(CI & result_chunk_iter) co
     m_functor.finalize(reduction_variable, result_chunk_view, *this);
 }
 
+template<class CT, class F, class X, class O>
+template<class CI, class P>
+void xblockwise_reducer<CT, F, X, O>::assign_to_chunk(CI & result_chunk_iter, const P & policy) const
+{
+    auto result_chunk_view = *result_chunk_iter;
+    auto reduction_variable = m_functor.reduction_variable(result_chunk_view);
+
+    auto range = compute_input_chunk_range(result_chunk_iter);
+    std::vector<input_chunk_index_type> input_chunk_indices;
+    for(auto iter = std::get<0>(range); iter != std::get<1>(range); ++iter)
+    {
+        input_chunk_indices.push_back(*iter);
+    }
+
+    // the blocks are evaluated concurrently, then merged in order
+    auto compute_block = [this](const input_chunk_index_type & input_chunk_index)
+    {
+        auto chunked_input_iter = this->get_input_chunk_iter(input_chunk_index);
+        auto input_chunk_view = *chunked_input_iter;
+        return detail::blockwise::evaluate_block_result(m_functor.compute(input_chunk_view, m_axes, m_options));
+    };
+    using block_result_type = decltype(compute_block(std::declval<const input_chunk_index_type &>()));
+    std::vector<block_result_type> block_results(input_chunk_indices.size());
+    policy.for_range(std::size_t(0), input_chunk_indices.size(), std::size_t(1), [&](std::size_t begin, std::size_t end)
+    {
+        for(std::size_t i = begin; i < end; ++i)
+        {
+            block_results[i] = compute_block(input_chunk_indices[i]);
+        }
+    });
+
+    auto first = true;
+    for(const auto & block_res : block_results)
+    {
+        m_functor.merge(block_res, first, result_chunk_view, reduction_variable);
+        first = false;
+    }
+
+    m_functor.finalize(reduction_variable, result_chunk_view, *this);
+}
+
 template<class CT, class F, class X, class O>
 template<class CI>
 auto xblockwise_reducer<CT, F, X, O>::compute_input_chunk_range(CI & result_chunk_iter) const -> input_chunk_range_type
@@ -34,6 +34,26 @@ namespace blockwise
     {
     };
 
+    // Block results are evaluated before being stored, so that they do
+    // not refer to the input block once it has been computed.
+    template<class T>
+    auto evaluate_block_result(T && block_result, std::true_type)
+    {
+        return std::decay_t<decltype(xt::eval(std::forward<T>(block_result)))>(xt::eval(std::forward<T>(block_result)));
+    }
+
+    template<class T>
+    auto evaluate_block_result(T && block_result, std::false_type)
+    {
+        return std::decay_t<T>(std::forward<T>(block_result));
+    }
+
+    template<class T>
+    auto evaluate_block_result(T && block_result)
+    {
+        return evaluate_block_result(std::forward<T>(block_result), is_xexpression<std::decay_t<T>>());
+    }
+
 
     struct simple_functor_base
     {
@@ -247,9 +267,17 @@ namespace blockwise
             }
 
 
+            // single pass over the block
+            auto block_moments = xt::eval(xt::moments<value_type>(input, axes, options));
+            using moments_type = xmoments<value_type>;
+            xarray<value_type> block_variance = xt::make_lambda_xfunction(
+                [](const moments_type & m) { return m.variance(); }, block_moments);
+            xarray<value_type> block_mean = xt::make_lambda_xfunction(
+                [](const moments_type & m) { return m.mean; }, block_moments);
+
             return std::make_tuple(
-                xt::variance<value_type>(input, axes, options),
-                xt::mean<value_type>(input, axes, options),
+                std::move(block_variance),
+                std::move(block_mean),
                 weight
             );
         }
@@ -21,11 +21,13 @@
 #include <xtl/xsequence.hpp>
 
 #include "xaccessible.hpp"
+#include "xeval.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
 #include "xscalar.hpp"
 #include "xstrides.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -73,6 +75,11 @@ namespace xt
     template <class CT, class X>
     class xbroadcast;
 
+    template <class CT, class X>
+    struct expression_cost<xbroadcast<CT, X>> : expression_cost<std::decay_t<CT>>
+    {
+    };
+
     template <class CT, class X>
     struct xiterable_inner_types<xbroadcast<CT, X>>
     {
@@ -190,6 +197,14 @@ namespace xt
 
         const xexpression_type& expression() const noexcept;
 
+        template <class E = xexpression_type>
+        auto data_element(size_type i) const -> decltype(std::declval<const E&>().data_element(i));
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xt_simd::simd_traits<requested_type>::size, class E = xexpression_type>
+        auto load_simd(size_type i) const
+            -> decltype(std::declval<const E&>().template load_simd<align, requested_type, N>(i));
+
         template <class S>
         bool broadcast_shape(S& shape, bool reuse_cache = false) const;
 
@@ -313,10 +328,16 @@ namespace xt
         return m_e.layout();
     }
 
+    /**
+     * Checks whether the expression is contiguous, i.e. whether the
+     * broadcast is trivial and the broadcast expression is contiguous.
+     */
     template <class CT, class X>
     inline bool xbroadcast<CT, X>::is_contiguous() const noexcept
     {
-        return false;
+        return this->dimension() == m_e.dimension() &&
+            std::equal(m_shape.cbegin(), m_shape.cend(), m_e.shape().cbegin()) &&
+            m_e.is_contiguous();
     }
 
     //@}
@@ -386,6 +407,35 @@ namespace xt
     {
         return m_e;
     }
+
+    /**
+     * Returns the element of the broadcast expression at the specified
+     * flat index. Only meaningful when the expression can be linearly
+     * assigned, i.e. when the broadcast is trivial.
+     * @param i the flat index of the element
+     */
+    template <class CT, class X>
+    template <class E>
+    inline auto xbroadcast<CT, X>::data_element(size_type i) const
+        -> decltype(std::declval<const E&>().data_element(i))
+    {
+        return m_e.data_element(i);
+    }
+
+    /**
+     * Returns the batch of elements of the broadcast expression starting
+     * at the specified flat index. A broadcast scalar returns the same
+     * batch whatever the index, so that expressions built on \c ones or
+     * \c zeros keep the vectorized assignment loops.
+     * @param i the flat index of the first element
+     */
+    template <class CT, class X>
+    template <class align, class requested_type, std::size_t N, class E>
+    inline auto xbroadcast<CT, X>::load_simd(size_type i) const
+        -> decltype(std::declval<const E&>().template load_simd<align, requested_type, N>(i))
+    {
+        return m_e.template load_simd<align, requested_type, N>(i);
+    }
     //@}
 
     /**
@@ -11,7 +11,9 @@
 #define XTENSOR_BUFFER_ADAPTOR_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <memory>
 #include <stdexcept>
@@ -409,6 +411,119 @@ namespace xt
     void swap(xbuffer_adaptor<CP, O, A>& lhs,
               xbuffer_adaptor<CP, O, A>& rhs) noexcept;
 
+    /******************
+     * xshared_buffer *
+     ******************/
+
+    template <class T, class A = std::allocator<T>>
+    class xshared_buffer;
+
+    template <class T, class A>
+    struct buffer_inner_types<xshared_buffer<T, A>>
+    {
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = typename std::allocator_traits<A>::size_type;
+        using difference_type = typename std::allocator_traits<A>::difference_type;
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using index_type = size_type;
+    };
+
+    /**
+     * @class xshared_buffer
+     * @brief Reference-counted buffer with copy-on-write semantics.
+     *
+     * Copying an xshared_buffer shares its elements instead of copying them;
+     * the buffer is copied the first time one of the owners accesses it
+     * through a non-const method, data(), begin() or operator[], so that
+     * the others keep seeing the original values. The reference count is
+     * atomic, so that the copies can be handed to other threads; the same
+     * object must not be used concurrently though. As with any copy-on-write
+     * container, pointers and iterators obtained from a non-const access are
+     * invalidated when the buffer is copied afterwards.
+     *
+     * Used as the storage of an xarray_container, see xshared_array, it
+     * makes copies of arrays cheap until they are modified.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam A The allocator of the buffer.
+     */
+    template <class T, class A>
+    class xshared_buffer : public xbuffer_adaptor_base<xshared_buffer<T, A>>
+    {
+    public:
+
+        using self_type = xshared_buffer<T, A>;
+        using buffer_base_type = xbuffer_adaptor_base<self_type>;
+        using allocator_type = A;
+        using value_type = typename buffer_base_type::value_type;
+        using reference = typename buffer_base_type::reference;
+        using const_reference = typename buffer_base_type::const_reference;
+        using pointer = typename buffer_base_type::pointer;
+        using const_pointer = typename buffer_base_type::const_pointer;
+        using size_type = typename buffer_base_type::size_type;
+        using difference_type = typename buffer_base_type::difference_type;
+        using iterator = typename buffer_base_type::iterator;
+        using const_iterator = typename buffer_base_type::const_iterator;
+        using reverse_iterator = typename buffer_base_type::reverse_iterator;
+        using const_reverse_iterator = typename buffer_base_type::const_reverse_iterator;
+        using container_type = uvector<T, A>;
+
+        xshared_buffer() noexcept;
+        explicit xshared_buffer(size_type count, const allocator_type& alloc = allocator_type());
+        xshared_buffer(size_type count, const_reference value, const allocator_type& alloc = allocator_type());
+
+        template <class InputIt, class = detail::require_input_iter<InputIt>>
+        xshared_buffer(InputIt first, InputIt last, const allocator_type& alloc = allocator_type());
+
+        xshared_buffer(std::initializer_list<T> init, const allocator_type& alloc = allocator_type());
+        explicit xshared_buffer(container_type&& data);
+
+        ~xshared_buffer();
+
+        xshared_buffer(const self_type& rhs) noexcept;
+        self_type& operator=(const self_type& rhs) noexcept;
+
+        xshared_buffer(self_type&& rhs) noexcept;
+        self_type& operator=(self_type&& rhs) noexcept;
+
+        size_type size() const noexcept;
+        void resize(size_type size);
+
+        pointer data();
+        const_pointer data() const noexcept;
+
+        size_type use_count() const noexcept;
+        bool unique() const noexcept;
+        void detach();
+
+        allocator_type get_allocator() const noexcept;
+        void swap(self_type& rhs) noexcept;
+
+    private:
+
+        struct block
+        {
+            explicit block(container_type&& d);
+
+            std::atomic<size_type> m_count;
+            container_type m_data;
+        };
+
+        void release() noexcept;
+
+        block* p_block;
+    };
+
+    template <class T, class A>
+    void swap(xshared_buffer<T, A>& lhs, xshared_buffer<T, A>& rhs) noexcept;
+
     /*********************
      * xiterator_adaptor *
      *********************/
@@ -1052,6 +1167,204 @@ namespace xt
         lhs.swap(rhs);
     }
 
+    /*********************************
+     * xshared_buffer implementation *
+     *********************************/
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::block::block(container_type&& d)
+        : m_count(1), m_data(std::move(d))
+    {
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer() noexcept
+        : p_block(nullptr)
+    {
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer(size_type count, const allocator_type& alloc)
+        : xshared_buffer(container_type(count, alloc))
+    {
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer(size_type count, const_reference value, const allocator_type& alloc)
+        : xshared_buffer(container_type(count, value, alloc))
+    {
+    }
+
+    template <class T, class A>
+    template <class InputIt, class>
+    inline xshared_buffer<T, A>::xshared_buffer(InputIt first, InputIt last, const allocator_type& alloc)
+        : xshared_buffer(container_type(first, last, alloc))
+    {
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer(std::initializer_list<T> init, const allocator_type& alloc)
+        : xshared_buffer(container_type(init, alloc))
+    {
+    }
+
+    /**
+     * Builds a buffer owning the elements of \c data, without copying them.
+     */
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer(container_type&& data)
+        : p_block(new block(std::move(data)))
+    {
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::~xshared_buffer()
+    {
+        release();
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer(const self_type& rhs) noexcept
+        : p_block(rhs.p_block)
+    {
+        if (p_block != nullptr)
+        {
+            p_block->m_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::operator=(const self_type& rhs) noexcept -> self_type&
+    {
+        self_type tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template <class T, class A>
+    inline xshared_buffer<T, A>::xshared_buffer(self_type&& rhs) noexcept
+        : p_block(rhs.p_block)
+    {
+        rhs.p_block = nullptr;
+    }
+
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::operator=(self_type&& rhs) noexcept -> self_type&
+    {
+        self_type tmp(std::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::size() const noexcept -> size_type
+    {
+        return p_block != nullptr ? p_block->m_data.size() : size_type(0);
+    }
+
+    /**
+     * Resizes the buffer, keeping the first elements. A shared buffer is
+     * copied beforehand, only up to the new size.
+     */
+    template <class T, class A>
+    inline void xshared_buffer<T, A>::resize(size_type size)
+    {
+        if (size == this->size())
+        {
+            return;
+        }
+        if (p_block == nullptr || unique())
+        {
+            if (p_block == nullptr)
+            {
+                p_block = new block(container_type(size));
+            }
+            else
+            {
+                p_block->m_data.resize(size);
+            }
+        }
+        else
+        {
+            container_type tmp(size, p_block->m_data.get_allocator());
+            size_type n = (std::min)(size, this->size());
+            std::copy(p_block->m_data.cbegin(), p_block->m_data.cbegin() + static_cast<difference_type>(n), tmp.begin());
+            self_type(std::move(tmp)).swap(*this);
+        }
+    }
+
+    /**
+     * Returns a pointer to the elements, copying them first if the buffer
+     * is shared.
+     */
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::data() -> pointer
+    {
+        detach();
+        return p_block != nullptr ? p_block->m_data.data() : nullptr;
+    }
+
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::data() const noexcept -> const_pointer
+    {
+        return p_block != nullptr ? p_block->m_data.data() : nullptr;
+    }
+
+    /**
+     * Returns the number of buffers sharing the elements.
+     */
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::use_count() const noexcept -> size_type
+    {
+        return p_block != nullptr ? p_block->m_count.load(std::memory_order_acquire) : size_type(0);
+    }
+
+    template <class T, class A>
+    inline bool xshared_buffer<T, A>::unique() const noexcept
+    {
+        return use_count() == size_type(1);
+    }
+
+    /**
+     * Copies the elements if they are shared with other buffers.
+     */
+    template <class T, class A>
+    inline void xshared_buffer<T, A>::detach()
+    {
+        if (p_block != nullptr && !unique())
+        {
+            self_type(container_type(p_block->m_data)).swap(*this);
+        }
+    }
+
+    template <class T, class A>
+    inline auto xshared_buffer<T, A>::get_allocator() const noexcept -> allocator_type
+    {
+        return p_block != nullptr ? p_block->m_data.get_allocator() : allocator_type();
+    }
+
+    template <class T, class A>
+    inline void xshared_buffer<T, A>::swap(self_type& rhs) noexcept
+    {
+        std::swap(p_block, rhs.p_block);
+    }
+
+    template <class T, class A>
+    inline void xshared_buffer<T, A>::release() noexcept
+    {
+        if (p_block != nullptr && p_block->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete p_block;
+        }
+        p_block = nullptr;
+    }
+
+    template <class T, class A>
+    inline void swap(xshared_buffer<T, A>& lhs, xshared_buffer<T, A>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
     /************************************
      * xiterator_adaptor implementation *
      ************************************/
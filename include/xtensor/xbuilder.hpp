@@ -14,11 +14,14 @@
 #ifndef XTENSOR_BUILDER_HPP
 #define XTENSOR_BUILDER_HPP
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <limits>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -29,7 +32,9 @@
 #include "xbroadcast.hpp"
 #include "xfunction.hpp"
 #include "xgenerator.hpp"
+#include "xnoalias.hpp"
 #include "xoperation.hpp"
+#include "xstrided_view.hpp"
 
 namespace xt
 {
@@ -74,6 +79,32 @@ namespace xt
         return broadcast(T(0), shape);
     }
 
+    namespace detail
+    {
+        template <class C, class S, class = void>
+        struct has_uninitialized_from_shape : std::false_type
+        {
+        };
+
+        template <class C, class S>
+        struct has_uninitialized_from_shape<C, S, void_t<decltype(C::from_shape(std::declval<const S&>(), uninitialized))>>
+            : std::true_type
+        {
+        };
+
+        template <class C, class S>
+        inline C uninitialized_from_shape(const S& shape, std::true_type)
+        {
+            return C::from_shape(shape, uninitialized);
+        }
+
+        template <class C, class S>
+        inline C uninitialized_from_shape(const S& shape, std::false_type)
+        {
+            return C::from_shape(shape);
+        }
+    }
+
     /**
      * Create a xcontainer (xarray, xtensor or xtensor_fixed) with uninitialized values of
      * with value_type T and shape. Selects the best container match automatically
@@ -83,26 +114,30 @@ namespace xt
      * - ``std::array`` or ``initializer_list`` → ``xtensor<T, N>``
      * - ``xshape<N...>`` → ``xtensor_fixed<T, xshape<N...>>``
      *
+     * The elements are default-initialized: with the default storage, the buffer
+     * is not written if T is trivially default constructible, so that only the
+     * page mapping is paid for.
+     *
      * @param shape shape of the new xcontainer
      */
     template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
     inline xarray<T, L> empty(const S& shape)
     {
-        return xarray<T, L>::from_shape(shape);
+        return xarray<T, L>::from_shape(shape, uninitialized);
     }
 
     template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class ST, std::size_t N>
     inline xtensor<T, N, L> empty(const std::array<ST, N>& shape)
     {
         using shape_type = typename xtensor<T, N>::shape_type;
-        return xtensor<T, N, L>(xtl::forward_sequence<shape_type, decltype(shape)>(shape));
+        return xtensor<T, N, L>(xtl::forward_sequence<shape_type, decltype(shape)>(shape), uninitialized);
     }
 
     template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I, std::size_t N>
     inline xtensor<T, N, L> empty(const I(&shape)[N])
     {
         using shape_type = typename xtensor<T, N>::shape_type;
-        return xtensor<T, N, L>(xtl::forward_sequence<shape_type, decltype(shape)>(shape));
+        return xtensor<T, N, L>(xtl::forward_sequence<shape_type, decltype(shape)>(shape), uninitialized);
     }
 
     template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, std::size_t... N>
@@ -114,6 +149,7 @@ namespace xt
     /**
      * Create a xcontainer (xarray, xtensor or xtensor_fixed) with uninitialized values of
      * the same shape, value type and layout as the input xexpression *e*.
+     * As for empty, the elements are default-initialized.
      *
      * @param e the xexpression from which to extract shape, value type and layout.
      */
@@ -121,7 +157,9 @@ namespace xt
     inline auto empty_like(const xexpression<E>& e)
     {
         using xtype = temporary_type_t<E>;
-        auto res = xtype::from_shape(e.derived_cast().shape());
+        using shape_type = std::decay_t<decltype(e.derived_cast().shape())>;
+        auto res = detail::uninitialized_from_shape<xtype>(e.derived_cast().shape(),
+                                                          detail::has_uninitialized_from_shape<xtype, shape_type>());
         return res;
     }
 
@@ -251,6 +289,25 @@ namespace xt
                 arange_assign_to<R>(e, m_start, m_stop, m_step, m_endpoint);
             }
 
+            inline R data_element(size_t i) const
+            {
+                return access_impl(i);
+            }
+
+            // The batch is filled from scalar values rather than computed
+            // from an iota batch, so that the elements keep the rounding of
+            // access_impl, which computes them in T, and the endpoint.
+            template <class align, class requested_type, std::size_t N>
+            inline xt_simd::simd_return_type<R, requested_type> load_simd(size_t i) const
+            {
+                std::array<requested_type, N> values;
+                for (std::size_t j = 0; j < N; ++j)
+                {
+                    values[j] = static_cast<requested_type>(access_impl(i + j));
+                }
+                return xt_simd::load_as<requested_type>(values.data(), xt_simd::unaligned_mode());
+            }
+
         private:
 
             T m_start;
@@ -477,6 +534,90 @@ namespace xt
 
     namespace detail
     {
+        // Copies e to the positions [offset, offset + extent) of res along
+        // axis when both are contiguous in the same layout: the block is then
+        // made of one contiguous chunk per position in the dimensions of res
+        // that vary slower than axis.
+        template <class R, class E>
+        inline bool copy_contiguous_block(R& res, const E& e, std::size_t axis, std::size_t offset, std::size_t extent, std::true_type)
+        {
+            layout_type l = res.layout();
+            if ((l != layout_type::row_major && l != layout_type::column_major) || e.layout() != l || !e.is_contiguous())
+            {
+                return false;
+            }
+
+            const auto& shape = res.shape();
+            std::size_t first_dim = l == layout_type::row_major ? axis + 1 : 0;
+            std::size_t last_dim = l == layout_type::row_major ? shape.size() : axis;
+            std::size_t step = 1;
+            for (std::size_t d = first_dim; d < last_dim; ++d)
+            {
+                step *= static_cast<std::size_t>(shape[d]);
+            }
+            std::size_t chunk = extent * step;
+            std::size_t row = static_cast<std::size_t>(shape[axis]) * step;
+
+            auto src = e.data() + static_cast<std::ptrdiff_t>(e.data_offset());
+            auto dst = res.data() + static_cast<std::ptrdiff_t>(offset * step);
+            exec::default_policy().for_range(0, e.size(), chunk, [&](std::size_t first, std::size_t last)
+            {
+                auto out = dst + static_cast<std::ptrdiff_t>((first / chunk) * row);
+                if (chunk == 1)
+                {
+                    for (std::size_t i = first; i < last; ++i, out += static_cast<std::ptrdiff_t>(row))
+                    {
+                        *out = src[static_cast<std::ptrdiff_t>(i)];
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = first; i < last; i += chunk, out += static_cast<std::ptrdiff_t>(row))
+                    {
+                        std::copy(src + static_cast<std::ptrdiff_t>(i), src + static_cast<std::ptrdiff_t>(i + chunk), out);
+                    }
+                }
+            });
+            return true;
+        }
+
+        template <class R, class E>
+        inline bool copy_contiguous_block(R&, const E&, std::size_t, std::size_t, std::size_t, std::false_type)
+        {
+            return false;
+        }
+
+        template <class R, class E>
+        inline bool copy_contiguous_block(R& res, const E& e, std::size_t axis, std::size_t offset, std::size_t extent)
+        {
+            using has_data = xtl::conjunction<has_data_interface<R>, has_data_interface<E>>;
+            return copy_contiguous_block(res, e, axis, offset, extent, has_data());
+        }
+
+        // Assigns e to the positions [offset, offset + extent) of res along axis.
+        template <class R, class E>
+        inline void assign_concatenate_block(R& res, const E& e, std::size_t axis, std::size_t offset, std::size_t extent)
+        {
+            if (!copy_contiguous_block(res, e, axis, offset, extent))
+            {
+                xstrided_slice_vector sv(axis + 1, xall_tag());
+                sv[axis] = range(static_cast<std::ptrdiff_t>(offset), static_cast<std::ptrdiff_t>(offset + extent));
+                noalias(strided_view(res, sv)) = e;
+            }
+        }
+
+        // Assigns e to the slice of res at index along axis.
+        template <class R, class E>
+        inline void assign_stack_slice(R& res, const E& e, std::size_t axis, std::size_t index)
+        {
+            if (!copy_contiguous_block(res, e, axis, index, std::size_t(1)))
+            {
+                xstrided_slice_vector sv(axis + 1, xall_tag());
+                sv[axis] = static_cast<std::ptrdiff_t>(index);
+                noalias(strided_view(res, sv)) = e;
+            }
+        }
+
         template <class... CT>
         class concatenate_access
         {
@@ -514,6 +655,20 @@ namespace xt
                 }
                 return apply<value_type>(i, get, t);
             }
+
+            // Each expression is assigned to the block of e it covers.
+            template <class E>
+            inline void assign_blocks(const tuple_type& t, size_type axis, E& e) const
+            {
+                size_type offset = 0;
+                auto assign_block = [&offset, axis, &e](auto& arr)
+                {
+                    size_type size = static_cast<size_type>(arr.shape()[axis]);
+                    assign_concatenate_block(e, arr, axis, offset, size);
+                    offset += size;
+                };
+                for_each(assign_block, t);
+            }
         };
 
         template <class... CT>
@@ -536,6 +691,19 @@ namespace xt
                 index.erase(index.begin() + std::ptrdiff_t(axis));
                 return apply<value_type>(i, get_item, t);
             }
+
+            // Each expression is assigned to the slice of e at its index
+            // along the stacking axis.
+            template <class E>
+            inline void assign_blocks(const tuple_type& t, size_type axis, E& e) const
+            {
+                size_type index = 0;
+                auto assign_slice = [&index, axis, &e](auto& arr)
+                {
+                    assign_stack_slice(e, arr, axis, index++);
+                };
+                for_each(assign_slice, t);
+            }
         };
 
         template <class... CT>
@@ -563,6 +731,19 @@ namespace xt
                     return concatenate_base::access(t, axis, index);
                 }
             }
+
+            template <class E>
+            inline void assign_blocks(const tuple_type& t, size_type axis, E& e) const
+            {
+                if (std::get<0>(t).dimension() == 1)
+                {
+                    stack_base::assign_blocks(t, axis, e);
+                }
+                else
+                {
+                    concatenate_base::assign_blocks(t, axis, e);
+                }
+            }
         };
 
         template <template <class...> class F, class... CT>
@@ -593,6 +774,12 @@ namespace xt
                 return this->access(m_t, m_axis, xindex(first, last));
             }
 
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const
+            {
+                this->assign_blocks(m_t, m_axis, e.derived_cast());
+            }
+
         private:
 
             tuple_type m_t;
@@ -750,6 +937,10 @@ namespace xt
     /**
      * @brief Concatenates xexpressions along \em axis.
      *
+     * When the result is assigned to a container, each xexpression is
+     * assigned to the block it covers; the xexpressions that are stored
+     * contiguously in the layout of the container are copied chunk by chunk.
+     *
      * @param t \ref xtuple of xexpressions to concatenate
      * @param axis axis along which elements are concatenated
      * @returns xgenerator evaluating to concatenated elements
@@ -877,6 +1068,232 @@ namespace xt
         return detail::make_xgenerator(detail::vstack_impl<CT...>(std::move(t), size_t(0)), new_shape);
     }
 
+    namespace detail
+    {
+        template <class CT>
+        class concatenate_vector_impl
+        {
+        public:
+
+            using vector_type = std::decay_t<CT>;
+            using size_type = std::size_t;
+            using value_type = typename vector_type::value_type::value_type;
+
+            template <class V>
+            inline concatenate_vector_impl(V&& v, size_type axis)
+                : m_v(std::forward<V>(v)), m_axis(axis), m_offsets(m_v.size() + 1, size_type(0))
+            {
+                for (size_type i = 0; i < m_v.size(); ++i)
+                {
+                    m_offsets[i + 1] = m_offsets[i] + static_cast<size_type>(m_v[i].shape()[axis]);
+                }
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                return access(xindex({static_cast<size_type>(args)...}));
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                return access(xindex(first, last));
+            }
+
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const
+            {
+                auto& de = e.derived_cast();
+                for (size_type i = 0; i < m_v.size(); ++i)
+                {
+                    assign_concatenate_block(de, m_v[i], m_axis, m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+                }
+            }
+
+        private:
+
+            inline value_type access(xindex index) const
+            {
+                // The last block starting at or before the index, which skips
+                // the expressions that are empty along the axis
+                auto it = std::upper_bound(m_offsets.cbegin() + 1, m_offsets.cend() - 1, index[m_axis]);
+                size_type i = static_cast<size_type>(it - m_offsets.cbegin()) - 1;
+                index[m_axis] -= m_offsets[i];
+                return m_v[i][index];
+            }
+
+            CT m_v;
+            size_type m_axis;
+            std::vector<size_type> m_offsets;
+        };
+
+        template <class CT>
+        class stack_vector_impl
+        {
+        public:
+
+            using vector_type = std::decay_t<CT>;
+            using size_type = std::size_t;
+            using value_type = typename vector_type::value_type::value_type;
+
+            template <class V>
+            inline stack_vector_impl(V&& v, size_type axis)
+                : m_v(std::forward<V>(v)), m_axis(axis)
+            {
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                return access(xindex({static_cast<size_type>(args)...}));
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                return access(xindex(first, last));
+            }
+
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const
+            {
+                auto& de = e.derived_cast();
+                for (size_type i = 0; i < m_v.size(); ++i)
+                {
+                    assign_stack_slice(de, m_v[i], m_axis, i);
+                }
+            }
+
+        private:
+
+            inline value_type access(xindex index) const
+            {
+                size_type i = index[m_axis];
+                index.erase(index.begin() + std::ptrdiff_t(m_axis));
+                return m_v[i][index];
+            }
+
+            CT m_v;
+            size_type m_axis;
+        };
+
+        // Checks that the expressions held by v have the same shape, except
+        // along skipped_axis if it is specified.
+        template <class V>
+        inline void check_vector_shapes(const V& v, std::size_t skipped_axis = (std::numeric_limits<std::size_t>::max)())
+        {
+            if (v.empty())
+            {
+                XTENSOR_THROW(std::runtime_error, "Cannot concatenate or stack an empty vector of expressions");
+            }
+            const auto& shape = v.front().shape();
+            std::size_t dim = shape.size();
+            for (const auto& arr : v)
+            {
+                bool res = dim == arr.dimension();
+                for (std::size_t i = 0; i < dim && res; ++i)
+                {
+                    res = i == skipped_axis || shape[i] == arr.shape()[i];
+                }
+                if (!res)
+                {
+                    throw_concatenate_error(shape, arr.shape());
+                }
+            }
+        }
+
+        template <class V>
+        inline auto concatenate_vector(V&& v, std::size_t axis)
+        {
+            using expression_type = typename std::decay_t<V>::value_type;
+            using shape_type = typename concat_shape_builder_t::concat_shape<typename expression_type::shape_type>::type;
+            check_vector_shapes(v, axis);
+            if (axis >= v.front().dimension())
+            {
+                XTENSOR_THROW(std::runtime_error, "Axis argument to concatenate is out of bounds");
+            }
+
+            const auto& source_shape = v.front().shape();
+            shape_type new_shape = xtl::forward_sequence<shape_type, decltype(source_shape)>(source_shape);
+            new_shape[axis] = 0;
+            for (const auto& arr : v)
+            {
+                new_shape[axis] += arr.shape()[axis];
+            }
+            return make_xgenerator(concatenate_vector_impl<xtl::closure_type_t<V>>(std::forward<V>(v), axis), std::move(new_shape));
+        }
+
+        template <class V>
+        inline auto stack_vector(V&& v, std::size_t axis)
+        {
+            using expression_type = typename std::decay_t<V>::value_type;
+            using shape_type = typename concat_shape_builder_t::concat_shape<typename expression_type::shape_type>::type;
+            check_vector_shapes(v);
+            if (axis > v.front().dimension())
+            {
+                XTENSOR_THROW(std::runtime_error, "Axis argument to stack is out of bounds");
+            }
+
+            const auto& source_shape = v.front().shape();
+            auto new_shape = add_axis(xtl::forward_sequence<shape_type, decltype(source_shape)>(source_shape), axis, v.size());
+            return make_xgenerator(stack_vector_impl<xtl::closure_type_t<V>>(std::forward<V>(v), axis), std::move(new_shape));
+        }
+    }
+
+    /**
+     * @brief Concatenates the xexpressions held by a vector along \em axis.
+     *
+     * The expressions must have the same shape, except along \em axis.
+     * When the result is assigned to a container, each expression is
+     * assigned to the block it covers, as for the concatenation of an
+     * \ref xtuple.
+     *
+     * @param v vector of xexpressions to concatenate, held by reference
+     * @param axis axis along which elements are concatenated
+     * @returns xgenerator evaluating to concatenated elements
+     *
+     * \code{.cpp}
+     * std::vector<xt::xarray<double>> v = {{{1, 2, 3}}, {{2, 3, 4}}, {{3, 4, 5}}};
+     * xt::xarray<double> c = xt::concatenate(v); // => {{1, 2, 3},
+     *                                            //     {2, 3, 4},
+     *                                            //     {3, 4, 5}}
+     * \endcode
+     */
+    template <class E, class A>
+    inline auto concatenate(const std::vector<E, A>& v, std::size_t axis = 0)
+    {
+        return detail::concatenate_vector(v, axis);
+    }
+
+    template <class E, class A>
+    inline auto concatenate(std::vector<E, A>&& v, std::size_t axis = 0)
+    {
+        return detail::concatenate_vector(std::move(v), axis);
+    }
+
+    /**
+     * @brief Stacks the xexpressions held by a vector along \em axis.
+     *
+     * The expressions must have the same shape. The result has one more
+     * dimension than the expressions, of size \c v.size().
+     *
+     * @param v vector of xexpressions to stack, held by reference
+     * @param axis axis along which elements are stacked
+     * @returns xgenerator evaluating to stacked elements
+     */
+    template <class E, class A>
+    inline auto stack(const std::vector<E, A>& v, std::size_t axis = 0)
+    {
+        return detail::stack_vector(v, axis);
+    }
+
+    template <class E, class A>
+    inline auto stack(std::vector<E, A>&& v, std::size_t axis = 0)
+    {
+        return detail::stack_vector(std::move(v), axis);
+    }
+
     namespace detail
     {
 
@@ -0,0 +1,1107 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CHUNK_DISTRIBUTED_HPP
+#define XTENSOR_CHUNK_DISTRIBUTED_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(XTENSOR_USE_MPI)
+#include <mpi.h>
+#endif
+
+#include "xarray.hpp"
+#include "xchunk_store.hpp"
+#include "xchunked_array.hpp"
+#include "xchunked_view.hpp"
+#include "xmath.hpp"
+#include "xpad.hpp"
+#include "xstrided_view.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /**
+     * Reduction operations of the collective reductions of the
+     * communicators, see distributed_reduce.
+     */
+    enum class xreduce_op
+    {
+        sum,
+        prod,
+        min,
+        max
+    };
+
+    /**
+     * @class xlocal_communicator
+     * @brief Communicator of a single process.
+     *
+     * The xlocal_communicator class is the default communicator of the
+     * distributed chunk stores, for which all the chunks are local and the
+     * collective operations are no-ops. A communicator provides rank() and
+     * size(), allreduce(data, n, op), reducing in place n elements over all
+     * the processes, and exchange(send, recv), sending send[q] to the process
+     * q and receiving recv[q], whose size is known by the receiver, from it.
+     *
+     * @sa xmpi_communicator
+     */
+    class xlocal_communicator
+    {
+    public:
+
+        std::size_t rank() const noexcept;
+        std::size_t size() const noexcept;
+
+        template <class T>
+        void allreduce(T* data, std::size_t n, xreduce_op op) const noexcept;
+
+        template <class T>
+        void exchange(const std::vector<std::vector<T>>& send, std::vector<std::vector<T>>& recv) const noexcept;
+    };
+
+#if defined(XTENSOR_USE_MPI)
+    /**
+     * @class xmpi_communicator
+     * @brief Communicator of the processes of an MPI communicator.
+     *
+     * The xmpi_communicator class reduces with MPI_Allreduce and exchanges
+     * with non-blocking point-to-point messages. It does not own the MPI
+     * communicator, and MPI must be initialized before it is built.
+     */
+    class xmpi_communicator
+    {
+    public:
+
+        explicit xmpi_communicator(MPI_Comm comm = MPI_COMM_WORLD);
+
+        MPI_Comm comm() const noexcept;
+        std::size_t rank() const noexcept;
+        std::size_t size() const noexcept;
+
+        template <class T>
+        void allreduce(T* data, std::size_t n, xreduce_op op) const;
+
+        template <class T>
+        void exchange(const std::vector<std::vector<T>>& send, std::vector<std::vector<T>>& recv) const;
+
+    private:
+
+        static constexpr int exchange_tag = 0x7874;
+
+        MPI_Comm m_comm;
+        std::size_t m_rank;
+        std::size_t m_size;
+    };
+#endif
+
+    /****************************
+     * xchunk_distributed_store *
+     ****************************/
+
+    /**
+     * @class xchunk_distributed_store
+     * @brief Chunk storage of an xchunked_array distributed over processes.
+     *
+     * The xchunk_distributed_store class splits the chunks of an
+     * xchunked_array, in row-major order of the grid, into contiguous
+     * ranges of about the same number of chunks, one per process of the
+     * communicator, and only allocates the chunks of the calling process.
+     * The assignments of the array follow the owner-computes rule: each
+     * process assigns its own chunks, so that the expressions assigned must
+     * only read chunks of the same process, e.g. element-wise expressions
+     * of arrays with the same shape, chunk shape and communicator.
+     *
+     * Accessing the chunks of other processes throws, except through the
+     * constant accessors after exchange_halos copied the parts of them
+     * needed by the halos of the local chunks. Reductions go through
+     * distributed_reduce.
+     *
+     * @tparam T the value type of the elements
+     * @tparam C the communicator, xlocal_communicator or xmpi_communicator
+     * @sa chunked_distributed_array, exchange_halos, distributed_reduce
+     */
+    template <class T, class C = xlocal_communicator>
+    class xchunk_distributed_store
+    {
+    public:
+
+        using self_type = xchunk_distributed_store<T, C>;
+        using communicator_type = C;
+        using chunk_type = xarray<T>;
+        using value_type = chunk_type;
+        using reference = chunk_type&;
+        using const_reference = const chunk_type&;
+        using shape_type = typename chunk_type::shape_type;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = detail::xchunk_store_iterator<self_type, false>;
+        using const_iterator = detail::xchunk_store_iterator<self_type, true>;
+
+        template <class S>
+        explicit xchunk_distributed_store(const S& chunk_shape, const communicator_type& comm = communicator_type());
+
+        template <class S>
+        void resize(const S& grid_shape);
+
+        size_type size() const noexcept;
+        const shape_type& shape() const noexcept;
+        const shape_type& chunk_shape() const noexcept;
+        const communicator_type& communicator() const noexcept;
+
+        size_type owner(size_type i) const noexcept;
+        bool is_local(size_type i) const noexcept;
+        size_type local_begin() const noexcept;
+        size_type local_end() const noexcept;
+
+        bool has_ghost(size_type i) const noexcept;
+        reference ghost(size_type i);
+        void clear_ghosts() noexcept;
+
+        template <class It>
+        reference element(It first, It last);
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        reference pin(size_type i);
+        const_reference pin(size_type i) const;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+    private:
+
+        template <class It>
+        size_type linear_index(It first, It last) const;
+
+        shape_type m_shape;
+        shape_type m_chunk_shape;
+        communicator_type m_comm;
+        size_type m_size;
+        size_type m_local_begin;
+        size_type m_local_end;
+        std::vector<chunk_type> m_chunks;
+        // Copies of the chunks of other processes, filled by exchange_halos
+        std::map<size_type, chunk_type> m_ghosts;
+    };
+
+    template <class T, class C = xlocal_communicator, class S>
+    xchunked_array<xchunk_distributed_store<T, C>> chunked_distributed_array(S&& shape, S&& chunk_shape, const C& comm = C());
+
+    template <class T, class C = xlocal_communicator, class I>
+    xchunked_array<xchunk_distributed_store<T, C>> chunked_distributed_array(std::initializer_list<I> shape,
+                                                                             std::initializer_list<I> chunk_shape,
+                                                                             const C& comm = C());
+
+    template <class T, class C>
+    void exchange_halos(xchunked_array<xchunk_distributed_store<T, C>>& a, std::size_t halo,
+                        pad_mode mode = pad_mode::constant);
+
+    template <class T, class C, class F>
+    void for_each_local_chunk_with_halo(xchunked_array<xchunk_distributed_store<T, C>>& a, std::size_t halo, F&& f,
+                                        pad_mode mode = pad_mode::constant, T constant_value = 0);
+
+    template <class T, class C, class X>
+    xarray<T> distributed_reduce(const xchunked_array<xchunk_distributed_store<T, C>>& a, const X& axes, xreduce_op op);
+
+    template <class T, class C>
+    T distributed_reduce(const xchunked_array<xchunk_distributed_store<T, C>>& a, xreduce_op op);
+
+    /**************************************
+     * xlocal_communicator implementation *
+     **************************************/
+
+    inline std::size_t xlocal_communicator::rank() const noexcept
+    {
+        return 0;
+    }
+
+    inline std::size_t xlocal_communicator::size() const noexcept
+    {
+        return 1;
+    }
+
+    template <class T>
+    inline void xlocal_communicator::allreduce(T*, std::size_t, xreduce_op) const noexcept
+    {
+    }
+
+    // The chunks of a single process never leave it
+    template <class T>
+    inline void xlocal_communicator::exchange(const std::vector<std::vector<T>>&, std::vector<std::vector<T>>&) const noexcept
+    {
+    }
+
+#if defined(XTENSOR_USE_MPI)
+    /************************************
+     * xmpi_communicator implementation *
+     ************************************/
+
+    namespace detail
+    {
+        template <class T>
+        struct mpi_datatype;
+
+#define XTENSOR_MPI_DATATYPE(TYPE, MPI_TYPE)                  \
+        template <>                                           \
+        struct mpi_datatype<TYPE>                             \
+        {                                                     \
+            static MPI_Datatype get() noexcept                \
+            {                                                 \
+                return MPI_TYPE;                              \
+            }                                                 \
+        };
+
+        XTENSOR_MPI_DATATYPE(char, MPI_CHAR)
+        XTENSOR_MPI_DATATYPE(signed char, MPI_SIGNED_CHAR)
+        XTENSOR_MPI_DATATYPE(unsigned char, MPI_UNSIGNED_CHAR)
+        XTENSOR_MPI_DATATYPE(short, MPI_SHORT)
+        XTENSOR_MPI_DATATYPE(unsigned short, MPI_UNSIGNED_SHORT)
+        XTENSOR_MPI_DATATYPE(int, MPI_INT)
+        XTENSOR_MPI_DATATYPE(unsigned int, MPI_UNSIGNED)
+        XTENSOR_MPI_DATATYPE(long, MPI_LONG)
+        XTENSOR_MPI_DATATYPE(unsigned long, MPI_UNSIGNED_LONG)
+        XTENSOR_MPI_DATATYPE(long long, MPI_LONG_LONG)
+        XTENSOR_MPI_DATATYPE(unsigned long long, MPI_UNSIGNED_LONG_LONG)
+        XTENSOR_MPI_DATATYPE(float, MPI_FLOAT)
+        XTENSOR_MPI_DATATYPE(double, MPI_DOUBLE)
+        XTENSOR_MPI_DATATYPE(long double, MPI_LONG_DOUBLE)
+
+#undef XTENSOR_MPI_DATATYPE
+
+        inline void check_mpi(int code, const char* what)
+        {
+            if (code != MPI_SUCCESS)
+            {
+                XTENSOR_THROW(std::runtime_error, std::string("MPI error in ") + what);
+            }
+        }
+
+        // MPI counts are ints
+        inline int mpi_count(std::size_t n)
+        {
+            if (n > static_cast<std::size_t>((std::numeric_limits<int>::max)()))
+            {
+                XTENSOR_THROW(std::runtime_error, "MPI message too large");
+            }
+            return static_cast<int>(n);
+        }
+
+        inline MPI_Op mpi_op(xreduce_op op) noexcept
+        {
+            switch (op)
+            {
+            case xreduce_op::prod:
+                return MPI_PROD;
+            case xreduce_op::min:
+                return MPI_MIN;
+            case xreduce_op::max:
+                return MPI_MAX;
+            default:
+                return MPI_SUM;
+            }
+        }
+    }
+
+    /**
+     * Builds a communicator of the processes of \c comm.
+     */
+    inline xmpi_communicator::xmpi_communicator(MPI_Comm comm)
+        : m_comm(comm), m_rank(0), m_size(1)
+    {
+        int rank = 0, size = 1;
+        detail::check_mpi(MPI_Comm_rank(m_comm, &rank), "MPI_Comm_rank");
+        detail::check_mpi(MPI_Comm_size(m_comm, &size), "MPI_Comm_size");
+        m_rank = static_cast<std::size_t>(rank);
+        m_size = static_cast<std::size_t>(size);
+    }
+
+    inline MPI_Comm xmpi_communicator::comm() const noexcept
+    {
+        return m_comm;
+    }
+
+    inline std::size_t xmpi_communicator::rank() const noexcept
+    {
+        return m_rank;
+    }
+
+    inline std::size_t xmpi_communicator::size() const noexcept
+    {
+        return m_size;
+    }
+
+    template <class T>
+    inline void xmpi_communicator::allreduce(T* data, std::size_t n, xreduce_op op) const
+    {
+        detail::check_mpi(MPI_Allreduce(MPI_IN_PLACE, data, detail::mpi_count(n), detail::mpi_datatype<T>::get(),
+                                        detail::mpi_op(op), m_comm),
+                          "MPI_Allreduce");
+    }
+
+    template <class T>
+    inline void xmpi_communicator::exchange(const std::vector<std::vector<T>>& send, std::vector<std::vector<T>>& recv) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "xmpi_communicator exchanges trivially copyable elements");
+        std::vector<MPI_Request> requests;
+        requests.reserve(2 * m_size);
+        for (std::size_t q = 0; q < m_size; ++q)
+        {
+            if (!recv[q].empty())
+            {
+                requests.emplace_back();
+                detail::check_mpi(MPI_Irecv(recv[q].data(), detail::mpi_count(recv[q].size() * sizeof(T)), MPI_BYTE,
+                                            static_cast<int>(q), exchange_tag, m_comm, &requests.back()),
+                                  "MPI_Irecv");
+            }
+        }
+        for (std::size_t q = 0; q < m_size; ++q)
+        {
+            if (!send[q].empty())
+            {
+                requests.emplace_back();
+                detail::check_mpi(MPI_Isend(send[q].data(), detail::mpi_count(send[q].size() * sizeof(T)), MPI_BYTE,
+                                            static_cast<int>(q), exchange_tag, m_comm, &requests.back()),
+                                  "MPI_Isend");
+            }
+        }
+        detail::check_mpi(MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE),
+                          "MPI_Waitall");
+    }
+#endif
+
+    /*******************************************
+     * xchunk_distributed_store implementation *
+     *******************************************/
+
+    /**
+     * Builds a store of chunks of shape \c chunk_shape distributed over the
+     * processes of \c comm.
+     * @param chunk_shape the shape of the chunks
+     * @param comm the communicator
+     */
+    template <class T, class C>
+    template <class S>
+    inline xchunk_distributed_store<T, C>::xchunk_distributed_store(const S& chunk_shape, const communicator_type& comm)
+        : m_shape(), m_chunk_shape(xtl::forward_sequence<shape_type, const S&>(chunk_shape)), m_comm(comm),
+          m_size(0), m_local_begin(0), m_local_end(0), m_chunks(), m_ghosts()
+    {
+    }
+
+    /**
+     * Sets the shape of the grid of chunks, and allocates the chunks of the
+     * calling process. The process of rank r of p owns the chunks of linear
+     * index r * n / p to (r + 1) * n / p excluded, n being the number of chunks.
+     * @param grid_shape the number of chunks in each dimension
+     */
+    template <class T, class C>
+    template <class S>
+    inline void xchunk_distributed_store<T, C>::resize(const S& grid_shape)
+    {
+        m_shape = xtl::forward_sequence<shape_type, const S&>(grid_shape);
+        m_size = compute_size(m_shape);
+        size_type rank = m_comm.rank();
+        size_type nprocs = m_comm.size();
+        m_local_begin = rank * m_size / nprocs;
+        m_local_end = (rank + 1) * m_size / nprocs;
+        m_chunks.clear();
+        m_chunks.reserve(m_local_end - m_local_begin);
+        for (size_type i = m_local_begin; i != m_local_end; ++i)
+        {
+            m_chunks.push_back(chunk_type::from_shape(m_chunk_shape));
+        }
+        m_ghosts.clear();
+    }
+
+    /**
+     * Returns the number of chunks of all the processes.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the shape of the grid of chunks.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the shape of the chunks.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::chunk_shape() const noexcept -> const shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    /**
+     * Returns the communicator of the processes sharing the chunks.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::communicator() const noexcept -> const communicator_type&
+    {
+        return m_comm;
+    }
+
+    /**
+     * Returns the rank of the process owning the chunk of linear index i.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::owner(size_type i) const noexcept -> size_type
+    {
+        // Inverse of the ranges of resize
+        return ((i + 1) * m_comm.size() - 1) / m_size;
+    }
+
+    /**
+     * Returns whether the chunk of linear index i is owned by the calling process.
+     */
+    template <class T, class C>
+    inline bool xchunk_distributed_store<T, C>::is_local(size_type i) const noexcept
+    {
+        return i >= m_local_begin && i < m_local_end;
+    }
+
+    /**
+     * Returns the linear index of the first chunk of the calling process.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::local_begin() const noexcept -> size_type
+    {
+        return m_local_begin;
+    }
+
+    /**
+     * Returns the linear index following the last chunk of the calling process.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::local_end() const noexcept -> size_type
+    {
+        return m_local_end;
+    }
+
+    /**
+     * Returns whether the calling process holds a copy of the chunk of
+     * linear index i of another process.
+     */
+    template <class T, class C>
+    inline bool xchunk_distributed_store<T, C>::has_ghost(size_type i) const noexcept
+    {
+        return m_ghosts.find(i) != m_ghosts.end();
+    }
+
+    /**
+     * Returns the copy of the chunk of linear index i of another process,
+     * allocating it. Only the parts received by exchange_halos are defined.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::ghost(size_type i) -> reference
+    {
+        auto it = m_ghosts.find(i);
+        if (it == m_ghosts.end())
+        {
+            it = m_ghosts.emplace(i, chunk_type::from_shape(m_chunk_shape)).first;
+        }
+        return it->second;
+    }
+
+    /**
+     * Frees the copies of the chunks of other processes.
+     */
+    template <class T, class C>
+    inline void xchunk_distributed_store<T, C>::clear_ghosts() noexcept
+    {
+        m_ghosts.clear();
+    }
+
+    /**
+     * Returns the chunk of index [first, last) in the grid, which must be local.
+     */
+    template <class T, class C>
+    template <class It>
+    inline auto xchunk_distributed_store<T, C>::element(It first, It last) -> reference
+    {
+        return (*this)[linear_index(first, last)];
+    }
+
+    /**
+     * Returns the chunk of index [first, last) in the grid, which must be
+     * local or copied by exchange_halos.
+     */
+    template <class T, class C>
+    template <class It>
+    inline auto xchunk_distributed_store<T, C>::element(It first, It last) const -> const_reference
+    {
+        return (*this)[linear_index(first, last)];
+    }
+
+    /**
+     * Returns the chunk of linear index i, which must be local.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::operator[](size_type i) -> reference
+    {
+        if (!is_local(i))
+        {
+            XTENSOR_THROW(std::runtime_error, "xchunk_distributed_store: chunk owned by another process");
+        }
+        return m_chunks[i - m_local_begin];
+    }
+
+    /**
+     * Returns the chunk of linear index i, which must be local or copied by
+     * exchange_halos.
+     */
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::operator[](size_type i) const -> const_reference
+    {
+        if (is_local(i))
+        {
+            return m_chunks[i - m_local_begin];
+        }
+        auto it = m_ghosts.find(i);
+        if (it == m_ghosts.end())
+        {
+            XTENSOR_THROW(std::runtime_error, "xchunk_distributed_store: chunk owned by another process");
+        }
+        return it->second;
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::pin(size_type i) -> reference
+    {
+        return (*this)[i];
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::pin(size_type i) const -> const_reference
+    {
+        return (*this)[i];
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::begin() noexcept -> iterator
+    {
+        return iterator(this, 0);
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::end() noexcept -> iterator
+    {
+        return iterator(this, size());
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::begin() const noexcept -> const_iterator
+    {
+        return const_iterator(this, 0);
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::end() const noexcept -> const_iterator
+    {
+        return const_iterator(this, size());
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    template <class T, class C>
+    inline auto xchunk_distributed_store<T, C>::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    template <class T, class C>
+    template <class It>
+    inline auto xchunk_distributed_store<T, C>::linear_index(It first, It last) const -> size_type
+    {
+        size_type index = 0;
+        auto sh = m_shape.cbegin();
+        for (; first != last; ++first, ++sh)
+        {
+            index = index * *sh + static_cast<size_type>(*first);
+        }
+        return index;
+    }
+
+    // The temporary of an assignment changing the shape is distributed
+    // over the same processes
+    template <class T, class V, class C>
+    class xchunked_assigner<T, xchunk_distributed_store<V, C>>
+    {
+    public:
+
+        using temporary_type = T;
+
+        template <class E, class DST>
+        void build_and_assign_temporary(const xexpression<E>& e, DST& dst)
+        {
+            using storage_type = xchunk_distributed_store<V, C>;
+            temporary_type tmp(e, storage_type(dst.chunk_shape(), dst.chunks().communicator()), dst.chunk_shape());
+            dst = std::move(tmp);
+        }
+    };
+
+    /********************************************
+     * chunked_distributed_array implementation *
+     ********************************************/
+
+    /**
+     * Creates a chunked array distributed over the processes of a communicator.
+     * This function returns a ``xchunked_array<xchunk_distributed_store<T, C>>``
+     * of which each process only allocates its own chunks. It must be called
+     * by all the processes of \c comm with the same arguments.
+     *
+     * @tparam T The type of the elements (e.g. double)
+     * @tparam C The communicator
+     *
+     * @param shape The shape of the array
+     * @param chunk_shape The shape of a chunk
+     * @param comm The communicator of the processes sharing the array
+     *
+     * @return returns a ``xchunked_array<xchunk_distributed_store<T, C>>`` with the given shape and chunk shape.
+     */
+    template <class T, class C, class S>
+    inline xchunked_array<xchunk_distributed_store<T, C>> chunked_distributed_array(S&& shape, S&& chunk_shape, const C& comm)
+    {
+        using chunk_storage = xchunk_distributed_store<T, C>;
+        chunk_storage chunks(chunk_shape, comm);
+        return xchunked_array<chunk_storage>(std::move(chunks), std::forward<S>(shape), std::forward<S>(chunk_shape));
+    }
+
+    template <class T, class C, class I>
+    inline xchunked_array<xchunk_distributed_store<T, C>> chunked_distributed_array(std::initializer_list<I> shape,
+                                                                                    std::initializer_list<I> chunk_shape,
+                                                                                    const C& comm)
+    {
+        using sh_type = std::vector<std::size_t>;
+        auto sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(shape);
+        auto ch_sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(chunk_shape);
+        return chunked_distributed_array<T, C, sh_type>(std::move(sh), std::move(ch_sh), comm);
+    }
+
+    /*************************
+     * halo exchange of the  *
+     * distributed arrays    *
+     *************************/
+
+    namespace detail
+    {
+        template <class S>
+        inline void check_halo(const S& shape, std::size_t halo, pad_mode mode, const char* what)
+        {
+            if (mode != pad_mode::constant)
+            {
+                for (std::size_t n : shape)
+                {
+                    if (halo > (mode == pad_mode::reflect ? n - 1 : n))
+                    {
+                        XTENSOR_THROW(std::runtime_error, std::string(what) + ": halo larger than the array for this pad mode");
+                    }
+                }
+            }
+        }
+
+        // Calls f(j, chunk_slices, n) for each part of the chunk j read by
+        // assemble_halo_block for the block of the chunk of linear index c,
+        // in the order of assemble_halo_block, n being its number of elements
+        template <class S, class F>
+        inline void for_each_halo_source(const S& shape, const S& chunk_shape, const S& grid_shape, std::size_t c,
+                                         std::size_t halo, pad_mode mode, F&& f)
+        {
+            std::size_t dimension = shape.size();
+            S chunk_index(dimension);
+            for (std::size_t k = dimension, r = c; k != 0; --k)
+            {
+                chunk_index[k - 1] = r % grid_shape[k - 1];
+                r /= grid_shape[k - 1];
+            }
+
+            std::vector<std::vector<xhalo_run>> runs(dimension);
+            S first(dimension, 0), last(dimension), idx(dimension, 0);
+            for (std::size_t k = 0; k < dimension; ++k)
+            {
+                std::size_t origin = chunk_index[k] * chunk_shape[k];
+                std::size_t extent = (std::min)(chunk_shape[k], shape[k] - origin);
+                runs[k] = halo_runs(origin, extent, shape[k], halo, mode);
+                last[k] = runs[k].size();
+            }
+
+            xstrided_slice_vector chunk_slices(dimension);
+            S chunk_first(dimension), chunk_last(dimension);
+            do
+            {
+                bool constant = false;
+                for (std::size_t k = 0; k < dimension; ++k)
+                {
+                    const xhalo_run& run = runs[k][idx[k]];
+                    constant = constant || run.constant;
+                    chunk_first[k] = run.src_first / chunk_shape[k];
+                    chunk_last[k] = (run.src_first + run.size - 1) / chunk_shape[k] + 1;
+                }
+                if (constant)
+                {
+                    continue;
+                }
+
+                // Same traversal as for_each_block_chunk
+                S gidx = chunk_first;
+                do
+                {
+                    std::size_t j = 0;
+                    std::size_t n = 1;
+                    for (std::size_t k = 0; k < dimension; ++k)
+                    {
+                        const xhalo_run& run = runs[k][idx[k]];
+                        std::size_t chunk_origin = gidx[k] * chunk_shape[k];
+                        std::size_t first_index = (std::max)(run.src_first, chunk_origin);
+                        std::size_t last_index = (std::min)(run.src_first + run.size, chunk_origin + chunk_shape[k]);
+                        chunk_slices[k] = range(first_index - chunk_origin, last_index - chunk_origin);
+                        n *= last_index - first_index;
+                        j = j * grid_shape[k] + gidx[k];
+                    }
+                    f(j, static_cast<const xstrided_slice_vector&>(chunk_slices), n);
+                }
+                while (next_grid_index(gidx, chunk_first, chunk_last));
+            }
+            while (next_grid_index(idx, first, last));
+        }
+    }
+
+    /**
+     * Copies from the other processes the parts of their chunks read by the
+     * halos of \c halo elements of the chunks of the calling process, as
+     * built by for_each_chunk_with_halo with \c mode. The copies are kept by
+     * the chunk storage, whose constant accessors return them, until the
+     * next exchange. It must be called by all the processes of the
+     * communicator, each process receiving the elements of the other
+     * processes in a single message per process.
+     * @param a the distributed array.
+     * @param halo the number of elements added on each side of the chunks.
+     * @param mode the padding of the halo at the edges of the array.
+     */
+    template <class T, class C>
+    inline void exchange_halos(xchunked_array<xchunk_distributed_store<T, C>>& a, std::size_t halo, pad_mode mode)
+    {
+        using shape_type = std::vector<std::size_t>;
+        using store_type = xchunk_distributed_store<T, C>;
+
+        store_type& store = a.chunks();
+        const store_type& cstore = store;
+        store.clear_ghosts();
+        if (a.size() == 0)
+        {
+            return;
+        }
+        shape_type shape(a.shape().cbegin(), a.shape().cend());
+        shape_type chunk_shape(a.chunk_shape().cbegin(), a.chunk_shape().cend());
+        shape_type grid_shape(a.grid_shape().cbegin(), a.grid_shape().cend());
+        detail::check_halo(shape, halo, mode, "exchange_halos");
+
+        struct incoming_part
+        {
+            std::size_t chunk;
+            xstrided_slice_vector slices;
+            std::size_t size;
+        };
+
+        // All the processes enumerate the parts in the same order, so that
+        // the messages are unpacked as they were packed
+        const C& comm = store.communicator();
+        std::size_t rank = comm.rank();
+        std::vector<std::vector<T>> send(comm.size()), recv(comm.size());
+        std::vector<std::vector<incoming_part>> incoming(comm.size());
+        for (std::size_t c = 0; c < store.size(); ++c)
+        {
+            std::size_t dst = store.owner(c);
+            detail::for_each_halo_source(shape, chunk_shape, grid_shape, c, halo, mode,
+                                         [&](std::size_t j, const xstrided_slice_vector& slices, std::size_t n) {
+                std::size_t src = store.owner(j);
+                if (src == dst)
+                {
+                    return;
+                }
+                if (src == rank)
+                {
+                    auto part = strided_view(cstore[j], slices);
+                    send[dst].insert(send[dst].end(), part.template cbegin<layout_type::row_major>(),
+                                     part.template cend<layout_type::row_major>());
+                }
+                else if (dst == rank)
+                {
+                    incoming[src].push_back({j, slices, n});
+                }
+            });
+        }
+
+        for (std::size_t q = 0; q < incoming.size(); ++q)
+        {
+            std::size_t n = 0;
+            for (const auto& part : incoming[q])
+            {
+                n += part.size;
+            }
+            recv[q].resize(n);
+        }
+        comm.exchange(send, recv);
+
+        for (std::size_t q = 0; q < incoming.size(); ++q)
+        {
+            auto src = recv[q].cbegin();
+            for (const auto& part : incoming[q])
+            {
+                auto dst = strided_view(store.ghost(part.chunk), part.slices);
+                std::copy(src, src + static_cast<std::ptrdiff_t>(part.size), dst.template begin<layout_type::row_major>());
+                src += static_cast<std::ptrdiff_t>(part.size);
+            }
+        }
+    }
+
+    /**
+     * Calls \c f on each chunk of the calling process extended by \c halo
+     * elements on each side along all the axes, after exchanging the halos
+     * with the other processes. The blocks are those of
+     * for_each_chunk_with_halo, and \c f is called as ``f(block, chunk_index)``
+     * in row-major order of the chunk grid. It must be called by all the
+     * processes of the communicator.
+     * @param a the distributed array.
+     * @param halo the number of elements added on each side of the chunks.
+     * @param f the function to call on each block.
+     * @param mode the padding of the halo at the edges of the array.
+     * @param constant_value the value of the padding with \c pad_mode::constant.
+     */
+    template <class T, class C, class F>
+    inline void for_each_local_chunk_with_halo(xchunked_array<xchunk_distributed_store<T, C>>& a, std::size_t halo, F&& f,
+                                               pad_mode mode, T constant_value)
+    {
+        using shape_type = std::vector<std::size_t>;
+
+        exchange_halos(a, halo, mode);
+        if (a.size() == 0)
+        {
+            return;
+        }
+
+        const auto& ca = a;
+        std::size_t dimension = a.dimension();
+        shape_type shape(a.shape().cbegin(), a.shape().cend());
+        shape_type chunk_shape(a.chunk_shape().cbegin(), a.chunk_shape().cend());
+        shape_type grid_shape(a.grid_shape().cbegin(), a.grid_shape().cend());
+        shape_type chunk_index(dimension), zero(dimension, 0), block_shape(dimension);
+        for (std::size_t k = dimension, r = a.chunks().local_begin(); k != 0; --k)
+        {
+            chunk_index[k - 1] = r % grid_shape[k - 1];
+            r /= grid_shape[k - 1];
+        }
+
+        std::vector<std::vector<detail::xhalo_run>> runs(dimension);
+        xarray<T> block;
+        for (std::size_t i = a.chunks().local_begin(); i != a.chunks().local_end(); ++i)
+        {
+            for (std::size_t k = 0; k < dimension; ++k)
+            {
+                std::size_t origin = chunk_index[k] * chunk_shape[k];
+                std::size_t extent = (std::min)(chunk_shape[k], shape[k] - origin);
+                runs[k] = detail::halo_runs(origin, extent, shape[k], halo, mode);
+                block_shape[k] = extent + 2 * halo;
+            }
+            block.resize(block_shape);
+            detail::assemble_halo_block(ca, runs, block, constant_value);
+            f(block, static_cast<const shape_type&>(chunk_index));
+            detail::next_grid_index(chunk_index, zero, grid_shape);
+        }
+    }
+
+    /*****************************************
+     * reductions of the distributed arrays  *
+     *****************************************/
+
+    namespace detail
+    {
+        template <class T>
+        inline T reduce_op_identity(xreduce_op op) noexcept
+        {
+            using limits = std::numeric_limits<T>;
+            switch (op)
+            {
+            case xreduce_op::prod:
+                return T(1);
+            case xreduce_op::min:
+                return limits::has_infinity ? limits::infinity() : (limits::max)();
+            case xreduce_op::max:
+                return limits::has_infinity ? -limits::infinity() : limits::lowest();
+            default:
+                return T(0);
+            }
+        }
+
+        template <class T, class R, class B, class X>
+        inline void merge_distributed_block(R&& region, const B& block, const X& axes, xreduce_op op)
+        {
+            switch (op)
+            {
+            case xreduce_op::sum:
+                noalias(region) += sum<T>(block, axes, evaluation_strategy::immediate);
+                break;
+            case xreduce_op::prod:
+                noalias(region) *= prod<T>(block, axes, evaluation_strategy::immediate);
+                break;
+            case xreduce_op::min:
+                noalias(region) = minimum(region, amin(block, axes, evaluation_strategy::immediate));
+                break;
+            case xreduce_op::max:
+                noalias(region) = maximum(region, amax(block, axes, evaluation_strategy::immediate));
+                break;
+            }
+        }
+    }
+
+    /**
+     * Reduces \c a over \c axes with \c op. Each process reduces its chunks
+     * into a partial result, initialized with the identity of \c op, and the
+     * partial results are combined by the allreduce of the communicator, so
+     * that all the processes get the result. It must be called by all the
+     * processes of the communicator.
+     * @param a the distributed array.
+     * @param axes the axes to reduce.
+     * @param op the reduction operation.
+     * @return an xarray of the shape of \c a without the reduced axes.
+     */
+    template <class T, class C, class X>
+    inline xarray<T> distributed_reduce(const xchunked_array<xchunk_distributed_store<T, C>>& a, const X& axes, xreduce_op op)
+    {
+        using shape_type = std::vector<std::size_t>;
+
+        std::size_t dimension = a.dimension();
+        std::vector<bool> reduced(dimension, false);
+        shape_type reduced_axes;
+        for (auto ax : axes)
+        {
+            std::size_t k = static_cast<std::size_t>(ax);
+            if (k >= dimension)
+            {
+                XTENSOR_THROW(std::runtime_error, "distributed_reduce: axis out of bounds");
+            }
+            if (!reduced[k])
+            {
+                reduced[k] = true;
+                reduced_axes.push_back(k);
+            }
+        }
+        std::sort(reduced_axes.begin(), reduced_axes.end());
+
+        shape_type result_shape;
+        for (std::size_t k = 0; k < dimension; ++k)
+        {
+            if (!reduced[k])
+            {
+                result_shape.push_back(a.shape()[k]);
+            }
+        }
+        xarray<T> result = xarray<T>::from_shape(result_shape);
+        std::fill(result.begin(), result.end(), detail::reduce_op_identity<T>(op));
+
+        const auto& store = a.chunks();
+        shape_type grid_shape(a.grid_shape().cbegin(), a.grid_shape().cend());
+        shape_type chunk_index(dimension), zero(dimension, 0);
+        for (std::size_t k = dimension, r = store.local_begin(); k != 0; --k)
+        {
+            chunk_index[k - 1] = r % grid_shape[k - 1];
+            r /= grid_shape[k - 1];
+        }
+
+        xstrided_slice_vector chunk_slices(dimension), region_slices;
+        for (std::size_t i = store.local_begin(); i != store.local_end(); ++i)
+        {
+            bool full = true;
+            region_slices.clear();
+            for (std::size_t k = 0; k < dimension; ++k)
+            {
+                std::size_t origin = chunk_index[k] * a.chunk_shape()[k];
+                std::size_t extent = (std::min)(a.chunk_shape()[k], a.shape()[k] - origin);
+                full = full && extent == a.chunk_shape()[k];
+                chunk_slices[k] = range(std::size_t(0), extent);
+                if (!reduced[k])
+                {
+                    region_slices.push_back(range(origin, origin + extent));
+                }
+            }
+
+            const auto& chunk = store[i];
+            auto merge = [&](const auto& block) {
+                if (result_shape.empty())
+                {
+                    detail::merge_distributed_block<T>(result, block, reduced_axes, op);
+                }
+                else
+                {
+                    detail::merge_distributed_block<T>(strided_view(result, region_slices), block, reduced_axes, op);
+                }
+            };
+            if (full)
+            {
+                merge(chunk);
+            }
+            else
+            {
+                merge(eval(strided_view(chunk, chunk_slices)));
+            }
+            detail::next_grid_index(chunk_index, zero, grid_shape);
+        }
+
+        store.communicator().allreduce(result.data(), result.size(), op);
+        return result;
+    }
+
+    /**
+     * Reduces all the elements of \c a with \c op, see
+     * distributed_reduce(const xchunked_array<xchunk_distributed_store<T, C>>&, const X&, xreduce_op).
+     * @param a the distributed array.
+     * @param op the reduction operation.
+     * @return the reduced value, on all the processes.
+     */
+    template <class T, class C>
+    inline T distributed_reduce(const xchunked_array<xchunk_distributed_store<T, C>>& a, xreduce_op op)
+    {
+        std::vector<std::size_t> axes(a.dimension());
+        std::iota(axes.begin(), axes.end(), std::size_t(0));
+        return distributed_reduce(a, axes, op)();
+    }
+}
+
+#endif
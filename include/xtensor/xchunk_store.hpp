@@ -0,0 +1,1763 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CHUNK_STORE_HPP
+#define XTENSOR_CHUNK_STORE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(XTENSOR_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include "xarray.hpp"
+#include "xchunked_array.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /*********************
+     * xchunk_file_store *
+     *********************/
+
+    template <class T>
+    class xchunk_file_store;
+
+    namespace detail
+    {
+        template <class S, bool is_const>
+        class xchunk_store_iterator
+        {
+        public:
+
+            using self_type = xchunk_store_iterator<S, is_const>;
+            using store_type = std::conditional_t<is_const, const S, S>;
+            using value_type = typename S::value_type;
+            using reference = std::conditional_t<is_const, const value_type&, value_type&>;
+            using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            xchunk_store_iterator() = default;
+            xchunk_store_iterator(store_type* store, std::size_t index) noexcept;
+
+            reference operator*() const;
+            pointer operator->() const;
+
+            self_type& operator++() noexcept;
+            self_type operator++(int) noexcept;
+            self_type operator+(difference_type n) const noexcept;
+
+            bool operator==(const self_type& rhs) const noexcept;
+            bool operator!=(const self_type& rhs) const noexcept;
+
+        private:
+
+            store_type* p_store = nullptr;
+            std::size_t m_index = 0;
+        };
+
+        // Chunks read ahead of their access, and the mutex serializing
+        // the accesses to the backend. The pending reads are completed
+        // before the prefetcher is moved, since they refer to the store.
+        template <class C>
+        class xchunk_prefetcher
+        {
+        public:
+
+            using chunk_type = C;
+
+            xchunk_prefetcher();
+            ~xchunk_prefetcher();
+
+            xchunk_prefetcher(xchunk_prefetcher&& rhs);
+            xchunk_prefetcher& operator=(xchunk_prefetcher&& rhs);
+
+            bool pending(std::size_t i) const;
+            template <class F>
+            void launch(std::size_t i, F&& f);
+            bool take(std::size_t i, chunk_type& chunk);
+            void discard_outside(std::size_t first, std::size_t last) noexcept;
+            void wait() noexcept;
+
+            std::mutex& mutex() const noexcept;
+
+        private:
+
+            std::map<std::size_t, std::future<chunk_type>> m_pending;
+            std::unique_ptr<std::mutex> p_mutex;
+        };
+    }
+
+    /**
+     * @class xchunk_cached_store
+     * @brief Chunk storage of an xchunked_array with a bounded cache of chunks.
+     *
+     * The xchunk_cached_store class keeps the chunks of an xchunked_array in
+     * a backend, e.g. a file or compressed buffers, and at most cache_size()
+     * of them resident in memory. The least recently used chunk is evicted
+     * to load another one, and written back to the backend if it was
+     * accessed through a non-const reference. The chunk last dereferenced
+     * through an iterator of the store, as done by the chunk iterators of
+     * the xchunked_array while a chunk is assigned, is pinned and never
+     * evicted.
+     *
+     * The references to the elements of the chunks that are not pinned are
+     * invalidated by the next access to another chunk, and the store must
+     * not be accessed concurrently.
+     *
+     * With a non-zero prefetch depth, pinning the chunk i also starts reading
+     * the chunks i + 1 to i + prefetch_depth() from the backend in background
+     * threads, so that the I/O or the decompression of the next chunks of a
+     * row-major traversal, as done by the chunk iterators, overlaps the
+     * computation of the current one.
+     *
+     * @tparam T the value type of the elements, which must be trivially copyable
+     * @tparam B the backend, providing resize(n), read(i, data, n),
+     *           write(i, data, n) and flush() for the chunk of linear index i
+     *           (in row-major order of the grid) of n elements
+     * @sa xchunk_file_store, xchunk_compressed_store
+     */
+    template <class T, class B>
+    class xchunk_cached_store
+    {
+    public:
+
+        static_assert(std::is_trivially_copyable<T>::value, "xchunk_cached_store requires trivially copyable elements");
+
+        using self_type = xchunk_cached_store<T, B>;
+        using backend_type = B;
+        using chunk_type = xarray<T, layout_type::row_major>;
+        using value_type = chunk_type;
+        using reference = chunk_type&;
+        using const_reference = const chunk_type&;
+        using shape_type = typename chunk_type::shape_type;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = detail::xchunk_store_iterator<self_type, false>;
+        using const_iterator = detail::xchunk_store_iterator<self_type, true>;
+
+        template <class S>
+        xchunk_cached_store(backend_type&& backend, const S& chunk_shape, size_type cache_size);
+        ~xchunk_cached_store();
+
+        xchunk_cached_store(const xchunk_cached_store&) = delete;
+        xchunk_cached_store& operator=(const xchunk_cached_store&) = delete;
+
+        xchunk_cached_store(xchunk_cached_store&&) = default;
+        xchunk_cached_store& operator=(xchunk_cached_store&&) = default;
+
+        template <class S>
+        void resize(const S& grid_shape);
+
+        size_type size() const noexcept;
+        const shape_type& shape() const noexcept;
+        const shape_type& chunk_shape() const noexcept;
+        size_type cache_size() const noexcept;
+
+        size_type prefetch_depth() const noexcept;
+        void set_prefetch_depth(size_type depth) noexcept;
+
+        template <class It>
+        reference element(It first, It last);
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        reference pin(size_type i);
+        const_reference pin(size_type i) const;
+        void unpin() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        void flush();
+
+    protected:
+
+        backend_type& backend() noexcept;
+        const backend_type& backend() const noexcept;
+
+    private:
+
+        static constexpr size_type npos = (std::numeric_limits<size_type>::max)();
+
+        struct slot
+        {
+            chunk_type m_chunk;
+            size_type m_index;
+            bool m_dirty;
+            std::list<size_type>::iterator m_lru;
+        };
+
+        template <class It>
+        size_type linear_index(It first, It last) const;
+
+        slot& load(size_type i) const;
+        void write(slot& s) const;
+        void prefetch(size_type i) const;
+
+        shape_type m_shape;
+        shape_type m_chunk_shape;
+        size_type m_chunk_size;
+        size_type m_cache_size;
+        size_type m_prefetch_depth;
+        // Moved before the backend the pending reads refer to
+        mutable detail::xchunk_prefetcher<chunk_type> m_prefetcher;
+        // The store is logically const when chunks are loaded or evicted
+        mutable backend_type m_backend;
+        mutable std::vector<slot> m_slots;
+        mutable std::vector<size_type> m_resident;
+        // Slots from the most to the least recently used
+        mutable std::list<size_type> m_lru;
+        mutable size_type m_pinned;
+    };
+
+    namespace detail
+    {
+        template <class T>
+        class xchunk_file_backend
+        {
+        public:
+
+            explicit xchunk_file_backend(const std::string& path);
+
+            void resize(std::size_t n_chunks);
+            void read(std::size_t i, T* data, std::size_t n);
+            bool write(std::size_t i, const T* data, std::size_t n);
+            void flush();
+
+            const std::string& path() const noexcept;
+
+        private:
+
+            std::string m_path;
+            std::fstream m_file;
+        };
+    }
+
+    /**
+     * @class xchunk_file_store
+     * @brief Chunk storage of an xchunked_array persisted to a file.
+     *
+     * The xchunk_file_store class is an xchunk_cached_store keeping the
+     * chunks in one file, the chunk of linear index i being at the offset
+     * i times the size of a full chunk. The chunks missing from the file are
+     * read as zeros, and an existing file is reopened with its content.
+     *
+     * @tparam T the value type of the elements, which must be trivially copyable
+     * @sa chunked_file_array
+     */
+    template <class T>
+    class xchunk_file_store : public xchunk_cached_store<T, detail::xchunk_file_backend<T>>
+    {
+    public:
+
+        using base_type = xchunk_cached_store<T, detail::xchunk_file_backend<T>>;
+        using size_type = typename base_type::size_type;
+
+        template <class S>
+        xchunk_file_store(const std::string& path, const S& chunk_shape, size_type cache_size);
+
+        const std::string& path() const noexcept;
+    };
+
+    /**
+     * @class xchunk_rle_codec
+     * @brief Run-length codec of the compressed chunk stores.
+     *
+     * Runs of 3 to 130 equal bytes are stored as a count and the byte, and the
+     * other bytes as literal runs of at most 128 bytes. It is fast, and makes
+     * the long runs of zeros of sparse data, or of the high bytes of shuffled
+     * numbers, small.
+     */
+    struct xchunk_rle_codec
+    {
+        void compress(const char* src, std::size_t size, std::vector<char>& dst) const;
+        void decompress(const char* src, std::size_t size, char* dst, std::size_t dst_size) const;
+    };
+
+#if defined(XTENSOR_USE_ZLIB)
+    /**
+     * @class xchunk_zlib_codec
+     * @brief Deflate codec of the compressed chunk stores, given a zlib
+     * compression level.
+     */
+    struct xchunk_zlib_codec
+    {
+        int level = 1;
+
+        void compress(const char* src, std::size_t size, std::vector<char>& dst) const;
+        void decompress(const char* src, std::size_t size, char* dst, std::size_t dst_size) const;
+    };
+#endif
+
+    namespace detail
+    {
+        template <class T, class C>
+        class xchunk_compressed_backend
+        {
+        public:
+
+            xchunk_compressed_backend(const C& codec, bool shuffle);
+
+            void resize(std::size_t n_chunks);
+            void read(std::size_t i, T* data, std::size_t n);
+            bool write(std::size_t i, const T* data, std::size_t n);
+            void flush();
+
+            std::size_t compressed_size() const noexcept;
+            bool shuffle() const noexcept;
+
+        private:
+
+            C m_codec;
+            bool m_shuffle;
+            // Empty for the chunks of zeros
+            std::vector<std::vector<char>> m_chunks;
+            std::vector<char> m_buffer;
+            std::size_t m_compressed_size;
+        };
+    }
+
+    /**
+     * @class xchunk_compressed_store
+     * @brief Chunk storage of an xchunked_array compressed in memory.
+     *
+     * The xchunk_compressed_store class is an xchunk_cached_store keeping
+     * the chunks compressed by the codec C, and decompressed to the resident
+     * chunks on access. The bytes of the elements can be shuffled before the
+     * compression, as done by blosc: the first bytes of all the elements are
+     * stored first, then their second bytes, etc. This groups the bytes of
+     * equal significance, e.g. the exponents of floating point numbers, and
+     * makes them compress better. The chunks of zeros take no memory.
+     *
+     * @tparam T the value type of the elements, which must be trivially copyable
+     * @tparam C the codec, providing compress(src, size, dst) appending to the
+     *           std::vector<char> dst and decompress(src, size, dst, dst_size)
+     * @sa chunked_compressed_array
+     */
+    template <class T, class C = xchunk_rle_codec>
+    class xchunk_compressed_store : public xchunk_cached_store<T, detail::xchunk_compressed_backend<T, C>>
+    {
+    public:
+
+        using base_type = xchunk_cached_store<T, detail::xchunk_compressed_backend<T, C>>;
+        using codec_type = C;
+        using size_type = typename base_type::size_type;
+
+        template <class S>
+        xchunk_compressed_store(const S& chunk_shape, size_type cache_size, bool shuffle = sizeof(T) > 1,
+                                const codec_type& codec = codec_type());
+
+        size_type compressed_size() const noexcept;
+        bool shuffle() const noexcept;
+    };
+
+    template <class T, class S>
+    xchunked_array<xchunk_file_store<T>> chunked_file_array(const std::string& path, S&& shape, S&& chunk_shape,
+                                                            std::size_t cache_size);
+
+    template <class T, class I>
+    xchunked_array<xchunk_file_store<T>> chunked_file_array(const std::string& path, std::initializer_list<I> shape,
+                                                            std::initializer_list<I> chunk_shape, std::size_t cache_size);
+
+    template <class T, class C = xchunk_rle_codec, class S>
+    xchunked_array<xchunk_compressed_store<T, C>> chunked_compressed_array(S&& shape, S&& chunk_shape, std::size_t cache_size,
+                                                                          bool shuffle = sizeof(T) > 1, const C& codec = C());
+
+    template <class T, class C = xchunk_rle_codec, class I>
+    xchunked_array<xchunk_compressed_store<T, C>> chunked_compressed_array(std::initializer_list<I> shape,
+                                                                          std::initializer_list<I> chunk_shape,
+                                                                          std::size_t cache_size, bool shuffle = sizeof(T) > 1,
+                                                                          const C& codec = C());
+
+    /***********************
+     * xchunk_sparse_store *
+     ***********************/
+
+    /**
+     * @class xchunk_sparse_store
+     * @brief In-memory chunk storage allocating the chunks on first write.
+     *
+     * The xchunk_sparse_store class keeps the chunks of an xchunked_array
+     * in memory, but only allocates a chunk when it is accessed through a
+     * non-const reference, e.g. by an assignment or the non-const access
+     * operators of the array. The other chunks read as the fill value, and
+     * are skipped by the reductions of the array, which reduce the fill
+     * chunk once instead.
+     *
+     * @tparam T the value type of the elements
+     * @tparam L the layout of the chunks
+     * @sa chunked_sparse_array
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    class xchunk_sparse_store
+    {
+    public:
+
+        using self_type = xchunk_sparse_store<T, L>;
+        using chunk_type = xarray<T, L>;
+        using value_type = chunk_type;
+        using reference = chunk_type&;
+        using const_reference = const chunk_type&;
+        using shape_type = typename chunk_type::shape_type;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = detail::xchunk_store_iterator<self_type, false>;
+        using const_iterator = detail::xchunk_store_iterator<self_type, true>;
+
+        template <class S>
+        xchunk_sparse_store(const S& chunk_shape, const T& fill_value = T());
+        ~xchunk_sparse_store() = default;
+
+        xchunk_sparse_store(const xchunk_sparse_store& rhs);
+        xchunk_sparse_store& operator=(const xchunk_sparse_store& rhs);
+
+        xchunk_sparse_store(xchunk_sparse_store&&) = default;
+        xchunk_sparse_store& operator=(xchunk_sparse_store&&) = default;
+
+        template <class S>
+        void resize(const S& grid_shape);
+
+        size_type size() const noexcept;
+        const shape_type& shape() const noexcept;
+        const shape_type& chunk_shape() const noexcept;
+        const T& fill_value() const noexcept;
+
+        bool is_materialized(size_type i) const noexcept;
+        size_type materialized_size() const noexcept;
+        void release(size_type i);
+
+        template <class It>
+        reference element(It first, It last);
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        reference pin(size_type i);
+        const_reference pin(size_type i) const;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+    private:
+
+        template <class It>
+        size_type linear_index(It first, It last) const;
+
+        shape_type m_shape;
+        shape_type m_chunk_shape;
+        T m_fill_value;
+        chunk_type m_fill;
+        std::vector<std::unique_ptr<chunk_type>> m_chunks;
+    };
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
+    xchunked_array<xchunk_sparse_store<T, L>> chunked_sparse_array(S&& shape, S&& chunk_shape, const T& fill_value = T());
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I>
+    xchunked_array<xchunk_sparse_store<T, L>> chunked_sparse_array(std::initializer_list<I> shape,
+                                                                   std::initializer_list<I> chunk_shape,
+                                                                   const T& fill_value = T());
+
+    /*********************************************
+     * xchunk_store_iterator implementation *
+     *********************************************/
+
+    namespace detail
+    {
+        template <class S, bool is_const>
+        inline xchunk_store_iterator<S, is_const>::xchunk_store_iterator(store_type* store, std::size_t index) noexcept
+            : p_store(store), m_index(index)
+        {
+        }
+
+        template <class S, bool is_const>
+        inline auto xchunk_store_iterator<S, is_const>::operator*() const -> reference
+        {
+            return p_store->pin(m_index);
+        }
+
+        template <class S, bool is_const>
+        inline auto xchunk_store_iterator<S, is_const>::operator->() const -> pointer
+        {
+            return &(p_store->pin(m_index));
+        }
+
+        template <class S, bool is_const>
+        inline auto xchunk_store_iterator<S, is_const>::operator++() noexcept -> self_type&
+        {
+            ++m_index;
+            return *this;
+        }
+
+        template <class S, bool is_const>
+        inline auto xchunk_store_iterator<S, is_const>::operator++(int) noexcept -> self_type
+        {
+            self_type tmp(*this);
+            ++m_index;
+            return tmp;
+        }
+
+        template <class S, bool is_const>
+        inline auto xchunk_store_iterator<S, is_const>::operator+(difference_type n) const noexcept -> self_type
+        {
+            return self_type(p_store, static_cast<std::size_t>(static_cast<difference_type>(m_index) + n));
+        }
+
+        template <class S, bool is_const>
+        inline bool xchunk_store_iterator<S, is_const>::operator==(const self_type& rhs) const noexcept
+        {
+            return p_store == rhs.p_store && m_index == rhs.m_index;
+        }
+
+        template <class S, bool is_const>
+        inline bool xchunk_store_iterator<S, is_const>::operator!=(const self_type& rhs) const noexcept
+        {
+            return !(*this == rhs);
+        }
+    }
+
+    /************************************
+     * xchunk_prefetcher implementation *
+     ************************************/
+
+    namespace detail
+    {
+        template <class C>
+        inline xchunk_prefetcher<C>::xchunk_prefetcher()
+            : m_pending(), p_mutex(new std::mutex())
+        {
+        }
+
+        template <class C>
+        inline xchunk_prefetcher<C>::~xchunk_prefetcher()
+        {
+            wait();
+        }
+
+        template <class C>
+        inline xchunk_prefetcher<C>::xchunk_prefetcher(xchunk_prefetcher&& rhs)
+            : m_pending(), p_mutex()
+        {
+            rhs.wait();
+            p_mutex = std::move(rhs.p_mutex);
+            rhs.p_mutex.reset(new std::mutex());
+        }
+
+        template <class C>
+        inline auto xchunk_prefetcher<C>::operator=(xchunk_prefetcher&& rhs) -> xchunk_prefetcher&
+        {
+            wait();
+            rhs.wait();
+            std::swap(p_mutex, rhs.p_mutex);
+            return *this;
+        }
+
+        template <class C>
+        inline bool xchunk_prefetcher<C>::pending(std::size_t i) const
+        {
+            return m_pending.find(i) != m_pending.end();
+        }
+
+        template <class C>
+        template <class F>
+        inline void xchunk_prefetcher<C>::launch(std::size_t i, F&& f)
+        {
+            m_pending.emplace(i, std::async(std::launch::async, std::forward<F>(f)));
+        }
+
+        // Moves the chunk i to chunk if it was read ahead, rethrowing the
+        // exception of its read if any
+        template <class C>
+        inline bool xchunk_prefetcher<C>::take(std::size_t i, chunk_type& chunk)
+        {
+            auto it = m_pending.find(i);
+            if (it == m_pending.end())
+            {
+                return false;
+            }
+            std::future<chunk_type> f = std::move(it->second);
+            m_pending.erase(it);
+            chunk = f.get();
+            return true;
+        }
+
+        template <class C>
+        inline void xchunk_prefetcher<C>::discard_outside(std::size_t first, std::size_t last) noexcept
+        {
+            for (auto it = m_pending.begin(); it != m_pending.end();)
+            {
+                if (it->first < first || it->first >= last)
+                {
+                    it->second.wait();
+                    it = m_pending.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        // Waits for the pending reads and drops their chunks
+        template <class C>
+        inline void xchunk_prefetcher<C>::wait() noexcept
+        {
+            for (auto& p : m_pending)
+            {
+                p.second.wait();
+            }
+            m_pending.clear();
+        }
+
+        template <class C>
+        inline std::mutex& xchunk_prefetcher<C>::mutex() const noexcept
+        {
+            return *p_mutex;
+        }
+    }
+
+    /**************************************
+     * xchunk_cached_store implementation *
+     **************************************/
+
+    /**
+     * Builds a store of the chunks kept in \c backend.
+     * @param backend the backend storing the chunks
+     * @param chunk_shape the shape of the chunks
+     * @param cache_size the maximal number of resident chunks, at least 2
+     */
+    template <class T, class B>
+    template <class S>
+    inline xchunk_cached_store<T, B>::xchunk_cached_store(backend_type&& backend, const S& chunk_shape, size_type cache_size)
+        : m_shape(), m_chunk_shape(xtl::forward_sequence<shape_type, const S&>(chunk_shape)),
+          m_chunk_size(compute_size(m_chunk_shape)), m_cache_size((std::max)(cache_size, size_type(2))),
+          m_prefetch_depth(0), m_prefetcher(), m_backend(std::move(backend)), m_slots(), m_resident(), m_lru(),
+          m_pinned(npos)
+    {
+        m_slots.reserve(m_cache_size);
+    }
+
+    /**
+     * Writes the modified resident chunks back to the backend.
+     */
+    template <class T, class B>
+    inline xchunk_cached_store<T, B>::~xchunk_cached_store()
+    {
+        m_prefetcher.wait();
+        for (slot& s : m_slots)
+        {
+            if (s.m_dirty)
+            {
+                m_backend.write(s.m_index, s.m_chunk.data(), m_chunk_size);
+            }
+        }
+    }
+
+    /**
+     * Sets the shape of the grid of chunks. The resident chunks are written
+     * back and evicted, the chunks of the backend keeping their linear index.
+     * @param grid_shape the number of chunks in each dimension
+     */
+    template <class T, class B>
+    template <class S>
+    inline void xchunk_cached_store<T, B>::resize(const S& grid_shape)
+    {
+        m_prefetcher.wait();
+        flush();
+        m_slots.clear();
+        m_lru.clear();
+        m_pinned = npos;
+        m_shape = xtl::forward_sequence<shape_type, const S&>(grid_shape);
+        m_resident.assign(compute_size(m_shape), npos);
+        std::lock_guard<std::mutex> lock(m_prefetcher.mutex());
+        m_backend.resize(m_resident.size());
+    }
+
+    /**
+     * Returns the number of chunks.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::size() const noexcept -> size_type
+    {
+        return m_resident.size();
+    }
+
+    /**
+     * Returns the shape of the grid of chunks.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the shape of the chunks.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::chunk_shape() const noexcept -> const shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    /**
+     * Returns the maximal number of resident chunks.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::cache_size() const noexcept -> size_type
+    {
+        return m_cache_size;
+    }
+
+    /**
+     * Returns the number of chunks read ahead of the pinned chunk.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::prefetch_depth() const noexcept -> size_type
+    {
+        return m_prefetch_depth;
+    }
+
+    /**
+     * Sets the number of chunks read ahead of the pinned chunk, which are
+     * held in memory in addition to the resident chunks until they are
+     * accessed. A depth of 0, the default, disables the prefetching.
+     * @param depth the number of chunks to read ahead
+     */
+    template <class T, class B>
+    inline void xchunk_cached_store<T, B>::set_prefetch_depth(size_type depth) noexcept
+    {
+        m_prefetch_depth = depth;
+    }
+
+    /**
+     * Returns the chunk at the given position in the grid, loading it if
+     * needed. The chunk is marked as modified.
+     */
+    template <class T, class B>
+    template <class It>
+    inline auto xchunk_cached_store<T, B>::element(It first, It last) -> reference
+    {
+        return (*this)[linear_index(first, last)];
+    }
+
+    /**
+     * Returns the chunk at the given position in the grid, loading it if
+     * needed.
+     */
+    template <class T, class B>
+    template <class It>
+    inline auto xchunk_cached_store<T, B>::element(It first, It last) const -> const_reference
+    {
+        return (*this)[linear_index(first, last)];
+    }
+
+    /**
+     * Returns the chunk of linear index i, loading it if needed. The chunk
+     * is marked as modified.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::operator[](size_type i) -> reference
+    {
+        slot& s = load(i);
+        s.m_dirty = true;
+        return s.m_chunk;
+    }
+
+    /**
+     * Returns the chunk of linear index i, loading it if needed.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::operator[](size_type i) const -> const_reference
+    {
+        return load(i).m_chunk;
+    }
+
+    /**
+     * Returns the chunk of linear index i, which is not evicted until another
+     * chunk is pinned or unpin is called. The chunk is marked as modified.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::pin(size_type i) -> reference
+    {
+        reference chunk = (*this)[i];
+        m_pinned = i;
+        prefetch(i);
+        return chunk;
+    }
+
+    /**
+     * Returns the chunk of linear index i, which is not evicted until another
+     * chunk is pinned or unpin is called.
+     */
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::pin(size_type i) const -> const_reference
+    {
+        const_reference chunk = (*this)[i];
+        m_pinned = i;
+        prefetch(i);
+        return chunk;
+    }
+
+    /**
+     * Lets the pinned chunk be evicted.
+     */
+    template <class T, class B>
+    inline void xchunk_cached_store<T, B>::unpin() const noexcept
+    {
+        m_pinned = npos;
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::begin() noexcept -> iterator
+    {
+        return iterator(this, 0);
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::end() noexcept -> iterator
+    {
+        return iterator(this, size());
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::begin() const noexcept -> const_iterator
+    {
+        return const_iterator(this, 0);
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::end() const noexcept -> const_iterator
+    {
+        return const_iterator(this, size());
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Writes the modified resident chunks back to the backend, and flushes it.
+     */
+    template <class T, class B>
+    inline void xchunk_cached_store<T, B>::flush()
+    {
+        for (slot& s : m_slots)
+        {
+            if (s.m_dirty)
+            {
+                write(s);
+            }
+        }
+        std::lock_guard<std::mutex> lock(m_prefetcher.mutex());
+        m_backend.flush();
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::backend() noexcept -> backend_type&
+    {
+        return m_backend;
+    }
+
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::backend() const noexcept -> const backend_type&
+    {
+        return m_backend;
+    }
+
+    template <class T, class B>
+    template <class It>
+    inline auto xchunk_cached_store<T, B>::linear_index(It first, It last) const -> size_type
+    {
+        size_type index = 0;
+        auto sh = m_shape.cbegin();
+        for (; first != last; ++first, ++sh)
+        {
+            index = index * *sh + static_cast<size_type>(*first);
+        }
+        return index;
+    }
+
+    // Returns the slot of the chunk i, evicts the least recently used chunk
+    // that is not pinned if the cache is full
+    template <class T, class B>
+    inline auto xchunk_cached_store<T, B>::load(size_type i) const -> slot&
+    {
+        size_type k = m_resident[i];
+        if (k != npos)
+        {
+            slot& s = m_slots[k];
+            m_lru.splice(m_lru.begin(), m_lru, s.m_lru);
+            return s;
+        }
+
+        chunk_type prefetched;
+        bool is_prefetched = m_prefetcher.take(i, prefetched);
+        if (m_slots.size() < m_cache_size)
+        {
+            k = m_slots.size();
+            m_slots.push_back(slot{is_prefetched ? std::move(prefetched) : chunk_type::from_shape(m_chunk_shape),
+                                   npos, false, m_lru.end()});
+            m_lru.push_front(k);
+        }
+        else
+        {
+            auto victim = std::prev(m_lru.end());
+            if (m_slots[*victim].m_index == m_pinned)
+            {
+                --victim;
+            }
+            k = *victim;
+            slot& old = m_slots[k];
+            if (old.m_dirty)
+            {
+                write(old);
+            }
+            m_resident[old.m_index] = npos;
+            m_lru.splice(m_lru.begin(), m_lru, victim);
+        }
+
+        slot& s = m_slots[k];
+        s.m_index = i;
+        s.m_dirty = false;
+        s.m_lru = m_lru.begin();
+        m_resident[i] = k;
+        if (is_prefetched)
+        {
+            s.m_chunk = std::move(prefetched);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_prefetcher.mutex());
+            m_backend.read(i, s.m_chunk.data(), m_chunk_size);
+        }
+        return s;
+    }
+
+    template <class T, class B>
+    inline void xchunk_cached_store<T, B>::write(slot& s) const
+    {
+        bool written;
+        {
+            std::lock_guard<std::mutex> lock(m_prefetcher.mutex());
+            written = m_backend.write(s.m_index, s.m_chunk.data(), m_chunk_size);
+        }
+        if (!written)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to write a chunk.");
+        }
+        s.m_dirty = false;
+    }
+
+    // Starts reading the chunks following i that are neither resident nor
+    // already read, and drops the reads of the chunks left behind
+    template <class T, class B>
+    inline void xchunk_cached_store<T, B>::prefetch(size_type i) const
+    {
+        if (m_prefetch_depth == 0)
+        {
+            return;
+        }
+        size_type last = (std::min)(i + 1 + m_prefetch_depth, size());
+        m_prefetcher.discard_outside(i + 1, last);
+        for (size_type j = i + 1; j < last; ++j)
+        {
+            if (m_resident[j] == npos && !m_prefetcher.pending(j))
+            {
+                m_prefetcher.launch(j, [this, j]()
+                {
+                    chunk_type chunk = chunk_type::from_shape(m_chunk_shape);
+                    std::lock_guard<std::mutex> lock(m_prefetcher.mutex());
+                    m_backend.read(j, chunk.data(), m_chunk_size);
+                    return chunk;
+                });
+            }
+        }
+    }
+
+    /************************************
+     * xchunk_file_store implementation *
+     ************************************/
+
+    namespace detail
+    {
+        template <class T>
+        inline xchunk_file_backend<T>::xchunk_file_backend(const std::string& path)
+            : m_path(path), m_file()
+        {
+            std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out | std::ios_base::binary;
+            m_file.open(m_path, mode);
+            if (!m_file.is_open())
+            {
+                // Creates the file, which std::fstream does not do in read-write mode
+                std::ofstream(m_path, std::ios_base::binary);
+                m_file.open(m_path, mode);
+            }
+            if (!m_file.is_open())
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+            }
+        }
+
+        template <class T>
+        inline void xchunk_file_backend<T>::resize(std::size_t)
+        {
+        }
+
+        // The part of the chunk after the end of the file is zero
+        template <class T>
+        inline void xchunk_file_backend<T>::read(std::size_t i, T* data, std::size_t n)
+        {
+            std::size_t bytes = n * sizeof(T);
+            m_file.clear();
+            m_file.seekg(static_cast<std::streamoff>(i) * static_cast<std::streamoff>(bytes));
+            m_file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(bytes));
+            std::size_t count = m_file ? bytes : static_cast<std::size_t>((std::max)(m_file.gcount(), std::streamsize(0)));
+            std::fill(reinterpret_cast<char*>(data) + count, reinterpret_cast<char*>(data) + bytes, char(0));
+            m_file.clear();
+        }
+
+        template <class T>
+        inline bool xchunk_file_backend<T>::write(std::size_t i, const T* data, std::size_t n)
+        {
+            std::size_t bytes = n * sizeof(T);
+            m_file.seekp(static_cast<std::streamoff>(i) * static_cast<std::streamoff>(bytes));
+            m_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            bool good = static_cast<bool>(m_file);
+            m_file.clear();
+            return good;
+        }
+
+        template <class T>
+        inline void xchunk_file_backend<T>::flush()
+        {
+            m_file.flush();
+        }
+
+        template <class T>
+        inline const std::string& xchunk_file_backend<T>::path() const noexcept
+        {
+            return m_path;
+        }
+    }
+
+    /**
+     * Opens or creates the file storing the chunks.
+     * @param path the path of the file
+     * @param chunk_shape the shape of the chunks
+     * @param cache_size the maximal number of resident chunks, at least 2
+     */
+    template <class T>
+    template <class S>
+    inline xchunk_file_store<T>::xchunk_file_store(const std::string& path, const S& chunk_shape, size_type cache_size)
+        : base_type(detail::xchunk_file_backend<T>(path), chunk_shape, cache_size)
+    {
+    }
+
+    /**
+     * Returns the path of the file storing the chunks.
+     */
+    template <class T>
+    inline const std::string& xchunk_file_store<T>::path() const noexcept
+    {
+        return this->backend().path();
+    }
+
+    /*******************************
+     * chunk codecs implementation *
+     *******************************/
+
+    inline void xchunk_rle_codec::compress(const char* src, std::size_t size, std::vector<char>& dst) const
+    {
+        std::size_t i = 0;
+        std::size_t literal = 0;
+        while (i < size)
+        {
+            std::size_t run = 1;
+            while (i + run < size && run < 130 && src[i + run] == src[i])
+            {
+                ++run;
+            }
+            if (run >= 3)
+            {
+                dst.push_back(static_cast<char>(run + 125));
+                dst.push_back(src[i]);
+                i += run;
+                literal = 0;
+            }
+            else
+            {
+                if (literal == 0 || literal == 128)
+                {
+                    dst.push_back(char(0));
+                    literal = 0;
+                }
+                dst.push_back(src[i]);
+                ++literal;
+                dst[dst.size() - literal - 1] = static_cast<char>(literal - 1);
+                ++i;
+            }
+        }
+    }
+
+    inline void xchunk_rle_codec::decompress(const char* src, std::size_t size, char* dst, std::size_t dst_size) const
+    {
+        const char* last = src + size;
+        char* out = dst;
+        char* out_last = dst + dst_size;
+        while (src != last)
+        {
+            std::size_t control = static_cast<unsigned char>(*src++);
+            std::size_t count = control < 128 ? control + 1 : control - 125;
+            if (static_cast<std::size_t>(out_last - out) < count ||
+                static_cast<std::size_t>(last - src) < (control < 128 ? count : std::size_t(1)))
+            {
+                XTENSOR_THROW(std::runtime_error, "Corrupted compressed chunk");
+            }
+            if (control < 128)
+            {
+                std::memcpy(out, src, count);
+                src += count;
+            }
+            else
+            {
+                std::memset(out, *src++, count);
+            }
+            out += count;
+        }
+        if (out != out_last)
+        {
+            XTENSOR_THROW(std::runtime_error, "Corrupted compressed chunk");
+        }
+    }
+
+#if defined(XTENSOR_USE_ZLIB)
+    inline void xchunk_zlib_codec::compress(const char* src, std::size_t size, std::vector<char>& dst) const
+    {
+        std::size_t offset = dst.size();
+        uLongf dst_size = compressBound(static_cast<uLong>(size));
+        dst.resize(offset + dst_size);
+        if (compress2(reinterpret_cast<Bytef*>(dst.data() + offset), &dst_size,
+                      reinterpret_cast<const Bytef*>(src), static_cast<uLong>(size), level) != Z_OK)
+        {
+            XTENSOR_THROW(std::runtime_error, "Failed to compress a chunk");
+        }
+        dst.resize(offset + dst_size);
+    }
+
+    inline void xchunk_zlib_codec::decompress(const char* src, std::size_t size, char* dst, std::size_t dst_size) const
+    {
+        uLongf out_size = static_cast<uLongf>(dst_size);
+        if (uncompress(reinterpret_cast<Bytef*>(dst), &out_size, reinterpret_cast<const Bytef*>(src),
+                       static_cast<uLong>(size)) != Z_OK || out_size != dst_size)
+        {
+            XTENSOR_THROW(std::runtime_error, "Corrupted compressed chunk");
+        }
+    }
+#endif
+
+    /******************************************
+     * xchunk_compressed_store implementation *
+     ******************************************/
+
+    namespace detail
+    {
+        template <class T, class C>
+        inline xchunk_compressed_backend<T, C>::xchunk_compressed_backend(const C& codec, bool shuffle)
+            : m_codec(codec), m_shuffle(shuffle && sizeof(T) > 1), m_chunks(), m_buffer(), m_compressed_size(0)
+        {
+        }
+
+        template <class T, class C>
+        inline void xchunk_compressed_backend<T, C>::resize(std::size_t n_chunks)
+        {
+            m_chunks.resize(n_chunks);
+        }
+
+        template <class T, class C>
+        inline void xchunk_compressed_backend<T, C>::read(std::size_t i, T* data, std::size_t n)
+        {
+            std::size_t bytes = n * sizeof(T);
+            char* out = reinterpret_cast<char*>(data);
+            const std::vector<char>& chunk = m_chunks[i];
+            if (chunk.empty())
+            {
+                std::fill(out, out + bytes, char(0));
+            }
+            else if (!m_shuffle)
+            {
+                m_codec.decompress(chunk.data(), chunk.size(), out, bytes);
+            }
+            else
+            {
+                m_buffer.resize(bytes);
+                m_codec.decompress(chunk.data(), chunk.size(), m_buffer.data(), bytes);
+                for (std::size_t b = 0; b < sizeof(T); ++b)
+                {
+                    const char* in = m_buffer.data() + b * n;
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        out[k * sizeof(T) + b] = in[k];
+                    }
+                }
+            }
+        }
+
+        template <class T, class C>
+        inline bool xchunk_compressed_backend<T, C>::write(std::size_t i, const T* data, std::size_t n)
+        {
+            std::size_t bytes = n * sizeof(T);
+            const char* in = reinterpret_cast<const char*>(data);
+            std::vector<char>& chunk = m_chunks[i];
+            m_compressed_size -= chunk.size();
+            chunk.clear();
+            if (std::all_of(in, in + bytes, [](char c) { return c == char(0); }))
+            {
+                chunk.shrink_to_fit();
+                return true;
+            }
+            if (m_shuffle)
+            {
+                m_buffer.resize(bytes);
+                for (std::size_t b = 0; b < sizeof(T); ++b)
+                {
+                    char* out = m_buffer.data() + b * n;
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        out[k] = in[k * sizeof(T) + b];
+                    }
+                }
+                in = m_buffer.data();
+            }
+            m_codec.compress(in, bytes, chunk);
+            chunk.shrink_to_fit();
+            m_compressed_size += chunk.size();
+            return true;
+        }
+
+        template <class T, class C>
+        inline void xchunk_compressed_backend<T, C>::flush()
+        {
+        }
+
+        template <class T, class C>
+        inline std::size_t xchunk_compressed_backend<T, C>::compressed_size() const noexcept
+        {
+            return m_compressed_size;
+        }
+
+        template <class T, class C>
+        inline bool xchunk_compressed_backend<T, C>::shuffle() const noexcept
+        {
+            return m_shuffle;
+        }
+    }
+
+    /**
+     * Builds an empty store of compressed chunks.
+     * @param chunk_shape the shape of the chunks
+     * @param cache_size the maximal number of resident chunks, at least 2
+     * @param shuffle true to shuffle the bytes of the elements before the compression
+     * @param codec the codec compressing the chunks
+     */
+    template <class T, class C>
+    template <class S>
+    inline xchunk_compressed_store<T, C>::xchunk_compressed_store(const S& chunk_shape, size_type cache_size, bool shuffle,
+                                                                  const codec_type& codec)
+        : base_type(detail::xchunk_compressed_backend<T, C>(codec, shuffle), chunk_shape, cache_size)
+    {
+    }
+
+    /**
+     * Returns the number of bytes of the compressed chunks, the resident
+     * chunks being counted as of their last write back.
+     */
+    template <class T, class C>
+    inline auto xchunk_compressed_store<T, C>::compressed_size() const noexcept -> size_type
+    {
+        return this->backend().compressed_size();
+    }
+
+    /**
+     * Returns whether the bytes of the elements are shuffled before the
+     * compression.
+     */
+    template <class T, class C>
+    inline bool xchunk_compressed_store<T, C>::shuffle() const noexcept
+    {
+        return this->backend().shuffle();
+    }
+
+    /*******************************************
+     * chunked assignment in the cached stores *
+     *******************************************/
+
+    // The chunks are loaded on access, and thus assigned sequentially
+    template <class T>
+    struct is_concurrent_chunk_storage<xchunk_file_store<T>> : std::false_type
+    {
+    };
+
+    template <class T, class C>
+    struct is_concurrent_chunk_storage<xchunk_compressed_store<T, C>> : std::false_type
+    {
+    };
+
+    namespace detail
+    {
+        // The chunks are assigned in place, the cached stores not being
+        // copyable to a temporary array. The expression must have the shape
+        // of the array and must not depend on other chunks than the one it
+        // is assigned to.
+        template <class E, class DST>
+        inline void assign_cached_chunks(const xexpression<E>& e, DST& dst)
+        {
+            const auto& shape = e.derived_cast().shape();
+            if (shape.size() != dst.dimension() || !std::equal(shape.cbegin(), shape.cend(), dst.shape().cbegin()))
+            {
+                XTENSOR_THROW(std::runtime_error, "Cannot resize a chunked array with a cached chunk store");
+            }
+            dst.assign_xexpression(e);
+        }
+    }
+
+    template <class T, class V>
+    class xchunked_assigner<T, xchunk_file_store<V>>
+    {
+    public:
+
+        using temporary_type = T;
+
+        template <class E, class DST>
+        void build_and_assign_temporary(const xexpression<E>& e, DST& dst)
+        {
+            detail::assign_cached_chunks(e, dst);
+        }
+    };
+
+    template <class T, class V, class C>
+    class xchunked_assigner<T, xchunk_compressed_store<V, C>>
+    {
+    public:
+
+        using temporary_type = T;
+
+        template <class E, class DST>
+        void build_and_assign_temporary(const xexpression<E>& e, DST& dst)
+        {
+            detail::assign_cached_chunks(e, dst);
+        }
+    };
+
+    /*************************************
+     * chunked_file_array implementation *
+     *************************************/
+
+    /**
+     * Creates a chunked array stored in a file.
+     * This function returns a ``xchunked_array<xchunk_file_store<T>>`` whose
+     * chunks are kept in the file \c path, of which at most \c cache_size
+     * are resident in memory. The content of an existing file is kept.
+     *
+     * @tparam T The type of the elements (e.g. double)
+     *
+     * @param path The path of the file
+     * @param shape The shape of the array
+     * @param chunk_shape The shape of a chunk
+     * @param cache_size The maximal number of resident chunks
+     *
+     * @return returns a ``xchunked_array<xchunk_file_store<T>>`` with the given shape and chunk shape.
+     */
+    template <class T, class S>
+    inline xchunked_array<xchunk_file_store<T>> chunked_file_array(const std::string& path, S&& shape, S&& chunk_shape,
+                                                                   std::size_t cache_size)
+    {
+        using chunk_storage = xchunk_file_store<T>;
+        chunk_storage chunks(path, chunk_shape, cache_size);
+        return xchunked_array<chunk_storage>(std::move(chunks), std::forward<S>(shape), std::forward<S>(chunk_shape),
+                                             layout_type::row_major);
+    }
+
+    template <class T, class I>
+    inline xchunked_array<xchunk_file_store<T>> chunked_file_array(const std::string& path, std::initializer_list<I> shape,
+                                                                   std::initializer_list<I> chunk_shape, std::size_t cache_size)
+    {
+        using sh_type = std::vector<std::size_t>;
+        auto sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(shape);
+        auto ch_sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(chunk_shape);
+        return chunked_file_array<T, sh_type>(path, std::move(sh), std::move(ch_sh), cache_size);
+    }
+
+    /*******************************************
+     * chunked_compressed_array implementation *
+     *******************************************/
+
+    /**
+     * Creates a chunked array compressed in memory.
+     * This function returns a ``xchunked_array<xchunk_compressed_store<T, C>>``
+     * of zeros, whose chunks are compressed by \c codec and of which at most
+     * \c cache_size are decompressed.
+     *
+     * @tparam T The type of the elements (e.g. double)
+     * @tparam C The codec compressing the chunks (default: xchunk_rle_codec)
+     *
+     * @param shape The shape of the array
+     * @param chunk_shape The shape of a chunk
+     * @param cache_size The maximal number of decompressed chunks
+     * @param shuffle true to shuffle the bytes of the elements before the compression
+     * @param codec The codec compressing the chunks
+     *
+     * @return returns a ``xchunked_array<xchunk_compressed_store<T, C>>`` with the given shape and chunk shape.
+     */
+    template <class T, class C, class S>
+    inline xchunked_array<xchunk_compressed_store<T, C>> chunked_compressed_array(S&& shape, S&& chunk_shape, std::size_t cache_size,
+                                                                                 bool shuffle, const C& codec)
+    {
+        using chunk_storage = xchunk_compressed_store<T, C>;
+        chunk_storage chunks(chunk_shape, cache_size, shuffle, codec);
+        return xchunked_array<chunk_storage>(std::move(chunks), std::forward<S>(shape), std::forward<S>(chunk_shape),
+                                             layout_type::row_major);
+    }
+
+    template <class T, class C, class I>
+    inline xchunked_array<xchunk_compressed_store<T, C>> chunked_compressed_array(std::initializer_list<I> shape,
+                                                                                 std::initializer_list<I> chunk_shape,
+                                                                                 std::size_t cache_size, bool shuffle,
+                                                                                 const C& codec)
+    {
+        using sh_type = std::vector<std::size_t>;
+        auto sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(shape);
+        auto ch_sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(chunk_shape);
+        return chunked_compressed_array<T, C, sh_type>(std::move(sh), std::move(ch_sh), cache_size, shuffle, codec);
+    }
+
+    /**************************************
+     * xchunk_sparse_store implementation *
+     **************************************/
+
+    /**
+     * Builds a store of chunks of shape \c chunk_shape reading as \c fill_value
+     * until they are written.
+     * @param chunk_shape the shape of the chunks
+     * @param fill_value the value of the elements of the chunks not written
+     */
+    template <class T, layout_type L>
+    template <class S>
+    inline xchunk_sparse_store<T, L>::xchunk_sparse_store(const S& chunk_shape, const T& fill_value)
+        : m_shape(), m_chunk_shape(xtl::forward_sequence<shape_type, const S&>(chunk_shape)),
+          m_fill_value(fill_value), m_fill(m_chunk_shape, fill_value), m_chunks()
+    {
+    }
+
+    template <class T, layout_type L>
+    inline xchunk_sparse_store<T, L>::xchunk_sparse_store(const xchunk_sparse_store& rhs)
+        : m_shape(rhs.m_shape), m_chunk_shape(rhs.m_chunk_shape), m_fill_value(rhs.m_fill_value), m_fill(rhs.m_fill),
+          m_chunks(rhs.m_chunks.size())
+    {
+        for (size_type i = 0; i < m_chunks.size(); ++i)
+        {
+            if (rhs.m_chunks[i])
+            {
+                m_chunks[i].reset(new chunk_type(*rhs.m_chunks[i]));
+            }
+        }
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::operator=(const xchunk_sparse_store& rhs) -> self_type&
+    {
+        self_type tmp(rhs);
+        *this = std::move(tmp);
+        return *this;
+    }
+
+    /**
+     * Sets the shape of the grid of chunks. The chunks are released.
+     * @param grid_shape the number of chunks in each dimension
+     */
+    template <class T, layout_type L>
+    template <class S>
+    inline void xchunk_sparse_store<T, L>::resize(const S& grid_shape)
+    {
+        m_shape = xtl::forward_sequence<shape_type, const S&>(grid_shape);
+        m_chunks.clear();
+        m_chunks.resize(compute_size(m_shape));
+    }
+
+    /**
+     * Returns the number of chunks.
+     */
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::size() const noexcept -> size_type
+    {
+        return m_chunks.size();
+    }
+
+    /**
+     * Returns the shape of the grid of chunks.
+     */
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the shape of the chunks.
+     */
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::chunk_shape() const noexcept -> const shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    /**
+     * Returns the value of the elements of the chunks not written.
+     */
+    template <class T, layout_type L>
+    inline const T& xchunk_sparse_store<T, L>::fill_value() const noexcept
+    {
+        return m_fill_value;
+    }
+
+    /**
+     * Returns whether the chunk of linear index i is allocated.
+     */
+    template <class T, layout_type L>
+    inline bool xchunk_sparse_store<T, L>::is_materialized(size_type i) const noexcept
+    {
+        return m_chunks[i] != nullptr;
+    }
+
+    /**
+     * Returns the number of allocated chunks.
+     */
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::materialized_size() const noexcept -> size_type
+    {
+        return static_cast<size_type>(std::count_if(m_chunks.cbegin(), m_chunks.cend(),
+                                                    [](const std::unique_ptr<chunk_type>& c) { return c != nullptr; }));
+    }
+
+    /**
+     * Frees the chunk of linear index i, which reads as the fill value again.
+     */
+    template <class T, layout_type L>
+    inline void xchunk_sparse_store<T, L>::release(size_type i)
+    {
+        m_chunks[i].reset();
+    }
+
+    /**
+     * Returns the chunk of index [first, last) in the grid, allocating it.
+     */
+    template <class T, layout_type L>
+    template <class It>
+    inline auto xchunk_sparse_store<T, L>::element(It first, It last) -> reference
+    {
+        return (*this)[linear_index(first, last)];
+    }
+
+    /**
+     * Returns the chunk of index [first, last) in the grid, or the fill chunk
+     * if it is not allocated.
+     */
+    template <class T, layout_type L>
+    template <class It>
+    inline auto xchunk_sparse_store<T, L>::element(It first, It last) const -> const_reference
+    {
+        return (*this)[linear_index(first, last)];
+    }
+
+    /**
+     * Returns the chunk of linear index i, allocating it.
+     */
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::operator[](size_type i) -> reference
+    {
+        std::unique_ptr<chunk_type>& chunk = m_chunks[i];
+        if (!chunk)
+        {
+            chunk.reset(new chunk_type(m_fill));
+        }
+        return *chunk;
+    }
+
+    /**
+     * Returns the chunk of linear index i, or the fill chunk if it is not
+     * allocated.
+     */
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::operator[](size_type i) const -> const_reference
+    {
+        const std::unique_ptr<chunk_type>& chunk = m_chunks[i];
+        return chunk ? *chunk : m_fill;
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::pin(size_type i) -> reference
+    {
+        return (*this)[i];
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::pin(size_type i) const -> const_reference
+    {
+        return (*this)[i];
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::begin() noexcept -> iterator
+    {
+        return iterator(this, 0);
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::end() noexcept -> iterator
+    {
+        return iterator(this, size());
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::begin() const noexcept -> const_iterator
+    {
+        return const_iterator(this, 0);
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::end() const noexcept -> const_iterator
+    {
+        return const_iterator(this, size());
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    template <class T, layout_type L>
+    inline auto xchunk_sparse_store<T, L>::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    template <class T, layout_type L>
+    template <class It>
+    inline auto xchunk_sparse_store<T, L>::linear_index(It first, It last) const -> size_type
+    {
+        size_type index = 0;
+        auto sh = m_shape.cbegin();
+        for (; first != last; ++first, ++sh)
+        {
+            index = index * *sh + static_cast<size_type>(*first);
+        }
+        return index;
+    }
+
+    // The temporary of an assignment changing the shape has the chunk
+    // shape and the fill value of the array
+    template <class T, class V, layout_type L>
+    class xchunked_assigner<T, xchunk_sparse_store<V, L>>
+    {
+    public:
+
+        using temporary_type = T;
+
+        template <class E, class DST>
+        void build_and_assign_temporary(const xexpression<E>& e, DST& dst)
+        {
+            using storage_type = xchunk_sparse_store<V, L>;
+            temporary_type tmp(e, storage_type(dst.chunk_shape(), dst.chunks().fill_value()), dst.chunk_shape());
+            dst = std::move(tmp);
+        }
+    };
+
+    /***************************************
+     * chunked_sparse_array implementation *
+     ***************************************/
+
+    /**
+     * Creates an in-memory chunked array allocating its chunks on first write.
+     * This function returns a ``xchunked_array<xchunk_sparse_store<T, L>>``
+     * whose elements read as \c fill_value until their chunk is written.
+     *
+     * @tparam T The type of the elements (e.g. double)
+     * @tparam L The layout of the chunks
+     *
+     * @param shape The shape of the array
+     * @param chunk_shape The shape of a chunk
+     * @param fill_value The value of the elements of the chunks not written
+     *
+     * @return returns a ``xchunked_array<xchunk_sparse_store<T, L>>`` with the given shape and chunk shape.
+     */
+    template <class T, layout_type L, class S>
+    inline xchunked_array<xchunk_sparse_store<T, L>> chunked_sparse_array(S&& shape, S&& chunk_shape, const T& fill_value)
+    {
+        using chunk_storage = xchunk_sparse_store<T, L>;
+        chunk_storage chunks(chunk_shape, fill_value);
+        return xchunked_array<chunk_storage>(std::move(chunks), std::forward<S>(shape), std::forward<S>(chunk_shape), L);
+    }
+
+    template <class T, layout_type L, class I>
+    inline xchunked_array<xchunk_sparse_store<T, L>> chunked_sparse_array(std::initializer_list<I> shape,
+                                                                          std::initializer_list<I> chunk_shape,
+                                                                          const T& fill_value)
+    {
+        using sh_type = std::vector<std::size_t>;
+        auto sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(shape);
+        auto ch_sh = xtl::forward_sequence<sh_type, std::initializer_list<I>>(chunk_shape);
+        return chunked_sparse_array<T, L, sh_type>(std::move(sh), std::move(ch_sh), fill_value);
+    }
+}
+
+#endif
@@ -10,11 +10,16 @@
 #ifndef XTENSOR_CHUNKED_ARRAY_HPP
 #define XTENSOR_CHUNKED_ARRAY_HPP
 
-#include <vector>
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
 
 #include "xarray.hpp"
 #include "xchunked_assign.hpp"
+#include "xreducer.hpp"
 
 namespace xt
 {
@@ -26,6 +31,94 @@ namespace xt
     template <class chunk_storage>
     class xchunked_array;
 
+    namespace detail
+    {
+        // Division by a chunk extent: a shift and a mask for powers of two,
+        // otherwise a multiplication by a precomputed reciprocal for 32-bit
+        // indices (Lemire et al., "Faster remainder by direct computation")
+        class xchunk_divider
+        {
+        public:
+
+            explicit xchunk_divider(std::size_t divisor = 1) noexcept;
+
+            std::size_t divisor() const noexcept;
+            std::pair<std::size_t, std::size_t> divmod(std::size_t n) const noexcept;
+
+        private:
+
+            std::size_t m_divisor;
+            std::size_t m_mask;
+            std::size_t m_shift;
+            std::uint64_t m_magic;
+            bool m_power_of_two;
+        };
+    }
+
+    /**
+     * @class xchunked_stepper
+     * @brief Stepper of the chunked arrays whose chunks stay in memory.
+     *
+     * The xchunked_stepper class keeps the index of the current element in
+     * its chunk and its offset in the chunk storage, and only looks up the
+     * chunk again when a step crosses a chunk boundary.
+     *
+     * @tparam A the type of the chunked array
+     * @tparam is_const true for a stepper on a constant array
+     */
+    template <class A, bool is_const>
+    class xchunked_stepper
+    {
+    public:
+
+        using self_type = xchunked_stepper<A, is_const>;
+        using array_type = std::conditional_t<is_const, const A, A>;
+        using chunk_type = std::conditional_t<is_const, const typename A::chunk_type, typename A::chunk_type>;
+
+        using value_type = typename A::value_type;
+        using reference = std::conditional_t<is_const, typename A::const_reference, typename A::reference>;
+        using pointer = std::conditional_t<is_const, typename A::const_pointer, typename A::pointer>;
+        using size_type = typename A::size_type;
+        using difference_type = typename A::difference_type;
+
+        using shape_type = typename A::shape_type;
+        using index_type = xindex_type_t<shape_type>;
+
+        xchunked_stepper() = default;
+        xchunked_stepper(array_type* a, size_type offset, bool end = false) noexcept;
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+        void reset_back(size_type dim);
+
+        void to_begin();
+        void to_end(layout_type l);
+
+    private:
+
+        void update_dimension(size_type dim);
+        void resolve_chunk() const;
+        size_type chunk_stride(size_type dim) const;
+
+        array_type* p_a;
+        index_type m_index;
+        index_type m_chunk_index;
+        index_type m_in_chunk;
+        size_type m_offset;
+        mutable chunk_type* p_chunk;
+        mutable size_type m_chunk_offset;
+        mutable bool m_resolved;
+    };
+
+    template <class A, bool is_const>
+    struct is_indexed_stepper<xchunked_stepper<A, is_const>>
+    {
+        static const bool value = true;
+    };
+
     template <class chunk_storage>
     struct xcontainer_inner_types<xchunked_array<chunk_storage>>
     {
@@ -42,8 +135,14 @@ namespace xt
     {
         using chunk_type = typename chunk_storage::value_type;
         using inner_shape_type = typename chunk_type::shape_type;
-        using const_stepper = xindexed_stepper<xchunked_array<chunk_storage>, true>;
-        using stepper = xindexed_stepper<xchunked_array<chunk_storage>, false>;
+        // The chunks of the cached stores may be evicted between two
+        // accesses, and are thus accessed through the array
+        using const_stepper = std::conditional_t<is_concurrent_chunk_storage<chunk_storage>::value,
+                                                 xchunked_stepper<xchunked_array<chunk_storage>, true>,
+                                                 xindexed_stepper<xchunked_array<chunk_storage>, true>>;
+        using stepper = std::conditional_t<is_concurrent_chunk_storage<chunk_storage>::value,
+                                           xchunked_stepper<xchunked_array<chunk_storage>, false>,
+                                           xindexed_stepper<xchunked_array<chunk_storage>, false>>;
     };
 
     template <class chunk_storage>
@@ -178,7 +277,11 @@ namespace xt
 
         shape_type m_shape;
         shape_type m_chunk_shape;
+        std::vector<detail::xchunk_divider> m_chunk_dividers;
         chunk_storage_type m_chunks;
+
+        friend class xchunked_stepper<self_type, true>;
+        friend class xchunked_stepper<self_type, false>;
     };
 
     template<class E>
@@ -237,6 +340,38 @@ namespace xt
     xchunked_array<xarray<xarray<typename E::value_type>>>
     chunked_array(const xexpression<E>&e, layout_type chunk_memory_layout = XTENSOR_DEFAULT_LAYOUT);
 
+    /**
+     * Copies a chunked array into another one with a different chunk shape.
+     * The copy proceeds by blocks made of whole chunks of the destination,
+     * that are gathered from the chunks of the source into a contiguous
+     * buffer of at most \c memory_budget bytes. The blocks are extended up
+     * to the chunk shape of the source when the budget allows it, so that
+     * each chunk of the source is read a bounded number of times. The
+     * buffer holds at least one chunk of the destination, whatever the
+     * budget.
+     *
+     * @param src The chunked array to copy
+     * @param dst The chunked array to copy into, with the same shape as \c src
+     * @param memory_budget The maximum size of the buffer in bytes
+     */
+    template <class CS1, class CS2>
+    void rechunk(const xchunked_array<CS1>& src, xchunked_array<CS2>& dst, std::size_t memory_budget = std::size_t(1) << 28);
+
+    /**
+     * Creates an in-memory chunked array with the same shape and elements
+     * as \c src and the given chunk shape.
+     *
+     * @param src The chunked array to copy
+     * @param chunk_shape The shape of a chunk of the result
+     * @param memory_budget The maximum size of the intermediate buffer in bytes
+     *
+     * @return returns a ``xchunked_array<xarray<T>>`` with the given chunk shape.
+     * @sa rechunk(const xchunked_array<CS1>&, xchunked_array<CS2>&, std::size_t)
+     */
+    template <class CS, class S>
+    std::enable_if_t<!detail::is_xchunked_array<std::decay_t<S>>::value, xchunked_array<xarray<xarray<typename xchunked_array<CS>::value_type>>>>
+    rechunk(const xchunked_array<CS>& src, S&& chunk_shape, std::size_t memory_budget = std::size_t(1) << 28);
+
     /*******************************
      * chunk_helper implementation *
      *******************************/
@@ -568,6 +703,11 @@ namespace xt
 
         m_shape = xtl::forward_sequence<shape_type, S1>(shape);
         m_chunk_shape = xtl::forward_sequence<shape_type, S2>(chunk_shape);
+        m_chunk_dividers.clear();
+        for (auto cs : m_chunk_shape)
+        {
+            m_chunk_dividers.emplace_back(static_cast<std::size_t>(cs));
+        }
     }
 
     template <class CS>
@@ -582,9 +722,7 @@ namespace xt
     template <class Idx>
     inline std::pair<std::size_t, std::size_t> xchunked_array<CS>::get_chunk_indexes_in_dimension(std::size_t dim, Idx idx) const
     {
-        std::size_t index_of_chunk = static_cast<size_t>(idx) / m_chunk_shape[dim];
-        std::size_t index_in_chunk = static_cast<size_t>(idx) - index_of_chunk * m_chunk_shape[dim];
-        return std::make_pair(index_of_chunk, index_in_chunk);
+        return m_chunk_dividers[dim].divmod(static_cast<std::size_t>(idx));
     }
 
     template <class CS>
@@ -625,6 +763,513 @@ namespace xt
         }
         return std::make_pair(indexes_of_chunk, indexes_in_chunk);
     }
+
+    /*********************************
+     * xchunk_divider implementation *
+     *********************************/
+
+    namespace detail
+    {
+        inline xchunk_divider::xchunk_divider(std::size_t divisor) noexcept
+            : m_divisor(divisor), m_mask(divisor - 1), m_shift(0), m_magic(0),
+              m_power_of_two(divisor != 0 && (divisor & (divisor - 1)) == 0)
+        {
+            if (m_power_of_two)
+            {
+                while ((std::size_t(1) << m_shift) != divisor)
+                {
+                    ++m_shift;
+                }
+            }
+#if defined(__SIZEOF_INT128__)
+            else if (divisor != 0 && divisor <= std::size_t(0xFFFFFFFF))
+            {
+                m_magic = (std::numeric_limits<std::uint64_t>::max)() / divisor + 1;
+            }
+#endif
+        }
+
+        inline std::size_t xchunk_divider::divisor() const noexcept
+        {
+            return m_divisor;
+        }
+
+        inline std::pair<std::size_t, std::size_t> xchunk_divider::divmod(std::size_t n) const noexcept
+        {
+            if (m_power_of_two)
+            {
+                return std::make_pair(n >> m_shift, n & m_mask);
+            }
+            std::size_t q;
+#if defined(__SIZEOF_INT128__)
+            if (m_magic != 0 && n <= std::size_t(0xFFFFFFFF))
+            {
+                q = static_cast<std::size_t>((static_cast<unsigned __int128>(m_magic) * n) >> 64);
+            }
+            else
+#endif
+            {
+                q = n / m_divisor;
+            }
+            return std::make_pair(q, n - q * m_divisor);
+        }
+    }
+
+    /***********************************
+     * xchunked_stepper implementation *
+     ***********************************/
+
+    template <class A, bool is_const>
+    inline xchunked_stepper<A, is_const>::xchunked_stepper(array_type* a, size_type offset, bool end) noexcept
+        : p_a(a),
+          m_index(xtl::make_sequence<index_type>(a->dimension(), size_type(0))),
+          m_chunk_index(xtl::make_sequence<index_type>(a->dimension(), size_type(0))),
+          m_in_chunk(xtl::make_sequence<index_type>(a->dimension(), size_type(0))),
+          m_offset(offset), p_chunk(nullptr), m_chunk_offset(0), m_resolved(false)
+    {
+        if (end)
+        {
+            to_end(XTENSOR_DEFAULT_TRAVERSAL);
+        }
+    }
+
+    template <class A, bool is_const>
+    inline auto xchunked_stepper<A, is_const>::operator*() const -> reference
+    {
+        if (!m_resolved)
+        {
+            resolve_chunk();
+        }
+        return p_chunk->data_element(m_chunk_offset);
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::step(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_index[d] += n;
+            size_type in_chunk = m_in_chunk[d] + n;
+            if (in_chunk < p_a->m_chunk_shape[d])
+            {
+                m_in_chunk[d] = in_chunk;
+                if (m_resolved)
+                {
+                    m_chunk_offset += n * chunk_stride(d);
+                }
+            }
+            else
+            {
+                update_dimension(d);
+            }
+        }
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::step_back(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_index[d] -= n;
+            if (m_in_chunk[d] >= n)
+            {
+                m_in_chunk[d] -= n;
+                if (m_resolved)
+                {
+                    m_chunk_offset -= n * chunk_stride(d);
+                }
+            }
+            else
+            {
+                update_dimension(d);
+            }
+        }
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::reset(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_index[d] = 0;
+            if (m_chunk_index[d] == 0)
+            {
+                if (m_resolved)
+                {
+                    m_chunk_offset -= m_in_chunk[d] * chunk_stride(d);
+                }
+                m_in_chunk[d] = 0;
+            }
+            else
+            {
+                update_dimension(d);
+            }
+        }
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::reset_back(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_index[d] = p_a->shape()[d] - 1;
+            update_dimension(d);
+        }
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::to_begin()
+    {
+        std::fill(m_index.begin(), m_index.end(), size_type(0));
+        std::fill(m_chunk_index.begin(), m_chunk_index.end(), size_type(0));
+        std::fill(m_in_chunk.begin(), m_in_chunk.end(), size_type(0));
+        m_resolved = false;
+    }
+
+    // Moves one past the last element along the leading dimension of l,
+    // as the steppers of the containers do, so that the reverse iterators
+    // can step back from the end
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::to_end(layout_type l)
+    {
+        size_type dim = m_index.size();
+        if (dim == 0)
+        {
+            return;
+        }
+        for (size_type d = 0; d < dim; ++d)
+        {
+            m_index[d] = p_a->shape()[d] - 1;
+        }
+        if (l == layout_type::row_major)
+        {
+            ++m_index[dim - 1];
+        }
+        else if (m_offset == 0)
+        {
+            ++m_index[0];
+        }
+        for (size_type d = 0; d < dim; ++d)
+        {
+            update_dimension(d);
+        }
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::update_dimension(size_type dim)
+    {
+        auto indexes = p_a->m_chunk_dividers[dim].divmod(m_index[dim]);
+        m_chunk_index[dim] = indexes.first;
+        m_in_chunk[dim] = indexes.second;
+        m_resolved = false;
+    }
+
+    template <class A, bool is_const>
+    inline void xchunked_stepper<A, is_const>::resolve_chunk() const
+    {
+        p_chunk = &(p_a->chunks().element(m_chunk_index.cbegin(), m_chunk_index.cend()));
+        m_chunk_offset = 0;
+        for (size_type d = 0; d < m_in_chunk.size(); ++d)
+        {
+            m_chunk_offset += m_in_chunk[d] * chunk_stride(d);
+        }
+        m_resolved = true;
+    }
+
+    template <class A, bool is_const>
+    inline auto xchunked_stepper<A, is_const>::chunk_stride(size_type dim) const -> size_type
+    {
+        return static_cast<size_type>(p_chunk->strides()[dim]);
+    }
+
+    /*********************************
+     * chunked reduce implementation *
+     *********************************/
+
+    namespace detail
+    {
+        template <class B, class V, class M>
+        inline void merge_chunk_reduction(const B& block, V&& region, const M& merge_fct, bool first)
+        {
+            if (first)
+            {
+                noalias(region) = block;
+            }
+            else
+            {
+                auto it = region.template begin<layout_type::row_major>();
+                auto block_end = block.template cend<layout_type::row_major>();
+                for (auto block_it = block.template cbegin<layout_type::row_major>(); block_it != block_end; ++block_it, ++it)
+                {
+                    *it = merge_fct(*it, *block_it);
+                }
+            }
+        }
+
+        // Whether the chunk i of the storage holds data, the storages that
+        // allocate their chunks lazily providing is_materialized
+        template <class CS>
+        inline auto is_materialized_chunk(const CS& chunks, std::size_t i, int) -> decltype(chunks.is_materialized(i))
+        {
+            return chunks.is_materialized(i);
+        }
+
+        template <class CS>
+        inline bool is_materialized_chunk(const CS&, std::size_t, long)
+        {
+            return true;
+        }
+
+        // Reduces each chunk of e contiguously with reduce_immediate, and
+        // merges the results of the chunks reduced into the same region of
+        // result. The chunks are visited in row-major order of the grid,
+        // so that the first chunk of each region has the index 0 along all
+        // the reduced axes. The full chunks that are not materialized all
+        // hold the fill value, which is reduced once.
+        template <class F, class CS, class X, class O, class R>
+        inline void reduce_chunked(const F& f, const xchunked_array<CS>& e, const X& axes, const O& options, R& result)
+        {
+            using size_type = typename xchunked_array<CS>::size_type;
+            using chunk_type = typename xchunked_array<CS>::chunk_type;
+            using block_type = decltype(reduce_immediate(f, std::declval<const chunk_type&>(), axes, options));
+            constexpr bool keep_dims = O::keep_dims::value;
+            auto merge_fct = xt::get<2>(f);
+            block_type fill_block;
+            bool has_fill_block = false;
+            size_type chunk_linear_index = 0;
+
+            std::vector<bool> reduced(e.dimension(), false);
+            for (auto a : axes)
+            {
+                reduced[static_cast<size_type>(a)] = true;
+            }
+
+            xstrided_slice_vector region_slices;
+            auto chunk_end = e.chunk_end();
+            for (auto it = e.chunk_begin(); it != chunk_end; ++it, ++chunk_linear_index)
+            {
+                const auto& chunk_index = it.chunk_index();
+                bool first = true;
+                bool full = true;
+                region_slices.clear();
+                for (size_type i = 0; i < e.dimension(); ++i)
+                {
+                    full = full && (chunk_index[i] + 1) * e.chunk_shape()[i] <= e.shape()[i];
+                    if (!reduced[i])
+                    {
+                        region_slices.push_back(it.get_slice_vector()[i]);
+                    }
+                    else
+                    {
+                        first = first && chunk_index[i] == 0;
+                        if (keep_dims)
+                        {
+                            region_slices.push_back(all());
+                        }
+                    }
+                }
+
+                const auto& chunk = *it;
+                auto region = strided_view(result, region_slices);
+                if (full && !is_materialized_chunk(e.chunks(), chunk_linear_index, 0))
+                {
+                    if (!has_fill_block)
+                    {
+                        fill_block = reduce_immediate(f, chunk, axes, options);
+                        has_fill_block = true;
+                    }
+                    merge_chunk_reduction(fill_block, region, merge_fct, first);
+                }
+                else if (full)
+                {
+                    merge_chunk_reduction(reduce_immediate(f, chunk, axes, options), region, merge_fct, first);
+                }
+                else
+                {
+                    auto block = eval(strided_view(chunk, it.get_chunk_slice_vector()));
+                    merge_chunk_reduction(reduce_immediate(f, block, axes, options), region, merge_fct, first);
+                }
+            }
+        }
+    }
+
+    /**************************
+     * rechunk implementation *
+     **************************/
+
+    namespace detail
+    {
+        // Moves idx to the next multi-index of [first, last) in row-major
+        // order, returns false once all of them have been visited
+        template <class I>
+        inline bool next_grid_index(I& idx, const I& first, const I& last)
+        {
+            for (std::size_t i = idx.size(); i != 0; --i)
+            {
+                if (++idx[i - 1] != last[i - 1])
+                {
+                    return true;
+                }
+                idx[i - 1] = first[i - 1];
+            }
+            return false;
+        }
+
+        // Shape of the blocks copied by rechunk: a multiple of the chunk
+        // shape of the destination, covering the chunks of the source when
+        // they are larger, then halved along the longest axis until it fits
+        // in budget elements
+        template <class S>
+        inline S rechunk_block_shape(const S& shape, const S& src_chunk_shape, const S& dst_chunk_shape, std::size_t budget)
+        {
+            std::size_t dimension = shape.size();
+            S factors(dimension);
+            for (std::size_t i = 0; i < dimension; ++i)
+            {
+                std::size_t dst_extent = dst_chunk_shape[i];
+                std::size_t wanted = (std::min)((std::max)(src_chunk_shape[i], dst_extent), (std::max)(shape[i], std::size_t(1)));
+                factors[i] = (wanted + dst_extent - 1) / dst_extent;
+            }
+
+            auto block_size = [&]() {
+                std::size_t size = 1;
+                for (std::size_t i = 0; i < dimension; ++i)
+                {
+                    size *= factors[i] * dst_chunk_shape[i];
+                }
+                return size;
+            };
+
+            while (block_size() > budget)
+            {
+                auto it = std::max_element(factors.begin(), factors.end());
+                if (it == factors.end() || *it == 1)
+                {
+                    break;
+                }
+                *it = (*it + 1) / 2;
+            }
+
+            S block_shape(dimension);
+            for (std::size_t i = 0; i < dimension; ++i)
+            {
+                block_shape[i] = factors[i] * dst_chunk_shape[i];
+            }
+            return block_shape;
+        }
+
+        // Calls f(chunk, chunk_slices, start, stop) for each chunk of e
+        // intersecting the block [origin, origin + extent), with the slices
+        // of the intersection in the chunk and its bounds [start, stop)
+        // relative to the origin of the block
+        template <class A, class S, class F>
+        inline void for_each_block_chunk(A& e, const S& origin, const S& extent, F&& f)
+        {
+            std::size_t dimension = origin.size();
+            const auto& chunk_shape = e.chunk_shape();
+            S first(dimension), last(dimension);
+            for (std::size_t i = 0; i < dimension; ++i)
+            {
+                first[i] = origin[i] / chunk_shape[i];
+                last[i] = (origin[i] + extent[i] - 1) / chunk_shape[i] + 1;
+            }
+
+            xstrided_slice_vector chunk_slices(dimension);
+            S start(dimension), stop(dimension);
+            S idx = first;
+            do
+            {
+                for (std::size_t i = 0; i < dimension; ++i)
+                {
+                    std::size_t chunk_origin = idx[i] * chunk_shape[i];
+                    std::size_t first_index = (std::max)(origin[i], chunk_origin);
+                    std::size_t last_index = (std::min)(origin[i] + extent[i], chunk_origin + chunk_shape[i]);
+                    chunk_slices[i] = range(first_index - chunk_origin, last_index - chunk_origin);
+                    start[i] = first_index - origin[i];
+                    stop[i] = last_index - origin[i];
+                }
+                f(e.chunks().element(idx.cbegin(), idx.cend()), chunk_slices, start, stop);
+            }
+            while (next_grid_index(idx, first, last));
+        }
+
+        template <class S>
+        inline xstrided_slice_vector block_range_slices(const S& start, const S& stop)
+        {
+            xstrided_slice_vector slices(start.size());
+            for (std::size_t i = 0; i < start.size(); ++i)
+            {
+                slices[i] = range(start[i], stop[i]);
+            }
+            return slices;
+        }
+    }
+
+    template <class CS1, class CS2>
+    inline void rechunk(const xchunked_array<CS1>& src, xchunked_array<CS2>& dst, std::size_t memory_budget)
+    {
+        using value_type = typename xchunked_array<CS2>::value_type;
+        using shape_type = std::vector<std::size_t>;
+
+        std::size_t dimension = src.dimension();
+        if (dimension != dst.dimension() || !std::equal(src.shape().cbegin(), src.shape().cend(), dst.shape().cbegin()))
+        {
+            XTENSOR_THROW(std::runtime_error, "rechunk: source and destination must have the same shape");
+        }
+        if (src.size() == 0)
+        {
+            return;
+        }
+
+        shape_type shape(src.shape().cbegin(), src.shape().cend());
+        shape_type src_chunk_shape(src.chunk_shape().cbegin(), src.chunk_shape().cend());
+        shape_type dst_chunk_shape(dst.chunk_shape().cbegin(), dst.chunk_shape().cend());
+        std::size_t budget = (std::max)(memory_budget / sizeof(value_type), std::size_t(1));
+        shape_type block_shape = detail::rechunk_block_shape(shape, src_chunk_shape, dst_chunk_shape, budget);
+
+        shape_type first(dimension, 0), last(dimension);
+        for (std::size_t i = 0; i < dimension; ++i)
+        {
+            last[i] = (shape[i] + block_shape[i] - 1) / block_shape[i];
+        }
+
+        xarray<value_type> buffer;
+        shape_type origin(dimension), extent(dimension);
+        shape_type idx = first;
+        do
+        {
+            for (std::size_t i = 0; i < dimension; ++i)
+            {
+                origin[i] = idx[i] * block_shape[i];
+                extent[i] = (std::min)(block_shape[i], shape[i] - origin[i]);
+            }
+            buffer.resize(extent);
+
+            detail::for_each_block_chunk(src, origin, extent, [&buffer](const auto& chunk, const auto& chunk_slices, const auto& start, const auto& stop) {
+                noalias(strided_view(buffer, detail::block_range_slices(start, stop))) = strided_view(chunk, chunk_slices);
+            });
+            detail::for_each_block_chunk(dst, origin, extent, [&buffer](auto& chunk, const auto& chunk_slices, const auto& start, const auto& stop) {
+                noalias(strided_view(chunk, chunk_slices)) = strided_view(buffer, detail::block_range_slices(start, stop));
+            });
+        }
+        while (detail::next_grid_index(idx, first, last));
+    }
+
+    template <class CS, class S>
+    inline std::enable_if_t<!detail::is_xchunked_array<std::decay_t<S>>::value, xchunked_array<xarray<xarray<typename xchunked_array<CS>::value_type>>>>
+    rechunk(const xchunked_array<CS>& src, S&& chunk_shape, std::size_t memory_budget)
+    {
+        using value_type = typename xchunked_array<CS>::value_type;
+        using shape_type = typename xchunked_array<CS>::shape_type;
+        shape_type shape = src.shape();
+        auto res = chunked_array<value_type>(std::move(shape), shape_type(chunk_shape.cbegin(), chunk_shape.cend()));
+        rechunk(src, res, memory_budget);
+        return res;
+    }
 }
 
 #endif
@@ -10,6 +10,9 @@
 #ifndef XTENSOR_CHUNKED_ASSIGN_HPP
 #define XTENSOR_CHUNKED_ASSIGN_HPP
 
+#include <xtl/xsequence.hpp>
+
+#include "xexecution.hpp"
 #include "xnoalias.hpp"
 #include "xstrided_view.hpp"
 
@@ -47,6 +50,9 @@ namespace xt
         template <class E>
         derived_type& assign_xexpression(const xexpression<E>& e);
 
+        template <class E, class P>
+        derived_type& assign_xexpression(const xexpression<E>& e, const P& policy);
+
         template <class E>
         derived_type& computed_assign(const xexpression<E>& e);
 
@@ -71,8 +77,38 @@ namespace xt
 
         template <class CS>
         xchunked_assigner<temporary_type, CS> get_assigner(const CS&) const;
+
+        template <class It, class E, class S>
+        static void assign_chunk(const It& it, const E& e, const S& chunk_shape);
+    };
+
+    /**
+     * Tells whether distinct chunks of the chunk storage CS can be accessed
+     * from several threads, so that they can be assigned concurrently. The
+     * storages loading the chunks on access specialize it to false.
+     */
+    template <class CS>
+    struct is_concurrent_chunk_storage : std::true_type
+    {
     };
 
+    namespace detail
+    {
+        // Whether the chunk i of the storage is assigned by the calling
+        // process, the distributed storages providing is_local
+        template <class CS>
+        inline auto is_local_chunk(const CS& chunks, std::size_t i, int) -> decltype(chunks.is_local(i))
+        {
+            return chunks.is_local(i);
+        }
+
+        template <class CS>
+        inline bool is_local_chunk(const CS&, std::size_t, long)
+        {
+            return true;
+        }
+    }
+
     /*******************
      * xchunk_iterator *
      *******************/
@@ -205,24 +241,66 @@ namespace xt
     {
         auto& d = this->derived_cast();
         const auto& chunk_shape = d.chunk_shape();
-        size_t i = 0;
         auto it_end = d.chunk_end();
+        std::size_t i = 0;
         for (auto it = d.chunk_begin(); it != it_end; ++it, ++i)
         {
-            auto rhs = strided_view(e.derived_cast(), it.get_slice_vector());
-            if (rhs.shape() != chunk_shape)
+            if (detail::is_local_chunk(d.chunks(), i, 0))
             {
-                noalias(strided_view(*it, it.get_chunk_slice_vector())) = rhs;
-            }
-            else
-            {
-                noalias(*it) = rhs;
+                assign_chunk(it, e.derived_cast(), chunk_shape);
             }
         }
 
         return this->derived_cast();
     }
 
+    /**
+     * Assigns \c e chunk by chunk, the chunks being distributed according
+     * to \c policy. Each chunk is assigned by a single task, and the chunks
+     * of storages that are not concurrent are assigned sequentially. The
+     * chunks of distributed storages owned by other processes are skipped.
+     * @param e the xexpression to assign, of the shape of the array.
+     * @param policy the execution policy, \c exec::seq or the result of \c exec::par.
+     */
+    template <class D>
+    template <class E, class P>
+    inline auto xchunked_semantic<D>::assign_xexpression(const xexpression<E>& e, const P& policy) -> derived_type&
+    {
+        using chunk_storage_type = typename D::chunk_storage_type;
+        using shape_type = typename D::shape_type;
+        using size_type = typename D::size_type;
+
+        auto& d = this->derived_cast();
+        size_type chunk_size = compute_size(d.chunk_shape());
+        if (!is_concurrent_chunk_storage<chunk_storage_type>::value || chunk_size == 0)
+        {
+            return assign_xexpression(e);
+        }
+        // The policy ranges over the elements of the chunks, so that its
+        // thresholds apply to the size of the data
+        const auto& grid_shape = d.grid_shape();
+        policy.for_range(size_type(0), d.grid_size() * chunk_size, chunk_size, [&](size_type begin, size_type end)
+        {
+            size_type first = begin / chunk_size;
+            size_type last = (end + chunk_size - 1) / chunk_size;
+            shape_type chunk_index = xtl::make_sequence<shape_type>(d.dimension(), size_type(0));
+            for (size_type k = d.dimension(), r = first; k != 0; --k)
+            {
+                chunk_index[k - 1] = r % grid_shape[k - 1];
+                r /= grid_shape[k - 1];
+            }
+            typename D::chunk_iterator it(d, std::move(chunk_index), first);
+            for (size_type i = first; i != last; ++i, ++it)
+            {
+                if (detail::is_local_chunk(d.chunks(), i, 0))
+                {
+                    assign_chunk(it, e.derived_cast(), d.chunk_shape());
+                }
+            }
+        });
+        return d;
+    }
+
     template <class D>
     template <class E>
     inline auto xchunked_semantic<D>::computed_assign(const xexpression<E>& e) -> derived_type&
@@ -243,9 +321,15 @@ namespace xt
     template <class E, class F>
     inline auto xchunked_semantic<D>::scalar_computed_assign(const E& e, F&& f) -> derived_type&
     {
-        for (auto& c: this->derived_cast().chunks())
+        auto& chunks = this->derived_cast().chunks();
+        auto chunk_end = chunks.end();
+        std::size_t i = 0;
+        for (auto it = chunks.begin(); it != chunk_end; ++it, ++i)
         {
-            c.scalar_computed_assign(e, f);
+            if (detail::is_local_chunk(chunks, i, 0))
+            {
+                (*it).scalar_computed_assign(e, f);
+            }
         }
         return this->derived_cast();
     }
@@ -266,6 +350,21 @@ namespace xt
         return xchunked_assigner<temporary_type, CS>();
     }
 
+    template <class D>
+    template <class It, class E, class S>
+    inline void xchunked_semantic<D>::assign_chunk(const It& it, const E& e, const S& chunk_shape)
+    {
+        auto rhs = strided_view(e, it.get_slice_vector());
+        if (rhs.shape() != chunk_shape)
+        {
+            noalias(strided_view(*it, it.get_chunk_slice_vector())) = rhs;
+        }
+        else
+        {
+            noalias(*it) = rhs;
+        }
+    }
+
     /**********************************
      * xchunk_iterator implementation *
      **********************************/
@@ -10,9 +10,13 @@
 #ifndef XTENSOR_CHUNKED_VIEW_HPP
 #define XTENSOR_CHUNKED_VIEW_HPP
 
+#include <algorithm>
+#include <cstddef>
+
 #include <xtl/xsequence.hpp>
 
 #include "xnoalias.hpp"
+#include "xpad.hpp"
 #include "xstorage.hpp"
 #include "xstrided_view.hpp"
 #include "xchunked_array.hpp"
@@ -93,6 +97,29 @@ namespace xt
     template <class E, class S>
     xchunked_view<E> as_chunked(E&& e, S&& chunk_shape);
 
+    template <class E, class S, class F>
+    void for_each_chunk(E&& e, S&& chunk_shape, F&& f);
+
+    template <class E, class S, class F, class P>
+    void for_each_chunk(E&& e, S&& chunk_shape, F&& f, const P& policy);
+
+    template <class E, class F>
+    void parallel_for_blocks(E&& e, std::ptrdiff_t axis, std::size_t grain, F&& f);
+
+    template <class E, class F, class P>
+    void parallel_for_blocks(E&& e, std::ptrdiff_t axis, std::size_t grain, F&& f, const P& policy);
+
+    template <class CS, class F>
+    void for_each_chunk_with_halo(const xchunked_array<CS>& e, std::size_t halo, F&& f,
+                                  pad_mode mode = pad_mode::constant,
+                                  typename xchunked_array<CS>::value_type constant_value = 0);
+
+    template <class CS, class F, class P>
+    std::enable_if_t<is_execution_policy<P>::value>
+    for_each_chunk_with_halo(const xchunked_array<CS>& e, std::size_t halo, F&& f, const P& policy,
+                             pad_mode mode = pad_mode::constant,
+                             typename xchunked_array<CS>::value_type constant_value = 0);
+
     /********************************
      * xchunked_view implementation *
      ********************************/
@@ -276,6 +303,396 @@ namespace xt
     {
         return xchunked_view<E>(std::forward<E>(e));
     }
+
+    namespace detail
+    {
+        // Whether distinct chunks of a view on e can be accessed from
+        // different threads
+        template <class E>
+        struct is_concurrent_chunked_view_expression : std::true_type
+        {
+        };
+
+        template <class CS>
+        struct is_concurrent_chunked_view_expression<xchunked_array<CS>>
+            : is_concurrent_chunk_storage<CS>
+        {
+        };
+    }
+
+    /**
+     * Calls \c f on each chunk of the grid of shape \c chunk_shape laid over
+     * \c e, in row-major order of the grid. \c f is called as
+     * ``f(chunk, chunk_index)``, where \c chunk is a strided view on the
+     * region of \c e covered by the chunk (smaller than \c chunk_shape for
+     * the chunks at the end of the array) and \c chunk_index its position in
+     * the grid. When \c e is a container, the chunk shares its buffer:
+     * ``chunk.data() + chunk.data_offset()`` points to its first element and
+     * ``chunk.strides()`` gives its strides.
+     * @param e the expression to split in chunks.
+     * @param chunk_shape the shape of the chunks.
+     * @param f the function to call on each chunk.
+     */
+    template <class E, class S, class F>
+    inline void for_each_chunk(E&& e, S&& chunk_shape, F&& f)
+    {
+        for_each_chunk(std::forward<E>(e), std::forward<S>(chunk_shape), std::forward<F>(f), exec::seq);
+    }
+
+    /**
+     * Calls \c f on each chunk of the grid of shape \c chunk_shape laid over
+     * \c e, the chunks being distributed according to \c policy. Each chunk
+     * is processed by a single task, so that \c f may write to it without
+     * synchronization. The chunks of xchunked_array with a storage that is
+     * not concurrent are processed sequentially.
+     * @param e the expression to split in chunks.
+     * @param chunk_shape the shape of the chunks.
+     * @param f the function to call on each chunk, as ``f(chunk, chunk_index)``.
+     * @param policy the execution policy, \c exec::seq or the result of \c exec::par.
+     */
+    template <class E, class S, class F, class P>
+    inline void for_each_chunk(E&& e, S&& chunk_shape, F&& f, const P& policy)
+    {
+        using view_type = xchunked_view<E>;
+        using size_type = typename view_type::size_type;
+        using shape_type = typename view_type::shape_type;
+
+        view_type view(std::forward<E>(e), std::forward<S>(chunk_shape));
+        size_type chunk_size = compute_size(view.chunk_shape());
+        if (!detail::is_concurrent_chunked_view_expression<std::decay_t<E>>::value || chunk_size == 0)
+        {
+            auto end = view.chunk_end();
+            for (auto it = view.chunk_begin(); it != end; ++it)
+            {
+                auto chunk = *it;
+                f(chunk, it.chunk_index());
+            }
+            return;
+        }
+        // As for the assignment of chunked arrays, the policy ranges over
+        // the elements of the chunks
+        const auto& grid_shape = view.grid_shape();
+        policy.for_range(size_type(0), view.grid_size() * chunk_size, chunk_size, [&](size_type begin, size_type end)
+        {
+            size_type first = begin / chunk_size;
+            size_type last = (end + chunk_size - 1) / chunk_size;
+            shape_type chunk_index(view.dimension(), size_type(0));
+            for (size_type k = view.dimension(), r = first; k != 0; --k)
+            {
+                chunk_index[k - 1] = r % grid_shape[k - 1];
+                r /= grid_shape[k - 1];
+            }
+            typename view_type::chunk_iterator it(view, std::move(chunk_index), first);
+            for (size_type i = first; i != last; ++i, ++it)
+            {
+                auto chunk = *it;
+                f(chunk, it.chunk_index());
+            }
+        });
+    }
+    /**
+     * Splits \c e along \c axis into blocks of \c grain consecutive slices,
+     * the last one being possibly shorter, and calls \c f on each block
+     * from the workers of the default thread pool.
+     * @sa parallel_for_blocks(E&&, std::ptrdiff_t, std::size_t, F&&, const P&)
+     */
+    template <class E, class F>
+    inline void parallel_for_blocks(E&& e, std::ptrdiff_t axis, std::size_t grain, F&& f)
+    {
+        parallel_for_blocks(std::forward<E>(e), axis, grain, std::forward<F>(f), exec::par());
+    }
+
+    /**
+     * Splits \c e along \c axis into blocks of \c grain consecutive slices
+     * and calls \c f on each block, the blocks being distributed according
+     * to \c policy. The blocks are strided views sharing the buffer of
+     * \c e, built from its shape and strides computed once, and do not
+     * overlap: \c f may write to its block without synchronization, as long
+     * as no other thread resizes or reads \c e meanwhile.
+     *
+     * \code{.cpp}
+     * xt::parallel_for_blocks(out, 0, 64, [&](auto& block, std::size_t first, std::size_t last)
+     * {
+     *     xt::noalias(block).assign(xt::view(a, xt::range(first, last)) * 2., xt::exec::seq);
+     * });
+     * \endcode
+     *
+     * @param e an expression with a data interface, e.g. a container.
+     * @param axis the axis along which \c e is split.
+     * @param grain the number of slices of the blocks, 0 meaning 1.
+     * @param f the function to call on each block, as
+     *        ``f(block, first, last)`` where [first, last) is the range of
+     *        the block along \c axis.
+     * @param policy the execution policy, \c exec::seq or the result of \c exec::par.
+     */
+    template <class E, class F, class P>
+    inline void parallel_for_blocks(E&& e, std::ptrdiff_t axis, std::size_t grain, F&& f, const P& policy)
+    {
+        static_assert(has_data_interface<std::decay_t<E>>::value, "parallel_for_blocks requires an expression with a data interface");
+        using shape_type = dynamic_shape<std::size_t>;
+        using strides_type = dynamic_shape<std::ptrdiff_t>;
+
+        std::size_t dim = e.dimension();
+        std::size_t ax = normalize_axis(dim, axis);
+        grain = std::max(grain, std::size_t(1));
+        const shape_type shape(e.shape().cbegin(), e.shape().cend());
+        const strides_type strides(e.strides().cbegin(), e.strides().cend());
+        const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(e.data_offset());
+        // Blocks along the outer axis of a contiguous layout are contiguous
+        bool keep_layout = (e.layout() == layout_type::row_major && ax == 0)
+                           || (e.layout() == layout_type::column_major && ax + 1 == dim);
+        layout_type block_layout = keep_layout ? e.layout() : layout_type::dynamic;
+
+        policy.for_range(std::size_t(0), shape[ax], grain, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t first = begin; first < end; first += grain)
+            {
+                std::size_t last = std::min(first + grain, end);
+                shape_type block_shape = shape;
+                block_shape[ax] = last - first;
+                std::size_t block_offset = static_cast<std::size_t>(offset + static_cast<std::ptrdiff_t>(first) * strides[ax]);
+                auto block = strided_view(e, std::move(block_shape), strides, block_offset, block_layout);
+                f(block, first, last);
+            }
+        });
+    }
+
+    namespace detail
+    {
+        // Elements of the block of a chunk with its halo along one axis,
+        // copied from consecutive elements of the array, possibly in
+        // reverse order, or set to the constant value of the padding
+        struct xhalo_run
+        {
+            std::size_t src_first;
+            std::size_t block_first;
+            std::size_t size;
+            bool reversed;
+            bool constant;
+        };
+
+        // Splits the block [origin - halo, origin + extent + halo) of an
+        // axis of length n into the runs of the padding before the array,
+        // of the array and of the padding after the array, following the
+        // conventions of pad
+        inline std::vector<xhalo_run> halo_runs(std::size_t origin, std::size_t extent, std::size_t n,
+                                                std::size_t halo, pad_mode mode)
+        {
+            std::vector<xhalo_run> runs;
+            std::size_t nb = halo > origin ? halo - origin : 0;
+            std::size_t stop = origin + extent + halo;
+            std::size_t ne = stop > n ? stop - n : 0;
+            std::size_t src_first = origin + nb - halo;
+
+            if (nb != 0)
+            {
+                switch (mode)
+                {
+                case pad_mode::constant:
+                    runs.push_back({0, 0, nb, false, true});
+                    break;
+                case pad_mode::symmetric:
+                    runs.push_back({0, 0, nb, true, false});
+                    break;
+                case pad_mode::reflect:
+                    runs.push_back({1, 0, nb, true, false});
+                    break;
+                case pad_mode::wrap:
+                case pad_mode::periodic:
+                    runs.push_back({n - nb, 0, nb, false, false});
+                    break;
+                }
+            }
+
+            runs.push_back({src_first, nb, stop - ne - src_first, false, false});
+
+            if (ne != 0)
+            {
+                std::size_t block_first = extent + 2 * halo - ne;
+                switch (mode)
+                {
+                case pad_mode::constant:
+                    runs.push_back({0, block_first, ne, false, true});
+                    break;
+                case pad_mode::symmetric:
+                    runs.push_back({n - ne, block_first, ne, true, false});
+                    break;
+                case pad_mode::reflect:
+                    runs.push_back({n - 1 - ne, block_first, ne, true, false});
+                    break;
+                case pad_mode::wrap:
+                case pad_mode::periodic:
+                    runs.push_back({0, block_first, ne, false, false});
+                    break;
+                }
+            }
+            return runs;
+        }
+
+        // Fills block with the runs of each axis, the product of the runs
+        // being copied from the intersecting chunks of e
+        template <class CS, class B, class V>
+        inline void assemble_halo_block(const xchunked_array<CS>& e, const std::vector<std::vector<xhalo_run>>& runs,
+                                        B& block, const V& constant_value)
+        {
+            using shape_type = std::vector<std::size_t>;
+            std::size_t dimension = runs.size();
+            shape_type first(dimension, 0), last(dimension), idx(dimension, 0);
+            shape_type origin(dimension), extent(dimension);
+            xstrided_slice_vector block_slices(dimension);
+            for (std::size_t i = 0; i < dimension; ++i)
+            {
+                last[i] = runs[i].size();
+            }
+
+            do
+            {
+                bool constant = false;
+                for (std::size_t i = 0; i < dimension; ++i)
+                {
+                    const xhalo_run& run = runs[i][idx[i]];
+                    constant = constant || run.constant;
+                    origin[i] = run.src_first;
+                    extent[i] = run.size;
+                    block_slices[i] = range(run.block_first, run.block_first + run.size);
+                }
+
+                if (constant)
+                {
+                    strided_view(block, block_slices) = constant_value;
+                    continue;
+                }
+
+                for_each_block_chunk(e, origin, extent, [&](const auto& chunk, const auto& chunk_slices, const auto& start, const auto& stop) {
+                    for (std::size_t i = 0; i < dimension; ++i)
+                    {
+                        const xhalo_run& run = runs[i][idx[i]];
+                        if (!run.reversed)
+                        {
+                            block_slices[i] = range(run.block_first + start[i], run.block_first + stop[i]);
+                        }
+                        else
+                        {
+                            // The element start of the run goes to the last
+                            // element of its place in the block
+                            std::size_t block_last = run.block_first + run.size;
+                            if (block_last == stop[i])
+                            {
+                                block_slices[i] = range(block_last - 1 - start[i], _, -1);
+                            }
+                            else
+                            {
+                                block_slices[i] = range(block_last - 1 - start[i], block_last - 1 - stop[i], -1);
+                            }
+                        }
+                    }
+                    noalias(strided_view(block, block_slices)) = strided_view(chunk, chunk_slices);
+                });
+            }
+            while (next_grid_index(idx, first, last));
+        }
+    }
+
+    /**
+     * Calls \c f on each chunk of \c e extended by \c halo elements on
+     * each side along all the axes, in row-major order of the chunk grid.
+     * The chunk and its halo are gathered from the neighbouring chunks into
+     * a contiguous row-major buffer, reused from one chunk to the next, and
+     * \c f is called as ``f(block, chunk_index)``. The halo crossing the
+     * edges of the array is filled according to \c mode, as for pad. The
+     * shape of the block is the shape of the chunk, smaller at the end of
+     * the array, plus \c 2 * \c halo.
+     * @param e the chunked array.
+     * @param halo the number of elements added on each side of the chunks.
+     * @param f the function to call on each block.
+     * @param mode the padding of the halo at the edges of the array.
+     * @param constant_value the value of the padding with \c pad_mode::constant.
+     */
+    template <class CS, class F>
+    inline void for_each_chunk_with_halo(const xchunked_array<CS>& e, std::size_t halo, F&& f,
+                                         pad_mode mode, typename xchunked_array<CS>::value_type constant_value)
+    {
+        for_each_chunk_with_halo(e, halo, std::forward<F>(f), exec::seq, mode, constant_value);
+    }
+
+    /**
+     * Calls \c f on each chunk of \c e extended by \c halo elements, the
+     * chunks being distributed according to \c policy. Each task gathers
+     * its chunks into its own buffer. The chunks of storages that are not
+     * concurrent are processed sequentially.
+     * @param e the chunked array.
+     * @param halo the number of elements added on each side of the chunks.
+     * @param f the function to call on each block, as ``f(block, chunk_index)``.
+     * @param policy the execution policy, \c exec::seq or the result of \c exec::par.
+     * @param mode the padding of the halo at the edges of the array.
+     * @param constant_value the value of the padding with \c pad_mode::constant.
+     */
+    template <class CS, class F, class P>
+    inline std::enable_if_t<is_execution_policy<P>::value>
+    for_each_chunk_with_halo(const xchunked_array<CS>& e, std::size_t halo, F&& f, const P& policy,
+                             pad_mode mode, typename xchunked_array<CS>::value_type constant_value)
+    {
+        using value_type = typename xchunked_array<CS>::value_type;
+        using shape_type = std::vector<std::size_t>;
+
+        std::size_t dimension = e.dimension();
+        shape_type shape(e.shape().cbegin(), e.shape().cend());
+        shape_type chunk_shape(e.chunk_shape().cbegin(), e.chunk_shape().cend());
+        shape_type grid_shape(e.grid_shape().cbegin(), e.grid_shape().cend());
+        if (e.size() == 0)
+        {
+            return;
+        }
+        if (mode != pad_mode::constant)
+        {
+            for (std::size_t n : shape)
+            {
+                if (halo > (mode == pad_mode::reflect ? n - 1 : n))
+                {
+                    XTENSOR_THROW(std::runtime_error, "for_each_chunk_with_halo: halo larger than the array for this pad mode");
+                }
+            }
+        }
+
+        auto process = [&](std::size_t first, std::size_t last)
+        {
+            shape_type chunk_index(dimension), zero(dimension, 0), block_shape(dimension);
+            for (std::size_t k = dimension, r = first; k != 0; --k)
+            {
+                chunk_index[k - 1] = r % grid_shape[k - 1];
+                r /= grid_shape[k - 1];
+            }
+            std::vector<std::vector<detail::xhalo_run>> runs(dimension);
+            xarray<value_type> block;
+            for (std::size_t i = first; i != last; ++i)
+            {
+                for (std::size_t k = 0; k < dimension; ++k)
+                {
+                    std::size_t origin = chunk_index[k] * chunk_shape[k];
+                    std::size_t extent = (std::min)(chunk_shape[k], shape[k] - origin);
+                    runs[k] = detail::halo_runs(origin, extent, shape[k], halo, mode);
+                    block_shape[k] = extent + 2 * halo;
+                }
+                block.resize(block_shape);
+                detail::assemble_halo_block(e, runs, block, constant_value);
+                f(block, static_cast<const shape_type&>(chunk_index));
+                detail::next_grid_index(chunk_index, zero, grid_shape);
+            }
+        };
+
+        if (!is_concurrent_chunk_storage<CS>::value)
+        {
+            process(0, e.grid_size());
+            return;
+        }
+        // As for the assignment of chunked arrays, the policy ranges over
+        // the elements of the chunks
+        std::size_t chunk_size = compute_size(chunk_shape);
+        policy.for_range(std::size_t(0), e.grid_size() * chunk_size, chunk_size, [&](std::size_t begin, std::size_t end)
+        {
+            process(begin / chunk_size, (end + chunk_size - 1) / chunk_size);
+        });
+    }
 }
 
 #endif
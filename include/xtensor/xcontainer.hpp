@@ -282,6 +282,10 @@ namespace xt
         void resize(S&& shape, layout_type l);
         template <class S = shape_type>
         void resize(S&& shape, const strides_type& strides);
+        template <class S = shape_type>
+        void resize(S&& shape, uninitialized_t, bool force = false);
+        template <class S = shape_type>
+        void resize(S&& shape, layout_type l, uninitialized_t);
 
         template <class S = shape_type>
         auto& reshape(S&& shape, layout_type layout = base_type::static_layout) &;
@@ -324,6 +328,9 @@ namespace xt
 
     private:
 
+        template <class S>
+        void resize_impl(S&& shape, bool force, bool initialize);
+
         inner_shape_type m_shape;
         inner_strides_type m_strides;
         inner_backstrides_type m_backstrides;
@@ -928,6 +935,18 @@ namespace xt
             XTENSOR_ASSERT_MSG(c.size() == size, "Trying to resize const data container with wrong size.");
         }
 
+        template <class C, class S>
+        inline void resize_data_container(C& c, S size, uninitialized_t)
+        {
+            xt::resize_container(c, size, uninitialized);
+        }
+
+        template <class C, class S>
+        inline void resize_data_container(const C& c, S size, uninitialized_t)
+        {
+            resize_data_container(c, size);
+        }
+
         template <class S, class T>
         constexpr bool check_resize_dimension(const S&, const T&)
         {
@@ -951,27 +970,50 @@ namespace xt
     template <class D>
     template <class S>
     inline void xstrided_container<D>::resize(S&& shape, bool force)
+    {
+        resize_impl(std::forward<S>(shape), force, true);
+    }
+
+    /**
+     * Resizes the container.
+     * @warning Contrary to STL containers like std::vector, resize
+     * does NOT preserve the container elements.
+     * @param shape the new shape
+     * @param l the new layout_type
+     */
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize(S&& shape, layout_type l)
     {
         XTENSOR_ASSERT_MSG(detail::check_resize_dimension(m_shape, shape),
                            "cannot change the number of dimensions of xtensor")
-        std::size_t dim = shape.size();
-        if (m_shape.size() != dim || !std::equal(std::begin(shape), std::end(shape), std::begin(m_shape)) || force)
+        if (base_type::static_layout != layout_type::dynamic && l != base_type::static_layout)
         {
-            if (D::static_layout == layout_type::dynamic && m_layout == layout_type::dynamic)
-            {
-                m_layout = XTENSOR_DEFAULT_LAYOUT;  // fall back to default layout
-            }
-            m_shape = xtl::forward_sequence<shape_type, S>(shape);
-
-            resize_container(m_strides, dim);
-            resize_container(m_backstrides, dim);
-            size_type data_size = compute_strides<D::static_layout>(m_shape, m_layout, m_strides, m_backstrides);
-            detail::resize_data_container(this->storage(), data_size);
+            XTENSOR_THROW(std::runtime_error, "Cannot change layout_type if template parameter not layout_type::dynamic.");
         }
+        m_layout = l;
+        resize(std::forward<S>(shape), true);
     }
 
     /**
-     * Resizes the container.
+     * Resizes the container without value-initializing the elements of the
+     * new buffer. If the underlying storage supports it (as uvector does),
+     * the buffer is not written for trivially default constructible types.
+     * @warning Contrary to STL containers like std::vector, resize
+     * does NOT preserve the container elements.
+     * @param shape the new shape
+     * @param force force reshaping, even if the shape stays the same (default: false)
+     */
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize(S&& shape, uninitialized_t, bool force)
+    {
+        resize_impl(std::forward<S>(shape), force, false);
+    }
+
+    /**
+     * Resizes the container without value-initializing the elements of the
+     * new buffer.
      * @warning Contrary to STL containers like std::vector, resize
      * does NOT preserve the container elements.
      * @param shape the new shape
@@ -979,7 +1021,7 @@ namespace xt
      */
     template <class D>
     template <class S>
-    inline void xstrided_container<D>::resize(S&& shape, layout_type l)
+    inline void xstrided_container<D>::resize(S&& shape, layout_type l, uninitialized_t)
     {
         XTENSOR_ASSERT_MSG(detail::check_resize_dimension(m_shape, shape),
                            "cannot change the number of dimensions of xtensor")
@@ -988,7 +1030,7 @@ namespace xt
             XTENSOR_THROW(std::runtime_error, "Cannot change layout_type if template parameter not layout_type::dynamic.");
         }
         m_layout = l;
-        resize(std::forward<S>(shape), true);
+        resize_impl(std::forward<S>(shape), true, false);
     }
 
     /**
@@ -1116,6 +1158,35 @@ namespace xt
     {
         return m_layout;
     }
+
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize_impl(S&& shape, bool force, bool initialize)
+    {
+        XTENSOR_ASSERT_MSG(detail::check_resize_dimension(m_shape, shape),
+                           "cannot change the number of dimensions of xtensor")
+        std::size_t dim = shape.size();
+        if (m_shape.size() != dim || !std::equal(std::begin(shape), std::end(shape), std::begin(m_shape)) || force)
+        {
+            if (D::static_layout == layout_type::dynamic && m_layout == layout_type::dynamic)
+            {
+                m_layout = XTENSOR_DEFAULT_LAYOUT;  // fall back to default layout
+            }
+            m_shape = xtl::forward_sequence<shape_type, S>(shape);
+
+            resize_container(m_strides, dim);
+            resize_container(m_backstrides, dim);
+            size_type data_size = compute_strides<D::static_layout>(m_shape, m_layout, m_strides, m_backstrides);
+            if (initialize)
+            {
+                detail::resize_data_container(this->storage(), data_size);
+            }
+            else
+            {
+                detail::resize_data_container(this->storage(), data_size, uninitialized);
+            }
+        }
+    }
 }
 
 #endif
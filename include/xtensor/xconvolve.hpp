@@ -0,0 +1,242 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CONVOLVE_HPP
+#define XTENSOR_CONVOLVE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xbuilder.hpp"
+#include "xexecution.hpp"
+#include "xmath.hpp"
+#include "xpad.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+    /************************************
+     * N-dimensional convolve/correlate *
+     ************************************/
+
+    namespace detail
+    {
+        // Number of outputs of a line computed for all the rows of the
+        // kernel before moving to the next ones, so that the rows of the
+        // input they read stay in cache.
+        constexpr std::size_t correlate_nd_tile = 512;
+
+        template <class S>
+        inline std::vector<std::vector<std::size_t>> correlate_nd_pad_width(const S& kernel_shape, convolve_mode::valid)
+        {
+            return std::vector<std::vector<std::size_t>>(kernel_shape.size(), std::vector<std::size_t>{0, 0});
+        }
+
+        template <class S>
+        inline std::vector<std::vector<std::size_t>> correlate_nd_pad_width(const S& kernel_shape, convolve_mode::same)
+        {
+            std::vector<std::vector<std::size_t>> res;
+            for (auto k : kernel_shape)
+            {
+                res.push_back({static_cast<std::size_t>(k) / 2, (static_cast<std::size_t>(k) - 1) / 2});
+            }
+            return res;
+        }
+
+        template <class S>
+        inline std::vector<std::vector<std::size_t>> correlate_nd_pad_width(const S& kernel_shape, convolve_mode::full)
+        {
+            std::vector<std::vector<std::size_t>> res;
+            for (auto k : kernel_shape)
+            {
+                res.push_back({static_cast<std::size_t>(k) - 1, static_cast<std::size_t>(k) - 1});
+            }
+            return res;
+        }
+
+        // Correlates the row-major array in with the row-major kernel k into
+        // out, whose shape is the shape of in minus the shape of k plus one.
+        // Each line of out is the sum of the 1D correlations of the rows of
+        // k with the rows of in below it; the lines are split among the
+        // threads of the policy.
+        template <class T, class S, class P>
+        inline void correlate_nd_impl(const T* in, const S& in_shape, const T* k, const S& k_shape,
+                                      T* out, const S& out_shape, const P& policy)
+        {
+            const std::size_t dim = in_shape.size();
+            const std::size_t line_size = out_shape[dim - 1];
+            const std::size_t kernel_width = k_shape[dim - 1];
+
+            std::vector<std::size_t> in_strides(dim);
+            std::size_t stride = 1;
+            for (std::size_t d = dim; d-- > 0;)
+            {
+                in_strides[d] = stride;
+                stride *= in_shape[d];
+            }
+
+            // Offsets in the input of the rows of the kernel
+            std::size_t kernel_rows = 1;
+            std::size_t lines = 1;
+            for (std::size_t d = 0; d + 1 < dim; ++d)
+            {
+                kernel_rows *= k_shape[d];
+                lines *= out_shape[d];
+            }
+            std::vector<std::size_t> row_offsets(kernel_rows);
+            for (std::size_t r = 0; r < kernel_rows; ++r)
+            {
+                std::size_t rem = r;
+                std::size_t offset = 0;
+                for (std::size_t d = dim - 1; d-- > 0;)
+                {
+                    offset += (rem % k_shape[d]) * in_strides[d];
+                    rem /= k_shape[d];
+                }
+                row_offsets[r] = offset;
+            }
+
+            policy.for_range(0, lines, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t l = first; l < last; ++l)
+                {
+                    std::size_t rem = l;
+                    std::size_t base = 0;
+                    for (std::size_t d = dim - 1; d-- > 0;)
+                    {
+                        base += (rem % out_shape[d]) * in_strides[d];
+                        rem /= out_shape[d];
+                    }
+                    T* out_line = out + l * line_size;
+                    for (std::size_t x = 0; x < line_size; x += correlate_nd_tile)
+                    {
+                        std::size_t n = (std::min)(correlate_nd_tile, line_size - x);
+                        for (std::size_t r = 0; r < kernel_rows; ++r)
+                        {
+                            convolve_direct(in + base + row_offsets[r] + x, k + r * kernel_width, kernel_width, out_line + x, n);
+                        }
+                    }
+                }
+            });
+        }
+
+        template <bool Flip, class E1, class E2, class M, class P>
+        inline auto correlate_nd(const xexpression<E1>& e, const xexpression<E2>& kernel, M mode, pad_mode pmode, const P& policy)
+        {
+            using value_type = typename E1::value_type;
+            using array_type = xarray<value_type, layout_type::row_major>;
+            using shape_type = typename array_type::shape_type;
+
+            const E1& de = e.derived_cast();
+            const E2& dk = kernel.derived_cast();
+            if (de.dimension() != dk.dimension() || de.dimension() == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "convolve_nd: the expression and the kernel must have the same non-zero dimension");
+            }
+
+            array_type k = dk;
+            if (Flip)
+            {
+                std::reverse(k.begin(), k.end());
+            }
+            shape_type k_shape(k.shape().cbegin(), k.shape().cend());
+            if (std::find(k_shape.cbegin(), k_shape.cend(), std::size_t(0)) != k_shape.cend())
+            {
+                XTENSOR_THROW(std::runtime_error, "convolve_nd: the kernel must not be empty");
+            }
+
+            std::vector<std::vector<std::size_t>> pad_width = correlate_nd_pad_width(k_shape, mode);
+            bool padded = std::any_of(pad_width.cbegin(), pad_width.cend(), [](const std::vector<std::size_t>& w)
+            {
+                return w[0] != 0 || w[1] != 0;
+            });
+            array_type in = padded ? array_type(pad(de, pad_width, pmode, value_type(0))) : array_type(de);
+
+            shape_type in_shape(in.shape().cbegin(), in.shape().cend());
+            shape_type out_shape(in_shape);
+            for (std::size_t d = 0; d < in_shape.size(); ++d)
+            {
+                if (in_shape[d] < k_shape[d])
+                {
+                    XTENSOR_THROW(std::runtime_error, "convolve_nd: the kernel is larger than the padded expression");
+                }
+                out_shape[d] = in_shape[d] - k_shape[d] + 1;
+            }
+            array_type out = zeros<value_type>(out_shape);
+            correlate_nd_impl(in.data(), in_shape, k.data(), k_shape, out.data(), out_shape, policy);
+            return out;
+        }
+    }
+
+    /**
+     * @brief Computes the N-dimensional convolution of an expression with a
+     * kernel of the same dimension.
+     *
+     * With convolve_mode::same and convolve_mode::full, the borders of the
+     * expression are extended according to \c pmode, as xt::pad does, the
+     * constant mode padding with zeros. The result is a row-major xarray
+     * whose shape is, along each axis, that of the expression minus the
+     * kernel plus one (valid), that of the expression (same) or their sum
+     * minus one (full), as scipy.signal.convolve.
+     *
+     * @param e the expression to convolve
+     * @param kernel the kernel
+     * @param mode placeholder selecting the size of the result #convolve_mode
+     * @param pmode the padding mode at the borders
+     * @param policy the execution policy splitting the lines of the result
+     */
+    template <class E1, class E2, class M, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto convolve_nd(const xexpression<E1>& e, const xexpression<E2>& kernel, M mode, pad_mode pmode, const P& policy)
+    {
+        return detail::correlate_nd<true>(e, kernel, mode, pmode, policy);
+    }
+
+    /**
+     * @brief Computes the N-dimensional convolution of an expression with a
+     * kernel of the same dimension, on the calling thread.
+     *
+     * @sa convolve_nd(const xexpression<E1>&, const xexpression<E2>&, M, pad_mode, const P&)
+     */
+    template <class E1, class E2, class M>
+    inline auto convolve_nd(const xexpression<E1>& e, const xexpression<E2>& kernel, M mode, pad_mode pmode = pad_mode::constant)
+    {
+        return detail::correlate_nd<true>(e, kernel, mode, pmode, exec::default_policy());
+    }
+
+    /**
+     * @brief Computes the N-dimensional cross-correlation of an expression
+     * with a kernel of the same dimension.
+     *
+     * This is convolve_nd with the kernel flipped along all its axes; the
+     * kernel is not conjugated.
+     *
+     * @sa convolve_nd(const xexpression<E1>&, const xexpression<E2>&, M, pad_mode, const P&)
+     */
+    template <class E1, class E2, class M, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto correlate_nd(const xexpression<E1>& e, const xexpression<E2>& kernel, M mode, pad_mode pmode, const P& policy)
+    {
+        return detail::correlate_nd<false>(e, kernel, mode, pmode, policy);
+    }
+
+    /**
+     * @brief Computes the N-dimensional cross-correlation of an expression
+     * with a kernel of the same dimension, on the calling thread.
+     *
+     * @sa correlate_nd(const xexpression<E1>&, const xexpression<E2>&, M, pad_mode, const P&)
+     */
+    template <class E1, class E2, class M>
+    inline auto correlate_nd(const xexpression<E1>& e, const xexpression<E2>& kernel, M mode, pad_mode pmode = pad_mode::constant)
+    {
+        return detail::correlate_nd<false>(e, kernel, mode, pmode, exec::default_policy());
+    }
+}
+
+#endif
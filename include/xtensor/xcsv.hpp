@@ -10,13 +10,37 @@
 #ifndef XTENSOR_CSV_HPP
 #define XTENSOR_CSV_HPP
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <fstream>
 #include <istream>
 #include <iterator>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+// std::from_chars and std::to_chars are used for the integers with
+// <charconv>, and for the floating point numbers with __cpp_lib_to_chars
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#define XTENSOR_CSV_HAS_FROM_CHARS
+#if defined(__cpp_lib_to_chars)
+#define XTENSOR_CSV_HAS_FLOAT_FROM_CHARS
+#endif
+#endif
+#endif
+
+#include "xeval.hpp"
+#include "xexecution.hpp"
 #include "xtensor.hpp"
 #include "xtensor_config.hpp"
 
@@ -33,9 +57,18 @@ namespace xt
     template <class T, class A = std::allocator<T>>
     xcsv_tensor<T, A> load_csv(std::istream& stream, const char delimiter = ',', const std::size_t skip_rows = 0, const std::ptrdiff_t max_rows = -1, const std::string comments = "#");
 
+    template <class T, class A = std::allocator<T>, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    xcsv_tensor<T, A> load_csv(std::istream& stream, const char delimiter, const std::size_t skip_rows, const std::ptrdiff_t max_rows, const std::string comments, const P& policy);
+
+    template <class T, class A = std::allocator<T>, class P = exec::default_policy, class = std::enable_if_t<is_execution_policy<P>::value>>
+    xcsv_tensor<T, A> load_csv(const std::string& filename, const char delimiter = ',', const std::size_t skip_rows = 0, const std::ptrdiff_t max_rows = -1, const std::string comments = "#", const P& policy = P());
+
     template <class E>
     void dump_csv(std::ostream& stream, const xexpression<E>& e);
 
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    void dump_csv(std::ostream& stream, const xexpression<E>& e, const P& policy);
+
     /*****************************************
      * load_csv and dump_csv implementations *
      *****************************************/
@@ -62,50 +95,634 @@ namespace xt
             return cell.substr(first, last==std::string::npos?cell.size():last+1);
         }
 
-        template <>
-        inline float lexical_cast<float>(const std::string& cell) { return std::stof(cell); }
+        /**************
+         * csv_stream *
+         **************/
 
-        template <>
-        inline double lexical_cast<double>(const std::string& cell) { return std::stod(cell); }
+        // Reads the lines of a CSV stream by blocks, so that their cells are
+        // parsed in place. A line ends with an end of line outside of the
+        // quoted fields.
+        constexpr std::size_t csv_block_size = std::size_t(1) << 20;
 
-        template <>
-        inline long double lexical_cast<long double>(const std::string& cell) { return std::stold(cell); }
+        class csv_stream
+        {
+        public:
 
-        template <>
-        inline int lexical_cast<int>(const std::string& cell) { return std::stoi(cell); }
+            explicit csv_stream(std::istream& stream, std::size_t block_size = csv_block_size);
 
-        template <>
-        inline long lexical_cast<long>(const std::string& cell) { return std::stol(cell); }
+            bool next_line(const char*& first, const char*& last);
+            bool next_block(const char*& first, const char*& last, bool& quoted);
+            std::size_t remaining_size() const noexcept;
 
-        template <>
-        inline long long lexical_cast<long long>(const std::string& cell) { return std::stoll(cell); }
+        private:
 
-        template <>
-        inline unsigned int lexical_cast<unsigned int>(const std::string& cell) { return static_cast<unsigned int>(std::stoul(cell)); }
+            void fill();
 
-        template <>
-        inline unsigned long lexical_cast<unsigned long>(const std::string& cell) { return std::stoul(cell); }
+            std::istream& m_stream;
+            std::size_t m_block_size;
+            std::vector<char> m_buffer;
+            std::size_t m_pos;
+            std::size_t m_size;
+            std::size_t m_remaining;
+            bool m_eof;
+        };
 
-        template <>
-        inline unsigned long long lexical_cast<unsigned long long>(const std::string& cell) { return std::stoull(cell); }
+        inline csv_stream::csv_stream(std::istream& stream, std::size_t block_size)
+            : m_stream(stream), m_block_size(block_size), m_buffer(block_size + 1, '\0'), m_pos(0), m_size(0), m_remaining(0), m_eof(false)
+        {
+            // The size of a seekable stream gives an estimate of the number
+            // of rows before reading them
+            std::istream::pos_type start = m_stream.tellg();
+            if (start != std::istream::pos_type(-1) && m_stream.seekg(0, std::ios_base::end))
+            {
+                std::istream::pos_type end = m_stream.tellg();
+                m_remaining = static_cast<std::size_t>(end - start);
+                m_stream.seekg(start);
+            }
+            m_stream.clear();
+        }
+
+        // Sets [first, last) to the next line, without its end of line, and
+        // returns false at the end of the stream
+        inline bool csv_stream::next_line(const char*& first, const char*& last)
+        {
+            std::size_t scanned = 0;
+            while (true)
+            {
+                const char* begin = m_buffer.data() + m_pos;
+                const char* end = m_buffer.data() + m_size;
+                const char* eol = static_cast<const char*>(std::memchr(begin + scanned, '\n', static_cast<std::size_t>(end - begin) - scanned));
+                if (eol != nullptr && std::memchr(begin, '"', static_cast<std::size_t>(eol - begin)) != nullptr)
+                {
+                    bool quoted = false;
+                    eol = nullptr;
+                    for (const char* p = begin; p != end; ++p)
+                    {
+                        quoted = *p == '"' ? !quoted : quoted;
+                        if (*p == '\n' && !quoted)
+                        {
+                            eol = p;
+                            break;
+                        }
+                    }
+                }
+                if (eol != nullptr || m_eof)
+                {
+                    if (begin == end)
+                    {
+                        return false;
+                    }
+                    first = begin;
+                    last = eol != nullptr ? eol : end;
+                    m_pos = static_cast<std::size_t>(last - m_buffer.data()) + (eol != nullptr ? 1 : 0);
+                    if (last != first && last[-1] == '\r')
+                    {
+                        --last;
+                    }
+                    return true;
+                }
+                scanned = static_cast<std::size_t>(end - begin);
+                fill();
+            }
+        }
+
+        // Sets [first, last) to the next complete lines, with their ends of
+        // line, and returns false at the end of the stream. They make a block
+        // unless a line is longer, and quoted tells whether they have quotes.
+        inline bool csv_stream::next_block(const char*& first, const char*& last, bool& quoted)
+        {
+            if (m_size - m_pos < m_block_size)
+            {
+                fill();
+            }
+            while (true)
+            {
+                const char* begin = m_buffer.data() + m_pos;
+                const char* end = m_buffer.data() + m_size;
+                if (begin == end)
+                {
+                    return false;
+                }
+                quoted = std::memchr(begin, '"', static_cast<std::size_t>(end - begin)) != nullptr;
+                const char* cut = end;
+                if (!m_eof)
+                {
+                    // The last line may continue in the next block
+                    cut = begin;
+                    if (!quoted)
+                    {
+                        for (const char* p = end; p != begin; --p)
+                        {
+                            if (p[-1] == '\n')
+                            {
+                                cut = p;
+                                break;
+                            }
+                        }
+                    }
+                    else
+                    {
+                        bool in_quotes = false;
+                        for (const char* p = begin; p != end; ++p)
+                        {
+                            in_quotes = *p == '"' ? !in_quotes : in_quotes;
+                            cut = *p == '\n' && !in_quotes ? p + 1 : cut;
+                        }
+                    }
+                }
+                if (cut != begin)
+                {
+                    first = begin;
+                    last = cut;
+                    m_pos = static_cast<std::size_t>(cut - m_buffer.data());
+                    return true;
+                }
+                fill();
+            }
+        }
+
+        // Returns the number of bytes after the current line, if the size of
+        // the stream is known
+        inline std::size_t csv_stream::remaining_size() const noexcept
+        {
+            return m_remaining + (m_size - m_pos);
+        }
+
+        // Moves the unread data to the beginning of the buffer, growing it
+        // for the lines longer than a block, and reads the next block. The
+        // data is followed by a null character.
+        inline void csv_stream::fill()
+        {
+            std::size_t unread = m_size - m_pos;
+            std::memmove(m_buffer.data(), m_buffer.data() + m_pos, unread);
+            m_pos = 0;
+            m_size = unread;
+            if (m_buffer.size() - 1 - m_size < m_block_size)
+            {
+                m_buffer.resize(m_size + m_block_size + 1);
+            }
+            m_stream.read(m_buffer.data() + m_size, static_cast<std::streamsize>(m_buffer.size() - 1 - m_size));
+            std::size_t n = static_cast<std::size_t>(m_stream.gcount());
+            m_size += n;
+            m_buffer[m_size] = '\0';
+            m_remaining -= (std::min)(m_remaining, n);
+            m_eof = n == 0;
+        }
+
+        /****************
+         * cell parsing *
+         ****************/
+
+        // The types parsed in place, the others being read from a string
+        // by lexical_cast
+        template <class T>
+        struct csv_number
+            : std::integral_constant<bool, std::is_floating_point<T>::value ||
+                                           (std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                            sizeof(T) >= sizeof(int))>
+        {
+        };
+
+#if defined(XTENSOR_CSV_HAS_FLOAT_FROM_CHARS)
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value, bool>
+        parse_csv_number(const char* first, const char* last, T& value)
+        {
+            auto res = std::from_chars(first, last, value);
+            if (res.ec == std::errc::result_out_of_range)
+            {
+                XTENSOR_THROW(std::out_of_range, "Number out of range in CSV: " + std::string(first, last));
+            }
+            return res.ec == std::errc();
+        }
+#else
+        // The cells are followed by a delimiter, an end of line or the null
+        // character ending the buffer of csv_stream, which stop strtod
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value, bool>
+        parse_csv_number(const char* first, const char* last, T& value)
+        {
+            char* end = nullptr;
+            errno = 0;
+            long double res = std::strtold(first, &end);
+            if (errno == ERANGE || res > static_cast<long double>((std::numeric_limits<T>::max)()) ||
+                res < static_cast<long double>(std::numeric_limits<T>::lowest()))
+            {
+                XTENSOR_THROW(std::out_of_range, "Number out of range in CSV: " + std::string(first, last));
+            }
+            value = static_cast<T>(res);
+            return end != first;
+        }
+#endif
+
+#if defined(XTENSOR_CSV_HAS_FROM_CHARS)
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value, bool>
+        parse_csv_number(const char* first, const char* last, T& value)
+        {
+            auto res = std::from_chars(first, last, value);
+            if (res.ec == std::errc::result_out_of_range)
+            {
+                XTENSOR_THROW(std::out_of_range, "Number out of range in CSV: " + std::string(first, last));
+            }
+            return res.ec == std::errc();
+        }
+#else
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, bool>
+        parse_csv_number(const char* first, const char* last, T& value)
+        {
+            char* end = nullptr;
+            errno = 0;
+            long long res = std::strtoll(first, &end, 10);
+            if (errno == ERANGE || res > (std::numeric_limits<T>::max)() || res < (std::numeric_limits<T>::min)())
+            {
+                XTENSOR_THROW(std::out_of_range, "Number out of range in CSV: " + std::string(first, last));
+            }
+            value = static_cast<T>(res);
+            return end != first;
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value && !std::is_signed<T>::value, bool>
+        parse_csv_number(const char* first, const char* last, T& value)
+        {
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long res = std::strtoull(first, &end, 10);
+            if (errno == ERANGE || res > (std::numeric_limits<T>::max)())
+            {
+                XTENSOR_THROW(std::out_of_range, "Number out of range in CSV: " + std::string(first, last));
+            }
+            value = static_cast<T>(res);
+            return end != first;
+        }
+#endif
+
+        template <class T>
+        inline std::enable_if_t<csv_number<T>::value, T> parse_csv_cell(const char* first, const char* last)
+        {
+            while (first != last && (*first == ' ' || *first == '\t'))
+            {
+                ++first;
+            }
+            while (last != first && (last[-1] == ' ' || last[-1] == '\t'))
+            {
+                --last;
+            }
+            if (first != last && *first == '+')
+            {
+                ++first;
+            }
+            T value;
+            if (first == last || !parse_csv_number(first, last, value))
+            {
+                XTENSOR_THROW(std::invalid_argument, "Invalid number in CSV: " + std::string(first, last));
+            }
+            return value;
+        }
 
-        template <class ST, class T, class OI>
-        ST load_csv_row(std::istream& row_stream, OI output, std::string cell, const char delimiter = ',')
+        template <class T>
+        inline std::enable_if_t<!csv_number<T>::value, T> parse_csv_cell(const char* first, const char* last)
+        {
+            return lexical_cast<T>(std::string(first, last));
+        }
+
+        // Parses the cells of the line [first, last) to output and returns
+        // their number. A delimiter ending the line does not start a cell.
+        // Quoted fields may contain delimiters, ends of line and escaped
+        // quotes "", and are unescaped in cell.
+        template <class T, class OI>
+        inline std::size_t load_csv_row(const char* first, const char* last, OI& output, std::string& cell,
+                                        const char delimiter)
         {
-            ST length = 0;
-            while (std::getline(row_stream, cell, delimiter))
+            std::size_t length = 0;
+            const char* p = first;
+            while (p != last)
             {
-                *output++ = lexical_cast<T>(cell);
+                const char* q = p;
+                while (q != last && *q == ' ' && delimiter != ' ')
+                {
+                    ++q;
+                }
+                const char* cell_first = p;
+                const char* cell_last = nullptr;
+                if (q != last && *q == '"')
+                {
+                    cell.clear();
+                    for (++q; q != last; ++q)
+                    {
+                        if (*q == '"')
+                        {
+                            if (q + 1 == last || q[1] != '"')
+                            {
+                                ++q;
+                                break;
+                            }
+                            ++q;
+                        }
+                        cell.push_back(*q);
+                    }
+                    cell_first = cell.c_str();
+                    cell_last = cell_first + cell.size();
+                }
+                const char* d = static_cast<const char*>(std::memchr(q, delimiter, static_cast<std::size_t>(last - q)));
+                d = d != nullptr ? d : last;
+                if (cell_last == nullptr)
+                {
+                    cell_last = d;
+                }
+                *output++ = parse_csv_cell<T>(cell_first, cell_last);
                 ++length;
+                p = d != last ? d + 1 : last;
             }
             return length;
         }
+
+        /*******************
+         * cell formatting *
+         *******************/
+
+        // Size of the text formatted before being written to the stream,
+        // and number of rows formatted by a task of the parallel dump_csv
+        constexpr std::size_t csv_write_buffer_size = std::size_t(1) << 20;
+        constexpr std::size_t csv_write_rows = 1024;
+
+#if defined(XTENSOR_CSV_HAS_FLOAT_FROM_CHARS)
+        // The shortest representation parsed back to the same value
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value> append_csv_cell(std::string& out, T value)
+        {
+            char buffer[64];
+            auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, res.ptr);
+        }
+#else
+        // The digits10 significant digits of T unless more are needed to
+        // parse back the same value
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value> append_csv_cell(std::string& out, T value)
+        {
+            char buffer[64];
+            long double v = static_cast<long double>(value);
+            int n = std::snprintf(buffer, sizeof(buffer), "%.*Lg", std::numeric_limits<T>::digits10, v);
+            if (static_cast<T>(std::strtold(buffer, nullptr)) != value && value == value)
+            {
+                n = std::snprintf(buffer, sizeof(buffer), "%.*Lg", std::numeric_limits<T>::max_digits10, v);
+            }
+            out.append(buffer, static_cast<std::size_t>(n));
+        }
+#endif
+
+#if defined(XTENSOR_CSV_HAS_FROM_CHARS)
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value && csv_number<T>::value> append_csv_cell(std::string& out, T value)
+        {
+            char buffer[32];
+            auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, res.ptr);
+        }
+#else
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value && csv_number<T>::value && std::is_signed<T>::value>
+        append_csv_cell(std::string& out, T value)
+        {
+            char buffer[32];
+            int n = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+            out.append(buffer, static_cast<std::size_t>(n));
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value && csv_number<T>::value && !std::is_signed<T>::value>
+        append_csv_cell(std::string& out, T value)
+        {
+            char buffer[32];
+            int n = std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+            out.append(buffer, static_cast<std::size_t>(n));
+        }
+#endif
+
+        template <class T>
+        inline std::enable_if_t<!csv_number<T>::value> append_csv_cell(std::string& out, const T& value)
+        {
+            std::ostringstream oss;
+            oss << value;
+            out += oss.str();
+        }
+
+        // Appends the rows [first, last) of the 2-D expression e to out
+        template <class E>
+        inline void append_csv_rows(std::string& out, const E& e, std::size_t first, std::size_t last)
+        {
+            std::size_t nbcols = e.shape()[1];
+            for (std::size_t r = first; r != last; ++r)
+            {
+                for (std::size_t c = 0; c != nbcols; ++c)
+                {
+                    append_csv_cell(out, e(r, c));
+                    out.push_back(c != nbcols - 1 ? ',' : '\n');
+                }
+            }
+        }
+
+        /*****************
+         * block parsing *
+         *****************/
+
+        // Size of the blocks read by the parallel load_csv, and of the chunks
+        // they are split into on ends of line
+        constexpr std::size_t csv_parallel_block_size = std::size_t(1) << 24;
+        constexpr std::size_t csv_chunk_size = std::size_t(1) << 18;
+
+        // Returns false for the blank lines and the comments
+        inline bool is_csv_data_line(const char* first, const char* last, const std::string& comments)
+        {
+            std::size_t line_size = static_cast<std::size_t>(last - first);
+            return line_size != 0 &&
+                   (comments.empty() || line_size < comments.size() ||
+                    !std::equal(comments.begin(), comments.end(), first));
+        }
+
+        // Calls f(line_first, line_last) for the lines of [first, last),
+        // without their ends of line, until f returns false. The quoted
+        // fields are only looked for if quoted is true.
+        template <class F>
+        inline void for_each_csv_line(const char* first, const char* last, bool quoted, F&& f)
+        {
+            while (first != last)
+            {
+                const char* eol = nullptr;
+                if (!quoted)
+                {
+                    eol = static_cast<const char*>(std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+                }
+                else
+                {
+                    bool in_quotes = false;
+                    for (const char* p = first; p != last && eol == nullptr; ++p)
+                    {
+                        in_quotes = *p == '"' ? !in_quotes : in_quotes;
+                        eol = *p == '\n' && !in_quotes ? p : nullptr;
+                    }
+                }
+                eol = eol != nullptr ? eol : last;
+                const char* line_last = eol != first && eol[-1] == '\r' ? eol - 1 : eol;
+                if (!f(first, line_last))
+                {
+                    return;
+                }
+                first = eol != last ? eol + 1 : last;
+            }
+        }
+
+        // Output iterator writing the cells of a row to [first, last), the
+        // cells after last being dropped
+        template <class T, class It>
+        class csv_row_output
+        {
+        public:
+
+            csv_row_output(It first, It last)
+                : m_it(first), m_last(last)
+            {
+            }
+
+            csv_row_output& operator*() noexcept
+            {
+                return *this;
+            }
+
+            csv_row_output& operator++(int) noexcept
+            {
+                return *this;
+            }
+
+            csv_row_output& operator=(T value)
+            {
+                if (m_it != m_last)
+                {
+                    *m_it = std::move(value);
+                    ++m_it;
+                }
+                return *this;
+            }
+
+        private:
+
+            It m_it;
+            It m_last;
+        };
+
+        // Runs f(c) for the n_chunks chunks of a block. The policy ranges over
+        // their bytes, so that its thresholds apply to the size of the data.
+        template <class P, class F>
+        inline void for_each_csv_chunk(const P& policy, std::size_t n_chunks, F&& f)
+        {
+            policy.for_range(std::size_t(0), n_chunks * csv_chunk_size, csv_chunk_size, [&f](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t c = begin / csv_chunk_size; c < (end + csv_chunk_size - 1) / csv_chunk_size; ++c)
+                {
+                    f(c);
+                }
+            });
+        }
+
+        // Parses at most max_nbrow rows of the complete lines [first, last)
+        // into data after its nbrow rows of nbcol cells, and returns their
+        // number. The block is split on ends of line into chunks whose rows
+        // are counted, then parsed to their place in data concurrently. The
+        // lines with quotes, which may hold ends of line, make one chunk.
+        template <class T, class S, class P>
+        inline std::size_t load_csv_block(const char* first, const char* last, bool quoted, S& data,
+                                          std::size_t nbrow, std::size_t nbcol, std::size_t max_nbrow,
+                                          const char delimiter, const std::string& comments, const P& policy)
+        {
+            std::size_t size = static_cast<std::size_t>(last - first);
+            // The bits of std::vector<bool> cannot be written concurrently
+            bool single_chunk = quoted || std::is_same<T, bool>::value;
+            std::size_t n_chunks = single_chunk ? std::size_t(1) : (size + csv_chunk_size - 1) / csv_chunk_size;
+            std::vector<const char*> bounds(n_chunks + 1, last);
+            bounds[0] = first;
+            for (std::size_t c = 1; c < n_chunks; ++c)
+            {
+                const char* start = (std::max)(bounds[c - 1], first + c * csv_chunk_size);
+                const char* eol = static_cast<const char*>(std::memchr(start, '\n', static_cast<std::size_t>(last - start)));
+                bounds[c] = eol != nullptr ? eol + 1 : last;
+            }
+
+            std::vector<std::size_t> offsets(n_chunks + 1, 0);
+            for_each_csv_chunk(policy, n_chunks, [&](std::size_t c)
+            {
+                std::size_t n = 0;
+                for_each_csv_line(bounds[c], bounds[c + 1], quoted, [&](const char* line_first, const char* line_last)
+                {
+                    n += is_csv_data_line(line_first, line_last, comments) ? std::size_t(1) : std::size_t(0);
+                    return true;
+                });
+                offsets[c + 1] = n;
+            });
+            for (std::size_t c = 0; c < n_chunks; ++c)
+            {
+                offsets[c + 1] += offsets[c];
+            }
+            std::size_t block_nbrow = (std::min)(offsets[n_chunks], max_nbrow);
+            data.resize((nbrow + block_nbrow) * nbcol);
+
+            // The first error of the block is rethrown once the chunks are parsed
+            std::vector<std::exception_ptr> errors(n_chunks);
+            for_each_csv_chunk(policy, n_chunks, [&](std::size_t c)
+            {
+                std::size_t row = offsets[c];
+                if (row >= block_nbrow)
+                {
+                    return;
+                }
+                auto it = data.begin() + static_cast<std::ptrdiff_t>((nbrow + row) * nbcol);
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+                try
+                {
+#endif
+                    std::string cell;
+                    for_each_csv_line(bounds[c], bounds[c + 1], quoted, [&](const char* line_first, const char* line_last)
+                    {
+                        if (!is_csv_data_line(line_first, line_last, comments))
+                        {
+                            return true;
+                        }
+                        auto row_last = it + static_cast<std::ptrdiff_t>(nbcol);
+                        csv_row_output<T, decltype(it)> output(it, row_last);
+                        if (load_csv_row<T>(line_first, line_last, output, cell, delimiter) != nbcol)
+                        {
+                            XTENSOR_THROW(std::runtime_error, "Inconsistent row lengths in CSV");
+                        }
+                        it = row_last;
+                        return ++row < block_nbrow;
+                    });
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+                }
+                catch (...)
+                {
+                    errors[c] = std::current_exception();
+                }
+#endif
+            });
+            for (const auto& error : errors)
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+            return block_nbrow;
+        }
     }
 
     /**
      * @brief Load tensor from CSV.
-     * 
-     * Returns an \ref xexpression for the parsed CSV
+     *
+     * Returns an \ref xexpression for the parsed CSV. The stream is read by
+     * blocks and the numbers are parsed in place, with std::from_chars when
+     * available. Fields may be quoted, and blank lines are skipped.
      * @param stream the input stream containing the CSV encoded values
      * @param delimiter the character used to separate values. [default: ',']
      * @param skip_rows the number of lines to skip from the beginning. [default: 0]
@@ -130,15 +747,19 @@ namespace xt
         size_type nbrow = 0, nbcol = 0, nhead = 0;
         {
             output_iterator output(data);
-            std::string row, cell;
-            while (std::getline(stream, row))
+            detail::csv_stream reader(stream);
+            std::string cell;
+            const char* first = nullptr;
+            const char* last = nullptr;
+            while (reader.next_line(first, last))
             {
-                if (nhead < skip_rows) 
+                if (nhead < skip_rows)
                 {
                     ++nhead;
                     continue;
                 }
-                if (std::equal(comments.begin(), comments.end(), row.begin()))
+                std::size_t line_size = static_cast<std::size_t>(last - first);
+                if (!detail::is_csv_data_line(first, last, comments))
                 {
                     continue;
                 }
@@ -146,9 +767,17 @@ namespace xt
                 {
                     break;
                 }
-                std::stringstream row_stream(row);
-                nbcol = detail::load_csv_row<size_type, T, output_iterator>(row_stream, output, cell, delimiter);
-                ++nbrow;
+                nbcol = detail::load_csv_row<T>(first, last, output, cell, delimiter);
+                if (nbrow++ == 0)
+                {
+                    // Sizes the data once from the length of the first row
+                    std::size_t nb_lines = reader.remaining_size() / (line_size + 1) + 1;
+                    if (0 < max_rows)
+                    {
+                        nb_lines = (std::min)(nb_lines, static_cast<std::size_t>(max_rows));
+                    }
+                    data.reserve(nbcol * (nb_lines + nb_lines / 16 + 1));
+                }
             }
         }
         inner_shape_type shape = {nbrow, nbcol};
@@ -162,9 +791,276 @@ namespace xt
         return tensor_type(std::move(data), std::move(shape), std::move(strides));
     }
 
+    /**
+     * @brief Load tensor from CSV in parallel.
+     *
+     * Reads the stream by large blocks, split on ends of line into chunks
+     * parsed concurrently according to \c policy. The rows of each chunk
+     * are counted first, so that the chunks are parsed directly to their
+     * rows of the result. The blocks with quoted fields, which may hold
+     * ends of line, are parsed sequentially.
+     * @param stream the input stream containing the CSV encoded values
+     * @param delimiter the character used to separate values
+     * @param skip_rows the number of lines to skip from the beginning
+     * @param max_rows the number of lines to read after skip_rows lines, or -1 to read all the lines
+     * @param comments the string used to indicate the start of a comment
+     * @param policy the execution policy parsing the chunks
+     */
+    template <class T, class A, class P, class>
+    xcsv_tensor<T, A> load_csv(std::istream& stream,
+                               const char delimiter,
+                               const std::size_t skip_rows,
+                               const std::ptrdiff_t max_rows,
+                               const std::string comments,
+                               const P& policy)
+    {
+        using tensor_type = xcsv_tensor<T, A>;
+        using storage_type = typename tensor_type::storage_type;
+        using size_type = typename tensor_type::size_type;
+        using inner_shape_type = typename tensor_type::inner_shape_type;
+        using inner_strides_type = typename tensor_type::inner_strides_type;
+        using output_iterator = std::back_insert_iterator<storage_type>;
+
+        storage_type data;
+        size_type nbrow = 0, nbcol = 0, nhead = 0;
+        size_type max_nbrow = 0 < max_rows ? static_cast<size_type>(max_rows) : (std::numeric_limits<size_type>::max)();
+        detail::csv_stream reader(stream, detail::csv_parallel_block_size);
+        const char* first = nullptr;
+        const char* last = nullptr;
+        // The skipped lines and the first row, which gives the number of
+        // columns, are read line by line
+        while (nbrow == 0 && reader.next_line(first, last))
+        {
+            if (nhead < skip_rows)
+            {
+                ++nhead;
+                continue;
+            }
+            if (detail::is_csv_data_line(first, last, comments))
+            {
+                output_iterator output(data);
+                std::string cell;
+                nbcol = detail::load_csv_row<T>(first, last, output, cell, delimiter);
+                nbrow = 1;
+                std::size_t nb_lines = (std::min)(reader.remaining_size() / (static_cast<std::size_t>(last - first) + 1) + 1, max_nbrow);
+                data.reserve(nbcol * (nb_lines + nb_lines / 16 + 1));
+            }
+        }
+        bool quoted = false;
+        while (nbrow < max_nbrow && reader.next_block(first, last, quoted))
+        {
+            nbrow += detail::load_csv_block<T>(first, last, quoted, data, nbrow, nbcol, max_nbrow - nbrow,
+                                               delimiter, comments, policy);
+        }
+        inner_shape_type shape = {nbrow, nbcol};
+        inner_strides_type strides;
+        compute_strides(shape, layout_type::row_major, strides);
+        return tensor_type(std::move(data), std::move(shape), std::move(strides));
+    }
+
+    /**
+     * @brief Load tensor from a CSV file in parallel.
+     *
+     * Opens the file and loads it with the parallel load_csv.
+     * @param filename the name of the CSV file
+     * @param delimiter the character used to separate values. [default: ',']
+     * @param skip_rows the number of lines to skip from the beginning. [default: 0]
+     * @param max_rows the number of lines to read after skip_rows lines; the default is to read all the lines. [default: -1]
+     * @param comments the string used to indicate the start of a comment. [default: "#"]
+     * @param policy the execution policy parsing the chunks. [default: exec::default_policy]
+     */
+    template <class T, class A, class P, class>
+    xcsv_tensor<T, A> load_csv(const std::string& filename,
+                               const char delimiter,
+                               const std::size_t skip_rows,
+                               const std::ptrdiff_t max_rows,
+                               const std::string comments,
+                               const P& policy)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        return load_csv<T, A>(stream, delimiter, skip_rows, max_rows, comments, policy);
+    }
+
+    /**************
+     * csv_reader *
+     **************/
+
+    /**
+     * @class csv_reader
+     * @brief Reader of the rows of a CSV stream by batches.
+     *
+     * The csv_reader class parses a CSV stream by batches of a fixed number
+     * of rows, so that files bigger than the memory can be processed by
+     * streaming reductions such as histogram_accumulator. The batches are
+     * parsed to the same tensor, which is only reallocated for the last
+     * batch if it has fewer rows. The fields are parsed as in load_csv.
+     *
+     * @tparam T the value type of the batches
+     * @tparam A the allocator of the batches
+     */
+    template <class T, class A = std::allocator<T>>
+    class csv_reader
+    {
+    public:
+
+        using value_type = T;
+        using batch_type = xcsv_tensor<T, A>;
+        using size_type = typename batch_type::size_type;
+
+        csv_reader(std::istream& stream, size_type batch_rows, const char delimiter = ',',
+                   const std::size_t skip_rows = 0, const std::string comments = "#");
+
+        csv_reader(const csv_reader&) = delete;
+        csv_reader& operator=(const csv_reader&) = delete;
+
+        bool next();
+
+        const batch_type& batch() const noexcept;
+        size_type batch_rows() const noexcept;
+        size_type columns() const noexcept;
+        size_type rows() const noexcept;
+
+    private:
+
+        detail::csv_stream m_stream;
+        batch_type m_batch;
+        std::string m_cell;
+        std::string m_comments;
+        size_type m_batch_rows;
+        size_type m_columns;
+        size_type m_rows;
+        std::size_t m_skip_rows;
+        char m_delimiter;
+        bool m_end;
+    };
+
+    /*****************************
+     * csv_reader implementation *
+     *****************************/
+
+    /**
+     * Constructs a reader of the rows of \c stream by batches of
+     * \c batch_rows rows.
+     * @param stream the input stream containing the CSV encoded values
+     * @param batch_rows the number of rows of the batches
+     * @param delimiter the character used to separate values. [default: ',']
+     * @param skip_rows the number of lines to skip from the beginning. [default: 0]
+     * @param comments the string used to indicate the start of a comment. [default: "#"]
+     */
+    template <class T, class A>
+    inline csv_reader<T, A>::csv_reader(std::istream& stream, size_type batch_rows, const char delimiter,
+                                        const std::size_t skip_rows, const std::string comments)
+        : m_stream(stream), m_batch(), m_cell(), m_comments(comments), m_batch_rows(batch_rows),
+          m_columns(0), m_rows(0), m_skip_rows(skip_rows), m_delimiter(delimiter), m_end(batch_rows == 0)
+    {
+    }
+
+    /**
+     * Parses the next batch of rows and returns false if the stream has none
+     * left. The last batch may have fewer rows than batch_rows().
+     */
+    template <class T, class A>
+    inline bool csv_reader<T, A>::next()
+    {
+        using output_iterator = std::back_insert_iterator<typename batch_type::storage_type>;
+        using iterator = typename batch_type::storage_type::iterator;
+
+        size_type n = 0;
+        const char* first = nullptr;
+        const char* last = nullptr;
+        while (!m_end && n < m_batch_rows)
+        {
+            if (!m_stream.next_line(first, last))
+            {
+                m_end = true;
+                break;
+            }
+            if (m_skip_rows != 0)
+            {
+                --m_skip_rows;
+                continue;
+            }
+            if (!detail::is_csv_data_line(first, last, m_comments))
+            {
+                continue;
+            }
+            if (m_rows == 0 && n == 0)
+            {
+                // The first row gives the number of columns of the batches
+                typename batch_type::storage_type row;
+                output_iterator output(row);
+                m_columns = detail::load_csv_row<T>(first, last, output, m_cell, m_delimiter);
+                m_batch.resize({m_batch_rows, m_columns});
+                std::move(row.begin(), row.end(), m_batch.storage().begin());
+            }
+            else
+            {
+                iterator row_first = m_batch.storage().begin() + static_cast<std::ptrdiff_t>(n * m_columns);
+                iterator row_last = row_first + static_cast<std::ptrdiff_t>(m_columns);
+                detail::csv_row_output<T, iterator> output(row_first, row_last);
+                if (detail::load_csv_row<T>(first, last, output, m_cell, m_delimiter) != m_columns)
+                {
+                    XTENSOR_THROW(std::runtime_error, "Inconsistent row lengths in CSV");
+                }
+            }
+            ++n;
+        }
+        if (n != m_batch_rows)
+        {
+            m_batch.resize({n, m_columns});
+        }
+        m_rows += n;
+        return n != 0;
+    }
+
+    /**
+     * Returns the batch parsed by the last call to next().
+     */
+    template <class T, class A>
+    inline auto csv_reader<T, A>::batch() const noexcept -> const batch_type&
+    {
+        return m_batch;
+    }
+
+    /**
+     * Returns the number of rows of the batches.
+     */
+    template <class T, class A>
+    inline auto csv_reader<T, A>::batch_rows() const noexcept -> size_type
+    {
+        return m_batch_rows;
+    }
+
+    /**
+     * Returns the number of columns of the rows, known once the first batch
+     * is parsed.
+     */
+    template <class T, class A>
+    inline auto csv_reader<T, A>::columns() const noexcept -> size_type
+    {
+        return m_columns;
+    }
+
+    /**
+     * Returns the number of rows parsed so far.
+     */
+    template <class T, class A>
+    inline auto csv_reader<T, A>::rows() const noexcept -> size_type
+    {
+        return m_rows;
+    }
+
     /**
      * @brief Dump tensor to CSV.
-     * 
+     *
+     * The numbers are formatted with std::to_chars when available, the
+     * floating point ones with the shortest representation parsed back to
+     * the same value, regardless of the locale and of the format flags of
+     * the stream. The text is written to the stream by large blocks.
      * @param stream the output stream to write the CSV encoded values
      * @param e the tensor expression to serialize
      */
@@ -178,24 +1074,75 @@ namespace xt
             XTENSOR_THROW(std::runtime_error, "Only 2-D expressions can be serialized to CSV");
         }
         size_type nbrows = ex.shape()[0], nbcols = ex.shape()[1];
+        std::string out;
+        out.reserve(detail::csv_write_buffer_size + 256);
         auto st = ex.stepper_begin(ex.shape());
         for (size_type r = 0; r != nbrows; ++r)
         {
             for (size_type c = 0; c != nbcols; ++c)
             {
-                stream << *st;
+                detail::append_csv_cell(out, *st);
                 if (c != nbcols - 1)
                 {
                     st.step(1);
-                    stream << ',';
+                    out.push_back(',');
                 }
                 else
                 {
                     st.reset(1);
                     st.step(0);
-                    stream << std::endl;
+                    out.push_back('\n');
                 }
             }
+            if (out.size() >= detail::csv_write_buffer_size)
+            {
+                stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+                out.clear();
+            }
+        }
+        stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+
+    /**
+     * @brief Dump tensor to CSV in parallel.
+     *
+     * The expression is evaluated, then blocks of rows are formatted
+     * concurrently according to \c policy, as in the sequential dump_csv,
+     * and written to the stream in order.
+     * @param stream the output stream to write the CSV encoded values
+     * @param e the tensor expression to serialize
+     * @param policy the execution policy formatting the blocks of rows
+     */
+    template <class E, class P, class>
+    void dump_csv(std::ostream& stream, const xexpression<E>& e, const P& policy)
+    {
+        const auto& ex = xt::eval(e.derived_cast());
+        if (ex.dimension() != 2)
+        {
+            XTENSOR_THROW(std::runtime_error, "Only 2-D expressions can be serialized to CSV");
+        }
+        std::size_t nbrows = ex.shape()[0];
+        // The rows are formatted by groups of blocks, bounding the memory
+        // holding the text
+        constexpr std::size_t group_blocks = 64;
+        constexpr std::size_t group_rows = group_blocks * detail::csv_write_rows;
+        std::vector<std::string> texts(group_blocks);
+        for (std::size_t first = 0; first < nbrows; first += group_rows)
+        {
+            std::size_t last = (std::min)(first + group_rows, nbrows);
+            policy.for_range(first, last, detail::csv_write_rows, [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t r = begin; r < end; r += detail::csv_write_rows)
+                {
+                    std::string& text = texts[(r - first) / detail::csv_write_rows];
+                    text.clear();
+                    detail::append_csv_rows(text, ex, r, (std::min)(r + detail::csv_write_rows, end));
+                }
+            });
+            for (std::size_t b = 0; b < (last - first + detail::csv_write_rows - 1) / detail::csv_write_rows; ++b)
+            {
+                stream.write(texts[b].data(), static_cast<std::streamsize>(texts[b].size()));
+            }
         }
     }
 
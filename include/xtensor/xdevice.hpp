@@ -0,0 +1,605 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DEVICE_HPP
+#define XTENSOR_DEVICE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(XTENSOR_USE_SYCL)
+#include <sycl/sycl.hpp>
+#endif
+
+#include "xarray.hpp"
+#include "xassign.hpp"
+#include "xexecution.hpp"
+#include "xfunction.hpp"
+#include "xmath.hpp"
+#include "xscalar.hpp"
+#include "xstorage.hpp"
+#include "xstrides.hpp"
+#include "xtensor.hpp"
+
+namespace xt
+{
+
+    /***********
+     * devices *
+     ***********/
+
+    /**
+     * @class xhost_device
+     * @brief Reference device running the kernels on the host.
+     *
+     * A device provides static functions allocating and freeing the memory
+     * of the device containers, running a kernel on the indices [0, n) and
+     * reducing the values computed by a kernel. The memory of a device must
+     * be accessible from the host, so that the device containers keep the
+     * whole xtensor API; only the assignments and reductions that can be
+     * lowered to kernels run on the device.
+     * The host device splits its kernels with the default execution policy.
+     */
+    struct xhost_device
+    {
+        static void* allocate(std::size_t bytes);
+        static void deallocate(void* p, std::size_t bytes) noexcept;
+
+        template <class K>
+        static void parallel_for(std::size_t n, const K& kernel);
+
+        template <class T, class K, class F>
+        static T reduce(std::size_t n, const K& kernel, T init, F f);
+    };
+
+#if defined(XTENSOR_USE_SYCL)
+    /**
+     * @class xsycl_device
+     * @brief Device running the kernels on a SYCL queue.
+     *
+     * The memory is allocated as USM shared memory, migrated between the
+     * host and the device by the runtime. The kernels are submitted to the
+     * queue returned by queue(), which can be replaced with set_queue before
+     * the first device container is allocated, and are waited for before
+     * returning.
+     */
+    struct xsycl_device
+    {
+        static sycl::queue& queue();
+        static void set_queue(const sycl::queue& q);
+
+        static void* allocate(std::size_t bytes);
+        static void deallocate(void* p, std::size_t bytes) noexcept;
+
+        template <class K>
+        static void parallel_for(std::size_t n, const K& kernel);
+
+        template <class T, class K, class F>
+        static T reduce(std::size_t n, const K& kernel, T init, F f);
+    };
+#endif
+
+    /********************
+     * device_allocator *
+     ********************/
+
+    /**
+     * @class device_allocator
+     * @brief Stateless allocator taking its memory from a device.
+     *
+     * The containers whose storage uses a device_allocator are device
+     * containers: the assignments of expressions made of such containers
+     * of the same device and of scalars run as kernels on that device.
+     * @tparam T The value type of the elements.
+     * @tparam D The device, xhost_device or xsycl_device.
+     */
+    template <class T, class D = xhost_device>
+    class device_allocator
+    {
+    public:
+
+        using value_type = T;
+        using device_type = D;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = device_allocator<U, D>;
+        };
+
+        device_allocator() noexcept = default;
+
+        template <class U>
+        device_allocator(const device_allocator<U, D>& rhs) noexcept;
+
+        T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n) noexcept;
+    };
+
+    template <class T, class U, class D>
+    bool operator==(const device_allocator<T, D>& lhs, const device_allocator<U, D>& rhs) noexcept;
+
+    template <class T, class U, class D>
+    bool operator!=(const device_allocator<T, D>& lhs, const device_allocator<U, D>& rhs) noexcept;
+
+    /**
+     * Dynamically dimensional container allocated on the device \c D.
+     */
+    template <class T, class D = xhost_device, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    using xdevice_array = xarray<T, L, device_allocator<T, D>>;
+
+    /**
+     * Statically dimensional container allocated on the device \c D.
+     */
+    template <class T, std::size_t N, class D = xhost_device, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    using xdevice_tensor = xtensor<T, N, L, device_allocator<T, D>>;
+
+    /*******************
+     * kernel lowering *
+     *******************/
+
+    namespace detail
+    {
+        // Device of an expression: the device of its allocator for the
+        // containers, the first device found in the arguments for the
+        // functions, and void for the other expressions.
+        template <class E, class = void>
+        struct expression_device
+        {
+            using type = void;
+        };
+
+        template <class A>
+        struct allocator_device
+        {
+            using type = void;
+        };
+
+        template <class T, class D>
+        struct allocator_device<device_allocator<T, D>>
+        {
+            using type = D;
+        };
+
+        template <class E>
+        struct expression_device<E, std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value>>
+            : allocator_device<typename E::allocator_type>
+        {
+        };
+
+        template <class... D>
+        struct first_device
+        {
+            using type = void;
+        };
+
+        template <class D, class... R>
+        struct first_device<D, R...>
+        {
+            using type = std::conditional_t<std::is_void<D>::value, typename first_device<R...>::type, D>;
+        };
+
+        template <class F, class... CT>
+        struct expression_device<xfunction<F, CT...>>
+            : first_device<typename expression_device<std::decay_t<CT>>::type...>
+        {
+        };
+
+        template <class E>
+        using expression_device_t = typename expression_device<E>::type;
+
+        // An expression can be lowered to a kernel of the device D when its
+        // leaves are containers of D holding arithmetic values, or scalars.
+        template <class D, class E, class = void>
+        struct is_device_lowerable : std::false_type
+        {
+        };
+
+        template <class D, class E>
+        struct is_device_lowerable<D, E, std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value>>
+            : xtl::conjunction<std::is_same<expression_device_t<E>, D>,
+                               std::is_arithmetic<typename E::value_type>>
+        {
+        };
+
+        template <class D, class CT>
+        struct is_device_lowerable<D, xscalar<CT>>
+            : std::is_arithmetic<std::decay_t<CT>>
+        {
+        };
+
+        template <class D, class F, class... CT>
+        struct is_device_lowerable<D, xfunction<F, CT...>>
+            : xtl::conjunction<is_device_lowerable<D, std::decay_t<CT>>...>
+        {
+        };
+
+        template <class T>
+        struct xdevice_leaf
+        {
+            const T* p_data;
+
+            T operator()(std::size_t i) const
+            {
+                return p_data[i];
+            }
+        };
+
+        template <class T>
+        struct xdevice_constant
+        {
+            T m_value;
+
+            T operator()(std::size_t) const
+            {
+                return m_value;
+            }
+        };
+
+        template <class F, class... K>
+        struct xdevice_function
+        {
+            F m_functor;
+            std::tuple<K...> m_arguments;
+
+            auto operator()(std::size_t i) const
+            {
+                return call(i, std::index_sequence_for<K...>());
+            }
+
+            template <std::size_t... I>
+            auto call(std::size_t i, std::index_sequence<I...>) const
+            {
+                return m_functor(std::get<I>(m_arguments)(i)...);
+            }
+        };
+
+        template <class T, class K>
+        struct xdevice_assign_kernel
+        {
+            T* p_data;
+            K m_kernel;
+
+            void operator()(std::size_t i) const
+            {
+                p_data[i] = static_cast<T>(m_kernel(i));
+            }
+        };
+
+        // Builds the kernel computing the elements of an expression. The
+        // kernels only hold pointers and values, so that they can be copied
+        // to the device.
+        template <class E>
+        struct device_kernel
+        {
+            using type = xdevice_leaf<typename E::value_type>;
+
+            static type make(const E& e)
+            {
+                return type{e.data() + e.data_offset()};
+            }
+        };
+
+        template <class CT>
+        struct device_kernel<xscalar<CT>>
+        {
+            using type = xdevice_constant<std::decay_t<CT>>;
+
+            static type make(const xscalar<CT>& e)
+            {
+                return type{e()};
+            }
+        };
+
+        template <class F, class... CT>
+        struct device_kernel<xfunction<F, CT...>>
+        {
+            using type = xdevice_function<F, typename device_kernel<std::decay_t<CT>>::type...>;
+
+            static type make(const xfunction<F, CT...>& e)
+            {
+                return make_impl(e, std::index_sequence_for<CT...>());
+            }
+
+            template <std::size_t... I>
+            static type make_impl(const xfunction<F, CT...>& e, std::index_sequence<I...>)
+            {
+                return type{e.functor(), std::make_tuple(device_kernel<std::decay_t<CT>>::make(std::get<I>(e.arguments()))...)};
+            }
+        };
+
+        template <class E>
+        inline typename device_kernel<E>::type make_device_kernel(const E& e)
+        {
+            return device_kernel<E>::make(e);
+        }
+
+        // Checks that the leaves of e can be read linearly in the layout
+        // of its first container, i.e. that there is no broadcasting.
+        template <class E>
+        inline bool is_device_linear(const E& e)
+        {
+            using strides_type = dynamic_shape<std::ptrdiff_t>;
+            const auto& shape = e.shape();
+            strides_type strides(shape.size());
+            for (layout_type l : {layout_type::row_major, layout_type::column_major})
+            {
+                compute_strides(shape, l, strides);
+                if (e.has_linear_assign(strides))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <class E, class T, class F, class H>
+        inline T device_reduce(const E& e, T init, F f, H&& host_reduce)
+        {
+            using device_type = expression_device_t<E>;
+            static_assert(!std::is_void<device_type>::value, "device reductions require an expression of device containers");
+            static_assert(is_device_lowerable<device_type, E>::value, "expression cannot be lowered to a device kernel");
+            if (!is_device_linear(e))
+            {
+                return host_reduce(e);
+            }
+            return device_type::template reduce<T>(e.size(), make_device_kernel(e), init, f);
+        }
+
+        struct device_min
+        {
+            template <class T>
+            T operator()(const T& lhs, const T& rhs) const
+            {
+                return rhs < lhs ? rhs : lhs;
+            }
+        };
+
+        struct device_max
+        {
+            template <class T>
+            T operator()(const T& lhs, const T& rhs) const
+            {
+                return lhs < rhs ? rhs : lhs;
+            }
+        };
+    }
+
+    template <class E1, class E2>
+    struct is_device_assignable<E1, E2, std::enable_if_t<!std::is_void<detail::expression_device_t<E1>>::value>>
+        : xtl::conjunction<std::is_arithmetic<typename E1::value_type>,
+                           detail::is_device_lowerable<detail::expression_device_t<E1>, E2>>
+    {
+    };
+
+    template <>
+    template <class E1, class E2>
+    inline bool device_assigner<true>::run(E1& e1, const E2& e2)
+    {
+        using device_type = detail::expression_device_t<E1>;
+        using value_type = typename E1::value_type;
+        auto kernel = detail::make_device_kernel(e2);
+        using kernel_type = detail::xdevice_assign_kernel<value_type, decltype(kernel)>;
+        device_type::parallel_for(e1.size(), kernel_type{e1.data() + e1.data_offset(), kernel});
+        return true;
+    }
+
+    /*********************
+     * device reductions *
+     *********************/
+
+    /**
+     * @brief Sum of the elements of an expression of device containers.
+     *
+     * The reduction runs on the device when the expression does not
+     * broadcast its operands, and on the host otherwise.
+     */
+    template <class E>
+    inline auto device_sum(const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<typename E::value_type>;
+        return detail::device_reduce(e.derived_cast(), value_type(0), std::plus<value_type>(),
+                                     [](const E& de) -> value_type { return sum(de)(); });
+    }
+
+    /**
+     * @brief Product of the elements of an expression of device containers.
+     * @sa device_sum
+     */
+    template <class E>
+    inline auto device_prod(const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<typename E::value_type>;
+        return detail::device_reduce(e.derived_cast(), value_type(1), std::multiplies<value_type>(),
+                                     [](const E& de) -> value_type { return prod(de)(); });
+    }
+
+    /**
+     * @brief Minimum of the elements of an expression of device containers.
+     * @sa device_sum
+     */
+    template <class E>
+    inline auto device_amin(const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<typename E::value_type>;
+        return detail::device_reduce(e.derived_cast(), (std::numeric_limits<value_type>::max)(), detail::device_min(),
+                                     [](const E& de) -> value_type { return amin(de)(); });
+    }
+
+    /**
+     * @brief Maximum of the elements of an expression of device containers.
+     * @sa device_sum
+     */
+    template <class E>
+    inline auto device_amax(const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<typename E::value_type>;
+        return detail::device_reduce(e.derived_cast(), std::numeric_limits<value_type>::lowest(), detail::device_max(),
+                                     [](const E& de) -> value_type { return amax(de)(); });
+    }
+
+    /*******************************
+     * xhost_device implementation *
+     *******************************/
+
+    inline void* xhost_device::allocate(std::size_t bytes)
+    {
+        return ::operator new(bytes);
+    }
+
+    inline void xhost_device::deallocate(void* p, std::size_t /*bytes*/) noexcept
+    {
+        ::operator delete(p);
+    }
+
+    template <class K>
+    inline void xhost_device::parallel_for(std::size_t n, const K& kernel)
+    {
+        exec::default_policy().for_range(std::size_t(0), n, std::size_t(1), [&kernel](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                kernel(i);
+            }
+        });
+    }
+
+    template <class T, class K, class F>
+    inline T xhost_device::reduce(std::size_t n, const K& kernel, T init, F f)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            init = f(init, static_cast<T>(kernel(i)));
+        }
+        return init;
+    }
+
+#if defined(XTENSOR_USE_SYCL)
+    /*******************************
+     * xsycl_device implementation *
+     *******************************/
+
+    namespace detail
+    {
+        inline sycl::queue& sycl_device_queue()
+        {
+            static sycl::queue q;
+            return q;
+        }
+    }
+
+    inline sycl::queue& xsycl_device::queue()
+    {
+        return detail::sycl_device_queue();
+    }
+
+    inline void xsycl_device::set_queue(const sycl::queue& q)
+    {
+        detail::sycl_device_queue() = q;
+    }
+
+    inline void* xsycl_device::allocate(std::size_t bytes)
+    {
+        void* p = sycl::malloc_shared(bytes, queue());
+        if (p == nullptr && bytes != 0)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    inline void xsycl_device::deallocate(void* p, std::size_t /*bytes*/) noexcept
+    {
+        sycl::free(p, queue());
+    }
+
+    template <class K>
+    inline void xsycl_device::parallel_for(std::size_t n, const K& kernel)
+    {
+        if (n != 0)
+        {
+            queue().parallel_for(sycl::range<1>(n), [kernel](sycl::id<1> i)
+            {
+                kernel(i[0]);
+            }).wait();
+        }
+    }
+
+    template <class T, class K, class F>
+    inline T xsycl_device::reduce(std::size_t n, const K& kernel, T init, F f)
+    {
+        T* result = sycl::malloc_shared<T>(1, queue());
+        if (result == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        *result = init;
+        queue().submit([&](sycl::handler& h)
+        {
+            h.parallel_for(sycl::range<1>(n), sycl::reduction(result, init, f), [kernel](sycl::id<1> i, auto& acc)
+            {
+                acc.combine(static_cast<T>(kernel(i[0])));
+            });
+        }).wait();
+        T res = *result;
+        sycl::free(result, queue());
+        return res;
+    }
+#endif
+
+    /***********************************
+     * device_allocator implementation *
+     ***********************************/
+
+    template <class T, class D>
+    template <class U>
+    inline device_allocator<T, D>::device_allocator(const device_allocator<U, D>&) noexcept
+    {
+    }
+
+    template <class T, class D>
+    inline T* device_allocator<T, D>::allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "device_allocator does not support over-aligned types");
+        if (n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(D::allocate(n * sizeof(T)));
+    }
+
+    template <class T, class D>
+    inline void device_allocator<T, D>::deallocate(T* p, std::size_t n) noexcept
+    {
+        D::deallocate(p, n * sizeof(T));
+    }
+
+    template <class T, class U, class D>
+    inline bool operator==(const device_allocator<T, D>&, const device_allocator<U, D>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U, class D>
+    inline bool operator!=(const device_allocator<T, D>& lhs, const device_allocator<U, D>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
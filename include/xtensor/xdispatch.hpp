@@ -0,0 +1,271 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_DISPATCH_HPP
+#define XTENSOR_DISPATCH_HPP
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "xtensor_config.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define XTENSOR_CPU_FEATURES_X86
+#endif
+
+#if defined(XTENSOR_USE_RUNTIME_DISPATCH) && defined(XTENSOR_CPU_FEATURES_X86)
+#define XTENSOR_DISPATCH_X86
+#define XTENSOR_TARGET_AVX2 __attribute__((target("avx2,fma"), flatten))
+#define XTENSOR_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma"), flatten))
+#endif
+
+namespace xt
+{
+
+    /**
+     * Instruction sets the dispatched kernels are compiled for.
+     * The generic target is the instruction set selected by the
+     * compilation flags.
+     */
+    enum class simd_target
+    {
+        generic,
+        avx2,
+        avx512
+    };
+
+    /**
+     * @struct cpu_features
+     * @brief Instruction set extensions of the host CPU that are supported
+     * by the operating system.
+     */
+    struct cpu_features
+    {
+        bool sse2 = false;
+        bool sse4_2 = false;
+        bool avx = false;
+        bool avx2 = false;
+        bool fma = false;
+        bool avx512f = false;
+        bool avx512bw = false;
+        bool avx512dq = false;
+        bool avx512vl = false;
+    };
+
+    const cpu_features& host_cpu_features() noexcept;
+
+    simd_target best_simd_target() noexcept;
+    simd_target dispatch_target() noexcept;
+    simd_target set_dispatch_target(simd_target target) noexcept;
+    const char* simd_target_name(simd_target target) noexcept;
+
+    template <class F>
+    void dispatch_kernel(F&& f);
+
+    template <class T, class F>
+    void dispatch_for(F&& f);
+
+    /**************************
+     * cpu_features detection *
+     **************************/
+
+    namespace detail
+    {
+        inline cpu_features detect_cpu_features() noexcept
+        {
+            cpu_features res;
+#if defined(XTENSOR_CPU_FEATURES_X86)
+            __builtin_cpu_init();
+            res.sse2 = __builtin_cpu_supports("sse2");
+            res.sse4_2 = __builtin_cpu_supports("sse4.2");
+            res.avx = __builtin_cpu_supports("avx");
+            res.avx2 = __builtin_cpu_supports("avx2");
+            res.fma = __builtin_cpu_supports("fma");
+            res.avx512f = __builtin_cpu_supports("avx512f");
+            res.avx512bw = __builtin_cpu_supports("avx512bw");
+            res.avx512dq = __builtin_cpu_supports("avx512dq");
+            res.avx512vl = __builtin_cpu_supports("avx512vl");
+#endif
+            return res;
+        }
+
+        inline simd_target parse_simd_target(const char* name, simd_target fallback) noexcept
+        {
+            if (name == nullptr)
+            {
+                return fallback;
+            }
+            if (std::strcmp(name, "generic") == 0)
+            {
+                return simd_target::generic;
+            }
+            if (std::strcmp(name, "avx2") == 0)
+            {
+                return simd_target::avx2;
+            }
+            if (std::strcmp(name, "avx512") == 0)
+            {
+                return simd_target::avx512;
+            }
+            return fallback;
+        }
+
+        inline simd_target clamp_simd_target(simd_target target) noexcept
+        {
+            return static_cast<int>(target) <= static_cast<int>(best_simd_target()) ? target : best_simd_target();
+        }
+
+        inline std::atomic<int>& dispatch_target_storage() noexcept
+        {
+            // The XTENSOR_SIMD_TARGET environment variable caps the target
+            // selected at startup, e.g. to compare the kernels
+            static std::atomic<int> target(static_cast<int>(
+                clamp_simd_target(parse_simd_target(std::getenv("XTENSOR_SIMD_TARGET"), best_simd_target()))));
+            return target;
+        }
+
+#if defined(XTENSOR_DISPATCH_X86)
+        // The kernel and the functions it calls are inlined in these
+        // wrappers, and compiled for their instruction set
+        template <class F>
+        XTENSOR_TARGET_AVX512 inline void run_kernel_avx512(F& f)
+        {
+            f();
+        }
+
+        template <class F>
+        XTENSOR_TARGET_AVX2 inline void run_kernel_avx2(F& f)
+        {
+            f();
+        }
+#endif
+    }
+
+    /**
+     * Returns the instruction set extensions of the host CPU, detected
+     * on the first call.
+     */
+    inline const cpu_features& host_cpu_features() noexcept
+    {
+        static const cpu_features features = detail::detect_cpu_features();
+        return features;
+    }
+
+    /**
+     * Returns the widest target supported by the host CPU among the
+     * targets the kernels are compiled for. This is always
+     * simd_target::generic when XTENSOR_USE_RUNTIME_DISPATCH is not
+     * defined or on other architectures than x86.
+     */
+    inline simd_target best_simd_target() noexcept
+    {
+#if defined(XTENSOR_DISPATCH_X86)
+        const cpu_features& f = host_cpu_features();
+        if (f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl && f.avx2 && f.fma)
+        {
+            return simd_target::avx512;
+        }
+        if (f.avx2 && f.fma)
+        {
+            return simd_target::avx2;
+        }
+#endif
+        return simd_target::generic;
+    }
+
+    /**
+     * Returns the target the dispatched kernels currently run. It is
+     * resolved once at startup from the CPU, and can be lowered with the
+     * \c XTENSOR_SIMD_TARGET environment variable (\c generic, \c avx2 or
+     * \c avx512).
+     */
+    inline simd_target dispatch_target() noexcept
+    {
+        return static_cast<simd_target>(detail::dispatch_target_storage().load(std::memory_order_relaxed));
+    }
+
+    /**
+     * Makes the dispatched kernels run \c target, or the best target
+     * supported by the CPU if it is wider, and returns the previous one.
+     */
+    inline simd_target set_dispatch_target(simd_target target) noexcept
+    {
+        int previous = detail::dispatch_target_storage().exchange(static_cast<int>(detail::clamp_simd_target(target)));
+        return static_cast<simd_target>(previous);
+    }
+
+    inline const char* simd_target_name(simd_target target) noexcept
+    {
+        switch (target)
+        {
+            case simd_target::avx2:
+                return "avx2";
+            case simd_target::avx512:
+                return "avx512";
+            default:
+                return "generic";
+        }
+    }
+
+    /**
+     * Calls \c f compiled for the current dispatch target. \c f and the
+     * functions it calls are inlined in a copy compiled for each target,
+     * so that its loops are vectorized with the widest registers of the
+     * CPU. Without XTENSOR_USE_RUNTIME_DISPATCH, \c f is simply called.
+     */
+    template <class F>
+    inline void dispatch_kernel(F&& f)
+    {
+#if defined(XTENSOR_DISPATCH_X86)
+        switch (dispatch_target())
+        {
+            case simd_target::avx512:
+                detail::run_kernel_avx512(f);
+                return;
+            case simd_target::avx2:
+                detail::run_kernel_avx2(f);
+                return;
+            default:
+                break;
+        }
+#endif
+        f();
+    }
+
+    namespace detail
+    {
+        template <class F>
+        inline void dispatch_for_impl(F&& f, std::true_type)
+        {
+            dispatch_kernel(std::forward<F>(f));
+        }
+
+        template <class F>
+        inline void dispatch_for_impl(F&& f, std::false_type)
+        {
+            f();
+        }
+    }
+
+    /**
+     * Calls \c f through dispatch_kernel when \c T is an arithmetic type,
+     * directly otherwise; the kernels on other value types do not benefit
+     * from the wider instruction sets.
+     */
+    template <class T, class F>
+    inline void dispatch_for(F&& f)
+    {
+        detail::dispatch_for_impl(std::forward<F>(f), std::is_arithmetic<T>());
+    }
+}
+
+#endif
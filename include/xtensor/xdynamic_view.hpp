@@ -442,7 +442,7 @@ namespace xt
     inline auto xdynamic_view<CT, S, L, FST>::unchecked(Args... args) -> reference
     {
         offset_type offset = base_type::compute_unchecked_index(args...);
-        offset = adjust_offset(args...);
+        offset = adjust_offset(offset, args...);
         return base_type::storage()[static_cast<size_type>(offset)];
     }
 
@@ -451,7 +451,7 @@ namespace xt
     inline auto xdynamic_view<CT, S, L, FST>::unchecked(Args... args) const -> const_reference
     {
         offset_type offset = base_type::compute_unchecked_index(args...);
-        offset = adjust_offset(args...);
+        offset = adjust_offset(offset, args...);
         return base_type::storage()[static_cast<size_type>(offset)];
     }
 
@@ -491,8 +491,12 @@ namespace xt
     inline auto xdynamic_view<CT, S, L, FST>::data_offset() const noexcept -> size_type
     {
         size_type offset = base_type::data_offset();
+        if (m_slices.empty() || m_adj_strides[0] == 0)
+        {
+            return offset;
+        }
         size_type sl_offset = xtl::visit([](const auto& sl) { return sl(size_type(0)); }, m_slices[0]);
-        return offset + sl_offset * m_adj_strides[0];
+        return offset + sl_offset * static_cast<size_type>(m_adj_strides[0]);
     }
 
     template <class CT, class S, layout_type L, class FST>
@@ -596,6 +600,10 @@ namespace xt
     template <class T, class... Args>
     inline auto xdynamic_view<CT, S, L, FST>::adjust_offset(offset_type offset, T idx, Args... args) const noexcept -> offset_type
     {
+        if (m_slices.empty())
+        {
+            return offset;
+        }
         constexpr size_type nb_args = sizeof...(Args) + 1;
         size_type dim = base_type::dimension();
         offset_type res = nb_args > dim ? adjust_offset(offset, args...) : adjust_offset_impl(offset, dim - nb_args, idx, args...);
@@ -613,11 +621,17 @@ namespace xt
     inline auto xdynamic_view<CT, S, L, FST>::adjust_offset_impl(offset_type offset, size_type idx_offset, T idx, Args... args) const noexcept
         -> offset_type
     {
-        offset_type sl_offset = xtl::visit([idx](const auto& sl) {
-                using type = typename std::decay_t<decltype(sl)>::size_type;
-                return sl(type(idx));
-        }, m_slices[idx_offset]);
-        offset_type res = offset + sl_offset * m_adj_strides[idx_offset];
+        // The dimensions not sliced by a keep or a drop slice have a null
+        // adjustment stride
+        offset_type res = offset;
+        if (m_adj_strides[idx_offset] != 0)
+        {
+            offset_type sl_offset = xtl::visit([idx](const auto& sl) {
+                    using type = typename std::decay_t<decltype(sl)>::size_type;
+                    return sl(type(idx));
+            }, m_slices[idx_offset]);
+            res += sl_offset * m_adj_strides[idx_offset];
+        }
         return adjust_offset_impl(res, idx_offset + 1, args...);
     }
 
@@ -632,6 +646,10 @@ namespace xt
     template <class It>
     inline auto xdynamic_view<CT, S, L, FST>::adjust_element_offset(offset_type offset, It first, It last) const noexcept -> offset_type
     {
+        if (m_slices.empty())
+        {
+            return offset;
+        }
         auto dst = std::distance(first, last);
         offset_type dim = static_cast<offset_type>(dimension());
         offset_type loop_offset = dst < dim ? dim - dst : offset_type(0);
@@ -639,6 +657,10 @@ namespace xt
         offset_type res = offset;
         for (offset_type i = loop_offset; i < dim; ++i, ++first)
         {
+            if (m_adj_strides[static_cast<std::size_t>(i)] == 0)
+            {
+                continue;
+            }
             offset_type j = static_cast<offset_type>(first[idx_offset]);
             offset_type sl_offset = xtl::visit([j](const auto& sl) { return static_cast<offset_type>(sl(j)); }, m_slices[static_cast<std::size_t>(i)]);
             res += sl_offset * m_adj_strides[static_cast<std::size_t>(i)];
@@ -658,6 +680,9 @@ namespace xt
             using slice_vector = V;
             using strides_type = dynamic_shape<std::ptrdiff_t>;
 
+            // The slices and their strides are only stored when a keep or a
+            // drop slice is met, the other slices being folded in the strides
+            // of the view
             slice_vector new_slices;
             strides_type new_adj_strides;
 
@@ -665,14 +690,18 @@ namespace xt
 
             inline void resize(std::size_t size)
             {
-                new_slices.resize(size);
-                new_adj_strides.resize(size);
+                m_size = size;
+                new_slices.clear();
+                new_adj_strides.clear();
             }
 
             inline void set_fake_slice(std::size_t idx)
             {
-                new_slices[idx] = xfake_slice<std::ptrdiff_t>();
-                new_adj_strides[idx] = std::ptrdiff_t(0);
+                if (!new_slices.empty())
+                {
+                    new_slices[idx] = xfake_slice<std::ptrdiff_t>();
+                    new_adj_strides[idx] = std::ptrdiff_t(0);
+                }
             }
 
             template <class ST, class S>
@@ -694,6 +723,12 @@ namespace xt
                 auto* sl = xtl::get_if<SL>(&slices[sl_idx]);
                 if (sl != nullptr)
                 {
+                    if (new_slices.empty())
+                    {
+                        new_slices.resize(m_size);
+                        new_adj_strides.resize(m_size);
+                        std::fill(new_adj_strides.begin(), new_adj_strides.end(), std::ptrdiff_t(0));
+                    }
                     new_slices[i] = *sl;
                     auto& ns = xtl::get<SL>(new_slices[i]);
                     ns.normalize(old_shape);
@@ -703,6 +738,10 @@ namespace xt
                 }
                 return sl != nullptr;
             }
+
+        private:
+
+            std::size_t m_size = 0;
         };
     }
 
@@ -0,0 +1,481 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_EINSUM_HPP
+#define XTENSOR_EINSUM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xmatmul.hpp"
+#include "xtensor_config.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /******************
+     * einsum helpers *
+     ******************/
+
+    namespace detail
+    {
+        // Operand of an einsum contraction: a strided tensor whose axes are
+        // named by distinct labels. The intermediate results of the
+        // contraction own their storage; the input operands are read in
+        // place when possible.
+        template <class T>
+        struct einsum_operand
+        {
+            std::string labels;
+            std::vector<std::size_t> shape;
+            std::vector<std::ptrdiff_t> strides;
+            const T* data = nullptr;
+            std::shared_ptr<xarray<T>> storage;
+        };
+
+        struct einsum_subscripts
+        {
+            std::vector<std::string> inputs;
+            std::string output;
+        };
+
+        inline bool einsum_is_label(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        }
+
+        // Parses "ij,jk->ik". Without an explicit output, its labels are the
+        // labels appearing once in the inputs, in alphabetical order.
+        inline einsum_subscripts einsum_parse(const std::string& subscripts)
+        {
+            einsum_subscripts res;
+            std::string lhs = subscripts;
+            std::string::size_type arrow = subscripts.find("->");
+            bool explicit_output = arrow != std::string::npos;
+            if (explicit_output)
+            {
+                lhs = subscripts.substr(0, arrow);
+                for (char c : subscripts.substr(arrow + 2))
+                {
+                    if (einsum_is_label(c))
+                    {
+                        if (res.output.find(c) != std::string::npos)
+                        {
+                            XTENSOR_THROW(std::runtime_error, "einsum: repeated label in the output");
+                        }
+                        res.output.push_back(c);
+                    }
+                    else if (c != ' ')
+                    {
+                        XTENSOR_THROW(std::runtime_error, "einsum: invalid character in the subscripts");
+                    }
+                }
+            }
+
+            res.inputs.emplace_back();
+            for (char c : lhs)
+            {
+                if (einsum_is_label(c))
+                {
+                    res.inputs.back().push_back(c);
+                }
+                else if (c == ',')
+                {
+                    res.inputs.emplace_back();
+                }
+                else if (c != ' ')
+                {
+                    XTENSOR_THROW(std::runtime_error, "einsum: invalid character in the subscripts");
+                }
+            }
+
+            std::map<char, std::size_t> counts;
+            for (const auto& input : res.inputs)
+            {
+                for (char c : input)
+                {
+                    ++counts[c];
+                }
+            }
+            if (explicit_output)
+            {
+                for (char c : res.output)
+                {
+                    if (counts.find(c) == counts.end())
+                    {
+                        XTENSOR_THROW(std::runtime_error, "einsum: output label missing from the inputs");
+                    }
+                }
+            }
+            else
+            {
+                for (const auto& count : counts)
+                {
+                    if (count.second == 1)
+                    {
+                        res.output.push_back(count.first);
+                    }
+                }
+            }
+            return res;
+        }
+
+        template <class T>
+        inline std::vector<std::size_t> einsum_axes(const einsum_operand<T>& op, const std::string& labels)
+        {
+            std::vector<std::size_t> res;
+            res.reserve(labels.size());
+            for (char c : labels)
+            {
+                res.push_back(op.labels.find(c));
+            }
+            return res;
+        }
+
+        template <class T>
+        inline std::vector<std::ptrdiff_t> einsum_offsets(const einsum_operand<T>& op, const std::string& labels)
+        {
+            return gemm_offsets(op.shape, op.strides, einsum_axes(op, labels));
+        }
+
+        template <class T>
+        inline einsum_operand<T> einsum_owning_operand(const std::string& labels, const std::map<char, std::size_t>& extents)
+        {
+            einsum_operand<T> res;
+            res.labels = labels;
+            for (char c : labels)
+            {
+                res.shape.push_back(extents.at(c));
+            }
+            res.storage = std::make_shared<xarray<T>>(xarray<T>::from_shape(res.shape));
+            res.strides.assign(res.storage->strides().cbegin(), res.storage->strides().cend());
+            res.data = res.storage->data();
+            return res;
+        }
+
+        // The axes of an input sharing a label are merged into one axis
+        // whose stride is the sum of their strides, i.e. their diagonal.
+        template <class T, class E>
+        inline einsum_operand<T> einsum_make_operand(const E& e, const std::string& labels,
+                                                     std::map<char, std::size_t>& extents, std::true_type /*in_place*/)
+        {
+            if (labels.size() != e.dimension())
+            {
+                XTENSOR_THROW(std::runtime_error, "einsum: the number of labels does not match the dimension of an operand");
+            }
+            einsum_operand<T> res;
+            res.data = e.data() + e.data_offset();
+            for (std::size_t d = 0; d < labels.size(); ++d)
+            {
+                const char c = labels[d];
+                const std::size_t extent = static_cast<std::size_t>(e.shape()[d]);
+                const std::ptrdiff_t stride = extent == 1 ? 0 : static_cast<std::ptrdiff_t>(e.strides()[d]);
+                auto known = extents.find(c);
+                if (known == extents.end())
+                {
+                    extents[c] = extent;
+                }
+                else if (known->second != extent)
+                {
+                    XTENSOR_THROW(std::runtime_error, "einsum: inconsistent extents for a label");
+                }
+                std::string::size_type pos = res.labels.find(c);
+                if (pos == std::string::npos)
+                {
+                    res.labels.push_back(c);
+                    res.shape.push_back(extent);
+                    res.strides.push_back(stride);
+                }
+                else
+                {
+                    res.strides[pos] += stride;
+                }
+            }
+            return res;
+        }
+
+        template <class T, class E>
+        inline einsum_operand<T> einsum_make_operand(const E& e, const std::string& labels,
+                                                     std::map<char, std::size_t>& extents, std::false_type /*in_place*/)
+        {
+            auto storage = std::make_shared<xarray<T>>(e);
+            einsum_operand<T> res = einsum_make_operand<T>(*storage, labels, extents, std::true_type());
+            res.storage = std::move(storage);
+            return res;
+        }
+
+        // Sums op over its labels missing from labels, and stores the result
+        // with its axes in the order of labels.
+        template <class T>
+        inline einsum_operand<T> einsum_reduce(const einsum_operand<T>& op, const std::string& labels,
+                                               const std::map<char, std::size_t>& extents)
+        {
+            std::string summed;
+            for (char c : op.labels)
+            {
+                if (labels.find(c) == std::string::npos)
+                {
+                    summed.push_back(c);
+                }
+            }
+            auto rows = einsum_offsets(op, labels);
+            auto cols = einsum_offsets(op, summed);
+            einsum_operand<T> res = einsum_owning_operand<T>(labels, extents);
+            T* out = res.storage->data();
+            for (std::size_t i = 0; i < rows.size(); ++i)
+            {
+                const T* src = op.data + rows[i];
+                T acc = T(0);
+                for (std::ptrdiff_t offset : cols)
+                {
+                    acc += src[offset];
+                }
+                out[i] = acc;
+            }
+            return res;
+        }
+
+        // Labels of lhs or rhs still needed after their contraction
+        template <class T>
+        inline std::string einsum_kept_labels(const std::vector<einsum_operand<T>>& ops, std::size_t lhs, std::size_t rhs,
+                                              const std::string& output)
+        {
+            std::string res;
+            auto is_kept = [&](char c)
+            {
+                if (output.find(c) != std::string::npos)
+                {
+                    return true;
+                }
+                for (std::size_t i = 0; i < ops.size(); ++i)
+                {
+                    if (i != lhs && i != rhs && ops[i].labels.find(c) != std::string::npos)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            for (char c : ops[lhs].labels + ops[rhs].labels)
+            {
+                if (res.find(c) == std::string::npos && is_kept(c))
+                {
+                    res.push_back(c);
+                }
+            }
+            return res;
+        }
+
+        // Contracts two operands: the labels they share are either kept as
+        // batch axes or contracted, and each batch is lowered to the gemm
+        // kernel of matmul, or computed directly when it is small.
+        template <class T>
+        inline einsum_operand<T> einsum_contract(const einsum_operand<T>& a, const einsum_operand<T>& b,
+                                                 const std::string& kept, const std::map<char, std::size_t>& extents)
+        {
+            std::string batch, contracted, free_a, free_b;
+            for (char c : a.labels)
+            {
+                bool shared = b.labels.find(c) != std::string::npos;
+                bool keep = kept.find(c) != std::string::npos;
+                if (shared)
+                {
+                    (keep ? batch : contracted).push_back(c);
+                }
+                else
+                {
+                    free_a.push_back(c);
+                }
+            }
+            for (char c : b.labels)
+            {
+                if (a.labels.find(c) == std::string::npos)
+                {
+                    free_b.push_back(c);
+                }
+            }
+
+            auto batch_a = einsum_offsets(a, batch);
+            auto batch_b = einsum_offsets(b, batch);
+            auto rows_a = einsum_offsets(a, free_a);
+            auto cols_a = einsum_offsets(a, contracted);
+            auto rows_b = einsum_offsets(b, contracted);
+            auto cols_b = einsum_offsets(b, free_b);
+            const std::size_t m = rows_a.size();
+            const std::size_t k = cols_a.size();
+            const std::size_t n = cols_b.size();
+
+            einsum_operand<T> res = einsum_owning_operand<T>(batch + free_a + free_b, extents);
+            T* out = res.storage->data();
+            for (std::size_t bi = 0; bi < batch_a.size(); ++bi, out += m * n)
+            {
+                const T* pa = a.data + batch_a[bi];
+                const T* pb = b.data + batch_b[bi];
+                if (m * n * k >= XTENSOR_EINSUM_GEMM_THRESHOLD)
+                {
+                    gemm(m, n, k, pa, rows_a.data(), cols_a.data(), pb, rows_b.data(), cols_b.data(),
+                         out, n, exec::default_policy());
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        for (std::size_t j = 0; j < n; ++j)
+                        {
+                            T acc = T(0);
+                            for (std::size_t p = 0; p < k; ++p)
+                            {
+                                acc += pa[rows_a[i] + cols_a[p]] * pb[rows_b[p] + cols_b[j]];
+                            }
+                            out[i * n + j] = acc;
+                        }
+                    }
+                }
+            }
+            return res;
+        }
+
+        inline std::size_t einsum_size(const std::string& labels, const std::map<char, std::size_t>& extents)
+        {
+            std::size_t res = 1;
+            for (char c : labels)
+            {
+                res *= extents.at(c);
+            }
+            return res;
+        }
+
+        template <class T>
+        inline xarray<T> einsum_impl(const einsum_subscripts& sub, std::vector<einsum_operand<T>> ops,
+                                     const std::map<char, std::size_t>& extents)
+        {
+            // Labels appearing in a single operand and not in the output are
+            // summed first.
+            for (std::size_t i = 0; i < ops.size() && ops.size() > 1; ++i)
+            {
+                std::string kept;
+                for (char c : ops[i].labels)
+                {
+                    bool needed = sub.output.find(c) != std::string::npos;
+                    for (std::size_t j = 0; j < ops.size() && !needed; ++j)
+                    {
+                        needed = j != i && ops[j].labels.find(c) != std::string::npos;
+                    }
+                    if (needed)
+                    {
+                        kept.push_back(c);
+                    }
+                }
+                if (kept.size() != ops[i].labels.size())
+                {
+                    ops[i] = einsum_reduce(ops[i], kept, extents);
+                }
+            }
+
+            // Greedy contraction order: the pair whose result is the
+            // smallest is contracted first.
+            while (ops.size() > 1)
+            {
+                std::size_t best_lhs = 0, best_rhs = 1;
+                std::size_t best_size = 0;
+                bool found = false;
+                for (std::size_t i = 0; i < ops.size(); ++i)
+                {
+                    for (std::size_t j = i + 1; j < ops.size(); ++j)
+                    {
+                        std::size_t size = einsum_size(einsum_kept_labels(ops, i, j, sub.output), extents);
+                        if (!found || size < best_size)
+                        {
+                            best_lhs = i;
+                            best_rhs = j;
+                            best_size = size;
+                            found = true;
+                        }
+                    }
+                }
+                std::string kept = einsum_kept_labels(ops, best_lhs, best_rhs, sub.output);
+                einsum_operand<T> contracted = einsum_contract(ops[best_lhs], ops[best_rhs], kept, extents);
+                ops.erase(ops.begin() + static_cast<std::ptrdiff_t>(best_rhs));
+                ops.erase(ops.begin() + static_cast<std::ptrdiff_t>(best_lhs));
+                ops.push_back(std::move(contracted));
+            }
+
+            einsum_operand<T>& last = ops.front();
+            if (last.labels == sub.output && last.storage != nullptr && last.data == last.storage->data()
+                && last.storage->dimension() == last.labels.size())
+            {
+                return std::move(*last.storage);
+            }
+            return std::move(*einsum_reduce(last, sub.output, extents).storage);
+        }
+    }
+
+    /**********
+     * einsum *
+     **********/
+
+    /**
+     * @brief Evaluates the Einstein summation convention on the operands,
+     * with the semantic of numpy.einsum.
+     *
+     * The subscripts are a comma-separated list of labels, one per axis of
+     * each operand, optionally followed by \c -> and the labels of the
+     * result; without them, the result has the labels appearing once, in
+     * alphabetical order. A label repeated in an operand selects its
+     * diagonal. Labels are letters; ellipsis is not supported.
+     *
+     * The labels belonging to a single operand are summed first, then the
+     * operands are contracted two by two, starting with the pair whose
+     * result is the smallest. Each pairwise contraction is lowered to the
+     * kernel of matmul, the shared labels kept in the result being batch
+     * axes, so that broadcast products are never materialized. Strided
+     * operands are read in place.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> c = xt::einsum("bij,bjk->bik", a, b);
+     * \endcode
+     *
+     * @param subscripts the labels of the operands and of the result
+     * @param e the operands
+     * @return an xarray holding the result
+     */
+    template <class... E>
+    inline auto einsum(const std::string& subscripts, const xexpression<E>&... e)
+    {
+        using value_type = std::common_type_t<typename E::value_type...>;
+        detail::einsum_subscripts sub = detail::einsum_parse(subscripts);
+        if (sub.inputs.size() != sizeof...(E))
+        {
+            XTENSOR_THROW(std::runtime_error, "einsum: the number of operands does not match the subscripts");
+        }
+
+        std::map<char, std::size_t> extents;
+        std::vector<detail::einsum_operand<value_type>> ops;
+        std::size_t index = 0;
+        using expand = int[];
+        (void)expand{0, (ops.push_back(detail::einsum_make_operand<value_type>(
+                              e.derived_cast(), sub.inputs[index++], extents,
+                              std::integral_constant<bool, detail::is_strided_operand<E>::value
+                                                           && std::is_same<typename E::value_type, value_type>::value>())),
+                         0)...};
+        return detail::einsum_impl(sub, std::move(ops), extents);
+    }
+}
+
+#endif
@@ -10,9 +10,14 @@
 #ifndef XTENSOR_EVAL_HPP
 #define XTENSOR_EVAL_HPP
 
+#include <cstddef>
+#include <type_traits>
+
 #include "xexpression_traits.hpp"
+#include "xtensor_config.hpp"
 #include "xtensor_forward.hpp"
 #include "xshape.hpp"
+#include "xutils.hpp"
 
 namespace xt
 {
@@ -49,6 +54,111 @@ namespace xt
     }
     /// @endcond
 
+    /*******************
+     * expression_cost *
+     *******************/
+
+    /**
+     * @class functor_cost
+     * @brief Estimated number of operations of one call to the functor F
+     * of an xfunction.
+     *
+     * Arithmetic and comparison functors cost 1. The transcendental functions
+     * of xmath.hpp and the functions called through a pointer, e.g. by
+     * vectorize, cost XTENSOR_EXPENSIVE_FUNCTOR_COST. The trait can be
+     * specialized for user functors.
+     */
+    template <class F>
+    struct functor_cost : std::integral_constant<std::size_t, 1>
+    {
+    };
+
+    template <class R, class... Args>
+    struct functor_cost<R (*)(Args...)> : std::integral_constant<std::size_t, XTENSOR_EXPENSIVE_FUNCTOR_COST>
+    {
+    };
+
+    /**
+     * @class expression_cost
+     * @brief Estimated number of operations needed to compute one element
+     * of the expression E.
+     *
+     * Reading an element of a container or a scalar is free, an xfunction
+     * costs its functor and the computation of its operands, and a view
+     * costs its underlying expression. The other expressions cost 1, except
+     * the reducers which are always considered expensive.
+     */
+    template <class E>
+    struct expression_cost : std::integral_constant<std::size_t, has_data_interface<E>::value ? 0 : 1>
+    {
+    };
+
+    namespace detail
+    {
+        template <class... CT>
+        struct operands_cost;
+
+        template <>
+        struct operands_cost<> : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template <class CT, class... CTS>
+        struct operands_cost<CT, CTS...>
+            : std::integral_constant<std::size_t, expression_cost<std::decay_t<CT>>::value + operands_cost<CTS...>::value>
+        {
+        };
+    }
+
+    template <class CT>
+    struct expression_cost<xscalar<CT>> : std::integral_constant<std::size_t, 0>
+    {
+    };
+
+    template <class F, class... CT>
+    struct expression_cost<xfunction<F, CT...>>
+        : std::integral_constant<std::size_t, functor_cost<F>::value + detail::operands_cost<CT...>::value>
+    {
+    };
+
+    template <class CT, class... S>
+    struct expression_cost<xview<CT, S...>> : expression_cost<std::decay_t<CT>>
+    {
+    };
+
+    /**
+     * Evaluates an xexpression that is read several times when the
+     * computation of its elements is expensive.
+     *
+     * Lazy expressions are computed again each time they are read. When
+     * the expression_cost of \c t reaches XTENSOR_EVAL_COST_THRESHOLD, it
+     * is evaluated once into an xarray or an xtensor, as done by eval;
+     * otherwise \c t is returned as is (a reference for lvalues), since
+     * computing its elements again is cheaper than writing and reading a
+     * temporary.
+     *
+     * \code{.cpp}
+     * xarray<double> a = {1., 2., 3., 4.};
+     * auto&& b = xt::eval_if_costly(a + 1.); // b is an xfunction
+     * auto&& c = xt::eval_if_costly(xt::exp(a) * xt::sin(a)); // c is xarray<double>
+     * \endcode
+     */
+    template <class T>
+    inline auto eval_if_costly(T&& t)
+        -> std::enable_if_t<expression_cost<std::decay_t<T>>::value < XTENSOR_EVAL_COST_THRESHOLD, xtl::closure_type_t<T>>
+    {
+        return std::forward<T>(t);
+    }
+
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <class T>
+    inline auto eval_if_costly(T&& t)
+        -> std::enable_if_t<expression_cost<std::decay_t<T>>::value >= XTENSOR_EVAL_COST_THRESHOLD, temporary_type_t<T>>
+    {
+        return std::forward<T>(t);
+    }
+    /// @endcond
+
     namespace detail
     {
         /**********************************
@@ -0,0 +1,1049 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_EXECUTION_HPP
+#define XTENSOR_EXECUTION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtask_tracing.hpp"
+#include "xtensor_config.hpp"
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/tbb.h>
+#elif defined(XTENSOR_USE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace xt
+{
+
+    /****************
+     * xthread_pool *
+     ****************/
+
+    /**
+     * @class xthread_pool
+     * @brief Work-stealing thread pool used by the parallel execution policy.
+     *
+     * Each worker owns a task queue; tasks submitted from a worker are pushed
+     * on its own queue and processed in LIFO order, while idle workers steal
+     * the oldest tasks of the other queues. The thread calling parallel_for
+     * always takes part in the computation, so nested parallel loops cannot
+     * deadlock the pool.
+     */
+    class xthread_pool
+    {
+    public:
+
+        using task_type = std::function<void()>;
+
+        explicit xthread_pool(std::size_t n_threads = default_concurrency());
+        ~xthread_pool();
+
+        xthread_pool(const xthread_pool&) = delete;
+        xthread_pool& operator=(const xthread_pool&) = delete;
+
+        xthread_pool(xthread_pool&&) = delete;
+        xthread_pool& operator=(xthread_pool&&) = delete;
+
+        std::size_t size() const noexcept;
+
+        template <class F>
+        void submit(F&& f);
+
+        template <class F>
+        void parallel_for(std::size_t first, std::size_t last, std::size_t grain_size, F&& f);
+
+        static std::size_t default_concurrency() noexcept;
+
+    private:
+
+        struct worker_queue
+        {
+            std::mutex m_mutex;
+            std::deque<task_type> m_tasks;
+        };
+
+        struct worker_id
+        {
+            const xthread_pool* p_pool = nullptr;
+            std::size_t m_index = 0;
+        };
+
+        void worker_loop(std::size_t index);
+        bool pop_task(std::size_t index, task_type& task);
+        bool steal_task(std::size_t index, task_type& task);
+
+        static worker_id& current_worker() noexcept;
+
+        std::vector<std::unique_ptr<worker_queue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::mutex m_wait_mutex;
+        std::condition_variable m_condition;
+        std::size_t m_pending;
+        std::atomic<std::size_t> m_next_queue;
+        bool m_stop;
+    };
+
+    xthread_pool& default_thread_pool();
+
+    /**********************
+     * execution policies *
+     **********************/
+
+    /**
+     * Execution policies split the index range [first, last) of an
+     * assignment loop and call \c f(begin, end) on the resulting
+     * sub-ranges, where \c begin - \c first is a multiple of \c step.
+     * Any type providing a \c for_range method with the same signature
+     * and specializing is_execution_policy can be used as a policy.
+     */
+    namespace exec
+    {
+        /**
+         * @class sequenced_policy
+         * @brief Runs the assignment loop on the calling thread.
+         */
+        struct sequenced_policy
+        {
+            template <class F>
+            void for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const;
+        };
+
+        /**
+         * @class default_policy
+         * @brief Policy selected at compile time through the XTENSOR_USE_TBB
+         * and XTENSOR_USE_OPENMP macros. This is the policy used when no
+         * policy is passed to an assignment.
+         */
+        struct default_policy
+        {
+            template <class F>
+            void for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const;
+        };
+
+        /**
+         * @class parallel_policy
+         * @brief Splits the assignment loop across the workers of an xthread_pool.
+         *
+         * Loops with less than \c threshold iterations run on the calling thread.
+         * A \c grain_size of 0 lets the pool choose the chunk size.
+         */
+        class parallel_policy
+        {
+        public:
+
+            explicit parallel_policy(xthread_pool& pool, std::size_t threshold = 0, std::size_t grain_size = 0) noexcept;
+
+            xthread_pool& pool() const noexcept;
+            std::size_t threshold() const noexcept;
+            std::size_t grain_size() const noexcept;
+
+            template <class F>
+            void for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const;
+
+        private:
+
+            xthread_pool* p_pool;
+            std::size_t m_threshold;
+            std::size_t m_grain_size;
+        };
+
+        /**
+         * @class adaptive_policy
+         * @brief Parallel policy calibrating its threshold and grain size.
+         *
+         * The first time a given loop body runs with this policy, a prefix of
+         * the range is timed on the calling thread to estimate the cost of one
+         * element. The grain size is then chosen so that a task lasts at least
+         * min_task_duration(), and loops shorter than two grains run on the
+         * calling thread. The calibration is made once per loop body type,
+         * i.e. once per assigner instantiation, and is shared by all the
+         * adaptive policies; reset_calibration() discards it.
+         */
+        class adaptive_policy
+        {
+        public:
+
+            explicit adaptive_policy(xthread_pool& pool) noexcept;
+
+            xthread_pool& pool() const noexcept;
+
+            template <class F>
+            void for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const;
+
+        private:
+
+            xthread_pool* p_pool;
+        };
+
+        /**
+         * @class streaming_policy
+         * @brief Wraps an execution policy and requests non-temporal stores
+         * in the SIMD assignment loop, whatever the size of the destination.
+         *
+         * The iterations are scheduled by the wrapped policy.
+         * @tparam P the wrapped execution policy.
+         */
+        template <class P>
+        class streaming_policy
+        {
+        public:
+
+            using base_policy_type = P;
+
+            explicit streaming_policy(const P& policy) noexcept(std::is_nothrow_copy_constructible<P>::value);
+
+            const P& base_policy() const noexcept;
+
+            template <class F>
+            void for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const;
+
+        private:
+
+            P m_policy;
+        };
+
+        constexpr sequenced_policy seq{};
+
+        parallel_policy par(std::size_t threshold = 0, std::size_t grain_size = 0);
+        parallel_policy par(xthread_pool& pool, std::size_t threshold = 0, std::size_t grain_size = 0) noexcept;
+
+        adaptive_policy adaptive();
+        adaptive_policy adaptive(xthread_pool& pool) noexcept;
+
+        streaming_policy<default_policy> streaming() noexcept;
+
+        template <class P>
+        streaming_policy<P> streaming(const P& policy);
+
+        /********************
+         * runtime settings *
+         ********************/
+
+        std::size_t default_threshold() noexcept;
+        void set_default_threshold(std::size_t threshold) noexcept;
+
+        std::size_t default_grain_size() noexcept;
+        void set_default_grain_size(std::size_t grain_size) noexcept;
+
+        std::chrono::nanoseconds min_task_duration() noexcept;
+        void set_min_task_duration(std::chrono::nanoseconds duration) noexcept;
+
+        void reset_calibration() noexcept;
+
+        std::size_t streaming_threshold() noexcept;
+        void set_streaming_threshold(std::size_t bytes) noexcept;
+
+        /**
+         * @class parallel_decision
+         * @brief Describes how the last loop run by an execution policy on
+         * the current thread was scheduled.
+         */
+        struct parallel_decision
+        {
+            /// Number of indices of the loop.
+            std::size_t size = 0;
+            /// Number of indices below which the loop runs on the calling thread.
+            std::size_t threshold = 0;
+            /// Requested number of indices per task, 0 if left to the backend.
+            std::size_t grain_size = 0;
+            /// Estimated cost of one index in nanoseconds, only set by adaptive_policy.
+            double cost_per_element = 0.;
+            /// Whether the loop was split across several threads.
+            bool parallel = false;
+        };
+
+        const parallel_decision& last_decision() noexcept;
+    }
+
+    template <class P>
+    struct is_execution_policy : std::false_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<exec::sequenced_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<exec::default_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<exec::parallel_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<exec::adaptive_policy> : std::true_type
+    {
+    };
+
+    template <class P>
+    struct is_execution_policy<exec::streaming_policy<P>> : is_execution_policy<P>
+    {
+    };
+
+    /*******************************
+     * xthread_pool implementation *
+     *******************************/
+
+    /**
+     * Builds a pool with \c n_threads workers. A pool with 0 workers is valid
+     * and runs every task on the calling thread.
+     */
+    inline xthread_pool::xthread_pool(std::size_t n_threads)
+        : m_pending(0), m_next_queue(0), m_stop(false)
+    {
+        m_queues.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+        {
+            m_queues.emplace_back(new worker_queue());
+        }
+        m_threads.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+        {
+            m_threads.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    inline xthread_pool::~xthread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wait_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (auto& t : m_threads)
+        {
+            t.join();
+        }
+    }
+
+    /**
+     * Returns the number of worker threads of the pool.
+     */
+    inline std::size_t xthread_pool::size() const noexcept
+    {
+        return m_threads.size();
+    }
+
+    /**
+     * Returns the number of workers of the default pool, i.e. one less than
+     * the hardware concurrency since the calling thread also does work.
+     */
+    inline std::size_t xthread_pool::default_concurrency() noexcept
+    {
+        std::size_t n = static_cast<std::size_t>(std::thread::hardware_concurrency());
+        return n > 1 ? n - 1 : 1;
+    }
+
+    /**
+     * Schedules the execution of \c f on a worker of the pool.
+     */
+    template <class F>
+    inline void xthread_pool::submit(F&& f)
+    {
+        if (m_threads.empty())
+        {
+            f();
+            return;
+        }
+
+        worker_id& self = current_worker();
+        std::size_t index = self.p_pool == this ? self.m_index
+                                                : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+        // The counter is raised before the task is visible, so that a worker
+        // that finds it cannot decrement it below zero.
+        {
+            std::lock_guard<std::mutex> lock(m_wait_mutex);
+            ++m_pending;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queues[index]->m_mutex);
+            m_queues[index]->m_tasks.emplace_back(std::forward<F>(f));
+        }
+        m_condition.notify_one();
+    }
+
+    namespace detail
+    {
+        inline std::size_t range_end(std::size_t first, std::size_t last, std::size_t step, std::size_t n) noexcept
+        {
+            return (std::min)(first + n * step, last);
+        }
+
+        struct parallel_for_state
+        {
+            explicit parallel_for_state(std::size_t n_chunks)
+                : m_n_chunks(n_chunks), m_next(0), m_done(0)
+            {
+            }
+
+            std::size_t m_n_chunks;
+            std::atomic<std::size_t> m_next;
+            std::atomic<std::size_t> m_done;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::exception_ptr m_exception;
+        };
+
+        template <class F>
+        inline void run_parallel_chunks(parallel_for_state& state,
+                                        std::size_t first,
+                                        std::size_t last,
+                                        std::size_t grain_size,
+                                        F& f)
+        {
+            std::size_t n_run = 0;
+            std::size_t chunk;
+            while ((chunk = state.m_next.fetch_add(1)) < state.m_n_chunks)
+            {
+                std::size_t begin = first + chunk * grain_size;
+                std::size_t end = (std::min)(begin + grain_size, last);
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+                f(begin, end);
+#else
+                try
+                {
+                    f(begin, end);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(state.m_mutex);
+                    if (!state.m_exception)
+                    {
+                        state.m_exception = std::current_exception();
+                    }
+                }
+#endif
+                ++n_run;
+            }
+            if (n_run != 0 && state.m_done.fetch_add(n_run) + n_run == state.m_n_chunks)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(state.m_mutex);
+                }
+                state.m_condition.notify_all();
+            }
+        }
+    }
+
+    /**
+     * Calls \c f(begin, end) on consecutive sub-ranges of [first, last)
+     * and returns once every sub-range has been processed. Sub-ranges hold
+     * at least \c grain_size elements except for the last one; a grain size
+     * of 0 lets the pool pick one. The first exception thrown by \c f is
+     * rethrown on the calling thread.
+     */
+    template <class F>
+    inline void xthread_pool::parallel_for(std::size_t first, std::size_t last, std::size_t grain_size, F&& f)
+    {
+        if (first >= last)
+        {
+            return;
+        }
+
+        std::size_t n = last - first;
+        // A few chunks per thread keep the load balanced without paying
+        // the scheduling overhead for every element.
+        std::size_t max_chunks = 4 * (size() + 1);
+        if (grain_size == 0 || (n + grain_size - 1) / grain_size > max_chunks)
+        {
+            grain_size = (n + max_chunks - 1) / max_chunks;
+        }
+        std::size_t n_chunks = (n + grain_size - 1) / grain_size;
+
+        if (n_chunks == 1 || m_threads.empty())
+        {
+            f(first, last);
+            return;
+        }
+
+        auto state = std::make_shared<detail::parallel_for_state>(n_chunks);
+        // Helpers only dereference f while chunks remain, and the caller does
+        // not return before every chunk is done, so capturing f by address is safe.
+        auto* pf = &f;
+        std::size_t n_helpers = (std::min)(size(), n_chunks - 1);
+        for (std::size_t i = 0; i < n_helpers; ++i)
+        {
+            submit([state, first, last, grain_size, pf]()
+            {
+                detail::run_parallel_chunks(*state, first, last, grain_size, *pf);
+            });
+        }
+
+        detail::run_parallel_chunks(*state, first, last, grain_size, f);
+
+        {
+            std::unique_lock<std::mutex> lock(state->m_mutex);
+            state->m_condition.wait(lock, [&state]() { return state->m_done.load() == state->m_n_chunks; });
+        }
+
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+        if (state->m_exception)
+        {
+            std::rethrow_exception(state->m_exception);
+        }
+#endif
+    }
+
+    inline void xthread_pool::worker_loop(std::size_t index)
+    {
+        current_worker().p_pool = this;
+        current_worker().m_index = index;
+
+        task_type task;
+        while (true)
+        {
+            if (pop_task(index, task) || steal_task(index, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_wait_mutex);
+            m_condition.wait(lock, [this]() { return m_stop || m_pending != 0; });
+            if (m_stop && m_pending == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    inline bool xthread_pool::pop_task(std::size_t index, task_type& task)
+    {
+        worker_queue& q = *m_queues[index];
+        {
+            std::lock_guard<std::mutex> lock(q.m_mutex);
+            if (q.m_tasks.empty())
+            {
+                return false;
+            }
+            task = std::move(q.m_tasks.back());
+            q.m_tasks.pop_back();
+        }
+        std::lock_guard<std::mutex> lock(m_wait_mutex);
+        --m_pending;
+        return true;
+    }
+
+    inline bool xthread_pool::steal_task(std::size_t index, task_type& task)
+    {
+        std::size_t n = m_queues.size();
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            worker_queue& q = *m_queues[(index + i) % n];
+            {
+                std::lock_guard<std::mutex> lock(q.m_mutex);
+                if (q.m_tasks.empty())
+                {
+                    continue;
+                }
+                task = std::move(q.m_tasks.front());
+                q.m_tasks.pop_front();
+            }
+            std::lock_guard<std::mutex> lock(m_wait_mutex);
+            --m_pending;
+            return true;
+        }
+        return false;
+    }
+
+    inline auto xthread_pool::current_worker() noexcept -> worker_id&
+    {
+        static thread_local worker_id id;
+        return id;
+    }
+
+    /**
+     * Returns the process-wide pool used by exec::par() when no pool is given.
+     */
+    inline xthread_pool& default_thread_pool()
+    {
+        static xthread_pool pool;
+        return pool;
+    }
+
+    /***********************************
+     * runtime settings implementation *
+     ***********************************/
+
+    namespace exec
+    {
+        namespace detail
+        {
+            struct parallel_settings
+            {
+                parallel_settings() noexcept
+#if defined(XTENSOR_USE_TBB)
+                    : m_threshold(XTENSOR_TBB_THRESHOLD),
+#elif defined(XTENSOR_USE_OPENMP)
+                    : m_threshold(XTENSOR_OPENMP_TRESHOLD),
+#else
+                    : m_threshold(0),
+#endif
+                      m_grain_size(0), m_min_task_ns(20000), m_generation(0),
+                      m_streaming_threshold(XTENSOR_STREAMING_THRESHOLD)
+                {
+                }
+
+                std::atomic<std::size_t> m_threshold;
+                std::atomic<std::size_t> m_grain_size;
+                std::atomic<std::size_t> m_min_task_ns;
+                std::atomic<std::size_t> m_generation;
+                std::atomic<std::size_t> m_streaming_threshold;
+            };
+
+            inline parallel_settings& settings() noexcept
+            {
+                static parallel_settings s;
+                return s;
+            }
+
+            inline parallel_decision& current_decision() noexcept
+            {
+                static thread_local parallel_decision d;
+                return d;
+            }
+
+            inline void record_decision(std::size_t size, std::size_t threshold, std::size_t grain_size,
+                                        bool parallel, double cost_per_element = 0.) noexcept
+            {
+                parallel_decision& d = current_decision();
+                d.size = size;
+                d.threshold = threshold;
+                d.grain_size = grain_size;
+                d.cost_per_element = cost_per_element;
+                d.parallel = parallel;
+            }
+
+            struct calibration
+            {
+                std::atomic<std::size_t> m_generation{0};
+                std::atomic<std::size_t> m_grain_size{0};
+                // picoseconds per element, to keep the record lock-free
+                std::atomic<std::size_t> m_cost{0};
+            };
+
+            // One record per loop body type. Lambdas defined in the assigners
+            // have a distinct type per instantiation of the assigner.
+            template <class F>
+            inline calibration& calibration_for() noexcept
+            {
+                static calibration c;
+                return c;
+            }
+
+            template <class P>
+            struct is_streaming_policy : std::false_type
+            {
+            };
+
+            template <class P>
+            struct is_streaming_policy<streaming_policy<P>> : std::true_type
+            {
+            };
+
+            // Whether an assignment writing nbytes with policy should bypass
+            // the cache hierarchy.
+            template <class P>
+            inline bool use_streaming_store(const P&, std::size_t nbytes) noexcept
+            {
+                return is_streaming_policy<P>::value
+                    || nbytes >= settings().m_streaming_threshold.load(std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * Returns the number of elements below which default_policy runs
+         * loops on the calling thread. The initial value is XTENSOR_TBB_THRESHOLD
+         * or XTENSOR_OPENMP_TRESHOLD depending on the parallel backend.
+         */
+        inline std::size_t default_threshold() noexcept
+        {
+            return detail::settings().m_threshold.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Sets the number of elements below which default_policy runs loops
+         * on the calling thread.
+         */
+        inline void set_default_threshold(std::size_t threshold) noexcept
+        {
+            detail::settings().m_threshold.store(threshold, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the grain size used by default_policy with the TBB backend,
+         * 0 meaning that TBB chooses it.
+         */
+        inline std::size_t default_grain_size() noexcept
+        {
+            return detail::settings().m_grain_size.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Sets the grain size used by default_policy with the TBB backend.
+         */
+        inline void set_default_grain_size(std::size_t grain_size) noexcept
+        {
+            detail::settings().m_grain_size.store(grain_size, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the minimal duration of a task scheduled by adaptive_policy
+         * (20us by default).
+         */
+        inline std::chrono::nanoseconds min_task_duration() noexcept
+        {
+            using rep = std::chrono::nanoseconds::rep;
+            return std::chrono::nanoseconds(static_cast<rep>(detail::settings().m_min_task_ns.load(std::memory_order_relaxed)));
+        }
+
+        /**
+         * Sets the minimal duration of a task scheduled by adaptive_policy.
+         * Existing calibrations are discarded.
+         */
+        inline void set_min_task_duration(std::chrono::nanoseconds duration) noexcept
+        {
+            std::size_t ns = duration.count() > 0 ? static_cast<std::size_t>(duration.count()) : std::size_t(0);
+            detail::settings().m_min_task_ns.store(ns, std::memory_order_relaxed);
+            reset_calibration();
+        }
+
+        /**
+         * Discards the calibrations made by adaptive_policy, so that the
+         * next loops measure their cost again.
+         */
+        inline void reset_calibration() noexcept
+        {
+            detail::settings().m_generation.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the size in bytes from which SIMD assignments of contiguous
+         * destinations use non-temporal stores. The initial value is
+         * XTENSOR_STREAMING_THRESHOLD.
+         */
+        inline std::size_t streaming_threshold() noexcept
+        {
+            return detail::settings().m_streaming_threshold.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Sets the size in bytes from which SIMD assignments of contiguous
+         * destinations use non-temporal stores. Passing
+         * <tt>std::numeric_limits<std::size_t>::max()</tt> disables them
+         * except for assignments run with a streaming_policy.
+         */
+        inline void set_streaming_threshold(std::size_t bytes) noexcept
+        {
+            detail::settings().m_streaming_threshold.store(bytes, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the decision taken for the last loop run by an execution
+         * policy on the current thread.
+         */
+        inline const parallel_decision& last_decision() noexcept
+        {
+            return detail::current_decision();
+        }
+    }
+
+    /*************************************
+     * execution policies implementation *
+     *************************************/
+
+    namespace exec
+    {
+        template <class F>
+        inline void sequenced_policy::for_range(std::size_t first, std::size_t last, std::size_t /*step*/, F&& f) const
+        {
+            if (first < last)
+            {
+                detail::record_decision(last - first, 0, 0, false);
+                f(first, last);
+            }
+        }
+
+        template <class F>
+        inline void default_policy::for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const
+        {
+            if (first >= last)
+            {
+                return;
+            }
+            std::size_t threshold = default_threshold();
+            bool parallel = last - first >= threshold;
+#if defined(XTENSOR_USE_TBB)
+            std::size_t grain_size = default_grain_size();
+            detail::record_decision(last - first, threshold, grain_size, parallel);
+            if (parallel)
+            {
+                XTENSOR_TRACE_TASK("default_policy", first, last);
+                std::size_t n_iter = (last - first + step - 1) / step;
+                std::size_t grain_iter = (std::max)(grain_size / step, std::size_t(1));
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n_iter, grain_iter), [&](const tbb::blocked_range<std::size_t>& r)
+                {
+                    std::size_t b = first + r.begin() * step;
+                    std::size_t e = xt::detail::range_end(first, last, step, r.end());
+                    XTENSOR_TRACE_TASK("tbb_task", b, e);
+                    f(b, e);
+                });
+            }
+            else
+            {
+                f(first, last);
+            }
+#elif defined(XTENSOR_USE_OPENMP)
+            detail::record_decision(last - first, threshold, 0, parallel);
+            if (parallel)
+            {
+                XTENSOR_TRACE_TASK("default_policy", first, last);
+                std::ptrdiff_t n_iter = static_cast<std::ptrdiff_t>((last - first + step - 1) / step);
+                #pragma omp parallel
+                {
+                    std::ptrdiff_t n_threads = static_cast<std::ptrdiff_t>(omp_get_num_threads());
+                    std::ptrdiff_t t = static_cast<std::ptrdiff_t>(omp_get_thread_num());
+                    std::size_t b = static_cast<std::size_t>(n_iter * t / n_threads);
+                    std::size_t e = static_cast<std::size_t>(n_iter * (t + 1) / n_threads);
+                    if (b < e)
+                    {
+                        std::size_t tb = first + b * step;
+                        std::size_t te = xt::detail::range_end(first, last, step, e);
+                        XTENSOR_TRACE_TASK("openmp_task", tb, te);
+                        f(tb, te);
+                    }
+                }
+            }
+            else
+            {
+                f(first, last);
+            }
+#else
+            (void) step;
+            (void) parallel;
+            detail::record_decision(last - first, threshold, 0, false);
+            f(first, last);
+#endif
+        }
+
+        inline parallel_policy::parallel_policy(xthread_pool& pool, std::size_t threshold, std::size_t grain_size) noexcept
+            : p_pool(&pool), m_threshold(threshold), m_grain_size(grain_size)
+        {
+        }
+
+        inline xthread_pool& parallel_policy::pool() const noexcept
+        {
+            return *p_pool;
+        }
+
+        inline std::size_t parallel_policy::threshold() const noexcept
+        {
+            return m_threshold;
+        }
+
+        inline std::size_t parallel_policy::grain_size() const noexcept
+        {
+            return m_grain_size;
+        }
+
+        template <class F>
+        inline void parallel_policy::for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const
+        {
+            if (first >= last)
+            {
+                return;
+            }
+            if (last - first < m_threshold)
+            {
+                detail::record_decision(last - first, m_threshold, m_grain_size, false);
+                f(first, last);
+                return;
+            }
+            detail::record_decision(last - first, m_threshold, m_grain_size, p_pool->size() != 0);
+            XTENSOR_TRACE_TASK("parallel_policy", first, last);
+            // The pool partitions iteration numbers, which are mapped back
+            // to indices so that every sub-range starts on a multiple of step.
+            std::size_t n_iter = (last - first + step - 1) / step;
+            p_pool->parallel_for(std::size_t(0), n_iter, m_grain_size / step, [first, last, step, &f](std::size_t b, std::size_t e)
+            {
+                std::size_t tb = first + b * step;
+                std::size_t te = xt::detail::range_end(first, last, step, e);
+                XTENSOR_TRACE_TASK("pool_task", tb, te);
+                f(tb, te);
+            });
+        }
+
+        inline adaptive_policy::adaptive_policy(xthread_pool& pool) noexcept
+            : p_pool(&pool)
+        {
+        }
+
+        inline xthread_pool& adaptive_policy::pool() const noexcept
+        {
+            return *p_pool;
+        }
+
+        template <class F>
+        inline void adaptive_policy::for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const
+        {
+            if (first >= last)
+            {
+                return;
+            }
+
+            std::size_t size = last - first;
+            detail::calibration& c = detail::calibration_for<std::decay_t<F>>();
+            std::size_t generation = detail::settings().m_generation.load(std::memory_order_relaxed) + 1;
+            if (c.m_generation.load(std::memory_order_acquire) != generation)
+            {
+                // Times a prefix of the range; it is part of the loop, so
+                // no work is wasted.
+                constexpr std::size_t sample_size = 4096;
+                std::size_t sample_end = xt::detail::range_end(first, last, step, (sample_size + step - 1) / step);
+                auto start = std::chrono::steady_clock::now();
+                f(first, sample_end);
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                std::size_t sample = sample_end - first;
+                std::size_t elapsed_ps = static_cast<std::size_t>((std::max)(elapsed.count(), std::chrono::nanoseconds::rep(1))) * 1000;
+                std::size_t cost = (std::max)(elapsed_ps / sample, std::size_t(1));
+                std::size_t min_task_ps = static_cast<std::size_t>(min_task_duration().count()) * 1000;
+                std::size_t grain_size = (std::max)(min_task_ps / cost, std::size_t(1));
+                grain_size = ((grain_size + step - 1) / step) * step;
+                c.m_cost.store(cost, std::memory_order_relaxed);
+                c.m_grain_size.store(grain_size, std::memory_order_relaxed);
+                c.m_generation.store(generation, std::memory_order_release);
+                first = sample_end;
+                if (first == last)
+                {
+                    detail::record_decision(size, 2 * grain_size, grain_size, false, static_cast<double>(cost) / 1000.);
+                    return;
+                }
+            }
+
+            std::size_t grain_size = c.m_grain_size.load(std::memory_order_relaxed);
+            double cost = static_cast<double>(c.m_cost.load(std::memory_order_relaxed)) / 1000.;
+            std::size_t threshold = 2 * grain_size;
+            if (last - first < threshold || p_pool->size() == 0)
+            {
+                detail::record_decision(size, threshold, grain_size, false, cost);
+                f(first, last);
+                return;
+            }
+            detail::record_decision(size, threshold, grain_size, true, cost);
+            XTENSOR_TRACE_TASK("adaptive_policy", first, last);
+            std::size_t n_iter = (last - first + step - 1) / step;
+            p_pool->parallel_for(std::size_t(0), n_iter, grain_size / step, [first, last, step, &f](std::size_t b, std::size_t e)
+            {
+                std::size_t tb = first + b * step;
+                std::size_t te = xt::detail::range_end(first, last, step, e);
+                XTENSOR_TRACE_TASK("pool_task", tb, te);
+                f(tb, te);
+            });
+        }
+
+        template <class P>
+        inline streaming_policy<P>::streaming_policy(const P& policy) noexcept(std::is_nothrow_copy_constructible<P>::value)
+            : m_policy(policy)
+        {
+        }
+
+        template <class P>
+        inline const P& streaming_policy<P>::base_policy() const noexcept
+        {
+            return m_policy;
+        }
+
+        template <class P>
+        template <class F>
+        inline void streaming_policy<P>::for_range(std::size_t first, std::size_t last, std::size_t step, F&& f) const
+        {
+            m_policy.for_range(first, last, step, std::forward<F>(f));
+        }
+
+        /**
+         * Returns a parallel policy running on the default thread pool.
+         * @param threshold the number of elements below which the loop runs on the calling thread.
+         * @param grain_size the minimal number of elements processed by a task, 0 for automatic.
+         */
+        inline parallel_policy par(std::size_t threshold, std::size_t grain_size)
+        {
+            return parallel_policy(default_thread_pool(), threshold, grain_size);
+        }
+
+        /**
+         * Returns a parallel policy running on \c pool.
+         * @param pool the pool whose workers run the loop.
+         * @param threshold the number of elements below which the loop runs on the calling thread.
+         * @param grain_size the minimal number of elements processed by a task, 0 for automatic.
+         */
+        inline parallel_policy par(xthread_pool& pool, std::size_t threshold, std::size_t grain_size) noexcept
+        {
+            return parallel_policy(pool, threshold, grain_size);
+        }
+
+        /**
+         * Returns an adaptive policy running on the default thread pool.
+         */
+        inline adaptive_policy adaptive()
+        {
+            return adaptive_policy(default_thread_pool());
+        }
+
+        /**
+         * Returns an adaptive policy running on \c pool.
+         */
+        inline adaptive_policy adaptive(xthread_pool& pool) noexcept
+        {
+            return adaptive_policy(pool);
+        }
+
+        /**
+         * Returns a policy requesting non-temporal stores, scheduled as
+         * default_policy.
+         */
+        inline streaming_policy<default_policy> streaming() noexcept
+        {
+            return streaming_policy<default_policy>(default_policy());
+        }
+
+        /**
+         * Returns a policy requesting non-temporal stores, scheduled as \c policy.
+         * @param policy the execution policy running the loop.
+         */
+        template <class P>
+        inline streaming_policy<P> streaming(const P& policy)
+        {
+            return streaming_policy<P>(policy);
+        }
+    }
+}
+
+#endif
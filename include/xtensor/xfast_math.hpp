@@ -0,0 +1,542 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+/**
+ * @brief approximate mathematical functions for xexpressions
+ */
+
+#ifndef XTENSOR_FAST_MATH_HPP
+#define XTENSOR_FAST_MATH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "xmath.hpp"
+#include "xoperation.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+    namespace fast
+    {
+        /******************
+         * Scalar kernels *
+         ******************/
+
+        // The kernels evaluate polynomials on a reduced argument and
+        // handle the special values with selects instead of branches, so
+        // that the assignment loops calling them are vectorized by the
+        // compiler.
+
+        namespace detail
+        {
+            template <class To, class From>
+            inline To bit_cast(const From& from) noexcept
+            {
+                static_assert(sizeof(To) == sizeof(From), "bit_cast requires types of the same size");
+                To to;
+                std::memcpy(static_cast<void*>(&to), static_cast<const void*>(&from), sizeof(To));
+                return to;
+            }
+
+            template <class T>
+            inline T horner(T, T a) noexcept
+            {
+                return a;
+            }
+
+            // Evaluates the polynomial of coefficients a, b, c... given
+            // from the highest degree.
+            template <class T, class... C>
+            inline T horner(T x, T a, T b, C... c) noexcept
+            {
+                return horner(x, a * x + b, c...);
+            }
+
+            template <class T>
+            inline T clenshaw(T u, T b1, T b2, T c0) noexcept
+            {
+                return u * b1 - b2 + c0;
+            }
+
+            // Evaluates the Chebyshev series of coefficients c given from
+            // the highest degree, the constant term being halved.
+            template <class T, class... C>
+            inline T clenshaw(T u, T b1, T b2, T c, T d, C... rest) noexcept
+            {
+                return clenshaw(u, T(2) * u * b1 - b2 + c, b1, d, rest...);
+            }
+
+            template <class T>
+            struct fast_math_traits;
+
+            template <>
+            struct fast_math_traits<float>
+            {
+                using uint_type = std::uint32_t;
+                using int_type = std::int32_t;
+
+                static constexpr int mantissa_bits = 23;
+                static constexpr int exponent_bias = 127;
+                static constexpr uint_type sign_mask = 0x80000000u;
+                static constexpr uint_type exponent_mask = 0xffu;
+                static constexpr uint_type mantissa_mask = 0x007fffffu;
+
+                static constexpr float shifter() noexcept { return 12582912.f; }
+                static constexpr float exp_min() noexcept { return -104.f; }
+                static constexpr float exp_max() noexcept { return 89.f; }
+                static constexpr float ln2_hi() noexcept { return 0.693359375f; }
+                static constexpr float ln2_lo() noexcept { return -2.12194440e-4f; }
+
+                // exp(r) = 1 + r + r^2 * expm1_poly(r) for |r| <= ln(2) / 2
+                static float expm1_poly(float r) noexcept
+                {
+                    return horner(r, 1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                                  4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f);
+                }
+
+                // log(1 + f) for sqrt(1/2) - 1 <= f < sqrt(2) - 1, the
+                // exponent being added with log_reduced_end
+                static float log_reduced(float f) noexcept
+                {
+                    float z = f * f;
+                    float y = f * z * horner(f, 7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+                                             -1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+                                             2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f);
+                    return f + (y - 0.5f * z);
+                }
+
+                static float log_reduced_end(float logf, float e) noexcept
+                {
+                    return (logf + e * ln2_lo()) + e * ln2_hi();
+                }
+            };
+
+            template <>
+            struct fast_math_traits<double>
+            {
+                using uint_type = std::uint64_t;
+                using int_type = std::int64_t;
+
+                static constexpr int mantissa_bits = 52;
+                static constexpr int exponent_bias = 1023;
+                static constexpr uint_type sign_mask = 0x8000000000000000ull;
+                static constexpr uint_type exponent_mask = 0x7ffull;
+                static constexpr uint_type mantissa_mask = 0x000fffffffffffffull;
+
+                static constexpr double shifter() noexcept { return 6755399441055744.; }
+                static constexpr double exp_min() noexcept { return -746.; }
+                static constexpr double exp_max() noexcept { return 710.; }
+                static constexpr double tanh_max() noexcept { return 22.; }
+                static constexpr double erf_max() noexcept { return 6.; }
+                static constexpr double ln2_hi() noexcept { return 6.93147180369123816490e-01; }
+                static constexpr double ln2_lo() noexcept { return 1.90821492927058770002e-10; }
+
+                static double expm1_poly(double r) noexcept
+                {
+                    return horner(r, 1. / 6227020800., 1. / 479001600., 1. / 39916800., 1. / 3628800.,
+                                  1. / 362880., 1. / 40320., 1. / 5040., 1. / 720., 1. / 120., 1. / 24.,
+                                  1. / 6., 1. / 2.);
+                }
+
+                static double log_reduced(double f) noexcept
+                {
+                    double s = f / (2. + f);
+                    double z = s * s;
+                    double hfsq = 0.5 * f * f;
+                    double r = z * horner(z, 1.479819860511658591e-01, 1.531383769920937332e-01,
+                                          1.818357216161805012e-01, 2.222219843214978396e-01,
+                                          2.857142874366239149e-01, 3.999999999940941908e-01,
+                                          6.666666666666735130e-01);
+                    return f - (hfsq - s * (hfsq + r));
+                }
+
+                static double log_reduced_end(double logf, double e) noexcept
+                {
+                    return (logf + e * ln2_lo()) + e * ln2_hi();
+                }
+
+                static constexpr double pio2_1() noexcept { return 1.570796251296997070312; }
+                static constexpr double pio2_2() noexcept { return 7.549789415861596353e-8; }
+                static constexpr double pio2_3() noexcept { return 5.390302858158119129e-15; }
+
+                static double sin_poly(double z) noexcept
+                {
+                    double zz = z * z;
+                    return z + z * zz * horner(zz, 1.58962301576546568060e-10, -2.50507477628578072866e-8,
+                                               2.75573136213857245213e-6, -1.98412698295895385996e-4,
+                                               8.33333333332211858878e-3, -1.66666666666666307295e-1);
+                }
+
+                static double cos_poly(double z) noexcept
+                {
+                    double zz = z * z;
+                    return 1. - 0.5 * zz
+                        + zz * zz * horner(zz, -1.13585365213876817300e-11, 2.08757008419747316778e-9,
+                                           -2.75573141792967388112e-7, 2.48015872888517045348e-5,
+                                           -1.38888888888730564116e-3, 4.16666666666665929218e-2);
+                }
+
+                static double erf_series(double xx) noexcept
+                {
+                    return horner(xx, -9.06397084280867248e-17, 1.63426140953671519e-15, -2.78351620721092135e-14,
+                                  4.46322426328647734e-13, -6.71136685516411038e-12, 9.42275906465041097e-11,
+                                  -1.22905553017179274e-09, 1.48071928158792172e-08, -1.63658446912349243e-07,
+                                  1.64621143658892474e-06, -1.49256503584062510e-05, 1.20553329817896643e-04,
+                                  -8.54832702345085283e-04, 5.22397762544218784e-03, -2.68661706451312518e-02,
+                                  1.12837916709551257e-01, -3.76126389031837525e-01, 1.12837916709551257e+00);
+                }
+
+                static double erfcx_cheb(double t) noexcept
+                {
+                    double u = 2.4 * (t - 8.333333333333333333e-02);
+                    return clenshaw(u, 0., 0., -2.22600258538430129e-18, 7.08144954893012712e-17, 6.71547202340996158e-16,
+                                    -1.24530106278969432e-15, -6.50307258265531499e-14, -2.80863463013997488e-13,
+                                    4.45937962002541629e-12, 4.93108320645405324e-11, -2.50609641035068342e-10,
+                                    -6.23055823761575327e-09, 1.64653343394370214e-08, 8.12140704316162331e-07,
+                                    -3.79051274037015129e-06, -1.14016501866273531e-04, 1.99526397303254156e-03,
+                                    -1.56295230856285719e-02, 6.25464256442996730e-02, 5.07864225107838540e-01);
+                }
+            };
+
+            template <class T>
+            using fast_uint_t = typename fast_math_traits<T>::uint_type;
+
+            template <class T>
+            using fast_int_t = typename fast_math_traits<T>::int_type;
+
+            // Returns cond ? a : b with integer operations; the compiler
+            // does not speculate the floating point operations computing
+            // the unselected value, which would leave a branch in the loop.
+            template <class T>
+            inline T select(bool cond, T a, T b) noexcept
+            {
+                using uint_type = fast_uint_t<T>;
+                uint_type mask = uint_type(0) - static_cast<uint_type>(cond);
+                return bit_cast<T>((bit_cast<uint_type>(a) & mask) | (bit_cast<uint_type>(b) & ~mask));
+            }
+
+            // 2^k for k in the range of the normal exponents
+            template <class T>
+            inline T pow2(fast_int_t<T> k) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                return bit_cast<T>((static_cast<fast_uint_t<T>>(k) + traits::exponent_bias) << traits::mantissa_bits);
+            }
+
+            // Splits x into k * ln(2) + r with |r| <= ln(2) / 2; k is
+            // rounded with the shifter, which leaves it in the low bits
+            // of the mantissa and avoids converting NaNs to integers.
+            template <class T>
+            inline T exp_reduce(T x, fast_int_t<T>& k) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                T z = x * T(1.44269504088896340736) + traits::shifter();
+                T kf = z - traits::shifter();
+                k = static_cast<fast_int_t<T>>(bit_cast<fast_uint_t<T>>(z) - bit_cast<fast_uint_t<T>>(traits::shifter()));
+                return (x - kf * traits::ln2_hi()) - kf * traits::ln2_lo();
+            }
+
+            template <class T>
+            inline T exp_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                fast_int_t<T> k;
+                T r = exp_reduce(x, k);
+                T p = T(1) + r + r * r * traits::expm1_poly(r);
+                // 2^k is applied in two halves so that the overflows and
+                // the subnormal results are rounded by the multiplications
+                fast_int_t<T> k1 = k / 2;
+                T res = p * pow2<T>(k1) * pow2<T>(k - k1);
+                // the arguments out of range are selected last: clamping
+                // them first lets the compiler duplicate the loop body for
+                // the constant results, which prevents its vectorization
+                res = select(x > traits::exp_max(), std::numeric_limits<T>::infinity(), res);
+                return select(x < traits::exp_min(), T(0), res);
+            }
+
+            // exp(x) - 1 for x >= 0, the results above 2 * tanh_max being
+            // discarded by the caller
+            template <class T>
+            inline T expm1_positive_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                fast_int_t<T> k;
+                T r = exp_reduce(x, k);
+                T p = r + r * r * traits::expm1_poly(r);
+                T s = pow2<T>(k);
+                return s * p + (s - T(1));
+            }
+
+            template <class T>
+            inline T log_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                using uint_type = fast_uint_t<T>;
+                using int_type = fast_int_t<T>;
+                // subnormal inputs are scaled into the normal range
+                bool tiny = x < (std::numeric_limits<T>::min)();
+                T xs = select(tiny, x * pow2<T>(traits::mantissa_bits + 2), x);
+                int_type eadj = tiny ? -(traits::mantissa_bits + 2) : 0;
+                uint_type ix = bit_cast<uint_type>(xs);
+                int_type e = static_cast<int_type>((ix >> traits::mantissa_bits) & traits::exponent_mask)
+                             - (traits::exponent_bias - 1);
+                // m is in [0.5, 1), and brought to [sqrt(1/2), sqrt(2))
+                T m = bit_cast<T>((ix & traits::mantissa_mask) | bit_cast<uint_type>(T(0.5)));
+                bool low = m < T(0.70710678118654752440);
+                e = low ? e - 1 : e;
+                T f = select(low, (m + m) - T(1), m - T(1));
+                // the exponent goes through int32, whose conversion to double
+                // has a vector instruction on more targets than int64
+                T ef = static_cast<T>(static_cast<std::int32_t>(e + eadj));
+                T res = traits::log_reduced_end(traits::log_reduced(f), ef);
+                res = select(x == std::numeric_limits<T>::infinity(), x, res);
+                res = select(x == T(0), -std::numeric_limits<T>::infinity(), res);
+                bool invalid = (x < T(0)) | (x != x);
+                return select(invalid, std::numeric_limits<T>::quiet_NaN(), res);
+            }
+
+            // Reduces |x| to z in [-pi/4, pi/4], with |x| = z + q * pi/2
+            template <class T>
+            inline T trig_reduce(T ax, fast_uint_t<T>& q) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                T z = ax * T(0.63661977236758134308) + traits::shifter();
+                T kf = z - traits::shifter();
+                q = bit_cast<fast_uint_t<T>>(z) - bit_cast<fast_uint_t<T>>(traits::shifter());
+                return ((ax - kf * traits::pio2_1()) - kf * traits::pio2_2()) - kf * traits::pio2_3();
+            }
+
+            template <class T>
+            inline T sin_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                using uint_type = fast_uint_t<T>;
+                uint_type q;
+                T z = trig_reduce(std::abs(x), q);
+                T res = select((q & 1u) != 0, traits::cos_poly(z), traits::sin_poly(z));
+                uint_type sign = (bit_cast<uint_type>(x) & traits::sign_mask)
+                                 ^ ((q & 2u) ? traits::sign_mask : uint_type(0));
+                return bit_cast<T>(bit_cast<uint_type>(res) ^ sign);
+            }
+
+            template <class T>
+            inline T cos_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                using uint_type = fast_uint_t<T>;
+                uint_type q;
+                T z = trig_reduce(std::abs(x), q);
+                T res = select((q & 1u) != 0, traits::sin_poly(z), traits::cos_poly(z));
+                uint_type sign = ((q + 1u) & 2u) ? traits::sign_mask : uint_type(0);
+                return bit_cast<T>(bit_cast<uint_type>(res) ^ sign);
+            }
+
+            template <class T>
+            inline T tanh_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                T ax = std::abs(x);
+                T e = expm1_positive_kernel(ax + ax);
+                T res = select(ax > traits::tanh_max(), T(1), e / (e + T(2)));
+                return std::copysign(res, x);
+            }
+
+            template <class T>
+            inline T erf_kernel(T x) noexcept
+            {
+                using traits = fast_math_traits<T>;
+                T ax = std::abs(x);
+                T small = x * traits::erf_series(x * x);
+                T t = (ax - T(2)) / (ax + T(2));
+                T large = T(1) - exp_kernel(-ax * ax) * traits::erfcx_cheb(t) / ax;
+                large = select(ax >= traits::erf_max(), T(1), large);
+                return select(ax < T(1), small, std::copysign(large, x));
+            }
+
+            // The kernels are used for float and double only, the other
+            // value types falling back to the functions of xmath. The
+            // float versions of the functions whose reduction or final
+            // division loses accuracy are evaluated in double.
+#define XTENSOR_FAST_MATH_KERNEL(NAME, FLOAT_TYPE)                                \
+            inline float fast_##NAME(float x) noexcept                            \
+            {                                                                     \
+                return static_cast<float>(NAME##_kernel(static_cast<FLOAT_TYPE>(x))); \
+            }                                                                     \
+            inline double fast_##NAME(double x) noexcept                          \
+            {                                                                     \
+                return NAME##_kernel(x);                                          \
+            }                                                                     \
+            template <class T>                                                    \
+            inline auto fast_##NAME(const T& x)                                   \
+            {                                                                     \
+                using xt::math::NAME;                                             \
+                return NAME(x);                                                   \
+            }
+
+            XTENSOR_FAST_MATH_KERNEL(exp, float)
+            XTENSOR_FAST_MATH_KERNEL(log, float)
+            XTENSOR_FAST_MATH_KERNEL(sin, double)
+            XTENSOR_FAST_MATH_KERNEL(cos, double)
+            XTENSOR_FAST_MATH_KERNEL(tanh, double)
+            XTENSOR_FAST_MATH_KERNEL(erf, double)
+
+#undef XTENSOR_FAST_MATH_KERNEL
+        }
+
+        /************
+         * Functors *
+         ************/
+
+#define XTENSOR_FAST_MATH_FUNCTOR(NAME)                                           \
+        struct NAME##_fun                                                         \
+        {                                                                         \
+            template <class T>                                                    \
+            auto operator()(const T& arg) const                                   \
+            {                                                                     \
+                return detail::fast_##NAME(arg);                                  \
+            }                                                                     \
+        }
+
+        XTENSOR_FAST_MATH_FUNCTOR(exp);
+        XTENSOR_FAST_MATH_FUNCTOR(log);
+        XTENSOR_FAST_MATH_FUNCTOR(sin);
+        XTENSOR_FAST_MATH_FUNCTOR(cos);
+        XTENSOR_FAST_MATH_FUNCTOR(tanh);
+        XTENSOR_FAST_MATH_FUNCTOR(erf);
+
+#undef XTENSOR_FAST_MATH_FUNCTOR
+
+        /**
+         * @defgroup fast_math_functions Approximate mathematical functions
+         *
+         * The functions of the \c xt::fast namespace trade a few ulps of
+         * accuracy for throughput. They evaluate polynomials instead of
+         * calling the C library, so that the assignment loops are
+         * vectorized by the compiler; build with -O3 and an instruction set
+         * such as AVX2, or define XTENSOR_USE_RUNTIME_DISPATCH, since the
+         * scalar loops may be slower than the standard functions. The errors
+         * given below were measured on a dense sampling of the inputs
+         * against long double references. Infinities and NaNs are handled
+         * like in the standard functions, but the results below the
+         * smallest normal number may be flushed to zero. Other value
+         * types than float and double use the functions of xmath.
+         */
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate natural exponential function.
+         *
+         * Returns an \ref xfunction for the element-wise natural
+         * exponential of \em e, with an error below 1.3 ulp in float and
+         * in double.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto exp(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<exp_fun, E>
+        {
+            return xt::detail::make_xfunction<exp_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate natural logarithm function.
+         *
+         * Returns an \ref xfunction for the element-wise natural
+         * logarithm of \em e, with an error below 0.9 ulp in float and
+         * 1.3 ulp in double.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto log(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<log_fun, E>
+        {
+            return xt::detail::make_xfunction<log_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate sine function.
+         *
+         * Returns an \ref xfunction for the element-wise sine of \em e,
+         * with a correctly rounded result in float for |x| <= 1e9, and an
+         * error below 1.6 ulp in double for |x| <= 8192. Close to the
+         * non-zero multiples of pi, only the absolute error of the double
+         * result is bounded, by about 1e-31 |x|.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto sin(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<sin_fun, E>
+        {
+            return xt::detail::make_xfunction<sin_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate cosine function.
+         *
+         * Returns an \ref xfunction for the element-wise cosine of \em e,
+         * with the same bounds as sin, the error of the double result
+         * reaching 6 ulps for |x| close to 1e9.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto cos(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<cos_fun, E>
+        {
+            return xt::detail::make_xfunction<cos_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate hyperbolic tangent function.
+         *
+         * Returns an \ref xfunction for the element-wise hyperbolic
+         * tangent of \em e, with an error below 0.5 ulp in float and
+         * 2.5 ulps in double.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto tanh(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<tanh_fun, E>
+        {
+            return xt::detail::make_xfunction<tanh_fun>(std::forward<E>(e));
+        }
+
+        /**
+         * @ingroup fast_math_functions
+         * @brief Approximate error function.
+         *
+         * Returns an \ref xfunction for the element-wise error function
+         * of \em e, with an error below 0.5 ulp in float and 1.8 ulp in
+         * double.
+         * @param e an \ref xexpression
+         * @return an \ref xfunction
+         */
+        template <class E>
+        inline auto erf(E&& e) noexcept
+            -> xt::detail::xfunction_type_t<erf_fun, E>
+        {
+            return xt::detail::make_xfunction<erf_fun>(std::forward<E>(e));
+        }
+    }
+}
+
+#endif
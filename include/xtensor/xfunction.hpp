@@ -25,6 +25,7 @@
 #include "xexpression_traits.hpp"
 #include "xiterable.hpp"
 #include "xlayout.hpp"
+#include "xprofiler.hpp"
 #include "xscalar.hpp"
 #include "xshape.hpp"
 #include "xstrides.hpp"
@@ -90,6 +91,52 @@ namespace xt
 
         template <class... CT>
         using xfunction_bool_load_type_t = typename xfunction_bool_load_type<CT...>::type;
+
+        /******************
+         * lambda_functor *
+         ******************/
+
+        template <class T, std::size_t>
+        using lambda_arg_type = const T&;
+
+        // Functor of an xfunction wrapping a user callable of arity N. It exposes
+        // simd_apply when the callable can be invoked with N batches of the same
+        // type, so that generic lambdas are vectorized by the assignment.
+        template <class F, class S>
+        class lambda_functor;
+
+        template <class F, std::size_t... I>
+        class lambda_functor<F, std::index_sequence<I...>>
+        {
+        public:
+
+            template <class Func, class = std::enable_if_t<!std::is_same<std::decay_t<Func>, lambda_functor>::value>>
+            explicit lambda_functor(Func&& f)
+                : m_f(std::forward<Func>(f))
+            {
+            }
+
+            template <class... T>
+            auto operator()(const T&... args) const
+                -> decltype(std::declval<const F&>()(args...))
+            {
+                return m_f(args...);
+            }
+
+            template <class B>
+            auto simd_apply(lambda_arg_type<B, I>... args) const
+                -> decltype(std::declval<const F&>()(args...))
+            {
+                return m_f(args...);
+            }
+
+        private:
+
+            F m_f;
+        };
+
+        template <class F, std::size_t N>
+        using lambda_functor_t = lambda_functor<std::decay_t<F>, std::make_index_sequence<N>>;
     }
 
     /************************
@@ -157,6 +204,18 @@ namespace xt
     {
     };
 
+    /**
+     * Traits class for the functors whose result on integers is congruent
+     * modulo 2^N to their result on the truncations of the arguments to
+     * N bits, e.g. the addition or the bitwise operations. The
+     * assignment of such expressions to narrow integers is vectorized in
+     * the type of the destination.
+     */
+    template <class F>
+    struct is_wrapping_functor : std::false_type
+    {
+    };
+
     /*************
      * xfunction *
      *************/
@@ -353,6 +412,9 @@ namespace xt
 
         void compute_cached_shape() const;
 
+        template <class S>
+        bool broadcast_arguments(S& shape) const;
+
         tuple_type m_e;
         functor_type m_f;
         mutable xfunction_cache<detail::promote_index<typename std::decay_t<CT>::shape_type...>> m_cache;
@@ -468,7 +530,11 @@ namespace xt
         template <class T>
         simd_return_type<T> step_simd();
 
+        template <class T>
+        simd_return_type<T> step_simd(size_type dim);
+
         void step_leading();
+        void step_leading(size_type dim);
 
     private:
 
@@ -478,6 +544,9 @@ namespace xt
         template <class T, std::size_t... I>
         simd_return_type<T> step_simd_impl(std::index_sequence<I...>);
 
+        template <class T, std::size_t... I>
+        simd_return_type<T> step_simd_impl(size_type dim, std::index_sequence<I...>);
+
         const xfunction_type* p_f;
         std::tuple<typename std::decay_t<CT>::const_stepper...> m_st;
     };
@@ -522,6 +591,13 @@ namespace xt
     template <class F, class... CT>
     inline auto xfunction<F, CT...>::dimension() const noexcept -> size_type
     {
+        // The dimension of a function of fixed-dimension arguments is known
+        // at compile time, it does not need to traverse the arguments.
+        constexpr std::ptrdiff_t static_dim = static_dimension<inner_shape_type>::value;
+        if (static_dim != -1)
+        {
+            return static_cast<size_type>(static_dim);
+        }
         size_type dimension = m_cache.is_initialized ? m_cache.shape.size() : compute_dimension();
         return dimension;
     }
@@ -532,10 +608,19 @@ namespace xt
         static_assert(!detail::is_fixed<shape_type>::value, "Calling compute_cached_shape on fixed!");
 
         m_cache.shape = uninitialized_shape<xindex_type_t<inner_shape_type>>(compute_dimension());
-        m_cache.is_trivial = broadcast_shape(m_cache.shape, false);
+        m_cache.is_trivial = broadcast_arguments(m_cache.shape);
         m_cache.is_initialized = true;
     }
 
+    template <class F, class... CT>
+    template <class S>
+    inline bool xfunction<F, CT...>::broadcast_arguments(S& shape) const
+    {
+        // e.broadcast_shape must be evaluated even if b is false
+        auto func = [&shape](bool b, auto&& e) { return e.broadcast_shape(shape) && b; };
+        return accumulate(func, true, m_e);
+    }
+
     /**
      * Returns the shape of the xfunction.
      */
@@ -664,12 +749,31 @@ namespace xt
             std::copy(m_cache.shape.cbegin(), m_cache.shape.cend(), shape.begin());
             return m_cache.is_trivial;
         }
-        else
+        return xtl::mpl::static_if<!detail::is_fixed<inner_shape_type>::value>([&](auto self)
         {
-            // e.broadcast_shape must be evaluated even if b is false
-            auto func = [&shape](bool b, auto&& e) { return e.broadcast_shape(shape) && b; };
-            return accumulate(func, true, m_e);
-        }
+            if (self(this)->m_cache.is_initialized)
+            {
+                // The arguments have already been broadcast, the function
+                // is broadcast to the result as a single operand.
+                return xt::broadcast_shape(self(this)->m_cache.shape, shape) && self(this)->m_cache.is_trivial;
+            }
+            else if (reuse_cache)
+            {
+                // The shape of the function is requested by an assignment,
+                // it is cached for the subsequent evaluations.
+                auto& cache = self(this)->m_cache;
+                cache.shape = uninitialized_shape<xindex_type_t<inner_shape_type>>(shape.size());
+                cache.is_trivial = self(this)->broadcast_arguments(cache.shape);
+                cache.is_initialized = true;
+                std::copy(cache.shape.cbegin(), cache.shape.cend(), shape.begin());
+                return cache.is_trivial;
+            }
+            return self(this)->broadcast_arguments(shape);
+        },
+        /* else */ [&](auto self)
+        {
+            return self(this)->broadcast_arguments(shape);
+        });
     }
 
     /**
@@ -796,6 +900,7 @@ namespace xt
     template <std::size_t... I, class... Args>
     inline auto xfunction<F, CT...>::access_impl(std::index_sequence<I...>, Args... args) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         XTENSOR_TRY(check_index(shape(), args...));
         XTENSOR_CHECK_DIMENSION(shape(), args...);
         return m_f(std::get<I>(m_e)(args...)...);
@@ -805,6 +910,7 @@ namespace xt
     template <std::size_t... I, class... Args>
     inline auto xfunction<F, CT...>::unchecked_impl(std::index_sequence<I...>, Args... args) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         return m_f(std::get<I>(m_e).unchecked(args...)...);
     }
 
@@ -812,6 +918,7 @@ namespace xt
     template <std::size_t... I, class It>
     inline auto xfunction<F, CT...>::element_access_impl(std::index_sequence<I...>, It first, It last) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         XTENSOR_TRY(check_element_index(shape(), first, last));
         return m_f((std::get<I>(m_e).element(first, last))...);
     }
@@ -820,6 +927,7 @@ namespace xt
     template <std::size_t... I>
     inline auto xfunction<F, CT...>::data_element_impl(std::index_sequence<I...>, size_type i) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         return m_f((std::get<I>(m_e).data_element(i))...);
     }
 
@@ -827,6 +935,7 @@ namespace xt
     template <class align, class requested_type, std::size_t N, std::size_t... I>
     inline auto xfunction<F, CT...>::load_simd_impl(std::index_sequence<I...>, size_type i) const
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         return m_f.simd_apply((std::get<I>(m_e)
             .template load_simd<align, requested_type>(i))...);
     }
@@ -931,6 +1040,7 @@ namespace xt
     template <std::size_t... I>
     inline auto xfunction_iterator<F, CT...>::deref_impl(std::index_sequence<I...>) const -> reference
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         return (p_f->m_f)(*std::get<I>(m_it)...);
     }
 
@@ -1036,6 +1146,7 @@ namespace xt
     template <std::size_t... I>
     inline auto xfunction_stepper<F, CT...>::deref_impl(std::index_sequence<I...>) const -> reference
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         return (p_f->m_f)(*std::get<I>(m_st)...);
     }
 
@@ -1043,6 +1154,7 @@ namespace xt
     template <class T, std::size_t... I>
     inline auto xfunction_stepper<F, CT...>::step_simd_impl(std::index_sequence<I...>) -> simd_return_type<T>
     {
+        XTENSOR_PROFILE_NODE(function_node, F);
         return (p_f->m_f.simd_apply)(std::get<I>(m_st). template step_simd<T>()...);
     }
 
@@ -1053,12 +1165,39 @@ namespace xt
         return step_simd_impl<T>(std::make_index_sequence<sizeof...(CT)>());
     }
 
+    template <class F, class... CT>
+    template <class T, std::size_t... I>
+    inline auto xfunction_stepper<F, CT...>::step_simd_impl(size_type dim, std::index_sequence<I...>) -> simd_return_type<T>
+    {
+        XTENSOR_PROFILE_NODE(function_node, F);
+        return (p_f->m_f.simd_apply)(std::get<I>(m_st). template step_simd<T>(dim)...);
+    }
+
+    /**
+     * Returns the next batch of the function along the leading dimension
+     * \c dim of a strided loop: the arguments broadcast along \c dim
+     * contribute a splatted value instead of a load.
+     */
+    template <class F, class... CT>
+    template <class T>
+    inline auto xfunction_stepper<F, CT...>::step_simd(size_type dim) -> simd_return_type<T>
+    {
+        return step_simd_impl<T>(dim, std::make_index_sequence<sizeof...(CT)>());
+    }
+
     template <class F, class... CT>
     inline void xfunction_stepper<F, CT...>::step_leading()
     {
         auto step_leading_lambda = [](auto&& st) { st.step_leading(); };
         for_each(step_leading_lambda, m_st);
     }
+
+    template <class F, class... CT>
+    inline void xfunction_stepper<F, CT...>::step_leading(size_type dim)
+    {
+        auto step_leading_lambda = [dim](auto&& st) { st.step_leading(dim); };
+        for_each(step_leading_lambda, m_st);
+    }
 }
 
 #endif
@@ -22,7 +22,9 @@
 #include "xaccessible.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xshape.hpp"
 #include "xstrides.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 #include "xstrided_view.hpp"
 
@@ -60,6 +62,49 @@ namespace xt
     template <class F, class R, class S>
     class xgenerator;
 
+    namespace detail
+    {
+        template <class F, class = void>
+        struct has_flat_access : std::false_type
+        {
+        };
+
+        template <class F>
+        struct has_flat_access<F, void_t<decltype(std::declval<const F&>().data_element(std::size_t(0)))>>
+            : std::true_type
+        {
+        };
+
+        template <class F, class = void>
+        struct has_row_major_flat_layout : std::false_type
+        {
+        };
+
+        template <class F>
+        struct has_row_major_flat_layout<F, void_t<decltype(F::flat_layout)>>
+            : std::integral_constant<bool, F::flat_layout == layout_type::row_major &&
+                                           XTENSOR_DEFAULT_TRAVERSAL == layout_type::row_major>
+        {
+        };
+    }
+
+    /**
+     * Checks whether an xgenerator with the function type F and the shape
+     * type S is linear, i.e. with a function computing its elements from
+     * their flat index through a data_element method, and either
+     * one-dimensional or with a function declaring that its flat indices
+     * follow the row-major order through a static \c flat_layout member.
+     * A linear xgenerator is assigned like a contiguous container, with
+     * SIMD instructions when the function also provides load_simd.
+     */
+    template <class F, class S>
+    struct is_linear_generator
+        : xtl::conjunction<detail::has_flat_access<std::remove_reference_t<F>>,
+                           xtl::disjunction<std::integral_constant<bool, static_dimension<S>::value == 1>,
+                                            detail::has_row_major_flat_layout<std::remove_reference_t<F>>>>
+    {
+    };
+
     template <class C, class R, class S>
     struct xiterable_inner_types<xgenerator<C, R, S>>
     {
@@ -120,8 +165,10 @@ namespace xt
 
         using bool_load_type = xt::bool_load_type<R>;
 
-        static constexpr layout_type static_layout = layout_type::dynamic;
-        static constexpr bool contiguous_layout = false;
+        static constexpr bool contiguous_layout = is_linear_generator<F, S>::value;
+        static constexpr layout_type static_layout = !contiguous_layout ? layout_type::dynamic
+                                                   : static_dimension<S>::value == 1 ? layout_type::any
+                                                   : layout_type::row_major;
 
         template <class Func>
         xgenerator(Func&& f, const S& shape) noexcept;
@@ -139,6 +186,14 @@ namespace xt
         template <class It>
         const_reference element(It first, It last) const;
 
+        template <class FE = F, class = std::enable_if_t<is_linear_generator<FE, S>::value>>
+        const_reference data_element(size_type i) const;
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xt_simd::simd_traits<requested_type>::size, class FE = functor_type>
+        auto load_simd(size_type i) const
+            -> decltype(std::declval<const FE&>().template load_simd<align, requested_type, N>(i));
+
         template <class O>
         bool broadcast_shape(O& shape, bool reuse_cache = false) const;
 
@@ -238,7 +293,7 @@ namespace xt
     template <class F, class R, class S>
     inline bool xgenerator<F, R, S>::is_contiguous() const noexcept
     {
-        return false;
+        return contiguous_layout;
     }
 
     //@}
@@ -302,6 +357,32 @@ namespace xt
         XTENSOR_TRY(check_element_index(shape(), first, last));
         return m_f.element(bounded_iterator(first, shape().cbegin()), bounded_iterator(last, shape().cend()));
     }
+
+    /**
+     * Returns the element at the specified flat index. Only available
+     * for linear generators.
+     * @param i the flat index of the element
+     * @sa is_linear_generator
+     */
+    template <class F, class R, class S>
+    template <class FE, class>
+    inline auto xgenerator<F, R, S>::data_element(size_type i) const -> const_reference
+    {
+        return m_f.data_element(i);
+    }
+
+    /**
+     * Returns the batch of elements starting at the specified flat index,
+     * computed by the function of the generator.
+     * @param i the flat index of the first element
+     */
+    template <class F, class R, class S>
+    template <class align, class requested_type, std::size_t N, class FE>
+    inline auto xgenerator<F, R, S>::load_simd(size_type i) const
+        -> decltype(std::declval<const FE&>().template load_simd<align, requested_type, N>(i))
+    {
+        return m_f.template load_simd<align, requested_type, N>(i);
+    }
     //@}
 
     /**
@@ -328,9 +409,10 @@ namespace xt
      */
     template <class F, class R, class S>
     template <class O>
-    inline bool xgenerator<F, R, S>::has_linear_assign(const O& /*strides*/) const noexcept
+    inline bool xgenerator<F, R, S>::has_linear_assign(const O& strides) const noexcept
     {
-        return false;
+        return contiguous_layout && (static_dimension<S>::value == 1 ||
+               (strides.size() == m_shape.size() && do_strides_match(m_shape, strides, layout_type::row_major, true)));
     }
     //@}
 
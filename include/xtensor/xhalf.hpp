@@ -0,0 +1,487 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_HALF_HPP
+#define XTENSOR_HALF_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__AVX512BF16__)
+#include <immintrin.h>
+#endif
+
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /***********
+     * float16 *
+     ***********/
+
+    /**
+     * @class float16
+     * @brief IEEE 754 half-precision floating point value.
+     *
+     * float16 is a storage type: it converts implicitly to and from float,
+     * and the arithmetic operations are performed on float, so that an
+     * expression on arrays of float16 is evaluated in single precision
+     * and only rounded to half precision when it is assigned. The
+     * conversions use the F16C instructions when they are enabled.
+     */
+    class float16
+    {
+    public:
+
+        float16() noexcept = default;
+        float16(float value) noexcept;
+
+        template <class T, class = std::enable_if_t<std::is_arithmetic<T>::value>>
+        float16(T value) noexcept;
+
+        operator float() const noexcept;
+
+        float16& operator+=(float rhs) noexcept;
+        float16& operator-=(float rhs) noexcept;
+        float16& operator*=(float rhs) noexcept;
+        float16& operator/=(float rhs) noexcept;
+
+        std::uint16_t bits() const noexcept;
+        static float16 from_bits(std::uint16_t bits) noexcept;
+
+    private:
+
+        std::uint16_t m_bits;
+    };
+
+    /************
+     * bfloat16 *
+     ************/
+
+    /**
+     * @class bfloat16
+     * @brief Brain floating point value, made of the 16 upper bits of a
+     * float.
+     *
+     * Like float16, bfloat16 is a storage type promoted to float in the
+     * computations. Rounding to bfloat16 is a round to nearest even.
+     */
+    class bfloat16
+    {
+    public:
+
+        bfloat16() noexcept = default;
+        bfloat16(float value) noexcept;
+
+        template <class T, class = std::enable_if_t<std::is_arithmetic<T>::value>>
+        bfloat16(T value) noexcept;
+
+        operator float() const noexcept;
+
+        bfloat16& operator+=(float rhs) noexcept;
+        bfloat16& operator-=(float rhs) noexcept;
+        bfloat16& operator*=(float rhs) noexcept;
+        bfloat16& operator/=(float rhs) noexcept;
+
+        std::uint16_t bits() const noexcept;
+        static bfloat16 from_bits(std::uint16_t bits) noexcept;
+
+    private:
+
+        std::uint16_t m_bits;
+    };
+
+    std::ostream& operator<<(std::ostream& out, float16 value);
+    std::ostream& operator<<(std::ostream& out, bfloat16 value);
+
+    void convert_n(const float* first, std::size_t n, float16* out) noexcept;
+    void convert_n(const float16* first, std::size_t n, float* out) noexcept;
+    void convert_n(const float* first, std::size_t n, bfloat16* out) noexcept;
+    void convert_n(const bfloat16* first, std::size_t n, float* out) noexcept;
+
+    /*****************************
+     * conversion implementation *
+     *****************************/
+
+    namespace detail
+    {
+        inline std::uint32_t float_bits(float value) noexcept
+        {
+            std::uint32_t res;
+            std::memcpy(&res, &value, sizeof(res));
+            return res;
+        }
+
+        inline float bits_float(std::uint32_t bits) noexcept
+        {
+            float res;
+            std::memcpy(&res, &bits, sizeof(res));
+            return res;
+        }
+
+        inline std::uint16_t float_to_half(float value) noexcept
+        {
+#if defined(__F16C__)
+            return static_cast<std::uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+            std::uint32_t x = float_bits(value);
+            std::uint32_t sign = (x >> 16) & 0x8000u;
+            std::uint32_t absx = x & 0x7fffffffu;
+            std::uint32_t res;
+            if (absx >= 0x7f800000u)
+            {
+                // Infinity, or NaN kept quiet
+                res = 0x7c00u | (absx > 0x7f800000u ? 0x200u | ((absx >> 13) & 0x3ffu) : 0u);
+            }
+            else if (absx >= 0x477ff000u)
+            {
+                // Rounds above the largest half
+                res = 0x7c00u;
+            }
+            else if (absx < 0x38800000u)
+            {
+                // Subnormal half, rounded to nearest even
+                if (absx <= 0x33000000u)
+                {
+                    res = 0u;
+                }
+                else
+                {
+                    std::uint32_t mantissa = (absx & 0x7fffffu) | 0x800000u;
+                    std::uint32_t shift = 126u - (absx >> 23);
+                    std::uint32_t half_ulp = 1u << (shift - 1u);
+                    std::uint32_t rem = mantissa & ((1u << shift) - 1u);
+                    res = mantissa >> shift;
+                    if (rem > half_ulp || (rem == half_ulp && (res & 1u)))
+                    {
+                        ++res;
+                    }
+                }
+            }
+            else
+            {
+                std::uint32_t rem = absx & 0x1fffu;
+                res = (((absx >> 23) - 112u) << 10) | ((absx >> 13) & 0x3ffu);
+                if (rem > 0x1000u || (rem == 0x1000u && (res & 1u)))
+                {
+                    ++res;
+                }
+            }
+            return static_cast<std::uint16_t>(sign | res);
+#endif
+        }
+
+        inline float half_to_float(std::uint16_t bits) noexcept
+        {
+#if defined(__F16C__)
+            return _cvtsh_ss(bits);
+#else
+            std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+            std::uint32_t exponent = (bits >> 10) & 0x1fu;
+            std::uint32_t mantissa = bits & 0x3ffu;
+            if (exponent == 0u)
+            {
+                // Zero or subnormal, exactly representable in float
+                float res = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+                return sign != 0u ? -res : res;
+            }
+            else if (exponent == 0x1fu)
+            {
+                return bits_float(sign | 0x7f800000u | (mantissa << 13));
+            }
+            return bits_float(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+#endif
+        }
+
+        inline std::uint16_t float_to_bfloat(float value) noexcept
+        {
+            std::uint32_t x = float_bits(value);
+            if ((x & 0x7fffffffu) > 0x7f800000u)
+            {
+                return static_cast<std::uint16_t>((x >> 16) | 0x40u);
+            }
+            x += 0x7fffu + ((x >> 16) & 1u);
+            return static_cast<std::uint16_t>(x >> 16);
+        }
+
+        inline float bfloat_to_float(std::uint16_t bits) noexcept
+        {
+            return bits_float(static_cast<std::uint32_t>(bits) << 16);
+        }
+    }
+
+    /**************************
+     * float16 implementation *
+     **************************/
+
+    inline float16::float16(float value) noexcept
+        : m_bits(detail::float_to_half(value))
+    {
+    }
+
+    template <class T, class>
+    inline float16::float16(T value) noexcept
+        : float16(static_cast<float>(value))
+    {
+    }
+
+    inline float16::operator float() const noexcept
+    {
+        return detail::half_to_float(m_bits);
+    }
+
+    inline float16& float16::operator+=(float rhs) noexcept
+    {
+        return *this = float16(float(*this) + rhs);
+    }
+
+    inline float16& float16::operator-=(float rhs) noexcept
+    {
+        return *this = float16(float(*this) - rhs);
+    }
+
+    inline float16& float16::operator*=(float rhs) noexcept
+    {
+        return *this = float16(float(*this) * rhs);
+    }
+
+    inline float16& float16::operator/=(float rhs) noexcept
+    {
+        return *this = float16(float(*this) / rhs);
+    }
+
+    inline std::uint16_t float16::bits() const noexcept
+    {
+        return m_bits;
+    }
+
+    inline float16 float16::from_bits(std::uint16_t bits) noexcept
+    {
+        float16 res;
+        res.m_bits = bits;
+        return res;
+    }
+
+    /***************************
+     * bfloat16 implementation *
+     ***************************/
+
+    inline bfloat16::bfloat16(float value) noexcept
+        : m_bits(detail::float_to_bfloat(value))
+    {
+    }
+
+    template <class T, class>
+    inline bfloat16::bfloat16(T value) noexcept
+        : bfloat16(static_cast<float>(value))
+    {
+    }
+
+    inline bfloat16::operator float() const noexcept
+    {
+        return detail::bfloat_to_float(m_bits);
+    }
+
+    inline bfloat16& bfloat16::operator+=(float rhs) noexcept
+    {
+        return *this = bfloat16(float(*this) + rhs);
+    }
+
+    inline bfloat16& bfloat16::operator-=(float rhs) noexcept
+    {
+        return *this = bfloat16(float(*this) - rhs);
+    }
+
+    inline bfloat16& bfloat16::operator*=(float rhs) noexcept
+    {
+        return *this = bfloat16(float(*this) * rhs);
+    }
+
+    inline bfloat16& bfloat16::operator/=(float rhs) noexcept
+    {
+        return *this = bfloat16(float(*this) / rhs);
+    }
+
+    inline std::uint16_t bfloat16::bits() const noexcept
+    {
+        return m_bits;
+    }
+
+    inline bfloat16 bfloat16::from_bits(std::uint16_t bits) noexcept
+    {
+        bfloat16 res;
+        res.m_bits = bits;
+        return res;
+    }
+
+    inline std::ostream& operator<<(std::ostream& out, float16 value)
+    {
+        return out << float(value);
+    }
+
+    inline std::ostream& operator<<(std::ostream& out, bfloat16 value)
+    {
+        return out << float(value);
+    }
+
+    /****************************
+     * convert_n implementation *
+     ****************************/
+
+    /**
+     * Rounds \c n floats to half precision, eight at a time with F16C.
+     * The linear assignment of a contiguous float array to a float16 array
+     * goes through this function.
+     */
+    inline void convert_n(const float* first, std::size_t n, float16* out) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(first + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            out[i] = float16(first[i]);
+        }
+    }
+
+    /**
+     * Widens \c n half precision values to float, eight at a time with F16C.
+     */
+    inline void convert_n(const float16* first, std::size_t n, float* out) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            out[i] = float(first[i]);
+        }
+    }
+
+    /**
+     * Rounds \c n floats to bfloat16, sixteen at a time with AVX512-BF16.
+     */
+    inline void convert_n(const float* first, std::size_t n, bfloat16* out) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__AVX512BF16__)
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256bh h = _mm512_cvtneps_pbh(_mm512_loadu_ps(first + i));
+            std::memcpy(static_cast<void*>(out + i), &h, sizeof(h));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            out[i] = bfloat16(first[i]);
+        }
+    }
+
+    /**
+     * Widens \c n bfloat16 values to float.
+     */
+    inline void convert_n(const bfloat16* first, std::size_t n, float* out) noexcept
+    {
+        // A shift of the bits, vectorized by the compiler
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            out[i] = float(first[i]);
+        }
+    }
+}
+
+namespace std
+{
+    template <>
+    class numeric_limits<xt::float16>
+    {
+    public:
+
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr bool has_signaling_NaN = true;
+        static constexpr bool is_iec559 = true;
+        static constexpr bool is_bounded = true;
+        static constexpr bool is_modulo = false;
+        static constexpr int digits = 11;
+        static constexpr int digits10 = 3;
+        static constexpr int max_digits10 = 5;
+        static constexpr int radix = 2;
+        static constexpr int min_exponent = -13;
+        static constexpr int min_exponent10 = -4;
+        static constexpr int max_exponent = 16;
+        static constexpr int max_exponent10 = 4;
+
+        static xt::float16 min() noexcept { return xt::float16::from_bits(0x0400u); }
+        static xt::float16 lowest() noexcept { return xt::float16::from_bits(0xfbffu); }
+        static xt::float16 max() noexcept { return xt::float16::from_bits(0x7bffu); }
+        static xt::float16 epsilon() noexcept { return xt::float16::from_bits(0x1400u); }
+        static xt::float16 round_error() noexcept { return xt::float16::from_bits(0x3800u); }
+        static xt::float16 infinity() noexcept { return xt::float16::from_bits(0x7c00u); }
+        static xt::float16 quiet_NaN() noexcept { return xt::float16::from_bits(0x7e00u); }
+        static xt::float16 signaling_NaN() noexcept { return xt::float16::from_bits(0x7d00u); }
+        static xt::float16 denorm_min() noexcept { return xt::float16::from_bits(0x0001u); }
+    };
+
+    template <>
+    class numeric_limits<xt::bfloat16>
+    {
+    public:
+
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr bool has_signaling_NaN = true;
+        static constexpr bool is_iec559 = false;
+        static constexpr bool is_bounded = true;
+        static constexpr bool is_modulo = false;
+        static constexpr int digits = 8;
+        static constexpr int digits10 = 2;
+        static constexpr int max_digits10 = 4;
+        static constexpr int radix = 2;
+        static constexpr int min_exponent = -125;
+        static constexpr int min_exponent10 = -37;
+        static constexpr int max_exponent = 128;
+        static constexpr int max_exponent10 = 38;
+
+        static xt::bfloat16 min() noexcept { return xt::bfloat16::from_bits(0x0080u); }
+        static xt::bfloat16 lowest() noexcept { return xt::bfloat16::from_bits(0xff7fu); }
+        static xt::bfloat16 max() noexcept { return xt::bfloat16::from_bits(0x7f7fu); }
+        static xt::bfloat16 epsilon() noexcept { return xt::bfloat16::from_bits(0x3c00u); }
+        static xt::bfloat16 round_error() noexcept { return xt::bfloat16::from_bits(0x3f00u); }
+        static xt::bfloat16 infinity() noexcept { return xt::bfloat16::from_bits(0x7f80u); }
+        static xt::bfloat16 quiet_NaN() noexcept { return xt::bfloat16::from_bits(0x7fc0u); }
+        static xt::bfloat16 signaling_NaN() noexcept { return xt::bfloat16::from_bits(0x7fa0u); }
+        static xt::bfloat16 denorm_min() noexcept { return xt::bfloat16::from_bits(0x0001u); }
+    };
+}
+
+#endif
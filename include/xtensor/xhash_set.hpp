@@ -0,0 +1,228 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_HASH_SET_HPP
+#define XTENSOR_HASH_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xt
+{
+    namespace detail
+    {
+        /************
+         * hash_key *
+         ************/
+
+        // Finalizer of MurmurHash3, spreading the bits of keys whose hash is
+        // the identity, such as integers, over the slots of the table
+        inline std::size_t hash_mix(std::uint64_t x) noexcept
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return static_cast<std::size_t>(x);
+        }
+
+        // Bits of a key mixed into a hash: the value of integers, and the
+        // representation of floating point numbers, where -0 and +0, which
+        // compare equal, must have the same bits
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value, std::uint64_t> hash_bits(const T& v) noexcept
+        {
+            return static_cast<std::uint64_t>(v);
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value && sizeof(T) <= sizeof(std::uint64_t), std::uint64_t>
+        hash_bits(const T& v) noexcept
+        {
+            std::uint64_t bits = 0;
+            if (v != T(0))
+            {
+                std::memcpy(&bits, &v, sizeof(T));
+            }
+            return bits;
+        }
+
+        template <class T>
+        struct has_hash_bits
+            : std::integral_constant<bool, std::is_integral<T>::value ||
+                                           (std::is_floating_point<T>::value && sizeof(T) <= sizeof(std::uint64_t))>
+        {
+        };
+
+        template <class T, class = void>
+        struct hash_key
+        {
+            static std::size_t hash(const T& v)
+            {
+                return hash_mix(static_cast<std::uint64_t>(std::hash<T>()(v)));
+            }
+        };
+
+        template <class T>
+        struct hash_key<T, std::enable_if_t<has_hash_bits<T>::value>>
+        {
+            static std::size_t hash(const T& v) noexcept
+            {
+                return hash_mix(hash_bits(v));
+            }
+        };
+
+        /************
+         * hash_set *
+         ************/
+
+        // Open addressing hash set with linear probing, used by the set
+        // operations. Each distinct value gets an id, its rank of insertion,
+        // and the values are kept in insertion order. Values that do not
+        // compare equal to themselves, such as NaN, are all distinct.
+        template <class T>
+        class hash_set
+        {
+        public:
+
+            using value_type = T;
+            using size_type = std::size_t;
+
+            static constexpr size_type npos = size_type(-1);
+
+            explicit hash_set(size_type capacity = 0);
+
+            std::pair<size_type, bool> insert(const value_type& v);
+            size_type find(const value_type& v) const;
+            bool contains(const value_type& v) const;
+
+            size_type size() const noexcept;
+            const std::vector<value_type>& values() const noexcept;
+
+        private:
+
+            struct slot
+            {
+                value_type key;
+                size_type id;
+            };
+
+            size_type probe(const value_type& v) const;
+            void rehash(size_type n_slots);
+
+            std::vector<slot> m_slots;
+            std::vector<value_type> m_values;
+            size_type m_mask;
+        };
+
+        /***************************
+         * hash_set implementation *
+         ***************************/
+
+        template <class T>
+        constexpr typename hash_set<T>::size_type hash_set<T>::npos;
+
+        // The table is kept at most half full, with a power of two number of
+        // slots so that the slot of a hash is obtained with a mask.
+        template <class T>
+        inline hash_set<T>::hash_set(size_type capacity)
+            : m_slots(), m_values(), m_mask(0)
+        {
+            size_type n_slots = 16;
+            while (n_slots < 2 * capacity)
+            {
+                n_slots *= 2;
+            }
+            m_slots.resize(n_slots, slot{value_type(), npos});
+            m_mask = n_slots - 1;
+            m_values.reserve(capacity);
+        }
+
+        template <class T>
+        inline auto hash_set<T>::insert(const value_type& v) -> std::pair<size_type, bool>
+        {
+            size_type i = probe(v);
+            if (m_slots[i].id != npos)
+            {
+                return std::make_pair(m_slots[i].id, false);
+            }
+            if (2 * (m_values.size() + 1) > m_slots.size())
+            {
+                rehash(2 * m_slots.size());
+                i = probe(v);
+            }
+            size_type id = m_values.size();
+            m_slots[i] = slot{v, id};
+            m_values.push_back(v);
+            return std::make_pair(id, true);
+        }
+
+        // Returns the id of v, or npos if v is not in the set
+        template <class T>
+        inline auto hash_set<T>::find(const value_type& v) const -> size_type
+        {
+            return m_slots[probe(v)].id;
+        }
+
+        template <class T>
+        inline bool hash_set<T>::contains(const value_type& v) const
+        {
+            return find(v) != npos;
+        }
+
+        template <class T>
+        inline auto hash_set<T>::size() const noexcept -> size_type
+        {
+            return m_values.size();
+        }
+
+        template <class T>
+        inline auto hash_set<T>::values() const noexcept -> const std::vector<value_type>&
+        {
+            return m_values;
+        }
+
+        // Returns the slot holding v, or the empty slot where it would be
+        // inserted
+        template <class T>
+        inline auto hash_set<T>::probe(const value_type& v) const -> size_type
+        {
+            size_type i = hash_key<value_type>::hash(v) & m_mask;
+            while (m_slots[i].id != npos && !(m_slots[i].key == v))
+            {
+                i = (i + 1) & m_mask;
+            }
+            return i;
+        }
+
+        template <class T>
+        inline void hash_set<T>::rehash(size_type n_slots)
+        {
+            m_slots.assign(n_slots, slot{value_type(), npos});
+            m_mask = n_slots - 1;
+            for (size_type id = 0; id < m_values.size(); ++id)
+            {
+                size_type i = hash_key<value_type>::hash(m_values[id]) & m_mask;
+                while (m_slots[i].id != npos)
+                {
+                    i = (i + 1) & m_mask;
+                }
+                m_slots[i] = slot{m_values[id], id};
+            }
+        }
+    }
+}
+
+#endif
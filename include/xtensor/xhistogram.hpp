@@ -14,6 +14,15 @@
 #ifndef XTENSOR_HISTOGRAM_HPP
 #define XTENSOR_HISTOGRAM_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
 #include "xtensor.hpp"
 #include "xsort.hpp"
 #include "xset_operation.hpp"
@@ -46,71 +55,129 @@ namespace xt
 
     namespace detail
     {
-        template <class R = double, class E1, class E2, class E3>
-        inline auto histogram_imp(E1&& data, E2&& bin_edges, E3&& weights, bool density, bool equal_bins)
+        // Number of samples per task of a histogram accumulation
+        constexpr std::size_t histogram_block = std::size_t(1) << 14;
+
+        // Minimum number of samples per bin for the tasks to use private
+        // counts, their merge costing one pass over the bins per task
+        constexpr std::size_t histogram_private_ratio = 8;
+
+        // Calls f(counts, first, last) to accumulate the samples [first, last)
+        // of n samples in counts. The tasks run in parallel with the default
+        // policy, each one in private counts that are added to count at its
+        // end; a single task writes directly to count.
+        template <class T, class F>
+        inline void accumulate_bins(xtensor<T, 1>& count, std::size_t n, F&& f)
         {
-            using size_type = common_size_type_t<std::decay_t<E1>, std::decay_t<E2>, std::decay_t<E3>>;
-            using value_type = typename std::decay_t<E3>::value_type;
-
-            XTENSOR_ASSERT(data.dimension() == 1);
-            XTENSOR_ASSERT(weights.dimension() == 1);
-            XTENSOR_ASSERT(bin_edges.dimension() == 1);
-            XTENSOR_ASSERT(weights.size() == data.size());
-            XTENSOR_ASSERT(bin_edges.size() >= 2);
-            XTENSOR_ASSERT(std::is_sorted(bin_edges.cbegin(), bin_edges.cend()));
+            std::size_t n_tasks = (n + histogram_block - 1) / histogram_block;
+            if (n_tasks < 2 || n < histogram_private_ratio * count.size())
+            {
+                f(count.data(), std::size_t(0), n);
+                return;
+            }
+            std::mutex mutex;
+            run_sort_tasks(exec::default_policy(), n_tasks, n, [&](std::size_t begin, std::size_t end)
+            {
+                std::size_t first = begin * histogram_block;
+                std::size_t last = (std::min)(end * histogram_block, n);
+                if (begin == 0 && end == n_tasks)
+                {
+                    f(count.data(), first, last);
+                    return;
+                }
+                uvector<T> local(count.size(), T(0));
+                f(local.data(), first, last);
+                std::lock_guard<std::mutex> lock(mutex);
+                std::transform(count.cbegin(), count.cend(), local.cbegin(), count.begin(), std::plus<T>());
+            });
+        }
 
-            size_t n_bins = bin_edges.size() - 1;
-            xt::xtensor<value_type, 1> count = xt::zeros<value_type>({ n_bins });
+        // Adds the weights of the samples of data to the bins of count, whose
+        // count.size() + 1 sorted edges are stored in pe. If equal_bins, the
+        // bins are assumed to have the same width.
+        template <class T, class E1, class U, class E2>
+        inline void histogram_count(xtensor<T, 1>& count, const E1& data, const U* pe, const E2& weights, bool equal_bins)
+        {
+            using value_type = T;
+            using data_type = typename E1::value_type;
 
+            std::size_t n_bins = count.size();
             if (equal_bins)
             {
-                std::array<typename std::decay_t<E2>::value_type, 2> bounds = xt::minmax(bin_edges)();
-                auto left = static_cast<double>(bounds[0]);
-                auto right = static_cast<double>(bounds[1]);
-                double norm = 1. / (right - left);
-                for (size_t i = 0; i < data.size(); ++i)
+                // The bin of a sample is computed from its distance to the
+                // left edge, and corrected with the edges to absorb the
+                // rounding errors.
+                auto left = static_cast<double>(pe[0]);
+                auto right = static_cast<double>(pe[n_bins]);
+                double inv_width = static_cast<double>(n_bins) / (right - left);
+                double max_bin = static_cast<double>(n_bins - 1);
+                accumulate_bins(count, data.size(), [&](value_type* c, std::size_t first, std::size_t last)
                 {
-                    auto v = static_cast<double>(data(i));
-                    // left and right are not bounds of data
-                    if (v >= left && v < right)
-                    {
-                        auto i_bin = static_cast<size_t>(static_cast<double>(n_bins) * (v - left) * norm);
-                        count(i_bin) += weights(i);
-                    }
-                    else if (v == right)
+                    for (std::size_t i = first; i < last; ++i)
                     {
-                        count(n_bins - 1) += weights(i);
+                        auto v = static_cast<double>(data(i));
+                        // left and right are not bounds of data
+                        if (v >= left && v <= right)
+                        {
+                            auto i_bin = static_cast<std::size_t>((std::min)((v - left) * inv_width, max_bin));
+                            if (v < static_cast<double>(pe[i_bin]))
+                            {
+                                --i_bin;
+                            }
+                            else if (i_bin + 1 < n_bins && v >= static_cast<double>(pe[i_bin + 1]))
+                            {
+                                ++i_bin;
+                            }
+                            c[i_bin] += weights(i);
+                        }
                     }
-                }
+                });
             }
             else
             {
-                auto sorter = xt::argsort(data);
-
-                size_type ibin = 0;
-
-                for (auto& idx : sorter)
+                accumulate_bins(count, data.size(), [&](value_type* c, std::size_t first, std::size_t last)
                 {
-                    auto item = data[idx];
-
-                    if (item < bin_edges[0])
+                    std::array<data_type, search_batch> v;
+                    std::array<std::size_t, search_batch> pos;
+                    for (std::size_t i = first; i < last; i += search_batch)
                     {
-                        continue;
+                        std::size_t m = (std::min)(search_batch, last - i);
+                        for (std::size_t b = 0; b < m; ++b)
+                        {
+                            v[b] = data(i + b);
+                        }
+                        batch_search<true>(pe, n_bins + 1, v.data(), m, pos.data());
+                        for (std::size_t b = 0; b < m; ++b)
+                        {
+                            if (!(v[b] < pe[0]) && !(pe[n_bins] < v[b]) && pos[b] != 0)
+                            {
+                                c[(std::min)(pos[b] - 1, n_bins - 1)] += weights(i + b);
+                            }
+                        }
                     }
+                });
+            }
+        }
 
-                    if (item > bin_edges[n_bins])
-                    {
-                        break;
-                    }
+        template <class R = double, class E1, class E2, class E3>
+        inline auto histogram_imp(E1&& data, E2&& bin_edges, E3&& weights, bool density, bool equal_bins)
+        {
+            using size_type = common_size_type_t<std::decay_t<E1>, std::decay_t<E2>, std::decay_t<E3>>;
+            using value_type = typename std::decay_t<E3>::value_type;
+            using edge_type = typename std::decay_t<E2>::value_type;
 
-                    while (item >= bin_edges[ibin + 1] && ibin < n_bins - 1)
-                    {
-                        ++ibin;
-                    }
+            XTENSOR_ASSERT(data.dimension() == 1);
+            XTENSOR_ASSERT(weights.dimension() == 1);
+            XTENSOR_ASSERT(bin_edges.dimension() == 1);
+            XTENSOR_ASSERT(weights.size() == data.size());
+            XTENSOR_ASSERT(bin_edges.size() >= 2);
+            XTENSOR_ASSERT(std::is_sorted(bin_edges.cbegin(), bin_edges.cend()));
 
-                    count[ibin] += weights[idx];
-                }
-            }
+            size_t n_bins = bin_edges.size() - 1;
+            xt::xtensor<value_type, 1> count = xt::zeros<value_type>({ n_bins });
+            uvector<edge_type> edges(bin_edges.size());
+            std::copy(bin_edges.cbegin(), bin_edges.cend(), edges.begin());
+            histogram_count(count, data, edges.data(), weights, equal_bins);
 
             xt::xtensor<R, 1> prob = xt::cast<R>(count);
 
@@ -476,6 +543,114 @@ namespace xt
             std::forward<E1>(data), xt::ones<value_type>({ n }), left, right, bins, mode);
     }
 
+    /**
+     * @ingroup histogram
+     * @brief Defines the estimators of the number of bins used in
+     * "histogram_bin_count".
+     */
+    enum class histogram_bin_estimator
+    {
+        automatic,
+        fd,
+        sturges
+    };
+
+    namespace detail
+    {
+        template <class E>
+        inline std::size_t estimate_bin_count(const E& data, double range, histogram_bin_estimator estimator)
+        {
+            std::size_t n = data.size();
+            if (n == 0 || !(range > 0.))
+            {
+                return std::size_t(1);
+            }
+            double sturges = std::ceil(std::log2(static_cast<double>(n)) + 1.);
+            if (estimator == histogram_bin_estimator::sturges)
+            {
+                return static_cast<std::size_t>(sturges);
+            }
+
+            // The quartiles are selected with a partial sort of a copy of
+            // the data, instead of a full sort
+            auto quartiles = xt::quantile(data, {0.25, 0.75});
+            double iqr = static_cast<double>(quartiles(1)) - static_cast<double>(quartiles(0));
+            if (!(iqr > 0.))
+            {
+                return static_cast<std::size_t>(sturges);
+            }
+            double fd = std::ceil(range * std::cbrt(static_cast<double>(n)) / (2. * iqr));
+            if (estimator == histogram_bin_estimator::automatic)
+            {
+                fd = (std::max)(fd, sturges);
+            }
+            return static_cast<std::size_t>(fd);
+        }
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Estimate the number of bins of equal width of a histogram of a set of data.
+     *
+     * The Freedman-Diaconis estimator (fd) uses bins of width
+     * 2 IQR / cbrt(n), where IQR is the interquartile range of the data,
+     * and is robust to outliers. The Sturges estimator uses log2(n) + 1
+     * bins, which suits small, roughly normal, samples. The automatic
+     * estimator takes the largest of both, and the Freedman-Diaconis
+     * estimator falls back to Sturges when the IQR is zero.
+     *
+     * @param data The data.
+     * @param estimator The estimator to use. [default: "auto"]
+     * @return The number of bins, at least 1.
+     */
+    template <class E1>
+    inline std::size_t histogram_bin_count(E1&& data,
+                                           histogram_bin_estimator estimator = histogram_bin_estimator::automatic)
+    {
+        using value_type = typename std::decay_t<E1>::value_type;
+        XTENSOR_ASSERT(data.dimension() == 1);
+
+        if (data.size() == 0)
+        {
+            return std::size_t(1);
+        }
+        std::array<value_type, 2> left_right;
+        left_right = xt::minmax(data)();
+        double range = static_cast<double>(left_right[1]) - static_cast<double>(left_right[0]);
+        return detail::estimate_bin_count(data, range, estimator);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Compute the bin-edges of a histogram of a set of data, with a
+     * number of bins of equal width given by an estimator.
+     *
+     * @param data The data.
+     * @param estimator The estimator of the number of bins.
+     * @return An one-dimensional xtensor, length: bins+1.
+     * @sa histogram_bin_count
+     */
+    template <class E1>
+    inline auto histogram_bin_edges(E1&& data, histogram_bin_estimator estimator)
+    {
+        using value_type = typename std::decay_t<E1>::value_type;
+        XTENSOR_ASSERT(data.dimension() == 1);
+
+        std::array<value_type, 2> left_right = {value_type(0), value_type(0)};
+        std::size_t bins = 1;
+        if (data.size() != 0)
+        {
+            left_right = xt::minmax(data)();
+            double range = static_cast<double>(left_right[1]) - static_cast<double>(left_right[0]);
+            bins = detail::estimate_bin_count(data, range, estimator);
+        }
+        return histogram_bin_edges(std::forward<E1>(data),
+                                   left_right[0],
+                                   left_right[1],
+                                   bins,
+                                   histogram_algorithm::linspace);
+    }
+
     /**
      * Count number of occurrences of each value in array of non-negative ints.
      *
@@ -517,10 +692,13 @@ namespace xt
         xt::xtensor<result_value_type, 1> res = xt::zeros<result_value_type>(
             { (std::max)(minlength, std::size_t(left_right[1] + 1)) });
 
-        for (size_type i = 0; i < data.size(); ++i)
+        detail::accumulate_bins(res, data.size(), [&](result_value_type* c, size_type first, size_type last)
         {
-            res(data(i)) += weights(i);
-        }
+            for (size_type i = first; i < last; ++i)
+            {
+                c[static_cast<std::size_t>(data(i))] += weights(i);
+            }
+        });
 
         return res;
     }
@@ -533,6 +711,624 @@ namespace xt
                         minlength);
     }
 
+    /**********************
+     * segment reductions *
+     **********************/
+
+    namespace detail
+    {
+        struct segment_sum_op
+        {
+            template <class T>
+            static T identity()
+            {
+                return T(0);
+            }
+
+            template <class T, class U>
+            static void apply(T& acc, const U& v)
+            {
+                acc += static_cast<T>(v);
+            }
+        };
+
+        struct segment_min_op
+        {
+            template <class T>
+            static T identity()
+            {
+                return (std::numeric_limits<T>::max)();
+            }
+
+            template <class T, class U>
+            static void apply(T& acc, const U& v)
+            {
+                acc = static_cast<T>(v) < acc ? static_cast<T>(v) : acc;
+            }
+        };
+
+        struct segment_max_op
+        {
+            template <class T>
+            static T identity()
+            {
+                return std::numeric_limits<T>::lowest();
+            }
+
+            template <class T, class U>
+            static void apply(T& acc, const U& v)
+            {
+                acc = acc < static_cast<T>(v) ? static_cast<T>(v) : acc;
+            }
+        };
+
+        // The rows of values along its first axis and their segment ids,
+        // laid out contiguously.
+        template <class V, class I>
+        struct segment_input
+        {
+            xarray<V, layout_type::row_major> values_storage;
+            xarray<I, layout_type::row_major> ids_storage;
+            const V* values;
+            const I* ids;
+            std::size_t rows;
+            std::size_t inner;
+        };
+
+        template <class E1, class E2>
+        inline auto make_segment_input(const E1& values, const E2& ids, std::size_t num_segments)
+        {
+            using value_type = typename E1::value_type;
+            using id_type = typename E2::value_type;
+            static_assert(xtl::is_integral<id_type>::value, "Segment ids have to be integral type.");
+
+            if (values.dimension() == 0 || ids.dimension() != 1 || ids.size() != values.shape()[0])
+            {
+                XTENSOR_THROW(std::runtime_error, "Segment ids must hold one id per row of values");
+            }
+            segment_input<value_type, id_type> in;
+            in.values = row_major_data(values, in.values_storage);
+            in.ids = row_major_data(ids, in.ids_storage);
+            in.rows = ids.size();
+            in.inner = in.rows == 0 ? std::size_t(0) : values.size() / in.rows;
+            if (in.rows != 0)
+            {
+                auto bounds = std::minmax_element(in.ids, in.ids + in.rows);
+                if (*bounds.first < id_type(0) || static_cast<std::size_t>(*bounds.second) >= num_segments)
+                {
+                    XTENSOR_THROW(std::runtime_error, "Segment ids must be in [0, num_segments)");
+                }
+            }
+            return in;
+        }
+
+        // Reduces with Op the rows of in into the num_segments rows of out.
+        // Sorted ids are split among the tasks at the boundaries of their
+        // segments, so that each task writes its own segments of out;
+        // otherwise the tasks accumulate in private rows merged at their
+        // end, unless there are too few rows per segment for the merge to
+        // pay off.
+        template <class Op, class T, class V, class I, class P>
+        inline void segment_reduce(const segment_input<V, I>& in, std::size_t num_segments, T* out, const P& policy)
+        {
+            const std::size_t inner = in.inner;
+            const std::size_t n = in.rows;
+            const std::size_t size = num_segments * inner;
+            std::fill(out, out + size, Op::template identity<T>());
+            if (n == 0 || inner == 0)
+            {
+                return;
+            }
+
+            auto reduce_rows = [&](T* acc, std::size_t first, std::size_t last)
+            {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    T* o = acc + static_cast<std::size_t>(in.ids[i]) * inner;
+                    const V* v = in.values + i * inner;
+                    for (std::size_t j = 0; j < inner; ++j)
+                    {
+                        Op::apply(o[j], v[j]);
+                    }
+                }
+            };
+
+            const std::size_t block = (std::max)(std::size_t(1), histogram_block / inner);
+            const std::size_t n_tasks = (n + block - 1) / block;
+            if (std::is_sorted(in.ids, in.ids + n))
+            {
+                run_sort_tasks(policy, n_tasks, n * inner, [&](std::size_t begin, std::size_t end)
+                {
+                    std::size_t first = begin * block;
+                    std::size_t last = (std::min)(end * block, n);
+                    // the segment running over the first row belongs to the previous task
+                    while (first != 0 && first < last && in.ids[first] == in.ids[first - 1])
+                    {
+                        ++first;
+                    }
+                    if (first == last)
+                    {
+                        return;
+                    }
+                    while (last < n && in.ids[last] == in.ids[last - 1])
+                    {
+                        ++last;
+                    }
+                    reduce_rows(out, first, last);
+                });
+                return;
+            }
+
+            if (n_tasks < 2 || n < histogram_private_ratio * num_segments)
+            {
+                reduce_rows(out, std::size_t(0), n);
+                return;
+            }
+            std::mutex mutex;
+            run_sort_tasks(policy, n_tasks, n * inner, [&](std::size_t begin, std::size_t end)
+            {
+                std::size_t first = begin * block;
+                std::size_t last = (std::min)(end * block, n);
+                if (begin == 0 && end == n_tasks)
+                {
+                    reduce_rows(out, first, last);
+                    return;
+                }
+                uvector<T> local(size, Op::template identity<T>());
+                reduce_rows(local.data(), first, last);
+                std::lock_guard<std::mutex> lock(mutex);
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    Op::apply(out[j], local[j]);
+                }
+            });
+        }
+
+        template <class R, class S>
+        inline auto make_segment_result(const S& values_shape, std::size_t num_segments)
+        {
+            using result_type = xarray<R, layout_type::row_major>;
+            typename result_type::shape_type shape(values_shape.cbegin(), values_shape.cend());
+            shape[0] = num_segments;
+            return result_type::from_shape(shape);
+        }
+
+        template <class Op, class E1, class E2, class P>
+        inline auto segment_reduction(const E1& values, const E2& ids, std::size_t num_segments, const P& policy)
+        {
+            using value_type = typename E1::value_type;
+            auto in = make_segment_input(values, ids, num_segments);
+            auto res = make_segment_result<value_type>(values.shape(), num_segments);
+            segment_reduce<Op>(in, num_segments, res.data(), policy);
+            return res;
+        }
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Sum of the rows of values in each segment.
+     *
+     * The rows of \c values along its first axis are added to the row
+     * \c segment_ids[i] of the result, as np.add.at. The ids need not be
+     * sorted, sorted ids being detected and reduced segment by segment.
+     * Empty segments hold zero.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @param policy the execution policy splitting the rows
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto segment_sum(const xexpression<E1>& values, const xexpression<E2>& segment_ids,
+                            std::size_t num_segments, const P& policy)
+    {
+        return detail::segment_reduction<detail::segment_sum_op>(values.derived_cast(), segment_ids.derived_cast(),
+                                                                 num_segments, policy);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Sum of the rows of values in each segment.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     * @sa segment_sum(const xexpression<E1>&, const xexpression<E2>&, std::size_t, const P&)
+     */
+    template <class E1, class E2>
+    inline auto segment_sum(const xexpression<E1>& values, const xexpression<E2>& segment_ids, std::size_t num_segments)
+    {
+        return segment_sum(values, segment_ids, num_segments, exec::default_policy());
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Mean of the rows of values in each segment.
+     *
+     * The mean holds doubles when \c values holds integers. Empty segments
+     * hold zero.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @param policy the execution policy splitting the rows
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto segment_mean(const xexpression<E1>& values, const xexpression<E2>& segment_ids,
+                             std::size_t num_segments, const P& policy)
+    {
+        using value_type = typename E1::value_type;
+        using result_type = detail::axis_integral_type<value_type>;
+
+        const auto& dv = values.derived_cast();
+        auto in = detail::make_segment_input(dv, segment_ids.derived_cast(), num_segments);
+        auto res = detail::make_segment_result<result_type>(dv.shape(), num_segments);
+        detail::segment_reduce<detail::segment_sum_op>(in, num_segments, res.data(), policy);
+
+        std::vector<std::size_t> count(num_segments, std::size_t(0));
+        for (std::size_t i = 0; i < in.rows; ++i)
+        {
+            ++count[static_cast<std::size_t>(in.ids[i])];
+        }
+        result_type* r = res.data();
+        for (std::size_t s = 0; s < num_segments; ++s)
+        {
+            if (count[s] != 0)
+            {
+                const result_type c = static_cast<result_type>(count[s]);
+                for (std::size_t j = 0; j < in.inner; ++j)
+                {
+                    r[s * in.inner + j] /= c;
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Mean of the rows of values in each segment.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     * @sa segment_mean(const xexpression<E1>&, const xexpression<E2>&, std::size_t, const P&)
+     */
+    template <class E1, class E2>
+    inline auto segment_mean(const xexpression<E1>& values, const xexpression<E2>& segment_ids, std::size_t num_segments)
+    {
+        return segment_mean(values, segment_ids, num_segments, exec::default_policy());
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Minimum of the rows of values in each segment.
+     *
+     * Empty segments hold the largest value of the value type.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @param policy the execution policy splitting the rows
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto segment_min(const xexpression<E1>& values, const xexpression<E2>& segment_ids,
+                            std::size_t num_segments, const P& policy)
+    {
+        return detail::segment_reduction<detail::segment_min_op>(values.derived_cast(), segment_ids.derived_cast(),
+                                                                 num_segments, policy);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Minimum of the rows of values in each segment.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     * @sa segment_min(const xexpression<E1>&, const xexpression<E2>&, std::size_t, const P&)
+     */
+    template <class E1, class E2>
+    inline auto segment_min(const xexpression<E1>& values, const xexpression<E2>& segment_ids, std::size_t num_segments)
+    {
+        return segment_min(values, segment_ids, num_segments, exec::default_policy());
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Maximum of the rows of values in each segment.
+     *
+     * Empty segments hold the lowest value of the value type.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @param policy the execution policy splitting the rows
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto segment_max(const xexpression<E1>& values, const xexpression<E2>& segment_ids,
+                            std::size_t num_segments, const P& policy)
+    {
+        return detail::segment_reduction<detail::segment_max_op>(values.derived_cast(), segment_ids.derived_cast(),
+                                                                 num_segments, policy);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Maximum of the rows of values in each segment.
+     *
+     * @param values the values to reduce
+     * @param segment_ids a 1D container holding the segment in [0, num_segments) of each row of \c values
+     * @param num_segments the number of segments
+     * @return an xarray of shape (num_segments, values.shape()[1:]...)
+     * @sa segment_max(const xexpression<E1>&, const xexpression<E2>&, std::size_t, const P&)
+     */
+    template <class E1, class E2>
+    inline auto segment_max(const xexpression<E1>& values, const xexpression<E2>& segment_ids, std::size_t num_segments)
+    {
+        return segment_max(values, segment_ids, num_segments, exec::default_policy());
+    }
+
+    /*************************
+     * histogram_accumulator *
+     *************************/
+
+    /**
+     * @class histogram_accumulator
+     * @brief Histogram accumulated over batches of data.
+     *
+     * The histogram_accumulator class counts the samples of successive
+     * batches of data in fixed bins, so that the batches never need to be
+     * concatenated nor the bin edges to be computed again. Each batch is
+     * counted with the same kernels as histogram, and accumulators built
+     * with the same bins, for instance on different threads, can be
+     * combined with merge.
+     *
+     * @tparam T the value type of the bin edges
+     * @tparam W the value type of the weights and of the counts
+     */
+    template <class T = double, class W = double>
+    class histogram_accumulator
+    {
+    public:
+
+        using edge_type = T;
+        using value_type = W;
+        using edges_type = xtensor<edge_type, 1>;
+        using count_type = xtensor<value_type, 1>;
+        using size_type = std::size_t;
+
+        template <class E>
+        explicit histogram_accumulator(const xexpression<E>& bin_edges);
+
+        histogram_accumulator(size_type bins, edge_type left, edge_type right);
+
+        template <class E>
+        void add(const xexpression<E>& data);
+
+        template <class E1, class E2>
+        void add(const xexpression<E1>& data, const xexpression<E2>& weights);
+
+        void merge(const histogram_accumulator& other);
+
+        const edges_type& bin_edges() const noexcept;
+        const count_type& count() const noexcept;
+        size_type samples() const noexcept;
+
+        template <class R = double>
+        xtensor<R, 1> density() const;
+
+        void reset();
+
+    private:
+
+        edges_type m_edges;
+        count_type m_count;
+        size_type m_samples;
+        bool m_equal_bins;
+    };
+
+    template <class W = double, class E>
+    histogram_accumulator<typename E::value_type, W> make_histogram_accumulator(const xexpression<E>& bin_edges);
+
+    template <class W = double, class T>
+    histogram_accumulator<T, W> make_histogram_accumulator(std::size_t bins, T left, T right);
+
+    /****************************************
+     * histogram_accumulator implementation *
+     ****************************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty accumulator with the given bins.
+     * @param bin_edges The bin-edges. It has to be 1-dimensional and monotonic.
+     */
+    template <class T, class W>
+    template <class E>
+    inline histogram_accumulator<T, W>::histogram_accumulator(const xexpression<E>& bin_edges)
+        : m_edges(bin_edges), m_count(), m_samples(0), m_equal_bins(false)
+    {
+        XTENSOR_ASSERT(m_edges.size() >= 2);
+        XTENSOR_ASSERT(std::is_sorted(m_edges.cbegin(), m_edges.cend()));
+        m_count = xt::zeros<value_type>({ m_edges.size() - 1 });
+    }
+
+    /**
+     * Constructs an empty accumulator with bins of equal width.
+     * @param bins The number of bins.
+     * @param left The lower-most edge.
+     * @param right The upper-most edge.
+     */
+    template <class T, class W>
+    inline histogram_accumulator<T, W>::histogram_accumulator(size_type bins, edge_type left, edge_type right)
+        : m_edges(xt::linspace<edge_type>(left, right, bins + 1)), m_count(xt::zeros<value_type>({ bins })),
+          m_samples(0), m_equal_bins(true)
+    {
+        XTENSOR_ASSERT(left <= right);
+        XTENSOR_ASSERT(bins > size_type(0));
+    }
+    //@}
+
+    /**
+     * @name Accumulation
+     */
+    //@{
+    /**
+     * Counts the samples of \c data.
+     * @param data 1-D expression holding the batch of samples
+     */
+    template <class T, class W>
+    template <class E>
+    inline void histogram_accumulator<T, W>::add(const xexpression<E>& data)
+    {
+        const auto& de = data.derived_cast();
+        add(de, xt::ones<value_type>({ de.size() }));
+    }
+
+    /**
+     * Adds the weights of the samples of \c data to their bins.
+     * @param data 1-D expression holding the batch of samples
+     * @param weights Weight factors corresponding to each data-point.
+     */
+    template <class T, class W>
+    template <class E1, class E2>
+    inline void histogram_accumulator<T, W>::add(const xexpression<E1>& data, const xexpression<E2>& weights)
+    {
+        const auto& de = data.derived_cast();
+        const auto& dw = weights.derived_cast();
+        XTENSOR_ASSERT(de.dimension() == 1);
+        XTENSOR_ASSERT(dw.dimension() == 1);
+        XTENSOR_ASSERT(dw.size() == de.size());
+        detail::histogram_count(m_count, de, m_edges.data(), dw, m_equal_bins);
+        m_samples += de.size();
+    }
+
+    /**
+     * Adds the counts of \c other to this accumulator.
+     * @param other an accumulator with the same bin edges
+     * @throws std::runtime_error if the bin edges differ.
+     */
+    template <class T, class W>
+    inline void histogram_accumulator<T, W>::merge(const histogram_accumulator& other)
+    {
+        if (other.m_edges.size() != m_edges.size() ||
+            !std::equal(m_edges.cbegin(), m_edges.cend(), other.m_edges.cbegin()))
+        {
+            XTENSOR_THROW(std::runtime_error, "Incompatible bin edges in histogram merge.");
+        }
+        m_count += other.m_count;
+        m_samples += other.m_samples;
+    }
+    //@}
+
+    /**
+     * @name Result
+     */
+    //@{
+    /**
+     * Returns the bin edges.
+     */
+    template <class T, class W>
+    inline auto histogram_accumulator<T, W>::bin_edges() const noexcept -> const edges_type&
+    {
+        return m_edges;
+    }
+
+    /**
+     * Returns the weighted number of samples of each bin.
+     */
+    template <class T, class W>
+    inline auto histogram_accumulator<T, W>::count() const noexcept -> const count_type&
+    {
+        return m_count;
+    }
+
+    /**
+     * Returns the number of samples added so far, including those outside
+     * of the bins and those of the merged accumulators.
+     */
+    template <class T, class W>
+    inline auto histogram_accumulator<T, W>::samples() const noexcept -> size_type
+    {
+        return m_samples;
+    }
+
+    /**
+     * Returns the counts normalized by the number of samples and the width
+     * of the bins, as histogram with \c density set to true.
+     * @tparam R the value type of the result
+     */
+    template <class T, class W>
+    template <class R>
+    inline xtensor<R, 1> histogram_accumulator<T, W>::density() const
+    {
+        xtensor<R, 1> prob = xt::cast<R>(m_count);
+        R n = static_cast<R>(m_samples);
+        for (size_type i = 0; i < prob.size(); ++i)
+        {
+            prob[i] /= (static_cast<R>(m_edges[i + 1] - m_edges[i]) * n);
+        }
+        return prob;
+    }
+
+    /**
+     * Discards the counts.
+     */
+    template <class T, class W>
+    inline void histogram_accumulator<T, W>::reset()
+    {
+        m_count.fill(value_type(0));
+        m_samples = 0;
+    }
+    //@}
+
+    /**
+     * @ingroup histogram
+     * @brief Builds a histogram accumulator with the given bins.
+     *
+     * @tparam W the value type of the weights and of the counts
+     * @param bin_edges The bin-edges. It has to be 1-dimensional and monotonic.
+     * @return an empty histogram_accumulator.
+     *
+     * @code{.cpp}
+     * auto acc = xt::make_histogram_accumulator(xt::histogram_bin_edges(first_batch, std::size_t(20)));
+     * acc.add(first_batch);
+     * acc.add(second_batch);
+     * xt::xtensor<double, 1> count = acc.count();
+     * @endcode
+     */
+    template <class W, class E>
+    inline histogram_accumulator<typename E::value_type, W> make_histogram_accumulator(const xexpression<E>& bin_edges)
+    {
+        return histogram_accumulator<typename E::value_type, W>(bin_edges);
+    }
+
+    /**
+     * @ingroup histogram
+     * @brief Builds a histogram accumulator with bins of equal width.
+     *
+     * @tparam W the value type of the weights and of the counts
+     * @param bins The number of bins.
+     * @param left The lower-most edge.
+     * @param right The upper-most edge.
+     * @return an empty histogram_accumulator.
+     */
+    template <class W, class T>
+    inline histogram_accumulator<T, W> make_histogram_accumulator(std::size_t bins, T left, T right)
+    {
+        return histogram_accumulator<T, W>(bins, left, right);
+    }
+
     /**
      * Get the number of items in each bin, given the fraction of items per bin.
      * The output is such that the total number of items of all bins is exactly "N".
@@ -0,0 +1,524 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_INCREMENTAL_HPP
+#define XTENSOR_INCREMENTAL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+#include <xtl/xtype_traits.hpp>
+
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xnoalias.hpp"
+#include "xslice.hpp"
+#include "xstorage.hpp"
+#include "xstrided_view.hpp"
+#include "xtensor_config.hpp"
+#include "xview.hpp"
+#include "xview_utils.hpp"
+
+namespace xt
+{
+
+    /*****************
+     * xdirty_region *
+     *****************/
+
+    /**
+     * @class xdirty_region
+     * @brief Boxes of an expression whose elements have changed.
+     *
+     * Each box holds, for every dimension, the half-open range [begin, end)
+     * of the changed indices. Boxes contained in a box already marked are
+     * discarded; beyond max_boxes, the boxes are merged into their bounding
+     * box, so that a region never costs more than a few loops to update.
+     */
+    class xdirty_region
+    {
+    public:
+
+        using size_type = std::size_t;
+        using index_type = svector<size_type, 4>;
+
+        struct box
+        {
+            index_type begin;
+            index_type end;
+
+            bool contains(const box& rhs) const noexcept;
+        };
+
+        using container_type = std::vector<box>;
+
+        static constexpr size_type max_boxes = 16;
+
+        xdirty_region() = default;
+
+        template <class S>
+        explicit xdirty_region(const S& shape);
+
+        size_type dimension() const noexcept;
+        const index_type& shape() const noexcept;
+        const container_type& boxes() const noexcept;
+        bool empty() const noexcept;
+
+        template <class B, class E>
+        void mark(const B& begin, const E& end);
+
+        void mark_all();
+        void clear() noexcept;
+
+    private:
+
+        void merge_boxes();
+
+        index_type m_shape;
+        container_type m_boxes;
+    };
+
+    /************
+     * xtracked *
+     ************/
+
+    /**
+     * @class xtracked
+     * @brief Tracks the writes to an expression in an xdirty_region.
+     *
+     * The writes performed through the views and the element access of the
+     * tracker mark the region they cover as dirty; writes performed directly
+     * on the expression are not seen and must be marked explicitly. The region
+     * is kept until clear is called, typically once every output depending on
+     * the expression has been updated with xt::update.
+     *
+     * @tparam E The type of the tracked expression, usually a container.
+     */
+    template <class E>
+    class xtracked
+    {
+    public:
+
+        using expression_type = E;
+        using size_type = typename E::size_type;
+
+        explicit xtracked(E& e);
+
+        expression_type& expression() noexcept;
+        const expression_type& expression() const noexcept;
+        const xdirty_region& dirty_region() const;
+
+        template <class... S>
+        auto view(S&&... slices);
+
+        template <class... Args>
+        decltype(auto) operator()(Args... args);
+
+        template <class B, class F>
+        void mark(const B& begin, const F& end);
+
+        void mark_all();
+        void clear() noexcept;
+
+    private:
+
+        void check_shape() const;
+
+        E& m_e;
+        mutable xdirty_region m_region;
+    };
+
+    template <class E>
+    xtracked<E> track(xexpression<E>& e);
+
+    template <class E1, class E2>
+    void update(xexpression<E1>& e1, const xexpression<E2>& e2, const xdirty_region& region);
+
+    /********************************
+     * xdirty_region implementation *
+     ********************************/
+
+    inline bool xdirty_region::box::contains(const box& rhs) const noexcept
+    {
+        for (std::size_t i = 0; i < begin.size(); ++i)
+        {
+            if (rhs.begin[i] < begin[i] || rhs.end[i] > end[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Builds an empty region of an expression with the given shape.
+     * @param shape the shape of the tracked expression
+     */
+    template <class S>
+    inline xdirty_region::xdirty_region(const S& shape)
+        : m_shape(shape.cbegin(), shape.cend())
+    {
+    }
+
+    /**
+     * Returns the number of dimensions of the tracked expression.
+     */
+    inline auto xdirty_region::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the tracked expression.
+     */
+    inline auto xdirty_region::shape() const noexcept -> const index_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the boxes of the region.
+     */
+    inline auto xdirty_region::boxes() const noexcept -> const container_type&
+    {
+        return m_boxes;
+    }
+
+    /**
+     * Returns true if no element has been marked.
+     */
+    inline bool xdirty_region::empty() const noexcept
+    {
+        return m_boxes.empty();
+    }
+
+    /**
+     * Marks the box [begin, end) as dirty. Empty boxes are ignored.
+     * @param begin the first index of the box in each dimension
+     * @param end the index past the box in each dimension
+     */
+    template <class B, class E>
+    inline void xdirty_region::mark(const B& begin, const E& end)
+    {
+        if (static_cast<size_type>(std::distance(begin.cbegin(), begin.cend())) != dimension()
+            || static_cast<size_type>(std::distance(end.cbegin(), end.cend())) != dimension())
+        {
+            XTENSOR_THROW(std::out_of_range, "xdirty_region: box dimension mismatch");
+        }
+        box b = {index_type(begin.cbegin(), begin.cend()), index_type(end.cbegin(), end.cend())};
+        bool empty_box = false;
+        for (std::size_t i = 0; i < dimension(); ++i)
+        {
+            if (b.begin[i] > b.end[i] || b.end[i] > m_shape[i])
+            {
+                XTENSOR_THROW(std::out_of_range, "xdirty_region: box out of the expression");
+            }
+            empty_box = empty_box || b.begin[i] == b.end[i];
+        }
+        if (empty_box || std::any_of(m_boxes.cbegin(), m_boxes.cend(), [&b](const box& rhs) { return rhs.contains(b); }))
+        {
+            return;
+        }
+        m_boxes.erase(std::remove_if(m_boxes.begin(), m_boxes.end(), [&b](const box& rhs) { return b.contains(rhs); }),
+                      m_boxes.end());
+        m_boxes.push_back(std::move(b));
+        if (m_boxes.size() > max_boxes)
+        {
+            merge_boxes();
+        }
+    }
+
+    /**
+     * Marks the whole expression as dirty.
+     */
+    inline void xdirty_region::mark_all()
+    {
+        m_boxes.clear();
+        mark(index_type(dimension(), size_type(0)), m_shape);
+    }
+
+    /**
+     * Empties the region.
+     */
+    inline void xdirty_region::clear() noexcept
+    {
+        m_boxes.clear();
+    }
+
+    inline void xdirty_region::merge_boxes()
+    {
+        box bound = m_boxes.front();
+        for (const box& b : m_boxes)
+        {
+            for (std::size_t i = 0; i < dimension(); ++i)
+            {
+                bound.begin[i] = (std::min)(bound.begin[i], b.begin[i]);
+                bound.end[i] = (std::max)(bound.end[i], b.end[i]);
+            }
+        }
+        m_boxes.assign(1, std::move(bound));
+    }
+
+    /***************************
+     * xtracked implementation *
+     ***************************/
+
+    namespace detail
+    {
+        // Computes the range of the indices of the tracked expression
+        // covered by each slice of a view, in begin and end.
+        template <class E, class I>
+        class slice_bounds
+        {
+        public:
+
+            slice_bounds(const E& e, I& begin, I& end)
+                : m_e(e), m_begin(begin), m_end(end), m_axis(0)
+            {
+            }
+
+            template <class S>
+            void operator()(const S& slice)
+            {
+                if (m_axis < m_e.dimension())
+                {
+                    auto s = get_slice_implementation(m_e, slice, m_axis);
+                    add(s, xtl::is_integral<std::decay_t<decltype(s)>>());
+                }
+            }
+
+        private:
+
+            template <class S>
+            void add(const S& s, std::true_type /*is_integral*/)
+            {
+                m_begin[m_axis] = static_cast<std::size_t>(s);
+                m_end[m_axis] = static_cast<std::size_t>(s) + 1;
+                ++m_axis;
+            }
+
+            template <class S>
+            void add(const S& s, std::false_type /*is_integral*/)
+            {
+                add_slice(s, is_newaxis<S>());
+            }
+
+            template <class S>
+            void add_slice(const S&, std::true_type /*is_newaxis*/)
+            {
+            }
+
+            template <class S>
+            void add_slice(const S& s, std::false_type /*is_newaxis*/)
+            {
+                std::size_t n = static_cast<std::size_t>(s.size());
+                std::size_t first = m_e.shape()[m_axis];
+                std::size_t last = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    std::size_t index = static_cast<std::size_t>(s(i));
+                    first = (std::min)(first, index);
+                    last = (std::max)(last, index + 1);
+                }
+                m_begin[m_axis] = n != 0 ? first : 0;
+                m_end[m_axis] = n != 0 ? last : 0;
+                ++m_axis;
+            }
+
+            const E& m_e;
+            I& m_begin;
+            I& m_end;
+            std::size_t m_axis;
+        };
+    }
+
+    /**
+     * Builds a tracker of \c e with an empty dirty region.
+     * @param e the tracked expression, which must outlive the tracker
+     */
+    template <class E>
+    inline xtracked<E>::xtracked(E& e)
+        : m_e(e), m_region(e.shape())
+    {
+    }
+
+    /**
+     * Returns a reference to the tracked expression.
+     */
+    template <class E>
+    inline auto xtracked<E>::expression() noexcept -> expression_type&
+    {
+        return m_e;
+    }
+
+    /**
+     * Returns a constant reference to the tracked expression.
+     */
+    template <class E>
+    inline auto xtracked<E>::expression() const noexcept -> const expression_type&
+    {
+        return m_e;
+    }
+
+    /**
+     * Returns the region marked since the last call to clear. If the
+     * expression has been resized in the meantime, the whole expression
+     * is dirty.
+     */
+    template <class E>
+    inline auto xtracked<E>::dirty_region() const -> const xdirty_region&
+    {
+        check_shape();
+        return m_region;
+    }
+
+    /**
+     * Returns a view of the tracked expression, as xt::view, and marks the
+     * elements it covers as dirty.
+     * @param slices the slices of the view
+     */
+    template <class E>
+    template <class... S>
+    inline auto xtracked<E>::view(S&&... slices)
+    {
+        check_shape();
+        xdirty_region::index_type begin(m_e.dimension(), size_type(0));
+        xdirty_region::index_type end(m_e.shape().cbegin(), m_e.shape().cend());
+        detail::slice_bounds<E, xdirty_region::index_type> bounds(m_e, begin, end);
+        using expand = int[];
+        (void)expand{0, (bounds(slices), 0)...};
+        m_region.mark(begin, end);
+        return xt::view(m_e, std::forward<S>(slices)...);
+    }
+
+    /**
+     * Returns a reference to the element of the tracked expression at the
+     * given position, and marks it as dirty.
+     * @param args a list of indices, one per dimension
+     */
+    template <class E>
+    template <class... Args>
+    inline decltype(auto) xtracked<E>::operator()(Args... args)
+    {
+        check_shape();
+        if (sizeof...(Args) != m_e.dimension())
+        {
+            XTENSOR_THROW(std::out_of_range, "xtracked: one index per dimension is required");
+        }
+        xdirty_region::index_type begin = {static_cast<size_type>(args)...};
+        xdirty_region::index_type end = {static_cast<size_type>(args) + 1 ...};
+        m_region.mark(begin, end);
+        return m_e(args...);
+    }
+
+    /**
+     * Marks the box [begin, end) as dirty, for writes performed directly on
+     * the tracked expression.
+     * @param begin the first index of the box in each dimension
+     * @param end the index past the box in each dimension
+     */
+    template <class E>
+    template <class B, class F>
+    inline void xtracked<E>::mark(const B& begin, const F& end)
+    {
+        check_shape();
+        m_region.mark(begin, end);
+    }
+
+    /**
+     * Marks the whole expression as dirty.
+     */
+    template <class E>
+    inline void xtracked<E>::mark_all()
+    {
+        check_shape();
+        m_region.mark_all();
+    }
+
+    /**
+     * Empties the dirty region.
+     */
+    template <class E>
+    inline void xtracked<E>::clear() noexcept
+    {
+        m_region.clear();
+    }
+
+    template <class E>
+    inline void xtracked<E>::check_shape() const
+    {
+        const auto& shape = m_e.shape();
+        if (shape.size() != m_region.dimension()
+            || !std::equal(shape.cbegin(), shape.cend(), m_region.shape().cbegin()))
+        {
+            m_region = xdirty_region(shape);
+            m_region.mark_all();
+        }
+    }
+
+    /**
+     * Returns a tracker of the writes to \c e.
+     * @param e the tracked expression, which must outlive the tracker
+     */
+    template <class E>
+    inline xtracked<E> track(xexpression<E>& e)
+    {
+        return xtracked<E>(e.derived_cast());
+    }
+
+    /*************************
+     * update implementation *
+     *************************/
+
+    /**
+     * Assigns \c e2 to \c e1 over the boxes of \c region only. When \c e2 is
+     * an element-wise expression of operands sharing the shape of \c e1, and
+     * \c region holds the changes of these operands since \c e1 was last
+     * computed, the other elements of \c e1 are unchanged and \c e1 ends up
+     * equal to \c e2. As with xt::noalias, no temporary is involved.
+     * @param e1 the destination, which must already have the shape of \c e2
+     * @param e2 the expression to assign
+     * @param region the elements to compute, in the coordinates of \c e1
+     */
+    template <class E1, class E2>
+    inline void update(xexpression<E1>& e1, const xexpression<E2>& e2, const xdirty_region& region)
+    {
+        E1& de1 = e1.derived_cast();
+        const E2& de2 = e2.derived_cast();
+        if (de1.dimension() != de2.dimension()
+            || !std::equal(de1.shape().cbegin(), de1.shape().cend(), de2.shape().cbegin()))
+        {
+            XTENSOR_THROW(std::runtime_error, "update: the destination must have the shape of the expression");
+        }
+        if (de1.dimension() != region.dimension()
+            || !std::equal(region.shape().cbegin(), region.shape().cend(), de1.shape().cbegin()))
+        {
+            XTENSOR_THROW(std::runtime_error, "update: the region does not match the shape of the destination");
+        }
+        for (const auto& b : region.boxes())
+        {
+            xstrided_slice_vector slices;
+            slices.reserve(b.begin.size());
+            for (std::size_t i = 0; i < b.begin.size(); ++i)
+            {
+                slices.push_back(range(static_cast<std::ptrdiff_t>(b.begin[i]), static_cast<std::ptrdiff_t>(b.end[i])));
+            }
+            auto dst = strided_view(de1, slices);
+            noalias(dst) = strided_view(de2, slices);
+        }
+    }
+}
+
+#endif
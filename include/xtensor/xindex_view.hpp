@@ -12,15 +12,20 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <numeric>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
 #include "xoperation.hpp"
 #include "xsemantic.hpp"
 #include "xstrides.hpp"
+#include "xtensor.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -768,7 +773,8 @@ namespace xt
      * This is equivalent to \verbatim{index_view(e, argwhere(condition));}\endverbatim
      * The returned view is not optimal if you just want to assign a scalar to the filtered
      * elements. In that case, you should consider using the \ref filtration function
-     * instead.
+     * instead. If you only need the values of the selected elements, \ref extract
+     * computes them in a single pass.
      *
      * @tparam L the traversal order
      * @param e the underlying xexpression
@@ -790,6 +796,48 @@ namespace xt
         return view_type(std::forward<E>(e), std::move(indices));
     }
 
+    /**
+     * @brief returns the elements of \a e selected where \a condition evaluates to \em true.
+     *
+     * Contrary to \ref filter, which builds a view on the indices of the selected
+     * elements, the condition is evaluated and the selected values are stored
+     * contiguously in a single pass, without branching on the condition. Large
+     * expressions are compacted in parallel when a parallel backend is enabled.
+     *
+     * @tparam L the traversal order
+     * @param condition xexpression with shape of \a e which selects the elements
+     * @param e the xexpression whose elements are selected
+     * @return a 1-D \ref xtensor holding the selected values
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1,5,3}, {4,5,6}};
+     * xtensor<double, 1> b = extract(a >= 5, a);
+     * std::cout << b << std::endl; // {5, 5, 6}
+     * \endcode
+     *
+     * \sa filter
+     */
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class C, class E>
+    inline auto extract(const C& condition, const E& e)
+    {
+        using value_type = typename E::value_type;
+        using result_type = xtensor<value_type, 1>;
+        if (!std::equal(condition.shape().cbegin(), condition.shape().cend(), e.shape().cbegin(), e.shape().cend()))
+        {
+            XTENSOR_THROW(std::runtime_error, "extract: the condition and the expression must have the same shape");
+        }
+        auto values = detail::apply_on_traversal<L>(e, [&condition, &e](auto values_at)
+        {
+            return detail::apply_on_traversal<L>(condition, [&e, &values_at](auto cond_at)
+            {
+                return detail::compact<value_type>(e.size(), cond_at, values_at);
+            });
+        });
+        typename result_type::inner_shape_type shape = {values.size()};
+        typename result_type::inner_strides_type strides = {1};
+        return result_type(std::move(values), std::move(shape), std::move(strides));
+    }
+
     /**
      * @brief creates a filtration of \c e filtered by \a condition.
      *
@@ -813,6 +861,184 @@ namespace xt
         using filtration_type = xfiltration<xclosure_t<E>, xclosure_t<C>>;
         return filtration_type(std::forward<E>(e), std::forward<C>(condition));
     }
+
+    /***************
+     * scatter_add *
+     ***************/
+
+    namespace detail
+    {
+        // Number of indices per task of the partition of a scatter, and
+        // maximal number of blocks of destination rows.
+        constexpr std::size_t scatter_chunk = std::size_t(1) << 14;
+        constexpr std::size_t scatter_max_blocks = 256;
+
+        template <class P>
+        struct is_sequenced_policy : std::is_same<P, exec::sequenced_policy>
+        {
+        };
+
+        template <class T, class V, class I>
+        inline void scatter_rows(T* out, const V* values, const I* indices, const std::size_t* pos,
+                                 std::size_t first, std::size_t last, std::size_t inner)
+        {
+            for (std::size_t p = first; p < last; ++p)
+            {
+                const std::size_t i = pos == nullptr ? p : pos[p];
+                T* o = out + static_cast<std::size_t>(indices[i]) * inner;
+                const V* v = values + i * inner;
+                for (std::size_t j = 0; j < inner; ++j)
+                {
+                    o[j] += static_cast<T>(v[j]);
+                }
+            }
+        }
+
+        // Adds the n rows of values to the rows indices of out. The
+        // positions of the indices are sorted by block of destination rows
+        // with a stable counting sort whose chunks run in parallel, then
+        // each task adds the rows of whole blocks: no two tasks write the
+        // same row, and each row receives its values in the order of the
+        // indices, as the sequential loop.
+        template <class T, class V, class I, class P>
+        inline void scatter_add_impl(T* out, std::size_t rows, const V* values, const I* indices,
+                                     std::size_t n, std::size_t inner, const P& policy)
+        {
+            const std::size_t chunks = (n + scatter_chunk - 1) / scatter_chunk;
+            if (chunks < 2 || rows < 2 || is_sequenced_policy<P>::value)
+            {
+                scatter_rows(out, values, indices, static_cast<const std::size_t*>(nullptr), 0, n, inner);
+                return;
+            }
+
+            const std::size_t block_rows = (rows + scatter_max_blocks - 1) / scatter_max_blocks;
+            const std::size_t blocks = (rows + block_rows - 1) / block_rows;
+            std::vector<std::size_t> offsets(chunks * blocks + 1, std::size_t(0));
+            policy.for_range(0, chunks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t* count = offsets.data() + 1;
+                    for (std::size_t i = c * scatter_chunk; i < (std::min)(n, (c + 1) * scatter_chunk); ++i)
+                    {
+                        ++count[static_cast<std::size_t>(indices[i]) / block_rows * chunks + c];
+                    }
+                }
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            uvector<std::size_t> pos(n);
+            policy.for_range(0, chunks, 1, [&](std::size_t first, std::size_t last)
+            {
+                std::vector<std::size_t> next(blocks);
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    for (std::size_t b = 0; b < blocks; ++b)
+                    {
+                        next[b] = offsets[b * chunks + c];
+                    }
+                    for (std::size_t i = c * scatter_chunk; i < (std::min)(n, (c + 1) * scatter_chunk); ++i)
+                    {
+                        pos[next[static_cast<std::size_t>(indices[i]) / block_rows]++] = i;
+                    }
+                }
+            });
+
+            policy.for_range(0, blocks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    scatter_rows(out, values, indices, pos.data(), offsets[b * chunks], offsets[(b + 1) * chunks], inner);
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Adds the rows of \a values to the rows of \a out selected by \a indices.
+     *
+     * The row \c i of \a values along its first axis is added to the row
+     * \c indices[i] of \a out, repeated indices accumulating all their
+     * values, as \c np.add.at(out, indices, values). Large scatters are
+     * split among the threads of \a policy by partitioning the indices
+     * per block of destination rows, so that no two threads update the
+     * same row; the values of a row are added in the order of the indices
+     * whatever the policy.
+     *
+     * @param out the container updated in place
+     * @param indices a 1-D expression of integers in [0, out.shape()[0])
+     * @param values an expression of shape (indices.size(), out.shape()[1:]...)
+     * @param policy the execution policy splitting the partition and the updates
+     *
+     * \code{.cpp}
+     * xarray<double> a = {0, 0, 0};
+     * scatter_add(a, xarray<int>{0, 2, 0}, xarray<double>{1, 2, 3});
+     * std::cout << a << std::endl; // {4, 0, 2}
+     * \endcode
+     */
+    template <class O, class I, class V, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline void scatter_add(xexpression<O>& out, const xexpression<I>& indices, const xexpression<V>& values,
+                            const P& policy)
+    {
+        using value_type = typename O::value_type;
+        using index_type = typename I::value_type;
+        using values_type = typename V::value_type;
+        static_assert(xtl::is_integral<index_type>::value, "scatter_add: the indices have to be integral type.");
+
+        O& dout = out.derived_cast();
+        const auto& dindices = indices.derived_cast();
+        const auto& dvalues = values.derived_cast();
+        if (dout.dimension() == 0 || dindices.dimension() != 1 || dvalues.dimension() != dout.dimension()
+            || dvalues.shape()[0] != dindices.size()
+            || !std::equal(dvalues.shape().cbegin() + 1, dvalues.shape().cend(), dout.shape().cbegin() + 1))
+        {
+            XTENSOR_THROW(std::runtime_error, "scatter_add: values must hold one row of out per index");
+        }
+        const std::size_t rows = dout.shape()[0];
+        const std::size_t n = dindices.size();
+        if (n == 0)
+        {
+            return;
+        }
+
+        xarray<index_type, layout_type::row_major> indices_storage;
+        const index_type* pindices = detail::row_major_data(dindices, indices_storage);
+        auto bounds = std::minmax_element(pindices, pindices + n);
+        if (*bounds.first < index_type(0) || static_cast<std::size_t>(*bounds.second) >= rows)
+        {
+            XTENSOR_THROW(std::runtime_error, "scatter_add: index out of bounds");
+        }
+        xarray<values_type, layout_type::row_major> values_storage;
+        const values_type* pvalues = detail::row_major_data(dvalues, values_storage);
+        const std::size_t inner = dout.size() / rows;
+
+        if (dout.layout() == layout_type::row_major && dout.is_contiguous())
+        {
+            value_type* pout = dout.data() + static_cast<std::ptrdiff_t>(dout.data_offset());
+            detail::scatter_add_impl(pout, rows, pvalues, pindices, n, inner, policy);
+        }
+        else
+        {
+            xarray<value_type, layout_type::row_major> tmp = dout;
+            detail::scatter_add_impl(tmp.data(), rows, pvalues, pindices, n, inner, policy);
+            dout = tmp;
+        }
+    }
+
+    /**
+     * @brief Adds the rows of \a values to the rows of \a out selected by \a indices,
+     * under the default execution policy.
+     *
+     * @param out the container updated in place
+     * @param indices a 1-D expression of integers in [0, out.shape()[0])
+     * @param values an expression of shape (indices.size(), out.shape()[1:]...)
+     * @sa scatter_add(xexpression<O>&, const xexpression<I>&, const xexpression<V>&, const P&)
+     */
+    template <class O, class I, class V>
+    inline void scatter_add(xexpression<O>& out, const xexpression<I>& indices, const xexpression<V>& values)
+    {
+        scatter_add(out, indices, values, exec::default_policy());
+    }
 }
 
 #endif
@@ -10,13 +10,29 @@
 #ifndef XTENSOR_IO_HPP
 #define XTENSOR_IO_HPP
 
+#include <algorithm>
 #include <complex>
 #include <cstddef>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+// std::to_chars is used for the floating point numbers when the standard
+// library provides it (__cpp_lib_to_chars), snprintf otherwise
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define XTENSOR_IO_HAS_FLOAT_TO_CHARS
+#endif
+#endif
+#endif
 
 #include "xexpression.hpp"
 #include "xmath.hpp"
@@ -185,72 +201,132 @@ namespace xt
 
     namespace detail
     {
-        template <class E, class F>
-        std::ostream& xoutput(std::ostream& out, const E& e,
-                              xstrided_slice_vector& slices, F& printer, std::size_t blanks,
-                              std::streamsize element_width, std::size_t edgeitems, std::size_t line_width)
+        /*******************
+         * text formatting *
+         *******************/
+
+        // The elements are formatted into a single buffer which is written
+        // to the stream at once. The floating point numbers are converted
+        // with to_chars or snprintf, which both format them as the streams
+        // do in the classic locale.
+
+        inline void append_padded(std::string& buf, const char* first, std::size_t size, std::streamsize width)
         {
-            using size_type = typename E::size_type;
+            if (width > 0 && static_cast<std::size_t>(width) > size)
+            {
+                buf.append(static_cast<std::size_t>(width) - size, ' ');
+            }
+            buf.append(first, size);
+        }
 
-            const auto view = xt::strided_view(e, slices);
-            if (view.dimension() == 0)
+        template <class T>
+        inline void append_integral(std::string& buf, T val, std::streamsize width)
+        {
+            // Converts the absolute value without overflowing on the lowest
+            // value of signed types
+            using unsigned_type = std::make_unsigned_t<decltype(+val)>;
+            char tmp[std::numeric_limits<unsigned_type>::digits10 + 3];
+            char* last = tmp + sizeof(tmp);
+            char* first = last;
+            bool negative = val < T(0);
+            unsigned_type u = negative ? unsigned_type(0) - static_cast<unsigned_type>(+val) : static_cast<unsigned_type>(+val);
+            do
+            {
+                *--first = static_cast<char>('0' + u % 10u);
+                u /= 10u;
+            } while (u != 0u);
+            if (negative)
+            {
+                *--first = '-';
+            }
+            append_padded(buf, first, static_cast<std::size_t>(last - first), width);
+        }
+
+        template <class T>
+        inline void append_floating(std::string& buf, T val, std::streamsize precision, bool scientific, std::streamsize width)
+        {
+            // Values printed in fixed notation are smaller than 1e7
+            const std::size_t capacity = 64 + static_cast<std::size_t>((std::max)(precision, std::streamsize(0)));
+            char stack_tmp[128];
+            std::string heap_tmp;
+            char* tmp = stack_tmp;
+            if (capacity > sizeof(stack_tmp))
+            {
+                heap_tmp.resize(capacity);
+                tmp = &heap_tmp[0];
+            }
+            int prec = static_cast<int>(precision);
+#if defined(XTENSOR_IO_HAS_FLOAT_TO_CHARS)
+            auto res = std::to_chars(tmp, tmp + capacity, val,
+                                     scientific ? std::chars_format::scientific : std::chars_format::fixed, prec);
+            std::size_t size = static_cast<std::size_t>(res.ptr - tmp);
+#else
+            int n = std::snprintf(tmp, capacity, scientific ? "%.*Le" : "%.*Lf", prec, static_cast<long double>(val));
+            std::size_t size = static_cast<std::size_t>((std::max)(n, 0));
+#endif
+            append_padded(buf, tmp, size, width);
+        }
+
+        template <class F, class S>
+        void xoutput(std::string& buf, const S& shape, std::size_t axis, F& printer, std::size_t blanks,
+                     std::streamsize element_width, std::size_t edgeitems, std::size_t line_width)
+        {
+            const std::size_t dimension = shape.size() - axis;
+            if (dimension == 0)
             {
-                printer.print_next(out);
+                printer.print_next(buf);
             }
             else
             {
-                std::string indents(blanks, ' ');
+                const std::size_t n = static_cast<std::size_t>(shape[axis]);
+                std::size_t i = 0;
+                std::size_t elems_on_line = 0;
+                std::size_t ewp2 = static_cast<std::size_t>(element_width) + std::size_t(2);
+                std::size_t line_lim = static_cast<std::size_t>(std::floor(line_width / ewp2));
 
-                size_type i = 0;
-                size_type elems_on_line = 0;
-                size_type ewp2 = static_cast<size_type>(element_width) + size_type(2);
-                size_type line_lim = static_cast<size_type>(std::floor(line_width / ewp2));
+                auto new_line = [&buf, blanks]() {
+                    buf += '\n';
+                    buf.append(blanks, ' ');
+                };
 
-                out << '{';
-                for (; i != size_type(view.shape()[0] - 1); ++i)
+                buf += '{';
+                for (; i != n - 1; ++i)
                 {
-                    if (edgeitems && size_type(view.shape()[0]) > (edgeitems * 2) && i == edgeitems)
+                    if (edgeitems && n > (edgeitems * 2) && i == edgeitems)
                     {
-                        out << "..., ";
-                        if (view.dimension() > 1)
+                        buf += "..., ";
+                        if (dimension > 1)
                         {
                             elems_on_line = 0;
-                            out << std::endl
-                                << indents;
+                            new_line();
                         }
-                        i = size_type(view.shape()[0]) - edgeitems;
+                        i = n - edgeitems;
                     }
-                    if (view.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                    if (dimension == 1 && line_lim != 0 && elems_on_line >= line_lim)
                     {
-                        out << std::endl
-                            << indents;
+                        new_line();
                         elems_on_line = 0;
                     }
-                    slices.push_back(static_cast<int>(i));
-                    xoutput(out, e, slices, printer, blanks + 1, element_width, edgeitems, line_width) << ',';
-                    slices.pop_back();
+                    xoutput(buf, shape, axis + 1, printer, blanks + 1, element_width, edgeitems, line_width);
+                    buf += ',';
                     elems_on_line++;
 
-                    if (view.dimension() == 1)
+                    if (dimension == 1)
                     {
-                        out << ' ';
+                        buf += ' ';
                     }
                     else
                     {
-                        out << std::endl
-                            << indents;
+                        new_line();
                     }
                 }
-                if (view.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                if (dimension == 1 && line_lim != 0 && elems_on_line >= line_lim)
                 {
-                    out << std::endl
-                        << indents;
+                    new_line();
                 }
-                slices.push_back(static_cast<int>(i));
-                xoutput(out, e, slices, printer, blanks + 1, element_width, edgeitems, line_width) << '}';
-                slices.pop_back();
+                xoutput(buf, shape, axis + 1, printer, blanks + 1, element_width, edgeitems, line_width);
+                buf += '}';
             }
-            return out;
         }
 
         template <class F, class E>
@@ -281,6 +357,36 @@ namespace xt
             }
         }
 
+        // Visits the printed elements in the same order as the above
+        // overload, accessing them by index instead of building a view
+        // per element.
+        template <class F, class E, class I>
+        void recurser_run_impl(F& fn, const E& e, I& index, std::size_t axis, std::size_t lim)
+        {
+            if (axis == index.size())
+            {
+                fn.update(e.element(index.cbegin(), index.cend()));
+                return;
+            }
+            const std::size_t n = static_cast<std::size_t>(e.shape()[axis]);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (lim && n > (lim * 2) && i == lim)
+                {
+                    i = n - lim;
+                }
+                index[axis] = i;
+                recurser_run_impl(fn, e, index, axis + 1, lim);
+            }
+        }
+
+        template <class F, class E>
+        void recurser_run(F& fn, const E& e, std::size_t lim)
+        {
+            std::vector<std::size_t> index(e.dimension(), std::size_t(0));
+            recurser_run_impl(fn, e, index, 0, lim);
+        }
+
         template <class T, class E = void>
         struct printer;
 
@@ -326,55 +432,39 @@ namespace xt
                 }
             }
 
-            std::ostream& print_next(std::ostream& out)
+            void print_next(std::string& buf)
             {
+                const std::size_t first = buf.size();
                 if (!m_scientific)
                 {
-                    std::stringstream buf;
-                    buf.width(m_width);
-                    buf << std::fixed;
-                    buf.precision(m_precision);
-                    buf << (*m_it);
+                    append_floating(buf, *m_it, m_precision, false, m_width);
                     if (!m_required_precision && !std::isinf(*m_it) && !std::isnan(*m_it))
                     {
-                        buf << '.';
+                        buf += '.';
                     }
-                    std::string res = buf.str();
-                    auto sit = res.rbegin();
-                    while (*sit == '0')
+                    for (std::size_t i = buf.size(); i != first && buf[i - 1] == '0'; --i)
                     {
-                        *sit = ' ';
-                        ++sit;
+                        buf[i - 1] = ' ';
                     }
-                    out << res;
                 }
                 else
                 {
-                    if (!m_large_exponent)
+                    append_floating(buf, *m_it, m_precision, true, m_width);
+                    const std::size_t size = buf.size() - first;
+                    if (m_large_exponent && size >= 4 && buf[buf.size() - 4] == 'e')
                     {
-                        out << std::scientific;
-                        out.width(m_width);
-                        out << (*m_it);
-                    }
-                    else
-                    {
-                        std::stringstream buf;
-                        buf.width(m_width);
-                        buf << std::scientific;
-                        buf.precision(m_precision);
-                        buf << (*m_it);
-                        std::string res = buf.str();
-
-                        if (res[res.size() - 4] == 'e')
-                        {
-                            res.erase(0, 1);
-                            res.insert(res.size() - 2, "0");
-                        }
-                        out << res;
+                        buf.erase(first, 1);
+                        buf.insert(buf.size() - 2, 1, '0');
                     }
                 }
                 ++m_it;
-                return out;
+            }
+
+            std::ostream& print_next(std::ostream& out)
+            {
+                std::string buf;
+                print_next(buf);
+                return out << buf;
             }
 
             void update(const value_type& val)
@@ -444,14 +534,18 @@ namespace xt
                 m_width = 1 + std::streamsize((m_max > 0) ? std::log10(m_max) : 0) + m_sign;
             }
 
-            std::ostream& print_next(std::ostream& out)
+            void print_next(std::string& buf)
             {
-                // + enables printing of chars etc. as numbers
-                // TODO should chars be printed as numbers?
-                out.width(m_width);
-                out << +(*m_it);
+                // chars are printed as numbers
+                append_integral(buf, *m_it, m_width);
                 ++m_it;
-                return out;
+            }
+
+            std::ostream& print_next(std::ostream& out)
+            {
+                std::string buf;
+                print_next(buf);
+                return out << buf;
             }
 
             void update(const value_type& val)
@@ -498,20 +592,17 @@ namespace xt
                 m_it = m_cache.cbegin();
             }
 
-            std::ostream& print_next(std::ostream& out)
+            void print_next(std::string& buf)
             {
-                if (*m_it)
-                {
-                    out << " true";
-                }
-                else
-                {
-                    out << "false";
-                }
-                // TODO: the following std::setw(5) isn't working correctly on OSX.
-                //out << std::boolalpha << std::setw(m_width) << (*m_it);
+                buf += *m_it ? " true" : "false";
                 ++m_it;
-                return out;
+            }
+
+            std::ostream& print_next(std::ostream& out)
+            {
+                std::string buf;
+                print_next(buf);
+                return out << buf;
             }
 
             void update(const value_type& val)
@@ -551,30 +642,28 @@ namespace xt
                 m_it = m_signs.cbegin();
             }
 
-            std::ostream& print_next(std::ostream& out)
+            void print_next(std::string& buf)
             {
-                real_printer.print_next(out);
-                if (*m_it)
-                {
-                    out << "-";
-                }
-                else
-                {
-                    out << "+";
-                }
-                std::stringstream buf;
-                imag_printer.print_next(buf);
-                std::string s = buf.str();
-                if (s[0] == ' ')
+                real_printer.print_next(buf);
+                buf += *m_it ? '-' : '+';
+                std::string s;
+                imag_printer.print_next(s);
+                if (!s.empty() && s[0] == ' ')
                 {
                     s.erase(0, 1);  // erase space for +/-
                 }
-                // insert j at end of number
+                // insert i at end of number
                 std::size_t idx = s.find_last_not_of(" ");
                 s.insert(idx + 1, "i");
-                out << s;
+                buf += s;
                 ++m_it;
-                return out;
+            }
+
+            std::ostream& print_next(std::ostream& out)
+            {
+                std::string buf;
+                print_next(buf);
+                return out << buf;
             }
 
             void update(const value_type& val)
@@ -617,12 +706,17 @@ namespace xt
                 }
             }
 
-            std::ostream& print_next(std::ostream& out)
+            void print_next(std::string& buf)
             {
-                out.width(m_width);
-                out << *m_it;
+                append_padded(buf, m_it->data(), m_it->size(), m_width);
                 ++m_it;
-                return out;
+            }
+
+            std::ostream& print_next(std::ostream& out)
+            {
+                std::string buf;
+                print_next(buf);
+                return out << buf;
             }
 
             void update(const_reference val)
@@ -759,11 +853,11 @@ namespace xt
 
         detail::printer<E> p(precision);
 
-        xstrided_slice_vector sv;
-        detail::recurser_run(p, d, sv, lim);
+        detail::recurser_run(p, d, lim);
         p.init();
-        sv.clear();
-        xoutput(out, d, sv, p, 1, p.width(), lim, static_cast<std::size_t>(po.line_width));
+        std::string buf;
+        detail::xoutput(buf, d.shape(), 0, p, 1, p.width(), lim, static_cast<std::size_t>(po.line_width));
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
 
         out.precision(temp_precision);  // restore precision
 
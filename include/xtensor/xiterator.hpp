@@ -87,6 +87,14 @@ namespace xt
             using type = std::array<V, L>;
         };
 
+        // The index of an expression with an inline shape holds as many
+        // dimensions inline
+        template <class V, std::size_t N, class A, bool Init>
+        struct index_type_impl<svector<V, N, A, Init>>
+        {
+            using type = svector<V, N>;
+        };
+
         template <std::size_t... I>
         struct index_type_impl<fixed_shape<I...>>
         {
@@ -136,7 +144,11 @@ namespace xt
         template <class T>
         simd_return_type<T> step_simd();
 
+        template <class T>
+        simd_return_type<T> step_simd(size_type dim);
+
         void step_leading();
+        void step_leading(size_type dim);
 
         template <class R>
         void store_simd(const R& vec);
@@ -165,6 +177,19 @@ namespace xt
                                       IT& index,
                                       const ST& shape);
 
+        // When the number of dimensions is known at compile time, the
+        // carry loop is fully unrolled.
+
+        template <class S, class T, std::size_t N, class ST>
+        static void increment_stepper(S& stepper,
+                                      std::array<T, N>& index,
+                                      const ST& shape);
+
+        template <class S, class T, std::size_t N, class ST>
+        static void decrement_stepper(S& stepper,
+                                      std::array<T, N>& index,
+                                      const ST& shape);
+
         template <class S, class IT, class ST>
         static void increment_stepper(S& stepper,
                                       IT& index,
@@ -560,6 +585,12 @@ namespace xt
                 return reg.load_unaligned(&(*it));
                 //return reg;
             }
+
+            template <class R>
+            static R gather(const It& it, std::ptrdiff_t stride)
+            {
+                return xt_simd::gather_as<R>(&(*it), stride);
+            }
         };
 
         template <bool is_const, class T, class S, layout_type L>
@@ -570,6 +601,12 @@ namespace xt
             {
                 return R(*it);
             }
+
+            template <class R>
+            static R gather(const xiterator<xscalar_stepper<is_const, T>, S, L>& it, std::ptrdiff_t)
+            {
+                return R(*it);
+            }
         };
     }
 
@@ -591,12 +628,130 @@ namespace xt
         m_it += xt_simd::revert_simd_traits<R>::size;;
     }
 
+    /**
+     * Returns the next batch along the dimension \c dim, the innermost
+     * dimension of a strided loop. When the underlying container is
+     * broadcast along \c dim, it is constant over the loop and the batch
+     * is a splat of the current element; when its elements are not
+     * contiguous along \c dim, such as in a view with a step, they are
+     * gathered.
+     */
+    template <class C>
+    template <class T>
+    inline auto xstepper<C>::step_simd(size_type dim) -> simd_return_type<T>
+    {
+        using simd_type = simd_return_type<T>;
+        if (dim >= m_offset)
+        {
+            difference_type stride = difference_type(p_c->strides()[dim - m_offset]);
+            if (stride == 1)
+            {
+                return step_simd<T>();
+            }
+            if (stride != 0)
+            {
+                simd_type reg = detail::step_simd_invoker<subiterator_type>::template gather<simd_type>(m_it, stride);
+                m_it += difference_type(xt_simd::revert_simd_traits<simd_type>::size) * stride;
+                return reg;
+            }
+        }
+        return simd_type(*m_it);
+    }
+
     template <class C>
     void xstepper<C>::step_leading()
     {
         ++m_it;
     }
 
+    template <class C>
+    void xstepper<C>::step_leading(size_type dim)
+    {
+        step(dim);
+    }
+
+    namespace detail
+    {
+        // Carry of increment_stepper and decrement_stepper over the K-th
+        // dimension in the traversal order of L, the innermost first
+        template <layout_type L, std::size_t N, std::size_t K = 0>
+        struct unrolled_stepper_carry
+        {
+            static constexpr std::size_t dim = L == layout_type::row_major ? N - 1 - K : K;
+            using next_type = unrolled_stepper_carry<L, N, K + 1>;
+
+            template <class S, class IT, class ST>
+            static bool increment(S& stepper, IT& index, const ST& shape)
+            {
+                if (index[dim] != shape[dim] - 1)
+                {
+                    ++index[dim];
+                    stepper.step(dim);
+                    return true;
+                }
+                index[dim] = 0;
+                reset(stepper, std::integral_constant<bool, K + 1 != N>());
+                return next_type::increment(stepper, index, shape);
+            }
+
+            template <class S, class IT, class ST>
+            static bool decrement(S& stepper, IT& index, const ST& shape)
+            {
+                if (index[dim] != 0)
+                {
+                    --index[dim];
+                    stepper.step_back(dim);
+                    return true;
+                }
+                index[dim] = shape[dim] - 1;
+                reset_back(stepper, std::integral_constant<bool, K + 1 != N>());
+                return next_type::decrement(stepper, index, shape);
+            }
+
+        private:
+
+            // The outermost dimension is not reset, the stepper is moved
+            // to the end or to the beginning instead
+            template <class S>
+            static void reset(S& stepper, std::true_type)
+            {
+                stepper.reset(dim);
+            }
+
+            template <class S>
+            static void reset(S&, std::false_type)
+            {
+            }
+
+            template <class S>
+            static void reset_back(S& stepper, std::true_type)
+            {
+                stepper.reset_back(dim);
+            }
+
+            template <class S>
+            static void reset_back(S&, std::false_type)
+            {
+            }
+        };
+
+        template <layout_type L, std::size_t N>
+        struct unrolled_stepper_carry<L, N, N>
+        {
+            template <class S, class IT, class ST>
+            static bool increment(S&, IT&, const ST&)
+            {
+                return false;
+            }
+
+            template <class S, class IT, class ST>
+            static bool decrement(S&, IT&, const ST&)
+            {
+                return false;
+            }
+        };
+    }
+
     template <>
     template <class S, class IT, class ST>
     void stepper_tools<layout_type::row_major>::increment_stepper(S& stepper,
@@ -630,6 +785,19 @@ namespace xt
         }
     }
 
+    template <>
+    template <class S, class T, std::size_t N, class ST>
+    void stepper_tools<layout_type::row_major>::increment_stepper(S& stepper,
+                                                                  std::array<T, N>& index,
+                                                                  const ST& shape)
+    {
+        if (!detail::unrolled_stepper_carry<layout_type::row_major, N>::increment(stepper, index, shape))
+        {
+            std::copy(shape.cbegin(), shape.cend(), index.begin());
+            stepper.to_end(layout_type::row_major);
+        }
+    }
+
     template <>
     template <class S, class IT, class ST>
     void stepper_tools<layout_type::row_major>::increment_stepper(S& stepper,
@@ -708,6 +876,18 @@ namespace xt
         }
     }
 
+    template <>
+    template <class S, class T, std::size_t N, class ST>
+    void stepper_tools<layout_type::row_major>::decrement_stepper(S& stepper,
+                                                                  std::array<T, N>& index,
+                                                                  const ST& shape)
+    {
+        if (!detail::unrolled_stepper_carry<layout_type::row_major, N>::decrement(stepper, index, shape))
+        {
+            stepper.to_begin();
+        }
+    }
+
     template <>
     template <class S, class IT, class ST>
     void stepper_tools<layout_type::row_major>::decrement_stepper(S& stepper,
@@ -787,6 +967,19 @@ namespace xt
         }
     }
 
+    template <>
+    template <class S, class T, std::size_t N, class ST>
+    void stepper_tools<layout_type::column_major>::increment_stepper(S& stepper,
+                                                                     std::array<T, N>& index,
+                                                                     const ST& shape)
+    {
+        if (!detail::unrolled_stepper_carry<layout_type::column_major, N>::increment(stepper, index, shape))
+        {
+            std::copy(shape.cbegin(), shape.cend(), index.begin());
+            stepper.to_end(layout_type::column_major);
+        }
+    }
+
     template <>
     template <class S, class IT, class ST>
     void stepper_tools<layout_type::column_major>::increment_stepper(S& stepper,
@@ -868,6 +1061,18 @@ namespace xt
         }
     }
 
+    template <>
+    template <class S, class T, std::size_t N, class ST>
+    void stepper_tools<layout_type::column_major>::decrement_stepper(S& stepper,
+                                                                     std::array<T, N>& index,
+                                                                     const ST& shape)
+    {
+        if (!detail::unrolled_stepper_carry<layout_type::column_major, N>::decrement(stepper, index, shape))
+        {
+            stepper.to_begin();
+        }
+    }
+
     template <>
     template <class S, class IT, class ST>
     void stepper_tools<layout_type::column_major>::decrement_stepper(S& stepper,
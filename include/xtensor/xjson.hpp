@@ -10,10 +10,29 @@
 #ifndef XTENSOR_JSON_HPP
 #define XTENSOR_JSON_HPP
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <ostream>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+// std::to_chars is used for the floating point numbers when the standard
+// library provides it (__cpp_lib_to_chars), snprintf otherwise
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define XTENSOR_JSON_HAS_FLOAT_TO_CHARS
+#endif
+#endif
+#endif
+
 #include <nlohmann/json.hpp>
 
 #include "xstrided_view.hpp"
@@ -36,57 +55,58 @@ namespace xt
     enable_xview_semantics<E> from_json(const nlohmann::basic_json<M>&, E&);
     /// @endcond
 
+    template <class E>
+    std::ostream& dump_json(std::ostream& out, const xexpression<E>& e);
+
     /****************************************
      * to_json and from_json implementation *
      ****************************************/
 
     namespace detail
     {
-        template <template <typename U, typename V, typename... Args> class M, class D>
-        void to_json_impl(nlohmann::basic_json<M>& j, const xexpression<D>& e,
-                          xstrided_slice_vector& slices)
+        // The elements are visited in row-major order with an iterator on
+        // the expression, the nested arrays following its shape.
+
+        template <template <typename U, typename V, typename... Args> class M, class S, class It>
+        void to_json_impl(nlohmann::basic_json<M>& j, const S& shape, std::size_t axis, It& it)
         {
-            const auto view = strided_view(e.derived_cast(), slices);
-            if (view.dimension() == 0)
+            if (axis == shape.size())
             {
-                j = view();
+                j = *it;
+                ++it;
             }
             else
             {
                 j = nlohmann::basic_json<M>::array();
-                using size_type = typename D::size_type;
-                size_type nrows = view.shape()[0];
-                for (size_type i = 0; i != nrows; ++i)
+                const std::size_t nrows = static_cast<std::size_t>(shape[axis]);
+                for (std::size_t i = 0; i != nrows; ++i)
                 {
-                    slices.push_back(i);
                     nlohmann::basic_json<M> k;
-                    to_json_impl(k, e, slices);
+                    to_json_impl(k, shape, axis + 1, it);
                     j.push_back(std::move(k));
-                    slices.pop_back();
                 }
             }
         }
 
-        template <template <typename U, typename V, typename... Args> class M, class D>
-        inline void from_json_impl(const nlohmann::basic_json<M>& j, xexpression<D>& e,
-                                   xstrided_slice_vector& slices)
+        template <template <typename U, typename V, typename... Args> class M, class S, class It>
+        void from_json_impl(const nlohmann::basic_json<M>& j, const S& shape, std::size_t axis, It& it)
         {
-            auto view = strided_view(e.derived_cast(), slices);
-
-            if (view.dimension() == 0)
+            using value_type = typename std::iterator_traits<It>::value_type;
+            if (axis == shape.size())
             {
-                view() = j.template get<std::remove_reference_t<decltype(view())>>();
+                *it = j.template get<value_type>();
+                ++it;
             }
             else
             {
-                using size_type = typename D::size_type;
-                size_type nrows = view.shape()[0];
-                for (size_type i = 0; i != nrows; ++i)
+                const std::size_t nrows = static_cast<std::size_t>(shape[axis]);
+                if (!j.is_array() || j.size() != nrows)
                 {
-                    slices.push_back(i);
-                    const nlohmann::basic_json<M>& k = j[i];
-                    from_json_impl(k, e, slices);
-                    slices.pop_back();
+                    XTENSOR_THROW(std::runtime_error, "Irregular shape when deserializing JSON");
+                }
+                for (std::size_t i = 0; i != nrows; ++i)
+                {
+                    from_json_impl(j[i], shape, axis + 1, it);
                 }
             }
         }
@@ -117,6 +137,97 @@ namespace xt
                 }
             }
         }
+
+        /******************
+         * JSON text dump *
+         ******************/
+
+        inline void json_append(std::string& buf, bool val)
+        {
+            buf += val ? "true" : "false";
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value> json_append(std::string& buf, T val)
+        {
+            using unsigned_type = std::make_unsigned_t<decltype(+val)>;
+            char tmp[std::numeric_limits<unsigned_type>::digits10 + 3];
+            char* last = tmp + sizeof(tmp);
+            char* first = last;
+            bool negative = val < T(0);
+            unsigned_type u = negative ? unsigned_type(0) - static_cast<unsigned_type>(+val) : static_cast<unsigned_type>(+val);
+            do
+            {
+                *--first = static_cast<char>('0' + u % 10u);
+                u /= 10u;
+            } while (u != 0u);
+            if (negative)
+            {
+                *--first = '-';
+            }
+            buf.append(first, last);
+        }
+
+        // Writes the shortest representation that reads back to the same
+        // value, with a trailing ".0" for integral values and null for the
+        // non-finite values, as nlohmann::json does.
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value> json_append(std::string& buf, T val)
+        {
+            if (!std::isfinite(val))
+            {
+                buf += "null";
+                return;
+            }
+            char tmp[64];
+#if defined(XTENSOR_JSON_HAS_FLOAT_TO_CHARS)
+            std::size_t size = static_cast<std::size_t>(std::to_chars(tmp, tmp + sizeof(tmp), val).ptr - tmp);
+#else
+            const double dval = static_cast<double>(val);
+            int n = std::snprintf(tmp, sizeof(tmp), "%.*g", std::numeric_limits<T>::digits10, dval);
+            if (static_cast<T>(std::strtod(tmp, nullptr)) != val)
+            {
+                n = std::snprintf(tmp, sizeof(tmp), "%.*g", std::numeric_limits<T>::max_digits10, dval);
+            }
+            std::size_t size = static_cast<std::size_t>((std::max)(n, 0));
+#endif
+            buf.append(tmp, size);
+            if (std::find_if(tmp, tmp + size, [](char c) { return c == '.' || c == 'e'; }) == tmp + size)
+            {
+                buf += ".0";
+            }
+        }
+
+        template <class S, class It>
+        void dump_json_impl(std::ostream& out, std::string& buf, const S& shape, std::size_t axis, It& it)
+        {
+            // Size of the chunks written to the stream
+            constexpr std::size_t chunk_size = std::size_t(1) << 16;
+            if (axis == shape.size())
+            {
+                json_append(buf, *it);
+                ++it;
+                if (buf.size() >= chunk_size)
+                {
+                    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+                    buf.clear();
+                }
+            }
+            else
+            {
+                buf += '[';
+                const std::size_t nrows = static_cast<std::size_t>(shape[axis]);
+                for (std::size_t i = 0; i != nrows; ++i)
+                {
+                    if (i != 0)
+                    {
+                        buf += ',';
+                    }
+                    dump_json_impl(out, buf, shape, axis + 1, it);
+                }
+                buf += ']';
+            }
+        }
     }
 
     /**
@@ -128,12 +239,13 @@ namespace xt
      *
      * @param j a JSON object
      * @param e a const \ref xexpression
+     * @sa dump_json
      */
     template <template <typename U, typename V, typename... Args> class M, class E>
     inline enable_xexpression<E> to_json(nlohmann::basic_json<M>& j, const E& e)
     {
-        auto sv = xstrided_slice_vector();
-        detail::to_json_impl(j, e, sv);
+        auto it = e.template cbegin<layout_type::row_major>();
+        detail::to_json_impl(j, e.shape(), 0, it);
     }
 
     /**
@@ -142,7 +254,10 @@ namespace xt
      *
      * The from_json method is used by the nlohmann_json library for automatic
      * serialization of user-defined types. The method is picked up by
-     * argument-dependent lookup.
+     * argument-dependent lookup. The shape is read from the first element of
+     * each nested array, the container is resized, and the values are written
+     * directly in row-major order. An exception is thrown when the nested
+     * arrays do not have a regular shape.
      *
      * Note: for converting a JSON object to a value, nlohmann_json requires
      * the value type to be default constructible, which is typically not the
@@ -162,8 +277,8 @@ namespace xt
         // In the case of a container, we resize the container.
         e.resize(s);
 
-        auto sv = xstrided_slice_vector();
-        detail::from_json_impl(j, e, sv);
+        auto it = e.template begin<layout_type::row_major>();
+        detail::from_json_impl(j, e.shape(), 0, it);
     }
 
     /// @cond DOXYGEN_INCLUDE_SFINAE
@@ -179,10 +294,36 @@ namespace xt
             XTENSOR_THROW(std::runtime_error, "Shape mismatch when deserializing JSON to view");
         }
 
-        auto sv = xstrided_slice_vector();
-        detail::from_json_impl(j, e, sv);
+        auto it = e.template begin<layout_type::row_major>();
+        detail::from_json_impl(j, e.shape(), 0, it);
     }
     /// @endcond
+
+    /**
+     * @brief Writes an expression of booleans or numbers as nested JSON arrays.
+     *
+     * The text is identical to the compact dump of the JSON object built by
+     * to_json, up to the representation of the floating point numbers, which
+     * read back to the same values. It is produced directly from the
+     * expression, without building the JSON object, and written to the
+     * stream by chunks.
+     *
+     * @param out the output stream
+     * @param e the \ref xexpression to serialize
+     * @return out
+     */
+    template <class E>
+    inline std::ostream& dump_json(std::ostream& out, const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        static_assert(std::is_arithmetic<value_type>::value, "dump_json requires an expression of booleans or numbers");
+        const E& de = e.derived_cast();
+        std::string buf;
+        auto it = de.template cbegin<layout_type::row_major>();
+        detail::dump_json_impl(out, buf, de.shape(), 0, it);
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        return out;
+    }
 }
 
 #endif
@@ -0,0 +1,337 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_KERNEL_HOLDER_HPP
+#define XTENSOR_KERNEL_HOLDER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xsequence.hpp>
+
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xexpression.hpp"
+#include "xiterator.hpp"
+#include "xlayout.hpp"
+#include "xstorage.hpp"
+#include "xstrides.hpp"
+#include "xtensor_config.hpp"
+#include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /****************************
+     * xkernel_holder internals *
+     ****************************/
+
+    namespace detail
+    {
+        // Computes the elements [first, first + n) of the expression, in
+        // row-major order, into out.
+        template <class T>
+        using xkernel_type = void (*)(const void* expression, std::size_t first, std::size_t n, T* out);
+
+        template <class T, class E>
+        inline void kernel_copy(const E& e, std::size_t first, std::size_t n, T* out, std::false_type /*use_simd*/)
+        {
+            auto it = linear_begin(e) + static_cast<std::ptrdiff_t>(first);
+            for (std::size_t i = 0; i < n; ++i, ++it)
+            {
+                out[i] = static_cast<T>(*it);
+            }
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class T, class E>
+        inline void kernel_copy(const E& e, std::size_t first, std::size_t n, T* out, std::true_type /*use_simd*/)
+        {
+            using size_type = typename E::size_type;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            std::size_t simd_end = (n / simd_size) * simd_size;
+            for (std::size_t i = 0; i < simd_end; i += simd_size)
+            {
+                xt_simd::store_as(out + i, e.template load_simd<unaligned_mode, T>(static_cast<size_type>(first + i)), unaligned_mode());
+            }
+            kernel_copy(e, first + simd_end, n - simd_end, out + simd_end, std::false_type());
+        }
+#endif
+
+        template <class T, class E>
+        struct use_simd_kernel
+        {
+            static constexpr bool value = std::is_same<typename E::value_type, T>::value
+                && has_simd_interface<E, T>::value
+                && has_simd_type<T>::value
+                && !std::is_same<T, bool>::value;
+        };
+
+        template <class T, class E>
+        inline void linear_kernel(const void* expression, std::size_t first, std::size_t n, T* out)
+        {
+            const E& e = *static_cast<const E*>(expression);
+            kernel_copy(e, first, n, out, std::integral_constant<bool, use_simd_kernel<T, E>::value>());
+        }
+
+        template <class T, class E>
+        inline void stepper_kernel(const void* expression, std::size_t first, std::size_t n, T* out)
+        {
+            const E& e = *static_cast<const E*>(expression);
+            auto it = e.template cbegin<layout_type::row_major>() + static_cast<std::ptrdiff_t>(first);
+            for (std::size_t i = 0; i < n; ++i, ++it)
+            {
+                out[i] = static_cast<T>(*it);
+            }
+        }
+
+        template <class E, class = void>
+        struct has_kernel_linear_assign : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_kernel_linear_assign<E, void_t<decltype(std::declval<const E&>().has_linear_assign(std::declval<const get_strides_t<typename E::shape_type>&>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class E>
+        inline bool is_row_major_linear(const E& e, std::true_type)
+        {
+            using strides_type = get_strides_t<typename E::shape_type>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), 0);
+            compute_strides(e.shape(), layout_type::row_major, strides);
+            return e.has_linear_assign(strides);
+        }
+
+        template <class E>
+        inline bool is_row_major_linear(const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class T, class E>
+        inline xkernel_type<T> make_kernel(const E& e)
+        {
+            if (is_row_major_linear(e, has_kernel_linear_assign<E>()))
+            {
+                return &linear_kernel<T, E>;
+            }
+            return &stepper_kernel<T, E>;
+        }
+    }
+
+    /******************
+     * xkernel_holder *
+     ******************/
+
+    /**
+     * @class xkernel_holder
+     * @brief Type-erased expression evaluated with a kernel compiled for its
+     * concrete type.
+     *
+     * The expression is copied when the holder is built, and an evaluation
+     * kernel is bound to it: a function pointer computing a contiguous range
+     * of its elements in row-major order. The kernel runs the linear, and
+     * vectorized when possible, loop of the concrete expression, so that
+     * expressions built at runtime only pay one indirect call per range
+     * instead of one per element. Copies of a holder share the expression;
+     * as for any lazy expression, the operands it holds by reference must
+     * outlive the holder.
+     *
+     * @tparam T The value type of the computed elements.
+     */
+    template <class T>
+    class xkernel_holder
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using shape_type = dynamic_shape<std::size_t>;
+
+        xkernel_holder() = default;
+
+        template <class E>
+        xkernel_holder(const xexpression<E>& e);
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+
+        void evaluate(value_type* out) const;
+        void evaluate(size_type first, size_type n, value_type* out) const;
+
+        template <class E>
+        void assign_to(xexpression<E>& e) const;
+
+    private:
+
+        template <class E>
+        void assign_to_impl(E& e, std::true_type) const;
+
+        template <class E>
+        void assign_to_impl(E& e, std::false_type) const;
+
+        void check_holder() const;
+
+        std::shared_ptr<const void> p_expression;
+        detail::xkernel_type<T> m_kernel = nullptr;
+        shape_type m_shape;
+        size_type m_size = 0;
+    };
+
+    /*********************************
+     * xkernel_holder implementation *
+     *********************************/
+
+    /**
+     * Builds an xkernel_holder from an xexpression, which is copied, and
+     * selects its kernel: the linear loop when the expression can be
+     * traversed linearly in row-major order, its row-major iterator
+     * otherwise.
+     * @param e the xexpression
+     */
+    template <class T>
+    template <class E>
+    inline xkernel_holder<T>::xkernel_holder(const xexpression<E>& e)
+    {
+        using expression_type = std::decay_t<E>;
+        auto expression = std::make_shared<const expression_type>(e.derived_cast());
+        m_kernel = detail::make_kernel<T>(*expression);
+        m_shape = xtl::forward_sequence<shape_type, decltype(expression->shape())>(expression->shape());
+        m_size = compute_size(m_shape);
+        p_expression = std::move(expression);
+    }
+
+    /**
+     * Returns true if the holder does not contain an expression.
+     */
+    template <class T>
+    inline bool xkernel_holder<T>::empty() const noexcept
+    {
+        return p_expression == nullptr;
+    }
+
+    /**
+     * Returns the number of elements of the expression.
+     */
+    template <class T>
+    inline auto xkernel_holder<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the number of dimensions of the expression.
+     */
+    template <class T>
+    inline auto xkernel_holder<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the expression.
+     */
+    template <class T>
+    inline auto xkernel_holder<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Computes all the elements of the expression, in row-major order, into
+     * the buffer \c out of size() elements. Large expressions are split into
+     * ranges computed in parallel when a parallel backend is enabled.
+     */
+    template <class T>
+    inline void xkernel_holder<T>::evaluate(value_type* out) const
+    {
+        check_holder();
+        exec::default_policy().for_range(size_type(0), m_size, size_type(1),
+                                         [this, out](size_type first, size_type last)
+        {
+            m_kernel(p_expression.get(), first, last - first, out + first);
+        });
+    }
+
+    /**
+     * Computes the \c n elements of the expression starting at the flat
+     * row-major index \c first into the buffer \c out.
+     */
+    template <class T>
+    inline void xkernel_holder<T>::evaluate(size_type first, size_type n, value_type* out) const
+    {
+        check_holder();
+        if (first + n > m_size)
+        {
+            XTENSOR_THROW(std::out_of_range, "xkernel_holder: range out of the expression");
+        }
+        m_kernel(p_expression.get(), first, n, out);
+    }
+
+    /**
+     * Assigns the expression to the container \c e, which is resized to its
+     * shape. Row-major containers are written directly by the kernel.
+     */
+    template <class T>
+    template <class E>
+    inline void xkernel_holder<T>::assign_to(xexpression<E>& e) const
+    {
+        check_holder();
+        E& de = e.derived_cast();
+        de.resize(xtl::forward_sequence<typename E::shape_type, const shape_type&>(m_shape));
+        assign_to_impl(de, std::is_same<typename E::value_type, value_type>());
+    }
+
+    template <class T>
+    template <class E>
+    inline void xkernel_holder<T>::assign_to_impl(E& e, std::true_type /*same_value_type*/) const
+    {
+        if (e.layout() == layout_type::row_major || m_shape.size() <= 1)
+        {
+            evaluate(e.data());
+        }
+        else
+        {
+            assign_to_impl(e, std::false_type());
+        }
+    }
+
+    template <class T>
+    template <class E>
+    inline void xkernel_holder<T>::assign_to_impl(E& e, std::false_type /*same_value_type*/) const
+    {
+        using e_value_type = typename E::value_type;
+        uvector<value_type> buffer(m_size);
+        evaluate(buffer.data());
+        std::transform(buffer.cbegin(), buffer.cend(), e.template begin<layout_type::row_major>(),
+                       [](const value_type& v) { return static_cast<e_value_type>(v); });
+    }
+
+    template <class T>
+    inline void xkernel_holder<T>::check_holder() const
+    {
+        if (p_expression == nullptr)
+        {
+            XTENSOR_THROW(std::runtime_error, "The holder does not contain an expression");
+        }
+    }
+}
+
+#endif
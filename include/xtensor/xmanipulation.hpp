@@ -10,8 +10,21 @@
 #ifndef XTENSOR_MANIPULATION_HPP
 #define XTENSOR_MANIPULATION_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+
 #include "xbuilder.hpp"
+#include "xexecution.hpp"
+#include "xnoalias.hpp"
+#include "xoperation.hpp"
 #include "xstrided_view.hpp"
+#include "xtensor.hpp"
 #include "xutils.hpp"
 #include "xtensor_config.hpp"
 #include "xrepeat.hpp"
@@ -34,15 +47,30 @@ namespace xt
     template <class E, class S, class Tag = check_policy::none>
     auto transpose(E&& e, S&& permutation, Tag check_policy = Tag());
 
+    template <class E>
+    void transpose_inplace(xexpression<E>& e);
+
+    template <class E, class S>
+    void transpose_inplace(xexpression<E>& e, const S& permutation);
+
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
     auto ravel(E&& e);
 
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
     auto flatten(E&& e);
 
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E, class S>
+    auto reshape_copy(E&& e, S&& shape);
+
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E, class I, std::size_t N>
+    auto reshape_copy(E&& e, const I(&shape)[N]);
+
     template <layout_type L, class T>
     auto flatnonzero(const T& arr);
 
+    template <layout_type L, class T>
+    xtensor<std::size_t, 1> flatnonzero_tensor(const T& arr);
+
     template <class E>
     auto trim_zeros(E&& e, const std::string& direction = "fb");
 
@@ -248,6 +276,236 @@ namespace xt
     }
     /// @endcond
 
+    /************************************
+     * transpose_inplace implementation *
+     ************************************/
+
+    namespace detail
+    {
+        // Transposes in place a square matrix of extent n stored
+        // contiguously, by swapping XTENSOR_ASSIGN_TILE_SIZE wide tiles
+        // across the diagonal. The tiles are copied row by row to buffers,
+        // so that the memory is never walked with a stride of n, which
+        // would thrash the cache when n is a power of two. Each row of
+        // tiles is a work item.
+        template <class T>
+        inline void transpose_square_inplace(T* data, std::size_t n)
+        {
+            constexpr std::size_t tile = XTENSOR_ASSIGN_TILE_SIZE;
+            std::size_t nb_tiles = (n + tile - 1) / tile;
+            exec::default_policy().for_range(std::size_t(0), nb_tiles, std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                std::vector<T> upper(tile * tile);
+                std::vector<T> lower(tile * tile);
+                for (std::size_t bi = first; bi < last; ++bi)
+                {
+                    std::size_t i0 = bi * tile;
+                    std::size_t ni = (std::min)(tile, n - i0);
+                    for (std::size_t j0 = i0; j0 < n; j0 += tile)
+                    {
+                        std::size_t nj = (std::min)(tile, n - j0);
+                        for (std::size_t i = 0; i < ni; ++i)
+                        {
+                            std::copy(data + (i0 + i) * n + j0, data + (i0 + i) * n + j0 + nj, upper.data() + i * tile);
+                        }
+                        for (std::size_t j = 0; j < nj; ++j)
+                        {
+                            std::copy(data + (j0 + j) * n + i0, data + (j0 + j) * n + i0 + ni, lower.data() + j * tile);
+                        }
+                        for (std::size_t i = 0; i < ni; ++i)
+                        {
+                            T* row = data + (i0 + i) * n + j0;
+                            for (std::size_t j = 0; j < nj; ++j)
+                            {
+                                row[j] = lower[j * tile + i];
+                            }
+                        }
+                        if (j0 != i0)
+                        {
+                            for (std::size_t j = 0; j < nj; ++j)
+                            {
+                                T* row = data + (j0 + j) * n + i0;
+                                for (std::size_t i = 0; i < ni; ++i)
+                                {
+                                    row[i] = upper[i * tile + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        // Moves the elements of the storage along the cycles of the
+        // permutation p -> dest(p), marking the visited positions.
+        template <class T, class F>
+        inline void transpose_cycles_inplace(T* data, std::size_t size, F&& dest)
+        {
+            std::vector<bool> visited(size, false);
+            for (std::size_t start = 0; start < size; ++start)
+            {
+                if (visited[start])
+                {
+                    continue;
+                }
+                visited[start] = true;
+                std::size_t next = dest(start);
+                if (next == start)
+                {
+                    continue;
+                }
+                T value = std::move(data[start]);
+                while (next != start)
+                {
+                    using std::swap;
+                    swap(value, data[next]);
+                    visited[next] = true;
+                    next = dest(next);
+                }
+                data[start] = std::move(value);
+            }
+        }
+
+        template <class E, class S>
+        inline void transpose_inplace_impl(E& e, const S& permutation)
+        {
+            using shape_type = typename E::shape_type;
+            const auto& shape = e.shape();
+            std::size_t dim = shape.size();
+            if (permutation.size() != dim)
+            {
+                XTENSOR_THROW(transpose_error, "Permutation does not have the same size as shape");
+            }
+            std::vector<bool> seen(dim, false);
+            for (std::size_t k = 0; k < dim; ++k)
+            {
+                std::size_t axis = static_cast<std::size_t>(permutation[k]);
+                if (axis >= dim || seen[axis])
+                {
+                    XTENSOR_THROW(transpose_error, "Permutation contains wrong or repeated axis");
+                }
+                seen[axis] = true;
+            }
+            layout_type l = e.layout();
+            if (!e.is_contiguous() || (l != layout_type::row_major && l != layout_type::column_major))
+            {
+                XTENSOR_THROW(transpose_error, "transpose_inplace requires a contiguous row_major or column_major container");
+            }
+
+            shape_type new_shape = xtl::make_sequence<shape_type>(dim, 0);
+            for (std::size_t k = 0; k < dim; ++k)
+            {
+                new_shape[k] = shape[static_cast<std::size_t>(permutation[k])];
+            }
+
+            std::size_t size = e.size();
+            bool identity = true;
+            for (std::size_t k = 0; k < dim; ++k)
+            {
+                identity = identity && (static_cast<std::size_t>(permutation[k]) == k || shape[k] == 1);
+            }
+            auto data = e.data() + static_cast<std::ptrdiff_t>(e.data_offset());
+            std::size_t m = dim == 2 ? static_cast<std::size_t>(shape[l == layout_type::row_major ? 0 : 1]) : 0;
+            if (identity || size < 2)
+            {
+                // The storage is unchanged
+            }
+            else if (dim == 2 && shape[0] == shape[1])
+            {
+                transpose_square_inplace(data, m);
+            }
+            else if (dim == 2 && size - 1 <= (std::numeric_limits<std::size_t>::max)() / m)
+            {
+                // The element at storage position p moves to p * m modulo
+                // size - 1, the last one staying in place.
+                transpose_cycles_inplace(data, size - 1, [m, size](std::size_t p)
+                {
+                    return (p * m) % (size - 1);
+                });
+            }
+            else
+            {
+                // The storage position of an element in the result is the sum
+                // of its indices weighted by the strides of the new shape,
+                // reordered to the axes of the original shape.
+                svector<std::size_t, 4> new_strides(dim);
+                compute_strides(new_shape, l, new_strides);
+                svector<std::size_t, 4> weights(dim);
+                svector<std::size_t, 4> extents(dim);
+                for (std::size_t k = 0; k < dim; ++k)
+                {
+                    std::size_t d = l == layout_type::row_major ? dim - 1 - k : k;
+                    extents[k] = static_cast<std::size_t>(shape[d]);
+                }
+                for (std::size_t k = 0; k < dim; ++k)
+                {
+                    std::size_t axis = static_cast<std::size_t>(permutation[k]);
+                    std::size_t pos = l == layout_type::row_major ? dim - 1 - axis : axis;
+                    weights[pos] = new_strides[k];
+                }
+                transpose_cycles_inplace(data, size, [&](std::size_t p)
+                {
+                    std::size_t q = 0;
+                    for (std::size_t k = 0; k < dim; ++k)
+                    {
+                        q += (p % extents[k]) * weights[k];
+                        p /= extents[k];
+                    }
+                    return q;
+                });
+            }
+            e.reshape(std::move(new_shape), l);
+        }
+    }
+
+    /**
+     * Transposes the contiguous container \c e in place, by reversing its
+     * dimensions. Contrary to \ref transpose, which returns a view, the
+     * elements are moved in the storage of \c e, which keeps its layout
+     * and is reshaped. Square matrices are transposed by swapping tiles
+     * across the diagonal, the other shapes by moving the elements along
+     * the cycles of the permutation, which only requires one bit of
+     * temporary memory per element.
+     * @param e the container to transpose
+     * @throws transpose_error if \c e is not a contiguous row_major or
+     *         column_major container
+     */
+    template <class E>
+    inline void transpose_inplace(xexpression<E>& e)
+    {
+        E& de = e.derived_cast();
+        std::size_t dim = de.dimension();
+        svector<std::size_t, 4> permutation(dim);
+        for (std::size_t k = 0; k < dim; ++k)
+        {
+            permutation[k] = dim - 1 - k;
+        }
+        detail::transpose_inplace_impl(de, permutation);
+    }
+
+    /**
+     * Permutes in place the dimensions of the contiguous container \c e
+     * with \c permutation; after the call, the dimension \c k of \c e is
+     * the dimension \c permutation[k] of the original container.
+     * @param e the container to transpose
+     * @param permutation the sequence containing permutation
+     * @throws transpose_error if the permutation is not valid, or if
+     *         \c e is not a contiguous row_major or column_major container
+     */
+    template <class E, class S>
+    inline void transpose_inplace(xexpression<E>& e, const S& permutation)
+    {
+        detail::transpose_inplace_impl(e.derived_cast(), permutation);
+    }
+
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <class E, class I, std::size_t N>
+    inline void transpose_inplace(xexpression<E>& e, const I(&permutation)[N])
+    {
+        detail::transpose_inplace_impl(e.derived_cast(), xtl::forward_sequence<std::array<std::size_t, N>, decltype(permutation)>(permutation));
+    }
+    /// @endcond
+
     /************************************
      * ravel and flatten implementation *
      ************************************/
@@ -312,6 +570,43 @@ namespace xt
         return ravel<L>(std::forward<E>(e));
     }
 
+    /**
+     * Returns a container holding the elements of the given expression with
+     * a new shape. Contrary to reshape_view, which reads the elements of an
+     * expression that is not a contiguous container from their flat index,
+     * the expression is evaluated once with the regular assignment.
+     * @param e the input expression
+     * @param shape the new shape, holding as many elements as e
+     * @tparam L the layout used to read the elements of e, which is also the
+     * layout of the returned container. If no parameter is specified,
+     * XTENSOR_DEFAULT_TRAVERSAL is used.
+     * @sa reshape_view, is_zero_copy_reshape
+     */
+    template <layout_type L, class E, class S>
+    inline auto reshape_copy(E&& e, S&& shape)
+    {
+        static_assert(L == layout_type::row_major || L == layout_type::column_major, "traversal has to be row or column major");
+        using value_type = typename std::decay_t<E>::value_type;
+        using shape_type = std::decay_t<S>;
+        using result_type = typename detail::xtype_for_shape<shape_type>::template type<value_type, L>;
+
+        if (compute_size(shape) != e.size())
+        {
+            XTENSOR_THROW(std::runtime_error, "Cannot reshape with incorrect number of elements.");
+        }
+        result_type res;
+        res.resize(std::forward<S>(shape));
+        noalias(reshape_view<L>(res, e.shape())) = e;
+        return res;
+    }
+
+    template <layout_type L, class E, class I, std::size_t N>
+    inline auto reshape_copy(E&& e, const I(&shape)[N])
+    {
+        using shape_type = std::array<std::size_t, N>;
+        return reshape_copy<L>(std::forward<E>(e), xtl::forward_sequence<shape_type, decltype(shape)>(shape));
+    }
+
     /**
      * @brief return indices that are non-zero in the flattened version of arr,
      * equivalent to nonzero(ravel<layout_type>(arr))[0];
@@ -322,7 +617,30 @@ namespace xt
     template <layout_type L, class T>
     inline auto flatnonzero(const T& arr)
     {
-        return nonzero(ravel<L>(arr))[0];
+        using size_type = typename T::size_type;
+        return detail::flat_nonzero<L, T, std::vector<size_type>>(arr);
+    }
+
+    /**
+     * @brief return indices that are non-zero in the flattened version of arr,
+     * as a one-dimensional tensor.
+     *
+     * The indices are counted first, so that the tensor is allocated once
+     * with its final size and filled in place.
+     *
+     * @param arr input array
+     * @return indices that are non-zero in the flattened version of arr
+     * @sa flatnonzero
+     */
+    template <layout_type L, class T>
+    inline xtensor<std::size_t, 1> flatnonzero_tensor(const T& arr)
+    {
+        using tensor_type = xtensor<std::size_t, 1>;
+        using storage_type = typename tensor_type::storage_type;
+        storage_type flat = detail::flat_nonzero<L, T, storage_type>(arr);
+        typename tensor_type::inner_shape_type shape = {flat.size()};
+        typename tensor_type::inner_strides_type strides = {1};
+        return tensor_type(std::move(flat), std::move(shape), std::move(strides));
     }
 
     /*****************************
@@ -631,12 +949,29 @@ namespace xt
     template <class E>
     inline auto flip(E&& e)
     {
-        using size_type = typename std::decay_t<E>::size_type;
-        auto r = flip(e, 0);
-        for (size_type d = 1; d < e.dimension(); ++d) {
-            r = flip(r, d);
+        using shape_type = xindex_type_t<typename std::decay_t<E>::shape_type>;
+
+        shape_type shape;
+        resize_container(shape, e.shape().size());
+        std::copy(e.shape().cbegin(), e.shape().cend(), shape.begin());
+
+        get_strides_t<shape_type> strides;
+        decltype(auto) old_strides = detail::get_strides<XTENSOR_DEFAULT_LAYOUT>(e);
+        resize_container(strides, old_strides.size());
+
+        // All the axes are reversed in a single view; assigning a flipped
+        // view to another one would copy the elements instead of rebinding.
+        std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(e.data_offset());
+        for (std::size_t d = 0; d < shape.size(); ++d)
+        {
+            strides[d] = -old_strides[d];
+            if (shape[d] != 0)
+            {
+                offset += old_strides[d] * (static_cast<std::ptrdiff_t>(shape[d]) - 1);
+            }
         }
-        return r;
+
+        return strided_view(std::forward<E>(e), std::move(shape), std::move(strides), static_cast<std::size_t>(offset));
     }
 
     /**
@@ -758,6 +1093,50 @@ namespace xt
      * roll implementation *
      ***********************/
 
+    namespace detail
+    {
+        // Rolls by shift runs of inner elements each of the outer slabs of
+        // extent runs of the contiguous expression e into res, with two
+        // block copies per slab. Returns false when e is not contiguous in
+        // the layout of res.
+        template <class R, class E>
+        inline bool roll_contiguous(R& res, const E& e, std::size_t outer, std::size_t extent, std::size_t inner, std::size_t shift, std::true_type)
+        {
+            layout_type l = res.layout();
+            if (e.layout() != l || !e.is_contiguous() || (l != layout_type::row_major && l != layout_type::column_major && res.dimension() > 1))
+            {
+                return false;
+            }
+            auto src = e.data() + static_cast<std::ptrdiff_t>(e.data_offset());
+            auto dst = res.data();
+            std::size_t slab = extent * inner;
+            std::size_t head = shift * inner;
+            exec::default_policy().for_range(std::size_t(0), outer, std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t o = first; o < last; ++o)
+                {
+                    auto s = src + static_cast<std::ptrdiff_t>(o * slab);
+                    auto d = dst + static_cast<std::ptrdiff_t>(o * slab);
+                    std::copy(s + static_cast<std::ptrdiff_t>(slab - head), s + static_cast<std::ptrdiff_t>(slab), d);
+                    std::copy(s, s + static_cast<std::ptrdiff_t>(slab - head), d + static_cast<std::ptrdiff_t>(head));
+                }
+            });
+            return true;
+        }
+
+        template <class R, class E>
+        inline bool roll_contiguous(R&, const E&, std::size_t, std::size_t, std::size_t, std::size_t, std::false_type)
+        {
+            return false;
+        }
+
+        template <class R, class E>
+        inline bool roll_contiguous(R& res, const E& e, std::size_t outer, std::size_t extent, std::size_t inner, std::size_t shift)
+        {
+            return roll_contiguous(res, e, outer, extent, inner, shift, has_data_interface<std::decay_t<E>>());
+        }
+    }
+
     /**
      * @brief Roll an expression.
      * The expression is flatten before shifting, after which the original
@@ -775,14 +1154,24 @@ namespace xt
     {
         auto cpy = empty_like(e);
         auto flat_size = std::accumulate(cpy.shape().begin(), cpy.shape().end(), 1L, std::multiplies<std::size_t>());
+        if (flat_size == 0)
+        {
+            return cpy;
+        }
         while(shift < 0)
         {
             shift += flat_size;
         }
 
         shift %= flat_size;
-        std::copy(e.begin(), e.end() - shift,
-                  std::copy(e.end() - shift, e.end(), cpy.begin()));
+        // The flattening follows the default traversal order, the storage
+        // can be rolled directly only when it has the same order
+        bool same_order = cpy.dimension() <= 1 || cpy.layout() == XTENSOR_DEFAULT_TRAVERSAL;
+        if (!same_order || !detail::roll_contiguous(cpy, e, std::size_t(1), static_cast<std::size_t>(flat_size), std::size_t(1), static_cast<std::size_t>(shift)))
+        {
+            std::copy(e.begin(), e.end() - shift,
+                      std::copy(e.end() - shift, e.end(), cpy.begin()));
+        }
 
         return cpy;
     }
@@ -862,11 +1251,11 @@ namespace xt
     {
         auto cpy = empty_like(e);
         auto const& shape = cpy.shape();
-        std::size_t saxis = static_cast<std::size_t>(axis);
         if(axis < 0)
         {
             axis += std::ptrdiff_t(cpy.dimension());
         }
+        std::size_t saxis = static_cast<std::size_t>(axis);
 
         if(saxis >= cpy.dimension() || axis < 0)
         {
@@ -874,12 +1263,32 @@ namespace xt
         }
 
         const auto axis_dim = static_cast<std::ptrdiff_t>(shape[saxis]);
+        if (axis_dim == 0)
+        {
+            return cpy;
+        }
         while(shift < 0)
         {
             shift += axis_dim;
         }
-
-        detail::roll(cpy.begin(), e.begin(), shift, saxis, shape, 0);
+        shift %= axis_dim;
+
+        // In the storage order of cpy, each slab spanning the rolled axis is
+        // made of axis_dim runs of inner elements
+        bool row_major = cpy.layout() != layout_type::column_major;
+        std::size_t inner = 1;
+        std::size_t outer = 1;
+        for (std::size_t d = 0; d < shape.size(); ++d)
+        {
+            if (d != saxis)
+            {
+                ((d > saxis) == row_major ? inner : outer) *= static_cast<std::size_t>(shape[d]);
+            }
+        }
+        if (!detail::roll_contiguous(cpy, e, outer, static_cast<std::size_t>(axis_dim), inner, static_cast<std::size_t>(shift)))
+        {
+            detail::roll(cpy.begin(), e.begin(), shift, saxis, shape, 0);
+        }
         return cpy;
     }
 
@@ -950,6 +1359,133 @@ namespace xt
     {
         return detail::make_xrepeat(std::forward<E>(e), std::move(repeats), axis);
     }
+
+    /**************************************
+     * sliding_window_view implementation *
+     **************************************/
+
+    namespace detail
+    {
+        template <class E, class W, class X>
+        inline auto sliding_window_view_impl(E&& e, const W& window_shape, const X& axes)
+        {
+            using shape_type = dynamic_shape<std::size_t>;
+            using strides_type = get_strides_t<shape_type>;
+
+            if (sequence_size(window_shape) != sequence_size(axes))
+            {
+                XTENSOR_THROW(std::runtime_error, "sliding_window_view: the window shape and the axes must have the same size");
+            }
+
+            const std::size_t dim = e.dimension();
+            const std::size_t nwin = sequence_size(window_shape);
+            decltype(auto) old_strides = detail::get_strides<XTENSOR_DEFAULT_LAYOUT>(e);
+            shape_type shape(dim + nwin);
+            strides_type strides(dim + nwin);
+            std::copy(e.shape().cbegin(), e.shape().cend(), shape.begin());
+            std::copy(old_strides.cbegin(), old_strides.cend(), strides.begin());
+
+            // The window axes step along the same memory as the axes they are
+            // taken from, so that consecutive windows overlap.
+            for (std::size_t k = 0; k < nwin; ++k)
+            {
+                std::size_t axis = normalize_axis(dim, static_cast<std::ptrdiff_t>(axes[k]));
+                if (axis >= dim)
+                {
+                    XTENSOR_THROW(std::runtime_error, "sliding_window_view: axis out of bounds");
+                }
+                std::size_t window = static_cast<std::size_t>(window_shape[k]);
+                if (window > shape[axis])
+                {
+                    XTENSOR_THROW(std::runtime_error, "sliding_window_view: the window is larger than the expression");
+                }
+                shape[axis] -= window - 1;
+                shape[dim + k] = window;
+                strides[dim + k] = old_strides[axis];
+            }
+
+            return strided_view(std::forward<E>(e), std::move(shape), std::move(strides),
+                                get_offset<XTENSOR_DEFAULT_LAYOUT>(e), layout_type::dynamic);
+        }
+    }
+
+    /**
+     * @brief Returns a view on the windows of an expression sliding along
+     * given axes.
+     *
+     * The view has the axes of \c e, shortened by the size of the window
+     * minus one along \c axes, followed by one axis per element of
+     * \c window_shape that runs within a window, as
+     * numpy.lib.stride_tricks.sliding_window_view. No copy is made: the
+     * windows overlap in the storage of \c e, and writing to the view
+     * modifies every window sharing that element.
+     *
+     * \code{.cpp}
+     * xt::xarray<int> a = {0, 1, 2, 3, 4};
+     * auto w = xt::sliding_window_view(a, {3}, {0});
+     * // ==> {{0, 1, 2}, {1, 2, 3}, {2, 3, 4}}
+     * auto s = xt::sum(w, {1});
+     * // ==> {3, 6, 9}
+     * \endcode
+     *
+     * @param e the input xexpression
+     * @param window_shape the sizes of the windows
+     * @param axes the axes along which the windows slide; an axis may appear
+     * more than once
+     * @return an \ref xstrided_view
+     */
+    template <class E, class W, class X,
+              XTL_REQUIRES(xtl::negation<xtl::is_integral<W>>, xtl::negation<xtl::is_integral<X>>)>
+    inline auto sliding_window_view(E&& e, const W& window_shape, const X& axes)
+    {
+        return detail::sliding_window_view_impl(std::forward<E>(e), window_shape, axes);
+    }
+
+    /**
+     * @brief Returns a view on the windows of an expression sliding along all
+     * its axes.
+     *
+     * \c window_shape must have one element per axis of \c e.
+     *
+     * @sa sliding_window_view(E&&, const W&, const X&)
+     */
+    template <class E, class W, XTL_REQUIRES(xtl::negation<xtl::is_integral<W>>)>
+    inline auto sliding_window_view(E&& e, const W& window_shape)
+    {
+        if (sequence_size(window_shape) != e.dimension())
+        {
+            XTENSOR_THROW(std::runtime_error, "sliding_window_view: the window shape must have one element per axis");
+        }
+        std::vector<std::size_t> axes(e.dimension());
+        std::iota(axes.begin(), axes.end(), std::size_t(0));
+        return detail::sliding_window_view_impl(std::forward<E>(e), window_shape, axes);
+    }
+
+    /**
+     * @brief Returns a view on the windows of an expression sliding along a
+     * single axis.
+     *
+     * @sa sliding_window_view(E&&, const W&, const X&)
+     */
+    template <class E>
+    inline auto sliding_window_view(E&& e, std::size_t window, std::ptrdiff_t axis)
+    {
+        return detail::sliding_window_view_impl(std::forward<E>(e), std::array<std::size_t, 1>{window},
+                                                std::array<std::ptrdiff_t, 1>{axis});
+    }
+
+    template <class E, class I, std::size_t N, class J, std::size_t M>
+    inline auto sliding_window_view(E&& e, const I (&window_shape)[N], const J (&axes)[M])
+    {
+        return detail::sliding_window_view_impl(std::forward<E>(e), xtl::forward_sequence<std::array<std::size_t, N>, decltype(window_shape)>(window_shape),
+                                                xtl::forward_sequence<std::array<std::ptrdiff_t, M>, decltype(axes)>(axes));
+    }
+
+    template <class E, class I, std::size_t N>
+    inline auto sliding_window_view(E&& e, const I (&window_shape)[N])
+    {
+        return sliding_window_view(std::forward<E>(e), xtl::forward_sequence<std::array<std::size_t, N>, decltype(window_shape)>(window_shape));
+    }
 }
 
 #endif
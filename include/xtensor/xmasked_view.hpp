@@ -13,8 +13,11 @@
 #include "xtl/xmasked_value.hpp"
 
 #include "xaccessible.hpp"
+#include "xbroadcast.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xnoalias.hpp"
+#include "xoperation.hpp"
 #include "xutils.hpp"
 #include "xshape.hpp"
 #include "xsemantic.hpp"
@@ -236,8 +239,81 @@ namespace xt
         template <class E>
         disable_xexpression<E, self_type>& operator=(const E& e);
 
+        using semantic_base::operator+=;
+        using semantic_base::operator-=;
+        using semantic_base::operator*=;
+        using semantic_base::operator/=;
+        using semantic_base::operator%=;
+        using semantic_base::operator&=;
+        using semantic_base::operator|=;
+        using semantic_base::operator^=;
+
+        template <class E>
+        self_type& operator+=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator-=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator*=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator/=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator%=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator&=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator|=(const xexpression<E>& e);
+
+        template <class E>
+        self_type& operator^=(const xexpression<E>& e);
+
+        template <class E, class F>
+        self_type& scalar_computed_assign(const E& e, F&& f);
+
     private:
 
+        // Assignments to a view on plain values are evaluated as a blend of
+        // the assigned values and the data selected by the mask, instead of
+        // a branch on the mask for each element
+        template <class T>
+        using use_blend = std::integral_constant<bool, std::is_arithmetic<base_value_type>::value &&
+                                                       std::is_arithmetic<T>::value>;
+
+        template <class E>
+        void assign_blend(const E& e);
+
+        template <class E>
+        void assign_scalar_blend(const E& e);
+
+        template <class E>
+        void assign_impl(const xexpression<E>& e, std::true_type);
+
+        template <class E>
+        void assign_impl(const xexpression<E>& e, std::false_type);
+
+        template <class E>
+        void assign_scalar_impl(const E& e, std::true_type);
+
+        template <class E>
+        void assign_scalar_impl(const E& e, std::false_type);
+
+        template <class E, class F>
+        void computed_assign_impl(const xexpression<E>& e, F f, std::true_type);
+
+        template <class E, class F>
+        void computed_assign_impl(const xexpression<E>& e, F f, std::false_type);
+
+        template <class E, class F>
+        void scalar_computed_assign_impl(const E& e, F&& f, std::true_type);
+
+        template <class E, class F>
+        void scalar_computed_assign_impl(const E& e, F&& f, std::false_type);
+
         CTD m_data;
         CTM m_mask;
 
@@ -580,17 +656,170 @@ namespace xt
     template <class E>
     inline auto xmasked_view<CTD, CTM>::operator=(const xexpression<E>& e) -> self_type&
     {
-        return semantic_base::operator=(e);
+        assign_impl(e, use_blend<typename E::value_type>());
+        return *this;
     }
 
     template <class CTD, class CTM>
     template <class E>
     inline auto xmasked_view<CTD, CTM>::operator=(const E& e) -> disable_xexpression<E, self_type>&
     {
-        std::fill(this->begin(), this->end(), e);
+        assign_scalar_impl(e, use_blend<E>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator+=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::plus<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator-=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::minus<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator*=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::multiplies<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator/=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::divides<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator%=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::modulus<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator&=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::bit_and<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator|=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::bit_or<>(), use_blend<typename E::value_type>());
         return *this;
     }
 
+    template <class CTD, class CTM>
+    template <class E>
+    inline auto xmasked_view<CTD, CTM>::operator^=(const xexpression<E>& e) -> self_type&
+    {
+        computed_assign_impl(e, std::bit_xor<>(), use_blend<typename E::value_type>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline auto xmasked_view<CTD, CTM>::scalar_computed_assign(const E& e, F&& f) -> self_type&
+    {
+        scalar_computed_assign_impl(e, std::forward<F>(f), use_blend<E>());
+        return *this;
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline void xmasked_view<CTD, CTM>::assign_blend(const E& e)
+    {
+        m_data = where(m_mask, e, m_data);
+    }
+
+    // A scalar assignment only reads the data at the assigned position,
+    // so that no temporary is needed
+    template <class CTD, class CTM>
+    template <class E>
+    inline void xmasked_view<CTD, CTM>::assign_scalar_blend(const E& e)
+    {
+        noalias(m_data) = where(m_mask, e, m_data);
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline void xmasked_view<CTD, CTM>::assign_impl(const xexpression<E>& e, std::true_type)
+    {
+        const E& de = e.derived_cast();
+        if (de.dimension() == dimension() && std::equal(shape().cbegin(), shape().cend(), de.shape().cbegin()))
+        {
+            assign_blend(de);
+        }
+        else
+        {
+            assign_blend(broadcast(de, shape()));
+        }
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline void xmasked_view<CTD, CTM>::assign_impl(const xexpression<E>& e, std::false_type)
+    {
+        semantic_base::operator=(e);
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline void xmasked_view<CTD, CTM>::assign_scalar_impl(const E& e, std::true_type)
+    {
+        assign_scalar_blend(e);
+    }
+
+    template <class CTD, class CTM>
+    template <class E>
+    inline void xmasked_view<CTD, CTM>::assign_scalar_impl(const E& e, std::false_type)
+    {
+        std::fill(this->begin(), this->end(), e);
+    }
+
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline void xmasked_view<CTD, CTM>::computed_assign_impl(const xexpression<E>& e, F f, std::true_type)
+    {
+        assign_impl(f(m_data, e.derived_cast()), std::true_type());
+    }
+
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline void xmasked_view<CTD, CTM>::computed_assign_impl(const xexpression<E>& e, F f, std::false_type)
+    {
+        *this = f(*this, e.derived_cast());
+    }
+
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline void xmasked_view<CTD, CTM>::scalar_computed_assign_impl(const E& e, F&& f, std::true_type)
+    {
+        assign_scalar_blend(f(m_data, e));
+    }
+
+    template <class CTD, class CTM>
+    template <class E, class F>
+    inline void xmasked_view<CTD, CTM>::scalar_computed_assign_impl(const E& e, F&& f, std::false_type)
+    {
+        semantic_base::scalar_computed_assign(e, std::forward<F>(f));
+    }
+
     template <class CTD, class CTM>
     inline void xmasked_view<CTD, CTM>::assign_temporary_impl(temporary_type&& tmp)
     {
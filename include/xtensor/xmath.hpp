@@ -18,7 +18,9 @@
 #include <algorithm>
 #include <array>
 #include <complex>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xcomplex.hpp>
 #include <xtl/xtype_traits.hpp>
@@ -29,6 +31,7 @@
 #include "xoperation.hpp"
 #include "xreducer.hpp"
 #include "xslice.hpp"
+#include "xsorted_index.hpp"
 #include "xstrided_view.hpp"
 #include "xtensor_config.hpp"
 
@@ -345,6 +348,44 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
         XTENSOR_UNARY_MATH_FUNCTOR(isnan);
     }
 
+#define XTENSOR_EXPENSIVE_FUNCTOR(NAME)                                           \
+    template <>                                                                   \
+    struct functor_cost<math::NAME##_fun>                                         \
+        : std::integral_constant<std::size_t, XTENSOR_EXPENSIVE_FUNCTOR_COST>     \
+    {                                                                             \
+    }
+
+    XTENSOR_EXPENSIVE_FUNCTOR(fmod);
+    XTENSOR_EXPENSIVE_FUNCTOR(remainder);
+    XTENSOR_EXPENSIVE_FUNCTOR(exp);
+    XTENSOR_EXPENSIVE_FUNCTOR(exp2);
+    XTENSOR_EXPENSIVE_FUNCTOR(expm1);
+    XTENSOR_EXPENSIVE_FUNCTOR(log);
+    XTENSOR_EXPENSIVE_FUNCTOR(log10);
+    XTENSOR_EXPENSIVE_FUNCTOR(log2);
+    XTENSOR_EXPENSIVE_FUNCTOR(log1p);
+    XTENSOR_EXPENSIVE_FUNCTOR(pow);
+    XTENSOR_EXPENSIVE_FUNCTOR(cbrt);
+    XTENSOR_EXPENSIVE_FUNCTOR(hypot);
+    XTENSOR_EXPENSIVE_FUNCTOR(sin);
+    XTENSOR_EXPENSIVE_FUNCTOR(cos);
+    XTENSOR_EXPENSIVE_FUNCTOR(tan);
+    XTENSOR_EXPENSIVE_FUNCTOR(asin);
+    XTENSOR_EXPENSIVE_FUNCTOR(acos);
+    XTENSOR_EXPENSIVE_FUNCTOR(atan);
+    XTENSOR_EXPENSIVE_FUNCTOR(atan2);
+    XTENSOR_EXPENSIVE_FUNCTOR(sinh);
+    XTENSOR_EXPENSIVE_FUNCTOR(cosh);
+    XTENSOR_EXPENSIVE_FUNCTOR(tanh);
+    XTENSOR_EXPENSIVE_FUNCTOR(asinh);
+    XTENSOR_EXPENSIVE_FUNCTOR(acosh);
+    XTENSOR_EXPENSIVE_FUNCTOR(atanh);
+    XTENSOR_EXPENSIVE_FUNCTOR(erf);
+    XTENSOR_EXPENSIVE_FUNCTOR(erfc);
+    XTENSOR_EXPENSIVE_FUNCTOR(tgamma);
+    XTENSOR_EXPENSIVE_FUNCTOR(lgamma);
+
+#undef XTENSOR_EXPENSIVE_FUNCTOR
 #undef XTENSOR_UNARY_MATH_FUNCTOR
 #undef XTENSOR_BINARY_MATH_FUNCTOR
 #undef XTENSOR_TERNARY_MATH_FUNCTOR
@@ -607,6 +648,114 @@ namespace detail {
             }
         };
 
+        namespace detail
+        {
+            // Integers narrower than 64 bits are computed in 64 bits and
+            // clamped, a form which compilers vectorize
+            template <class T>
+            constexpr T saturate_wide(long long v) noexcept
+            {
+                return static_cast<T>(v < static_cast<long long>((std::numeric_limits<T>::min)()) ? (std::numeric_limits<T>::min)()
+                                    : v > static_cast<long long>((std::numeric_limits<T>::max)()) ? (std::numeric_limits<T>::max)()
+                                    : v);
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<std::is_integral<T>::value && (sizeof(T) < sizeof(long long)), T>
+            saturating_add(T a, T b) noexcept
+            {
+                return saturate_wide<T>(static_cast<long long>(a) + static_cast<long long>(b));
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<std::is_integral<T>::value && (sizeof(T) < sizeof(long long)), T>
+            saturating_sub(T a, T b) noexcept
+            {
+                return saturate_wide<T>(static_cast<long long>(a) - static_cast<long long>(b));
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<std::is_unsigned<T>::value && (sizeof(T) >= sizeof(long long)), T>
+            saturating_add(T a, T b) noexcept
+            {
+                return a > (std::numeric_limits<T>::max)() - b ? (std::numeric_limits<T>::max)() : T(a + b);
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<std::is_unsigned<T>::value && (sizeof(T) >= sizeof(long long)), T>
+            saturating_sub(T a, T b) noexcept
+            {
+                return a < b ? T(0) : T(a - b);
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<std::is_signed<T>::value && std::is_integral<T>::value && (sizeof(T) >= sizeof(long long)), T>
+            saturating_add(T a, T b) noexcept
+            {
+                return b > 0 ? (a > (std::numeric_limits<T>::max)() - b ? (std::numeric_limits<T>::max)() : T(a + b))
+                             : (a < (std::numeric_limits<T>::min)() - b ? (std::numeric_limits<T>::min)() : T(a + b));
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<std::is_signed<T>::value && std::is_integral<T>::value && (sizeof(T) >= sizeof(long long)), T>
+            saturating_sub(T a, T b) noexcept
+            {
+                return b < 0 ? (a > (std::numeric_limits<T>::max)() + b ? (std::numeric_limits<T>::max)() : T(a - b))
+                             : (a < (std::numeric_limits<T>::min)() + b ? (std::numeric_limits<T>::min)() : T(a - b));
+            }
+
+            // Floating point values saturate to infinity by themselves
+            template <class T>
+            constexpr std::enable_if_t<!std::is_integral<T>::value, T> saturating_add(T a, T b) noexcept
+            {
+                return a + b;
+            }
+
+            template <class T>
+            constexpr std::enable_if_t<!std::is_integral<T>::value, T> saturating_sub(T a, T b) noexcept
+            {
+                return a - b;
+            }
+        }
+
+        // The operands are converted to their common type, whose limits
+        // bound the result; unlike operator+, integers narrower than int are
+        // not promoted, and their batches are added with the saturating
+        // instructions of xsimd.
+        struct saturating_add_fun
+        {
+            template <class A1, class A2>
+            constexpr auto operator()(const A1& a, const A2& b) const noexcept
+            {
+                using result_type = std::common_type_t<A1, A2>;
+                return detail::saturating_add(static_cast<result_type>(a), static_cast<result_type>(b));
+            }
+
+            // sadd is found by argument dependent lookup in the namespace of
+            // the batch
+            template <class B>
+            B simd_apply(const B& a, const B& b) const noexcept
+            {
+                return sadd(a, b);
+            }
+        };
+
+        struct saturating_sub_fun
+        {
+            template <class A1, class A2>
+            constexpr auto operator()(const A1& a, const A2& b) const noexcept
+            {
+                using result_type = std::common_type_t<A1, A2>;
+                return detail::saturating_sub(static_cast<result_type>(a), static_cast<result_type>(b));
+            }
+
+            template <class B>
+            B simd_apply(const B& a, const B& b) const noexcept
+            {
+                return ssub(a, b);
+            }
+        };
+
         struct deg2rad
         {
             template <class A, std::enable_if_t<xtl::is_integral<A>::value, int> = 0>
@@ -803,6 +952,44 @@ namespace detail {
         return detail::make_xfunction<math::clamp_fun>(std::forward<E1>(e1), std::forward<E2>(lo), std::forward<E3>(hi));
     }
 
+    /**
+     * @ingroup basic_functions
+     * @brief Saturating addition
+     *
+     * Returns an \ref xfunction for the element-wise sum of \em e1 and
+     * \em e2, clamped to the limits of the common value type of the
+     * arguments instead of wrapping around. Integers narrower than int are
+     * not promoted: the scalar arguments should have the value type of the
+     * expressions, e.g. \c uint8_t(10) for an \c xarray<uint8_t>.
+     * @param e1 an \ref xexpression or a scalar
+     * @param e2 an \ref xexpression or a scalar
+     * @return an \ref xfunction
+     */
+    template <class E1, class E2>
+    inline auto saturating_add(E1&& e1, E2&& e2) noexcept
+        -> detail::xfunction_type_t<math::saturating_add_fun, E1, E2>
+    {
+        return detail::make_xfunction<math::saturating_add_fun>(std::forward<E1>(e1), std::forward<E2>(e2));
+    }
+
+    /**
+     * @ingroup basic_functions
+     * @brief Saturating subtraction
+     *
+     * Returns an \ref xfunction for the element-wise difference of \em e1
+     * and \em e2, clamped to the limits of the common value type of the
+     * arguments instead of wrapping around.
+     * @param e1 an \ref xexpression or a scalar
+     * @param e2 an \ref xexpression or a scalar
+     * @return an \ref xfunction
+     */
+    template <class E1, class E2>
+    inline auto saturating_sub(E1&& e1, E2&& e2) noexcept
+        -> detail::xfunction_type_t<math::saturating_sub_fun, E1, E2>
+    {
+        return detail::make_xfunction<math::saturating_sub_fun>(std::forward<E1>(e1), std::forward<E2>(e2));
+    }
+
     namespace math
     {
         template <class T>
@@ -1012,29 +1199,6 @@ namespace detail {
             : decltype(supports_test(std::declval<F>(), std::declval<T>()...))
         {
         };
-
-        template <class F>
-        struct lambda_adapt
-        {
-            explicit lambda_adapt(F&& lmbd)
-                : m_lambda(std::move(lmbd))
-            {
-            }
-
-            template <class... T>
-            auto operator()(T... args) const
-            {
-                return m_lambda(args...);
-            }
-
-            template <class... T, XTL_REQUIRES(detail::supports<F(T...)>)>
-            auto simd_apply(T... args) const
-            {
-                return m_lambda(args...);
-            }
-
-            F m_lambda;
-        };
     }
 
     /**
@@ -1066,8 +1230,9 @@ namespace detail {
     template <class F, class... E>
     inline auto make_lambda_xfunction(F&& lambda, E&&... args)
     {
-        using xfunction_type = typename detail::xfunction_type<detail::lambda_adapt<F>, E...>::type;
-        return xfunction_type(detail::lambda_adapt<F>(std::forward<F>(lambda)), std::forward<E>(args)...);
+        using functor_type = detail::lambda_functor_t<F, sizeof...(E)>;
+        using xfunction_type = typename detail::xfunction_type<functor_type, E...>::type;
+        return xfunction_type(functor_type(std::forward<F>(lambda)), std::forward<E>(args)...);
     }
 
 
@@ -1838,7 +2003,9 @@ namespace detail {
      * \em axes.
      * @param e an \ref xexpression
      * @param axes the axes along which the sum is performed (optional)
-     * @param es evaluation strategy of the reducer
+     * @param es evaluation strategy of the reducer; \c summation::pairwise or
+     *           \c summation::kahan select a compensated summation, which is
+     *           evaluated immediately
      * @tparam T the value type used for internal computation. The default is
      *           `E::value_type`. `T` is also used for determining the value type
      *           of the result, which is the type of `T() + E::value_type()`.
@@ -1867,6 +2034,98 @@ namespace detail {
      */
     XTENSOR_REDUCER_FUNCTION(prod, detail::multiplies, typename std::decay_t<E>::value_type, 1)
 
+    /*********************
+     * masked reductions *
+     *********************/
+
+    /**
+     * @brief Mask of the elements taking part in a reduction, built by
+     * \ref where_mask.
+     *
+     * The masked reducers reduce where(mask, e, neutral), where neutral
+     * is the neutral element of the reduction: the mask is evaluated in
+     * the reduction loop, with SIMD blends when the expression is
+     * vectorized, instead of gathering the selected elements like filter.
+     */
+    template <class M>
+    class xwhere_mask
+    {
+    public:
+
+        explicit xwhere_mask(M mask)
+            : m_mask(std::forward<M>(mask))
+        {
+        }
+
+        M mask() const
+        {
+            return m_mask;
+        }
+
+        M release() &&
+        {
+            return std::forward<M>(m_mask);
+        }
+
+    private:
+
+        M m_mask;
+    };
+
+    /**
+     * @ingroup red_functions
+     * @brief Restricts a reduction to the elements where \em mask is true,
+     * like the \c where argument of NumPy.
+     *
+     * \code{.cpp}
+     * auto s = xt::sum(a, {1}, xt::where_mask(a > 0.));
+     * auto m = xt::mean(a, xt::where_mask(valid));
+     * \endcode
+     *
+     * The mask is broadcast to the shape of the reduced expression. The
+     * minimum and maximum of an empty selection are the initial values
+     * of amin and amax, and its mean is NaN.
+     * @param mask a boolean \ref xexpression
+     * @return an option accepted by sum, prod, amin, amax and mean
+     */
+    template <class M>
+    inline auto where_mask(M&& mask)
+    {
+        return xwhere_mask<xtl::closure_type_t<M>>(std::forward<M>(mask));
+    }
+
+#define XTENSOR_MASKED_REDUCER_FUNCTION(NAME, NEUTRAL)                                                        \
+    template <class T = void, class E, class X, class M, class EVS = DEFAULT_STRATEGY_REDUCERS,                \
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>                                             \
+    inline auto NAME(E&& e, X&& axes, xwhere_mask<M> mask, EVS es = EVS())                                    \
+    {                                                                                                         \
+        using value_type = xvalue_type_t<std::decay_t<E>>;                                                    \
+        return NAME<T>(where(std::move(mask).release(), std::forward<E>(e), value_type(NEUTRAL)),             \
+                       std::forward<X>(axes), es);                                                            \
+    }                                                                                                         \
+                                                                                                              \
+    template <class T = void, class E, class M, class EVS = DEFAULT_STRATEGY_REDUCERS,                         \
+              XTL_REQUIRES(is_reducer_options<EVS>)>                                                          \
+    inline auto NAME(E&& e, xwhere_mask<M> mask, EVS es = EVS())                                              \
+    {                                                                                                         \
+        using value_type = xvalue_type_t<std::decay_t<E>>;                                                    \
+        return NAME<T>(where(std::move(mask).release(), std::forward<E>(e), value_type(NEUTRAL)), es);        \
+    }                                                                                                         \
+                                                                                                              \
+    template <class T = void, class E, class I, std::size_t N, class M, class EVS = DEFAULT_STRATEGY_REDUCERS> \
+    inline auto NAME(E&& e, const I (&axes)[N], xwhere_mask<M> mask, EVS es = EVS())                          \
+    {                                                                                                         \
+        using value_type = xvalue_type_t<std::decay_t<E>>;                                                    \
+        return NAME<T>(where(std::move(mask).release(), std::forward<E>(e), value_type(NEUTRAL)), axes, es);  \
+    }
+
+    XTENSOR_MASKED_REDUCER_FUNCTION(sum, 0)
+    XTENSOR_MASKED_REDUCER_FUNCTION(prod, 1)
+    XTENSOR_MASKED_REDUCER_FUNCTION(amin, std::numeric_limits<value_type>::max())
+    XTENSOR_MASKED_REDUCER_FUNCTION(amax, std::numeric_limits<value_type>::lowest())
+
+#undef XTENSOR_MASKED_REDUCER_FUNCTION
+
     namespace detail
     {
         template <class T, class S, class ST>
@@ -1949,6 +2208,123 @@ namespace detail {
         return detail::mean<T>(std::forward<E>(e), axes, 0u, es);
     }
 
+    namespace detail
+    {
+        // Number of selected elements of each lane, the mask being
+        // broadcast to the shape of the reduced expression
+        template <class T, class E, class M>
+        inline auto masked_count(const E& e, const xwhere_mask<M>& mask)
+        {
+            using shape_type = dynamic_shape<std::size_t>;
+            shape_type shape(e.shape().cbegin(), e.shape().cend());
+            return broadcast(where(mask.mask(), T(1), T(0)), std::move(shape));
+        }
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Mean of the elements selected by a mask over given axes.
+     *
+     * @param e an \ref xexpression
+     * @param axes the axes along which the mean is computed (optional)
+     * @param mask the selected elements, see \ref where_mask
+     * @param es the evaluation strategy (optional)
+     * @return an \ref xexpression
+     */
+    template <class T = void, class E, class X, class M, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
+    inline auto mean(E&& e, X&& axes, xwhere_mask<M> mask, EVS es = EVS())
+    {
+        using value_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        auto count = sum<value_type>(detail::masked_count<value_type>(e, mask), axes, es);
+        auto s = sum<T>(std::forward<E>(e), std::forward<X>(axes), std::move(mask), es);
+        return std::move(s) / std::move(count);
+    }
+
+    template <class T = void, class E, class M, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(is_reducer_options<EVS>)>
+    inline auto mean(E&& e, xwhere_mask<M> mask, EVS es = EVS())
+    {
+        using value_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        auto count = sum<value_type>(detail::masked_count<value_type>(e, mask), es);
+        auto s = sum<T>(std::forward<E>(e), std::move(mask), es);
+        return std::move(s) / std::move(count);
+    }
+
+    template <class T = void, class E, class I, std::size_t N, class M, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto mean(E&& e, const I (&axes)[N], xwhere_mask<M> mask, EVS es = EVS())
+    {
+        using value_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+        auto count = sum<value_type>(detail::masked_count<value_type>(e, mask), axes, es);
+        auto s = sum<T>(std::forward<E>(e), axes, std::move(mask), es);
+        return std::move(s) / std::move(count);
+    }
+
+    /**************
+     * lazy_where *
+     **************/
+
+    namespace detail
+    {
+        // Assigns the elements of e at the flat positions of res, in the
+        // traversal order of plan
+        template <class R, class PL, class C, class E, class P>
+        inline void assign_at_positions(R& res, const PL& plan, const C& positions, const E& e, const P& policy)
+        {
+            using value_type = typename R::value_type;
+            using index_type = xindex_type_t<typename R::shape_type>;
+            // Computes the shape cache of e before the parallel loop
+            (void) e.shape();
+            policy.for_range(std::size_t(0), positions.size(), std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                index_type idx = xtl::make_sequence<index_type>(res.dimension(), 0);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    plan.unravel(static_cast<std::ptrdiff_t>(positions[i]), idx);
+                    res.element(idx.cbegin(), idx.cend()) = static_cast<value_type>(e.element(idx.cbegin(), idx.cend()));
+                }
+            });
+        }
+    }
+
+    /**
+     * @ingroup logical_operators
+     * @brief Ternary selection computing each branch only where it is selected.
+     *
+     * Returns the evaluation of where(e1, e2, e3), where the elements of
+     * \a e2 are only computed at the positions where \a e1 is true, and
+     * the ones of \a e3 where it is false. The positions of both branches
+     * are compacted first, then the branches are evaluated at their
+     * positions, in parallel according to \a policy. This pays off for
+     * expensive branches selected by a sparse condition, e.g.
+     * <tt>lazy_where(x > 0., log(x), nan)</tt>; where(e1, e2, e3)
+     * computes both branches with a branch-free select, which remains the
+     * fastest choice for cheap branches.
+     *
+     * @param e1 a boolean \ref xexpression
+     * @param e2 an \ref xexpression or a scalar
+     * @param e3 an \ref xexpression or a scalar
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     * @return the evaluated selection
+     */
+    template <class E1, class E2, class E3, class P = exec::default_policy,
+              class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto lazy_where(E1&& e1, E2&& e2, E3&& e3, const P& policy = P())
+    {
+        auto f = where(std::forward<E1>(e1), std::forward<E2>(e2), std::forward<E3>(e3));
+        using result_type = temporary_type_t<decltype(f)>;
+
+        result_type res = result_type::from_shape(f.shape());
+        dynamic_shape<std::size_t> shape(f.shape().cbegin(), f.shape().cend());
+        xarray<bool> mask = broadcast(std::get<0>(f.arguments()), shape);
+        auto selected = detail::flat_nonzero<XTENSOR_DEFAULT_TRAVERSAL>(mask);
+        auto rejected = detail::flat_nonzero<XTENSOR_DEFAULT_TRAVERSAL>(!mask);
+        auto plan = unravel_plan(mask.shape(), XTENSOR_DEFAULT_TRAVERSAL);
+        detail::assign_at_positions(res, plan, selected, std::get<1>(f.arguments()), policy);
+        detail::assign_at_positions(res, plan, rejected, std::get<2>(f.arguments()), policy);
+        return res;
+    }
+
     /**
      * @ingroup red_functions
      * @brief Average of elements over given axes using weights.
@@ -2049,6 +2425,11 @@ namespace detail {
         {
             return make_xshared(std::move(e));
         }
+
+        // Immediate evaluation keeping the summation selected in O.
+        template <class O>
+        using immediate_summation_t = std::tuple<evaluation_strategy::immediate_type,
+                                                 typename reducer_options<int, std::decay_t<O>>::summation>;
     }
 
     template <class T = void, class E, class D, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -2105,7 +2486,7 @@ namespace detail {
         // note: forcing copy of first axes argument -- is there a better solution?
         auto axes_copy = axes;
         // always eval to prevent repeated evaluations in the next calls
-        auto inner_mean = eval(mean<T>(sc, std::move(axes_copy), evaluation_strategy::immediate));
+        auto inner_mean = eval(mean<T>(sc, std::move(axes_copy), detail::immediate_summation_t<EVS>()));
 
         // fake keep_dims = 1
         auto keep_dim_shape = e.shape();
@@ -2170,7 +2551,8 @@ namespace detail {
                            es);
     }
 
-    template <class T = void, class E, class A, std::size_t N, class D, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    template <class T = void, class E, class A, std::size_t N, class D, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<D>>)>
     inline auto variance(E&& e, const A (&axes)[N], D const& ddof, EVS es = EVS())
     {
       return variance<T>(std::forward<E>(e),
@@ -2179,6 +2561,118 @@ namespace detail {
                          es);
     }
 
+    namespace detail
+    {
+        template <class T>
+        struct use_simd_minmax
+        {
+#if defined(XTENSOR_USE_XSIMD)
+            static constexpr bool value = !std::is_same<T, bool>::value &&
+                                          xt_simd::simd_traits<T>::size > 1;
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        template <class T>
+        inline std::size_t minmax_accumulate(const T*, std::size_t, std::array<T, 2>&, std::false_type /*use_simd*/)
+        {
+            return 0;
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        // Scans the largest multiple of the step of [first, first + size)
+        // and returns its length; the bounds are kept in two pairs of
+        // registers to hide the latency of the comparisons.
+        template <class T>
+        inline std::size_t minmax_accumulate(const T* first, std::size_t size, std::array<T, 2>& res, std::true_type /*use_simd*/)
+        {
+            using batch_type = xt_simd::simd_type<T>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            constexpr std::size_t n_acc = 2;
+            constexpr std::size_t step = n_acc * simd_size;
+
+            std::size_t i = 0;
+            if (size < step)
+            {
+                return i;
+            }
+            batch_type lo[n_acc];
+            batch_type hi[n_acc];
+            for (std::size_t k = 0; k < n_acc; ++k)
+            {
+                lo[k] = batch_type(res[0]);
+                hi[k] = batch_type(res[1]);
+            }
+            for (; i + step <= size; i += step)
+            {
+                for (std::size_t k = 0; k < n_acc; ++k)
+                {
+                    batch_type b = xt_simd::load_as<T>(first + i + k * simd_size, unaligned_mode());
+                    lo[k] = xt_simd::select(b < lo[k], b, lo[k]);
+                    hi[k] = xt_simd::select(hi[k] < b, b, hi[k]);
+                }
+            }
+            alignas(batch_type) T lo_buffer[simd_size];
+            alignas(batch_type) T hi_buffer[simd_size];
+            xt_simd::store_as(lo_buffer, xt_simd::select(lo[1] < lo[0], lo[1], lo[0]), aligned_mode());
+            xt_simd::store_as(hi_buffer, xt_simd::select(hi[0] < hi[1], hi[1], hi[0]), aligned_mode());
+            for (std::size_t k = 0; k < simd_size; ++k)
+            {
+                res[0] = lo_buffer[k] < res[0] ? lo_buffer[k] : res[0];
+                res[1] = res[1] < hi_buffer[k] ? hi_buffer[k] : res[1];
+            }
+            return i;
+        }
+#endif
+
+        /**
+         * Reduction functor of minmax: both bounds are updated in a single
+         * pass over the elements, like std::min and std::max, so that NaN
+         * values never replace a bound. Contiguous ranges of arithmetic
+         * values are scanned in SIMD registers when xsimd is enabled.
+         */
+        template <class T>
+        struct minmax_reduce
+        {
+            using result_type = std::array<T, 2>;
+
+            template <class V>
+            result_type operator()(result_type r, const V& v) const
+            {
+                r[0] = v < r[0] ? v : r[0];
+                r[1] = r[1] < v ? v : r[1];
+                return r;
+            }
+
+            template <class It, XTL_REQUIRES(std::is_pointer<It>,
+                                             std::is_same<std::remove_cv_t<std::remove_pointer_t<It>>, T>,
+                                             std::is_arithmetic<T>)>
+            result_type accumulate(It first, It last, result_type init) const
+            {
+                std::size_t size = static_cast<std::size_t>(last - first);
+                using use_simd = std::integral_constant<bool, use_simd_minmax<T>::value>;
+                std::size_t i = minmax_accumulate(first, size, init, use_simd());
+                for (; i < size; ++i)
+                {
+                    init = (*this)(init, first[i]);
+                }
+                return init;
+            }
+        };
+
+        template <class T>
+        struct minmax_merge
+        {
+            std::array<T, 2> operator()(std::array<T, 2> r, const std::array<T, 2>& s) const
+            {
+                r[0] = s[0] < r[0] ? s[0] : r[0];
+                r[1] = r[1] < s[1] ? s[1] : r[1];
+                return r;
+            }
+        };
+    }
+
     /**
      * @ingroup red_functions
      * @brief Minimum and maximum among the elements of an array or expression.
@@ -2193,77 +2687,196 @@ namespace detail {
               XTL_REQUIRES(is_reducer_options<EVS>)>
     inline auto minmax(E&& e, EVS es = EVS())
     {
-        using std::min;
-        using std::max;
         using value_type = typename std::decay_t<E>::value_type;
         using result_type = std::array<value_type, 2>;
         using init_value_fct = xt::const_value<result_type>;
 
-        auto reduce_func = [](auto r, const auto& v) {
-            r[0] = (min)(r[0], v);
-            r[1] = (max)(r[1], v);
-            return r;
-        };
-
         auto init_func = init_value_fct(result_type{std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::lowest()});
 
-        auto merge_func = [](auto r, const auto& s) {
-            r[0] = (min)(r[0], s[0]);
-            r[1] = (max)(r[1], s[1]);
-            return r;
-        };
-        return xt::reduce(make_xreducer_functor(std::move(reduce_func),
+        return xt::reduce(make_xreducer_functor(detail::minmax_reduce<value_type>(),
                                                 std::move(init_func),
-                                                std::move(merge_func)),
+                                                detail::minmax_merge<value_type>()),
                       std::forward<E>(e), arange(e.dimension()), es);
     }
 
     /**
-     * @defgroup acc_functions accumulating functions
-     */
-
-    /**
-     * @ingroup acc_functions
-     * @brief Cumulative sum.
+     * @brief Running moments of a set of values, as accumulated by
+     * \ref moments.
      *
-     * Returns the accumulated sum for the elements over given
-     * \em axis (or flattened).
-     * @param e an \ref xexpression
-     * @param axis the axes along which the cumulative sum is computed (optional)
-     * @tparam T the value type used for internal computation. The default is
-     *           `E::value_type`. `T`is also used for determining the value type of the result,
-     *           which is the type of `T() + E::value_type()`.
-     *           You can pass `big_promote_value_type_t<E>` to avoid overflow in computation.
-     * @return an \ref xarray<T>
+     * Holds the number of values, their mean and the sum of squared
+     * deviations from the mean.
      */
-    template <class T = void, class E>
-    inline auto cumsum(E&& e, std::ptrdiff_t axis)
+    template <class T>
+    struct xmoments
     {
-        using init_value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
-        return accumulate(make_xaccumulator_functor(detail::plus(), detail::accumulator_identity<init_value_type>()),
-                          std::forward<E>(e),
-                          axis);
-    }
+        using value_type = T;
 
-    template <class T = void, class E>
-    inline auto cumsum(E&& e)
-    {
-        using init_value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
-        return accumulate(make_xaccumulator_functor(detail::plus(), detail::accumulator_identity<init_value_type>()),
-                          std::forward<E>(e));
-    }
+        std::size_t count;
+        T mean;
+        T m2;
 
-    /**
-     * @ingroup acc_functions
-     * @brief Cumulative product.
-     *
-     * Returns the accumulated product for the elements over given
-     * \em axis (or flattened).
-     * @param e an \ref xexpression
-     * @param axis the axes along which the cumulative product is computed (optional)
-     * @tparam T the value type used for internal computation. The default is
-     *           `E::value_type`. `T`is also used for determining the value type of the result,
-     *           which is the type of `T() * E::value_type()`.
+        T variance(std::size_t ddof = 0) const
+        {
+            return m2 / static_cast<T>(count - ddof);
+        }
+
+        T stddev(std::size_t ddof = 0) const
+        {
+            using std::sqrt;
+            return sqrt(variance(ddof));
+        }
+    };
+
+    namespace detail
+    {
+        // Welford's update with one value
+        template <class T>
+        struct moments_reduce
+        {
+            template <class V>
+            xmoments<T> operator()(xmoments<T> r, const V& v) const
+            {
+                T x = static_cast<T>(v);
+                ++r.count;
+                T delta = x - r.mean;
+                r.mean += delta / static_cast<T>(r.count);
+                r.m2 += delta * (x - r.mean);
+                return r;
+            }
+        };
+
+        // Chan et al. combination of two partial results
+        template <class T>
+        struct moments_merge
+        {
+            xmoments<T> operator()(const xmoments<T>& a, const xmoments<T>& b) const
+            {
+                if (a.count == 0)
+                {
+                    return b;
+                }
+                if (b.count == 0)
+                {
+                    return a;
+                }
+                std::size_t count = a.count + b.count;
+                T na = static_cast<T>(a.count);
+                T nb = static_cast<T>(b.count);
+                T n = static_cast<T>(count);
+                T delta = b.mean - a.mean;
+                return xmoments<T>{count, a.mean + delta * (nb / n), a.m2 + b.m2 + delta * delta * (na * nb / n)};
+            }
+        };
+
+        template <class T, class E>
+        using moments_value_type_t = std::conditional_t<std::is_same<T, void>::value,
+                                                           std::conditional_t<std::is_integral<typename std::decay_t<E>::value_type>::value,
+                                                                              double,
+                                                                              typename std::decay_t<E>::value_type>,
+                                                           T>;
+
+        template <class T, class E>
+        inline auto make_moments_functors()
+        {
+            using value_type = moments_value_type_t<T, E>;
+            using init_value_fct = xt::const_value<xmoments<value_type>>;
+            return make_xreducer_functor(moments_reduce<value_type>(),
+                                         init_value_fct(xmoments<value_type>{0, value_type(0), value_type(0)}),
+                                         moments_merge<value_type>());
+        }
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Mean and variance of elements over given axes, in a single pass.
+     *
+     * Returns an \ref xreducer of \ref xmoments, from which the mean, the
+     * variance and the standard deviation of the reduced elements are read.
+     * Values are accumulated with Welford's algorithm, and partial results of
+     * merged axes, threads or chunks are combined with the formula of Chan et
+     * al., which is numerically stable and does not read the input twice
+     * like \ref variance.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the moments are computed (optional)
+     * @param es evaluation strategy of the reducer
+     * @tparam T the value type used for computation. The default is
+     *           `E::value_type`, or `double` for integral types.
+     * @return an \ref xreducer
+     * @sa mean, variance, stddev
+     */
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>, xtl::negation<xtl::is_integral<std::decay_t<X>>>)>
+    inline auto moments(E&& e, X&& axes, EVS es = EVS())
+    {
+        return xt::reduce(detail::make_moments_functors<T, E>(), std::forward<E>(e), std::forward<X>(axes), es);
+    }
+
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>, xtl::is_integral<std::decay_t<X>>)>
+    inline auto moments(E&& e, X axis, EVS es = EVS())
+    {
+        return moments<T>(std::forward<E>(e), {axis}, es);
+    }
+
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(is_reducer_options<EVS>)>
+    inline auto moments(E&& e, EVS es = EVS())
+    {
+        return xt::reduce(detail::make_moments_functors<T, E>(), std::forward<E>(e), es);
+    }
+
+    template <class T = void, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto moments(E&& e, const I (&axes)[N], EVS es = EVS())
+    {
+        return xt::reduce(detail::make_moments_functors<T, E>(), std::forward<E>(e), axes, es);
+    }
+
+    /**
+     * @defgroup acc_functions accumulating functions
+     */
+
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative sum.
+     *
+     * Returns the accumulated sum for the elements over given
+     * \em axis (or flattened).
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative sum is computed (optional)
+     * @tparam T the value type used for internal computation. The default is
+     *           `E::value_type`. `T`is also used for determining the value type of the result,
+     *           which is the type of `T() + E::value_type()`.
+     *           You can pass `big_promote_value_type_t<E>` to avoid overflow in computation.
+     * @return an \ref xarray<T>
+     */
+    template <class T = void, class E>
+    inline auto cumsum(E&& e, std::ptrdiff_t axis)
+    {
+        using init_value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
+        return accumulate(make_xaccumulator_functor(detail::plus(), detail::accumulator_identity<init_value_type>()),
+                          std::forward<E>(e),
+                          axis);
+    }
+
+    template <class T = void, class E>
+    inline auto cumsum(E&& e)
+    {
+        using init_value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
+        return accumulate(make_xaccumulator_functor(detail::plus(), detail::accumulator_identity<init_value_type>()),
+                          std::forward<E>(e));
+    }
+
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative product.
+     *
+     * Returns the accumulated product for the elements over given
+     * \em axis (or flattened).
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative product is computed (optional)
+     * @tparam T the value type used for internal computation. The default is
+     *           `E::value_type`. `T`is also used for determining the value type of the result,
+     *           which is the type of `T() * E::value_type()`.
      *           You can pass `big_promote_value_type_t<E>` to avoid overflow in computation.
      * @return an \ref xarray<T>
      */
@@ -2319,10 +2932,15 @@ namespace detail {
             template <class T, class U>
             constexpr auto operator()(const T lhs, const U rhs) const
             {
-                // Clunky expression for working with GCC 4.9
-                return math::isnan(lhs) ?
-                       rhs :
-                       (math::isnan(rhs) ? lhs : std::common_type_t<T, U>(detail::make_xfunction<math::minimum<void>>(lhs, rhs)));
+                using value_type = std::common_type_t<T, U>;
+                return (math::isnan(lhs) || value_type(rhs) < value_type(lhs)) ? value_type(rhs) : value_type(lhs);
+            }
+
+            template <class B>
+            constexpr auto simd_apply(const B& lhs, const B& rhs) const
+            {
+                return xt_simd::select(math::isnan_fun().simd_apply(lhs), rhs,
+                                       xt_simd::select(rhs < lhs, rhs, lhs));
             }
         };
 
@@ -2331,10 +2949,15 @@ namespace detail {
             template <class T, class U>
             constexpr auto operator()(const T lhs, const U rhs) const
             {
-                // Clunky expression for working with GCC 4.9
-                return math::isnan(lhs) ?
-                       rhs :
-                       (math::isnan(rhs) ? lhs : std::common_type_t<T, U>(detail::make_xfunction<math::maximum<void>>(lhs, rhs)));
+                using value_type = std::common_type_t<T, U>;
+                return (math::isnan(lhs) || value_type(lhs) < value_type(rhs)) ? value_type(rhs) : value_type(lhs);
+            }
+
+            template <class B>
+            constexpr auto simd_apply(const B& lhs, const B& rhs) const
+            {
+                return xt_simd::select(math::isnan_fun().simd_apply(lhs), rhs,
+                                       xt_simd::select(lhs < rhs, rhs, lhs));
             }
         };
 
@@ -2345,6 +2968,12 @@ namespace detail {
             {
                 return !math::isnan(rhs) ? lhs + rhs : lhs;
             }
+
+            template <class B>
+            constexpr auto simd_apply(const B& lhs, const B& rhs) const
+            {
+                return lhs + xt_simd::select(math::isnan_fun().simd_apply(rhs), B(0), rhs);
+            }
         };
 
         struct nan_multiplies
@@ -2354,6 +2983,61 @@ namespace detail {
             {
                 return !math::isnan(rhs) ? lhs * rhs : lhs;
             }
+
+            template <class B>
+            constexpr auto simd_apply(const B& lhs, const B& rhs) const
+            {
+                return lhs * xt_simd::select(math::isnan_fun().simd_apply(rhs), B(1), rhs);
+            }
+        };
+
+        // nan_plus and nan_multiplies ignore a nan on their right-hand side
+        // only, their accumulators start from the first elements with the
+        // nans replaced by the identity.
+        template <int V>
+        struct nan_reducer_start
+        {
+            template <class U>
+            static constexpr U apply(const U& v)
+            {
+                return math::isnan(v) ? U(V) : v;
+            }
+
+            template <class B>
+            static constexpr B simd_apply(const B& b)
+            {
+                return xt_simd::select(math::isnan_fun().simd_apply(b), B(V), b);
+            }
+        };
+
+        template <>
+        struct simd_reducer_start<nan_plus> : nan_reducer_start<0>
+        {
+        };
+
+        template <>
+        struct simd_reducer_start<nan_multiplies> : nan_reducer_start<1>
+        {
+        };
+
+        template <>
+        struct is_simd_reducer<nan_min> : std::true_type
+        {
+        };
+
+        template <>
+        struct is_simd_reducer<nan_max> : std::true_type
+        {
+        };
+
+        template <>
+        struct is_simd_reducer<nan_plus> : std::true_type
+        {
+        };
+
+        template <>
+        struct is_simd_reducer<nan_multiplies> : std::true_type
+        {
         };
 
         template <class T, int V>
@@ -2366,6 +3050,38 @@ namespace detail {
                 return math::isnan(lhs) ? result_type(V) : lhs;
             }
         };
+
+        /***************
+         * scan_traits *
+         ***************/
+
+        template <class T>
+        struct scan_traits<plus, accumulator_identity<T>>
+        {
+            using combine_type = plus;
+            static constexpr bool simd_plus = true;
+        };
+
+        template <class T>
+        struct scan_traits<multiplies, accumulator_identity<T>>
+        {
+            using combine_type = multiplies;
+            static constexpr bool simd_plus = false;
+        };
+
+        template <class T>
+        struct scan_traits<nan_plus, nan_init<T, 0>>
+        {
+            using combine_type = plus;
+            static constexpr bool simd_plus = false;
+        };
+
+        template <class T>
+        struct scan_traits<nan_multiplies, nan_init<T, 1>>
+        {
+            using combine_type = multiplies;
+            static constexpr bool simd_plus = false;
+        };
     }
 
     /**
@@ -2468,13 +3184,32 @@ namespace detail {
     };                                                                                      \
     auto merge_func = detail::plus();                                                       \
 
+    namespace detail
+    {
+        template <class E, class EVS>
+        inline auto count_nonzero_impl(E&& e, EVS es, std::false_type /*is_bit_array*/)
+        {
+            COUNT_NON_ZEROS_CONTENT;
+            return xt::reduce(make_xreducer_functor(std::move(reduce_fct), std::move(init_fct), std::move(merge_func)),
+                          std::forward<E>(e), es);
+        }
+
+        // A packed mask is counted with one popcount per block
+        template <class E, class EVS>
+        inline auto count_nonzero_impl(E&& e, EVS, std::true_type /*is_bit_array*/)
+        {
+            using result_type = xt::detail::xreducer_size_type_t<bool>;
+            return xscalar<result_type>(static_cast<result_type>(e.storage().count()));
+        }
+    }
+
     template <class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
               XTL_REQUIRES(is_reducer_options<EVS>)>
     inline auto count_nonzero(E&& e, EVS es = EVS())
     {
-        COUNT_NON_ZEROS_CONTENT;
-        return xt::reduce(make_xreducer_functor(std::move(reduce_fct), std::move(init_fct), std::move(merge_func)),
-                      std::forward<E>(e), es);
+        using is_packed = std::integral_constant<bool, is_bit_array<E>::value
+                                                   && std::is_same<EVS, DEFAULT_STRATEGY_REDUCERS>::value>;
+        return detail::count_nonzero_impl(std::forward<E>(e), es, is_packed());
     }
 
     template <class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -2589,74 +3324,362 @@ namespace detail {
 
     namespace detail
     {
-        template <class T>
-        struct diff_impl
+        /***********************
+         * axis lanes kernels *
+         ***********************/
+
+        // Number of adjacent lanes processed together by the kernels
+        // running along an axis, and number of elements of a tile of
+        // positions along that axis: the rows of a tile are read
+        // contiguously and stay in the L1 cache.
+        constexpr std::size_t axis_lane_block = 64;
+        constexpr std::size_t axis_tile_elements = 4096;
+
+        // A row-major array seen as outer x length x inner, the kernels
+        // running along the middle axis.
+        struct axis_lanes
+        {
+            std::size_t outer;
+            std::size_t length;
+            std::size_t inner;
+        };
+
+        template <class S>
+        inline axis_lanes make_axis_lanes(const S& shape, std::size_t axis)
         {
-            template <class Arg>
-            inline void operator()(Arg& ad, const std::size_t& n,
-                                   xstrided_slice_vector& slice1, xstrided_slice_vector& slice2,
-                                   std::size_t saxis)
+            axis_lanes l = {1, static_cast<std::size_t>(shape[axis]), 1};
+            for (std::size_t d = 0; d < axis; ++d)
             {
-                for (std::size_t i = 0; i < n; ++i)
+                l.outer *= static_cast<std::size_t>(shape[d]);
+            }
+            for (std::size_t d = axis + 1; d < shape.size(); ++d)
+            {
+                l.inner *= static_cast<std::size_t>(shape[d]);
+            }
+            return l;
+        }
+
+        // Calls f(o, lane, nlanes, first, last) for the tiles [first, last)
+        // of the count positions of the result along the axis and the blocks
+        // of lanes of each outer index o, split among the threads of policy.
+        template <class P, class F>
+        inline void for_each_axis_tile(const axis_lanes& l, std::size_t count, std::size_t tile, const P& policy, F&& f)
+        {
+            const std::size_t blocks = (l.inner + axis_lane_block - 1) / axis_lane_block;
+            const std::size_t tiles = (count + tile - 1) / tile;
+            policy.for_range(0, l.outer * blocks * tiles, 1, [&](std::size_t first_task, std::size_t last_task)
+            {
+                for (std::size_t task = first_task; task < last_task; ++task)
                 {
-                    slice2[saxis] = range(xnone(), ad.shape()[saxis] - 1);
-                    ad = strided_view(ad, slice1) - strided_view(ad, slice2);
+                    const std::size_t t = task % tiles;
+                    const std::size_t lane = ((task / tiles) % blocks) * axis_lane_block;
+                    f(task / (tiles * blocks), lane, (std::min)(axis_lane_block, l.inner - lane),
+                      t * tile, (std::min)(count, (t + 1) * tile));
                 }
+            });
+        }
+
+        // Returns the elements of e in row-major order, copying them to
+        // storage unless e already holds them contiguously.
+        template <class A, class E>
+        inline const typename A::value_type* row_major_data(const E& e, A& storage, std::true_type)
+        {
+            if (e.layout() == layout_type::row_major && e.is_contiguous())
+            {
+                return e.data() + static_cast<std::ptrdiff_t>(e.data_offset());
+            }
+            storage = e;
+            return storage.data();
+        }
+
+        template <class A, class E>
+        inline const typename A::value_type* row_major_data(const E& e, A& storage, std::false_type)
+        {
+            storage = e;
+            return storage.data();
+        }
+
+        template <class A, class E>
+        inline const typename A::value_type* row_major_data(const E& e, A& storage)
+        {
+            return row_major_data(e, storage, has_data_interface<E>());
+        }
+
+        template <class T>
+        struct diff_op
+        {
+            T operator()(const T& prev, const T& next) const
+            {
+                return static_cast<T>(next - prev);
             }
         };
 
         template <>
-        struct diff_impl<bool>
+        struct diff_op<bool>
+        {
+            bool operator()(bool prev, bool next) const
+            {
+                return prev != next;
+            }
+        };
+
+        // n-th difference of the positions [first, last) of the result in
+        // nlanes adjacent lanes. The last - first + n rows of the input they
+        // depend on are copied to a buffer and differenced there n times in
+        // place, which rounds as differencing the whole array n times.
+        template <class T>
+        inline void diff_tile(const T* src, T* dst, std::size_t inner, std::size_t n,
+                              std::size_t first, std::size_t last, std::size_t nlanes)
         {
-            template <class Arg>
-            inline void operator()(Arg& ad, const std::size_t& n,
-                                   xstrided_slice_vector& slice1, xstrided_slice_vector& slice2,
-                                   std::size_t saxis)
+            const std::size_t rows = last - first + n;
+            uvector<T> buf(rows * nlanes);
+            for (std::size_t r = 0; r < rows; ++r)
+            {
+                std::copy(src + (first + r) * inner, src + (first + r) * inner + nlanes, buf.data() + r * nlanes);
+            }
+            diff_op<T> op;
+            for (std::size_t k = 1; k <= n; ++k)
             {
-                for (std::size_t i = 0; i < n; ++i)
+                for (std::size_t r = 0; r + k < rows; ++r)
                 {
-                    slice2[saxis] = range(xnone(), ad.shape()[saxis] - 1);
-                    ad = not_equal(strided_view(ad, slice1), strided_view(ad, slice2));
+                    T* cur = buf.data() + r * nlanes;
+                    const T* next = cur + nlanes;
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        cur[j] = op(cur[j], next[j]);
+                    }
                 }
             }
-        };
-    }
+            for (std::size_t r = 0; r < last - first; ++r)
+            {
+                std::copy(buf.data() + r * nlanes, buf.data() + (r + 1) * nlanes, dst + (first + r) * inner);
+            }
+        }
 
-    /**
-     * @ingroup nan_functions
-     * @brief Mean of elements over given axes, excluding nans.
-     *
-     * Returns an \ref xreducer for the mean of elements over given
-     * \em axes, excluding nans.
-     * @param e an \ref xexpression
-     * @param axes the axes along which the mean is computed (optional)
-     * @param es the evaluation strategy (optional)
-     * @tparam T the result type. The default is `E::value_type`.
-     *           You can pass `big_promote_value_type_t<E>` to avoid overflow in computation.
-     * @return an \ref xexpression
-     */
-    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
-              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
-    inline auto nanmean(E&& e, X&& axes, EVS es = EVS())
-    {
-        decltype(auto) sc = detail::shared_forward<E>(e);
-        // note: forcing copy of first axes argument -- is there a better solution?
-        auto axes_copy = axes;
-        using value_type = typename std::conditional_t<std::is_same<T, void>::value, double, T>;
-        using sum_type = typename std::conditional_t<std::is_same<T, void>::value, typename std::common_type_t<typename std::decay_t<E>::value_type, value_type>, T>;
-        // sum cannot always be a double. It could be a complex number which cannot operate on
-        // std::plus<double>.
-        return nansum<sum_type>(sc, std::forward<X>(axes), es) / xt::cast<value_type>(count_nonnan(sc, std::move(axes_copy), es));
+        template <class T>
+        using axis_integral_type = std::common_type_t<double, T>;
+
+        // Sums of y[t] + y[t + 1] along the lanes, weighted by dx[t] when
+        // the spacing is given by the lane dx of the same geometry
+        // (DX == 2), or by its element t (DX == 1).
+        template <std::size_t DX, class R, class T, class X>
+        inline void trapz_block(const T* y, const X* x, R* res, std::size_t length, std::size_t inner, std::size_t nlanes)
+        {
+            std::fill(res, res + nlanes, R(0));
+            for (std::size_t t = 0; t + 1 < length; ++t)
+            {
+                const T* cur = y + t * inner;
+                const T* next = cur + inner;
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    R pair = static_cast<R>(cur[j]) + static_cast<R>(next[j]);
+                    if (DX == 1)
+                    {
+                        pair *= static_cast<R>(x[t + 1] - x[t]);
+                    }
+                    else if (DX == 2)
+                    {
+                        pair *= static_cast<R>(x[(t + 1) * inner + j] - x[t * inner + j]);
+                    }
+                    res[j] += pair;
+                }
+            }
+        }
+
+        template <std::size_t DX, class T, class X, class S, class P>
+        inline auto trapz_impl(const T* y, const X* x, const S& y_shape, std::size_t saxis, double scale, const P& policy)
+        {
+            using result_type = axis_integral_type<T>;
+            using array_type = xarray<result_type, layout_type::row_major>;
+            const axis_lanes l = make_axis_lanes(y_shape, saxis);
+            typename array_type::shape_type res_shape(y_shape.cbegin(), y_shape.cend());
+            res_shape.erase(res_shape.begin() + static_cast<std::ptrdiff_t>(saxis));
+            array_type res = array_type::from_shape(res_shape);
+            result_type* out = res.data();
+            for_each_axis_tile(l, std::size_t(1), std::size_t(1), policy,
+                [&](std::size_t o, std::size_t lane, std::size_t nlanes, std::size_t, std::size_t)
+            {
+                const std::size_t offset = o * l.length * l.inner + lane;
+                result_type* r = out + o * l.inner + lane;
+                trapz_block<DX>(y + offset, DX == 2 ? x + offset : x, r, l.length, l.inner, nlanes);
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    r[j] *= static_cast<result_type>(scale);
+                }
+            });
+            return res;
+        }
     }
 
-    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
-              XTL_REQUIRES(is_reducer_options<EVS>)>
-    inline auto nanmean(E&& e, EVS es = EVS())
+    namespace detail
     {
-        decltype(auto) sc = detail::shared_forward<E>(e);
-        using value_type = typename std::conditional_t<std::is_same<T, void>::value, double, T>;
-        using sum_type = typename std::conditional_t<std::is_same<T, void>::value, typename std::common_type_t<typename std::decay_t<E>::value_type, value_type>, T>;
-        return nansum<sum_type>(sc, es) / xt::cast<value_type>(count_nonnan(sc, es));
+        // nanmean accumulates the sum and the count of the non-nan elements
+        // in a single traversal.
+        template <class S>
+        struct nan_mean_accumulator
+        {
+            S sum;
+            std::size_t count;
+        };
+
+        template <class T, class E>
+        struct nan_mean_types
+        {
+            using value_type = std::conditional_t<std::is_same<T, void>::value, double, T>;
+            // sum cannot always be a double. It could be a complex number which
+            // cannot operate on std::plus<double>.
+            using sum_type = std::conditional_t<std::is_same<T, void>::value,
+                                                std::common_type_t<typename std::decay_t<E>::value_type, value_type>,
+                                                T>;
+            using accumulator_type = nan_mean_accumulator<std::decay_t<decltype(std::declval<sum_type>() +
+                                                                                std::declval<typename std::decay_t<E>::value_type>())>>;
+        };
+
+        struct nan_mean_reduce
+        {
+            template <class S, class V>
+            nan_mean_accumulator<S> operator()(const nan_mean_accumulator<S>& acc, const V& v) const
+            {
+                bool is_nan = math::isnan(v);
+                return {acc.sum + (is_nan ? S(0) : static_cast<S>(v)),
+                        acc.count + (is_nan ? std::size_t(0) : std::size_t(1))};
+            }
+
+            // Contiguous reductions of arithmetic types keep independent
+            // lanes of sums and counts, which the compiler vectorizes.
+            template <class S, class V>
+            nan_mean_accumulator<S> accumulate(const V* first, const V* last, nan_mean_accumulator<S> init) const
+            {
+                using use_lanes = std::integral_constant<bool, std::is_arithmetic<S>::value && std::is_arithmetic<V>::value>;
+                return accumulate_impl(first, last, init, use_lanes());
+            }
+
+        private:
+
+            template <class S, class V>
+            nan_mean_accumulator<S> accumulate_impl(const V* first, const V* last, nan_mean_accumulator<S> init,
+                                                    std::false_type) const
+            {
+                return std::accumulate(first, last, init, *this);
+            }
+
+            template <class S, class V>
+            nan_mean_accumulator<S> accumulate_impl(const V* first, const V* last, nan_mean_accumulator<S> init,
+                                                    std::true_type) const
+            {
+                constexpr std::size_t n_lanes = 16;
+                std::size_t size = static_cast<std::size_t>(last - first);
+                nan_mean_accumulator<S> res = init;
+                dispatch_kernel([&]()
+                {
+                    S sum[n_lanes] = {};
+                    std::size_t count[n_lanes] = {};
+                    std::size_t i = 0;
+                    for (; i + n_lanes <= size; i += n_lanes)
+                    {
+                        for (std::size_t j = 0; j < n_lanes; ++j)
+                        {
+                            bool is_nan = math::isnan(first[i + j]);
+                            sum[j] += is_nan ? S(0) : static_cast<S>(first[i + j]);
+                            count[j] += is_nan ? std::size_t(0) : std::size_t(1);
+                        }
+                    }
+                    for (std::size_t j = 0; j < n_lanes; ++j)
+                    {
+                        res.sum += sum[j];
+                        res.count += count[j];
+                    }
+                    for (; i < size; ++i)
+                    {
+                        res = (*this)(res, first[i]);
+                    }
+                });
+                return res;
+            }
+        };
+
+        struct nan_mean_merge
+        {
+            template <class S>
+            nan_mean_accumulator<S> operator()(const nan_mean_accumulator<S>& lhs, const nan_mean_accumulator<S>& rhs) const
+            {
+                return {lhs.sum + rhs.sum, lhs.count + rhs.count};
+            }
+        };
+
+        template <class V>
+        struct nan_mean_result
+        {
+            template <class S>
+            constexpr auto operator()(const nan_mean_accumulator<S>& acc) const
+            {
+                return acc.sum / static_cast<V>(acc.count);
+            }
+        };
+
+        template <class V, class R>
+        inline auto make_nan_mean(R&& red, evaluation_strategy::lazy_type)
+        {
+            return make_xfunction<nan_mean_result<V>>(std::forward<R>(red));
+        }
+
+        // The immediate reductions return containers of accumulators, which
+        // are converted to the means right away.
+        template <class V, class R>
+        inline auto make_nan_mean(R&& red, evaluation_strategy::immediate_type)
+        {
+            using accumulator_container = std::decay_t<R>;
+            using value_type = std::decay_t<decltype(nan_mean_result<V>()(std::declval<typename accumulator_container::value_type>()))>;
+            using shape_type = std::decay_t<decltype(red.shape())>;
+            using result_type = typename xtype_for_shape<shape_type>::template type<value_type, accumulator_container::static_layout>;
+            result_type res;
+            res.resize(red.shape());
+            std::transform(red.storage().cbegin(), red.storage().cend(), res.storage().begin(), nan_mean_result<V>());
+            return res;
+        }
+
+        template <class T, class E>
+        inline auto make_nan_mean_functors()
+        {
+            using accumulator_type = typename nan_mean_types<T, E>::accumulator_type;
+            return make_xreducer_functor(nan_mean_reduce(),
+                                         const_value<accumulator_type>(accumulator_type{0, 0}),
+                                         nan_mean_merge());
+        }
+    }
+
+    /**
+     * @ingroup nan_functions
+     * @brief Mean of elements over given axes, excluding nans.
+     *
+     * Returns an \ref xreducer for the mean of elements over given
+     * \em axes, excluding nans.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the mean is computed (optional)
+     * @param es the evaluation strategy (optional)
+     * @tparam T the result type. The default is `E::value_type`.
+     *           You can pass `big_promote_value_type_t<E>` to avoid overflow in computation.
+     * @return an \ref xexpression
+     */
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
+    inline auto nanmean(E&& e, X&& axes, EVS es = EVS())
+    {
+        using value_type = typename detail::nan_mean_types<T, E>::value_type;
+        using evaluation_strategy = typename reducer_options<value_type, EVS>::evaluation_strategy;
+        return detail::make_nan_mean<value_type>(xt::reduce(detail::make_nan_mean_functors<T, E>(), std::forward<E>(e),
+                                                            std::forward<X>(axes), es),
+                                                 evaluation_strategy());
+    }
+
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(is_reducer_options<EVS>)>
+    inline auto nanmean(E&& e, EVS es = EVS())
+    {
+        using value_type = typename detail::nan_mean_types<T, E>::value_type;
+        using evaluation_strategy = typename reducer_options<value_type, EVS>::evaluation_strategy;
+        return detail::make_nan_mean<value_type>(xt::reduce(detail::make_nan_mean_functors<T, E>(), std::forward<E>(e), es),
+                                                 evaluation_strategy());
     }
 
     template <class T = void, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
@@ -2768,6 +3791,65 @@ namespace detail {
      * @brief Calculate the n-th discrete difference along the given axis.
      *
      * Calculate the n-th discrete difference along the given axis. This function is not lazy (might change in the future).
+     * The differences of the elements of tiles of adjacent lanes are computed from a copy of the elements they depend on,
+     * in a single pass over the expression; the tiles are split among the threads of the policy.
+     * @param a an \ref xexpression
+     * @param n The number of times values are differenced. If zero, the input is returned as-is.
+     * @param axis The axis along which the difference is taken.
+     * @param policy the execution policy splitting the tiles
+     * @return an xarray
+     */
+    template <class T, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    auto diff(const xexpression<T>& a, std::size_t n, std::ptrdiff_t axis, const P& policy)
+    {
+        using temporary_type = typename std::decay_t<T>::temporary_type;
+        using value_type = typename T::value_type;
+        using array_type = xarray<value_type, layout_type::row_major>;
+
+        const auto& de = a.derived_cast();
+        std::size_t saxis = normalize_axis(de.dimension(), axis);
+        if (n == std::size_t(0))
+        {
+            return temporary_type(de);
+        }
+
+        const detail::axis_lanes l = detail::make_axis_lanes(de.shape(), saxis);
+        const std::size_t count = n < l.length ? l.length - n : std::size_t(0);
+        typename temporary_type::shape_type shape;
+        resize_container(shape, de.dimension());
+        std::copy(de.shape().cbegin(), de.shape().cend(), shape.begin());
+        shape[saxis] = count;
+        temporary_type res;
+        res.resize(shape);
+
+        array_type in_storage;
+        const value_type* src = detail::row_major_data(de, in_storage);
+        array_type out_storage;
+        const bool direct = res.layout() == layout_type::row_major;
+        if (!direct)
+        {
+            out_storage.resize(shape);
+        }
+        value_type* dst = direct ? res.data() : out_storage.data();
+
+        const std::size_t tile = (std::max)(std::size_t(1), detail::axis_tile_elements / (std::min)(l.inner, detail::axis_lane_block));
+        detail::for_each_axis_tile(l, count, tile, policy,
+            [&](std::size_t o, std::size_t lane, std::size_t nlanes, std::size_t first, std::size_t last)
+        {
+            detail::diff_tile(src + o * l.length * l.inner + lane, dst + o * count * l.inner + lane,
+                              l.inner, n, first, last, nlanes);
+        });
+        if (!direct)
+        {
+            noalias(res) = out_storage;
+        }
+        return res;
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Calculate the n-th discrete difference along the given axis, on the calling thread.
+     *
      * @param a an \ref xexpression
      * @param n The number of times values are differenced. If zero, the input is returned as-is. (optional)
      * @param axis The axis along which the difference is taken, default is the last axis.
@@ -2776,28 +3858,32 @@ namespace detail {
     template <class T>
     auto diff(const xexpression<T>& a, std::size_t n = 1, std::ptrdiff_t axis = -1)
     {
-        typename std::decay_t<T>::temporary_type ad = a.derived_cast();
-        std::size_t saxis = normalize_axis(ad.dimension(), axis);
-        if(n <= ad.size())
-        {
+        return diff(a, n, axis, exec::default_policy());
+    }
 
-            if (n != std::size_t(0))
-            {
-                xstrided_slice_vector slice1(ad.dimension(), all());
-                xstrided_slice_vector slice2(ad.dimension(), all());
-                slice1[saxis] = range(1, xnone());
+    /**
+     * @ingroup red_functions
+     * @brief Integrate along the given axis using the composite trapezoidal rule.
+     *
+     * Returns definite integral as approximated by trapezoidal rule. This function is not lazy (might change in the future).
+     * The sums of the lanes along the axis are accumulated in a single pass, in blocks of adjacent lanes split among
+     * the threads of the policy.
+     * @param y an \ref xexpression
+     * @param dx the spacing between sample points
+     * @param axis the axis along which to integrate.
+     * @param policy the execution policy splitting the lanes
+     * @return an xarray
+     */
+    template <class T, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    auto trapz(const xexpression<T>& y, double dx, std::ptrdiff_t axis, const P& policy)
+    {
+        using value_type = typename T::value_type;
+        const auto& yd = y.derived_cast();
+        std::size_t saxis = normalize_axis(yd.dimension(), axis);
 
-                detail::diff_impl<typename T::value_type> impl;
-                impl(ad, n, slice1, slice2, saxis);
-            }
-        }
-        else
-        {
-            auto shape = ad.shape();
-            shape[saxis] = std::size_t(0);
-            ad.resize(shape);
-        }
-        return ad;
+        xarray<value_type, layout_type::row_major> y_storage;
+        const value_type* yp = detail::row_major_data(yd, y_storage);
+        return detail::trapz_impl<0>(yp, yp, yd.shape(), saxis, dx * 0.5, policy);
     }
 
     /**
@@ -2813,17 +3899,7 @@ namespace detail {
     template <class T>
     auto trapz(const xexpression<T>& y, double dx = 1.0, std::ptrdiff_t axis = -1)
     {
-        auto& yd = y.derived_cast();
-        std::size_t saxis = normalize_axis(yd.dimension(), axis);
-
-        xstrided_slice_vector slice1(yd.dimension(), all());
-        xstrided_slice_vector slice2(yd.dimension(), all());
-        slice1[saxis] = range(1, xnone());
-        slice2[saxis] = range(xnone(), yd.shape()[saxis] - 1);
-
-        auto trap = dx * (strided_view(yd, slice1) + strided_view(yd, slice2)) * 0.5;
-
-        return eval(sum(trap, {saxis}));
+        return trapz(y, dx, axis, exec::default_policy());
     }
 
     /**
@@ -2832,48 +3908,201 @@ namespace detail {
      *
      * Returns definite integral as approximated by trapezoidal rule. This function is not lazy (might change in the future).
      * @param y an \ref xexpression
-     * @param x an \ref xexpression representing the sample points corresponding to the y values.
+     * @param x an \ref xexpression representing the sample points corresponding to the y values, either along the
+     * axis or broadcast to the shape of y.
      * @param axis the axis along which to integrate.
+     * @param policy the execution policy splitting the lanes
      * @return an xarray
      */
-    template <class T, class E>
-    auto trapz(const xexpression<T>& y, const xexpression<E>& x, std::ptrdiff_t axis = -1)
+    template <class T, class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    auto trapz(const xexpression<T>& y, const xexpression<E>& x, std::ptrdiff_t axis, const P& policy)
     {
-        auto& yd = y.derived_cast();
-        auto& xd = x.derived_cast();
-        decltype(diff(x)) dx;
-
+        using value_type = typename T::value_type;
+        using x_value_type = typename E::value_type;
+        const auto& yd = y.derived_cast();
+        const auto& xd = x.derived_cast();
         std::size_t saxis = normalize_axis(yd.dimension(), axis);
 
+        xarray<value_type, layout_type::row_major> y_storage;
+        const value_type* yp = detail::row_major_data(yd, y_storage);
+        xarray<x_value_type, layout_type::row_major> x_storage;
         if (xd.dimension() == 1)
         {
-            dx = diff(x);
-            typename std::decay_t<decltype(yd)>::shape_type shape;
-            resize_container(shape, yd.dimension());
-            std::fill(shape.begin(), shape.end(), 1);
-            shape[saxis] = dx.shape()[0];
-            dx.reshape(shape);
+            if (xd.size() != yd.shape()[saxis])
+            {
+                XTENSOR_THROW(std::runtime_error, "trapz: the sample points must have the length of the axis");
+            }
+            const x_value_type* xp = detail::row_major_data(xd, x_storage);
+            return detail::trapz_impl<1>(yp, xp, yd.shape(), saxis, 0.5, policy);
         }
-        else
+        x_storage = broadcast(xd, yd.shape());
+        return detail::trapz_impl<2>(yp, x_storage.data(), yd.shape(), saxis, 0.5, policy);
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Integrate along the given axis using the composite trapezoidal rule, on the calling thread.
+     *
+     * @param y an \ref xexpression
+     * @param x an \ref xexpression representing the sample points corresponding to the y values.
+     * @param axis the axis along which to integrate.
+     * @return an xarray
+     */
+    template <class T, class E>
+    auto trapz(const xexpression<T>& y, const xexpression<E>& x, std::ptrdiff_t axis = -1)
+    {
+        return trapz(y, x, axis, exec::default_policy());
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Estimate the gradient along the given axis.
+     *
+     * Returns the central differences (f[i + 1] - f[i - 1]) / (2 * dx) of the interior points and the one-sided
+     * differences at the boundaries, as numpy.gradient with edge_order=1. The result has the shape of \c e and
+     * holds doubles when \c e holds integers. This function is not lazy.
+     * @param e an \ref xexpression
+     * @param dx the spacing between sample points
+     * @param axis the axis along which the gradient is taken
+     * @param policy the execution policy splitting the tiles
+     * @return an xarray
+     */
+    template <class T, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    auto gradient(const xexpression<T>& e, double dx, std::ptrdiff_t axis, const P& policy)
+    {
+        using value_type = typename T::value_type;
+        using result_type = detail::axis_integral_type<value_type>;
+        using array_type = xarray<result_type, layout_type::row_major>;
+
+        const auto& de = e.derived_cast();
+        std::size_t saxis = normalize_axis(de.dimension(), axis);
+        const detail::axis_lanes l = detail::make_axis_lanes(de.shape(), saxis);
+        if (l.length < 2)
         {
-            dx = diff(x, 1, axis);
+            XTENSOR_THROW(std::runtime_error, "gradient: the axis must have at least two elements");
         }
 
-        xstrided_slice_vector slice1(yd.dimension(), all());
-        xstrided_slice_vector slice2(yd.dimension(), all());
-        slice1[saxis] = range(1, xnone());
-        slice2[saxis] = range(xnone(), yd.shape()[saxis] - 1);
+        xarray<value_type, layout_type::row_major> storage;
+        const value_type* src = detail::row_major_data(de, storage);
+        array_type res = array_type::from_shape(de.shape());
+        result_type* dst = res.data();
+        const result_type h = static_cast<result_type>(dx);
+        const result_type h2 = static_cast<result_type>(2. * dx);
 
-        auto trap = dx * (strided_view(yd, slice1) + strided_view(yd, slice2)) * 0.5;
+        const std::size_t tile = (std::max)(std::size_t(1), detail::axis_tile_elements / (std::min)(l.inner, detail::axis_lane_block));
+        detail::for_each_axis_tile(l, l.length, tile, policy,
+            [&](std::size_t o, std::size_t lane, std::size_t nlanes, std::size_t first, std::size_t last)
+        {
+            const value_type* in = src + o * l.length * l.inner + lane;
+            result_type* out = dst + o * l.length * l.inner + lane;
+            for (std::size_t t = first; t < last; ++t)
+            {
+                const std::size_t prev = t == 0 ? 0 : t - 1;
+                const std::size_t next = t + 1 == l.length ? t : t + 1;
+                const result_type div = next - prev == 2 ? h2 : h;
+                const value_type* p = in + prev * l.inner;
+                const value_type* q = in + next * l.inner;
+                result_type* r = out + t * l.inner;
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    r[j] = (static_cast<result_type>(q[j]) - static_cast<result_type>(p[j])) / div;
+                }
+            }
+        });
+        return res;
+    }
 
-        return eval(sum(trap, {saxis}));
+    /**
+     * @ingroup red_functions
+     * @brief Estimate the gradient along the given axis, on the calling thread.
+     *
+     * @param e an \ref xexpression
+     * @param dx the spacing between sample points (optional)
+     * @param axis the axis along which the gradient is taken, default is the last axis.
+     * @return an xarray
+     */
+    template <class T>
+    auto gradient(const xexpression<T>& e, double dx = 1.0, std::ptrdiff_t axis = -1)
+    {
+        return gradient(e, dx, axis, exec::default_policy());
+    }
+
+    namespace detail
+    {
+        // Number of queries whose intervals are found before they are
+        // interpolated together
+        constexpr std::size_t interp_block_size = 256;
+
+        // Stores in pos the lower bounds of the sorted queries [q, q + m)
+        // in [a, a + n). The queries are merged with the part of a they
+        // span, or searched from the previous bound when that part is much
+        // longer than [q, q + m).
+        template <class T, class V>
+        inline void merge_search(const T* a, std::size_t n, const V* q, std::size_t m, std::size_t* pos)
+        {
+            if (m == 0)
+            {
+                return;
+            }
+            std::size_t p = static_cast<std::size_t>(std::lower_bound(a, a + n, q[0]) - a);
+            std::size_t last = static_cast<std::size_t>(std::lower_bound(a + p, a + n, q[m - 1]) - a);
+            bool gallop = last - p > 8 * m;
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                if (gallop)
+                {
+                    p = static_cast<std::size_t>(std::lower_bound(a + p, a + last, q[i]) - a);
+                }
+                else
+                {
+                    while (p < n && a[p] < q[i])
+                    {
+                        ++p;
+                    }
+                }
+                pos[i] = p;
+            }
+        }
+
+        // Interpolates the m queries x whose lower bounds in xp are pos. The
+        // interval is clamped and the out of range queries are selected
+        // afterwards, which keeps the loop free of branches.
+        template <class R, class T, class F, class V>
+        inline void interp_block(const T* xp, const F* fp, std::size_t n, const V* x, const std::size_t* pos,
+                                 std::size_t m, R* out, R left, R right)
+        {
+            if (n < 2)
+            {
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    out[i] = !(x[i] > xp[0]) ? left : right;
+                }
+                return;
+            }
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                // xp[ip - 1] < x <= xp[ip]
+                std::size_t ip = (std::min)((std::max)(pos[i], std::size_t(1)), n - 1);
+                double dfp = static_cast<double>(fp[ip] - fp[ip - 1]);
+                double dxp = static_cast<double>(xp[ip] - xp[ip - 1]);
+                double dx  = static_cast<double>(x[i] - xp[ip - 1]);
+                R inner = fp[ip - 1] + static_cast<R>(dfp / dxp * dx);
+                R outer = !(x[i] > xp[0]) ? left : right;
+                out[i] = (x[i] > xp[0] && x[i] < xp[n - 1]) ? inner : outer;
+            }
+        }
     }
 
     /**
      * @ingroup basic_functions
      * @brief Returns the one-dimensional piecewise linear interpolant to a function with given discrete data points (xp, fp), evaluated at x.
      *
-     * @param x The x-coordinates at which to evaluate the interpolated values (sorted).
+     * When x is sorted, its intervals in xp are found by merging both
+     * arrays; otherwise each x-coordinate is searched with a batched
+     * branchless binary search. Large inputs are split over the threads
+     * of the default execution policy.
+     *
+     * @param x The x-coordinates at which to evaluate the interpolated values.
      * @param xp The x-coordinates of the data points (sorted).
      * @param fp The y-coordinates of the data points, same length as xp.
      * @param left Value to return for x < xp[0].
@@ -2883,72 +4112,47 @@ namespace detail {
     template<class E1, class E2, class E3, typename T>
     inline auto interp(const E1 &x, const E2 &xp, const E3 &fp, T left, T right)
     {
-        using size_type = common_size_type_t<E1, E2, E3>;
         using value_type = typename E3::value_type;
 
         // basic checks
         XTENSOR_ASSERT(xp.dimension() == 1);
-        XTENSOR_ASSERT(std::is_sorted(x.cbegin(), x.cend()));
         XTENSOR_ASSERT(std::is_sorted(xp.cbegin(), xp.cend()));
 
         // allocate output
         auto f = xtensor<value_type, 1>::from_shape(x.shape());
-
-        // counter in "x": from left
-        size_type i = 0;
-
-        // fill f[i] for x[i] <= xp[0]
-        for (; i < x.size() ; ++i)
-        {
-            if (x[i] > xp[0])
-            {
-                break;
-            }
-            f[i] = static_cast<value_type>(left);
-        }
-
-        // counter in "x": from right
-        // (index counts one right, to terminate the reverse loop, without risking being negative)
-        size_type imax = x.size();
-
-        // fill f[i] for x[-1] >= xp[-1]
-        for (; imax > 0 ; --imax)
-        {
-            if (x[imax-1] < xp[xp.size() - 1])
-            {
-                break;
-            }
-            f[imax-1] = static_cast<value_type>(right);
-        }
-
-        // catch edge case: all entries are "right"
-        if (imax == 0)
-        {
-            return f;
-        }
-
-        // set "imax" as actual index
-        // (counted one right, see above)
-        --imax;
-
-        // counter in "xp"
-        size_type ip = 1;
-
-        // fill f[i] for the interior
-        for (; i <= imax ; ++i)
-        {
-            // - search next value in "xp"
-            while (x[i] > xp[ip])
-            {
-                ++ip;
-            }
-            // - distances as doubles
-            double dfp = static_cast<double>(fp[ip] - fp[ip - 1]);
-            double dxp = static_cast<double>(xp[ip] - xp[ip - 1]);
-            double dx  = static_cast<double>(x[i] - xp[ip - 1]);
-            // - interpolate
-            f[i] = fp[ip - 1] + static_cast<value_type>(dfp / dxp * dx);
-        }
+        value_type* out = f.data();
+        value_type vleft = static_cast<value_type>(left);
+        value_type vright = static_cast<value_type>(right);
+
+        detail::apply_on_contiguous(xp, [&](const auto* pxp, std::size_t n) {
+            detail::apply_on_contiguous(fp, [&](const auto* pfp, std::size_t) {
+                detail::apply_on_contiguous(x, [&](const auto* px, std::size_t m) {
+                    bool sorted = std::is_sorted(px, px + m);
+                    auto interp_range = [&](std::size_t begin, std::size_t end)
+                    {
+                        std::array<std::size_t, detail::interp_block_size> pos;
+                        for (std::size_t b = begin; b < end; b += detail::interp_block_size)
+                        {
+                            std::size_t bm = (std::min)(detail::interp_block_size, end - b);
+                            if (sorted)
+                            {
+                                detail::merge_search(pxp, n, px + b, bm, pos.data());
+                            }
+                            else
+                            {
+                                for (std::size_t k = 0; k < bm; k += detail::search_batch)
+                                {
+                                    detail::batch_search<false>(pxp, n, px + b + k, (std::min)(detail::search_batch, bm - k),
+                                                                pos.data() + k);
+                                }
+                            }
+                            detail::interp_block(pxp, pfp, n, px + b, pos.data(), bm, out + b, vleft, vright);
+                        }
+                    };
+                    exec::default_policy().for_range(std::size_t(0), m, detail::interp_block_size, interp_range);
+                });
+            });
+        });
 
         return f;
     }
@@ -2957,7 +4161,7 @@ namespace detail {
      * @ingroup basic_functions
      * @brief Returns the one-dimensional piecewise linear interpolant to a function with given discrete data points (xp, fp), evaluated at x.
      *
-     * @param x The x-coordinates at which to evaluate the interpolated values (sorted).
+     * @param x The x-coordinates at which to evaluate the interpolated values.
      * @param xp The x-coordinates of the data points (sorted).
      * @param fp The y-coordinates of the data points, same length as xp.
      * @return an one-dimensional xarray, same length as x.
@@ -3018,55 +4222,371 @@ namespace detail {
 
     /*
     * convolution mode placeholders for selecting the algorithm
-    * used in computing a 1D convolution.
+    * used in computing a convolution.
     * Same as NumPy's mode parameter.
     */
     namespace convolve_mode
     {
         struct valid{};
+        struct same{};
         struct full{};
     }
 
-    namespace detail {
-        template <class E1, class E2>
-        inline auto convolve_impl(E1&& e1, E2&& e2, convolve_mode::valid)
+    namespace detail
+    {
+        /*****************************
+         * direct convolution kernel *
+         *****************************/
+
+        // Adds sum(a[i + k] * rv[k], k < nv) to res[i] for i < nres, rv
+        // being the reversed kernel. Blocks of consecutive outputs are
+        // accumulated in registers, so that each kernel value is loaded
+        // once per block.
+        template <class T>
+        inline void convolve_direct(const T* a, const T* rv, std::size_t nv, T* res, std::size_t nres, std::false_type)
         {
-            using value_type = typename std::decay<E1>::type::value_type;
+            constexpr std::size_t block = 8;
+            std::size_t i = 0;
+            for (; i + block <= nres; i += block)
+            {
+                std::array<T, block> acc;
+                std::copy(res + i, res + i + block, acc.begin());
+                for (std::size_t k = 0; k < nv; ++k)
+                {
+                    const T w = rv[k];
+                    const T* p = a + i + k;
+                    for (std::size_t b = 0; b < block; ++b)
+                    {
+                        acc[b] += p[b] * w;
+                    }
+                }
+                std::copy(acc.cbegin(), acc.cend(), res + i);
+            }
+            for (; i < nres; ++i)
+            {
+                T acc = res[i];
+                for (std::size_t k = 0; k < nv; ++k)
+                {
+                    acc += a[i + k] * rv[k];
+                }
+                res[i] = acc;
+            }
+        }
 
-            std::size_t const na = e1.size();
-            std::size_t const nv = e2.size();
-            std::size_t const n = na - nv + 1;
-            xt::xtensor<value_type, 1> out = xt::zeros<value_type>({ n });
-            for (std::size_t i = 0; i < n; i++)
+#if defined(XTENSOR_USE_XSIMD)
+        template <class T>
+        inline void convolve_direct(const T* a, const T* rv, std::size_t nv, T* res, std::size_t nres, std::true_type)
+        {
+            using batch_type = xt_simd::simd_type<T>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            constexpr std::size_t n_acc = 4;
+            constexpr std::size_t step = n_acc * simd_size;
+
+            std::size_t i = 0;
+            for (; i + step <= nres; i += step)
             {
-                for (std::size_t j = 0; j < nv; j++)
+                batch_type acc[n_acc];
+                for (std::size_t j = 0; j < n_acc; ++j)
                 {
-                    out(i) += e1(j) * e2(j + i);
+                    acc[j] = xt_simd::load_as<T>(res + i + j * simd_size, unaligned_mode());
+                }
+                for (std::size_t k = 0; k < nv; ++k)
+                {
+                    const batch_type w(rv[k]);
+                    const T* p = a + i + k;
+                    for (std::size_t j = 0; j < n_acc; ++j)
+                    {
+                        acc[j] += xt_simd::load_as<T>(p + j * simd_size, unaligned_mode()) * w;
+                    }
+                }
+                for (std::size_t j = 0; j < n_acc; ++j)
+                {
+                    xt_simd::store_as(res + i + j * simd_size, acc[j], unaligned_mode());
                 }
             }
-            return out;
+            convolve_direct(a + i, rv, nv, res + i, nres - i, std::false_type());
         }
+#endif
 
-        template <class E1, class E2>
-        inline auto convolve_impl(E1&& e1, E2&& e2, convolve_mode::full)
+        template <class T>
+        inline void convolve_direct(const T* a, const T* rv, std::size_t nv, T* res, std::size_t nres)
         {
-            using value_type = typename std::decay<E1>::type::value_type;
+#if defined(XTENSOR_USE_XSIMD)
+            using use_simd = std::integral_constant<bool, std::is_arithmetic<T>::value && (xt_simd::simd_traits<T>::size > 1)>;
+#else
+            using use_simd = std::false_type;
+#endif
+            convolve_direct(a, rv, nv, res, nres, use_simd());
+        }
+
+        /**************************
+         * FFT convolution kernel *
+         **************************/
 
-            std::size_t const na = e1.size();
-            std::size_t const nv = e2.size();
-            std::size_t const n = na + nv - 1;
-            xt::xtensor<value_type, 1> out = xt::zeros<value_type>({ n });
-            for (std::size_t i = 0; i < n; i++)
+        // In-place iterative radix-2 FFT of a fixed power of two size
+        template <class R>
+        class convolve_fft_plan
+        {
+        public:
+
+            using complex_type = std::complex<R>;
+
+            explicit convolve_fft_plan(std::size_t size);
+
+            void forward(complex_type* data) const;
+            void inverse(complex_type* data) const;
+
+        private:
+
+            template <bool Inverse>
+            void run(complex_type* data) const;
+
+            std::size_t m_size;
+            std::vector<std::size_t> m_reversed;
+            std::vector<complex_type> m_twiddles;
+        };
+
+        template <class R>
+        inline convolve_fft_plan<R>::convolve_fft_plan(std::size_t size)
+            : m_size(size), m_reversed(size), m_twiddles(size / 2)
+        {
+            std::size_t bits = 0;
+            while ((std::size_t(1) << bits) < size)
             {
-                std::size_t const jmn = (i >= nv - 1) ? i - (nv - 1) : 0;
-                std::size_t const jmx = (i < na - 1) ? i : na - 1;
-                for (std::size_t j = jmn; j <= jmx; ++j)
+                ++bits;
+            }
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::size_t r = 0;
+                for (std::size_t b = 0; b < bits; ++b)
+                {
+                    r |= ((i >> b) & 1u) << (bits - 1 - b);
+                }
+                m_reversed[i] = r;
+            }
+            const double pi = 3.141592653589793238462643383279502884;
+            for (std::size_t k = 0; k < size / 2; ++k)
+            {
+                double angle = -2. * pi * static_cast<double>(k) / static_cast<double>(size);
+                m_twiddles[k] = complex_type(static_cast<R>(std::cos(angle)), static_cast<R>(std::sin(angle)));
+            }
+        }
+
+        template <class R>
+        inline void convolve_fft_plan<R>::forward(complex_type* data) const
+        {
+            run<false>(data);
+        }
+
+        // The result is not divided by the size of the plan
+        template <class R>
+        inline void convolve_fft_plan<R>::inverse(complex_type* data) const
+        {
+            run<true>(data);
+        }
+
+        template <class R>
+        template <bool Inverse>
+        inline void convolve_fft_plan<R>::run(complex_type* data) const
+        {
+            for (std::size_t i = 0; i < m_size; ++i)
+            {
+                if (i < m_reversed[i])
                 {
-                    out(i) += e1(j) * e2(i - j);
+                    std::swap(data[i], data[m_reversed[i]]);
                 }
             }
+            for (std::size_t len = 2; len <= m_size; len <<= 1)
+            {
+                std::size_t half = len / 2;
+                std::size_t stride = m_size / len;
+                for (std::size_t first = 0; first < m_size; first += len)
+                {
+                    for (std::size_t j = 0; j < half; ++j)
+                    {
+                        complex_type w = m_twiddles[j * stride];
+                        if (Inverse)
+                        {
+                            w = std::conj(w);
+                        }
+                        complex_type t = w * data[first + j + half];
+                        complex_type u = data[first + j];
+                        data[first + j] = u + t;
+                        data[first + j + half] = u - t;
+                    }
+                }
+            }
+        }
+
+        // Returns the FFT size minimizing the cost per output of the
+        // overlap-add convolution of a signal of length na with a kernel
+        // of length nv.
+        inline std::size_t convolve_fft_size(std::size_t na, std::size_t nv)
+        {
+            std::size_t log_size = 1;
+            while ((std::size_t(1) << log_size) < 2 * nv)
+            {
+                ++log_size;
+            }
+            std::size_t best = std::size_t(1) << log_size;
+            double best_cost = (std::numeric_limits<double>::max)();
+            for (std::size_t size = best; ; size <<= 1, ++log_size)
+            {
+                double cost = static_cast<double>(size * log_size) / static_cast<double>(size - nv + 1);
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best = size;
+                }
+                if (size >= na + nv - 1)
+                {
+                    break;
+                }
+            }
+            return best;
+        }
+
+        // Overlap-add full convolution of a (length na) with v (length nv).
+        // The kernel being real, two consecutive blocks of the signal are
+        // transformed at once as the real and imaginary parts of a single
+        // complex block.
+        template <class T>
+        inline void convolve_fft(const T* a, std::size_t na, const T* v, std::size_t nv, T* res)
+        {
+            using complex_type = std::complex<T>;
+            const std::size_t size = convolve_fft_size(na, nv);
+            const std::size_t step = size - nv + 1;
+            convolve_fft_plan<T> plan(size);
+
+            std::vector<complex_type> kernel(size, complex_type(0));
+            const T scale = T(1) / static_cast<T>(size);
+            for (std::size_t i = 0; i < nv; ++i)
+            {
+                kernel[i] = complex_type(v[i] * scale, T(0));
+            }
+            plan.forward(kernel.data());
+
+            std::fill(res, res + na + nv - 1, T(0));
+            std::vector<complex_type> buffer(size);
+            for (std::size_t first = 0; first < na; first += 2 * step)
+            {
+                std::size_t n0 = (std::min)(step, na - first);
+                std::size_t n1 = first + step < na ? (std::min)(step, na - first - step) : 0;
+                std::fill(buffer.begin(), buffer.end(), complex_type(0));
+                for (std::size_t i = 0; i < n0; ++i)
+                {
+                    buffer[i].real(a[first + i]);
+                }
+                for (std::size_t i = 0; i < n1; ++i)
+                {
+                    buffer[i].imag(a[first + step + i]);
+                }
+                plan.forward(buffer.data());
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    buffer[i] *= kernel[i];
+                }
+                plan.inverse(buffer.data());
+                for (std::size_t i = 0; i < n0 + nv - 1; ++i)
+                {
+                    res[first + i] += buffer[i].real();
+                }
+                for (std::size_t i = 0; n1 != 0 && i < n1 + nv - 1; ++i)
+                {
+                    res[first + step + i] += buffer[i].imag();
+                }
+            }
+        }
+
+        /***********************
+         * convolve dispatcher *
+         ***********************/
+
+        template <class T>
+        inline void convolve_full(const T* a, std::size_t na, const T* v, std::size_t nv, T* res, std::false_type)
+        {
+            std::vector<T> padded(na + 2 * (nv - 1), T(0));
+            std::copy(a, a + na, padded.begin() + static_cast<std::ptrdiff_t>(nv - 1));
+            std::vector<T> rv(v, v + nv);
+            std::reverse(rv.begin(), rv.end());
+            convolve_direct(padded.data(), rv.data(), nv, res, na + nv - 1);
+        }
+
+        template <class T>
+        inline void convolve_full(const T* a, std::size_t na, const T* v, std::size_t nv, T* res, std::true_type)
+        {
+            if (nv >= XTENSOR_CONVOLVE_FFT_THRESHOLD)
+            {
+                convolve_fft(a, na, v, nv, res);
+            }
+            else
+            {
+                convolve_full(a, na, v, nv, res, std::false_type());
+            }
+        }
+
+        template <class T>
+        inline void convolve_valid(const T* a, std::size_t na, const T* v, std::size_t nv, T* res, std::false_type)
+        {
+            std::vector<T> rv(v, v + nv);
+            std::reverse(rv.begin(), rv.end());
+            convolve_direct(a, rv.data(), nv, res, na - nv + 1);
+        }
+
+        template <class T>
+        inline void convolve_valid(const T* a, std::size_t na, const T* v, std::size_t nv, T* res, std::true_type)
+        {
+            if (nv >= XTENSOR_CONVOLVE_FFT_THRESHOLD)
+            {
+                std::vector<T> full(na + nv - 1);
+                convolve_fft(a, na, v, nv, full.data());
+                std::copy(full.cbegin() + static_cast<std::ptrdiff_t>(nv - 1), full.cbegin() + static_cast<std::ptrdiff_t>(na), res);
+            }
+            else
+            {
+                convolve_valid(a, na, v, nv, res, std::false_type());
+            }
+        }
+
+        template <class T, class F>
+        inline xtensor<T, 1> convolve_impl(const T* a, std::size_t na, const T* v, std::size_t nv, convolve_mode::full, F use_fft)
+        {
+            xtensor<T, 1> out = zeros<T>({na + nv - 1});
+            convolve_full(a, na, v, nv, out.data(), use_fft);
+            return out;
+        }
+
+        template <class T, class F>
+        inline xtensor<T, 1> convolve_impl(const T* a, std::size_t na, const T* v, std::size_t nv, convolve_mode::same, F use_fft)
+        {
+            xtensor<T, 1> full = convolve_impl(a, na, v, nv, convolve_mode::full(), use_fft);
+            xtensor<T, 1> out = xtensor<T, 1>::from_shape({na});
+            std::copy(full.cbegin() + static_cast<std::ptrdiff_t>((nv - 1) / 2),
+                      full.cbegin() + static_cast<std::ptrdiff_t>((nv - 1) / 2 + na),
+                      out.begin());
             return out;
         }
+
+        template <class T, class F>
+        inline xtensor<T, 1> convolve_impl(const T* a, std::size_t na, const T* v, std::size_t nv, convolve_mode::valid, F use_fft)
+        {
+            xtensor<T, 1> out = zeros<T>({na - nv + 1});
+            convolve_valid(a, na, v, nv, out.data(), use_fft);
+            return out;
+        }
+
+        template <class E1, class E2, class M>
+        inline auto convolve_impl(E1&& e1, E2&& e2, M mode)
+        {
+            using value_type = typename std::decay<E1>::type::value_type;
+            using use_fft = std::is_floating_point<value_type>;
+
+            const xtensor<value_type, 1> a = std::forward<E1>(e1);
+            const xtensor<value_type, 1> v = std::forward<E2>(e2);
+            std::size_t const na = a.size();
+            std::size_t const nv = v.size();
+            return convolve_impl(a.data(), na, v.data(), nv, mode, use_fft());
+        }
     }
 
     /*
@@ -3076,8 +4596,11 @@ namespace detail {
     * @param v 1D expression
     * @param mode placeholder Select algorithm #convolve_mode
     *
-    * @detail the algorithm convolves a with v and will incur a copy overhead
-    *   should v be longer than a.
+    * @detail the operands are copied into contiguous buffers. When the
+    *   shorter one has at least XTENSOR_CONVOLVE_FFT_THRESHOLD elements
+    *   and their value type is a floating point type, the convolution is
+    *   computed with FFTs (overlap-add); otherwise it is computed directly,
+    *   with SIMD instructions when they are enabled.
     */
     template <class E1, class E2, class E3>
     inline auto convolve(E1&& a, E2&& v, E3 mode)
@@ -3100,6 +4623,84 @@ namespace detail {
             return detail::convolve_impl(std::forward<E1>(a), std::forward<E2>(v), mode);
         }
     }
+
+    /**
+     * @defgroup inplace_functions In-place functions
+     *
+     * The in-place functions overwrite the elements of an expression with the
+     * result of the corresponding element-wise function, e.g. <tt>exp_inplace(a)</tt>
+     * is equivalent to <tt>noalias(a) = exp(a)</tt>. They never allocate: the
+     * expression is assigned to itself without temporary, element by element,
+     * through the SIMD linear assignment when the expression is contiguous.
+     * The argument must be an assignable expression, i.e. a container or a view.
+     */
+
+#define XTENSOR_INPLACE_FUNCTION(NAME)                                          \
+    template <class E>                                                          \
+    inline auto NAME##_inplace(E&& e)                                           \
+        -> std::enable_if_t<is_xexpression<std::decay_t<E>>::value, E&&>        \
+    {                                                                           \
+        noalias(e) = NAME(e);                                                   \
+        return std::forward<E>(e);                                              \
+    }
+
+    /**
+     * @ingroup inplace_functions
+     * @brief In-place element-wise functions.
+     *
+     * Replace each element of \em e with the result of the function of the
+     * same name without the ``_inplace`` suffix, and return \em e.
+     * @param e an assignable \ref xexpression
+     */
+    XTENSOR_INPLACE_FUNCTION(abs)
+    XTENSOR_INPLACE_FUNCTION(fabs)
+    XTENSOR_INPLACE_FUNCTION(sign)
+    XTENSOR_INPLACE_FUNCTION(exp)
+    XTENSOR_INPLACE_FUNCTION(exp2)
+    XTENSOR_INPLACE_FUNCTION(expm1)
+    XTENSOR_INPLACE_FUNCTION(log)
+    XTENSOR_INPLACE_FUNCTION(log2)
+    XTENSOR_INPLACE_FUNCTION(log10)
+    XTENSOR_INPLACE_FUNCTION(log1p)
+    XTENSOR_INPLACE_FUNCTION(sqrt)
+    XTENSOR_INPLACE_FUNCTION(cbrt)
+    XTENSOR_INPLACE_FUNCTION(sin)
+    XTENSOR_INPLACE_FUNCTION(cos)
+    XTENSOR_INPLACE_FUNCTION(tan)
+    XTENSOR_INPLACE_FUNCTION(asin)
+    XTENSOR_INPLACE_FUNCTION(acos)
+    XTENSOR_INPLACE_FUNCTION(atan)
+    XTENSOR_INPLACE_FUNCTION(sinh)
+    XTENSOR_INPLACE_FUNCTION(cosh)
+    XTENSOR_INPLACE_FUNCTION(tanh)
+    XTENSOR_INPLACE_FUNCTION(erf)
+    XTENSOR_INPLACE_FUNCTION(erfc)
+    XTENSOR_INPLACE_FUNCTION(ceil)
+    XTENSOR_INPLACE_FUNCTION(floor)
+    XTENSOR_INPLACE_FUNCTION(trunc)
+    XTENSOR_INPLACE_FUNCTION(round)
+    XTENSOR_INPLACE_FUNCTION(rint)
+    XTENSOR_INPLACE_FUNCTION(nan_to_num)
+
+#undef XTENSOR_INPLACE_FUNCTION
+
+    /**
+     * @ingroup inplace_functions
+     * @brief Clips the values of an expression in place.
+     *
+     * Equivalent to <tt>noalias(e) = clip(e, lo, hi)</tt>.
+     * @param e an assignable \ref xexpression
+     * @param lo a scalar
+     * @param hi a scalar
+     * @return \em e
+     */
+    template <class E, class E2, class E3>
+    inline auto clip_inplace(E&& e, const E2& lo, const E3& hi)
+        -> std::enable_if_t<is_xexpression<std::decay_t<E>>::value, E&&>
+    {
+        noalias(e) = clip(e, lo, hi);
+        return std::forward<E>(e);
+    }
 }
 
 
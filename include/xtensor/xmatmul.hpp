@@ -0,0 +1,847 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_MATMUL_HPP
+#define XTENSOR_MATMUL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xmath.hpp"
+#include "xstorage.hpp"
+#include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /********
+     * gemm *
+     ********/
+
+    namespace detail
+    {
+        // Blocking of the matrix product: C is computed by tiles of mr x nr
+        // elements held in registers, from panels of A and B packed so that
+        // the micro-kernel reads them contiguously. A block of mc x kc
+        // elements of A stays in L2 while the kc x nc panel of B is shared
+        // by all the blocks of rows.
+        template <class T>
+        struct gemm_traits
+        {
+            using batch_type = std::conditional_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                                                  xt_simd::simd_type<T>,
+                                                  T>;
+            using use_simd = std::integral_constant<bool, !std::is_same<batch_type, T>::value>;
+
+            static constexpr std::size_t simd_size = use_simd::value ? xt_simd::simd_traits<T>::size : 1;
+            static constexpr std::size_t mr = use_simd::value ? 6 : 4;
+            static constexpr std::size_t nb = use_simd::value ? 2 : 4;
+            static constexpr std::size_t nr = nb * simd_size;
+            static constexpr std::size_t kc = XTENSOR_GEMM_KC;
+            static constexpr std::size_t mc = (XTENSOR_GEMM_MC + mr - 1) / mr * mr;
+            static constexpr std::size_t nc = (XTENSOR_GEMM_NC + nr - 1) / nr * nr;
+        };
+
+        template <class B, class T>
+        inline B gemm_load(const T* src, std::false_type /*use_simd*/)
+        {
+            return *src;
+        }
+
+        template <class T, class B>
+        inline void gemm_store(T* dst, const B& value, std::false_type /*use_simd*/)
+        {
+            *dst = value;
+        }
+
+        template <class B>
+        inline B gemm_madd(const B& a, const B& b, const B& c, std::false_type /*use_simd*/)
+        {
+            return c + a * b;
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class B, class T>
+        inline B gemm_load(const T* src, std::true_type /*use_simd*/)
+        {
+            return xt_simd::load_as<T>(src, unaligned_mode());
+        }
+
+        template <class T, class B>
+        inline void gemm_store(T* dst, const B& value, std::true_type /*use_simd*/)
+        {
+            xt_simd::store_as(dst, value, unaligned_mode());
+        }
+
+        template <class B>
+        inline B gemm_madd(const B& a, const B& b, const B& c, std::true_type /*use_simd*/)
+        {
+            return xsimd::fma(a, b, c);
+        }
+#endif
+
+        // Packs the block of A made of the rows [i0, i0 + m) and of the
+        // columns [p0, p0 + k) into micro-panels of mr rows, stored column
+        // after column. Rows past the end of A are zero-padded.
+        template <class T, class TA>
+        inline void gemm_pack_a(const TA* a, const std::ptrdiff_t* rows, const std::ptrdiff_t* cols,
+                                std::size_t i0, std::size_t m, std::size_t p0, std::size_t k, T* out)
+        {
+            constexpr std::size_t mr = gemm_traits<T>::mr;
+            for (std::size_t ir = 0; ir < m; ir += mr)
+            {
+                std::size_t rm = (std::min)(mr, m - ir);
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    const TA* col = a + cols[p0 + p];
+                    for (std::size_t i = 0; i < rm; ++i)
+                    {
+                        out[i] = static_cast<T>(col[rows[i0 + ir + i]]);
+                    }
+                    for (std::size_t i = rm; i < mr; ++i)
+                    {
+                        out[i] = T(0);
+                    }
+                    out += mr;
+                }
+            }
+        }
+
+        // Packs the block of B made of the rows [p0, p0 + k) and of the
+        // columns [j0, j0 + n) into micro-panels of nr columns, stored row
+        // after row. Columns past the end of B are zero-padded.
+        template <class T, class TB>
+        inline void gemm_pack_b(const TB* b, const std::ptrdiff_t* rows, const std::ptrdiff_t* cols,
+                                std::size_t p0, std::size_t k, std::size_t j0, std::size_t n, T* out)
+        {
+            constexpr std::size_t nr = gemm_traits<T>::nr;
+            for (std::size_t jr = 0; jr < n; jr += nr)
+            {
+                std::size_t rn = (std::min)(nr, n - jr);
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    const TB* row = b + rows[p0 + p];
+                    for (std::size_t j = 0; j < rn; ++j)
+                    {
+                        out[j] = static_cast<T>(row[cols[j0 + jr + j]]);
+                    }
+                    for (std::size_t j = rn; j < nr; ++j)
+                    {
+                        out[j] = T(0);
+                    }
+                    out += nr;
+                }
+            }
+        }
+
+        // Computes the mr x nr tile of the product of a packed micro-panel
+        // of A by a packed micro-panel of B, and stores or adds its m x n
+        // top-left part into c, whose rows are ldc elements apart.
+        template <class T>
+        inline void gemm_micro_kernel(std::size_t k, const T* a, const T* b, T* c, std::size_t ldc,
+                                      std::size_t m, std::size_t n, bool accumulate)
+        {
+            using traits = gemm_traits<T>;
+            using batch_type = typename traits::batch_type;
+            using use_simd = typename traits::use_simd;
+            constexpr std::size_t mr = traits::mr;
+            constexpr std::size_t nb = traits::nb;
+            constexpr std::size_t nr = traits::nr;
+            constexpr std::size_t simd_size = traits::simd_size;
+
+            batch_type acc[mr][nb];
+            for (std::size_t i = 0; i < mr; ++i)
+            {
+                for (std::size_t j = 0; j < nb; ++j)
+                {
+                    acc[i][j] = batch_type(T(0));
+                }
+            }
+
+            for (std::size_t p = 0; p < k; ++p, a += mr, b += nr)
+            {
+                batch_type bv[nb];
+                for (std::size_t j = 0; j < nb; ++j)
+                {
+                    bv[j] = gemm_load<batch_type>(b + j * simd_size, use_simd());
+                }
+                for (std::size_t i = 0; i < mr; ++i)
+                {
+                    batch_type av(a[i]);
+                    for (std::size_t j = 0; j < nb; ++j)
+                    {
+                        acc[i][j] = gemm_madd(av, bv[j], acc[i][j], use_simd());
+                    }
+                }
+            }
+
+            if (m == mr && n == nr)
+            {
+                for (std::size_t i = 0; i < mr; ++i)
+                {
+                    T* row = c + i * ldc;
+                    for (std::size_t j = 0; j < nb; ++j)
+                    {
+                        T* dst = row + j * simd_size;
+                        if (accumulate)
+                        {
+                            gemm_store(dst, gemm_load<batch_type>(dst, use_simd()) + acc[i][j], use_simd());
+                        }
+                        else
+                        {
+                            gemm_store(dst, acc[i][j], use_simd());
+                        }
+                    }
+                }
+            }
+            else
+            {
+                T tile[mr * nr];
+                for (std::size_t i = 0; i < mr; ++i)
+                {
+                    for (std::size_t j = 0; j < nb; ++j)
+                    {
+                        gemm_store(tile + i * nr + j * simd_size, acc[i][j], use_simd());
+                    }
+                }
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    T* row = c + i * ldc;
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        row[j] = accumulate ? row[j] + tile[i * nr + j] : tile[i * nr + j];
+                    }
+                }
+            }
+        }
+
+        // Computes the m x n matrix c, whose rows are ldc elements apart, as
+        // the product of the m x k matrix a by the k x n matrix b. The element
+        // (i, p) of a is a[a_rows[i] + a_cols[p]], and similarly for b, so
+        // that any strided operand, and any grouping of its axes into rows and
+        // columns, is read without being transposed first. The blocks of rows
+        // of c are split among the threads of the policy.
+        template <class T, class TA, class TB, class P>
+        inline void gemm(std::size_t m, std::size_t n, std::size_t k,
+                         const TA* a, const std::ptrdiff_t* a_rows, const std::ptrdiff_t* a_cols,
+                         const TB* b, const std::ptrdiff_t* b_rows, const std::ptrdiff_t* b_cols,
+                         T* c, std::size_t ldc, const P& policy)
+        {
+            using traits = gemm_traits<T>;
+            constexpr std::size_t mr = traits::mr;
+            constexpr std::size_t nr = traits::nr;
+
+            if (m == 0 || n == 0)
+            {
+                return;
+            }
+            if (k == 0)
+            {
+                for (std::size_t i = 0; i < m; ++i)
+                {
+                    std::fill(c + i * ldc, c + i * ldc + n, T(0));
+                }
+                return;
+            }
+
+            const std::size_t kc = (std::min)(std::size_t(traits::kc), k);
+            const std::size_t mc = (std::min)(std::size_t(traits::mc), (m + mr - 1) / mr * mr);
+            const std::size_t nc = (std::min)(std::size_t(traits::nc), (n + nr - 1) / nr * nr);
+            const std::size_t row_blocks = (m + mc - 1) / mc;
+            uvector<T> packed_b(kc * nc);
+
+            for (std::size_t jc = 0; jc < n; jc += nc)
+            {
+                const std::size_t nn = (std::min)(nc, n - jc);
+                for (std::size_t pc = 0; pc < k; pc += kc)
+                {
+                    const std::size_t kk = (std::min)(kc, k - pc);
+                    const bool accumulate = pc != 0;
+                    gemm_pack_b(b, b_rows, b_cols, pc, kk, jc, nn, packed_b.data());
+                    const T* pb = packed_b.data();
+
+                    policy.for_range(0, row_blocks, 1, [&](std::size_t first, std::size_t last)
+                    {
+                        uvector<T> packed_a(mc * kc);
+                        for (std::size_t blk = first; blk < last; ++blk)
+                        {
+                            const std::size_t ic = blk * mc;
+                            const std::size_t mm = (std::min)(mc, m - ic);
+                            gemm_pack_a(a, a_rows, a_cols, ic, mm, pc, kk, packed_a.data());
+                            for (std::size_t jr = 0; jr < nn; jr += nr)
+                            {
+                                const T* panel_b = pb + jr * kk;
+                                for (std::size_t ir = 0; ir < mm; ir += mr)
+                                {
+                                    gemm_micro_kernel(kk, packed_a.data() + ir * kk, panel_b,
+                                                      c + (ic + ir) * ldc + jc + jr, ldc,
+                                                      (std::min)(mr, mm - ir), (std::min)(nr, nn - jr), accumulate);
+                                }
+                            }
+                        }
+                    });
+                }
+            }
+        }
+
+        template <class E>
+        using is_strided_operand = xtl::conjunction<has_data_interface<E>, has_strides<E>>;
+
+        template <class E>
+        inline const E& strided_operand(const E& e, std::true_type)
+        {
+            return e;
+        }
+
+        template <class E>
+        inline xarray<typename E::value_type> strided_operand(const E& e, std::false_type)
+        {
+            return e;
+        }
+
+        // Offsets of the elements of the row-major traversal of the axes of
+        // an operand, the other axes being fixed to 0.
+        template <class S, class ST>
+        inline std::vector<std::ptrdiff_t> gemm_offsets(const S& shape, const ST& strides, const std::vector<std::size_t>& axes)
+        {
+            std::vector<std::ptrdiff_t> res(1, 0);
+            for (std::size_t axis : axes)
+            {
+                const std::size_t extent = static_cast<std::size_t>(shape[axis]);
+                const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(strides[axis]);
+                std::vector<std::ptrdiff_t> next;
+                next.reserve(res.size() * extent);
+                for (std::ptrdiff_t offset : res)
+                {
+                    for (std::size_t i = 0; i < extent; ++i)
+                    {
+                        next.push_back(offset + static_cast<std::ptrdiff_t>(i) * stride);
+                    }
+                }
+                res = std::move(next);
+            }
+            return res;
+        }
+
+        template <class E1, class E2>
+        using matmul_value_type = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+
+        template <class E1, class E2, class P>
+        inline auto tensordot_impl(const E1& e1, const E2& e2,
+                                   const std::vector<std::size_t>& axes1, const std::vector<std::size_t>& axes2,
+                                   const P& policy)
+        {
+            using value_type = matmul_value_type<E1, E2>;
+            using result_type = xarray<value_type>;
+
+            const std::size_t dim1 = e1.dimension();
+            const std::size_t dim2 = e2.dimension();
+            if (axes1.size() != axes2.size())
+            {
+                XTENSOR_THROW(std::runtime_error, "tensordot: the lists of contracted axes must have the same size");
+            }
+
+            std::vector<bool> contracted1(dim1, false);
+            std::vector<bool> contracted2(dim2, false);
+            for (std::size_t i = 0; i < axes1.size(); ++i)
+            {
+                if (axes1[i] >= dim1 || axes2[i] >= dim2)
+                {
+                    XTENSOR_THROW(std::runtime_error, "tensordot: contracted axis out of bounds");
+                }
+                if (contracted1[axes1[i]] || contracted2[axes2[i]])
+                {
+                    XTENSOR_THROW(std::runtime_error, "tensordot: repeated contracted axis");
+                }
+                if (static_cast<std::size_t>(e1.shape()[axes1[i]]) != static_cast<std::size_t>(e2.shape()[axes2[i]]))
+                {
+                    XTENSOR_THROW(std::runtime_error, "tensordot: shape mismatch along contracted axes");
+                }
+                contracted1[axes1[i]] = true;
+                contracted2[axes2[i]] = true;
+            }
+
+            std::vector<std::size_t> free1;
+            std::vector<std::size_t> free2;
+            typename result_type::shape_type shape;
+            for (std::size_t d = 0; d < dim1; ++d)
+            {
+                if (!contracted1[d])
+                {
+                    free1.push_back(d);
+                    shape.push_back(static_cast<std::size_t>(e1.shape()[d]));
+                }
+            }
+            for (std::size_t d = 0; d < dim2; ++d)
+            {
+                if (!contracted2[d])
+                {
+                    free2.push_back(d);
+                    shape.push_back(static_cast<std::size_t>(e2.shape()[d]));
+                }
+            }
+
+            auto rows1 = gemm_offsets(e1.shape(), e1.strides(), free1);
+            auto cols1 = gemm_offsets(e1.shape(), e1.strides(), axes1);
+            auto rows2 = gemm_offsets(e2.shape(), e2.strides(), axes2);
+            auto cols2 = gemm_offsets(e2.shape(), e2.strides(), free2);
+
+            result_type res = result_type::from_shape(shape);
+            gemm(rows1.size(), cols2.size(), cols1.size(),
+                 e1.data() + e1.data_offset(), rows1.data(), cols1.data(),
+                 e2.data() + e2.data_offset(), rows2.data(), cols2.data(),
+                 res.data(), cols2.size(), policy);
+            return res;
+        }
+
+        template <class E1, class E2, class P>
+        inline auto matmul_impl(const E1& e1, const E2& e2, const P& policy)
+        {
+            using value_type = matmul_value_type<E1, E2>;
+            using result_type = xarray<value_type>;
+
+            const std::size_t dim1 = e1.dimension();
+            const std::size_t dim2 = e2.dimension();
+            if (dim1 == 0 || dim2 == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "matmul: the operands must not be scalars");
+            }
+
+            // One-dimensional operands are a row vector on the left and a
+            // column vector on the right; the corresponding axis is then
+            // removed from the result.
+            const std::size_t m = dim1 == 1 ? 1 : static_cast<std::size_t>(e1.shape()[dim1 - 2]);
+            const std::size_t k = static_cast<std::size_t>(e1.shape()[dim1 - 1]);
+            const std::size_t k2 = static_cast<std::size_t>(e2.shape()[dim2 == 1 ? 0 : dim2 - 2]);
+            const std::size_t n = dim2 == 1 ? 1 : static_cast<std::size_t>(e2.shape()[dim2 - 1]);
+            if (k != k2)
+            {
+                XTENSOR_THROW(std::runtime_error, "matmul: shape mismatch along the contracted axis");
+            }
+            const std::ptrdiff_t sm = dim1 == 1 ? 0 : static_cast<std::ptrdiff_t>(e1.strides()[dim1 - 2]);
+            const std::ptrdiff_t sk1 = static_cast<std::ptrdiff_t>(e1.strides()[dim1 - 1]);
+            const std::ptrdiff_t sk2 = static_cast<std::ptrdiff_t>(e2.strides()[dim2 == 1 ? 0 : dim2 - 2]);
+            const std::ptrdiff_t sn = dim2 == 1 ? 0 : static_cast<std::ptrdiff_t>(e2.strides()[dim2 - 1]);
+
+            // Leading axes are broadcast as a stack of matrices.
+            const std::size_t batch1 = dim1 > 2 ? dim1 - 2 : 0;
+            const std::size_t batch2 = dim2 > 2 ? dim2 - 2 : 0;
+            const std::size_t batch_dim = (std::max)(batch1, batch2);
+            std::vector<std::size_t> batch_shape(batch_dim, 1);
+            std::vector<std::ptrdiff_t> batch_strides1(batch_dim, 0);
+            std::vector<std::ptrdiff_t> batch_strides2(batch_dim, 0);
+            for (std::size_t d = 0; d < batch_dim; ++d)
+            {
+                std::size_t ext1 = 1;
+                std::size_t ext2 = 1;
+                if (d + batch1 >= batch_dim)
+                {
+                    std::size_t d1 = d + batch1 - batch_dim;
+                    ext1 = static_cast<std::size_t>(e1.shape()[d1]);
+                    batch_strides1[d] = ext1 == 1 ? 0 : static_cast<std::ptrdiff_t>(e1.strides()[d1]);
+                }
+                if (d + batch2 >= batch_dim)
+                {
+                    std::size_t d2 = d + batch2 - batch_dim;
+                    ext2 = static_cast<std::size_t>(e2.shape()[d2]);
+                    batch_strides2[d] = ext2 == 1 ? 0 : static_cast<std::ptrdiff_t>(e2.strides()[d2]);
+                }
+                if (ext1 != ext2 && ext1 != 1 && ext2 != 1)
+                {
+                    XTENSOR_THROW(std::runtime_error, "matmul: the leading axes cannot be broadcast");
+                }
+                batch_shape[d] = (std::max)(ext1, ext2);
+            }
+
+            typename result_type::shape_type shape(batch_shape.cbegin(), batch_shape.cend());
+            if (dim1 != 1)
+            {
+                shape.push_back(m);
+            }
+            if (dim2 != 1)
+            {
+                shape.push_back(n);
+            }
+            result_type res = result_type::from_shape(shape);
+
+            std::vector<std::ptrdiff_t> rows1(m), cols1(k), rows2(k), cols2(n);
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                rows1[i] = static_cast<std::ptrdiff_t>(i) * sm;
+            }
+            for (std::size_t p = 0; p < k; ++p)
+            {
+                cols1[p] = static_cast<std::ptrdiff_t>(p) * sk1;
+                rows2[p] = static_cast<std::ptrdiff_t>(p) * sk2;
+            }
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                cols2[j] = static_cast<std::ptrdiff_t>(j) * sn;
+            }
+
+            const auto* data1 = e1.data() + e1.data_offset();
+            const auto* data2 = e2.data() + e2.data_offset();
+            std::size_t batches = 1;
+            for (std::size_t ext : batch_shape)
+            {
+                batches *= ext;
+            }
+            for (std::size_t b = 0; b < batches; ++b)
+            {
+                std::size_t rem = b;
+                std::ptrdiff_t offset1 = 0;
+                std::ptrdiff_t offset2 = 0;
+                for (std::size_t d = batch_dim; d-- > 0;)
+                {
+                    std::ptrdiff_t idx = static_cast<std::ptrdiff_t>(rem % batch_shape[d]);
+                    rem /= batch_shape[d];
+                    offset1 += idx * batch_strides1[d];
+                    offset2 += idx * batch_strides2[d];
+                }
+                gemm(m, n, k,
+                     data1 + offset1, rows1.data(), cols1.data(),
+                     data2 + offset2, rows2.data(), cols2.data(),
+                     res.data() + b * m * n, n, policy);
+            }
+            return res;
+        }
+    }
+
+    /********************
+     * matmul/tensordot *
+     ********************/
+
+    /**
+     * @brief Matrix product of two expressions, with the semantic of
+     * numpy.matmul.
+     *
+     * Two-dimensional operands are multiplied as matrices. A one-dimensional
+     * operand is a row vector on the left and a column vector on the right,
+     * and the corresponding axis is removed from the result. The leading
+     * axes of operands of higher dimension are broadcast as stacks of
+     * matrices. The product is computed by a packed, cache-blocked kernel,
+     * vectorized with xsimd when possible; strided operands are read in
+     * place and the other expressions are evaluated first.
+     * @param e1 the left operand
+     * @param e2 the right operand
+     * @param policy the execution policy splitting the blocks of rows of
+     * the products
+     * @return an xarray holding the product
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto matmul(const xexpression<E1>& e1, const xexpression<E2>& e2, const P& policy)
+    {
+        const auto& a = detail::strided_operand(e1.derived_cast(), detail::is_strided_operand<E1>());
+        const auto& b = detail::strided_operand(e2.derived_cast(), detail::is_strided_operand<E2>());
+        return detail::matmul_impl(a, b, policy);
+    }
+
+    /**
+     * @brief Matrix product of two expressions, with the semantic of
+     * numpy.matmul, computed under the default execution policy.
+     * @param e1 the left operand
+     * @param e2 the right operand
+     * @return an xarray holding the product
+     */
+    template <class E1, class E2>
+    inline auto matmul(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        return matmul(e1, e2, exec::default_policy());
+    }
+
+    /**
+     * @brief Tensor contraction of two expressions over the given axes,
+     * with the semantic of numpy.tensordot.
+     *
+     * The axis \c axes1[i] of \c e1 is contracted with the axis \c axes2[i]
+     * of \c e2. The axes of the result are the remaining axes of \c e1
+     * followed by the remaining axes of \c e2. The contraction is computed
+     * by the kernel of matmul, which reads the operands through their
+     * strides instead of transposing them.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @param axes1 the contracted axes of \c e1
+     * @param axes2 the contracted axes of \c e2
+     * @param policy the execution policy splitting the blocks of rows of
+     * the product
+     * @return an xarray holding the contraction
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2,
+                          const std::vector<std::size_t>& axes1, const std::vector<std::size_t>& axes2,
+                          const P& policy)
+    {
+        const auto& a = detail::strided_operand(e1.derived_cast(), detail::is_strided_operand<E1>());
+        const auto& b = detail::strided_operand(e2.derived_cast(), detail::is_strided_operand<E2>());
+        return detail::tensordot_impl(a, b, axes1, axes2, policy);
+    }
+
+    /**
+     * @brief Tensor contraction of two expressions over the given axes,
+     * computed under the default execution policy.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @param axes1 the contracted axes of \c e1
+     * @param axes2 the contracted axes of \c e2
+     * @return an xarray holding the contraction
+     */
+    template <class E1, class E2>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2,
+                          const std::vector<std::size_t>& axes1, const std::vector<std::size_t>& axes2)
+    {
+        return tensordot(e1, e2, axes1, axes2, exec::default_policy());
+    }
+
+    /**
+     * @brief Tensor contraction of the last \c naxes axes of \c e1 with the
+     * first \c naxes axes of \c e2.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @param naxes the number of contracted axes
+     * @param policy the execution policy splitting the blocks of rows of
+     * the product
+     * @return an xarray holding the contraction
+     */
+    template <class E1, class E2, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2, std::size_t naxes, const P& policy)
+    {
+        const std::size_t dim1 = e1.derived_cast().dimension();
+        if (naxes > dim1 || naxes > e2.derived_cast().dimension())
+        {
+            XTENSOR_THROW(std::runtime_error, "tensordot: more contracted axes than dimensions");
+        }
+        std::vector<std::size_t> axes1(naxes), axes2(naxes);
+        for (std::size_t i = 0; i < naxes; ++i)
+        {
+            axes1[i] = dim1 - naxes + i;
+            axes2[i] = i;
+        }
+        return tensordot(e1, e2, axes1, axes2, policy);
+    }
+
+    /**
+     * @brief Tensor contraction of the last \c naxes axes of \c e1 with the
+     * first \c naxes axes of \c e2, computed under the default execution
+     * policy.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @param naxes the number of contracted axes
+     * @return an xarray holding the contraction
+     */
+    template <class E1, class E2>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2, std::size_t naxes = 2)
+    {
+        return tensordot(e1, e2, naxes, exec::default_policy());
+    }
+
+    namespace detail
+    {
+        /*****************************
+         * covariance matrix kernels *
+         *****************************/
+
+        // Lower triangle of c = a * a^T for the n x k matrix a whose element
+        // (i, p) is a[rows[i] + cols[p]]. The block of rows [i0, i1) only
+        // needs the columns [0, i1), which halves the work of the full
+        // product; the blocks are dealt out short and long in turn so that
+        // the ranges of the threads have similar costs.
+        template <class T, class P>
+        inline void syrk_lower(std::size_t n, std::size_t k, const T* a, const std::ptrdiff_t* rows,
+                               const std::ptrdiff_t* cols, T* c, const P& policy)
+        {
+            const std::size_t block = gemm_traits<T>::mc;
+            const std::size_t blocks = (n + block - 1) / block;
+            policy.for_range(0, blocks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t t = first; t < last; ++t)
+                {
+                    const std::size_t blk = t % 2 == 0 ? t / 2 : blocks - 1 - t / 2;
+                    const std::size_t i0 = blk * block;
+                    const std::size_t i1 = (std::min)(n, i0 + block);
+                    gemm(i1 - i0, i1, k, a, rows + i0, cols, a, cols, rows, c + i0 * n, n, exec::seq);
+                }
+            });
+        }
+
+        // Covariance matrix of the variables of the 2-D array x, held
+        // along its rows when rowvar is true and along its columns
+        // otherwise. x is centered in a single pass over the variables and
+        // the product of the centered array with its transpose is a
+        // symmetric rank-k update.
+        template <class E, class P>
+        inline auto cov_impl(const E& x, bool rowvar, const P& policy)
+        {
+            using value_type = typename E::value_type;
+            using result_type = axis_integral_type<value_type>;
+            using tensor_type = xtensor<result_type, 2>;
+
+            if (x.dimension() > 2)
+            {
+                XTENSOR_THROW(std::runtime_error, "cov: the input must have one or two dimensions");
+            }
+            const bool row_major_vars = rowvar || x.dimension() == 1;
+            std::array<std::size_t, 2> shape = {1, 1};
+            std::copy(x.shape().crbegin(), x.shape().crend(), shape.rbegin());
+            const axis_lanes l = make_axis_lanes(shape, row_major_vars ? 1 : 0);
+            const std::size_t n = row_major_vars ? shape[0] : shape[1];
+            const std::size_t k = l.length;
+
+            xarray<value_type, layout_type::row_major> storage;
+            const value_type* src = row_major_data(x, storage);
+            uvector<result_type> centered(n * k);
+            std::vector<std::ptrdiff_t> rows(n), cols(k);
+            const std::size_t var_stride = row_major_vars ? k : 1;
+            const std::size_t obs_stride = row_major_vars ? 1 : n;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                rows[i] = static_cast<std::ptrdiff_t>(i * var_stride);
+            }
+            for (std::size_t p = 0; p < k; ++p)
+            {
+                cols[p] = static_cast<std::ptrdiff_t>(p * obs_stride);
+            }
+
+            const result_type count = static_cast<result_type>(k);
+            for_each_axis_tile(l, std::size_t(1), std::size_t(1), policy,
+                [&](std::size_t o, std::size_t lane, std::size_t nlanes, std::size_t, std::size_t)
+            {
+                const std::size_t offset = o * l.length * l.inner + lane;
+                const value_type* in = src + offset;
+                result_type* out = centered.data() + offset;
+                std::array<result_type, axis_lane_block> mean;
+                std::fill(mean.begin(), mean.begin() + nlanes, result_type(0));
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        mean[j] += static_cast<result_type>(in[p * l.inner + j]);
+                    }
+                }
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    mean[j] /= count;
+                }
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        out[p * l.inner + j] = static_cast<result_type>(in[p * l.inner + j]) - mean[j];
+                    }
+                }
+            });
+
+            tensor_type res = tensor_type::from_shape({n, n});
+            result_type* c = res.data();
+            syrk_lower(n, k, centered.data(), rows.data(), cols.data(), c, policy);
+            const result_type div = static_cast<result_type>(k) - result_type(1);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t j = 0; j <= i; ++j)
+                {
+                    c[i * n + j] /= div;
+                    c[j * n + i] = c[i * n + j];
+                }
+            }
+            return res;
+        }
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Returns the covariance matrix of the variables of a two-dimensional array.
+     *
+     * Each row of \c x holds the observations of a variable when \c rowvar is true, each column otherwise,
+     * as numpy.cov. The array is centered in a single pass and the products of the variables are computed
+     * by a symmetric update running the blocked matrix product kernel on the lower triangle only. The
+     * estimate is unbiased (normalized by the number of observations minus one) and holds doubles when
+     * \c x holds integers. This function is not lazy.
+     * @param x one or two dimensional array
+     * @param rowvar whether the variables are the rows of \c x
+     * @param policy the execution policy splitting the blocks of variables
+     * @return an xtensor of shape (variables, variables)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto cov(const xexpression<E>& x, bool rowvar, const P& policy)
+    {
+        return detail::cov_impl(x.derived_cast(), rowvar, policy);
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Returns the covariance matrix of the variables of a two-dimensional array.
+     *
+     * @param x one or two dimensional array
+     * @param rowvar whether the variables are the rows of \c x
+     * @return an xtensor of shape (variables, variables)
+     * @sa cov(const xexpression<E>&, bool, const P&)
+     */
+    template <class E>
+    inline auto cov(const xexpression<E>& x, bool rowvar)
+    {
+        return cov(x, rowvar, exec::default_policy());
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Returns the Pearson correlation coefficients of the variables of a two-dimensional array.
+     *
+     * The covariance matrix \c c of cov(x, rowvar, policy) is normalized to c(i, j) / sqrt(c(i, i) * c(j, j)),
+     * clipped to [-1, 1], as numpy.corrcoef. This function is not lazy.
+     * @param x one or two dimensional array
+     * @param rowvar whether the variables are the rows of \c x
+     * @param policy the execution policy splitting the blocks of variables
+     * @return an xtensor of shape (variables, variables)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto corrcoef(const xexpression<E>& x, bool rowvar, const P& policy)
+    {
+        auto res = detail::cov_impl(x.derived_cast(), rowvar, policy);
+        using result_type = typename decltype(res)::value_type;
+        const std::size_t n = res.shape()[0];
+        result_type* c = res.data();
+        std::vector<result_type> stddev(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            stddev[i] = std::sqrt(c[i * n + i]);
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                const result_type r = c[i * n + j] / (stddev[i] * stddev[j]);
+                c[i * n + j] = (std::max)(result_type(-1), (std::min)(result_type(1), r));
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Returns the Pearson correlation coefficients of the variables of a two-dimensional array.
+     *
+     * @param x one or two dimensional array
+     * @param rowvar whether the variables are the rows of \c x (default true)
+     * @return an xtensor of shape (variables, variables)
+     * @sa corrcoef(const xexpression<E>&, bool, const P&)
+     */
+    template <class E>
+    inline auto corrcoef(const xexpression<E>& x, bool rowvar = true)
+    {
+        return corrcoef(x, rowvar, exec::default_policy());
+    }
+}
+
+#endif
@@ -0,0 +1,649 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_MEMOIZE_HPP
+#define XTENSOR_MEMOIZE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xiterator_base.hpp>
+
+#include "xaccessible.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xiterator.hpp"
+#include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /***********
+     * memoize *
+     ***********/
+
+    template <class E>
+    auto memoize(E&& e);
+
+    /**********************************
+     * xmemoized_expression internals *
+     **********************************/
+
+    template <class CT>
+    class xmemoized_expression;
+
+    template <class CT>
+    class xmemoized_iterator;
+
+    template <class CT>
+    struct xiterable_inner_types<xmemoized_expression<CT>>
+    {
+        using xexpression_type = std::decay_t<CT>;
+        using inner_shape_type = typename xexpression_type::inner_shape_type;
+        using const_stepper = typename xexpression_type::const_stepper;
+        using stepper = const_stepper;
+    };
+
+    template <class CT>
+    struct xcontainer_inner_types<xmemoized_expression<CT>>
+    {
+        using xexpression_type = std::decay_t<CT>;
+        using reference = typename xexpression_type::const_reference;
+        using const_reference = typename xexpression_type::const_reference;
+        using size_type = typename xexpression_type::size_type;
+    };
+
+    template <class T, class CT>
+    struct has_simd_interface<xmemoized_expression<CT>, T>
+        : has_simd_interface<std::decay_t<CT>, T>
+    {
+    };
+
+    namespace detail
+    {
+        // Values of a memoized expression computed by the current thread,
+        // starting at the index m_begin.
+        template <class T>
+        struct xmemoized_block
+        {
+            const void* p_owner = nullptr;
+            std::size_t m_epoch = 0;
+            std::size_t m_begin = 0;
+            std::size_t m_size = 0;
+            std::size_t m_fill = 0;
+            std::array<T, XTENSOR_MEMOIZE_BLOCK_SIZE> m_values;
+        };
+
+        // Each thread keeps a block for the last few memoized expressions
+        // of a given value type it evaluated.
+        template <class T>
+        struct xmemoized_cache
+        {
+            std::array<xmemoized_block<T>, 4> m_blocks;
+            std::size_t m_next = 0;
+        };
+
+        template <class T>
+        inline xmemoized_cache<T>& memoized_cache()
+        {
+            static thread_local xmemoized_cache<T> cache;
+            return cache;
+        }
+
+        // The epochs are unique across all the memoized expressions, so
+        // that a block can never be mistaken for one of an expression
+        // allocated at the same address.
+        inline std::size_t next_memoized_epoch() noexcept
+        {
+            static std::atomic<std::size_t> epoch(0);
+            return epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+    }
+
+    /************************
+     * xmemoized_expression *
+     ************************/
+
+    /**
+     * @class xmemoized_expression
+     * @brief Expression evaluated once per element for all its occurrences.
+     *
+     * When the same subexpression appears several times in an expression,
+     * e.g. <tt>d * d + abs(d)</tt>, each occurrence computes it again. The
+     * copies of an xmemoized_expression share their state instead: during a
+     * linear assignment, the first occurrence computes a block of
+     * XTENSOR_MEMOIZE_BLOCK_SIZE values in a buffer of the current thread,
+     * from which the other occurrences and the following elements read.
+     * SIMD batches are loaded from this buffer as well.
+     *
+     * The values are computed again at each assignment, when it checks
+     * whether a linear assignment is possible. The other ways of
+     * accessing the elements (operator(), steppers, which the assignments
+     * of non-contiguous or broadcasting expressions use) are forwarded to
+     * the underlying expression and are not memoized.
+     *
+     * @tparam CT the closure type of the memoized \ref xexpression
+     *
+     * @sa memoize
+     */
+    template <class CT>
+    class xmemoized_expression : public xsharable_expression<xmemoized_expression<CT>>,
+                                 public xconst_iterable<xmemoized_expression<CT>>,
+                                 public xconst_accessible<xmemoized_expression<CT>>
+    {
+    public:
+
+        using self_type = xmemoized_expression<CT>;
+        using xexpression_type = std::decay_t<CT>;
+        using accessible_base = xconst_accessible<self_type>;
+        using expression_tag = xtensor_expression_tag;
+
+        using inner_types = xcontainer_inner_types<self_type>;
+        using value_type = typename xexpression_type::value_type;
+        using reference = typename inner_types::reference;
+        using const_reference = typename inner_types::const_reference;
+        using pointer = typename xexpression_type::const_pointer;
+        using const_pointer = typename xexpression_type::const_pointer;
+        using size_type = typename inner_types::size_type;
+        using difference_type = typename xexpression_type::difference_type;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using linear_iterator = xmemoized_iterator<CT>;
+        using const_linear_iterator = linear_iterator;
+
+        using bool_load_type = typename xexpression_type::bool_load_type;
+
+        template <class requested_type>
+        using simd_return_type = xt_simd::simd_return_type<value_type, requested_type>;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        template <class CTA, class = std::enable_if_t<!std::is_base_of<self_type, std::decay_t<CTA>>::value>>
+        explicit xmemoized_expression(CTA&& e);
+
+        using accessible_base::size;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+        bool is_contiguous() const noexcept;
+        using accessible_base::shape;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        const_reference data_element(size_type i) const;
+
+        const xexpression_type& expression() const noexcept;
+
+        template <class S>
+        bool broadcast_shape(S& shape, bool reuse_cache = false) const;
+
+        template <class S>
+        bool has_linear_assign(const S& strides) const noexcept;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const noexcept;
+        template <class S>
+        const_stepper stepper_end(const S& shape, layout_type l) const noexcept;
+
+        const_linear_iterator linear_begin() const noexcept;
+        const_linear_iterator linear_end() const noexcept;
+        const_linear_iterator linear_cbegin() const noexcept;
+        const_linear_iterator linear_cend() const noexcept;
+
+        template <class align, class requested_type = value_type,
+                  std::size_t N = xt_simd::simd_traits<requested_type>::size>
+        simd_return_type<requested_type> load_simd(size_type i) const;
+
+    private:
+
+        using block_type = detail::xmemoized_block<value_type>;
+
+        struct state_type
+        {
+            template <class CTA>
+            explicit state_type(CTA&& e);
+
+            CT m_e;
+            mutable std::atomic<std::size_t> m_epoch;
+        };
+
+        void refresh() const noexcept;
+        bool holds(const block_type& b, std::size_t first, std::size_t last) const noexcept;
+        const block_type& block(size_type i, size_type n) const;
+
+        std::shared_ptr<const state_type> p_state;
+
+        friend class xmemoized_iterator<CT>;
+    };
+
+    /**********************
+     * xmemoized_iterator *
+     **********************/
+
+    template <class CT>
+    class xmemoized_iterator : public xtl::xrandom_access_iterator_base<xmemoized_iterator<CT>,
+                                                                        typename xmemoized_expression<CT>::value_type,
+                                                                        typename xmemoized_expression<CT>::difference_type,
+                                                                        typename xmemoized_expression<CT>::const_pointer,
+                                                                        typename xmemoized_expression<CT>::value_type>
+    {
+    public:
+
+        using self_type = xmemoized_iterator<CT>;
+        using expression_type = xmemoized_expression<CT>;
+
+        using value_type = typename expression_type::value_type;
+        using reference = value_type;
+        using pointer = typename expression_type::const_pointer;
+        using size_type = typename expression_type::size_type;
+        using difference_type = typename expression_type::difference_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xmemoized_iterator(const expression_type* e, size_type index) noexcept;
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        using block_type = typename expression_type::block_type;
+
+        const expression_type* p_e;
+        size_type m_index;
+        mutable const block_type* p_block;
+        mutable std::size_t m_fill;
+        mutable std::size_t m_first;
+        mutable std::size_t m_size;
+    };
+
+    template <class CT>
+    bool operator==(const xmemoized_iterator<CT>& it1,
+                    const xmemoized_iterator<CT>& it2);
+
+    template <class CT>
+    bool operator<(const xmemoized_iterator<CT>& it1,
+                   const xmemoized_iterator<CT>& it2);
+
+    /**************************
+     * memoize implementation *
+     **************************/
+
+    /**
+     * @brief Returns an \ref xexpression whose elements are computed once
+     * for all its occurrences in an assigned expression.
+     *
+     * \code{.cpp}
+     * auto d = xt::memoize(a - b);
+     * xt::xarray<double> res = d * d + xt::abs(d); // a - b is computed once per element
+     * \endcode
+     *
+     * The returned expression either holds a const reference to \p e or a
+     * copy depending on whether \p e is an lvalue or an rvalue; its copies
+     * share their state.
+     *
+     * @param e the \ref xexpression to memoize
+     */
+    template <class E>
+    inline auto memoize(E&& e)
+    {
+        using memoized_type = xmemoized_expression<const_xclosure_t<E>>;
+        return memoized_type(std::forward<E>(e));
+    }
+
+    /***************************************
+     * xmemoized_expression implementation *
+     ***************************************/
+
+    template <class CT>
+    template <class CTA>
+    inline xmemoized_expression<CT>::state_type::state_type(CTA&& e)
+        : m_e(std::forward<CTA>(e)), m_epoch(detail::next_memoized_epoch())
+    {
+    }
+
+    /**
+     * Constructs an xmemoized_expression of the specified \ref xexpression.
+     * @param e the expression to memoize
+     */
+    template <class CT>
+    template <class CTA, class>
+    inline xmemoized_expression<CT>::xmemoized_expression(CTA&& e)
+        : p_state(std::make_shared<const state_type>(std::forward<CTA>(e)))
+    {
+    }
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the shape of the expression.
+     */
+    template <class CT>
+    inline auto xmemoized_expression<CT>::shape() const noexcept -> const inner_shape_type&
+    {
+        return p_state->m_e.shape();
+    }
+
+    /**
+     * Returns the layout_type of the expression.
+     */
+    template <class CT>
+    inline layout_type xmemoized_expression<CT>::layout() const noexcept
+    {
+        return p_state->m_e.layout();
+    }
+
+    template <class CT>
+    inline bool xmemoized_expression<CT>::is_contiguous() const noexcept
+    {
+        return p_state->m_e.is_contiguous();
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the element at the specified position in the expression,
+     * computed by the underlying expression.
+     * @param args a list of indices specifying the position in the expression.
+     */
+    template <class CT>
+    template <class... Args>
+    inline auto xmemoized_expression<CT>::operator()(Args... args) const -> const_reference
+    {
+        return p_state->m_e(args...);
+    }
+
+    template <class CT>
+    template <class... Args>
+    inline auto xmemoized_expression<CT>::unchecked(Args... args) const -> const_reference
+    {
+        return p_state->m_e.unchecked(args...);
+    }
+
+    template <class CT>
+    template <class It>
+    inline auto xmemoized_expression<CT>::element(It first, It last) const -> const_reference
+    {
+        return p_state->m_e.element(first, last);
+    }
+
+    template <class CT>
+    inline auto xmemoized_expression<CT>::data_element(size_type i) const -> const_reference
+    {
+        return p_state->m_e.data_element(i);
+    }
+
+    /**
+     * Returns a constant reference to the memoized expression.
+     */
+    template <class CT>
+    inline auto xmemoized_expression<CT>::expression() const noexcept -> const xexpression_type&
+    {
+        return p_state->m_e;
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the expression to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class CT>
+    template <class S>
+    inline bool xmemoized_expression<CT>::broadcast_shape(S& shape, bool reuse_cache) const
+    {
+        return p_state->m_e.broadcast_shape(shape, reuse_cache);
+    }
+
+    /**
+     * Checks whether the expression can be linearly assigned to an expression
+     * with the specified strides. This starts a new evaluation: the values
+     * computed before are not used anymore.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class CT>
+    template <class S>
+    inline bool xmemoized_expression<CT>::has_linear_assign(const S& strides) const noexcept
+    {
+        refresh();
+        return p_state->m_e.has_linear_assign(strides);
+    }
+    //@}
+
+    template <class CT>
+    template <class S>
+    inline auto xmemoized_expression<CT>::stepper_begin(const S& shape) const noexcept -> const_stepper
+    {
+        return p_state->m_e.stepper_begin(shape);
+    }
+
+    template <class CT>
+    template <class S>
+    inline auto xmemoized_expression<CT>::stepper_end(const S& shape, layout_type l) const noexcept -> const_stepper
+    {
+        return p_state->m_e.stepper_end(shape, l);
+    }
+
+    template <class CT>
+    inline auto xmemoized_expression<CT>::linear_begin() const noexcept -> const_linear_iterator
+    {
+        return linear_cbegin();
+    }
+
+    template <class CT>
+    inline auto xmemoized_expression<CT>::linear_end() const noexcept -> const_linear_iterator
+    {
+        return linear_cend();
+    }
+
+    template <class CT>
+    inline auto xmemoized_expression<CT>::linear_cbegin() const noexcept -> const_linear_iterator
+    {
+        return const_linear_iterator(this, size_type(0));
+    }
+
+    template <class CT>
+    inline auto xmemoized_expression<CT>::linear_cend() const noexcept -> const_linear_iterator
+    {
+        return const_linear_iterator(this, size());
+    }
+
+    template <class CT>
+    template <class align, class requested_type, std::size_t N>
+    inline auto xmemoized_expression<CT>::load_simd(size_type i) const -> simd_return_type<requested_type>
+    {
+        const block_type& b = block(i, N);
+        return xt_simd::load_as<requested_type>(b.m_values.data() + (static_cast<std::size_t>(i) - b.m_begin), unaligned_mode());
+    }
+
+    template <class CT>
+    inline void xmemoized_expression<CT>::refresh() const noexcept
+    {
+        p_state->m_epoch.store(detail::next_memoized_epoch(), std::memory_order_relaxed);
+    }
+
+    template <class CT>
+    inline bool xmemoized_expression<CT>::holds(const block_type& b, std::size_t first, std::size_t last) const noexcept
+    {
+        return b.p_owner == p_state.get()
+            && b.m_epoch == p_state->m_epoch.load(std::memory_order_relaxed)
+            && first >= b.m_begin && last <= b.m_begin + b.m_size;
+    }
+
+    // Returns a block of the current thread holding the elements [i, i + n).
+    template <class CT>
+    inline auto xmemoized_expression<CT>::block(size_type i, size_type n) const -> const block_type&
+    {
+        auto& cache = detail::memoized_cache<value_type>();
+        const void* owner = p_state.get();
+        std::size_t first = static_cast<std::size_t>(i);
+        std::size_t last = first + static_cast<std::size_t>(n);
+        for (const block_type& b : cache.m_blocks)
+        {
+            if (holds(b, first, last))
+            {
+                return b;
+            }
+        }
+
+        // The values are computed before a block is picked, since the
+        // underlying expression may itself use memoized expressions.
+        std::size_t count = (std::min)(std::size_t(XTENSOR_MEMOIZE_BLOCK_SIZE), static_cast<std::size_t>(size()) - first);
+        std::array<value_type, XTENSOR_MEMOIZE_BLOCK_SIZE> values;
+        auto it = xt::linear_begin(p_state->m_e) + static_cast<difference_type>(first);
+        for (std::size_t k = 0; k < count; ++k, ++it)
+        {
+            values[k] = *it;
+        }
+
+        auto found = std::find_if(cache.m_blocks.begin(), cache.m_blocks.end(),
+                                  [owner](const block_type& b) { return b.p_owner == owner; });
+        if (found == cache.m_blocks.end())
+        {
+            found = cache.m_blocks.begin() + static_cast<std::ptrdiff_t>(cache.m_next);
+            cache.m_next = (cache.m_next + 1) % cache.m_blocks.size();
+        }
+        std::copy(values.cbegin(), values.cbegin() + static_cast<std::ptrdiff_t>(count), found->m_values.begin());
+        found->p_owner = owner;
+        found->m_epoch = p_state->m_epoch.load(std::memory_order_relaxed);
+        found->m_begin = first;
+        found->m_size = count;
+        ++(found->m_fill);
+        return *found;
+    }
+
+    /*************************************
+     * xmemoized_iterator implementation *
+     *************************************/
+
+    template <class CT>
+    inline xmemoized_iterator<CT>::xmemoized_iterator(const expression_type* e, size_type index) noexcept
+        : p_e(e), m_index(index), p_block(nullptr), m_fill(0), m_first(0), m_size(0)
+    {
+    }
+
+    template <class CT>
+    inline auto xmemoized_iterator<CT>::operator++() -> self_type&
+    {
+        ++m_index;
+        return *this;
+    }
+
+    template <class CT>
+    inline auto xmemoized_iterator<CT>::operator--() -> self_type&
+    {
+        --m_index;
+        return *this;
+    }
+
+    template <class CT>
+    inline auto xmemoized_iterator<CT>::operator+=(difference_type n) -> self_type&
+    {
+        m_index = static_cast<size_type>(static_cast<difference_type>(m_index) + n);
+        return *this;
+    }
+
+    template <class CT>
+    inline auto xmemoized_iterator<CT>::operator-=(difference_type n) -> self_type&
+    {
+        m_index = static_cast<size_type>(static_cast<difference_type>(m_index) - n);
+        return *this;
+    }
+
+    template <class CT>
+    inline auto xmemoized_iterator<CT>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(rhs.m_index);
+    }
+
+    // The block found last holds the following elements until it is
+    // filled again, which its fill count tells.
+    template <class CT>
+    inline auto xmemoized_iterator<CT>::operator*() const -> reference
+    {
+        std::size_t offset = static_cast<std::size_t>(m_index) - m_first;
+        if (p_block == nullptr || offset >= m_size || p_block->m_fill != m_fill)
+        {
+            p_block = &(p_e->block(m_index, size_type(1)));
+            m_fill = p_block->m_fill;
+            m_first = p_block->m_begin;
+            m_size = p_block->m_size;
+            offset = static_cast<std::size_t>(m_index) - m_first;
+        }
+        return p_block->m_values[offset];
+    }
+
+    template <class CT>
+    inline bool xmemoized_iterator<CT>::equal(const self_type& rhs) const
+    {
+        return p_e == rhs.p_e && m_index == rhs.m_index;
+    }
+
+    template <class CT>
+    inline bool xmemoized_iterator<CT>::less_than(const self_type& rhs) const
+    {
+        return p_e == rhs.p_e && m_index < rhs.m_index;
+    }
+
+    template <class CT>
+    inline bool operator==(const xmemoized_iterator<CT>& it1,
+                           const xmemoized_iterator<CT>& it2)
+    {
+        return it1.equal(it2);
+    }
+
+    template <class CT>
+    inline bool operator<(const xmemoized_iterator<CT>& it1,
+                          const xmemoized_iterator<CT>& it2)
+    {
+        return it1.less_than(it2);
+    }
+}
+
+#endif
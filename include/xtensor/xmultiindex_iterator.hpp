@@ -10,9 +10,15 @@
 #ifndef XTENSOR_XMULTIINDEX_ITERATOR
 #define XTENSOR_XMULTIINDEX_ITERATOR
 
-#include "xtl/xsequence.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 
+#include "xtl/xsequence.hpp"
 
+#include "xexecution.hpp"
 #include "xstrided_view.hpp"
 
 namespace xt
@@ -87,6 +93,11 @@ namespace xt
             return !this->operator==(rhs);
         }
 
+        std::size_t linear_index() const noexcept
+        {
+            return m_linear_index;
+        }
+
     private:
         shape_type m_begin;
         shape_type m_end;
@@ -130,6 +141,307 @@ namespace xt
         );
     }
 
+    /*********************
+     * xmultiindex_range *
+     *********************/
+
+    /**
+     * @class xmultiindex_range
+     * @brief Region of interest [roi_begin, roi_end) of a multi-index space.
+     *
+     * Besides the iterators over the indices of the region, in row-major
+     * order, the range provides loops that do not carry the index at
+     * every step: for_each_run calls a function once per run of the
+     * innermost dimension, with the index of the first element of the run
+     * and its length, and for_each calls a function per index of the
+     * innermost loop of these runs. Both loops can split the region among
+     * threads according to an execution policy, each thread unraveling
+     * the index of the first run it processes.
+     *
+     * With a std::array index type, e.g. for the shape of an xtensor<T, N>,
+     * the indices are never allocated.
+     *
+     * \code{.cpp}
+     * xt::xtensor<double, 3> a = ...;
+     * auto r = xt::make_multiindex_range(a.shape());
+     * r.for_each_run([&a](const std::array<std::size_t, 3>& idx, std::size_t n)
+     * {
+     *     double* p = &a.element(idx.cbegin(), idx.cend());
+     *     for (std::size_t k = 0; k < n; ++k) { p[k] += double(idx[0]); }
+     * }, xt::exec::par(pool));
+     * \endcode
+     *
+     * @tparam S the index type, e.g. std::vector<std::size_t> or
+     *           std::array<std::size_t, N>
+     */
+    template <class S>
+    class xmultiindex_range
+    {
+    public:
+
+        using shape_type = S;
+        using index_type = S;
+        using iterator = xmultiindex_iterator<S>;
+        using const_iterator = iterator;
+        using size_type = std::size_t;
+
+        template <class B, class E>
+        xmultiindex_range(const B& roi_begin, const E& roi_end);
+
+        size_type dimension() const noexcept;
+        size_type size() const noexcept;
+        size_type run_length() const noexcept;
+        size_type run_count() const noexcept;
+
+        iterator begin() const;
+        iterator end() const;
+        iterator iterator_at(size_type linear_index) const;
+
+        void unravel(size_type linear_index, index_type& index) const;
+
+        template <class F>
+        void for_each_run(F&& f) const;
+        template <class F, class P>
+        void for_each_run(F&& f, const P& policy) const;
+
+        template <class F>
+        void for_each(F&& f) const;
+        template <class F, class P>
+        void for_each(F&& f, const P& policy) const;
+
+    private:
+
+        void next_run(index_type& index) const;
+
+        template <class F>
+        void run_loop(size_type first, size_type last, F& f) const;
+
+        index_type m_begin;
+        index_type m_end;
+        size_type m_size;
+        size_type m_run_length;
+    };
+
+    /**
+     * Returns the range of the indices [roi_begin, roi_end).
+     */
+    template <class S, class B, class E>
+    inline xmultiindex_range<S> make_multiindex_range(const B& roi_begin, const E& roi_end)
+    {
+        return xmultiindex_range<S>(roi_begin, roi_end);
+    }
+
+    /**
+     * Returns the range of the indices of the specified shape, with a
+     * std::array index type for a fixed-size shape such as the shape of
+     * an xtensor<T, N>.
+     */
+    template <class S>
+    inline auto make_multiindex_range(const S& shape)
+    {
+        using index_type = xindex_type_t<S>;
+        index_type roi_begin = xtl::make_sequence<index_type>(shape.size(), 0);
+        return xmultiindex_range<index_type>(roi_begin, shape);
+    }
+
+    /************************************
+     * xmultiindex_range implementation *
+     ************************************/
+
+    template <class S>
+    template <class B, class E>
+    inline xmultiindex_range<S>::xmultiindex_range(const B& roi_begin, const E& roi_end)
+        : m_size(1), m_run_length(1)
+    {
+        resize_container(m_begin, roi_begin.size());
+        resize_container(m_end, roi_begin.size());
+        std::copy(roi_begin.begin(), roi_begin.end(), m_begin.begin());
+        std::copy(roi_end.begin(), roi_end.end(), m_end.begin());
+        for (size_type i = 0; i < m_begin.size(); ++i)
+        {
+            m_size *= static_cast<size_type>(m_end[i] - m_begin[i]);
+        }
+        if (!m_begin.empty())
+        {
+            m_run_length = static_cast<size_type>(m_end.back() - m_begin.back());
+        }
+    }
+
+    template <class S>
+    inline auto xmultiindex_range<S>::dimension() const noexcept -> size_type
+    {
+        return m_begin.size();
+    }
+
+    /**
+     * Returns the number of indices of the range.
+     */
+    template <class S>
+    inline auto xmultiindex_range<S>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the length of the runs of the innermost dimension.
+     */
+    template <class S>
+    inline auto xmultiindex_range<S>::run_length() const noexcept -> size_type
+    {
+        return m_run_length;
+    }
+
+    /**
+     * Returns the number of runs of the innermost dimension.
+     */
+    template <class S>
+    inline auto xmultiindex_range<S>::run_count() const noexcept -> size_type
+    {
+        return m_run_length == 0 ? 0 : m_size / m_run_length;
+    }
+
+    template <class S>
+    inline auto xmultiindex_range<S>::begin() const -> iterator
+    {
+        return multiindex_iterator_begin<S>(m_begin, m_end);
+    }
+
+    template <class S>
+    inline auto xmultiindex_range<S>::end() const -> iterator
+    {
+        return multiindex_iterator_end<S>(m_begin, m_end);
+    }
+
+    /**
+     * Returns an iterator on the index of the specified row-major position
+     * in the range, so that the range can be split in subranges.
+     */
+    template <class S>
+    inline auto xmultiindex_range<S>::iterator_at(size_type linear_index) const -> iterator
+    {
+        if (linear_index >= m_size)
+        {
+            return end();
+        }
+        index_type current = m_begin;
+        unravel(linear_index, current);
+        return iterator(m_begin, m_end, std::move(current), linear_index);
+    }
+
+    /**
+     * Computes the index of the specified row-major position in the range.
+     */
+    template <class S>
+    inline void xmultiindex_range<S>::unravel(size_type linear_index, index_type& index) const
+    {
+        for (size_type i = m_begin.size(); i != 0; --i)
+        {
+            size_type extent = static_cast<size_type>(m_end[i - 1] - m_begin[i - 1]);
+            index[i - 1] = m_begin[i - 1] + static_cast<typename index_type::value_type>(linear_index % extent);
+            linear_index /= extent;
+        }
+    }
+
+    /**
+     * Calls f(index, n) for every run of the innermost dimension, where
+     * index is the index of the first element of the run and n its length.
+     */
+    template <class S>
+    template <class F>
+    inline void xmultiindex_range<S>::for_each_run(F&& f) const
+    {
+        run_loop(0, run_count(), f);
+    }
+
+    /**
+     * Calls f(index, n) for every run of the innermost dimension, the runs
+     * being split among threads according to \c policy. f must be safe to
+     * call concurrently.
+     */
+    template <class S>
+    template <class F, class P>
+    inline void xmultiindex_range<S>::for_each_run(F&& f, const P& policy) const
+    {
+        policy.for_range(size_type(0), run_count(), size_type(1), [this, &f](size_type first, size_type last)
+        {
+            run_loop(first, last, f);
+        });
+    }
+
+    /**
+     * Calls f(index) for every index of the range, in row-major order.
+     */
+    template <class S>
+    template <class F>
+    inline void xmultiindex_range<S>::for_each(F&& f) const
+    {
+        for_each(std::forward<F>(f), exec::sequenced_policy());
+    }
+
+    /**
+     * Calls f(index) for every index of the range, the runs of the
+     * innermost dimension being split among threads according to
+     * \c policy. f must be safe to call concurrently.
+     */
+    template <class S>
+    template <class F, class P>
+    inline void xmultiindex_range<S>::for_each(F&& f, const P& policy) const
+    {
+        if (m_begin.empty())
+        {
+            if (m_size != 0)
+            {
+                f(static_cast<const index_type&>(m_begin));
+            }
+            return;
+        }
+        size_type last_dim = m_begin.size() - 1;
+        for_each_run([&f, last_dim](const index_type& run, size_type n)
+        {
+            index_type index = run;
+            for (size_type k = 0; k < n; ++k, ++index[last_dim])
+            {
+                f(static_cast<const index_type&>(index));
+            }
+        }, policy);
+    }
+
+    // Moves index to the first element of the next run
+    template <class S>
+    inline void xmultiindex_range<S>::next_run(index_type& index) const
+    {
+        size_type i = m_begin.size() == 0 ? 0 : m_begin.size() - 1;
+        while (i != 0)
+        {
+            --i;
+            if (index[i] + 1u == m_end[i])
+            {
+                index[i] = m_begin[i];
+            }
+            else
+            {
+                ++index[i];
+                break;
+            }
+        }
+    }
+
+    template <class S>
+    template <class F>
+    inline void xmultiindex_range<S>::run_loop(size_type first, size_type last, F& f) const
+    {
+        if (first >= last)
+        {
+            return;
+        }
+        index_type index = m_begin;
+        unravel(first * m_run_length, index);
+        for (size_type r = first; r < last; ++r)
+        {
+            f(static_cast<const index_type&>(index), m_run_length);
+            next_run(index);
+        }
+    }
 }
 
 #endif
@@ -77,6 +77,9 @@ namespace xt
         template <class E>
         A operator^=(const xexpression<E>&);
 
+        template <class E, class P>
+        A assign(const xexpression<E>& e, const P& policy);
+
     private:
 
         A m_array;
@@ -221,6 +224,17 @@ namespace xt
         return m_array.bit_xor_assign(e);
     }
 
+    /**
+     * Assigns \c e without temporary and distributes the work according
+     * to \c policy, e.g. <tt>noalias(a).assign(b + c, exec::par(pool))</tt>.
+     */
+    template <class A>
+    template <class E, class P>
+    inline A noalias_proxy<A>::assign(const xexpression<E>& e, const P& policy)
+    {
+        return m_array.assign(e, policy);
+    }
+
     template <class A>
     inline noalias_proxy<xtl::closure_type_t<A>>
     noalias(A&& a) noexcept
@@ -375,22 +375,273 @@ namespace xt
         using norm_value_type_t = typename norm_value_type<T>::type;
     }
 
-#define XTENSOR_EMPTY
-#define XTENSOR_COMMA ,
-#define XTENSOR_NORM_FUNCTION(NAME, RESULT_TYPE, REDUCE_EXPR, REDUCE_OP, MERGE_FUNC) \
+    namespace detail
+    {
+        /*****************
+         * norm reducers *
+         *****************/
+
+        // Element-wise parts of the norms. The batch overloads are used by
+        // the contiguous kernels when the result type is the value type.
+        struct norm_l0_op
+        {
+            template <class T>
+            auto operator()(const T& v) const noexcept
+            {
+                return norm_l0(v);
+            }
+        };
+
+        struct norm_l1_op
+        {
+            template <class T>
+            auto operator()(const T& v) const noexcept
+            {
+                return norm_l1(v);
+            }
+
+            template <class B>
+            B simd_apply(const B& b) const noexcept
+            {
+                return math::abs_fun().simd_apply(b);
+            }
+        };
+
+        struct norm_sq_op
+        {
+            template <class T>
+            auto operator()(const T& v) const noexcept
+            {
+                return norm_sq(v);
+            }
+
+            template <class B>
+            B simd_apply(const B& b) const noexcept
+            {
+                return b * b;
+            }
+        };
+
+        struct norm_linf_op
+        {
+            template <class T>
+            auto operator()(const T& v) const noexcept
+            {
+                return norm_linf(v);
+            }
+
+            template <class B>
+            B simd_apply(const B& b) const noexcept
+            {
+                return math::abs_fun().simd_apply(b);
+            }
+        };
+
+        struct norm_lp_to_p_op
+        {
+            double p;
+
+            template <class T>
+            auto operator()(const T& v) const noexcept
+            {
+                return norm_lp_to_p(v, p);
+            }
+
+            template <class B>
+            B simd_apply(const B& b) const noexcept
+            {
+                using value_type = typename B::value_type;
+                if (p == 0.)
+                {
+                    return xt_simd::select(b != B(value_type(0)), B(value_type(1)), B(value_type(0)));
+                }
+                if (p == 1.)
+                {
+                    return math::abs_fun().simd_apply(b);
+                }
+                if (p == 2.)
+                {
+                    return b * b;
+                }
+                return math::pow_fun().simd_apply(math::abs_fun().simd_apply(b), B(static_cast<value_type>(p)));
+            }
+        };
+    }
+    namespace detail
+    {
+        struct norm_plus
+        {
+            template <class T>
+            T operator()(const T& a, const T& b) const noexcept
+            {
+                return a + b;
+            }
+
+            template <class B>
+            B simd_apply(const B& a, const B& b) const noexcept
+            {
+                return a + b;
+            }
+        };
+
+        struct norm_max
+        {
+            template <class T>
+            T operator()(const T& a, const T& b) const noexcept
+            {
+                return (std::max)(a, b);
+            }
+
+            template <class B>
+            B simd_apply(const B& a, const B& b) const noexcept
+            {
+                return xt_simd::select(a < b, b, a);
+            }
+        };
+
+        template <class R, class V, class F>
+        struct use_simd_norm
+        {
+#if defined(XTENSOR_USE_XSIMD)
+            static constexpr bool value = std::is_same<R, V>::value &&
+                                          xt_simd::simd_traits<R>::size > 1 &&
+                                          has_simd_apply<F, xt_simd::simd_type<R>>::value;
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        template <class R, class V, class F, class C>
+        inline R norm_accumulate(const V* first, std::size_t size, R init, const F& f, const C& combine,
+                                 std::false_type /*use_simd*/)
+        {
+            R res = init;
+            std::size_t i = 0;
+#if defined(XTENSOR_USE_RUNTIME_DISPATCH)
+            // Independent lanes, which the compiler vectorizes for the
+            // dispatch target; the norms of the elements are non-negative,
+            // hence the zero start of the lanes.
+            constexpr std::size_t n_lanes = 16;
+            dispatch_kernel([&]()
+            {
+                R acc[n_lanes];
+                std::fill(acc, acc + n_lanes, R(0));
+                for (; i + n_lanes <= size; i += n_lanes)
+                {
+                    for (std::size_t j = 0; j < n_lanes; ++j)
+                    {
+                        acc[j] = combine(acc[j], static_cast<R>(f(first[i + j])));
+                    }
+                }
+                for (std::size_t j = 0; j < n_lanes; ++j)
+                {
+                    res = combine(res, acc[j]);
+                }
+            });
+#endif
+            for (; i < size; ++i)
+            {
+                res = combine(res, static_cast<R>(f(first[i])));
+            }
+            return res;
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class R, class V, class F, class C>
+        inline R norm_accumulate(const V* first, std::size_t size, R init, const F& f, const C& combine,
+                                 std::true_type /*use_simd*/)
+        {
+            using batch_type = xt_simd::simd_type<R>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            constexpr std::size_t n_acc = 4;
+            constexpr std::size_t step = n_acc * simd_size;
+
+            R res = init;
+            std::size_t i = 0;
+            if (size >= step)
+            {
+                batch_type acc[n_acc];
+                for (std::size_t k = 0; k < n_acc; ++k)
+                {
+                    acc[k] = batch_type(R(0));
+                }
+                for (; i + step <= size; i += step)
+                {
+                    for (std::size_t k = 0; k < n_acc; ++k)
+                    {
+                        batch_type b = xt_simd::load_as<R>(first + i + k * simd_size, unaligned_mode());
+                        acc[k] = combine.simd_apply(acc[k], f.simd_apply(b));
+                    }
+                }
+                batch_type acc_res = combine.simd_apply(combine.simd_apply(acc[0], acc[1]),
+                                                        combine.simd_apply(acc[2], acc[3]));
+                alignas(batch_type) R buffer[simd_size];
+                xt_simd::store_as(buffer, acc_res, aligned_mode());
+                for (std::size_t k = 0; k < simd_size; ++k)
+                {
+                    res = combine(res, buffer[k]);
+                }
+            }
+            for (; i < size; ++i)
+            {
+                res = combine(res, static_cast<R>(f(first[i])));
+            }
+            return res;
+        }
+#endif
+
+        /**
+         * Reduction functor of the norms: combines the result with the norm
+         * of each element. Contiguous ranges of arithmetic values are reduced
+         * by a dedicated kernel, in SIMD registers with xsimd and in
+         * independent lanes with the runtime dispatch, which can change the
+         * rounding of the sums.
+         */
+        template <class R, class F, class C>
+        class norm_reducer
+        {
+        public:
+
+            norm_reducer() = default;
+
+            explicit norm_reducer(const F& f)
+                : m_f(f)
+            {
+            }
+
+            template <class V>
+            R operator()(const R& r, const V& v) const
+            {
+                return C()(r, static_cast<R>(m_f(v)));
+            }
+
+            template <class It, XTL_REQUIRES(std::is_pointer<It>,
+                                             std::is_arithmetic<std::remove_cv_t<std::remove_pointer_t<It>>>,
+                                             std::is_arithmetic<R>)>
+            R accumulate(It first, It last, R init) const
+            {
+                using value_type = std::remove_cv_t<std::remove_pointer_t<It>>;
+                using use_simd = std::integral_constant<bool, use_simd_norm<R, value_type, F>::value>;
+                return norm_accumulate(first, static_cast<std::size_t>(last - first), init, m_f, C(), use_simd());
+            }
+
+        private:
+
+            F m_f;
+        };
+    }
+
+#define XTENSOR_NORM_FUNCTION(NAME, RESULT_TYPE, COMBINE, MERGE_FUNC)                 \
     template <class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,               \
               XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>                    \
     inline auto NAME(E&& e, X&& axes, EVS es = EVS()) noexcept                       \
     {                                                                                \
-        using value_type = typename std::decay_t<E>::value_type;                     \
         using result_type = detail::norm_value_type_t<RESULT_TYPE>;                  \
+        using reduce_type = detail::norm_reducer<result_type, detail::NAME##_op,     \
+                                                 detail::COMBINE>;                  \
                                                                                      \
-        auto reduce_func = [](result_type const& r, value_type const& v) {           \
-            return REDUCE_EXPR(r REDUCE_OP NAME(v));                                 \
-        };                                                                           \
-                                                                                     \
-        return xt::reduce(make_xreducer_functor(std::move(reduce_func),              \
-                                                const_value<result_type>(0),                    \
+        return xt::reduce(make_xreducer_functor(reduce_type(),                       \
+                                                const_value<result_type>(0),         \
                                                 MERGE_FUNC<result_type>()),          \
                       std::forward<E>(e), std::forward<X>(axes), es);                \
     }                                                                                \
@@ -403,13 +654,11 @@ namespace xt
     }                                                                                \
     XTENSOR_NORM_FUNCTION_AXES(NAME)
 
-    XTENSOR_NORM_FUNCTION(norm_l0, unsigned long long, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_l1, xtl::big_promote_type_t<value_type>, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_sq, xtl::big_promote_type_t<value_type>, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_linf, decltype(norm_linf(std::declval<value_type>())), (std::max<result_type>), XTENSOR_COMMA, math::maximum)
+    XTENSOR_NORM_FUNCTION(norm_l0, unsigned long long, norm_plus, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_l1, xtl::big_promote_type_t<typename std::decay_t<E>::value_type>, norm_plus, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_sq, xtl::big_promote_type_t<typename std::decay_t<E>::value_type>, norm_plus, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_linf, decltype(norm_linf(std::declval<typename std::decay_t<E>::value_type>())), norm_max, math::maximum)
 
-#undef XTENSOR_EMPTY
-#undef XTENSOR_COMMA
 #undef XTENSOR_NORM_FUNCTION
 #undef XTENSOR_NORM_FUNCTION_AXES
     /// @endcond
@@ -498,6 +747,54 @@ namespace xt
         return sqrt(norm_sq(std::forward<E>(e), xtl::forward_sequence<axes_type, decltype(axes)>(axes), es));
     }
 
+    /**
+     * @ingroup red_functions
+     * @brief Overflow-safe L2 norm of an array-like argument over given axes.
+     *
+     * Computes the same value as \ref norm_l2, but divides the elements by their
+     * largest magnitude along \em axes before squaring them, so that the
+     * intermediate sums neither overflow nor underflow. This costs a second pass
+     * over the data, and the result is always evaluated immediately.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the norm is computed (optional)
+     * @return an xcontainer holding the norm
+     */
+    template <class E, class X, XTL_REQUIRES(is_xexpression<E>, xtl::negation<is_reducer_options<X>>)>
+    inline auto norm_l2_scaled(E&& e, X&& axes)
+    {
+        const auto& de = e;
+        const auto& ax = axes;
+        auto scale = norm_linf(de, ax, keep_dims | evaluation_strategy::immediate);
+        using scale_type = typename decltype(scale)::value_type;
+        static_assert(std::is_floating_point<scale_type>::value,
+                      "norm_l2_scaled requires floating point or complex values");
+
+        decltype(scale) safe_scale = where(equal(scale, scale_type(0)) || isinf(scale), scale_type(1), scale);
+        auto res = norm_sq(de / safe_scale, ax, evaluation_strategy::immediate);
+
+        // The keep_dims layout only inserts unit axes, so both results share their linear order
+        using std::sqrt;
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            scale_type s = scale.data()[i];
+            res.data()[i] = (s == scale_type(0) || std::isinf(s)) ? s : s * sqrt(res.data()[i]);
+        }
+        return res;
+    }
+
+    template <class E, XTL_REQUIRES(is_xexpression<E>)>
+    inline auto norm_l2_scaled(E&& e)
+    {
+        return norm_l2_scaled(std::forward<E>(e), arange(e.dimension()));
+    }
+
+    template <class E, class I, std::size_t N>
+    inline auto norm_l2_scaled(E&& e, const I (&axes)[N])
+    {
+        using axes_type = std::array<typename std::decay_t<E>::size_type, N>;
+        return norm_l2_scaled(std::forward<E>(e), xtl::forward_sequence<axes_type, decltype(axes)>(axes));
+    }
+
     /**
      * @ingroup red_functions
      * @brief Infinity (maximum) norm of an array-like argument over given axes.
@@ -530,13 +827,10 @@ namespace xt
               XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
     inline auto norm_lp_to_p(E&& e, double p, X&& axes, EVS es = EVS()) noexcept
     {
-        using value_type = typename std::decay_t<E>::value_type;
         using result_type = norm_type_t<std::decay_t<E>>;
+        using reduce_type = detail::norm_reducer<result_type, detail::norm_lp_to_p_op, detail::norm_plus>;
 
-        auto reduce_func = [p](result_type const& r, value_type const& v) {
-            return r + norm_lp_to_p(v, p);
-        };
-        return xt::reduce(make_xreducer_functor(std::move(reduce_func), xt::const_value<result_type>(0), std::plus<result_type>()),
+        return xt::reduce(make_xreducer_functor(reduce_type(detail::norm_lp_to_p_op{p}), xt::const_value<result_type>(0), std::plus<result_type>()),
                       std::forward<E>(e), std::forward<X>(axes), es);
     }
 
@@ -18,29 +18,99 @@
 #include <xtl/xplatform.hpp>
 
 #include <algorithm>
+#include <array>
 #include <complex>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
-#include <regex>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define XTENSOR_NPY_HAS_MMAP
+#endif
+
+#if defined(XTENSOR_USE_IO_URING) && defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define XTENSOR_NPY_HAS_IO_URING
+#endif
+
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xeval.hpp"
+#include "xtensor/xgenerator.hpp"
+#include "xtensor/xslice.hpp"
+#include "xtensor/xstorage.hpp"
 #include "xtensor/xstrides.hpp"
+#include "xtensor/xutils.hpp"
 #include "xtensor_config.hpp"
 
 namespace xt
 {
     using namespace std::string_literals;
 
+    /**
+     * Access mode of a memory mapped npy file.
+     */
+    enum class npy_mmap_mode
+    {
+        /**
+         * The data is read-only, writing to it is undefined behavior.
+         */
+        read_only,
+        /**
+         * The data can be modified, the changes are private to the process
+         * and are not written to the file.
+         */
+        copy_on_write,
+        /**
+         * The changes are written to the file and shared with the other
+         * processes that map it.
+         */
+        read_write
+    };
+
+    /**
+     * Options of the positioned reads of npy files.
+     *
+     * When xtensor is built with XTENSOR_USE_IO_URING on Linux, up to
+     * queue_depth reads of chunk_size bytes are kept in flight with
+     * io_uring; otherwise, or if io_uring is not available at runtime,
+     * the reads are issued one at a time.
+     */
+    struct npy_read_options
+    {
+        /**
+         * Maximum number of reads in flight.
+         */
+        std::size_t queue_depth = 32;
+        /**
+         * Maximum size in bytes of a single read.
+         */
+        std::size_t chunk_size = std::size_t(1) << 20;
+        /**
+         * Bypass the page cache (O_DIRECT) when the file system supports
+         * it; the data is then read by aligned blocks through intermediate
+         * buffers.
+         */
+        bool direct = false;
+    };
+
     namespace detail
     {
 
@@ -82,112 +152,265 @@ namespace xt
             *v_minor = static_cast<unsigned char>(buf[magic_string_length + 1]);
         }
 
+        // Kind character of the npy typestring of T, '\0' if T has no npy type
+        template <class T>
+        constexpr char map_type() noexcept
+        {
+            return std::is_floating_point<T>::value ? 'f'
+                 : (std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                    std::is_same<T, short>::value || std::is_same<T, int>::value ||
+                    std::is_same<T, long>::value || std::is_same<T, long long>::value) ? 'i'
+                 : (std::is_same<T, unsigned char>::value || std::is_same<T, unsigned short>::value ||
+                    std::is_same<T, unsigned int>::value || std::is_same<T, unsigned long>::value ||
+                    std::is_same<T, unsigned long long>::value) ? 'u'
+                 : std::is_same<T, bool>::value ? 'b'
+                 : (std::is_same<T, std::complex<float>>::value || std::is_same<T, std::complex<double>>::value ||
+                    std::is_same<T, std::complex<long double>>::value) ? 'c'
+                 : '\0';
+        }
+
+        template <class T>
+        constexpr char get_endianess() noexcept
+        {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            return sizeof(T) <= sizeof(char) ? '|' : '>';
+#else
+            return sizeof(T) <= sizeof(char) ? '|' : '<';
+#endif
+        }
+
+        // Typestring of T, e.g. "<f8", built at compile time so that
+        // dumping and loading arrays do not format it
         template <class T>
-        inline char map_type()
+        struct npy_typestring
         {
-            if (std::is_same<T, float>::value) return 'f';
-            if (std::is_same<T, double>::value) return 'f';
-            if (std::is_same<T, long double>::value) return 'f';
+            static constexpr std::size_t size = sizeof(T);
+            static constexpr char value[5] = {
+                get_endianess<T>(),
+                map_type<T>(),
+                static_cast<char>('0' + (size >= 10 ? size / 10 : size)),
+                size >= 10 ? static_cast<char>('0' + size % 10) : '\0',
+                '\0'
+            };
+        };
+
+        template <class T>
+        constexpr char npy_typestring<T>::value[5];
 
-            if (std::is_same<T, char>::value) return 'i';
-            if (std::is_same<T, signed char>::value) return 'i';
-            if (std::is_same<T, short>::value) return 'i';
-            if (std::is_same<T, int>::value) return 'i';
-            if (std::is_same<T, long>::value) return 'i';
-            if (std::is_same<T, long long>::value) return 'i';
+        // Single pass parser of the header dictionary, which reads the
+        // characters of [m_first, m_last) in place
+        class npy_header_parser
+        {
+        public:
 
-            if (std::is_same<T, unsigned char>::value) return 'u';
-            if (std::is_same<T, unsigned short>::value) return 'u';
-            if (std::is_same<T, unsigned int>::value) return 'u';
-            if (std::is_same<T, unsigned long>::value) return 'u';
-            if (std::is_same<T, unsigned long long>::value) return 'u';
+            npy_header_parser(const char* first, const char* last) noexcept
+                : m_first(first), m_last(last)
+            {
+            }
 
-            if (std::is_same<T, bool>::value) return 'b';
+            void parse(std::string& descr, bool* fortran_order, std::vector<std::size_t>& shape);
 
-            if (std::is_same<T, std::complex<float>>::value) return 'c';
-            if (std::is_same<T, std::complex<double>>::value) return 'c';
-            if (std::is_same<T, std::complex<long double>>::value) return 'c';
+        private:
 
-            XTENSOR_THROW(std::runtime_error, "Type not known.");
-        }
+            void skip_spaces() noexcept;
+            bool consume(char c) noexcept;
+            void expect(char c, const char* message);
+            void parse_string(const char*& first, const char*& last);
+            void parse_descr(std::string& descr);
+            void parse_fortran_order(bool* fortran_order);
+            void parse_shape(std::vector<std::size_t>& shape);
 
-        template <class T>
-        inline char get_endianess()
-        {
-            constexpr char little_endian_char = '<';
-            constexpr char big_endian_char = '>';
-            constexpr char no_endian_char = '|';
+            const char* m_first;
+            const char* m_last;
+        };
 
-            if(sizeof(T) <= sizeof(char))
+        inline void npy_header_parser::skip_spaces() noexcept
+        {
+            while (m_first != m_last && (*m_first == ' ' || *m_first == '\t'))
             {
-                return no_endian_char;
+                ++m_first;
             }
+        }
 
-            switch(xtl::endianness())
+        inline bool npy_header_parser::consume(char c) noexcept
+        {
+            skip_spaces();
+            if (m_first != m_last && *m_first == c)
             {
-            case xtl::endian::little_endian:
-                return little_endian_char;
-            case xtl::endian::big_endian:
-                return big_endian_char;
-            default:
-                return no_endian_char;
+                ++m_first;
+                return true;
             }
+            return false;
         }
 
-        template <class T>
-        inline std::string build_typestring()
+        inline void npy_header_parser::expect(char c, const char* message)
         {
-            std::stringstream ss;
-            ss << get_endianess<T>() << map_type<T>() << sizeof(T);
-            return ss.str();
+            if (!consume(c))
+            {
+                XTENSOR_THROW(std::runtime_error, message);
+            }
         }
 
-        // Safety check function
-        inline void parse_typestring(std::string typestring)
+        // Quoted Python string, the bounds of its content are returned
+        inline void npy_header_parser::parse_string(const char*& first, const char*& last)
         {
-            std::regex re("'([<>|])([ifucb])(\\d+)'");
-            std::smatch sm;
+            skip_spaces();
+            if (m_first == m_last || (*m_first != '\'' && *m_first != '"'))
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid header");
+            }
+            char quote = *m_first++;
+            first = m_first;
+            while (m_first != m_last && *m_first != quote)
+            {
+                ++m_first;
+            }
+            if (m_first == m_last)
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid header");
+            }
+            last = m_first++;
+        }
 
-            std::regex_match(typestring, sm, re);
-            if (sm.size() != 4)
+        inline void npy_header_parser::parse_descr(std::string& descr)
+        {
+            const char* first;
+            const char* last;
+            parse_string(first, last);
+            bool valid = last - first >= 3
+                && (first[0] == '<' || first[0] == '>' || first[0] == '|')
+                && std::strchr("ifucb", first[1]) != nullptr && first[1] != '\0';
+            for (const char* it = first + 2; valid && it != last; ++it)
+            {
+                valid = *it >= '0' && *it <= '9';
+            }
+            if (!valid)
             {
                 XTENSOR_THROW(std::runtime_error, "invalid typestring");
             }
+            descr.assign(first, last);
         }
 
-        // Helpers for the improvised parser
-        inline std::string unwrap_s(std::string s, char delim_front, char delim_back)
+        inline void npy_header_parser::parse_fortran_order(bool* fortran_order)
         {
-            if ((s.back() == delim_back) && (s.front() == delim_front))
+            skip_spaces();
+            std::size_t remaining = static_cast<std::size_t>(m_last - m_first);
+            if (remaining >= 4 && std::memcmp(m_first, "True", 4) == 0)
+            {
+                *fortran_order = true;
+                m_first += 4;
+            }
+            else if (remaining >= 5 && std::memcmp(m_first, "False", 5) == 0)
             {
-                return s.substr(1, s.length() - 2);
+                *fortran_order = false;
+                m_first += 5;
             }
             else
             {
-                XTENSOR_THROW(std::runtime_error, "unable to unwrap");
+                XTENSOR_THROW(std::runtime_error, "invalid fortran_order value");
             }
         }
 
-        inline std::string get_value_from_map(std::string mapstr)
+        // Python tuple of integers: (), (x,), (x, y) or (x, y,)
+        inline void npy_header_parser::parse_shape(std::vector<std::size_t>& shape)
         {
-            std::size_t sep_pos = mapstr.find_first_of(":");
-            if (sep_pos == std::string::npos)
+            shape.clear();
+            expect('(', "invalid shape");
+            while (!consume(')'))
             {
-                return "";
+                skip_spaces();
+                if (m_first == m_last || *m_first < '0' || *m_first > '9')
+                {
+                    XTENSOR_THROW(std::runtime_error, "invalid shape");
+                }
+                std::size_t dim = 0;
+                while (m_first != m_last && *m_first >= '0' && *m_first <= '9')
+                {
+                    dim = dim * 10 + static_cast<std::size_t>(*m_first - '0');
+                    ++m_first;
+                }
+                // Python 2 long integers
+                if (m_first != m_last && *m_first == 'L')
+                {
+                    ++m_first;
+                }
+                shape.push_back(dim);
+                if (!consume(','))
+                {
+                    expect(')', "invalid shape");
+                    break;
+                }
             }
-
-            return mapstr.substr(sep_pos + 1);
         }
 
-        inline void pop_char(std::string& s, char c)
+        inline void npy_header_parser::parse(std::string& descr, bool* fortran_order,
+                                             std::vector<std::size_t>& shape)
         {
-            if (s.back() == c)
+            // remove trailing newline
+            if (m_first == m_last || *(m_last - 1) != '\n')
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid header");
+            }
+            --m_last;
+
+            expect('{', "invalid header");
+            bool has_descr = false;
+            bool has_fortran = false;
+            bool has_shape = false;
+            while (!consume('}'))
+            {
+                const char* key_first;
+                const char* key_last;
+                parse_string(key_first, key_last);
+                std::size_t key_size = static_cast<std::size_t>(key_last - key_first);
+                expect(':', "invalid header");
+                if (key_size == 5 && std::memcmp(key_first, "descr", 5) == 0)
+                {
+                    parse_descr(descr);
+                    has_descr = true;
+                }
+                else if (key_size == 13 && std::memcmp(key_first, "fortran_order", 13) == 0)
+                {
+                    parse_fortran_order(fortran_order);
+                    has_fortran = true;
+                }
+                else if (key_size == 5 && std::memcmp(key_first, "shape", 5) == 0)
+                {
+                    parse_shape(shape);
+                    has_shape = true;
+                }
+                else
+                {
+                    XTENSOR_THROW(std::runtime_error, "invalid header");
+                }
+                if (!consume(','))
+                {
+                    expect('}', "invalid header");
+                    break;
+                }
+            }
+            skip_spaces();
+            if (m_first != m_last)
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid header");
+            }
+
+            // make sure all the keys are present
+            if (!has_descr)
+            {
+                XTENSOR_THROW(std::runtime_error, "missing 'descr' key");
+            }
+            if (!has_fortran)
+            {
+                XTENSOR_THROW(std::runtime_error, "missing 'fortran_order' key");
+            }
+            if (!has_shape)
             {
-                s.pop_back();
+                XTENSOR_THROW(std::runtime_error, "missing 'shape' key");
             }
         }
 
-        inline void parse_header(std::string header, std::string& descr,
+        inline void parse_header(const std::string& header, std::string& descr,
                                  bool* fortran_order,
                                  std::vector<std::size_t>& shape)
         {
@@ -220,255 +443,128 @@ namespace xt
             // them to be written directly to disk for efficiency.
             // "shape" : tuple of int
             // The shape of the array.
-            // For repeatability and readability, this dictionary is formatted using
-            // pprint.pformat() so the keys are in alphabetic order.
-
-            // remove trailing newline
-            if (header.back() != '\n')
-            {
-                XTENSOR_THROW(std::runtime_error, "invalid header");
-            }
-            header.pop_back();
-
-            // remove all whitespaces
-            header.erase(std::remove(header.begin(), header.end(), ' '), header.end());
-
-            // unwrap dictionary
-            header = unwrap_s(header, '{', '}');
-
-            // find the positions of the 3 dictionary keys
-            std::size_t keypos_descr = header.find("'descr'");
-            std::size_t keypos_fortran = header.find("'fortran_order'");
-            std::size_t keypos_shape = header.find("'shape'");
-
-            // make sure all the keys are present
-            if (keypos_descr == std::string::npos)
-            {
-                XTENSOR_THROW(std::runtime_error, "missing 'descr' key");
-            }
-            if (keypos_fortran == std::string::npos)
-            {
-                XTENSOR_THROW(std::runtime_error, "missing 'fortran_order' key");
-            }
-            if (keypos_shape == std::string::npos)
-            {
-                XTENSOR_THROW(std::runtime_error, "missing 'shape' key");
-            }
-
-            // Make sure the keys are in order.
-            // Note that this violates the standard, which states that readers *must* not
-            // depend on the correct order here.
-            // TODO: fix
-            if (keypos_descr >= keypos_fortran || keypos_fortran >= keypos_shape)
-            {
-                XTENSOR_THROW(std::runtime_error, "header keys in wrong order");
-            }
-
-            // get the 3 key-value pairs
-            std::string keyvalue_descr;
-            keyvalue_descr = header.substr(keypos_descr, keypos_fortran - keypos_descr);
-            pop_char(keyvalue_descr, ',');
-
-            std::string keyvalue_fortran;
-            keyvalue_fortran = header.substr(keypos_fortran, keypos_shape - keypos_fortran);
-            pop_char(keyvalue_fortran, ',');
-
-            std::string keyvalue_shape;
-            keyvalue_shape = header.substr(keypos_shape, std::string::npos);
-            pop_char(keyvalue_shape, ',');
-
-            // get the values (right side of `:')
-            std::string descr_s = get_value_from_map(keyvalue_descr);
-            std::string fortran_s = get_value_from_map(keyvalue_fortran);
-            std::string shape_s = get_value_from_map(keyvalue_shape);
-
-            parse_typestring(descr_s);
-            descr = unwrap_s(descr_s, '\'', '\'');
+            // The keys may come in any order.
+            npy_header_parser parser(header.data(), header.data() + header.size());
+            parser.parse(descr, fortran_order, shape);
+        }
 
-            // convert literal Python bool to C++ bool
-            if (fortran_s == "True")
-            {
-                *fortran_order = true;
-            }
-            else if (fortran_s == "False")
-            {
-                *fortran_order = false;
-            }
-            else
+        inline void append_npy_integer(std::string& out, std::size_t value)
+        {
+            char buffer[24];
+            char* last = buffer + sizeof(buffer);
+            char* first = last;
+            do
             {
-                XTENSOR_THROW(std::runtime_error, "invalid fortran_order value");
-            }
-
-            // parse the shape Python tuple ( x, y, z,)
-
-            // first clear the vector
-            shape.clear();
-            shape_s = unwrap_s(shape_s, '(', ')');
+                *--first = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            out.append(first, last);
+        }
 
-            // a tokenizer would be nice...
-            std::size_t pos = 0;
-            for (;;)
+        template <class T>
+        inline std::string build_typestring()
+        {
+            if (map_type<T>() == '\0')
             {
-                std::size_t pos_next = shape_s.find_first_of(',', pos);
-                std::string dim_s;
-
-                if (pos_next != std::string::npos)
-                {
-                    dim_s = shape_s.substr(pos, pos_next - pos);
-                }
-                else
-                {
-                    dim_s = shape_s.substr(pos);
-                }
-
-                if (dim_s.length() == 0)
-                {
-                    if (pos_next != std::string::npos)
-                    {
-                        XTENSOR_THROW(std::runtime_error, "invalid shape");
-                    }
-                }
-                else
-                {
-                    std::stringstream ss;
-                    ss << dim_s;
-                    std::size_t tmp;
-                    ss >> tmp;
-                    shape.push_back(tmp);
-                }
-
-                if (pos_next != std::string::npos)
-                {
-                    pos = ++pos_next;
-                }
-                else
-                {
-                    break;
-                }
+                XTENSOR_THROW(std::runtime_error, "Type not known.");
             }
+            return std::string(npy_typestring<T>::value);
         }
 
+        // reserve is a number of extra spaces padding the header, so that it
+        // can be rewritten in place with a shape taking more characters.
+        // The magic string, the header length and the header are built in a
+        // single buffer and written at once.
         template <class O, class S>
         inline void write_header(O& out, const std::string& descr,
-                                 bool fortran_order, const S& shape)
+                                 bool fortran_order, const S& shape,
+                                 std::size_t reserve = 0)
         {
-            std::ostringstream ss_header;
-            std::string s_fortran_order;
-            if (fortran_order)
-            {
-                s_fortran_order = "True";
-            }
-            else
-            {
-                s_fortran_order = "False";
-            }
-
-            std::string s_shape;
-            std::ostringstream ss_shape;
-            ss_shape << "(";
-            for (auto shape_it = std::begin(shape); shape_it != std::end(shape); ++shape_it)
-            {
-                ss_shape << *shape_it << ", ";
-            }
-            s_shape = ss_shape.str();
-            if (xtl::sequence_size(shape) > 1)
-            {
-                s_shape = s_shape.erase(s_shape.size() - 2);
-            }
-            else if (xtl::sequence_size(shape) == 1)
+            std::string header;
+            header.reserve(128 + reserve);
+            header.append(magic_string, magic_string_length);
+            // version and header length, filled below
+            header.append(6, '\0');
+            std::size_t dict_first = header.size();
+
+            header += "{'descr': '";
+            header += descr;
+            header += "', 'fortran_order': ";
+            header += fortran_order ? "True" : "False";
+            header += ", 'shape': (";
+            std::size_t dim = xtl::sequence_size(shape);
+            std::size_t i = 0;
+            for (auto shape_it = std::begin(shape); shape_it != std::end(shape); ++shape_it, ++i)
             {
-                s_shape = s_shape.erase(s_shape.size() - 1);
+                append_npy_integer(header, static_cast<std::size_t>(*shape_it));
+                if (i + 1 != dim)
+                {
+                    header += ", ";
+                }
+                else if (dim == 1)
+                {
+                    header += ',';
+                }
             }
-            s_shape += ")";
+            header += "), }";
+            header.append(reserve, ' ');
 
-            ss_header << "{'descr': '" << descr
-                      << "', 'fortran_order': " << s_fortran_order
-                      << ", 'shape': " << s_shape << ", }";
-
-            std::size_t header_len_pre = ss_header.str().length() + 1;
+            std::size_t header_len_pre = header.size() - dict_first + 1;
             std::size_t metadata_len = magic_string_length + 2 + 2 + header_len_pre;
-
-            unsigned char version[2] = {1, 0};
+            std::size_t length_size = 2;
             if (metadata_len >= 255 * 255)
             {
                 metadata_len = magic_string_length + 2 + 4 + header_len_pre;
-                version[0] = 2;
-                version[1] = 0;
+                length_size = 4;
             }
             std::size_t padding_len = 64 - (metadata_len % 64);
-            std::string padding(padding_len, ' ');
-            ss_header << padding;
-            ss_header << std::endl;
-
-            std::string header = ss_header.str();
-
-            // write magic
-            write_magic(out, version[0], version[1]);
-
-            // write header length
-            if (version[0] == 1 && version[1] == 0)
-            {
-                char header_len_le16[2];
-                uint16_t header_len = uint16_t(header.length());
-
-                header_len_le16[0] = char((header_len >> 0) & 0xff);
-                header_len_le16[1] = char((header_len >> 8) & 0xff);
-                out.write(reinterpret_cast<char*>(header_len_le16), 2);
-            }
-            else
+            header.append(padding_len, ' ');
+            header += '\n';
+
+            // remove the unused bytes of the header length
+            header.erase(magic_string_length + 2 + length_size, 4 - length_size);
+            std::size_t header_length = header.size() - (magic_string_length + 2 + length_size);
+            header[magic_string_length] = char(length_size == 2 ? 1 : 2);
+            header[magic_string_length + 1] = char(0);
+            for (std::size_t k = 0; k < length_size; ++k)
             {
-                char header_len_le32[4];
-                uint32_t header_len = uint32_t(header.length());
-
-                header_len_le32[0] = char((header_len >> 0) & 0xff);
-                header_len_le32[1] = char((header_len >> 8) & 0xff);
-                header_len_le32[2] = char((header_len >> 16) & 0xff);
-                header_len_le32[3] = char((header_len >> 24) & 0xff);
-                out.write(reinterpret_cast<char*>(header_len_le32), 4);
+                header[magic_string_length + 2 + k] = char((header_length >> (8 * k)) & 0xff);
             }
-
-            out << header;
+            out.write(header.data(), static_cast<std::streamsize>(header.size()));
         }
 
-        inline std::string read_header_1_0(std::istream& istream)
+        inline std::string read_header_data(std::istream& istream, std::size_t length_size)
         {
             // read header length and convert from little endian
-            char header_len_le16[2];
-            istream.read(header_len_le16, 2);
-
-            uint16_t header_length = uint16_t(header_len_le16[0] << 0) | uint16_t(header_len_le16[1] << 8);
-
-            if ((magic_string_length + 2 + 2 + header_length) % 16 != 0)
+            unsigned char header_len_le[4] = {0, 0, 0, 0};
+            istream.read(reinterpret_cast<char*>(header_len_le), static_cast<std::streamsize>(length_size));
+            std::size_t header_length = 0;
+            for (std::size_t k = 0; k < length_size; ++k)
             {
-                // TODO: display warning
+                header_length |= std::size_t(header_len_le[k]) << (8 * k);
+            }
+            if (!istream)
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid header");
             }
 
-            std::unique_ptr<char[]> buf(new char[header_length]);
-            istream.read(buf.get(), header_length);
-            std::string header(buf.get(), header_length);
-
+            std::string header(header_length, '\0');
+            istream.read(&header[0], static_cast<std::streamsize>(header_length));
+            if (!istream)
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid header");
+            }
             return header;
         }
 
-        inline std::string read_header_2_0(std::istream& istream)
+        inline std::string read_header_1_0(std::istream& istream)
         {
-            // read header length and convert from little endian
-            char header_len_le32[4];
-            istream.read(header_len_le32, 4);
-
-            uint32_t header_length = uint32_t(header_len_le32[0] << 0) | uint32_t(header_len_le32[1] << 8) |
-                uint32_t(header_len_le32[2] << 16) | uint32_t(header_len_le32[3] << 24);
-
-            if ((magic_string_length + 2 + 4 + header_length) % 16 != 0)
-            {
-                // TODO: display warning
-            }
-
-            std::unique_ptr<char[]> buf(new char[header_length]);
-            istream.read(buf.get(), header_length);
-            std::string header(buf.get(), header_length);
+            return read_header_data(istream, 2);
+        }
 
-            return header;
+        inline std::string read_header_2_0(std::istream& istream)
+        {
+            return read_header_data(istream, 4);
         }
 
         struct npy_file
@@ -600,7 +696,10 @@ namespace xt
             char* m_buffer;
         };
 
-        inline npy_file load_npy_file(std::istream& stream)
+        // Reads the magic string and the header of a npy file, leaving the
+        // stream at the beginning of the data
+        inline void read_npy_header(std::istream& stream, std::string& typestr,
+                                    bool* fortran_order, std::vector<std::size_t>& shape)
         {
             // check magic bytes an version number
             unsigned char v_major, v_minor;
@@ -622,11 +721,16 @@ namespace xt
             }
 
             // parse header
+            detail::parse_header(header, typestr, fortran_order, shape);
+        }
+
+        inline npy_file load_npy_file(std::istream& stream)
+        {
             bool fortran_order;
             std::string typestr;
 
             std::vector<std::size_t> shape;
-            detail::parse_header(header, typestr, &fortran_order, shape);
+            detail::read_npy_header(stream, typestr, &fortran_order, shape);
 
             npy_file result(shape, fortran_order, typestr);
             // read the data
@@ -634,99 +738,1974 @@ namespace xt
             return result;
         }
 
-        template <class O, class E>
-        inline void dump_npy_stream(O& stream, const xexpression<E>& e)
+        // Memory mapping of a whole file, unmapped on destruction
+        class npy_mmap_region
         {
-            using value_type = typename E::value_type;
-            const E& ex = e.derived_cast();
-            auto&& eval_ex = eval(ex);
-            bool fortran_order = false;
-            if (eval_ex.layout() == layout_type::column_major && eval_ex.dimension() > 1)
-            {
-                fortran_order = true;
-            }
+        public:
 
-            std::string typestring = detail::build_typestring<value_type>();
+            npy_mmap_region(const std::string& filename, npy_mmap_mode mode);
+            ~npy_mmap_region();
 
-            auto shape = eval_ex.shape();
-            detail::write_header(stream, typestring, fortran_order, shape);
+            npy_mmap_region(const npy_mmap_region&) = delete;
+            npy_mmap_region& operator=(const npy_mmap_region&) = delete;
 
-            std::size_t size = compute_size(shape);
-            stream.write(reinterpret_cast<const char*>(eval_ex.data()),
-                         std::streamsize((sizeof(value_type) * size)));
-        }
-    }  // namespace detail
+            char* data() const noexcept;
+            std::size_t size() const noexcept;
 
+        private:
 
-    /**
-     * Save xexpression to NumPy npy format
-     *
-     * @param filename The filename or path to dump the data
-     * @param e the xexpression
-     */
-    template <typename E>
-    inline void dump_npy(const std::string& filename, const xexpression<E>& e)
-    {
-        std::ofstream stream(filename, std::ofstream::binary);
-        if (!stream)
+            void* m_addr;
+            std::size_t m_size;
+        };
+
+#if defined(XTENSOR_NPY_HAS_MMAP)
+        inline npy_mmap_region::npy_mmap_region(const std::string& filename, npy_mmap_mode mode)
+            : m_addr(nullptr), m_size(0)
         {
-            XTENSOR_THROW(std::runtime_error, "IO Error: failed to open file: "s + filename);
+            int fd = ::open(filename.c_str(), mode == npy_mmap_mode::read_write ? O_RDWR : O_RDONLY);
+            if (fd == -1)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+            }
+            struct stat st;
+            if (::fstat(fd, &st) == -1 || st.st_size <= 0)
+            {
+                ::close(fd);
+                XTENSOR_THROW(std::runtime_error, "io error: failed reading file");
+            }
+            m_size = static_cast<std::size_t>(st.st_size);
+            int prot = mode == npy_mmap_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = mode == npy_mmap_mode::read_write ? MAP_SHARED : MAP_PRIVATE;
+            void* addr = ::mmap(nullptr, m_size, prot, flags, fd, 0);
+            // The mapping stays valid once the file is closed
+            ::close(fd);
+            if (addr == MAP_FAILED)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to map file in memory");
+            }
+            m_addr = addr;
         }
 
-        detail::dump_npy_stream(stream, e);
-    }
+        inline npy_mmap_region::~npy_mmap_region()
+        {
+            ::munmap(m_addr, m_size);
+        }
 
-    /**
-     * Save xexpression to NumPy npy format in a string
+        inline void resize_npy_file(const std::string& filename, std::size_t size)
+        {
+            if (::truncate(filename.c_str(), static_cast<off_t>(size)) == -1)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to resize file: "s + filename);
+            }
+        }
+#else
+        inline npy_mmap_region::npy_mmap_region(const std::string& /*filename*/, npy_mmap_mode /*mode*/)
+            : m_addr(nullptr), m_size(0)
+        {
+            XTENSOR_THROW(std::runtime_error, "memory mapped npy files are not supported on this platform");
+        }
+
+        inline npy_mmap_region::~npy_mmap_region()
+        {
+        }
+
+        inline void resize_npy_file(const std::string& /*filename*/, std::size_t /*size*/)
+        {
+            XTENSOR_THROW(std::runtime_error, "memory mapped npy files are not supported on this platform");
+        }
+#endif
+
+#if defined(XTENSOR_NPY_HAS_IO_URING)
+        // Submission and completion queues of an io_uring instance, set up
+        // with the raw system calls so that no library is required. The
+        // caller is responsible for keeping at most entries() reads in
+        // flight.
+        class npy_io_uring
+        {
+        public:
+
+            explicit npy_io_uring(unsigned entries);
+            ~npy_io_uring();
+
+            npy_io_uring(const npy_io_uring&) = delete;
+            npy_io_uring& operator=(const npy_io_uring&) = delete;
+
+            bool valid() const noexcept;
+            std::size_t entries() const noexcept;
+
+            void push_read(int fd, char* data, std::size_t size, std::size_t offset, std::uint64_t tag);
+            bool submit(unsigned wait);
+            bool pop(std::uint64_t& tag, int& result);
+
+        private:
+
+            void release() noexcept;
+
+            int m_fd;
+            unsigned m_entries;
+            unsigned m_to_submit;
+            void* m_sq_ring;
+            std::size_t m_sq_ring_size;
+            void* m_cq_ring;
+            std::size_t m_cq_ring_size;
+            void* m_sqes;
+            std::size_t m_sqes_size;
+            unsigned* m_sq_tail;
+            unsigned* m_sq_mask;
+            unsigned* m_sq_array;
+            unsigned* m_cq_head;
+            unsigned* m_cq_tail;
+            unsigned* m_cq_mask;
+            io_uring_cqe* m_cqes;
+        };
+
+        inline npy_io_uring::npy_io_uring(unsigned entries)
+            : m_fd(-1), m_entries(0), m_to_submit(0),
+              m_sq_ring(MAP_FAILED), m_sq_ring_size(0),
+              m_cq_ring(MAP_FAILED), m_cq_ring_size(0),
+              m_sqes(MAP_FAILED), m_sqes_size(0),
+              m_sq_tail(nullptr), m_sq_mask(nullptr), m_sq_array(nullptr),
+              m_cq_head(nullptr), m_cq_tail(nullptr), m_cq_mask(nullptr), m_cqes(nullptr)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (m_fd < 0)
+            {
+                return;
+            }
+            m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single_mmap = false;
+#if defined(IORING_FEAT_SINGLE_MMAP)
+            single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+            if (single_mmap)
+            {
+                m_sq_ring_size = m_cq_ring_size = (std::max)(m_sq_ring_size, m_cq_ring_size);
+            }
+            m_sq_ring = ::mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               m_fd, IORING_OFF_SQ_RING);
+            m_cq_ring = single_mmap ? m_sq_ring
+                                    : ::mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+            m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = ::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            m_fd, IORING_OFF_SQES);
+            if (m_sq_ring == MAP_FAILED || m_cq_ring == MAP_FAILED || m_sqes == MAP_FAILED)
+            {
+                release();
+                return;
+            }
+            char* sq = static_cast<char*>(m_sq_ring);
+            char* cq = static_cast<char*>(m_cq_ring);
+            m_entries = params.sq_entries;
+            m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        inline npy_io_uring::~npy_io_uring()
+        {
+            release();
+        }
+
+        inline void npy_io_uring::release() noexcept
+        {
+            if (m_sqes != MAP_FAILED)
+            {
+                ::munmap(m_sqes, m_sqes_size);
+            }
+            if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+            {
+                ::munmap(m_cq_ring, m_cq_ring_size);
+            }
+            if (m_sq_ring != MAP_FAILED)
+            {
+                ::munmap(m_sq_ring, m_sq_ring_size);
+            }
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+            }
+            m_sqes = m_cq_ring = m_sq_ring = MAP_FAILED;
+            m_fd = -1;
+            m_entries = 0;
+        }
+
+        inline bool npy_io_uring::valid() const noexcept
+        {
+            return m_entries != 0;
+        }
+
+        inline std::size_t npy_io_uring::entries() const noexcept
+        {
+            return m_entries;
+        }
+
+        inline void npy_io_uring::push_read(int fd, char* data, std::size_t size, std::size_t offset,
+                                            std::uint64_t tag)
+        {
+            unsigned tail = *m_sq_tail;
+            unsigned index = tail & *m_sq_mask;
+            io_uring_sqe* sqe = static_cast<io_uring_sqe*>(m_sqes) + index;
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<std::uint64_t>(data);
+            sqe->len = static_cast<std::uint32_t>(size);
+            sqe->off = static_cast<std::uint64_t>(offset);
+            sqe->user_data = tag;
+            m_sq_array[index] = index;
+            __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            ++m_to_submit;
+        }
+
+        // Submits the pending reads and waits for at least wait completions
+        inline bool npy_io_uring::submit(unsigned wait)
+        {
+            do
+            {
+                long res = ::syscall(__NR_io_uring_enter, m_fd, m_to_submit, wait,
+                                     wait != 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+                if (res < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                m_to_submit -= static_cast<unsigned>(res);
+            } while (m_to_submit != 0);
+            return true;
+        }
+
+        inline bool npy_io_uring::pop(std::uint64_t& tag, int& result)
+        {
+            unsigned head = *m_cq_head;
+            if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+            {
+                return false;
+            }
+            const io_uring_cqe& cqe = m_cqes[head & *m_cq_mask];
+            tag = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+#endif
+
+        // Positioned reads of a file, queued with io_uring when available.
+        // The buffers given to read must stay valid until finish returns.
+        class npy_file_reader
+        {
+        public:
+
+            npy_file_reader(const std::string& filename, const npy_read_options& options);
+            ~npy_file_reader();
+
+            npy_file_reader(const npy_file_reader&) = delete;
+            npy_file_reader& operator=(const npy_file_reader&) = delete;
+
+            void read(char* data, std::size_t size, std::size_t offset);
+            void finish();
+
+        private:
+
+#if defined(XTENSOR_NPY_HAS_MMAP)
+            struct read_slot
+            {
+                char* data;
+                std::size_t size;
+                std::size_t offset;
+                std::size_t begin;
+                char* bounce;
+            };
+
+            static constexpr std::size_t direct_alignment = 4096;
+
+            char* allocate_bounce();
+            void read_chunk(char* data, std::size_t size, std::size_t offset);
+            void read_sync(char* data, std::size_t size, std::size_t offset);
+            void read_direct(read_slot& slot);
+            void complete(read_slot& slot, int result);
+
+            npy_read_options m_options;
+            int m_fd;
+            int m_direct_fd;
+            std::vector<char*> m_bounces;
+            read_slot m_sync_slot;
+#if defined(XTENSOR_NPY_HAS_IO_URING)
+            void wait_completions();
+            void drain() noexcept;
+
+            std::unique_ptr<npy_io_uring> m_ring;
+            std::vector<read_slot> m_slots;
+            std::vector<std::size_t> m_free_slots;
+#endif
+#else
+            std::ifstream m_stream;
+#endif
+        };
+
+#if defined(XTENSOR_NPY_HAS_MMAP)
+        inline npy_file_reader::npy_file_reader(const std::string& filename, const npy_read_options& options)
+            : m_options(options), m_fd(-1), m_direct_fd(-1), m_sync_slot{nullptr, 0, 0, 0, nullptr}
+        {
+            if (m_options.chunk_size == 0 || m_options.queue_depth == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "npy read options: chunk_size and queue_depth must be positive");
+            }
+            m_fd = ::open(filename.c_str(), O_RDONLY);
+            if (m_fd == -1)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+            }
+#if defined(O_DIRECT)
+            if (m_options.direct)
+            {
+                // File systems without O_DIRECT support fall back to buffered reads
+                m_direct_fd = ::open(filename.c_str(), O_RDONLY | O_DIRECT);
+            }
+#endif
+#if defined(XTENSOR_NPY_HAS_IO_URING)
+            if (m_options.queue_depth > 1)
+            {
+                m_ring = std::make_unique<npy_io_uring>(static_cast<unsigned>(m_options.queue_depth));
+                if (m_ring->valid())
+                {
+                    std::size_t depth = (std::min)(m_ring->entries(), m_options.queue_depth);
+                    m_slots.resize(depth, read_slot{nullptr, 0, 0, 0, nullptr});
+                    for (std::size_t i = depth; i-- > 0;)
+                    {
+                        m_free_slots.push_back(i);
+                    }
+                }
+                else
+                {
+                    m_ring.reset();
+                }
+            }
+#endif
+        }
+
+        inline npy_file_reader::~npy_file_reader()
+        {
+#if defined(XTENSOR_NPY_HAS_IO_URING)
+            drain();
+            m_ring.reset();
+#endif
+            for (char* bounce : m_bounces)
+            {
+                std::free(bounce);
+            }
+            if (m_direct_fd != -1)
+            {
+                ::close(m_direct_fd);
+            }
+            ::close(m_fd);
+        }
+
+        inline void npy_file_reader::read(char* data, std::size_t size, std::size_t offset)
+        {
+            while (size != 0)
+            {
+                std::size_t chunk = (std::min)(size, m_options.chunk_size);
+                read_chunk(data, chunk, offset);
+                data += chunk;
+                offset += chunk;
+                size -= chunk;
+            }
+        }
+
+        inline char* npy_file_reader::allocate_bounce()
+        {
+            void* bounce = nullptr;
+            std::size_t size = (m_options.chunk_size + 3 * direct_alignment - 1) / direct_alignment * direct_alignment;
+            if (::posix_memalign(&bounce, direct_alignment, size) != 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to allocate a read buffer.");
+            }
+            m_bounces.push_back(static_cast<char*>(bounce));
+            return static_cast<char*>(bounce);
+        }
+
+        inline void npy_file_reader::read_sync(char* data, std::size_t size, std::size_t offset)
+        {
+            while (size != 0)
+            {
+                ssize_t res = ::pread(m_fd, data, size, static_cast<off_t>(offset));
+                if (res < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (res <= 0)
+                {
+                    XTENSOR_THROW(std::runtime_error, "io error: failed reading file.");
+                }
+                std::size_t n = static_cast<std::size_t>(res);
+                data += n;
+                offset += n;
+                size -= n;
+            }
+        }
+
+        // Called once the aligned block of slot has been read in its bounce
+        // buffer, or has failed
+        inline void npy_file_reader::complete(read_slot& slot, int result)
+        {
+            if (slot.bounce != nullptr)
+            {
+                std::size_t skip = slot.offset - slot.begin;
+                if (result >= 0 && static_cast<std::size_t>(result) >= skip + slot.size)
+                {
+                    std::memcpy(slot.data, slot.bounce + skip, slot.size);
+                }
+                else
+                {
+                    read_sync(slot.data, slot.size, slot.offset);
+                }
+            }
+            else if (result < 0 || static_cast<std::size_t>(result) != slot.size)
+            {
+                // Short reads and failures are completed synchronously
+                std::size_t done = result > 0 ? static_cast<std::size_t>(result) : 0;
+                read_sync(slot.data + done, slot.size - done, slot.offset + done);
+            }
+        }
+
+        inline void npy_file_reader::read_direct(read_slot& slot)
+        {
+            std::size_t length = slot.offset + slot.size - slot.begin;
+            length = (length + direct_alignment - 1) / direct_alignment * direct_alignment;
+            int result = -1;
+            ssize_t res;
+            do
+            {
+                res = ::pread(m_direct_fd, slot.bounce, length, static_cast<off_t>(slot.begin));
+            } while (res < 0 && errno == EINTR);
+            if (res >= 0)
+            {
+                result = static_cast<int>(res);
+            }
+            complete(slot, result);
+        }
+
+#if defined(XTENSOR_NPY_HAS_IO_URING)
+        inline void npy_file_reader::read_chunk(char* data, std::size_t size, std::size_t offset)
+        {
+            if (!m_ring)
+            {
+                read_slot& slot = m_sync_slot;
+                slot = read_slot{data, size, offset, 0, nullptr};
+                if (m_direct_fd != -1)
+                {
+                    slot.begin = offset / direct_alignment * direct_alignment;
+                    slot.bounce = m_bounces.empty() ? allocate_bounce() : m_bounces.front();
+                    read_direct(slot);
+                }
+                else
+                {
+                    read_sync(data, size, offset);
+                }
+                return;
+            }
+            if (m_free_slots.empty())
+            {
+                wait_completions();
+            }
+            std::size_t index = m_free_slots.back();
+            m_free_slots.pop_back();
+            read_slot& slot = m_slots[index];
+            slot.data = data;
+            slot.size = size;
+            slot.offset = offset;
+            if (m_direct_fd != -1)
+            {
+                if (slot.bounce == nullptr)
+                {
+                    slot.bounce = allocate_bounce();
+                }
+                slot.begin = offset / direct_alignment * direct_alignment;
+                std::size_t length = offset + size - slot.begin;
+                length = (length + direct_alignment - 1) / direct_alignment * direct_alignment;
+                m_ring->push_read(m_direct_fd, slot.bounce, length, slot.begin, index);
+            }
+            else
+            {
+                m_ring->push_read(m_fd, data, size, offset, index);
+            }
+        }
+
+        inline void npy_file_reader::wait_completions()
+        {
+            if (!m_ring->submit(1))
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to submit reads.");
+            }
+            std::uint64_t tag;
+            int result;
+            while (m_ring->pop(tag, result))
+            {
+                read_slot& slot = m_slots[static_cast<std::size_t>(tag)];
+                m_free_slots.push_back(static_cast<std::size_t>(tag));
+                complete(slot, result);
+            }
+        }
+
+        inline void npy_file_reader::finish()
+        {
+            if (m_ring)
+            {
+                while (m_free_slots.size() != m_slots.size())
+                {
+                    wait_completions();
+                }
+            }
+        }
+
+        // Waits for the reads in flight without processing them, so that
+        // their buffers can be released
+        inline void npy_file_reader::drain() noexcept
+        {
+            if (m_ring)
+            {
+                std::size_t in_flight = m_slots.size() - m_free_slots.size();
+                std::uint64_t tag;
+                int result;
+                while (in_flight != 0 && m_ring->submit(1))
+                {
+                    while (m_ring->pop(tag, result))
+                    {
+                        m_free_slots.push_back(static_cast<std::size_t>(tag));
+                        --in_flight;
+                    }
+                }
+            }
+        }
+#else
+        inline void npy_file_reader::read_chunk(char* data, std::size_t size, std::size_t offset)
+        {
+            if (m_direct_fd != -1)
+            {
+                read_slot& slot = m_sync_slot;
+                slot = read_slot{data, size, offset, offset / direct_alignment * direct_alignment,
+                                 m_bounces.empty() ? allocate_bounce() : m_bounces.front()};
+                read_direct(slot);
+            }
+            else
+            {
+                read_sync(data, size, offset);
+            }
+        }
+
+        inline void npy_file_reader::finish()
+        {
+        }
+#endif
+#else
+        inline npy_file_reader::npy_file_reader(const std::string& filename, const npy_read_options&)
+            : m_stream(filename, std::ifstream::binary)
+        {
+            if (!m_stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+            }
+        }
+
+        inline npy_file_reader::~npy_file_reader()
+        {
+        }
+
+        inline void npy_file_reader::read(char* data, std::size_t size, std::size_t offset)
+        {
+            m_stream.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+            m_stream.read(data, static_cast<std::streamsize>(size));
+            if (!m_stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed reading file.");
+            }
+        }
+
+        inline void npy_file_reader::finish()
+        {
+        }
+#endif
+
+        // Positioned reads of an input stream, with the interface of
+        // npy_file_reader
+        class npy_stream_reader
+        {
+        public:
+
+            explicit npy_stream_reader(std::istream& stream)
+                : m_stream(stream)
+            {
+            }
+
+            void read(char* data, std::size_t size, std::size_t offset)
+            {
+                m_stream.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+                m_stream.read(data, static_cast<std::streamsize>(size));
+                if (!m_stream)
+                {
+                    XTENSOR_THROW(std::runtime_error, "io error: failed reading file.");
+                }
+            }
+
+            void finish()
+            {
+            }
+
+        private:
+
+            std::istream& m_stream;
+        };
+
+        inline char* npy_mmap_region::data() const noexcept
+        {
+            return static_cast<char*>(m_addr);
+        }
+
+        inline std::size_t npy_mmap_region::size() const noexcept
+        {
+            return m_size;
+        }
+
+        // Adaptor on the data of a mapped npy file, starting at offset
+        template <class T, layout_type L, class S>
+        inline auto adapt_npy_region(std::shared_ptr<npy_mmap_region> region, std::size_t offset,
+                                     const S& shape, layout_type l)
+        {
+            if (region->size() < offset + compute_size(shape) * sizeof(T))
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed reading file");
+            }
+            if (offset % alignof(T) != 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "npy data is not aligned for memory mapping");
+            }
+            T* ptr = reinterpret_cast<T*>(region->data() + offset);
+            return adapt_smart_ptr<L>(std::move(ptr), shape, std::move(region), l);
+        }
+
+        template <class T, layout_type L>
+        inline void check_npy_cast(const std::string& typestr, bool fortran_order)
+        {
+            if (typestr != detail::build_typestring<T>())
+            {
+                XTENSOR_THROW(std::runtime_error,
+                              "Cast error: formats not matching "s + typestr +
+                              " vs "s + detail::build_typestring<T>());
+            }
+            if ((L == layout_type::column_major && !fortran_order) ||
+                (L == layout_type::row_major && fortran_order))
+            {
+                XTENSOR_THROW(std::runtime_error, "Cast error: layout mismatch between npy file and requested layout.");
+            }
+        }
+
+        template <std::size_t N>
+        struct npy_bits_type;
+
+        template <>
+        struct npy_bits_type<1>
+        {
+            using type = std::uint8_t;
+        };
+
+        template <>
+        struct npy_bits_type<2>
+        {
+            using type = std::uint16_t;
+        };
+
+        template <>
+        struct npy_bits_type<4>
+        {
+            using type = std::uint32_t;
+        };
+
+        template <>
+        struct npy_bits_type<8>
+        {
+            using type = std::uint64_t;
+        };
+
+        inline std::uint8_t npy_byteswap(std::uint8_t v) noexcept
+        {
+            return v;
+        }
+
+        inline std::uint16_t npy_byteswap(std::uint16_t v) noexcept
+        {
+            return static_cast<std::uint16_t>((v >> 8) | (v << 8));
+        }
+
+        inline std::uint32_t npy_byteswap(std::uint32_t v) noexcept
+        {
+            v = ((v & 0x00ff00ffu) << 8) | ((v >> 8) & 0x00ff00ffu);
+            return (v << 16) | (v >> 16);
+        }
+
+        inline std::uint64_t npy_byteswap(std::uint64_t v) noexcept
+        {
+            v = ((v & 0x00ff00ff00ff00ffull) << 8) | ((v >> 8) & 0x00ff00ff00ff00ffull);
+            v = ((v & 0x0000ffff0000ffffull) << 16) | ((v >> 16) & 0x0000ffff0000ffffull);
+            return (v << 32) | (v >> 32);
+        }
+
+        // Number of elements converted at once when reading npy data of
+        // another type, small enough for the raw data to stay in cache
+        constexpr std::size_t npy_convert_block = std::size_t(1) << 13;
+
+        // Converts n elements of type S, stored byte swapped if Swap, to T.
+        // The loops have no branch so that they are vectorized.
+        template <class S, bool Swap, class T>
+        inline void convert_npy_block(const char* in, T* out, std::size_t n)
+        {
+            using bits_type = typename npy_bits_type<sizeof(S)>::type;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                bits_type bits;
+                std::memcpy(&bits, in + i * sizeof(S), sizeof(S));
+                if (Swap)
+                {
+                    bits = npy_byteswap(bits);
+                }
+                S v;
+                std::memcpy(&v, &bits, sizeof(S));
+                out[i] = static_cast<T>(v);
+            }
+        }
+
+        // Reads n elements of type S from stream into out, converting them
+        // block by block
+        template <class S, class T>
+        inline void read_npy_converted(std::istream& stream, T* out, std::size_t n, bool swap)
+        {
+            if (std::is_same<S, T>::value && !swap)
+            {
+                stream.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(n * sizeof(T)));
+            }
+            else
+            {
+                uvector<char> raw(sizeof(S) * (std::min)(n, npy_convert_block));
+                for (std::size_t i = 0; i < n && stream; i += npy_convert_block)
+                {
+                    std::size_t m = (std::min)(n - i, npy_convert_block);
+                    stream.read(raw.data(), static_cast<std::streamsize>(m * sizeof(S)));
+                    if (swap)
+                    {
+                        convert_npy_block<S, true>(raw.data(), out + i, m);
+                    }
+                    else
+                    {
+                        convert_npy_block<S, false>(raw.data(), out + i, m);
+                    }
+                }
+            }
+            if (!stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed reading file");
+            }
+        }
+
+        // Reads n elements described by typestr, i.e. byte order, kind and
+        // size, into out
+        template <class T>
+        inline void read_npy_as(std::istream& stream, const std::string& typestr, T* out, std::size_t n)
+        {
+            if (typestr.size() < 3)
+            {
+                XTENSOR_THROW(std::runtime_error, "invalid typestring");
+            }
+            char order = typestr[0];
+            char kind = typestr[1];
+            std::string size = typestr.substr(2);
+            bool little = xtl::endianness() == xtl::endian::little_endian;
+            bool swap = (order == '<' && !little) || (order == '>' && little);
+            if (kind == 'f' && size == "4")
+            {
+                read_npy_converted<float>(stream, out, n, swap);
+            }
+            else if (kind == 'f' && size == "8")
+            {
+                read_npy_converted<double>(stream, out, n, swap);
+            }
+            else if (kind == 'i' && size == "1")
+            {
+                read_npy_converted<std::int8_t>(stream, out, n, swap);
+            }
+            else if (kind == 'i' && size == "2")
+            {
+                read_npy_converted<std::int16_t>(stream, out, n, swap);
+            }
+            else if (kind == 'i' && size == "4")
+            {
+                read_npy_converted<std::int32_t>(stream, out, n, swap);
+            }
+            else if (kind == 'i' && size == "8")
+            {
+                read_npy_converted<std::int64_t>(stream, out, n, swap);
+            }
+            else if ((kind == 'u' || kind == 'b') && size == "1")
+            {
+                read_npy_converted<std::uint8_t>(stream, out, n, swap);
+            }
+            else if (kind == 'u' && size == "2")
+            {
+                read_npy_converted<std::uint16_t>(stream, out, n, swap);
+            }
+            else if (kind == 'u' && size == "4")
+            {
+                read_npy_converted<std::uint32_t>(stream, out, n, swap);
+            }
+            else if (kind == 'u' && size == "8")
+            {
+                read_npy_converted<std::uint64_t>(stream, out, n, swap);
+            }
+            else
+            {
+                XTENSOR_THROW(std::runtime_error, "Cast error: unsupported conversion from "s + typestr);
+            }
+        }
+
+        // Stands for an expression of the shape of a npy file when getting
+        // the implementation of the slices
+        struct npy_shape_holder
+        {
+            using size_type = std::size_t;
+
+            const std::vector<std::size_t>& shape() const noexcept
+            {
+                return m_shape;
+            }
+
+            std::size_t shape(std::size_t i) const noexcept
+            {
+                return m_shape[i];
+            }
+
+            const std::vector<std::size_t>& m_shape;
+        };
+
+        // Indices selected along an axis of a npy file, squeeze being set
+        // when the axis is selected by an integer
+        struct npy_axis_selection
+        {
+            std::vector<std::size_t> index;
+            bool squeeze = false;
+        };
+
+        template <class SL>
+        inline std::enable_if_t<xtl::is_integral<SL>::value>
+        select_npy_axis(const SL& slice, std::size_t size, npy_axis_selection& sel)
+        {
+            if (slice < SL(0) || static_cast<std::size_t>(slice) >= size)
+            {
+                XTENSOR_THROW(std::out_of_range, "Index out of bounds in the slice of a npy file.");
+            }
+            sel.index.assign(1, static_cast<std::size_t>(slice));
+            sel.squeeze = true;
+        }
+
+        template <class SL>
+        inline std::enable_if_t<!xtl::is_integral<SL>::value>
+        select_npy_axis(const SL& slice, std::size_t, npy_axis_selection& sel)
+        {
+            static_assert(!std::is_same<SL, xnewaxis<std::size_t>>::value, "newaxis cannot be used to slice a npy file");
+            using slice_size_type = typename SL::size_type;
+            sel.index.resize(static_cast<std::size_t>(slice.size()));
+            for (std::size_t i = 0; i < sel.index.size(); ++i)
+            {
+                sel.index[i] = static_cast<std::size_t>(slice(static_cast<slice_size_type>(i)));
+            }
+        }
+
+        inline void select_npy_axes(const npy_shape_holder& holder, std::size_t axis,
+                                    std::vector<npy_axis_selection>& sel)
+        {
+            for (; axis < sel.size(); ++axis)
+            {
+                sel[axis].index.resize(holder.shape(axis));
+                std::iota(sel[axis].index.begin(), sel[axis].index.end(), std::size_t(0));
+            }
+        }
+
+        template <class SL, class... S>
+        inline void select_npy_axes(const npy_shape_holder& holder, std::size_t axis,
+                                    std::vector<npy_axis_selection>& sel, SL&& slice, S&&... slices)
+        {
+            auto impl = get_slice_implementation(holder, std::forward<SL>(slice), axis);
+            select_npy_axis(impl, holder.shape(axis), sel[axis]);
+            select_npy_axes(holder, axis + 1, sel, std::forward<S>(slices)...);
+        }
+
+        // Reads the elements selected by sel from the data of a npy file,
+        // which starts at offset in the file read by reader. The innermost
+        // axes of the file whose selection is contiguous are read with a
+        // single read per block, the others by iterating over their selected
+        // indices.
+        template <class T, class R>
+        inline uvector<T> read_npy_selection(R& reader, std::size_t offset,
+                                             const std::vector<std::size_t>& shape, bool fortran_order,
+                                             const std::vector<npy_axis_selection>& sel)
+        {
+            std::size_t dim = shape.size();
+            // Axes in the order of the storage, the last one being contiguous
+            std::vector<std::size_t> axes(dim);
+            std::iota(axes.begin(), axes.end(), std::size_t(0));
+            if (fortran_order)
+            {
+                std::reverse(axes.begin(), axes.end());
+            }
+            std::vector<std::size_t> strides(dim);
+            std::size_t size = 1;
+            for (std::size_t k = dim; k-- > 0;)
+            {
+                strides[k] = size;
+                size *= shape[axes[k]];
+            }
+            std::size_t result_size = 1;
+            for (const auto& s : sel)
+            {
+                result_size *= s.index.size();
+            }
+            uvector<T> result(result_size);
+            if (result_size == 0)
+            {
+                return result;
+            }
+
+            // The block is made of the full innermost axes, and of the run of
+            // consecutive indices of the next axis
+            std::size_t block = 1;
+            std::size_t n_outer = dim;
+            while (n_outer > 0)
+            {
+                const auto& index = sel[axes[n_outer - 1]].index;
+                std::size_t n = index.size();
+                bool consecutive = index.back() - index.front() + 1 == n &&
+                                   std::is_sorted(index.cbegin(), index.cend());
+                if (!consecutive)
+                {
+                    break;
+                }
+                block *= n;
+                --n_outer;
+                if (n != shape[axes[n_outer]])
+                {
+                    break;
+                }
+            }
+            std::size_t base = 0;
+            for (std::size_t k = n_outer; k < dim; ++k)
+            {
+                base += sel[axes[k]].index.front() * strides[k];
+            }
+
+            std::vector<std::size_t> counter(n_outer, 0);
+            T* out = result.data();
+            for (std::size_t done = 0; done < result_size; done += block)
+            {
+                std::size_t position = base;
+                for (std::size_t k = 0; k < n_outer; ++k)
+                {
+                    position += sel[axes[k]].index[counter[k]] * strides[k];
+                }
+                reader.read(reinterpret_cast<char*>(out), block * sizeof(T), offset + position * sizeof(T));
+                out += block;
+                for (std::size_t k = n_outer; k-- > 0;)
+                {
+                    if (++counter[k] != sel[axes[k]].index.size())
+                    {
+                        break;
+                    }
+                    counter[k] = 0;
+                }
+            }
+            reader.finish();
+            return result;
+        }
+
+        template <class... S>
+        struct is_npy_read_options : std::false_type
+        {
+        };
+
+        template <class S, class... R>
+        struct is_npy_read_options<S, R...> : std::is_same<std::decay_t<S>, npy_read_options>
+        {
+        };
+
+        // Reads the header of the npy file from stream, and the elements
+        // selected by slices with reader
+        template <class T, layout_type L, class R, class... S>
+        inline auto load_npy_slice_impl(std::istream& stream, R& reader, S&&... slices)
+        {
+            bool fortran_order;
+            std::string typestr;
+            std::vector<std::size_t> shape;
+            detail::read_npy_header(stream, typestr, &fortran_order, shape);
+            std::size_t offset = static_cast<std::size_t>(stream.tellg());
+            detail::check_npy_cast<T, L>(typestr, fortran_order);
+            if (sizeof...(S) > shape.size())
+            {
+                XTENSOR_THROW(std::runtime_error, "Too many slices for the dimension of the npy file.");
+            }
+
+            std::vector<detail::npy_axis_selection> sel(shape.size());
+            detail::select_npy_axes(detail::npy_shape_holder{shape}, 0, sel, std::forward<S>(slices)...);
+            auto data = detail::read_npy_selection<T>(reader, offset, shape, fortran_order, sel);
+
+            std::vector<std::size_t> result_shape;
+            for (const auto& s : sel)
+            {
+                if (!s.squeeze)
+                {
+                    result_shape.push_back(s.index.size());
+                }
+            }
+            layout_type l = fortran_order ? layout_type::column_major : layout_type::row_major;
+            return adapt<L>(std::move(data), result_shape, l);
+        }
+
+        // Size in bytes under which contiguous runs of a strided expression
+        // are gathered before being written
+        constexpr std::size_t npy_write_chunk_size = std::size_t(1) << 16;
+
+        template <class E>
+        using npy_strided_expression = xtl::conjunction<has_data_interface<E>, has_strides<E>>;
+
+        template <class E>
+        inline bool is_npy_contiguous(const E& e, std::true_type)
+        {
+            return e.layout() == layout_type::row_major || e.layout() == layout_type::column_major;
+        }
+
+        template <class E>
+        inline bool is_npy_contiguous(const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class O, class T>
+        inline void write_npy_values(O& stream, const T* data, std::size_t size)
+        {
+            stream.write(reinterpret_cast<const char*>(data), std::streamsize(sizeof(T) * size));
+        }
+
+        // Writes a strided expression in row major order, enumerating the
+        // contiguous runs of its underlying buffer instead of evaluating it.
+        // Runs long enough are written directly, shorter ones are gathered
+        // in a bounded staging buffer.
+        template <class O, class E>
+        inline void write_npy_runs(O& stream, const E& e)
+        {
+            using value_type = typename E::value_type;
+            const auto& shape = e.shape();
+            const auto& strides = e.strides();
+            std::size_t dim = shape.size();
+            std::size_t size = compute_size(shape);
+            if (size == 0)
+            {
+                return;
+            }
+
+            std::size_t run = 1;
+            std::size_t n_outer = dim;
+            while (n_outer > 0 && (shape[n_outer - 1] == 1
+                   || static_cast<std::ptrdiff_t>(strides[n_outer - 1]) == static_cast<std::ptrdiff_t>(run)))
+            {
+                run *= static_cast<std::size_t>(shape[n_outer - 1]);
+                --n_outer;
+            }
+
+            const value_type* base = e.data() + e.data_offset();
+            bool direct = run * sizeof(value_type) >= npy_write_chunk_size;
+            std::size_t capacity = direct ? 0 : (std::max)(npy_write_chunk_size / sizeof(value_type) / run, std::size_t(1)) * run;
+            uvector<value_type> staging(capacity);
+            std::size_t staged = 0;
+            std::vector<std::size_t> counter(n_outer, 0);
+            for (std::size_t done = 0; done < size; done += run)
+            {
+                std::ptrdiff_t position = 0;
+                for (std::size_t k = 0; k < n_outer; ++k)
+                {
+                    position += static_cast<std::ptrdiff_t>(counter[k]) * static_cast<std::ptrdiff_t>(strides[k]);
+                }
+                if (direct)
+                {
+                    write_npy_values(stream, base + position, run);
+                }
+                else
+                {
+                    std::copy(base + position, base + position + static_cast<std::ptrdiff_t>(run), staging.begin() + static_cast<std::ptrdiff_t>(staged));
+                    staged += run;
+                    if (staged == capacity)
+                    {
+                        write_npy_values(stream, staging.data(), staged);
+                        staged = 0;
+                    }
+                }
+                for (std::size_t k = n_outer; k-- > 0;)
+                {
+                    if (++counter[k] != static_cast<std::size_t>(shape[k]))
+                    {
+                        break;
+                    }
+                    counter[k] = 0;
+                }
+            }
+            if (staged != 0)
+            {
+                write_npy_values(stream, staging.data(), staged);
+            }
+        }
+
+        template <class O, class E>
+        inline void dump_npy_data(O& stream, const E& e, std::true_type)
+        {
+            using value_type = typename E::value_type;
+            std::string typestring = detail::build_typestring<value_type>();
+            if (is_npy_contiguous(e, std::true_type()))
+            {
+                bool fortran_order = e.layout() == layout_type::column_major && e.dimension() > 1;
+                detail::write_header(stream, typestring, fortran_order, e.shape());
+                write_npy_values(stream, e.data() + e.data_offset(), compute_size(e.shape()));
+            }
+            else
+            {
+                detail::write_header(stream, typestring, false, e.shape());
+                write_npy_runs(stream, e);
+            }
+        }
+
+        template <class O, class E>
+        inline void dump_npy_data(O& stream, const E& e, std::false_type)
+        {
+            auto&& eval_ex = eval(e);
+            dump_npy_data(stream, eval_ex, std::true_type());
+        }
+
+        template <class O, class E>
+        inline void dump_npy_stream(O& stream, const xexpression<E>& e)
+        {
+            dump_npy_data(stream, e.derived_cast(), npy_strided_expression<E>());
+        }
+    }  // namespace detail
+
+
+    /**
+     * Save xexpression to NumPy npy format
+     *
+     * @param filename The filename or path to dump the data
+     * @param e the xexpression
+     */
+    template <typename E>
+    inline void dump_npy(const std::string& filename, const xexpression<E>& e)
+    {
+        std::ofstream stream(filename, std::ofstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "IO Error: failed to open file: "s + filename);
+        }
+
+        detail::dump_npy_stream(stream, e);
+    }
+
+    /**
+     * Save xexpression to NumPy npy format in a string
+     *
+     * @param e the xexpression
+     */
+    template <typename E>
+    inline std::string dump_npy(const xexpression<E>& e)
+    {
+        std::stringstream stream;
+        detail::dump_npy_stream(stream, e);
+        return stream.str();
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format)
+     *
+     * @param stream An input stream from which to load the file
+     * @tparam T select the type of the npy file (note: currently there is
+     *           no dynamic casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray with contents from npy file
+     */
+    template <typename T, layout_type L = layout_type::dynamic>
+    inline auto load_npy(std::istream& stream)
+    {
+        detail::npy_file file = detail::load_npy_file(stream);
+        return std::move(file).cast<T, L>();
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format)
+     *
+     * @param filename The filename or path to the file
+     * @tparam T select the type of the npy file (note: currently there is
+     *           no dynamic casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray with contents from npy file
+     */
+    template <typename T, layout_type L = layout_type::dynamic>
+    inline auto load_npy(const std::string& filename)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        return load_npy<T, L>(stream);
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format)
+     *
+     * The data of the file is read with the positioned reads described by
+     * \c options: with the io_uring backend, several chunks are read in
+     * parallel, which is needed to reach the bandwidth of fast storage.
+     *
+     * @param filename The filename or path to the file
+     * @param options The options of the reads
+     * @tparam T select the type of the npy file (note: currently there is
+     *           no dynamic casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray with contents from npy file
+     */
+    template <typename T, layout_type L = layout_type::dynamic>
+    inline auto load_npy(const std::string& filename, const npy_read_options& options)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, &fortran_order, shape);
+        std::size_t offset = static_cast<std::size_t>(stream.tellg());
+        stream.close();
+
+        detail::npy_file file(shape, fortran_order, typestr);
+        detail::npy_file_reader reader(filename, options);
+        reader.read(file.ptr(), file.n_bytes(), offset);
+        reader.finish();
+        return std::move(file).cast<T, L>();
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format), converting its data
+     *
+     * Unlike load_npy, the data of the file can be of any byte order and
+     * of any real, integer or boolean type: it is converted to \c T during
+     * the read, by blocks, without intermediate copy of the whole array.
+     *
+     * @param stream An input stream from which to load the file
+     * @tparam T the value type of the returned array
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor with the converted contents of the npy file
+     */
+    template <typename T, layout_type L = layout_type::dynamic>
+    inline auto load_npy_as(std::istream& stream)
+    {
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, &fortran_order, shape);
+        if ((L == layout_type::column_major && !fortran_order) ||
+            (L == layout_type::row_major && fortran_order))
+        {
+            XTENSOR_THROW(std::runtime_error, "Cast error: layout mismatch between npy file and requested layout.");
+        }
+        uvector<T> data(compute_size(shape));
+        detail::read_npy_as(stream, typestr, data.data(), data.size());
+        layout_type l = fortran_order ? layout_type::column_major : layout_type::row_major;
+        return adapt<L>(std::move(data), shape, l);
+    }
+
+    /**
+     * Loads a npy file (the numpy storage format), converting its data
+     *
+     * @param filename The filename or path to the file
+     * @tparam T the value type of the returned array
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor with the converted contents of the npy file
+     * @sa load_npy_as(std::istream&)
+     */
+    template <typename T, layout_type L = layout_type::dynamic>
+    inline auto load_npy_as(const std::string& filename)
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        return load_npy_as<T, L>(stream);
+    }
+
+    /**
+     * Loads a slice of a npy file (the numpy storage format)
      *
-     * @param e the xexpression
+     * Only the elements selected by the slices are read from the file:
+     * their positions are computed from the shape in the header, and each
+     * contiguous block of selected elements is read with a positioned
+     * read. The slices are integers, ranges, all, keep or drop slices,
+     * the axes without slices being fully read.
+     *
+     * @code{.cpp}
+     * auto batch = xt::load_npy_slice<float>("train.npy", xt::range(first, last));
+     * @endcode
+     *
+     * @param filename The filename or path to the file
+     * @param slices The slices of the first axes of the array
+     * @tparam T select the type of the npy file (note: there is no dynamic
+     *           casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor holding the selected elements
      */
-    template <typename E>
-    inline std::string dump_npy(const xexpression<E>& e)
+    template <typename T, layout_type L = layout_type::dynamic, class... S,
+              class = std::enable_if_t<!detail::is_npy_read_options<S...>::value>>
+    inline auto load_npy_slice(const std::string& filename, S&&... slices)
     {
-        std::stringstream stream;
-        detail::dump_npy_stream(stream, e);
-        return stream.str();
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        detail::npy_stream_reader reader(stream);
+        return detail::load_npy_slice_impl<T, L>(stream, reader, std::forward<S>(slices)...);
     }
 
     /**
-     * Loads a npy file (the numpy storage format)
+     * Loads a slice of a npy file (the numpy storage format)
      *
-     * @param stream An input stream from which to load the file
-     * @tparam T select the type of the npy file (note: currently there is
-     *           no dynamic casting if types do not match)
+     * The blocks of selected elements are read with the positioned reads
+     * described by \c options, which can keep several reads in flight.
+     *
+     * @param filename The filename or path to the file
+     * @param options The options of the reads
+     * @param slices The slices of the first axes of the array
+     * @tparam T select the type of the npy file (note: there is no dynamic
+     *           casting if types do not match)
      * @tparam L select layout_type::column_major if you stored data in
      *           Fortran format
-     * @return xarray with contents from npy file
+     * @return xarray_adaptor holding the selected elements
+     * @sa load_npy_slice(const std::string&, S&&...)
      */
-    template <typename T, layout_type L = layout_type::dynamic>
-    inline auto load_npy(std::istream& stream)
+    template <typename T, layout_type L = layout_type::dynamic, class... S>
+    inline auto load_npy_slice(const std::string& filename, const npy_read_options& options, S&&... slices)
     {
-        detail::npy_file file = detail::load_npy_file(stream);
-        return std::move(file).cast<T, L>();
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        detail::npy_file_reader reader(filename, options);
+        return detail::load_npy_slice_impl<T, L>(stream, reader, std::forward<S>(slices)...);
+    }
+
+    namespace detail
+    {
+        // Function of the generators returned by npy_source: the elements
+        // are read from the file by blocks of chunk_size bytes, the block
+        // holding the last element accessed being kept in memory. The state
+        // is shared by the copies of the function.
+        template <class T>
+        class npy_source_impl
+        {
+        public:
+
+            using value_type = T;
+            using strides_type = std::vector<std::ptrdiff_t>;
+
+            npy_source_impl(const std::string& filename, const npy_read_options& options, std::size_t offset,
+                            const std::vector<std::size_t>& shape, bool fortran_order);
+
+            template <class... Args>
+            value_type operator()(Args... args) const;
+
+            template <class It>
+            value_type element(It first, It last) const;
+
+            value_type data_element(std::size_t i) const;
+
+            template <class EX>
+            void assign_to(xexpression<EX>& e) const;
+
+        private:
+
+            struct state
+            {
+                state(const std::string& filename, const npy_read_options& options)
+                    : reader(filename, options), begin(0), end(0)
+                {
+                }
+
+                npy_file_reader reader;
+                uvector<T> block;
+                std::size_t begin;
+                std::size_t end;
+            };
+
+            void load_block(std::size_t i) const;
+
+            std::shared_ptr<state> m_state;
+            std::size_t m_offset;
+            std::size_t m_size;
+            layout_type m_layout;
+            strides_type m_strides;
+        };
+
+        template <class T>
+        inline npy_source_impl<T>::npy_source_impl(const std::string& filename, const npy_read_options& options,
+                                                   std::size_t offset, const std::vector<std::size_t>& shape,
+                                                   bool fortran_order)
+            : m_state(std::make_shared<state>(filename, options)),
+              m_offset(offset),
+              m_size(compute_size(shape)),
+              m_layout(fortran_order ? layout_type::column_major : layout_type::row_major),
+              m_strides(shape.size())
+        {
+            compute_strides(shape, m_layout, m_strides);
+            std::size_t block_size = (std::max)(options.chunk_size / sizeof(T), std::size_t(1));
+            m_state->block.resize((std::min)(block_size, m_size));
+        }
+
+        template <class T>
+        template <class... Args>
+        inline auto npy_source_impl<T>::operator()(Args... args) const -> value_type
+        {
+            return data_element(static_cast<std::size_t>(data_offset<std::ptrdiff_t>(m_strides, args...)));
+        }
+
+        template <class T>
+        template <class It>
+        inline auto npy_source_impl<T>::element(It first, It last) const -> value_type
+        {
+            return data_element(static_cast<std::size_t>(element_offset<std::ptrdiff_t>(m_strides, first, last)));
+        }
+
+        template <class T>
+        inline auto npy_source_impl<T>::data_element(std::size_t i) const -> value_type
+        {
+            if (i < m_state->begin || i >= m_state->end)
+            {
+                load_block(i);
+            }
+            return m_state->block[i - m_state->begin];
+        }
+
+        template <class T>
+        inline void npy_source_impl<T>::load_block(std::size_t i) const
+        {
+            state& st = *m_state;
+            std::size_t block_size = st.block.size();
+            std::size_t begin = i / block_size * block_size;
+            std::size_t end = (std::min)(begin + block_size, m_size);
+            // The block is invalidated first, in case the read throws
+            st.begin = st.end = 0;
+            st.reader.read(reinterpret_cast<char*>(st.block.data()), (end - begin) * sizeof(T),
+                           m_offset + begin * sizeof(T));
+            st.reader.finish();
+            st.begin = begin;
+            st.end = end;
+        }
+
+        // Contiguous destinations with the layout of the file are read
+        // directly, the others are filled in the order of the file.
+        template <class T>
+        template <class EX>
+        inline void npy_source_impl<T>::assign_to(xexpression<EX>& e) const
+        {
+            auto& ed = e.derived_cast();
+            bool done = xtl::mpl::static_if<has_data_interface<EX>::value>([&](auto self)
+            {
+                auto& d = self(ed);
+                if (d.layout() != m_layout || !d.is_contiguous()
+                    || !std::is_same<typename EX::value_type, T>::value)
+                {
+                    return false;
+                }
+                auto out = d.data() + static_cast<std::ptrdiff_t>(d.data_offset());
+                m_state->reader.read(reinterpret_cast<char*>(out), m_size * sizeof(T), m_offset);
+                m_state->reader.finish();
+                return true;
+            }, /*else*/ [](auto /*self*/)
+            {
+                return false;
+            });
+            if (!done)
+            {
+                auto fill = [this](auto it)
+                {
+                    for (std::size_t i = 0; i < m_size; ++i, ++it)
+                    {
+                        *it = data_element(i);
+                    }
+                };
+                if (m_layout == layout_type::row_major)
+                {
+                    fill(ed.template begin<layout_type::row_major>());
+                }
+                else
+                {
+                    fill(ed.template begin<layout_type::column_major>());
+                }
+            }
+        }
     }
 
     /**
-     * Loads a npy file (the numpy storage format)
+     * Returns an expression reading the elements of a npy file on access
+     *
+     * Only the header of the file is read by this function. The elements
+     * are read by blocks of \c options.chunk_size bytes as the expression
+     * is evaluated, so that the file can be reduced or assigned in constant
+     * memory:
+     *
+     * @code{.cpp}
+     * double total = xt::sum(xt::npy_source<double>("big.npy"))();
+     * @endcode
+     *
+     * The elements are best accessed in the order of the file; the copies
+     * of the expression share their block and must not be evaluated from
+     * several threads at once.
      *
      * @param filename The filename or path to the file
-     * @tparam T select the type of the npy file (note: currently there is
-     *           no dynamic casting if types do not match)
+     * @param options The options of the reads [default: npy_read_options()]
+     * @tparam T select the type of the npy file (note: there is no dynamic
+     *           casting if types do not match)
+     * @return xgenerator reading the elements of the npy file
+     */
+    template <typename T>
+    inline auto npy_source(const std::string& filename, const npy_read_options& options = npy_read_options())
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, &fortran_order, shape);
+        std::size_t offset = static_cast<std::size_t>(stream.tellg());
+        stream.close();
+        detail::check_npy_cast<T, layout_type::dynamic>(typestr, fortran_order);
+        return detail::make_xgenerator(detail::npy_source_impl<T>(filename, options, offset, shape, fortran_order),
+                                       shape);
+    }
+
+    /**
+     * Maps a npy file (the numpy storage format) in memory
+     *
+     * Only the header of the file is read, the returned adaptor refers to
+     * the data of the file mapped in memory, so that the pages are read on
+     * first access and shared with the other processes mapping the file.
+     * The mapping is released with the last copy of the adaptor.
+     * Memory mapping is available on POSIX systems.
+     *
+     * @param filename The filename or path to the file
+     * @param mode The access mode of the data [default: npy_mmap_mode::read_only]
+     * @tparam T select the type of the npy file (note: there is no dynamic
+     *           casting if types do not match)
      * @tparam L select layout_type::column_major if you stored data in
      *           Fortran format
-     * @return xarray with contents from npy file
+     * @return xarray_adaptor on the data of the npy file
      */
     template <typename T, layout_type L = layout_type::dynamic>
-    inline auto load_npy(const std::string& filename)
+    inline auto load_npy_mmap(const std::string& filename, npy_mmap_mode mode = npy_mmap_mode::read_only)
     {
         std::ifstream stream(filename, std::ifstream::binary);
         if (!stream)
         {
             XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
         }
-        return load_npy<T, L>(stream);
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, &fortran_order, shape);
+        std::size_t offset = static_cast<std::size_t>(stream.tellg());
+        stream.close();
+
+        detail::check_npy_cast<T, L>(typestr, fortran_order);
+
+        auto region = std::make_shared<detail::npy_mmap_region>(filename, mode);
+        layout_type l = fortran_order ? layout_type::column_major : layout_type::row_major;
+        return detail::adapt_npy_region<T, L>(std::move(region), offset, shape, l);
+    }
+
+    /**
+     * Creates a npy file (the numpy storage format) mapped in memory
+     *
+     * The header of the file is written and the file is extended to the
+     * size of the data, which is mapped in memory with
+     * npy_mmap_mode::read_write. The elements of the returned adaptor,
+     * initially zero, can then be assigned piecewise, e.g. through views
+     * and from several threads, the changes being written to the file by
+     * the operating system. This allows producing arrays larger than the
+     * memory. A whole array should be assigned with noalias, so that the
+     * layout of the adaptor is kept. The mapping is released with the last
+     * copy of the adaptor.
+     * Memory mapping is available on POSIX systems.
+     *
+     * @code{.cpp}
+     * auto out = xt::create_npy_mmap<double>("features.npy", {n_rows, n_features});
+     * xt::view(out, xt::range(first, last)) = compute_rows(first, last);
+     * @endcode
+     *
+     * @param filename The filename or path to the file, overwritten if it exists
+     * @param shape The shape of the array
+     * @param l The layout of the array, layout_type::column_major to store
+     *          the data in Fortran format [default: XTENSOR_DEFAULT_LAYOUT]
+     * @tparam T the value type of the array
+     * @return xarray_adaptor on the data of the npy file
+     */
+    template <typename T, class S>
+    inline auto create_npy_mmap(const std::string& filename, const S& shape, layout_type l = XTENSOR_DEFAULT_LAYOUT)
+    {
+        if (l != layout_type::row_major && l != layout_type::column_major)
+        {
+            XTENSOR_THROW(std::runtime_error, "npy files can only be row_major or column_major.");
+        }
+        std::vector<std::size_t> sh(std::begin(shape), std::end(shape));
+        std::size_t offset = 0;
+        {
+            std::ofstream stream(filename, std::ofstream::binary | std::ofstream::trunc);
+            if (!stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "IO Error: failed to open file: "s + filename);
+            }
+            bool fortran_order = l == layout_type::column_major && sh.size() > 1;
+            detail::write_header(stream, detail::build_typestring<T>(), fortran_order, sh);
+            offset = static_cast<std::size_t>(stream.tellp());
+            if (!stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed writing file: "s + filename);
+            }
+        }
+        detail::resize_npy_file(filename, offset + compute_size(sh) * sizeof(T));
+        auto region = std::make_shared<detail::npy_mmap_region>(filename, npy_mmap_mode::read_write);
+        return detail::adapt_npy_region<T, layout_type::dynamic>(std::move(region), offset, sh, l);
+    }
+
+    template <typename T, class I, std::size_t N>
+    inline auto create_npy_mmap(const std::string& filename, const I (&shape)[N], layout_type l = XTENSOR_DEFAULT_LAYOUT)
+    {
+        std::array<std::size_t, N> sh;
+        std::copy(shape, shape + N, sh.begin());
+        return create_npy_mmap<T>(filename, sh, l);
+    }
+
+    /**************
+     * npy_writer *
+     **************/
+
+    /**
+     * @class npy_writer
+     * @brief Writer of a npy file growing along its first axis.
+     *
+     * The npy_writer class writes a npy file (the numpy storage format)
+     * whose elements are frames of a fixed shape, appended one or several
+     * at a time along the first axis of the stored array. The data is
+     * written as it is appended, so that the memory used does not depend
+     * on the number of frames. The header is written with room for the
+     * largest number of frames and rewritten in place with the actual
+     * number by flush and close, so that the file is a valid npy file
+     * holding the frames appended before the last flush, even if the
+     * program stops without closing it.
+     *
+     * @code{.cpp}
+     * xt::npy_writer<float> writer("frames.npy", {height, width});
+     * for (...)
+     * {
+     *     writer.append(frame);
+     * }
+     * writer.close();
+     * @endcode
+     *
+     * @tparam T the value type of the stored array
+     */
+    template <class T>
+    class npy_writer
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using shape_type = std::vector<size_type>;
+
+        template <class S>
+        npy_writer(const std::string& filename, const S& frame_shape);
+
+        template <class I, std::size_t N>
+        npy_writer(const std::string& filename, const I (&frame_shape)[N]);
+
+        ~npy_writer();
+
+        npy_writer(const npy_writer&) = delete;
+        npy_writer& operator=(const npy_writer&) = delete;
+
+        template <class E>
+        void append(const xexpression<E>& e);
+
+        size_type rows() const noexcept;
+        const shape_type& frame_shape() const noexcept;
+        bool is_open() const noexcept;
+
+        void flush();
+        void close();
+
+    private:
+
+        void init();
+        void write_header();
+        void check_stream() const;
+
+        template <class E>
+        void write_data(const E& e, std::true_type);
+
+        template <class E>
+        void write_data(const E& e, std::false_type);
+
+        std::ofstream m_stream;
+        std::string m_filename;
+        shape_type m_frame_shape;
+        size_type m_rows;
+        std::streamoff m_data_offset;
+    };
+
+    /*****************************
+     * npy_writer implementation *
+     *****************************/
+
+    /**
+     * Creates the npy file \c filename, overwritten if it exists, holding
+     * an array of frames of shape \c frame_shape.
+     * @param filename The filename or path to the file
+     * @param frame_shape The shape of the frames, i.e. the shape of the
+     *                    stored array without its first axis
+     */
+    template <class T>
+    template <class S>
+    inline npy_writer<T>::npy_writer(const std::string& filename, const S& frame_shape)
+        : m_stream(), m_filename(filename),
+          m_frame_shape(std::begin(frame_shape), std::end(frame_shape)),
+          m_rows(0), m_data_offset(0)
+    {
+        init();
+    }
+
+    template <class T>
+    template <class I, std::size_t N>
+    inline npy_writer<T>::npy_writer(const std::string& filename, const I (&frame_shape)[N])
+        : m_stream(), m_filename(filename),
+          m_frame_shape(frame_shape, frame_shape + N),
+          m_rows(0), m_data_offset(0)
+    {
+        init();
+    }
+
+    /**
+     * Closes the file if it is still open, errors being ignored.
+     */
+    template <class T>
+    inline npy_writer<T>::~npy_writer()
+    {
+        if (is_open())
+        {
+            write_header();
+            m_stream.close();
+        }
+    }
+
+    /**
+     * Appends frames to the file.
+     * @param e an expression of the frame shape, appended as one frame,
+     *          or of one more dimension and whose shape ends with the frame
+     *          shape, appended as e.shape()[0] frames
+     */
+    template <class T>
+    template <class E>
+    inline void npy_writer<T>::append(const xexpression<E>& e)
+    {
+        const auto& de = e.derived_cast();
+        if (!is_open())
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: npy_writer is closed.");
+        }
+        size_type dim = m_frame_shape.size();
+        auto first = std::begin(de.shape());
+        size_type n_rows = 1;
+        if (de.dimension() == dim + 1)
+        {
+            n_rows = static_cast<size_type>(*first);
+            ++first;
+        }
+        else if (de.dimension() != dim)
+        {
+            XTENSOR_THROW(std::runtime_error, "Dimension mismatch between npy_writer frames and appended expression.");
+        }
+        if (!std::equal(m_frame_shape.cbegin(), m_frame_shape.cend(), first))
+        {
+            XTENSOR_THROW(std::runtime_error, "Shape mismatch between npy_writer frames and appended expression.");
+        }
+        write_data(de, std::integral_constant<bool, has_data_interface<E>::value &&
+                                                        std::is_same<typename E::value_type, T>::value>());
+        check_stream();
+        m_rows += n_rows;
+    }
+
+    /**
+     * Returns the number of frames appended to the file.
+     */
+    template <class T>
+    inline auto npy_writer<T>::rows() const noexcept -> size_type
+    {
+        return m_rows;
+    }
+
+    /**
+     * Returns the shape of the frames.
+     */
+    template <class T>
+    inline auto npy_writer<T>::frame_shape() const noexcept -> const shape_type&
+    {
+        return m_frame_shape;
+    }
+
+    /**
+     * Returns true until the file is closed.
+     */
+    template <class T>
+    inline bool npy_writer<T>::is_open() const noexcept
+    {
+        return m_stream.is_open();
+    }
+
+    /**
+     * Writes the number of frames in the header and flushes the file, so
+     * that it holds a valid npy file with the frames appended so far.
+     */
+    template <class T>
+    inline void npy_writer<T>::flush()
+    {
+        if (is_open())
+        {
+            write_header();
+            m_stream.flush();
+            check_stream();
+        }
+    }
+
+    /**
+     * Writes the number of frames in the header and closes the file.
+     */
+    template <class T>
+    inline void npy_writer<T>::close()
+    {
+        if (is_open())
+        {
+            write_header();
+            m_stream.close();
+            check_stream();
+        }
+    }
+
+    template <class T>
+    inline void npy_writer<T>::init()
+    {
+        m_stream.open(m_filename, std::ofstream::binary | std::ofstream::trunc);
+        if (!m_stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "IO Error: failed to open file: "s + m_filename);
+        }
+        write_header();
+        check_stream();
+        m_data_offset = static_cast<std::streamoff>(m_stream.tellp());
+    }
+
+    // Rewrites the header at the beginning of the file and goes back to
+    // the end. The spaces reserved for the digits of the number of frames
+    // keep the size of the header constant.
+    template <class T>
+    inline void npy_writer<T>::write_header()
+    {
+        shape_type shape(m_frame_shape.size() + 1);
+        shape[0] = m_rows;
+        std::copy(m_frame_shape.cbegin(), m_frame_shape.cend(), shape.begin() + 1);
+        std::size_t max_digits = std::numeric_limits<size_type>::digits10 + 1;
+        std::size_t reserve = max_digits - std::to_string(m_rows).size();
+        m_stream.seekp(0, std::ios_base::beg);
+        detail::write_header(m_stream, detail::build_typestring<T>(), false, shape, reserve);
+        XTENSOR_ASSERT(m_data_offset == 0 || m_stream.tellp() == m_data_offset);
+        m_stream.seekp(0, std::ios_base::end);
+    }
+
+    template <class T>
+    inline void npy_writer<T>::check_stream() const
+    {
+        if (!m_stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed writing file: "s + m_filename);
+        }
+    }
+
+    template <class T>
+    template <class E>
+    inline void npy_writer<T>::write_data(const E& e, std::true_type)
+    {
+        if (e.layout() == layout_type::row_major && e.is_contiguous())
+        {
+            m_stream.write(reinterpret_cast<const char*>(e.data() + e.data_offset()),
+                           std::streamsize(sizeof(T) * e.size()));
+        }
+        else
+        {
+            write_data(e, std::false_type());
+        }
     }
 
+    // Copies the elements in row-major order through a buffer of bounded
+    // size
+    template <class T>
+    template <class E>
+    inline void npy_writer<T>::write_data(const E& e, std::false_type)
+    {
+        constexpr size_type buffer_size = size_type(1) << 16;
+        uvector<T> buffer((std::min)(buffer_size, static_cast<size_type>(e.size())));
+        auto it = e.template cbegin<layout_type::row_major>();
+        auto last = e.template cend<layout_type::row_major>();
+        while (it != last)
+        {
+            size_type n = 0;
+            for (; n < buffer.size() && it != last; ++n, ++it)
+            {
+                buffer[n] = static_cast<T>(*it);
+            }
+            m_stream.write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(sizeof(T) * n));
+        }
+    }
+
+
 }  // namespace xt
 
 #endif
@@ -0,0 +1,1006 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_NPZ_HPP
+#define XTENSOR_NPZ_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(XTENSOR_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xstorage.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /**************
+     * zip format *
+     **************/
+
+    namespace detail
+    {
+        constexpr std::uint32_t zip_local_signature = 0x04034b50;
+        constexpr std::uint32_t zip_central_signature = 0x02014b50;
+        constexpr std::uint32_t zip_end_signature = 0x06054b50;
+        constexpr std::uint32_t zip64_end_signature = 0x06064b50;
+        constexpr std::uint32_t zip64_locator_signature = 0x07064b50;
+
+        constexpr std::size_t zip_local_header_size = 30;
+        constexpr std::size_t zip_central_header_size = 46;
+        constexpr std::size_t zip_end_size = 22;
+        constexpr std::size_t zip64_end_size = 56;
+        constexpr std::size_t zip64_locator_size = 20;
+        constexpr std::size_t zip_max_comment_size = 0xffff;
+
+        constexpr std::uint64_t zip_u16_max = 0xffff;
+        constexpr std::uint64_t zip_u32_max = 0xffffffff;
+        // Members larger than this get zip64 sizes, leaving room for the
+        // expansion of incompressible data by deflate
+        constexpr std::uint64_t zip64_member_threshold = 0xffff0000;
+
+        constexpr std::uint16_t zip_stored = 0;
+        constexpr std::uint16_t zip_deflated = 8;
+        constexpr std::uint16_t zip_encrypted_flag = 1;
+        constexpr std::uint16_t zip64_extra_id = 0x0001;
+        // Extra field padding the local headers so that the data of the
+        // members is aligned, as the one used by zipalign
+        constexpr std::uint16_t zip_align_extra_id = 0xd935;
+        constexpr std::size_t npz_alignment = 64;
+
+        // MS-DOS date of the members, 1980-01-01
+        constexpr std::uint16_t zip_dos_date = (1 << 5) | 1;
+
+        inline std::uint64_t zip_read(const char* p, std::size_t n) noexcept
+        {
+            std::uint64_t v = 0;
+            for (std::size_t i = n; i-- > 0;)
+            {
+                v = (v << 8) | static_cast<unsigned char>(p[i]);
+            }
+            return v;
+        }
+
+        inline void zip_write(std::string& s, std::uint64_t v, std::size_t n)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                s.push_back(static_cast<char>(v & 0xff));
+                v >>= 8;
+            }
+        }
+
+        inline std::uint32_t zip_crc32(std::uint32_t crc, const char* data, std::size_t n)
+        {
+#if defined(XTENSOR_USE_ZLIB)
+            while (n > 0)
+            {
+                uInt m = static_cast<uInt>((std::min)(n, std::size_t(1) << 30));
+                crc = static_cast<std::uint32_t>(::crc32(crc, reinterpret_cast<const Bytef*>(data), m));
+                data += m;
+                n -= m;
+            }
+            return crc;
+#else
+            static const std::array<std::uint32_t, 256> table = []()
+            {
+                std::array<std::uint32_t, 256> t;
+                for (std::uint32_t i = 0; i < 256; ++i)
+                {
+                    std::uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+                    }
+                    t[i] = c;
+                }
+                return t;
+            }();
+            crc = ~crc;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+            }
+            return ~crc;
+#endif
+        }
+
+#if defined(XTENSOR_USE_ZLIB)
+        inline void zip_inflate(const char* src, std::uint64_t src_size, char* dst, std::uint64_t dst_size)
+        {
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+            {
+                XTENSOR_THROW(std::runtime_error, "zlib error: failed to initialize inflate.");
+            }
+            int ret = Z_OK;
+            while (ret == Z_OK)
+            {
+                // avail_in and avail_out are 32 bits, the input and the output
+                // are given by chunks
+                if (zs.avail_in == 0 && src_size > 0)
+                {
+                    uInt m = static_cast<uInt>((std::min)(src_size, std::uint64_t(1) << 30));
+                    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+                    zs.avail_in = m;
+                    src += m;
+                    src_size -= m;
+                }
+                if (zs.avail_out == 0 && dst_size > 0)
+                {
+                    uInt m = static_cast<uInt>((std::min)(dst_size, std::uint64_t(1) << 30));
+                    zs.next_out = reinterpret_cast<Bytef*>(dst);
+                    zs.avail_out = m;
+                    dst += m;
+                    dst_size -= m;
+                }
+                ret = inflate(&zs, Z_NO_FLUSH);
+            }
+            bool complete = ret == Z_STREAM_END && zs.avail_out == 0 && dst_size == 0;
+            inflateEnd(&zs);
+            if (!complete)
+            {
+                XTENSOR_THROW(std::runtime_error, "zlib error: corrupted deflated member.");
+            }
+        }
+
+        // Deflates the data written to a stream, returning the number of
+        // compressed bytes on finish
+        class zip_deflater
+        {
+        public:
+
+            explicit zip_deflater(std::ostream& out);
+            ~zip_deflater();
+
+            zip_deflater(const zip_deflater&) = delete;
+            zip_deflater& operator=(const zip_deflater&) = delete;
+
+            void write(const char* data, std::size_t n);
+            std::uint64_t finish();
+
+        private:
+
+            void run(int flush);
+
+            z_stream m_zs;
+            std::ostream& m_out;
+            std::uint64_t m_written;
+            std::array<char, 1 << 16> m_buffer;
+        };
+
+        inline zip_deflater::zip_deflater(std::ostream& out)
+            : m_out(out), m_written(0)
+        {
+            std::memset(&m_zs, 0, sizeof(m_zs));
+            if (deflateInit2(&m_zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                XTENSOR_THROW(std::runtime_error, "zlib error: failed to initialize deflate.");
+            }
+        }
+
+        inline zip_deflater::~zip_deflater()
+        {
+            deflateEnd(&m_zs);
+        }
+
+        inline void zip_deflater::write(const char* data, std::size_t n)
+        {
+            while (n > 0)
+            {
+                uInt m = static_cast<uInt>((std::min)(n, std::size_t(1) << 30));
+                m_zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+                m_zs.avail_in = m;
+                run(Z_NO_FLUSH);
+                data += m;
+                n -= m;
+            }
+        }
+
+        inline std::uint64_t zip_deflater::finish()
+        {
+            m_zs.next_in = nullptr;
+            m_zs.avail_in = 0;
+            run(Z_FINISH);
+            return m_written;
+        }
+
+        inline void zip_deflater::run(int flush)
+        {
+            int ret = Z_OK;
+            do
+            {
+                m_zs.next_out = reinterpret_cast<Bytef*>(m_buffer.data());
+                m_zs.avail_out = static_cast<uInt>(m_buffer.size());
+                ret = deflate(&m_zs, flush);
+                if (ret == Z_STREAM_ERROR)
+                {
+                    XTENSOR_THROW(std::runtime_error, "zlib error: deflate failed.");
+                }
+                std::size_t n = m_buffer.size() - m_zs.avail_out;
+                m_out.write(m_buffer.data(), static_cast<std::streamsize>(n));
+                m_written += n;
+            } while (m_zs.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+        }
+#endif
+
+        // Input stream buffer on a memory area, used to parse the npy
+        // header of a member of a npz archive
+        class npz_memory_buffer : public std::streambuf
+        {
+        public:
+
+            npz_memory_buffer(const char* data, std::size_t size)
+            {
+                char* p = const_cast<char*>(data);
+                setg(p, p, p + size);
+            }
+
+            std::size_t position() const noexcept
+            {
+                return static_cast<std::size_t>(gptr() - eback());
+            }
+        };
+
+        struct npz_entry
+        {
+            std::string name;
+            std::uint16_t flags;
+            std::uint16_t method;
+            std::uint32_t crc;
+            std::uint64_t compressed_size;
+            std::uint64_t size;
+            std::uint64_t local_offset;
+        };
+
+        inline void read_zip(std::istream& stream, std::uint64_t offset, char* data, std::size_t n)
+        {
+            stream.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+            stream.read(data, static_cast<std::streamsize>(n));
+            if (!stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed reading npz file.");
+            }
+        }
+
+        // Reads the entries of the central directory of a zip archive,
+        // found from the end of central directory record
+        inline std::vector<npz_entry> read_zip_directory(std::istream& stream)
+        {
+            stream.seekg(0, std::ios_base::end);
+            std::uint64_t file_size = static_cast<std::uint64_t>(stream.tellg());
+            std::size_t tail_size = static_cast<std::size_t>(
+                (std::min)(file_size, std::uint64_t(zip_end_size + zip_max_comment_size)));
+            if (tail_size < zip_end_size)
+            {
+                XTENSOR_THROW(std::runtime_error, "npz error: not a zip archive.");
+            }
+            std::string tail(tail_size, '\0');
+            read_zip(stream, file_size - tail_size, &tail[0], tail_size);
+            std::size_t end = tail_size - zip_end_size + 1;
+            do
+            {
+                --end;
+            } while (end > 0 && zip_read(&tail[end], 4) != zip_end_signature);
+            if (zip_read(&tail[end], 4) != zip_end_signature)
+            {
+                XTENSOR_THROW(std::runtime_error, "npz error: not a zip archive.");
+            }
+            std::uint64_t n_entries = zip_read(&tail[end + 10], 2);
+            std::uint64_t directory_size = zip_read(&tail[end + 12], 4);
+            std::uint64_t directory_offset = zip_read(&tail[end + 16], 4);
+            if (end >= zip64_locator_size &&
+                zip_read(&tail[end - zip64_locator_size], 4) == zip64_locator_signature)
+            {
+                std::uint64_t end64_offset = zip_read(&tail[end - zip64_locator_size + 8], 8);
+                std::array<char, zip64_end_size> end64;
+                read_zip(stream, end64_offset, end64.data(), end64.size());
+                if (zip_read(end64.data(), 4) != zip64_end_signature)
+                {
+                    XTENSOR_THROW(std::runtime_error, "npz error: corrupted zip64 end of central directory.");
+                }
+                n_entries = zip_read(&end64[32], 8);
+                directory_size = zip_read(&end64[40], 8);
+                directory_offset = zip_read(&end64[48], 8);
+            }
+            if (directory_offset + directory_size > file_size)
+            {
+                XTENSOR_THROW(std::runtime_error, "npz error: corrupted central directory.");
+            }
+
+            std::string directory(static_cast<std::size_t>(directory_size), '\0');
+            if (directory_size > 0)
+            {
+                read_zip(stream, directory_offset, &directory[0], directory.size());
+            }
+            std::vector<npz_entry> entries;
+            entries.reserve(static_cast<std::size_t>(n_entries));
+            std::size_t pos = 0;
+            for (std::uint64_t i = 0; i < n_entries; ++i)
+            {
+                if (pos + zip_central_header_size > directory.size() ||
+                    zip_read(&directory[pos], 4) != zip_central_signature)
+                {
+                    XTENSOR_THROW(std::runtime_error, "npz error: corrupted central directory.");
+                }
+                const char* h = &directory[pos];
+                npz_entry entry;
+                entry.flags = static_cast<std::uint16_t>(zip_read(h + 8, 2));
+                entry.method = static_cast<std::uint16_t>(zip_read(h + 10, 2));
+                entry.crc = static_cast<std::uint32_t>(zip_read(h + 16, 4));
+                entry.compressed_size = zip_read(h + 20, 4);
+                entry.size = zip_read(h + 24, 4);
+                std::size_t name_size = static_cast<std::size_t>(zip_read(h + 28, 2));
+                std::size_t extra_size = static_cast<std::size_t>(zip_read(h + 30, 2));
+                std::size_t comment_size = static_cast<std::size_t>(zip_read(h + 32, 2));
+                entry.local_offset = zip_read(h + 42, 4);
+                std::size_t next = pos + zip_central_header_size + name_size + extra_size + comment_size;
+                if (next > directory.size())
+                {
+                    XTENSOR_THROW(std::runtime_error, "npz error: corrupted central directory.");
+                }
+                entry.name = directory.substr(pos + zip_central_header_size, name_size);
+
+                // The zip64 extra field holds the sizes and offset that do not
+                // fit in 32 bits, in this order
+                const char* extra = h + zip_central_header_size + name_size;
+                for (std::size_t e = 0; e + 4 <= extra_size;)
+                {
+                    std::size_t id = static_cast<std::size_t>(zip_read(extra + e, 2));
+                    std::size_t len = static_cast<std::size_t>(zip_read(extra + e + 2, 2));
+                    if (id == zip64_extra_id)
+                    {
+                        const char* p = extra + e + 4;
+                        const char* last = p + (std::min)(len, extra_size - e - 4);
+                        for (std::uint64_t* field : {&entry.size, &entry.compressed_size, &entry.local_offset})
+                        {
+                            if (*field == zip_u32_max && p + 8 <= last)
+                            {
+                                *field = zip_read(p, 8);
+                                p += 8;
+                            }
+                        }
+                    }
+                    e += 4 + len;
+                }
+                entries.push_back(std::move(entry));
+                pos = next;
+            }
+            return entries;
+        }
+    }
+
+    /************
+     * npz_file *
+     ************/
+
+    /**
+     * @class npz_file
+     * @brief Reader of a npz archive (the numpy storage format for several arrays).
+     *
+     * Opening a npz archive only reads its central directory, the arrays
+     * being read when they are accessed. The arrays stored without
+     * compression are adapted on the memory mapped archive, without copy,
+     * when memory mapping is available (on POSIX systems) and their data is
+     * aligned; they are then mapped copy-on-write, so that modifying them
+     * does not change the archive. The deflated arrays are decompressed on
+     * their first access and kept by the npz_file, which requires building
+     * with XTENSOR_USE_ZLIB. Like load_npy, the adaptors share the ownership
+     * of their data and outlive the npz_file.
+     */
+    class npz_file
+    {
+    public:
+
+        using size_type = std::size_t;
+
+        explicit npz_file(const std::string& filename);
+
+        size_type size() const noexcept;
+        const std::vector<std::string>& names() const noexcept;
+        bool contains(const std::string& name) const;
+
+        template <class T, layout_type L = layout_type::dynamic>
+        auto get(const std::string& name) const;
+
+    private:
+
+        const detail::npz_entry& entry(const std::string& name) const;
+        std::uint64_t data_offset(const detail::npz_entry& en) const;
+        std::shared_ptr<void> member_data(size_type index, const char*& data) const;
+
+        std::string m_filename;
+        std::vector<detail::npz_entry> m_entries;
+        std::vector<std::string> m_names;
+        std::map<std::string, size_type> m_index;
+        mutable std::shared_ptr<detail::npy_mmap_region> m_region;
+        mutable std::map<size_type, std::shared_ptr<uvector<char>>> m_buffers;
+    };
+
+    npz_file load_npz(const std::string& filename);
+
+    /**************
+     * npz_writer *
+     **************/
+
+    /**
+     * @class npz_writer
+     * @brief Writer of a npz archive (the numpy storage format for several arrays).
+     *
+     * The arrays added to the npz_writer are written one after the other
+     * in the archive, as npy files named after the arrays. They are stored
+     * without compression, like numpy.savez, with their data aligned so
+     * that they can be memory mapped, or deflated like numpy.savez_compressed
+     * when building with XTENSOR_USE_ZLIB. The central directory of the
+     * archive is written by close.
+     */
+    class npz_writer
+    {
+    public:
+
+        explicit npz_writer(const std::string& filename, bool compress = false);
+        ~npz_writer();
+
+        npz_writer(const npz_writer&) = delete;
+        npz_writer& operator=(const npz_writer&) = delete;
+
+        template <class E>
+        void add(const std::string& name, const xexpression<E>& e);
+
+        bool is_open() const noexcept;
+        void close();
+
+    private:
+
+        void write_member(const std::string& header, const char* data, std::size_t n_bytes,
+                          detail::npz_entry& en);
+        void write_directory();
+        void check_stream() const;
+
+        std::ofstream m_stream;
+        std::string m_filename;
+        bool m_compress;
+        std::vector<detail::npz_entry> m_entries;
+    };
+
+    template <class E, class... Args>
+    void dump_npz(const std::string& filename, const std::string& name, const xexpression<E>& e,
+                  const Args&... args);
+
+    /***************************
+     * npz_file implementation *
+     ***************************/
+
+    /**
+     * Opens the npz archive \c filename and reads its central directory.
+     */
+    inline npz_file::npz_file(const std::string& filename)
+        : m_filename(filename), m_entries(), m_names(), m_index(), m_region(), m_buffers()
+    {
+        std::ifstream stream(filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        m_entries = detail::read_zip_directory(stream);
+        const std::string suffix = ".npy";
+        for (size_type i = 0; i < m_entries.size(); ++i)
+        {
+            std::string name = m_entries[i].name;
+            if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                name.erase(name.size() - suffix.size());
+            }
+            m_names.push_back(name);
+            m_index.emplace(name, i);
+        }
+    }
+
+    /**
+     * Returns the number of arrays of the archive.
+     */
+    inline auto npz_file::size() const noexcept -> size_type
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * Returns the names of the arrays of the archive, without the .npy
+     * extension of the members, in the order of the archive.
+     */
+    inline const std::vector<std::string>& npz_file::names() const noexcept
+    {
+        return m_names;
+    }
+
+    /**
+     * Returns true if the archive holds the array \c name.
+     */
+    inline bool npz_file::contains(const std::string& name) const
+    {
+        return m_index.find(name) != m_index.end();
+    }
+
+    /**
+     * Returns the array \c name of the archive.
+     *
+     * @tparam T select the type of the array (note: there is no dynamic
+     *           casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor on the data of the array, sharing its ownership
+     */
+    template <class T, layout_type L>
+    inline auto npz_file::get(const std::string& name) const
+    {
+        const detail::npz_entry& en = entry(name);
+        const char* data = nullptr;
+        std::shared_ptr<void> owner = member_data(m_index.find(name)->second, data);
+
+        detail::npz_memory_buffer buffer(data, static_cast<std::size_t>(en.size));
+        std::istream stream(&buffer);
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        detail::read_npy_header(stream, typestr, &fortran_order, shape);
+        std::size_t offset = buffer.position();
+        detail::check_npy_cast<T, L>(typestr, fortran_order);
+
+        std::size_t n_bytes = compute_size(shape) * sizeof(T);
+        if (offset + n_bytes > en.size)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: truncated member " + en.name);
+        }
+        const char* first = data + offset;
+        T* ptr = nullptr;
+        if (reinterpret_cast<std::uintptr_t>(first) % alignof(T) == 0)
+        {
+            ptr = reinterpret_cast<T*>(const_cast<char*>(first));
+        }
+        else
+        {
+            auto copy = std::make_shared<uvector<T>>(compute_size(shape));
+            std::memcpy(copy->data(), first, n_bytes);
+            ptr = copy->data();
+            owner = std::move(copy);
+        }
+        layout_type l = fortran_order ? layout_type::column_major : layout_type::row_major;
+        return adapt_smart_ptr<L>(std::move(ptr), shape, std::move(owner), l);
+    }
+
+    inline const detail::npz_entry& npz_file::entry(const std::string& name) const
+    {
+        auto it = m_index.find(name);
+        if (it == m_index.end())
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: no array named " + name);
+        }
+        const detail::npz_entry& en = m_entries[it->second];
+        if (en.flags & detail::zip_encrypted_flag)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: encrypted members are not supported.");
+        }
+        if (en.method != detail::zip_stored && en.method != detail::zip_deflated)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: unsupported compression method of member " + en.name);
+        }
+#if !defined(XTENSOR_USE_ZLIB)
+        if (en.method == detail::zip_deflated)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: reading deflated members requires XTENSOR_USE_ZLIB.");
+        }
+#endif
+        return en;
+    }
+
+    // The local header, whose extra field may differ from the one of the
+    // central directory, gives the position of the data
+    inline std::uint64_t npz_file::data_offset(const detail::npz_entry& en) const
+    {
+        std::ifstream stream(m_filename, std::ifstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+        }
+        std::array<char, detail::zip_local_header_size> header;
+        detail::read_zip(stream, en.local_offset, header.data(), header.size());
+        if (detail::zip_read(header.data(), 4) != detail::zip_local_signature)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: corrupted local header of member " + en.name);
+        }
+        return en.local_offset + detail::zip_local_header_size
+               + detail::zip_read(&header[26], 2) + detail::zip_read(&header[28], 2);
+    }
+
+    // Sets data to the uncompressed member and returns its owner
+    inline std::shared_ptr<void> npz_file::member_data(size_type index, const char*& data) const
+    {
+        const detail::npz_entry& en = m_entries[index];
+        auto it = m_buffers.find(index);
+        if (it != m_buffers.end())
+        {
+            data = it->second->data();
+            return it->second;
+        }
+        std::uint64_t offset = data_offset(en);
+#if defined(XTENSOR_NPY_HAS_MMAP)
+        if (m_region == nullptr)
+        {
+            m_region = std::make_shared<detail::npy_mmap_region>(m_filename, npy_mmap_mode::copy_on_write);
+        }
+        if (offset + en.compressed_size > m_region->size())
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: truncated member " + en.name);
+        }
+        const char* member = m_region->data() + offset;
+        if (en.method == detail::zip_stored)
+        {
+            data = member;
+            return m_region;
+        }
+#else
+        auto raw = std::make_shared<uvector<char>>(static_cast<std::size_t>(en.compressed_size));
+        {
+            std::ifstream stream(m_filename, std::ifstream::binary);
+            detail::read_zip(stream, offset, raw->data(), raw->size());
+        }
+        const char* member = raw->data();
+        if (en.method == detail::zip_stored)
+        {
+            data = member;
+            m_buffers.emplace(index, raw);
+            return raw;
+        }
+#endif
+#if defined(XTENSOR_USE_ZLIB)
+        auto inflated = std::make_shared<uvector<char>>(static_cast<std::size_t>(en.size));
+        detail::zip_inflate(member, en.compressed_size, inflated->data(), en.size);
+        if (detail::zip_crc32(0, inflated->data(), inflated->size()) != en.crc)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: CRC mismatch of member " + en.name);
+        }
+        m_buffers.emplace(index, inflated);
+        data = inflated->data();
+        return inflated;
+#else
+        (void) member;
+        XTENSOR_THROW(std::runtime_error, "npz error: reading deflated members requires XTENSOR_USE_ZLIB.");
+#endif
+    }
+
+    /**
+     * Opens a npz archive (the numpy storage format for several arrays)
+     *
+     * @param filename The filename or path to the file
+     * @return npz_file giving access to the arrays of the archive
+     */
+    inline npz_file load_npz(const std::string& filename)
+    {
+        return npz_file(filename);
+    }
+
+    /*****************************
+     * npz_writer implementation *
+     *****************************/
+
+    /**
+     * Creates the npz archive \c filename, overwritten if it exists.
+     * @param filename The filename or path to the file
+     * @param compress deflate the arrays, which requires XTENSOR_USE_ZLIB
+     */
+    inline npz_writer::npz_writer(const std::string& filename, bool compress)
+        : m_stream(), m_filename(filename), m_compress(compress), m_entries()
+    {
+#if !defined(XTENSOR_USE_ZLIB)
+        if (compress)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: writing deflated members requires XTENSOR_USE_ZLIB.");
+        }
+#endif
+        m_stream.open(filename, std::ofstream::binary | std::ofstream::trunc);
+        if (!m_stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "IO Error: failed to open file: "s + filename);
+        }
+    }
+
+    /**
+     * Closes the archive if it is still open, errors being ignored.
+     */
+    inline npz_writer::~npz_writer()
+    {
+        if (is_open())
+        {
+            write_directory();
+            m_stream.close();
+        }
+    }
+
+    /**
+     * Adds the array \c name to the archive.
+     * @param name the name of the array, the member being name.npy
+     * @param e the xexpression
+     */
+    template <class E>
+    inline void npz_writer::add(const std::string& name, const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        if (!is_open())
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: npz_writer is closed.");
+        }
+        auto&& eval_ex = eval(e.derived_cast());
+        bool fortran_order = eval_ex.layout() == layout_type::column_major && eval_ex.dimension() > 1;
+        std::ostringstream header;
+        detail::write_header(header, detail::build_typestring<value_type>(), fortran_order, eval_ex.shape());
+
+        detail::npz_entry en;
+        en.name = name + ".npy";
+        write_member(header.str(), reinterpret_cast<const char*>(eval_ex.data()),
+                     sizeof(value_type) * compute_size(eval_ex.shape()), en);
+        m_entries.push_back(std::move(en));
+    }
+
+    /**
+     * Returns true until the archive is closed.
+     */
+    inline bool npz_writer::is_open() const noexcept
+    {
+        return m_stream.is_open();
+    }
+
+    /**
+     * Writes the central directory and closes the archive.
+     */
+    inline void npz_writer::close()
+    {
+        if (is_open())
+        {
+            write_directory();
+            check_stream();
+            m_stream.close();
+            check_stream();
+        }
+    }
+
+    // Writes the local header with the sizes known beforehand, then the
+    // data, and patches the CRC and the compressed size in the header
+    inline void npz_writer::write_member(const std::string& header, const char* data, std::size_t n_bytes,
+                                         detail::npz_entry& en)
+    {
+        en.flags = 0;
+        en.method = m_compress ? detail::zip_deflated : detail::zip_stored;
+        en.size = header.size() + n_bytes;
+        en.compressed_size = en.size;
+        en.local_offset = static_cast<std::uint64_t>(m_stream.tellp());
+        bool zip64 = en.size >= detail::zip64_member_threshold;
+
+        std::string extra;
+        if (zip64)
+        {
+            detail::zip_write(extra, detail::zip64_extra_id, 2);
+            detail::zip_write(extra, 16, 2);
+            detail::zip_write(extra, en.size, 8);
+            detail::zip_write(extra, en.compressed_size, 8);
+        }
+        if (!m_compress)
+        {
+            std::uint64_t start = en.local_offset + detail::zip_local_header_size + en.name.size() + extra.size();
+            std::size_t padding = static_cast<std::size_t>((detail::npz_alignment - start % detail::npz_alignment)
+                                                           % detail::npz_alignment);
+            if (padding != 0)
+            {
+                padding += padding < 4 ? detail::npz_alignment : 0;
+                detail::zip_write(extra, detail::zip_align_extra_id, 2);
+                detail::zip_write(extra, padding - 4, 2);
+                extra.append(padding - 4, '\0');
+            }
+        }
+
+        std::string local;
+        detail::zip_write(local, detail::zip_local_signature, 4);
+        detail::zip_write(local, zip64 ? 45 : 20, 2);
+        detail::zip_write(local, en.flags, 2);
+        detail::zip_write(local, en.method, 2);
+        detail::zip_write(local, 0, 2);
+        detail::zip_write(local, detail::zip_dos_date, 2);
+        detail::zip_write(local, 0, 4);
+        detail::zip_write(local, zip64 ? detail::zip_u32_max : en.compressed_size, 4);
+        detail::zip_write(local, zip64 ? detail::zip_u32_max : en.size, 4);
+        detail::zip_write(local, en.name.size(), 2);
+        detail::zip_write(local, extra.size(), 2);
+        local += en.name;
+        local += extra;
+        m_stream.write(local.data(), static_cast<std::streamsize>(local.size()));
+
+        en.crc = detail::zip_crc32(0, header.data(), header.size());
+        en.crc = detail::zip_crc32(en.crc, data, n_bytes);
+        if (m_compress)
+        {
+#if defined(XTENSOR_USE_ZLIB)
+            detail::zip_deflater deflater(m_stream);
+            deflater.write(header.data(), header.size());
+            deflater.write(data, n_bytes);
+            en.compressed_size = deflater.finish();
+#endif
+        }
+        else
+        {
+            m_stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+            m_stream.write(data, static_cast<std::streamsize>(n_bytes));
+        }
+        check_stream();
+        if (!zip64 && en.compressed_size >= detail::zip_u32_max)
+        {
+            XTENSOR_THROW(std::runtime_error, "npz error: compressed member too large.");
+        }
+
+        std::string patch;
+        detail::zip_write(patch, en.crc, 4);
+        if (!zip64)
+        {
+            detail::zip_write(patch, en.compressed_size, 4);
+        }
+        m_stream.seekp(static_cast<std::streamoff>(en.local_offset + 14), std::ios_base::beg);
+        m_stream.write(patch.data(), static_cast<std::streamsize>(patch.size()));
+        if (zip64)
+        {
+            patch.clear();
+            detail::zip_write(patch, en.compressed_size, 8);
+            m_stream.seekp(static_cast<std::streamoff>(en.local_offset + detail::zip_local_header_size
+                                                       + en.name.size() + 12),
+                           std::ios_base::beg);
+            m_stream.write(patch.data(), static_cast<std::streamsize>(patch.size()));
+        }
+        m_stream.seekp(0, std::ios_base::end);
+        check_stream();
+    }
+
+    inline void npz_writer::write_directory()
+    {
+        std::uint64_t directory_offset = static_cast<std::uint64_t>(m_stream.tellp());
+        std::string directory;
+        for (const auto& en : m_entries)
+        {
+            bool large_size = en.size >= detail::zip_u32_max || en.compressed_size >= detail::zip_u32_max;
+            bool large_offset = en.local_offset >= detail::zip_u32_max;
+            std::string extra;
+            if (large_size || large_offset)
+            {
+                detail::zip_write(extra, detail::zip64_extra_id, 2);
+                detail::zip_write(extra, (large_size ? 16u : 0u) + (large_offset ? 8u : 0u), 2);
+                if (large_size)
+                {
+                    detail::zip_write(extra, en.size, 8);
+                    detail::zip_write(extra, en.compressed_size, 8);
+                }
+                if (large_offset)
+                {
+                    detail::zip_write(extra, en.local_offset, 8);
+                }
+            }
+            std::uint64_t version = extra.empty() ? 20 : 45;
+            detail::zip_write(directory, detail::zip_central_signature, 4);
+            detail::zip_write(directory, version, 2);
+            detail::zip_write(directory, version, 2);
+            detail::zip_write(directory, en.flags, 2);
+            detail::zip_write(directory, en.method, 2);
+            detail::zip_write(directory, 0, 2);
+            detail::zip_write(directory, detail::zip_dos_date, 2);
+            detail::zip_write(directory, en.crc, 4);
+            detail::zip_write(directory, large_size ? detail::zip_u32_max : en.compressed_size, 4);
+            detail::zip_write(directory, large_size ? detail::zip_u32_max : en.size, 4);
+            detail::zip_write(directory, en.name.size(), 2);
+            detail::zip_write(directory, extra.size(), 2);
+            detail::zip_write(directory, 0, 2);
+            detail::zip_write(directory, 0, 2);
+            detail::zip_write(directory, 0, 2);
+            detail::zip_write(directory, 0, 4);
+            detail::zip_write(directory, large_offset ? detail::zip_u32_max : en.local_offset, 4);
+            directory += en.name;
+            directory += extra;
+        }
+
+        std::uint64_t n_entries = m_entries.size();
+        std::uint64_t directory_size = directory.size();
+        bool zip64 = n_entries >= detail::zip_u16_max || directory_size >= detail::zip_u32_max
+                     || directory_offset >= detail::zip_u32_max;
+        if (zip64)
+        {
+            std::uint64_t end64_offset = directory_offset + directory_size;
+            detail::zip_write(directory, detail::zip64_end_signature, 4);
+            detail::zip_write(directory, detail::zip64_end_size - 12, 8);
+            detail::zip_write(directory, 45, 2);
+            detail::zip_write(directory, 45, 2);
+            detail::zip_write(directory, 0, 4);
+            detail::zip_write(directory, 0, 4);
+            detail::zip_write(directory, n_entries, 8);
+            detail::zip_write(directory, n_entries, 8);
+            detail::zip_write(directory, directory_size, 8);
+            detail::zip_write(directory, directory_offset, 8);
+            detail::zip_write(directory, detail::zip64_locator_signature, 4);
+            detail::zip_write(directory, 0, 4);
+            detail::zip_write(directory, end64_offset, 8);
+            detail::zip_write(directory, 1, 4);
+        }
+        detail::zip_write(directory, detail::zip_end_signature, 4);
+        detail::zip_write(directory, 0, 2);
+        detail::zip_write(directory, 0, 2);
+        detail::zip_write(directory, (std::min)(n_entries, detail::zip_u16_max), 2);
+        detail::zip_write(directory, (std::min)(n_entries, detail::zip_u16_max), 2);
+        detail::zip_write(directory, (std::min)(directory_size, detail::zip_u32_max), 4);
+        detail::zip_write(directory, (std::min)(directory_offset, detail::zip_u32_max), 4);
+        detail::zip_write(directory, 0, 2);
+        m_stream.write(directory.data(), static_cast<std::streamsize>(directory.size()));
+    }
+
+    inline void npz_writer::check_stream() const
+    {
+        if (!m_stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed writing file: "s + m_filename);
+        }
+    }
+
+    namespace detail
+    {
+        inline void add_npz(npz_writer&)
+        {
+        }
+
+        template <class E, class... Args>
+        inline void add_npz(npz_writer& writer, const std::string& name, const xexpression<E>& e,
+                            const Args&... args)
+        {
+            writer.add(name, e);
+            add_npz(writer, args...);
+        }
+    }
+
+    /**
+     * Save xexpressions to a npz archive (the numpy storage format for
+     * several arrays), without compression like numpy.savez
+     *
+     * @code{.cpp}
+     * xt::dump_npz("bundle.npz", "weights", weights, "bias", bias);
+     * @endcode
+     *
+     * @param filename The filename or path to dump the data
+     * @param name the name of the first array
+     * @param e the first xexpression
+     * @param args the names and xexpressions of the other arrays
+     */
+    template <class E, class... Args>
+    inline void dump_npz(const std::string& filename, const std::string& name, const xexpression<E>& e,
+                         const Args&... args)
+    {
+        npz_writer writer(filename);
+        detail::add_npz(writer, name, e, args...);
+        writer.close();
+    }
+}
+
+#endif
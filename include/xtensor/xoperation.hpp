@@ -11,11 +11,19 @@
 #define XTENSOR_OPERATION_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
+#include "xbit_vector.hpp"
+#include "xexecution.hpp"
 #include "xfunction.hpp"
 #include "xscalar.hpp"
 #include "xstrides.hpp"
@@ -157,12 +165,69 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
                 {
                     return static_cast<R>(arg);
                 }
-                // SIMD conversion disabled for now since it does not make sense
-                // in most of the cases
-                /*constexpr simd_result_type simd_apply(const simd_value_type& arg) const
+
+                // The arguments of an xfunction are loaded as batches of
+                // the requested type, the conversion to R is therefore done
+                // by the vectorized load of the argument when R is the
+                // requested type. Other batch types are not accepted, since
+                // the values would not go through R.
+                template <class B, class = std::enable_if_t<std::is_arithmetic<R>::value
+                                                            && !std::is_same<R, bool>::value
+                                                            && std::is_same<B, xt_simd::simd_type<R>>::value>>
+                constexpr B simd_apply(const B& arg) const
                 {
-                    return static_cast<R>(arg);
-                }*/
+                    return arg;
+                }
+            };
+        };
+
+        // Conversion of arithmetic values clamping them to the range of R;
+        // NaN is converted to 0 for integral results.
+        template <class R, class A>
+        constexpr std::enable_if_t<!std::is_integral<R>::value || std::is_same<R, bool>::value, R>
+        saturate(const A& arg)
+        {
+            return static_cast<R>(arg);
+        }
+
+        template <class R, class A>
+        constexpr std::enable_if_t<std::is_integral<R>::value && !std::is_same<R, bool>::value
+                                   && std::is_floating_point<A>::value, R>
+        saturate(const A& arg)
+        {
+            // The bounds of R may not be representable in A and are rounded:
+            // the comparisons with them select the bound before converting.
+            return arg != arg ? R(0)
+                : arg <= static_cast<A>((std::numeric_limits<R>::min)()) ? (std::numeric_limits<R>::min)()
+                : arg >= static_cast<A>((std::numeric_limits<R>::max)()) ? (std::numeric_limits<R>::max)()
+                : static_cast<R>(arg);
+        }
+
+        template <class R, class A>
+        constexpr std::enable_if_t<std::is_integral<R>::value && !std::is_same<R, bool>::value
+                                   && std::is_integral<A>::value, R>
+        saturate(const A& arg)
+        {
+            return (std::is_signed<A>::value && arg < A(0))
+                ? (!std::is_signed<R>::value ? R(0)
+                   : static_cast<std::intmax_t>(arg) < static_cast<std::intmax_t>((std::numeric_limits<R>::min)())
+                       ? (std::numeric_limits<R>::min)() : static_cast<R>(arg))
+                : (static_cast<std::uintmax_t>(arg) > static_cast<std::uintmax_t>((std::numeric_limits<R>::max)())
+                       ? (std::numeric_limits<R>::max)() : static_cast<R>(arg));
+        }
+
+        template <class R>
+        struct saturate_cast
+        {
+            struct functor
+            {
+                using result_type = R;
+
+                template <class A1>
+                constexpr result_type operator()(const A1& arg) const
+                {
+                    return saturate<R>(arg);
+                }
             };
         };
 
@@ -215,6 +280,25 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
 #undef UNARY_OPERATOR_FUNCTOR
 #undef BINARY_OPERATOR_FUNCTOR
 
+#define WRAPPING_FUNCTOR(NAME)                          \
+    template <>                                         \
+    struct is_wrapping_functor<detail::NAME>            \
+        : std::true_type                                \
+    {                                                   \
+    }
+
+    WRAPPING_FUNCTOR(identity);
+    WRAPPING_FUNCTOR(negate);
+    WRAPPING_FUNCTOR(plus);
+    WRAPPING_FUNCTOR(minus);
+    WRAPPING_FUNCTOR(multiplies);
+    WRAPPING_FUNCTOR(bitwise_or);
+    WRAPPING_FUNCTOR(bitwise_and);
+    WRAPPING_FUNCTOR(bitwise_xor);
+    WRAPPING_FUNCTOR(bitwise_not);
+
+#undef WRAPPING_FUNCTOR
+
     /*************
      * operators *
      *************/
@@ -636,6 +720,230 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
         return detail::make_xfunction<detail::greater_equal>(std::forward<E1>(e1), std::forward<E2>(e2));
     }
 
+    namespace detail
+    {
+        /************************
+         * short-circuit search *
+         ************************/
+
+        // any, all and operator== stop at the first block holding a decisive
+        // element. The blocks are long enough to amortize the check and short
+        // enough not to evaluate much past that element.
+        constexpr std::size_t short_circuit_block_size = 1024;
+        // Length of the chunks searched concurrently for huge expressions
+        constexpr std::size_t short_circuit_chunk_size = 65536;
+
+        inline bool use_parallel_short_circuit(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            return size >= 2 * short_circuit_chunk_size && size >= exec::default_threshold();
+#else
+            (void) size;
+            return false;
+#endif
+        }
+
+        template <class E, class = void>
+        struct has_linear_traversal : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_linear_traversal<E, void_t<decltype(std::declval<const E&>().has_linear_assign(std::declval<const get_strides_t<typename E::shape_type>&>())),
+                                              decltype(linear_begin(std::declval<const E&>()))>>
+            : std::true_type
+        {
+        };
+
+        // Whether the elements of e can be read with linear_begin and
+        // load_simd in row-major order
+        template <class E>
+        inline bool is_linear_traversable(const E& e, std::true_type)
+        {
+            using strides_type = get_strides_t<typename E::shape_type>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), 0);
+            compute_strides(e.shape(), layout_type::row_major, strides);
+            return e.has_linear_assign(strides);
+        }
+
+        template <class E>
+        inline bool is_linear_traversable(const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class E>
+        inline bool is_linear_traversable(const E& e)
+        {
+            return is_linear_traversable(e, has_linear_traversal<E>());
+        }
+
+        template <class E>
+        struct use_simd_short_circuit
+        {
+            using value_type = typename E::value_type;
+            static constexpr bool value = has_simd_interface<E, value_type>::value
+                && has_simd_type<value_type>::value
+                && std::is_arithmetic<value_type>::value
+                && !std::is_same<value_type, bool>::value;
+        };
+
+        /**
+         * Returns whether found(first, last) is true for one of the blocks
+         * splitting [0, n). The search stops at the first block found, or,
+         * when the blocks are searched concurrently, shortly after.
+         */
+        template <class F>
+        inline bool find_block(std::size_t n, F&& found)
+        {
+            if (!use_parallel_short_circuit(n))
+            {
+                for (std::size_t i = 0; i < n; i += short_circuit_block_size)
+                {
+                    if (found(i, (std::min)(i + short_circuit_block_size, n)))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            std::atomic<bool> res(false);
+            std::size_t n_chunks = (n + short_circuit_chunk_size - 1) / short_circuit_chunk_size;
+            exec::default_policy().for_range(std::size_t(0), n_chunks, std::size_t(1),
+                                             [&](std::size_t chunk_begin, std::size_t chunk_end)
+            {
+                for (std::size_t c = chunk_begin; c < chunk_end; ++c)
+                {
+                    std::size_t last = (std::min)((c + 1) * short_circuit_chunk_size, n);
+                    for (std::size_t i = c * short_circuit_chunk_size; i < last; i += short_circuit_block_size)
+                    {
+                        if (res.load(std::memory_order_relaxed))
+                        {
+                            return;
+                        }
+                        if (found(i, (std::min)(i + short_circuit_block_size, last)))
+                        {
+                            res.store(true, std::memory_order_relaxed);
+                            return;
+                        }
+                    }
+                }
+            });
+            return res.load();
+        }
+
+        // Returns whether an element of e in [first, last) is truthy
+        // (truthy = true) or falsy (truthy = false)
+        template <class E>
+        inline bool find_truth(const E& e, std::size_t first, std::size_t last, bool truthy, std::false_type /*use_simd*/)
+        {
+            using value_type = typename E::value_type;
+            auto it = linear_begin(e) + static_cast<std::ptrdiff_t>(first);
+            return std::any_of(it, it + static_cast<std::ptrdiff_t>(last - first),
+                               [truthy](const value_type& el) { return static_cast<bool>(el) == truthy; });
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class E>
+        inline bool find_truth(const E& e, std::size_t first, std::size_t last, bool truthy, std::true_type /*use_simd*/)
+        {
+            using value_type = typename E::value_type;
+            using size_type = typename E::size_type;
+            using batch_type = xt_simd::simd_type<value_type>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<value_type>::size;
+            const batch_type zero(value_type(0));
+            std::size_t i = first;
+            for (; i + simd_size <= last; i += simd_size)
+            {
+                auto b = e.template load_simd<unaligned_mode, value_type>(static_cast<size_type>(i));
+                if (truthy ? xsimd::any(b != zero) : xsimd::any(b == zero))
+                {
+                    return true;
+                }
+            }
+            return find_truth(e, i, last, truthy, std::false_type());
+        }
+#endif
+
+        template <class E>
+        inline bool find_truth(const E& e, bool truthy)
+        {
+            using use_simd = std::integral_constant<bool, use_simd_short_circuit<E>::value>;
+            return find_block(e.size(), [&e, truthy](std::size_t first, std::size_t last)
+            {
+                return find_truth(e, first, last, truthy, use_simd());
+            });
+        }
+
+        // Returns whether e1 and e2 differ in [first, last)
+        template <class E1, class E2>
+        inline bool find_mismatch(const E1& e1, const E2& e2, std::size_t first, std::size_t last, std::false_type /*use_simd*/)
+        {
+            auto it1 = linear_begin(e1) + static_cast<std::ptrdiff_t>(first);
+            auto it2 = linear_begin(e2) + static_cast<std::ptrdiff_t>(first);
+            return !std::equal(it1, it1 + static_cast<std::ptrdiff_t>(last - first), it2);
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class E1, class E2>
+        inline bool find_mismatch(const E1& e1, const E2& e2, std::size_t first, std::size_t last, std::true_type /*use_simd*/)
+        {
+            using value_type = typename E1::value_type;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<value_type>::size;
+            std::size_t i = first;
+            for (; i + simd_size <= last; i += simd_size)
+            {
+                if (xsimd::any(e1.template load_simd<unaligned_mode, value_type>(static_cast<typename E1::size_type>(i)) !=
+                               e2.template load_simd<unaligned_mode, value_type>(static_cast<typename E2::size_type>(i))))
+                {
+                    return true;
+                }
+            }
+            return find_mismatch(e1, e2, i, last, std::false_type());
+        }
+#endif
+
+        template <class E1, class E2>
+        struct use_linear_equal
+            : xtl::conjunction<has_linear_traversal<E1>,
+                               has_linear_traversal<E2>,
+                               std::is_arithmetic<typename E1::value_type>,
+                               std::is_arithmetic<typename E2::value_type>>
+        {
+        };
+
+        template <class E1, class E2>
+        inline bool linear_equal(const E1& e1, const E2& e2, std::true_type)
+        {
+            if (!is_linear_traversable(e1) || !is_linear_traversable(e2))
+            {
+                return linear_equal(e1, e2, std::false_type());
+            }
+            using use_simd = std::integral_constant<bool, use_simd_short_circuit<E1>::value &&
+                                                          use_simd_short_circuit<E2>::value &&
+                                                          std::is_same<typename E1::value_type, typename E2::value_type>::value>;
+            return !find_block(e1.size(), [&e1, &e2](std::size_t first, std::size_t last)
+            {
+                return find_mismatch(e1, e2, first, last, use_simd());
+            });
+        }
+
+        template <class E1, class E2>
+        inline bool linear_equal(const E1& e1, const E2& e2, std::false_type)
+        {
+            bool res = true;
+            auto iter1 = e1.begin();
+            auto iter2 = e2.begin();
+            auto iter_end = e1.end();
+            while (res && iter1 != iter_end)
+            {
+                res = (*iter1++ == *iter2++);
+            }
+            return res;
+        }
+    }
+
     /**
      * @ingroup comparison_operators
      * @brief Equality
@@ -654,14 +962,7 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
         const E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
         bool res = de1.dimension() == de2.dimension() && std::equal(de1.shape().begin(), de1.shape().end(), de2.shape().begin());
-        auto iter1 = de1.begin();
-        auto iter2 = de2.begin();
-        auto iter_end = de1.end();
-        while (res && iter1 != iter_end)
-        {
-            res = (*iter1++ == *iter2++);
-        }
-        return res;
+        return res && detail::linear_equal(de1, de2, detail::use_linear_equal<E1, E2>());
     }
 
     /**
@@ -864,6 +1165,180 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
             next_idx_impl<L> nii;
             return nii(shape, idx);
         }
+
+        // Length of the blocks compacted independently in parallel
+        constexpr std::size_t compact_block_size = 16384;
+
+        inline bool use_parallel_compaction(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            return size >= 2 * compact_block_size && size >= exec::default_threshold();
+#else
+            (void) size;
+            return false;
+#endif
+        }
+
+        // Iterates over the flat positions of an expression
+        class flat_position_iterator
+        {
+        public:
+
+            explicit flat_position_iterator(std::size_t pos) noexcept
+                : m_pos(pos)
+            {
+            }
+
+            std::size_t operator*() const noexcept
+            {
+                return m_pos;
+            }
+
+            flat_position_iterator& operator++() noexcept
+            {
+                ++m_pos;
+                return *this;
+            }
+
+        private:
+
+            std::size_t m_pos;
+        };
+
+        // Stores the values whose condition is truthy contiguously in out and
+        // returns their number. Every value is stored and the output advanced
+        // by the truth value of its condition, so that the loop has no data
+        // dependent branch; out must hold size elements.
+        template <class CIt, class VIt, class T>
+        inline std::size_t compact_block(CIt& cond, VIt& values, std::size_t size, T* out)
+        {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < size; ++i, ++cond, ++values)
+            {
+                out[n] = static_cast<T>(*values);
+                n += static_cast<bool>(*cond) ? std::size_t(1) : std::size_t(0);
+            }
+            return n;
+        }
+
+        template <class CIt>
+        inline std::size_t count_block(CIt cond, std::size_t size)
+        {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < size; ++i, ++cond)
+            {
+                n += static_cast<bool>(*cond) ? std::size_t(1) : std::size_t(0);
+            }
+            return n;
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        // Contiguous arithmetic conditions are counted a batch at a time, with
+        // one popcount of the mask of the non-zero lanes per batch
+        template <class T>
+        inline std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                (xt_simd::simd_traits<T>::size > 1), std::size_t>
+        count_block(const T* cond, std::size_t size)
+        {
+            using batch_type = xt_simd::simd_type<T>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            const batch_type zero(T(0));
+            std::size_t n = 0;
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                auto mask = xt_simd::load_as<T>(cond + i, unaligned_mode()) != zero;
+                n += popcount(static_cast<std::uint64_t>(mask.mask()));
+            }
+            for (; i < size; ++i)
+            {
+                n += cond[i] != T(0) ? std::size_t(1) : std::size_t(0);
+            }
+            return n;
+        }
+#endif
+
+        template <class C, class P, class CF, class VF>
+        inline C compact_impl(const P& policy, std::size_t size, CF cond_at, VF values_at)
+        {
+            using value_type = typename C::value_type;
+            std::size_t n_blocks = (size + compact_block_size - 1) / compact_block_size;
+            std::vector<std::size_t> offsets(n_blocks + 1, 0);
+            policy.for_range(std::size_t(0), n_blocks, std::size_t(1), [&](std::size_t block_begin, std::size_t block_end)
+            {
+                for (std::size_t b = block_begin; b < block_end; ++b)
+                {
+                    std::size_t first = b * compact_block_size;
+                    offsets[b + 1] = count_block(cond_at(first), (std::min)(compact_block_size, size - first));
+                }
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            C result(offsets.back());
+            policy.for_range(std::size_t(0), n_blocks, std::size_t(1), [&](std::size_t block_begin, std::size_t block_end)
+            {
+                // The branch free store may write one element past the
+                // survivors of a block, blocks are therefore compacted in
+                // a buffer
+                uvector<value_type> buffer((std::min)(compact_block_size, size));
+                for (std::size_t b = block_begin; b < block_end; ++b)
+                {
+                    if (offsets[b + 1] == offsets[b])
+                    {
+                        continue;
+                    }
+                    std::size_t first = b * compact_block_size;
+                    auto cond = cond_at(first);
+                    auto values = values_at(first);
+                    std::size_t n = compact_block(cond, values, (std::min)(compact_block_size, size - first), buffer.data());
+                    std::copy(buffer.cbegin(), buffer.cbegin() + std::ptrdiff_t(n), result.begin() + std::ptrdiff_t(offsets[b]));
+                }
+            });
+            return result;
+        }
+
+        // Returns the values of the truthy elements of a condition of the
+        // specified size, cond_at(i) and values_at(i) returning iterators on
+        // the condition and on the values starting at the flat position i.
+        // The survivors of each block are counted, then written at the prefix
+        // sum of the counts, so that the result is allocated once with its
+        // final size. Large conditions are compacted in parallel.
+        template <class T, class C = uvector<T>, class CF, class VF>
+        inline C compact(std::size_t size, CF cond_at, VF values_at)
+        {
+            if (!use_parallel_compaction(size))
+            {
+                return compact_impl<C>(exec::sequenced_policy(), size, cond_at, values_at);
+            }
+            return compact_impl<C>(exec::default_policy(), size, cond_at, values_at);
+        }
+
+        // Calls f(cond_at) with a function returning an iterator on the
+        // elements of e in the order L, starting at a flat position. Linear
+        // iterators are used when e allows them.
+        template <layout_type L, class E, class F>
+        inline auto apply_on_traversal(const E& e, F&& f)
+        {
+            using strides_type = get_strides_t<typename E::shape_type>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), 0);
+            compute_strides(e.shape(), L, strides);
+            if (e.has_linear_assign(strides))
+            {
+                return f([&e](std::size_t first) { return e.linear_cbegin() + std::ptrdiff_t(first); });
+            }
+            return f([&e](std::size_t first) { return e.template cbegin<L>() + std::ptrdiff_t(first); });
+        }
+
+        // Flat positions, in the order L, of the truthy elements of e,
+        // stored in a container of type C
+        template <layout_type L, class E, class C = uvector<std::size_t>>
+        inline C flat_nonzero(const E& e)
+        {
+            return apply_on_traversal<L>(e, [&e](auto cond_at)
+            {
+                return compact<typename C::value_type, C>(e.size(), cond_at, [](std::size_t first) { return flat_position_iterator(first); });
+            });
+        }
     }
 
     /**
@@ -877,22 +1352,20 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     template <class T>
     inline auto nonzero(const T& arr)
     {
-        auto shape = arr.shape();
         using index_type = xindex_type_t<typename T::shape_type>;
         using size_type = typename T::size_type;
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
-        std::vector<std::vector<size_type>> indices(arr.dimension());
-
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx(shape, idx))
+        std::size_t dim = arr.dimension();
+        auto flat = detail::flat_nonzero<XTENSOR_DEFAULT_TRAVERSAL>(arr);
+        auto plan = unravel_plan(arr.shape(), XTENSOR_DEFAULT_TRAVERSAL);
+        auto idx = xtl::make_sequence<index_type>(dim, 0);
+        std::vector<std::vector<size_type>> indices(dim, std::vector<size_type>(flat.size()));
+        for (std::size_t i = 0; i < flat.size(); ++i)
         {
-            if (arr.element(std::begin(idx), std::end(idx)))
+            plan.unravel(static_cast<std::ptrdiff_t>(flat[i]), idx);
+            for (std::size_t n = 0; n < dim; ++n)
             {
-                for (std::size_t n = 0; n < indices.size(); ++n)
-                {
-                    indices.at(n).push_back(idx[n]);
-                }
+                indices[n][i] = static_cast<size_type>(idx[n]);
             }
         }
 
@@ -923,26 +1396,58 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
      *
      * @sa xt::from_indices
      */
-    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class T>
-    inline auto argwhere(const T& arr)
+    namespace detail
     {
-        auto shape = arr.shape();
-        using index_type = xindex_type_t<typename T::shape_type>;
-        using size_type = typename T::size_type;
+        // The flat positions of the truthy elements are compacted first, then
+        // unraveled
+        template <layout_type L, class T>
+        inline auto argwhere_impl(const T& arr, std::false_type /*is_bit_array*/)
+        {
+            using index_type = xindex_type_t<typename T::shape_type>;
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
-        std::vector<index_type> indices;
+            auto flat = flat_nonzero<L>(arr);
+            auto plan = unravel_plan(arr.shape(), L);
+            std::vector<index_type> indices(flat.size(), xtl::make_sequence<index_type>(arr.dimension(), 0));
+            for (std::size_t i = 0; i < flat.size(); ++i)
+            {
+                plan.unravel(static_cast<std::ptrdiff_t>(flat[i]), indices[i]);
+            }
+            return indices;
+        }
 
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx<L>(shape, idx))
+        // The set bits of a packed mask stored in the traversal order are
+        // found a block at a time
+        template <layout_type L, class T>
+        inline auto argwhere_impl(const T& arr, std::true_type /*is_bit_array*/)
         {
-            if (arr.element(std::begin(idx), std::end(idx)))
+            if (arr.layout() != L)
             {
-                indices.push_back(idx);
+                return argwhere_impl<L>(arr, std::false_type());
             }
+            using index_type = xindex_type_t<typename T::shape_type>;
+            const auto& shape = arr.shape();
+            std::size_t dim = arr.dimension();
+            std::vector<index_type> indices;
+            indices.reserve(arr.storage().count());
+            detail::for_each_set_bit(arr.storage().blocks(), arr.size(), [&](std::size_t flat)
+            {
+                auto idx = xtl::make_sequence<index_type>(dim, 0);
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    std::size_t axis = L == layout_type::row_major ? dim - 1 - d : d;
+                    idx[axis] = flat % shape[axis];
+                    flat /= shape[axis];
+                }
+                indices.push_back(std::move(idx));
+            });
+            return indices;
         }
+    }
 
-        return indices;
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class T>
+    inline auto argwhere(const T& arr)
+    {
+        return detail::argwhere_impl<L>(arr, std::integral_constant<bool, is_bit_array<T>::value>());
     }
 
     /**
@@ -950,7 +1455,9 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     * @brief Any
     *
     * Returns true if any of the values of \a e is truthy,
-    * false otherwise.
+    * false otherwise. Expressions that can be traversed linearly are
+    * searched by blocks, with SIMD instructions when they provide them,
+    * and the search stops at the first block holding a truthy value.
     * @param e an \ref xexpression
     * @return a boolean
     */
@@ -959,6 +1466,10 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     {
         using xtype = std::decay_t<E>;
         using value_type = typename xtype::value_type;
+        if (detail::is_linear_traversable(e))
+        {
+            return detail::find_truth(e, true);
+        }
         return std::any_of(e.cbegin(), e.cend(), [](const value_type& el) { return el; });
     }
 
@@ -967,7 +1478,8 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     * @brief Any
     *
     * Returns true if all of the values of \a e are truthy,
-    * false otherwise.
+    * false otherwise. Like any, the search stops at the first
+    * block holding a falsy value.
     * @param e an \ref xexpression
     * @return a boolean
     */
@@ -976,6 +1488,10 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     {
         using xtype = std::decay_t<E>;
         using value_type = typename xtype::value_type;
+        if (detail::is_linear_traversable(e))
+        {
+            return !detail::find_truth(e, false);
+        }
         return std::all_of(e.cbegin(), e.cend(), [](const value_type& el) { return el; });
     }
 
@@ -1001,6 +1517,32 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
         return detail::make_xfunction<typename detail::cast<R>::functor>(std::forward<E>(e));
     }
 
+    /**
+     * @ingroup casting_operators
+     * @brief Element-wise saturating conversion.
+     *
+     * Returns an \ref xfunction converting the elements of \a e to the
+     * arithmetic type R, the values out of the range of R being clamped to
+     * its bounds instead of overflowing, and NaN being converted to 0 when
+     * R is integral.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = {-1., 3.7, 300., NAN};
+     * xt::xarray<std::uint8_t> b = xt::saturate_cast<std::uint8_t>(a);
+     * // b = {0, 3, 255, 0}
+     * \endcode
+     *
+     * @param e an \ref xexpression or a scalar
+     * @return an \ref xfunction
+     */
+    template <class R, class E>
+    inline auto saturate_cast(E&& e) noexcept
+        -> detail::xfunction_type_t<typename detail::saturate_cast<R>::functor, E>
+    {
+        static_assert(std::is_arithmetic<R>::value, "saturate_cast requires an arithmetic result type");
+        return detail::make_xfunction<typename detail::saturate_cast<R>::functor>(std::forward<E>(e));
+    }
+
 }
 
 #endif
@@ -10,6 +10,8 @@
 #ifndef XTENSOR_OPTIONAL_HPP
 #define XTENSOR_OPTIONAL_HPP
 
+#include <algorithm>
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 
@@ -266,6 +268,9 @@ namespace xt
 
         template <class E1, class E2>
         static void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
+
+        template <class E1, class E2, class P>
+        static void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, const P& policy);
     };
 
     /**********************************
@@ -1263,6 +1268,238 @@ namespace xt
 
     namespace detail
     {
+        /********************
+         * flags assignment *
+         ********************/
+
+        // The flags of an optional expression are the conjunction of the
+        // flags of its operands. When these flags are held in containers
+        // with the same shape and layout as the destination, they are
+        // combined directly from the storages one word at a time: a
+        // block of 64 flags for xbit_array, a single flag for contiguous
+        // bool containers. Both loops are vectorized by the compiler,
+        // unlike the generic assignment which steps through the xfunction.
+
+        struct bit_flags_tag
+        {
+            using word_type = std::uint64_t;
+
+            static constexpr word_type fill(bool b) noexcept
+            {
+                return b ? ~word_type(0) : word_type(0);
+            }
+        };
+
+        struct byte_flags_tag
+        {
+            using word_type = bool;
+
+            static constexpr word_type fill(bool b) noexcept
+            {
+                return b;
+            }
+        };
+
+        template <class E, class = void>
+        struct is_byte_flag_array_impl : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_byte_flag_array_impl<E, void_t<typename E::storage_type>>
+            : xtl::conjunction<std::is_base_of<xcontainer<E>, E>,
+                               std::is_same<decltype(std::declval<const E&>().data()), const bool*>>
+        {
+        };
+
+        template <class K, class E>
+        struct is_flag_array;
+
+        template <class E>
+        struct is_flag_array<bit_flags_tag, E> : is_bit_array<E>
+        {
+        };
+
+        template <class E>
+        struct is_flag_array<byte_flags_tag, E> : is_byte_flag_array_impl<std::decay_t<E>>
+        {
+        };
+
+        // Flag expressions whose words can be computed from the storages:
+        // the flag arrays, the scalar flags and the conjunctions of flags
+        // built by the operations on optional expressions.
+        template <class K, class E>
+        struct is_flag_word_expression : is_flag_array<K, E>
+        {
+        };
+
+        template <class K, class CT>
+        struct is_flag_word_expression<K, xscalar<CT>> : std::true_type
+        {
+        };
+
+        template <class K, class... CT>
+        struct is_flag_word_expression<K, xfunction<optional_bitwise<bool>, CT...>>
+            : xtl::conjunction<is_flag_word_expression<K, std::decay_t<CT>>...>
+        {
+        };
+
+        // Checks whether the flags of e can be combined with flags of the
+        // given shape and layout, and computes the word w
+        template <class K, class E, class = void>
+        struct flag_words;
+
+        template <class E>
+        struct flag_words<bit_flags_tag, E, std::enable_if_t<is_bit_array<E>::value>>
+        {
+            template <class S>
+            static bool match(const E& e, const S& shape, layout_type l)
+            {
+                return e.layout() == l && std::equal(e.shape().cbegin(), e.shape().cend(), shape.cbegin(), shape.cend());
+            }
+
+            static std::uint64_t word(const E& e, std::size_t w)
+            {
+                return e.storage().blocks()[w];
+            }
+        };
+
+        template <class E>
+        struct flag_words<byte_flags_tag, E, std::enable_if_t<is_flag_array<byte_flags_tag, E>::value>>
+        {
+            template <class S>
+            static bool match(const E& e, const S& shape, layout_type l)
+            {
+                return e.layout() == l && e.is_contiguous()
+                    && std::equal(e.shape().cbegin(), e.shape().cend(), shape.cbegin(), shape.cend());
+            }
+
+            static bool word(const E& e, std::size_t w)
+            {
+                return e.data()[e.data_offset() + w];
+            }
+        };
+
+        template <class K, class CT>
+        struct flag_words<K, xscalar<CT>>
+        {
+            template <class S>
+            static bool match(const xscalar<CT>&, const S&, layout_type)
+            {
+                return true;
+            }
+
+            static typename K::word_type word(const xscalar<CT>& e, std::size_t)
+            {
+                return K::fill(e());
+            }
+        };
+
+        template <class K, class... CT>
+        struct flag_words<K, xfunction<optional_bitwise<bool>, CT...>>
+        {
+            using function_type = xfunction<optional_bitwise<bool>, CT...>;
+            using tuple_type = typename function_type::tuple_type;
+            using word_type = typename K::word_type;
+
+            template <class S>
+            static bool match(const function_type& e, const S& shape, layout_type l)
+            {
+                return match_impl(e.arguments(), shape, l, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+            static word_type word(const function_type& e, std::size_t w)
+            {
+                return word_impl(e.arguments(), w, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+        private:
+
+            template <class S>
+            static bool match_impl(const tuple_type&, const S&, layout_type, std::index_sequence<>)
+            {
+                return true;
+            }
+
+            template <class S, std::size_t I, std::size_t... J>
+            static bool match_impl(const tuple_type& args, const S& shape, layout_type l, std::index_sequence<I, J...>)
+            {
+                using arg_type = std::decay_t<std::tuple_element_t<I, tuple_type>>;
+                return flag_words<K, arg_type>::match(std::get<I>(args), shape, l)
+                    && match_impl(args, shape, l, std::index_sequence<J...>());
+            }
+
+            static word_type word_impl(const tuple_type&, std::size_t, std::index_sequence<>)
+            {
+                return K::fill(true);
+            }
+
+            template <std::size_t I, std::size_t... J>
+            static word_type word_impl(const tuple_type& args, std::size_t w, std::index_sequence<I, J...>)
+            {
+                using arg_type = std::decay_t<std::tuple_element_t<I, tuple_type>>;
+                return word_type(flag_words<K, arg_type>::word(std::get<I>(args), w)
+                                 & word_impl(args, w, std::index_sequence<J...>()));
+            }
+        };
+
+        template <class E1, class E2>
+        inline void assign_flag_words(E1& e1, const E2& e2, bit_flags_tag)
+        {
+            auto& storage = e1.storage();
+            std::uint64_t* out = storage.blocks();
+            const std::size_t n = storage.block_count();
+            for (std::size_t b = 0; b < n; ++b)
+            {
+                out[b] = flag_words<bit_flags_tag, E2>::word(e2, b);
+            }
+            const std::size_t used = storage.size() % 64;
+            if (used != 0)
+            {
+                out[n - 1] &= (std::uint64_t(1) << used) - 1u;
+            }
+        }
+
+        template <class E1, class E2>
+        inline void assign_flag_words(E1& e1, const E2& e2, byte_flags_tag)
+        {
+            bool* out = e1.data() + e1.data_offset();
+            const std::size_t n = e1.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = flag_words<byte_flags_tag, E2>::word(e2, i);
+            }
+        }
+
+        template <class K, class E1, class E2>
+        inline void assign_flags_impl(E1& e1, const E2& e2, bool trivial, K tag, std::true_type)
+        {
+            bool dense = e1.layout() != layout_type::dynamic && e1.is_contiguous();
+            if (!dense || !flag_words<K, E2>::match(e2, e1.shape(), e1.layout()))
+            {
+                xexpression_assigner_base<xtensor_expression_tag>::assign_data(e1, e2, trivial);
+                return;
+            }
+            assign_flag_words(e1, e2, tag);
+        }
+
+        template <class K, class E1, class E2>
+        inline void assign_flags_impl(E1& e1, const E2& e2, bool trivial, K, std::false_type)
+        {
+            xexpression_assigner_base<xtensor_expression_tag>::assign_data(e1, e2, trivial);
+        }
+
+        // Assigns the flags of an optional expression, combining the
+        // flag storages word by word when they allow it
+        template <class E1, class E2>
+        inline void assign_flags(E1& e1, const E2& e2, bool trivial)
+        {
+            using tag_type = std::conditional_t<is_bit_array<E1>::value, bit_flags_tag, byte_flags_tag>;
+            using use_words = xtl::conjunction<is_flag_array<tag_type, E1>,
+                                               is_flag_word_expression<tag_type, std::decay_t<E2>>>;
+            assign_flags_impl(e1, e2, trivial, tag_type(), use_words());
+        }
+
         template <class T1, class T2>
         struct assign_data_impl
         {
@@ -1275,7 +1512,7 @@ namespace xt
                 decltype(auto) bde1 = xt::value(de1);
                 decltype(auto) hde1 = xt::has_value(de1);
                 xexpression_assigner_base<xtensor_expression_tag>::assign_data(bde1, xt::value(de2), trivial);
-                xexpression_assigner_base<xtensor_expression_tag>::assign_data(hde1, xt::has_value(de2), trivial);
+                assign_flags(hde1, xt::has_value(de2), trivial);
             }
         };
 
@@ -1331,7 +1568,15 @@ namespace xt
     inline void xexpression_assigner_base<xoptional_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
     {
         detail::assign_data_impl<typename E1::expression_tag, typename E2::expression_tag>::run(e1, e2, trivial);
-    } 
+    }
+
+    template <class E1, class E2, class P>
+    inline void xexpression_assigner_base<xoptional_expression_tag>::assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, const P&)
+    {
+        // Optional assignments are split into value and flag assignments,
+        // which run with the default execution policy.
+        assign_data(e1, e2, trivial);
+    }
 }
 
 #endif
@@ -10,6 +10,13 @@
 #ifndef XOPTIONAL_ASSEMBLY_HPP
 #define XOPTIONAL_ASSEMBLY_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "xbit_vector.hpp"
+#include "xbuffer_adaptor.hpp"
 #include "xoptional.hpp"
 #include "xoptional_assembly_base.hpp"
 #include "xsemantic.hpp"
@@ -662,6 +669,55 @@ namespace xt
     {
         return m_has_value;
     }
+
+    /****************
+     * adapt_bitmap *
+     ****************/
+
+    /**
+     * Adapts a buffer of values and its validity bitmap in the layout of
+     * Apache Arrow as an xoptional_assembly_adaptor, without copying them.
+     * The element i is missing when the bit offset + i of the bitmap is not
+     * set. A null bitmap stands for an array without missing values, as in
+     * Arrow; the adaptor then holds its own bitmap.
+     *
+     * \code{.cpp}
+     * // arr is a std::shared_ptr<arrow::DoubleArray>
+     * std::vector<std::size_t> shape = {static_cast<std::size_t>(arr->length())};
+     * auto a = xt::adapt_bitmap(arr->raw_values(), arr->null_bitmap_data(),
+     *                           static_cast<std::size_t>(arr->offset()), shape, arr);
+     * \endcode
+     *
+     * @param values pointer to the values of the elements
+     * @param bitmap pointer to the validity bitmap, std::uint8_t or
+     *               const std::uint8_t
+     * @param offset the index of the bit of the first element in the bitmap
+     * @param shape the shape of the adaptor
+     * @param owner an optional owner of both buffers, kept alive by the adaptor
+     * @param l the layout_type of the adaptor
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class T, class B, class SC>
+    inline auto adapt_bitmap(T* values, B* bitmap, std::size_t offset, const SC& shape,
+                             std::shared_ptr<const void> owner = std::shared_ptr<const void>(),
+                             layout_type l = L)
+    {
+        using value_buffer = xbuffer_adaptor<T*, smart_ownership, std::shared_ptr<const void>>;
+        using value_adaptor = xarray_adaptor<value_buffer, L, std::decay_t<SC>>;
+        using flag_adaptor = xarray_adaptor<xbitmap_adaptor<B>, L, std::decay_t<SC>>;
+        using return_type = xoptional_assembly_adaptor<value_adaptor, flag_adaptor>;
+
+        std::size_t size = compute_size(shape);
+        std::shared_ptr<const void> flag_owner = owner;
+        if (bitmap == nullptr)
+        {
+            auto ones = std::make_shared<std::vector<std::uint8_t>>((size + 7) / 8, std::uint8_t(0xff));
+            bitmap = ones->data();
+            offset = 0;
+            flag_owner = std::move(ones);
+        }
+        return return_type(value_adaptor(value_buffer(values, size, std::move(owner)), shape, l),
+                           flag_adaptor(xbitmap_adaptor<B>(bitmap, size, offset, std::move(flag_owner)), shape, l));
+    }
 }
 
 #endif
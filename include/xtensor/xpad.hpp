@@ -10,7 +10,13 @@
 #ifndef XTENSOR_PAD_HPP
 #define XTENSOR_PAD_HPP
 
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
 #include "xarray.hpp"
+#include "xgenerator.hpp"
+#include "xnoalias.hpp"
 #include "xtensor.hpp"
 #include "xview.hpp"
 #include "xstrided_view.hpp"
@@ -56,6 +62,103 @@ namespace xt
 
             return true;
         }
+
+        // Fills the borders of out, whose center already holds the padded
+        // expression of the specified shape, one axis after the other: the
+        // borders along an axis are copied from the center and from the
+        // borders along the previous axes.
+        template <class O, class T, class S, class V>
+        inline void pad_borders(O& out, const T& shape, const std::vector<std::vector<S>>& pad_width, pad_mode mode, V constant_value)
+        {
+            using size_type = typename O::size_type;
+
+            xt::xstrided_slice_vector svs(shape.size(), xt::all());
+            xt::xstrided_slice_vector svt(shape.size(), xt::all());
+
+            for (size_type axis = 0; axis < shape.size(); ++axis)
+            {
+                size_type n = static_cast<size_type>(shape[axis]);
+                size_type nb = static_cast<size_type>(pad_width[axis][0]);
+                size_type ne = static_cast<size_type>(pad_width[axis][1]);
+
+                if (nb > static_cast<size_type>(0))
+                {
+                    svt[axis] = xt::range(0, nb);
+
+                    if (mode == pad_mode::constant)
+                    {
+                        xt::strided_view(out, svt) = constant_value;
+                    }
+                    else
+                    {
+                        if (mode == pad_mode::wrap || mode == pad_mode::periodic)
+                        {
+                            XTENSOR_ASSERT(nb <= n);
+                            svs[axis] = xt::range(n, nb+n);
+                        }
+                        else if (mode == pad_mode::symmetric)
+                        {
+                            XTENSOR_ASSERT(nb <= n);
+                            svs[axis] = xt::range(2*nb-1, nb-1, -1);
+                        }
+                        else if (mode == pad_mode::reflect)
+                        {
+                            XTENSOR_ASSERT(nb <= n - 1);
+                            svs[axis] = xt::range(2*nb, nb, -1);
+                        }
+
+                        xt::strided_view(out, svt) = xt::strided_view(out, svs);
+                    }
+                }
+
+                if (ne > static_cast<size_type>(0))
+                {
+                    svt[axis] = xt::range(out.shape(axis)-ne, out.shape(axis));
+
+                    if (mode == pad_mode::constant)
+                    {
+                        xt::strided_view(out, svt) = constant_value;
+                    }
+                    else
+                    {
+                        if (mode == pad_mode::wrap || mode == pad_mode::periodic)
+                        {
+                            XTENSOR_ASSERT(ne <= n);
+                            svs[axis] = xt::range(nb, nb+ne);
+                        }
+                        else if (mode == pad_mode::symmetric)
+                        {
+                            XTENSOR_ASSERT(ne <= n);
+                            if (ne == nb + n)
+                            {
+                                svs[axis] = xt::range(nb+n-1, _, -1);
+                            }
+                            else
+                            {
+                                svs[axis] = xt::range(nb+n-1, nb+n-ne-1, -1);
+                            }
+                        }
+                        else if (mode == pad_mode::reflect)
+                        {
+                            XTENSOR_ASSERT(ne <= n - 1);
+                            if (ne == nb + n - 1)
+                            {
+                                svs[axis] = xt::range(nb+n-2, _, -1);
+                            }
+                            else
+                            {
+                                svs[axis] = xt::range(nb+n-2, nb+n-ne-2, -1);
+                            }
+                        }
+
+                        xt::strided_view(out, svt) = xt::strided_view(out, svs);
+                    }
+                }
+
+                svs[axis] = xt::all();
+                svt[axis] = xt::all();
+            }
+        }
     }
 
     /**
@@ -96,95 +199,221 @@ namespace xt
             sv.push_back(xt::range(nb, nb + e.shape(axis)));
         }
 
-        if (mode == pad_mode::constant)
-        {
-            return_type out(new_shape, constant_value);
-            xt::strided_view(out, sv) = e;
-            return out;
-        }
-
         return_type out(new_shape);
-        xt::strided_view(out, sv) = e;
+        xt::noalias(xt::strided_view(out, sv)) = e;
+        detail::pad_borders(out, e.shape(), pad_width, mode, constant_value);
+        return out;
+    }
+
+    /**
+     * @brief Pad an array.
+     *
+     * @param e The array.
+     * @param pad_width Number of values padded to the edges of each axis:
+     * `{before, after}`.
+     * @param mode The type of algorithm to use. [default: `xt::pad_mode::constant`].
+     * @param constant_value The value to set the padded values for each axis
+     * (used in `xt::pad_mode::constant`).
+     * @return The padded array.
+     */
+    template <class E,
+              class S = typename std::decay_t<E>::size_type,
+              class V = typename std::decay_t<E>::value_type>
+    inline auto pad(E&& e,
+                    const std::vector<S>& pad_width,
+                    pad_mode mode = pad_mode::constant,
+                    V constant_value = 0)
+    {
+        std::vector<std::vector<S>> pw(e.shape().size(), pad_width);
+
+        return pad(e, pw, mode, constant_value);
+    }
+
+    /**
+     * @brief Pad an array.
+     *
+     * @param e The array.
+     * @param pad_width Number of values padded to the edges of each axis.
+     * @param mode The type of algorithm to use. [default: `xt::pad_mode::constant`].
+     * @param constant_value The value to set the padded values for each axis
+     * (used in `xt::pad_mode::constant`).
+     * @return The padded array.
+     */
+    template <class E,
+              class S = typename std::decay_t<E>::size_type,
+              class V = typename std::decay_t<E>::value_type>
+    inline auto pad(E&& e,
+                    S pad_width,
+                    pad_mode mode = pad_mode::constant,
+                    V constant_value = 0)
+    {
+        std::vector<std::vector<S>> pw(e.shape().size(), {pad_width, pad_width});
 
-        // construct padded regions based on original image
+        return pad(e, pw, mode, constant_value);
+    }
 
-        xt::xstrided_slice_vector svs(e.shape().size(), xt::all());
-        xt::xstrided_slice_vector svt(e.shape().size(), xt::all());
+    /************
+     * pad_view *
+     ************/
 
-        for (size_type axis = 0; axis < e.shape().size(); ++axis)
+    namespace detail
+    {
+        // Maps the index i of a padded axis to the index of the padded
+        // expression, of size n, or returns -1 for the constant borders.
+        inline std::ptrdiff_t pad_index(std::ptrdiff_t i, std::ptrdiff_t n, pad_mode mode) noexcept
         {
-            size_type nb = static_cast<size_type>(pad_width[axis][0]);
-            size_type ne = static_cast<size_type>(pad_width[axis][1]);
+            if (i >= 0 && i < n)
+            {
+                return i;
+            }
+            if (mode == pad_mode::constant || n == 0)
+            {
+                return -1;
+            }
 
-            if (nb > static_cast<size_type>(0))
+            // The symmetric and reflected borders repeat the expression
+            // followed by its mirror, without the edges for reflect
+            std::ptrdiff_t period = n;
+            if (mode == pad_mode::symmetric)
+            {
+                period = 2 * n;
+            }
+            else if (mode == pad_mode::reflect)
             {
-                svt[axis] = xt::range(0, nb);
+                period = n > 1 ? 2 * n - 2 : 1;
+            }
+            std::ptrdiff_t k = i % period;
+            k = k < 0 ? k + period : k;
+            return k < n ? k : period - k - (mode == pad_mode::symmetric ? 1 : 0);
+        }
 
-                if (mode == pad_mode::wrap || mode == pad_mode::periodic)
-                {
-                    XTENSOR_ASSERT(nb <= e.shape(axis));
-                    svs[axis] = xt::range(e.shape(axis), nb+e.shape(axis));
-                }
-                else if (mode == pad_mode::symmetric)
-                {
-                    XTENSOR_ASSERT(nb <= e.shape(axis));
-                    svs[axis] = xt::range(2*nb-1, nb-1, -1);
-                }
-                else if (mode == pad_mode::reflect)
-                {
-                    XTENSOR_ASSERT(nb <= e.shape(axis) - 1);
-                    svs[axis] = xt::range(2*nb, nb, -1);
-                }
+        template <class CT>
+        class pad_access
+        {
+        public:
+
+            using xexpression_type = std::decay_t<CT>;
+            using value_type = typename xexpression_type::value_type;
+            using size_type = typename xexpression_type::size_type;
+            using index_type = xindex_type_t<typename xexpression_type::shape_type>;
 
-                xt::strided_view(out, svt) = xt::strided_view(out, svs);
+            template <class E>
+            pad_access(E&& e, index_type before, pad_mode mode, value_type constant_value)
+                : m_e(std::forward<E>(e)), m_before(std::move(before)), m_mode(mode), m_constant_value(constant_value)
+            {
             }
 
-            if (ne > static_cast<size_type>(0))
+            template <class... Args>
+            inline value_type operator()(Args... args) const
             {
-                svt[axis] = xt::range(out.shape(axis)-ne, out.shape(axis));
+                std::array<size_type, sizeof...(Args)> idx = {{static_cast<size_type>(args)...}};
+                return element(idx.cbegin(), idx.cend());
+            }
 
-                if (mode == pad_mode::wrap || mode == pad_mode::periodic)
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                std::size_t dim = m_e.dimension();
+                std::size_t nb_indices = static_cast<std::size_t>(std::distance(first, last));
+                if (nb_indices > dim)
                 {
-                    XTENSOR_ASSERT(ne <= e.shape(axis));
-                    svs[axis] = xt::range(nb, nb+ne);
+                    std::advance(first, static_cast<std::ptrdiff_t>(nb_indices - dim));
                 }
-                else if (mode == pad_mode::symmetric)
+
+                // Missing leading indices are zero
+                std::size_t missing = dim - (std::min)(nb_indices, dim);
+                index_type idx = xtl::make_sequence<index_type>(dim, size_type(0));
+                for (std::size_t d = 0; d < dim; ++d)
                 {
-                    XTENSOR_ASSERT(ne <= e.shape(axis));
-                    if (ne == nb + e.shape(axis))
+                    std::ptrdiff_t padded = d < missing ? 0 : static_cast<std::ptrdiff_t>(*first++);
+                    std::ptrdiff_t i = pad_index(padded - static_cast<std::ptrdiff_t>(m_before[d]),
+                                                 static_cast<std::ptrdiff_t>(m_e.shape()[d]), m_mode);
+                    if (i < 0)
                     {
-                        svs[axis] = xt::range(nb+e.shape(axis)-1, _, -1);
-                    }
-                    else
-                    {
-                        svs[axis] = xt::range(nb+e.shape(axis)-1, nb+e.shape(axis)-ne-1, -1);
+                        return m_constant_value;
                     }
+                    idx[d] = static_cast<size_type>(i);
                 }
-                else if (mode == pad_mode::reflect)
+                return m_e.element(idx.cbegin(), idx.cend());
+            }
+
+            // The padded expression is copied as a single block in the
+            // center of e, whose borders are then copied from the center.
+            template <class E>
+            inline void assign_to(xexpression<E>& e) const
+            {
+                auto& de = e.derived_cast();
+                std::size_t dim = m_e.dimension();
+                xstrided_slice_vector sv;
+                sv.reserve(dim);
+                std::vector<std::vector<size_type>> pad_width(dim);
+                for (std::size_t d = 0; d < dim; ++d)
                 {
-                    XTENSOR_ASSERT(ne <= e.shape(axis) - 1);
-                    if (ne == nb + e.shape(axis) - 1)
-                    {
-                        svs[axis] = xt::range(nb+e.shape(axis)-2, _, -1);
-                    }
-                    else
-                    {
-                        svs[axis] = xt::range(nb+e.shape(axis)-2, nb+e.shape(axis)-ne-2, -1);
-                    }
+                    size_type nb = static_cast<size_type>(m_before[d]);
+                    size_type n = static_cast<size_type>(m_e.shape()[d]);
+                    sv.push_back(xt::range(nb, nb + n));
+                    pad_width[d] = {nb, static_cast<size_type>(de.shape()[d]) - nb - n};
                 }
-
-                xt::strided_view(out, svt) = xt::strided_view(out, svs);
+                xt::noalias(xt::strided_view(de, sv)) = m_e;
+                pad_borders(de, m_e.shape(), pad_width, m_mode, m_constant_value);
             }
 
-            svs[axis] = xt::all();
-            svt[axis] = xt::all();
-        }
+        private:
 
-        return out;
+            CT m_e;
+            index_type m_before;
+            pad_mode m_mode;
+            value_type m_constant_value;
+        };
     }
 
     /**
-     * @brief Pad an array.
+     * @brief Lazily pad an array.
+     *
+     * Contrary to ``xt::pad``, the padded array is not allocated: the
+     * elements in the borders are mapped to the elements of \c e, or to
+     * \c constant_value, when they are accessed. This is suitable for
+     * stencils that only read a few elements of the borders. When the
+     * view is assigned to a container, \c e is copied as a single block
+     * and the borders are then filled as with ``xt::pad``.
+     *
+     * @param e The array.
+     * @param pad_width Number of values padded to the edges of each axis:
+     * `{{before_1, after_1}, ..., {before_N, after_N}}`.
+     * @param mode The type of algorithm to use. [default: `xt::pad_mode::constant`].
+     * @param constant_value The value to set the padded values for each axis
+     * (used in `xt::pad_mode::constant`).
+     * @return An expression evaluating to the padded array.
+     */
+    template <class E,
+              class S = typename std::decay_t<E>::size_type,
+              class V = typename std::decay_t<E>::value_type>
+    inline auto pad_view(E&& e,
+                         const std::vector<std::vector<S>>& pad_width,
+                         pad_mode mode = pad_mode::constant,
+                         V constant_value = 0)
+    {
+        XTENSOR_ASSERT(detail::check_pad_width(pad_width, e.shape()));
+
+        using access_type = detail::pad_access<xclosure_t<E>>;
+        using index_type = typename access_type::index_type;
+        using value_type = typename access_type::value_type;
+        using size_type = typename access_type::size_type;
+
+        std::size_t dim = e.dimension();
+        index_type before = xtl::make_sequence<index_type>(dim, size_type(0));
+        index_type new_shape = xtl::make_sequence<index_type>(dim, size_type(0));
+        for (std::size_t axis = 0; axis < dim; ++axis)
+        {
+            before[axis] = static_cast<size_type>(pad_width[axis][0]);
+            new_shape[axis] = before[axis] + static_cast<size_type>(e.shape()[axis]) + static_cast<size_type>(pad_width[axis][1]);
+        }
+        return detail::make_xgenerator(access_type(std::forward<E>(e), std::move(before), mode, static_cast<value_type>(constant_value)),
+                                       new_shape);
+    }
+
+    /**
+     * @brief Lazily pad an array.
      *
      * @param e The array.
      * @param pad_width Number of values padded to the edges of each axis:
@@ -192,45 +421,103 @@ namespace xt
      * @param mode The type of algorithm to use. [default: `xt::pad_mode::constant`].
      * @param constant_value The value to set the padded values for each axis
      * (used in `xt::pad_mode::constant`).
-     * @return The padded array.
+     * @return An expression evaluating to the padded array.
      */
     template <class E,
               class S = typename std::decay_t<E>::size_type,
               class V = typename std::decay_t<E>::value_type>
-    inline auto pad(E&& e,
-                    const std::vector<S>& pad_width,
-                    pad_mode mode = pad_mode::constant,
-                    V constant_value = 0)
+    inline auto pad_view(E&& e,
+                         const std::vector<S>& pad_width,
+                         pad_mode mode = pad_mode::constant,
+                         V constant_value = 0)
     {
         std::vector<std::vector<S>> pw(e.shape().size(), pad_width);
 
-        return pad(e, pw, mode, constant_value);
+        return pad_view(std::forward<E>(e), pw, mode, constant_value);
     }
 
     /**
-     * @brief Pad an array.
+     * @brief Lazily pad an array.
      *
      * @param e The array.
      * @param pad_width Number of values padded to the edges of each axis.
      * @param mode The type of algorithm to use. [default: `xt::pad_mode::constant`].
      * @param constant_value The value to set the padded values for each axis
      * (used in `xt::pad_mode::constant`).
-     * @return The padded array.
+     * @return An expression evaluating to the padded array.
      */
     template <class E,
               class S = typename std::decay_t<E>::size_type,
               class V = typename std::decay_t<E>::value_type>
-    inline auto pad(E&& e,
-                    S pad_width,
-                    pad_mode mode = pad_mode::constant,
-                    V constant_value = 0)
+    inline auto pad_view(E&& e,
+                         S pad_width,
+                         pad_mode mode = pad_mode::constant,
+                         V constant_value = 0)
     {
         std::vector<std::vector<S>> pw(e.shape().size(), {pad_width, pad_width});
 
-        return pad(e, pw, mode, constant_value);
+        return pad_view(std::forward<E>(e), pw, mode, constant_value);
     }
 
-    namespace detail {
+    namespace detail
+    {
+        // Copies src to the first tile of dst, then the tile along the
+        // dimension j, which is a contiguous block of dst, reps[j] - 1 times.
+        // The dimensions of the vectors are ordered from the slowest to the
+        // fastest varying one in memory.
+        template <class T, class U>
+        inline void tile_blocks(const T* src, U* dst, const std::vector<std::size_t>& shape,
+                                const std::vector<std::size_t>& reps, const std::vector<std::size_t>& src_strides,
+                                const std::vector<std::size_t>& dst_strides, std::size_t j)
+        {
+            std::size_t n = shape[j];
+            if (j + 1 == shape.size())
+            {
+                std::copy(src, src + n, dst);
+            }
+            else
+            {
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    tile_blocks(src + k * src_strides[j], dst + k * dst_strides[j], shape, reps, src_strides, dst_strides, j + 1);
+                }
+            }
+            std::size_t block = n * dst_strides[j];
+            for (std::size_t r = 1; r < reps[j]; ++r)
+            {
+                std::copy(dst, dst + block, dst + r * block);
+            }
+        }
+
+        template <class O, class E, class S>
+        inline void tile_contiguous(O& out, const E& e, const S& reps)
+        {
+            std::size_t dim = e.dimension();
+            if (dim == 0)
+            {
+                out.data()[0] = e.data()[e.data_offset()];
+                return;
+            }
+
+            std::vector<std::size_t> shape(dim), r(dim), src_strides(dim), dst_strides(dim);
+            std::size_t src_stride = 1;
+            std::size_t dst_stride = 1;
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                std::size_t j = dim - 1 - i;
+                std::size_t axis = out.layout() == layout_type::row_major ? j : i;
+                shape[j] = static_cast<std::size_t>(e.shape()[axis]);
+                r[j] = static_cast<std::size_t>(reps[axis]);
+                src_strides[j] = src_stride;
+                dst_strides[j] = dst_stride;
+                src_stride *= shape[j];
+                dst_stride *= shape[j] * r[j];
+            }
+            if (src_stride != 0 && dst_stride != 0)
+            {
+                tile_blocks(e.data() + e.data_offset(), out.data(), shape, r, src_strides, dst_strides, 0);
+            }
+        }
 
         template <class E, class S>
         inline auto tile(E&& e, const S& reps)
@@ -244,32 +531,32 @@ namespace xt
             using new_shape_type = typename return_type::shape_type;
             auto new_shape = xtl::make_sequence<new_shape_type>(e.shape().size());
 
-            xt::xstrided_slice_vector sv(reps.size());
-
             for (size_type axis = 0; axis < reps.size(); ++axis)
             {
                 new_shape[axis] = e.shape(axis) * reps[axis];
-                sv[axis] = xt::range(0, e.shape(axis));
             }
             return_type out(new_shape);
 
-            xt::strided_view(out, sv) = e;
-
-            xt::xstrided_slice_vector svs(e.shape().size(), xt::all());
-            xt::xstrided_slice_vector svt(e.shape().size(), xt::all());
-
-            for (size_type axis = 0; axis < e.shape().size(); ++axis)
+            // The tiled expression is evaluated in the layout of the result
+            // unless it already is, the tiles are then copied as blocks
+            bool direct = xtl::mpl::static_if<has_data_interface<std::decay_t<E>>::value>([&](auto self)
             {
-                for (size_type i = 1; i < static_cast<size_type>(reps[axis]); ++i)
+                const auto& src = self(e);
+                if (src.is_contiguous() && src.layout() == out.layout())
                 {
-                    svs[axis] = xt::range(0, e.shape(axis));
-                    svt[axis] = xt::range(i * e.shape(axis), (i + 1) * e.shape(axis));
-                    xt::strided_view(out, svt) = xt::strided_view(out, svs);
-                    svs[axis] = xt::all();
-                    svt[axis] = xt::all();
+                    tile_contiguous(out, src, reps);
+                    return true;
                 }
+                return false;
+            }, /*else*/ [](auto /*self*/)
+            {
+                return false;
+            });
+            if (!direct)
+            {
+                return_type tmp = e;
+                tile_contiguous(out, tmp, reps);
             }
-
             return out;
         }
     }
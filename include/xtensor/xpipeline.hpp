@@ -0,0 +1,536 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PIPELINE_HPP
+#define XTENSOR_PIPELINE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xexpression.hpp"
+#include "xlayout.hpp"
+#include "xstorage.hpp"
+#include "xstrides.hpp"
+#include "xtensor_config.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /**
+     * Element-wise operations of an xpipeline. The operations up to
+     * \c maximum take two operands, the following ones a single operand.
+     */
+    enum class pipeline_op
+    {
+        add,
+        subtract,
+        multiply,
+        divide,
+        minimum,
+        maximum,
+        negate,
+        abs,
+        square,
+        sqrt,
+        exp,
+        log,
+        sin,
+        cos,
+        tanh
+    };
+
+    /***********************
+     * xpipeline internals *
+     ***********************/
+
+    namespace detail
+    {
+        constexpr bool is_binary_pipeline_op(pipeline_op op) noexcept
+        {
+            return static_cast<int>(op) <= static_cast<int>(pipeline_op::maximum);
+        }
+
+        template <class T, class F>
+        inline void pipeline_loop(std::size_t n, const T* a, const T* b, T* r, F f)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                r[i] = f(a[i], b[i]);
+            }
+        }
+
+        template <class T, class F>
+        inline void pipeline_loop(std::size_t n, const T* a, T* r, F f)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                r[i] = f(a[i]);
+            }
+        }
+
+        // One switch per block and operation, the loops themselves are
+        // compiled for the value type and vectorized by the compiler.
+        template <class T>
+        inline void pipeline_kernel(pipeline_op op, std::size_t n, const T* a, const T* b, T* r)
+        {
+            using std::abs;
+            using std::sqrt;
+            using std::exp;
+            using std::log;
+            using std::sin;
+            using std::cos;
+            using std::tanh;
+            switch (op)
+            {
+                case pipeline_op::add:
+                    pipeline_loop(n, a, b, r, [](const T& x, const T& y) { return x + y; });
+                    break;
+                case pipeline_op::subtract:
+                    pipeline_loop(n, a, b, r, [](const T& x, const T& y) { return x - y; });
+                    break;
+                case pipeline_op::multiply:
+                    pipeline_loop(n, a, b, r, [](const T& x, const T& y) { return x * y; });
+                    break;
+                case pipeline_op::divide:
+                    pipeline_loop(n, a, b, r, [](const T& x, const T& y) { return x / y; });
+                    break;
+                case pipeline_op::minimum:
+                    pipeline_loop(n, a, b, r, [](const T& x, const T& y) { return y < x ? y : x; });
+                    break;
+                case pipeline_op::maximum:
+                    pipeline_loop(n, a, b, r, [](const T& x, const T& y) { return x < y ? y : x; });
+                    break;
+                case pipeline_op::negate:
+                    pipeline_loop(n, a, r, [](const T& x) { return -x; });
+                    break;
+                case pipeline_op::abs:
+                    pipeline_loop(n, a, r, [](const T& x) { return abs(x); });
+                    break;
+                case pipeline_op::square:
+                    pipeline_loop(n, a, r, [](const T& x) { return x * x; });
+                    break;
+                case pipeline_op::sqrt:
+                    pipeline_loop(n, a, r, [](const T& x) { return sqrt(x); });
+                    break;
+                case pipeline_op::exp:
+                    pipeline_loop(n, a, r, [](const T& x) { return exp(x); });
+                    break;
+                case pipeline_op::log:
+                    pipeline_loop(n, a, r, [](const T& x) { return log(x); });
+                    break;
+                case pipeline_op::sin:
+                    pipeline_loop(n, a, r, [](const T& x) { return sin(x); });
+                    break;
+                case pipeline_op::cos:
+                    pipeline_loop(n, a, r, [](const T& x) { return cos(x); });
+                    break;
+                case pipeline_op::tanh:
+                    pipeline_loop(n, a, r, [](const T& x) { return tanh(x); });
+                    break;
+            }
+        }
+    }
+
+    /*************
+     * xpipeline *
+     *************/
+
+    /**
+     * @class xpipeline
+     * @brief Element-wise computation composed at runtime.
+     *
+     * The nodes of the pipeline are inputs (contiguous row-major
+     * expressions of the same shape, held by reference), scalars, and
+     * operations on previous nodes. A node is evaluated by blocks of
+     * XTENSOR_PIPELINE_BLOCK_SIZE elements: each operation of the subgraph
+     * is applied to the whole block, with a loop compiled for the value
+     * type, and the intermediate blocks stay in cache. The interpretation
+     * of the graph therefore costs one dispatch per block and operation,
+     * and no temporary array is allocated.
+     *
+     * \code{.cpp}
+     * xt::xpipeline<double> p;
+     * auto x = p.input(a);
+     * auto y = p.input(b);
+     * auto d = p.apply(xt::pipeline_op::subtract, x, y);
+     * auto r = p.apply(xt::pipeline_op::exp, p.apply(xt::pipeline_op::square, d));
+     * xt::xarray<double> res;
+     * p.assign_to(r, res); // res = exp(square(a - b))
+     * \endcode
+     *
+     * @tparam T The value type of the inputs and of the results.
+     */
+    template <class T>
+    class xpipeline
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using shape_type = dynamic_shape<std::size_t>;
+        using node_type = std::size_t;
+
+        xpipeline() = default;
+
+        template <class E>
+        node_type input(const xexpression<E>& e);
+        node_type scalar(value_type value);
+        node_type apply(pipeline_op op, node_type arg);
+        node_type apply(pipeline_op op, node_type arg1, node_type arg2);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+
+        void evaluate(node_type node, value_type* out) const;
+
+        template <class E>
+        void assign_to(node_type node, xexpression<E>& e) const;
+
+    private:
+
+        enum class node_kind
+        {
+            input,
+            scalar,
+            operation
+        };
+
+        struct node
+        {
+            node_kind kind;
+            pipeline_op op;
+            node_type arg1;
+            node_type arg2;
+            const value_type* data;
+            value_type value;
+        };
+
+        // Operations of the subgraph of a node in evaluation order; reg is
+        // the block buffer holding the result of the node.
+        struct step
+        {
+            node_type id;
+            size_type reg;
+        };
+
+        struct program
+        {
+            std::vector<step> steps;
+            std::vector<size_type> regs;
+            size_type n_regs = 0;
+        };
+
+        template <class E>
+        void assign_to_impl(node_type node, E& e, std::true_type) const;
+
+        template <class E>
+        void assign_to_impl(node_type node, E& e, std::false_type) const;
+
+        node_type push(node n);
+        void check_node(node_type id) const;
+        program compile(node_type root) const;
+        const value_type* operand(node_type id, const program& prog, size_type first, value_type* buffers) const;
+        void run(const program& prog, node_type root, size_type first, size_type last, value_type* out) const;
+
+        std::vector<node> m_nodes;
+        shape_type m_shape;
+        size_type m_size = 1;
+        bool m_has_input = false;
+    };
+
+    /****************************
+     * xpipeline implementation *
+     ****************************/
+
+    /**
+     * Adds an input node reading the elements of \c e, which must provide a
+     * contiguous row-major data interface. All the inputs have the same
+     * shape; \c e is held by reference.
+     * @param e the xexpression
+     * @return the node of the input
+     */
+    template <class T>
+    template <class E>
+    inline auto xpipeline<T>::input(const xexpression<E>& e) -> node_type
+    {
+        static_assert(std::is_same<typename E::value_type, value_type>::value,
+                      "xpipeline: the inputs must have the value type of the pipeline");
+        const E& de = e.derived_cast();
+        if (!de.is_contiguous() || (de.dimension() > 1 && de.layout() != layout_type::row_major))
+        {
+            XTENSOR_THROW(std::runtime_error, "xpipeline: the inputs must be contiguous and row-major");
+        }
+        shape_type shape = xtl::forward_sequence<shape_type, decltype(de.shape())>(de.shape());
+        if (!m_has_input)
+        {
+            m_shape = std::move(shape);
+            m_size = compute_size(m_shape);
+            m_has_input = true;
+        }
+        else if (shape != m_shape)
+        {
+            XTENSOR_THROW(std::runtime_error, "xpipeline: the inputs must have the same shape");
+        }
+        return push(node{node_kind::input, pipeline_op::add, 0, 0, de.data() + de.data_offset(), value_type()});
+    }
+
+    /**
+     * Adds a node holding a scalar, broadcast to the shape of the inputs.
+     */
+    template <class T>
+    inline auto xpipeline<T>::scalar(value_type value) -> node_type
+    {
+        return push(node{node_kind::scalar, pipeline_op::add, 0, 0, nullptr, value});
+    }
+
+    /**
+     * Adds a node applying the unary operation \c op to the node \c arg.
+     */
+    template <class T>
+    inline auto xpipeline<T>::apply(pipeline_op op, node_type arg) -> node_type
+    {
+        if (detail::is_binary_pipeline_op(op))
+        {
+            XTENSOR_THROW(std::invalid_argument, "xpipeline: binary operation applied to a single node");
+        }
+        check_node(arg);
+        return push(node{node_kind::operation, op, arg, arg, nullptr, value_type()});
+    }
+
+    /**
+     * Adds a node applying the binary operation \c op to the nodes \c arg1
+     * and \c arg2.
+     */
+    template <class T>
+    inline auto xpipeline<T>::apply(pipeline_op op, node_type arg1, node_type arg2) -> node_type
+    {
+        if (!detail::is_binary_pipeline_op(op))
+        {
+            XTENSOR_THROW(std::invalid_argument, "xpipeline: unary operation applied to two nodes");
+        }
+        check_node(arg1);
+        check_node(arg2);
+        return push(node{node_kind::operation, op, arg1, arg2, nullptr, value_type()});
+    }
+
+    /**
+     * Returns the number of elements of the results.
+     */
+    template <class T>
+    inline auto xpipeline<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the number of dimensions of the results.
+     */
+    template <class T>
+    inline auto xpipeline<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the results, the shape of the inputs.
+     */
+    template <class T>
+    inline auto xpipeline<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Computes the elements of \c node, in row-major order, into the buffer
+     * \c out of size() elements. Large pipelines are split into ranges
+     * computed in parallel when a parallel backend is enabled.
+     */
+    template <class T>
+    inline void xpipeline<T>::evaluate(node_type node, value_type* out) const
+    {
+        check_node(node);
+        program prog = compile(node);
+        exec::default_policy().for_range(size_type(0), m_size, size_type(XTENSOR_PIPELINE_BLOCK_SIZE),
+                                         [this, &prog, node, out](size_type first, size_type last)
+        {
+            run(prog, node, first, last, out);
+        });
+    }
+
+    /**
+     * Assigns the elements of \c node to the container \c e, which is
+     * resized to the shape of the pipeline.
+     */
+    template <class T>
+    template <class E>
+    inline void xpipeline<T>::assign_to(node_type node, xexpression<E>& e) const
+    {
+        E& de = e.derived_cast();
+        de.resize(xtl::forward_sequence<typename E::shape_type, const shape_type&>(m_shape));
+        assign_to_impl(node, de, std::is_same<typename E::value_type, value_type>());
+    }
+
+    template <class T>
+    template <class E>
+    inline void xpipeline<T>::assign_to_impl(node_type node, E& e, std::true_type /*same_value_type*/) const
+    {
+        if (e.layout() == layout_type::row_major || m_shape.size() <= 1)
+        {
+            evaluate(node, e.data());
+        }
+        else
+        {
+            assign_to_impl(node, e, std::false_type());
+        }
+    }
+
+    template <class T>
+    template <class E>
+    inline void xpipeline<T>::assign_to_impl(node_type node, E& e, std::false_type /*same_value_type*/) const
+    {
+        using e_value_type = typename E::value_type;
+        uvector<value_type> buffer(m_size);
+        evaluate(node, buffer.data());
+        std::transform(buffer.cbegin(), buffer.cend(), e.template begin<layout_type::row_major>(),
+                       [](const value_type& v) { return static_cast<e_value_type>(v); });
+    }
+
+    template <class T>
+    inline auto xpipeline<T>::push(node n) -> node_type
+    {
+        m_nodes.push_back(n);
+        return m_nodes.size() - 1;
+    }
+
+    template <class T>
+    inline void xpipeline<T>::check_node(node_type id) const
+    {
+        if (id >= m_nodes.size())
+        {
+            XTENSOR_THROW(std::out_of_range, "xpipeline: unknown node");
+        }
+    }
+
+    // The arguments of a node are always created before it, the subgraph
+    // is therefore evaluated in increasing order of the nodes. The block
+    // buffer of an operation is reused once its last consumer has run.
+    template <class T>
+    inline auto xpipeline<T>::compile(node_type root) const -> program
+    {
+        std::vector<bool> used(root + 1, false);
+        std::vector<node_type> last_use(root + 1, 0);
+        used[root] = true;
+        for (node_type id = root + 1; id-- > 0;)
+        {
+            const node& n = m_nodes[id];
+            if (used[id] && n.kind == node_kind::operation)
+            {
+                used[n.arg1] = used[n.arg2] = true;
+                last_use[n.arg1] = (std::max)(last_use[n.arg1], id);
+                last_use[n.arg2] = (std::max)(last_use[n.arg2], id);
+            }
+        }
+
+        program prog;
+        prog.regs.assign(root + 1, 0);
+        std::vector<size_type> free_regs;
+        for (node_type id = 0; id <= root; ++id)
+        {
+            const node& n = m_nodes[id];
+            if (!used[id] || n.kind == node_kind::input)
+            {
+                continue;
+            }
+            // The scalars are written once per range, their buffers are
+            // never shared
+            size_type reg = prog.n_regs;
+            if (free_regs.empty() || n.kind == node_kind::scalar)
+            {
+                ++prog.n_regs;
+            }
+            else
+            {
+                reg = free_regs.back();
+                free_regs.pop_back();
+            }
+            prog.regs[id] = reg;
+            if (n.kind == node_kind::operation)
+            {
+                prog.steps.push_back(step{id, reg});
+                for (node_type arg : {n.arg1, n.arg2})
+                {
+                    const node& a = m_nodes[arg];
+                    if (a.kind == node_kind::operation && last_use[arg] == id &&
+                        std::find(free_regs.cbegin(), free_regs.cend(), prog.regs[arg]) == free_regs.cend())
+                    {
+                        free_regs.push_back(prog.regs[arg]);
+                    }
+                }
+            }
+        }
+        return prog;
+    }
+
+    template <class T>
+    inline auto xpipeline<T>::operand(node_type id, const program& prog, size_type first, value_type* buffers) const
+        -> const value_type*
+    {
+        const node& n = m_nodes[id];
+        return n.kind == node_kind::input ?
+            n.data + first :
+            buffers + prog.regs[id] * XTENSOR_PIPELINE_BLOCK_SIZE;
+    }
+
+    template <class T>
+    inline void xpipeline<T>::run(const program& prog, node_type root, size_type first, size_type last, value_type* out) const
+    {
+        constexpr size_type block_size = XTENSOR_PIPELINE_BLOCK_SIZE;
+        uvector<value_type> buffers(prog.n_regs * block_size);
+        for (node_type id = 0; id <= root; ++id)
+        {
+            const node& n = m_nodes[id];
+            if (n.kind == node_kind::scalar)
+            {
+                std::fill_n(buffers.data() + prog.regs[id] * block_size, block_size, n.value);
+            }
+        }
+
+        for (size_type b = first; b < last; b += block_size)
+        {
+            size_type size = (std::min)(block_size, last - b);
+            const node& r = m_nodes[root];
+            if (r.kind != node_kind::operation)
+            {
+                std::copy_n(operand(root, prog, b, buffers.data()), size, out + b);
+                continue;
+            }
+            for (const step& s : prog.steps)
+            {
+                const node& n = m_nodes[s.id];
+                value_type* res = s.id == root ? out + b : buffers.data() + s.reg * block_size;
+                detail::pipeline_kernel(n.op, size, operand(n.arg1, prog, b, buffers.data()),
+                                        operand(n.arg2, prog, b, buffers.data()), res);
+            }
+        }
+    }
+}
+
+#endif
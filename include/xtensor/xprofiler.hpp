@@ -0,0 +1,446 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PROFILER_HPP
+#define XTENSOR_PROFILER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+#include "xtensor_config.hpp"
+
+#ifndef XTENSOR_PROFILING_SAMPLE_PERIOD
+#define XTENSOR_PROFILING_SAMPLE_PERIOD 1024
+#endif
+
+/**
+ * Profiling of expression evaluation. When xtensor is compiled with
+ * XTENSOR_EXPRESSION_PROFILING defined and profiling is enabled, the element
+ * accesses of xfunction, xreducer and xview and the immediate reductions
+ * record their timings. XTENSOR_PROFILE_NODE marks an element evaluation:
+ * one out of sample_period() evaluations that are not nested in another one
+ * is timed, together with the nodes it evaluates. XTENSOR_PROFILE_CALL marks
+ * a coarse operation, timed on every call. Without the macro, nothing is
+ * instrumented.
+ */
+#if defined(XTENSOR_EXPRESSION_PROFILING)
+#define XTENSOR_PROFILE_NODE(KIND, T) \
+    ::xt::profiling::sampled_scope xtensor_profile_scope(::xt::profiling::node_name<::xt::profiling::KIND, T>())
+#define XTENSOR_PROFILE_CALL(KIND, T) \
+    ::xt::profiling::timed_scope xtensor_profile_scope(::xt::profiling::node_name<::xt::profiling::KIND, T>())
+#else
+#define XTENSOR_PROFILE_NODE(KIND, T)
+#define XTENSOR_PROFILE_CALL(KIND, T)
+#endif
+
+namespace xt
+{
+    namespace profiling
+    {
+        /**************
+         * node kinds *
+         **************/
+
+        struct function_node
+        {
+            static const char* prefix() noexcept { return "xfunction"; }
+        };
+
+        struct reducer_node
+        {
+            static const char* prefix() noexcept { return "xreducer"; }
+        };
+
+        struct reduce_call
+        {
+            static const char* prefix() noexcept { return "reduce_immediate"; }
+        };
+
+        struct view_node
+        {
+            static const char* prefix() noexcept { return "xview"; }
+        };
+
+        template <class K, class T>
+        const char* node_name();
+
+        namespace detail
+        {
+            struct thread_state;
+        }
+
+        /*******************
+         * profile records *
+         *******************/
+
+        /**
+         * Time spent in a node, excluding the nodes it evaluates. The sampled
+         * timings are scaled by the sample period, so that the times of the
+         * sampled and of the coarse nodes can be compared.
+         */
+        struct profile_record
+        {
+            // Names of the nodes from the outermost one, separated by ';'
+            std::string stack;
+            double time = 0.;
+            std::size_t samples = 0;
+        };
+
+        bool enabled() noexcept;
+        void enable() noexcept;
+        void disable() noexcept;
+
+        std::size_t sample_period() noexcept;
+        void set_sample_period(std::size_t period) noexcept;
+
+        std::vector<profile_record> records();
+        void reset();
+        void report(std::ostream& out);
+
+        /**********
+         * scopes *
+         **********/
+
+        class sampled_scope
+        {
+        public:
+
+            explicit sampled_scope(const char* name);
+            ~sampled_scope();
+
+            sampled_scope(const sampled_scope&) = delete;
+            sampled_scope& operator=(const sampled_scope&) = delete;
+
+        private:
+
+            detail::thread_state* p_state;
+            bool m_active;
+        };
+
+        class timed_scope
+        {
+        public:
+
+            explicit timed_scope(const char* name);
+            ~timed_scope();
+
+            timed_scope(const timed_scope&) = delete;
+            timed_scope& operator=(const timed_scope&) = delete;
+
+        private:
+
+            detail::thread_state* p_state;
+            std::size_t m_depth;
+            bool m_sampling;
+        };
+
+        /***************************
+         * profiler implementation *
+         ***************************/
+
+        namespace detail
+        {
+            using clock_type = std::chrono::steady_clock;
+
+            struct frame
+            {
+                const char* name;
+                clock_type::time_point start;
+                // time of the nested frames, in the unit of this frame
+                double child_time;
+                std::size_t children;
+                double weight;
+            };
+
+            struct thread_state
+            {
+                std::vector<frame> stack;
+                // number of nested sampled scopes, active or not
+                std::size_t depth = 0;
+                std::size_t counter = 0;
+                bool sampling = false;
+            };
+
+            struct registry
+            {
+                std::mutex mutex;
+                std::map<std::string, profile_record> records;
+                std::atomic<std::size_t> period{XTENSOR_PROFILING_SAMPLE_PERIOD};
+                std::atomic<bool> enabled{false};
+            };
+
+            inline registry& get_registry()
+            {
+                static registry r;
+                return r;
+            }
+
+            inline thread_state& get_thread_state()
+            {
+                static thread_local thread_state s;
+                return s;
+            }
+
+            // Cost of reading the clock, subtracted once per nested frame
+            inline double clock_overhead()
+            {
+                static const double overhead = []()
+                {
+                    double best = 1e9;
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        auto t0 = clock_type::now();
+                        auto t1 = clock_type::now();
+                        best = (std::min)(best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+                    }
+                    return best;
+                }();
+                return overhead;
+            }
+
+            inline std::string demangle(const char* name)
+            {
+                std::string res = name;
+#if defined(__GNUC__)
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+                if (status == 0 && demangled != nullptr)
+                {
+                    res = demangled;
+                }
+                std::free(demangled);
+#endif
+                for (const char* ns : {"xt::", "detail::", "math::", "struct ", "class "})
+                {
+                    std::string n(ns);
+                    for (std::size_t pos = res.find(n); pos != std::string::npos; pos = res.find(n, pos))
+                    {
+                        res.erase(pos, n.size());
+                    }
+                }
+                return res;
+            }
+
+            inline void push_frame(thread_state& s, const char* name, double weight)
+            {
+                s.stack.push_back(frame{name, clock_type::now(), 0., 0, weight});
+            }
+
+            inline void pop_frame(thread_state& s)
+            {
+                auto stop = clock_type::now();
+                frame f = s.stack.back();
+                double elapsed = std::chrono::duration<double, std::nano>(stop - f.start).count();
+                double self = elapsed - f.child_time - static_cast<double>(f.children) * clock_overhead();
+
+                std::string key;
+                for (const frame& p : s.stack)
+                {
+                    if (!key.empty())
+                    {
+                        key += ';';
+                    }
+                    key += p.name;
+                }
+                s.stack.pop_back();
+                {
+                    registry& r = get_registry();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    profile_record& rec = r.records[key];
+                    rec.time += (std::max)(self, 0.) * f.weight;
+                    ++rec.samples;
+                }
+
+                if (!s.stack.empty())
+                {
+                    // The bookkeeping above is not part of the parent
+                    frame& parent = s.stack.back();
+                    double bookkeeping = std::chrono::duration<double, std::nano>(clock_type::now() - stop).count();
+                    parent.child_time += elapsed * f.weight / parent.weight + bookkeeping;
+                    ++parent.children;
+                }
+            }
+        }
+
+        /**
+         * Returns the name of the node of kind K with functor T, e.g.
+         * <tt>xfunction<multiplies></tt>, or the name of the kind if T is void.
+         */
+        template <class K, class T>
+        inline const char* node_name()
+        {
+            static const std::string name = std::is_void<T>::value
+                ? std::string(K::prefix())
+                : std::string(K::prefix()) + "<" + detail::demangle(typeid(T).name()) + ">";
+            return name.c_str();
+        }
+
+        /**
+         * Returns whether the instrumented nodes record their timings.
+         */
+        inline bool enabled() noexcept
+        {
+            return detail::get_registry().enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Starts recording the timings of the instrumented nodes.
+         */
+        inline void enable() noexcept
+        {
+            detail::get_registry().enabled.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * Stops recording the timings of the instrumented nodes. The recorded
+         * timings are kept until reset() is called.
+         */
+        inline void disable() noexcept
+        {
+            detail::get_registry().enabled.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the number of element evaluations per timed evaluation.
+         */
+        inline std::size_t sample_period() noexcept
+        {
+            return detail::get_registry().period.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Sets the number of element evaluations per timed evaluation, 1
+         * timing all of them. The initial value is XTENSOR_PROFILING_SAMPLE_PERIOD.
+         */
+        inline void set_sample_period(std::size_t period) noexcept
+        {
+            detail::get_registry().period.store((std::max)(period, std::size_t(1)), std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the recorded timings, sorted by stack.
+         */
+        inline std::vector<profile_record> records()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            std::vector<profile_record> res;
+            res.reserve(r.records.size());
+            for (const auto& p : r.records)
+            {
+                res.push_back(p.second);
+                res.back().stack = p.first;
+            }
+            return res;
+        }
+
+        /**
+         * Discards the recorded timings.
+         */
+        inline void reset()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.records.clear();
+        }
+
+        /**
+         * Writes the recorded timings in the collapsed stack format of
+         * flamegraph.pl, one line per stack followed by its time in
+         * nanoseconds.
+         */
+        inline void report(std::ostream& out)
+        {
+            for (const profile_record& rec : records())
+            {
+                out << rec.stack << ' ' << static_cast<unsigned long long>(rec.time + 0.5) << '\n';
+            }
+        }
+
+        /*************************
+         * scopes implementation *
+         *************************/
+
+        inline sampled_scope::sampled_scope(const char* name)
+            : p_state(nullptr), m_active(false)
+        {
+            if (!enabled())
+            {
+                return;
+            }
+            p_state = &detail::get_thread_state();
+            detail::thread_state& s = *p_state;
+            if (s.depth++ == 0)
+            {
+                s.sampling = s.counter++ % sample_period() == 0;
+            }
+            m_active = s.sampling;
+            if (m_active)
+            {
+                double weight = s.depth == 1 || s.stack.empty() ? static_cast<double>(sample_period()) : s.stack.back().weight;
+                detail::push_frame(s, name, weight);
+            }
+        }
+
+        inline sampled_scope::~sampled_scope()
+        {
+            if (p_state != nullptr)
+            {
+                if (m_active)
+                {
+                    detail::pop_frame(*p_state);
+                }
+                --p_state->depth;
+            }
+        }
+
+        // The sampled scopes nested in a timed one sample their own
+        // evaluations, as if they were not nested.
+        inline timed_scope::timed_scope(const char* name)
+            : p_state(nullptr), m_depth(0), m_sampling(false)
+        {
+            if (!enabled())
+            {
+                return;
+            }
+            p_state = &detail::get_thread_state();
+            m_depth = p_state->depth;
+            m_sampling = p_state->sampling;
+            p_state->depth = 0;
+            p_state->sampling = false;
+            detail::push_frame(*p_state, name, 1.);
+        }
+
+        inline timed_scope::~timed_scope()
+        {
+            if (p_state != nullptr)
+            {
+                detail::pop_frame(*p_state);
+                p_state->depth = m_depth;
+                p_state->sampling = m_sampling;
+            }
+        }
+    }
+}
+
+#endif
@@ -15,16 +15,25 @@
 #define XTENSOR_RANDOM_HPP
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <random>
 #include <utility>
+#include <vector>
 #include <type_traits>
+#include <unordered_set>
 
 #include <xtl/xspan.hpp>
 
 #include "xbuilder.hpp"
+#include "xexecution.hpp"
+#include "xfast_math.hpp"
 #include "xgenerator.hpp"
 #include "xindex_view.hpp"
+#include "xstrides.hpp"
 #include "xtensor.hpp"
 #include "xtensor_config.hpp"
 #include "xview.hpp"
@@ -44,6 +53,56 @@ namespace xt
         default_engine_type& get_default_random_engine();
         void seed(seed_type seed);
 
+        /**
+         * @class philox4x32
+         * @brief Counter-based random number engine implementing Philox4x32-10.
+         *
+         * Block \c n of the stream is four 32-bit words computed from the
+         * key (the seed), the stream identifier and \c n only, so any part
+         * of the stream can be computed independently of the others. The
+         * engine satisfies the requirements of UniformRandomBitGenerator
+         * and can be used with the standard distributions; passing it to
+         * \ref rand or \ref randn returns a generator whose element of flat
+         * index \c i (in row-major order) depends only on the state of the
+         * engine and on \c i, which makes the generated values independent
+         * of the layout and of the way the assignment is split across threads.
+         */
+        class philox4x32
+        {
+        public:
+
+            using result_type = std::uint32_t;
+            using block_type = std::array<result_type, 4>;
+
+            explicit philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept;
+
+            void seed(std::uint64_t seed, std::uint64_t stream = 0) noexcept;
+
+            static constexpr result_type min() noexcept;
+            static constexpr result_type max() noexcept;
+
+            result_type operator()() noexcept;
+            void discard(unsigned long long z) noexcept;
+
+            block_type block(std::uint64_t n) const noexcept;
+
+            std::uint64_t counter() const noexcept;
+            void set_counter(std::uint64_t n) noexcept;
+            std::uint64_t skip_blocks(std::uint64_t n) noexcept;
+
+        private:
+
+            using key_type = std::array<result_type, 2>;
+
+            static void round(block_type& c, const key_type& k) noexcept;
+
+            key_type m_key;
+            std::uint64_t m_stream;
+            std::uint64_t m_counter;
+            block_type m_buffer;
+            std::size_t m_index;
+        };
+
         template <class T, class S, class E = random::default_engine_type>
         auto rand(const S& shape, T lower = 0, T upper = 1,
                   E& engine = random::get_default_random_engine());
@@ -172,9 +231,42 @@ namespace xt
         auto student_t(const I (&shape)[L], T n = 1.0,
                        E& engine = random::get_default_random_engine());
 
+        template <class T, class S>
+        auto rand(const S& shape, T lower, T upper, philox4x32& engine);
+
+        template <class T, class S>
+        auto randn(const S& shape, T mean, T std_dev, philox4x32& engine);
+
+        template <class T, class I, std::size_t L>
+        auto rand(const I (&shape)[L], T lower, T upper, philox4x32& engine);
+
+        template <class T, class I, std::size_t L>
+        auto randn(const I (&shape)[L], T mean, T std_dev, philox4x32& engine);
+
+        template <class E, class T = typename E::value_type, class G = random::default_engine_type>
+        void fill_rand(xexpression<E>& e, T lower = 0, T upper = 1,
+                       G& engine = random::get_default_random_engine());
+
+        template <class E, class T = typename E::value_type, class G = random::default_engine_type>
+        void fill_randint(xexpression<E>& e, T lower = 0, T upper = (std::numeric_limits<T>::max)(),
+                          G& engine = random::get_default_random_engine());
+
+        template <class E, class T = typename E::value_type, class G = random::default_engine_type>
+        void fill_randn(xexpression<E>& e, T mean = 0, T std_dev = 1,
+                        G& engine = random::get_default_random_engine());
+
+        template <class E, class T>
+        void fill_rand(xexpression<E>& e, T lower, T upper, philox4x32& engine);
+
+        template <class E, class T>
+        void fill_randn(xexpression<E>& e, T mean, T std_dev, philox4x32& engine);
+
         template <class T, class E = random::default_engine_type>
         void shuffle(xexpression<T>& e, E& engine = random::get_default_random_engine());
 
+        template <class T>
+        void shuffle(xexpression<T>& e, philox4x32& engine);
+
         template <class T, class E = random::default_engine_type>
         std::enable_if_t<xtl::is_integral<T>::value, xtensor<T, 1>>
         permutation(T e, E& engine = random::get_default_random_engine());
@@ -234,6 +326,434 @@ namespace xt
             E& m_engine;
             mutable D m_dist;
         };
+
+        // Converts the words of a philox4x32 block to floating point numbers
+        // uniformly distributed in [0, 1): two numbers with 53 random bits for
+        // double precision, four numbers with 24 random bits for float.
+        template <class T, bool = (sizeof(T) > sizeof(std::uint32_t))>
+        struct philox_unit
+        {
+            static constexpr std::size_t size = 2;
+
+            static void convert(const random::philox4x32::block_type& w, T* u) noexcept
+            {
+                for (std::size_t k = 0; k < size; ++k)
+                {
+                    std::uint64_t bits = ((std::uint64_t(w[2 * k]) << 32) | w[2 * k + 1]) >> 11;
+                    u[k] = static_cast<T>(static_cast<double>(bits) * (1.0 / 9007199254740992.0));
+                }
+            }
+        };
+
+        template <class T>
+        struct philox_unit<T, false>
+        {
+            static constexpr std::size_t size = 4;
+
+            static void convert(const random::philox4x32::block_type& w, T* u) noexcept
+            {
+                for (std::size_t k = 0; k < size; ++k)
+                {
+                    u[k] = static_cast<T>(w[k] >> 8) * T(1.f / 16777216.f);
+                }
+            }
+        };
+
+        // The distributions transform in place n uniform numbers computed
+        // by philox_unit, n being a multiple of the number of values per block.
+        template <class T>
+        struct uniform_transform
+        {
+            void operator()(T* u, std::size_t n) const noexcept
+            {
+                T scale = m_upper - m_lower;
+                for (std::size_t k = 0; k < n; ++k)
+                {
+                    u[k] = m_lower + scale * u[k];
+                }
+            }
+
+            T m_lower;
+            T m_upper;
+        };
+
+        // Box-Muller transform of the pairs of uniform numbers, also used by
+        // fill_randn with the other engines.
+        template <class T>
+        struct box_muller_transform
+        {
+            void operator()(T* u, std::size_t n) const noexcept
+            {
+                for (std::size_t k = 0; k < n; k += 2)
+                {
+                    T r = m_std_dev * std::sqrt(T(-2) * fast::detail::fast_log(T(1) - u[k]));
+                    T theta = T(6.283185307179586476925286766559) * u[k + 1];
+                    u[k] = m_mean + r * fast::detail::fast_cos(theta);
+                    u[k + 1] = m_mean + r * fast::detail::fast_sin(theta);
+                }
+            }
+
+            T m_mean;
+            T m_std_dev;
+        };
+
+        // Function of the generators built on a philox4x32: the element of
+        // flat index i is the (i % block_size)-th value computed from the
+        // block first_block + i / block_size of the stream of the engine,
+        // which is copied on construction. The flat indices follow the
+        // row-major order, so that the generators are linear whatever
+        // their dimension.
+        template <class T, class D>
+        class philox_random_impl
+        {
+        public:
+
+            using value_type = T;
+            using strides_type = svector<std::ptrdiff_t, 4>;
+            using unit_type = philox_unit<T>;
+            static constexpr std::size_t block_size = unit_type::size;
+            static constexpr layout_type flat_layout = layout_type::row_major;
+
+            template <class S>
+            philox_random_impl(const random::philox4x32& engine, std::uint64_t first_block, D dist, const S& shape)
+                : m_engine(engine), m_first_block(first_block), m_dist(dist), m_strides(shape.size())
+            {
+                compute_strides(shape, layout_type::row_major, m_strides);
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                return data_element(static_cast<std::size_t>(data_offset<std::ptrdiff_t>(m_strides, args...)));
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                return data_element(static_cast<std::size_t>(element_offset<std::ptrdiff_t>(m_strides, first, last)));
+            }
+
+            inline value_type data_element(std::size_t i) const
+            {
+                std::array<T, block_size> buffer;
+                unit_type::convert(m_engine.block(m_first_block + i / block_size), buffer.data());
+                m_dist(buffer.data(), block_size);
+                return buffer[i % block_size];
+            }
+
+            template <class align, class requested_type, std::size_t N>
+            inline xt_simd::simd_return_type<T, requested_type> load_simd(std::size_t i) const
+            {
+                std::array<requested_type, N> values;
+                fill(values.data(), i, i + N);
+                return xt_simd::load_as<requested_type>(values.data(), xt_simd::unaligned_mode());
+            }
+
+            template <class EX>
+            inline void assign_to(xexpression<EX>& e) const
+            {
+                auto& ed = e.derived_cast();
+                bool done = xtl::mpl::static_if<has_data_interface<EX>::value>([&](auto self)
+                {
+                    auto& d = self(ed);
+                    if (d.layout() != layout_type::row_major || !d.is_contiguous())
+                    {
+                        return false;
+                    }
+                    auto out = d.data() + static_cast<std::ptrdiff_t>(d.data_offset());
+                    exec::default_policy().for_range(std::size_t(0), d.size(), block_size, [&](std::size_t first, std::size_t last)
+                    {
+                        fill(out + static_cast<std::ptrdiff_t>(first), first, last);
+                    });
+                    return true;
+                }, /*else*/ [](auto /*self*/)
+                {
+                    return false;
+                });
+                if (!done)
+                {
+                    fill(ed.template begin<layout_type::row_major>(), std::size_t(0), ed.size());
+                }
+            }
+
+        private:
+
+            // Writes the elements of flat indices [first, last) to out. The
+            // blocks are computed by batches, so that the compiler can
+            // vectorize the loop of the distribution.
+            template <class It>
+            inline void fill(It out, std::size_t first, std::size_t last) const
+            {
+                constexpr std::size_t batch_size = 64;
+                std::array<T, batch_size * block_size> buffer;
+                std::uint64_t n = m_first_block + first / block_size;
+                std::size_t k = first % block_size;
+                while (first < last)
+                {
+                    std::size_t nb_blocks = (std::min)(batch_size, (last - first + k + block_size - 1) / block_size);
+                    for (std::size_t b = 0; b < nb_blocks; ++b)
+                    {
+                        unit_type::convert(m_engine.block(n + b), buffer.data() + b * block_size);
+                    }
+                    m_dist(buffer.data(), nb_blocks * block_size);
+                    std::size_t count = (std::min)(nb_blocks * block_size - k, last - first);
+                    out = std::copy(buffer.data() + k, buffer.data() + k + count, out);
+                    first += count;
+                    n += nb_blocks;
+                    k = 0;
+                }
+            }
+
+            random::philox4x32 m_engine;
+            std::uint64_t m_first_block;
+            D m_dist;
+            strides_type m_strides;
+        };
+
+        template <class T, class D, class S>
+        inline auto make_philox_impl(random::philox4x32& engine, D dist, const S& shape)
+        {
+            static_assert(std::is_floating_point<T>::value, "philox4x32 generators require a floating point value type");
+            std::size_t size = compute_size(shape);
+            std::size_t block_size = philox_unit<T>::size;
+            std::uint64_t first_block = engine.skip_blocks((size + block_size - 1) / block_size);
+            return philox_random_impl<T, D>(engine, first_block, dist, shape);
+        }
+
+        template <class T, class D, class S>
+        inline auto make_philox_generator(random::philox4x32& engine, D dist, const S& shape)
+        {
+            return make_xgenerator(make_philox_impl<T>(engine, dist, shape), shape);
+        }
+
+        // Calls f(first, n) on ranges of the elements of e, where f writes n
+        // values starting at the pointer first: directly on the storage of a
+        // contiguous container, and on a buffer copied to e otherwise.
+        template <class E, class F>
+        inline void random_fill(E& e, F&& f)
+        {
+            bool done = xtl::mpl::static_if<has_data_interface<E>::value>([&](auto self)
+            {
+                auto& d = self(e);
+                if (!d.is_contiguous())
+                {
+                    return false;
+                }
+                f(d.data() + static_cast<std::ptrdiff_t>(d.data_offset()), d.size());
+                return true;
+            }, /*else*/ [](auto /*self*/)
+            {
+                return false;
+            });
+            if (!done)
+            {
+                std::array<typename E::value_type, 256> buffer;
+                auto out = e.begin();
+                for (std::size_t first = 0; first < e.size(); first += buffer.size())
+                {
+                    std::size_t n = (std::min)(buffer.size(), e.size() - first);
+                    f(buffer.data(), n);
+                    out = std::copy(buffer.data(), buffer.data() + n, out);
+                }
+            }
+        }
+
+        // Swaps the rows of the first axis with the Fisher-Yates algorithm.
+        // The rows of a contiguous row-major container are swapped in
+        // place; the sequence of numbers drawn from engine, hence the
+        // permutation, does not depend on the type of e.
+        template <class T, class E>
+        inline void fisher_yates_shuffle(T& de, E& engine)
+        {
+            using size_type = typename T::size_type;
+            if (de.dimension() == 1)
+            {
+                auto first = de.begin();
+                auto last = de.end();
+
+                for (size_type i = static_cast<size_type>(last - first); i-- > 1;)
+                {
+                    std::uniform_int_distribution<size_type> dist(0, i);
+                    auto j = dist(engine);
+                    using std::swap;
+                    swap(first[i], first[j]);
+                }
+                return;
+            }
+
+            bool done = xtl::mpl::static_if<has_data_interface<T>::value>([&](auto self)
+            {
+                auto& d = self(de);
+                if (d.layout() != layout_type::row_major || !d.is_contiguous())
+                {
+                    return false;
+                }
+                size_type n_rows = d.shape()[0];
+                if (n_rows < 2)
+                {
+                    return true;
+                }
+                std::ptrdiff_t row_size = n_rows == 0 ? 0 : static_cast<std::ptrdiff_t>(d.size() / n_rows);
+                auto data = d.data() + static_cast<std::ptrdiff_t>(d.data_offset());
+                for (size_type i = n_rows - 1; i > 0; --i)
+                {
+                    std::uniform_int_distribution<size_type> dist(0, i);
+                    size_type j = dist(engine);
+                    if (j != i)
+                    {
+                        auto row_i = data + static_cast<std::ptrdiff_t>(i) * row_size;
+                        std::swap_ranges(row_i, row_i + row_size, data + static_cast<std::ptrdiff_t>(j) * row_size);
+                    }
+                }
+                return true;
+            }, /*else*/ [](auto /*self*/)
+            {
+                return false;
+            });
+            if (!done)
+            {
+                decltype(auto) buf = empty_like(view(de, 0));
+
+                for (size_type i = de.shape()[0] - 1; i > 0; --i)
+                {
+                    std::uniform_int_distribution<size_type> dist(0, i);
+                    size_type j = dist(engine);
+
+                    buf = view(de, j);
+                    view(de, j) = view(de, i);
+                    view(de, i) = buf;
+                }
+            }
+        }
+
+        // Unbiased random integer in [0, range), with the multiplication
+        // method of Lemire, "Fast random integer generation in an interval".
+        inline std::uint32_t philox_bounded(random::philox4x32& engine, std::uint32_t range) noexcept
+        {
+            std::uint64_t m = std::uint64_t(engine()) * range;
+            if (static_cast<std::uint32_t>(m) < range)
+            {
+                std::uint32_t threshold = static_cast<std::uint32_t>(-range) % range;
+                while (static_cast<std::uint32_t>(m) < threshold)
+                {
+                    m = std::uint64_t(engine()) * range;
+                }
+            }
+            return static_cast<std::uint32_t>(m >> 32);
+        }
+
+        // Shuffles n_rows contiguous rows of row_size elements. Each row is
+        // sent to a bucket drawn from its index with the counter-based
+        // engine; a power of two number of buckets makes the draw unbiased.
+        // The rows are counted and scattered chunk by chunk, then each
+        // bucket is shuffled with an engine seeded from its own block of
+        // the stream. The chunk size and the number of buckets only depend
+        // on the size of the data.
+        template <class V>
+        inline void bucket_shuffle(V* data, std::size_t n_rows, std::size_t row_size, random::philox4x32& engine)
+        {
+            constexpr std::size_t bucket_bytes = std::size_t(1) << 18;
+            constexpr std::size_t max_buckets = std::size_t(1) << 16;
+            constexpr std::size_t chunk_rows = std::size_t(1) << 16;
+
+            std::size_t bytes = n_rows * row_size * sizeof(V);
+            std::size_t log_buckets = 0;
+            while ((std::size_t(1) << log_buckets) * bucket_bytes < bytes && (std::size_t(1) << log_buckets) < max_buckets)
+            {
+                ++log_buckets;
+            }
+            std::size_t n_buckets = std::size_t(1) << log_buckets;
+            std::size_t label_blocks = (n_rows + 7) / 8;
+            const random::philox4x32 stream = engine;
+            std::uint64_t first_block = engine.skip_blocks(label_blocks + n_buckets);
+
+            auto shuffle_bucket = [&](V* rows, std::size_t n, std::size_t bucket)
+            {
+                random::philox4x32::block_type w = stream.block(first_block + label_blocks + bucket);
+                random::philox4x32 sub((std::uint64_t(w[0]) << 32) | w[1], (std::uint64_t(w[2]) << 32) | w[3]);
+                for (std::size_t i = n; i-- > 1;)
+                {
+                    std::size_t j = philox_bounded(sub, static_cast<std::uint32_t>(i + 1));
+                    if (j != i)
+                    {
+                        std::swap_ranges(rows + i * row_size, rows + (i + 1) * row_size, rows + j * row_size);
+                    }
+                }
+            };
+
+            if (n_buckets == 1)
+            {
+                shuffle_bucket(data, n_rows, 0);
+                return;
+            }
+
+            // The bucket of row i is given by the (i % 8)-th half word of the
+            // block first_block + i / 8; the buckets are computed once and
+            // kept for the scatter pass.
+            std::size_t n_chunks = (n_rows + chunk_rows - 1) / chunk_rows;
+            std::vector<std::uint16_t> labels(n_rows);
+            std::vector<std::size_t> offsets(n_chunks * n_buckets, 0);
+            exec::default_policy().for_range(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t* count = offsets.data() + c * n_buckets;
+                    std::size_t end = (std::min)((c + 1) * chunk_rows, n_rows);
+                    for (std::size_t i = c * chunk_rows; i < end; i += 8)
+                    {
+                        random::philox4x32::block_type w = stream.block(first_block + i / 8);
+                        std::size_t n = (std::min)(std::size_t(8), end - i);
+                        for (std::size_t k = 0; k < n; ++k)
+                        {
+                            std::uint32_t half = k % 2 == 0 ? w[k / 2] >> 16 : w[k / 2] & 0xFFFF;
+                            std::uint16_t b = static_cast<std::uint16_t>(half >> (16 - log_buckets));
+                            labels[i + k] = b;
+                            ++count[b];
+                        }
+                    }
+                }
+            });
+
+            std::vector<std::size_t> bucket_start(n_buckets + 1);
+            std::size_t total = 0;
+            for (std::size_t b = 0; b < n_buckets; ++b)
+            {
+                bucket_start[b] = total;
+                for (std::size_t c = 0; c < n_chunks; ++c)
+                {
+                    std::size_t count = offsets[c * n_buckets + b];
+                    offsets[c * n_buckets + b] = total;
+                    total += count;
+                }
+            }
+            bucket_start[n_buckets] = total;
+
+            uvector<V> tmp(n_rows * row_size);
+            exec::default_policy().for_range(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t* offset = offsets.data() + c * n_buckets;
+                    std::size_t end = (std::min)((c + 1) * chunk_rows, n_rows);
+                    for (std::size_t i = c * chunk_rows; i < end; ++i)
+                    {
+                        const V* src = data + i * row_size;
+                        std::copy(src, src + row_size, tmp.data() + (offset[labels[i]]++) * row_size);
+                    }
+                }
+            });
+
+            exec::default_policy().for_range(std::size_t(0), n_buckets, std::size_t(1), [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    V* rows = tmp.data() + bucket_start[b] * row_size;
+                    std::size_t n = bucket_start[b + 1] - bucket_start[b];
+                    shuffle_bucket(rows, n, b);
+                    std::copy(rows, rows + n * row_size, data + bucket_start[b] * row_size);
+                }
+            });
+        }
     }
 
     namespace random
@@ -256,6 +776,133 @@ namespace xt
             get_default_random_engine().seed(seed);
         }
 
+        /*****************************
+         * philox4x32 implementation *
+         *****************************/
+
+        // One round of the Philox bijection, with the multipliers of
+        // Salmon et al., "Parallel random numbers: as easy as 1, 2, 3".
+        inline void philox4x32::round(block_type& c, const key_type& k) noexcept
+        {
+            std::uint64_t p0 = std::uint64_t(0xD2511F53) * c[0];
+            std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c[2];
+            c = {{static_cast<result_type>(p1 >> 32) ^ c[1] ^ k[0], static_cast<result_type>(p1),
+                  static_cast<result_type>(p0 >> 32) ^ c[3] ^ k[1], static_cast<result_type>(p0)}};
+        }
+
+        /**
+         * Builds a philox4x32 engine.
+         * @param seed the seed, used as the key of the engine
+         * @param stream the identifier of the stream, engines with the same
+         *        seed and different streams generate independent sequences
+         */
+        inline philox4x32::philox4x32(std::uint64_t seed, std::uint64_t stream) noexcept
+        {
+            this->seed(seed, stream);
+        }
+
+        /**
+         * Sets the key and the stream of the engine and rewinds it to the
+         * beginning of the stream.
+         */
+        inline void philox4x32::seed(std::uint64_t seed, std::uint64_t stream) noexcept
+        {
+            m_key = {{static_cast<result_type>(seed), static_cast<result_type>(seed >> 32)}};
+            m_stream = stream;
+            set_counter(0);
+        }
+
+        inline constexpr auto philox4x32::min() noexcept -> result_type
+        {
+            return 0;
+        }
+
+        inline constexpr auto philox4x32::max() noexcept -> result_type
+        {
+            return (std::numeric_limits<result_type>::max)();
+        }
+
+        /**
+         * Returns the next word of the stream.
+         */
+        inline auto philox4x32::operator()() noexcept -> result_type
+        {
+            if (m_index == m_buffer.size())
+            {
+                m_buffer = block(m_counter++);
+                m_index = 0;
+            }
+            return m_buffer[m_index++];
+        }
+
+        /**
+         * Advances the engine by \c z words.
+         */
+        inline void philox4x32::discard(unsigned long long z) noexcept
+        {
+            std::size_t remaining = m_buffer.size() - m_index;
+            if (z <= remaining)
+            {
+                m_index += static_cast<std::size_t>(z);
+                return;
+            }
+            z -= remaining;
+            m_counter += z / m_buffer.size();
+            m_index = m_buffer.size();
+            for (std::size_t k = 0; k < static_cast<std::size_t>(z % m_buffer.size()); ++k)
+            {
+                (*this)();
+            }
+        }
+
+        /**
+         * Returns the block of index \c n of the stream, without changing
+         * the state of the engine.
+         */
+        inline auto philox4x32::block(std::uint64_t n) const noexcept -> block_type
+        {
+            block_type c = {{static_cast<result_type>(n), static_cast<result_type>(n >> 32),
+                             static_cast<result_type>(m_stream), static_cast<result_type>(m_stream >> 32)}};
+            key_type k = m_key;
+            round(c, k);
+            for (std::size_t r = 1; r < 10; ++r)
+            {
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+                round(c, k);
+            }
+            return c;
+        }
+
+        /**
+         * Returns the index of the first block of the stream none of whose
+         * words have been returned by the engine yet.
+         */
+        inline std::uint64_t philox4x32::counter() const noexcept
+        {
+            return m_counter;
+        }
+
+        /**
+         * Moves the engine to the beginning of the block of index \c n.
+         */
+        inline void philox4x32::set_counter(std::uint64_t n) noexcept
+        {
+            m_counter = n;
+            m_index = m_buffer.size();
+        }
+
+        /**
+         * Reserves the next \c n blocks of the stream, and returns the
+         * index of the first one. The engine is moved past them.
+         */
+        inline std::uint64_t philox4x32::skip_blocks(std::uint64_t n) noexcept
+        {
+            std::uint64_t first = counter();
+            set_counter(first + n);
+            return first;
+        }
+
         /**
          * xexpression with specified @p shape containing uniformly distributed random numbers
          * in the interval from @p lower to @p upper, excluding upper.
@@ -675,6 +1322,193 @@ namespace xt
             return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
         }
 
+        /**
+         * xexpression with specified @p shape containing uniformly distributed
+         * random numbers in the interval from @p lower to @p upper, excluding
+         * upper, computed by a counter-based engine.
+         *
+         * The element of flat index \c i in row-major order is a function of
+         * the state of @p engine and of \c i only: the values do not depend on
+         * the layout of the result nor on the way the assignment is split
+         * across threads. The engine is moved past the blocks used by the
+         * returned expression.
+         *
+         * @param shape shape of resulting xexpression
+         * @param lower lower bound
+         * @param upper upper bound
+         * @param engine counter-based random number engine
+         * @tparam T floating point type to use
+         */
+        template <class T, class S>
+        inline auto rand(const S& shape, T lower, T upper, philox4x32& engine)
+        {
+            return detail::make_philox_generator<T>(engine, detail::uniform_transform<T>{lower, upper}, shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the Normal (Gaussian) random number distribution with mean @p mean and
+         * standard deviation @p std_dev, computed by a counter-based engine.
+         *
+         * Numbers are computed with the Box-Muller transform; as for \ref rand,
+         * the element of flat index \c i in row-major order is a function of
+         * the state of @p engine and of \c i only.
+         *
+         * @param shape shape of resulting xexpression
+         * @param mean mean of normal distribution
+         * @param std_dev standard deviation of normal distribution
+         * @param engine counter-based random number engine
+         * @tparam T floating point type to use
+         */
+        template <class T, class S>
+        inline auto randn(const S& shape, T mean, T std_dev, philox4x32& engine)
+        {
+            return detail::make_philox_generator<T>(engine, detail::box_muller_transform<T>{mean, std_dev}, shape);
+        }
+
+        template <class T, class I, std::size_t L>
+        inline auto rand(const I (&shape)[L], T lower, T upper, philox4x32& engine)
+        {
+            using shape_type = std::array<std::size_t, L>;
+            return rand(xtl::forward_sequence<shape_type, decltype(shape)>(shape), lower, upper, engine);
+        }
+
+        template <class T, class I, std::size_t L>
+        inline auto randn(const I (&shape)[L], T mean, T std_dev, philox4x32& engine)
+        {
+            using shape_type = std::array<std::size_t, L>;
+            return randn(xtl::forward_sequence<shape_type, decltype(shape)>(shape), mean, std_dev, engine);
+        }
+
+        /**
+         * Fills @p e in place with uniformly distributed random numbers
+         * in the interval from @p lower to @p upper, excluding upper.
+         *
+         * Numbers are drawn from @c std::uniform_real_distribution, in the
+         * storage order of @p e, and written without allocating.
+         *
+         * @param e xexpression to fill, e.g. a preallocated container
+         * @param lower lower bound
+         * @param upper upper bound
+         * @param engine random number engine
+         */
+        template <class E, class T, class G>
+        inline void fill_rand(xexpression<E>& e, T lower, T upper, G& engine)
+        {
+            using value_type = typename E::value_type;
+            std::uniform_real_distribution<value_type> dist(static_cast<value_type>(lower), static_cast<value_type>(upper));
+            detail::random_fill(e.derived_cast(), [&](value_type* out, std::size_t n)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    out[i] = dist(engine);
+                }
+            });
+        }
+
+        /**
+         * Fills @p e in place with uniformly distributed random integers
+         * in the interval from @p lower to @p upper, excluding upper.
+         *
+         * Numbers are drawn from @c std::uniform_int_distribution, in the
+         * storage order of @p e, and written without allocating.
+         *
+         * @param e xexpression to fill, e.g. a preallocated container
+         * @param lower lower bound
+         * @param upper upper bound
+         * @param engine random number engine
+         */
+        template <class E, class T, class G>
+        inline void fill_randint(xexpression<E>& e, T lower, T upper, G& engine)
+        {
+            using value_type = typename E::value_type;
+            std::uniform_int_distribution<value_type> dist(static_cast<value_type>(lower), static_cast<value_type>(upper - 1));
+            detail::random_fill(e.derived_cast(), [&](value_type* out, std::size_t n)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    out[i] = dist(engine);
+                }
+            });
+        }
+
+        /**
+         * Fills @p e in place with numbers sampled from the Normal (Gaussian)
+         * random number distribution with mean @p mean and standard deviation
+         * @p std_dev.
+         *
+         * Uniform numbers are drawn from @p engine in the storage order of
+         * @p e, then transformed by pairs with the Box-Muller method in a
+         * loop the compiler can vectorize. The sequence therefore differs
+         * from the one of \ref randn, which uses @c std::normal_distribution.
+         *
+         * @param e xexpression of floating point values to fill
+         * @param mean mean of normal distribution
+         * @param std_dev standard deviation of normal distribution
+         * @param engine random number engine
+         */
+        template <class E, class T, class G>
+        inline void fill_randn(xexpression<E>& e, T mean, T std_dev, G& engine)
+        {
+            using value_type = typename E::value_type;
+            static_assert(std::is_floating_point<value_type>::value, "fill_randn requires a floating point value type");
+            std::uniform_real_distribution<value_type> unit(value_type(0), value_type(1));
+            detail::box_muller_transform<value_type> transform{static_cast<value_type>(mean), static_cast<value_type>(std_dev)};
+            detail::random_fill(e.derived_cast(), [&](value_type* out, std::size_t n)
+            {
+                std::size_t even = n - n % 2;
+                for (std::size_t i = 0; i < even; ++i)
+                {
+                    out[i] = unit(engine);
+                }
+                transform(out, even);
+                if (even != n)
+                {
+                    value_type pair[2] = {unit(engine), unit(engine)};
+                    transform(pair, 2);
+                    out[even] = pair[0];
+                }
+            });
+        }
+
+        /**
+         * Fills @p e in place with uniformly distributed random numbers
+         * computed by a counter-based engine. @p e receives the values of
+         * the expression returned by \ref rand for its shape and the same
+         * engine, and the engine is moved past them.
+         *
+         * @param e xexpression of floating point values to fill
+         * @param lower lower bound
+         * @param upper upper bound
+         * @param engine counter-based random number engine
+         */
+        template <class E, class T>
+        inline void fill_rand(xexpression<E>& e, T lower, T upper, philox4x32& engine)
+        {
+            using value_type = typename E::value_type;
+            detail::uniform_transform<value_type> dist{static_cast<value_type>(lower), static_cast<value_type>(upper)};
+            detail::make_philox_impl<value_type>(engine, dist, e.derived_cast().shape()).assign_to(e);
+        }
+
+        /**
+         * Fills @p e in place with numbers sampled from the Normal (Gaussian)
+         * random number distribution, computed by a counter-based engine.
+         * @p e receives the values of the expression returned by \ref randn
+         * for its shape and the same engine, and the engine is moved past them.
+         *
+         * @param e xexpression of floating point values to fill
+         * @param mean mean of normal distribution
+         * @param std_dev standard deviation of normal distribution
+         * @param engine counter-based random number engine
+         */
+        template <class E, class T>
+        inline void fill_randn(xexpression<E>& e, T mean, T std_dev, philox4x32& engine)
+        {
+            using value_type = typename E::value_type;
+            detail::box_muller_transform<value_type> dist{static_cast<value_type>(mean), static_cast<value_type>(std_dev)};
+            detail::make_philox_impl<value_type>(engine, dist, e.derived_cast().shape()).assign_to(e);
+        }
+
         /**
          * Randomly shuffle elements inplace in xcontainer along first axis.
          * The order of sub-arrays is changed but their contents remain the same.
@@ -685,36 +1519,46 @@ namespace xt
         template <class T, class E>
         void shuffle(xexpression<T>& e, E& engine)
         {
-            T& de = e.derived_cast();
+            detail::fisher_yates_shuffle(e.derived_cast(), engine);
+        }
 
-            if (de.dimension() == 1)
+        /**
+         * Randomly shuffle elements inplace in xcontainer along first axis,
+         * with a counter-based engine.
+         *
+         * The rows are first scattered to buckets of about the size of the
+         * cache, the bucket of each row being computed from the engine state
+         * and the index of the row only, then each bucket is shuffled with its
+         * own engine. Both passes run through exec::default_policy, and the
+         * result does not depend on the number of threads. Contiguous
+         * row-major containers are shuffled this way, with a temporary copy
+         * of their data; the other expressions are shuffled sequentially.
+         *
+         * @param e xcontainer to shuffle inplace
+         * @param engine counter-based random number engine
+         */
+        template <class T>
+        void shuffle(xexpression<T>& e, philox4x32& engine)
+        {
+            T& de = e.derived_cast();
+            bool done = xtl::mpl::static_if<has_data_interface<T>::value>([&](auto self)
             {
-                using size_type = typename T::size_type;
-                auto first = de.begin();
-                auto last = de.end();
-
-                for (size_type i = std::size_t((last - first) - 1); i > 0; --i)
+                auto& d = self(de);
+                if (d.dimension() == 0 || !d.is_contiguous() || (d.dimension() > 1 && d.layout() != layout_type::row_major))
                 {
-                    std::uniform_int_distribution<size_type> dist(0, i);
-                    auto j = dist(engine);
-                    using std::swap;
-                    swap(first[i], first[j]);
+                    return false;
                 }
-            }
-            else
+                std::size_t n_rows = static_cast<std::size_t>(d.shape()[0]);
+                std::size_t row_size = n_rows == 0 ? 0 : d.size() / n_rows;
+                detail::bucket_shuffle(d.data() + static_cast<std::ptrdiff_t>(d.data_offset()), n_rows, row_size, engine);
+                return true;
+            }, /*else*/ [](auto /*self*/)
             {
-                using size_type = typename T::size_type;
-                decltype(auto) buf = empty_like(view(de, 0));
-
-                for (size_type i = de.shape()[0] - 1; i > 0; --i)
-                {
-                    std::uniform_int_distribution<size_type> dist(0, i);
-                    size_type j = dist(engine);
-
-                    buf = view(de, j);
-                    view(de, j) = view(de, i);
-                    view(de, i) = buf;
-                }
+                return false;
+            });
+            if (!done)
+            {
+                detail::fisher_yates_shuffle(de, engine);
             }
         }
 
@@ -784,17 +1628,23 @@ namespace xt
             }
             else
             {
-                // Naive resevoir sampling without weighting:
-                std::copy(de.storage().begin(), de.storage().begin() + n, result.begin());
-                size_type i = n;
-                for(auto it = de.storage().begin() + n; it != de.storage().end(); ++it, ++i)
+                // Floyd's algorithm draws n distinct indices with n random
+                // numbers and O(n) memory; the samples are then shuffled so
+                // that their order is random as well.
+                std::unordered_set<size_type> selected;
+                selected.reserve(n);
+                size_type i = 0;
+                for (size_type j = de.size() - n; j < de.size(); ++j, ++i)
                 {
-                    auto idx = std::uniform_int_distribution<size_type>(0, i)(engine);
-                    if (idx < n)
+                    size_type t = std::uniform_int_distribution<size_type>(0, j)(engine);
+                    size_type idx = selected.insert(t).second ? t : j;
+                    if (idx == j)
                     {
-                        result.storage()[idx] = *it;
+                        selected.insert(j);
                     }
+                    result.storage()[i] = de.storage()[idx];
                 }
+                shuffle(result, engine);
             }
             return result;
         }
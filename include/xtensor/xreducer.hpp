@@ -11,9 +11,11 @@
 #define XTENSOR_REDUCER_HPP
 
 #include <algorithm>
+#include <complex>
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
@@ -23,12 +25,18 @@
 #include <xtl/xsequence.hpp>
 
 #include "xaccessible.hpp"
+#include "xarena.hpp"
+#include "xassign.hpp"
 #include "xbuilder.hpp"
+#include "xdispatch.hpp"
 #include "xeval.hpp"
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
 #include "xiterable.hpp"
+#include "xprofiler.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -43,6 +51,16 @@ namespace xt
     struct keep_dims_type : xt::detail::option_base {};
     constexpr auto keep_dims = std::tuple<keep_dims_type>{};
 
+    namespace summation
+    {
+        struct naive_type : xt::detail::option_base {};
+        constexpr auto naive = std::tuple<naive_type>{};
+        struct pairwise_type : xt::detail::option_base {};
+        constexpr auto pairwise = std::tuple<pairwise_type>{};
+        struct kahan_type : xt::detail::option_base {};
+        constexpr auto kahan = std::tuple<kahan_type>{};
+    }
+
     template <class T = double>
     struct xinitial : xt::detail::option_base
     {
@@ -125,6 +143,16 @@ namespace xt
             );
         }
 
+        template <class OR>
+        reducer_options(const reducer_options<OR, T>& other)
+        {
+            xtl::mpl::static_if<initial_val_idx != std::tuple_size<T>::value>([this, &other](auto no_compile) {
+                    this->initial_value = static_cast<R>(no_compile(other).initial_value);
+                },
+                [](auto /*np_compile*/){}
+            );
+        }
+
         using evaluation_strategy = std::conditional_t<tuple_idx_of<xt::evaluation_strategy::immediate_type, d_t>::value != -1,
                                                                     xt::evaluation_strategy::immediate_type,
                                                                     xt::evaluation_strategy::lazy_type>;
@@ -133,6 +161,12 @@ namespace xt
                                              std::true_type,
                                              std::false_type>;
 
+        using summation = std::conditional_t<tuple_idx_of<xt::summation::kahan_type, d_t>::value != -1,
+                                             xt::summation::kahan_type,
+                                             std::conditional_t<tuple_idx_of<xt::summation::pairwise_type, d_t>::value != -1,
+                                                                xt::summation::pairwise_type,
+                                                                xt::summation::naive_type>>;
+
         constexpr static bool has_initial_value = initial_val_idx != std::tuple_size<d_t>::value;
 
         R initial_value;
@@ -164,6 +198,26 @@ namespace xt
     {
     };
 
+    namespace detail
+    {
+        // Options already parsed by a lazy reducer are rebound to the
+        // value type of the immediate evaluation.
+        template <class R, class O>
+        struct reducer_options_type
+        {
+            using type = reducer_options<R, O>;
+        };
+
+        template <class R, class OR, class T>
+        struct reducer_options_type<R, reducer_options<OR, T>>
+        {
+            using type = reducer_options<R, T>;
+        };
+
+        template <class R, class O>
+        using reducer_options_t = typename reducer_options_type<R, std::decay_t<O>>::type;
+    }
+
     /**********
      * reduce *
      **********/
@@ -260,19 +314,789 @@ namespace xt
         }
     }
 
+    namespace math
+    {
+        template <class T>
+        struct minimum;
+
+        template <class T>
+        struct maximum;
+    }
+
+    namespace detail
+    {
+        // Length of the chunks reduced independently when an immediate
+        // reduction runs in parallel. It does not depend on the number of
+        // threads, so that the results are reproducible.
+        constexpr std::size_t reduce_chunk_size = 16384;
+
+        inline bool use_parallel_reduce(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            return size >= 2 * reduce_chunk_size && size >= exec::default_threshold();
+#else
+            (void) size;
+            return false;
+#endif
+        }
+
+        /*****************************
+         * contiguous simd reduction *
+         *****************************/
+
+        // Reduction functors whose simd_apply may be used with several
+        // accumulators, i.e. which can be reassociated.
+        template <class RF>
+        struct is_simd_reducer : std::false_type
+        {
+        };
+
+        template <>
+        struct is_simd_reducer<plus> : std::true_type
+        {
+        };
+
+        template <>
+        struct is_simd_reducer<multiplies> : std::true_type
+        {
+        };
+
+        template <class T>
+        struct is_simd_reducer<math::minimum<T>> : std::true_type
+        {
+        };
+
+        template <class T>
+        struct is_simd_reducer<math::maximum<T>> : std::true_type
+        {
+        };
+
+        // Start value of the accumulators of a reduction in lanes, computed
+        // from the first element of the lane.
+        template <class RF>
+        struct simd_reducer_start
+        {
+            template <class T>
+            static constexpr T apply(const T& v)
+            {
+                return v;
+            }
+
+            template <class B>
+            static constexpr B simd_apply(const B& b)
+            {
+                return b;
+            }
+        };
+
+        // Value types of the reductions in lanes: the arithmetic types, and
+        // the complex types for the sums and the products.
+        template <class R, class RF>
+        struct is_lane_value : std::is_arithmetic<R>
+        {
+        };
+
+        template <class T>
+        struct is_lane_value<std::complex<T>, plus> : std::is_floating_point<T>
+        {
+        };
+
+        template <class T>
+        struct is_lane_value<std::complex<T>, multiplies> : std::is_floating_point<T>
+        {
+        };
+
+        template <class R, class It, class RF>
+        struct use_simd_accumulate
+        {
+#if defined(XTENSOR_USE_XSIMD)
+            using value_type = std::remove_cv_t<std::remove_pointer_t<It>>;
+            static constexpr bool value = std::is_pointer<It>::value &&
+                                          std::is_same<value_type, R>::value &&
+                                          is_lane_value<R, std::decay_t<RF>>::value &&
+                                          xt_simd::simd_traits<R>::size > 1 &&
+                                          is_simd_reducer<std::decay_t<RF>>::value;
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        // Without xsimd, the builds with runtime dispatch accumulate the
+        // known reductions in independent lanes, which the compiler
+        // vectorizes for the dispatch target.
+        template <class R, class It, class RF>
+        struct use_lane_accumulate
+        {
+#if defined(XTENSOR_USE_RUNTIME_DISPATCH) && !defined(XTENSOR_USE_XSIMD)
+            using value_type = std::remove_cv_t<std::remove_pointer_t<It>>;
+            static constexpr bool value = std::is_pointer<It>::value &&
+                                          std::is_same<value_type, R>::value &&
+                                          is_lane_value<R, std::decay_t<RF>>::value &&
+                                          is_simd_reducer<std::decay_t<RF>>::value;
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        template <class R, class It, class RF>
+        inline R accumulate_serial(It first, It last, R init, RF& reduce_fct, std::false_type)
+        {
+            return std::accumulate(first, last, init, reduce_fct);
+        }
+
+        template <class R, class It, class RF>
+        inline R accumulate_serial(It first, It last, R init, RF& reduce_fct, std::true_type)
+        {
+            constexpr std::size_t n_lanes = 16;
+            std::size_t size = static_cast<std::size_t>(last - first);
+            if (size < 2 * n_lanes)
+            {
+                return std::accumulate(first, last, init, reduce_fct);
+            }
+
+            R res = init;
+            dispatch_kernel([&]()
+            {
+                using start_type = simd_reducer_start<std::decay_t<RF>>;
+                R acc[n_lanes];
+                for (std::size_t j = 0; j < n_lanes; ++j)
+                {
+                    acc[j] = start_type::apply(first[j]);
+                }
+                std::size_t i = n_lanes;
+                for (; i + n_lanes <= size; i += n_lanes)
+                {
+                    for (std::size_t j = 0; j < n_lanes; ++j)
+                    {
+                        acc[j] = reduce_fct(acc[j], first[i + j]);
+                    }
+                }
+                for (std::size_t j = 0; j < n_lanes; ++j)
+                {
+                    res = reduce_fct(res, acc[j]);
+                }
+                for (; i < size; ++i)
+                {
+                    res = reduce_fct(res, first[i]);
+                }
+            });
+            return res;
+        }
+
+        template <class R, class It, class RF>
+        inline R accumulate_contiguous_impl(It first, It last, R init, RF& reduce_fct, std::false_type)
+        {
+            using use_lanes = std::integral_constant<bool, use_lane_accumulate<R, It, RF>::value>;
+            return accumulate_serial(first, last, init, reduce_fct, use_lanes());
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class R, class It, class RF>
+        inline R accumulate_contiguous_impl(It first, It last, R init, RF& reduce_fct, std::true_type)
+        {
+            using batch_type = xt_simd::simd_type<R>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            // Independent accumulators hide the latency of the reduction
+            // instruction.
+            constexpr std::size_t n_acc = 4;
+            constexpr std::size_t step = n_acc * simd_size;
+
+            std::size_t size = static_cast<std::size_t>(last - first);
+            std::size_t align_begin = xt_simd::get_alignment_offset(first, size, simd_size);
+            std::size_t simd_end = align_begin + ((size - align_begin) / step) * step;
+
+            R res = init;
+            for (std::size_t i = 0; i < align_begin; ++i)
+            {
+                res = reduce_fct(res, first[i]);
+            }
+            if (simd_end != align_begin)
+            {
+                using start_type = simd_reducer_start<std::decay_t<RF>>;
+                batch_type acc[n_acc];
+                for (std::size_t k = 0; k < n_acc; ++k)
+                {
+                    acc[k] = start_type::simd_apply(xt_simd::load_as<R>(first + align_begin + k * simd_size, aligned_mode()));
+                }
+                for (std::size_t i = align_begin + step; i < simd_end; i += step)
+                {
+                    for (std::size_t k = 0; k < n_acc; ++k)
+                    {
+                        acc[k] = reduce_fct.simd_apply(acc[k], xt_simd::load_as<R>(first + i + k * simd_size, aligned_mode()));
+                    }
+                }
+                batch_type acc_res = reduce_fct.simd_apply(reduce_fct.simd_apply(acc[0], acc[1]),
+                                                           reduce_fct.simd_apply(acc[2], acc[3]));
+                alignas(batch_type) R buffer[simd_size];
+                xt_simd::store_as(buffer, acc_res, aligned_mode());
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    res = reduce_fct(res, buffer[i]);
+                }
+            }
+            for (std::size_t i = simd_end; i < size; ++i)
+            {
+                res = reduce_fct(res, first[i]);
+            }
+            return res;
+        }
+#endif
+
+        // Reduction functors may take over the contiguous loop with an
+        // accumulate(first, last, init) method, e.g. to keep several
+        // partial results in registers.
+        template <class RF, class It, class R, class = void>
+        struct has_accumulate_method : std::false_type
+        {
+        };
+
+        template <class RF, class It, class R>
+        struct has_accumulate_method<RF, It, R, void_t<decltype(std::declval<const RF&>().accumulate(std::declval<It>(),
+                                                                                                    std::declval<It>(),
+                                                                                                    std::declval<R>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class R, class It, class RF>
+        inline R accumulate_contiguous(It first, It last, R init, RF& reduce_fct, std::true_type /*has_accumulate*/)
+        {
+            return reduce_fct.accumulate(first, last, init);
+        }
+
+        template <class R, class It, class RF>
+        inline R accumulate_contiguous(It first, It last, R init, RF& reduce_fct, std::false_type /*has_accumulate*/)
+        {
+            using use_simd = std::integral_constant<bool, use_simd_accumulate<R, It, RF>::value>;
+            return accumulate_contiguous_impl(first, last, init, reduce_fct, use_simd());
+        }
+
+        /**
+         * Equivalent to std::accumulate(first, last, init, reduce_fct). Known
+         * reduction functors on contiguous memory are vectorized when xsimd
+         * or the runtime dispatch is enabled, which changes the summation
+         * order of floating point values.
+         */
+        template <class R, class It, class RF>
+        inline R accumulate_contiguous(It first, It last, R init, RF& reduce_fct)
+        {
+            return accumulate_contiguous(first, last, init, reduce_fct, has_accumulate_method<std::decay_t<RF>, It, R>());
+        }
+
+        /**
+         * Reduces the n contiguous elements starting at first. In parallel,
+         * chunks are reduced from init_fct() on the worker threads and the
+         * partial results are combined in order with merge_fct.
+         */
+        template <class R, class It, class RF, class IF, class MF>
+        inline R reduce_contiguous(It first, std::size_t n, RF& reduce_fct, IF& init_fct, MF& merge_fct, bool parallel)
+        {
+            if (!parallel || n < 2 * reduce_chunk_size)
+            {
+                R tmp = init_fct();
+                return accumulate_contiguous(first, first + static_cast<std::ptrdiff_t>(n), tmp, reduce_fct);
+            }
+
+            std::size_t n_chunks = (n + reduce_chunk_size - 1) / reduce_chunk_size;
+            arena_uvector<R> partials(n_chunks);
+            exec::default_policy().for_range(std::size_t(0), n_chunks, std::size_t(1),
+                                             [&](std::size_t chunk_begin, std::size_t chunk_end)
+            {
+                for (std::size_t c = chunk_begin; c < chunk_end; ++c)
+                {
+                    It b = first + static_cast<std::ptrdiff_t>(c * reduce_chunk_size);
+                    It e = first + static_cast<std::ptrdiff_t>((std::min)((c + 1) * reduce_chunk_size, n));
+                    R tmp = init_fct();
+                    partials[c] = accumulate_contiguous(b, e, tmp, reduce_fct);
+                }
+            });
+
+            R res = partials[0];
+            for (std::size_t c = 1; c < n_chunks; ++c)
+            {
+                res = merge_fct(res, partials[c]);
+            }
+            return res;
+        }
+
+        /************************************
+         * Reduction of linear xexpressions *
+         ************************************/
+
+        // Complete reductions of an element-wise expression whose operands
+        // can be traversed linearly are fused with the computation of the
+        // elements: blocks of the expression are evaluated into a buffer
+        // that stays in cache, and reduced with the contiguous kernels,
+        // instead of evaluating the whole expression into a temporary.
+        constexpr std::size_t linear_reduce_block_size = 256;
+
+        template <class E, class = void>
+        struct has_linear_reduce : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_linear_reduce<E, void_t<decltype(std::declval<const E&>().has_linear_assign(std::declval<const get_strides_t<typename E::shape_type>&>())),
+                                           decltype(linear_begin(std::declval<const E&>()))>>
+            : std::is_arithmetic<typename E::value_type>
+        {
+        };
+
+        template <class E>
+        inline bool is_linear_reducible(const E& e, std::true_type)
+        {
+            using strides_type = get_strides_t<typename E::shape_type>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), 0);
+            compute_strides(e.shape(), layout_type::row_major, strides);
+            return e.has_linear_assign(strides);
+        }
+
+        template <class E>
+        inline bool is_linear_reducible(const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class E>
+        inline bool is_linear_reducible(const E& e)
+        {
+            return is_linear_reducible(e, has_linear_reduce<E>());
+        }
+
+        template <class E, class V>
+        inline void load_linear(const E& e, std::size_t first, std::size_t n, V* buffer, std::false_type /*use_simd*/)
+        {
+            std::copy_n(linear_begin(e) + static_cast<std::ptrdiff_t>(first), n, buffer);
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class E, class V>
+        inline void load_linear(const E& e, std::size_t first, std::size_t n, V* buffer, std::true_type /*use_simd*/)
+        {
+            using size_type = typename E::size_type;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<V>::size;
+            std::size_t simd_end = (n / simd_size) * simd_size;
+            for (std::size_t i = 0; i < simd_end; i += simd_size)
+            {
+                xt_simd::store_as(buffer + i, e.template load_simd<unaligned_mode, V>(static_cast<size_type>(first + i)), unaligned_mode());
+            }
+            std::copy_n(linear_begin(e) + static_cast<std::ptrdiff_t>(first + simd_end), n - simd_end, buffer + simd_end);
+        }
+#endif
+
+        template <class E>
+        struct use_simd_linear_load
+        {
+            using value_type = typename E::value_type;
+            static constexpr bool value = has_simd_interface<E, value_type>::value
+                && has_simd_type<value_type>::value
+                && !std::is_same<value_type, bool>::value;
+        };
+
+        template <class R, class E, class RF>
+        inline R accumulate_linear(const E& e, std::size_t first, std::size_t last, R init, RF& reduce_fct, std::true_type /*is_pointer*/)
+        {
+            auto begin = linear_begin(e);
+            return accumulate_contiguous(begin + static_cast<std::ptrdiff_t>(first), begin + static_cast<std::ptrdiff_t>(last), init, reduce_fct);
+        }
+
+        // The buffer holds the values of the expression rather than the
+        // result type, so that the reduction functor sees the same arguments
+        // as when it walks the expression.
+        template <class R, class E, class RF>
+        inline R accumulate_linear(const E& e, std::size_t first, std::size_t last, R init, RF& reduce_fct, std::false_type /*is_pointer*/)
+        {
+            using value_type = typename E::value_type;
+            using use_simd = std::integral_constant<bool, use_simd_linear_load<E>::value>;
+            value_type buffer[linear_reduce_block_size];
+            R res = init;
+            for (std::size_t i = first; i < last; i += linear_reduce_block_size)
+            {
+                std::size_t n = (std::min)(linear_reduce_block_size, last - i);
+                load_linear(e, i, n, buffer, use_simd());
+                const value_type* block = buffer;
+                res = accumulate_contiguous(block, block + static_cast<std::ptrdiff_t>(n), res, reduce_fct);
+            }
+            return res;
+        }
+
+        /**
+         * Equivalent to std::accumulate on the elements of e in [first, last),
+         * in row-major order, for an expression that can be traversed linearly
+         * (see is_linear_reducible).
+         */
+        template <class R, class E, class RF>
+        inline R accumulate_linear(const E& e, std::size_t first, std::size_t last, R init, RF& reduce_fct)
+        {
+            using is_pointer = std::is_pointer<decltype(linear_begin(e))>;
+            return accumulate_linear(e, first, last, init, reduce_fct, is_pointer());
+        }
+
+        /**
+         * Counterpart of reduce_contiguous for an expression that can be
+         * traversed linearly. The chunks are the same, so that the result
+         * does not depend on the kind of the expression.
+         */
+        template <class R, class E, class RF, class IF, class MF>
+        inline R reduce_linear(const E& e, std::size_t n, RF& reduce_fct, IF& init_fct, MF& merge_fct, bool parallel)
+        {
+            if (!parallel || n < 2 * reduce_chunk_size)
+            {
+                R tmp = init_fct();
+                return accumulate_linear(e, std::size_t(0), n, tmp, reduce_fct);
+            }
+
+            std::size_t n_chunks = (n + reduce_chunk_size - 1) / reduce_chunk_size;
+            arena_uvector<R> partials(n_chunks);
+            exec::default_policy().for_range(std::size_t(0), n_chunks, std::size_t(1),
+                                             [&](std::size_t chunk_begin, std::size_t chunk_end)
+            {
+                for (std::size_t c = chunk_begin; c < chunk_end; ++c)
+                {
+                    R tmp = init_fct();
+                    partials[c] = accumulate_linear(e, c * reduce_chunk_size, (std::min)((c + 1) * reduce_chunk_size, n),
+                                                    tmp, reduce_fct);
+                }
+            });
+
+            R res = partials[0];
+            for (std::size_t c = 1; c < n_chunks; ++c)
+            {
+                res = merge_fct(res, partials[c]);
+            }
+            return res;
+        }
+
+        template <class R, class O, class It, class RF, class IF>
+        inline void reduce_strided_serial(O out, It first, std::size_t inner_size, std::size_t outer_size,
+                                          bool merge, RF& reduce_fct, IF& init_fct)
+        {
+            dispatch_for<R>([&]()
+            {
+                std::transform(out, out + inner_size, first, out,
+                               [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
+                                    return merge ?
+                                        reduce_fct(v1, v2) :
+                                        // cast because return type of identity function is not upcasted
+                                        reduce_fct(static_cast<R>(init_fct()), v2);
+                               });
+
+                It row = first + static_cast<std::ptrdiff_t>(inner_size);
+                for (std::size_t i = 1; i < outer_size; ++i)
+                {
+                    std::transform(out, out + inner_size, row, out, reduce_fct);
+                    row += static_cast<std::ptrdiff_t>(inner_size);
+                }
+            });
+        }
+
+        /**
+         * Reduces outer_size consecutive rows of inner_size elements into
+         * the inner_size outputs starting at out. Wide rows are split
+         * across the threads; narrow rows are reduced by groups into
+         * partial rows, combined in order with merge_fct.
+         */
+        template <class R, class O, class It, class RF, class IF, class MF>
+        inline void reduce_strided(O out, It first, std::size_t inner_size, std::size_t outer_size, bool merge,
+                                   RF& reduce_fct, IF& init_fct, MF& merge_fct, bool parallel)
+        {
+            if (!parallel || inner_size * outer_size < 2 * reduce_chunk_size)
+            {
+                reduce_strided_serial<R>(out, first, inner_size, outer_size, merge, reduce_fct, init_fct);
+                return;
+            }
+
+            if (inner_size >= reduce_chunk_size)
+            {
+                exec::default_policy().for_range(std::size_t(0), inner_size, std::size_t(1),
+                                                 [&](std::size_t b, std::size_t e)
+                {
+                    std::size_t n = e - b;
+                    O o = out + static_cast<std::ptrdiff_t>(b);
+                    It it = first + static_cast<std::ptrdiff_t>(b);
+                    std::transform(o, o + n, it, o,
+                                   [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
+                                       return merge ? reduce_fct(v1, v2) : reduce_fct(static_cast<R>(init_fct()), v2);
+                                   });
+                    for (std::size_t i = 1; i < outer_size; ++i)
+                    {
+                        it += static_cast<std::ptrdiff_t>(inner_size);
+                        std::transform(o, o + n, it, o, reduce_fct);
+                    }
+                });
+                return;
+            }
+
+            std::size_t rows_per_chunk = (std::max)(reduce_chunk_size / inner_size, std::size_t(1));
+            std::size_t n_chunks = (outer_size + rows_per_chunk - 1) / rows_per_chunk;
+            arena_uvector<R> partials(n_chunks * inner_size);
+            exec::default_policy().for_range(std::size_t(0), n_chunks, std::size_t(1),
+                                             [&](std::size_t chunk_begin, std::size_t chunk_end)
+            {
+                for (std::size_t c = chunk_begin; c < chunk_end; ++c)
+                {
+                    std::size_t row_begin = c * rows_per_chunk;
+                    std::size_t row_end = (std::min)(row_begin + rows_per_chunk, outer_size);
+                    reduce_strided_serial<R>(partials.begin() + static_cast<std::ptrdiff_t>(c * inner_size),
+                                             first + static_cast<std::ptrdiff_t>(row_begin * inner_size),
+                                             inner_size, row_end - row_begin, false, reduce_fct, init_fct);
+                }
+            });
+
+            for (std::size_t j = 0; j < inner_size; ++j)
+            {
+                R tmp = partials[j];
+                for (std::size_t c = 1; c < n_chunks; ++c)
+                {
+                    tmp = merge_fct(tmp, partials[c * inner_size + j]);
+                }
+                out[static_cast<std::ptrdiff_t>(j)] = merge ? merge_fct(out[static_cast<std::ptrdiff_t>(j)], tmp) : tmp;
+            }
+        }
+
+        template <class E, class X>
+        inline void check_reduce_axes(const E& e, const X& axes)
+        {
+            // std::less is used, because as the standard says (24.4.5):
+            // A sequence is sorted with respect to a comparator comp if for any iterator i pointing to the sequence and any non-negative integer n
+            // such that i + n is a valid iterator pointing to an element of the sequence, comp(*(i + n), *i) == false.
+            // Therefore less is required to detect duplicates.
+            if (!std::is_sorted(axes.cbegin(), axes.cend(), std::less<>()))
+            {
+                XTENSOR_THROW(std::runtime_error, "Reducing axes should be sorted.");
+            }
+            if (std::adjacent_find(axes.cbegin(), axes.cend()) != axes.cend())
+            {
+                XTENSOR_THROW(std::runtime_error, "Reducing axes should not contain duplicates.");
+            }
+            if (axes.size() != 0 && axes[axes.size() - 1] > e.dimension() - 1)
+            {
+                XTENSOR_THROW(std::runtime_error,
+                              "Axis " + std::to_string(axes[axes.size() - 1]) +
+                              " out of bounds for reduction.");
+            }
+        }
+
+        /***********************
+         * compensated summing *
+         ***********************/
+
+        // Below this length, pairwise summation falls back to a blocked
+        // naive loop; the error bound is O(log(n / block) + block) ulps.
+        constexpr std::size_t pairwise_block_size = 128;
+
+        template <class R, class It>
+        inline R sum_range(It first, std::size_t n, summation::pairwise_type)
+        {
+            if (n < 8)
+            {
+                R res = R(0);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    res += static_cast<R>(first[static_cast<std::ptrdiff_t>(i)]);
+                }
+                return res;
+            }
+            else if (n <= pairwise_block_size)
+            {
+                // Eight partial sums, as numpy does, so that the loop does
+                // not serialize on a single accumulator.
+                R partials[8];
+                for (std::size_t k = 0; k < 8; ++k)
+                {
+                    partials[k] = static_cast<R>(first[static_cast<std::ptrdiff_t>(k)]);
+                }
+                std::size_t i = 8;
+                for (; i + 8 <= n; i += 8)
+                {
+                    for (std::size_t k = 0; k < 8; ++k)
+                    {
+                        partials[k] += static_cast<R>(first[static_cast<std::ptrdiff_t>(i + k)]);
+                    }
+                }
+                R res = ((partials[0] + partials[1]) + (partials[2] + partials[3])) +
+                        ((partials[4] + partials[5]) + (partials[6] + partials[7]));
+                for (; i < n; ++i)
+                {
+                    res += static_cast<R>(first[static_cast<std::ptrdiff_t>(i)]);
+                }
+                return res;
+            }
+            else
+            {
+                std::size_t half = (n / 2) - (n / 2) % 8;
+                return sum_range<R>(first, half, summation::pairwise_type()) +
+                       sum_range<R>(first + static_cast<std::ptrdiff_t>(half), n - half, summation::pairwise_type());
+            }
+        }
+
+        template <class R, class It>
+        inline R sum_range(It first, std::size_t n, summation::kahan_type)
+        {
+            R res = R(0);
+            R compensation = R(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                R y = static_cast<R>(first[static_cast<std::ptrdiff_t>(i)]) - compensation;
+                R t = res + y;
+                compensation = (t - res) - y;
+                res = t;
+            }
+            return res;
+        }
+    }
+
+    namespace detail
+    {
+        template <class F, class E, class X, class O>
+        struct reduce_immediate_types
+        {
+            using reduce_functor_type = typename std::decay_t<F>::reduce_functor_type;
+            using init_functor_type = typename std::decay_t<F>::init_functor_type;
+            using expr_value_type = typename std::decay_t<E>::value_type;
+            using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(std::declval<init_functor_type>()(), std::declval<expr_value_type>()))>;
+            using options_t = reducer_options_t<result_type, O>;
+            using shape_type = typename xreducer_shape_type<typename std::decay_t<E>::shape_type, std::decay_t<X>, typename options_t::keep_dims>::type;
+            using result_container_type = typename xtype_for_shape<shape_type>::template type<result_type, std::decay_t<E>::static_layout>;
+        };
+    }
+
+    /*****************************
+     * Reduction of fixed shapes *
+     *****************************/
+
+    namespace detail
+    {
+        template <class S>
+        struct fixed_compute_size;
+
+        // Offsets, in the buffer of a container of shape fixed_shape<I...>
+        // and layout L, of the first element reduced into each element of the
+        // result (outer), and of the reduced elements relative to this first
+        // one (inner), both in the memory order of L.
+        template <class S, class X, layout_type L>
+        struct fixed_reduce_offsets;
+
+        template <std::size_t... I, std::size_t... J, layout_type L>
+        struct fixed_reduce_offsets<fixed_shape<I...>, fixed_shape<J...>, L>
+        {
+            static constexpr std::size_t dimension = sizeof...(I);
+            static constexpr std::size_t size = fixed_compute_size<fixed_shape<I...>>::value;
+            static constexpr std::size_t inner_size = fixed_compute_size<fixed_shape<fixed_shape<I...>::template get<J>()...>>::value;
+            static constexpr std::size_t outer_size = size / inner_size;
+
+            std::size_t outer[outer_size];
+            std::size_t inner[inner_size];
+
+            constexpr fixed_reduce_offsets()
+                : outer{}, inner{}
+            {
+                const std::size_t shape[dimension] = {I...};
+                bool reduced[dimension] = {};
+                std::size_t strides[dimension] = {};
+                const std::size_t axes[sizeof...(J)] = {J...};
+                for (std::size_t i = 0; i < sizeof...(J); ++i)
+                {
+                    reduced[axes[i]] = true;
+                }
+                std::size_t stride = 1;
+                for (std::size_t k = 0; k < dimension; ++k)
+                {
+                    std::size_t d = L == layout_type::row_major ? dimension - 1 - k : k;
+                    strides[d] = stride;
+                    stride *= shape[d];
+                }
+                fill(outer, outer_size, shape, strides, reduced, false);
+                fill(inner, inner_size, shape, strides, reduced, true);
+            }
+
+        private:
+
+            // Enumerates the indices along the axes that are reduced, or not,
+            // the fastest varying axis of L first.
+            static constexpr void fill(std::size_t* offsets, std::size_t n, const std::size_t* shape,
+                                       const std::size_t* strides, const bool* reduced, bool select)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    std::size_t rem = i;
+                    std::size_t offset = 0;
+                    for (std::size_t k = 0; k < dimension; ++k)
+                    {
+                        std::size_t d = L == layout_type::row_major ? dimension - 1 - k : k;
+                        if (reduced[d] == select)
+                        {
+                            offset += (rem % shape[d]) * strides[d];
+                            rem /= shape[d];
+                        }
+                    }
+                    offsets[i] = offset;
+                }
+            }
+        };
+
+        template <class E, class X, class = void>
+        struct is_fixed_reduction : std::false_type
+        {
+        };
+
+        template <class E, std::size_t... J>
+        struct is_fixed_reduction<E, fixed_shape<J...>, std::enable_if_t<has_data_interface<E>::value
+                                                                         && is_fixed<typename E::shape_type>::value>>
+            : std::integral_constant<bool, sizeof...(J) != 0
+                                           && E::shape_type::size() != 0
+                                           && fixed_compute_size<typename E::shape_type>::value != 0
+                                           && fixed_compute_size<typename E::shape_type>::value <= XTENSOR_FIXED_ASSIGN_MAX_SIZE
+                                           && E::contiguous_layout
+                                           && (E::static_layout == layout_type::row_major
+                                               || E::static_layout == layout_type::column_major)>
+        {
+        };
+
+        template <class F, class E, class X, class O, class R>
+        inline void reduce_fixed(F&, const E&, const X&, const O&, R&, std::false_type)
+        {
+        }
+
+        // Reduces a container of fixed shape along axes known at compile
+        // time: the offsets of the reduced elements are computed by the
+        // compiler, and the loops run over constant numbers of elements,
+        // so that they are unrolled completely for small containers.
+        template <class F, class E, class X, class O, class R>
+        inline void reduce_fixed(F& f, const E& e, const X&, const O& options, R& result, std::true_type)
+        {
+            using result_type = typename R::value_type;
+            using offsets_type = fixed_reduce_offsets<typename E::shape_type, X, E::static_layout>;
+            static constexpr offsets_type offsets{};
+            auto reduce_fct = xt::get<0>(f);
+            auto init_fct = xt::get<1>(f);
+            auto merge_fct = xt::get<2>(f);
+            const auto* data = e.data() + e.data_offset();
+            auto* out = result.data();
+            for (std::size_t i = 0; i < offsets_type::outer_size; ++i)
+            {
+                const auto* first = data + offsets.outer[i];
+                result_type acc = init_fct();
+                for (std::size_t j = 0; j < offsets_type::inner_size; ++j)
+                {
+                    acc = reduce_fct(acc, first[offsets.inner[j]]);
+                }
+                out[i] = O::has_initial_value ? merge_fct(acc, options.initial_value) : acc;
+            }
+        }
+    }
+
     template <class F, class E, class X, class O>
     inline auto reduce_immediate(F&& f, E&& e, X&& axes, O&& raw_options)
     {
-        using reduce_functor_type = typename std::decay_t<F>::reduce_functor_type;
-        using init_functor_type = typename std::decay_t<F>::init_functor_type;
-        using expr_value_type = typename std::decay_t<E>::value_type;
-        using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(std::declval<init_functor_type>()(), std::declval<expr_value_type>()))>;
-
-        using options_t = reducer_options<result_type, std::decay_t<O>>;
+        using types = detail::reduce_immediate_types<F, E, X, O>;
+        XTENSOR_PROFILE_CALL(reduce_call, typename types::reduce_functor_type);
+        using result_type = typename types::result_type;
+        using options_t = typename types::options_t;
         options_t options(raw_options);
 
-        using shape_type = typename xreducer_shape_type<typename std::decay_t<E>::shape_type, std::decay_t<X>, typename options_t::keep_dims>::type;
-        using result_container_type = typename detail::xtype_for_shape<shape_type>::template type<result_type, std::decay_t<E>::static_layout>;
+        using shape_type = typename types::shape_type;
+        using result_container_type = typename types::result_container_type;
         result_container_type result;
 
         // retrieve functors from triple struct
@@ -288,36 +1112,39 @@ namespace xt
             return result;
         }
 
+        using fixed_reduction = detail::is_fixed_reduction<std::decay_t<E>, std::decay_t<X>>;
+        if (fixed_reduction::value)
+        {
+            detail::check_reduce_axes(e, axes);
+            detail::reduce_fixed(f, e, axes, options, result, fixed_reduction());
+            return result;
+        }
+
         shape_type result_shape{};
         dynamic_shape<std::size_t> iter_shape = xtl::forward_sequence<dynamic_shape<std::size_t>, decltype(e.shape())>(e.shape());
         dynamic_shape<std::size_t> iter_strides(e.dimension());
 
-        // std::less is used, because as the standard says (24.4.5):
-        // A sequence is sorted with respect to a comparator comp if for any iterator i pointing to the sequence and any non-negative integer n
-        // such that i + n is a valid iterator pointing to an element of the sequence, comp(*(i + n), *i) == false.
-        // Therefore less is required to detect duplicates.
-        if (!std::is_sorted(axes.cbegin(), axes.cend(), std::less<>()))
-        {
-            XTENSOR_THROW(std::runtime_error, "Reducing axes should be sorted.");
-        }
-        if (std::adjacent_find(axes.cbegin(), axes.cend()) != axes.cend())
-        {
-            XTENSOR_THROW(std::runtime_error, "Reducing axes should not contain duplicates.");
-        }
-        if (axes.size() != 0 && axes[axes.size() - 1] > e.dimension() - 1)
-        {
-            XTENSOR_THROW(std::runtime_error,
-                          "Axis " + std::to_string(axes[axes.size() - 1]) +
-                          " out of bounds for reduction.");
-        }
+        detail::check_reduce_axes(e, axes);
 
         detail::shape_computation<options_t>(result_shape, result, e, axes);
 
+        bool parallel = detail::use_parallel_reduce(static_cast<std::size_t>(e.size()));
+
         // Fast track for complete reduction
         if (e.dimension() == axes.size())
         {
-            result_type tmp = options_t::has_initial_value ? options.initial_value : init_fct();
-            result.data()[0] = std::accumulate(e.storage().begin(), e.storage().end(), tmp, reduce_fct);
+            if (parallel)
+            {
+                result_type tmp = detail::reduce_contiguous<result_type>(e.data(), static_cast<std::size_t>(e.size()),
+                                                                         reduce_fct, init_fct, merge_fct, true);
+                result.data()[0] = options_t::has_initial_value ? merge_fct(tmp, options.initial_value) : tmp;
+            }
+            else
+            {
+                result_type tmp = options_t::has_initial_value ? options.initial_value : init_fct();
+                result.data()[0] = detail::accumulate_contiguous(e.data(), e.data() + static_cast<std::ptrdiff_t>(e.size()),
+                                                                 tmp, reduce_fct);
+            }
             return result;
         }
 
@@ -419,6 +1246,63 @@ namespace xt
         auto out = result.data();
         auto out_begin = result.data();
 
+        // Each step of the loops below reduces a block of consecutive elements
+        // of e. When no two blocks share their outputs, the blocks are split
+        // across the threads; otherwise the blocks are visited in order and
+        // each of them may be reduced in parallel.
+        std::size_t block_size = outer_loop_size * inner_loop_size;
+        std::size_t n_blocks = static_cast<std::size_t>(e.size()) / block_size;
+        bool disjoint_blocks = true;
+        for (std::size_t i = 0; i < iter_shape.size(); ++i)
+        {
+            disjoint_blocks = disjoint_blocks && (iter_shape[i] == 1 || iter_strides[i] != 0);
+        }
+        if (parallel && disjoint_blocks && n_blocks >= 2 * xthread_pool::default_concurrency())
+        {
+            exec::default_policy().for_range(std::size_t(0), n_blocks, std::size_t(1),
+                                             [&](std::size_t block_begin, std::size_t block_end)
+            {
+                xindex block_idx(iter_shape.size());
+                std::size_t rem = block_begin;
+                for (std::size_t i = iter_shape.size(); i > 0; --i)
+                {
+                    block_idx[i - 1] = rem % iter_shape[i - 1];
+                    rem /= iter_shape[i - 1];
+                }
+                for (std::size_t b = block_begin; b < block_end; ++b)
+                {
+                    auto block_in = begin + static_cast<std::ptrdiff_t>(b * block_size);
+                    auto block_out = out_begin + std::inner_product(block_idx.begin(), block_idx.end(),
+                                                                    iter_strides.begin(), std::ptrdiff_t(0));
+                    if (inner_stride == 1)
+                    {
+                        result_type tmp = init_fct();
+                        *block_out = detail::accumulate_contiguous(block_in, block_in + static_cast<std::ptrdiff_t>(outer_loop_size),
+                                                                   tmp, reduce_fct);
+                    }
+                    else
+                    {
+                        detail::reduce_strided_serial<result_type>(block_out, block_in, inner_loop_size, outer_loop_size,
+                                                                   false, reduce_fct, init_fct);
+                    }
+                    for (std::size_t i = iter_shape.size(); i > 0; --i)
+                    {
+                        if (++block_idx[i - 1] < iter_shape[i - 1])
+                        {
+                            break;
+                        }
+                        block_idx[i - 1] = 0;
+                    }
+                }
+            });
+            if (options_t::has_initial_value)
+            {
+                std::transform(result.data(), result.data() + result.size(), result.data(),
+                               [&merge_fct, &options](auto&& v) { return merge_fct(v, options.initial_value); });
+            }
+            return result;
+        }
+
         std::ptrdiff_t next_stride = 0;
 
         std::pair<bool, std::ptrdiff_t> idx_res(false, 0);
@@ -439,8 +1323,8 @@ namespace xt
             {
                 // for unknown reasons it's much faster to use a temporary variable and
                 // std::accumulate here -- probably some cache behavior
-                result_type tmp = init_fct();
-                tmp = std::accumulate(begin , begin + outer_loop_size, tmp, reduce_fct);
+                result_type tmp = detail::reduce_contiguous<result_type>(begin, outer_loop_size, reduce_fct,
+                                                                         init_fct, merge_fct, parallel);
 
                 // use merge function if necessary
                 *out = merge ? merge_fct(*out, tmp) : tmp;
@@ -467,20 +1351,9 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                std::transform(out, out + inner_loop_size, begin, out,
-                               [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
-                                    return merge ?
-                                        reduce_fct(v1, v2) :
-                                        // cast because return type of identity function is not upcasted
-                                        reduce_fct(static_cast<result_type>(init_fct()), v2);
-                               });
-
-                begin += inner_stride;
-                for (std::size_t i = 1; i < outer_loop_size; ++i)
-                {
-                    std::transform(out, out + inner_loop_size, begin, out, reduce_fct);
-                    begin += inner_stride;
-                }
+                detail::reduce_strided<result_type>(out, begin, inner_loop_size, outer_loop_size, merge,
+                                                    reduce_fct, init_fct, merge_fct, parallel);
+                begin += static_cast<std::ptrdiff_t>(block_size);
 
                 idx_res = next_idx();
                 next_stride = idx_res.second;
@@ -506,6 +1379,103 @@ namespace xt
         return result;
     }
 
+    /**
+     * Sums \c e over \c axes with the pairwise or Kahan summation selected
+     * in \c raw_options, and returns the evaluated result. Elements that are
+     * not contiguous along the reduced axes are gathered into a buffer for
+     * each output.
+     */
+    template <class F, class E, class X, class O>
+    inline auto reduce_summation(F&& f, E&& e, X&& axes, O&& raw_options)
+    {
+        using reduce_functor_type = typename std::decay_t<F>::reduce_functor_type;
+        using init_functor_type = typename std::decay_t<F>::init_functor_type;
+        using expr_value_type = typename std::decay_t<E>::value_type;
+        using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(std::declval<init_functor_type>()(), std::declval<expr_value_type>()))>;
+
+        static_assert(std::is_same<std::decay_t<reduce_functor_type>, detail::plus>::value,
+                      "Summation options only apply to sum reductions");
+
+        using options_t = reducer_options<result_type, std::decay_t<O>>;
+        using summation_type = typename options_t::summation;
+        options_t options(raw_options);
+
+        using shape_type = typename xreducer_shape_type<typename std::decay_t<E>::shape_type, std::decay_t<X>, typename options_t::keep_dims>::type;
+        using result_container_type = typename detail::xtype_for_shape<shape_type>::template type<result_type, std::decay_t<E>::static_layout>;
+        result_container_type result;
+
+        auto init_fct = xt::get<1>(f);
+        auto merge_fct = xt::get<2>(f);
+
+        detail::check_reduce_axes(e, axes);
+        shape_type result_shape{};
+        detail::shape_computation<options_t>(result_shape, result, e, axes);
+
+        // Splits the dimensions into kept and reduced ones, each iterated
+        // in row-major order.
+        std::size_t dim = e.dimension();
+        dynamic_shape<std::size_t> kept_shape, reduced_shape;
+        dynamic_shape<std::ptrdiff_t> kept_strides, reduced_strides;
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            bool reduced = std::find(axes.cbegin(), axes.cend(), i) != axes.cend();
+            (reduced ? reduced_shape : kept_shape).push_back(static_cast<std::size_t>(e.shape()[i]));
+            (reduced ? reduced_strides : kept_strides).push_back(static_cast<std::ptrdiff_t>(e.strides()[i]));
+        }
+        std::size_t reduced_size = std::accumulate(reduced_shape.cbegin(), reduced_shape.cend(),
+                                                   std::size_t(1), std::multiplies<std::size_t>());
+
+        // Trailing reduced axes of a row-major container are summed in place;
+        // axes are sorted, so they are trailing when the first one is.
+        bool contiguous = e.layout() == layout_type::row_major &&
+                          (axes.size() == 0 || static_cast<std::size_t>(axes[0]) == dim - axes.size());
+
+        auto advance = [](dynamic_shape<std::size_t>& index, const dynamic_shape<std::size_t>& shape,
+                          const dynamic_shape<std::ptrdiff_t>& strides, std::ptrdiff_t& offset)
+        {
+            for (std::size_t i = index.size(); i > 0; --i)
+            {
+                if (++index[i - 1] < shape[i - 1])
+                {
+                    offset += strides[i - 1];
+                    return;
+                }
+                offset -= static_cast<std::ptrdiff_t>(shape[i - 1] - 1) * strides[i - 1];
+                index[i - 1] = 0;
+            }
+        };
+
+        arena_uvector<result_type> buffer(contiguous ? std::size_t(0) : reduced_size);
+        dynamic_shape<std::size_t> kept_index(kept_shape.size(), std::size_t(0));
+        dynamic_shape<std::size_t> reduced_index(reduced_shape.size(), std::size_t(0));
+        std::ptrdiff_t kept_offset = 0;
+        auto data = e.data();
+        auto out = result.template begin<layout_type::row_major>();
+        for (std::size_t j = 0; j < result.size(); ++j, ++out)
+        {
+            result_type tmp;
+            if (contiguous)
+            {
+                tmp = detail::sum_range<result_type>(data + static_cast<std::ptrdiff_t>(j * reduced_size),
+                                                     reduced_size, summation_type());
+            }
+            else
+            {
+                std::ptrdiff_t offset = kept_offset;
+                for (std::size_t r = 0; r < reduced_size; ++r)
+                {
+                    buffer[r] = static_cast<result_type>(data[offset]);
+                    advance(reduced_index, reduced_shape, reduced_strides, offset);
+                }
+                tmp = detail::sum_range<result_type>(buffer.cbegin(), reduced_size, summation_type());
+            }
+            result_type init = options_t::has_initial_value ? options.initial_value : static_cast<result_type>(init_fct());
+            *out = merge_fct(init, tmp);
+            advance(kept_index, kept_shape, kept_strides, kept_offset);
+        }
+        return result;
+    }
+
 
     /*********************
      * xreducer functors *
@@ -571,7 +1541,8 @@ namespace xt
         {
         }
 
-        template <class RF>
+        // Excludes self_type so that non-const lvalues are copied
+        template <class RF, XTL_REQUIRES(xtl::negation<std::is_same<std::decay_t<RF>, self_type>>)>
         xreducer_functors(RF&& reduce_func)
             : base_type(std::forward<RF>(reduce_func), INIT_FUNC(), reduce_func)
         {
@@ -708,6 +1679,53 @@ namespace xt
         using size_type = typename xexpression_type::size_type;
     };
 
+    // Each element of a reducer reduces a part of its expression, whose
+    // size is not known at compile time.
+    template <class F, class CT, class X, class O>
+    struct expression_cost<xreducer<F, CT, X, O>>
+        : std::integral_constant<std::size_t, XTENSOR_EVAL_COST_THRESHOLD + expression_cost<std::decay_t<CT>>::value>
+    {
+    };
+
+    namespace detail
+    {
+        // Lazy reductions of row-major or column-major containers of
+        // arithmetic values are assigned with the row-streaming strategy
+        // of reduce_immediate when the innermost axis is not reduced.
+        template <class E>
+        struct is_streamable_reduction
+            : xtl::conjunction<std::is_base_of<xcontainer<E>, E>,
+                               std::is_arithmetic<typename E::value_type>,
+                               xtl::disjunction<std::integral_constant<bool, E::static_layout == layout_type::row_major>,
+                                                std::integral_constant<bool, E::static_layout == layout_type::column_major>>>
+        {
+        };
+    }
+
+    template <class CS>
+    class xchunked_array;
+
+    namespace detail
+    {
+        // Lazy reductions of chunked arrays of arithmetic values, without
+        // initial value, are evaluated chunk by chunk by reduce_chunked,
+        // defined with xchunked_array.
+        template <class E, class O>
+        struct is_chunked_reduction : std::false_type
+        {
+        };
+
+        template <class CS, class O>
+        struct is_chunked_reduction<xchunked_array<CS>, O>
+            : xtl::conjunction<std::is_arithmetic<typename xchunked_array<CS>::value_type>,
+                               xtl::negation<std::integral_constant<bool, O::has_initial_value>>>
+        {
+        };
+
+        template <class F, class CS, class X, class O, class R>
+        void reduce_chunked(const F& f, const xchunked_array<CS>& e, const X& axes, const O& options, R& result);
+    }
+
     template <class T>
     struct select_dim_mapping_type
     {
@@ -810,6 +1828,11 @@ namespace xt
         template <class S>
         const_stepper stepper_end(const S& shape, layout_type) const noexcept;
 
+        template <class E, class XE = xexpression_type,
+                  class = std::enable_if_t<detail::is_streamable_reduction<XE>::value ||
+                                           detail::is_chunked_reduction<XE, O>::value>>
+        void assign_to(xexpression<E>& e) const;
+
         template <class E, class Func = F, class Opts = O>
         using rebind_t = xreducer<Func, E, X, Opts>;
 
@@ -830,6 +1853,19 @@ namespace xt
         }
     private:
 
+        using chunked_reduction = detail::is_chunked_reduction<xexpression_type, O>;
+        using chunked_temporary_type = typename detail::xtype_for_shape<inner_shape_type>::template type<value_type, layout_type::row_major>;
+
+        template <class E>
+        void assign_to_impl(xexpression<E>& e, std::true_type) const;
+        template <class E>
+        void assign_to_impl(xexpression<E>& e, std::false_type) const;
+
+        template <class It>
+        const_reference element_impl(It first, It last, std::true_type) const;
+        template <class It>
+        const_reference element_impl(It first, It last, std::false_type) const;
+
         CT m_e;
         reduce_functor_type m_reduce;
         init_functor_type m_init;
@@ -865,16 +1901,94 @@ namespace xt
         }
 
 
+        template <class F, class E, class X, class O>
+        inline auto reduce_immediate_expression(F&& f, E&& e, X&& axes, O&& options, std::true_type /*has_data_interface*/)
+        {
+            return reduce_immediate(std::forward<F>(f), eval(std::forward<E>(e)), std::forward<X>(axes), std::forward<O>(options));
+        }
+
+        // A complete reduction of an expression that can be traversed
+        // linearly does not need its evaluation; the result has the type
+        // returned by the reduction of the evaluated expression.
+        template <class F, class E, class X, class O>
+        inline auto reduce_immediate_expression(F&& f, E&& e, X&& axes, O&& raw_options, std::false_type /*has_data_interface*/)
+        {
+            using types = reduce_immediate_types<F, decltype(eval(std::declval<E>())), X, O>;
+            using result_type = typename types::result_type;
+            using options_t = typename types::options_t;
+            using shape_type = typename types::shape_type;
+            using result_container_type = typename types::result_container_type;
+
+            if (e.dimension() == 0 || axes.size() != e.dimension() ||
+                e.layout() == layout_type::dynamic || !is_linear_reducible(e))
+            {
+                return reduce_immediate(std::forward<F>(f), eval(std::forward<E>(e)), std::forward<X>(axes), std::forward<O>(raw_options));
+            }
+
+            XTENSOR_PROFILE_CALL(reduce_call, typename std::decay_t<F>::reduce_functor_type);
+            check_reduce_axes(e, axes);
+            options_t options(raw_options);
+            result_container_type result;
+            shape_type result_shape{};
+            shape_computation<options_t>(result_shape, result, e, axes);
+
+            auto reduce_fct = xt::get<0>(f);
+            auto init_fct = xt::get<1>(f);
+            auto merge_fct = xt::get<2>(f);
+            std::size_t size = static_cast<std::size_t>(e.size());
+            if (use_parallel_reduce(size))
+            {
+                result_type tmp = reduce_linear<result_type>(e, size, reduce_fct, init_fct, merge_fct, true);
+                result.data()[0] = options_t::has_initial_value ? merge_fct(tmp, options.initial_value) : tmp;
+            }
+            else
+            {
+                result_type tmp = options_t::has_initial_value ? options.initial_value : init_fct();
+                result.data()[0] = accumulate_linear(e, std::size_t(0), size, tmp, reduce_fct);
+            }
+            return result;
+        }
+
         template <class F, class E, class X, class O>
         inline auto reduce_impl(F&& f, E&& e, X&& axes, evaluation_strategy::immediate_type, O&& options)
         {
             decltype(auto) normalized_axes = normalize_axis(e, std::forward<X>(axes));
-            return reduce_immediate(std::forward<F>(f),
+            return reduce_immediate_expression(std::forward<F>(f),
+                                               std::forward<E>(e),
+                                               std::forward<decltype(normalized_axes)>(normalized_axes),
+                                               std::forward<O>(options),
+                                               has_data_interface<std::decay_t<E>>()
+            );
+        }
+
+        template <class F, class E, class X, class O>
+        inline auto reduce_summation_impl(F&& f, E&& e, X&& axes, O&& options)
+        {
+            decltype(auto) normalized_axes = normalize_axis(e, std::forward<X>(axes));
+            return reduce_summation(std::forward<F>(f),
                                     eval(std::forward<E>(e)),
                                     std::forward<decltype(normalized_axes)>(normalized_axes),
                                     std::forward<O>(options)
             );
         }
+
+        template <class F, class E, class X, class O>
+        inline auto reduce_impl(F&& f, E&& e, X&& axes, summation::pairwise_type, O&& options)
+        {
+            return reduce_summation_impl(std::forward<F>(f), std::forward<E>(e), std::forward<X>(axes), std::forward<O>(options));
+        }
+
+        template <class F, class E, class X, class O>
+        inline auto reduce_impl(F&& f, E&& e, X&& axes, summation::kahan_type, O&& options)
+        {
+            return reduce_summation_impl(std::forward<F>(f), std::forward<E>(e), std::forward<X>(axes), std::forward<O>(options));
+        }
+
+        // Compensated summations are always evaluated immediately.
+        template <class O>
+        using reduce_strategy_t = std::conditional_t<std::is_same<typename O::summation, summation::naive_type>::value,
+                                                     typename O::evaluation_strategy,
+                                                     typename O::summation>;
     }
 
 #define DEFAULT_STRATEGY_REDUCERS std::tuple<evaluation_strategy::lazy_type>
@@ -918,7 +2032,7 @@ namespace xt
         return detail::reduce_impl(std::forward<F>(f),
                                    std::forward<E>(e),
                                    std::forward<X>(axes),
-                                   typename reducer_options<int, EVS>::evaluation_strategy{},
+                                   detail::reduce_strategy_t<reducer_options<int, std::decay_t<EVS>>>{},
                                    std::forward<EVS>(options)
         );
     }
@@ -943,7 +2057,7 @@ namespace xt
         return detail::reduce_impl(std::forward<F>(f),
                                    std::forward<E>(e),
                                    std::move(ar),
-                                   typename reducer_options<int, std::decay_t<EVS>>::evaluation_strategy{},
+                                   detail::reduce_strategy_t<reducer_options<int, std::decay_t<EVS>>>{},
                                    std::forward<EVS>(options)
         );
     }
@@ -963,7 +2077,7 @@ namespace xt
         using axes_type = std::array<std::size_t, N>;
         auto ax = xt::forward_normalize<axes_type>(e, axes);
         return detail::reduce_impl(std::forward<F>(f), std::forward<E>(e), std::move(ax),
-                                   typename reducer_options<int, EVS>::evaluation_strategy{},
+                                   detail::reduce_strategy_t<reducer_options<int, std::decay_t<EVS>>>{},
                                    options);
     }
     template <class F, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -973,6 +2087,185 @@ namespace xt
         return reduce(make_xreducer_functor(std::forward<F>(f)), std::forward<E>(e), axes, options);
     }
 
+    /***************
+     * reduce_many *
+     ***************/
+
+    namespace detail
+    {
+        template <class F>
+        inline auto as_xreducer_functors(F f, std::true_type)
+        {
+            return f;
+        }
+
+        template <class F>
+        inline auto as_xreducer_functors(F f, std::false_type)
+        {
+            return make_xreducer_functor(std::move(f));
+        }
+
+        template <class F>
+        inline auto as_xreducer_functors(const F& f)
+        {
+            return as_xreducer_functors(f, is_xreducer_functors<F>());
+        }
+
+        template <class V, class F>
+        using reduce_many_result_t = std::decay_t<decltype(std::declval<typename F::reduce_functor_type>()(
+            std::declval<typename F::init_functor_type>()(), std::declval<V>()))>;
+
+        // Reduction functors combining those of several xreducer_functors,
+        // whose results are accumulated in a tuple.
+        template <class V, class... F>
+        struct reduce_many_functors
+        {
+            using value_type = std::tuple<reduce_many_result_t<V, F>...>;
+            using index_type = std::index_sequence_for<F...>;
+
+            struct reduce_type
+            {
+                template <class T>
+                value_type operator()(const value_type& r, const T& v) const
+                {
+                    return apply(r, v, index_type());
+                }
+
+                template <class T, std::size_t... I>
+                value_type apply(const value_type& r, const T& v, std::index_sequence<I...>) const
+                {
+                    return value_type(std::get<I>(m_functors).get_reduce()(std::get<I>(r), v)...);
+                }
+
+                std::tuple<F...> m_functors;
+            };
+
+            struct init_type
+            {
+                using value_type = typename reduce_many_functors::value_type;
+
+                value_type operator()() const
+                {
+                    return apply(index_type());
+                }
+
+                template <std::size_t... I>
+                value_type apply(std::index_sequence<I...>) const
+                {
+                    return value_type(static_cast<std::tuple_element_t<I, value_type>>(std::get<I>(m_functors).get_init()())...);
+                }
+
+                std::tuple<F...> m_functors;
+            };
+
+            struct merge_type
+            {
+                value_type operator()(const value_type& r, const value_type& s) const
+                {
+                    return apply(r, s, index_type());
+                }
+
+                template <std::size_t... I>
+                value_type apply(const value_type& r, const value_type& s, std::index_sequence<I...>) const
+                {
+                    return value_type(std::get<I>(m_functors).get_merge()(std::get<I>(r), std::get<I>(s))...);
+                }
+
+                std::tuple<F...> m_functors;
+            };
+
+            static auto make(const std::tuple<F...>& functors)
+            {
+                return make_xreducer_functor(reduce_type{functors}, init_type{functors}, merge_type{functors});
+            }
+        };
+
+        template <class R, std::size_t I>
+        inline auto split_reduce_many_result(const R& combined)
+        {
+            using value_type = std::tuple_element_t<I, typename R::value_type>;
+            using shape_type = std::decay_t<decltype(combined.shape())>;
+            using result_type = typename xtype_for_shape<shape_type>::template type<value_type, R::static_layout>;
+            result_type res;
+            res.resize(combined.shape());
+            std::transform(combined.storage().cbegin(), combined.storage().cend(), res.storage().begin(),
+                           [](const auto& v) { return std::get<I>(v); });
+            return res;
+        }
+
+        template <class R, std::size_t... I>
+        inline auto split_reduce_many_result(const R& combined, std::index_sequence<I...>)
+        {
+            return std::make_tuple(split_reduce_many_result<R, I>(combined)...);
+        }
+
+        template <class... F, std::size_t... I>
+        inline auto wrap_reduce_many_functors(const std::tuple<F...>& functors, std::index_sequence<I...>)
+        {
+            return std::make_tuple(as_xreducer_functors(std::get<I>(functors))...);
+        }
+
+        template <class V, class... F>
+        inline auto make_reduce_many_functors_impl(const std::tuple<F...>& functors)
+        {
+            return reduce_many_functors<V, F...>::make(functors);
+        }
+
+        template <class E, class... F>
+        inline auto make_reduce_many_functors(const std::tuple<F...>& functors)
+        {
+            using value_type = typename std::decay_t<E>::value_type;
+            return make_reduce_many_functors_impl<value_type>(wrap_reduce_many_functors(functors, std::index_sequence_for<F...>()));
+        }
+
+        template <class EVS>
+        inline auto reduce_many_options(const EVS& options)
+        {
+            return std::tuple_cat(options, evaluation_strategy::immediate);
+        }
+    }
+
+    /**
+     * @brief Applies several reductions in a single traversal of \c e.
+     *
+     * Each element of \c functors is an \ref xreducer_functors object, or a
+     * reducing function as accepted by \ref reduce. The results of all the
+     * reductions are accumulated together, so the expression is evaluated and
+     * read once, and the function returns a tuple of containers, one per
+     * reduction. The evaluation is always immediate; keep_dims is supported,
+     * initial values are not.
+     * @param functors a tuple of reducers
+     * @param e an \ref xexpression
+     * @param axes the axes along which the reductions are performed (optional)
+     * @param options reducer options
+     * @return a tuple of containers
+     */
+    template <class... F, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
+    inline auto reduce_many(const std::tuple<F...>& functors, E&& e, X&& axes, EVS options = EVS())
+    {
+        auto combined = reduce(detail::make_reduce_many_functors<E>(functors), std::forward<E>(e),
+                               std::forward<X>(axes), detail::reduce_many_options(options));
+        return detail::split_reduce_many_result(combined, std::index_sequence_for<F...>());
+    }
+
+    template <class... F, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(is_reducer_options<EVS>)>
+    inline auto reduce_many(const std::tuple<F...>& functors, E&& e, EVS options = EVS())
+    {
+        auto combined = reduce(detail::make_reduce_many_functors<E>(functors), std::forward<E>(e),
+                               detail::reduce_many_options(options));
+        return detail::split_reduce_many_result(combined, std::index_sequence_for<F...>());
+    }
+
+    template <class... F, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto reduce_many(const std::tuple<F...>& functors, E&& e, const I (&axes)[N], EVS options = EVS())
+    {
+        auto combined = reduce(detail::make_reduce_many_functors<E>(functors), std::forward<E>(e),
+                               axes, detail::reduce_many_options(options));
+        return detail::split_reduce_many_result(combined, std::index_sequence_for<F...>());
+    }
+
     /********************
      * xreducer_stepper *
      ********************/
@@ -1016,6 +2309,8 @@ namespace xt
         reference aggregate(size_type dim) const;
         reference aggregate_impl(size_type dim, /*keep_dims=*/ std::false_type) const;
         reference aggregate_impl(size_type dim, /*keep_dims=*/ std::true_type) const;
+        reference aggregate_linear(std::true_type) const;
+        reference aggregate_linear(std::false_type) const;
 
         substepper_type get_substepper_begin() const;
         size_type get_dim(size_type dim) const noexcept;
@@ -1422,7 +2717,29 @@ namespace xt
     template <class It>
     inline auto xreducer<F, CT, X, O>::element(It first, It last) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(reducer_node, reduce_functor_type);
         XTENSOR_TRY(check_element_index(shape(), first, last));
+        return element_impl(first, last, chunked_reduction());
+    }
+
+    // The complete reductions of chunked arrays reduce each chunk contiguously
+    template <class F, class CT, class X, class O>
+    template <class It>
+    inline auto xreducer<F, CT, X, O>::element_impl(It first, It last, std::true_type) const -> const_reference
+    {
+        if (this->dimension() != 0)
+        {
+            return element_impl(first, last, std::false_type());
+        }
+        chunked_temporary_type tmp = chunked_temporary_type::from_shape(shape());
+        detail::reduce_chunked(functors(), m_e, m_axes, m_options, tmp);
+        return tmp();
+    }
+
+    template <class F, class CT, class X, class O>
+    template <class It>
+    inline auto xreducer<F, CT, X, O>::element_impl(It first, It last, std::false_type) const -> const_reference
+    {
         auto stepper = const_stepper(*this, 0);
         if (first != last)
         {
@@ -1502,6 +2819,54 @@ namespace xt
         return const_stepper(*this, offset, true, l);
     }
 
+    /**
+     * Assigns the reduction to \c e. When the innermost axis of the reduced
+     * container is kept, the reduced rows are accumulated as whole rows into
+     * the result, as done by reduce_immediate, instead of walking the reduced
+     * axes with large strides for each output element. The reductions of
+     * chunked arrays reduce each chunk contiguously and merge the results of
+     * the chunks, instead of computing the chunk of each element.
+     * @param e the expression to assign to.
+     */
+    template <class F, class CT, class X, class O>
+    template <class E, class, class>
+    inline void xreducer<F, CT, X, O>::assign_to(xexpression<E>& e) const
+    {
+        assign_to_impl(e, chunked_reduction());
+    }
+
+    template <class F, class CT, class X, class O>
+    template <class E>
+    inline void xreducer<F, CT, X, O>::assign_to_impl(xexpression<E>& e, std::true_type) const
+    {
+        chunked_temporary_type tmp = chunked_temporary_type::from_shape(shape());
+        detail::reduce_chunked(functors(), m_e, m_axes, m_options, tmp);
+        xt::assign_xexpression(e, tmp);
+    }
+
+    template <class F, class CT, class X, class O>
+    template <class E>
+    inline void xreducer<F, CT, X, O>::assign_to_impl(xexpression<E>& e, std::false_type) const
+    {
+        using tag = xexpression_tag_t<E, self_type>;
+        std::size_t inner_axis = m_e.layout() == layout_type::row_major ? m_e.dimension() - 1 : 0;
+        bool streamable = m_axes.size() != 0 && m_axes.size() != m_e.dimension() &&
+                          std::find(m_axes.cbegin(), m_axes.cend(), inner_axis) == m_axes.cend();
+        // Small fixed containers reduced along compile-time axes are reduced
+        // with unrolled loops into a fixed temporary.
+        bool fixed = detail::is_fixed_reduction<xexpression_type, std::decay_t<X>>::value;
+        if (streamable || fixed)
+        {
+            auto tmp = reduce_immediate(functors(), m_e, m_axes, m_options);
+            xt::assign_xexpression(e, tmp);
+        }
+        else
+        {
+            const xexpression<self_type>& self = *this;
+            xexpression_assigner<tag>::assign_xexpression(e, self);
+        }
+    }
+
     template <class F, class CT, class X, class O>
     template <class E>
     inline auto xreducer<F, CT, X, O>::build_reducer(E&& e) const -> rebind_t<E>
@@ -1534,6 +2899,7 @@ namespace xt
     template <class F, class CT, class X, class O>
     inline auto xreducer_stepper<F, CT, X, O>::operator*() const -> reference
     {
+        XTENSOR_PROFILE_NODE(reducer_node, typename xreducer_type::reduce_functor_type);
         reference r = aggregate(0);
         return r;
     }
@@ -1637,7 +3003,11 @@ namespace xt
         }
         else
         {
-            res = aggregate_impl(dim, typename O::keep_dims());
+            using linear_reduce = std::integral_constant<bool, detail::has_linear_reduce<xexpression_type>::value &&
+                                                               std::is_arithmetic<reference>::value>;
+            bool linear = dim == 0 && m_reducer->m_axes.size() == m_reducer->m_e.dimension() &&
+                          detail::is_linear_reducible(m_reducer->m_e);
+            res = linear ? aggregate_linear(linear_reduce()) : aggregate_impl(dim, typename O::keep_dims());
             if (O::has_initial_value && dim == 0)
             {
                 res = m_reducer->m_merge(m_reducer->m_options.initial_value, res);
@@ -1646,6 +3016,24 @@ namespace xt
         return res;
     }
 
+    // Complete reduction of an expression that can be traversed linearly,
+    // computed by blocks with the contiguous kernels of the immediate
+    // reductions.
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::aggregate_linear(std::true_type) const -> reference
+    {
+        const auto& e = m_reducer->m_e;
+        std::size_t size = static_cast<std::size_t>(e.size());
+        return detail::reduce_linear<reference>(e, size, m_reducer->m_reduce, m_reducer->m_init,
+                                                m_reducer->m_merge, detail::use_parallel_reduce(size));
+    }
+
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::aggregate_linear(std::false_type) const -> reference
+    {
+        return aggregate_impl(0, typename O::keep_dims());
+    }
+
     template <class F, class CT, class X, class O>
     inline auto xreducer_stepper<F, CT, X, O>::aggregate_impl(size_type dim, std::false_type) const -> reference
     {
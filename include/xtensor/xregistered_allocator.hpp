@@ -0,0 +1,381 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_REGISTERED_ALLOCATOR_HPP
+#define XTENSOR_REGISTERED_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "xarray.hpp"
+#include "xstorage.hpp"
+#include "xtensor.hpp"
+#include "xtensor_config.hpp"
+
+#ifndef XTENSOR_REGISTERED_ALIGNMENT
+#define XTENSOR_REGISTERED_ALIGNMENT 4096
+#endif
+
+namespace xt
+{
+
+    /*******************
+     * memory_registry *
+     *******************/
+
+    /**
+     * @class memory_registry
+     * @brief Source of the host buffers shared with a device or a network
+     * transport.
+     *
+     * A registry allocates page-aligned buffers and passes each of them to
+     * a registration callback before handing it out, and to an
+     * unregistration callback before freeing it, so that the buffers can
+     * be pinned or registered with a driver (e.g. \c ibv_reg_mr or
+     * \c cudaHostRegister) for their whole lifetime. The allocation itself
+     * can be replaced too, for drivers allocating the page-locked memory
+     * (e.g. \c cudaHostAlloc). The unregistration and deallocation
+     * callbacks must not throw. The callbacks are called from the threads
+     * allocating and freeing the buffers.
+     */
+    class memory_registry
+    {
+    public:
+
+        using allocate_function = std::function<void*(std::size_t)>;
+        using deallocate_function = std::function<void(void*, std::size_t)>;
+        using register_function = std::function<void(void*, std::size_t)>;
+        using unregister_function = std::function<void(void*, std::size_t)>;
+
+        memory_registry() = default;
+        memory_registry(register_function reg, unregister_function unreg);
+        memory_registry(allocate_function alloc,
+                        deallocate_function dealloc,
+                        register_function reg = register_function(),
+                        unregister_function unreg = unregister_function());
+
+        memory_registry(const memory_registry&) = delete;
+        memory_registry& operator=(const memory_registry&) = delete;
+
+        void* allocate(std::size_t bytes);
+        void deallocate(void* p, std::size_t bytes) noexcept;
+
+        std::size_t registered() const noexcept;
+
+        static std::shared_ptr<memory_registry> get_default();
+        static std::shared_ptr<memory_registry> set_default(std::shared_ptr<memory_registry> registry);
+
+    private:
+
+        static std::size_t allocation_size(std::size_t bytes) noexcept;
+        static void* aligned_allocate(std::size_t bytes);
+        static void aligned_deallocate(void* p) noexcept;
+
+        static std::mutex& default_mutex() noexcept;
+        static std::shared_ptr<memory_registry>& default_registry();
+
+        allocate_function m_allocate;
+        deallocate_function m_deallocate;
+        register_function m_register;
+        unregister_function m_unregister;
+        std::atomic<std::size_t> m_registered{0};
+    };
+
+    /************************
+     * registered_allocator *
+     ************************/
+
+    /**
+     * @class registered_allocator
+     * @brief Allocator taking its buffers from a memory_registry.
+     *
+     * A default constructed allocator uses the default registry at the
+     * time of its construction, so that the containers created by xtensor
+     * itself, such as the result of an assignment, are registered too.
+     * The allocator is propagated on copy, move and swap, and its buffers
+     * are given back to the registry they come from even when the default
+     * registry has changed in the meantime.
+     */
+    template <class T>
+    class registered_allocator
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        using registry_type = std::shared_ptr<memory_registry>;
+
+        registered_allocator();
+        explicit registered_allocator(registry_type registry) noexcept;
+
+        template <class U>
+        registered_allocator(const registered_allocator<U>& rhs) noexcept;
+
+        T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n) noexcept;
+
+        const registry_type& registry() const noexcept;
+
+    private:
+
+        registry_type m_registry;
+    };
+
+    template <class T, class U>
+    bool operator==(const registered_allocator<T>& lhs, const registered_allocator<U>& rhs) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const registered_allocator<T>& lhs, const registered_allocator<U>& rhs) noexcept;
+
+    /**
+     * @typedef xregistered_array
+     * Alias template on xarray_container whose elements are held in
+     * memory from a memory_registry; its data() can be handed to the
+     * transport the registry registers the buffers with.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam L The layout_type of the xarray_container (default: XTENSOR_DEFAULT_LAYOUT).
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class SA = std::allocator<typename std::vector<T>::size_type>>
+    using xregistered_array = xarray_container<uvector<T, registered_allocator<T>>, L,
+                                               XTENSOR_DEFAULT_SHAPE_CONTAINER(T, registered_allocator<T>, SA)>;
+
+    /**
+     * @typedef xregistered_tensor
+     * Alias template on xtensor_container whose elements are held in
+     * memory from a memory_registry.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam N The dimension of the tensor.
+     * @tparam L The layout_type of the tensor (default: XTENSOR_DEFAULT_LAYOUT).
+     */
+    template <class T, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    using xregistered_tensor = xtensor_container<uvector<T, registered_allocator<T>>, N, L>;
+
+    /**********************************
+     * memory_registry implementation *
+     **********************************/
+
+    /**
+     * Builds a registry allocating from the heap and registering the
+     * buffers with the given callbacks.
+     */
+    inline memory_registry::memory_registry(register_function reg, unregister_function unreg)
+        : m_register(std::move(reg)), m_unregister(std::move(unreg))
+    {
+    }
+
+    /**
+     * Builds a registry allocating with \c alloc and freeing with
+     * \c dealloc, and registering the buffers with the given callbacks.
+     * The sizes passed to the callbacks are rounded up to a multiple of
+     * XTENSOR_REGISTERED_ALIGNMENT; \c alloc must return memory aligned
+     * on it.
+     */
+    inline memory_registry::memory_registry(allocate_function alloc,
+                                            deallocate_function dealloc,
+                                            register_function reg,
+                                            unregister_function unreg)
+        : m_allocate(std::move(alloc)), m_deallocate(std::move(dealloc)),
+          m_register(std::move(reg)), m_unregister(std::move(unreg))
+    {
+    }
+
+    /**
+     * Returns a buffer of at least \c bytes bytes aligned on
+     * XTENSOR_REGISTERED_ALIGNMENT, registered with the registration
+     * callback. When the registration throws, the buffer is freed and
+     * the exception is propagated.
+     */
+    inline void* memory_registry::allocate(std::size_t bytes)
+    {
+        std::size_t size = allocation_size(bytes);
+        void* p = m_allocate ? m_allocate(size) : aligned_allocate(size);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        if (m_register)
+        {
+            try
+            {
+                m_register(p, size);
+            }
+            catch (...)
+            {
+                m_deallocate ? m_deallocate(p, size) : aligned_deallocate(p);
+                throw;
+            }
+        }
+        ++m_registered;
+        return p;
+    }
+
+    /**
+     * Unregisters the buffer \c p and frees it.
+     */
+    inline void memory_registry::deallocate(void* p, std::size_t bytes) noexcept
+    {
+        std::size_t size = allocation_size(bytes);
+        if (m_unregister)
+        {
+            m_unregister(p, size);
+        }
+        --m_registered;
+        m_deallocate ? m_deallocate(p, size) : aligned_deallocate(p);
+    }
+
+    /**
+     * Returns the number of buffers of the registry currently alive.
+     */
+    inline std::size_t memory_registry::registered() const noexcept
+    {
+        return m_registered.load();
+    }
+
+    /**
+     * Returns the registry used by the default constructed
+     * registered_allocators. Unless it has been replaced, it allocates
+     * page-aligned buffers from the heap without registering them.
+     */
+    inline std::shared_ptr<memory_registry> memory_registry::get_default()
+    {
+        std::lock_guard<std::mutex> lock(default_mutex());
+        return default_registry();
+    }
+
+    /**
+     * Replaces the registry used by the default constructed
+     * registered_allocators, and returns the previous one. Passing
+     * nullptr restores a registry allocating from the heap.
+     */
+    inline std::shared_ptr<memory_registry> memory_registry::set_default(std::shared_ptr<memory_registry> registry)
+    {
+        if (!registry)
+        {
+            registry = std::make_shared<memory_registry>();
+        }
+        std::lock_guard<std::mutex> lock(default_mutex());
+        std::swap(default_registry(), registry);
+        return registry;
+    }
+
+    inline std::size_t memory_registry::allocation_size(std::size_t bytes) noexcept
+    {
+        constexpr std::size_t alignment = XTENSOR_REGISTERED_ALIGNMENT;
+        return bytes == 0 ? alignment : (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    // The heap buffers are over-allocated, the address returned by
+    // operator new being stored right before the aligned buffer
+    inline void* memory_registry::aligned_allocate(std::size_t bytes)
+    {
+        constexpr std::size_t alignment = XTENSOR_REGISTERED_ALIGNMENT;
+        if (bytes > (std::numeric_limits<std::size_t>::max)() - alignment - sizeof(void*))
+        {
+            throw std::bad_alloc();
+        }
+        char* raw = static_cast<char*>(::operator new(bytes + alignment + sizeof(void*)));
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+        char* res = raw + sizeof(void*) + (alignment - address % alignment) % alignment;
+        reinterpret_cast<void**>(res)[-1] = raw;
+        return res;
+    }
+
+    inline void memory_registry::aligned_deallocate(void* p) noexcept
+    {
+        ::operator delete(static_cast<void**>(p)[-1]);
+    }
+
+    inline std::mutex& memory_registry::default_mutex() noexcept
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    inline std::shared_ptr<memory_registry>& memory_registry::default_registry()
+    {
+        static std::shared_ptr<memory_registry> registry = std::make_shared<memory_registry>();
+        return registry;
+    }
+
+    /***************************************
+     * registered_allocator implementation *
+     ***************************************/
+
+    template <class T>
+    inline registered_allocator<T>::registered_allocator()
+        : m_registry(memory_registry::get_default())
+    {
+    }
+
+    template <class T>
+    inline registered_allocator<T>::registered_allocator(registry_type registry) noexcept
+        : m_registry(std::move(registry))
+    {
+    }
+
+    template <class T>
+    template <class U>
+    inline registered_allocator<T>::registered_allocator(const registered_allocator<U>& rhs) noexcept
+        : m_registry(rhs.registry())
+    {
+    }
+
+    template <class T>
+    inline T* registered_allocator<T>::allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= XTENSOR_REGISTERED_ALIGNMENT, "registered_allocator does not support this alignment");
+        if (n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(m_registry->allocate(n * sizeof(T)));
+    }
+
+    template <class T>
+    inline void registered_allocator<T>::deallocate(T* p, std::size_t n) noexcept
+    {
+        m_registry->deallocate(p, n * sizeof(T));
+    }
+
+    template <class T>
+    inline auto registered_allocator<T>::registry() const noexcept -> const registry_type&
+    {
+        return m_registry;
+    }
+
+    template <class T, class U>
+    inline bool operator==(const registered_allocator<T>& lhs, const registered_allocator<U>& rhs) noexcept
+    {
+        return lhs.registry() == rhs.registry();
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const registered_allocator<T>& lhs, const registered_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -10,10 +10,13 @@
 #ifndef XTENSOR_XREPEAT
 #define XTENSOR_XREPEAT
 
+#include <algorithm>
 #include <vector>
 #include <utility>
 
 #include "xaccessible.hpp"
+#include "xassign.hpp"
+#include "xexpression_traits.hpp"
 #include "xiterable.hpp"
 
 
@@ -61,7 +64,7 @@ namespace xt
         using reference = typename xexpression_type::const_reference;
         using const_reference = typename xexpression_type::const_reference;
         using size_type = typename xexpression_type::size_type;
-        using temporary_type = typename xexpression_type::temporary_type;
+        using temporary_type = temporary_type_t<xexpression_type>;
 
         static constexpr bool is_const = std::is_const<std::remove_reference_t<CT>>::value;
 
@@ -160,6 +163,9 @@ namespace xt
         const_stepper stepper_end(layout_type l) const;
         const_stepper stepper_end(const shape_type& s, layout_type l) const;
 
+        template <class E>
+        void assign_to(xexpression<E>& e) const;
+
     private:
 
         CT m_e;
@@ -178,6 +184,11 @@ namespace xt
         template<std::size_t I>
         const_reference access_impl(stepper&& s) const;
 
+        template <class E>
+        bool assign_blocks(E& res) const;
+
+        template <class E, class S>
+        void copy_runs(E& res, const S& src) const;
     };
 
     /*******************
@@ -261,7 +272,7 @@ namespace xt
         : m_e(std::forward<CTA>(e))
         , m_repeating_axis(axis)
         , m_repeats(std::forward<R>(repeats))
-        , m_shape(e.shape())
+        , m_shape(m_e.shape())
     {
         using shape_value_type = typename shape_type::value_type;
         m_shape[axis] = static_cast<shape_value_type>(std::accumulate(m_repeats.begin(), m_repeats.end(), 0));
@@ -446,6 +457,117 @@ namespace xt
         return st;
     }
 
+    /**
+     * Assigns the expression to the container \c e, resized to the shape of
+     * the expression. When \c e is contiguous, each run of elements of the
+     * repeated expression along the repeating axis is copied as a block as
+     * many times as it is repeated.
+     */
+    template <class CT, class R>
+    template <class E>
+    inline void xrepeat<CT, R>::assign_to(xexpression<E>& e) const
+    {
+        using tag = xexpression_tag_t<E, self_type>;
+        using block_assign = xtl::conjunction<std::is_same<tag, xtensor_expression_tag>, has_data_interface<E>>;
+
+        E& de = e.derived_cast();
+        de.resize(m_shape);
+        bool done = xtl::mpl::static_if<block_assign::value>([&](auto self)
+        {
+            return self(*this).assign_blocks(de);
+        }, /*else*/ [](auto /*self*/)
+        {
+            return false;
+        });
+        if (!done)
+        {
+            const xexpression<self_type>& self = *this;
+            xexpression_assigner<tag>::assign_data(e, self, true);
+        }
+    }
+
+    template <class CT, class R>
+    template <class E>
+    inline bool xrepeat<CT, R>::assign_blocks(E& res) const
+    {
+        layout_type l = res.layout();
+        if ((l != layout_type::row_major && l != layout_type::column_major) || !res.is_contiguous())
+        {
+            return false;
+        }
+
+        bool direct = xtl::mpl::static_if<has_data_interface<xexpression_type>::value>([&](auto self)
+        {
+            const auto& src = self(m_e);
+            if (src.is_contiguous() && src.layout() == l)
+            {
+                self(*this).copy_runs(res, src);
+                return true;
+            }
+            return false;
+        }, /*else*/ [](auto /*self*/)
+        {
+            return false;
+        });
+
+        // Otherwise the repeated expression is evaluated in the layout of
+        // res first, this temporary being smaller than the result
+        if (!direct && l == layout_type::row_major)
+        {
+            typename detail::xtype_for_shape<shape_type>::template type<value_type, layout_type::row_major> tmp = m_e;
+            copy_runs(res, tmp);
+        }
+        else if (!direct)
+        {
+            typename detail::xtype_for_shape<shape_type>::template type<value_type, layout_type::column_major> tmp = m_e;
+            copy_runs(res, tmp);
+        }
+        return true;
+    }
+
+    template <class CT, class R>
+    template <class E, class S>
+    inline void xrepeat<CT, R>::copy_runs(E& res, const S& src) const
+    {
+        const auto& shape = src.shape();
+        std::size_t inner = 1;
+        std::size_t outer = 1;
+        for (std::size_t d = 0; d < shape.size(); ++d)
+        {
+            bool is_inner = res.layout() == layout_type::row_major ? d > m_repeating_axis : d < m_repeating_axis;
+            if (is_inner)
+            {
+                inner *= static_cast<std::size_t>(shape[d]);
+            }
+            else if (d != m_repeating_axis)
+            {
+                outer *= static_cast<std::size_t>(shape[d]);
+            }
+        }
+
+        auto in = src.data() + static_cast<std::ptrdiff_t>(src.data_offset());
+        auto out = res.data();
+        std::size_t nb_runs = static_cast<std::size_t>(shape[m_repeating_axis]);
+        for (std::size_t o = 0; o < outer; ++o)
+        {
+            for (std::size_t k = 0; k < nb_runs; ++k, in += static_cast<std::ptrdiff_t>(inner))
+            {
+                std::size_t count = static_cast<std::size_t>(m_repeats[k]);
+                if (inner == 1)
+                {
+                    out = std::fill_n(out, count, *in);
+                }
+                else
+                {
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        out = std::copy(in, in + static_cast<std::ptrdiff_t>(inner), out);
+                    }
+                }
+            }
+        }
+    }
+
     template <class CT, class R>
     template<std::size_t I, class Arg, class... Args>
     inline auto xrepeat<CT, R>::access_impl(stepper&& s, Arg arg, Args... args) const -> const_reference
@@ -0,0 +1,439 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ROLLING_HPP
+#define XTENSOR_ROLLING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <xtl/xtype_traits.hpp>
+
+#include "xarray.hpp"
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xtensor_config.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /**************************
+     * rolling window kernels *
+     **************************/
+
+    namespace detail
+    {
+        // Number of adjacent lanes processed together by a task: the
+        // sliding sums update a whole row of them at each step, which
+        // reads the input contiguously.
+        constexpr std::size_t rolling_lane_block = 256;
+
+        // The input seen as outer x length x inner, the window moving
+        // along the middle axis. The result has count = length - window + 1
+        // positions along that axis.
+        struct rolling_geometry
+        {
+            std::size_t outer;
+            std::size_t length;
+            std::size_t inner;
+            std::size_t window;
+            std::size_t count;
+        };
+
+        template <class T>
+        using rolling_sum_accumulator_t = std::conditional_t<xtl::is_integral<T>::value,
+                                                             xtl::big_promote_type_t<T>,
+                                                             std::common_type_t<T, double>>;
+
+        template <class T>
+        using rolling_mean_result_t = std::conditional_t<xtl::is_integral<T>::value, double, T>;
+
+        // Sliding sum: each step adds the element entering the window and
+        // subtracts the one leaving it.
+        template <bool Mean>
+        struct rolling_sum_kernel
+        {
+            template <class T>
+            using result_type = std::conditional_t<Mean, rolling_mean_result_t<T>, T>;
+
+            template <class T, class R>
+            void operator()(const T* src, R* dst, const rolling_geometry& g, std::size_t nlanes) const
+            {
+                using acc_type = rolling_sum_accumulator_t<T>;
+                const std::size_t inner = g.inner;
+                std::vector<acc_type> acc(nlanes, acc_type(0));
+                for (std::size_t t = 0; t < g.window; ++t)
+                {
+                    const T* row = src + t * inner;
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        acc[j] += static_cast<acc_type>(row[j]);
+                    }
+                }
+                store(acc, dst, g.window, nlanes);
+                for (std::size_t t = 1; t < g.count; ++t)
+                {
+                    const T* in_row = src + (t + g.window - 1) * inner;
+                    const T* out_row = src + (t - 1) * inner;
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        acc[j] += static_cast<acc_type>(in_row[j]);
+                        acc[j] -= static_cast<acc_type>(out_row[j]);
+                    }
+                    store(acc, dst + t * inner, g.window, nlanes);
+                }
+            }
+
+        private:
+
+            template <class A, class R>
+            static void store(const std::vector<A>& acc, R* dst, std::size_t window, std::size_t nlanes)
+            {
+                using div_type = std::common_type_t<A, R>;
+                const div_type div = Mean ? static_cast<div_type>(window) : div_type(1);
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    dst[j] = static_cast<R>(static_cast<div_type>(acc[j]) / div);
+                }
+            }
+        };
+
+        // Sliding Welford update: with x entering and y leaving a window of
+        // size w, the mean moves by (x - y) / w and the sum of the squared
+        // deviations by (x - y) * (x - new_mean + y - old_mean).
+        template <bool Sqrt>
+        struct rolling_var_kernel
+        {
+            template <class T>
+            using result_type = rolling_mean_result_t<T>;
+
+            template <class T, class R>
+            void operator()(const T* src, R* dst, const rolling_geometry& g, std::size_t nlanes) const
+            {
+                using acc_type = std::common_type_t<T, double>;
+                const std::size_t inner = g.inner;
+                std::vector<acc_type> mean(nlanes, acc_type(0));
+                std::vector<acc_type> m2(nlanes, acc_type(0));
+                for (std::size_t t = 0; t < g.window; ++t)
+                {
+                    const T* row = src + t * inner;
+                    const acc_type n = static_cast<acc_type>(t + 1);
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        acc_type x = static_cast<acc_type>(row[j]);
+                        acc_type delta = x - mean[j];
+                        mean[j] += delta / n;
+                        m2[j] += delta * (x - mean[j]);
+                    }
+                }
+                const acc_type w = static_cast<acc_type>(g.window);
+                store(m2, dst, w, nlanes);
+                for (std::size_t t = 1; t < g.count; ++t)
+                {
+                    const T* in_row = src + (t + g.window - 1) * inner;
+                    const T* out_row = src + (t - 1) * inner;
+                    for (std::size_t j = 0; j < nlanes; ++j)
+                    {
+                        acc_type x = static_cast<acc_type>(in_row[j]);
+                        acc_type y = static_cast<acc_type>(out_row[j]);
+                        acc_type old_mean = mean[j];
+                        mean[j] += (x - y) / w;
+                        m2[j] += (x - y) * (x - mean[j] + y - old_mean);
+                    }
+                    store(m2, dst + t * inner, w, nlanes);
+                }
+            }
+
+        private:
+
+            template <class A, class R>
+            static void store(const std::vector<A>& m2, R* dst, A w, std::size_t nlanes)
+            {
+                using std::sqrt;
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    // The updates can leave a tiny negative rounding error
+                    A var = (std::max)(m2[j], A(0)) / w;
+                    dst[j] = static_cast<R>(Sqrt ? sqrt(var) : var);
+                }
+            }
+        };
+
+        // Monotonic deque of the indices of the lane whose values can still
+        // become the extremum of a window, the front holding the current one;
+        // each index is pushed and popped at most once.
+        template <class Compare>
+        struct rolling_extremum_kernel
+        {
+            template <class T>
+            using result_type = T;
+
+            template <class T>
+            void operator()(const T* src, T* dst, const rolling_geometry& g, std::size_t nlanes) const
+            {
+                const std::size_t inner = g.inner;
+                std::vector<std::size_t> deque(g.length);
+                Compare cmp;
+                for (std::size_t j = 0; j < nlanes; ++j)
+                {
+                    const T* lane = src + j;
+                    std::size_t head = 0;
+                    std::size_t tail = 0;
+                    for (std::size_t t = 0; t < g.length; ++t)
+                    {
+                        if (head != tail && deque[head] + g.window <= t)
+                        {
+                            ++head;
+                        }
+                        const T& x = lane[t * inner];
+                        while (head != tail && !cmp(lane[deque[tail - 1] * inner], x))
+                        {
+                            --tail;
+                        }
+                        deque[tail++] = t;
+                        if (t + 1 >= g.window)
+                        {
+                            dst[(t + 1 - g.window) * inner + j] = lane[deque[head] * inner];
+                        }
+                    }
+                }
+            }
+        };
+
+        template <class K, class E, class P>
+        inline auto rolling(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+        {
+            using value_type = typename E::value_type;
+            static_assert(std::is_arithmetic<value_type>::value, "rolling functions require arithmetic values");
+            using result_type = typename K::template result_type<value_type>;
+            using array_type = xarray<value_type, layout_type::row_major>;
+            using result_array_type = xarray<result_type, layout_type::row_major>;
+
+            array_type in = e.derived_cast();
+            if (in.dimension() == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "rolling: the expression must have at least one dimension");
+            }
+            const std::size_t saxis = normalize_axis(in.dimension(), axis);
+            if (saxis >= in.dimension())
+            {
+                XTENSOR_THROW(std::runtime_error, "rolling: axis out of bounds");
+            }
+
+            rolling_geometry g;
+            g.length = in.shape()[saxis];
+            g.window = window;
+            if (window == 0 || window > g.length)
+            {
+                XTENSOR_THROW(std::runtime_error, "rolling: the window must be between 1 and the length of the axis");
+            }
+            g.count = g.length - window + 1;
+            g.outer = std::accumulate(in.shape().cbegin(), in.shape().cbegin() + static_cast<std::ptrdiff_t>(saxis),
+                                      std::size_t(1), std::multiplies<std::size_t>());
+            g.inner = std::accumulate(in.shape().cbegin() + static_cast<std::ptrdiff_t>(saxis) + 1, in.shape().cend(),
+                                      std::size_t(1), std::multiplies<std::size_t>());
+
+            typename result_array_type::shape_type res_shape(in.shape().cbegin(), in.shape().cend());
+            res_shape[saxis] = g.count;
+            result_array_type res = result_array_type::from_shape(res_shape);
+            if (res.size() == 0)
+            {
+                return res;
+            }
+
+            const std::size_t blocks = (g.inner + rolling_lane_block - 1) / rolling_lane_block;
+            const value_type* src = in.data();
+            result_type* dst = res.data();
+            K kernel;
+            policy.for_range(0, g.outer * blocks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t task = first; task < last; ++task)
+                {
+                    std::size_t o = task / blocks;
+                    std::size_t lane = (task % blocks) * rolling_lane_block;
+                    std::size_t nlanes = (std::min)(rolling_lane_block, g.inner - lane);
+                    kernel(src + o * g.length * g.inner + lane, dst + o * g.count * g.inner + lane, g, nlanes);
+                }
+            });
+            return res;
+        }
+    }
+
+    /**
+     * @brief Computes the sums over a window sliding along an axis.
+     *
+     * The i-th element of the result along \c axis is the sum of the
+     * elements i to i + window - 1 of the expression along that axis, so
+     * that the axis of the result has its length minus window plus one
+     * positions. Each step of the window adds the element that enters it
+     * and subtracts the one that leaves it, so that the cost does not
+     * depend on the size of the window; floating point sums are
+     * accumulated in double precision. The lanes along the axis are split
+     * among the threads of the policy.
+     *
+     * @param e the expression
+     * @param window the number of elements of the window
+     * @param axis the axis along which the window moves
+     * @param policy the execution policy splitting the lanes
+     * @return a row-major xarray
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto rolling_sum(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+    {
+        return detail::rolling<detail::rolling_sum_kernel<false>>(e, window, axis, policy);
+    }
+
+    /**
+     * @brief Computes the sums over a window sliding along an axis, on the
+     * calling thread.
+     *
+     * @sa rolling_sum(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E>
+    inline auto rolling_sum(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis = -1)
+    {
+        return detail::rolling<detail::rolling_sum_kernel<false>>(e, window, axis, exec::default_policy());
+    }
+
+    /**
+     * @brief Computes the means over a window sliding along an axis.
+     *
+     * The means of integral expressions are doubles.
+     *
+     * @sa rolling_sum(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto rolling_mean(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+    {
+        return detail::rolling<detail::rolling_sum_kernel<true>>(e, window, axis, policy);
+    }
+
+    /**
+     * @brief Computes the means over a window sliding along an axis, on the
+     * calling thread.
+     *
+     * @sa rolling_mean(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E>
+    inline auto rolling_mean(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis = -1)
+    {
+        return detail::rolling<detail::rolling_sum_kernel<true>>(e, window, axis, exec::default_policy());
+    }
+
+    /**
+     * @brief Computes the variances over a window sliding along an axis.
+     *
+     * The variance is the mean of the squared deviations from the mean of
+     * the window, as xt::variance without ddof. It is updated at each step
+     * with Welford's formula rather than from the sums of the squares,
+     * which would lose the variance of windows of large values to
+     * cancellation. The variances of integral expressions are doubles.
+     *
+     * @sa rolling_sum(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto rolling_var(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+    {
+        return detail::rolling<detail::rolling_var_kernel<false>>(e, window, axis, policy);
+    }
+
+    /**
+     * @brief Computes the variances over a window sliding along an axis, on
+     * the calling thread.
+     *
+     * @sa rolling_var(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E>
+    inline auto rolling_var(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis = -1)
+    {
+        return detail::rolling<detail::rolling_var_kernel<false>>(e, window, axis, exec::default_policy());
+    }
+
+    /**
+     * @brief Computes the standard deviations over a window sliding along an
+     * axis.
+     *
+     * @sa rolling_var(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto rolling_std(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+    {
+        return detail::rolling<detail::rolling_var_kernel<true>>(e, window, axis, policy);
+    }
+
+    /**
+     * @brief Computes the standard deviations over a window sliding along an
+     * axis, on the calling thread.
+     *
+     * @sa rolling_var(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E>
+    inline auto rolling_std(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis = -1)
+    {
+        return detail::rolling<detail::rolling_var_kernel<true>>(e, window, axis, exec::default_policy());
+    }
+
+    /**
+     * @brief Computes the minima over a window sliding along an axis.
+     *
+     * Each lane keeps the indices of the elements that can still become
+     * the minimum of a later window in a monotonic queue, so that every
+     * element is compared a constant number of times on average whatever
+     * the size of the window.
+     *
+     * @sa rolling_sum(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto rolling_min(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+    {
+        return detail::rolling<detail::rolling_extremum_kernel<std::less<>>>(e, window, axis, policy);
+    }
+
+    /**
+     * @brief Computes the minima over a window sliding along an axis, on the
+     * calling thread.
+     *
+     * @sa rolling_min(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E>
+    inline auto rolling_min(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis = -1)
+    {
+        return detail::rolling<detail::rolling_extremum_kernel<std::less<>>>(e, window, axis, exec::default_policy());
+    }
+
+    /**
+     * @brief Computes the maxima over a window sliding along an axis.
+     *
+     * @sa rolling_min(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto rolling_max(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis, const P& policy)
+    {
+        return detail::rolling<detail::rolling_extremum_kernel<std::greater<>>>(e, window, axis, policy);
+    }
+
+    /**
+     * @brief Computes the maxima over a window sliding along an axis, on the
+     * calling thread.
+     *
+     * @sa rolling_max(const xexpression<E>&, std::size_t, std::ptrdiff_t, const P&)
+     */
+    template <class E>
+    inline auto rolling_max(const xexpression<E>& e, std::size_t window, std::ptrdiff_t axis = -1)
+    {
+        return detail::rolling<detail::rolling_extremum_kernel<std::greater<>>>(e, window, axis, exec::default_policy());
+    }
+}
+
+#endif
@@ -388,7 +388,11 @@ namespace xt
         template <class T>
         simd_return_type<T> step_simd();
 
+        template <class T>
+        simd_return_type<T> step_simd(size_type dim);
+
         void step_leading();
+        void step_leading(size_type dim);
 
     private:
 
@@ -1029,11 +1033,23 @@ namespace xt
         return simd_return_type<T>(p_c->operator()());
     }
 
+    template <bool is_const, class CT>
+    template <class T>
+    inline auto xscalar_stepper<is_const, CT>::step_simd(size_type) -> simd_return_type<T>
+    {
+        return step_simd<T>();
+    }
+
     template <bool is_const, class CT>
     inline void xscalar_stepper<is_const, CT>::step_leading()
     {
     }
 
+    template <bool is_const, class CT>
+    inline void xscalar_stepper<is_const, CT>::step_leading(size_type)
+    {
+    }
+
     /**********************************
      * xdummy_iterator implementation *
      **********************************/
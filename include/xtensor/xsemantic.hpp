@@ -10,7 +10,13 @@
 #ifndef XTENSOR_SEMANTIC_HPP
 #define XTENSOR_SEMANTIC_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "xassign.hpp"
@@ -115,6 +121,9 @@ namespace xt
         template <class E>
         derived_type& assign(const xexpression<E>&);
 
+        template <class E, class P>
+        derived_type& assign(const xexpression<E>&, const P& policy);
+
         template <class E>
         derived_type& plus_assign(const xexpression<E>&);
 
@@ -188,6 +197,9 @@ namespace xt
         template <class E>
         derived_type& assign_xexpression(const xexpression<E>& e);
 
+        template <class E, class P>
+        derived_type& assign_xexpression(const xexpression<E>& e, const P& policy);
+
         template <class E>
         derived_type& computed_assign(const xexpression<E>& e);
 
@@ -242,6 +254,9 @@ namespace xt
         template <class E>
         derived_type& assign_xexpression(const xexpression<E>& e);
 
+        template <class E, class P>
+        derived_type& assign_xexpression(const xexpression<E>& e, const P& policy);
+
         template <class E>
         derived_type& computed_assign(const xexpression<E>& e);
 
@@ -489,6 +504,21 @@ namespace xt
         return this->derived_cast().assign_xexpression(e);
     }
 
+    /**
+     * Assigns the xexpression \c e to \c *this. Ensures no temporary
+     * will be used to perform the assignment, and distributes the work
+     * according to \c policy.
+     * @param e the xexpression to assign.
+     * @param policy the execution policy, \c exec::seq or the result of \c exec::par.
+     * @return a reference to \c *this.
+     */
+    template <class D>
+    template <class E, class P>
+    inline auto xsemantic_base<D>::assign(const xexpression<E>& e, const P& policy) -> derived_type&
+    {
+        return this->derived_cast().assign_xexpression(e, policy);
+    }
+
     /**
      * Adds the xexpression \c e to \c *this. Ensures no temporary
      * will be used to perform the assignment.
@@ -593,10 +623,180 @@ namespace xt
         return this->derived_cast().computed_assign(this->derived_cast() ^ e.derived_cast());
     }
 
+    namespace detail
+    {
+        /******************
+         * alias analysis *
+         ******************/
+
+        template <class E, class = void>
+        struct has_memory_range : std::false_type
+        {
+        };
+
+        // Packed storages, such as xbit_vector, have no pointer to their elements
+        template <class E>
+        struct has_memory_range<E, void_t<decltype(std::declval<const E&>().data()),
+                                          decltype(std::declval<const E&>().data_offset()),
+                                          decltype(std::declval<const E&>().strides())>>
+            : std::is_same<decltype(std::declval<const E&>().data()), const typename E::value_type*>
+        {
+        };
+
+        // Bytes spanned by the elements of an expression with a data interface
+        struct memory_range
+        {
+            std::uintptr_t first;
+            std::uintptr_t last;
+            std::uintptr_t origin;
+        };
+
+        template <class E>
+        inline memory_range make_memory_range(const E& e)
+        {
+            using value_type = typename E::value_type;
+            std::uintptr_t origin = reinterpret_cast<std::uintptr_t>(e.data() + e.data_offset());
+            if (e.size() == 0)
+            {
+                return {origin, origin, origin};
+            }
+            std::ptrdiff_t min_offset = 0;
+            std::ptrdiff_t max_offset = 0;
+            for (std::size_t i = 0; i < e.dimension(); ++i)
+            {
+                std::ptrdiff_t extent = static_cast<std::ptrdiff_t>(e.shape()[i] - 1) * static_cast<std::ptrdiff_t>(e.strides()[i]);
+                (extent < 0 ? min_offset : max_offset) += extent;
+            }
+            std::ptrdiff_t elem_size = static_cast<std::ptrdiff_t>(sizeof(value_type));
+            return {static_cast<std::uintptr_t>(static_cast<std::ptrdiff_t>(origin) + min_offset * elem_size),
+                    static_cast<std::uintptr_t>(static_cast<std::ptrdiff_t>(origin) + (max_offset + 1) * elem_size),
+                    origin};
+        }
+
+        /**
+         * Checks whether an expression can be assigned to a destination with
+         * a data interface without a temporary. Each leaf of the expression
+         * must either not overlap the destination, or read exactly the element
+         * being written, i.e. start at the same address with the same shape
+         * and strides as the destination. Leaves whose memory is unknown,
+         * and nodes other than functions and scalars, are assumed to alias.
+         */
+        template <class D>
+        class alias_checker
+        {
+        public:
+
+            alias_checker(const D& dst, bool same_shape)
+                : m_dst(dst), m_range(make_memory_range(dst)), m_same_shape(same_shape)
+            {
+            }
+
+            template <class F, class... CT>
+            bool safe(const xfunction<F, CT...>& e) const
+            {
+                return safe_arguments(e.arguments(), std::make_index_sequence<sizeof...(CT)>());
+            }
+
+            template <class CT>
+            bool safe(const xscalar<CT>& e) const
+            {
+                // A scalar held by reference may be an element of the destination
+                return !std::is_reference<CT>::value || !contains(reinterpret_cast<std::uintptr_t>(std::addressof(e.expression())));
+            }
+
+            template <class E>
+            std::enable_if_t<has_memory_range<E>::value, bool> safe(const E& e) const
+            {
+                memory_range r = make_memory_range(e);
+                if (r.first == r.last || r.last <= m_range.first || m_range.last <= r.first)
+                {
+                    return true;
+                }
+                return m_same_shape && r.origin == m_range.origin &&
+                       sizeof(typename E::value_type) == sizeof(typename D::value_type) &&
+                       same_layout(e);
+            }
+
+            template <class E>
+            std::enable_if_t<!has_memory_range<E>::value, bool> safe(const E&) const
+            {
+                return false;
+            }
+
+        private:
+
+            template <class T, std::size_t... I>
+            bool safe_arguments(const T& args, std::index_sequence<I...>) const
+            {
+                bool res = true;
+                (void) std::initializer_list<int>{(res = res && safe(std::get<I>(args)), 0)...};
+                return res;
+            }
+
+            bool contains(std::uintptr_t address) const
+            {
+                return m_range.first <= address && address < m_range.last;
+            }
+
+            template <class E>
+            bool same_layout(const E& e) const
+            {
+                if (e.dimension() != m_dst.dimension())
+                {
+                    return false;
+                }
+                for (std::size_t i = 0; i < e.dimension(); ++i)
+                {
+                    if (e.shape()[i] != m_dst.shape()[i] ||
+                        (e.shape()[i] != 1 && static_cast<std::ptrdiff_t>(e.strides()[i]) != static_cast<std::ptrdiff_t>(m_dst.strides()[i])))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            const D& m_dst;
+            memory_range m_range;
+            bool m_same_shape;
+        };
+
+        template <class D, class E>
+        inline bool is_alias_safe(const D& dst, const E& e, std::true_type)
+        {
+            bool same_shape = dst.dimension() == e.dimension() &&
+                              std::equal(dst.shape().cbegin(), dst.shape().cend(), e.shape().cbegin());
+            return alias_checker<D>(dst, same_shape).safe(e);
+        }
+
+        template <class D, class E>
+        inline bool is_alias_safe(const D&, const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class D, class E>
+        inline bool is_alias_safe(const D& dst, const E& e)
+        {
+            return is_alias_safe(dst, e, has_memory_range<D>());
+        }
+    }
+
+    /**
+     * Assigns the xexpression \c e to \c *this. A temporary is used unless
+     * the analysis of the memory read by \c e shows that it can be assigned
+     * in place, as for <tt>a = a + b</tt> when \c b does not overlap \c a.
+     * @param e the xexpression to assign.
+     * @return a reference to \c *this.
+     */
     template <class D>
     template <class E>
     inline auto xsemantic_base<D>::operator=(const xexpression<E>& e) -> derived_type&
     {
+        if (detail::is_alias_safe(this->derived_cast(), e.derived_cast()))
+        {
+            return this->derived_cast().assign_xexpression(e);
+        }
         temporary_type tmp(e);
         return this->derived_cast().assign_temporary(std::move(tmp));
     }
@@ -624,6 +824,14 @@ namespace xt
         return this->derived_cast();
     }
 
+    template <class D>
+    template <class E, class P>
+    inline auto xcontainer_semantic<D>::assign_xexpression(const xexpression<E>& e, const P& policy) -> derived_type&
+    {
+        xt::assign_xexpression(*this, e, policy);
+        return this->derived_cast();
+    }
+
     template <class D>
     template <class E>
     inline auto xcontainer_semantic<D>::computed_assign(const xexpression<E>& e) -> derived_type&
@@ -692,6 +900,15 @@ namespace xt
         return this->derived_cast();
     }
 
+    template <class D>
+    template <class E, class P>
+    inline auto xview_semantic<D>::assign_xexpression(const xexpression<E>& e, const P& policy) -> derived_type&
+    {
+        xt::assert_compatible_shape(*this, e);
+        xt::assign_data(*this, e, detail::get_rhs_triviality(e.derived_cast()), policy);
+        return this->derived_cast();
+    }
+
     template <class D>
     template <class E>
     inline auto xview_semantic<D>::computed_assign(const xexpression<E>& e) -> derived_type&
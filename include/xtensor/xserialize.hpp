@@ -0,0 +1,365 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SERIALIZE_HPP
+#define XTENSOR_SERIALIZE_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <xtl/xplatform.hpp>
+
+#include "xadapt.hpp"
+#include "xarray.hpp"
+#include "xexception.hpp"
+#include "xlayout.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    /************************
+     * binary record format *
+     ************************/
+
+    /*
+     * A serialized record is a fixed 24 bytes header, followed by the
+     * shape and the strides, zero padding, and the raw elements:
+     *
+     *   offset  size  field
+     *   0       4     magic "XTSR"
+     *   4       1     format version
+     *   5       1     byte order ('<', '>' or '|')
+     *   6       1     value kind ('b', 'i', 'u', 'f' or 'c')
+     *   7       1     size of a value in bytes
+     *   8       1     layout of the data (xt::layout_type)
+     *   9       3     reserved, zero
+     *   12      4     dimension
+     *   16      4     alignment of the data section
+     *   20      4     offset of the data section
+     *   24      8*d   shape, unsigned 64 bits
+     *   24+8*d  8*d   strides in elements, signed 64 bits
+     *
+     * Integers of the header are stored in the byte order of the record.
+     * The data section starts at a multiple of the alignment, so that a
+     * buffer holding the record can be adapted without copying.
+     */
+
+    namespace detail
+    {
+        constexpr char serialize_magic[] = {'X', 'T', 'S', 'R'};
+        constexpr std::uint8_t serialize_version = 1;
+        constexpr std::size_t serialize_header_size = 24;
+
+        template <class T>
+        inline char serialize_kind()
+        {
+            using value_type = std::remove_cv_t<T>;
+            if (std::is_same<value_type, bool>::value) return 'b';
+            if (std::is_floating_point<value_type>::value) return 'f';
+            if (std::is_same<value_type, std::complex<float>>::value) return 'c';
+            if (std::is_same<value_type, std::complex<double>>::value) return 'c';
+            if (std::is_same<value_type, std::complex<long double>>::value) return 'c';
+            if (std::is_integral<value_type>::value)
+            {
+                return std::is_signed<value_type>::value ? 'i' : 'u';
+            }
+            XTENSOR_THROW(std::runtime_error, "Type not serializable.");
+        }
+
+        template <class T>
+        inline char serialize_byte_order()
+        {
+            if (sizeof(T) == 1)
+            {
+                return '|';
+            }
+            return xtl::endianness() == xtl::endian::big_endian ? '>' : '<';
+        }
+
+        template <class I>
+        inline void serialize_integer(char* buffer, I value)
+        {
+            std::memcpy(buffer, &value, sizeof(I));
+        }
+
+        template <class I>
+        inline I deserialize_integer(const char* buffer)
+        {
+            I value;
+            std::memcpy(&value, buffer, sizeof(I));
+            return value;
+        }
+
+        struct serialize_header
+        {
+            char byte_order;
+            char kind;
+            std::size_t value_size;
+            layout_type layout;
+            std::size_t dimension;
+            std::size_t data_offset;
+            std::vector<std::size_t> shape;
+            std::vector<std::ptrdiff_t> strides;
+        };
+
+        inline std::size_t serialize_data_offset(std::size_t dimension, std::size_t alignment)
+        {
+            std::size_t size = serialize_header_size + 16 * dimension;
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        template <class T, class S>
+        inline std::vector<char> build_serialize_header(const S& shape, const S& strides,
+                                                        layout_type l, std::size_t alignment)
+        {
+            std::size_t dimension = shape.size();
+            std::size_t data_offset = serialize_data_offset(dimension, alignment);
+            std::vector<char> header(data_offset, '\0');
+            char* ptr = header.data();
+            std::memcpy(ptr, serialize_magic, 4);
+            ptr[4] = static_cast<char>(serialize_version);
+            ptr[5] = serialize_byte_order<T>();
+            ptr[6] = serialize_kind<T>();
+            ptr[7] = static_cast<char>(sizeof(T));
+            ptr[8] = static_cast<char>(l);
+            serialize_integer(ptr + 12, static_cast<std::uint32_t>(dimension));
+            serialize_integer(ptr + 16, static_cast<std::uint32_t>(alignment));
+            serialize_integer(ptr + 20, static_cast<std::uint32_t>(data_offset));
+            ptr += serialize_header_size;
+            for (std::size_t i = 0; i < dimension; ++i, ptr += 8)
+            {
+                serialize_integer(ptr, static_cast<std::uint64_t>(shape[i]));
+            }
+            for (std::size_t i = 0; i < dimension; ++i, ptr += 8)
+            {
+                serialize_integer(ptr, static_cast<std::int64_t>(strides[i]));
+            }
+            return header;
+        }
+
+        inline serialize_header parse_serialize_header(const char* buffer, std::size_t size)
+        {
+            if (size < serialize_header_size || std::memcmp(buffer, serialize_magic, 4) != 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "Not a serialized xtensor record.");
+            }
+            if (static_cast<std::uint8_t>(buffer[4]) != serialize_version)
+            {
+                XTENSOR_THROW(std::runtime_error, "Unsupported serialized record version.");
+            }
+            serialize_header header;
+            header.byte_order = buffer[5];
+            header.kind = buffer[6];
+            header.value_size = static_cast<std::uint8_t>(buffer[7]);
+            header.layout = static_cast<layout_type>(static_cast<unsigned char>(buffer[8]));
+            header.dimension = deserialize_integer<std::uint32_t>(buffer + 12);
+            header.data_offset = deserialize_integer<std::uint32_t>(buffer + 20);
+            if (size < serialize_header_size + 16 * header.dimension)
+            {
+                XTENSOR_THROW(std::runtime_error, "Truncated serialized record header.");
+            }
+            const char* ptr = buffer + serialize_header_size;
+            header.shape.resize(header.dimension);
+            header.strides.resize(header.dimension);
+            for (std::size_t i = 0; i < header.dimension; ++i, ptr += 8)
+            {
+                header.shape[i] = static_cast<std::size_t>(deserialize_integer<std::uint64_t>(ptr));
+            }
+            for (std::size_t i = 0; i < header.dimension; ++i, ptr += 8)
+            {
+                header.strides[i] = static_cast<std::ptrdiff_t>(deserialize_integer<std::int64_t>(ptr));
+            }
+            return header;
+        }
+
+        template <class T>
+        inline void check_serialize_header(const serialize_header& header)
+        {
+            if (header.kind != serialize_kind<T>() || header.value_size != sizeof(T))
+            {
+                XTENSOR_THROW(std::runtime_error, "Serialized record has a different value type.");
+            }
+            if (header.byte_order != '|' && header.byte_order != serialize_byte_order<T>())
+            {
+                XTENSOR_THROW(std::runtime_error, "Serialized record has a different byte order.");
+            }
+        }
+
+        inline std::size_t serialize_data_size(const serialize_header& header)
+        {
+            std::size_t size = 1;
+            for (auto s : header.shape)
+            {
+                size *= s;
+            }
+            return size;
+        }
+
+        template <class E>
+        inline bool has_serializable_data(const E& e, std::true_type)
+        {
+            return e.layout() == layout_type::row_major || e.layout() == layout_type::column_major;
+        }
+
+        template <class E>
+        inline bool has_serializable_data(const E&, std::false_type)
+        {
+            return false;
+        }
+
+        template <class E>
+        inline void write_serialized(std::ostream& stream, const E& e, layout_type l, std::size_t alignment)
+        {
+            using value_type = typename E::value_type;
+            using shape_type = std::vector<std::size_t>;
+            shape_type shape(e.shape().cbegin(), e.shape().cend());
+            shape_type strides(shape.size());
+            compute_strides(shape, l, strides);
+            auto header = build_serialize_header<value_type>(shape, strides, l, alignment);
+            stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+            stream.write(reinterpret_cast<const char*>(e.data() + e.data_offset()),
+                         static_cast<std::streamsize>(sizeof(value_type) * e.size()));
+        }
+
+        template <class E>
+        inline void serialize_impl(std::ostream& stream, const E& e, std::size_t alignment, std::true_type)
+        {
+            if (has_serializable_data(e, std::true_type()))
+            {
+                write_serialized(stream, e, e.layout(), alignment);
+            }
+            else
+            {
+                xarray<typename E::value_type, layout_type::row_major> tmp = e;
+                write_serialized(stream, tmp, layout_type::row_major, alignment);
+            }
+        }
+
+        template <class E>
+        inline void serialize_impl(std::ostream& stream, const E& e, std::size_t alignment, std::false_type)
+        {
+            xarray<typename E::value_type, layout_type::row_major> tmp = e;
+            write_serialized(stream, tmp, layout_type::row_major, alignment);
+        }
+    }
+
+    /**
+     * @brief Writes an expression to a stream in the xtensor binary format.
+     *
+     * Contiguous row major and column major containers are written without
+     * copy; any other expression is first evaluated in row major order.
+     *
+     * @param stream the output stream, which should be opened in binary mode
+     * @param e the expression to serialize
+     * @param alignment the alignment of the data section in the record, must
+     *                  be a power of two
+     */
+    template <class E>
+    inline void serialize(std::ostream& stream, const xexpression<E>& e, std::size_t alignment = 64)
+    {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "Serialization alignment must be a power of two.");
+        }
+        detail::serialize_impl(stream, e.derived_cast(), alignment, has_data_interface<E>());
+    }
+
+    /**
+     * @brief Reads an expression serialized with xt::serialize.
+     *
+     * @tparam T the value type of the serialized expression
+     * @tparam L the layout of the returned container
+     * @param stream the input stream, which should be opened in binary mode
+     * @return an xarray holding the deserialized values
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    inline xarray<T, L> deserialize(std::istream& stream)
+    {
+        char fixed[detail::serialize_header_size];
+        if (!stream.read(fixed, detail::serialize_header_size)
+            || std::memcmp(fixed, detail::serialize_magic, 4) != 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "Not a serialized xtensor record.");
+        }
+        std::size_t dimension = detail::deserialize_integer<std::uint32_t>(fixed + 12);
+        std::size_t data_offset = detail::deserialize_integer<std::uint32_t>(fixed + 20);
+        std::vector<char> header((std::max)(data_offset, detail::serialize_header_size + 16 * dimension));
+        std::memcpy(header.data(), fixed, detail::serialize_header_size);
+        std::size_t remaining = data_offset - detail::serialize_header_size;
+        if (data_offset < detail::serialize_header_size
+            || !stream.read(header.data() + detail::serialize_header_size, static_cast<std::streamsize>(remaining)))
+        {
+            XTENSOR_THROW(std::runtime_error, "Truncated serialized record header.");
+        }
+        auto h = detail::parse_serialize_header(header.data(), header.size());
+        detail::check_serialize_header<T>(h);
+
+        xarray<T, L> result(h.shape);
+        std::streamsize nbytes = static_cast<std::streamsize>(sizeof(T) * result.size());
+        if (h.layout == L)
+        {
+            if (!stream.read(reinterpret_cast<char*>(result.data()), nbytes))
+            {
+                XTENSOR_THROW(std::runtime_error, "Truncated serialized record data.");
+            }
+        }
+        else
+        {
+            uvector<T> buffer(result.size());
+            if (!stream.read(reinterpret_cast<char*>(buffer.data()), nbytes))
+            {
+                XTENSOR_THROW(std::runtime_error, "Truncated serialized record data.");
+            }
+            result = adapt(buffer.data(), buffer.size(), no_ownership(), h.shape, h.strides);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Adapts a serialized record held in memory without copying it.
+     *
+     * The returned adaptor points to the data section of @p buffer and uses
+     * the shape and the strides stored in the record; it does not own the
+     * memory, which must outlive it.
+     *
+     * @tparam T the value type of the serialized expression
+     * @param buffer pointer to the beginning of the record, aligned at least
+     *               on the alignment of T
+     * @param size the size of the buffer in bytes
+     */
+    template <class T, class B>
+    inline auto adapt_serialized(B* buffer, std::size_t size)
+    {
+        using value_type = std::conditional_t<std::is_const<B>::value, const T, T>;
+        using byte_type = std::conditional_t<std::is_const<B>::value, const char, char>;
+        byte_type* bytes = reinterpret_cast<byte_type*>(buffer);
+        auto h = detail::parse_serialize_header(bytes, size);
+        detail::check_serialize_header<T>(h);
+        std::size_t n = detail::serialize_data_size(h);
+        if (h.data_offset > size || (size - h.data_offset) / sizeof(T) < n)
+        {
+            XTENSOR_THROW(std::runtime_error, "Truncated serialized record data.");
+        }
+        byte_type* data = bytes + h.data_offset;
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "Serialized record data is not aligned.");
+        }
+        return adapt(reinterpret_cast<value_type*>(data), n, no_ownership(), h.shape, h.strides);
+    }
+}
+
+#endif
@@ -12,11 +12,14 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <type_traits>
 
 #include <xtl/xsequence.hpp>
 
 #include "xfunction.hpp"
+#include "xhash_set.hpp"
+#include "xsorted_index.hpp"
 #include "xutils.hpp"
 #include "xscalar.hpp"
 #include "xstrides.hpp"
@@ -28,27 +31,22 @@ namespace xt
 
     namespace detail
     {
-
-        template <bool lvalue>
-        struct lambda_isin
-        {
-            template <class E>
-            static auto make(E&& e)
-            {
-                return [&e](const auto& t) { return std::find(e.begin(), e.end(), t) != e.end(); };
-            }
-        };
-
-        template <>
-        struct lambda_isin<false>
+        // Key type of the set of test elements, so that elements comparing
+        // equal have the same hash
+        template <class E, class T>
+        using isin_key_type = std::common_type_t<typename std::decay_t<E>::value_type, std::decay_t<T>>;
+
+        // The hash set is shared by the copies of the returned functor
+        template <class K, class It>
+        inline auto make_isin_lambda(It first, It last)
         {
-            template <class E>
-            static auto make(E&& e)
+            auto set = std::make_shared<hash_set<K>>();
+            for (; first != last; ++first)
             {
-                return [e](const auto& t) { return std::find(e.begin(), e.end(), t) != e.end(); };
+                set->insert(static_cast<K>(*first));
             }
-        };
-
+            return [set](const auto& t) { return set->contains(static_cast<K>(t)); };
+        }
     }
 
     /**
@@ -56,16 +54,17 @@ namespace xt
     * @brief isin
     *
     * Returns a boolean array of the same shape as ``element`` that is ``true`` where an element of
-    * ``element`` is in ``test_elements`` and ``False`` otherwise.
+    * ``element`` is in ``test_elements`` and ``False`` otherwise. The test elements are copied in a
+    * hash set when the function is called, so that each lookup takes constant time.
     * @param element an \ref xexpression
     * @param test_elements an array
     * @return a boolean array
     */
     template <class E, class T>
-    inline auto isin(E&& element, std::initializer_list<T> test_elements) noexcept
+    inline auto isin(E&& element, std::initializer_list<T> test_elements)
     {
-        auto lambda = [test_elements](const auto& t) {
-            return std::find(test_elements.begin(), test_elements.end(), t) != test_elements.end(); };
+        using key_type = detail::isin_key_type<E, T>;
+        auto lambda = detail::make_isin_lambda<key_type>(test_elements.begin(), test_elements.end());
         return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
     }
 
@@ -74,15 +73,17 @@ namespace xt
     * @brief isin
     *
     * Returns a boolean array of the same shape as ``element`` that is ``true`` where an element of
-    * ``element`` is in ``test_elements`` and ``False`` otherwise.
+    * ``element`` is in ``test_elements`` and ``False`` otherwise. The test elements are copied in a
+    * hash set when the function is called, so that each lookup takes constant time.
     * @param element an \ref xexpression
     * @param test_elements an array
     * @return a boolean array
     */
     template <class E, class F, class = typename std::enable_if_t<has_iterator_interface<F>::value>>
-    inline auto isin(E&& element, F&& test_elements) noexcept
+    inline auto isin(E&& element, F&& test_elements)
     {
-        auto lambda = detail::lambda_isin<std::is_lvalue_reference<F>::value>::make(std::forward<F>(test_elements));
+        using key_type = detail::isin_key_type<E, decltype(*test_elements.begin())>;
+        auto lambda = detail::make_isin_lambda<key_type>(test_elements.begin(), test_elements.end());
         return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
     }
 
@@ -91,17 +92,18 @@ namespace xt
     * @brief isin
     *
     * Returns a boolean array of the same shape as ``element`` that is ``true`` where an element of
-    * ``element`` is in ``test_elements`` and ``False`` otherwise.
+    * ``element`` is in ``test_elements`` and ``False`` otherwise. The test elements are copied in a
+    * hash set when the function is called, so that each lookup takes constant time.
     * @param element an \ref xexpression
     * @param test_elements_begin iterator to the beginning of an array
     * @param test_elements_end iterator to the end of an array
     * @return a boolean array
     */
     template <class E, class I, class = typename std::enable_if_t<is_iterator<I>::value>>
-    inline auto isin(E&& element, I&& test_elements_begin, I&& test_elements_end) noexcept
+    inline auto isin(E&& element, I&& test_elements_begin, I&& test_elements_end)
     {
-        auto lambda = [&test_elements_begin, &test_elements_end](const auto& t) {
-            return std::find(test_elements_begin, test_elements_end, t) != test_elements_end; };
+        using key_type = detail::isin_key_type<E, decltype(*test_elements_begin)>;
+        auto lambda = detail::make_isin_lambda<key_type>(test_elements_begin, test_elements_end);
         return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
     }
 
@@ -116,7 +118,7 @@ namespace xt
     * @return a boolean array
     */
     template <class E, class T>
-    inline auto in1d(E&& element, std::initializer_list<T> test_elements) noexcept
+    inline auto in1d(E&& element, std::initializer_list<T> test_elements)
     {
         XTENSOR_ASSERT(element.dimension() == 1ul);
         return isin(std::forward<E>(element), std::forward<std::initializer_list<T>>(test_elements));
@@ -133,7 +135,7 @@ namespace xt
     * @return a boolean array
     */
     template <class E, class F, class = typename std::enable_if_t<has_iterator_interface<F>::value>>
-    inline auto in1d(E&& element, F&& test_elements) noexcept
+    inline auto in1d(E&& element, F&& test_elements)
     {
         XTENSOR_ASSERT(element.dimension() == 1ul);
         XTENSOR_ASSERT(test_elements.dimension() == 1ul);
@@ -152,47 +154,89 @@ namespace xt
     * @return a boolean array
     */
     template <class E, class I, class = typename std::enable_if_t<is_iterator<I>::value>>
-    inline auto in1d(E&& element, I&& test_elements_begin, I&& test_elements_end) noexcept
+    inline auto in1d(E&& element, I&& test_elements_begin, I&& test_elements_end)
     {
         XTENSOR_ASSERT(element.dimension() == 1ul);
         return isin(std::forward<E>(element), std::forward<I>(test_elements_begin), std::forward<I>(test_elements_end));
     }
 
+    namespace detail
+    {
+        template <class E>
+        struct is_sorted_index : std::false_type
+        {
+        };
+
+        template <class T>
+        struct is_sorted_index<xsorted_index<T>> : std::true_type
+        {
+        };
+
+        template <bool Right, class T, class E, class R>
+        inline void searchsorted_impl(const T* a, std::size_t n, const E& v, R& out)
+        {
+            auto out_it = out.begin();
+            for_each_search<Right>(a, n, v.cbegin(), v.cend(), [&out_it](std::size_t, const auto&, std::size_t p) {
+                *out_it++ = p;
+            });
+        }
+    }
+
     /**
      * @ingroup searchsorted
      * @brief Find indices where elements should be inserted to maintain order.
      *
+     * The values are searched by batches with a branchless binary search.
+     * When the same sorted array is searched many times, an xsorted_index
+     * built once can be given instead of \c a.
+     *
      * @param a Input array: sorted (array_like).
      * @param v Values to insert into a (array_like).
      * @param right If ``false``, the index of the first suitable location found is given.
      * @return Array of insertion points with the same shape as v.
      */
-    template <class E1, class E2>
+    template <class E1, class E2, class = std::enable_if_t<!detail::is_sorted_index<std::decay_t<E1>>::value>>
     inline auto searchsorted(E1&& a, E2&& v, bool right = true)
     {
         XTENSOR_ASSERT(std::is_sorted(a.cbegin(), a.cend()));
 
         auto out = xt::empty<size_t>(v.shape());
+        detail::apply_on_contiguous(a, [&](const auto* data, std::size_t n) {
+            if (right)
+            {
+                detail::searchsorted_impl<false>(data, n, v, out);
+            }
+            else
+            {
+                detail::searchsorted_impl<true>(data, n, v, out);
+            }
+        });
+        return out;
+    }
 
+    /**
+     * @ingroup searchsorted
+     * @brief Find indices where elements should be inserted to maintain order.
+     *
+     * @param index Index of the sorted array, see make_sorted_index.
+     * @param v Values to insert into the sorted array (array_like).
+     * @param right If ``false``, the index of the first suitable location found is given.
+     * @return Array of insertion points with the same shape as v.
+     */
+    template <class T, class E2>
+    inline auto searchsorted(const xsorted_index<T>& index, E2&& v, bool right = true)
+    {
+        auto out = xt::empty<size_t>(v.shape());
         if (right)
         {
-            for (size_t i = 0; i < v.size(); ++i)
-            {
-                out(i) = static_cast<std::size_t>(std::lower_bound(a.cbegin(), a.cend(), v(i)) - a.cbegin());
-            }
+            std::transform(v.cbegin(), v.cend(), out.begin(), [&index](const auto& x) { return index.lower_bound(x); });
         }
         else
         {
-            for (size_t i = 0; i < v.size(); ++i)
-            {
-                out(i) = static_cast<std::size_t>(std::upper_bound(a.cbegin(), a.cend(), v(i)) - a.cbegin());
-            }
+            std::transform(v.cbegin(), v.cend(), out.begin(), [&index](const auto& x) { return index.upper_bound(x); });
         }
-
-
         return out;
     }
-
 }
 
 #endif
@@ -26,7 +26,7 @@
 namespace xt
 {
     template <class T>
-    using dynamic_shape = svector<T, 4>;
+    using dynamic_shape = svector<T, XTENSOR_SHAPE_INLINE_CAPACITY>;
 
     template <class T, std::size_t N>
     using static_shape = std::array<T, N>;
@@ -0,0 +1,501 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SHARED_MEMORY_HPP
+#define XTENSOR_SHARED_MEMORY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define XTENSOR_HAS_SHARED_MEMORY
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define XTENSOR_HAS_MEMFD
+#endif
+#endif
+
+#include "xadapt.hpp"
+#include "xexception.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+    /**
+     * Access mode of an attached shared memory segment.
+     */
+    enum class shm_mode
+    {
+        /**
+         * The segment is mapped read-only, writing to it is undefined behavior.
+         */
+        read_only,
+        /**
+         * The segment can be modified, the changes are seen by all the
+         * processes mapping it.
+         */
+        read_write
+    };
+
+    /******************
+     * xshared_memory *
+     ******************/
+
+    /**
+     * @class xshared_memory
+     * @brief Memory segment shared between processes.
+     *
+     * The segment is either a named POSIX shared memory object, which
+     * other processes attach with the same name, or, on Linux, an
+     * anonymous memfd, which is inherited by forked processes or sent
+     * to other processes as a file descriptor over a Unix socket. The
+     * segment is unmapped on destruction; a named segment persists until
+     * it is removed with remove(), even when no process maps it.
+     * Shared memory is available on POSIX systems.
+     */
+    class xshared_memory
+    {
+    public:
+
+        xshared_memory(const std::string& name, std::size_t size);
+        explicit xshared_memory(std::size_t size);
+        xshared_memory(const std::string& name, shm_mode mode);
+        xshared_memory(int fd, shm_mode mode);
+        ~xshared_memory();
+
+        xshared_memory(const xshared_memory&) = delete;
+        xshared_memory& operator=(const xshared_memory&) = delete;
+
+        char* data() const noexcept;
+        std::size_t size() const noexcept;
+        int fd() const noexcept;
+        shm_mode mode() const noexcept;
+
+        static void remove(const std::string& name);
+
+    private:
+
+        void map(shm_mode mode);
+
+        void* m_addr;
+        std::size_t m_size;
+        int m_fd;
+        shm_mode m_mode;
+    };
+
+    /*************************
+     * shared array adaptors *
+     *************************/
+
+    template <class T, class S>
+    std::size_t shared_array_bytes(const S& shape);
+
+    template <class T, class S>
+    auto adapt_shared_array(std::shared_ptr<xshared_memory> segment, const S& shape,
+                            layout_type l = XTENSOR_DEFAULT_LAYOUT);
+
+    template <class T, layout_type L = layout_type::dynamic>
+    auto attach_shared_array(std::shared_ptr<xshared_memory> segment);
+
+    template <class T, class S>
+    auto create_shared_array(const std::string& name, const S& shape, layout_type l = XTENSOR_DEFAULT_LAYOUT);
+
+    template <class T, class I, std::size_t N>
+    auto create_shared_array(const std::string& name, const I (&shape)[N], layout_type l = XTENSOR_DEFAULT_LAYOUT);
+
+    template <class T, layout_type L = layout_type::dynamic>
+    auto attach_shared_array(const std::string& name, shm_mode mode = shm_mode::read_only);
+
+    /*********************************
+     * xshared_memory implementation *
+     *********************************/
+
+#if defined(XTENSOR_HAS_SHARED_MEMORY)
+    /**
+     * Creates the named segment \c name of \c size bytes, initially zero.
+     * The name starts with a slash, e.g. "/reference_weights", and must
+     * not exist yet.
+     */
+    inline xshared_memory::xshared_memory(const std::string& name, std::size_t size)
+        : m_addr(nullptr), m_size(size), m_fd(-1), m_mode(shm_mode::read_write)
+    {
+        m_fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (m_fd == -1)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to create segment " + name);
+        }
+        if (::ftruncate(m_fd, static_cast<off_t>(size)) == -1)
+        {
+            ::close(m_fd);
+            ::shm_unlink(name.c_str());
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to resize segment " + name);
+        }
+        map(shm_mode::read_write);
+    }
+
+    /**
+     * Creates an anonymous segment of \c size bytes, initially zero,
+     * backed by a memfd. The segment is released once all the processes
+     * have unmapped it and closed its file descriptor.
+     * Anonymous segments are available on Linux.
+     */
+    inline xshared_memory::xshared_memory(std::size_t size)
+        : m_addr(nullptr), m_size(size), m_fd(-1), m_mode(shm_mode::read_write)
+    {
+#if defined(XTENSOR_HAS_MEMFD)
+        m_fd = ::memfd_create("xtensor", MFD_CLOEXEC);
+        if (m_fd == -1)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to create anonymous segment");
+        }
+        if (::ftruncate(m_fd, static_cast<off_t>(size)) == -1)
+        {
+            ::close(m_fd);
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to resize anonymous segment");
+        }
+        map(shm_mode::read_write);
+#else
+        XTENSOR_THROW(std::runtime_error, "shared memory: anonymous segments are not supported on this platform");
+#endif
+    }
+
+    /**
+     * Attaches the existing named segment \c name.
+     */
+    inline xshared_memory::xshared_memory(const std::string& name, shm_mode mode)
+        : m_addr(nullptr), m_size(0), m_fd(-1), m_mode(mode)
+    {
+        m_fd = ::shm_open(name.c_str(), mode == shm_mode::read_only ? O_RDONLY : O_RDWR, 0);
+        if (m_fd == -1)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to open segment " + name);
+        }
+        map(mode);
+    }
+
+    /**
+     * Attaches the segment of the file descriptor \c fd, e.g. received
+     * from the process which created an anonymous segment. The file
+     * descriptor is duplicated, the caller keeps ownership of \c fd.
+     */
+    inline xshared_memory::xshared_memory(int fd, shm_mode mode)
+        : m_addr(nullptr), m_size(0), m_fd(-1), m_mode(mode)
+    {
+        m_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (m_fd == -1)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: invalid file descriptor");
+        }
+        map(mode);
+    }
+
+    inline xshared_memory::~xshared_memory()
+    {
+        if (m_addr != nullptr)
+        {
+            ::munmap(m_addr, m_size);
+        }
+        ::close(m_fd);
+    }
+
+    /**
+     * Removes the named segment \c name. The processes which mapped it
+     * keep their mapping, the memory is released with the last one.
+     */
+    inline void xshared_memory::remove(const std::string& name)
+    {
+        if (::shm_unlink(name.c_str()) == -1)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to remove segment " + name);
+        }
+    }
+
+    // Maps the whole segment, whose size is read from the file descriptor
+    // when it is attached
+    inline void xshared_memory::map(shm_mode mode)
+    {
+        struct stat st;
+        if (::fstat(m_fd, &st) == -1 || st.st_size <= 0)
+        {
+            ::close(m_fd);
+            XTENSOR_THROW(std::runtime_error, "shared memory: empty segment");
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        int prot = mode == shm_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* addr = ::mmap(nullptr, m_size, prot, MAP_SHARED, m_fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            ::close(m_fd);
+            XTENSOR_THROW(std::runtime_error, "shared memory: failed to map segment in memory");
+        }
+        m_addr = addr;
+    }
+#else
+    inline xshared_memory::xshared_memory(const std::string& /*name*/, std::size_t /*size*/)
+        : m_addr(nullptr), m_size(0), m_fd(-1), m_mode(shm_mode::read_write)
+    {
+        XTENSOR_THROW(std::runtime_error, "shared memory is not supported on this platform");
+    }
+
+    inline xshared_memory::xshared_memory(std::size_t /*size*/)
+        : m_addr(nullptr), m_size(0), m_fd(-1), m_mode(shm_mode::read_write)
+    {
+        XTENSOR_THROW(std::runtime_error, "shared memory is not supported on this platform");
+    }
+
+    inline xshared_memory::xshared_memory(const std::string& /*name*/, shm_mode mode)
+        : m_addr(nullptr), m_size(0), m_fd(-1), m_mode(mode)
+    {
+        XTENSOR_THROW(std::runtime_error, "shared memory is not supported on this platform");
+    }
+
+    inline xshared_memory::xshared_memory(int /*fd*/, shm_mode mode)
+        : m_addr(nullptr), m_size(0), m_fd(-1), m_mode(mode)
+    {
+        XTENSOR_THROW(std::runtime_error, "shared memory is not supported on this platform");
+    }
+
+    inline xshared_memory::~xshared_memory()
+    {
+    }
+
+    inline void xshared_memory::remove(const std::string& /*name*/)
+    {
+        XTENSOR_THROW(std::runtime_error, "shared memory is not supported on this platform");
+    }
+
+    inline void xshared_memory::map(shm_mode /*mode*/)
+    {
+    }
+#endif
+
+    inline char* xshared_memory::data() const noexcept
+    {
+        return static_cast<char*>(m_addr);
+    }
+
+    inline std::size_t xshared_memory::size() const noexcept
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the file descriptor of the segment, which can be sent to
+     * another process to attach an anonymous segment.
+     */
+    inline int xshared_memory::fd() const noexcept
+    {
+        return m_fd;
+    }
+
+    inline shm_mode xshared_memory::mode() const noexcept
+    {
+        return m_mode;
+    }
+
+    /****************************************
+     * shared array adaptors implementation *
+     ****************************************/
+
+    namespace detail
+    {
+        // The segment of a shared array starts with a header describing
+        // the array, so that the processes attaching it only need its
+        // name. The magic number is written last, once the header is
+        // complete.
+        constexpr std::uint64_t shared_array_magic = 0x7874656e736f7231ULL;
+        constexpr std::size_t shared_array_alignment = 64;
+
+        struct shared_array_header
+        {
+            std::uint64_t magic;
+            std::uint64_t value_size;
+            std::uint64_t value_kind;
+            std::uint64_t layout;
+            std::uint64_t dimension;
+            std::uint64_t data_offset;
+        };
+
+        template <class T>
+        constexpr std::uint64_t shared_array_value_kind()
+        {
+            return (std::is_floating_point<T>::value ? 1u : 0u) |
+                   (std::is_integral<T>::value ? 2u : 0u) |
+                   (std::is_signed<T>::value ? 4u : 0u);
+        }
+
+        inline std::size_t shared_array_offset(std::size_t dimension)
+        {
+            std::size_t header = sizeof(shared_array_header) + dimension * sizeof(std::uint64_t);
+            return (header + shared_array_alignment - 1) / shared_array_alignment * shared_array_alignment;
+        }
+
+        inline std::uint64_t* shared_array_shape(shared_array_header* header)
+        {
+            return reinterpret_cast<std::uint64_t*>(header + 1);
+        }
+    }
+
+    /**
+     * Returns the size in bytes of the shared memory segment holding an
+     * array of value type \c T and shape \c shape, header included.
+     */
+    template <class T, class S>
+    inline std::size_t shared_array_bytes(const S& shape)
+    {
+        std::size_t dimension = static_cast<std::size_t>(std::distance(std::begin(shape), std::end(shape)));
+        return detail::shared_array_offset(dimension) + compute_size(shape) * sizeof(T);
+    }
+
+    /**
+     * Lays out an array of value type \c T and shape \c shape in the
+     * shared memory \c segment, which must hold shared_array_bytes<T>(shape)
+     * bytes, and returns an xarray_adaptor on its elements. The segment
+     * stays mapped as long as a copy of the adaptor exists.
+     *
+     * @param segment The shared memory, mapped read-write
+     * @param shape The shape of the array
+     * @param l The layout of the array [default: XTENSOR_DEFAULT_LAYOUT]
+     * @tparam T the value type of the array, trivially copyable
+     * @return xarray_adaptor on the elements of the array, initially zero
+     *         if the segment was just created
+     */
+    template <class T, class S>
+    inline auto adapt_shared_array(std::shared_ptr<xshared_memory> segment, const S& shape, layout_type l)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "shared arrays require trivially copyable values");
+        if (l != layout_type::row_major && l != layout_type::column_major)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared arrays can only be row_major or column_major.");
+        }
+        std::vector<std::size_t> sh(std::begin(shape), std::end(shape));
+        if (segment->mode() != shm_mode::read_write || segment->size() < shared_array_bytes<T>(sh))
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: segment too small or read-only");
+        }
+        auto* header = reinterpret_cast<detail::shared_array_header*>(segment->data());
+        header->value_size = sizeof(T);
+        header->value_kind = detail::shared_array_value_kind<T>();
+        header->layout = static_cast<std::uint64_t>(l);
+        header->dimension = sh.size();
+        header->data_offset = detail::shared_array_offset(sh.size());
+        std::copy(sh.cbegin(), sh.cend(), detail::shared_array_shape(header));
+        header->magic = detail::shared_array_magic;
+
+        T* ptr = reinterpret_cast<T*>(segment->data() + header->data_offset);
+        return adapt_smart_ptr<layout_type::dynamic>(std::move(ptr), sh, std::move(segment), l);
+    }
+
+    /**
+     * Returns an xarray_adaptor on the array laid out in the shared memory
+     * \c segment by another process, without copying its elements.
+     *
+     * @param segment The shared memory holding the array
+     * @tparam T the value type of the array, which must match the one of
+     *           the process which created the array
+     * @tparam L the static layout of the adaptor [default: dynamic]
+     * @return xarray_adaptor on the elements of the array; they must not
+     *         be modified if the segment is mapped read-only
+     */
+    template <class T, layout_type L>
+    inline auto attach_shared_array(std::shared_ptr<xshared_memory> segment)
+    {
+        if (segment->size() < sizeof(detail::shared_array_header))
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: not a shared array");
+        }
+        auto* header = reinterpret_cast<detail::shared_array_header*>(segment->data());
+        if (header->magic != detail::shared_array_magic)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: not a shared array");
+        }
+        if (header->value_size != sizeof(T) || header->value_kind != detail::shared_array_value_kind<T>())
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: value type mismatch");
+        }
+        layout_type l = static_cast<layout_type>(header->layout);
+        if (L != layout_type::dynamic && L != l)
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: layout mismatch");
+        }
+        const std::uint64_t* first = detail::shared_array_shape(header);
+        std::vector<std::size_t> sh(first, first + header->dimension);
+        if (segment->size() < shared_array_bytes<T>(sh))
+        {
+            XTENSOR_THROW(std::runtime_error, "shared memory: segment too small");
+        }
+
+        T* ptr = reinterpret_cast<T*>(segment->data() + header->data_offset);
+        return adapt_smart_ptr<L>(std::move(ptr), sh, std::move(segment), l);
+    }
+
+    /**
+     * Creates the named shared memory segment \c name and returns an
+     * xarray_adaptor on the array of shape \c shape it holds, initially
+     * zero. Once filled, the array is attached by the other processes
+     * with attach_shared_array, without copy. The segment persists until
+     * it is removed with xshared_memory::remove.
+     *
+     * \code{.cpp}
+     * // loader process
+     * auto w = xt::create_shared_array<float>("/weights", {n_rows, n_cols});
+     * w = xt::load_npy<float>("weights.npy");
+     * // worker processes
+     * auto w = xt::attach_shared_array<float>("/weights");
+     * \endcode
+     *
+     * @param name The name of the segment, starting with a slash
+     * @param shape The shape of the array
+     * @param l The layout of the array [default: XTENSOR_DEFAULT_LAYOUT]
+     * @tparam T the value type of the array
+     * @return xarray_adaptor on the elements of the array
+     */
+    template <class T, class S>
+    inline auto create_shared_array(const std::string& name, const S& shape, layout_type l)
+    {
+        auto segment = std::make_shared<xshared_memory>(name, shared_array_bytes<T>(shape));
+        return adapt_shared_array<T>(std::move(segment), shape, l);
+    }
+
+    template <class T, class I, std::size_t N>
+    inline auto create_shared_array(const std::string& name, const I (&shape)[N], layout_type l)
+    {
+        std::array<std::size_t, N> sh;
+        std::copy(shape, shape + N, sh.begin());
+        return create_shared_array<T>(name, sh, l);
+    }
+
+    /**
+     * Attaches the array held by the named shared memory segment \c name.
+     *
+     * @param name The name of the segment
+     * @param mode The access mode [default: shm_mode::read_only]
+     * @tparam T the value type of the array
+     * @tparam L the static layout of the adaptor [default: dynamic]
+     * @return xarray_adaptor on the elements of the array
+     */
+    template <class T, layout_type L>
+    inline auto attach_shared_array(const std::string& name, shm_mode mode)
+    {
+        return attach_shared_array<T, L>(std::make_shared<xshared_memory>(name, mode));
+    }
+}
+
+#endif
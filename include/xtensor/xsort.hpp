@@ -11,115 +11,684 @@
 #define XTENSOR_SORT_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
 #include <utility>
+#include <vector>
 
+#include "xarena.hpp"
 #include "xarray.hpp"
 #include "xeval.hpp"
+#include "xexecution.hpp"
+#include "xhash_set.hpp"
 #include "xslice.hpp"  // for xnone
 #include "xmanipulation.hpp"
+#include "xsorted_index.hpp"
 #include "xtensor.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 
 namespace xt
 {
     namespace detail
     {
-        template <class T>
-        std::ptrdiff_t adjust_secondary_stride(std::ptrdiff_t stride, T shape)
+        /*********************
+         * axis lane kernels *
+         *********************/
+
+        // Lanes that are not contiguous in memory are gathered by blocks of
+        // this many consecutive lanes, so that the input is read by rows of
+        // the block instead of one element per cache line.
+        constexpr std::size_t sort_lane_block = 16;
+
+        // A dense container seen as outer x n x inner in memory order, where
+        // n is the length of the lanes along the processed axis.
+        struct sort_lanes
+        {
+            std::size_t outer;
+            std::size_t n;
+            std::size_t inner;
+        };
+
+        template <class E>
+        inline sort_lanes get_sort_lanes(const E& e, std::size_t axis)
         {
-            return stride != 0 ? stride : static_cast<std::ptrdiff_t>(shape);
+            auto shape_begin = e.shape().cbegin();
+            auto axis_it = shape_begin + std::ptrdiff_t(axis);
+            std::size_t n = static_cast<std::size_t>(e.shape()[axis]);
+            std::size_t before = std::accumulate(shape_begin, axis_it, std::size_t(1), std::multiplies<>());
+            std::size_t after = std::accumulate(axis_it + 1, e.shape().cend(), std::size_t(1), std::multiplies<>());
+            if (e.layout() == layout_type::row_major)
+            {
+                return {before, n, after};
+            }
+            else if (e.layout() == layout_type::column_major)
+            {
+                return {after, n, before};
+            }
+            XTENSOR_THROW(std::runtime_error, "Layout not supported.");
         }
 
-        template <class E, class F>
-        inline void call_over_leading_axis(E& ev, F&& fct)
+        inline bool use_parallel_sort(std::size_t n_tasks, std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            return n_tasks >= 2 && size >= exec::default_threshold();
+#else
+            (void) n_tasks;
+            (void) size;
+            return false;
+#endif
+        }
+
+        // Runs f(begin, end) over the n_tasks tasks of a sorting function
+        // processing size elements. The default policy only goes parallel
+        // with enough work, as for the assignment loops.
+        template <class P, class F>
+        inline void run_sort_tasks(const P& policy, std::size_t n_tasks, std::size_t /*size*/, F&& f)
         {
-            std::size_t n_iters = 1;
-            std::ptrdiff_t secondary_stride;
+            policy.for_range(std::size_t(0), n_tasks, std::size_t(1), std::forward<F>(f));
+        }
 
-            if (ev.layout() == layout_type::row_major)
+        template <class F>
+        inline void run_sort_tasks(const exec::default_policy& policy, std::size_t n_tasks, std::size_t size, F&& f)
+        {
+            if (use_parallel_sort(n_tasks, size))
             {
-                n_iters = std::accumulate(ev.shape().begin(), ev.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                secondary_stride = adjust_secondary_stride(ev.strides()[ev.dimension() - 2],
-                                                           *(ev.shape().end() - 1));
+                policy.for_range(std::size_t(0), n_tasks, std::size_t(1), std::forward<F>(f));
             }
             else
             {
-                n_iters = std::accumulate(ev.shape().begin() + 1, ev.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                secondary_stride = adjust_secondary_stride(ev.strides()[1],
-                                                           *(ev.shape().begin()));
+                f(std::size_t(0), n_tasks);
             }
+        }
 
-            std::ptrdiff_t offset = 0;
+        // Calls f(buffer, o, j, width) for the blocks of width lanes starting
+        // at lane j of the outer slice o. Blocks may be processed in parallel,
+        // each thread having its own default constructed buffer.
+        template <class B, class F, class P>
+        inline void for_each_lane_block(const sort_lanes& l, F&& f, const P& policy)
+        {
+            std::size_t width = l.inner == 1 ? 1 : sort_lane_block;
+            std::size_t n_groups = (l.inner + width - 1) / width;
+            run_sort_tasks(policy, l.outer * n_groups, l.outer * l.n * l.inner, [&](std::size_t begin, std::size_t end)
+            {
+                B buffer;
+                for (std::size_t t = begin; t < end; ++t)
+                {
+                    std::size_t o = t / n_groups;
+                    std::size_t j = (t % n_groups) * width;
+                    f(buffer, o, j, (std::min)(width, l.inner - j));
+                }
+            });
+        }
 
-            for (std::size_t i = 0; i < n_iters; ++i, offset += secondary_stride)
+        template <class B>
+        inline void reserve_lane_buffer(B& buffer, std::size_t size)
+        {
+            if (buffer.size() != size)
             {
-                fct(ev.data() + offset, ev.data() + offset + secondary_stride);
+                buffer.resize(size);
             }
         }
 
-        template <class E>
-        inline std::size_t leading_axis(const E& e)
+        // Copies width lanes of length n and stride inner to consecutive
+        // segments of buf
+        template <class T, class U>
+        inline void gather_lanes(const T* first, std::size_t n, std::size_t inner, std::size_t width, U* buf)
         {
-            if (e.layout() == layout_type::row_major)
+            for (std::size_t k = 0; k < n; ++k, first += inner)
             {
-                return e.dimension() - 1;
+                for (std::size_t b = 0; b < width; ++b)
+                {
+                    buf[b * n + k] = first[b];
+                }
             }
-            else if (e.layout() == layout_type::column_major)
+        }
+
+        template <class T, class U>
+        inline void scatter_lanes(const T* buf, std::size_t n, std::size_t inner, std::size_t width, U* first)
+        {
+            for (std::size_t k = 0; k < n; ++k, first += inner)
             {
-                return 0;
+                for (std::size_t b = 0; b < width; ++b)
+                {
+                    first[b] = buf[b * n + k];
+                }
             }
-            XTENSOR_THROW(std::runtime_error, "Layout not supported.");
         }
 
-        // get permutations to transpose and reverse-transpose array
-        inline std::pair<dynamic_shape<std::size_t>, dynamic_shape<std::size_t>>
-        get_permutations(std::size_t dim, std::size_t ax, layout_type layout)
+        // Applies f(begin, end) in place to each lane of the dense container
+        // ev along axis. Contiguous lanes are processed in place, the other
+        // ones are gathered into a small buffer and scattered back.
+        template <class E, class F, class P = exec::default_policy>
+        inline void call_over_axis(E& ev, std::size_t axis, F&& f, const P& policy = P())
+        {
+            using value_type = typename E::value_type;
+            using buffer_type = arena_uvector<value_type>;
+            sort_lanes l = get_sort_lanes(ev, axis);
+            auto* data = ev.data();
+            for_each_lane_block<buffer_type>(l, [&](buffer_type& buffer, std::size_t o, std::size_t j, std::size_t width)
+            {
+                auto* first = data + (o * l.n * l.inner + j);
+                if (l.inner == 1)
+                {
+                    f(first, first + l.n);
+                }
+                else
+                {
+                    reserve_lane_buffer(buffer, sort_lane_block * l.n);
+                    gather_lanes(first, l.n, l.inner, width, buffer.data());
+                    for (std::size_t b = 0; b < width; ++b)
+                    {
+                        f(buffer.data() + b * l.n, buffer.data() + (b + 1) * l.n);
+                    }
+                    scatter_lanes(buffer.data(), l.n, l.inner, width, first);
+                }
+            }, policy);
+        }
+
+        // Calls f(values, indices, n) for each lane of the dense container
+        // data along axis; f fills the n indices of the lane, which are
+        // stored at the same positions in inds. data and inds must have the
+        // same shape and layout.
+        template <class Ed, class Ei, class F, class P = exec::default_policy>
+        inline void argcall_over_axis(const Ed& data, Ei& inds, std::size_t axis, F&& f, const P& policy = P())
+        {
+            using value_type = typename Ed::value_type;
+            using index_type = typename Ei::value_type;
+            using buffer_type = std::pair<arena_uvector<value_type>, arena_uvector<index_type>>;
+            sort_lanes l = get_sort_lanes(data, axis);
+            const value_type* in = data.data();
+            index_type* out = inds.data();
+            for_each_lane_block<buffer_type>(l, [&](buffer_type& buffer, std::size_t o, std::size_t j, std::size_t width)
+            {
+                std::size_t offset = o * l.n * l.inner + j;
+                if (l.inner == 1)
+                {
+                    f(in + offset, out + offset, l.n);
+                }
+                else
+                {
+                    reserve_lane_buffer(buffer.first, sort_lane_block * l.n);
+                    reserve_lane_buffer(buffer.second, sort_lane_block * l.n);
+                    gather_lanes(in + offset, l.n, l.inner, width, buffer.first.data());
+                    for (std::size_t b = 0; b < width; ++b)
+                    {
+                        f(buffer.first.data() + b * l.n, buffer.second.data() + b * l.n, l.n);
+                    }
+                    scatter_lanes(buffer.second.data(), l.n, l.inner, width, out + offset);
+                }
+            }, policy);
+        }
+
+        // Calls f(begin, end, p) with a copy of each lane of the dense
+        // container data along axis, that f can reorder. p is the index of
+        // the lane in a container of the layout of data whose shape is the
+        // one of data without axis.
+        template <class Ed, class F, class P = exec::default_policy>
+        inline void call_over_lane_copies(const Ed& data, std::size_t axis, F&& f, const P& policy = P())
+        {
+            using value_type = typename Ed::value_type;
+            using buffer_type = arena_uvector<value_type>;
+            sort_lanes l = get_sort_lanes(data, axis);
+            const value_type* in = data.data();
+            for_each_lane_block<buffer_type>(l, [&](buffer_type& buffer, std::size_t o, std::size_t j, std::size_t width)
+            {
+                reserve_lane_buffer(buffer, sort_lane_block * l.n);
+                gather_lanes(in + (o * l.n * l.inner + j), l.n, l.inner, width, buffer.data());
+                for (std::size_t b = 0; b < width; ++b)
+                {
+                    f(buffer.data() + b * l.n, buffer.data() + (b + 1) * l.n, o * l.inner + j + b);
+                }
+            }, policy);
+        }
+
+        // Stores f(begin, end) for each lane of the dense container data
+        // along axis into res, whose shape is the one of data without axis
+        // and whose layout is the one of data. f is given a copy of the lane
+        // that it can reorder.
+        template <class Ed, class R, class F, class P = exec::default_policy>
+        inline void reduce_over_axis(const Ed& data, R& res, std::size_t axis, F&& f, const P& policy = P())
         {
-            dynamic_shape<std::size_t> permutation(dim);
-            std::iota(permutation.begin(), permutation.end(), std::size_t(0));
-            permutation.erase(permutation.begin() + std::ptrdiff_t(ax));
+            using value_type = typename Ed::value_type;
+            auto* out = res.data();
+            call_over_lane_copies(data, axis, [out, &f](value_type* begin, value_type* end, std::size_t p)
+            {
+                out[p] = f(begin, end);
+            }, policy);
+        }
 
-            if (layout == layout_type::row_major)
+        // Ranges holding several ranks below this length are sorted, which
+        // places all their ranks at once.
+        constexpr std::size_t select_sort_threshold = 32;
+
+        // Places the elements of the sorted positions of the increasing
+        // unique ranks rfirst, ..., rlast as in a sorted lane; offset is the
+        // sorted position of begin. Each selection splits the range and the
+        // ranks, so that m ranks cost O(n log(m)) comparisons in a single
+        // recursion, instead of O(n m) for m successive selections.
+        template <class It, class RIt, class F>
+        inline void select_ranks(It begin, It end, RIt rfirst, RIt rlast, std::size_t offset, F& comp)
+        {
+            while (rfirst != rlast)
             {
-                permutation.push_back(ax);
+                if (rlast - rfirst > 1 && std::size_t(end - begin) <= select_sort_threshold)
+                {
+                    std::sort(begin, end, comp);
+                    return;
+                }
+                RIt rmid = rfirst + (rlast - rfirst) / 2;
+                It nth = begin + std::ptrdiff_t(*rmid - offset);
+                std::nth_element(begin, nth, end, comp);
+                select_ranks(begin, nth, rfirst, rmid, offset, comp);
+                begin = nth + 1;
+                offset = *rmid + 1;
+                rfirst = rmid + 1;
             }
-            else
+        }
+
+        template <class It, class RIt>
+        inline void select_ranks(It begin, It end, RIt rfirst, RIt rlast, std::size_t offset)
+        {
+            std::less<> comp;
+            select_ranks(begin, end, rfirst, rlast, offset, comp);
+        }
+
+        // Sorted unique copy of the kth positions of a partition
+        template <class C>
+        inline std::vector<std::size_t> partition_ranks(const C& kth_container)
+        {
+            std::vector<std::size_t> ranks(std::begin(kth_container), std::end(kth_container));
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+            return ranks;
+        }
+
+        // Orders (value, position) pairs by comp on the values, then by
+        // position, so that the selection of equal values is deterministic.
+        template <class C>
+        struct select_compare
+        {
+            C comp;
+
+            template <class T>
+            bool operator()(const T& a, const T& b) const
+            {
+                return comp(a.first, b.first) || (!comp(b.first, a.first) && a.second < b.second);
+            }
+        };
+
+        // Offers the element v at position i to the heap of the k best elements
+        // seen so far, whose top is the worst of them. Positions are offered in
+        // increasing order, so v only replaces the top if it is strictly better.
+        template <class T, class C>
+        inline void select_push(std::pair<T, std::size_t>* heap, std::size_t& size, std::size_t k,
+                                const T& v, std::size_t i, const select_compare<C>& comp)
+        {
+            if (size < k)
+            {
+                heap[size++] = std::make_pair(v, i);
+                std::push_heap(heap, heap + size, comp);
+            }
+            else if (comp.comp(v, heap->first))
+            {
+                std::pop_heap(heap, heap + k, comp);
+                heap[k - 1] = std::make_pair(v, i);
+                std::push_heap(heap, heap + k, comp);
+            }
+        }
+
+        // Selects the k first elements, in the order defined by comp, of each
+        // lane of the dense container data along axis, and calls f(offset,
+        // stride, best) where best holds the sorted (value, position) pairs
+        // and offset, stride locate the lane in a container of the layout of
+        // data whose axis has length k. The lanes are read once, by rows of
+        // blocks of lanes, and only k pairs per lane are kept.
+        template <class Ed, class C, class F, class P = exec::default_policy>
+        inline void select_over_axis(const Ed& data, std::size_t axis, std::size_t k, C comp, F&& f,
+                                     const P& policy = P())
+        {
+            using value_type = typename Ed::value_type;
+            using buffer_type = std::vector<std::pair<value_type, std::size_t>>;
+            sort_lanes l = get_sort_lanes(data, axis);
+            if (k == 0)
+            {
+                return;
+            }
+            select_compare<C> cmp{comp};
+            const value_type* in = data.data();
+            for_each_lane_block<buffer_type>(l, [&](buffer_type& heaps, std::size_t o, std::size_t j, std::size_t width)
+            {
+                reserve_lane_buffer(heaps, sort_lane_block * k);
+                std::array<std::size_t, sort_lane_block> sizes = {};
+                const value_type* first = in + (o * l.n * l.inner + j);
+                for (std::size_t i = 0; i < l.n; ++i, first += l.inner)
+                {
+                    for (std::size_t b = 0; b < width; ++b)
+                    {
+                        select_push(heaps.data() + b * k, sizes[b], k, first[b], i, cmp);
+                    }
+                }
+                for (std::size_t b = 0; b < width; ++b)
+                {
+                    auto* heap = heaps.data() + b * k;
+                    std::sort_heap(heap, heap + k, cmp);
+                    f(o * k * l.inner + j + b, l.inner, static_cast<const std::pair<value_type, std::size_t>*>(heap));
+                }
+            }, policy);
+        }
+
+        // Places the elements of the sorted unique positions kth_begin, ...,
+        // kth_end as in a sorted lane
+        template <class It, class KIt, class F>
+        inline void partition_lane(It begin, It end, KIt kth_begin, KIt kth_end, F&& comp)
+        {
+            select_ranks(begin, end, kth_begin, kth_end, std::size_t(0), comp);
+        }
+
+        /***************
+         * radix sorts *
+         ***************/
+
+        // Arithmetic types are sorted with a LSD radix sort on byte digits
+        // above this length; 64-bit keys need twice as many passes, so the
+        // comparison sort remains faster on longer ranges.
+        constexpr std::size_t radix_sort_threshold = 1024;
+
+        template <class T>
+        constexpr std::size_t radix_threshold()
+        {
+            return sizeof(T) > 4 ? 4 * radix_sort_threshold : radix_sort_threshold;
+        }
+
+        // Maps a value to an unsigned key with the same ordering
+        template <class T, class = void>
+        struct radix_traits
+        {
+            static constexpr bool value = false;
+        };
+
+        template <class T>
+        struct radix_traits<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+        {
+            static constexpr bool value = true;
+            using key_type = std::make_unsigned_t<T>;
+
+            static key_type key(T v) noexcept
+            {
+                // Flipping the sign bit orders the negative values first
+                constexpr key_type sign = std::is_signed<T>::value ? key_type(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+                return static_cast<key_type>(static_cast<key_type>(v) ^ sign);
+            }
+        };
+
+        template <class T, class K>
+        struct radix_float_traits
+        {
+            static constexpr bool value = true;
+            using key_type = K;
+
+            static key_type key(T v) noexcept
+            {
+                // Negative values have all their bits flipped so that their
+                // order is reversed, positive ones only have the sign bit set.
+                // NaNs are placed at the ends according to their sign bit.
+                constexpr key_type sign = key_type(key_type(1) << (8 * sizeof(K) - 1));
+                key_type bits;
+                std::memcpy(&bits, &v, sizeof(K));
+                return (bits & sign) ? key_type(~bits) : key_type(bits | sign);
+            }
+        };
+
+        template <>
+        struct radix_traits<float> : radix_float_traits<float, std::uint32_t>
+        {
+        };
+
+        template <>
+        struct radix_traits<double> : radix_float_traits<double, std::uint64_t>
+        {
+        };
+
+        template <class T>
+        using radix_counts = std::array<std::array<std::size_t, 256>, sizeof(typename radix_traits<T>::key_type)>;
+
+        template <class K>
+        inline std::size_t radix_digit(K key, std::size_t pass) noexcept
+        {
+            return static_cast<std::size_t>((key >> (8 * pass)) & K(0xFF));
+        }
+
+        // Turns the counts of a pass into the positions of the digits; a
+        // pass where all the keys have the same digit is skipped.
+        inline bool radix_offsets(std::array<std::size_t, 256>& counts, std::size_t first_digit, std::size_t n) noexcept
+        {
+            if (counts[first_digit] == n)
+            {
+                return false;
+            }
+            std::size_t offset = 0;
+            for (auto& c : counts)
             {
-                permutation.insert(permutation.begin(), ax);
+                std::size_t count = c;
+                c = offset;
+                offset += count;
             }
+            return true;
+        }
 
-            // TODO find a more clever way to get reverse permutation?
-            dynamic_shape<std::size_t> reverse_permutation;
-            for (std::size_t i = 0; i < dim; ++i)
+        template <class T>
+        inline void radix_sort(T* first, std::size_t n)
+        {
+            using traits = radix_traits<T>;
+            radix_counts<T> counts = {};
+            for (std::size_t i = 0; i < n; ++i)
             {
-                auto it = std::find(permutation.begin(), permutation.end(), i);
-                reverse_permutation.push_back(std::size_t(std::distance(permutation.begin(), it)));
+                auto key = traits::key(first[i]);
+                for (std::size_t p = 0; p < counts.size(); ++p)
+                {
+                    ++counts[p][radix_digit(key, p)];
+                }
             }
 
-            return std::make_pair(std::move(permutation), std::move(reverse_permutation));
+            arena_uvector<T> buffer(n);
+            T* src = first;
+            T* dst = buffer.data();
+            for (std::size_t p = 0; p < counts.size(); ++p)
+            {
+                auto& offsets = counts[p];
+                if (radix_offsets(offsets, radix_digit(traits::key(src[0]), p), n))
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        dst[offsets[radix_digit(traits::key(src[i]), p)]++] = src[i];
+                    }
+                    std::swap(src, dst);
+                }
+            }
+            if (src != first)
+            {
+                std::copy(src, src + n, first);
+            }
         }
 
-        template <class E, class R, class F>
-        inline auto run_lambda_over_axis(const E& e, R& res, std::size_t axis, F&& lambda)
+        // Stable sort of indices[0], ..., indices[n - 1] where indices[i] is
+        // associated with values[i]
+        template <class T, class I>
+        inline void radix_argsort(const T* values, I* indices, std::size_t n)
         {
-            if (axis != detail::leading_axis(e))
+            using traits = radix_traits<T>;
+            using key_type = typename traits::key_type;
+            arena_uvector<key_type> keys(n);
+            radix_counts<T> counts = {};
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                keys[i] = traits::key(values[i]);
+                for (std::size_t p = 0; p < counts.size(); ++p)
+                {
+                    ++counts[p][radix_digit(keys[i], p)];
+                }
+            }
+
+            arena_uvector<key_type> key_buffer(n);
+            arena_uvector<I> index_buffer(n);
+            key_type* key_src = keys.data();
+            key_type* key_dst = key_buffer.data();
+            I* index_src = indices;
+            I* index_dst = index_buffer.data();
+            for (std::size_t p = 0; p < counts.size(); ++p)
+            {
+                auto& offsets = counts[p];
+                if (radix_offsets(offsets, radix_digit(key_src[0], p), n))
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        std::size_t pos = offsets[radix_digit(key_src[i], p)]++;
+                        key_dst[pos] = key_src[i];
+                        index_dst[pos] = index_src[i];
+                    }
+                    std::swap(key_src, key_dst);
+                    std::swap(index_src, index_dst);
+                }
+            }
+            if (index_src != indices)
             {
-                dynamic_shape<std::size_t> permutation, reverse_permutation;
-                std::tie(permutation, reverse_permutation) = get_permutations(e.dimension(), axis, e.layout());
+                std::copy(index_src, index_src + n, indices);
+            }
+        }
 
-                res = transpose(e, permutation);
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
-                res = transpose(res, reverse_permutation);
+        template <class T>
+        inline void sort_range(T* first, T* last, std::true_type /*radix*/)
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n >= radix_threshold<T>())
+            {
+                radix_sort(first, n);
             }
             else
             {
-                res = e;
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
+                std::sort(first, last);
+            }
+        }
+
+        template <class T>
+        inline void sort_range(T* first, T* last, std::false_type /*radix*/)
+        {
+            std::sort(first, last);
+        }
+
+        // Sorts [first, last) in ascending order, with a radix sort for the
+        // arithmetic types when the range is long enough
+        template <class T>
+        inline void sort_range(T* first, T* last)
+        {
+            sort_range(first, last, std::integral_constant<bool, radix_traits<T>::value>());
+        }
+
+        // Blocks of this length are sorted independently by the parallel
+        // sort before being merged
+        constexpr std::size_t sort_merge_block = 65536;
+        constexpr std::size_t sort_max_blocks = 256;
+
+        // Number of elements of a among the first k elements of the merge
+        // of a and b, elements of a coming first on ties as in std::merge
+        template <class T, class C>
+        inline std::size_t merge_corank(const T* a, std::size_t na, const T* b, std::size_t nb,
+                                        std::size_t k, C& comp)
+        {
+            std::size_t lo = k > nb ? k - nb : std::size_t(0);
+            std::size_t hi = (std::min)(k, na);
+            while (lo < hi)
+            {
+                std::size_t i = lo + (hi - lo) / 2;
+                if (!comp(b[k - i - 1], a[i]))
+                {
+                    lo = i + 1;
+                }
+                else
+                {
+                    hi = i;
+                }
+            }
+            return lo;
+        }
+
+        // Sorts [first, first + n) according to policy. The range is split
+        // into a power of two of blocks that are sorted independently with
+        // block_sort and merged pairwise with comp, the merges being stable; each merge is split into parts of equal length
+        // so that every round has as many tasks as there are blocks. The
+        // blocks do not depend on the number of threads.
+        template <class T, class C, class S, class P>
+        inline void parallel_sort(T* first, std::size_t n, C comp, S block_sort, const P& policy)
+        {
+            std::size_t n_blocks = 1;
+            while (n_blocks < sort_max_blocks && n / (2 * n_blocks) >= sort_merge_block)
+            {
+                n_blocks *= 2;
+            }
+            if (n_blocks == 1)
+            {
+                block_sort(first, first + n);
+                return;
+            }
+
+            auto bound = [n, n_blocks](std::size_t b) { return n / n_blocks * b + n % n_blocks * b / n_blocks; };
+            run_sort_tasks(policy, n_blocks, n, [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t b = begin; b < end; ++b)
+                {
+                    block_sort(first + bound(b), first + bound(b + 1));
+                }
+            });
+
+            arena_uvector<T> buffer(n);
+            T* src = first;
+            T* dst = buffer.data();
+            for (std::size_t width = 1; width < n_blocks; width *= 2)
+            {
+                std::size_t parts = 2 * width;
+                run_sort_tasks(policy, n_blocks, n, [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t t = begin; t < end; ++t)
+                    {
+                        std::size_t pair = t / parts;
+                        std::size_t part = t % parts;
+                        std::size_t a_begin = bound(pair * parts);
+                        std::size_t b_begin = bound(pair * parts + width);
+                        std::size_t na = b_begin - a_begin;
+                        std::size_t nb = bound((pair + 1) * parts) - b_begin;
+                        std::size_t k0 = (na + nb) * part / parts;
+                        std::size_t k1 = (na + nb) * (part + 1) / parts;
+                        std::size_t i0 = merge_corank(src + a_begin, na, src + b_begin, nb, k0, comp);
+                        std::size_t i1 = merge_corank(src + a_begin, na, src + b_begin, nb, k1, comp);
+                        std::merge(src + a_begin + i0, src + a_begin + i1,
+                                   src + b_begin + (k0 - i0), src + b_begin + (k1 - i1),
+                                   dst + a_begin + k0, comp);
+                    }
+                });
+                std::swap(src, dst);
+            }
+
+            if (src != first)
+            {
+                run_sort_tasks(policy, n_blocks, n, [&](std::size_t begin, std::size_t end)
+                {
+                    std::copy(src + bound(begin), src + bound(end), first + bound(begin));
+                });
             }
         }
 
+        // Lanes are sorted one after the other, each one in parallel, when
+        // they are too few to be distributed over the threads
+        inline bool use_lane_parallel_sort(const sort_lanes& l) noexcept
+        {
+            return l.inner == 1 && l.outer * sort_merge_block < l.n;
+        }
+
         template <class VT>
         struct flatten_sort_result_type_impl
         {
@@ -147,15 +716,15 @@ namespace xt
         template <class VT>
         using flatten_sort_result_type_t = typename flatten_sort_result_type<VT>::type;
 
-        template <class E, class R = flatten_sort_result_type_t<E>>
-        inline auto flat_sort_impl(const xexpression<E>& e)
+        template <class E, class R = flatten_sort_result_type_t<E>, class P = exec::default_policy>
+        inline auto flat_sort_impl(const xexpression<E>& e, const P& policy = P())
         {
             const auto& de = e.derived_cast();
             R ev;
             ev.resize({static_cast<typename R::shape_type::value_type>(de.size())});
 
             std::copy(de.cbegin(), de.cend(), ev.begin());
-            std::sort(ev.begin(), ev.end());
+            parallel_sort(ev.data(), ev.size(), std::less<>(), [](auto* first, auto* last) { sort_range(first, last); }, policy);
 
             return ev;
         }
@@ -167,12 +736,27 @@ namespace xt
         return detail::flat_sort_impl(e);
     }
 
+    /**
+     * Sorts the flattened xexpression, distributing the work according to
+     * \c policy. The result is the same as with the serial sort.
+     *
+     * @param e xexpression to sort
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     *
+     * @return sorted 1-D array (copy)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto sort(const xexpression<E>& e, placeholders::xtuph /*t*/, const P& policy)
+    {
+        return detail::flat_sort_impl<E, detail::flatten_sort_result_type_t<E>>(e, policy);
+    }
+
     namespace detail
     {
         template <class T>
         struct sort_eval_type
         {
-            using type = typename T::temporary_type;
+            using type = temporary_type_t<T>;
         };
 
         template <class T, std::size_t... I, layout_type L>
@@ -180,6 +764,34 @@ namespace xt
         {
             using type = xtensor<T, sizeof...(I), L>;
         };
+
+        template <class E, class F>
+        inline auto apply_on_dense(const E& e, F&& f, std::true_type)
+        {
+            using eval_type = typename sort_eval_type<E>::type;
+            if (e.layout() == eval_type::static_layout)
+            {
+                return f(e);
+            }
+            eval_type ev = e;
+            return f(ev);
+        }
+
+        template <class E, class F>
+        inline auto apply_on_dense(const E& e, F&& f, std::false_type)
+        {
+            using eval_type = typename sort_eval_type<E>::type;
+            eval_type ev = e;
+            return f(ev);
+        }
+
+        // Calls f with e if it is a container with the layout of its
+        // evaluated type, and with an evaluated copy of e otherwise.
+        template <class E, class F>
+        inline auto apply_on_dense(const E& e, F&& f)
+        {
+            return apply_on_dense(e, std::forward<F>(f), std::integral_constant<bool, is_container<E>::value>());
+        }
     }
 
     /**
@@ -194,6 +806,24 @@ namespace xt
      */
     template <class E>
     inline auto sort(const xexpression<E>& e, std::ptrdiff_t axis = -1)
+    {
+        return sort(e, axis, exec::default_policy());
+    }
+
+    /**
+     * Sorts xexpression along axis, distributing the work according to
+     * \c policy. Independent lanes along the axis are sorted in parallel;
+     * when there are too few lanes, each one is split into blocks that
+     * are sorted in parallel and merged.
+     *
+     * @param e xexpression to sort
+     * @param axis axis along which sort is performed
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     *
+     * @return sorted array (copy)
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto sort(const xexpression<E>& e, std::ptrdiff_t axis, const P& policy)
     {
         using eval_type = typename detail::sort_eval_type<E>::type;
 
@@ -201,17 +831,44 @@ namespace xt
 
         if (de.dimension() == 1)
         {
-            return detail::flat_sort_impl<std::decay_t<decltype(de)>, eval_type>(de);
+            return detail::flat_sort_impl<std::decay_t<decltype(de)>, eval_type>(de, policy);
         }
 
         std::size_t ax = normalize_axis(de.dimension(), axis);
 
-        eval_type res;
-        detail::run_lambda_over_axis(de, res, ax, [](auto begin, auto end) { std::sort(begin, end); });
+        eval_type res = de;
+        detail::sort_lanes l = detail::get_sort_lanes(res, ax);
+        if (detail::use_lane_parallel_sort(l))
+        {
+            for (std::size_t o = 0; o < l.outer; ++o)
+            {
+                detail::parallel_sort(res.data() + o * l.n, l.n, std::less<>(),
+                                      [](auto* first, auto* last) { detail::sort_range(first, last); }, policy);
+            }
+        }
+        else
+        {
+            detail::call_over_axis(res, ax, [](auto begin, auto end) { detail::sort_range(begin, end); }, policy);
+        }
         return res;
     }
 
-    namespace detail
+    /**
+     * Sorting algorithm of argsort.
+     */
+    enum class sorting_method
+    {
+        /**
+         * Fastest algorithm, the order of equal elements is unspecified.
+         */
+        quick,
+        /**
+         * The order of equal elements is preserved.
+         */
+        stable,
+    };
+
+    namespace detail
     {
         template <class VT, class T>
         struct rebind_value_type
@@ -269,66 +926,110 @@ namespace xt
                                                             typename T::temporary_type>::type;
         };
 
-        template <class Ed, class Ei>
-        inline void argsort_over_leading_axis(const Ed& data, Ei& inds)
+        template <class T, class I>
+        inline void argsort_block(const T* values, I* first, I* last, sorting_method method, std::false_type /*radix*/)
         {
-            std::size_t n_iters = 1;
-            std::ptrdiff_t data_secondary_stride, inds_secondary_stride;
+            auto comp = [values](I x, I y) { return values[x] < values[y]; };
+            if (method == sorting_method::stable)
+            {
+                std::stable_sort(first, last, comp);
+            }
+            else
+            {
+                std::sort(first, last, comp);
+            }
+        }
 
-            if (data.layout() == layout_type::row_major)
+        template <class T, class I>
+        inline void argsort_block(const T* values, I* first, I* last, sorting_method method, std::true_type /*radix*/)
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n >= radix_threshold<T>())
             {
-                n_iters = std::accumulate(data.shape().begin(), data.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = static_cast<std::ptrdiff_t>(data.shape(data.dimension() - 1));
-                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.shape(inds.dimension() - 1));
+                radix_argsort(values + *first, first, n);
             }
             else
             {
-                n_iters = std::accumulate(data.shape().begin() + 1, data.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = static_cast<std::ptrdiff_t>(data.shape(0));
-                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.shape(0));
+                argsort_block(values, first, last, method, std::false_type());
             }
+        }
+
+        // Sorts the consecutive indices *first, *first + 1, ... of values;
+        // the radix argsort is stable whatever the method.
+        template <class T, class I>
+        inline void argsort_block(const T* values, I* first, I* last, sorting_method method)
+        {
+            argsort_block(values, first, last, method, std::integral_constant<bool, radix_traits<T>::value>());
+        }
+
+        template <class T, class I, class P>
+        inline void argsort_values(const T* values, I* indices, std::size_t n, const P& policy, sorting_method method)
+        {
+            std::iota(indices, indices + n, I(0));
+            parallel_sort(indices, n, [values](I x, I y) { return values[x] < values[y]; },
+                          [values, method](I* first, I* last) { argsort_block(values, first, last, method); }, policy);
+        }
 
-            auto ptr = data.data();
-            auto indices_ptr = inds.data();
+        template <class E, class I, class P>
+        inline void flatten_argsort_values(const E& e, I* indices, const P& policy, sorting_method method, std::false_type)
+        {
+            arena_uvector<typename E::value_type> values(e.size());
+            std::copy(e.template begin<layout_type::row_major>(), e.template end<layout_type::row_major>(), values.begin());
+            argsort_values(values.data(), indices, values.size(), policy, method);
+        }
 
-            for (std::size_t i = 0; i < n_iters; ++i, ptr += data_secondary_stride, indices_ptr += inds_secondary_stride)
+        // Containers traversed in row_major order are sorted without copy
+        template <class E, class I, class P>
+        inline void flatten_argsort_values(const E& e, I* indices, const P& policy, sorting_method method, std::true_type)
+        {
+            if (e.layout() == layout_type::row_major || e.dimension() <= 1)
             {
-                auto comp = [&ptr](std::size_t x, std::size_t y) {
-                    return *(ptr + x) < *(ptr + y);
-                };
-                std::iota(indices_ptr, indices_ptr + inds_secondary_stride, 0);
-                std::sort(indices_ptr, indices_ptr + inds_secondary_stride, comp);
+                argsort_values(e.data(), indices, e.size(), policy, method);
+            }
+            else
+            {
+                flatten_argsort_values(e, indices, policy, method, std::false_type());
             }
         }
 
-        template <class E, class R = typename detail::linear_argsort_result_type<E>::type>
-        inline auto flatten_argsort_impl(const xexpression<E>& e)
+        template <class E, class R = typename detail::linear_argsort_result_type<E>::type, class P = exec::default_policy>
+        inline auto flatten_argsort_impl(const xexpression<E>& e, const P& policy = P(),
+                                         sorting_method method = sorting_method::quick)
         {
             const auto& de = e.derived_cast();
 
-            auto cit = de.template begin<layout_type::row_major>();
-            using const_iterator = decltype(cit);
-            auto ad = xiterator_adaptor<const_iterator, const_iterator>(cit, cit, de.size());
-
             using result_type = R;
             result_type result;
             result.resize({de.size()});
-            auto comp = [&ad](std::size_t x, std::size_t y) {
-                return ad[x] < ad[y];
-            };
-            std::iota(result.begin(), result.end(), 0);
-            std::sort(result.begin(), result.end(), comp);
+            flatten_argsort_values(de, result.data(), policy, method, std::integral_constant<bool, is_container<E>::value>());
 
             return result;
         }
     }
 
     template <class E>
-    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/)
+    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/,
+                        sorting_method method = sorting_method::quick)
+    {
+        return detail::flatten_argsort_impl(e, exec::default_policy(), method);
+    }
+
+    /**
+     * Argsort of the flattened xexpression, distributing the work according
+     * to \c policy.
+     *
+     * @param e xexpression to argsort
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     * @param method sorting algorithm, \c sorting_method::stable keeps the
+     *        order of equal elements
+     *
+     * @return argsorted 1-D index array
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/, const P& policy,
+                        sorting_method method = sorting_method::quick)
     {
-        return detail::flatten_argsort_impl(e);
+        return detail::flatten_argsort_impl<E, typename detail::linear_argsort_result_type<E>::type>(e, policy, method);
     }
 
     /**
@@ -337,13 +1038,38 @@ namespace xt
      * of indices of the same shape as e that index data along the given axis in
      * sorted order.
      *
+     * Arithmetic types are sorted with a radix sort, which is stable, on
+     * long enough lanes.
+     *
      * @param e xexpression to argsort
      * @param axis axis along which argsort is performed
+     * @param method sorting algorithm, \c sorting_method::stable keeps the
+     *        order of equal elements
      *
      * @return argsorted index array
      */
     template <class E>
-    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1)
+    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1,
+                        sorting_method method = sorting_method::quick)
+    {
+        return argsort(e, axis, exec::default_policy(), method);
+    }
+
+    /**
+     * Argsort xexpression along axis, distributing the work according to
+     * \c policy, as for sort(const xexpression<E>&, std::ptrdiff_t, const P&).
+     *
+     * @param e xexpression to argsort
+     * @param axis axis along which argsort is performed
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     * @param method sorting algorithm, \c sorting_method::stable keeps the
+     *        order of equal elements
+     *
+     * @return argsorted index array
+     */
+    template <class E, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis, const P& policy,
+                        sorting_method method = sorting_method::quick)
     {
         using eval_type = typename detail::sort_eval_type<E>::type;
         using result_type = typename detail::argsort_result_type<eval_type>::type;
@@ -354,26 +1080,154 @@ namespace xt
 
         if (de.dimension() == 1)
         {
-            return detail::flatten_argsort_impl<E, result_type>(e);
+            return detail::flatten_argsort_impl<E, result_type>(e, policy, method);
         }
 
-        if (ax != detail::leading_axis(de))
-        {
-            dynamic_shape<std::size_t> permutation, reverse_permutation;
-            std::tie(permutation, reverse_permutation) = detail::get_permutations(de.dimension(), ax, de.layout());
-
-            eval_type ev = transpose(de, permutation);
+        return detail::apply_on_dense(de, [ax, &policy, method](const auto& ev) {
+            using value_type = typename std::decay_t<decltype(ev)>::value_type;
             result_type res = result_type::from_shape(ev.shape());
-            detail::argsort_over_leading_axis(ev, res);
-            res = transpose(res, reverse_permutation);
+            detail::sort_lanes l = detail::get_sort_lanes(ev, ax);
+            if (detail::use_lane_parallel_sort(l))
+            {
+                for (std::size_t o = 0; o < l.outer; ++o)
+                {
+                    detail::argsort_values(ev.data() + o * l.n, res.data() + o * l.n, l.n, policy, method);
+                }
+            }
+            else
+            {
+                detail::argcall_over_axis(ev, res, ax, [method](const value_type* values, auto* indices, std::size_t n) {
+                    std::iota(indices, indices + n, 0);
+                    detail::argsort_block(values, indices, indices + n, method);
+                }, policy);
+            }
             return res;
+        });
+    }
+
+    /*****************************
+     * Implementation of lexsort *
+     *****************************/
+
+    namespace detail
+    {
+        template <class T, class I>
+        inline void lexsort_pass(const T* key, I* indices, std::size_t n, std::false_type /*radix*/)
+        {
+            std::stable_sort(indices, indices + n, [key](I x, I y) { return key[x] < key[y]; });
         }
-        else
+
+        template <class T, class I>
+        inline void lexsort_pass(const T* key, I* indices, std::size_t n, std::true_type /*radix*/)
+        {
+            if (n >= radix_threshold<T>())
+            {
+                arena_uvector<T> values(n);
+                std::transform(indices, indices + n, values.begin(), [key](I i) { return key[i]; });
+                radix_argsort(values.data(), indices, n);
+            }
+            else
+            {
+                lexsort_pass(key, indices, n, std::false_type());
+            }
+        }
+
+        // Stable sort of the n indices by the values of key, the indices
+        // being iota if first
+        template <class T, class I>
+        inline void lexsort_values(const T* key, I* indices, std::size_t n, bool first)
+        {
+            if (first)
+            {
+                std::iota(indices, indices + n, I(0));
+                argsort_block(key, indices, indices + n, sorting_method::stable);
+            }
+            else
+            {
+                lexsort_pass(key, indices, n, std::integral_constant<bool, radix_traits<T>::value>());
+            }
+        }
+
+        template <class E, class I>
+        inline void lexsort_key(const E& key, I* indices, std::size_t n, bool first)
+        {
+            if (key.size() != n)
+            {
+                XTENSOR_THROW(std::runtime_error, "lexsort keys must have the same size.");
+            }
+            apply_on_contiguous(key, [indices, n, first](const auto* values, std::size_t) {
+                lexsort_values(values, indices, n, first);
+            });
+        }
+    }
+
+    /**
+     * Indirect stable sort on several keys.
+     *
+     * Returns the indices that sort the rows of \c keys, the last row being
+     * the primary key, the row before it the secondary key, and so on, as
+     * numpy.lexsort. A 1-D expression is a single key.
+     *
+     * Each key is used in a stable sort of the indices, from the least
+     * significant one; keys of arithmetic types are sorted with a radix
+     * sort on long enough arrays.
+     *
+     * @param keys 2-D expression whose rows are the keys, or 1-D key
+     * @return 1-D array of the indices that sort the keys
+     */
+    template <class E>
+    inline xtensor<std::size_t, 1> lexsort(const xexpression<E>& keys)
+    {
+        const auto& de = keys.derived_cast();
+        if (de.dimension() == 1)
         {
-            result_type res = result_type::from_shape(de.shape());
-            detail::argsort_over_leading_axis(de, res);
+            xtensor<std::size_t, 1> res = xtensor<std::size_t, 1>::from_shape({de.size()});
+            detail::lexsort_key(de, res.data(), res.size(), true);
             return res;
         }
+        if (de.dimension() != 2)
+        {
+            XTENSOR_THROW(std::runtime_error, "lexsort keys must be 1-D or 2-D.");
+        }
+        xarray<typename E::value_type, layout_type::row_major> rows = de;
+        std::size_t n_keys = rows.shape()[0];
+        std::size_t n = rows.shape()[1];
+        xtensor<std::size_t, 1> res = xtensor<std::size_t, 1>::from_shape({n});
+        for (std::size_t k = 0; k < n_keys; ++k)
+        {
+            detail::lexsort_values(rows.data() + k * n, res.data(), n, k == 0);
+        }
+        if (n_keys == 0)
+        {
+            std::iota(res.begin(), res.end(), std::size_t(0));
+        }
+        return res;
+    }
+
+    /**
+     * Indirect stable sort on several 1-D keys of possibly different value
+     * types, the last key being the primary one, as numpy.lexsort.
+     *
+     * @code{.cpp}
+     * // Sorts by last name, then by first name
+     * auto order = xt::lexsort(first_names, last_names);
+     * @endcode
+     *
+     * @param key1 least significant key
+     * @param key2 next key
+     * @param keys more significant keys, the last one being the primary key
+     * @return 1-D array of the indices that sort the keys
+     */
+    template <class E1, class E2, class... E>
+    inline xtensor<std::size_t, 1> lexsort(const xexpression<E1>& key1, const xexpression<E2>& key2, const xexpression<E>&... keys)
+    {
+        const auto& first = key1.derived_cast();
+        xtensor<std::size_t, 1> res = xtensor<std::size_t, 1>::from_shape({first.size()});
+        detail::lexsort_key(first, res.data(), res.size(), true);
+        detail::lexsort_key(key2.derived_cast(), res.data(), res.size(), false);
+        int passes[] = {0, (detail::lexsort_key(keys.derived_cast(), res.data(), res.size(), false), 0)...};
+        (void) passes;
+        return res;
     }
 
     /************************************************
@@ -390,7 +1244,10 @@ namespace xt
      * The optional third parameter can either be an axis or ``xnone()`` in which case
      * the xexpression will be flattened.
      *
-     * This function uses ``std::nth_element`` internally.
+     * All the kth positions are placed in a single recursion of
+     * ``std::nth_element`` calls, which splits the range around the median
+     * requested position and recurses on both halves, so that many positions,
+     * e.g. the cut points of percentile buckets, cost O(n log(m)) comparisons.
      *
      * \code{cpp}
      * xt::xarray<float> a = {1, 10, -10, 123};
@@ -412,22 +1269,10 @@ namespace xt
         const auto& de = e.derived_cast();
 
         R ev = R::from_shape({ de.size() });
-        C kth_copy = kth_container;
-        if (kth_copy.size() > 1)
-        {
-            std::sort(kth_copy.begin(), kth_copy.end());
-        }
+        std::vector<std::size_t> ranks = detail::partition_ranks(kth_container);
 
         std::copy(de.linear_cbegin(), de.linear_cend(), ev.linear_begin()); // flatten
-        std::size_t k_last = kth_copy.back();
-        std::nth_element(ev.linear_begin(), ev.linear_begin() + k_last, ev.linear_end());
-
-        for (auto it = (kth_copy.rbegin() + 1); it != kth_copy.rend(); ++it)
-        {
-            std::nth_element(ev.linear_begin(), ev.linear_begin() + *it, ev.linear_begin() + k_last);
-            k_last = *it;
-        }
-
+        detail::partition_lane(ev.linear_begin(), ev.linear_end(), ranks.cbegin(), ranks.cend(), std::less<>());
         return ev;
     }
 
@@ -443,8 +1288,26 @@ namespace xt
         return partition(e, std::array<std::size_t, 1>({kth}), tag);
     }
 
-    template <class E, class C, class = std::enable_if_t<!xtl::is_integral<C>::value, int>>
-    inline auto partition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis = -1)
+    /**
+     * Partially sorts the lanes of an xexpression along an axis, with the
+     * given execution policy.
+     *
+     * All the kth positions of a lane are placed in a single recursion,
+     * which partitions the lane around the median requested position and
+     * recurses on both halves with their positions, so that m positions
+     * cost O(n log(m)) comparisons, e.g. the 99 cut points of percentile
+     * buckets. The lanes are processed in parallel by \c exec::par.
+     *
+     * @param e input xexpression
+     * @param kth_container a container of ``indices`` that should contain the correctly sorted value
+     * @param axis the axis along which the lanes are partitioned
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     *
+     * @return partially sorted xcontainer
+     */
+    template <class E, class C, class P,
+              class = std::enable_if_t<!xtl::is_integral<C>::value && is_execution_policy<P>::value, int>>
+    inline auto partition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis, const P& policy)
     {
         using eval_type = typename detail::sort_eval_type<E>::type;
 
@@ -455,50 +1318,22 @@ namespace xt
             return partition<E, C, eval_type>(de, kth_container, xnone());
         }
 
-        C kth_copy = kth_container;
-        if (kth_copy.size() > 1)
-        {
-            std::sort(kth_copy.begin(), kth_copy.end());
-        }
-
+        std::vector<std::size_t> ranks = detail::partition_ranks(kth_container);
         std::size_t ax = normalize_axis(de.dimension(), axis);
 
-        eval_type res;
-
-        std::size_t kth = kth_copy.back();
-
-        dynamic_shape<std::size_t> permutation, reverse_permutation;
-        bool is_leading_axis = (ax == detail::leading_axis(de));
-
-        if (!is_leading_axis)
-        {
-            std::tie(permutation, reverse_permutation) = detail::get_permutations(de.dimension(), ax, de.layout());
-            res = transpose(de, permutation);
-        }
-        else
-        {
-            res = de;
-        }
-
-        auto lambda = [&kth](auto begin, auto end) {
-            std::nth_element(begin, begin + kth, end);
-        };
-        detail::call_over_leading_axis(res, lambda);
-
-        for (auto it = kth_copy.rbegin() + 1; it != kth_copy.rend(); ++it)
-        {
-            kth = *it;
-            detail::call_over_leading_axis(res, lambda);
-        }
-
-        if (!is_leading_axis)
-        {
-            res = transpose(res, reverse_permutation);
-        }
-
+        eval_type res = de;
+        detail::call_over_axis(res, ax, [&ranks](auto begin, auto end) {
+            detail::partition_lane(begin, end, ranks.cbegin(), ranks.cend(), std::less<>());
+        }, policy);
         return res;
     }
 
+    template <class E, class C, class = std::enable_if_t<!xtl::is_integral<C>::value, int>>
+    inline auto partition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis = -1)
+    {
+        return partition(e, kth_container, axis, exec::default_policy());
+    }
+
     template <class E, class T, std::size_t N>
     inline auto partition(const xexpression<E>& e, const T(&kth_container)[N], std::ptrdiff_t axis = -1)
     {
@@ -521,7 +1356,7 @@ namespace xt
      * The optional third parameter can either be an axis or ``xnone()`` in which case
      * the xexpression will be flattened.
      *
-     * This function uses ``std::nth_element`` internally.
+     * All the kth positions are placed in a single recursion, see partition.
      *
      * \code{cpp}
      * xt::xarray<float> a = {1, 10, -10, 123};
@@ -547,27 +1382,14 @@ namespace xt
         const auto& de = e.derived_cast();
 
         result_type ev = result_type::from_shape({ de.size() });
-
-        C kth_copy = kth_container;
-        if (kth_copy.size() > 1)
-        {
-            std::sort(kth_copy.begin(), kth_copy.end());
-        }
+        std::vector<std::size_t> ranks = detail::partition_ranks(kth_container);
 
         auto arg_lambda = [&de](std::size_t a, std::size_t b) {
             return de[a] < de[b];
         };
 
         std::iota(ev.linear_begin(), ev.linear_end(), 0);
-        std::size_t k_last = kth_copy.back();
-        std::nth_element(ev.linear_begin(), ev.linear_begin() + k_last, ev.linear_end(), arg_lambda);
-
-        for (auto it = (kth_copy.rbegin() + 1); it != kth_copy.rend(); ++it)
-        {
-            std::nth_element(ev.linear_begin(), ev.linear_begin() + *it, ev.linear_begin() + k_last, arg_lambda);
-            k_last = *it;
-        }
-
+        detail::partition_lane(ev.linear_begin(), ev.linear_end(), ranks.cbegin(), ranks.cend(), arg_lambda);
         return ev;
     }
 
@@ -583,55 +1405,21 @@ namespace xt
         return argpartition(e, std::array<std::size_t, 1>({kth}), tag);
     }
 
-    namespace detail
-    {
-        template <class Ed, class Ei>
-        inline void argpartition_over_leading_axis(const Ed& data, Ei& inds, std::size_t kth, std::ptrdiff_t last)
-        {
-            std::size_t n_iters = 1;
-            std::ptrdiff_t data_secondary_stride, inds_secondary_stride;
-
-            if (data.layout() == layout_type::row_major)
-            {
-                n_iters = std::accumulate(data.shape().begin(), data.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = data.strides()[data.dimension() - 2];
-                inds_secondary_stride = inds.strides()[inds.dimension() - 2];
-            }
-            else
-            {
-                n_iters = std::accumulate(data.shape().begin() + 1, data.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = data.strides()[1];
-                inds_secondary_stride = inds.strides()[1];
-            }
-
-            auto ptr = data.data();
-            auto indices_ptr = inds.data();
-            auto comp = [&ptr](std::size_t x, std::size_t y) {
-                return *(ptr + x) < *(ptr + y);
-            };
-
-            if (last == -1) // initialize
-            {
-                for (std::size_t i = 0; i < n_iters; ++i, ptr += data_secondary_stride, indices_ptr += inds_secondary_stride)
-                {
-                    std::iota(indices_ptr, indices_ptr + inds_secondary_stride, 0);
-                    std::nth_element(indices_ptr, indices_ptr + kth, indices_ptr + inds_secondary_stride, comp);
-                }
-            }
-            else
-            {
-                for (std::size_t i = 0; i < n_iters; ++i, ptr += data_secondary_stride, indices_ptr += inds_secondary_stride)
-                {
-                    std::nth_element(indices_ptr, indices_ptr + kth, indices_ptr + last, comp);
-                }
-            }
-        }
-    }
-
-    template <class E, class C, class = std::enable_if_t<!xtl::is_integral<C>::value, int>>
-    inline auto argpartition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis = -1)
+    /**
+     * Partially sorts the indices of the lanes of an xexpression along an
+     * axis, with the given execution policy. All the kth positions of a
+     * lane are placed in a single recursion, see partition.
+     *
+     * @param e input xexpression
+     * @param kth_container a container of ``indices`` that should contain the correctly sorted value
+     * @param axis the axis along which the lanes are partitioned
+     * @param policy execution policy, e.g. \c exec::par(pool)
+     *
+     * @return xcontainer with indices of partial sort of input
+     */
+    template <class E, class C, class P,
+              class = std::enable_if_t<!xtl::is_integral<C>::value && is_execution_policy<P>::value, int>>
+    inline auto argpartition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis, const P& policy)
     {
         using eval_type = typename detail::sort_eval_type<E>::type;
         using result_type = typename detail::argsort_result_type<eval_type>::type;
@@ -645,44 +1433,24 @@ namespace xt
             return argpartition<E, C, result_type>(e, kth_container, xnone());
         }
 
-        C kth_copy = kth_container;
-        if (kth_copy.size() > 1)
-        {
-            std::sort(kth_copy.begin(), kth_copy.end());
-        }
-
-        eval_type ev;
-        result_type res;
-
-        dynamic_shape<std::size_t> permutation, reverse_permutation;
-        bool is_leading_axis = (ax == detail::leading_axis(de));
-
-        if (!is_leading_axis)
-        {
-            std::tie(permutation, reverse_permutation) = detail::get_permutations(de.dimension(), ax, de.layout());
-            ev = transpose(de, permutation);
-        }
-        else
-        {
-            ev = de;
-        }
-        res.resize(ev.shape());
-
-        std::size_t kth = kth_copy.back();
-        detail::argpartition_over_leading_axis(ev, res, kth, -1);
-
-        for (auto it = (kth_copy.rbegin() + 1); it != kth_copy.rend(); ++it)
-        {
-            detail::argpartition_over_leading_axis(ev, res, *it, static_cast<std::ptrdiff_t>(kth));
-            kth = *it;
-        }
+        std::vector<std::size_t> ranks = detail::partition_ranks(kth_container);
 
-        if (!is_leading_axis)
-        {
-            res = transpose(res, reverse_permutation);
-        }
+        return detail::apply_on_dense(de, [ax, &ranks, &policy](const auto& ev) {
+            using value_type = typename std::decay_t<decltype(ev)>::value_type;
+            result_type res = result_type::from_shape(ev.shape());
+            detail::argcall_over_axis(ev, res, ax, [&ranks](const value_type* values, auto* indices, std::size_t n) {
+                std::iota(indices, indices + n, 0);
+                detail::partition_lane(indices, indices + n, ranks.cbegin(), ranks.cend(),
+                                       [values](std::size_t x, std::size_t y) { return values[x] < values[y]; });
+            }, policy);
+            return res;
+        });
+    }
 
-        return res;
+    template <class E, class C, class = std::enable_if_t<!xtl::is_integral<C>::value, int>>
+    inline auto argpartition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis = -1)
+    {
+        return argpartition(e, kth_container, axis, exec::default_policy());
     }
 
     template <class E, class I, std::size_t N>
@@ -701,20 +1469,35 @@ namespace xt
     inline typename std::decay_t<E>::value_type median(E&& e)
     {
         using value_type = typename std::decay_t<E>::value_type;
-        auto sz = e.size();
-        if (sz % 2 == 0)
+        arena_uvector<value_type> values(e.size());
+        std::copy(e.cbegin(), e.cend(), values.begin());
+        auto mid = values.begin() + std::ptrdiff_t(values.size() / 2);
+        std::nth_element(values.begin(), mid, values.end());
+        if (values.size() % 2 == 0)
         {
-            std::size_t szh = sz / 2; // integer floor div
-            std::array<std::size_t, 2> kth = {szh - 1, szh};
-            auto values = xt::partition(xt::flatten(e), kth);
-            return (values[kth[0]] + values[kth[1]]) / value_type(2);
+            // The lower middle value is the largest of the lower half
+            return (*std::max_element(values.begin(), mid) + *mid) / value_type(2);
         }
-        else
+        return *mid;
+    }
+
+    namespace detail
+    {
+        template <class VT, class T>
+        struct axis_reduced_rebind_value_type
         {
-            std::array<std::size_t, 1> kth = {(sz - 1) / 2};
-            auto values = xt::partition(xt::flatten(e), kth);
-            return values[kth[0]];
-        }
+            using type = typename rebind_value_type<VT, T>::type;
+        };
+
+        template <class VT, class EC, std::size_t N, layout_type L>
+        struct axis_reduced_rebind_value_type<VT, xtensor<EC, N, L>>
+        {
+            using type = xtensor<VT, N - 1, L>;
+        };
+
+        // Type of the mean of the two middle values, as computed by xt::mean
+        template <class T>
+        using median_value_type_t = std::decay_t<decltype((std::declval<T>() + std::declval<T>()) / std::declval<double>())>;
     }
 
     /**
@@ -732,101 +1515,651 @@ namespace xt
     template <class E>
     inline auto median(E&& e, std::ptrdiff_t axis)
     {
-        std::size_t ax = normalize_axis(e.dimension(), axis);
-        std::size_t sz = e.shape()[ax];
-        xstrided_slice_vector sv(e.dimension(), xt::all());
+        using expression_type = std::decay_t<E>;
+        using eval_type = typename detail::sort_eval_type<expression_type>::type;
+        using value_type = typename expression_type::value_type;
+        using median_type = detail::median_value_type_t<value_type>;
+        using result_type = typename detail::axis_reduced_rebind_value_type<median_type, eval_type>::type;
+        using result_shape_type = typename result_type::shape_type;
 
-        if (sz % 2 == 0)
-        {
-            std::size_t szh = sz / 2; // integer floor div
-            std::array<std::size_t, 2> kth = {szh - 1, szh};
-            auto values = xt::partition(std::forward<E>(e), kth, static_cast<ptrdiff_t>(ax));
-            sv[ax] = xt::range(szh - 1, szh + 1);
-            return xt::mean(xt::strided_view(std::move(values), std::move(sv)), {ax});
-        }
-        else
-        {
-            std::size_t szh = (sz - 1) / 2;
-            std::array<std::size_t, 1> kth = {(sz - 1) / 2};
-            auto values = xt::partition(std::forward<E>(e), kth, static_cast<ptrdiff_t>(ax));
-            sv[ax] = xt::range(szh, szh + 1);
-            return xt::mean(xt::strided_view(std::move(values), std::move(sv)), {ax});
-        }
+        std::size_t ax = normalize_axis(e.dimension(), axis);
+        return detail::apply_on_dense(e, [ax](const auto& ev) {
+            result_shape_type shape;
+            xt::resize_container(shape, ev.dimension() - 1);
+            auto axis_it = ev.shape().cbegin() + std::ptrdiff_t(ax);
+            std::copy(ev.shape().cbegin(), axis_it, shape.begin());
+            std::copy(axis_it + 1, ev.shape().cend(), shape.begin() + std::ptrdiff_t(ax));
+
+            result_type res = result_type::from_shape(std::move(shape));
+            detail::reduce_over_axis(ev, res, ax, [](value_type* begin, value_type* end) -> median_type {
+                std::size_t n = static_cast<std::size_t>(end - begin);
+                if (n == 0)
+                {
+                    return std::numeric_limits<median_type>::quiet_NaN();
+                }
+                value_type* mid = begin + std::ptrdiff_t(n / 2);
+                std::nth_element(begin, mid, end);
+                if (n % 2 == 0)
+                {
+                    // The lower middle value is the largest of the lower half
+                    return (*std::max_element(begin, mid) + *mid) / 2.;
+                }
+                return static_cast<median_type>(*mid);
+            });
+            return res;
+        });
     }
 
     namespace detail
     {
-        template <class T>
-        struct argfunc_result_type
-        {
-            using type = xarray<std::size_t>;
-        };
-
-        template <class T, std::size_t N>
-        struct argfunc_result_type<xtensor<T, N>>
+        // Sorted positions lo and hi of a lane whose values are interpolated
+        // linearly with weight to compute a quantile
+        struct quantile_point
         {
-            using type = xtensor<std::size_t, N - 1>;
+            std::size_t lo;
+            std::size_t hi;
+            double weight;
         };
 
-        template <layout_type L, class E, class F>
-        inline typename argfunc_result_type<E>::type
-        arg_func_impl(const E& e, std::size_t axis, F&& cmp)
+        template <class Q>
+        inline std::vector<quantile_point> quantile_points(const Q& probs, std::size_t n)
         {
-            using eval_type = typename detail::sort_eval_type<E>::type;
-            using value_type = typename E::value_type;
-            using result_type = typename argfunc_result_type<E>::type;
-            using result_shape_type = typename result_type::shape_type;
-
-            if (e.dimension() == 1)
+            std::vector<quantile_point> points;
+            for (const auto& q : probs)
             {
-                auto begin = e.template begin<L>();
-                auto end = e.template end<L>();
-                std::size_t i = static_cast<std::size_t>(std::distance(begin, std::min_element(begin, end)));
-                return xtensor<size_t, 0>{i};
+                double p = static_cast<double>(q);
+                if (!(p >= 0. && p <= 1.))
+                {
+                    XTENSOR_THROW(std::runtime_error, "Quantiles must be in the range [0, 1].");
+                }
+                double h = n == 0 ? 0. : static_cast<double>(n - 1) * p;
+                std::size_t lo = static_cast<std::size_t>(h);
+                points.push_back({lo, n == 0 ? 0 : (std::min)(lo + 1, n - 1), h - static_cast<double>(lo)});
             }
+            return points;
+        }
 
-            result_shape_type alt_shape;
-            xt::resize_container(alt_shape, e.dimension() - 1);
+        inline std::vector<std::size_t> quantile_ranks(const std::vector<quantile_point>& points)
+        {
+            std::vector<std::size_t> ranks;
+            for (const auto& p : points)
+            {
+                ranks.push_back(p.lo);
+                ranks.push_back(p.hi);
+            }
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+            return ranks;
+        }
 
-            // Excluding copy, copy all of shape except for axis
-            std::copy(e.shape().cbegin(), e.shape().cbegin() + std::ptrdiff_t(axis), alt_shape.begin());
-            std::copy(e.shape().cbegin() + std::ptrdiff_t(axis) + 1, e.shape().cend(), alt_shape.begin() + std::ptrdiff_t(axis));
+        // Computes the quantiles of the lane [begin, end), which is reordered,
+        // and stores them at out[0], out[stride], ...
+        template <class T, class R>
+        inline void quantile_lane(T* begin, T* end, const std::vector<quantile_point>& points,
+                                  const std::vector<std::size_t>& ranks, R* out, std::size_t stride)
+        {
+            if (begin == end)
+            {
+                for (std::size_t q = 0; q < points.size(); ++q)
+                {
+                    out[q * stride] = std::numeric_limits<R>::quiet_NaN();
+                }
+                return;
+            }
+            select_ranks(begin, end, ranks.cbegin(), ranks.cend(), std::size_t(0));
+            for (std::size_t q = 0; q < points.size(); ++q)
+            {
+                const quantile_point& p = points[q];
+                R lo = static_cast<R>(begin[p.lo]);
+                R hi = static_cast<R>(begin[p.hi]);
+                out[q * stride] = p.weight == 0. ? lo : lo + (hi - lo) * p.weight;
+            }
+        }
+    }
 
-            result_type result = result_type::from_shape(std::move(alt_shape));
-            auto result_iter = result.template begin<L>();
+    /**
+     * Computes the quantiles of the flattened xexpression, with the linear
+     * interpolation between the closest ranks used by default in NumPy.
+     * All the quantiles are selected in a single pass over a copy of
+     * the data, without sorting it.
+     *
+     * @param e input xexpression
+     * @param probs the probabilities of the quantiles, in [0, 1]
+     * @return 1-D array of the quantiles
+     * @throws std::runtime_error if a probability is not in [0, 1]
+     */
+    template <class E, class Q>
+    inline auto quantile(E&& e, const Q& probs)
+    {
+        using value_type = typename std::decay_t<E>::value_type;
+        using quantile_type = detail::median_value_type_t<value_type>;
+
+        arena_uvector<value_type> values(e.size());
+        std::copy(e.cbegin(), e.cend(), values.begin());
+        std::vector<detail::quantile_point> points = detail::quantile_points(probs, values.size());
+        xtensor<quantile_type, 1> res = xtensor<quantile_type, 1>::from_shape({points.size()});
+        detail::quantile_lane(values.data(), values.data() + values.size(), points,
+                              detail::quantile_ranks(points), res.data(), std::size_t(1));
+        return res;
+    }
 
-            auto arg_func_lambda = [&result_iter, &cmp](auto begin, auto end) {
-                std::size_t idx = 0;
-                value_type val = *begin;
-                ++begin;
-                for (std::size_t i = 1; begin != end; ++begin, ++i)
+    template <class E, class T, std::size_t N>
+    inline auto quantile(E&& e, const T (&probs)[N])
+    {
+        return quantile(std::forward<E>(e), xtl::forward_sequence<std::array<T, N>, decltype(probs)>(probs));
+    }
+
+    /**
+     * Computes the quantiles along the specified axis, with the linear
+     * interpolation between the closest ranks used by default in NumPy.
+     * The quantiles of each lane are selected in a single pass over a copy
+     * of the lane; lanes are processed in parallel when a parallel backend
+     * is enabled.
+     *
+     * @code{.cpp}
+     * // p50, p90 and p99 of each column
+     * auto q = xt::quantile(latencies, {0.5, 0.9, 0.99}, 0);
+     * @endcode
+     *
+     * @param e input xexpression
+     * @param probs the probabilities of the quantiles, in [0, 1]
+     * @param axis axis along which the quantiles are computed
+     * @return array whose first axis indexes the quantiles, followed by the
+     *         axes of \c e other than \c axis
+     * @throws std::runtime_error if a probability is not in [0, 1]
+     */
+    template <class E, class Q>
+    inline auto quantile(E&& e, const Q& probs, std::ptrdiff_t axis)
+    {
+        using expression_type = std::decay_t<E>;
+        using eval_type = typename detail::sort_eval_type<expression_type>::type;
+        using value_type = typename expression_type::value_type;
+        using quantile_type = detail::median_value_type_t<value_type>;
+        using result_type = typename detail::rebind_value_type<quantile_type, eval_type>::type;
+        using result_shape_type = typename result_type::shape_type;
+
+        std::size_t ax = normalize_axis(e.dimension(), axis);
+        return detail::apply_on_dense(e, [ax, &probs](const auto& ev) {
+            std::vector<detail::quantile_point> points = detail::quantile_points(probs, ev.shape()[ax]);
+            std::vector<std::size_t> ranks = detail::quantile_ranks(points);
+
+            result_shape_type shape;
+            xt::resize_container(shape, ev.dimension());
+            auto axis_it = ev.shape().cbegin() + std::ptrdiff_t(ax);
+            shape[0] = points.size();
+            std::copy(ev.shape().cbegin(), axis_it, shape.begin() + 1);
+            std::copy(axis_it + 1, ev.shape().cend(), shape.begin() + std::ptrdiff_t(ax + 1));
+            result_type res = result_type::from_shape(std::move(shape));
+            if (res.size() == 0)
+            {
+                return res;
+            }
+
+            // The quantiles of a lane are strided by the number of lanes in
+            // row major order, and contiguous in column major order.
+            std::size_t n_lanes = res.size() / points.size();
+            bool row_major = res.layout() == layout_type::row_major;
+            std::size_t stride = row_major ? n_lanes : 1;
+            std::size_t lane_stride = row_major ? 1 : points.size();
+            quantile_type* out = res.data();
+            detail::call_over_lane_copies(ev, ax, [&](value_type* begin, value_type* end, std::size_t p) {
+                detail::quantile_lane(begin, end, points, ranks, out + p * lane_stride, stride);
+            });
+            return res;
+        });
+    }
+
+    template <class E, class T, std::size_t N>
+    inline auto quantile(E&& e, const T (&probs)[N], std::ptrdiff_t axis)
+    {
+        return quantile(std::forward<E>(e), xtl::forward_sequence<std::array<T, N>, decltype(probs)>(probs), axis);
+    }
+
+    /**************************************
+     * Implementation of topk and argtopk *
+     **************************************/
+
+    namespace detail
+    {
+        template <class R, class E>
+        inline R topk_result(const E& ev, std::size_t axis, std::size_t k)
+        {
+            if (k > static_cast<std::size_t>(ev.shape()[axis]))
+            {
+                XTENSOR_THROW(std::runtime_error, "k is larger than the length of the axis.");
+            }
+            typename R::shape_type shape;
+            xt::resize_container(shape, ev.dimension());
+            std::copy(ev.shape().cbegin(), ev.shape().cend(), shape.begin());
+            shape[axis] = k;
+            return R::from_shape(std::move(shape));
+        }
+    }
+
+    /**
+     * Returns the \c k first elements along \c axis of the sorted xexpression,
+     * i.e. the \c k largest ones in decreasing order with the default
+     * comparison. Unlike a full partition, the input is read once and only
+     * \c k elements are kept per lane, in a heap.
+     *
+     * @param e xexpression to select from
+     * @param k number of elements to select along \c axis
+     * @param axis axis along which the elements are selected
+     * @param comp comparison defining the order, e.g. \c std::less<>() for
+     *        the \c k smallest elements in increasing order
+     *
+     * @return array whose \c axis has length \c k
+     * @throws std::runtime_error if \c k exceeds the length of \c axis
+     * @sa argtopk
+     */
+    template <class E, class C = std::greater<>>
+    inline auto topk(const xexpression<E>& e, std::size_t k, std::ptrdiff_t axis = -1, C comp = C())
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+
+        const auto& de = e.derived_cast();
+        std::size_t ax = normalize_axis(de.dimension(), axis);
+        return detail::apply_on_dense(de, [ax, k, &comp](const auto& ev) {
+            eval_type res = detail::topk_result<eval_type>(ev, ax, k);
+            auto* out = res.data();
+            detail::select_over_axis(ev, ax, k, comp, [out, k](std::size_t offset, std::size_t stride, const auto* best) {
+                for (std::size_t r = 0; r < k; ++r)
                 {
-                    if (cmp(*begin, val))
+                    out[offset + r * stride] = best[r].first;
+                }
+            });
+            return res;
+        });
+    }
+
+    /**
+     * Returns the indices of the \c k first elements along \c axis of the
+     * sorted xexpression, in the order of topk. Among equal elements, the
+     * ones with the lowest indices are selected first.
+     *
+     * @param e xexpression to select from
+     * @param k number of indices to select along \c axis
+     * @param axis axis along which the elements are selected
+     * @param comp comparison defining the order
+     *
+     * @return index array whose \c axis has length \c k
+     * @throws std::runtime_error if \c k exceeds the length of \c axis
+     * @sa topk
+     */
+    template <class E, class C = std::greater<>>
+    inline auto argtopk(const xexpression<E>& e, std::size_t k, std::ptrdiff_t axis = -1, C comp = C())
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+        using result_type = typename detail::argsort_result_type<eval_type>::type;
+        using index_type = typename result_type::value_type;
+
+        const auto& de = e.derived_cast();
+        std::size_t ax = normalize_axis(de.dimension(), axis);
+        return detail::apply_on_dense(de, [ax, k, &comp](const auto& ev) {
+            result_type res = detail::topk_result<result_type>(ev, ax, k);
+            auto* out = res.data();
+            detail::select_over_axis(ev, ax, k, comp, [out, k](std::size_t offset, std::size_t stride, const auto* best) {
+                for (std::size_t r = 0; r < k; ++r)
+                {
+                    out[offset + r * stride] = static_cast<index_type>(best[r].second);
+                }
+            });
+            return res;
+        });
+    }
+
+
+    namespace detail
+    {
+        template <class T>
+        struct argfunc_result_type
+        {
+            using type = xarray<std::size_t>;
+        };
+
+        template <class T, std::size_t N>
+        struct argfunc_result_type<xtensor<T, N>>
+        {
+            using type = xtensor<std::size_t, N - 1>;
+        };
+
+        /********************
+         * arg_func kernels *
+         ********************/
+
+        // Length of the blocks searched independently when an arg-reduction
+        // runs in parallel. The partial results are combined in order, so
+        // that the first extremum is found whatever the number of threads.
+        constexpr std::size_t arg_block_size = 16384;
+
+        inline bool use_parallel_arg_func(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+            return size >= 2 * arg_block_size && size >= exec::default_threshold();
+#else
+            (void) size;
+            return false;
+#endif
+        }
+
+        // Comparisons that have a simd counterpart
+        template <class F>
+        struct arg_func_simd_op : std::false_type
+        {
+        };
+
+        template <class T>
+        struct arg_func_simd_op<std::less<T>> : std::true_type
+        {
+            template <class B>
+            static auto compare(const B& lhs, const B& rhs)
+            {
+                return lhs < rhs;
+            }
+        };
+
+        template <class T>
+        struct arg_func_simd_op<std::greater<T>> : std::true_type
+        {
+            template <class B>
+            static auto compare(const B& lhs, const B& rhs)
+            {
+                return lhs > rhs;
+            }
+        };
+
+        template <class T, class F>
+        using use_simd_arg_func = std::integral_constant<bool,
+#if defined(XTENSOR_USE_XSIMD)
+                                                         arg_func_simd_op<std::decay_t<F>>::value &&
+                                                         std::is_arithmetic<T>::value &&
+                                                         (xt_simd::simd_traits<T>::size > 1)
+#else
+                                                         false
+#endif
+                                                        >;
+
+        /**
+         * Searches [first + begin, first + end) for an element comparing
+         * better than best, the result of the search over the preceding
+         * elements, and returns the first best element with its index.
+         * Elements that are only equivalent to the best one, as well as
+         * NaNs, are skipped, as done by std::min_element.
+         */
+        template <class T, class F>
+        inline std::pair<T, std::size_t> arg_func_search(const T* first, std::size_t begin, std::size_t end,
+                                                         std::pair<T, std::size_t> best, F& cmp, std::false_type)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                if (cmp(first[i], best.first))
+                {
+                    best.first = first[i];
+                    best.second = i;
+                }
+            }
+            return best;
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        // The best value is searched with one candidate per lane, then the
+        // first element equal to it is looked for; equal elements are
+        // equivalent for arithmetic types, so the index is the one found by
+        // the scalar search.
+        template <class T, class F>
+        inline std::pair<T, std::size_t> arg_func_search(const T* first, std::size_t begin, std::size_t end,
+                                                         std::pair<T, std::size_t> best, F& cmp, std::true_type)
+        {
+            using batch_type = xt_simd::simd_type<T>;
+            using op_type = arg_func_simd_op<std::decay_t<F>>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            if (end - begin < 2 * simd_size)
+            {
+                return arg_func_search(first, begin, end, best, cmp, std::false_type());
+            }
+
+            batch_type candidates(best.first);
+            std::size_t i = begin;
+            for (; i + simd_size <= end; i += simd_size)
+            {
+                batch_type b = xt_simd::load_as<T>(first + i, unaligned_mode());
+                candidates = xsimd::select(op_type::compare(b, candidates), b, candidates);
+            }
+            T lanes[simd_size];
+            xt_simd::store_as(lanes, candidates, unaligned_mode());
+            T value = best.first;
+            for (std::size_t k = 0; k < simd_size; ++k)
+            {
+                if (cmp(lanes[k], value))
+                {
+                    value = lanes[k];
+                }
+            }
+            for (; i < end; ++i)
+            {
+                if (cmp(first[i], value))
+                {
+                    value = first[i];
+                }
+            }
+            if (!cmp(value, best.first))
+            {
+                return best;
+            }
+
+            batch_type target(value);
+            i = begin;
+            for (; i + simd_size <= end; i += simd_size)
+            {
+                if (xsimd::any(xt_simd::load_as<T>(first + i, unaligned_mode()) == target))
+                {
+                    break;
+                }
+            }
+            while (!(first[i] == value))
+            {
+                ++i;
+            }
+            return std::make_pair(value, i);
+        }
+#endif
+
+        template <class T, class F>
+        inline std::size_t arg_func_contiguous(const T* first, std::size_t n, F& cmp, bool parallel)
+        {
+            if (n == 0)
+            {
+                return 0;
+            }
+            using use_simd = use_simd_arg_func<T, F>;
+            std::pair<T, std::size_t> seed(first[0], 0);
+            if (!parallel || n < 2 * arg_block_size)
+            {
+                return arg_func_search(first, 1, n, seed, cmp, use_simd()).second;
+            }
+
+            // Every block is searched from the first element, so that a
+            // block result only differs from it if it is strictly better.
+            std::size_t n_blocks = (n + arg_block_size - 1) / arg_block_size;
+            std::vector<std::pair<T, std::size_t>> partials(n_blocks, seed);
+            exec::default_policy().for_range(std::size_t(0), n_blocks, std::size_t(1),
+                                             [&](std::size_t block_begin, std::size_t block_end)
+            {
+                for (std::size_t b = block_begin; b < block_end; ++b)
+                {
+                    std::size_t begin = (std::max)(b * arg_block_size, std::size_t(1));
+                    std::size_t end = (std::min)((b + 1) * arg_block_size, n);
+                    partials[b] = arg_func_search(first, begin, end, seed, cmp, use_simd());
+                }
+            });
+            std::pair<T, std::size_t> res = seed;
+            for (const auto& partial : partials)
+            {
+                if (cmp(partial.first, res.first))
+                {
+                    res = partial;
+                }
+            }
+            return res.second;
+        }
+
+        // Arg-reduction of the width first columns of n rows of stride
+        // elements; the scalar recurrence of the contiguous search is
+        // applied to every column.
+        template <class T, class F>
+        inline void arg_func_strided(const T* first, std::size_t n, std::size_t stride, std::size_t width,
+                                     std::size_t* out, F& cmp)
+        {
+            std::vector<T> best(first, first + width);
+            std::fill(out, out + width, std::size_t(0));
+            for (std::size_t k = 1; k < n; ++k)
+            {
+                const T* row = first + k * stride;
+                for (std::size_t i = 0; i < width; ++i)
+                {
+                    if (cmp(row[i], best[i]))
                     {
-                        val = *begin;
-                        idx = i;
+                        best[i] = row[i];
+                        out[i] = k;
                     }
                 }
-                *result_iter = idx;
-                ++result_iter;
-            };
+            }
+        }
 
-            if (axis != detail::leading_axis(e))
+        template <class T, class F>
+        inline void arg_func_axis(const T* first, std::size_t outer, std::size_t n, std::size_t inner,
+                                  std::size_t* out, F& cmp)
+        {
+            bool parallel = use_parallel_arg_func(outer * n * inner);
+            if (n == 0)
+            {
+                std::fill(out, out + outer * inner, std::size_t(0));
+            }
+            else if (inner == 1)
+            {
+                if (parallel && outer >= 2 * xthread_pool::default_concurrency())
+                {
+                    exec::default_policy().for_range(std::size_t(0), outer, std::size_t(1),
+                                                     [&](std::size_t begin, std::size_t end)
+                    {
+                        for (std::size_t o = begin; o < end; ++o)
+                        {
+                            out[o] = arg_func_contiguous(first + o * n, n, cmp, false);
+                        }
+                    });
+                }
+                else
+                {
+                    for (std::size_t o = 0; o < outer; ++o)
+                    {
+                        out[o] = arg_func_contiguous(first + o * n, n, cmp, parallel);
+                    }
+                }
+            }
+            else
             {
-                dynamic_shape<std::size_t> permutation, reverse_permutation;
-                std::tie(permutation, reverse_permutation) = detail::get_permutations(e.dimension(), axis, e.layout());
+                // Tasks are made of groups of columns of each outer slice
+                std::size_t group_size = parallel ? (std::max)(arg_block_size / n, std::size_t(64)) : inner;
+                std::size_t n_groups = (inner + group_size - 1) / group_size;
+                auto run = [&](std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t t = begin; t < end; ++t)
+                    {
+                        std::size_t o = t / n_groups;
+                        std::size_t col = (t % n_groups) * group_size;
+                        std::size_t width = (std::min)(group_size, inner - col);
+                        arg_func_strided(first + o * n * inner + col, n, inner, width, out + o * inner + col, cmp);
+                    }
+                };
+                if (parallel)
+                {
+                    exec::default_policy().for_range(std::size_t(0), outer * n_groups, std::size_t(1), run);
+                }
+                else
+                {
+                    run(std::size_t(0), outer * n_groups);
+                }
+            }
+        }
 
+        template <layout_type L, class E, class F>
+        inline typename argfunc_result_type<E>::type
+        arg_func_impl(const E& e, std::size_t axis, F&& cmp)
+        {
+            using eval_type = typename detail::sort_eval_type<E>::type;
+            using result_type = typename argfunc_result_type<E>::type;
+            using result_shape_type = typename result_type::shape_type;
+
+            if (e.layout() != layout_type::row_major && e.layout() != layout_type::column_major)
+            {
                 // note: creating copy
-                eval_type input = transpose(e, permutation);
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
+                eval_type input = e;
+                return arg_func_impl<L>(input, axis, std::forward<F>(cmp));
+            }
+
+            auto shape_begin = e.shape().cbegin();
+            auto shape_end = e.shape().cend();
+            auto axis_it = shape_begin + std::ptrdiff_t(axis);
+            std::size_t n = e.shape()[axis];
+            std::size_t before = std::accumulate(shape_begin, axis_it, std::size_t(1), std::multiplies<>());
+            std::size_t after = std::accumulate(axis_it + 1, shape_end, std::size_t(1), std::multiplies<>());
+            bool row_major = e.layout() == layout_type::row_major;
+            std::size_t outer = row_major ? before : after;
+            std::size_t inner = row_major ? after : before;
+
+            if (e.dimension() == 1)
+            {
+                return xtensor<size_t, 0>{arg_func_contiguous(e.data(), n, cmp, use_parallel_arg_func(n))};
+            }
+
+            result_shape_type alt_shape;
+            xt::resize_container(alt_shape, e.dimension() - 1);
+
+            // Excluding copy, copy all of shape except for axis
+            std::copy(shape_begin, axis_it, alt_shape.begin());
+            std::copy(axis_it + 1, shape_end, alt_shape.begin() + std::ptrdiff_t(axis));
+
+            result_type result = result_type::from_shape(std::move(alt_shape));
+            // The indices are computed in the memory order of e
+            if (row_major && result.layout() == layout_type::row_major)
+            {
+                arg_func_axis(e.data(), outer, n, inner, result.data(), cmp);
             }
             else
             {
-                auto&& input = eval(e);
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
+                arena_uvector<std::size_t> buffer(outer * inner);
+                arg_func_axis(e.data(), outer, n, inner, buffer.data(), cmp);
+                if (row_major)
+                {
+                    std::copy(buffer.cbegin(), buffer.cend(), result.template begin<layout_type::row_major>());
+                }
+                else
+                {
+                    std::copy(buffer.cbegin(), buffer.cend(), result.template begin<layout_type::column_major>());
+                }
             }
+            return result;
+        }
+
+        template <layout_type L, class E, class F>
+        inline std::size_t arg_func_flat(const E& e, F&& cmp)
+        {
+            if (e.layout() == L && (L == layout_type::row_major || L == layout_type::column_major))
+            {
+                std::size_t n = static_cast<std::size_t>(e.size());
+                return arg_func_contiguous(e.data(), n, cmp, use_parallel_arg_func(n));
+            }
+            auto begin = e.template begin<L>();
+            auto end = e.template end<L>();
+            auto best = begin;
+            for (auto it = begin; it != end; ++it)
+            {
+                if (cmp(*it, *best))
+                {
+                    best = it;
+                }
+            }
+            return static_cast<std::size_t>(std::distance(begin, best));
         }
     }
 
@@ -835,9 +2168,7 @@ namespace xt
     {
         using value_type = typename E::value_type;
         auto&& ed = eval(e.derived_cast());
-        auto begin = ed.template begin<L>();
-        auto end = ed.template end<L>();
-        std::size_t i = static_cast<std::size_t>(std::distance(begin, std::min_element(begin, end)));
+        std::size_t i = detail::arg_func_flat<L>(ed, std::less<value_type>());
         return xtensor<size_t, 0>{i};
     }
 
@@ -865,9 +2196,7 @@ namespace xt
     {
         using value_type = typename E::value_type;
         auto&& ed = eval(e.derived_cast());
-        auto begin = ed.template begin<L>();
-        auto end = ed.template end<L>();
-        std::size_t i = static_cast<std::size_t>(std::distance(begin, std::max_element(begin, end)));
+        std::size_t i = detail::arg_func_flat<L>(ed, std::greater<value_type>());
         return xtensor<size_t, 0>{i};
     }
 
@@ -890,29 +2219,393 @@ namespace xt
         return detail::arg_func_impl<L>(ed, ax, std::greater<value_type>());
     }
 
+    namespace detail
+    {
+        // unique gathers the distinct values in a hash set as long as there
+        // are fewer than one per this many elements, and sorts the input
+        // otherwise, sorting being then faster than hashing.
+        constexpr std::size_t unique_hash_ratio = 16;
+
+        template <class T, class It>
+        inline bool hash_unique(hash_set<T>& set, It first, It last, std::size_t max_size)
+        {
+            for (; first != last; ++first)
+            {
+                set.insert(*first);
+                if (set.size() > max_size)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Sorts the values of set, in insertion order, into values and
+        // returns the rank of each of them in values
+        template <class T>
+        inline xtensor<std::size_t, 1> sort_unique_values(const hash_set<T>& set, xtensor<T, 1>& values)
+        {
+            xtensor<T, 1> unsorted = xtensor<T, 1>::from_shape({set.size()});
+            std::copy(set.values().cbegin(), set.values().cend(), unsorted.begin());
+            auto order = argsort(unsorted);
+            values = xtensor<T, 1>::from_shape({set.size()});
+            xtensor<std::size_t, 1> ranks = xtensor<std::size_t, 1>::from_shape({set.size()});
+            for (std::size_t r = 0; r < order.size(); ++r)
+            {
+                values(r) = unsorted(order(r));
+                ranks(order(r)) = r;
+            }
+            return ranks;
+        }
+    }
+
     /**
      * Find unique elements of a xexpression. This returns a flattened xtensor with
      * sorted, unique elements from the original expression.
      *
+     * Inputs with few distinct values are deduplicated with a hash set,
+     * in linear time, before sorting the distinct values only.
+     *
      * @param e input xexpression (will be flattened)
      */
     template <class E>
     inline auto unique(const xexpression<E>& e)
     {
+        using value_type = typename E::value_type;
+        const auto& de = e.derived_cast();
+        detail::hash_set<value_type> set;
+        if (detail::hash_unique(set, de.cbegin(), de.cend(), de.size() / detail::unique_hash_ratio))
+        {
+            auto result = xtensor<value_type, 1>::from_shape({set.size()});
+            std::copy(set.values().cbegin(), set.values().cend(), result.begin());
+            detail::sort_range(result.data(), result.data() + result.size());
+            return result;
+        }
+
         auto sorted = sort(e, xnone());
         auto end = std::unique(sorted.begin(), sorted.end());
         std::size_t sz = static_cast<std::size_t>(std::distance(sorted.begin(), end));
         // TODO check if we can shrink the vector without reallocation
-        using value_type = typename E::value_type;
         auto result = xtensor<value_type, 1>::from_shape({sz});
         std::copy(sorted.begin(), end, result.begin());
         return result;
     }
 
+    /**
+     * Result of unique(const xexpression<E>&, bool, bool).
+     */
+    template <class T>
+    struct unique_result
+    {
+        /**
+         * The sorted unique values.
+         */
+        xtensor<T, 1> values;
+        /**
+         * The index in values of each element of the flattened input, if
+         * requested.
+         */
+        xtensor<std::size_t, 1> inverse;
+        /**
+         * The number of occurrences of each of the values, if requested.
+         */
+        xtensor<std::size_t, 1> counts;
+    };
+
+    /**
+     * Find unique elements of a xexpression, as with
+     * ``np.unique(e, return_inverse=..., return_counts=...)``. The elements
+     * are counted and mapped to their unique value in a single pass with a
+     * hash set, then only the distinct values are sorted.
+     *
+     * @code{.cpp}
+     * auto u = xt::unique(a, false, true);
+     * // u.values holds the unique values and u.counts their number of occurrences
+     * @endcode
+     *
+     * @param e input xexpression (will be flattened)
+     * @param return_inverse whether to compute the indices of the unique
+     *        values reconstructing the flattened input
+     * @param return_counts whether to count the occurrences of the unique values
+     * @return a unique_result whose arrays that are not requested are empty
+     */
+    template <class E>
+    inline auto unique(const xexpression<E>& e, bool return_inverse, bool return_counts = false)
+    {
+        using value_type = typename E::value_type;
+        const auto& de = e.derived_cast();
+
+        unique_result<value_type> res;
+        detail::hash_set<value_type> set;
+        std::vector<std::size_t> counts;
+        if (return_inverse)
+        {
+            res.inverse = xtensor<std::size_t, 1>::from_shape({de.size()});
+        }
+        std::size_t i = 0;
+        for (auto it = de.cbegin(); it != de.cend(); ++it, ++i)
+        {
+            std::size_t id = set.insert(*it).first;
+            if (return_inverse)
+            {
+                res.inverse(i) = id;
+            }
+            if (return_counts)
+            {
+                if (id == counts.size())
+                {
+                    counts.push_back(0);
+                }
+                ++counts[id];
+            }
+        }
+
+        xtensor<std::size_t, 1> ranks = detail::sort_unique_values(set, res.values);
+        if (return_inverse)
+        {
+            std::transform(res.inverse.cbegin(), res.inverse.cend(), res.inverse.begin(),
+                           [&ranks](std::size_t id) { return ranks(id); });
+        }
+        if (return_counts)
+        {
+            res.counts = xtensor<std::size_t, 1>::from_shape({counts.size()});
+            for (std::size_t id = 0; id < counts.size(); ++id)
+            {
+                res.counts(ranks(id)) = counts[id];
+            }
+        }
+        return res;
+    }
+
+    namespace detail
+    {
+        template <class E>
+        inline void check_row_keys(const E& e)
+        {
+            static_assert(has_hash_bits<typename E::value_type>::value, "row keys must be integral or floating point");
+            if (e.dimension() != 2)
+            {
+                XTENSOR_THROW(std::runtime_error, "row keys must be 2-D.");
+            }
+        }
+
+        // Hashes the n rows of m keys at data. The columns are processed one
+        // after the other, so that the loop over the rows has no dependency
+        // and is vectorized when the columns are contiguous.
+        template <class T>
+        inline void hash_rows_impl(const T* data, std::size_t n, std::size_t m,
+                                   std::size_t row_stride, std::size_t column_stride, std::size_t* res)
+        {
+            constexpr std::uint64_t prime = 0x100000001b3ULL;
+            std::vector<std::uint64_t> h(n, static_cast<std::uint64_t>(m));
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                const T* column = data + j * column_stride;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    h[i] = (h[i] ^ hash_bits(column[i * row_stride])) * prime;
+                }
+            }
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                res[i] = hash_mix(h[i]);
+            }
+        }
+
+        // Numbers the distinct rows of the row-major keys in order of first
+        // occurrence: ids receives the group of each row and firsts the
+        // first row of each group. The groups are found with an open
+        // addressing table of group ids, rows being compared only when their
+        // hashes are equal. Rows holding NaN are all distinct.
+        template <class T>
+        inline void group_row_ids(const xtensor<T, 2>& keys, std::vector<std::size_t>& ids,
+                                  std::vector<std::size_t>& firsts)
+        {
+            constexpr std::size_t npos = std::size_t(-1);
+            std::size_t n = keys.shape()[0];
+            std::size_t m = keys.shape()[1];
+            std::vector<std::size_t> hashes(n);
+            hash_rows_impl(keys.data(), n, m, m, std::size_t(1), hashes.data());
+
+            std::size_t n_slots = 16;
+            while (n_slots < 2 * n)
+            {
+                n_slots *= 2;
+            }
+            std::size_t mask = n_slots - 1;
+            std::vector<std::size_t> slots(n_slots, npos);
+            ids.resize(n);
+            firsts.clear();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const T* row = keys.data() + i * m;
+                std::size_t k = hashes[i] & mask;
+                while (slots[k] != npos)
+                {
+                    std::size_t first = firsts[slots[k]];
+                    if (hashes[first] == hashes[i] && std::equal(row, row + m, keys.data() + first * m))
+                    {
+                        break;
+                    }
+                    k = (k + 1) & mask;
+                }
+                if (slots[k] == npos)
+                {
+                    slots[k] = firsts.size();
+                    firsts.push_back(i);
+                }
+                ids[i] = slots[k];
+            }
+        }
+
+        // Lexicographic order of rows, NaN being greater than any number
+        template <class T>
+        inline bool row_less(const T* lhs, const T* rhs, std::size_t m)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                bool lhs_nan = lhs[j] != lhs[j];
+                bool rhs_nan = rhs[j] != rhs[j];
+                if (lhs_nan || rhs_nan)
+                {
+                    if (lhs_nan != rhs_nan)
+                    {
+                        return rhs_nan;
+                    }
+                }
+                else if (lhs[j] != rhs[j])
+                {
+                    return lhs[j] < rhs[j];
+                }
+            }
+            return false;
+        }
+    }
+
+    /**
+     * Hashes each row of a 2-D expression of integral or floating point
+     * values. Rows comparing equal have equal hashes, in particular -0 and
+     * +0 hash the same.
+     *
+     * The keys are hashed column by column, with a loop over the rows
+     * that the compiler vectorizes.
+     *
+     * @param e 2-D input xexpression
+     * @return the hash of each row
+     */
+    template <class E>
+    inline xtensor<std::size_t, 1> hash_rows(const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        const auto& de = e.derived_cast();
+        detail::check_row_keys(de);
+        xtensor<value_type, 2, layout_type::column_major> keys = de;
+        std::size_t n = keys.shape()[0];
+        auto res = xtensor<std::size_t, 1>::from_shape({n});
+        detail::hash_rows_impl(keys.data(), n, keys.shape()[1], std::size_t(1), n, res.data());
+        return res;
+    }
+
+    /**
+     * Result of group_rows.
+     */
+    struct row_groups
+    {
+        /**
+         * The first row of each group, the groups being numbered in order
+         * of first occurrence.
+         */
+        xtensor<std::size_t, 1> first;
+        /**
+         * The group of each row.
+         */
+        xtensor<std::size_t, 1> inverse;
+        /**
+         * The number of rows of each group.
+         */
+        xtensor<std::size_t, 1> counts;
+    };
+
+    /**
+     * Groups the equal rows of a 2-D expression, e.g. to implement a
+     * group-by on multi-column keys. The rows are hashed with hash_rows and
+     * only rows with equal hashes are compared, so that the grouping runs
+     * in linear time whatever the number of columns.
+     *
+     * @code{.cpp}
+     * xt::xtensor<int, 2> keys = {{1, 2}, {3, 4}, {1, 2}};
+     * auto g = xt::group_rows(keys);
+     * // g.first = {0, 1}, g.inverse = {0, 1, 0}, g.counts = {2, 1}
+     * @endcode
+     *
+     * @param e 2-D input xexpression of integral or floating point values
+     * @return a row_groups
+     */
+    template <class E>
+    inline row_groups group_rows(const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        const auto& de = e.derived_cast();
+        detail::check_row_keys(de);
+        xtensor<value_type, 2> keys = de;
+        std::vector<std::size_t> ids;
+        std::vector<std::size_t> firsts;
+        detail::group_row_ids(keys, ids, firsts);
+
+        row_groups res;
+        res.first = xtensor<std::size_t, 1>::from_shape({firsts.size()});
+        std::copy(firsts.cbegin(), firsts.cend(), res.first.begin());
+        res.inverse = xtensor<std::size_t, 1>::from_shape({ids.size()});
+        std::copy(ids.cbegin(), ids.cend(), res.inverse.begin());
+        res.counts = xtensor<std::size_t, 1>::from_shape({firsts.size()});
+        res.counts.fill(0);
+        for (std::size_t id : ids)
+        {
+            ++res.counts(id);
+        }
+        return res;
+    }
+
+    /**
+     * Find the unique rows of a 2-D expression, as with
+     * ``np.unique(e, axis=0)``. The distinct rows are found with
+     * group_rows, then only them are sorted in lexicographic order.
+     *
+     * @param e 2-D input xexpression of integral or floating point values
+     * @return the sorted unique rows
+     */
+    template <class E>
+    inline auto unique_rows(const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        const auto& de = e.derived_cast();
+        detail::check_row_keys(de);
+        xtensor<value_type, 2> keys = de;
+        std::vector<std::size_t> ids;
+        std::vector<std::size_t> firsts;
+        detail::group_row_ids(keys, ids, firsts);
+
+        std::size_t m = keys.shape()[1];
+        const value_type* data = keys.data();
+        std::sort(firsts.begin(), firsts.end(), [data, m](std::size_t lhs, std::size_t rhs)
+        {
+            return detail::row_less(data + lhs * m, data + rhs * m, m);
+        });
+        auto res = xtensor<value_type, 2>::from_shape({firsts.size(), m});
+        for (std::size_t g = 0; g < firsts.size(); ++g)
+        {
+            std::copy(data + firsts[g] * m, data + (firsts[g] + 1) * m, res.data() + g * m);
+        }
+        return res;
+    }
+
     /**
      * Find the set difference of two xexpressions. This returns a flattened xtensor with
      * the sorted, unique values in ar1 that are not in ar2.
      *
+     * The values of ar2 are gathered in a hash set, and only the values
+     * of ar1 that are kept are sorted.
+     *
      * @param ar1 input xexpression (will be flattened)
      * @param ar2 input xexpression
      */
@@ -921,23 +2614,26 @@ namespace xt
     {
         using value_type = typename E1::value_type;
 
-        auto unique1 = unique(ar1);
-        auto unique2 = unique(ar2);
-
-        auto tmp = xtensor<value_type, 1>::from_shape({unique1.size()});
-
-        auto end = std::set_difference(
-            unique1.begin(), unique1.end(),
-            unique2.begin(), unique2.end(),
-            tmp.begin()
-        );
-
-        std::size_t sz = static_cast<std::size_t>(std::distance(tmp.begin(), end));
-
-        auto result = xtensor<value_type, 1>::from_shape({sz});
+        const auto& d2 = ar2.derived_cast();
+        detail::hash_set<value_type> excluded(d2.size());
+        for (auto it = d2.cbegin(); it != d2.cend(); ++it)
+        {
+            excluded.insert(static_cast<value_type>(*it));
+        }
 
-        std::copy(tmp.begin(), end, result.begin());
+        const auto& d1 = ar1.derived_cast();
+        detail::hash_set<value_type> kept;
+        for (auto it = d1.cbegin(); it != d1.cend(); ++it)
+        {
+            if (!excluded.contains(*it))
+            {
+                kept.insert(*it);
+            }
+        }
 
+        auto result = xtensor<value_type, 1>::from_shape({kept.size()});
+        std::copy(kept.values().cbegin(), kept.values().cend(), result.begin());
+        detail::sort_range(result.data(), result.data() + result.size());
         return result;
     }
 }
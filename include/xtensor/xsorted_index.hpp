@@ -0,0 +1,291 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SORTED_INDEX_HPP
+#define XTENSOR_SORTED_INDEX_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xexpression.hpp"
+#include "xstorage.hpp"
+#include "xtensor_config.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /*************************
+     * sorted search kernels *
+     *************************/
+
+    namespace detail
+    {
+        // Number of queries searched together in a sorted array. All of
+        // them go through the same number of halving steps, so that their
+        // probes are independent loads overlapped by the processor, and the
+        // loop over the queries can be vectorized with gathers.
+        constexpr std::size_t search_batch = 16;
+
+        inline void search_prefetch(const void* p) noexcept
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(p);
+#else
+            (void) p;
+#endif
+        }
+
+        // Returns true if the position of q is after x, i.e. x < q for a
+        // lower bound and !(q < x) for an upper bound
+        template <bool Right, class T, class V>
+        inline bool search_after(const T& x, const V& q)
+        {
+            return Right ? !(q < x) : x < q;
+        }
+
+        // Stores in pos the lower bounds (upper bounds if Right) of the m
+        // queries q in the sorted array [a, a + n), with a branchless binary
+        // search. m must not exceed search_batch.
+        template <bool Right, class T, class V>
+        inline void batch_search(const T* a, std::size_t n, const V* q, std::size_t m, std::size_t* pos)
+        {
+            std::fill(pos, pos + m, std::size_t(0));
+            if (n == 0)
+            {
+                return;
+            }
+            for (std::size_t len = n; len > 1;)
+            {
+                std::size_t half = len / 2;
+                for (std::size_t b = 0; b < m; ++b)
+                {
+                    pos[b] += search_after<Right>(a[pos[b] + half - 1], q[b]) ? half : std::size_t(0);
+                }
+                len -= half;
+            }
+            for (std::size_t b = 0; b < m; ++b)
+            {
+                pos[b] += search_after<Right>(a[pos[b]], q[b]) ? std::size_t(1) : std::size_t(0);
+            }
+        }
+
+        // Calls f(i, q, p) for the i-th query q of [first, last), p being
+        // its lower bound (upper bound if Right) in [a, a + n). The queries
+        // are searched by batches.
+        template <bool Right, class T, class It, class F>
+        inline void for_each_search(const T* a, std::size_t n, It first, It last, F&& f)
+        {
+            using query_type = std::decay_t<decltype(*first)>;
+            std::array<query_type, search_batch> q;
+            std::array<std::size_t, search_batch> pos;
+            std::size_t i = 0;
+            while (first != last)
+            {
+                std::size_t m = 0;
+                for (; m < search_batch && first != last; ++m, ++first)
+                {
+                    q[m] = *first;
+                }
+                batch_search<Right>(a, n, q.data(), m, pos.data());
+                for (std::size_t b = 0; b < m; ++b)
+                {
+                    f(i + b, q[b], pos[b]);
+                }
+                i += m;
+            }
+        }
+
+        template <class E, class F>
+        inline auto apply_on_contiguous(const E& e, F&& f, std::true_type)
+        {
+            if (e.dimension() == 1 && (e.size() <= 1 || e.strides()[0] == 1))
+            {
+                return f(e.data() + e.data_offset(), e.size());
+            }
+            uvector<typename E::value_type> values(e.size());
+            std::copy(e.cbegin(), e.cend(), values.begin());
+            return f(values.data(), values.size());
+        }
+
+        template <class E, class F>
+        inline auto apply_on_contiguous(const E& e, F&& f, std::false_type)
+        {
+            uvector<typename E::value_type> values(e.size());
+            std::copy(e.cbegin(), e.cend(), values.begin());
+            return f(values.data(), values.size());
+        }
+
+        // Calls f(data, size) with the elements of e stored contiguously,
+        // copying them if e is not a contiguous 1-D expression
+        template <class E, class F>
+        inline auto apply_on_contiguous(const E& e, F&& f)
+        {
+            return apply_on_contiguous(e, std::forward<F>(f), has_data_interface<E>());
+        }
+    }
+
+    /*****************
+     * xsorted_index *
+     *****************/
+
+    /**
+     * @class xsorted_index
+     * @brief Search index over sorted values.
+     *
+     * The xsorted_index class stores sorted values in the Eytzinger layout,
+     * i.e. the breadth-first order of a balanced binary search tree, so that
+     * the successive probes of a search are close in memory and the probes
+     * of the next levels can be prefetched. It is meant to be built once and
+     * reused to search many values, e.g. with searchsorted.
+     *
+     * @tparam T the value type of the sorted values
+     */
+    template <class T>
+    class xsorted_index
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+
+        template <class E>
+        explicit xsorted_index(const xexpression<E>& sorted);
+
+        size_type size() const noexcept;
+
+        template <class V>
+        size_type lower_bound(const V& v) const;
+
+        template <class V>
+        size_type upper_bound(const V& v) const;
+
+    private:
+
+        template <bool Right, class V>
+        size_type search(const V& v) const;
+
+        void build(const value_type* values, size_type& rank, size_type k);
+
+        // 1-based tree, the node k having the children 2k and 2k + 1
+        std::vector<value_type> m_tree;
+        std::vector<size_type> m_rank;
+    };
+
+    template <class E>
+    xsorted_index<typename E::value_type> make_sorted_index(const xexpression<E>& sorted);
+
+    /********************************
+     * xsorted_index implementation *
+     ********************************/
+
+    /**
+     * Builds the index of the values of \c sorted, which must be a 1-D
+     * expression sorted in increasing order.
+     */
+    template <class T>
+    template <class E>
+    inline xsorted_index<T>::xsorted_index(const xexpression<E>& sorted)
+        : m_tree(), m_rank()
+    {
+        const auto& de = sorted.derived_cast();
+        XTENSOR_ASSERT(de.dimension() == 1);
+        XTENSOR_ASSERT(std::is_sorted(de.cbegin(), de.cend()));
+        m_tree.resize(de.size() + 1);
+        m_rank.resize(de.size() + 1);
+        uvector<value_type> values(de.size());
+        std::copy(de.cbegin(), de.cend(), values.begin());
+        size_type rank = 0;
+        build(values.data(), rank, 1);
+    }
+
+    /**
+     * Returns the number of indexed values.
+     */
+    template <class T>
+    inline auto xsorted_index<T>::size() const noexcept -> size_type
+    {
+        return m_tree.size() - 1;
+    }
+
+    /**
+     * Returns the position of the first indexed value that is not less
+     * than \c v, as std::lower_bound.
+     */
+    template <class T>
+    template <class V>
+    inline auto xsorted_index<T>::lower_bound(const V& v) const -> size_type
+    {
+        return search<false>(v);
+    }
+
+    /**
+     * Returns the position of the first indexed value that is greater
+     * than \c v, as std::upper_bound.
+     */
+    template <class T>
+    template <class V>
+    inline auto xsorted_index<T>::upper_bound(const V& v) const -> size_type
+    {
+        return search<true>(v);
+    }
+
+    template <class T>
+    template <bool Right, class V>
+    inline auto xsorted_index<T>::search(const V& v) const -> size_type
+    {
+        const value_type* tree = m_tree.data();
+        size_type n = size();
+        size_type k = 1;
+        while (k <= n)
+        {
+            // The 16 descendants of k four levels below are contiguous
+            detail::search_prefetch(tree + (std::min)(16 * k, n));
+            k = 2 * k + (detail::search_after<Right>(tree[k], v) ? 1 : 0);
+        }
+        // The last step to the left leads to the result: the moves to the
+        // right taken after it are removed with it.
+        while (k & 1)
+        {
+            k >>= 1;
+        }
+        k >>= 1;
+        return k == 0 ? n : m_rank[k];
+    }
+
+    // Fills the subtree of the node k by an in-order traversal, rank being
+    // the position of the next sorted value
+    template <class T>
+    inline void xsorted_index<T>::build(const value_type* values, size_type& rank, size_type k)
+    {
+        if (k < m_tree.size())
+        {
+            build(values, rank, 2 * k);
+            m_tree[k] = values[rank];
+            m_rank[k] = rank++;
+            build(values, rank, 2 * k + 1);
+        }
+    }
+
+    /**
+     * Builds the xsorted_index of the values of \c sorted.
+     * @param sorted 1-D expression sorted in increasing order
+     */
+    template <class E>
+    inline xsorted_index<typename E::value_type> make_sorted_index(const xexpression<E>& sorted)
+    {
+        return xsorted_index<typename E::value_type>(sorted);
+    }
+}
+
+#endif
@@ -0,0 +1,1120 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SPARSE_HPP
+#define XTENSOR_SPARSE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xaccessible.hpp"
+#include "xarray.hpp"
+#include "xeval.hpp"
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xshape.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class T>
+    class xsparse_array;
+
+    template <class T>
+    class xcsr_matrix;
+
+    /****************
+     * xsparse_base *
+     ****************/
+
+    /**
+     * @class xsparse_base
+     * @brief Base class of the sparse containers.
+     *
+     * The xsparse_base class implements the read-only expression interface
+     * of the sparse containers: the elements that are not stored are zero.
+     * Sparse containers can therefore be used in any expression, and be
+     * assigned to dense containers; the functions of ``xsparse.hpp`` operate
+     * on their non-zero elements only.
+     *
+     * @tparam D the derived type, which provides a ``linear_value`` method
+     *           returning the element at a row-major flat index.
+     */
+    template <class D>
+    class xsparse_base : public xsharable_expression<D>,
+                         public xconst_iterable<D>,
+                         public xconst_accessible<D>
+    {
+    public:
+
+        using derived_type = D;
+
+        using accessible_base = xconst_accessible<D>;
+        using expression_tag = xtensor_expression_tag;
+
+        using inner_types = xcontainer_inner_types<D>;
+        using value_type = typename inner_types::value_type;
+        using reference = typename inner_types::reference;
+        using const_reference = typename inner_types::const_reference;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = typename inner_types::size_type;
+        using difference_type = std::ptrdiff_t;
+
+        using iterable_base = xconst_iterable<D>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using bool_load_type = xt::bool_load_type<value_type>;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+        bool is_contiguous() const noexcept;
+        using accessible_base::shape;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape, bool reuse_cache = false) const;
+
+        template <class O>
+        bool has_linear_assign(const O& /*strides*/) const noexcept;
+
+        template <class O>
+        const_stepper stepper_begin(const O& shape) const noexcept;
+        template <class O>
+        const_stepper stepper_end(const O& shape, layout_type) const noexcept;
+
+    protected:
+
+        xsparse_base() = default;
+        explicit xsparse_base(inner_shape_type shape);
+        ~xsparse_base() = default;
+
+        xsparse_base(const xsparse_base&) = default;
+        xsparse_base& operator=(const xsparse_base&) = default;
+
+        xsparse_base(xsparse_base&&) = default;
+        xsparse_base& operator=(xsparse_base&&) = default;
+
+        const inner_shape_type& linear_strides() const noexcept;
+        const derived_type& derived_cast() const noexcept;
+
+    private:
+
+        inner_shape_type m_shape;
+        // Row-major strides, not zeroed on the dimensions of length 1
+        inner_shape_type m_strides;
+    };
+
+    /*****************
+     * xsparse_array *
+     *****************/
+
+    template <class T>
+    struct xiterable_inner_types<xsparse_array<T>>
+    {
+        using inner_shape_type = dynamic_shape<std::size_t>;
+        using const_stepper = xindexed_stepper<xsparse_array<T>, true>;
+        using stepper = const_stepper;
+    };
+
+    template <class T>
+    struct xcontainer_inner_types<xsparse_array<T>>
+    {
+        using value_type = T;
+        using reference = T;
+        using const_reference = T;
+        using size_type = std::size_t;
+    };
+
+    /**
+     * @class xsparse_array
+     * @brief N-dimensional sparse array in coordinate format.
+     *
+     * The xsparse_array class stores the non-zero elements of an array of
+     * any dimension, as the sorted list of their row-major flat indices and
+     * the list of their values. Accessing an element is a binary search in
+     * the list of indices.
+     *
+     * \code{.cpp}
+     * xt::xarray<double> a = {{0., 2.}, {0., 0.}};
+     * xt::xsparse_array<double> s(a);     // one non-zero element
+     * auto t = xt::sparse_map([](double x) { return 2. * x; }, s);
+     * double total = xt::sparse_sum(t);   // 4.
+     * xt::xarray<double> b = s + a;       // dense expression
+     * \endcode
+     *
+     * @tparam T the value type of the elements
+     * @sa xcsr_matrix
+     */
+    template <class T>
+    class xsparse_array : public xsparse_base<xsparse_array<T>>
+    {
+    public:
+
+        using self_type = xsparse_array<T>;
+        using base_type = xsparse_base<self_type>;
+        using value_type = T;
+        using size_type = typename base_type::size_type;
+        using shape_type = typename base_type::shape_type;
+        using const_reference = typename base_type::const_reference;
+        using index_container = std::vector<size_type>;
+        using value_container = std::vector<value_type>;
+
+        xsparse_array() = default;
+        explicit xsparse_array(shape_type shape);
+        xsparse_array(shape_type shape, index_container indices, value_container values);
+
+        template <class E>
+        xsparse_array(const xexpression<E>& e);
+
+        explicit xsparse_array(const xcsr_matrix<T>& m);
+
+        size_type nnz() const noexcept;
+        const index_container& indices() const noexcept;
+        const value_container& values() const noexcept;
+        value_container& values() noexcept;
+        shape_type coords(size_type k) const;
+
+        void prune();
+        xarray<value_type> to_dense() const;
+
+        const_reference linear_value(size_type i) const;
+
+    private:
+
+        index_container m_indices;
+        value_container m_values;
+    };
+
+    /***************
+     * xcsr_matrix *
+     ***************/
+
+    template <class T>
+    struct xiterable_inner_types<xcsr_matrix<T>>
+    {
+        using inner_shape_type = dynamic_shape<std::size_t>;
+        using const_stepper = xindexed_stepper<xcsr_matrix<T>, true>;
+        using stepper = const_stepper;
+    };
+
+    template <class T>
+    struct xcontainer_inner_types<xcsr_matrix<T>>
+    {
+        using value_type = T;
+        using reference = T;
+        using const_reference = T;
+        using size_type = std::size_t;
+    };
+
+    /**
+     * @class xcsr_matrix
+     * @brief Two-dimensional sparse array in compressed sparse row format.
+     *
+     * The non-zero elements of the row ``i`` are stored in the range
+     * ``[indptr[i], indptr[i + 1])`` of the column index and value lists,
+     * sorted by column. This is the format of the sparse-dense products
+     * computed by sparse_dot.
+     *
+     * @tparam T the value type of the elements
+     * @sa xsparse_array
+     */
+    template <class T>
+    class xcsr_matrix : public xsparse_base<xcsr_matrix<T>>
+    {
+    public:
+
+        using self_type = xcsr_matrix<T>;
+        using base_type = xsparse_base<self_type>;
+        using value_type = T;
+        using size_type = typename base_type::size_type;
+        using shape_type = typename base_type::shape_type;
+        using const_reference = typename base_type::const_reference;
+        using index_container = std::vector<size_type>;
+        using value_container = std::vector<value_type>;
+
+        xcsr_matrix() = default;
+        xcsr_matrix(size_type rows, size_type cols);
+        xcsr_matrix(size_type rows, size_type cols, index_container indptr,
+                    index_container indices, value_container values);
+
+        template <class E>
+        xcsr_matrix(const xexpression<E>& e);
+
+        explicit xcsr_matrix(const xsparse_array<T>& s);
+
+        size_type nnz() const noexcept;
+        const index_container& indptr() const noexcept;
+        const index_container& indices() const noexcept;
+        const value_container& values() const noexcept;
+        value_container& values() noexcept;
+
+        xarray<value_type> to_dense() const;
+
+        const_reference linear_value(size_type i) const;
+
+    private:
+
+        static shape_type matrix_shape(const xsparse_array<T>& s);
+
+        index_container m_indptr;
+        index_container m_indices;
+        value_container m_values;
+    };
+
+    /*************
+     * functions *
+     *************/
+
+    template <class F, class T>
+    auto sparse_map(F&& f, const xsparse_array<T>& s);
+
+    template <class F, class T1, class T2>
+    auto sparse_apply(F&& f, const xsparse_array<T1>& a, const xsparse_array<T2>& b);
+
+    template <class T1, class T2>
+    auto sparse_add(const xsparse_array<T1>& a, const xsparse_array<T2>& b);
+
+    template <class T1, class T2>
+    auto sparse_subtract(const xsparse_array<T1>& a, const xsparse_array<T2>& b);
+
+    template <class T1, class T2>
+    auto sparse_multiply(const xsparse_array<T1>& a, const xsparse_array<T2>& b);
+
+    template <class T, class E>
+    auto sparse_multiply(const xsparse_array<T>& a, const xexpression<E>& e);
+
+    template <class T>
+    T sparse_sum(const xsparse_array<T>& s);
+
+    template <class T>
+    xarray<T> sparse_sum(const xsparse_array<T>& s, std::size_t axis);
+
+    template <class T, class E>
+    auto sparse_dot(const xcsr_matrix<T>& m, const xexpression<E>& e);
+
+    template <class T, class E>
+    auto sparse_dot(const xsparse_array<T>& s, const xexpression<E>& e);
+
+    /*******************************
+     * xsparse_base implementation *
+     *******************************/
+
+    template <class D>
+    inline xsparse_base<D>::xsparse_base(inner_shape_type shape)
+        : m_shape(std::move(shape)), m_strides(m_shape.size())
+    {
+        size_type stride = 1;
+        for (std::size_t i = m_shape.size(); i != 0; --i)
+        {
+            m_strides[i - 1] = stride;
+            stride *= m_shape[i - 1];
+        }
+    }
+
+    /**
+     * Returns the shape of the sparse array.
+     */
+    template <class D>
+    inline auto xsparse_base<D>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class D>
+    inline layout_type xsparse_base<D>::layout() const noexcept
+    {
+        return static_layout;
+    }
+
+    template <class D>
+    inline bool xsparse_base<D>::is_contiguous() const noexcept
+    {
+        return false;
+    }
+
+    /**
+     * Returns the element at the specified position, zero if it is not stored.
+     * @param args a list of indices specifying the position in the array. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the array.
+     */
+    template <class D>
+    template <class... Args>
+    inline auto xsparse_base<D>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {static_cast<size_type>(args)...};
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns the element at the specified position, zero if it is not stored.
+     * The number of indices must be equal to the number of dimensions of the array.
+     */
+    template <class D>
+    template <class... Args>
+    inline auto xsparse_base<D>::unchecked(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {static_cast<size_type>(args)...};
+        size_type offset = 0;
+        for (std::size_t i = 0; i < index.size(); ++i)
+        {
+            offset += index[i] * m_strides[i];
+        }
+        return derived_cast().linear_value(offset);
+    }
+
+    /**
+     * Returns the element at the specified position, zero if it is not stored.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the array.
+     */
+    template <class D>
+    template <class It>
+    inline auto xsparse_base<D>::element(It first, It last) const -> const_reference
+    {
+        XTENSOR_TRY(check_element_index(shape(), first, last));
+        auto n = static_cast<std::size_t>(std::distance(first, last));
+        std::size_t dim = std::min(n, m_shape.size());
+        std::advance(first, static_cast<std::ptrdiff_t>(n - dim));
+        size_type offset = 0;
+        for (std::size_t i = m_shape.size() - dim; i < m_shape.size(); ++i, ++first)
+        {
+            // Broadcast dimensions of length 1
+            if (m_shape[i] != 1)
+            {
+                offset += static_cast<size_type>(*first) * m_strides[i];
+            }
+        }
+        return derived_cast().linear_value(offset);
+    }
+
+    template <class D>
+    template <class O>
+    inline bool xsparse_base<D>::broadcast_shape(O& shape, bool) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    template <class D>
+    template <class O>
+    inline bool xsparse_base<D>::has_linear_assign(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+
+    template <class D>
+    template <class O>
+    inline auto xsparse_base<D>::stepper_begin(const O& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - this->dimension();
+        return const_stepper(&derived_cast(), offset);
+    }
+
+    template <class D>
+    template <class O>
+    inline auto xsparse_base<D>::stepper_end(const O& shape, layout_type) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - this->dimension();
+        return const_stepper(&derived_cast(), offset, true);
+    }
+
+    template <class D>
+    inline auto xsparse_base<D>::linear_strides() const noexcept -> const inner_shape_type&
+    {
+        return m_strides;
+    }
+
+    template <class D>
+    inline auto xsparse_base<D>::derived_cast() const noexcept -> const derived_type&
+    {
+        return *static_cast<const derived_type*>(this);
+    }
+
+    /********************************
+     * xsparse_array implementation *
+     ********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty sparse array, i.e. with only zero elements,
+     * with the specified shape.
+     * @param shape the shape of the array
+     */
+    template <class T>
+    inline xsparse_array<T>::xsparse_array(shape_type shape)
+        : base_type(std::move(shape))
+    {
+    }
+
+    /**
+     * Constructs a sparse array from a list of row-major flat indices and
+     * the list of the corresponding values. The indices do not need to be
+     * sorted, the values of repeated indices are summed.
+     * @param shape the shape of the array
+     * @param indices the flat indices of the elements
+     * @param values the values of the elements
+     */
+    template <class T>
+    inline xsparse_array<T>::xsparse_array(shape_type shape, index_container indices, value_container values)
+        : base_type(std::move(shape))
+    {
+        if (indices.size() != values.size())
+        {
+            XTENSOR_THROW(std::runtime_error, "xsparse_array: indices and values must have the same size");
+        }
+        size_type size = this->size();
+        if (std::any_of(indices.cbegin(), indices.cend(), [size](size_type i) { return i >= size; }))
+        {
+            XTENSOR_THROW(std::out_of_range, "xsparse_array: index out of bounds");
+        }
+        if (std::is_sorted(indices.cbegin(), indices.cend()) &&
+            std::adjacent_find(indices.cbegin(), indices.cend()) == indices.cend())
+        {
+            m_indices = std::move(indices);
+            m_values = std::move(values);
+            return;
+        }
+        std::vector<size_type> order(indices.size());
+        std::iota(order.begin(), order.end(), size_type(0));
+        std::stable_sort(order.begin(), order.end(),
+                         [&indices](size_type i, size_type j) { return indices[i] < indices[j]; });
+        m_indices.reserve(order.size());
+        m_values.reserve(order.size());
+        for (size_type k : order)
+        {
+            if (!m_indices.empty() && m_indices.back() == indices[k])
+            {
+                m_values.back() += values[k];
+            }
+            else
+            {
+                m_indices.push_back(indices[k]);
+                m_values.push_back(values[k]);
+            }
+        }
+    }
+
+    /**
+     * Constructs a sparse array holding the non-zero elements of
+     * a dense expression.
+     * @param e the expression to gather
+     */
+    template <class T>
+    template <class E>
+    inline xsparse_array<T>::xsparse_array(const xexpression<E>& e)
+        : base_type(shape_type(e.derived_cast().shape().cbegin(), e.derived_cast().shape().cend()))
+    {
+        const auto& de = e.derived_cast();
+        size_type i = 0;
+        auto last = de.template cend<layout_type::row_major>();
+        for (auto it = de.template cbegin<layout_type::row_major>(); it != last; ++it, ++i)
+        {
+            value_type v = static_cast<value_type>(*it);
+            if (v != value_type(0))
+            {
+                m_indices.push_back(i);
+                m_values.push_back(v);
+            }
+        }
+    }
+
+    /**
+     * Constructs a sparse array in coordinate format from a CSR matrix.
+     */
+    template <class T>
+    inline xsparse_array<T>::xsparse_array(const xcsr_matrix<T>& m)
+        : base_type(m.shape()), m_values(m.values())
+    {
+        size_type cols = m.shape()[1];
+        m_indices.reserve(m.nnz());
+        for (size_type r = 0; r + 1 < m.indptr().size(); ++r)
+        {
+            for (size_type k = m.indptr()[r]; k < m.indptr()[r + 1]; ++k)
+            {
+                m_indices.push_back(r * cols + m.indices()[k]);
+            }
+        }
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the number of stored elements.
+     */
+    template <class T>
+    inline auto xsparse_array<T>::nnz() const noexcept -> size_type
+    {
+        return m_indices.size();
+    }
+
+    /**
+     * Returns the sorted row-major flat indices of the stored elements.
+     */
+    template <class T>
+    inline auto xsparse_array<T>::indices() const noexcept -> const index_container&
+    {
+        return m_indices;
+    }
+
+    /**
+     * Returns the values of the stored elements.
+     */
+    template <class T>
+    inline auto xsparse_array<T>::values() const noexcept -> const value_container&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the values of the stored elements. Values set to zero
+     * remain stored until prune is called.
+     */
+    template <class T>
+    inline auto xsparse_array<T>::values() noexcept -> value_container&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the multi-dimensional index of the k-th stored element.
+     */
+    template <class T>
+    inline auto xsparse_array<T>::coords(size_type k) const -> shape_type
+    {
+        const auto& strides = linear_strides();
+        shape_type res(strides.size());
+        size_type index = m_indices[k];
+        for (std::size_t i = 0; i < strides.size(); ++i)
+        {
+            res[i] = index / strides[i];
+            index -= res[i] * strides[i];
+        }
+        return res;
+    }
+
+    /**
+     * Removes the stored elements equal to zero.
+     */
+    template <class T>
+    inline void xsparse_array<T>::prune()
+    {
+        size_type j = 0;
+        for (size_type k = 0; k < m_values.size(); ++k)
+        {
+            if (m_values[k] != value_type(0))
+            {
+                m_indices[j] = m_indices[k];
+                m_values[j] = m_values[k];
+                ++j;
+            }
+        }
+        m_indices.resize(j);
+        m_values.resize(j);
+    }
+
+    /**
+     * Returns a dense array holding the elements of the sparse array.
+     */
+    template <class T>
+    inline xarray<T> xsparse_array<T>::to_dense() const
+    {
+        xarray<value_type> res = xarray<value_type>::from_shape(this->shape());
+        std::fill(res.data(), res.data() + res.size(), value_type(0));
+        for (size_type k = 0; k < m_indices.size(); ++k)
+        {
+            res.data()[m_indices[k]] = m_values[k];
+        }
+        return res;
+    }
+
+    /**
+     * Returns the element at the specified row-major flat index,
+     * zero if it is not stored.
+     */
+    template <class T>
+    inline auto xsparse_array<T>::linear_value(size_type i) const -> const_reference
+    {
+        auto it = std::lower_bound(m_indices.cbegin(), m_indices.cend(), i);
+        if (it == m_indices.cend() || *it != i)
+        {
+            return value_type(0);
+        }
+        return m_values[static_cast<size_type>(it - m_indices.cbegin())];
+    }
+    //@}
+
+    /******************************
+     * xcsr_matrix implementation *
+     ******************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty CSR matrix with the specified number of rows and columns.
+     */
+    template <class T>
+    inline xcsr_matrix<T>::xcsr_matrix(size_type rows, size_type cols)
+        : base_type(shape_type({rows, cols})), m_indptr(rows + 1, size_type(0))
+    {
+    }
+
+    /**
+     * Constructs a CSR matrix from its row pointers, column indices and values.
+     * The column indices of each row must be sorted and unique.
+     */
+    template <class T>
+    inline xcsr_matrix<T>::xcsr_matrix(size_type rows, size_type cols, index_container indptr,
+                                       index_container indices, value_container values)
+        : base_type(shape_type({rows, cols})),
+          m_indptr(std::move(indptr)),
+          m_indices(std::move(indices)),
+          m_values(std::move(values))
+    {
+        if (m_indptr.size() != rows + 1 || m_indptr.back() != m_indices.size() ||
+            m_indices.size() != m_values.size())
+        {
+            XTENSOR_THROW(std::runtime_error, "xcsr_matrix: inconsistent indptr, indices and values");
+        }
+    }
+
+    /**
+     * Constructs a CSR matrix holding the non-zero elements of
+     * a two-dimensional expression.
+     */
+    template <class T>
+    template <class E>
+    inline xcsr_matrix<T>::xcsr_matrix(const xexpression<E>& e)
+        : xcsr_matrix(xsparse_array<T>(e))
+    {
+    }
+
+    /**
+     * Constructs a CSR matrix from a two-dimensional sparse array.
+     */
+    template <class T>
+    inline xcsr_matrix<T>::xcsr_matrix(const xsparse_array<T>& s)
+        : base_type(matrix_shape(s)),
+          m_indptr(s.shape()[0] + 1, size_type(0)),
+          m_indices(s.nnz()),
+          m_values(s.values())
+    {
+        size_type cols = s.shape()[1];
+        for (size_type k = 0; k < s.nnz(); ++k)
+        {
+            size_type i = s.indices()[k];
+            ++m_indptr[i / cols + 1];
+            m_indices[k] = i % cols;
+        }
+        std::partial_sum(m_indptr.begin(), m_indptr.end(), m_indptr.begin());
+    }
+    //@}
+
+    template <class T>
+    inline auto xcsr_matrix<T>::matrix_shape(const xsparse_array<T>& s) -> shape_type
+    {
+        if (s.dimension() != 2)
+        {
+            XTENSOR_THROW(std::runtime_error, "xcsr_matrix: expected a two-dimensional array");
+        }
+        return s.shape();
+    }
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the number of stored elements.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::nnz() const noexcept -> size_type
+    {
+        return m_indices.size();
+    }
+
+    /**
+     * Returns the row pointers, of size the number of rows plus one.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::indptr() const noexcept -> const index_container&
+    {
+        return m_indptr;
+    }
+
+    /**
+     * Returns the column indices of the stored elements.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::indices() const noexcept -> const index_container&
+    {
+        return m_indices;
+    }
+
+    /**
+     * Returns the values of the stored elements.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::values() const noexcept -> const value_container&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns the values of the stored elements.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::values() noexcept -> value_container&
+    {
+        return m_values;
+    }
+
+    /**
+     * Returns a dense array holding the elements of the matrix.
+     */
+    template <class T>
+    inline xarray<T> xcsr_matrix<T>::to_dense() const
+    {
+        xarray<value_type> res = xarray<value_type>::from_shape(this->shape());
+        std::fill(res.data(), res.data() + res.size(), value_type(0));
+        size_type cols = this->shape()[1];
+        for (size_type r = 0; r + 1 < m_indptr.size(); ++r)
+        {
+            for (size_type k = m_indptr[r]; k < m_indptr[r + 1]; ++k)
+            {
+                res.data()[r * cols + m_indices[k]] = m_values[k];
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Returns the element at the specified row-major flat index,
+     * zero if it is not stored.
+     */
+    template <class T>
+    inline auto xcsr_matrix<T>::linear_value(size_type i) const -> const_reference
+    {
+        size_type cols = this->shape()[1];
+        size_type r = i / cols;
+        size_type c = i - r * cols;
+        auto first = m_indices.cbegin() + static_cast<std::ptrdiff_t>(m_indptr[r]);
+        auto last = m_indices.cbegin() + static_cast<std::ptrdiff_t>(m_indptr[r + 1]);
+        auto it = std::lower_bound(first, last, c);
+        if (it == last || *it != c)
+        {
+            return value_type(0);
+        }
+        return m_values[static_cast<size_type>(it - m_indices.cbegin())];
+    }
+    //@}
+
+    /****************************
+     * functions implementation *
+     ****************************/
+
+    namespace detail
+    {
+        template <class S1, class S2>
+        inline void check_sparse_shapes(const S1& s1, const S2& s2)
+        {
+            if (s1.size() != s2.size() || !std::equal(s1.cbegin(), s1.cend(), s2.cbegin()))
+            {
+                throw_broadcast_error(s1, s2);
+            }
+        }
+    }
+
+    /**
+     * Applies a function to the elements of a sparse array. When the function
+     * maps zero to zero, it is only evaluated on the stored elements; otherwise
+     * every element of the result is stored.
+     * @param f the function to apply
+     * @param s the sparse array
+     * @return an xsparse_array holding the result
+     */
+    template <class F, class T>
+    inline auto sparse_map(F&& f, const xsparse_array<T>& s)
+    {
+        using value_type = std::decay_t<decltype(f(std::declval<T>()))>;
+        using size_type = typename xsparse_array<T>::size_type;
+        typename xsparse_array<value_type>::index_container indices;
+        typename xsparse_array<value_type>::value_container values;
+        value_type fill = f(T(0));
+        if (fill == value_type(0))
+        {
+            indices = s.indices();
+            values.reserve(s.nnz());
+            for (const auto& v : s.values())
+            {
+                values.push_back(f(v));
+            }
+        }
+        else
+        {
+            size_type size = s.size();
+            indices.resize(size);
+            std::iota(indices.begin(), indices.end(), size_type(0));
+            values.assign(size, fill);
+            for (size_type k = 0; k < s.nnz(); ++k)
+            {
+                values[s.indices()[k]] = f(s.values()[k]);
+            }
+        }
+        return xsparse_array<value_type>(s.shape(), std::move(indices), std::move(values));
+    }
+
+    /**
+     * Applies a binary function to the elements of two sparse arrays of the same
+     * shape. The function must map a pair of zeros to zero; it is evaluated on the
+     * union of the stored elements of both arrays, and the zero results are not stored.
+     * @param f the function to apply
+     * @param a the first sparse array
+     * @param b the second sparse array
+     * @return an xsparse_array holding the result
+     */
+    template <class F, class T1, class T2>
+    inline auto sparse_apply(F&& f, const xsparse_array<T1>& a, const xsparse_array<T2>& b)
+    {
+        using value_type = std::decay_t<decltype(f(std::declval<T1>(), std::declval<T2>()))>;
+        using size_type = typename xsparse_array<T1>::size_type;
+        detail::check_sparse_shapes(a.shape(), b.shape());
+        if (f(T1(0), T2(0)) != value_type(0))
+        {
+            XTENSOR_THROW(std::runtime_error, "sparse_apply: the function must map zeros to zero");
+        }
+        typename xsparse_array<value_type>::index_container indices;
+        typename xsparse_array<value_type>::value_container values;
+        indices.reserve(std::max(a.nnz(), b.nnz()));
+        values.reserve(std::max(a.nnz(), b.nnz()));
+        auto push = [&indices, &values](size_type i, value_type v)
+        {
+            if (v != value_type(0))
+            {
+                indices.push_back(i);
+                values.push_back(v);
+            }
+        };
+        size_type i = 0, j = 0;
+        while (i < a.nnz() || j < b.nnz())
+        {
+            if (j == b.nnz() || (i < a.nnz() && a.indices()[i] < b.indices()[j]))
+            {
+                push(a.indices()[i], f(a.values()[i], T2(0)));
+                ++i;
+            }
+            else if (i == a.nnz() || b.indices()[j] < a.indices()[i])
+            {
+                push(b.indices()[j], f(T1(0), b.values()[j]));
+                ++j;
+            }
+            else
+            {
+                push(a.indices()[i], f(a.values()[i], b.values()[j]));
+                ++i, ++j;
+            }
+        }
+        return xsparse_array<value_type>(a.shape(), std::move(indices), std::move(values));
+    }
+
+    /**
+     * Returns the element-wise sum of two sparse arrays of the same shape.
+     */
+    template <class T1, class T2>
+    inline auto sparse_add(const xsparse_array<T1>& a, const xsparse_array<T2>& b)
+    {
+        return sparse_apply([](const T1& x, const T2& y) { return x + y; }, a, b);
+    }
+
+    /**
+     * Returns the element-wise difference of two sparse arrays of the same shape.
+     */
+    template <class T1, class T2>
+    inline auto sparse_subtract(const xsparse_array<T1>& a, const xsparse_array<T2>& b)
+    {
+        return sparse_apply([](const T1& x, const T2& y) { return x - y; }, a, b);
+    }
+
+    /**
+     * Returns the element-wise product of two sparse arrays of the same shape.
+     */
+    template <class T1, class T2>
+    inline auto sparse_multiply(const xsparse_array<T1>& a, const xsparse_array<T2>& b)
+    {
+        return sparse_apply([](const T1& x, const T2& y) { return x * y; }, a, b);
+    }
+
+    /**
+     * Returns the element-wise product of a sparse array and a dense expression
+     * of the same shape, as a sparse array. The expression is only evaluated
+     * at the positions of the stored elements.
+     */
+    template <class T, class E>
+    inline auto sparse_multiply(const xsparse_array<T>& a, const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<decltype(std::declval<T>() * std::declval<typename E::value_type>())>;
+        using size_type = typename xsparse_array<T>::size_type;
+        const auto& de = e.derived_cast();
+        detail::check_sparse_shapes(a.shape(), de.shape());
+        typename xsparse_array<value_type>::index_container indices;
+        typename xsparse_array<value_type>::value_container values;
+        indices.reserve(a.nnz());
+        values.reserve(a.nnz());
+        for (size_type k = 0; k < a.nnz(); ++k)
+        {
+            auto index = a.coords(k);
+            value_type v = a.values()[k] * de.element(index.cbegin(), index.cend());
+            if (v != value_type(0))
+            {
+                indices.push_back(a.indices()[k]);
+                values.push_back(v);
+            }
+        }
+        return xsparse_array<value_type>(a.shape(), std::move(indices), std::move(values));
+    }
+
+    /**
+     * Returns the sum of the elements of a sparse array, computed over
+     * its stored elements.
+     */
+    template <class T>
+    inline T sparse_sum(const xsparse_array<T>& s)
+    {
+        return std::accumulate(s.values().cbegin(), s.values().cend(), T(0));
+    }
+
+    /**
+     * Returns the sums of the elements of a sparse array along an axis, as a
+     * dense array, computed over its stored elements.
+     * @param s the sparse array
+     * @param axis the axis to reduce
+     */
+    template <class T>
+    inline xarray<T> sparse_sum(const xsparse_array<T>& s, std::size_t axis)
+    {
+        using size_type = typename xsparse_array<T>::size_type;
+        if (axis >= s.dimension())
+        {
+            XTENSOR_THROW(std::out_of_range, "sparse_sum: axis out of bounds");
+        }
+        typename xarray<T>::shape_type shape(s.dimension() - 1);
+        size_type inner = 1;
+        for (std::size_t i = 0, j = 0; i < s.dimension(); ++i)
+        {
+            if (i != axis)
+            {
+                shape[j++] = s.shape()[i];
+            }
+            if (i > axis)
+            {
+                inner *= s.shape()[i];
+            }
+        }
+        size_type outer = inner * s.shape()[axis];
+        xarray<T> res = xarray<T>::from_shape(shape);
+        std::fill(res.data(), res.data() + res.size(), T(0));
+        for (size_type k = 0; k < s.nnz(); ++k)
+        {
+            size_type i = s.indices()[k];
+            res.data()[(i / outer) * inner + i % inner] += s.values()[k];
+        }
+        return res;
+    }
+
+    /**
+     * Computes the product of a CSR matrix and a dense vector or matrix.
+     * @param m the CSR matrix, of shape ``(M, N)``
+     * @param e a dense expression of shape ``(N,)`` or ``(N, K)``
+     * @return a dense array of shape ``(M,)`` or ``(M, K)``
+     */
+    template <class T, class E>
+    inline auto sparse_dot(const xcsr_matrix<T>& m, const xexpression<E>& e)
+    {
+        using value_type = std::decay_t<decltype(std::declval<T>() * std::declval<typename E::value_type>())>;
+        using size_type = typename xcsr_matrix<T>::size_type;
+        const auto& de = e.derived_cast();
+        size_type rows = m.shape()[0];
+        size_type cols = m.shape()[1];
+        if (de.dimension() == 0 || de.dimension() > 2 || de.shape()[0] != cols)
+        {
+            XTENSOR_THROW(std::runtime_error, "sparse_dot: incompatible shapes");
+        }
+        size_type k = de.dimension() == 2 ? de.shape()[1] : size_type(1);
+        xarray<value_type, layout_type::row_major> x = de;
+        typename xarray<value_type>::shape_type shape = {rows};
+        if (de.dimension() == 2)
+        {
+            shape.push_back(k);
+        }
+        xarray<value_type> res = xarray<value_type>::from_shape(shape);
+        std::fill(res.data(), res.data() + res.size(), value_type(0));
+        const auto& indptr = m.indptr();
+        const auto& indices = m.indices();
+        const auto& values = m.values();
+        for (size_type r = 0; r < rows; ++r)
+        {
+            value_type* out = res.data() + r * k;
+            for (size_type p = indptr[r]; p < indptr[r + 1]; ++p)
+            {
+                const value_type* in = x.data() + indices[p] * k;
+                value_type v = static_cast<value_type>(values[p]);
+                for (size_type j = 0; j < k; ++j)
+                {
+                    out[j] += v * in[j];
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Computes the product of a two-dimensional sparse array and a dense
+     * vector or matrix, through its CSR representation.
+     */
+    template <class T, class E>
+    inline auto sparse_dot(const xsparse_array<T>& s, const xexpression<E>& e)
+    {
+        return sparse_dot(xcsr_matrix<T>(s), e);
+    }
+}
+
+#endif
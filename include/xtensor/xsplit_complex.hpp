@@ -0,0 +1,432 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_SPLIT_COMPLEX_HPP
+#define XTENSOR_SPLIT_COMPLEX_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xsequence.hpp>
+
+#include "xcomplex.hpp"
+#include "xexception.hpp"
+#include "xfunction.hpp"
+#include "xmath.hpp"
+
+namespace xt
+{
+
+    /******************************
+     * xsplit_complex declaration *
+     ******************************/
+
+    namespace detail
+    {
+        struct make_complex_fun
+        {
+            template <class R, class I>
+            constexpr auto operator()(const R& r, const I& i) const
+            {
+                return std::complex<std::common_type_t<R, I>>(r, i);
+            }
+        };
+    }
+
+    /**
+     * @class xsplit_complex
+     * @brief Dense multidimensional container of complex values, holding
+     * the real and the imaginary parts in two separate containers.
+     *
+     * Contrary to a container of std::complex, whose real and imaginary
+     * parts are interleaved, xsplit_complex keeps each part contiguous:
+     * \ref real and \ref imag return the underlying containers, and the
+     * functions computed on the parts (abs, norm, arg) are vectorized.
+     * The complex values are read through the expression returned by
+     * \ref expression.
+     *
+     * @tparam C The type of the containers holding the parts, e.g.
+     *           xarray<double>.
+     */
+    template <class C>
+    class xsplit_complex
+    {
+    public:
+
+        using container_type = C;
+        using real_value_type = typename container_type::value_type;
+        using value_type = std::complex<real_value_type>;
+        using shape_type = typename container_type::shape_type;
+        using inner_shape_type = typename container_type::inner_shape_type;
+        using size_type = typename container_type::size_type;
+        using expression_type = xfunction<detail::make_complex_fun, const container_type&, const container_type&>;
+
+        xsplit_complex() = default;
+        explicit xsplit_complex(const shape_type& shape);
+        xsplit_complex(container_type real, container_type imag);
+
+        template <class E>
+        xsplit_complex(const xexpression<E>& e);
+
+        template <class E>
+        xsplit_complex& operator=(const xexpression<E>& e);
+
+        void resize(const shape_type& shape);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+
+        container_type& real() & noexcept;
+        const container_type& real() const & noexcept;
+        container_type real() &&;
+
+        container_type& imag() & noexcept;
+        const container_type& imag() const & noexcept;
+        container_type imag() &&;
+
+        template <class... Args>
+        value_type operator()(Args... args) const;
+
+        expression_type expression() const noexcept;
+
+    private:
+
+        template <class E>
+        void assign_parts(const E& e);
+
+        template <layout_type L, class E>
+        void assign_parts_impl(const E& e);
+
+        container_type m_real;
+        container_type m_imag;
+    };
+
+    template <class E>
+    auto split_complex(E&& e);
+
+    /*********************************
+     * xsplit_complex implementation *
+     *********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Allocates an uninitialized xsplit_complex with the specified shape.
+     * @param shape the shape of the xsplit_complex
+     */
+    template <class C>
+    inline xsplit_complex<C>::xsplit_complex(const shape_type& shape)
+        : m_real(shape), m_imag(shape)
+    {
+    }
+
+    /**
+     * Builds an xsplit_complex from its real and imaginary parts.
+     * @param real the real parts
+     * @param imag the imaginary parts, of the same shape as \c real
+     */
+    template <class C>
+    inline xsplit_complex<C>::xsplit_complex(container_type real, container_type imag)
+        : m_real(std::move(real)), m_imag(std::move(imag))
+    {
+        if (!std::equal(m_real.shape().cbegin(), m_real.shape().cend(), m_imag.shape().cbegin(), m_imag.shape().cend()))
+        {
+            XTENSOR_THROW(std::runtime_error, "xsplit_complex: the real and imaginary parts must have the same shape");
+        }
+    }
+
+    /**
+     * Builds an xsplit_complex from an xexpression of real or complex
+     * values, which is evaluated once.
+     * @param e the xexpression
+     */
+    template <class C>
+    template <class E>
+    inline xsplit_complex<C>::xsplit_complex(const xexpression<E>& e)
+    {
+        assign_parts(e.derived_cast());
+    }
+    //@}
+
+    /**
+     * The extended assignment operator; the xsplit_complex is resized to
+     * the shape of \c e.
+     */
+    template <class C>
+    template <class E>
+    inline auto xsplit_complex<C>::operator=(const xexpression<E>& e) -> xsplit_complex&
+    {
+        assign_parts(e.derived_cast());
+        return *this;
+    }
+
+    /**
+     * Resizes both parts to the specified shape.
+     */
+    template <class C>
+    inline void xsplit_complex<C>::resize(const shape_type& shape)
+    {
+        m_real.resize(shape);
+        m_imag.resize(shape);
+    }
+
+    /**
+     * Returns the number of elements.
+     */
+    template <class C>
+    inline auto xsplit_complex<C>::size() const noexcept -> size_type
+    {
+        return m_real.size();
+    }
+
+    /**
+     * Returns the number of dimensions.
+     */
+    template <class C>
+    inline auto xsplit_complex<C>::dimension() const noexcept -> size_type
+    {
+        return m_real.dimension();
+    }
+
+    /**
+     * Returns the shape.
+     */
+    template <class C>
+    inline auto xsplit_complex<C>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_real.shape();
+    }
+
+    /**
+     * Returns the container of the real parts.
+     */
+    template <class C>
+    inline auto xsplit_complex<C>::real() & noexcept -> container_type&
+    {
+        return m_real;
+    }
+
+    template <class C>
+    inline auto xsplit_complex<C>::real() const & noexcept -> const container_type&
+    {
+        return m_real;
+    }
+
+    template <class C>
+    inline auto xsplit_complex<C>::real() && -> container_type
+    {
+        return std::move(m_real);
+    }
+
+    /**
+     * Returns the container of the imaginary parts.
+     */
+    template <class C>
+    inline auto xsplit_complex<C>::imag() & noexcept -> container_type&
+    {
+        return m_imag;
+    }
+
+    template <class C>
+    inline auto xsplit_complex<C>::imag() const & noexcept -> const container_type&
+    {
+        return m_imag;
+    }
+
+    template <class C>
+    inline auto xsplit_complex<C>::imag() && -> container_type
+    {
+        return std::move(m_imag);
+    }
+
+    /**
+     * Returns the complex value of the element at the specified position.
+     * @param args a list of indices specifying the position
+     */
+    template <class C>
+    template <class... Args>
+    inline auto xsplit_complex<C>::operator()(Args... args) const -> value_type
+    {
+        return value_type(m_real(args...), m_imag(args...));
+    }
+
+    /**
+     * Returns an xexpression of the complex values, holding references
+     * on the parts. The expression must not be used after the
+     * xsplit_complex is resized or destroyed.
+     */
+    template <class C>
+    inline auto xsplit_complex<C>::expression() const noexcept -> expression_type
+    {
+        return expression_type(detail::make_complex_fun(), m_real, m_imag);
+    }
+
+    template <class C>
+    template <class E>
+    inline void xsplit_complex<C>::assign_parts(const E& e)
+    {
+        resize(xtl::forward_sequence<shape_type, decltype(e.shape())>(e.shape()));
+        if (m_real.layout() == layout_type::column_major)
+        {
+            assign_parts_impl<layout_type::column_major>(e);
+        }
+        else
+        {
+            assign_parts_impl<layout_type::row_major>(e);
+        }
+    }
+
+    // The expression is traversed once in the storage order of the parts,
+    // each complex value being split on the fly.
+    template <class C>
+    template <layout_type L, class E>
+    inline void xsplit_complex<C>::assign_parts_impl(const E& e)
+    {
+        auto re = m_real.storage().begin();
+        auto im = m_imag.storage().begin();
+        auto last = e.template cend<L>();
+        for (auto it = e.template cbegin<L>(); it != last; ++it, ++re, ++im)
+        {
+            value_type v(*it);
+            *re = v.real();
+            *im = v.imag();
+        }
+    }
+
+    /**
+     * Evaluates an xexpression of complex values into an xsplit_complex
+     * whose parts are xarray or xtensor containers, depending on the
+     * shape of \c e.
+     * @param e the xexpression
+     */
+    template <class E>
+    inline auto split_complex(E&& e)
+    {
+        using value_type = xtl::complex_value_type_t<typename std::decay_t<E>::value_type>;
+        using shape_type = typename std::decay_t<E>::shape_type;
+        using container_type = typename detail::xtype_for_shape<shape_type>::template type<value_type, XTENSOR_DEFAULT_LAYOUT>;
+        return xsplit_complex<container_type>(e);
+    }
+
+    /************************************
+     * Functions of the split complexes *
+     ************************************/
+
+    namespace detail
+    {
+        template <class S>
+        inline decltype(auto) split_real(S&& s)
+        {
+            return std::forward<S>(s).real();
+        }
+
+        template <class S>
+        inline decltype(auto) split_imag(S&& s)
+        {
+            return std::forward<S>(s).imag();
+        }
+
+        // The real and imaginary parts are forwarded separately, an rvalue
+        // xsplit_complex is therefore moved into the returned expression.
+        template <class S>
+        inline auto split_abs(S&& s)
+        {
+            return xt::hypot(split_real(std::forward<S>(s)), split_imag(std::forward<S>(s)));
+        }
+
+        template <class S>
+        inline auto split_norm(S&& s)
+        {
+            return xt::square(split_real(std::forward<S>(s))) + xt::square(split_imag(std::forward<S>(s)));
+        }
+
+        template <class S>
+        inline auto split_arg(S&& s)
+        {
+            return xt::atan2(split_imag(std::forward<S>(s)), split_real(std::forward<S>(s)));
+        }
+
+        template <class S>
+        inline auto split_conj(S&& s)
+        {
+            return make_xfunction<make_complex_fun>(split_real(std::forward<S>(s)), -split_imag(std::forward<S>(s)));
+        }
+    }
+
+    // The generic real, imag, norm, arg and conj accept any argument, an
+    // overload is therefore needed for each value category.
+#define XTENSOR_SPLIT_COMPLEX_FUNCTION(NAME, IMPL)              \
+    template <class C>                                          \
+    inline decltype(auto) NAME(xsplit_complex<C>& s)            \
+    {                                                           \
+        return detail::IMPL(s);                                 \
+    }                                                           \
+                                                                \
+    template <class C>                                          \
+    inline decltype(auto) NAME(const xsplit_complex<C>& s)      \
+    {                                                           \
+        return detail::IMPL(s);                                 \
+    }                                                           \
+                                                                \
+    template <class C>                                          \
+    inline decltype(auto) NAME(xsplit_complex<C>&& s)           \
+    {                                                           \
+        return detail::IMPL(std::move(s));                      \
+    }
+
+    /**
+     * @fn real(xsplit_complex<C>& s)
+     * @brief Returns the container of the real parts of \c s.
+     */
+    XTENSOR_SPLIT_COMPLEX_FUNCTION(real, split_real)
+
+    /**
+     * @fn imag(xsplit_complex<C>& s)
+     * @brief Returns the container of the imaginary parts of \c s.
+     */
+    XTENSOR_SPLIT_COMPLEX_FUNCTION(imag, split_imag)
+
+    /**
+     * @fn abs(xsplit_complex<C>& s)
+     * @brief Returns an \ref xfunction evaluating to the magnitudes of \c s,
+     * computed with hypot on the parts.
+     */
+    XTENSOR_SPLIT_COMPLEX_FUNCTION(abs, split_abs)
+
+    /**
+     * @fn norm(xsplit_complex<C>& s)
+     * @brief Returns an \ref xfunction evaluating to the squared magnitudes
+     * of \c s.
+     */
+    XTENSOR_SPLIT_COMPLEX_FUNCTION(norm, split_norm)
+
+    /**
+     * @fn arg(xsplit_complex<C>& s)
+     * @brief Returns an \ref xfunction evaluating to the phase angles of \c s.
+     */
+    XTENSOR_SPLIT_COMPLEX_FUNCTION(arg, split_arg)
+
+    /**
+     * @fn conj(xsplit_complex<C>& s)
+     * @brief Returns an \ref xfunction evaluating to the complex conjugates
+     * of \c s.
+     */
+    XTENSOR_SPLIT_COMPLEX_FUNCTION(conj, split_conj)
+
+#undef XTENSOR_SPLIT_COMPLEX_FUNCTION
+}
+
+#endif
@@ -0,0 +1,545 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_STENCIL_HPP
+#define XTENSOR_STENCIL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xexception.hpp"
+#include "xexecution.hpp"
+#include "xnoalias.hpp"
+#include "xpad.hpp"
+#include "xstrided_view.hpp"
+#include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
+
+namespace xt
+{
+    /************
+     * xstencil *
+     ************/
+
+    /**
+     * @class xstencil
+     * @brief Weighted sum of the neighbours of the points of a grid.
+     *
+     * An xstencil holds the offsets of its taps relative to the updated
+     * point, one per axis of the grid, and the weight of each tap. It is
+     * applied to an expression with apply_stencil.
+     *
+     * @tparam T the type of the weights
+     * @sa stencil, apply_stencil
+     */
+    template <class T>
+    class xstencil
+    {
+    public:
+
+        using value_type = T;
+        using offset_type = std::vector<std::ptrdiff_t>;
+        using offsets_type = std::vector<offset_type>;
+        using weights_type = std::vector<value_type>;
+
+        xstencil(offsets_type offsets, weights_type weights);
+
+        std::size_t dimension() const noexcept;
+        std::size_t size() const noexcept;
+
+        const offsets_type& offsets() const noexcept;
+        const weights_type& weights() const noexcept;
+
+        std::size_t lower_halo(std::size_t axis) const;
+        std::size_t upper_halo(std::size_t axis) const;
+
+    private:
+
+        offsets_type m_offsets;
+        weights_type m_weights;
+        std::vector<std::size_t> m_lower_halo;
+        std::vector<std::size_t> m_upper_halo;
+    };
+
+    template <class T>
+    xstencil<T> stencil(std::vector<std::vector<std::ptrdiff_t>> offsets, std::vector<T> weights);
+
+    template <class T>
+    xstencil<T> stencil(std::vector<std::vector<std::ptrdiff_t>> offsets, std::initializer_list<T> weights);
+
+    /***************************
+     * xstencil implementation *
+     ***************************/
+
+    /**
+     * Builds a stencil from the offsets of its taps and their weights.
+     * @param offsets the offsets of the taps, which must all have the same
+     * non-zero size
+     * @param weights the weights of the taps
+     */
+    template <class T>
+    inline xstencil<T>::xstencil(offsets_type offsets, weights_type weights)
+        : m_offsets(std::move(offsets)), m_weights(std::move(weights))
+    {
+        if (m_offsets.empty() || m_offsets.size() != m_weights.size())
+        {
+            XTENSOR_THROW(std::runtime_error, "stencil: there must be as many weights as offsets, and at least one");
+        }
+        const std::size_t dim = m_offsets.front().size();
+        if (dim == 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "stencil: the offsets must have at least one dimension");
+        }
+        m_lower_halo.assign(dim, 0);
+        m_upper_halo.assign(dim, 0);
+        for (const auto& offset : m_offsets)
+        {
+            if (offset.size() != dim)
+            {
+                XTENSOR_THROW(std::runtime_error, "stencil: all the offsets must have the same dimension");
+            }
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                if (offset[d] < 0)
+                {
+                    m_lower_halo[d] = (std::max)(m_lower_halo[d], static_cast<std::size_t>(-offset[d]));
+                }
+                else
+                {
+                    m_upper_halo[d] = (std::max)(m_upper_halo[d], static_cast<std::size_t>(offset[d]));
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns the number of axes of the grids the stencil applies to.
+     */
+    template <class T>
+    inline std::size_t xstencil<T>::dimension() const noexcept
+    {
+        return m_lower_halo.size();
+    }
+
+    /**
+     * Returns the number of taps of the stencil.
+     */
+    template <class T>
+    inline std::size_t xstencil<T>::size() const noexcept
+    {
+        return m_weights.size();
+    }
+
+    /**
+     * Returns the offsets of the taps.
+     */
+    template <class T>
+    inline auto xstencil<T>::offsets() const noexcept -> const offsets_type&
+    {
+        return m_offsets;
+    }
+
+    /**
+     * Returns the weights of the taps.
+     */
+    template <class T>
+    inline auto xstencil<T>::weights() const noexcept -> const weights_type&
+    {
+        return m_weights;
+    }
+
+    /**
+     * Returns the number of points read before the updated one along \c axis.
+     */
+    template <class T>
+    inline std::size_t xstencil<T>::lower_halo(std::size_t axis) const
+    {
+        return m_lower_halo[axis];
+    }
+
+    /**
+     * Returns the number of points read after the updated one along \c axis.
+     */
+    template <class T>
+    inline std::size_t xstencil<T>::upper_halo(std::size_t axis) const
+    {
+        return m_upper_halo[axis];
+    }
+
+    /**
+     * @brief Builds a stencil from the offsets of its taps and their weights.
+     *
+     * \code{.cpp}
+     * // 5-point Laplacian
+     * auto lap = xt::stencil({{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}}, {-4., 1., 1., 1., 1.});
+     * \endcode
+     *
+     * @param offsets the offsets of the taps relative to the updated point
+     * @param weights the weights of the taps
+     */
+    template <class T>
+    inline xstencil<T> stencil(std::vector<std::vector<std::ptrdiff_t>> offsets, std::vector<T> weights)
+    {
+        return xstencil<T>(std::move(offsets), std::move(weights));
+    }
+
+    template <class T>
+    inline xstencil<T> stencil(std::vector<std::vector<std::ptrdiff_t>> offsets, std::initializer_list<T> weights)
+    {
+        return xstencil<T>(std::move(offsets), std::vector<T>(weights));
+    }
+
+    /********************************
+     * apply_stencil implementation *
+     ********************************/
+
+    namespace detail
+    {
+        // Size of the pair of buffers a task of the temporal blocking
+        // advances by several steps, so that they stay in the L2 cache.
+        constexpr std::size_t stencil_tile_bytes = std::size_t(1) << 18;
+
+        // Padded row-major grid: shape is the interior one, lower and upper
+        // the halos along each axis, and taps the flat offsets of the taps.
+        template <class V>
+        struct stencil_grid
+        {
+            std::vector<std::size_t> shape;
+            std::vector<std::size_t> lower;
+            std::vector<std::size_t> upper;
+            std::vector<std::size_t> strides;
+            std::vector<std::ptrdiff_t> taps;
+            std::vector<V> weights;
+        };
+
+        // A 1-D grid is seen as a single row, so that the rows always index
+        // the first axis and the lines the last one.
+        template <class V, class S, class T>
+        inline stencil_grid<V> make_stencil_grid(const S& shape, const xstencil<T>& st)
+        {
+            stencil_grid<V> g;
+            const std::size_t dim = st.dimension();
+            const std::size_t gdim = (std::max)(dim, std::size_t(2));
+            const std::size_t lead = gdim - dim;
+            g.shape.assign(gdim, 1);
+            g.lower.assign(gdim, 0);
+            g.upper.assign(gdim, 0);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                g.shape[lead + d] = static_cast<std::size_t>(shape[d]);
+                g.lower[lead + d] = st.lower_halo(d);
+                g.upper[lead + d] = st.upper_halo(d);
+            }
+            g.strides.resize(gdim);
+            std::size_t stride = 1;
+            for (std::size_t d = gdim; d-- > 0;)
+            {
+                g.strides[d] = stride;
+                stride *= g.lower[d] + g.shape[d] + g.upper[d];
+            }
+            for (std::size_t t = 0; t < st.size(); ++t)
+            {
+                std::ptrdiff_t tap = 0;
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    tap += st.offsets()[t][d] * static_cast<std::ptrdiff_t>(g.strides[lead + d]);
+                }
+                g.taps.push_back(tap);
+                g.weights.push_back(static_cast<V>(st.weights()[t]));
+            }
+            return g;
+        }
+
+        // Writes sum(w[t] * in[taps[t] + i], t) to out[i] for i < n. Blocks
+        // of consecutive outputs are accumulated in registers over all the
+        // taps, as in convolve_direct.
+        template <class V>
+        inline void stencil_line(const V* in, const std::ptrdiff_t* taps, const V* w, std::size_t ntaps,
+                                 V* out, std::size_t n, std::false_type)
+        {
+            constexpr std::size_t block = 8;
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                std::array<V, block> acc;
+                acc.fill(V(0));
+                for (std::size_t t = 0; t < ntaps; ++t)
+                {
+                    const V wt = w[t];
+                    const V* p = in + taps[t] + static_cast<std::ptrdiff_t>(i);
+                    for (std::size_t b = 0; b < block; ++b)
+                    {
+                        acc[b] += p[b] * wt;
+                    }
+                }
+                std::copy(acc.cbegin(), acc.cend(), out + i);
+            }
+            for (; i < n; ++i)
+            {
+                V acc(0);
+                for (std::size_t t = 0; t < ntaps; ++t)
+                {
+                    acc += in[taps[t] + static_cast<std::ptrdiff_t>(i)] * w[t];
+                }
+                out[i] = acc;
+            }
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        template <class V>
+        inline void stencil_line(const V* in, const std::ptrdiff_t* taps, const V* w, std::size_t ntaps,
+                                 V* out, std::size_t n, std::true_type)
+        {
+            using batch_type = xt_simd::simd_type<V>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<V>::size;
+            constexpr std::size_t n_acc = 4;
+            constexpr std::size_t step = n_acc * simd_size;
+
+            std::size_t i = 0;
+            for (; i + step <= n; i += step)
+            {
+                batch_type acc[n_acc];
+                for (std::size_t j = 0; j < n_acc; ++j)
+                {
+                    acc[j] = batch_type(V(0));
+                }
+                for (std::size_t t = 0; t < ntaps; ++t)
+                {
+                    const batch_type wt(w[t]);
+                    const V* p = in + taps[t] + static_cast<std::ptrdiff_t>(i);
+                    for (std::size_t j = 0; j < n_acc; ++j)
+                    {
+                        acc[j] += xt_simd::load_as<V>(p + j * simd_size, unaligned_mode()) * wt;
+                    }
+                }
+                for (std::size_t j = 0; j < n_acc; ++j)
+                {
+                    xt_simd::store_as(out + i + j * simd_size, acc[j], unaligned_mode());
+                }
+            }
+            stencil_line(in + i, taps, w, ntaps, out + i, n - i, std::false_type());
+        }
+#endif
+
+        // Updates the interior points of the rows [row_first, row_last) of
+        // dst from src, both laid out as the padded grid g.
+        template <class V>
+        inline void stencil_rows(const V* src, V* dst, const stencil_grid<V>& g, std::size_t row_first, std::size_t row_last)
+        {
+#if defined(XTENSOR_USE_XSIMD)
+            using use_simd = std::integral_constant<bool, std::is_arithmetic<V>::value && (xt_simd::simd_traits<V>::size > 1)>;
+#else
+            using use_simd = std::false_type;
+#endif
+            const std::size_t dim = g.shape.size();
+            std::size_t lines = 1;
+            for (std::size_t d = 1; d + 1 < dim; ++d)
+            {
+                lines *= g.shape[d];
+            }
+            for (std::size_t row = row_first; row < row_last; ++row)
+            {
+                for (std::size_t l = 0; l < lines; ++l)
+                {
+                    std::size_t rem = l;
+                    std::size_t offset = row * g.strides[0] + g.lower[dim - 1];
+                    for (std::size_t d = dim - 1; d-- > 1;)
+                    {
+                        offset += (rem % g.shape[d] + g.lower[d]) * g.strides[d];
+                        rem /= g.shape[d];
+                    }
+                    stencil_line(src + offset, g.taps.data(), g.weights.data(), g.taps.size(),
+                                 dst + offset, g.shape[dim - 1], use_simd());
+                }
+            }
+        }
+
+        // Advances tiles of rows by all the steps at once in two buffers
+        // that fit in cache. A tile starts from the rows it depends on after
+        // the last step, steps times the halo beyond its own ones, and
+        // computes fewer of them at each step; the overlapping rows of the
+        // neighbouring tiles are computed twice. The rows out of the grid are
+        // the zeros of the constant padding, and are never updated.
+        template <class V, class P>
+        inline bool stencil_temporal_blocking(const V* src, V* dst, const stencil_grid<V>& g,
+                                              std::size_t steps, const P& policy)
+        {
+            const std::size_t row_size = g.strides[0];
+            const std::size_t hl = g.lower[0];
+            const std::size_t hh = g.upper[0];
+            const std::size_t n0 = g.shape[0];
+            const std::size_t extent = steps * (hl + hh);
+            const std::size_t rows_fit = stencil_tile_bytes / (2 * sizeof(V) * row_size);
+            const std::size_t tile_rows = rows_fit > extent ? rows_fit - extent : 0;
+            // Below that, more rows would be computed twice than once
+            if (tile_rows == 0 || tile_rows < extent)
+            {
+                return false;
+            }
+
+            const std::ptrdiff_t padded_rows = static_cast<std::ptrdiff_t>(hl + n0 + hh);
+            const std::size_t tiles = (n0 + tile_rows - 1) / tile_rows;
+            policy.for_range(0, tiles, 1, [&](std::size_t first, std::size_t last)
+            {
+                std::vector<V> a((tile_rows + extent) * row_size);
+                std::vector<V> b(a.size());
+                for (std::size_t tile = first; tile < last; ++tile)
+                {
+                    // Rows in the coordinates of the padded grid
+                    const std::size_t r0 = tile * tile_rows + hl;
+                    const std::size_t r1 = (std::min)(n0, (tile + 1) * tile_rows) + hl;
+                    const std::ptrdiff_t q0_span = static_cast<std::ptrdiff_t>(r0) - static_cast<std::ptrdiff_t>(steps * hl);
+                    const std::ptrdiff_t q1_span = static_cast<std::ptrdiff_t>(r1 + steps * hh);
+                    const std::size_t q0 = static_cast<std::size_t>((std::max)(q0_span, std::ptrdiff_t(0)));
+                    const std::size_t q1 = static_cast<std::size_t>((std::min)(q1_span, padded_rows));
+
+                    std::copy(src + q0 * row_size, src + q1 * row_size, a.begin());
+                    std::copy(src + q0 * row_size, src + q1 * row_size, b.begin());
+                    for (std::size_t s = 1; s <= steps; ++s)
+                    {
+                        const std::ptrdiff_t lo = (std::max)(q0_span + static_cast<std::ptrdiff_t>(s * hl),
+                                                             static_cast<std::ptrdiff_t>(hl));
+                        const std::ptrdiff_t hi = (std::min)(q1_span - static_cast<std::ptrdiff_t>(s * hh),
+                                                             static_cast<std::ptrdiff_t>(hl + n0));
+                        stencil_rows(a.data(), b.data(), g, static_cast<std::size_t>(lo) - q0, static_cast<std::size_t>(hi) - q0);
+                        std::swap(a, b);
+                    }
+                    std::copy(a.cbegin() + static_cast<std::ptrdiff_t>((r0 - q0) * row_size),
+                              a.cbegin() + static_cast<std::ptrdiff_t>((r1 - q0) * row_size),
+                              dst + r0 * row_size);
+                }
+            });
+            return true;
+        }
+
+        template <class O, class E, class T, class P>
+        inline void apply_stencil_impl(O& out, const E& in, const xstencil<T>& st, std::size_t steps,
+                                       pad_mode mode, const P& policy)
+        {
+            using value_type = std::common_type_t<typename E::value_type, T>;
+            using array_type = xarray<value_type, layout_type::row_major>;
+
+            const std::size_t dim = in.dimension();
+            if (dim != st.dimension())
+            {
+                XTENSOR_THROW(std::runtime_error, "apply_stencil: the stencil and the expression must have the same dimension");
+            }
+
+            std::vector<std::vector<std::size_t>> pad_width(dim);
+            typename array_type::shape_type padded_shape(in.shape().cbegin(), in.shape().cend());
+            xstrided_slice_vector interior(dim);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                const std::size_t n = static_cast<std::size_t>(in.shape()[d]);
+                const std::size_t lo = st.lower_halo(d);
+                const std::size_t hi = st.upper_halo(d);
+                const std::size_t limit = mode == pad_mode::reflect ? n - (std::min)(n, std::size_t(1)) : n;
+                if (mode != pad_mode::constant && (lo > limit || hi > limit))
+                {
+                    XTENSOR_THROW(std::runtime_error, "apply_stencil: the stencil is wider than the expression for this padding mode");
+                }
+                pad_width[d] = {lo, hi};
+                padded_shape[d] = lo + n + hi;
+                interior[d] = range(lo, lo + n);
+            }
+
+            array_type cur = array_type::from_shape(padded_shape);
+            noalias(strided_view(cur, interior)) = in;
+            if (steps == 0 || cur.size() == 0)
+            {
+                noalias(out) = strided_view(cur, interior);
+                return;
+            }
+            detail::pad_borders(cur, in.shape(), pad_width, mode, value_type(0));
+
+            const stencil_grid<value_type> g = make_stencil_grid<value_type>(in.shape(), st);
+            const std::size_t first_row = g.lower[0];
+            const std::size_t last_row = g.lower[0] + g.shape[0];
+            array_type next = array_type::from_shape(padded_shape);
+
+            if (steps > 1 && mode == pad_mode::constant && stencil_temporal_blocking(cur.data(), next.data(), g, steps, policy))
+            {
+                noalias(out) = strided_view(next, interior);
+                return;
+            }
+
+            for (std::size_t s = 0; s < steps; ++s)
+            {
+                policy.for_range(first_row, last_row, 1, [&](std::size_t first, std::size_t last)
+                {
+                    stencil_rows(cur.data(), next.data(), g, first, last);
+                });
+                if (s + 1 < steps)
+                {
+                    detail::pad_borders(next, in.shape(), pad_width, mode, value_type(0));
+                }
+                std::swap(cur, next);
+            }
+            noalias(out) = strided_view(cur, interior);
+        }
+    }
+
+    /**
+     * @brief Applies a stencil to an expression one or several times.
+     *
+     * Each step replaces every point of the grid by the weighted sum of the
+     * points at the offsets of the taps of the stencil. The borders of the
+     * grid are extended by the halos of the stencil according to \c mode, as
+     * xt::pad does, the constant mode padding with zeros; they are extended
+     * again before each step. The points are computed in registers over all
+     * the taps, line by line along the last axis, and the rows along the
+     * first axis are split among the threads of the policy.
+     *
+     * With the constant mode and several steps, the rows are advanced by
+     * tiles that fit in the L2 cache through all the steps at once, which
+     * computes the rows shared by neighbouring tiles twice but reads the grid
+     * from memory once rather than once per step (temporal blocking). The
+     * steps are swept one after the other when the rows are too long for it.
+     *
+     * \code{.cpp}
+     * auto lap = xt::stencil({{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}}, {0.6, 0.1, 0.1, 0.1, 0.1});
+     * xt::apply_stencil(u, u, lap, 10);
+     * \endcode
+     *
+     * @param out the expression the result is assigned to, which may be \c in
+     * @param in the grid
+     * @param st the stencil, of the same dimension as \c in
+     * @param steps the number of times the stencil is applied
+     * @param mode the padding mode at the borders
+     * @param policy the execution policy splitting the rows
+     */
+    template <class O, class E, class T, class P, class = std::enable_if_t<is_execution_policy<P>::value>>
+    inline void apply_stencil(xexpression<O>& out, const xexpression<E>& in, const xstencil<T>& st,
+                              std::size_t steps, pad_mode mode, const P& policy)
+    {
+        detail::apply_stencil_impl(out.derived_cast(), in.derived_cast(), st, steps, mode, policy);
+    }
+
+    /**
+     * @brief Applies a stencil to an expression one or several times, on the
+     * calling thread.
+     *
+     * @sa apply_stencil(xexpression<O>&, const xexpression<E>&, const xstencil<T>&, std::size_t, pad_mode, const P&)
+     */
+    template <class O, class E, class T>
+    inline void apply_stencil(xexpression<O>& out, const xexpression<E>& in, const xstencil<T>& st,
+                              std::size_t steps = 1, pad_mode mode = pad_mode::constant)
+    {
+        detail::apply_stencil_impl(out.derived_cast(), in.derived_cast(), st, steps, mode, exec::default_policy());
+    }
+}
+
+#endif
@@ -12,13 +12,24 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <new>
 #include <type_traits>
 
+#if defined(XTENSOR_USE_NUMA)
+#include <numa.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 #include "xexception.hpp"
+#include "xexecution.hpp"
 #include "xtensor_config.hpp"
 #include "xtensor_simd.hpp"
 #include "xutils.hpp"
@@ -38,6 +49,481 @@ namespace xt
     {
     };
 
+    /**************
+     * allocators *
+     **************/
+
+    template <class T>
+    void first_touch(T* p, std::size_t n);
+
+    template <class T, class P>
+    void first_touch(T* p, std::size_t n, const P& policy);
+
+    /**
+     * @class first_touch_allocator
+     * @brief Allocator adaptor touching the pages of the blocks it allocates
+     * in parallel.
+     *
+     * Operating systems usually map a page on the NUMA node of the thread
+     * that first writes to it. Touching the pages with exec::default_policy,
+     * i.e. with the partitioning used later by the parallel assignment loops,
+     * places each part of the buffer on the node of the thread that computes
+     * it. Without a parallel backend, this only faults the pages in advance.
+     *
+     * @tparam T the value type.
+     * @tparam A the allocator actually allocating the memory.
+     */
+    template <class T, class A = std::allocator<T>>
+    class first_touch_allocator : private A
+    {
+    public:
+
+        using base_type = A;
+        using traits = std::allocator_traits<A>;
+        using value_type = typename traits::value_type;
+        using pointer = typename traits::pointer;
+        using const_pointer = typename traits::const_pointer;
+        using size_type = typename traits::size_type;
+        using difference_type = typename traits::difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = first_touch_allocator<U, typename traits::template rebind_alloc<U>>;
+        };
+
+        first_touch_allocator() = default;
+        explicit first_touch_allocator(const A& alloc);
+
+        template <class U, class AU>
+        first_touch_allocator(const first_touch_allocator<U, AU>& rhs);
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n);
+
+        const base_type& base() const noexcept;
+    };
+
+    template <class T, class AT, class U, class AU>
+    bool operator==(const first_touch_allocator<T, AT>& lhs, const first_touch_allocator<U, AU>& rhs);
+
+    template <class T, class AT, class U, class AU>
+    bool operator!=(const first_touch_allocator<T, AT>& lhs, const first_touch_allocator<U, AU>& rhs);
+
+#if defined(XTENSOR_USE_NUMA)
+    /**
+     * @class numa_interleave_allocator
+     * @brief Allocator spreading the pages of large blocks over all the NUMA
+     * nodes, using libnuma.
+     *
+     * Blocks smaller than min_size() bytes are allocated with the fallback
+     * allocator \c A, since interleaving requires whole pages.
+     *
+     * @tparam T the value type.
+     * @tparam A the allocator used for small blocks.
+     */
+    template <class T, class A = std::allocator<T>>
+    class numa_interleave_allocator : private A
+    {
+    public:
+
+        using base_type = A;
+        using traits = std::allocator_traits<A>;
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = numa_interleave_allocator<U, typename traits::template rebind_alloc<U>>;
+        };
+
+        numa_interleave_allocator() = default;
+        explicit numa_interleave_allocator(const A& alloc);
+
+        template <class U, class AU>
+        numa_interleave_allocator(const numa_interleave_allocator<U, AU>& rhs);
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n);
+
+        const base_type& base() const noexcept;
+
+        static constexpr std::size_t min_size() noexcept;
+    };
+
+    template <class T, class AT, class U, class AU>
+    bool operator==(const numa_interleave_allocator<T, AT>& lhs, const numa_interleave_allocator<U, AU>& rhs);
+
+    template <class T, class AT, class U, class AU>
+    bool operator!=(const numa_interleave_allocator<T, AT>& lhs, const numa_interleave_allocator<U, AU>& rhs);
+#endif
+
+    /**
+     * @class huge_page_allocator
+     * @brief Allocator placing large blocks on 2 MB pages to reduce TLB misses.
+     *
+     * Blocks of at least min_size() bytes are mapped with their size rounded
+     * up to a multiple of huge_page_size(), at an address aligned on it, and
+     * marked with madvise(MADV_HUGEPAGE) so that the kernel backs them with
+     * transparent huge pages. When XTENSOR_USE_HUGETLB is defined, explicit
+     * huge pages (MAP_HUGETLB) are tried first. Smaller blocks, and all the
+     * blocks on systems other than Linux, are allocated with \c A.
+     *
+     * @tparam T the value type.
+     * @tparam A the allocator used for small blocks.
+     */
+    template <class T, class A = std::allocator<T>>
+    class huge_page_allocator : private A
+    {
+    public:
+
+        using base_type = A;
+        using traits = std::allocator_traits<A>;
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U, typename traits::template rebind_alloc<U>>;
+        };
+
+        huge_page_allocator() = default;
+        explicit huge_page_allocator(const A& alloc);
+
+        template <class U, class AU>
+        huge_page_allocator(const huge_page_allocator<U, AU>& rhs);
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n);
+
+        const base_type& base() const noexcept;
+
+        static constexpr std::size_t huge_page_size() noexcept;
+        static constexpr std::size_t min_size() noexcept;
+    };
+
+    template <class T, class AT, class U, class AU>
+    bool operator==(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs);
+
+    template <class T, class AT, class U, class AU>
+    bool operator!=(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs);
+
+    /*****************************
+     * allocators implementation *
+     *****************************/
+
+    /**
+     * Writes to every page of the buffer [p, p + n), distributing the pages
+     * with the default execution policy. The buffer must not hold values yet:
+     * the touched bytes are overwritten.
+     */
+    template <class T>
+    inline void first_touch(T* p, std::size_t n)
+    {
+        first_touch(p, n, exec::default_policy());
+    }
+
+    /**
+     * Writes to every page of the buffer [p, p + n), distributing the pages
+     * with \c policy. The buffer must not hold values yet: the touched bytes
+     * are overwritten.
+     */
+    template <class T, class P>
+    inline void first_touch(T* p, std::size_t n, const P& policy)
+    {
+        // A smaller page size only means more writes, so the common one is used.
+        constexpr std::size_t page_size = 4096;
+        if (p == nullptr || n == 0)
+        {
+            return;
+        }
+        volatile char* bytes = reinterpret_cast<volatile char*>(p);
+        policy.for_range(0, n, 1, [bytes](std::size_t first, std::size_t last)
+        {
+            std::size_t end = last * sizeof(T);
+            for (std::size_t offset = first * sizeof(T); offset < end; offset = (offset / page_size + 1) * page_size)
+            {
+                bytes[offset] = 0;
+            }
+        });
+    }
+
+    template <class T, class A>
+    inline first_touch_allocator<T, A>::first_touch_allocator(const A& alloc)
+        : A(alloc)
+    {
+    }
+
+    template <class T, class A>
+    template <class U, class AU>
+    inline first_touch_allocator<T, A>::first_touch_allocator(const first_touch_allocator<U, AU>& rhs)
+        : A(rhs.base())
+    {
+    }
+
+    template <class T, class A>
+    inline auto first_touch_allocator<T, A>::allocate(size_type n) -> pointer
+    {
+        pointer p = traits::allocate(*this, n);
+        if (n != 0)
+        {
+            first_touch(std::addressof(*p), static_cast<std::size_t>(n));
+        }
+        return p;
+    }
+
+    template <class T, class A>
+    inline void first_touch_allocator<T, A>::deallocate(pointer p, size_type n)
+    {
+        traits::deallocate(*this, p, n);
+    }
+
+    template <class T, class A>
+    inline auto first_touch_allocator<T, A>::base() const noexcept -> const base_type&
+    {
+        return *this;
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator==(const first_touch_allocator<T, AT>& lhs, const first_touch_allocator<U, AU>& rhs)
+    {
+        return lhs.base() == rhs.base();
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator!=(const first_touch_allocator<T, AT>& lhs, const first_touch_allocator<U, AU>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+#if defined(XTENSOR_USE_NUMA)
+    template <class T, class A>
+    inline numa_interleave_allocator<T, A>::numa_interleave_allocator(const A& alloc)
+        : A(alloc)
+    {
+    }
+
+    template <class T, class A>
+    template <class U, class AU>
+    inline numa_interleave_allocator<T, A>::numa_interleave_allocator(const numa_interleave_allocator<U, AU>& rhs)
+        : A(rhs.base())
+    {
+    }
+
+    template <class T, class A>
+    inline auto numa_interleave_allocator<T, A>::allocate(size_type n) -> pointer
+    {
+        std::size_t bytes = n * sizeof(T);
+        if (bytes < min_size() || numa_available() < 0)
+        {
+            return traits::allocate(*this, n);
+        }
+        void* res = numa_alloc_interleaved(bytes);
+        if (res == nullptr)
+        {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+            XTENSOR_THROW(std::bad_alloc, "numa_alloc_interleaved failed");
+#else
+            throw std::bad_alloc();
+#endif
+        }
+        return static_cast<pointer>(res);
+    }
+
+    template <class T, class A>
+    inline void numa_interleave_allocator<T, A>::deallocate(pointer p, size_type n)
+    {
+        std::size_t bytes = n * sizeof(T);
+        if (bytes < min_size() || numa_available() < 0)
+        {
+            traits::deallocate(*this, p, n);
+        }
+        else
+        {
+            numa_free(p, bytes);
+        }
+    }
+
+    template <class T, class A>
+    inline auto numa_interleave_allocator<T, A>::base() const noexcept -> const base_type&
+    {
+        return *this;
+    }
+
+    /**
+     * Returns the size in bytes from which blocks are interleaved.
+     */
+    template <class T, class A>
+    inline constexpr std::size_t numa_interleave_allocator<T, A>::min_size() noexcept
+    {
+        return std::size_t(1) << 16;
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator==(const numa_interleave_allocator<T, AT>& lhs, const numa_interleave_allocator<U, AU>& rhs)
+    {
+        return lhs.base() == rhs.base();
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator!=(const numa_interleave_allocator<T, AT>& lhs, const numa_interleave_allocator<U, AU>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+#endif
+
+    namespace detail
+    {
+        constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+#if defined(__linux__)
+        constexpr bool has_huge_page_mapping = true;
+
+        // Maps size bytes, a multiple of huge_page_size, at an address
+        // aligned on huge_page_size; returns nullptr on failure
+        inline void* map_huge_pages(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_USE_HUGETLB) && defined(MAP_HUGETLB)
+            void* hugetlb = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (hugetlb != MAP_FAILED)
+            {
+                return hugetlb;
+            }
+#endif
+            // Over-mapping by one huge page leaves room to align the block,
+            // the unused head and tail being unmapped
+            void* raw = mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            char* first = static_cast<char*>(raw);
+            std::size_t head = (huge_page_size - reinterpret_cast<std::uintptr_t>(first) % huge_page_size) % huge_page_size;
+            char* res = first + head;
+            if (head != 0)
+            {
+                munmap(first, head);
+            }
+            if (huge_page_size - head != 0)
+            {
+                munmap(res + size, huge_page_size - head);
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(res, size, MADV_HUGEPAGE);
+#endif
+            return res;
+        }
+
+        inline void unmap_huge_pages(void* p, std::size_t size) noexcept
+        {
+            munmap(p, size);
+        }
+#else
+        constexpr bool has_huge_page_mapping = false;
+
+        inline void* map_huge_pages(std::size_t) noexcept
+        {
+            return nullptr;
+        }
+
+        inline void unmap_huge_pages(void*, std::size_t) noexcept
+        {
+        }
+#endif
+    }
+
+    template <class T, class A>
+    inline huge_page_allocator<T, A>::huge_page_allocator(const A& alloc)
+        : A(alloc)
+    {
+    }
+
+    template <class T, class A>
+    template <class U, class AU>
+    inline huge_page_allocator<T, A>::huge_page_allocator(const huge_page_allocator<U, AU>& rhs)
+        : A(rhs.base())
+    {
+    }
+
+    template <class T, class A>
+    inline auto huge_page_allocator<T, A>::allocate(size_type n) -> pointer
+    {
+        std::size_t bytes = n * sizeof(T);
+        if (!detail::has_huge_page_mapping || bytes < min_size())
+        {
+            return traits::allocate(*this, n);
+        }
+        std::size_t size = (bytes + huge_page_size() - 1) / huge_page_size() * huge_page_size();
+        void* res = detail::map_huge_pages(size);
+        if (res == nullptr)
+        {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+            XTENSOR_THROW(std::bad_alloc, "mmap failed");
+#else
+            throw std::bad_alloc();
+#endif
+        }
+        return static_cast<pointer>(res);
+    }
+
+    template <class T, class A>
+    inline void huge_page_allocator<T, A>::deallocate(pointer p, size_type n)
+    {
+        std::size_t bytes = n * sizeof(T);
+        if (!detail::has_huge_page_mapping || bytes < min_size())
+        {
+            traits::deallocate(*this, p, n);
+        }
+        else
+        {
+            detail::unmap_huge_pages(p, (bytes + huge_page_size() - 1) / huge_page_size() * huge_page_size());
+        }
+    }
+
+    template <class T, class A>
+    inline auto huge_page_allocator<T, A>::base() const noexcept -> const base_type&
+    {
+        return *this;
+    }
+
+    /**
+     * Returns the size and alignment in bytes of the huge pages.
+     */
+    template <class T, class A>
+    inline constexpr std::size_t huge_page_allocator<T, A>::huge_page_size() noexcept
+    {
+        return detail::huge_page_size;
+    }
+
+    /**
+     * Returns the size in bytes from which blocks are mapped on huge pages.
+     */
+    template <class T, class A>
+    inline constexpr std::size_t huge_page_allocator<T, A>::min_size() noexcept
+    {
+        return detail::huge_page_size;
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator==(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs)
+    {
+        return lhs.base() == rhs.base();
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator!=(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
     template <class T, class A = std::allocator<T>>
     class uvector
     {
@@ -62,6 +548,7 @@ namespace xt
         uvector() noexcept;
         explicit uvector(const allocator_type& alloc) noexcept;
         explicit uvector(size_type count, const allocator_type& alloc = allocator_type());
+        uvector(size_type count, uninitialized_t, const allocator_type& alloc = allocator_type());
         uvector(size_type count, const_reference value, const allocator_type& alloc = allocator_type());
 
         template <class InputIt, class = detail::require_input_iter<InputIt>>
@@ -84,6 +571,7 @@ namespace xt
         bool empty() const noexcept;
         size_type size() const noexcept;
         void resize(size_type size);
+        void resize(size_type size, uninitialized_t);
         size_type max_size() const noexcept;
         void reserve(size_type new_cap);
         size_type capacity() const noexcept;
@@ -130,7 +618,11 @@ namespace xt
         template <class I>
         void init_data(I first, I last);
 
+        template <class F>
+        void resize_impl(size_type new_size, F&& init);
         void resize_impl(size_type new_size);
+        void resize_impl(size_type new_size, uninitialized_t);
+        void reallocate(size_type new_cap);
 
         allocator_type m_allocator;
 
@@ -138,6 +630,7 @@ namespace xt
         // storing a pointer to the beginning and the size of the container
         pointer p_begin;
         pointer p_end;
+        pointer p_capacity_end;
     };
 
     template <class T, class A>
@@ -185,24 +678,91 @@ namespace xt
             return res;
         }
 
+        // Default-initializes the elements, which leaves the memory untouched
+        // for trivially default constructible types.
         template <class A>
-        inline void safe_destroy_deallocate(A& alloc, typename std::allocator_traits<A>::pointer ptr,
-                                            typename std::allocator_traits<A>::size_type size)
+        inline typename std::allocator_traits<A>::pointer
+        default_init_allocate(A& alloc, typename std::allocator_traits<A>::size_type size)
         {
             using traits = std::allocator_traits<A>;
             using pointer = typename traits::pointer;
             using value_type = typename traits::value_type;
-            if (ptr != nullptr)
+            pointer res = alloc.allocate(size);
+            if (!xtrivially_default_constructible<value_type>::value)
             {
-                if (!xtrivially_default_constructible<value_type>::value)
+                for (pointer p = res; p != res + size; ++p)
                 {
-                    for (pointer p = ptr; p != ptr + size; ++p)
-                    {
-                        traits::destroy(alloc, p);
-                    }
+                    ::new (static_cast<void*>(std::addressof(*p))) value_type;
                 }
-                traits::deallocate(alloc, ptr, size);
             }
+            return res;
+        }
+
+        template <class A>
+        inline void safe_init(A& alloc, typename std::allocator_traits<A>::pointer first,
+                              typename std::allocator_traits<A>::pointer last)
+        {
+            using traits = std::allocator_traits<A>;
+            using pointer = typename traits::pointer;
+            using value_type = typename traits::value_type;
+            if (!xtrivially_default_constructible<value_type>::value)
+            {
+                for (pointer p = first; p != last; ++p)
+                {
+                    traits::construct(alloc, p, value_type());
+                }
+            }
+        }
+
+        template <class A>
+        inline void default_init(A&, typename std::allocator_traits<A>::pointer first,
+                                 typename std::allocator_traits<A>::pointer last)
+        {
+            using pointer = typename std::allocator_traits<A>::pointer;
+            using value_type = typename std::allocator_traits<A>::value_type;
+            if (!xtrivially_default_constructible<value_type>::value)
+            {
+                for (pointer p = first; p != last; ++p)
+                {
+                    ::new (static_cast<void*>(std::addressof(*p))) value_type;
+                }
+            }
+        }
+
+        template <class A>
+        inline void safe_destroy(A& alloc, typename std::allocator_traits<A>::pointer first,
+                                 typename std::allocator_traits<A>::pointer last)
+        {
+            using traits = std::allocator_traits<A>;
+            using pointer = typename traits::pointer;
+            using value_type = typename traits::value_type;
+            if (!xtrivially_default_constructible<value_type>::value)
+            {
+                for (pointer p = first; p != last; ++p)
+                {
+                    traits::destroy(alloc, p);
+                }
+            }
+        }
+
+        template <class A>
+        inline void safe_destroy_deallocate(A& alloc, typename std::allocator_traits<A>::pointer ptr,
+                                            typename std::allocator_traits<A>::size_type size,
+                                            typename std::allocator_traits<A>::size_type capacity)
+        {
+            using traits = std::allocator_traits<A>;
+            if (ptr != nullptr)
+            {
+                safe_destroy(alloc, ptr, ptr + size);
+                traits::deallocate(alloc, ptr, capacity);
+            }
+        }
+
+        template <class A>
+        inline void safe_destroy_deallocate(A& alloc, typename std::allocator_traits<A>::pointer ptr,
+                                            typename std::allocator_traits<A>::size_type size)
+        {
+            safe_destroy_deallocate(alloc, ptr, size, size);
         }
     }
 
@@ -216,20 +776,81 @@ namespace xt
             p_begin = m_allocator.allocate(size);
             std::uninitialized_copy(first, last, p_begin);
             p_end = p_begin + size;
+            p_capacity_end = p_end;
+        }
+    }
+
+    // A size within the capacity reuses the buffer, keeping the elements
+    // that are still in range. A larger size allocates a buffer of exactly
+    // new_size elements, the previous elements being dropped. init
+    // initializes the new elements.
+    template <class T, class A>
+    template <class F>
+    inline void uvector<T, A>::resize_impl(size_type new_size, F&& init)
+    {
+        size_type old_size = size();
+        if (new_size <= capacity())
+        {
+            if (new_size < old_size)
+            {
+                detail::safe_destroy(m_allocator, p_begin + new_size, p_end);
+            }
+            else
+            {
+                init(p_end, p_begin + new_size);
+            }
+            p_end = p_begin + new_size;
+        }
+        else
+        {
+            pointer old_begin = p_begin;
+            size_type old_cap = capacity();
+            pointer new_begin = m_allocator.allocate(new_size);
+            init(new_begin, new_begin + new_size);
+            p_begin = new_begin;
+            p_end = p_begin + new_size;
+            p_capacity_end = p_end;
+            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size, old_cap);
         }
     }
 
     template <class T, class A>
     inline void uvector<T, A>::resize_impl(size_type new_size)
+    {
+        resize_impl(new_size, [this](pointer first, pointer last) { detail::safe_init(m_allocator, first, last); });
+    }
+
+    template <class T, class A>
+    inline void uvector<T, A>::resize_impl(size_type new_size, uninitialized_t)
+    {
+        resize_impl(new_size, [this](pointer first, pointer last) { detail::default_init(m_allocator, first, last); });
+    }
+
+    // Moves the elements to a buffer of new_cap elements, new_cap being at
+    // least size(); a capacity of 0 frees the buffer
+    template <class T, class A>
+    inline void uvector<T, A>::reallocate(size_type new_cap)
     {
         size_type old_size = size();
+        size_type old_cap = capacity();
         pointer old_begin = p_begin;
-        if (new_size != old_size)
+        pointer new_begin = nullptr;
+        if (new_cap != 0)
         {
-            p_begin = detail::safe_init_allocate(m_allocator, new_size);
-            p_end = p_begin + new_size;
-            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size);
+            new_begin = m_allocator.allocate(new_cap);
+            if (xtrivially_default_constructible<value_type>::value)
+            {
+                std::uninitialized_copy(p_begin, p_end, new_begin);
+            }
+            else
+            {
+                std::uninitialized_copy(std::make_move_iterator(p_begin), std::make_move_iterator(p_end), new_begin);
+            }
         }
+        p_begin = new_begin;
+        p_end = new_begin == nullptr ? nullptr : new_begin + old_size;
+        p_capacity_end = new_begin == nullptr ? nullptr : new_begin + new_cap;
+        detail::safe_destroy_deallocate(m_allocator, old_begin, old_size, old_cap);
     }
 
     template <class T, class A>
@@ -240,29 +861,47 @@ namespace xt
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const allocator_type& alloc) noexcept
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(size_type count, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
         if (count != 0)
         {
             p_begin = detail::safe_init_allocate(m_allocator, count);
             p_end = p_begin + count;
+            p_capacity_end = p_end;
+        }
+    }
+
+    /**
+     * Builds a uvector of \c count default-initialized elements: the buffer
+     * is not written if \c T is trivially default constructible.
+     */
+    template <class T, class A>
+    inline uvector<T, A>::uvector(size_type count, uninitialized_t, const allocator_type& alloc)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
+    {
+        if (count != 0)
+        {
+            p_begin = detail::default_init_allocate(m_allocator, count);
+            p_end = p_begin + count;
+            p_capacity_end = p_end;
         }
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(size_type count, const_reference value, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
         if (count != 0)
         {
             p_begin = m_allocator.allocate(count);
             p_end = p_begin + count;
+            p_capacity_end = p_end;
             std::uninitialized_fill(p_begin, p_end, value);
         }
     }
@@ -270,14 +909,14 @@ namespace xt
     template <class T, class A>
     template <class InputIt, class>
     inline uvector<T, A>::uvector(InputIt first, InputIt last, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
         init_data(first, last);
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(std::initializer_list<T> init, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
         init_data(init.begin(), init.end());
     }
@@ -285,22 +924,23 @@ namespace xt
     template <class T, class A>
     inline uvector<T, A>::~uvector()
     {
-        detail::safe_destroy_deallocate(m_allocator, p_begin, size());
+        detail::safe_destroy_deallocate(m_allocator, p_begin, size(), capacity());
         p_begin = nullptr;
         p_end = nullptr;
+        p_capacity_end = nullptr;
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const uvector& rhs)
         : m_allocator(std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.get_allocator())),
-          p_begin(nullptr), p_end(nullptr)
+          p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
         init_data(rhs.p_begin, rhs.p_end);
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(const uvector& rhs, const allocator_type& alloc)
-        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr), p_capacity_end(nullptr)
     {
         init_data(rhs.p_begin, rhs.p_end);
     }
@@ -327,18 +967,20 @@ namespace xt
 
     template <class T, class A>
     inline uvector<T, A>::uvector(uvector&& rhs) noexcept
-        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end)
+        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end), p_capacity_end(rhs.p_capacity_end)
     {
         rhs.p_begin = nullptr;
         rhs.p_end = nullptr;
+        rhs.p_capacity_end = nullptr;
     }
 
     template <class T, class A>
     inline uvector<T, A>::uvector(uvector&& rhs, const allocator_type& alloc) noexcept
-        : m_allocator(alloc), p_begin(rhs.p_begin), p_end(rhs.p_end)
+        : m_allocator(alloc), p_begin(rhs.p_begin), p_end(rhs.p_end), p_capacity_end(rhs.p_capacity_end)
     {
         rhs.p_begin = nullptr;
         rhs.p_end = nullptr;
+        rhs.p_capacity_end = nullptr;
     }
 
     template <class T, class A>
@@ -346,8 +988,10 @@ namespace xt
     {
         using std::swap;
         uvector tmp(std::move(rhs));
+        swap(m_allocator, tmp.m_allocator);
         swap(p_begin, tmp.p_begin);
         swap(p_end, tmp.p_end);
+        swap(p_capacity_end, tmp.p_capacity_end);
         return *this;
     }
 
@@ -375,28 +1019,58 @@ namespace xt
         resize_impl(size);
     }
 
+    /**
+     * Resizes the uvector, default-initializing the new elements: the buffer
+     * is not written if \c T is trivially default constructible. As for
+     * resize(size), the previous elements are not preserved.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::resize(size_type size, uninitialized_t)
+    {
+        resize_impl(size, uninitialized);
+    }
+
     template <class T, class A>
     inline auto uvector<T, A>::max_size() const noexcept -> size_type
     {
         return m_allocator.max_size();
     }
 
+    /**
+     * Makes the capacity at least \c new_cap, preserving the elements, so
+     * that the next resizes up to \c new_cap elements do not allocate.
+     */
     template <class T, class A>
-    inline void uvector<T, A>::reserve(size_type /*new_cap*/)
+    inline void uvector<T, A>::reserve(size_type new_cap)
     {
+        if (new_cap > capacity())
+        {
+            reallocate(new_cap);
+        }
     }
 
     template <class T, class A>
     inline auto uvector<T, A>::capacity() const noexcept -> size_type
     {
-        return size();
+        return static_cast<size_type>(p_capacity_end - p_begin);
     }
 
+    /**
+     * Reallocates the buffer to the size of the uvector, preserving the
+     * elements, and frees it when the uvector is empty.
+     */
     template <class T, class A>
     inline void uvector<T, A>::shrink_to_fit()
     {
+        if (capacity() != size())
+        {
+            reallocate(size());
+        }
     }
 
+    /**
+     * Destroys the elements; the capacity is left unchanged.
+     */
     template <class T, class A>
     inline void uvector<T, A>::clear()
     {
@@ -546,6 +1220,7 @@ namespace xt
         swap(m_allocator, rhs.m_allocator);
         swap(p_begin, rhs.p_begin);
         swap(p_end, rhs.p_end);
+        swap(p_capacity_end, rhs.p_capacity_end);
     }
 
     template <class T, class A>
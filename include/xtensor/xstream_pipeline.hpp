@@ -0,0 +1,433 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_STREAM_PIPELINE_HPP
+#define XTENSOR_STREAM_PIPELINE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "xexception.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /*****************
+     * xstream_queue *
+     *****************/
+
+    /**
+     * @class xstream_queue
+     * @brief Bounded blocking queue connecting the stages of an xstream_pipeline.
+     *
+     * push blocks while the queue is full and pop while it is empty. Once
+     * the queue is closed, push fails and pop fails as soon as the queue
+     * is empty, which wakes up the stages waiting on it.
+     *
+     * @tparam T The type of the elements.
+     */
+    template <class T>
+    class xstream_queue
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+
+        explicit xstream_queue(size_type capacity);
+
+        bool push(value_type value);
+        bool pop(value_type& value);
+        void close();
+
+        size_type capacity() const noexcept;
+
+    private:
+
+        std::mutex m_mutex;
+        std::condition_variable m_not_empty;
+        std::condition_variable m_not_full;
+        std::deque<value_type> m_items;
+        size_type m_capacity;
+        bool m_closed;
+    };
+
+    /********************
+     * xstream_pipeline *
+     ********************/
+
+    /**
+     * @class xstream_pipeline
+     * @brief Chain of stages processing a stream of buffers concurrently.
+     *
+     * A pipeline is made of a source filling buffers, stages transforming
+     * them in place, and a sink consuming them, e.g. reading the batches of
+     * a csv_reader, normalizing them with in-place math functions, and
+     * updating a streaming reducer or a histogram. Each stage runs on its
+     * own thread, the sink on the thread calling run, and consecutive stages
+     * are connected by bounded queues: while a stage processes a buffer,
+     * the previous one already fills the next.
+     *
+     * The buffers are allocated once per run and recycled: the sink hands
+     * each buffer back to the source, which waits for a free buffer when
+     * all of them are in flight. The memory used by a run is therefore
+     * bounded by buffers() buffers, whatever the length of the stream, and
+     * a source assigning batches of the same shape to the buffers stops
+     * allocating after the first round.
+     *
+     * \code{.cpp}
+     * xt::csv_reader<double> reader(in, 1024);
+     * auto acc = xt::make_streaming_reducer<double>(std::plus<double>(), {0});
+     * xt::xstream_pipeline<xt::xarray<double>> p;
+     * p.source([&](xt::xarray<double>& b) { if (!reader.next()) return false; b = reader.batch(); return true; })
+     *  .stage([](xt::xarray<double>& b) { xt::log1p_inplace(b); })
+     *  .sink([&](const xt::xarray<double>& b) { acc.update(b); });
+     * p.run();
+     * \endcode
+     *
+     * @tparam B The type of the buffers, e.g. xarray<double>.
+     */
+    template <class B>
+    class xstream_pipeline
+    {
+    public:
+
+        using buffer_type = B;
+        using size_type = std::size_t;
+        using source_type = std::function<bool(buffer_type&)>;
+        using stage_type = std::function<void(buffer_type&)>;
+        using sink_type = std::function<void(const buffer_type&)>;
+
+        explicit xstream_pipeline(size_type queue_capacity = 2);
+
+        template <class F>
+        xstream_pipeline& source(F&& f);
+        template <class F>
+        xstream_pipeline& stage(F&& f);
+        template <class F>
+        xstream_pipeline& sink(F&& f);
+
+        size_type stages() const noexcept;
+        size_type buffers() const noexcept;
+
+        size_type run();
+
+    private:
+
+        using queue_type = xstream_queue<buffer_type>;
+
+        void run_source(queue_type& free, queue_type& out);
+        void run_stage(const stage_type& f, queue_type& in, queue_type& out);
+        size_type run_sink(queue_type& in, queue_type& free);
+
+        template <class F>
+        void guard(std::vector<queue_type*>& queues, F&& f);
+
+        source_type m_source;
+        std::vector<stage_type> m_stages;
+        sink_type m_sink;
+        size_type m_queue_capacity;
+        std::mutex m_error_mutex;
+        std::exception_ptr m_error;
+    };
+
+    /********************************
+     * xstream_queue implementation *
+     ********************************/
+
+    template <class T>
+    inline xstream_queue<T>::xstream_queue(size_type capacity)
+        : m_capacity(capacity), m_closed(false)
+    {
+        if (capacity == 0)
+        {
+            XTENSOR_THROW(std::invalid_argument, "xstream_queue: capacity must be positive");
+        }
+    }
+
+    /**
+     * Appends \c value to the queue, waiting for a free slot.
+     * @return false if the queue is closed, in which case \c value is dropped.
+     */
+    template <class T>
+    inline bool xstream_queue<T>::push(value_type value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+        {
+            return false;
+        }
+        m_items.push_back(std::move(value));
+        lock.unlock();
+        m_not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * Moves the first element of the queue to \c value, waiting for one.
+     * @return false if the queue is closed and empty.
+     */
+    template <class T>
+    inline bool xstream_queue<T>::pop(value_type& value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+        {
+            return false;
+        }
+        value = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    /**
+     * Closes the queue; the elements already queued can still be popped.
+     */
+    template <class T>
+    inline void xstream_queue<T>::close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+    template <class T>
+    inline auto xstream_queue<T>::capacity() const noexcept -> size_type
+    {
+        return m_capacity;
+    }
+
+    /***********************************
+     * xstream_pipeline implementation *
+     ***********************************/
+
+    /**
+     * Builds an empty pipeline.
+     * @param queue_capacity the number of buffers each queue between two
+     *        stages can hold.
+     */
+    template <class B>
+    inline xstream_pipeline<B>::xstream_pipeline(size_type queue_capacity)
+        : m_queue_capacity(queue_capacity)
+    {
+        if (queue_capacity == 0)
+        {
+            XTENSOR_THROW(std::invalid_argument, "xstream_pipeline: queue capacity must be positive");
+        }
+    }
+
+    /**
+     * Sets the source of the pipeline, a callable filling the buffer it is
+     * passed and returning false when the stream is exhausted. The buffer
+     * holds the data of a previous batch, or is default constructed.
+     */
+    template <class B>
+    template <class F>
+    inline auto xstream_pipeline<B>::source(F&& f) -> xstream_pipeline&
+    {
+        m_source = std::forward<F>(f);
+        return *this;
+    }
+
+    /**
+     * Appends a stage transforming the buffers in place. The stages are
+     * applied in the order they are added.
+     */
+    template <class B>
+    template <class F>
+    inline auto xstream_pipeline<B>::stage(F&& f) -> xstream_pipeline&
+    {
+        m_stages.emplace_back(std::forward<F>(f));
+        return *this;
+    }
+
+    /**
+     * Sets the sink of the pipeline, a callable consuming the buffers in
+     * the order the source produced them. The buffer must not be kept,
+     * since it is recycled once the sink returns.
+     */
+    template <class B>
+    template <class F>
+    inline auto xstream_pipeline<B>::sink(F&& f) -> xstream_pipeline&
+    {
+        m_sink = std::forward<F>(f);
+        return *this;
+    }
+
+    /**
+     * Returns the number of in-place stages.
+     */
+    template <class B>
+    inline auto xstream_pipeline<B>::stages() const noexcept -> size_type
+    {
+        return m_stages.size();
+    }
+
+    /**
+     * Returns the number of buffers allocated by run: one per thread, so
+     * that no stage waits for a buffer in the steady state, and the
+     * capacity of a queue to absorb the variations of the stage durations.
+     */
+    template <class B>
+    inline auto xstream_pipeline<B>::buffers() const noexcept -> size_type
+    {
+        return m_stages.size() + 2 + m_queue_capacity;
+    }
+
+    /**
+     * Runs the pipeline until the source is exhausted and the sink has
+     * consumed all the buffers. If a stage throws, the pipeline is stopped
+     * and the first exception is rethrown once all the threads are joined.
+     * @return the number of buffers consumed by the sink.
+     */
+    template <class B>
+    inline auto xstream_pipeline<B>::run() -> size_type
+    {
+        if (!m_source)
+        {
+            XTENSOR_THROW(std::logic_error, "xstream_pipeline: no source");
+        }
+        m_error = nullptr;
+
+        queue_type free(buffers());
+        std::deque<queue_type> links;
+        for (size_type i = 0; i <= m_stages.size(); ++i)
+        {
+            links.emplace_back(m_queue_capacity);
+        }
+        std::vector<queue_type*> queues = {&free};
+        for (auto& q : links)
+        {
+            queues.push_back(&q);
+        }
+        for (size_type i = 0; i < buffers(); ++i)
+        {
+            free.push(buffer_type());
+        }
+
+        std::vector<std::thread> threads;
+        threads.emplace_back([this, &queues, &free, &links]()
+        {
+            guard(queues, [&]() { run_source(free, links.front()); });
+        });
+        for (size_type i = 0; i < m_stages.size(); ++i)
+        {
+            threads.emplace_back([this, i, &queues, &links]()
+            {
+                guard(queues, [&]() { run_stage(m_stages[i], links[i], links[i + 1]); });
+            });
+        }
+        size_type count = 0;
+        guard(queues, [&]() { count = run_sink(links.back(), free); });
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+        return count;
+    }
+
+    template <class B>
+    inline void xstream_pipeline<B>::run_source(queue_type& free, queue_type& out)
+    {
+        buffer_type buffer;
+        while (free.pop(buffer) && m_source(buffer))
+        {
+            if (!out.push(std::move(buffer)))
+            {
+                break;
+            }
+        }
+        out.close();
+    }
+
+    template <class B>
+    inline void xstream_pipeline<B>::run_stage(const stage_type& f, queue_type& in, queue_type& out)
+    {
+        buffer_type buffer;
+        while (in.pop(buffer))
+        {
+            f(buffer);
+            if (!out.push(std::move(buffer)))
+            {
+                break;
+            }
+        }
+        out.close();
+    }
+
+    template <class B>
+    inline auto xstream_pipeline<B>::run_sink(queue_type& in, queue_type& free) -> size_type
+    {
+        size_type count = 0;
+        buffer_type buffer;
+        while (in.pop(buffer))
+        {
+            if (m_sink)
+            {
+                m_sink(buffer);
+            }
+            ++count;
+            free.push(std::move(buffer));
+        }
+        return count;
+    }
+
+    // Records the first exception thrown by a stage and closes all the
+    // queues, so that the other stages stop instead of waiting forever.
+    template <class B>
+    template <class F>
+    inline void xstream_pipeline<B>::guard(std::vector<queue_type*>& queues, F&& f)
+    {
+#if defined(XTENSOR_DISABLE_EXCEPTIONS)
+        (void) queues;
+        f();
+#else
+        try
+        {
+            f();
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_error_mutex);
+                if (!m_error)
+                {
+                    m_error = std::current_exception();
+                }
+            }
+            for (auto* q : queues)
+            {
+                q->close();
+            }
+        }
+#endif
+    }
+}
+
+#endif
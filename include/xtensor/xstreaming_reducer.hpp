@@ -0,0 +1,292 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_STREAMING_REDUCER_HPP
+#define XTENSOR_STREAMING_REDUCER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "xarray.hpp"
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xreducer.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /**********************
+     * xstreaming_reducer *
+     **********************/
+
+    /**
+     * @class xstreaming_reducer
+     * @brief Reduction accumulated over batches of data.
+     *
+     * The xstreaming_reducer class maintains the result of a reduction
+     * over the specified axes while the reduced data is received in
+     * successive batches, e.g. frames stacked along a reduced axis.
+     * Each batch is reduced immediately and its result is combined with
+     * the partial result using the merge functor of the reducer, so that
+     * the batches never need to be concatenated. Partial results computed
+     * by different reducers, for instance on different threads, can be
+     * combined with merge.
+     *
+     * As for the chunked immediate reductions, the init functor is applied
+     * to each batch: it must be the identity of the merge functor.
+     *
+     * @tparam F the reducing functors (class \ref xreducer_functors or compatible)
+     * @tparam T the value type of the reduced data
+     * @tparam X the list of axes
+     * @tparam O the options of the reduction
+     *
+     * @sa make_streaming_reducer
+     */
+    template <class F, class T, class X, class O>
+    class xstreaming_reducer
+    {
+    public:
+
+        using self_type = xstreaming_reducer<F, T, X, O>;
+        using functors_type = F;
+        using reduce_functor_type = typename functors_type::reduce_functor_type;
+        using init_functor_type = typename functors_type::init_functor_type;
+        using merge_functor_type = typename functors_type::merge_functor_type;
+        using value_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(
+            std::declval<init_functor_type>()(), std::declval<T>()))>;
+        using axes_type = X;
+        using options_type = reducer_options<value_type, std::decay_t<O>>;
+        using keep_dims = typename options_type::keep_dims;
+        using result_type = xarray<value_type>;
+        using size_type = std::size_t;
+
+        template <class FA, class XA>
+        xstreaming_reducer(FA&& functors, XA&& axes, const O& options);
+
+        template <class E>
+        void update(const xexpression<E>& e);
+
+        void merge(const self_type& other);
+
+        bool empty() const noexcept;
+        size_type batches() const noexcept;
+        const axes_type& axes() const noexcept;
+
+        result_type result() const;
+        void reset() noexcept;
+
+    private:
+
+        using batch_options_type = std::conditional_t<keep_dims::value,
+                                                      std::tuple<evaluation_strategy::immediate_type, keep_dims_type>,
+                                                      std::tuple<evaluation_strategy::immediate_type>>;
+
+        template <class R>
+        void merge_partial(const R& partial);
+
+        functors_type m_functors;
+        axes_type m_axes;
+        options_type m_options;
+        result_type m_partial;
+        size_type m_batches;
+    };
+
+    template <class T, class F, class X, class O = std::tuple<evaluation_strategy::immediate_type>>
+    auto make_streaming_reducer(F&& f, X&& axes, O options = O());
+
+    template <class T, class F, class I, std::size_t N, class O = std::tuple<evaluation_strategy::immediate_type>>
+    auto make_streaming_reducer(F&& f, const I (&axes)[N], O options = O());
+
+    /*************************************
+     * xstreaming_reducer implementation *
+     *************************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs an empty streaming reducer.
+     * @param functors the reducing functors
+     * @param axes the axes along which each batch is reduced
+     * @param options the options of the reduction (keep_dims, initial value)
+     */
+    template <class F, class T, class X, class O>
+    template <class FA, class XA>
+    inline xstreaming_reducer<F, T, X, O>::xstreaming_reducer(FA&& functors, XA&& axes, const O& options)
+        : m_functors(std::forward<FA>(functors)), m_axes(std::forward<XA>(axes)), m_options(options),
+          m_partial(), m_batches(0)
+    {
+    }
+    //@}
+
+    /**
+     * @name Accumulation
+     */
+    //@{
+    /**
+     * Reduces \c e along the axes of the reducer and combines the result
+     * with the partial result of the previous batches. All the batches
+     * must have the same shape along the axes that are not reduced.
+     * @param e the batch to reduce
+     */
+    template <class F, class T, class X, class O>
+    template <class E>
+    inline void xstreaming_reducer<F, T, X, O>::update(const xexpression<E>& e)
+    {
+        merge_partial(reduce(m_functors, e.derived_cast(), m_axes, batch_options_type()));
+    }
+
+    /**
+     * Combines the partial result of \c other into this reducer.
+     * @param other a streaming reducer built with the same functors and axes
+     */
+    template <class F, class T, class X, class O>
+    inline void xstreaming_reducer<F, T, X, O>::merge(const self_type& other)
+    {
+        if (other.m_batches != 0)
+        {
+            size_type batches = m_batches;
+            merge_partial(other.m_partial);
+            m_batches = batches + other.m_batches;
+        }
+    }
+    //@}
+
+    /**
+     * @name Result
+     */
+    //@{
+    /**
+     * Returns true if no batch has been reduced yet.
+     */
+    template <class F, class T, class X, class O>
+    inline bool xstreaming_reducer<F, T, X, O>::empty() const noexcept
+    {
+        return m_batches == 0;
+    }
+
+    /**
+     * Returns the number of batches reduced so far, including those of the
+     * merged reducers.
+     */
+    template <class F, class T, class X, class O>
+    inline auto xstreaming_reducer<F, T, X, O>::batches() const noexcept -> size_type
+    {
+        return m_batches;
+    }
+
+    /**
+     * Returns the axes along which the batches are reduced.
+     */
+    template <class F, class T, class X, class O>
+    inline auto xstreaming_reducer<F, T, X, O>::axes() const noexcept -> const axes_type&
+    {
+        return m_axes;
+    }
+
+    /**
+     * Returns the reduction of all the batches received so far, merged with
+     * the initial value of the options if any.
+     * @throws std::runtime_error if no batch has been reduced.
+     */
+    template <class F, class T, class X, class O>
+    inline auto xstreaming_reducer<F, T, X, O>::result() const -> result_type
+    {
+        if (m_batches == 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "Streaming reducer has not received any batch.");
+        }
+        result_type res = m_partial;
+        xtl::mpl::static_if<options_type::has_initial_value>([&](auto self)
+        {
+            auto merge_fct = xt::get<2>(m_functors);
+            std::transform(res.begin(), res.end(), res.begin(),
+                           [&](const value_type& v) { return merge_fct(v, self(m_options).initial_value); });
+        }, /*else*/ [](auto /*self*/) {});
+        return res;
+    }
+
+    /**
+     * Discards the partial result.
+     */
+    template <class F, class T, class X, class O>
+    inline void xstreaming_reducer<F, T, X, O>::reset() noexcept
+    {
+        m_partial = result_type();
+        m_batches = 0;
+    }
+    //@}
+
+    template <class F, class T, class X, class O>
+    template <class R>
+    inline void xstreaming_reducer<F, T, X, O>::merge_partial(const R& partial)
+    {
+        if (m_batches == 0)
+        {
+            m_partial = partial;
+        }
+        else
+        {
+            if (partial.dimension() != m_partial.dimension() ||
+                !std::equal(partial.shape().cbegin(), partial.shape().cend(), m_partial.shape().cbegin()))
+            {
+                XTENSOR_THROW(std::runtime_error, "Incompatible batch shape in streaming reduction.");
+            }
+            auto merge_fct = xt::get<2>(m_functors);
+            std::transform(m_partial.begin(), m_partial.end(), partial.begin(), m_partial.begin(), merge_fct);
+        }
+        ++m_batches;
+    }
+
+    /**
+     * @brief Builds a streaming reducer.
+     *
+     * @tparam T the value type of the batches to reduce
+     * @param f the reducing functors (class \ref xreducer_functors), or a
+     *        binary reducing function used for both reducing and merging
+     * @param axes the axes along which each batch is reduced
+     * @param options the options of the reduction, e.g. \c keep_dims or
+     *        \c xt::initial(value); the evaluation strategy is ignored
+     * @return an xstreaming_reducer to which batches are given with update
+     *
+     * @code{.cpp}
+     * auto running_sum = xt::make_streaming_reducer<double>(xt::make_xreducer_functor(std::plus<double>()), {0});
+     * running_sum.update(frames_0);
+     * running_sum.update(frames_1);
+     * xt::xarray<double> s = running_sum.result();
+     * @endcode
+     */
+    template <class T, class F, class X, class O>
+    inline auto make_streaming_reducer(F&& f, X&& axes, O options)
+    {
+        using functors_type = decltype(detail::as_xreducer_functors(f));
+        using axes_type = std::decay_t<X>;
+        using reducer_type = xstreaming_reducer<functors_type, T, axes_type, O>;
+        return reducer_type(detail::as_xreducer_functors(f), std::forward<X>(axes), options);
+    }
+
+    template <class T, class F, class I, std::size_t N, class O>
+    inline auto make_streaming_reducer(F&& f, const I (&axes)[N], O options)
+    {
+        // Negative axes are normalized by each reduction, once the
+        // dimension of the batches is known.
+        std::array<I, N> ax;
+        std::copy(axes, axes + N, ax.begin());
+        return make_streaming_reducer<T>(std::forward<F>(f), std::move(ax), options);
+    }
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include <xtl/xsequence.hpp>
 #include <xtl/xvariant.hpp>
 
+#include "xeval.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
 #include "xlayout.hpp"
@@ -69,6 +70,11 @@ namespace xt
     template <class CT, class S, layout_type L, class FST>
     class xstrided_view;
 
+    template <class CT, class S, layout_type L, class FST>
+    struct expression_cost<xstrided_view<CT, S, L, FST>> : expression_cost<std::decay_t<CT>>
+    {
+    };
+
     template <class CT, class S, layout_type L, class FST>
     struct xcontainer_inner_types<xstrided_view<CT, S, L, FST>>
     {
@@ -347,6 +353,34 @@ namespace xt
     template <class E>
     auto strided_view(E&& e, const xstrided_slice_vector& slices);
 
+    /**
+     * @brief Checks whether reshape_view of an expression of type E traversed
+     * in the layout L is zero-copy.
+     *
+     * This is the case for containers whose static layout is L: the reshaped
+     * view then shares the storage of the container, its elements are read
+     * without any index computation and the assignments involving it are
+     * vectorized. Other expressions are read through a flat index adaptor.
+     *
+     * @tparam E the type of the expression to reshape
+     * @tparam L the layout used to read the elements
+     */
+    template <class E, layout_type L = XTENSOR_DEFAULT_TRAVERSAL>
+    struct is_zero_copy_reshape
+        : xtl::conjunction<std::is_base_of<xcontainer<std::decay_t<E>>, std::decay_t<E>>,
+                           has_data_interface<std::decay_t<E>>,
+                           std::integral_constant<bool, std::decay_t<E>::static_layout == L>>
+    {
+    };
+
+    namespace detail
+    {
+        template <class E, layout_type L>
+        using reshape_storage_getter = std::conditional_t<is_zero_copy_reshape<E, L>::value,
+                                                          inner_storage_getter<xclosure_t<E>>,
+                                                          flat_adaptor_getter<xclosure_t<E>, L>>;
+    }
+
     /********************************
      * xstrided_view implementation *
      ********************************/
@@ -718,6 +752,25 @@ namespace xt
         return view_type(std::forward<E>(e), std::move(args.new_shape), std::move(args.new_strides), args.new_offset, args.new_layout);
     }
 
+    /**
+     * @brief Return a view on an expression with a new shape
+     *
+     * The elements of \c e are read in the layout \c L. When
+     * is_zero_copy_reshape<E, L> holds, the view shares the storage of
+     * \c e and is contiguous; otherwise, the elements are computed from
+     * their flat index. Use \ref reshape_copy to reshape an expression
+     * into a new container.
+     *
+     * Note: if you resize the underlying container, this view becomes
+     * invalidated.
+     *
+     * @param e xexpression to reshape
+     * @param shape new shape
+     * @tparam L the layout used to read the elements of \c e
+     *
+     * @return view on xexpression with new shape
+     * @sa is_zero_copy_reshape
+     */
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E, class S>
     inline auto reshape_view(E&& e, S&& shape)
     {
@@ -729,8 +782,10 @@ namespace xt
         xt::resize_container(strides, shape.size());
         compute_strides(shape, L, strides);
         constexpr auto computed_layout = std::decay_t<E>::static_layout == L ? L : layout_type::dynamic;
-        using view_type = xstrided_view<xclosure_t<E>, shape_type, computed_layout, detail::flat_adaptor_getter<xclosure_t<E>, L>>;
-        return view_type(std::forward<E>(e), std::forward<S>(shape), std::move(strides), 0, e.layout());
+        using storage_getter = detail::reshape_storage_getter<E, L>;
+        using view_type = xstrided_view<xclosure_t<E>, shape_type, computed_layout, storage_getter>;
+        std::size_t offset = static_cast<std::size_t>(storage_getter::get_offset(e));
+        return view_type(std::forward<E>(e), std::forward<S>(shape), std::move(strides), offset, e.layout());
     }
 
     /**
@@ -69,7 +69,7 @@ namespace xt
             static index_type& get_index();
 
             mutable CT* m_e;
-            inner_strides_type m_strides;
+            xunravel_plan<inner_strides_type> m_plan;
             size_type m_size;
         };
 
@@ -685,15 +685,17 @@ namespace xt
             : m_e(e)
         {
             resize_container(get_index(), m_e->dimension());
-            resize_container(m_strides, m_e->dimension());
+            inner_strides_type strides;
+            resize_container(strides, m_e->dimension());
             m_size = compute_size(m_e->shape());
-            compute_strides(m_e->shape(), L, m_strides);
+            compute_strides(m_e->shape(), L, strides);
+            m_plan = xunravel_plan<inner_strides_type>(strides, L);
         }
 
         template <class CT, layout_type L>
         template <class FST>
         inline flat_expression_adaptor<CT, L>::flat_expression_adaptor(CT* e, FST&& strides)
-            : m_e(e), m_strides(xtl::forward_sequence<inner_strides_type, FST>(strides))
+            : m_e(e), m_plan(xtl::forward_sequence<inner_strides_type, FST>(strides), L)
         {
             resize_container(get_index(), m_e->dimension());
             m_size = m_e->size();
@@ -716,7 +718,7 @@ namespace xt
         inline auto flat_expression_adaptor<CT, L>::operator[](size_type idx) -> reference
         {
             auto i = static_cast<typename index_type::value_type>(idx);
-            get_index() = detail::unravel_noexcept(i, m_strides, L);
+            m_plan.unravel(i, get_index());
             return m_e->element(get_index().cbegin(), get_index().cend());
         }
 
@@ -724,7 +726,7 @@ namespace xt
         inline auto flat_expression_adaptor<CT, L>::operator[](size_type idx) const -> const_reference
         {
             auto i = static_cast<typename index_type::value_type>(idx);
-            get_index() = detail::unravel_noexcept(i, m_strides, L);
+            m_plan.unravel(i, get_index());
             return m_e->element(get_index().cbegin(), get_index().cend());
         }
 
@@ -873,7 +875,7 @@ namespace xt
                 new_strides.resize(dimension);
                 base_type::resize(dimension);
 
-                auto old_shape = shape;
+                const auto& old_shape = shape;
                 using old_strides_value_type = typename std::decay_t<ST>::value_type;
 
                 std::ptrdiff_t axis_skip = 0;
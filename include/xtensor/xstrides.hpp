@@ -11,6 +11,7 @@
 #define XTENSOR_STRIDES_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <numeric>
@@ -75,6 +76,85 @@ namespace xt
     template <class S, class T>
     std::vector<get_strides_t<S>> unravel_indices(const T& indices, const S& shape, layout_type l=layout_type::row_major);
 
+    namespace detail
+    {
+        /**
+         * Division of unsigned 64-bit integers by an invariant divisor,
+         * replaced with a multiplication by a precomputed magic number
+         * and shifts (Granlund and Montgomery, as in libdivide). Dividing
+         * by zero returns zero for dividends lower than 2^63.
+         */
+        class invariant_divisor
+        {
+        public:
+
+            using value_type = std::uint64_t;
+
+            invariant_divisor() = default;
+            explicit invariant_divisor(value_type d) noexcept;
+
+            value_type divisor() const noexcept;
+            value_type divide(value_type n) const noexcept;
+
+        private:
+
+            value_type m_divisor = 0;
+            value_type m_magic = 0;
+            unsigned int m_shift = 63;
+            bool m_add = false;
+        };
+    }
+
+    /**
+     * @class xunravel_plan
+     * @brief Precomputed unraveling of flat indices.
+     *
+     * xunravel_plan holds the strides of an unraveling together with the
+     * magic numbers of the divisions by these strides, so that unraveling
+     * a flat index costs a multiplication instead of a division per
+     * dimension. Building a plan costs a few divisions per dimension, it
+     * pays off as soon as more than a handful of indices are unraveled.
+     *
+     * @tparam S the type of the strides and of the unraveled indices
+     * @sa unravel_plan
+     */
+    template <class S>
+    class xunravel_plan
+    {
+    public:
+
+        using strides_type = S;
+        using index_type = S;
+        using value_type = typename strides_type::value_type;
+        using size_type = typename strides_type::size_type;
+
+        xunravel_plan() = default;
+        xunravel_plan(const strides_type& strides, layout_type l);
+
+        size_type dimension() const noexcept;
+        layout_type layout() const noexcept;
+        const strides_type& strides() const noexcept;
+
+        index_type operator()(value_type index) const;
+
+        template <class T>
+        void unravel(value_type index, T& result) const noexcept;
+
+        template <class T>
+        std::vector<index_type> unravel_indices(const T& indices) const;
+
+    private:
+
+        using divisors_type = rebind_container_t<detail::invariant_divisor, strides_type>;
+
+        strides_type m_strides;
+        divisors_type m_divisors;
+        layout_type m_layout = layout_type::row_major;
+    };
+
+    template <class S>
+    xunravel_plan<get_strides_t<S>> unravel_plan(const S& shape, layout_type l=layout_type::row_major);
+
     /***********************
      * broadcast functions *
      ***********************/
@@ -586,6 +666,191 @@ namespace xt
         }
     }
 
+    /************************************
+     * invariant_divisor implementation *
+     ************************************/
+
+    namespace detail
+    {
+        inline invariant_divisor::invariant_divisor(value_type d) noexcept
+            : m_divisor(d)
+        {
+            if (d == 0)
+            {
+                return;
+            }
+            unsigned int floor_log2 = 0;
+            while ((d >> floor_log2) > 1)
+            {
+                ++floor_log2;
+            }
+            m_shift = floor_log2;
+#if defined(__SIZEOF_INT128__)
+            if ((d & (d - 1)) != 0)
+            {
+                // magic = ceil(2^(64 + floor_log2) / d), the 65-bit magic
+                // numbers are handled with an extra addition
+                using wide_type = unsigned __int128;
+                wide_type num = wide_type(1) << (64 + floor_log2);
+                value_type proposed = static_cast<value_type>(num / d);
+                value_type rem = static_cast<value_type>(num % d);
+                if (d - rem >= (value_type(1) << floor_log2))
+                {
+                    proposed += proposed;
+                    value_type twice_rem = rem + rem;
+                    if (twice_rem >= d || twice_rem < rem)
+                    {
+                        proposed += 1;
+                    }
+                    m_add = true;
+                }
+                m_magic = proposed + 1;
+            }
+#endif
+        }
+
+        inline auto invariant_divisor::divisor() const noexcept -> value_type
+        {
+            return m_divisor;
+        }
+
+        inline auto invariant_divisor::divide(value_type n) const noexcept -> value_type
+        {
+#if defined(__SIZEOF_INT128__)
+            if (m_magic == 0)
+            {
+                return n >> m_shift;
+            }
+            using wide_type = unsigned __int128;
+            value_type q = static_cast<value_type>((wide_type(m_magic) * n) >> 64);
+            return m_add ? (((n - q) >> 1) + q) >> m_shift : q >> m_shift;
+#else
+            return m_divisor != 0 ? n / m_divisor : 0;
+#endif
+        }
+    }
+
+    /********************************
+     * xunravel_plan implementation *
+     ********************************/
+
+    /**
+     * Builds a plan unraveling flat indices according to the specified
+     * strides. A null stride yields a null coordinate.
+     * @param strides the strides of the unraveling
+     * @param l the layout the strides follow, row_major or column_major
+     */
+    template <class S>
+    inline xunravel_plan<S>::xunravel_plan(const strides_type& strides, layout_type l)
+        : m_strides(strides),
+          m_divisors(xtl::make_sequence<divisors_type>(strides.size(), detail::invariant_divisor())),
+          m_layout(l)
+    {
+        for (size_type i = 0; i < m_strides.size(); ++i)
+        {
+            m_divisors[i] = detail::invariant_divisor(static_cast<std::uint64_t>(m_strides[i]));
+        }
+    }
+
+    /**
+     * Returns the number of dimensions of the unraveled indices.
+     */
+    template <class S>
+    inline auto xunravel_plan<S>::dimension() const noexcept -> size_type
+    {
+        return m_strides.size();
+    }
+
+    /**
+     * Returns the layout of the unraveling.
+     */
+    template <class S>
+    inline layout_type xunravel_plan<S>::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    /**
+     * Returns the strides of the unraveling.
+     */
+    template <class S>
+    inline auto xunravel_plan<S>::strides() const noexcept -> const strides_type&
+    {
+        return m_strides;
+    }
+
+    /**
+     * Unravels a flat index.
+     * @param index the non negative flat index
+     * @return the multidimensional index
+     */
+    template <class S>
+    inline auto xunravel_plan<S>::operator()(value_type index) const -> index_type
+    {
+        index_type result = xtl::make_sequence<index_type>(dimension(), 0);
+        unravel(index, result);
+        return result;
+    }
+
+    /**
+     * Unravels a flat index into an existing multidimensional index.
+     * @param index the non negative flat index
+     * @param result the multidimensional index, of size dimension()
+     */
+    template <class S>
+    template <class T>
+    inline void xunravel_plan<S>::unravel(value_type index, T& result) const noexcept
+    {
+        using result_value_type = typename T::value_type;
+        std::uint64_t n = static_cast<std::uint64_t>(index);
+        size_type dim = dimension();
+        for (size_type k = 0; k < dim; ++k)
+        {
+            size_type i = m_layout == layout_type::row_major ? k : dim - 1 - k;
+            const detail::invariant_divisor& div = m_divisors[i];
+            std::uint64_t quot = div.divide(n);
+            n -= quot * div.divisor();
+            result[i] = static_cast<result_value_type>(quot);
+        }
+    }
+
+    /**
+     * Unravels a sequence of flat indices.
+     * @param indices the non negative flat indices
+     * @return a vector of the multidimensional indices
+     */
+    template <class S>
+    template <class T>
+    inline auto xunravel_plan<S>::unravel_indices(const T& indices) const -> std::vector<index_type>
+    {
+        std::vector<index_type> out(indices.size(), xtl::make_sequence<index_type>(dimension(), 0));
+        auto out_iter = out.begin();
+        for (auto idx_iter = indices.begin(); out_iter != out.end(); ++out_iter, ++idx_iter)
+        {
+            unravel(static_cast<value_type>(*idx_iter), *out_iter);
+        }
+        return out;
+    }
+
+    /**
+     * Builds an \ref xunravel_plan unraveling the flat indices of an
+     * expression of the specified shape.
+     * @param shape the shape of the expression
+     * @param l the layout of the flat indices, row_major or column_major
+     */
+    template <class S>
+    inline xunravel_plan<get_strides_t<S>> unravel_plan(const S& shape, layout_type l)
+    {
+        if (l != layout_type::row_major && l != layout_type::column_major)
+        {
+            XTENSOR_THROW(std::runtime_error, "unravel_plan: dynamic layout not supported");
+        }
+        using strides_type = get_strides_t<S>;
+        strides_type strides = xtl::make_sequence<strides_type>(shape.size(), 0);
+        compute_strides(shape, l, strides);
+        return xunravel_plan<strides_type>(strides, l);
+    }
+
     template <class S>
     inline S unravel_from_strides(typename S::value_type index, const S& strides, layout_type l)
     {
@@ -615,18 +880,7 @@ namespace xt
     template <class S, class T>
     inline std::vector<get_strides_t<S>> unravel_indices(const T& idx, const S& shape, layout_type l)
     {
-        using strides_type = get_strides_t<S>;
-        using strides_value_type = typename strides_type::value_type;
-        strides_type strides = xtl::make_sequence<strides_type>(shape.size(), 0);
-        compute_strides(shape, l, strides);
-        std::vector<get_strides_t<S>> out(idx.size());
-        auto out_iter = out.begin();
-        auto idx_iter = idx.begin();
-        for ( ; out_iter != out.end(); ++out_iter, ++idx_iter )
-        {
-            *out_iter = unravel_from_strides(static_cast<strides_value_type>(*idx_iter), strides, l);
-        }
-        return out;
+        return unravel_plan(shape, l).unravel_indices(idx);
     }
 
     template <class S, class T>
@@ -0,0 +1,237 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_TASK_TRACING_HPP
+#define XTENSOR_TASK_TRACING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "xtensor_config.hpp"
+
+/**
+ * Tracing of the parallel loops. When xtensor is compiled with
+ * XTENSOR_TASK_TRACING defined and tracing is enabled, the execution
+ * policies record an event for each parallel loop, on the calling thread,
+ * and for each task running a part of it, with its thread and the number of
+ * elements processed. Without the macro, the loops are not instrumented.
+ */
+#if defined(XTENSOR_TASK_TRACING)
+#define XTENSOR_TRACE_TASK(name, first, last) \
+    ::xt::task_tracing::scope xtensor_task_scope(name, first, last)
+#else
+#define XTENSOR_TRACE_TASK(name, first, last)
+#endif
+
+namespace xt
+{
+    namespace task_tracing
+    {
+        struct event
+        {
+            /// Kind of loop or task, e.g. "tbb_task".
+            const char* name = nullptr;
+            /// Start time, from the first use of the tracing.
+            std::chrono::nanoseconds start = std::chrono::nanoseconds(0);
+            std::chrono::nanoseconds duration = std::chrono::nanoseconds(0);
+            /// Index of the thread, in the order in which threads first traced an event.
+            std::size_t thread = 0;
+            /// Number of indices of the loop processed.
+            std::size_t elements = 0;
+        };
+
+        bool enabled() noexcept;
+        void enable() noexcept;
+        void disable() noexcept;
+
+        std::vector<event> events();
+        void clear();
+
+        void write_chrome_trace(std::ostream& out);
+
+        class scope
+        {
+        public:
+
+            scope(const char* name, std::size_t first, std::size_t last);
+            ~scope();
+
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+
+        private:
+
+            const char* m_name;
+            std::size_t m_elements;
+            std::chrono::steady_clock::time_point m_start;
+            bool m_active;
+        };
+
+        /*******************************
+         * task_tracing implementation *
+         *******************************/
+
+        namespace detail
+        {
+            // Events of one thread. Each buffer has its own mutex, which is
+            // only contended while events() or clear() run.
+            struct thread_buffer
+            {
+                std::mutex m_mutex;
+                std::vector<event> m_events;
+                std::size_t m_thread = 0;
+            };
+
+            struct registry
+            {
+                std::mutex m_mutex;
+                std::vector<std::shared_ptr<thread_buffer>> m_buffers;
+                std::atomic<bool> m_enabled{false};
+                std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+            };
+
+            inline registry& get_registry()
+            {
+                static registry r;
+                return r;
+            }
+
+            inline thread_buffer& get_thread_buffer()
+            {
+                // The registry keeps the buffers of the threads that exited
+                static thread_local std::shared_ptr<thread_buffer> buffer = []()
+                {
+                    registry& r = get_registry();
+                    auto b = std::make_shared<thread_buffer>();
+                    std::lock_guard<std::mutex> lock(r.m_mutex);
+                    b->m_thread = r.m_buffers.size();
+                    r.m_buffers.push_back(b);
+                    return b;
+                }();
+                return *buffer;
+            }
+        }
+
+        /**
+         * Returns whether the parallel loops record events.
+         */
+        inline bool enabled() noexcept
+        {
+            return detail::get_registry().m_enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Starts recording the events of the parallel loops.
+         */
+        inline void enable() noexcept
+        {
+            detail::get_registry().m_enabled.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * Stops recording events. The recorded events are kept until clear()
+         * is called.
+         */
+        inline void disable() noexcept
+        {
+            detail::get_registry().m_enabled.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the recorded events of all the threads, sorted by start time.
+         */
+        inline std::vector<event> events()
+        {
+            detail::registry& r = detail::get_registry();
+            std::vector<event> res;
+            std::lock_guard<std::mutex> lock(r.m_mutex);
+            for (const auto& b : r.m_buffers)
+            {
+                std::lock_guard<std::mutex> block(b->m_mutex);
+                res.insert(res.end(), b->m_events.cbegin(), b->m_events.cend());
+            }
+            std::stable_sort(res.begin(), res.end(), [](const event& lhs, const event& rhs)
+            {
+                return lhs.start < rhs.start;
+            });
+            return res;
+        }
+
+        /**
+         * Discards the recorded events.
+         */
+        inline void clear()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.m_mutex);
+            for (const auto& b : r.m_buffers)
+            {
+                std::lock_guard<std::mutex> block(b->m_mutex);
+                b->m_events.clear();
+            }
+        }
+
+        /**
+         * Writes the recorded events in the Chrome trace event format, which
+         * can be opened in chrome://tracing and in the Perfetto UI. Each
+         * event is a complete event on the track of its thread, with the
+         * number of elements it processed as argument.
+         */
+        inline void write_chrome_trace(std::ostream& out)
+        {
+            std::vector<event> evts = events();
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            for (std::size_t i = 0; i < evts.size(); ++i)
+            {
+                const event& e = evts[i];
+                out << (i == 0 ? "" : ",") << "\n{\"name\":\"" << e.name
+                    << "\",\"cat\":\"xtensor\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                    << ",\"ts\":" << static_cast<double>(e.start.count()) / 1000.
+                    << ",\"dur\":" << static_cast<double>(e.duration.count()) / 1000.
+                    << ",\"args\":{\"elements\":" << e.elements << "}}";
+            }
+            out << "\n]}\n";
+        }
+
+        inline scope::scope(const char* name, std::size_t first, std::size_t last)
+            : m_name(name), m_elements(last > first ? last - first : 0), m_active(enabled())
+        {
+            if (m_active)
+            {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        inline scope::~scope()
+        {
+            if (m_active)
+            {
+                auto stop = std::chrono::steady_clock::now();
+                detail::thread_buffer& b = detail::get_thread_buffer();
+                event e;
+                e.name = m_name;
+                e.start = std::chrono::duration_cast<std::chrono::nanoseconds>(m_start - detail::get_registry().m_epoch);
+                e.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - m_start);
+                e.thread = b.m_thread;
+                e.elements = m_elements;
+                std::lock_guard<std::mutex> lock(b.m_mutex);
+                b.m_events.push_back(e);
+            }
+        }
+    }
+}
+
+#endif
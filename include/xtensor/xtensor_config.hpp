@@ -52,9 +52,15 @@
 #define XTENSOR_DEFAULT_DATA_CONTAINER(T, A) uvector<T, A>
 #endif
 
+// Number of dimensions the dynamic shapes and strides hold without
+// allocating on the heap
+#ifndef XTENSOR_SHAPE_INLINE_CAPACITY
+#define XTENSOR_SHAPE_INLINE_CAPACITY 4
+#endif
+
 #ifndef XTENSOR_DEFAULT_SHAPE_CONTAINER
 #define XTENSOR_DEFAULT_SHAPE_CONTAINER(T, EA, SA) \
-    xt::svector<typename XTENSOR_DEFAULT_DATA_CONTAINER(T, EA)::size_type, 4, SA, true>
+    xt::svector<typename XTENSOR_DEFAULT_DATA_CONTAINER(T, EA)::size_type, XTENSOR_SHAPE_INLINE_CAPACITY, SA, true>
 #endif
 
 #ifdef XTENSOR_USE_XSIMD
@@ -76,6 +82,14 @@
         #define XTENSOR_DEFAULT_ALLOCATOR(T) \
             xt::tracking_allocator<T, std::allocator<T>, XTENSOR_ALLOC_TRACKING_POLICY>
     #endif
+#elif defined(XTENSOR_FIRST_TOUCH)
+    #ifdef XTENSOR_USE_XSIMD
+        #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+            xt::first_touch_allocator<T, xsimd::aligned_allocator<T, XSIMD_DEFAULT_ALIGNMENT>>
+    #else
+        #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+            xt::first_touch_allocator<T, std::allocator<T>>
+    #endif
 #else
     #ifdef XTENSOR_USE_XSIMD
         
@@ -112,6 +126,69 @@
 #define XTENSOR_TBB_THRESHOLD 0
 #endif
 
+#ifndef XTENSOR_ASSIGN_TILE_SIZE
+#define XTENSOR_ASSIGN_TILE_SIZE 32
+#endif
+
+// Largest number of elements of a fixed size destination assigned with
+// fully unrolled loops
+#ifndef XTENSOR_FIXED_ASSIGN_MAX_SIZE
+#define XTENSOR_FIXED_ASSIGN_MAX_SIZE 256
+#endif
+
+// Number of elements of each output computed in turn by assign_all
+#ifndef XTENSOR_ASSIGN_ALL_BLOCK_SIZE
+#define XTENSOR_ASSIGN_ALL_BLOCK_SIZE 1024
+#endif
+
+// Number of elements of a memoized expression evaluated at once
+#ifndef XTENSOR_MEMOIZE_BLOCK_SIZE
+#define XTENSOR_MEMOIZE_BLOCK_SIZE 64
+#endif
+
+// Estimated cost per element from which eval_if_costly evaluates an
+// expression, and cost of the transcendental functors
+#ifndef XTENSOR_EVAL_COST_THRESHOLD
+#define XTENSOR_EVAL_COST_THRESHOLD 16
+#endif
+
+#ifndef XTENSOR_EXPENSIVE_FUNCTOR_COST
+#define XTENSOR_EXPENSIVE_FUNCTOR_COST 16
+#endif
+
+// Number of elements of the blocks evaluated by an xpipeline
+#ifndef XTENSOR_PIPELINE_BLOCK_SIZE
+#define XTENSOR_PIPELINE_BLOCK_SIZE 512
+#endif
+
+#ifndef XTENSOR_STREAMING_THRESHOLD
+#define XTENSOR_STREAMING_THRESHOLD (std::size_t(32) << 20)
+#endif
+
+// Length of the shorter operand from which convolve uses the FFT
+#ifndef XTENSOR_CONVOLVE_FFT_THRESHOLD
+#define XTENSOR_CONVOLVE_FFT_THRESHOLD 128
+#endif
+
+// Blocking of the matmul and tensordot kernel (depth, rows and columns)
+#ifndef XTENSOR_GEMM_KC
+#define XTENSOR_GEMM_KC 256
+#endif
+
+#ifndef XTENSOR_GEMM_MC
+#define XTENSOR_GEMM_MC 96
+#endif
+
+#ifndef XTENSOR_GEMM_NC
+#define XTENSOR_GEMM_NC 4096
+#endif
+
+// Number of multiply-adds of the pairwise contractions of einsum from which
+// they are computed by the matmul kernel
+#ifndef XTENSOR_EINSUM_GEMM_THRESHOLD
+#define XTENSOR_EINSUM_GEMM_THRESHOLD 4096
+#endif
+
 #ifndef XTENSOR_SELECT_ALIGN
 #define XTENSOR_SELECT_ALIGN(T) (XTENSOR_DEFAULT_ALIGNMENT != 0 ? XTENSOR_DEFAULT_ALIGNMENT : alignof(T))
 #endif
@@ -47,6 +47,15 @@ namespace xt
     template <class T, std::size_t N, class A, bool Init>
     class svector;
 
+    template <class T, class A>
+    class xshared_buffer;
+
+    template <class A>
+    class xbit_vector;
+
+    template <class T, class A>
+    class first_touch_allocator;
+
     template <class EC,
               layout_type L = XTENSOR_DEFAULT_LAYOUT,
               class SC = XTENSOR_DEFAULT_SHAPE_CONTAINER(typename EC::value_type,
@@ -81,6 +90,62 @@ namespace xt
               class SA = std::allocator<typename std::vector<T, A>::size_type>>
     using xarray = xarray_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA)>;
 
+    /**
+     * @typedef xarray_inline
+     * Alias template on xarray_container whose shape and strides hold up to
+     * \c N dimensions without allocating on the heap. This allows to write
+     *
+     * \code{.cpp}
+     * xt::xarray_inline<double, 6> a = xt::zeros<double>({2, 2, 2, 2, 2, 2});
+     * \endcode
+     *
+     * for arrays of a higher dimension than XTENSOR_SHAPE_INLINE_CAPACITY.
+     * The views on such an array use the same shape type.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam N The number of dimensions stored inline.
+     * @tparam L The layout_type of the xarray_container (default: XTENSOR_DEFAULT_LAYOUT).
+     * @tparam A The allocator of the container holding the elements.
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     */
+    template <class T,
+              std::size_t N,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T),
+              class SA = std::allocator<typename std::vector<T, A>::size_type>>
+    using xarray_inline = xarray_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), L,
+                                           svector<typename XTENSOR_DEFAULT_DATA_CONTAINER(T, A)::size_type, N, SA, true>>;
+
+    /**
+     * @typedef xshared_array
+     * Alias template on xarray_container whose elements are held in an
+     * xshared_buffer: copies share the elements until one of them is
+     * modified.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam L The layout_type of the xarray_container (default: XTENSOR_DEFAULT_LAYOUT).
+     * @tparam A The allocator of the container holding the elements.
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     */
+    template <class T,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T),
+              class SA = std::allocator<typename std::vector<T, A>::size_type>>
+    using xshared_array = xarray_container<xshared_buffer<T, A>, L, XTENSOR_DEFAULT_SHAPE_CONTAINER(T, A, SA)>;
+
+    /**
+     * @typedef xbit_array
+     * Alias template on xarray_container holding bools packed in an
+     * xbit_vector, one bit per element.
+     *
+     * @tparam L The layout_type of the xarray_container (default: XTENSOR_DEFAULT_LAYOUT).
+     * @tparam SA The allocator of the containers holding the shape and the strides.
+     */
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class SA = std::allocator<std::size_t>>
+    using xbit_array = xarray_container<xbit_vector<std::allocator<std::uint64_t>>, L,
+                                        XTENSOR_DEFAULT_SHAPE_CONTAINER(bool, std::allocator<bool>, SA)>;
+
     template <class EC,
               layout_type L = XTENSOR_DEFAULT_LAYOUT,
               class SC = XTENSOR_DEFAULT_SHAPE_CONTAINER(typename EC::value_type,
@@ -205,6 +270,12 @@ namespace xt
 
     template <class F, class... CT>
     class xfunction;
+
+    template <class F, class R, class S>
+    class xgenerator;
+
+    template <class CT, class X>
+    class xbroadcast;
 }
 
 #endif
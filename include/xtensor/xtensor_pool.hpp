@@ -0,0 +1,432 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_TENSOR_POOL_HPP
+#define XTENSOR_TENSOR_POOL_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "xstorage.hpp"
+#include "xstrides.hpp"
+#include "xtensor.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    namespace detail
+    {
+        class tensor_pool_state;
+    }
+
+    /******************
+     * pool_allocator *
+     ******************/
+
+    /**
+     * @class pool_allocator
+     * @brief Allocator taking its buffers from a tensor_pool and giving them
+     * back to it on deallocation.
+     *
+     * The allocator shares the state of the pool, so that the containers
+     * using it can outlive the pool; once the pool is destroyed, their
+     * buffers are freed as usual. A default constructed allocator is not
+     * attached to any pool and allocates from the heap. The allocator is
+     * propagated on copy, move and swap, so that the copies of a pooled
+     * container are pooled too.
+     */
+    template <class T>
+    class pool_allocator
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        using state_type = std::shared_ptr<detail::tensor_pool_state>;
+
+        pool_allocator() noexcept = default;
+        explicit pool_allocator(state_type state) noexcept;
+
+        template <class U>
+        pool_allocator(const pool_allocator<U>& rhs) noexcept;
+
+        T* allocate(std::size_t n);
+        void deallocate(T* p, std::size_t n) noexcept;
+
+        const state_type& state() const noexcept;
+
+    private:
+
+        state_type m_state;
+    };
+
+    template <class T, class U>
+    bool operator==(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept;
+
+    /***************
+     * tensor_pool *
+     ***************/
+
+    /**
+     * @class tensor_pool
+     * @brief Pool of the buffers of tensors having the same value type and
+     * dimension.
+     *
+     * The tensors handed out by acquire hold a pool_allocator: when they
+     * are destroyed or resized, their buffer goes back to the pool instead
+     * of being freed, and the next tensor acquired with a shape of the same
+     * size reuses it. A loop acquiring tensors of identical shapes at each
+     * iteration therefore stops allocating after the first one, while the
+     * tensors keep their usual value semantics. Results are written into
+     * an acquired tensor with noalias, since a plain assignment goes through
+     * a temporary that does not come from the pool. The pool can be used
+     * from several threads.
+     *
+     * @tparam T The value type of the elements.
+     * @tparam N The dimension of the tensors.
+     * @tparam L The layout_type of the tensors (default: XTENSOR_DEFAULT_LAYOUT).
+     */
+    template <class T, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    class tensor_pool
+    {
+    public:
+
+        static_assert(L != layout_type::dynamic, "tensor_pool requires a static layout");
+
+        using value_type = T;
+        using allocator_type = pool_allocator<T>;
+        using storage_type = uvector<T, allocator_type>;
+        using tensor_type = xtensor_container<storage_type, N, L>;
+        using shape_type = typename tensor_type::shape_type;
+
+        explicit tensor_pool(std::size_t max_cached = (std::numeric_limits<std::size_t>::max)());
+        ~tensor_pool();
+
+        tensor_pool(const tensor_pool&) = delete;
+        tensor_pool& operator=(const tensor_pool&) = delete;
+
+        tensor_pool(tensor_pool&&) = default;
+        tensor_pool& operator=(tensor_pool&&) = default;
+
+        tensor_type acquire(const shape_type& shape);
+        tensor_type acquire(const shape_type& shape, const value_type& value);
+
+        void reserve(const shape_type& shape, std::size_t count);
+        void release();
+
+        std::size_t cached() const;
+        allocator_type get_allocator() const noexcept;
+
+    private:
+
+        tensor_type make_tensor(storage_type&& storage, const shape_type& shape) const;
+
+        std::shared_ptr<detail::tensor_pool_state> p_state;
+    };
+
+    /*********************************
+     * tensor_pool_state declaration *
+     *********************************/
+
+    namespace detail
+    {
+        class tensor_pool_state
+        {
+        public:
+
+            explicit tensor_pool_state(std::size_t max_cached);
+            ~tensor_pool_state();
+
+            tensor_pool_state(const tensor_pool_state&) = delete;
+            tensor_pool_state& operator=(const tensor_pool_state&) = delete;
+
+            void* allocate(std::size_t bytes);
+            void deallocate(void* p, std::size_t bytes) noexcept;
+
+            void release() noexcept;
+            void close() noexcept;
+            std::size_t cached() const;
+
+        private:
+
+            mutable std::mutex m_mutex;
+            std::unordered_map<std::size_t, std::vector<void*>> m_free;
+            std::size_t m_max_cached;
+            bool m_closed;
+        };
+    }
+
+    /************************************
+     * tensor_pool_state implementation *
+     ************************************/
+
+    namespace detail
+    {
+        inline tensor_pool_state::tensor_pool_state(std::size_t max_cached)
+            : m_max_cached(max_cached), m_closed(false)
+        {
+        }
+
+        inline tensor_pool_state::~tensor_pool_state()
+        {
+            release();
+        }
+
+        inline void* tensor_pool_state::allocate(std::size_t bytes)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_free.find(bytes);
+                if (it != m_free.end() && !it->second.empty())
+                {
+                    void* p = it->second.back();
+                    it->second.pop_back();
+                    return p;
+                }
+            }
+            return ::operator new(bytes);
+        }
+
+        inline void tensor_pool_state::deallocate(void* p, std::size_t bytes) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_closed)
+                {
+                    try
+                    {
+                        std::vector<void*>& free_list = m_free[bytes];
+                        if (free_list.size() < m_max_cached)
+                        {
+                            free_list.push_back(p);
+                            return;
+                        }
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+            }
+            ::operator delete(p);
+        }
+
+        inline void tensor_pool_state::release() noexcept
+        {
+            std::unordered_map<std::size_t, std::vector<void*>> free;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                free.swap(m_free);
+            }
+            for (auto& entry : free)
+            {
+                for (void* p : entry.second)
+                {
+                    ::operator delete(p);
+                }
+            }
+        }
+
+        inline void tensor_pool_state::close() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            release();
+        }
+
+        inline std::size_t tensor_pool_state::cached() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::size_t res = 0;
+            for (const auto& entry : m_free)
+            {
+                res += entry.second.size();
+            }
+            return res;
+        }
+    }
+
+    /*********************************
+     * pool_allocator implementation *
+     *********************************/
+
+    template <class T>
+    inline pool_allocator<T>::pool_allocator(state_type state) noexcept
+        : m_state(std::move(state))
+    {
+    }
+
+    template <class T>
+    template <class U>
+    inline pool_allocator<T>::pool_allocator(const pool_allocator<U>& rhs) noexcept
+        : m_state(rhs.state())
+    {
+    }
+
+    template <class T>
+    inline T* pool_allocator<T>::allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "pool_allocator does not support over-aligned types");
+        if (n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        std::size_t bytes = n * sizeof(T);
+        return static_cast<T*>(m_state ? m_state->allocate(bytes) : ::operator new(bytes));
+    }
+
+    template <class T>
+    inline void pool_allocator<T>::deallocate(T* p, std::size_t n) noexcept
+    {
+        if (m_state)
+        {
+            m_state->deallocate(p, n * sizeof(T));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    template <class T>
+    inline auto pool_allocator<T>::state() const noexcept -> const state_type&
+    {
+        return m_state;
+    }
+
+    template <class T, class U>
+    inline bool operator==(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept
+    {
+        return lhs.state() == rhs.state();
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /******************************
+     * tensor_pool implementation *
+     ******************************/
+
+    /**
+     * Builds an empty pool.
+     * @param max_cached the maximum number of buffers of a given size kept
+     * by the pool; the buffers given back beyond it are freed.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline tensor_pool<T, N, L>::tensor_pool(std::size_t max_cached)
+        : p_state(std::make_shared<detail::tensor_pool_state>(max_cached))
+    {
+    }
+
+    /**
+     * Frees the buffers held by the pool. The tensors still alive free
+     * their buffer when they are destroyed.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline tensor_pool<T, N, L>::~tensor_pool()
+    {
+        if (p_state)
+        {
+            p_state->close();
+        }
+    }
+
+    /**
+     * Returns a tensor of the given shape whose buffer comes from the pool.
+     * The elements are default initialized, so that a reused buffer of
+     * trivial values keeps its previous content.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline auto tensor_pool<T, N, L>::acquire(const shape_type& shape) -> tensor_type
+    {
+        return make_tensor(storage_type(compute_size(shape), get_allocator()), shape);
+    }
+
+    /**
+     * Returns a tensor of the given shape whose buffer comes from the pool,
+     * with all its elements set to \c value.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline auto tensor_pool<T, N, L>::acquire(const shape_type& shape, const value_type& value) -> tensor_type
+    {
+        return make_tensor(storage_type(compute_size(shape), value, get_allocator()), shape);
+    }
+
+    /**
+     * Allocates \c count buffers for tensors of the given shape, so that
+     * the first acquisitions do not allocate either.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline void tensor_pool<T, N, L>::reserve(const shape_type& shape, std::size_t count)
+    {
+        std::vector<storage_type> buffers;
+        buffers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            buffers.emplace_back(compute_size(shape), get_allocator());
+        }
+    }
+
+    /**
+     * Frees the buffers held by the pool.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline void tensor_pool<T, N, L>::release()
+    {
+        p_state->release();
+    }
+
+    /**
+     * Returns the number of buffers held by the pool, waiting to be reused.
+     */
+    template <class T, std::size_t N, layout_type L>
+    inline std::size_t tensor_pool<T, N, L>::cached() const
+    {
+        return p_state->cached();
+    }
+
+    template <class T, std::size_t N, layout_type L>
+    inline auto tensor_pool<T, N, L>::get_allocator() const noexcept -> allocator_type
+    {
+        return allocator_type(p_state);
+    }
+
+    template <class T, std::size_t N, layout_type L>
+    inline auto tensor_pool<T, N, L>::make_tensor(storage_type&& storage, const shape_type& shape) const -> tensor_type
+    {
+        using inner_shape_type = typename tensor_type::inner_shape_type;
+        using inner_strides_type = typename tensor_type::inner_strides_type;
+        inner_shape_type sh = shape;
+        inner_strides_type strides;
+        compute_strides(sh, L, strides);
+        return tensor_type(std::move(storage), std::move(sh), std::move(strides));
+    }
+}
+
+#endif
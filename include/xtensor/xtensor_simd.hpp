@@ -20,6 +20,16 @@
 #include <xsimd/xsimd.hpp>
 //#include <xsimd/memory/xsimd_load_store.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XTENSOR_STREAMING_STORE_X86
+#include <immintrin.h>
+#endif
+
 #if defined(_MSV_VER) && (_MSV_VER < 1910)
 template <class T, class A>
 inline xsimd::batch_bool<T, A> isnan(const xsimd::batch<T, A>& b)
@@ -80,6 +90,234 @@ namespace xt_simd
 
     template <class T1, class T2>
     using simd_condition = xsimd::detail::simd_condition<T1, T2>;
+
+    namespace detail
+    {
+        // Non-temporal stores are dispatched on the width of the batch; widths
+        // without a streaming instruction fall back to a regular aligned store.
+        template <std::size_t N>
+        struct stream_store
+        {
+            template <class T, class B>
+            static void run(T* dst, const B& src)
+            {
+                src.store_aligned(dst);
+            }
+
+            static void fence() noexcept
+            {
+            }
+        };
+
+#if defined(XTENSOR_STREAMING_STORE_X86)
+        template <>
+        struct stream_store<16>
+        {
+            template <class T, class B>
+            static void run(T* dst, const B& src)
+            {
+                __m128i reg;
+                std::memcpy(&reg, &src, sizeof(reg));
+                _mm_stream_si128(reinterpret_cast<__m128i*>(dst), reg);
+            }
+
+            static void fence() noexcept
+            {
+                _mm_sfence();
+            }
+        };
+#endif
+
+#if defined(XTENSOR_STREAMING_STORE_X86) && defined(__AVX__)
+        template <>
+        struct stream_store<32>
+        {
+            template <class T, class B>
+            static void run(T* dst, const B& src)
+            {
+                __m256i reg;
+                std::memcpy(&reg, &src, sizeof(reg));
+                _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), reg);
+            }
+
+            static void fence() noexcept
+            {
+                _mm_sfence();
+            }
+        };
+#endif
+
+#if defined(XTENSOR_STREAMING_STORE_X86) && defined(__AVX512F__)
+        template <>
+        struct stream_store<64>
+        {
+            template <class T, class B>
+            static void run(T* dst, const B& src)
+            {
+                __m512i reg;
+                std::memcpy(&reg, &src, sizeof(reg));
+                _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), reg);
+            }
+
+            static void fence() noexcept
+            {
+                _mm_sfence();
+            }
+        };
+#endif
+    }
+
+    /**
+     * Stores \c src at \c dst, which must be aligned on the size of the batch,
+     * bypassing the cache hierarchy when the architecture allows it.
+     * stream_fence must be called before the stored values are read by
+     * another thread.
+     */
+    template <class T>
+    inline void stream_as(T* dst, const simd_type<T>& src)
+    {
+        detail::stream_store<sizeof(simd_type<T>)>::run(dst, src);
+    }
+
+    /**
+     * Orders the non-temporal stores of stream_as issued by the calling
+     * thread before its subsequent stores.
+     */
+    template <class T>
+    inline void stream_fence() noexcept
+    {
+        detail::stream_store<sizeof(simd_type<T>)>::fence();
+    }
+
+    namespace detail
+    {
+        // Strided loads are dispatched on the value type and the width of
+        // the batch; widths without a gather instruction, and the loads
+        // converting the elements, fill the batch element-wise.
+        template <class T, std::size_t N>
+        struct strided_gather
+        {
+            template <class R>
+            static R run(const T* src, std::ptrdiff_t stride)
+            {
+                constexpr std::size_t size = revert_simd_traits<R>::size;
+                T buffer[size];
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    buffer[i] = src[static_cast<std::ptrdiff_t>(i) * stride];
+                }
+                R reg;
+                return reg.load_unaligned(&buffer[0]);
+            }
+        };
+
+        // The gather instructions take 32-bit element offsets; their masked
+        // form is used since the unmasked intrinsics trip
+        // -Wmaybe-uninitialized with some versions of GCC
+        template <std::size_t L>
+        inline bool gather_offsets_fit(std::ptrdiff_t stride) noexcept
+        {
+            constexpr std::ptrdiff_t max_stride = (std::numeric_limits<std::int32_t>::max)() / std::ptrdiff_t(L);
+            return stride <= max_stride && stride >= -max_stride;
+        }
+
+#if defined(XTENSOR_STREAMING_STORE_X86) && defined(__AVX2__)
+        template <>
+        struct strided_gather<float, 32>
+        {
+            template <class R>
+            static R run(const float* src, std::ptrdiff_t stride)
+            {
+                if (!gather_offsets_fit<8>(stride))
+                {
+                    return strided_gather<float, 0>::run<R>(src, stride);
+                }
+                __m256i offsets = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(stride)),
+                                                     _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                __m256 reg = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), src, offsets,
+                                                     _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+                R res;
+                std::memcpy(&res, &reg, sizeof(reg));
+                return res;
+            }
+        };
+
+        template <>
+        struct strided_gather<double, 32>
+        {
+            template <class R>
+            static R run(const double* src, std::ptrdiff_t stride)
+            {
+                if (!gather_offsets_fit<4>(stride))
+                {
+                    return strided_gather<double, 0>::run<R>(src, stride);
+                }
+                __m128i offsets = _mm_mullo_epi32(_mm_set1_epi32(static_cast<int>(stride)),
+                                                  _mm_setr_epi32(0, 1, 2, 3));
+                __m256d reg = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), src, offsets,
+                                                      _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+                R res;
+                std::memcpy(&res, &reg, sizeof(reg));
+                return res;
+            }
+        };
+#endif
+
+#if defined(XTENSOR_STREAMING_STORE_X86) && defined(__AVX512F__)
+        template <>
+        struct strided_gather<float, 64>
+        {
+            template <class R>
+            static R run(const float* src, std::ptrdiff_t stride)
+            {
+                if (!gather_offsets_fit<16>(stride))
+                {
+                    return strided_gather<float, 0>::run<R>(src, stride);
+                }
+                __m512i offsets = _mm512_mullo_epi32(_mm512_set1_epi32(static_cast<int>(stride)),
+                                                     _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                                                       8, 9, 10, 11, 12, 13, 14, 15));
+                __m512 reg = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), __mmask16(0xffff), offsets, src, 4);
+                R res;
+                std::memcpy(&res, &reg, sizeof(reg));
+                return res;
+            }
+        };
+
+        template <>
+        struct strided_gather<double, 64>
+        {
+            template <class R>
+            static R run(const double* src, std::ptrdiff_t stride)
+            {
+                if (!gather_offsets_fit<8>(stride))
+                {
+                    return strided_gather<double, 0>::run<R>(src, stride);
+                }
+                __m256i offsets = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(stride)),
+                                                     _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                __m512d reg = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), __mmask8(0xff), offsets, src, 8);
+                R res;
+                std::memcpy(&res, &reg, sizeof(reg));
+                return res;
+            }
+        };
+#endif
+    }
+
+    /**
+     * Loads a batch of type \c R from the elements of \c src spaced by
+     * \c stride elements, with a gather instruction when the architecture
+     * provides one for the batch.
+     */
+    template <class R, class T>
+    inline R gather_as(const T* src, std::ptrdiff_t stride)
+    {
+        using gather_type = std::conditional_t<std::is_same<R, simd_type<T>>::value,
+                                               detail::strided_gather<T, sizeof(R)>,
+                                               detail::strided_gather<T, 0>>;
+        return gather_type::template run<R>(src, stride);
+    }
 }
 
 #else  // XTENSOR_USE_XSIMD
@@ -199,6 +437,23 @@ namespace xt_simd
     struct simd_condition : std::true_type
     {
     };
+
+    template <class T>
+    inline void stream_as(T* dst, const simd_type<T>& src)
+    {
+        *dst = src;
+    }
+
+    template <class T>
+    inline void stream_fence() noexcept
+    {
+    }
+
+    template <class R, class T>
+    inline R gather_as(const T* src, std::ptrdiff_t /*stride*/)
+    {
+        return *src;
+    }
 }
 
 #endif  // XTENSOR_USE_XSIMD
@@ -212,6 +467,15 @@ namespace xt
     {
     };
 
+    /**
+     * Requests aligned accesses from every container, including those whose
+     * allocator does not guarantee alignment. Used by the assigners once
+     * they have checked at runtime that the accessed addresses are aligned.
+     */
+    struct runtime_aligned_mode
+    {
+    };
+
     namespace detail
     {
         template <class A1, class A2>
@@ -225,6 +489,12 @@ namespace xt
         {
             using type = A;
         };
+
+        template <class A>
+        struct driven_align_mode_impl<runtime_aligned_mode, A>
+        {
+            using type = ::xt_simd::aligned_mode;
+        };
     }
 
     template <class A1, class A2>
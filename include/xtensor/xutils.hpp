@@ -16,10 +16,16 @@
 #include <complex>
 #include <cstddef>
 #include <initializer_list>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -63,12 +69,30 @@ namespace xt
     template <class T, class S>
     void nested_copy(T&& iter, std::initializer_list<S> s);
 
+    /**
+     * Tag requesting a container to default-initialize the elements it
+     * allocates instead of value-initializing them. For trivially default
+     * constructible value types, the buffer is then not written at all.
+     */
+    struct uninitialized_t
+    {
+        explicit uninitialized_t() = default;
+    };
+
+    constexpr uninitialized_t uninitialized{};
+
     template <class C>
     bool resize_container(C& c, typename C::size_type size);
 
+    template <class C>
+    bool resize_container(C& c, typename C::size_type size, uninitialized_t);
+
     template <class T, std::size_t N>
     bool resize_container(std::array<T, N>& a, typename std::array<T, N>::size_type size);
 
+    template <class T, std::size_t N>
+    bool resize_container(std::array<T, N>& a, typename std::array<T, N>::size_type size, uninitialized_t);
+
     template <std::size_t... I>
     class fixed_shape;
 
@@ -341,12 +365,56 @@ namespace xt
         return true;
     }
 
+    namespace detail
+    {
+        template <class C, class = void>
+        struct has_uninitialized_resize : std::false_type
+        {
+        };
+
+        template <class C>
+        struct has_uninitialized_resize<C, void_t<decltype(std::declval<C&>().resize(std::declval<typename C::size_type>(),
+                                                                                      std::declval<uninitialized_t>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class C>
+        inline void resize_uninitialized(C& c, typename C::size_type size, std::true_type)
+        {
+            c.resize(size, uninitialized);
+        }
+
+        template <class C>
+        inline void resize_uninitialized(C& c, typename C::size_type size, std::false_type)
+        {
+            c.resize(size);
+        }
+    }
+
+    /**
+     * Resizes \c c without value-initializing its elements if the container
+     * supports it, i.e. if it provides a resize(size, uninitialized_t) method.
+     * Other containers are resized as usual.
+     */
+    template <class C>
+    inline bool resize_container(C& c, typename C::size_type size, uninitialized_t)
+    {
+        detail::resize_uninitialized(c, size, detail::has_uninitialized_resize<C>());
+        return true;
+    }
     template <class T, std::size_t N>
     inline bool resize_container(std::array<T, N>& /*a*/, typename std::array<T, N>::size_type size)
     {
         return size == N;
     }
 
+    template <class T, std::size_t N>
+    inline bool resize_container(std::array<T, N>& /*a*/, typename std::array<T, N>::size_type size, uninitialized_t)
+    {
+        return size == N;
+    }
+
     template <std::size_t... I>
     inline bool resize_container(xt::fixed_shape<I...>&, std::size_t size)
     {
@@ -734,10 +802,189 @@ namespace xt
             enabled() = false;
         }
 
+        /**
+         * What tracking_allocator does with the allocations made while the
+         * tracking is enabled: ``print`` writes them to std::cout, ``assert``
+         * throws, ``count`` only records them in the statistics.
+         */
         enum policy
         {
             print,
-            assert
+            assert,
+            count
+        };
+
+        /**
+         * Counters of the allocations made by tracking_allocator while the
+         * tracking is enabled. The live bytes are the bytes allocated and not
+         * deallocated yet, and do not go below zero when memory allocated
+         * before the tracking was enabled or the statistics were reset is
+         * deallocated.
+         */
+        struct statistics
+        {
+            std::size_t allocations = 0;
+            std::size_t deallocations = 0;
+            std::size_t allocated_bytes = 0;
+            std::size_t live_bytes = 0;
+            std::size_t peak_live_bytes = 0;
+        };
+
+        /**
+         * Allocation or deallocation passed to the callback, \c tag being
+         * the innermost scoped_tag of the calling thread or nullptr.
+         */
+        struct event
+        {
+            const std::type_info* type;
+            std::size_t size;
+            std::size_t bytes;
+            bool deallocation;
+            const char* tag;
+        };
+
+        using callback_type = std::function<void(const event&)>;
+
+        namespace detail
+        {
+            struct registry
+            {
+                std::mutex mutex;
+                statistics total;
+                std::map<std::type_index, statistics> by_type;
+                std::map<std::string, statistics> by_tag;
+                callback_type callback;
+            };
+
+            inline registry& get_registry()
+            {
+                static registry r;
+                return r;
+            }
+
+            inline const char*& current_tag()
+            {
+                static thread_local const char* tag = nullptr;
+                return tag;
+            }
+
+            inline void update(statistics& s, std::size_t bytes, bool deallocation)
+            {
+                if (deallocation)
+                {
+                    ++s.deallocations;
+                    s.live_bytes -= (std::min)(bytes, s.live_bytes);
+                }
+                else
+                {
+                    ++s.allocations;
+                    s.allocated_bytes += bytes;
+                    s.live_bytes += bytes;
+                    s.peak_live_bytes = (std::max)(s.peak_live_bytes, s.live_bytes);
+                }
+            }
+
+            inline void record(const std::type_info& type, std::size_t size, std::size_t bytes, bool deallocation)
+            {
+                registry& r = get_registry();
+                const char* tag = current_tag();
+                callback_type callback;
+                {
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    update(r.total, bytes, deallocation);
+                    update(r.by_type[std::type_index(type)], bytes, deallocation);
+                    if (tag != nullptr)
+                    {
+                        update(r.by_tag[tag], bytes, deallocation);
+                    }
+                    callback = r.callback;
+                }
+                if (callback)
+                {
+                    callback(event{&type, size, bytes, deallocation, tag});
+                }
+            }
+        }
+
+        /**
+         * Returns the statistics of all the tracked allocations.
+         */
+        inline statistics stats()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            return r.total;
+        }
+
+        /**
+         * Returns the statistics of the tracked allocations per value type.
+         */
+        inline std::map<std::type_index, statistics> type_stats()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            return r.by_type;
+        }
+
+        /**
+         * Returns the statistics of the tracked allocations per tag. A
+         * deallocation is attributed to the tag active when it happens.
+         */
+        inline std::map<std::string, statistics> tag_stats()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            return r.by_tag;
+        }
+
+        inline void reset_stats()
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.total = statistics();
+            r.by_type.clear();
+            r.by_tag.clear();
+        }
+
+        /**
+         * Sets the function called on each tracked allocation and
+         * deallocation, an empty function removing it. The callback is
+         * called without holding any lock, from the allocating thread.
+         */
+        inline void set_callback(callback_type callback)
+        {
+            detail::registry& r = detail::get_registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.callback = std::move(callback);
+        }
+
+        /**
+         * @class scoped_tag
+         * @brief Attributes the allocations of the calling thread to a tag
+         * until the end of the scope. Tags can be nested, the innermost one
+         * being used. The tag string must outlive the scope.
+         */
+        class scoped_tag
+        {
+        public:
+
+            explicit scoped_tag(const char* tag) noexcept
+                : p_previous(detail::current_tag())
+            {
+                detail::current_tag() = tag;
+            }
+
+            ~scoped_tag()
+            {
+                detail::current_tag() = p_previous;
+            }
+
+            scoped_tag(const scoped_tag&) = delete;
+            scoped_tag& operator=(const scoped_tag&) = delete;
+
+        private:
+
+            const char* p_previous;
         };
     }
 
@@ -770,11 +1017,20 @@ namespace xt
                                   "xtensor allocation of " + std::to_string(n) +
                                   " elements detected");
                 }
+                alloc_tracking::detail::record(typeid(T), n, n * sizeof(T), false);
             }
             return base_type::allocate(n);
         }
 
-        using base_type::deallocate;
+        void deallocate(T* p, std::size_t n)
+        {
+            if (alloc_tracking::enabled())
+            {
+                alloc_tracking::detail::record(typeid(T), n, n * sizeof(T), true);
+            }
+            base_type::deallocate(p, n);
+        }
+
         using base_type::construct;
         using base_type::destroy;
 
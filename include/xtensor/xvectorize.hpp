@@ -13,6 +13,8 @@
 #include <type_traits>
 #include <utility>
 
+#include <xtl/xtype_traits.hpp>
+
 #include "xfunction.hpp"
 #include "xutils.hpp"
 
@@ -42,10 +44,50 @@ namespace xt
         typename std::remove_reference<F>::type m_f;
     };
 
+    /***********************
+     * xgeneric_vectorizer *
+     ***********************/
+
+    template <class F>
+    class xgeneric_vectorizer
+    {
+    public:
+
+        template <class... E>
+        using functor_type = detail::lambda_functor_t<F, sizeof...(E)>;
+
+        template <class... E>
+        using xfunction_type = xfunction<functor_type<E...>, xclosure_t<E>...>;
+
+        template <class Func, class = std::enable_if_t<!std::is_same<std::decay_t<Func>, xgeneric_vectorizer>::value>>
+        xgeneric_vectorizer(Func&& f);
+
+        template <class... E>
+        xfunction_type<E...> operator()(E&&... e) const;
+
+    private:
+
+        std::decay_t<F> m_f;
+    };
+
     namespace detail
     {
         template <class F>
         using get_function_type = remove_class_t<decltype(&std::remove_reference_t<F>::operator())>;
+
+        template <class F, class = void>
+        struct has_function_type : std::false_type
+        {
+        };
+
+        template <class F>
+        struct has_function_type<F, void_t<get_function_type<F>>> : std::true_type
+        {
+        };
+
+        template <class F>
+        using is_generic_callable = xtl::conjunction<std::is_class<std::decay_t<F>>,
+                                                     xtl::negation<has_function_type<F>>>;
     }
 
     template <class R, class... Args>
@@ -80,6 +122,24 @@ namespace xt
         return xfunction_type<E...>(m_f, std::forward<E>(e)...);
     }
 
+    /**************************************
+     * xgeneric_vectorizer implementation *
+     **************************************/
+
+    template <class F>
+    template <class Func, class>
+    inline xgeneric_vectorizer<F>::xgeneric_vectorizer(Func&& f)
+        : m_f(std::forward<Func>(f))
+    {
+    }
+
+    template <class F>
+    template <class... E>
+    inline auto xgeneric_vectorizer<F>::operator()(E&&... e) const -> xfunction_type<E...>
+    {
+        return xfunction_type<E...>(functor_type<E...>(m_f), std::forward<E>(e)...);
+    }
+
     template <class R, class... Args>
     inline xvectorizer<R (*)(Args...), R> vectorize(R (*f)(Args...))
     {
@@ -97,6 +157,20 @@ namespace xt
     {
         return vectorize(std::forward<F>(f), static_cast<detail::get_function_type<F>*>(nullptr));
     }
+
+    /**
+     * Vectorizes a generic callable, e.g. a lambda taking \c auto arguments
+     * or a functor with a template call operator. The resulting function is
+     * vectorized with xsimd when the callable can be invoked with batches;
+     * as for make_lambda_xfunction, the callable must then have a trailing
+     * return type (<tt>-> decltype(...)</tt>) for the detection to work.
+     * @param f the callable to vectorize
+     */
+    template <class F, XTL_REQUIRES(detail::is_generic_callable<F>)>
+    inline xgeneric_vectorizer<F> vectorize(F&& f)
+    {
+        return xgeneric_vectorizer<F>(std::forward<F>(f));
+    }
 }
 
 #endif
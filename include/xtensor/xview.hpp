@@ -27,6 +27,7 @@
 #include "xbroadcast.hpp"
 #include "xcontainer.hpp"
 #include "xiterable.hpp"
+#include "xprofiler.hpp"
 #include "xsemantic.hpp"
 #include "xslice.hpp"
 #include "xtensor.hpp"
@@ -460,6 +461,9 @@ namespace xt
         template <class T>
         void fill(const T& value);
 
+        template <class E, class F>
+        self_type& scalar_computed_assign(const E& e, F&& f);
+
         template <class... Args>
         reference operator()(Args... args);
         template <class... Args>
@@ -666,6 +670,14 @@ namespace xt
             static constexpr bool value = (I + newaxis_count_before<S...>(I + 1) < sizeof...(S));
         };
 
+        // The elements of a strided view over a buffer are accessed through
+        // the strides and the data offset of the view, which are computed once
+        // and already account for the slices of the nested views.
+        static constexpr bool has_strided_access = is_strided_view
+            && std::is_lvalue_reference<reference>::value
+            && std::is_same<std::remove_reference_t<reference>, std::remove_pointer_t<pointer>>::value
+            && std::is_same<std::remove_reference_t<const_reference>, std::remove_pointer_t<const_pointer>>::value;
+
         CT m_e;
         slice_type m_slices;
         inner_shape_type m_shape;
@@ -686,6 +698,9 @@ namespace xt
         void compute_strides(std::true_type) const;
         void compute_strides(std::false_type) const;
 
+        void init_strided_access(std::true_type) noexcept;
+        void init_strided_access(std::false_type) noexcept;
+
         reference access();
 
         template <class Arg, class... Args>
@@ -702,12 +717,39 @@ namespace xt
         template <typename std::decay_t<CT>::size_type... I, class... Args>
         const_reference unchecked_impl(std::index_sequence<I...>, Args... args) const;
 
+        template <class... Args>
+        reference unchecked_dispatch(std::true_type, Args... args);
+
+        template <class... Args>
+        reference unchecked_dispatch(std::false_type, Args... args);
+
+        template <class... Args>
+        const_reference unchecked_dispatch(std::true_type, Args... args) const;
+
+        template <class... Args>
+        const_reference unchecked_dispatch(std::false_type, Args... args) const;
+
         template <typename std::decay_t<CT>::size_type... I, class... Args>
         reference access_impl(std::index_sequence<I...>, Args... args);
 
         template <typename std::decay_t<CT>::size_type... I, class... Args>
         const_reference access_impl(std::index_sequence<I...>, Args... args) const;
 
+        template <class... Args>
+        reference access_dispatch(std::true_type, Args... args);
+
+        template <class... Args>
+        reference access_dispatch(std::false_type, Args... args);
+
+        template <class... Args>
+        const_reference access_dispatch(std::true_type, Args... args) const;
+
+        template <class... Args>
+        const_reference access_dispatch(std::false_type, Args... args) const;
+
+        template <class... Args>
+        std::ptrdiff_t strided_offset(Args... args) const;
+
         template <typename std::decay_t<CT>::size_type I, class... Args>
         std::enable_if_t<lesser_condition<I>::value, size_type> index(Args... args) const;
 
@@ -907,6 +949,7 @@ namespace xt
           m_shape(compute_shape(std::false_type{})),
           m_strides_computed(false)
     {
+        init_strided_access(std::integral_constant<bool, has_strided_access>());
     }
     //@}
 
@@ -1007,15 +1050,53 @@ namespace xt
     template <class T>
     inline void xview<CT, S...>::fill(const T& value)
     {
-        xtl::mpl::static_if<static_layout != layout_type::dynamic>([&](auto self)
+        xtl::mpl::static_if<is_strided_view>([&](auto self)
         {
-            std::fill(self(this)->linear_begin(), self(this)->linear_end(), value);
+            if (static_layout != layout_type::dynamic || self(this)->is_contiguous())
+            {
+                std::fill(self(this)->linear_begin(), self(this)->linear_end(), value);
+            }
+            else
+            {
+                std::fill(self(this)->begin(), self(this)->end(), value);
+            }
         }, /*else*/ [&](auto self)
         {
             std::fill(self(this)->begin(), self(this)->end(), value);
         });
     }
 
+    /**
+     * Applies \c f to the elements of the view and the scalar \c e, and
+     * assigns the result to the view. The elements of a view whose slices
+     * are contiguous at runtime, e.g. full ranges following an integer, are
+     * traversed through the underlying buffer.
+     */
+    template <class CT, class... S>
+    template <class E, class F>
+    inline auto xview<CT, S...>::scalar_computed_assign(const E& e, F&& f) -> self_type&
+    {
+        xtl::mpl::static_if<is_strided_view>([&](auto self)
+        {
+            if (static_layout != layout_type::dynamic || self(this)->is_contiguous())
+            {
+                auto last = self(this)->linear_end();
+                for (auto it = self(this)->linear_begin(); it != last; ++it)
+                {
+                    *it = f(*it, e);
+                }
+            }
+            else
+            {
+                self(this)->semantic_base::scalar_computed_assign(e, std::forward<F>(f));
+            }
+        }, /*else*/ [&](auto self)
+        {
+            self(this)->semantic_base::scalar_computed_assign(e, std::forward<F>(f));
+        });
+        return *this;
+    }
+
     /**
      * Returns a reference to the element at the specified position in the view.
      * @param args a list of indices specifying the position in the view. Indices
@@ -1056,7 +1137,7 @@ namespace xt
     template <class... Args>
     inline auto xview<CT, S...>::unchecked(Args... args) -> reference
     {
-        return unchecked_impl(make_index_sequence(args...), static_cast<size_type>(args)...);
+        return unchecked_dispatch(std::integral_constant<bool, has_strided_access>(), static_cast<size_type>(args)...);
     }
 
 
@@ -1080,6 +1161,7 @@ namespace xt
     template <class... Args>
     inline auto xview<CT, S...>::operator()(Args... args) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(view_node, void);
         XTENSOR_TRY(check_index(shape(), args...));
         XTENSOR_CHECK_DIMENSION(shape(), args...);
         // The static cast prevents the compiler from instantiating the template methods with signed integers,
@@ -1110,13 +1192,15 @@ namespace xt
     template <class... Args>
     inline auto xview<CT, S...>::unchecked(Args... args) const -> const_reference
     {
-        return unchecked_impl(make_index_sequence(args...), static_cast<size_type>(args)...);
+        XTENSOR_PROFILE_NODE(view_node, void);
+        return unchecked_dispatch(std::integral_constant<bool, has_strided_access>(), static_cast<size_type>(args)...);
     }
 
     template <class CT, class... S>
     template <class It>
     inline auto xview<CT, S...>::element(It first, It last) const -> const_reference
     {
+        XTENSOR_PROFILE_NODE(view_node, void);
         // TODO: avoid memory allocation
         auto index = make_index(first, last);
         return m_e.element(index.cbegin(), index.cend());
@@ -1477,6 +1561,7 @@ namespace xt
     template <class align, class requested_type, std::size_t N, class T>
     inline auto xview<CT, S...>::load_simd(size_type i) const -> enable_simd_interface<T, simd_return_type<requested_type>>
     {
+        XTENSOR_PROFILE_NODE(view_node, void);
         return m_e.template load_simd<xt_simd::unaligned_mode, requested_type>(data_offset() + i);
     }
 
@@ -1491,6 +1576,7 @@ namespace xt
     template <class T>
     inline auto xview<CT, S...>::data_element(size_type i) const -> enable_simd_interface<T, const_reference>
     {
+        XTENSOR_PROFILE_NODE(view_node, void);
         return m_e.data_element(data_offset() + i);
     }
 
@@ -1561,6 +1647,18 @@ namespace xt
     {
     }
 
+    template <class CT, class... S>
+    inline void xview<CT, S...>::init_strided_access(std::true_type) noexcept
+    {
+        compute_strides(std::false_type());
+        m_strides_computed = true;
+    }
+
+    template <class CT, class... S>
+    inline void xview<CT, S...>::init_strided_access(std::false_type) noexcept
+    {
+    }
+
     template <class CT, class... S>
     inline auto xview<CT, S...>::access() -> reference
     {
@@ -1575,7 +1673,7 @@ namespace xt
         {
             return access(args...);
         }
-        return access_impl(make_index_sequence(arg, args...), arg, args...);
+        return access_dispatch(std::integral_constant<bool, has_strided_access>(), arg, args...);
     }
 
     template <class CT, class... S>
@@ -1592,7 +1690,79 @@ namespace xt
         {
             return access(args...);
         }
-        return access_impl(make_index_sequence(arg, args...), arg, args...);
+        return access_dispatch(std::integral_constant<bool, has_strided_access>(), arg, args...);
+    }
+
+    // Fewer indices than dimensions keep the semantic of the slices
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::access_dispatch(std::true_type, Args... args) -> reference
+    {
+        if (sizeof...(Args) == this->dimension())
+        {
+            return m_e.data()[strided_offset(args...)];
+        }
+        return access_impl(make_index_sequence(args...), args...);
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::access_dispatch(std::false_type, Args... args) -> reference
+    {
+        return access_impl(make_index_sequence(args...), args...);
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::access_dispatch(std::true_type, Args... args) const -> const_reference
+    {
+        if (sizeof...(Args) == this->dimension())
+        {
+            return m_e.data()[strided_offset(args...)];
+        }
+        return access_impl(make_index_sequence(args...), args...);
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::access_dispatch(std::false_type, Args... args) const -> const_reference
+    {
+        return access_impl(make_index_sequence(args...), args...);
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::unchecked_dispatch(std::true_type, Args... args) -> reference
+    {
+        return m_e.data()[strided_offset(args...)];
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::unchecked_dispatch(std::false_type, Args... args) -> reference
+    {
+        return unchecked_impl(make_index_sequence(args...), args...);
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::unchecked_dispatch(std::true_type, Args... args) const -> const_reference
+    {
+        return m_e.data()[strided_offset(args...)];
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline auto xview<CT, S...>::unchecked_dispatch(std::false_type, Args... args) const -> const_reference
+    {
+        return unchecked_impl(make_index_sequence(args...), args...);
+    }
+
+    template <class CT, class... S>
+    template <class... Args>
+    inline std::ptrdiff_t xview<CT, S...>::strided_offset(Args... args) const
+    {
+        return static_cast<std::ptrdiff_t>(m_data_offset) + static_cast<std::ptrdiff_t>(detail::raw_data_offset<0>(m_strides, args...));
     }
 
     template <class CT, class... S>
@@ -1983,6 +2153,7 @@ namespace xt
     template <bool is_const, class CT, class... S>
     inline auto xview_stepper<is_const, CT, S...>::operator*() const -> reference
     {
+        XTENSOR_PROFILE_NODE(view_node, void);
         return *m_it;
     }
 
@@ -241,4 +241,53 @@ namespace xt
         auto result2 = xt::cumsum(a, 1);
         EXPECT_EQ(result2, expected);
     }
+
+    // Large enough to take the blocked parallel scan when a parallel backend
+    // is enabled; integral values keep the reassociated sums exact.
+    TEST(xaccumulator, large)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(3. * 50000.), 5.);
+        a(7) = std::nan("");
+        a(70001) = std::nan("");
+        a.reshape({3, 50000});
+
+        xt::xarray<double> flat = xt::flatten(a);
+        xt::xarray<double> expected_flat = xt::zeros<double>({flat.size()});
+        double running = 0.;
+        for (std::size_t i = 0; i < flat.size(); ++i)
+        {
+            running += std::isnan(flat(i)) ? 0. : flat(i);
+            expected_flat(i) = running;
+        }
+        EXPECT_EQ(xt::nancumsum(a), expected_flat);
+
+        xt::xarray<double> expected_1 = xt::zeros<double>(a.shape());
+        xt::xarray<double> expected_0 = xt::zeros<double>(a.shape());
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            running = 0.;
+            for (std::size_t j = 0; j < 50000; ++j)
+            {
+                running += std::isnan(a(i, j)) ? 0. : a(i, j);
+                expected_1(i, j) = running;
+                expected_0(i, j) = (i == 0 ? 0. : expected_0(i - 1, j)) + (std::isnan(a(i, j)) ? 0. : a(i, j));
+            }
+        }
+        EXPECT_EQ(xt::nancumsum(a, 1), expected_1);
+        EXPECT_EQ(xt::nancumsum(a, 0), expected_0);
+
+        xt::xarray<double, xt::layout_type::column_major> ca = a;
+        EXPECT_EQ(xt::nancumsum(ca, 1), expected_1);
+        EXPECT_EQ(xt::nancumsum(ca, 0), expected_0);
+
+        xt::xarray<double> b = xt::where(xt::isnan(a), 0., a);
+        EXPECT_EQ(xt::cumsum(b, 1), xt::nancumsum(a, 1));
+        EXPECT_EQ(xt::cumsum(b), xt::nancumsum(a));
+
+        xt::xarray<double> ones = xt::ones<double>({100000});
+        ones(99999) = 3.;
+        xt::xarray<double> prod = xt::cumprod(ones);
+        EXPECT_EQ(prod(99998), 1.);
+        EXPECT_EQ(prod(99999), 3.);
+    }
 }
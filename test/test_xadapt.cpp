@@ -7,6 +7,11 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
 #include "test_common_macros.hpp"
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xstrides.hpp"
@@ -452,6 +457,20 @@ namespace xt
         }
     }
 
+    namespace
+    {
+        constexpr std::array<double, 6> static_table = {{1., 2., 3., 4., 5., 6.}};
+    }
+
+    TEST(xtensor_fixed_adaptor, static_table)
+    {
+        auto t = adapt(static_table.data(), xshape<2, 3>());
+        EXPECT_EQ(t.data(), static_table.data());
+        EXPECT_EQ(t(1, 2), 6.);
+        xtensor_fixed<double, xshape<2, 3>> twice = 2. * t;
+        EXPECT_EQ(twice(0, 1), 4.);
+    }
+
     namespace xadapt_test
     {
         struct Buffer {
@@ -530,4 +549,43 @@ namespace xt
             auto obj = adapt_smart_ptr(unique_buf.get()->buf.data(), {2, 4}, std::move(unique_buf));
         }
     }
+
+    TEST(xarray_container, adopt)
+    {
+        std::vector<double> v = {1., 2., 3., 4., 5., 6.};
+        const double* ptr = v.data();
+        auto a = adopt(std::move(v), std::vector<std::size_t>{2, 3});
+        bool is_container = std::is_same<decltype(a), xarray_container<std::vector<double>>>::value;
+        EXPECT_TRUE(is_container);
+        EXPECT_EQ(a.data(), ptr);
+        EXPECT_EQ(a(1, 0), XTENSOR_DEFAULT_LAYOUT == layout_type::row_major ? 4. : 2.);
+        a.resize({3, 3});
+        EXPECT_EQ(a.size(), 9u);
+
+        std::vector<int> w = {1, 2, 3, 4, 5, 6};
+        auto t = adopt<layout_type::column_major>(std::move(w), {2, 3});
+        EXPECT_EQ(t.dimension(), 2u);
+        EXPECT_EQ(t(1, 0), 2);
+        std::vector<int> back = std::move(t.storage());
+        EXPECT_EQ(back.size(), 6u);
+
+        std::vector<int> wrong = {1, 2, 3};
+        XT_EXPECT_THROW(adopt(std::move(wrong), {2, 2}), std::runtime_error);
+    }
+
+    TEST(xarray_adaptor, adopt)
+    {
+        std::size_t nb_deleted = 0;
+        auto deleter = [&nb_deleted](double* p) { ++nb_deleted; delete[] p; };
+        {
+            std::unique_ptr<double[], decltype(deleter)> buf(new double[6], deleter);
+            double* ptr = buf.get();
+            auto a = adopt(std::move(buf), {2, 3});
+            EXPECT_EQ(a.data(), ptr);
+            a.fill(2.);
+            auto b = a;
+            EXPECT_EQ(b.data(), ptr);
+        }
+        EXPECT_EQ(nb_deleted, 1u);
+    }
 }
@@ -0,0 +1,104 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarena.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xsort.hpp"
+
+namespace xt
+{
+    TEST(xarena, allocate)
+    {
+        xarena arena(64);
+        EXPECT_EQ(arena.capacity(), 0u);
+        void* p = arena.allocate(10);
+        void* q = arena.allocate(8, 8);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(q) % 8u, 0u);
+        EXPECT_EQ(static_cast<char*>(q) - static_cast<char*>(p), 16);
+        xarena::marker m = arena.mark();
+
+        // A request larger than the free space adds a block
+        arena.allocate(100);
+        EXPECT_EQ(arena.block_count(), 2u);
+        EXPECT_EQ(arena.capacity(), 64u + 128u);
+
+        arena.rewind(m);
+        EXPECT_EQ(arena.used(), 24u);
+        arena.reset();
+        EXPECT_EQ(arena.block_count(), 1u);
+        EXPECT_EQ(arena.capacity(), 192u);
+        EXPECT_EQ(arena.used(), 0u);
+        arena.release();
+        EXPECT_EQ(arena.capacity(), 0u);
+    }
+
+    TEST(xarena, scope)
+    {
+        EXPECT_TRUE(xarena::current() == nullptr);
+        xarena arena;
+        arena_uvector<double> outside(4, 1.);
+        {
+            arena_scope scope(arena);
+            EXPECT_TRUE(xarena::current() == &arena);
+            arena_uvector<double> a(100, 2.);
+            EXPECT_LT(100 * sizeof(double), arena.used() + 1);
+            std::size_t used = arena.used();
+            {
+                arena_scope inner(arena);
+                arena_uvector<int> b(10, 3);
+                EXPECT_LT(used, arena.used());
+            }
+            EXPECT_EQ(arena.used(), used);
+
+            // Memory from the heap is freed in the scope
+            outside.resize(8);
+            outside = arena_uvector<double>(3, 4.);
+            EXPECT_EQ(a[99], 2.);
+        }
+        EXPECT_TRUE(xarena::current() == nullptr);
+        EXPECT_EQ(arena.used(), 0u);
+        EXPECT_EQ(outside.size(), 3u);
+        EXPECT_EQ(outside[2], 4.);
+    }
+
+    TEST(xarena, temporaries)
+    {
+        xarray<double> a = xt::arange<double>(10000.);
+        xarray<double> ra = 10000. - a;
+        xarray<double> s;
+        double total = 0.;
+        {
+            arena_scope scope;
+            s = sort(ra, xnone());
+            xarray<double> m = a;
+            m.reshape({100, 100});
+            total = sum(m, {0})(0);
+            EXPECT_LT(std::size_t(0), scope.arena().capacity());
+            EXPECT_EQ(median(ra), 5000.5);
+        }
+        EXPECT_EQ(thread_arena().used(), 0u);
+        EXPECT_EQ(s(0), 1.);
+        EXPECT_EQ(s(9999), 10000.);
+        EXPECT_EQ(total, 495000.);
+
+        using arena_array = xarray<double, XTENSOR_DEFAULT_LAYOUT, arena_allocator<double>>;
+        {
+            arena_scope scope;
+            arena_array b = a + 1.;
+            EXPECT_EQ(b(9999), 10000.);
+            EXPECT_LT(b.size() * sizeof(double), scope.arena().used() + 1);
+        }
+    }
+}
@@ -11,6 +11,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xmanipulation.hpp"
+#include "xtensor/xview.hpp"
 #include "xtensor/xio.hpp"
 #include "test_common.hpp"
 #include <type_traits>
@@ -157,6 +158,31 @@ namespace xt
 #endif
     }
 
+    TEST(xarray, uninitialized)
+    {
+        std::vector<size_t> shape = {3, 4};
+        xarray<double> a(shape, uninitialized);
+        EXPECT_EQ(a.shape(), shape);
+        a.fill(1.);
+        EXPECT_EQ(a(2, 3), 1.);
+
+        auto b = xarray<double, layout_type::column_major>::from_shape({2, 5}, uninitialized);
+        EXPECT_EQ(b.size(), size_t(10));
+        EXPECT_EQ(b.strides()[0], 1);
+
+        a.resize({4, 5, 6}, uninitialized);
+        EXPECT_EQ(a.size(), size_t(120));
+        xarray_dynamic c;
+        c.resize({2, 3}, layout_type::column_major, uninitialized);
+        EXPECT_EQ(c.layout(), layout_type::column_major);
+        EXPECT_EQ(c.size(), size_t(6));
+
+        // storages without uninitialized resize are resized as usual
+        xarray_container<std::vector<int>> d(shape, uninitialized);
+        EXPECT_EQ(d.size(), size_t(12));
+        EXPECT_EQ(d(1, 1), 0);
+    }
+
     TEST(xarray, reshape)
     {
         xarray_dynamic a;
@@ -436,4 +462,86 @@ TEST(xarray, flat)
         EXPECT_TRUE(d(2));
         EXPECT_FALSE(d(3));
     }
+
+    template <class T>
+    struct shape_counting_allocator : std::allocator<T>
+    {
+        template <class U>
+        struct rebind
+        {
+            using other = shape_counting_allocator<U>;
+        };
+
+        shape_counting_allocator() = default;
+
+        template <class U>
+        shape_counting_allocator(const shape_counting_allocator<U>&)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            ++count();
+            return std::allocator<T>::allocate(n);
+        }
+
+        static std::size_t& count()
+        {
+            static std::size_t c = 0;
+            return c;
+        }
+    };
+
+    TEST(xarray, inline_shape)
+    {
+        using shape_allocator = shape_counting_allocator<std::size_t>;
+        using small_type = xarray<double, layout_type::row_major, std::allocator<double>, shape_allocator>;
+        using inline_type = xarray_inline<double, 8, layout_type::row_major, std::allocator<double>, shape_allocator>;
+
+        std::vector<std::size_t> shape = {2, 3, 2, 1, 2, 3};
+        shape_allocator::count() = 0;
+        small_type a(shape, 1.);
+        EXPECT_LT(std::size_t(0), shape_allocator::count());
+
+        shape_allocator::count() = 0;
+        inline_type b(shape, 1.);
+        inline_type c = b + b;
+        c.reshape({3, 2, 1, 2, 3, 2});
+        EXPECT_EQ(std::size_t(0), shape_allocator::count());
+        EXPECT_EQ(c(2, 1, 0, 1, 2, 1), 2.);
+
+        auto v = view(c, 1, all(), all(), range(0, 1));
+        EXPECT_TRUE((std::is_same<decltype(v)::shape_type, svector<std::size_t, 8, shape_allocator, true>>::value));
+        EXPECT_TRUE((std::is_same<xindex_type_t<inline_type::shape_type>, svector<std::size_t, 8>>::value));
+        EXPECT_EQ(v.dimension(), std::size_t(5));
+        EXPECT_EQ(std::size_t(0), shape_allocator::count());
+    }
+
+    TEST(xarray, shared_array)
+    {
+        xshared_array<double> a = {{1., 2.}, {3., 4.}};
+        const xshared_array<double>& ca = a;
+        xshared_array<double> b = a;
+        EXPECT_EQ(b.storage().use_count(), 2u);
+        EXPECT_EQ(ca.data(), static_cast<const xshared_array<double>&>(b).data());
+
+        b(0, 1) = 5.;
+        EXPECT_EQ(ca(0, 1), 2.);
+        EXPECT_EQ(b(0, 1), 5.);
+        EXPECT_TRUE(a.storage().unique());
+
+        xshared_array<double> c = b;
+        c += a;
+        EXPECT_EQ(b(1, 1), 4.);
+        EXPECT_EQ(c(1, 1), 8.);
+
+        xshared_array<double> d = a;
+        d.resize({3, 3});
+        d.fill(1.);
+        EXPECT_EQ(ca(1, 0), 3.);
+        EXPECT_EQ(d(2, 2), 1.);
+
+        xarray<double> e = ca * 2.;
+        EXPECT_EQ(e(1, 0), 6.);
+    }
 }
@@ -10,11 +10,17 @@
 #include "test_common_macros.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xadapt.hpp"
 
 #include "xtensor/xassign.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
 #include "test_common.hpp"
 
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -145,4 +151,297 @@ namespace xt
         }
 
     }
+
+    TEST(xassign, tiled_layout_change)
+    {
+        xarray<double> a = arange<double>(70. * 45.);
+        a.reshape({70, 45});
+
+        xarray<double, layout_type::column_major> b = a;
+        EXPECT_EQ(b.layout(), layout_type::column_major);
+        for (std::size_t i = 0; i < a.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < a.shape(1); ++j)
+            {
+                EXPECT_EQ(b(i, j), a(i, j));
+            }
+        }
+
+        xarray<int> c = transpose(b);
+        for (std::size_t i = 0; i < a.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < a.shape(1); ++j)
+            {
+                EXPECT_EQ(c(j, i), static_cast<int>(a(i, j)));
+            }
+        }
+    }
+
+    TEST(xassign, tiled_transpose)
+    {
+        xtensor<double, 3> a = arange<double>(5. * 37. * 66.).reshape({5, 37, 66});
+        xtensor<double, 3> res = zeros<double>({66, 5, 37});
+        EXPECT_TRUE(tiled_assigner<true>::run(res, transpose(a, {2, 0, 1}), exec::seq));
+        EXPECT_EQ(res, transpose(a, {2, 0, 1}));
+
+        xtensor<double, 3> tr = transpose(a);
+        EXPECT_EQ(tr, transpose(a));
+
+        auto v = view(a, 2, range(3, 35), range(1, 60));
+        xtensor<double, 2, layout_type::column_major> vres = v;
+        EXPECT_EQ(vres, v);
+
+        xtensor<double, 3> same = zeros<double>({5, 37, 66});
+        EXPECT_FALSE(tiled_assigner<true>::run(same, a, exec::seq));
+        EXPECT_EQ(same, zeros<double>({5, 37, 66}));
+    }
+
+    TEST(xassign, reversed)
+    {
+        xtensor<double, 2> a = arange<double>(6. * 37.).reshape({6, 37});
+        xtensor<double, 2> res = zeros<double>({6, 37});
+        EXPECT_TRUE(reversed_assigner<true>::run(res, flip(a, 1), exec::seq));
+        EXPECT_EQ(res, flip(a, 1));
+        EXPECT_TRUE(reversed_assigner<true>::run(res, flip(a), exec::seq));
+        EXPECT_EQ(res(0, 0), a(5, 36));
+        EXPECT_EQ(res(5, 0), a(0, 36));
+
+        auto rv = flip(res, 1);
+        EXPECT_TRUE(reversed_assigner<true>::run(rv, a, exec::seq));
+        EXPECT_EQ(res, flip(a, 1));
+        EXPECT_TRUE(reversed_assigner<true>::run(rv, flip(a, 1), exec::seq));
+        EXPECT_EQ(res, a);
+
+        EXPECT_FALSE(reversed_assigner<true>::run(res, flip(a, 0), exec::seq));
+        EXPECT_FALSE(reversed_assigner<true>::run(res, a, exec::seq));
+    }
+
+    TEST(xassign, mixed_alignment)
+    {
+        std::size_t n = 203;
+        xtensor<double, 1> a = arange<double>(double(n));
+        xtensor<double, 1> expected = 2. * a + 1.;
+        std::array<std::size_t, 1> shape = {n};
+
+        for (std::size_t offset = 0; offset < 4; ++offset)
+        {
+            std::vector<double> src(n + offset, -1.);
+            std::copy(a.cbegin(), a.cend(), src.begin() + static_cast<std::ptrdiff_t>(offset));
+            auto asrc = adapt(src.data() + offset, n, no_ownership(), shape);
+
+            xtensor<double, 1> res = zeros<double>({n});
+            noalias(res) = 2. * asrc + 1.;
+            EXPECT_EQ(res, expected);
+
+            std::vector<double> dst(n + offset + 1, -1.);
+            auto adst = adapt(dst.data() + offset, n, no_ownership(), shape);
+            noalias(adst) = asrc + a + 1.;
+            EXPECT_EQ(adst, expected);
+            EXPECT_EQ(dst[n + offset], -1.);
+            if (offset != 0)
+            {
+                EXPECT_EQ(dst[offset - 1], -1.);
+            }
+        }
+    }
+
+    TEST(xassign, inner_broadcast)
+    {
+        xtensor<double, 2> a = arange<double>(7. * 19.).reshape({7, 19});
+        xtensor<double, 1> mean = arange<double>(7.) * 0.5;
+        xtensor<double, 1> scale = arange<double>(19.) + 1.;
+        xtensor<double, 2> col = view(mean, all(), newaxis());
+
+        xtensor<double, 2> res = zeros<double>({7, 19});
+        noalias(res) = a - view(mean, all(), newaxis());
+        xtensor<double, 2> res2 = zeros<double>({7, 19});
+        noalias(res2) = (a - col) * view(scale, newaxis(), all());
+        for (std::size_t i = 0; i < a.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < a.shape(1); ++j)
+            {
+                EXPECT_EQ(res(i, j), a(i, j) - mean(i));
+                EXPECT_EQ(res2(i, j), (a(i, j) - mean(i)) * scale(j));
+            }
+        }
+
+        xtensor<double, 3> b = arange<double>(4. * 5. * 6.).reshape({4, 5, 6});
+        xtensor<double, 3> m = arange<double>(4.).reshape({4, 1, 1});
+        xtensor<double, 3> bres = zeros<double>({4, 5, 6});
+        noalias(bres) = b * m + 1.;
+        xtensor<double, 3> bm = broadcast(m, {4, 5, 6});
+        xtensor<double, 3> bexpected = b * bm + 1.;
+        EXPECT_EQ(bres, bexpected);
+
+        xtensor<double, 2, layout_type::column_major> ca = a;
+        xtensor<double, 2, layout_type::column_major> cres = zeros<double>({7, 19});
+        noalias(cres) = ca - view(scale, newaxis(), all());
+        for (std::size_t i = 0; i < a.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < a.shape(1); ++j)
+            {
+                EXPECT_EQ(cres(i, j), a(i, j) - scale(j));
+            }
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        xtensor<double, 2> sres = zeros<double>({7, 19});
+        strided_loop_assigner<true>::run(sres, a - view(mean, all(), newaxis()));
+        EXPECT_EQ(sres, res);
+        xtensor<double, 2, layout_type::column_major> scres = zeros<double>({7, 19});
+        strided_loop_assigner<true>::run(scres, ca - view(scale, newaxis(), all()));
+        EXPECT_EQ(scres, cres);
+#endif
+    }
+
+    TEST(xassign, strided_gather)
+    {
+        xtensor<double, 1> a = arange<double>(100.);
+        xtensor<double, 1> res = zeros<double>({34});
+        noalias(res) = view(a, range(0, 100, 3)) * 2. + 1.;
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            EXPECT_EQ(res(i), a(3 * i) * 2. + 1.);
+        }
+
+        xtensor<double, 1> rev = zeros<double>({50});
+        noalias(rev) = view(a, range(99, 0, -2)) + a(0);
+        for (std::size_t i = 0; i < rev.size(); ++i)
+        {
+            EXPECT_EQ(rev(i), a(99 - 2 * i));
+        }
+
+        xtensor<double, 2> m = arange<double>(6. * 40.).reshape({6, 40});
+        xtensor<double, 2> dec = zeros<double>({6, 10});
+        noalias(dec) = view(m, all(), range(1, 40, 4)) - view(m, all(), range(0, 10));
+        xtensor<double, 2> tr = zeros<double>({40, 6});
+        noalias(tr) = transpose(m) + 1.;
+        auto sv = strided_view(m, {range(0, 6, 2), range(0, 40, 5)});
+        xtensor<double, 2> sres = zeros<double>({3, 8});
+        noalias(sres) = sv * sv;
+        for (std::size_t i = 0; i < m.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < dec.shape(1); ++j)
+            {
+                EXPECT_EQ(dec(i, j), m(i, 1 + 4 * j) - m(i, j));
+            }
+            for (std::size_t j = 0; j < m.shape(1); ++j)
+            {
+                EXPECT_EQ(tr(j, i), m(i, j) + 1.);
+            }
+        }
+        for (std::size_t i = 0; i < sres.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < sres.shape(1); ++j)
+            {
+                EXPECT_EQ(sres(i, j), m(2 * i, 5 * j) * m(2 * i, 5 * j));
+            }
+        }
+
+        // A destination that is not contiguous along the innermost
+        // dimension is not written with batches
+        xtensor<double, 1> dst = zeros<double>({100});
+        auto vdst = view(dst, range(0, 100, 3));
+        noalias(vdst) = view(a, range(0, 34)) + 1.;
+        for (std::size_t i = 0; i < dst.size(); ++i)
+        {
+            EXPECT_EQ(dst(i), i % 3 == 0 ? a(i / 3) + 1. : 0.);
+        }
+
+        xtensor<double, 2, layout_type::column_major> cm = zeros<double>({10, 6});
+        noalias(cm) = transpose(view(m, all(), range(0, 40, 4))) + 1.;
+        for (std::size_t i = 0; i < cm.shape(0); ++i)
+        {
+            for (std::size_t j = 0; j < cm.shape(1); ++j)
+            {
+                EXPECT_EQ(cm(i, j), m(j, 4 * i) + 1.);
+            }
+        }
+
+#if defined(XTENSOR_USE_XSIMD)
+        xtensor<float, 1> f = arange<float>(1000.f);
+        xtensor<float, 1> fres = zeros<float>({100});
+        strided_loop_assigner<true>::run(fres, view(f, range(0, 1000, 10)) + 1.f);
+        for (std::size_t i = 0; i < fres.size(); ++i)
+        {
+            EXPECT_EQ(fres(i), f(10 * i) + 1.f);
+        }
+        xtensor<double, 2> gres = zeros<double>({6, 10});
+        strided_loop_assigner<true>::run(gres, view(m, all(), range(1, 40, 4)) - view(m, all(), range(0, 10)));
+        EXPECT_EQ(gres, dec);
+#endif
+    }
+
+    TEST(xassign, assign_all)
+    {
+        xtensor<double, 2> a = arange<double>(3000.).reshape({3, 1000});
+        xtensor<double, 2> b = 2. * a + 1.;
+
+        xarray<double> sum;
+        xtensor<int, 2> diff;
+        xtensor<double, 2> twice;
+        assign_all(std::tie(sum, diff, twice), std::make_tuple(a + b, b - a, 2. * sum));
+        xtensor<double, 2> expected_sum = a + b;
+        xtensor<int, 2> expected_diff = b - a;
+        xtensor<double, 2> expected_twice = 2. * expected_sum;
+        EXPECT_EQ(sum, expected_sum);
+        EXPECT_EQ(diff, expected_diff);
+        EXPECT_EQ(twice, expected_twice);
+
+        // Destinations traversed in different orders and broadcasting
+        // operands are assigned one after the other.
+        xtensor<double, 1> row = arange<double>(1000.);
+        xtensor<double, 2, layout_type::column_major> cres;
+        xtensor<double, 2> bres;
+        assign_all(std::tie(cres, bres), std::make_tuple(a - b, a + row), exec::seq);
+        xtensor<double, 2> expected_cres = a - b;
+        xtensor<double, 2> expected_bres = a + row;
+        EXPECT_EQ(cres, expected_cres);
+        EXPECT_EQ(bres, expected_bres);
+    }
+
+#if defined(XTENSOR_ASSIGN_TRACING)
+    TEST(xassign, tracing)
+    {
+        std::vector<assign_tracing::record> records;
+        auto id = assign_tracing::add_callback([&records](const assign_tracing::record& r) { records.push_back(r); });
+
+        xtensor<double, 2> a = arange<double>(24.).reshape({4, 6});
+        xtensor<double, 2> res = zeros<double>({4, 6});
+        noalias(res) = a + 1.;
+        EXPECT_TRUE(records.empty());
+
+        assign_tracing::enable();
+        noalias(res) = a + 1.;
+        EXPECT_EQ(records.size(), std::size_t(1));
+        EXPECT_TRUE(records[0].kind == assign_tracing::strategy::linear_simd
+                    || records[0].kind == assign_tracing::strategy::linear);
+        EXPECT_EQ(records[0].size, std::size_t(24));
+        EXPECT_EQ(records[0].bytes, 24 * sizeof(double));
+        EXPECT_TRUE(records[0].trivial_broadcast);
+        EXPECT_TRUE(*records[0].lhs_type == typeid(res));
+
+        xtensor<double, 2, layout_type::column_major> cres = zeros<double>({4, 6});
+        noalias(cres) = a;
+        EXPECT_EQ(records.size(), std::size_t(2));
+        EXPECT_EQ(std::string(assign_tracing::to_string(records[1].kind)), std::string("tiled"));
+
+        xtensor<double, 2> bres = zeros<double>({4, 6});
+        xtensor<double, 1> row = arange<double>(6.);
+        noalias(bres) = a + row;
+        EXPECT_EQ(records.size(), std::size_t(3));
+        EXPECT_FALSE(records[2].trivial_broadcast);
+        EXPECT_TRUE(records[2].kind == assign_tracing::strategy::strided_loop
+                    || records[2].kind == assign_tracing::strategy::stepper);
+
+        noalias(bres) = flip(a);
+        EXPECT_EQ(records.size(), std::size_t(4));
+        EXPECT_EQ(std::string(assign_tracing::to_string(records[3].kind)), std::string("reversed"));
+
+        assign_tracing::remove_callback(id);
+        noalias(res) = a;
+        EXPECT_EQ(records.size(), std::size_t(4));
+        assign_tracing::disable();
+    }
+#endif
 }
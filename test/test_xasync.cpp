@@ -0,0 +1,126 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <future>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xasync.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xasync, async_assign)
+    {
+        xthread_pool pool(2);
+        xarray<double> a = arange<double>(10000.);
+        xarray<double> b = ones<double>({10000});
+        xarray<double> res;
+
+        std::future<void> f = async_assign(res, a + 2. * b, pool);
+        f.get();
+        EXPECT_EQ(res, a + 2.);
+
+        xtensor<double, 2> t = zeros<double>({4, 5});
+        xarray<double> row = arange<double>(5.);
+        async_assign(view(t, 2, all()), row * 3., pool, exec::seq).get();
+        EXPECT_EQ(xarray<double>(view(t, 2, all())), row * 3.);
+        EXPECT_EQ(t(1, 4), 0.);
+    }
+
+    TEST(xasync, pipeline)
+    {
+        xthread_pool pool(3);
+        std::vector<xarray<double>> chunks;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            chunks.push_back(arange<double>(100.) + double(i));
+        }
+
+        std::vector<xarray<double>> results(chunks.size());
+        std::vector<std::future<void>> futures;
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            futures.push_back(async_assign(results[i], chunks[i] * 2., pool, exec::par(pool)));
+        }
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            futures[i].get();
+            EXPECT_EQ(results[i], chunks[i] * 2.);
+        }
+    }
+
+    TEST(xasync, exception)
+    {
+        xthread_pool pool(1);
+        xarray<double> a = ones<double>({3, 4});
+        xtensor<double, 2> res = zeros<double>({2, 2});
+        std::future<void> f = async_assign(view(res, all(), all()), a, pool);
+        XT_EXPECT_THROW(f.get(), std::runtime_error);
+    }
+
+    TEST(xasync, empty_pool)
+    {
+        xthread_pool pool(0);
+        xarray<int> a = {1, 2, 3};
+        xarray<int> res;
+        std::future<void> f = async_assign(res, a + 1, pool);
+        EXPECT_TRUE(f.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        EXPECT_EQ(res, (xarray<int>{2, 3, 4}));
+    }
+
+#if defined(XTENSOR_HAS_COROUTINES)
+    namespace
+    {
+        struct detached_task
+        {
+            struct promise_type
+            {
+                detached_task get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+
+        detached_task assign_twice(xarray<double>& res, const xarray<double>& a,
+                                   xthread_pool& pool, std::promise<bool>& done)
+        {
+            co_await co_assign(res, a + 1., pool);
+            co_await co_assign(res, res * 2., pool, exec::seq);
+            bool thrown = false;
+            try
+            {
+                co_await co_assign(view(res, range(0, 2)), a, pool);
+            }
+            catch (std::runtime_error&)
+            {
+                thrown = true;
+            }
+            done.set_value(thrown);
+        }
+    }
+
+    TEST(xasync, co_assign)
+    {
+        xthread_pool pool(2);
+        xarray<double> a = arange<double>(1000.);
+        xarray<double> res = zeros<double>({1000});
+        std::promise<bool> done;
+        std::future<bool> f = done.get_future();
+        assign_twice(res, a, pool, done);
+        EXPECT_TRUE(f.get());
+        EXPECT_EQ(res, (a + 1.) * 2.);
+    }
+#endif
+}
@@ -10,6 +10,7 @@
 #include "test_common_macros.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xaxis_iterator.hpp"
+#include "xtensor/xtensor.hpp"
 
 namespace xt
 {
@@ -206,4 +207,20 @@ namespace xt
         EXPECT_EQ(a(1, 1, 3), (*iter)(1, 1));
         EXPECT_EQ(a(1, 2, 3), (*iter)(1, 2));
     }
+
+    TEST(xaxis_iterator, xtensor)
+    {
+        xtensor<int, 3> a = get_test_array();
+        auto iter = axis_begin(a, 1u);
+        auto last = axis_end(a, 1u);
+        EXPECT_EQ(size_t(2), iter->dimension());
+        for (size_t j = 0; j < 3; ++j)
+        {
+            EXPECT_TRUE(iter != last);
+            EXPECT_EQ(a(0, j, 0), (*iter)(0, 0));
+            EXPECT_EQ(a(1, j, 3), (*iter)(1, 3));
+            ++iter;
+        }
+        EXPECT_TRUE(iter == last);
+    }
 }
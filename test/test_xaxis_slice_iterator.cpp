@@ -7,9 +7,12 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <numeric>
+
 #include "test_common_macros.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xaxis_slice_iterator.hpp"
+#include "xtensor/xtensor.hpp"
 
 
 namespace xt
@@ -323,4 +326,49 @@ namespace xt
         EXPECT_EQ(a(1, 2, 2), (*iter)(2));
         EXPECT_EQ(a(1, 2, 3), (*iter)(3));
     }
+
+    template <class E>
+    void check_axis_slices(const E& a, size_t axis)
+    {
+        // The slices start, in memory order, at the elements whose index
+        // along the axis is 0
+        size_t stride = static_cast<size_t>(a.strides()[axis]);
+        size_t axis_shape = a.shape()[axis];
+        auto iter = axis_slice_begin(a, axis);
+        auto last = axis_slice_end(a, axis);
+        size_t count = 0;
+        for (size_t offset = 0; offset < a.size(); ++offset)
+        {
+            if ((offset / stride) % axis_shape == 0)
+            {
+                EXPECT_TRUE(iter != last);
+                EXPECT_EQ(axis_shape, iter->shape()[0]);
+                for (size_t k = 0; k < axis_shape; ++k)
+                {
+                    EXPECT_EQ(a.data()[offset + k * stride], (*iter)(k));
+                }
+                ++iter;
+                ++count;
+            }
+        }
+        EXPECT_TRUE(iter == last);
+        EXPECT_EQ(a.size() / axis_shape, count);
+    }
+
+    TEST(xaxis_slice_iterator, four_dimensions)
+    {
+        xarray<int> a = xarray<int>::from_shape({2, 3, 4, 5});
+        xarray<int, layout_type::column_major> a_col = xarray<int, layout_type::column_major>::from_shape({2, 3, 4, 5});
+        xtensor<int, 4> t = xtensor<int, 4>::from_shape({2, 3, 4, 5});
+        std::iota(a.storage().begin(), a.storage().end(), 0);
+        std::iota(a_col.storage().begin(), a_col.storage().end(), 0);
+        std::iota(t.storage().begin(), t.storage().end(), 0);
+        for (size_t axis = 0; axis < 4; ++axis)
+        {
+            check_axis_slices(a, axis);
+            check_axis_slices(a_col, axis);
+            check_axis_slices(t, axis);
+        }
+        EXPECT_EQ(size_t(1), axis_slice_begin(t, 2)->dimension());
+    }
 }
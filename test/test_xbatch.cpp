@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+#include "xtensor/xbatch.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xbatch, layout)
+    {
+        xtensor<double, 3> aos = arange<double>(5 * 6).reshape({5, 2, 3});
+        auto batch = xbatch<double, xshape<2, 3>>::from_aos(aos);
+        EXPECT_EQ(batch.size(), std::size_t(5));
+        EXPECT_EQ(batch.soa().shape()[2], std::size_t(5));
+        EXPECT_EQ(batch.soa()(1, 2, 3), aos(3, 1, 2));
+        EXPECT_EQ(batch.to_aos(), aos);
+
+        auto item = batch.get(4);
+        EXPECT_EQ(item, (view(aos, 4, all(), all())));
+        item(0, 1) = -1.;
+        batch.set(2, item);
+        EXPECT_EQ(batch.get(2), item);
+        XT_EXPECT_THROW(batch.get(5), std::out_of_range);
+
+        xbatch<double, xshape<2, 3>> twice(2. * batch.soa());
+        EXPECT_EQ(twice.get(2), 2. * item);
+        XT_EXPECT_THROW((xbatch<double, xshape<3, 2>>(batch.soa())), std::runtime_error);
+    }
+
+    TEST(xbatch, kernels)
+    {
+        std::size_t n = 37;
+        xtensor<double, 3> a = arange<double>(n * 9.).reshape({n, 3, 3});
+        xtensor<double, 3> b = arange<double>(n * 6.).reshape({n, 3, 2});
+        xtensor<double, 2> v = arange<double>(n * 3.).reshape({n, 3});
+
+        auto ba = xbatch<double, xshape<3, 3>>::from_aos(a);
+        auto bb = xbatch<double, xshape<3, 2>>::from_aos(b);
+        auto bv = xbatch<double, xshape<3>>::from_aos(v);
+        auto prod = batch_matmul(ba, bb);
+        auto mv = batch_matmul(ba, bv);
+        auto det3 = batch_det(ba);
+
+        xbatch<double, xshape<2, 2>> sq(view(ba.soa(), range(0, 2), range(0, 2), all()));
+        auto det2 = batch_det(sq);
+
+        for (std::size_t t = 0; t < n; ++t)
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                double acc_v = 0.;
+                for (std::size_t l = 0; l < 3; ++l)
+                {
+                    acc_v += a(t, i, l) * v(t, l);
+                }
+                EXPECT_EQ(mv.get(t)(i), acc_v);
+                for (std::size_t j = 0; j < 2; ++j)
+                {
+                    double acc = 0.;
+                    for (std::size_t l = 0; l < 3; ++l)
+                    {
+                        acc += a(t, i, l) * b(t, l, j);
+                    }
+                    EXPECT_EQ(prod.get(t)(i, j), acc);
+                }
+            }
+            double d3 = a(t, 0, 0) * (a(t, 1, 1) * a(t, 2, 2) - a(t, 1, 2) * a(t, 2, 1))
+                      - a(t, 0, 1) * (a(t, 1, 0) * a(t, 2, 2) - a(t, 1, 2) * a(t, 2, 0))
+                      + a(t, 0, 2) * (a(t, 1, 0) * a(t, 2, 1) - a(t, 1, 1) * a(t, 2, 0));
+            EXPECT_EQ(det3(t), d3);
+            EXPECT_EQ(det2(t), a(t, 0, 0) * a(t, 1, 1) - a(t, 0, 1) * a(t, 1, 0));
+        }
+
+        XT_EXPECT_THROW(batch_matmul(ba, xbatch<double, xshape<3>>(n + 1)), std::runtime_error);
+    }
+}
@@ -0,0 +1,169 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbit_vector.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xindex_view.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xoperation.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xbit_vector, access)
+    {
+        xbit_vector<> v(70, true);
+        EXPECT_EQ(v.block_count(), 2u);
+        EXPECT_EQ(v.count(), 70u);
+        EXPECT_EQ(v.blocks()[1], 0x3fu);
+
+        v[3] = false;
+        v[69].flip();
+        EXPECT_FALSE(v[3]);
+        EXPECT_FALSE(v[69]);
+        EXPECT_EQ(v.count(), 68u);
+
+        v.resize(130);
+        EXPECT_EQ(v.count(), 68u);
+        EXPECT_FALSE(v[129]);
+        std::fill(v.begin() + 64, v.end(), true);
+        EXPECT_EQ(std::count(v.cbegin(), v.cend(), true), 129);
+
+        xbit_vector<> w = {true, false, true};
+        EXPECT_EQ(w.size(), 3u);
+        EXPECT_TRUE(w == xbit_vector<>({true, false, true}));
+        swap(w[0], w[1]);
+        EXPECT_FALSE(w[0]);
+        EXPECT_TRUE(w[1]);
+    }
+
+    TEST(xbit_vector, bit_array)
+    {
+        xarray<double> a = arange<double>(150.);
+        a.reshape({10, 15});
+        xbit_array<> mask = a > 40. && a < 120.;
+        EXPECT_EQ(mask.shape(), a.shape());
+        EXPECT_EQ(mask.storage().block_count(), 3u);
+        EXPECT_TRUE(mask(2, 11));
+        EXPECT_FALSE(mask(2, 10));
+
+        EXPECT_EQ(count_nonzero(mask)(), 79u);
+        EXPECT_EQ(count_nonzero(mask, {1})(2), 4u);
+
+        xarray<double> f = filter(a, mask);
+        EXPECT_EQ(f.size(), 79u);
+        EXPECT_EQ(f(0), 41.);
+        EXPECT_EQ(f(78), 119.);
+        EXPECT_EQ(argwhere(mask), argwhere(a > 40. && a < 120.));
+
+        xbit_array<layout_type::column_major> cmask = mask;
+        EXPECT_EQ(argwhere(cmask), argwhere(mask));
+        EXPECT_EQ(cmask, mask);
+
+        // Element-wise operations and views
+        xarray<bool> inverted = !mask;
+        EXPECT_EQ(std::count(inverted.cbegin(), inverted.cend(), true), 71);
+        mask(0, 0) = true;
+        view(mask, 9, all()) = true;
+        EXPECT_EQ(count_nonzero(mask)(), 95u);
+        xarray<double> w = where(mask, a, -1.);
+        EXPECT_EQ(w(0, 0), 0.);
+        EXPECT_EQ(w(0, 1), -1.);
+
+        // Parallel assignment packs whole blocks
+        xthread_pool pool(3);
+        xarray<double> big = arange<double>(10000.);
+        xbit_array<> big_mask(big.shape());
+        noalias(big_mask) = big < 6543.;
+        EXPECT_EQ(count_nonzero(big_mask)(), 6543u);
+        xbit_array<> par_mask(big.shape());
+        noalias(par_mask).assign(big < 6543., exec::par(pool, 0, 100));
+        EXPECT_EQ(par_mask, big_mask);
+    }
+    TEST(xbit_vector, bitmap)
+    {
+        // Arrow validity bitmap of 20 elements, the least significant bit first
+        std::vector<std::uint8_t> bitmap = {0xb5, 0x0f, 0x3a};
+        xbit_vector<> v(20);
+        load_bitmap(v, bitmap.data());
+        EXPECT_TRUE(v[0]);
+        EXPECT_FALSE(v[1]);
+        EXPECT_TRUE(v[7]);
+        EXPECT_TRUE(v[11]);
+        EXPECT_FALSE(v[12]);
+        EXPECT_FALSE(v[16]);
+        EXPECT_TRUE(v[17]);
+        EXPECT_EQ(v.count(), 11u);
+
+        std::vector<std::uint8_t> out(3, 0xff);
+        store_bitmap(v, out.data());
+        EXPECT_EQ(out[0], 0xb5);
+        EXPECT_EQ(out[1], 0x0f);
+        EXPECT_EQ(out[2], 0x0a);
+
+        // A slice starting at a bit offset, over several blocks
+        std::vector<std::uint8_t> large(40);
+        for (std::size_t j = 0; j < large.size(); ++j)
+        {
+            large[j] = static_cast<std::uint8_t>(j * 37 + 11);
+        }
+        xbit_vector<> w(250);
+        load_bitmap(w, large.data(), 13);
+        bool same = true;
+        for (std::size_t i = 0; i < w.size(); ++i)
+        {
+            std::size_t k = i + 13;
+            same = same && w[i] == (((large[k / 8] >> (k % 8)) & 1u) != 0u);
+        }
+        EXPECT_TRUE(same);
+        EXPECT_EQ(w.blocks()[3] >> (250 - 192), 0u);
+    }
+
+    TEST(xbit_vector, bitmap_adaptor)
+    {
+        std::vector<std::uint8_t> bitmap = {0xb5, 0x0f, 0x3a};
+        xbitmap_adaptor<> a(bitmap.data(), 20, 3);
+        EXPECT_EQ(a.size(), 20u);
+        EXPECT_EQ(a.count(), 11u);
+        EXPECT_FALSE(a[0]);
+        EXPECT_TRUE(a[1]);
+        EXPECT_TRUE(a[5]);
+        EXPECT_FALSE(a.back());
+        EXPECT_EQ(std::count(a.cbegin(), a.cend(), true), 11);
+        XT_EXPECT_THROW(a.resize(21), std::runtime_error);
+
+        // The adaptor can be the storage of an xarray_adaptor, writes go
+        // to the adapted bitmap
+        using array_type = xarray_adaptor<xbitmap_adaptor<>, layout_type::row_major, std::vector<std::size_t>>;
+        array_type arr(a, std::vector<std::size_t>{4, 5});
+        EXPECT_TRUE(arr(0, 1));
+        EXPECT_FALSE(arr(3, 4));
+        arr = zeros<bool>({4, 5});
+        EXPECT_EQ(bitmap[0], 0x05);
+        EXPECT_EQ(bitmap[1], 0x00);
+        EXPECT_EQ(bitmap[2], 0x00);
+        arr(1, 2) = true;
+        EXPECT_EQ(bitmap[1], 0x04);
+
+        const std::vector<std::uint8_t> read_only = {0xff, 0x01};
+        xbitmap_adaptor<const std::uint8_t> r(read_only.data(), 9);
+        EXPECT_EQ(r.count(), 9u);
+        EXPECT_TRUE(*r.crbegin());
+    }
+
+}
@@ -171,6 +171,16 @@ TEST_SUITE("xblockwise_reducer")
                         CHECK_EQ(result, should_result);
                     }
                 }
+
+                SUBCASE("parallel assign")
+                {
+                    auto result = xarray<result_value_type>::from_shape(reducer.shape());
+                    auto par_result = xarray<result_value_type>::from_shape(reducer.shape());
+                    xthread_pool pool(3);
+                    reducer.assign_to(result);
+                    reducer.assign_to(par_result, xt::exec::par(pool));
+                    CHECK_EQ(par_result, result);
+                }
             }
         }
 
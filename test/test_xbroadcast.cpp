@@ -8,9 +8,12 @@
 ****************************************************************************/
 
 
+#include <utility>
+
 #include "test_common.hpp"
 #include "xtensor/xbroadcast.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 
 namespace xt
 {
@@ -190,4 +193,30 @@ namespace xt
         EXPECT_EQ(cm_arr(1, 1), 11.0);
         EXPECT_EQ(cm_arr(1, 2), 12.0);
     }
+
+    TEST(xbroadcast, simd)
+    {
+        using array_type = xarray<double>;
+        EXPECT_TRUE((has_simd_interface<decltype(ones<double>({2, 3}))>::value));
+        EXPECT_TRUE((has_simd_interface<decltype(broadcast(std::declval<const array_type&>(), {2, 3}))>::value));
+
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> row = {10., 20., 30.};
+        xarray<double> col = {{100.}, {200.}};
+        xarray<double> expected = {{2., 3., 4.}, {5., 6., 7.}};
+
+        xarray<double> r1 = a + ones<double>({2, 3});
+        EXPECT_EQ(r1, expected);
+
+        xarray<double> r2 = a + broadcast(row, {2, 3}) + broadcast(col, {2, 3});
+        xarray<double> e2 = {{111., 222., 333.}, {114., 225., 336.}};
+        EXPECT_EQ(r2, e2);
+
+        xarray<double> r3 = 2. * broadcast(a, {2, 3}) - a;
+        EXPECT_EQ(r3, a);
+
+        xarray<double, layout_type::column_major> r4 = a * broadcast(row, {2, 3});
+        xarray<double> e4 = {{10., 40., 90.}, {40., 100., 180.}};
+        EXPECT_EQ(r4, e4);
+    }
 }
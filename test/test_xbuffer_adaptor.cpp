@@ -217,4 +217,38 @@ namespace xt
 
         delete[] data;
     }
+
+    TEST(xshared_buffer, copy_on_write)
+    {
+        using buffer_type = xshared_buffer<double>;
+        buffer_type a(4, 1.);
+        const buffer_type& ca = a;
+        buffer_type b = a;
+        EXPECT_EQ(a.use_count(), 2u);
+        EXPECT_EQ(ca.data(), static_cast<const buffer_type&>(b).data());
+
+        b[2] = 3.;
+        EXPECT_TRUE(a.unique());
+        EXPECT_TRUE(b.unique());
+        EXPECT_EQ(ca[2], 1.);
+        EXPECT_EQ(b[2], 3.);
+
+        buffer_type c = b;
+        c.resize(2);
+        EXPECT_EQ(c.size(), 2u);
+        EXPECT_EQ(b.size(), 4u);
+        EXPECT_EQ(c[1], 1.);
+
+        buffer_type d = std::move(b);
+        EXPECT_EQ(b.size(), 0u);
+        EXPECT_EQ(d[2], 3.);
+        d = a;
+        EXPECT_EQ(a.use_count(), 2u);
+        d = buffer_type();
+        EXPECT_TRUE(a.unique());
+
+        buffer_type e(uvector<double>(3, 2.));
+        EXPECT_EQ(e.size(), 3u);
+        EXPECT_TRUE(e == buffer_type({2., 2., 2.}));
+    }
 }
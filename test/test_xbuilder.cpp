@@ -16,6 +16,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
+#include "xtensor/xview.hpp"
 
 #include "xtensor/xio.hpp"
 #include <sstream>
@@ -317,6 +318,48 @@ namespace xt
         ASSERT_EQ(m_assigned(3), 1000);
     }
 
+    TEST(xbuilder, linear_generator)
+    {
+        auto ls = linspace<double>(0., 3., 101);
+        using ls_type = decltype(ls);
+        EXPECT_TRUE(ls_type::contiguous_layout);
+        EXPECT_TRUE(ls.is_contiguous());
+        EXPECT_TRUE(ls.has_linear_assign(std::array<std::ptrdiff_t, 1>({1})));
+        using reshaped_type = decltype(arange<double>(6).reshape({2, 3}));
+        EXPECT_FALSE(reshaped_type::contiguous_layout);
+        for (std::size_t i = 0; i < ls.size(); ++i)
+        {
+            EXPECT_EQ(ls.data_element(i), ls(i));
+        }
+
+        xtensor<double, 1> s = sin(ls) * 2.;
+        for (std::size_t i = 0; i < s.size(); ++i)
+        {
+            EXPECT_EQ(s(i), std::sin(ls(i)) * 2.);
+        }
+        EXPECT_EQ(s(100), std::sin(3.) * 2.);
+
+        xtensor<float, 1> f = linspace<float>(-1.f, 1.f, 37) + 1.f;
+        xtensor<double, 1, layout_type::column_major> c = arange<double>(-2., 5., 0.25) * 3.;
+        auto fl = linspace<float>(-1.f, 1.f, 37);
+        auto ar = arange<double>(-2., 5., 0.25);
+        for (std::size_t i = 0; i < f.size(); ++i)
+        {
+            EXPECT_EQ(f(i), fl(i) + 1.f);
+        }
+        for (std::size_t i = 0; i < c.size(); ++i)
+        {
+            EXPECT_EQ(c(i), ar(i) * 3.);
+        }
+
+        xarray<double> b({3, 28}, 1.);
+        xarray<double> res = b + ar;
+        EXPECT_EQ(res(2, 27), ar(27) + 1.);
+
+        xarray<double> lg = logspace(0., 3., 7);
+        EXPECT_EQ(lg(6), std::pow(10., 3.));
+    }
+
     TEST(xbuilder, eye)
     {
         auto e = eye(5);
@@ -516,6 +559,109 @@ namespace xt
         EXPECT_EQ(c2, e2);
     }
 
+    namespace
+    {
+        // Compares the result of an assignment to the values read from
+        // the generator element by element
+        template <class R, class G>
+        bool equal_to_generator(const R& res, const G& gen)
+        {
+            return std::equal(res.shape().cbegin(), res.shape().cend(), gen.shape().cbegin(), gen.shape().cend()) &&
+                   std::equal(res.cbegin(), res.cend(), gen.cbegin());
+        }
+    }
+
+    TEST(xbuilder, concatenate_assign)
+    {
+        xarray<double> a = arange<double>(24).reshape({2, 3, 4});
+        xtensor<int, 3> b = arange<int>(100, 118).reshape({2, 3, 3});
+        xarray<double, layout_type::column_major> c = arange<double>(-8, 0).reshape({2, 1, 4});
+
+        auto ca0 = concatenate(xtuple(a, a + 1.0), 0);
+        xarray<double> r0 = ca0;
+        EXPECT_TRUE(equal_to_generator(r0, ca0));
+
+        auto ca1 = concatenate(xtuple(a, c, view(a, all(), range(0, 2))), 1);
+        xtensor<double, 3> r1 = ca1;
+        EXPECT_TRUE(equal_to_generator(r1, ca1));
+        xarray<double, layout_type::column_major> r1c = ca1;
+        EXPECT_TRUE(equal_to_generator(r1c, ca1));
+
+        auto ca2 = concatenate(xtuple(view(a, all(), all(), range(0, 3)), b, transpose(transpose(b))), 2);
+        xarray<double> r2 = ca2;
+        EXPECT_TRUE(equal_to_generator(r2, ca2));
+
+        auto sa = stack(xtuple(a, a * 2.0, a - 3.0), 1);
+        xarray<double> s1 = sa;
+        EXPECT_TRUE(equal_to_generator(s1, sa));
+        auto sb = stack(xtuple(arange(3), arange(3, 6)), 1);
+        xtensor<int, 2> s2 = sb;
+        EXPECT_TRUE(equal_to_generator(s2, sb));
+
+        xarray<int> va = arange(3);
+        xarray<int> v0 = vstack(xtuple(va, va + 3));
+        xarray<int> ev0 = {{0, 1, 2}, {3, 4, 5}};
+        EXPECT_EQ(v0, ev0);
+        xarray<int> v1 = vstack(xtuple(b, b));
+        EXPECT_TRUE(equal_to_generator(v1, vstack(xtuple(b, b))));
+        xarray<int> h = hstack(xtuple(b, b));
+        EXPECT_TRUE(equal_to_generator(h, hstack(xtuple(b, b))));
+
+        xarray<double> r3;
+        r3 = concatenate(xtuple(a, a), 2);
+        EXPECT_TRUE(equal_to_generator(r3, concatenate(xtuple(a, a), 2)));
+    }
+
+    TEST(xbuilder, concatenate_vector)
+    {
+        std::vector<xarray<double>> v = {arange<double>(6).reshape({2, 3}),
+                                         arange<double>(6, 9).reshape({1, 3}),
+                                         xarray<double>::from_shape({0, 3}),
+                                         arange<double>(9, 15).reshape({2, 3})};
+        auto c = concatenate(v);
+        xarray<double> expected = arange<double>(15).reshape({5, 3});
+        EXPECT_EQ(c, expected);
+        xarray<double> r = c;
+        EXPECT_EQ(r, expected);
+        EXPECT_EQ(c(2, 1), 7.);
+        xarray<double, layout_type::column_major> rc = concatenate(v);
+        EXPECT_EQ(rc, expected);
+
+        std::vector<xtensor<int, 2>> w = {{{1, 2}, {3, 4}}, {{5}, {6}}};
+        xtensor<int, 2> rw = concatenate(std::move(w), 1);
+        xtensor<int, 2> ew = {{1, 2, 5}, {3, 4, 6}};
+        EXPECT_EQ(rw, ew);
+
+        std::vector<xarray<double>> empty;
+        XT_EXPECT_THROW(concatenate(empty), std::runtime_error);
+        XT_EXPECT_THROW(concatenate(v, 2), std::runtime_error);
+        v.push_back(ones<double>({2, 2}));
+        XT_EXPECT_ANY_THROW(concatenate(v));
+    }
+
+    TEST(xbuilder, stack_vector)
+    {
+        std::vector<xtensor<double, 1>> v = {{1, 2, 3}, {4, 5, 6}};
+        auto s0 = stack(v);
+        xtensor<double, 2> e0 = {{1, 2, 3}, {4, 5, 6}};
+        EXPECT_EQ(s0, e0);
+        xtensor<double, 2> r0 = s0;
+        EXPECT_EQ(r0, e0);
+
+        xtensor<double, 2> r1 = stack(v, 1);
+        xtensor<double, 2> e1 = {{1, 4}, {2, 5}, {3, 6}};
+        EXPECT_EQ(r1, e1);
+        EXPECT_EQ(stack(v, 1), e1);
+
+        std::vector<xarray<int>> w = {{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}, {{9, 10}, {11, 12}}};
+        xarray<int> r2 = stack(w, 2);
+        EXPECT_TRUE(equal_to_generator(r2, stack(xtuple(w[0], w[1], w[2]), 2)));
+
+        XT_EXPECT_THROW(stack(v, 3), std::runtime_error);
+        v.push_back({1, 2});
+        XT_EXPECT_ANY_THROW(stack(v));
+    }
+
     TEST(xbuilder, meshgrid)
     {
         auto mesh = meshgrid(linspace<double>(0.0, 1.0, 3), linspace<double>(0.0, 1.0, 2));
@@ -701,4 +847,24 @@ namespace xt
         b = std::is_same<decltype(ed3), xarray<double>>::value;
         EXPECT_TRUE(b);
     }
+
+    TEST(xbuilder, empty_like)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        auto ea = empty_like(a);
+        bool b = std::is_same<decltype(ea), xarray<double>>::value;
+        EXPECT_TRUE(b);
+        EXPECT_EQ(ea.shape(), a.shape());
+
+        xtensor<int, 2, layout_type::column_major> t = {{1, 2}, {3, 4}};
+        auto et = empty_like(t);
+        b = std::is_same<decltype(et), xtensor<int, 2, layout_type::column_major>>::value;
+        EXPECT_TRUE(b);
+        EXPECT_EQ(et.shape(), t.shape());
+
+        xtensor_fixed<double, xshape<2, 3>> f = a;
+        auto ef = empty_like(f);
+        b = std::is_same<decltype(ef), xtensor_fixed<double, xshape<2, 3>>>::value;
+        EXPECT_TRUE(b);
+    }
 }
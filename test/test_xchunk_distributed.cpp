@@ -0,0 +1,180 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include <vector>
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunk_distributed.hpp"
+#include "xtensor/xstrided_view.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        using mailbox_type = std::vector<std::vector<std::vector<double>>>;
+
+        // Process of rank r of n, the processes being run one after the
+        // other: the messages sent by a process are kept in a mailbox, and
+        // received by the next exchanges of the processes they are sent to
+        class xtest_communicator
+        {
+        public:
+
+            xtest_communicator(std::size_t r, std::size_t n, mailbox_type* mailbox = nullptr)
+                : m_rank(r), m_size(n), p_mailbox(mailbox)
+            {
+            }
+
+            std::size_t rank() const noexcept
+            {
+                return m_rank;
+            }
+
+            std::size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+            template <class T>
+            void allreduce(T*, std::size_t, xreduce_op) const noexcept
+            {
+            }
+
+            void exchange(const std::vector<std::vector<double>>& send, std::vector<std::vector<double>>& recv) const
+            {
+                for (std::size_t q = 0; q < m_size; ++q)
+                {
+                    (*p_mailbox)[m_rank][q] = send[q];
+                    const auto& received = (*p_mailbox)[q][m_rank];
+                    if (received.size() == recv[q].size())
+                    {
+                        recv[q] = received;
+                    }
+                }
+            }
+
+        private:
+
+            std::size_t m_rank;
+            std::size_t m_size;
+            mailbox_type* p_mailbox;
+        };
+
+        xarray<double> distributed_test_array()
+        {
+            return reshape_view(arange<double>(10 * 7), {10, 7});
+        }
+    }
+
+    TEST(xchunk_distributed, local)
+    {
+        xarray<double> e = distributed_test_array();
+        auto a = chunked_distributed_array<double>({10, 7}, {3, 4});
+        EXPECT_EQ(a.chunks().local_begin(), 0u);
+        EXPECT_EQ(a.chunks().local_end(), a.grid_size());
+
+        a = e;
+        EXPECT_TRUE(a == e);
+        a += 1.;
+        EXPECT_TRUE(a == e + 1.);
+        a = 2. * a - 2.;
+        EXPECT_TRUE(a == 2. * e);
+
+        EXPECT_EQ(distributed_reduce(a, xreduce_op::sum), sum(2. * e)());
+        EXPECT_EQ(distributed_reduce(a, xreduce_op::max), amax(2. * e)());
+        std::vector<std::size_t> axes = {0};
+        xarray<double> expected = sum(2. * e, axes);
+        EXPECT_EQ(distributed_reduce(a, axes, xreduce_op::sum), expected);
+        axes = {1};
+        expected = amin(2. * e, axes);
+        EXPECT_EQ(distributed_reduce(a, axes, xreduce_op::min), expected);
+    }
+
+    TEST(xchunk_distributed, owner_computes)
+    {
+        xarray<double> e = distributed_test_array();
+        std::vector<std::size_t> axes = {1};
+        xarray<double> row_sums = zeros<double>({10});
+        double total = 0.;
+        std::size_t nb_local = 0;
+        for (std::size_t r = 0; r < 3; ++r)
+        {
+            // 4 x 2 chunks split into 2, 3 and 3 chunks
+            auto a = chunked_distributed_array<double>({10, 7}, {3, 4}, xtest_communicator(r, 3));
+            auto b = chunked_distributed_array<double>({10, 7}, {3, 4}, xtest_communicator(r, 3));
+            const auto& store = a.chunks();
+            EXPECT_EQ(store.local_begin(), r == 0 ? 0u : 3u * r - 1u);
+            for (std::size_t i = 0; i < store.size(); ++i)
+            {
+                EXPECT_EQ(store.owner(i) == r, store.is_local(i));
+            }
+            nb_local += store.local_end() - store.local_begin();
+
+            a = e;
+            b = 2. * a;
+            b -= a;
+            std::size_t i = 0;
+            for (auto it = b.chunk_begin(); it != b.chunk_end(); ++it, ++i)
+            {
+                if (store.is_local(i))
+                {
+                    EXPECT_TRUE(strided_view(*it, it.get_chunk_slice_vector()) == strided_view(e, it.get_slice_vector()));
+                }
+            }
+            if (r != 0)
+            {
+                XT_EXPECT_THROW(a(0, 0) = 1., std::runtime_error);
+            }
+
+            row_sums += distributed_reduce(b, axes, xreduce_op::sum);
+            total += distributed_reduce(b, xreduce_op::sum);
+        }
+        EXPECT_EQ(nb_local, 8u);
+        xarray<double> expected = sum(e, axes);
+        EXPECT_EQ(row_sums, expected);
+        EXPECT_EQ(total, sum(e)());
+    }
+
+    TEST(xchunk_distributed, halo_exchange)
+    {
+        xarray<double> e = distributed_test_array();
+        auto reference = chunked_array(e, std::vector<std::size_t>({3, 4}));
+        std::vector<xarray<double>> expected;
+        for_each_chunk_with_halo(reference, 1, [&](const xarray<double>& block, const std::vector<std::size_t>&) {
+            expected.push_back(block);
+        }, pad_mode::wrap);
+
+        // Each process sends its halos in the first round, and receives
+        // those of the others in the second one
+        std::size_t n = 3;
+        mailbox_type mailbox(n, std::vector<std::vector<double>>(n));
+        std::vector<xarray<double>> blocks;
+        for (std::size_t round = 0; round < 2; ++round)
+        {
+            for (std::size_t r = 0; r < n; ++r)
+            {
+                auto a = chunked_distributed_array<double>({10, 7}, {3, 4}, xtest_communicator(r, n, &mailbox));
+                a = e;
+                for_each_local_chunk_with_halo(a, 1, [&](const xarray<double>& block, const std::vector<std::size_t>&) {
+                    if (round == 1)
+                    {
+                        blocks.push_back(block);
+                    }
+                }, pad_mode::wrap);
+            }
+        }
+        EXPECT_EQ(blocks.size(), expected.size());
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            EXPECT_EQ(blocks[i], expected[i]);
+        }
+    }
+}
@@ -0,0 +1,239 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include <cstdio>
+
+#include "xtensor/xbroadcast.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunk_store.hpp"
+#include "xtensor/xstrided_view.hpp"
+
+namespace xt
+{
+    TEST(xchunk_store, indexed_access)
+    {
+        std::string path = "test_xchunk_store_0.bin";
+        std::remove(path.c_str());
+        {
+            auto a = chunked_file_array<double>(path, {10, 10, 10}, {2, 3, 4}, 2);
+            EXPECT_EQ(a.chunks().cache_size(), 2u);
+            EXPECT_EQ(a(3, 9, 8), 0.);
+            a(3, 9, 8) = 1.;
+            a(0, 0, 0) = 2.;
+            a(9, 0, 0) = 3.;
+            EXPECT_EQ(a(3, 9, 8), 1.);
+            EXPECT_EQ(a(0, 0, 0), 2.);
+            EXPECT_EQ(a(9, 0, 0), 3.);
+
+            std::vector<size_t> idx = {3, 9, 8};
+            a[idx] = 4.;
+            EXPECT_EQ(a[idx], 4.);
+        }
+        {
+            // The chunks written back are read again
+            auto a = chunked_file_array<double>(path, {10, 10, 10}, {2, 3, 4}, 3);
+            EXPECT_EQ(a(3, 9, 8), 4.);
+            EXPECT_EQ(a(0, 0, 0), 2.);
+            EXPECT_EQ(a(9, 0, 0), 3.);
+            EXPECT_EQ(a(5, 5, 5), 0.);
+        }
+        std::remove(path.c_str());
+    }
+
+    TEST(xchunk_store, assign_expression)
+    {
+        std::string path = "test_xchunk_store_1.bin";
+        std::remove(path.c_str());
+        {
+            std::vector<size_t> shape = {13, 7, 5};
+            std::vector<size_t> chunk_shape = {4, 3, 2};
+            auto a = chunked_file_array<int>(path, shape, chunk_shape, 2);
+            xarray<int> e = reshape_view(arange<int>(13 * 7 * 5), {13, 7, 5});
+            a = e;
+            EXPECT_TRUE(a == e);
+
+            a += a;
+            EXPECT_TRUE(a == 2 * e);
+
+            a += 1;
+            EXPECT_TRUE(a == 2 * e + 1);
+
+            a = broadcast(5, a.shape());
+            for (const auto& v : a)
+            {
+                EXPECT_EQ(v, 5);
+            }
+            a.chunks().flush();
+
+            // The chunks of the file are assigned sequentially
+            xthread_pool pool(2);
+            a.assign(e, exec::par(pool));
+            EXPECT_TRUE(a == e);
+
+            XT_EXPECT_THROW(a = xarray<int>::from_shape({2, 2}), std::runtime_error);
+        }
+        std::remove(path.c_str());
+    }
+
+    TEST(xchunk_store, rle_codec)
+    {
+        std::vector<char> src;
+        for (int i = 0; i < 1000; ++i)
+        {
+            src.push_back(static_cast<char>(i % 7 == 0 ? 0 : i));
+        }
+        src.insert(src.end(), 300, 'x');
+        src.insert(src.end(), {'a', 'b', 'b', 'c', 'c', 'c'});
+
+        xchunk_rle_codec codec;
+        std::vector<char> compressed;
+        codec.compress(src.data(), src.size(), compressed);
+        std::vector<char> dst(src.size());
+        codec.decompress(compressed.data(), compressed.size(), dst.data(), dst.size());
+        EXPECT_EQ(dst, src);
+        XT_EXPECT_THROW(codec.decompress(compressed.data(), compressed.size() - 1, dst.data(), dst.size()), std::runtime_error);
+    }
+
+    TEST(xchunk_store, compressed)
+    {
+        std::vector<size_t> shape = {64, 64};
+        std::vector<size_t> chunk_shape = {16, 16};
+        auto a = chunked_compressed_array<double>(shape, chunk_shape, 2);
+        EXPECT_TRUE(a.chunks().shuffle());
+
+        // Sparse data
+        xarray<double> e = zeros<double>({64, 64});
+        for (size_t i = 0; i < 64; i += 5)
+        {
+            e(i, (7 * i) % 64) = 0.5 * static_cast<double>(i) + 1.;
+        }
+        a = e;
+        a.chunks().flush();
+        EXPECT_TRUE(a == e);
+        EXPECT_LT(a.chunks().compressed_size(), 64 * 64 * sizeof(double) / 5);
+
+        a += 1.;
+        EXPECT_TRUE(a == e + 1.);
+
+        auto b = chunked_compressed_array<int>({10, 10}, {4, 4}, 3, false);
+        b(9, 9) = 3;
+        b(0, 0) = -1;
+        b(5, 5) = 2;
+        EXPECT_EQ(b(9, 9), 3);
+        EXPECT_EQ(b(0, 0), -1);
+        EXPECT_EQ(b(5, 5), 2);
+        EXPECT_EQ(b(1, 1), 0);
+
+#if defined(XTENSOR_USE_ZLIB)
+        auto z = chunked_compressed_array<float, xchunk_zlib_codec>({100}, {10}, 2, true, xchunk_zlib_codec{6});
+        xarray<float> ze = arange<float>(100.f);
+        z = ze;
+        z.chunks().flush();
+        EXPECT_TRUE(z == ze);
+#endif
+    }
+
+    TEST(xchunk_store, prefetch)
+    {
+        std::string path = "test_xchunk_store_2.bin";
+        std::remove(path.c_str());
+        {
+            std::vector<size_t> shape = {13, 7, 5};
+            std::vector<size_t> chunk_shape = {4, 3, 2};
+            auto a = chunked_file_array<int>(path, shape, chunk_shape, 2);
+            a.chunks().set_prefetch_depth(2);
+            EXPECT_EQ(a.chunks().prefetch_depth(), 2u);
+            xarray<int> e = reshape_view(arange<int>(13 * 7 * 5), {13, 7, 5});
+            a = e;
+            EXPECT_TRUE(a == e);
+
+            // The chunks read ahead are read again after being written
+            a += a;
+            a += 1;
+            EXPECT_TRUE(a == 2 * e + 1);
+
+            auto b = std::move(a);
+            b += 1;
+            b.chunks().resize(b.chunks().shape());
+            EXPECT_TRUE(b == 2 * e + 2);
+        }
+        std::remove(path.c_str());
+
+        auto c = chunked_compressed_array<double>({64, 64}, {8, 8}, 2);
+        c.chunks().set_prefetch_depth(3);
+        xarray<double> e = reshape_view(arange<double>(64. * 64.), {64, 64});
+        c = e;
+        c += e;
+        EXPECT_TRUE(c == 2. * e);
+    }
+
+    TEST(xchunk_store, sparse)
+    {
+        auto a = chunked_sparse_array<double>({1000, 1000, 1000}, {100, 100, 100}, 1.5);
+        EXPECT_EQ(a.chunks().size(), 1000u);
+        EXPECT_EQ(a.chunks().materialized_size(), 0u);
+
+        const auto& ca = a;
+        EXPECT_EQ(ca(999, 0, 500), 1.5);
+        EXPECT_EQ(a.chunks().materialized_size(), 0u);
+
+        a(999, 0, 500) = 2.;
+        a(0, 0, 0) = -1.;
+        EXPECT_EQ(a.chunks().materialized_size(), 2u);
+        EXPECT_EQ(ca(999, 0, 500), 2.);
+        EXPECT_EQ(ca(999, 0, 501), 1.5);
+        EXPECT_EQ(ca(0, 0, 0), -1.);
+
+        // The reductions do not allocate the chunks
+        EXPECT_EQ(sum(a)(), 1.5 * 1e9 - 1.5 + 2. - 1.5 - 1.);
+        EXPECT_EQ(amin(a)(), -1.);
+        EXPECT_EQ(a.chunks().materialized_size(), 2u);
+
+        a.chunks().release(0);
+        EXPECT_EQ(ca(0, 0, 0), 1.5);
+
+        auto b = chunked_sparse_array<int>({10, 7}, {4, 4});
+        xarray<int> e = arange<int>(70).reshape({10, 7});
+        b = e;
+        EXPECT_EQ(b.chunks().materialized_size(), 6u);
+        EXPECT_TRUE(b == e);
+        xarray<int> s0 = sum(b, {0});
+        EXPECT_EQ(s0, xarray<int>(sum(e, {0})));
+
+        auto c = b;
+        c(0, 0) = 5;
+        EXPECT_EQ(b(0, 0), 0);
+
+        // Assigning another shape keeps the chunk shape and the fill value
+        b = xt::ones<int>({3, 3});
+        EXPECT_EQ(b.chunks().chunk_shape()[0], 4u);
+        EXPECT_TRUE(b == xt::ones<int>({3, 3}));
+    }
+
+    TEST(xchunk_store, rechunk)
+    {
+        std::string src_path = "test_xchunk_store_rechunk_src.bin";
+        std::string dst_path = "test_xchunk_store_rechunk_dst.bin";
+        std::remove(src_path.c_str());
+        std::remove(dst_path.c_str());
+        {
+            std::vector<std::size_t> shape = {30, 40};
+            xt::xarray<int> b = arange<int>(30 * 40).reshape({30, 40});
+            auto src = chunked_file_array<int>(src_path, std::vector<std::size_t>(shape), std::vector<std::size_t>{1, 40}, 2);
+            src = b;
+            auto dst = chunked_file_array<int>(dst_path, std::vector<std::size_t>(shape), std::vector<std::size_t>{30, 3}, 2);
+            rechunk(src, dst, 200 * sizeof(int));
+            EXPECT_TRUE(dst == b);
+        }
+        std::remove(src_path.c_str());
+        std::remove(dst_path.c_str());
+    }
+}
@@ -12,6 +12,7 @@
 #include "xtensor/xbroadcast.hpp"
 #include "xtensor/xchunked_array.hpp"
 #include "xtensor/xcsv.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xnoalias.hpp"
 
 namespace xt
@@ -166,4 +167,120 @@ namespace xt
         std::advance(it, 2);
         EXPECT_EQ(*((*it).begin()), a(0, 0, 4));
     }
+
+    TEST(xchunked_array, parallel_assign)
+    {
+        std::vector<std::size_t> shape = {13, 11, 9};
+        std::vector<std::size_t> chunk_shape = {4, 3, 2};
+        auto a = chunked_array<double>(shape, chunk_shape);
+        xt::xarray<double> b = arange(13 * 11 * 9).reshape({13, 11, 9});
+
+        xthread_pool pool(4);
+        a.assign(b, exec::par(pool));
+        EXPECT_TRUE(a == b);
+
+        noalias(a).assign(2. * b + 1., exec::par(pool));
+        EXPECT_TRUE(a == 2. * b + 1.);
+
+        a.assign(b, exec::seq);
+        EXPECT_TRUE(a == b);
+    }
+
+    TEST(xchunked_array, reduce)
+    {
+        std::vector<std::size_t> shape = {13, 11, 9};
+        std::vector<std::size_t> chunk_shape = {4, 3, 2};
+        auto a = chunked_array<double>(shape, chunk_shape);
+        xt::xarray<double> b = arange(13 * 11 * 9).reshape({13, 11, 9});
+        a = b;
+
+        EXPECT_EQ(sum(a)(), sum(b)());
+        EXPECT_EQ(amax(a)(), 13. * 11. * 9. - 1.);
+
+        xt::xarray<double> s0 = sum(a, {0});
+        EXPECT_EQ(s0, xt::xarray<double>(sum(b, {0})));
+        xt::xarray<double> s02 = sum(a, {0, 2}, keep_dims);
+        EXPECT_EQ(s02, xt::xarray<double>(sum(b, {0, 2}, keep_dims)));
+        xt::xarray<double> m1 = amin(a, {1});
+        EXPECT_EQ(m1, xt::xarray<double>(amin(b, {1})));
+
+        auto c = chunked_array<int>({5, 6, 7}, {2, 4, 3});
+        xt::xarray<int> d = arange(5 * 6 * 7).reshape({5, 6, 7}) % 3 + 1;
+        c = d;
+        xt::xarray<int> p2 = prod(c, {2});
+        EXPECT_EQ(p2, xt::xarray<int>(prod(d, {2})));
+
+        // The initial value is merged once
+        xt::xarray<double> i1 = sum(a, {1}, initial(2.));
+        EXPECT_EQ(i1, xt::xarray<double>(sum(b, {1}, initial(2.))));
+    }
+
+    TEST(xchunked_array, chunk_divider)
+    {
+        for (std::size_t d : {1u, 2u, 3u, 7u, 64u, 100u, 1000003u})
+        {
+            detail::xchunk_divider div(d);
+            for (std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(5), std::size_t(999), d - 1, d, d + 1,
+                                  std::size_t(0xFFFFFFFF), std::size_t(0x100000000), std::size_t(0x123456789)})
+            {
+                auto qr = div.divmod(n);
+                EXPECT_EQ(qr.first, n / d);
+                EXPECT_EQ(qr.second, n % d);
+            }
+        }
+    }
+
+    TEST(xchunked_array, stepper)
+    {
+        std::vector<std::size_t> shape = {9, 10, 7};
+        xt::xarray<double> b = arange(9 * 10 * 7).reshape({9, 10, 7});
+        for (auto chunk_shape : {std::vector<std::size_t>{4, 3, 2}, std::vector<std::size_t>{4, 8, 1},
+                                 std::vector<std::size_t>{9, 10, 7}})
+        {
+            auto a = chunked_array<double>(shape, chunk_shape);
+            a = b;
+            EXPECT_TRUE(std::equal(a.cbegin(), a.cend(), b.cbegin()));
+            EXPECT_TRUE(std::equal(a.crbegin(), a.crend(), b.crbegin()));
+            EXPECT_TRUE(std::equal(a.template cbegin<layout_type::column_major>(), a.template cend<layout_type::column_major>(),
+                                   b.template cbegin<layout_type::column_major>()));
+
+            // Broadcasting adds leading dimensions
+            xt::xarray<double> c = xt::ones<double>({2, 9, 10, 7});
+            xt::xarray<double> res = a + c;
+            EXPECT_EQ(res, b + c);
+
+            using dynamic_storage = xarray<xarray<double, layout_type::dynamic>>;
+            auto cs = chunk_shape;
+            xchunked_array<dynamic_storage> col(dynamic_storage(), std::vector<std::size_t>(shape), std::move(cs),
+                                                layout_type::column_major);
+            col = b;
+            EXPECT_TRUE(col == b);
+            EXPECT_EQ(col(8, 9, 6), b(8, 9, 6));
+        }
+    }
+
+    TEST(xchunked_array, rechunk)
+    {
+        std::vector<std::size_t> shape = {13, 21, 5};
+        std::vector<std::size_t> chunk_shape = {13, 2, 5};
+        auto a = chunked_array<double>(shape, chunk_shape);
+        xt::xarray<double> b = arange(13 * 21 * 5).reshape({13, 21, 5});
+        a = b;
+
+        // The budget ranges from less than one destination chunk to the whole array
+        for (std::size_t budget : {std::size_t(1), std::size_t(30 * sizeof(double)), std::size_t(1) << 20})
+        {
+            auto r = rechunk(a, std::vector<std::size_t>{4, 21, 3}, budget);
+            EXPECT_EQ(r.chunk_shape()[0], std::size_t(4));
+            EXPECT_EQ(r.chunk_shape()[2], std::size_t(3));
+            EXPECT_TRUE(r == b);
+
+            auto c = chunked_array<double>(std::vector<std::size_t>(shape), std::vector<std::size_t>{5, 5, 5});
+            rechunk(r, c, budget);
+            EXPECT_TRUE(c == b);
+        }
+
+        auto d = chunked_array<double>({13, 21}, {4, 4});
+        XT_EXPECT_THROW(rechunk(a, d), std::runtime_error);
+    }
 }
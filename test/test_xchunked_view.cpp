@@ -11,6 +11,9 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xchunked_array.hpp"
 #include "xtensor/xchunked_view.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xpad.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -59,4 +62,139 @@ namespace xt
         EXPECT_EQ(ref, a);
         EXPECT_EQ(ref, b);
     }
+
+    TEST(xchunked_view, for_each_chunk)
+    {
+        std::vector<std::size_t> shape = {7, 8};
+        xarray<double> a = arange(0., 56.).reshape(shape);
+        xarray<double> ref = a + 1.;
+
+        std::size_t chunk_nb = 0;
+        for_each_chunk(a, std::vector<std::size_t>{3, 8}, [&](auto& chunk, const auto& chunk_index)
+        {
+            // Chunks spanning the trailing dimensions are contiguous in the buffer
+            EXPECT_EQ(chunk.data() + chunk.data_offset(), &a(chunk_index[0] * 3, 0));
+            EXPECT_EQ(chunk.shape()[0], chunk_index[0] == 2 ? 1u : 3u);
+            EXPECT_EQ(chunk.strides()[1], 1);
+            chunk += 1.;
+            ++chunk_nb;
+        });
+        EXPECT_EQ(chunk_nb, 3u);
+        EXPECT_EQ(a, ref);
+
+        xthread_pool pool(3);
+        for_each_chunk(a, std::vector<std::size_t>{2, 3}, [](auto& chunk, const auto&)
+        {
+            chunk *= 2.;
+        }, exec::par(pool));
+        EXPECT_EQ(a, 2. * ref);
+
+        auto b = chunked_array<double>(std::vector<std::size_t>(shape), std::vector<std::size_t>{2, 2});
+        b = a;
+        double total = 0.;
+        for_each_chunk(b, std::vector<std::size_t>{4, 4}, [&](const auto& chunk, const auto&)
+        {
+            total += sum(chunk)();
+        });
+        EXPECT_EQ(total, sum(a)());
+    }
+
+    TEST(xchunked_view, parallel_for_blocks)
+    {
+        xarray<double> a = arange(0., 56.).reshape({7, 8});
+        xarray<double> out = zeros<double>({7, 8});
+        xthread_pool pool(3);
+
+        // Each task writes to the elements of its block only
+        std::vector<int> visited(7, 0);
+        std::vector<int> shared(7, 0);
+        parallel_for_blocks(out, 0, 2, [&](auto& block, std::size_t first, std::size_t last)
+        {
+            bool same = block.shape()[0] == last - first && block.data() + block.data_offset() == &out(first, 0);
+            noalias(block).assign(view(a, range(first, last)) * 2., exec::seq);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                ++visited[i];
+                shared[i] = same ? 1 : 0;
+            }
+        }, exec::par(pool));
+        EXPECT_EQ(out, 2. * a);
+        EXPECT_EQ(visited, std::vector<int>(7, 1));
+        EXPECT_EQ(shared, std::vector<int>(7, 1));
+
+        std::size_t nb_blocks = 0;
+        parallel_for_blocks(out, -1, 3, [&](auto& block, std::size_t first, std::size_t last)
+        {
+            block += view(a, all(), range(first, last));
+            ++nb_blocks;
+        }, exec::seq);
+        EXPECT_EQ(nb_blocks, 3u);
+        EXPECT_EQ(out, 3. * a);
+
+        xtensor<double, 2, layout_type::column_major> c = a;
+        parallel_for_blocks(c, 1, 0, [](auto& block, std::size_t, std::size_t)
+        {
+            block *= -1.;
+        });
+        EXPECT_EQ(c, -a);
+    }
+
+    TEST(xchunked_view, for_each_chunk_with_halo)
+    {
+        std::vector<std::size_t> shape = {7, 9};
+        std::vector<std::size_t> chunk_shape = {3, 4};
+        xarray<double> a = arange(0., 63.).reshape(shape);
+        auto c = chunked_array<double>(std::vector<std::size_t>(shape), std::vector<std::size_t>(chunk_shape));
+        c = a;
+
+        for (auto mode : {pad_mode::constant, pad_mode::symmetric, pad_mode::reflect, pad_mode::wrap})
+        {
+            for (std::size_t halo : {std::size_t(1), std::size_t(3)})
+            {
+                xarray<double> padded = pad(a, halo, mode, -1.);
+                std::size_t chunk_nb = 0;
+                for_each_chunk_with_halo(c, halo, [&](const auto& block, const auto& chunk_index)
+                {
+                    std::size_t r = chunk_index[0] * chunk_shape[0];
+                    std::size_t s = chunk_index[1] * chunk_shape[1];
+                    auto expected = view(padded, range(r, r + block.shape()[0]), range(s, s + block.shape()[1]));
+                    EXPECT_EQ(block.shape()[0], (std::min)(chunk_shape[0], shape[0] - r) + 2 * halo);
+                    EXPECT_TRUE(block == expected);
+                    ++chunk_nb;
+                }, mode, -1.);
+                EXPECT_EQ(chunk_nb, c.grid_size());
+            }
+        }
+
+        // A chunk-parallel 3x3 box filter
+        xarray<double> padded = pad(a, 1, pad_mode::symmetric);
+        xarray<double> expected = zeros<double>(shape);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                expected += view(padded, range(i, i + shape[0]), range(j, j + shape[1]));
+            }
+        }
+        xarray<double> res = zeros<double>(shape);
+        xthread_pool pool(3);
+        for_each_chunk_with_halo(c, 1, [&](const auto& block, const auto& chunk_index)
+        {
+            std::size_t r = chunk_index[0] * chunk_shape[0];
+            std::size_t s = chunk_index[1] * chunk_shape[1];
+            std::size_t n0 = block.shape()[0] - 2;
+            std::size_t n1 = block.shape()[1] - 2;
+            auto out = view(res, range(r, r + n0), range(s, s + n1));
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    out += view(block, range(i, i + n0), range(j, j + n1));
+                }
+            }
+        }, exec::par(pool), pad_mode::symmetric);
+        EXPECT_EQ(res, expected);
+
+        XT_EXPECT_THROW(for_each_chunk_with_halo(c, 8, [](const auto&, const auto&) {}, pad_mode::reflect), std::runtime_error);
+    }
 }
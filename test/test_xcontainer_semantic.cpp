@@ -8,6 +8,8 @@
 
 #include "test_common_macros.hpp"
 #include "test_xsemantic.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xview.hpp"
 
 TEST_SUITE_BEGIN("container_semantic");
 
@@ -688,6 +690,55 @@ namespace xt
         }
     }
 
+    TEST_CASE("alias_analysis")
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {{1., 1., 1.}, {2., 2., 2.}};
+        const double* data = a.data();
+
+        SUBCASE("in place update")
+        {
+            a += b * 2.;
+            xarray<double> expected = {{3., 4., 5.}, {8., 9., 10.}};
+            EXPECT_EQ(a, expected);
+            EXPECT_EQ(a.data(), data);
+
+            a = a * a(0, 0);
+            expected *= 3.;
+            EXPECT_EQ(a, expected);
+        }
+
+        SUBCASE("overlapping views")
+        {
+            a = transpose(a) + 0.;
+            xarray<double> expected = {{1., 4.}, {2., 5.}, {3., 6.}};
+            EXPECT_EQ(a, expected);
+
+            xarray<double> c = {1., 2., 3., 4.};
+            c = view(c, keep(3, 2, 1, 0)) + 0.;
+            xarray<double> expected_c = {4., 3., 2., 1.};
+            EXPECT_EQ(c, expected_c);
+
+            xarray<double> d = {1., 2., 3., 4.};
+            auto v = view(d, range(1, 4));
+            v = view(d, range(0, 3)) + 1.;
+            xarray<double> expected_d = {1., 2., 3., 4.};
+            EXPECT_EQ(d, expected_d);
+        }
+
+        SUBCASE("broadcasting")
+        {
+            xarray<double> row = {1., 2., 3.};
+            row = row + b;
+            EXPECT_EQ(row, (xarray<double>{{2., 3., 4.}, {3., 4., 5.}}));
+
+            xarray<double> c = {{1., 2., 3.}, {4., 5., 6.}};
+            c = c + view(c, 0, all());
+            xarray<double> expected_c = {{2., 4., 6.}, {5., 7., 9.}};
+            EXPECT_EQ(c, expected_c);
+        }
+    }
+
     #undef CONTAINER_SEMANTIC_TYPES
 }
 TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,92 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xconvolve.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        xarray<double> naive_correlate_2d(const xarray<double>& a, const xarray<double>& k)
+        {
+            std::size_t rows = a.shape()[0] - k.shape()[0] + 1;
+            std::size_t cols = a.shape()[1] - k.shape()[1] + 1;
+            xarray<double> res = zeros<double>({rows, cols});
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                for (std::size_t j = 0; j < cols; ++j)
+                {
+                    for (std::size_t u = 0; u < k.shape()[0]; ++u)
+                    {
+                        for (std::size_t v = 0; v < k.shape()[1]; ++v)
+                        {
+                            res(i, j) += a(i + u, j + v) * k(u, v);
+                        }
+                    }
+                }
+            }
+            return res;
+        }
+    }
+
+    TEST(xconvolve, convolve_nd)
+    {
+        xarray<double> image = fmod(arange<double>(30. * 700.), 17.);
+        image.reshape({30, 700});
+        xarray<double> kernel = {{1., 2., 0., -1.}, {0., 1., 3., 1.}, {2., -2., 1., 0.}};
+        xarray<double> flipped = flip(flip(kernel, 0), 1);
+
+        auto valid = correlate_nd(image, kernel, convolve_mode::valid());
+        EXPECT_EQ(valid, naive_correlate_2d(image, kernel));
+        EXPECT_EQ(convolve_nd(image, flipped, convolve_mode::valid()), valid);
+
+        // The borders are padded with pad
+        std::vector<std::vector<std::size_t>> same_width = {{1, 1}, {2, 1}};
+        auto same = convolve_nd(image, kernel, convolve_mode::same(), pad_mode::reflect);
+        EXPECT_EQ(same.shape(), image.shape());
+        EXPECT_EQ(same, naive_correlate_2d(pad(image, same_width, pad_mode::reflect), flipped));
+
+        std::vector<std::vector<std::size_t>> full_width = {{2, 2}, {3, 3}};
+        auto full = correlate_nd(image, kernel, convolve_mode::full(), pad_mode::wrap);
+        EXPECT_EQ(full.shape()[0], 32u);
+        EXPECT_EQ(full.shape()[1], 703u);
+        EXPECT_EQ(full, naive_correlate_2d(pad(image, full_width, pad_mode::wrap), kernel));
+
+        xthread_pool pool(3);
+        auto par = convolve_nd(image, kernel, convolve_mode::same(), pad_mode::reflect, exec::par(pool, 0, 1));
+        EXPECT_EQ(par, same);
+
+        // 3D, with an xtensor operand
+        xtensor<int, 3> volume = arange<int>(4 * 5 * 6).reshape({4, 5, 6}) % 5;
+        xtensor<int, 3> box = ones<int>({2, 2, 2});
+        auto boxes = convolve_nd(volume, box, convolve_mode::valid());
+        EXPECT_EQ(boxes.shape()[2], 5u);
+        int expected = 0;
+        for (std::size_t i = 1; i < 3; ++i)
+        {
+            for (std::size_t j = 2; j < 4; ++j)
+            {
+                for (std::size_t l = 3; l < 5; ++l)
+                {
+                    expected += volume(i, j, l);
+                }
+            }
+        }
+        EXPECT_EQ(boxes(1, 2, 3), expected);
+
+        XT_EXPECT_THROW(convolve_nd(image, volume, convolve_mode::valid()), std::runtime_error);
+    }
+}
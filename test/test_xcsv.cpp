@@ -13,8 +13,11 @@
 #include <iostream>
 
 #include "xtensor/xcsv.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xmath.hpp" 
 #include "xtensor/xio.hpp" 
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -55,6 +58,152 @@ namespace xt
         ASSERT_TRUE(all(equal(res, exp)));
     }
 
+    TEST(xcsv, load_quoted)
+    {
+        std::string source =
+            "\"1.5\",2,\" 3 \"\r\n"
+            "\n"
+            "4,+5,6e1,\r\n";
+
+        std::stringstream source_stream(source);
+        auto res = load_csv<double>(source_stream);
+        xtensor<double, 2> exp
+            {{1.5, 2.0, 3.0},
+             {4.0, 5.0, 60.0}};
+        ASSERT_TRUE(all(equal(res, exp)));
+
+        std::stringstream string_stream("\"a,b\",\"say \"\"hi\"\"\"\n\"line\nbreak\",c\n");
+        auto sres = load_csv<std::string>(string_stream);
+        EXPECT_EQ(sres.shape()[0], 2u);
+        EXPECT_EQ(sres(0, 0), "a,b");
+        EXPECT_EQ(sres(0, 1), "say \"hi\"");
+        EXPECT_EQ(sres(1, 0), "line\nbreak");
+        EXPECT_EQ(sres(1, 1), "c");
+    }
+
+    TEST(xcsv, load_int)
+    {
+        std::string source = "1,-2,3\n40,50,-60\n";
+        std::stringstream source_stream(source);
+        auto res = load_csv<int>(source_stream);
+        xtensor<int, 2> exp = {{1, -2, 3}, {40, 50, -60}};
+        ASSERT_TRUE(all(equal(res, exp)));
+
+        std::stringstream invalid("1,x,3\n");
+        XT_EXPECT_THROW(load_csv<int>(invalid), std::invalid_argument);
+        std::stringstream overflow("1,99999999999,3\n");
+        XT_EXPECT_THROW(load_csv<int>(overflow), std::out_of_range);
+        std::stringstream inconsistent("1,2,3\n4,5\n");
+        XT_EXPECT_THROW(load_csv<int>(inconsistent), std::runtime_error);
+    }
+
+    TEST(xcsv, load_large)
+    {
+        // Lines crossing the blocks read from the stream
+        std::size_t nbrow = 100000;
+        std::stringstream source;
+        for (std::size_t i = 0; i < nbrow; ++i)
+        {
+            source << i << ',' << 0.5 * static_cast<double>(i) << ",\"" << 2 * i << "\"\n";
+        }
+        auto res = load_csv<double>(source);
+        EXPECT_EQ(res.shape()[0], nbrow);
+        EXPECT_EQ(res.shape()[1], 3u);
+        EXPECT_EQ(res(nbrow - 1, 0), static_cast<double>(nbrow - 1));
+        EXPECT_EQ(res(12345, 1), 0.5 * 12345.);
+        EXPECT_EQ(res(54321, 2), 2. * 54321.);
+    }
+
+    TEST(xcsv, load_parallel)
+    {
+        // Chunks of rows with comments and blank lines
+        std::size_t nbrow = 200000;
+        std::stringstream source;
+        source << "header\n";
+        for (std::size_t i = 0; i < nbrow; ++i)
+        {
+            source << i << ',' << 0.25 * static_cast<double>(i) << ',' << 3 * i << "\r\n";
+            if (i % 1000 == 7)
+            {
+                source << "# comment\n\n";
+            }
+        }
+        std::string text = source.str();
+
+        std::stringstream sequential_stream(text);
+        auto exp = load_csv<double>(sequential_stream, ',', 1);
+
+        xthread_pool pool(4);
+        std::stringstream parallel_stream(text);
+        auto res = load_csv<double>(parallel_stream, ',', 1, -1, "#", exec::parallel_policy(pool));
+        EXPECT_EQ(res.shape()[0], nbrow);
+        EXPECT_EQ(res.shape()[1], 3u);
+        EXPECT_TRUE(res == exp);
+
+        std::stringstream clipped_stream(text);
+        auto clipped = load_csv<double>(clipped_stream, ',', 1, 123457, "#", exec::parallel_policy(pool));
+        EXPECT_EQ(clipped.shape()[0], 123457u);
+        EXPECT_TRUE(clipped == xt::view(exp, xt::range(0, 123457), xt::all()));
+
+        std::stringstream seq_stream(text);
+        auto seq = load_csv<double>(seq_stream, ',', 1, -1, "#", exec::seq);
+        EXPECT_TRUE(seq == exp);
+
+        std::stringstream quoted("1,\"2\"\n3,\"4\"\n");
+        auto qres = load_csv<int>(quoted, ',', 0, -1, "#", exec::parallel_policy(pool));
+        xtensor<int, 2> qexp = {{1, 2}, {3, 4}};
+        EXPECT_TRUE(qres == qexp);
+
+        std::stringstream inconsistent(text + "1,2\n");
+        XT_EXPECT_THROW(load_csv<double>(inconsistent, ',', 1, -1, "#", exec::parallel_policy(pool)), std::runtime_error);
+        std::stringstream invalid(text + "1,x,3\n");
+        XT_EXPECT_THROW(load_csv<double>(invalid, ',', 1, -1, "#", exec::parallel_policy(pool)), std::invalid_argument);
+    }
+
+    TEST(xcsv, reader)
+    {
+        std::stringstream source;
+        source << "a,b\n";
+        for (int i = 0; i < 10; ++i)
+        {
+            source << i << ',' << -i << "\n";
+            if (i == 4)
+            {
+                source << "# comment\n\n";
+            }
+        }
+        std::string text = source.str();
+
+        std::stringstream batch_stream(text);
+        csv_reader<int> reader(batch_stream, 4, ',', 1);
+        std::vector<std::size_t> sizes;
+        int sum = 0;
+        const int* data = nullptr;
+        while (reader.next())
+        {
+            const auto& batch = reader.batch();
+            EXPECT_EQ(batch.shape()[1], 2u);
+            if (sizes.size() == 1)
+            {
+                // The full batches reuse the same buffer
+                EXPECT_EQ(batch.data(), data);
+            }
+            data = batch.data();
+            sizes.push_back(batch.shape()[0]);
+            EXPECT_EQ(batch(0, 0), static_cast<int>(4 * (sizes.size() - 1)));
+            sum += xt::sum(batch)() + 2 * xt::sum(xt::view(batch, xt::all(), 0))();
+        }
+        EXPECT_EQ(sizes, (std::vector<std::size_t>{4, 4, 2}));
+        EXPECT_EQ(sum, 90);
+        EXPECT_EQ(reader.rows(), 10u);
+        EXPECT_EQ(reader.columns(), 2u);
+        EXPECT_FALSE(reader.next());
+
+        std::stringstream inconsistent("1,2\n3\n");
+        csv_reader<int> bad_reader(inconsistent, 8);
+        XT_EXPECT_THROW(bad_reader.next(), std::runtime_error);
+    }
+
     TEST(xcsv, dump_double)
     {
         xtensor<double, 2> data
@@ -66,4 +215,38 @@ namespace xt
         dump_csv(res, data);
         ASSERT_EQ("1,2,3,4\n10,12,15,18\n", res.str());
     }
+
+    TEST(xcsv, dump_roundtrip)
+    {
+        xtensor<double, 2> data = {{0.1, 1. / 3., -2.5e-300}, {1e300, 123456789.125, -7.}};
+        std::stringstream out;
+        dump_csv(out, data);
+        EXPECT_EQ(out.str().substr(0, 4), "0.1,");
+        std::stringstream in(out.str());
+        auto res = load_csv<double>(in);
+        EXPECT_TRUE(res == data);
+
+        xtensor<int, 2> idata = {{-1, 2147483647}, {0, -2147483647}};
+        std::stringstream iout;
+        dump_csv(iout, idata);
+        EXPECT_EQ(iout.str(), "-1,2147483647\n0,-2147483647\n");
+    }
+
+    TEST(xcsv, dump_parallel)
+    {
+        xtensor<double, 2> data = xt::reshape_view(xt::arange<double>(300000.) * 0.1, {100000, 3});
+        std::stringstream sequential;
+        dump_csv(sequential, data);
+
+        xthread_pool pool(4);
+        std::stringstream parallel;
+        dump_csv(parallel, data, exec::parallel_policy(pool));
+        EXPECT_EQ(parallel.str(), sequential.str());
+
+        std::stringstream lazy;
+        dump_csv(lazy, 2. * data, exec::parallel_policy(pool));
+        std::stringstream in(lazy.str());
+        auto res = load_csv<double>(in);
+        EXPECT_TRUE(res == 2. * data);
+    }
 }
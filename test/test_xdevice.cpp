@@ -0,0 +1,113 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include "xtensor/xdevice.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Host device counting the kernels it runs
+        struct xtest_device
+        {
+            static std::size_t launches;
+
+            static void* allocate(std::size_t bytes)
+            {
+                return xhost_device::allocate(bytes);
+            }
+
+            static void deallocate(void* p, std::size_t bytes) noexcept
+            {
+                xhost_device::deallocate(p, bytes);
+            }
+
+            template <class K>
+            static void parallel_for(std::size_t n, const K& kernel)
+            {
+                ++launches;
+                xhost_device::parallel_for(n, kernel);
+            }
+
+            template <class T, class K, class F>
+            static T reduce(std::size_t n, const K& kernel, T init, F f)
+            {
+                ++launches;
+                return xhost_device::reduce<T>(n, kernel, init, f);
+            }
+        };
+
+        std::size_t xtest_device::launches = 0;
+
+        using device_array = xdevice_array<double, xtest_device>;
+    }
+
+    TEST(xdevice, assign)
+    {
+        device_array a = {{1., 2., 3.}, {4., 5., 6.}};
+        device_array b = {{-1., 0., 1.}, {2., 3., 4.}};
+        xarray<double> ha = a;
+        xarray<double> hb = b;
+
+        device_array c(a.shape());
+        xtest_device::launches = 0;
+        noalias(c) = 2. * a + exp(b) - a / b;
+        EXPECT_EQ(xtest_device::launches, 1u);
+        xarray<double> expected = 2. * ha + exp(hb) - ha / hb;
+        EXPECT_EQ(c, expected);
+
+        c += a;
+        EXPECT_EQ(xtest_device::launches, 2u);
+        expected += ha;
+        EXPECT_EQ(c, expected);
+
+        xdevice_tensor<int, 2, xtest_device> t = a + b;
+        EXPECT_EQ(xtest_device::launches, 3u);
+        xtensor<int, 2> ht = ha + hb;
+        EXPECT_EQ(t, ht);
+    }
+
+    TEST(xdevice, host_fallback)
+    {
+        device_array a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> h = {{1., 1., 1.}, {2., 2., 2.}};
+        device_array row = {1., 2., 3.};
+        xdevice_array<double, xtest_device, layout_type::column_major> col = a;
+
+        device_array c(a.shape());
+        xtest_device::launches = 0;
+        noalias(c) = a + h;
+        noalias(c) = a + row;
+        noalias(c) = a + col;
+        EXPECT_EQ(xtest_device::launches, 0u);
+        xarray<double> expected = 2. * a;
+        EXPECT_EQ(c, expected);
+    }
+
+    TEST(xdevice, reduce)
+    {
+        device_array a = {{1., 2., 3.}, {4., 5., -6.}};
+        device_array row = {1., 2., 3.};
+        xarray<double> h = a;
+
+        xtest_device::launches = 0;
+        EXPECT_EQ(device_sum(a * a), sum(h * h)());
+        EXPECT_EQ(device_prod(a), prod(h)());
+        EXPECT_EQ(device_amin(a + 1.), amin(h + 1.)());
+        EXPECT_EQ(device_amax(a), amax(h)());
+        EXPECT_EQ(xtest_device::launches, 4u);
+
+        xarray<double> hrow = row;
+        EXPECT_EQ(device_sum(a + row), sum(h + hrow)());
+        EXPECT_EQ(xtest_device::launches, 4u);
+    }
+}
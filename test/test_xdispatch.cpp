@@ -0,0 +1,80 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xdispatch.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xdispatch, target)
+    {
+        simd_target best = best_simd_target();
+        EXPECT_TRUE(static_cast<int>(dispatch_target()) <= static_cast<int>(best));
+        if (best == simd_target::avx512)
+        {
+            EXPECT_TRUE(host_cpu_features().avx512f && host_cpu_features().avx2);
+        }
+
+        // The requested target is capped by the CPU
+        simd_target previous = set_dispatch_target(simd_target::avx512);
+        EXPECT_TRUE(dispatch_target() == best);
+        set_dispatch_target(simd_target::generic);
+        EXPECT_TRUE(dispatch_target() == simd_target::generic);
+        EXPECT_EQ(std::string(simd_target_name(simd_target::generic)), "generic");
+        set_dispatch_target(previous);
+
+        int calls = 0;
+        dispatch_kernel([&calls]() { ++calls; });
+        dispatch_for<std::string>([&calls]() { ++calls; });
+        EXPECT_EQ(calls, 2);
+    }
+
+    TEST(xdispatch, kernels)
+    {
+        // Integral values keep the floating point sums exact whatever
+        // their order
+        xarray<double> a = xt::fmod(xt::arange<double>(12000.), 37.);
+        a.reshape({40, 300});
+        xarray<double> b = xt::arange<double>(300.);
+
+        std::vector<simd_target> targets = {simd_target::generic, simd_target::avx2, simd_target::avx512};
+        simd_target previous = dispatch_target();
+        xarray<double> expected;
+        double expected_sum = 0.;
+        xarray<double> expected_rows;
+        for (simd_target target : targets)
+        {
+            set_dispatch_target(target);
+            xarray<double> res = 2. * a + b;
+            double total = sum(a, evaluation_strategy::immediate)();
+            xarray<double> rows = sum(a, {0}, evaluation_strategy::immediate);
+            if (target == simd_target::generic)
+            {
+                expected = res;
+                expected_sum = total;
+                expected_rows = rows;
+            }
+            EXPECT_EQ(res, expected);
+            EXPECT_EQ(total, expected_sum);
+            EXPECT_EQ(rows, expected_rows);
+        }
+        set_dispatch_target(previous);
+        EXPECT_EQ(expected(1, 2), 2. * a(1, 2) + 2.);
+        EXPECT_EQ(expected_rows(5), xt::sum(xt::view(a, xt::all(), 5))());
+    }
+}
@@ -275,4 +275,28 @@ namespace xt
         EXPECT_EQ(x, res);
     }
 
+    TEST(xdynamic_view, strided_and_keep_access)
+    {
+        xt::xarray<int> a = xt::arange<int>(60).reshape({3, 4, 5});
+
+        auto rv = xt::dynamic_view(a, {xt::range(1, 3), xt::all(), xt::range(0, 5, 2)});
+        EXPECT_EQ(rv(1, 2, 1), a(2, 2, 2));
+        EXPECT_EQ(rv.unchecked(0, 3, 2), a(1, 3, 4));
+        std::array<std::size_t, 3> i1 = {1, 1, 0};
+        EXPECT_EQ(rv.element(i1.cbegin(), i1.cend()), a(2, 1, 0));
+
+        auto kv = xt::dynamic_view(a, {xt::all(), xt::all(), xt::keep(4, 0)});
+        EXPECT_EQ(kv(2, 1, 0), a(2, 1, 4));
+        EXPECT_EQ(kv(2, 1, 1), a(2, 1, 0));
+        EXPECT_EQ(kv.unchecked(1, 3, 0), a(1, 3, 4));
+        std::array<std::size_t, 3> i2 = {0, 2, 1};
+        EXPECT_EQ(kv.element(i2.cbegin(), i2.cend()), a(0, 2, 0));
+
+        auto dv = xt::dynamic_view(a, {1, xt::drop(0, 2)});
+        EXPECT_EQ(dv(0, 3), a(1, 1, 3));
+        EXPECT_EQ(dv(1, 4), a(1, 3, 4));
+        xt::xarray<int> ev = dv;
+        EXPECT_EQ(ev(1, 2), a(1, 3, 2));
+    }
+
 }
@@ -0,0 +1,66 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xeinsum.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xmatmul.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xeinsum, contractions)
+    {
+        xarray<double> a = arange<double>(3 * 20 * 30).reshape({3, 20, 30}) - 900.;
+        xarray<double> b = arange<double>(3 * 30 * 25).reshape({3, 30, 25}) - 1100.;
+        xarray<double> r = einsum("bij,bjk->bik", a, b);
+        EXPECT_EQ(r, matmul(a, b));
+
+        xarray<double> x = arange<double>(4 * 5).reshape({4, 5});
+        xarray<double> y = arange<double>(5 * 6).reshape({5, 6}) - 10.;
+        xarray<double> z = arange<double>(6 * 3).reshape({6, 3}) - 5.;
+        xarray<double> xyz = matmul(matmul(x, y), z);
+        EXPECT_EQ(einsum("ij,jk,kl->il", x, y, z), xyz);
+        EXPECT_EQ(einsum("ij,jk,kl", x, y, z), xyz);
+        EXPECT_EQ(einsum("kl,ij,jk->li", z, x, y), transpose(xyz));
+
+        xarray<double> u = {1., 2., 3.};
+        xarray<double> v = {4., 5., 6.};
+        EXPECT_EQ(einsum("i,i->", u, v)(), 32.);
+        EXPECT_EQ(einsum("i,j->ij", u, v), (xarray<double>{{4., 5., 6.}, {8., 10., 12.}, {12., 15., 18.}}));
+        EXPECT_EQ(einsum("i,i->i", u, v), (xarray<double>{4., 10., 18.}));
+        EXPECT_EQ(einsum("ij,j->i", x + 1., view(y, all(), 0)), matmul(x + 1., view(y, all(), 0)));
+
+        xarray<int> xi = arange<int>(12).reshape({3, 4});
+        xarray<double> yd = arange<double>(4);
+        auto ri = einsum("ij,j", xi, yd);
+        EXPECT_TRUE((std::is_same<decltype(ri)::value_type, double>::value));
+        EXPECT_EQ(ri, (xarray<double>{14., 38., 62.}));
+    }
+
+    TEST(xeinsum, single_operand)
+    {
+        xarray<double> m = arange<double>(9).reshape({3, 3});
+        EXPECT_EQ(einsum("ii->", m)(), 12.);
+        EXPECT_EQ(einsum("ii->i", m), (xarray<double>{0., 4., 8.}));
+        EXPECT_EQ(einsum("ij->ji", m), transpose(m));
+        EXPECT_EQ(einsum("ij->j", m), (xarray<double>{9., 12., 15.}));
+        EXPECT_EQ(einsum("ij", m), m);
+        EXPECT_EQ(einsum("ji", m), transpose(m));
+
+        XT_EXPECT_THROW(einsum("ij,jk->ik", m), std::runtime_error);
+        XT_EXPECT_THROW(einsum("ijk->i", m), std::runtime_error);
+        XT_EXPECT_THROW(einsum("ij->ik", m), std::runtime_error);
+        xarray<double> n = arange<double>(8).reshape({2, 4});
+        XT_EXPECT_THROW(einsum("ij,jk->ik", m, n), std::runtime_error);
+    }
+}
@@ -14,6 +14,8 @@
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -59,6 +61,33 @@ namespace xt
         EXPECT_TRUE(type_eq_2);
     }
 
+    TEST(xeval, eval_if_costly)
+    {
+        xarray<double> a = {1., 2., 3., 4.};
+
+        auto f = a * a - 2.;
+        EXPECT_EQ(expression_cost<decltype(f)>::value, std::size_t(2));
+        auto&& b = eval_if_costly(f);
+        EXPECT_EQ(&b, &f);
+        auto&& c = eval_if_costly(a + 1.);
+        bool type_eq = std::is_same<decltype(c), xfunction<detail::plus, const xarray<double>&, xscalar<double>>&&>::value;
+        EXPECT_TRUE(type_eq);
+        EXPECT_EQ(c(1), 3.);
+
+        auto g = xt::exp(view(a, range(0, 2))) * xt::sin(view(a, range(2, 4)));
+        EXPECT_EQ(expression_cost<decltype(g)>::value, 2 * std::size_t(XTENSOR_EXPENSIVE_FUNCTOR_COST) + 1);
+        auto&& d = eval_if_costly(g);
+        bool type_eq_2 = std::is_same<decltype(d), xarray<double>&&>::value;
+        EXPECT_TRUE(type_eq_2);
+        EXPECT_EQ(d(1), std::exp(2.) * std::sin(4.));
+
+        auto&& e = eval_if_costly(a);
+        EXPECT_EQ(&e, &a);
+        auto&& s = eval_if_costly(sum(a, {0}));
+        bool type_eq_3 = std::is_same<decltype(s), xarray<double>&&>::value;
+        EXPECT_TRUE(type_eq_3);
+    }
+
 
 #define EXPECT_LAYOUT(EXPRESSION, LAYOUT)                         \
   EXPECT_TRUE((decltype(EXPRESSION)::static_layout == LAYOUT)) 
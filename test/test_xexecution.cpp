@@ -0,0 +1,266 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xthread_pool, parallel_for)
+    {
+        xthread_pool pool(3);
+        EXPECT_EQ(pool.size(), std::size_t(3));
+
+        std::vector<int> v(1000, 0);
+        pool.parallel_for(0, v.size(), 10, [&v](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                v[i] += 1;
+            }
+        });
+        EXPECT_EQ(std::count(v.begin(), v.end(), 1), 1000);
+    }
+
+    TEST(xthread_pool, nested_parallel_for)
+    {
+        xthread_pool pool(2);
+        std::atomic<std::size_t> count(0);
+        pool.parallel_for(0, 16, 1, [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                pool.parallel_for(0, 100, 0, [&count](std::size_t b, std::size_t e) { count += e - b; });
+            }
+        });
+        EXPECT_EQ(count.load(), std::size_t(1600));
+    }
+
+    TEST(xthread_pool, empty_pool)
+    {
+        xthread_pool pool(0);
+        int res = 0;
+        pool.parallel_for(0, 10, 1, [&res](std::size_t first, std::size_t last) { res += int(last - first); });
+        EXPECT_EQ(res, 10);
+    }
+
+    TEST(xthread_pool, exception)
+    {
+        xthread_pool pool(2);
+        XT_EXPECT_THROW(pool.parallel_for(0, 100, 1, [](std::size_t first, std::size_t last)
+        {
+            if (first <= 42 && 42 < last)
+            {
+                throw std::runtime_error("failure");
+            }
+        }), std::runtime_error);
+    }
+
+    TEST(xexecution, noalias_assign)
+    {
+        xthread_pool pool(3);
+        xarray<double> a = arange<double>(10007.);
+        xarray<double> b = arange<double>(10007.);
+        xarray<double> expected = a + 2. * b;
+
+        xarray<double> res_seq = zeros<double>({10007});
+        noalias(res_seq).assign(a + 2. * b, exec::seq);
+        EXPECT_EQ(res_seq, expected);
+
+        xarray<double> res_par = zeros<double>({10007});
+        noalias(res_par).assign(a + 2. * b, exec::par(pool));
+        EXPECT_EQ(res_par, expected);
+
+        xarray<double> res_grain = zeros<double>({10007});
+        noalias(res_grain).assign(a + 2. * b, exec::par(pool, 0, 64));
+        EXPECT_EQ(res_grain, expected);
+    }
+
+    TEST(xexecution, threshold)
+    {
+        xthread_pool pool(2);
+        xtensor<int, 1> a = {1, 2, 3};
+        xtensor<int, 1> res;
+        res.assign(a * 2, exec::par(pool, 1000));
+        xtensor<int, 1> expected = {2, 4, 6};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xexecution, resize)
+    {
+        xthread_pool pool(2);
+        xarray<int> a = {{1, 2, 3}, {4, 5, 6}};
+        xarray<int> res;
+        noalias(res).assign(a + a, exec::par(pool));
+        xarray<int> expected = {{2, 4, 6}, {8, 10, 12}};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xexecution, view)
+    {
+        xthread_pool pool(2);
+        xarray<double> a = arange<double>(2000.);
+        a.reshape({20, 100});
+        xarray<double> res = zeros<double>({20, 100});
+        auto v = view(res, range(2, 10), all());
+        noalias(v).assign(view(a, range(2, 10), all()) * 3., exec::par(pool));
+        xarray<double> expected = zeros<double>({20, 100});
+        view(expected, range(2, 10), all()) = view(a, range(2, 10), all()) * 3.;
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xexecution, layout_mismatch)
+    {
+        xthread_pool pool(2);
+        xarray<double, layout_type::row_major> a = arange<double>(600.);
+        a.reshape({20, 30});
+        xarray<double, layout_type::column_major> res(a.shape());
+        noalias(res).assign(a + 1., exec::par(pool));
+        EXPECT_EQ(res, a + 1.);
+    }
+
+    TEST(xexecution, default_threshold)
+    {
+        std::size_t threshold = exec::default_threshold();
+        exec::set_default_threshold(100000);
+        EXPECT_EQ(exec::default_threshold(), std::size_t(100000));
+
+        xarray<double> a = arange<double>(1000.);
+        xarray<double> res = zeros<double>({1000});
+        noalias(res) = a * 2.;
+        EXPECT_EQ(res, a * 2.);
+        EXPECT_EQ(exec::last_decision().threshold, std::size_t(100000));
+        EXPECT_FALSE(exec::last_decision().parallel);
+
+        exec::set_default_threshold(threshold);
+        EXPECT_EQ(exec::default_threshold(), threshold);
+    }
+
+    TEST(xexecution, last_decision)
+    {
+        xthread_pool pool(2);
+        xarray<double> a = arange<double>(10000.);
+        xarray<double> res = zeros<double>({10000});
+
+        noalias(res).assign(a + 1., exec::par(pool, 100, 50));
+        EXPECT_EQ(exec::last_decision().threshold, std::size_t(100));
+        EXPECT_EQ(exec::last_decision().grain_size, std::size_t(50));
+        EXPECT_TRUE(exec::last_decision().parallel);
+
+        noalias(res).assign(a + 1., exec::par(pool, 20000));
+        EXPECT_FALSE(exec::last_decision().parallel);
+
+        noalias(res).assign(a + 1., exec::seq);
+        EXPECT_FALSE(exec::last_decision().parallel);
+        EXPECT_EQ(res, a + 1.);
+    }
+
+    TEST(xexecution, adaptive)
+    {
+        xthread_pool pool(3);
+        xarray<double> a = arange<double>(100003.);
+        xarray<double> expected = a * a + 1.;
+
+        exec::reset_calibration();
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            xarray<double> res = zeros<double>({100003});
+            noalias(res).assign(a * a + 1., exec::adaptive(pool));
+            EXPECT_EQ(res, expected);
+            EXPECT_TRUE(exec::last_decision().grain_size > 0);
+            EXPECT_EQ(exec::last_decision().threshold, 2 * exec::last_decision().grain_size);
+            EXPECT_TRUE(exec::last_decision().cost_per_element > 0.);
+        }
+
+        // A huge minimal task duration prevents any split.
+        auto duration = exec::min_task_duration();
+        exec::set_min_task_duration(std::chrono::seconds(10));
+        xarray<double> res = zeros<double>({100003});
+        noalias(res).assign(a * a + 1., exec::adaptive(pool));
+        EXPECT_EQ(res, expected);
+        EXPECT_FALSE(exec::last_decision().parallel);
+        exec::set_min_task_duration(duration);
+
+        xarray<double> small = zeros<double>({10});
+        noalias(small).assign(view(a, range(0, 10)) * 2., exec::adaptive(pool));
+        EXPECT_EQ(small, view(a, range(0, 10)) * 2.);
+    }
+
+    TEST(xexecution, streaming)
+    {
+        xthread_pool pool(3);
+        xarray<double> a = arange<double>(100003.);
+        xarray<double> expected = a * 2. + 1.;
+
+        xarray<double> res = zeros<double>({100003});
+        noalias(res).assign(a * 2. + 1., exec::streaming());
+        EXPECT_EQ(res, expected);
+
+        res.fill(0.);
+        noalias(res).assign(a * 2. + 1., exec::streaming(exec::par(pool, 0, 1000)));
+        EXPECT_EQ(res, expected);
+        EXPECT_TRUE(exec::last_decision().parallel);
+        EXPECT_TRUE(is_execution_policy<exec::streaming_policy<exec::parallel_policy>>::value);
+
+        // Unaligned destination and tail handled by the scalar loops
+        xarray<double> vres = zeros<double>({100003});
+        auto v = view(vres, range(1, 100002));
+        noalias(v).assign(view(a, range(1, 100002)) - 3., exec::streaming(exec::seq));
+        EXPECT_EQ(xarray<double>(v), xarray<double>(view(a, range(1, 100002)) - 3.));
+        EXPECT_EQ(vres(0), 0.);
+        EXPECT_EQ(vres(100002), 0.);
+
+        std::size_t threshold = exec::streaming_threshold();
+        EXPECT_EQ(threshold, std::size_t(XTENSOR_STREAMING_THRESHOLD));
+        exec::set_streaming_threshold(0);
+        xarray<float> fres = zeros<float>({1001});
+        xarray<float> fa = arange<float>(1001.f);
+        noalias(fres) = fa * 3.f;
+        EXPECT_EQ(fres, xarray<float>(fa * 3.f));
+        exec::set_streaming_threshold(threshold);
+        EXPECT_EQ(exec::streaming_threshold(), threshold);
+    }
+
+#if defined(XTENSOR_USE_XSIMD)
+    TEST(xexecution, strided_loop_assigner)
+    {
+        xthread_pool pool(3);
+        xarray<double> a = arange<double>(24000.);
+        a.reshape({20, 30, 40});
+        auto v = view(a, all(), range(1, 29), range(3, 38));
+
+        xarray<double> expected = v;
+        xarray<double> res(expected.shape());
+        strided_loop_assigner<true>::run(res, v, exec::par(pool, 0, 1));
+        EXPECT_EQ(res, expected);
+
+        xarray<double, layout_type::column_major> ca = a;
+        auto cv = view(ca, range(2, 19), range(1, 29), all());
+        xarray<double, layout_type::column_major> cexpected = cv;
+        xarray<double, layout_type::column_major> cres(cexpected.shape());
+        strided_loop_assigner<true>::run(cres, cv, exec::par(pool, 0, 1));
+        EXPECT_EQ(cres, cexpected);
+
+        xarray<double> vres = zeros<double>({20, 30, 40});
+        auto dst = view(vres, all(), range(1, 29), range(3, 38));
+        strided_loop_assigner<true>::run(dst, v + 1., exec::par(pool, 0, 1));
+        EXPECT_EQ(xarray<double>(dst), xarray<double>(v + 1.));
+    }
+#endif
+}
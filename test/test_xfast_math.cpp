@@ -0,0 +1,150 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <limits>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfast_math.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Largest relative error of res against ref, the results close to
+        // zero being compared with an absolute tolerance
+        template <class E1, class E2>
+        double max_error(const E1& res, const E2& ref)
+        {
+            double err = 0.;
+            auto it = ref.cbegin();
+            for (auto r : res)
+            {
+                double d = std::abs(static_cast<double>(r) - static_cast<double>(*it));
+                double scale = (std::max)(std::abs(static_cast<double>(*it)), 1e-3);
+                err = (std::max)(err, d / scale);
+                ++it;
+            }
+            return err;
+        }
+    }
+
+    TEST(xfast_math, float_accuracy)
+    {
+        xtensor<float, 1> a = linspace<float>(-80.f, 80.f, 4001);
+        xtensor<float, 1> p = linspace<float>(1e-3f, 1e3f, 4001);
+        xtensor<float, 1> s = linspace<float>(-1.5f, 1.5f, 4001);
+
+        xtensor<float, 1> res = fast::exp(a);
+        EXPECT_LT(max_error(res, xt::exp(a)), 5e-7);
+        res = fast::log(p);
+        EXPECT_LT(max_error(res, xt::log(p)), 5e-7);
+        res = fast::sin(a);
+        EXPECT_LT(max_error(res, xt::sin(a)), 5e-7);
+        res = fast::cos(a);
+        EXPECT_LT(max_error(res, xt::cos(a)), 5e-7);
+        res = fast::tanh(s * 4.f);
+        EXPECT_LT(max_error(res, xt::tanh(s * 4.f)), 5e-7);
+        res = fast::erf(s * 3.f);
+        EXPECT_LT(max_error(res, xt::erf(s * 3.f)), 5e-7);
+    }
+
+    TEST(xfast_math, double_accuracy)
+    {
+        xtensor<double, 1> a = linspace<double>(-700., 700., 20001);
+        xtensor<double, 1> p = linspace<double>(1e-6, 1e6, 20001);
+        xtensor<double, 1> s = linspace<double>(-1.5, 1.5, 20001);
+
+        xtensor<double, 1> res = fast::exp(a);
+        EXPECT_LT(max_error(res, xt::exp(a)), 1e-15);
+        res = fast::log(p);
+        EXPECT_LT(max_error(res, xt::log(p)), 1e-15);
+        res = fast::sin(a);
+        EXPECT_LT(max_error(res, xt::sin(a)), 1e-13);
+        res = fast::cos(a);
+        EXPECT_LT(max_error(res, xt::cos(a)), 1e-13);
+        res = fast::tanh(s * 4.);
+        EXPECT_LT(max_error(res, xt::tanh(s * 4.)), 1e-15);
+        res = fast::erf(s * 3.);
+        EXPECT_LT(max_error(res, xt::erf(s * 3.)), 1e-15);
+    }
+
+    TEST(xfast_math, special_values)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> x = {inf, -inf, nan, 0., -0., 1e300, -1e300};
+
+        xarray<double> e = fast::exp(x);
+        EXPECT_EQ(e(0), inf);
+        EXPECT_EQ(e(1), 0.);
+        EXPECT_TRUE(std::isnan(e(2)));
+        EXPECT_EQ(e(3), 1.);
+        EXPECT_EQ(e(5), inf);
+        EXPECT_EQ(e(6), 0.);
+
+        xarray<double> l = fast::log(x);
+        EXPECT_EQ(l(0), inf);
+        EXPECT_TRUE(std::isnan(l(1)));
+        EXPECT_TRUE(std::isnan(l(2)));
+        EXPECT_EQ(l(3), -inf);
+        EXPECT_TRUE(std::isnan(l(6)));
+        xarray<double> tiny = {std::numeric_limits<double>::denorm_min(), 1e-310};
+        xarray<double> ltiny = fast::log(tiny);
+        EXPECT_LT(std::abs(ltiny(0) - std::log(tiny(0))), 1e-12);
+        EXPECT_LT(std::abs(ltiny(1) - std::log(tiny(1))), 1e-12);
+
+        xarray<double> sn = fast::sin(x);
+        EXPECT_TRUE(std::isnan(sn(0)));
+        EXPECT_TRUE(std::isnan(sn(2)));
+        EXPECT_TRUE(std::signbit(sn(4)));
+        xarray<double> cs = fast::cos(x);
+        EXPECT_TRUE(std::isnan(cs(1)));
+        EXPECT_EQ(cs(3), 1.);
+
+        xarray<double> th = fast::tanh(x);
+        EXPECT_EQ(th(0), 1.);
+        EXPECT_EQ(th(1), -1.);
+        EXPECT_TRUE(std::isnan(th(2)));
+        EXPECT_TRUE(std::signbit(th(4)));
+
+        xarray<double> ef = fast::erf(x);
+        EXPECT_EQ(ef(0), 1.);
+        EXPECT_EQ(ef(1), -1.);
+        EXPECT_TRUE(std::isnan(ef(2)));
+        EXPECT_EQ(ef(3), 0.);
+        EXPECT_EQ(ef(6), -1.);
+
+        xarray<float> xf = {std::numeric_limits<float>::infinity(), 100.f, -200.f};
+        xarray<float> ef32 = fast::exp(xf);
+        EXPECT_EQ(ef32(0), std::numeric_limits<float>::infinity());
+        EXPECT_EQ(ef32(1), std::numeric_limits<float>::infinity());
+        EXPECT_EQ(ef32(2), 0.f);
+    }
+
+    TEST(xfast_math, expressions)
+    {
+        xtensor<double, 2> a = linspace<double>(0.5, 5., 24).reshape({4, 6});
+        xtensor<double, 2> res = fast::exp(fast::log(a)) + fast::sin(a) * fast::sin(a) + fast::cos(a) * fast::cos(a);
+        EXPECT_LT(max_error(res, a + 1.), 1e-14);
+
+        xtensor<double, 1> row = linspace<double>(-1., 1., 6);
+        xtensor<double, 2> bres = fast::tanh(a * row);
+        EXPECT_LT(max_error(bres, xt::tanh(a * row)), 1e-15);
+
+        // Other value types use the functions of xmath
+        xtensor<int, 1> i = {1, 2, 3};
+        xtensor<double, 1> ires = fast::exp(i);
+        EXPECT_LT(max_error(ires, xt::exp(i)), 1e-15);
+    }
+}
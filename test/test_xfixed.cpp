@@ -23,6 +23,8 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xmanipulation.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xreducer.hpp"
 
 // On VS2015, when compiling in x86 mode, alignas(T) leads to C2718
 // when used for a function parameter, even indirectly. This means that
@@ -300,6 +302,52 @@ namespace xt
         using tiny_tensor = xtensor_fixed<double, xshape<2>, layout_type::row_major, false>;
         EXPECT_GT(sizeof(fixed_tensor), sizeof(tiny_tensor)); 
     }
+
+    TEST(xtensor_fixed, unrolled_assign)
+    {
+        xtensor_fixed<float, xshape<4, 5>> a = arange<float>(20.f).reshape({4, 5});
+        xtensor_fixed<float, xshape<4, 5>> b = 2.f * a + 1.f;
+        xtensor_fixed<double, xshape<4, 5>> res;
+        noalias(res) = a * b - 3.f;
+        xtensor_fixed<int, xshape<4, 5>> ires = a + b;
+        for (std::size_t i = 0; i < a.shape()[0]; ++i)
+        {
+            for (std::size_t j = 0; j < a.shape()[1]; ++j)
+            {
+                EXPECT_EQ(res(i, j), static_cast<double>(a(i, j) * b(i, j) - 3.f));
+                EXPECT_EQ(ires(i, j), static_cast<int>(a(i, j) + b(i, j)));
+            }
+        }
+
+        xtensor_fixed<float, xshape<4, 5>, layout_type::column_major> cres = a + b;
+        xtensor<float, 2> expected = a + b;
+        EXPECT_EQ(cres, expected);
+    }
+
+    TEST(xtensor_fixed, unrolled_reduction)
+    {
+        xtensor_fixed<double, xshape<3, 4, 5>> a = arange<double>(60.).reshape({3, 4, 5});
+        xtensor_fixed<double, xshape<3, 4, 5>, layout_type::column_major> ca = a;
+        xarray<double> da = a;
+
+        xtensor_fixed<double, xshape<3, 5>> res1 = sum(a, xshape<1>());
+        xarray<double> expected1 = sum(da, {1});
+        EXPECT_EQ(xarray<double>(res1), expected1);
+
+        auto res2 = sum(ca, xshape<0, 2>(), evaluation_strategy::immediate);
+        bool truth = std::is_same<decltype(res2), xtensor_fixed<double, xshape<4>, layout_type::column_major>>::value;
+        EXPECT_TRUE(truth);
+        xarray<double> expected2 = sum(da, {0, 2});
+        EXPECT_EQ(xarray<double>(res2), expected2);
+
+        xtensor_fixed<double, xshape<3, 4>> res3 = amax(ca, xshape<2>());
+        xarray<double> expected3 = amax(da, {2});
+        EXPECT_EQ(xarray<double>(res3), expected3);
+
+        auto res4 = sum(a, xshape<2>(), initial(10.) | evaluation_strategy::immediate);
+        xarray<double> expected4 = sum(da, {2}) + 10.;
+        EXPECT_EQ(xarray<double>(res4), expected4);
+    }
 }
 
 #endif
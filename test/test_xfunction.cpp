@@ -101,6 +101,51 @@ namespace xt
         }
     }
 
+    TEST(xfunction, cached_broadcast_shape)
+    {
+        using shape_type = layout_result<>::shape_type;
+        xfunction_features f;
+
+        // The shapes of the nested functions are cached once computed, they
+        // must then be broadcast as the shapes of their arguments.
+        auto inner_same = f.m_a + f.m_a;
+        auto inner_diff = f.m_a + f.m_b;
+        EXPECT_EQ(inner_same.shape(), f.m_a.shape());
+        EXPECT_EQ(inner_diff.shape(), f.m_a.shape());
+
+        shape_type sh = uninitialized_shape<shape_type>(3);
+        EXPECT_TRUE((inner_same * f.m_a).broadcast_shape(sh));
+        EXPECT_EQ(sh, f.m_a.shape());
+
+        sh = uninitialized_shape<shape_type>(3);
+        EXPECT_FALSE((inner_diff * f.m_a).broadcast_shape(sh));
+        EXPECT_EQ(sh, f.m_a.shape());
+
+        sh = uninitialized_shape<shape_type>(3);
+        EXPECT_FALSE((inner_same * f.m_b).broadcast_shape(sh));
+        EXPECT_EQ(sh, f.m_a.shape());
+
+        sh = uninitialized_shape<shape_type>(4);
+        EXPECT_FALSE((inner_same - f.m_c).broadcast_shape(sh));
+        EXPECT_EQ(sh, f.m_c.shape());
+
+        // An expression evaluated several times is broadcast once
+        auto func = inner_diff * f.m_a - f.m_c;
+        xarray<int> res1 = func;
+        xarray<int> res2 = func;
+        EXPECT_EQ(res1.shape(), f.m_c.shape());
+        EXPECT_EQ(res1, res2);
+        EXPECT_EQ(func.dimension(), size_t(4));
+
+        xtensor<double, 2> t1 = {{1., 2.}, {3., 4.}};
+        xtensor<double, 1> t2 = {1., 2.};
+        auto tfunc = (t1 + t2) * t2;
+        EXPECT_EQ(tfunc.dimension(), size_t(2));
+        xtensor<double, 2> tres = tfunc;
+        xtensor<double, 2> texpected = {{2., 8.}, {4., 12.}};
+        EXPECT_EQ(tres, texpected);
+    }
+
     TEST(xfunction, broadcast_shape_exception)
     {
         xt::xarray<double> arr1{ { 1.0, 2.0, 3.0 } };
@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xhalf.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xhalf, float16_conversion)
+    {
+        EXPECT_EQ(float16(1.f).bits(), 0x3c00u);
+        EXPECT_EQ(float16(-2.f).bits(), 0xc000u);
+        EXPECT_EQ(float16(65504.f).bits(), 0x7bffu);
+        EXPECT_EQ(float16(65520.f).bits(), 0x7c00u);
+        EXPECT_EQ(float16(std::numeric_limits<float>::infinity()).bits(), 0x7c00u);
+        EXPECT_TRUE(std::isnan(float(float16(std::numeric_limits<float>::quiet_NaN()))));
+
+        // Round to nearest even
+        EXPECT_EQ(float16(1.f + 1.f / 2048.f).bits(), 0x3c00u);
+        EXPECT_EQ(float16(1.f + 3.f / 2048.f).bits(), 0x3c02u);
+
+        // Subnormals
+        EXPECT_EQ(float16(5.9604644775390625e-8f).bits(), 0x0001u);
+        EXPECT_EQ(float16(2.9802322387695312e-8f).bits(), 0x0000u);
+        EXPECT_EQ(float(float16::from_bits(0x03ffu)), 6.097555160522461e-5f);
+
+        for (std::uint32_t b = 0; b < 0x7c00u; ++b)
+        {
+            float16 h = float16::from_bits(static_cast<std::uint16_t>(b));
+            EXPECT_EQ(float16(float(h)).bits(), b);
+        }
+        EXPECT_EQ(float(std::numeric_limits<float16>::max()), 65504.f);
+        EXPECT_EQ(float(std::numeric_limits<float16>::epsilon()), 1.f / 1024.f);
+    }
+
+    TEST(xhalf, bfloat16_conversion)
+    {
+        EXPECT_EQ(bfloat16(1.f).bits(), 0x3f80u);
+        EXPECT_EQ(float(bfloat16(3.f)), 3.f);
+        EXPECT_EQ(float(bfloat16(1.f + 1.f / 256.f)), 1.f);
+        EXPECT_EQ(float(bfloat16(1.f + 3.f / 256.f)), 1.f + 1.f / 64.f);
+        EXPECT_TRUE(std::isnan(float(bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+        EXPECT_EQ(float(std::numeric_limits<bfloat16>::epsilon()), 1.f / 128.f);
+    }
+
+    TEST(xhalf, arrays)
+    {
+        xarray<float16> a = {{1.f, 2.f, 3.f}, {4.f, 5.f, 6.f}};
+        xarray<float16> b = ones<float16>({2, 3});
+        EXPECT_TRUE((std::is_same<decltype(a + b)::value_type, float>::value));
+
+        xarray<float16> c = a * b + 0.5f;
+        EXPECT_EQ(float(c(1, 2)), 6.5f);
+        c += a;
+        EXPECT_EQ(float(c(0, 1)), 4.5f);
+        EXPECT_EQ(float(sum(a, {0, 1})()), 21.f);
+        EXPECT_EQ(float(amax(a)()), 6.f);
+
+        // Bulk conversion of contiguous buffers, with a tail
+        xtensor<float, 1> f = arange<float>(19.f) * 0.25f;
+        xtensor<float16, 1> h = f;
+        xtensor<bfloat16, 1> bh = f;
+        xtensor<float, 1> g = h;
+        xtensor<float, 1> bg = bh;
+        EXPECT_EQ(g, f);
+        EXPECT_EQ(bg, f);
+        EXPECT_EQ(sizeof(float16), 2u);
+        EXPECT_EQ(h.size() * sizeof(float16), 38u);
+    }
+}
@@ -7,13 +7,17 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
 #include <limits>
 
 #include "test_common_macros.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xhistogram.hpp"
+#include "xtensor/xmanipulation.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -70,6 +74,114 @@ namespace xt
         }
     }
 
+    TEST(xhistogram, histogram_large)
+    {
+        // Enough samples for the accumulation to be split in tasks
+        std::size_t n = 100000;
+        xt::xtensor<double, 1> data = xt::fmod(xt::arange<double>(static_cast<double>(n)) * 0.37, 10.) - 1.;
+        xt::xtensor<double, 1> weights = xt::fmod(xt::arange<double>(static_cast<double>(n)), 3.);
+        xt::xtensor<double, 1> bin_edges = xt::linspace<double>(0., 7., 71);
+
+        xt::xtensor<double, 1> expected = xt::zeros<double>({std::size_t(70)});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (data(i) >= 0. && data(i) <= 7.)
+            {
+                auto it = std::upper_bound(bin_edges.cbegin(), bin_edges.cend(), data(i));
+                std::size_t bin = (std::min)(static_cast<std::size_t>(it - bin_edges.cbegin()) - 1, std::size_t(69));
+                expected(bin) += weights(i);
+            }
+        }
+
+        xt::xtensor<double, 1> count = xt::histogram(data, bin_edges, weights);
+        EXPECT_EQ(count, expected);
+
+        xt::xtensor<double, 1> count_equal = xt::histogram(data, std::size_t(70), weights, 0., 7.);
+        EXPECT_EQ(count_equal, expected);
+
+        // Samples on the edges go to the bin on their right, except the last edge
+        xt::xtensor<double, 1> on_edges = xt::repeat(bin_edges, 2000, 0);
+        xt::xtensor<double, 1> edge_count = xt::histogram(on_edges, std::size_t(70), 0., 7.);
+        xt::xtensor<double, 1> edge_expected = xt::ones<double>({std::size_t(70)}) * 2000.;
+        edge_expected(69) = 4000.;
+        EXPECT_EQ(edge_count, edge_expected);
+        EXPECT_EQ(xt::histogram(on_edges, bin_edges), edge_expected);
+
+        xt::xtensor<double, 1> skewed_edges = xt::linspace<double>(-1.3, 2.1, 18);
+        xt::xtensor<double, 1> skewed_expected = xt::ones<double>({std::size_t(17)});
+        skewed_expected(16) = 2.;
+        EXPECT_EQ(xt::histogram(skewed_edges, std::size_t(17), -1.3, 2.1), skewed_expected);
+    }
+
+    TEST(xhistogram, histogram_bin_count)
+    {
+        xt::xtensor<double, 1> data = xt::arange<double>(1000.);
+        // IQR = 499.5, range = 999
+        std::size_t fd = static_cast<std::size_t>(std::ceil(999. * std::cbrt(1000.) / 999.));
+        EXPECT_EQ(xt::histogram_bin_count(data, xt::histogram_bin_estimator::fd), fd);
+        EXPECT_EQ(xt::histogram_bin_count(data, xt::histogram_bin_estimator::sturges), std::size_t(11));
+        EXPECT_EQ(xt::histogram_bin_count(data), (std::max)(fd, std::size_t(11)));
+
+        xt::xtensor<double, 1> bin_edges = xt::histogram_bin_edges(data, xt::histogram_bin_estimator::fd);
+        EXPECT_EQ(bin_edges.size(), fd + 1);
+        EXPECT_EQ(bin_edges(0), 0.);
+        EXPECT_EQ(bin_edges(fd), 999.);
+
+        // Zero IQR falls back to Sturges, constant data to one bin
+        xt::xtensor<double, 1> spike = {0., 0., 0., 0., 0., 0., 0., 1.};
+        EXPECT_EQ(xt::histogram_bin_count(spike, xt::histogram_bin_estimator::fd), std::size_t(4));
+        xt::xtensor<double, 1> constant = {2., 2., 2.};
+        EXPECT_EQ(xt::histogram_bin_count(constant), std::size_t(1));
+        EXPECT_EQ(xt::histogram_bin_edges(constant, xt::histogram_bin_estimator::automatic).size(), std::size_t(2));
+    }
+
+    TEST(xhistogram, histogram_accumulator)
+    {
+        xt::xtensor<double, 1> data = xt::fmod(xt::arange<double>(30000.) * 0.37, 10.) - 1.;
+        xt::xtensor<double, 1> weights = xt::fmod(xt::arange<double>(30000.), 3.);
+        auto first = xt::view(data, xt::range(0, 10000));
+        auto second = xt::view(data, xt::range(10000, 30000));
+        auto first_weights = xt::view(weights, xt::range(0, 10000));
+        auto second_weights = xt::view(weights, xt::range(10000, 30000));
+
+        {
+            xt::xtensor<double, 1> bin_edges = {0., 0.5, 2., 3., 7.};
+            auto acc = xt::make_histogram_accumulator(bin_edges);
+            acc.add(first);
+            acc.add(second);
+            EXPECT_EQ(acc.samples(), std::size_t(30000));
+            EXPECT_EQ(acc.bin_edges(), bin_edges);
+            EXPECT_EQ(acc.count(), xt::histogram(data, bin_edges));
+            EXPECT_EQ(acc.density(), xt::histogram(data, bin_edges, true));
+
+            acc.reset();
+            EXPECT_EQ(acc.samples(), std::size_t(0));
+            EXPECT_EQ(acc.count(), xt::zeros<double>({std::size_t(4)}));
+        }
+
+        {
+            auto acc = xt::make_histogram_accumulator(std::size_t(20), 0., 7.);
+            auto other = xt::make_histogram_accumulator(std::size_t(20), 0., 7.);
+            acc.add(first, first_weights);
+            other.add(second, second_weights);
+            acc.merge(other);
+            EXPECT_EQ(acc.samples(), std::size_t(30000));
+            EXPECT_EQ(acc.count(), xt::histogram(data, std::size_t(20), weights, 0., 7.));
+            EXPECT_EQ(acc.density(), xt::histogram(data, std::size_t(20), weights, 0., 7., true));
+
+            auto coarse = xt::make_histogram_accumulator(std::size_t(10), 0., 7.);
+            XT_EXPECT_THROW(acc.merge(coarse), std::runtime_error);
+        }
+
+        {
+            xt::xtensor<int, 1> int_data = {1, 4, 4, 7, 9, 12};
+            auto acc = xt::make_histogram_accumulator<int>(xt::xtensor<int, 1>{0, 5, 10});
+            acc.add(int_data);
+            xt::xtensor<int, 1> expected = {3, 2};
+            EXPECT_EQ(acc.count(), expected);
+        }
+    }
+
     TEST(xhistogram, bincount)
     {
         xtensor<int, 1> data = {1, 2, 3, 1, 1, 1, 1, 2, 3, 2, 3, 3, 3, 3};
@@ -84,6 +196,44 @@ namespace xt
         auto bc3 = bincount(data, 10);
         EXPECT_EQ(bc3.size(), std::size_t(10));
         EXPECT_EQ(bc3(3), expc(3));
+
+        xtensor<int, 1> large = xt::arange<int>(100000) % 7;
+        xtensor<int, 1> large_expc = {14286, 14286, 14286, 14286, 14286, 14285, 14285};
+        EXPECT_EQ(bincount(large), large_expc);
+        EXPECT_EQ(bincount(large, xt::ones<int>(large.shape()) * 2), large_expc * 2);
+    }
+
+    TEST(xhistogram, segment_reductions)
+    {
+        xtensor<int, 1> ids = {2, 0, 2, 2, 0, 3};
+        xtensor<int, 1> values = {1, 2, 3, 4, 5, 6};
+        xarray<int> sums = {7, 0, 8, 6};
+        xarray<double> means = {3.5, 0., 8. / 3., 6.};
+        xarray<int> mins = {2, (std::numeric_limits<int>::max)(), 1, 6};
+        xarray<int> maxs = {5, std::numeric_limits<int>::lowest(), 4, 6};
+        EXPECT_EQ(segment_sum(values, ids, 4), sums);
+        EXPECT_EQ(segment_mean(values, ids, 4), means);
+        EXPECT_EQ(segment_min(values, ids, 4), mins);
+        EXPECT_EQ(segment_max(values, ids, 4), maxs);
+        XT_EXPECT_THROW(segment_sum(values, ids, 3), std::runtime_error);
+
+        xtensor<int, 2> rows = {{1, 2}, {3, 4}, {5, 6}};
+        xtensor<int, 1> row_ids = {1, 1, 0};
+        xarray<int> row_sums = {{5, 6}, {4, 6}};
+        EXPECT_EQ(segment_sum(rows, row_ids, 2, xt::exec::seq), row_sums);
+
+        // sorted and unsorted ids over several tasks
+        std::size_t n = 100000;
+        xtensor<int, 1> sorted_ids = xt::arange<int>(static_cast<int>(n)) / 1000;
+        xtensor<int, 1> unsorted_ids = xt::arange<int>(static_cast<int>(n)) % 7;
+        xtensor<int, 1> ones = xt::ones<int>({n});
+        xtensor<int, 1> large = xt::arange<int>(static_cast<int>(n));
+        EXPECT_EQ(segment_sum(ones, sorted_ids, 100), xarray<int>(xt::ones<int>({100}) * 1000));
+        EXPECT_EQ(segment_sum(ones, unsorted_ids, 7, xt::exec::par()), xarray<int>(bincount(unsorted_ids)));
+        xarray<int> expected_max = xt::arange<int>(100) * 1000 + 999;
+        EXPECT_EQ(segment_max(large, sorted_ids, 100, xt::exec::par()), expected_max);
+        xarray<int> expected_min = xt::arange<int>(7);
+        EXPECT_EQ(segment_min(large, unsorted_ids, 7, xt::exec::par()), expected_min);
     }
 
     TEST(xhistogram, digitize)
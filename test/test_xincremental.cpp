@@ -0,0 +1,71 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xincremental.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xincremental, dirty_region)
+    {
+        xdirty_region region(std::vector<std::size_t>{6, 8});
+        EXPECT_TRUE(region.empty());
+
+        region.mark(std::vector<std::size_t>{1, 2}, std::vector<std::size_t>{3, 5});
+        region.mark(std::vector<std::size_t>{1, 3}, std::vector<std::size_t>{2, 4});
+        region.mark(std::vector<std::size_t>{2, 2}, std::vector<std::size_t>{2, 8});
+        EXPECT_EQ(region.boxes().size(), std::size_t(1));
+
+        region.mark(std::vector<std::size_t>{0, 0}, std::vector<std::size_t>{4, 6});
+        ASSERT_EQ(region.boxes().size(), std::size_t(1));
+        EXPECT_EQ(region.boxes()[0].end[1], std::size_t(6));
+
+        XT_EXPECT_THROW(region.mark(std::vector<std::size_t>{0, 0}, std::vector<std::size_t>{7, 1}), std::out_of_range);
+
+        for (std::size_t i = 0; i < 2 * xdirty_region::max_boxes; i += 2)
+        {
+            region.mark(std::vector<std::size_t>{5, i % 8}, std::vector<std::size_t>{6, i % 8 + 1});
+        }
+        EXPECT_LT(region.boxes().size(), xdirty_region::max_boxes + 1);
+
+        region.clear();
+        EXPECT_TRUE(region.empty());
+    }
+
+    TEST(xincremental, update)
+    {
+        xtensor<double, 2> a = arange<double>(48.).reshape({6, 8});
+        xtensor<double, 2> b = ones<double>({6, 8});
+        xtensor<double, 2> res = 2. * a + sqrt(b);
+
+        auto ta = track(a);
+        auto tb = track(b);
+        ta.view(range(1, 3), all()) = 10.;
+        ta(5, 7) = -1.;
+        tb.view(4, keep(1, 6)) = 4.;
+        EXPECT_EQ(ta.dirty_region().boxes().size(), std::size_t(2));
+
+        xtensor<double, 2> expected = 2. * a + sqrt(b);
+        update(res, 2. * a + sqrt(b), ta.dirty_region());
+        EXPECT_FALSE(res == expected);
+        update(res, 2. * a + sqrt(b), tb.dirty_region());
+        EXPECT_EQ(res, expected);
+
+        ta.clear();
+        update(res, 2. * a, ta.dirty_region());
+        EXPECT_EQ(res, expected);
+
+        xtensor<double, 2> small = zeros<double>({2, 2});
+        XT_EXPECT_THROW(update(small, 2. * a, ta.dirty_region()), std::runtime_error);
+    }
+}
@@ -177,4 +177,56 @@ namespace xt
         xarray<double> expected = {{1, 2, 3}, {5, 7, 9}};
         EXPECT_EQ(expected, b);
     }
+    TEST(xindex_view, extract)
+    {
+        xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+        xtensor<double, 1> res = extract(a >= 5, a);
+        xtensor<double, 1> expected = {5, 5, 6};
+        EXPECT_EQ(expected, res);
+
+        xtensor<double, 1> resc = extract<layout_type::column_major>(a >= 4, a);
+        xtensor<double, 1> expectedc = {4, 5, 5, 6};
+        EXPECT_EQ(expectedc, resc);
+
+        xarray<double> b = xarray<double>(filter(a + 1., a + 1. > 4.));
+        EXPECT_EQ(b, xarray<double>(extract(a > 3., a + 1.)));
+
+        EXPECT_EQ(std::size_t(0), extract(a > 10., a).size());
+        xtensor<double, 1> row = {2, 6, 1};
+        xtensor<double, 1> resb = extract(a > row, a);
+        xtensor<double, 1> expectedb = {3, 4, 6};
+        EXPECT_EQ(expectedb, resb);
+        XT_EXPECT_THROW(extract(row > 1., a), std::runtime_error);
+    }
+
+    TEST(xindex_view, scatter_add)
+    {
+        xarray<double> a = {0, 0, 0};
+        scatter_add(a, xarray<int>{0, 2, 0}, xarray<double>{1, 2, 3});
+        xarray<double> expected = {4, 0, 2};
+        EXPECT_EQ(expected, a);
+
+        xarray<int, layout_type::column_major> m = {{1, 1}, {2, 2}, {3, 3}};
+        xtensor<std::size_t, 1> rows = {2, 2, 1};
+        xtensor<int, 2> v = {{1, 2}, {3, 4}, {5, 6}};
+        scatter_add(m, rows, v, xt::exec::seq);
+        xarray<int> expectedm = {{1, 1}, {7, 8}, {7, 9}};
+        EXPECT_EQ(expectedm, m);
+        XT_EXPECT_THROW(scatter_add(a, xarray<int>{3}, xarray<double>{1}), std::runtime_error);
+        XT_EXPECT_THROW(scatter_add(a, xarray<int>{0, 1}, xarray<double>{1}), std::runtime_error);
+
+        // repeated indices over many tasks add their values in the same
+        // order as the sequential loop
+        std::size_t n = 100000;
+        xtensor<int, 1> indices = (xt::arange<int>(static_cast<int>(n)) * 7919) % 1000;
+        xtensor<double, 1> values = xt::arange<double>(static_cast<double>(n)) * 0.1;
+        xarray<double> par_res = xt::zeros<double>({1000});
+        xarray<double> seq_res = xt::zeros<double>({1000});
+        scatter_add(par_res, indices, values, xt::exec::par());
+        scatter_add(seq_res, indices, values, xt::exec::seq);
+        EXPECT_EQ(seq_res, par_res);
+        xarray<double> counts = xt::zeros<double>({1000});
+        scatter_add(counts, indices, xtensor<double, 1>(xt::ones<double>({n})));
+        EXPECT_EQ(counts, xarray<double>(xt::ones<double>({1000}) * 100.));
+    }
 }
@@ -648,4 +648,32 @@ namespace xt
             EXPECT_TRUE(e_iter == exp_iter.end());
        }
     }
+    TEST(xiterator, static_dimension)
+    {
+        xtensor<int, 3> t = {{{0, 1, 2}, {3, 4, 5}}, {{6, 7, 8}, {9, 10, 11}}};
+        xarray<int> a = t;
+        xtensor<int, 1> row = {1, 2, 3};
+        auto bt = t + row;
+        auto ba = a + row;
+
+        auto rba = ba.template begin<layout_type::row_major>();
+        for (auto it = bt.template begin<layout_type::row_major>(); it != bt.template end<layout_type::row_major>(); ++it, ++rba)
+        {
+            EXPECT_EQ(*it, *rba);
+        }
+        EXPECT_TRUE(rba == ba.template end<layout_type::row_major>());
+
+        auto cba = ba.template rbegin<layout_type::column_major>();
+        for (auto it = bt.template rbegin<layout_type::column_major>(); it != bt.template rend<layout_type::column_major>(); ++it, ++cba)
+        {
+            EXPECT_EQ(*it, *cba);
+        }
+        EXPECT_TRUE(cba == ba.template rend<layout_type::column_major>());
+
+        auto cit = bt.template end<layout_type::column_major>();
+        --cit;
+        EXPECT_EQ(*cit, 14);
+        cit -= 5;
+        EXPECT_EQ(*cit, 6);
+    }
 }
@@ -9,6 +9,7 @@
 
 #include "test_common_macros.hpp"
 
+#include <sstream>
 #include <string>
 
 #include "xtensor/xarray.hpp"
@@ -62,4 +63,56 @@ namespace xt
             {3, 4}}});
         EXPECT_TRUE(all(equal(arr, ref)));
     }
+
+    TEST(xjson, xtensor_from_json)
+    {
+        nlohmann::json j = "[[1, 2, 3], [4, 5, 6]]"_json;
+        auto t = j.get<xt::xtensor<int, 2>>();
+        xt::xtensor<int, 2> ref = {{1, 2, 3}, {4, 5, 6}};
+        EXPECT_EQ(t, ref);
+
+        nlohmann::json irregular = "[[1, 2, 3], [4, 5]]"_json;
+        using tensor_type = xt::xtensor<int, 2>;
+        XT_EXPECT_THROW(irregular.get<tensor_type>(), std::runtime_error);
+    }
+
+    TEST(xjson, expression_to_json)
+    {
+        xt::xarray<int> a = {{1, 2}, {3, 4}};
+        xt::xarray<int, layout_type::column_major> b = a;
+        nlohmann::json ja = a + 1;
+        nlohmann::json jb = b;
+        EXPECT_EQ(ja.dump(), "[[2,3],[4,5]]");
+        EXPECT_EQ(jb.dump(), "[[1,2],[3,4]]");
+    }
+
+    TEST(xjson, dump_json)
+    {
+        xt::xarray<double> t =
+          {{{1, 2.5},
+            {-3, 0.1}},
+           {{1e20, 2},
+            {3, 4}}};
+        std::ostringstream out;
+        dump_json(out, t);
+        nlohmann::json jl = t;
+        EXPECT_EQ(out.str(), jl.dump());
+
+        xt::xtensor<int, 1> i = {-2, 0, 7};
+        std::ostringstream iout;
+        dump_json(iout, i);
+        EXPECT_EQ(iout.str(), "[-2,0,7]");
+
+        xt::xarray<bool> b = {{true, false}};
+        std::ostringstream bout;
+        dump_json(bout, b);
+        EXPECT_EQ(bout.str(), "[[true,false]]");
+
+        // the text reads back to the same values
+        xt::xarray<double> r = xt::xarray<double>({1. / 3., 2e-7, -123456.789});
+        std::ostringstream rout;
+        dump_json(rout, r);
+        auto back = nlohmann::json::parse(rout.str()).get<xt::xarray<double>>();
+        EXPECT_EQ(back, r);
+    }
 }
@@ -0,0 +1,83 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xkernel_holder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xkernel_holder, linear)
+    {
+        xarray<double> a = arange<double>(1000.);
+        xarray<double> b = ones<double>({1000}) * 0.5;
+        a.reshape({20, 50});
+        b.reshape({20, 50});
+
+        xkernel_holder<double> h(xt::square(a - b) + 1.);
+        EXPECT_FALSE(h.empty());
+        EXPECT_EQ(h.size(), std::size_t(1000));
+        EXPECT_EQ(h.dimension(), std::size_t(2));
+        EXPECT_EQ(h.shape()[1], std::size_t(50));
+
+        xarray<double> expected = xt::square(a - b) + 1.;
+        xarray<double> res;
+        h.assign_to(res);
+        EXPECT_EQ(res, expected);
+
+        std::vector<double> part(7);
+        h.evaluate(95, 7, part.data());
+        EXPECT_EQ(part[0], expected(1, 45));
+        EXPECT_EQ(part[6], expected(2, 1));
+        XT_EXPECT_THROW(h.evaluate(995, 7, part.data()), std::out_of_range);
+
+        // Copies share the expression, which reads the current operands
+        xkernel_holder<double> h2 = h;
+        a(0, 0) = 10.5;
+        h2.assign_to(res);
+        EXPECT_EQ(res(0, 0), 101.);
+
+        // Column-major destinations and other value types
+        xtensor<double, 2, layout_type::column_major> cres;
+        h.assign_to(cres);
+        EXPECT_EQ(cres, res);
+        xkernel_holder<float> hf(a * 2.);
+        xarray<double> fres;
+        hf.assign_to(fres);
+        EXPECT_EQ(fres, a * 2.);
+    }
+
+    TEST(xkernel_holder, broadcast_and_views)
+    {
+        xtensor<double, 2> a = arange<double>(12.).reshape({3, 4});
+        xtensor<double, 1> row = {1., 2., 3., 4.};
+
+        xkernel_holder<double> h(a * row);
+        xtensor<double, 2> res;
+        h.assign_to(res);
+        EXPECT_EQ(res, a * row);
+
+        auto v = view(a, all(), range(0, 4, 2));
+        xkernel_holder<double> hv(v + 1.);
+        xarray<double> vres;
+        hv.assign_to(vres);
+        EXPECT_EQ(vres, v + 1.);
+
+        xkernel_holder<double> empty;
+        EXPECT_TRUE(empty.empty());
+        XT_EXPECT_THROW(empty.assign_to(vres), std::runtime_error);
+    }
+}
@@ -12,6 +12,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xbuilder.hpp"
+#include "xtensor/xfixed.hpp"
 #include "xtensor/xmanipulation.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xview.hpp"
@@ -56,6 +57,49 @@ namespace xt
         EXPECT_EQ(cbw3.layout(), layout_type::dynamic);
     }
 
+    TEST(xmanipulation, transpose_inplace)
+    {
+        // Square, with a tile that does not divide the extent
+        xtensor<double, 2> sq = arange<double>(77. * 77.).reshape({77, 77});
+        xtensor<double, 2> sq_ref = transpose(sq);
+        const double* data = sq.data();
+        transpose_inplace(sq);
+        EXPECT_EQ(sq, sq_ref);
+        EXPECT_EQ(sq.data(), data);
+
+        xarray<int> rect = arange<int>(35 * 12).reshape({35, 12});
+        xarray<int> rect_ref = transpose(rect);
+        transpose_inplace(rect);
+        EXPECT_EQ(rect, rect_ref);
+        EXPECT_EQ(rect.shape(0), 12u);
+
+        xarray<int, layout_type::column_major> cm = arange<int>(6 * 5).reshape({6, 5});
+        xarray<int, layout_type::column_major> cm_ref = transpose(cm);
+        transpose_inplace(cm);
+        EXPECT_EQ(cm, cm_ref);
+        EXPECT_EQ(cm.layout(), layout_type::column_major);
+
+        xtensor<int, 3> t = arange<int>(2 * 3 * 4).reshape({2, 3, 4});
+        xtensor<int, 3> t_ref = transpose(t, {1, 2, 0});
+        transpose_inplace(t, {1, 2, 0});
+        EXPECT_EQ(t, t_ref);
+        xtensor<int, 3> t_rev = transpose(t);
+        transpose_inplace(t);
+        EXPECT_EQ(t, t_rev);
+
+        xarray<int, layout_type::column_major> c3 = arange<int>(2 * 3 * 4).reshape({2, 3, 4});
+        xarray<int, layout_type::column_major> c3_ref = transpose(c3, {2, 0, 1});
+        transpose_inplace(c3, {2, 0, 1});
+        EXPECT_EQ(c3, c3_ref);
+
+        xarray<int> row = arange<int>(7).reshape({1, 7});
+        transpose_inplace(row);
+        EXPECT_EQ(row, xarray<int>(arange<int>(7).reshape({7, 1})));
+
+        XT_EXPECT_THROW(transpose_inplace(t, {0, 0, 1}), transpose_error);
+        XT_EXPECT_THROW(transpose_inplace(t, {0, 1}), transpose_error);
+    }
+
     TEST(xmanipulation, transpose_function)
     {
         xarray<int, layout_type::row_major> a = { { 0, 1, 2 }, { 3, 4, 5 } };
@@ -192,6 +236,28 @@ namespace xt
       }
     }
 
+    TEST(xmanipulation, reshape_copy)
+    {
+        xtensor<int, 2> a = {{1, 2, 3}, {4, 5, 6}};
+
+        auto r = reshape_copy(transpose(a), {3, 2});
+        bool truthy = std::is_same<decltype(r), xtensor<int, 2, XTENSOR_DEFAULT_TRAVERSAL>>::value;
+        EXPECT_TRUE(truthy);
+        xtensor<int, 2> expected = {{1, 4}, {2, 5}, {3, 6}};
+        EXPECT_EQ(r, expected);
+
+        std::vector<std::size_t> shape = {6};
+        auto c = reshape_copy<layout_type::column_major>(a + 1, shape);
+        xarray<int, layout_type::column_major> cexpected = {2, 5, 3, 6, 4, 7};
+        EXPECT_EQ(c, cexpected);
+
+        auto f = reshape_copy(view(a, all(), range(1, 3)), xshape<4>());
+        xtensor_fixed<int, xshape<4>> fexpected = {2, 3, 5, 6};
+        EXPECT_EQ(f, fexpected);
+
+        XT_EXPECT_THROW(reshape_copy(a, {4, 2}), std::runtime_error);
+    }
+
     TEST(xmanipulation, flatnonzero)
     {
         xt::xtensor<int, 1> a = arange(-2, 3);
@@ -202,6 +268,35 @@ namespace xt
         std::vector<std::size_t> expected_b = {0, 1, 3, 4};
         EXPECT_EQ(expected_b, flatnonzero<layout_type::row_major>(b));
 
+        xt::xtensor<std::size_t, 1> expected_t = {0, 1, 3, 4};
+        EXPECT_EQ(expected_t, flatnonzero_tensor<layout_type::row_major>(b));
+        EXPECT_EQ(expected_t, flatnonzero_tensor<layout_type::row_major>(b + 0));
+    }
+
+    TEST(xmanipulation, flatnonzero_large)
+    {
+        // Spans several compaction blocks, some of them without non-zero element
+        std::size_t n = 100000;
+        xt::xtensor<double, 1> a = xt::zeros<double>({n});
+        std::vector<std::size_t> expected;
+        for (std::size_t i = 0; i < n; i += (i < 40000 || i > 70000) ? 7 : 30011)
+        {
+            a(i) = 1.;
+            expected.push_back(i);
+        }
+        EXPECT_EQ(expected, flatnonzero<layout_type::row_major>(a));
+        EXPECT_EQ(expected, flatnonzero<layout_type::row_major>(a > 0.));
+        auto t = flatnonzero_tensor<layout_type::row_major>(a);
+        ASSERT_EQ(t.size(), expected.size());
+        EXPECT_TRUE(std::equal(t.cbegin(), t.cend(), expected.cbegin()));
+
+        xt::xtensor<double, 2> b = xt::zeros<double>({n / 10, std::size_t(10)});
+        b(3, 4) = 2.;
+        b(9999, 0) = -1.;
+        std::vector<std::size_t> expected_b = {34, 99990};
+        EXPECT_EQ(expected_b, flatnonzero<layout_type::row_major>(b));
+        std::vector<std::size_t> expected_bc = {9999, 4 * (n / 10) + 3};
+        EXPECT_EQ(expected_bc, flatnonzero<layout_type::column_major>(b));
     }
 
     TEST(xmanipulation, split)
@@ -480,6 +575,72 @@ namespace xt
         ASSERT_EQ(expected8, xt::roll(e2, -2, /*axis*/2));
     }
 
+    TEST(xmanipulation, roll_blocks)
+    {
+        xtensor<int, 3> a = arange<int>(4 * 5 * 6).reshape({4, 5, 6});
+        for (std::ptrdiff_t axis = -3; axis < 3; ++axis)
+        {
+            std::size_t ax = static_cast<std::size_t>(axis < 0 ? axis + 3 : axis);
+            std::size_t extent = a.shape()[ax];
+            for (std::ptrdiff_t shift : {-7, -1, 0, 2, 13})
+            {
+                xtensor<int, 3> res = roll(a, shift, axis);
+                std::ptrdiff_t n = static_cast<std::ptrdiff_t>(extent);
+                for (std::size_t k = 0; k < extent; ++k)
+                {
+                    std::size_t src = static_cast<std::size_t>(((static_cast<std::ptrdiff_t>(k) - shift) % n + n) % n);
+                    xstrided_slice_vector sk(3, all()), ss(3, all());
+                    sk[ax] = static_cast<std::ptrdiff_t>(k);
+                    ss[ax] = static_cast<std::ptrdiff_t>(src);
+                    EXPECT_EQ(strided_view(res, sk), strided_view(a, ss));
+                }
+            }
+        }
+
+        // Column major and non contiguous expressions
+        xarray<int, layout_type::column_major> c = a;
+        EXPECT_EQ(roll(c, 2, 1), roll(a, 2, 1));
+        EXPECT_EQ(roll(c, 7), roll(a, 7));
+        auto v = view(a, range(1, 3), all(), range(0, 6, 2));
+        xarray<int> ve = v;
+        EXPECT_EQ(roll(v, 1, 2), roll(ve, 1, 2));
+        EXPECT_EQ(roll(v, -4), roll(ve, -4));
+    }
+
+    TEST(xmanipulation, flip_assign)
+    {
+        xarray<double> a = arange<double>(7. * 9. * 5.).reshape({7, 9, 5});
+        xarray<double> cpy = a;
+        xarray<double> res = flip(a);
+        EXPECT_EQ(a, cpy);
+        for (std::size_t i = 0; i < 7; ++i)
+        {
+            for (std::size_t j = 0; j < 9; ++j)
+            {
+                for (std::size_t k = 0; k < 5; ++k)
+                {
+                    EXPECT_EQ(res(i, j, k), a(6 - i, 8 - j, 4 - k));
+                }
+            }
+        }
+        xarray<double> lr = flip(a, 2);
+        EXPECT_EQ(view(lr, all(), all(), 0), view(a, all(), all(), 4));
+        EXPECT_EQ(flip(lr, 2), a);
+
+        xtensor<float, 2, layout_type::column_major> cm = arange<float>(30.f).reshape({5, 6});
+        xtensor<float, 2, layout_type::column_major> cres = flip(cm, 0);
+        EXPECT_EQ(view(cres, 0, all()), view(cm, 4, all()));
+
+        // Reversed destination and conversion
+        xtensor<int, 2> dst = zeros<int>({7, 9});
+        auto dv = flip(dst, 1);
+        dv = view(a, all(), all(), 2);
+        EXPECT_EQ(dst, flip(xarray<double>(view(a, all(), all(), 2)), 1));
+
+        xtensor<double, 2> r2 = rot90<2>(xarray<double>(view(a, all(), all(), 0)));
+        EXPECT_EQ(r2(0, 0), a(6, 8, 0));
+    }
+
     TEST(xmanipulation, repeat_all_elements_of_axis_0_of_int_array_2_times)
     {
         xarray<int> array = {
@@ -567,6 +728,102 @@ namespace xt
         ASSERT_EQ(9, repeated_array(3, 2));
     }
 
+    namespace
+    {
+        template <class R, class E>
+        bool equal_to_repeat(const R& res, const E& rep)
+        {
+            if (!std::equal(res.shape().cbegin(), res.shape().cend(), rep.shape().cbegin(), rep.shape().cend()))
+            {
+                return false;
+            }
+            bool same = true;
+            for (std::size_t i = 0; i < res.shape()[0]; ++i)
+            {
+                for (std::size_t j = 0; j < res.shape()[1]; ++j)
+                {
+                    for (std::size_t k = 0; k < res.shape()[2]; ++k)
+                    {
+                        same = same && res(i, j, k) == rep(i, j, k);
+                    }
+                }
+            }
+            return same;
+        }
+    }
+
+    TEST(xmanipulation, repeat_assign)
+    {
+        xarray<int> a = reshape_view(arange<int>(24), {2, 3, 4});
+        xtensor<int, 3, layout_type::column_major> c = a;
+        const std::vector<std::size_t> repeats[] = {{2, 0}, {1, 3, 2}, {3, 1, 0, 2}};
+
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            auto rep = xt::repeat(a, repeats[axis], axis);
+            xarray<int> res = rep;
+            EXPECT_TRUE(equal_to_repeat(res, rep));
+
+            xtensor<int, 3, layout_type::column_major> cres = xt::repeat(c, repeats[axis], axis);
+            EXPECT_TRUE(equal_to_repeat(cres, rep));
+
+            xarray<int, layout_type::column_major> mixed = rep;
+            EXPECT_TRUE(equal_to_repeat(mixed, rep));
+
+            auto sv = xt::view(a, xt::all(), xt::range(1, 3), xt::all());
+            xarray<int> vres = xt::repeat(sv, std::size_t(2), axis);
+            EXPECT_TRUE(equal_to_repeat(vres, xt::repeat(xarray<int>(sv), std::size_t(2), axis)));
+        }
+    }
+
+    TEST(xmanipulation, sliding_window_view)
+    {
+        xarray<int> a = {0, 1, 2, 3, 4};
+        auto w = sliding_window_view(a, {3}, {0});
+        ASSERT_EQ(w.shape(), (dynamic_shape<std::size_t>{3, 3}));
+        EXPECT_EQ(w, (xarray<int>{{0, 1, 2}, {1, 2, 3}, {2, 3, 4}}));
+        EXPECT_EQ(w.data(), a.data());
+        EXPECT_EQ(sum(w, {1}), (xarray<int>{3, 6, 9}));
+
+        // No copy: writing through a window modifies the expression
+        w(1, 2) = 30;
+        EXPECT_EQ(a(3), 30);
+        EXPECT_EQ(w(2, 1), 30);
+
+        // 2D windows, as for an im2col
+        xarray<int> m = arange<int>(12).reshape({3, 4});
+        auto patches = sliding_window_view(m, {2, 3});
+        ASSERT_EQ(patches.shape(), (dynamic_shape<std::size_t>{2, 2, 2, 3}));
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 2; ++j)
+            {
+                EXPECT_EQ(xarray<int>(view(patches, i, j, all(), all())),
+                          xarray<int>(view(m, range(i, i + 2), range(j, j + 3))));
+            }
+        }
+
+        // Single axis, counted from the end, on a view and on a column-major container
+        auto rows = sliding_window_view(view(m, range(1, 3), all()), 2, -1);
+        ASSERT_EQ(rows.shape(), (dynamic_shape<std::size_t>{2, 3, 2}));
+        EXPECT_EQ(rows(1, 2, 0), m(2, 2));
+        EXPECT_EQ(rows(0, 1, 1), m(1, 2));
+
+        xarray<int, layout_type::column_major> c = m;
+        auto cols = sliding_window_view(c, 2, 0);
+        EXPECT_EQ(cols(1, 3, 1), m(2, 3));
+        EXPECT_EQ(cols(0, 2, 0), m(0, 2));
+
+        // The same axis twice nests the windows
+        auto twice = sliding_window_view(a, {2, 2}, {0, 0});
+        ASSERT_EQ(twice.shape(), (dynamic_shape<std::size_t>{3, 2, 2}));
+        EXPECT_EQ(twice(2, 1, 1), a(4));
+
+        XT_EXPECT_THROW(sliding_window_view(a, 6, 0), std::runtime_error);
+        XT_EXPECT_THROW(sliding_window_view(a, {2, 2}), std::runtime_error);
+        XT_EXPECT_THROW(sliding_window_view(m, {2}, {2}), std::runtime_error);
+    }
+
     TEST(xmanipulation, zzzzzz)
     {
 
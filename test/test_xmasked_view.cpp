@@ -258,4 +258,49 @@ namespace xt
         EXPECT_EQ(data_new(0, 0), size_t(0));
         EXPECT_EQ(data_new(0, 1), size_t(11));
     }
+
+    TEST(xmasked_view, blend_assign)
+    {
+        xarray<double> data = {{ 1.,-2., 3.},
+                               { 4., 5.,-6.},
+                               { 7., 8.,-9.}};
+        xarray<bool> mask = {{ true, false,  true},
+                             {false,  true, false},
+                             { true, false,  true}};
+
+        auto masked_data = masked_view(data, mask);
+
+        xarray<double> row = {10., 20., 30.};
+        masked_data = row;
+        xarray<double> expected1 = {{10.,-2., 30.},
+                                    { 4., 20.,-6.},
+                                    {10., 8., 30.}};
+        EXPECT_EQ(data, expected1);
+
+        masked_data += row;
+        xarray<double> expected2 = {{20.,-2., 60.},
+                                    { 4., 40.,-6.},
+                                    {20., 8., 60.}};
+        EXPECT_EQ(data, expected2);
+
+        masked_data *= 0.5;
+        xarray<double> expected3 = {{10.,-2., 30.},
+                                    { 4., 20.,-6.},
+                                    {10., 8., 30.}};
+        EXPECT_EQ(data, expected3);
+
+        masked_data -= data * 2.;
+        xarray<double> expected4 = {{-10.,-2., -30.},
+                                    {  4.,-20., -6.},
+                                    {-10., 8., -30.}};
+        EXPECT_EQ(data, expected4);
+
+        xarray<int> idata = {{1, 2}, {3, 4}};
+        xarray<bool> imask = {{false, true}, {true, false}};
+        auto masked_row = masked_view(view(idata, 1, all()), view(imask, 0, all()));
+        masked_row |= xarray<int>({8, 8});
+        masked_row ^= 1;
+        xarray<int> iexpected = {{1, 2}, {3, 13}};
+        EXPECT_EQ(idata, iexpected);
+    }
 }
@@ -16,6 +16,8 @@
 #include "xtensor/xoptional_assembly.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -221,6 +223,73 @@ namespace xt
         EXPECT_EQ(res1, clip(opt_a, 2.0, 4.0));
     }
 
+    TEST(xmath, inplace)
+    {
+        xarray<double> a = {1., 2., 3., 4., 5., 6.};
+        xarray<double> expected = exp(a);
+        const double* data = a.data();
+        xarray<double>& res = exp_inplace(a);
+        EXPECT_EQ(&res, &a);
+        EXPECT_EQ(a.data(), data);
+        EXPECT_TRUE(allclose(a, expected));
+
+        xarray<double> b = {1., 2., 3., 4., 5., 6.};
+        clip_inplace(b, 2., 4.);
+        xarray<double> expected_b = {2., 2., 3., 4., 4., 4.};
+        EXPECT_EQ(b, expected_b);
+
+        xarray<double> c = {{1., 2., 3.}, {4., 5., 6.}};
+        sqrt_inplace(xt::view(c, 1, xt::all()));
+        xarray<double> expected_c = {{1., 2., 3.}, {2., std::sqrt(5.), std::sqrt(6.)}};
+        EXPECT_TRUE(allclose(c, expected_c));
+
+        double inf = std::numeric_limits<double>::infinity();
+        xtensor<double, 1> d = {std::nan(""), inf, -inf, 1.};
+        nan_to_num_inplace(d);
+        xtensor<double, 1> expected_d = {0., std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), 1.};
+        EXPECT_EQ(d, expected_d);
+    }
+
+    TEST(xmath, saturating_add_sub)
+    {
+        xarray<uint8_t> a = {uint8_t(10), uint8_t(200), uint8_t(255)};
+        xarray<uint8_t> b = {uint8_t(20), uint8_t(100), uint8_t(1)};
+
+        xarray<uint8_t> sum = saturating_add(a, b);
+        xarray<uint8_t> sum_exp = {uint8_t(30), uint8_t(255), uint8_t(255)};
+        EXPECT_EQ(sum, sum_exp);
+
+        xarray<uint8_t> diff = saturating_sub(b, a);
+        xarray<uint8_t> diff_exp = {uint8_t(10), uint8_t(0), uint8_t(0)};
+        EXPECT_EQ(diff, diff_exp);
+
+        xarray<uint8_t> shifted = saturating_add(a, uint8_t(60));
+        xarray<uint8_t> shifted_exp = {uint8_t(70), uint8_t(255), uint8_t(255)};
+        EXPECT_EQ(shifted, shifted_exp);
+
+        xarray<int16_t> c = {int16_t(-30000), int16_t(30000), int16_t(5)};
+        xarray<int16_t> d = {int16_t(10000), int16_t(-10000), int16_t(-7)};
+        xarray<int16_t> sdiff = saturating_sub(c, d);
+        xarray<int16_t> sdiff_exp = {int16_t(-32768), int16_t(32767), int16_t(12)};
+        EXPECT_EQ(sdiff, sdiff_exp);
+
+        xarray<int64_t> e = {(std::numeric_limits<int64_t>::max)() - 1, (std::numeric_limits<int64_t>::min)() + 1};
+        xarray<int64_t> esum = saturating_add(e, int64_t(2));
+        EXPECT_EQ(esum(0), (std::numeric_limits<int64_t>::max)());
+        EXPECT_EQ(esum(1), (std::numeric_limits<int64_t>::min)() + 3);
+        xarray<int64_t> ediff = saturating_sub(e, int64_t(2));
+        EXPECT_EQ(ediff(0), (std::numeric_limits<int64_t>::max)() - 3);
+        EXPECT_EQ(ediff(1), (std::numeric_limits<int64_t>::min)());
+
+        xarray<uint64_t> u = {uint64_t(1), (std::numeric_limits<uint64_t>::max)()};
+        xarray<uint64_t> usum = saturating_add(u, uint64_t(5));
+        xarray<uint64_t> udiff = saturating_sub(u, uint64_t(5));
+        EXPECT_EQ(usum(0), uint64_t(6));
+        EXPECT_EQ(usum(1), (std::numeric_limits<uint64_t>::max)());
+        EXPECT_EQ(udiff(0), uint64_t(0));
+        EXPECT_EQ(udiff(1), (std::numeric_limits<uint64_t>::max)() - 5);
+    }
+
     TEST(xmath, sign)
     {
         shape_type shape = {3, 2};
@@ -830,6 +899,42 @@ namespace xt
         EXPECT_EQ(xt::diff(e, 5), expected8);
     }
 
+    TEST(xmath, diff_kernel)
+    {
+        // Several tiles and blocks of lanes along both axes
+        xt::xarray<double> a = xt::fmod(xt::square(xt::arange<double>(300. * 70.)), 23.);
+        a.reshape({300, 70});
+        for (std::size_t axis = 0; axis < 2; ++axis)
+        {
+            xt::xarray<double> expected = a;
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                xt::xstrided_slice_vector s1(2, xt::all()), s2(2, xt::all());
+                s1[axis] = xt::range(1, xt::xnone());
+                s2[axis] = xt::range(xt::xnone(), expected.shape()[axis] - 1);
+                expected = xt::xarray<double>(xt::strided_view(expected, s1) - xt::strided_view(expected, s2));
+            }
+            EXPECT_EQ(xt::diff(a, 3, static_cast<std::ptrdiff_t>(axis)), expected);
+            EXPECT_EQ(xt::diff(a, 3, static_cast<std::ptrdiff_t>(axis), xt::exec::par()), expected);
+
+            xt::xarray<double, xt::layout_type::column_major> ca = a;
+            xt::xarray<double, xt::layout_type::column_major> cres = xt::diff(ca, 3, static_cast<std::ptrdiff_t>(axis));
+            EXPECT_EQ(cres, expected);
+        }
+        EXPECT_EQ(xt::diff(xt::view(a, xt::range(0, 5), 2), 1), xt::xarray<double>(xt::view(a, xt::range(1, 5), 2) - xt::view(a, xt::range(0, 4), 2)));
+    }
+
+    TEST(xmath, gradient)
+    {
+        xt::xarray<int> a = {{1, 2, 4, 7}, {11, 16, 22, 29}};
+        xt::xarray<double> expected1 = {{1., 1.5, 2.5, 3.}, {5., 5.5, 6.5, 7.}};
+        EXPECT_EQ(xt::gradient(a), expected1);
+        xt::xarray<double> expected0 = {{5., 7., 9., 11.}, {5., 7., 9., 11.}};
+        EXPECT_EQ(xt::gradient(a, 2., 0), expected0);
+        EXPECT_EQ(xt::gradient(a, 0.5, 1, xt::exec::par()), 2. * expected1);
+        XT_EXPECT_THROW(xt::gradient(xt::xarray<double>{1.}), std::runtime_error);
+    }
+
     TEST(xmath, trapz)
     {
         xt::xarray<int> a = {{0, 1, 2},
@@ -852,6 +957,18 @@ namespace xt
         xt::xarray<int> d_x = {4, 6, 8};
         auto res5 = trapz(d, d_x);
         EXPECT_EQ(res5[0], 8.0);
+
+        xt::xarray<double> e_x = {{0., 1., 3.}, {0., 2., 6.}};
+        xt::xarray<double> expected6 = {3.5, 25.};
+        EXPECT_EQ(trapz(a, e_x), expected6);
+        EXPECT_EQ(trapz(a, e_x, -1, xt::exec::par()), expected6);
+        xt::xarray<double> expected7 = {3., 5., 7.};
+        EXPECT_EQ(trapz(a, xt::xarray<double>{0., 2.}, 0), expected7);
+        XT_EXPECT_THROW(trapz(a, xt::xarray<double>{0., 2., 3.}, 0), std::runtime_error);
+
+        // Longer than a block of lanes, and a lazy operand
+        xt::xarray<double> f = xt::ones<double>({3, 300});
+        EXPECT_EQ(trapz(2. * f, 0.5, 0), xt::xarray<double>(2. * xt::ones<double>({300})));
     }
 
     /********************
@@ -905,6 +1022,39 @@ namespace xt
         {
             EXPECT_EQ(f[i], x[i]);
         }
+
+        // Unsorted x-coordinates, outside of xp as well
+        xt::xtensor<double,1> xu = {2.5, -1.0, 0.5, 4.0, 1.0, 2.0, 0.25};
+        xt::xtensor<double,1> fu = {2.5, -2.0, 0.5, 5.0, 1.0, 2.0, 0.25};
+        EXPECT_EQ(xt::interp(xu, xp, fp, -2.0, 5.0), fu);
+    }
+
+    TEST(xmath, interp_large)
+    {
+        // Sorted and unsorted queries span several blocks, with duplicates
+        // and values outside of xp
+        xt::xtensor<double,1> xp = xt::arange<double>(0.0, 100.0);
+        xt::xtensor<double,1> fp = 2.0 * xp;
+        xt::xtensor<double,1> x = xt::linspace<double>(-10.0, 110.0, 5000);
+        xt::xtensor<double,1> fx = xt::where(x < 0.0, -1.0, xt::where(x > 99.0, -2.0, 2.0 * x));
+
+        auto f = xt::interp(x, xp, fp, -1.0, -2.0);
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(f[i], fx[i]);
+        }
+
+        xt::xtensor<double,1> xr = xt::flip(x, 0);
+        xt::xtensor<double,1> fr = xt::flip(fx, 0);
+        auto g = xt::interp(xr, xp, fp, -1.0, -2.0);
+        for (std::size_t i = 0; i < xr.size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(g[i], fr[i]);
+        }
+
+        xt::xtensor<double,1> xd = {1.5, 1.5, 1.5, 50.0, 50.0};
+        xt::xtensor<double,1> fd = {3.0, 3.0, 3.0, 100.0, 100.0};
+        EXPECT_EQ(xt::interp(xd, xp, fp), fd);
     }
 
     TEST(xmath, cov)
@@ -938,4 +1088,90 @@ namespace xt
 
         EXPECT_EQ(result, expected);
     }
+
+    namespace
+    {
+        template <class T>
+        xt::xtensor<T, 1> naive_convolve(const xt::xtensor<T, 1>& a, const xt::xtensor<T, 1>& v)
+        {
+            xt::xtensor<T, 1> res = xt::zeros<T>({a.size() + v.size() - 1});
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                for (std::size_t j = 0; j < v.size(); ++j)
+                {
+                    res(i + j) += a(i) * v(j);
+                }
+            }
+            return res;
+        }
+    }
+
+    TEST(xmath, convolve_kernels)
+    {
+        xt::xtensor<double, 1> x = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+        xt::xtensor<double, 1> y = { 1.0, 0.0, -1.0 };
+        xt::xtensor<double, 1> valid = { 2.0, 2.0, 2.0, 2.0 };
+        EXPECT_EQ(xt::convolve(x, y, xt::convolve_mode::valid()), valid);
+        EXPECT_EQ(xt::convolve(y, x, xt::convolve_mode::valid()), valid);
+
+        // Blocked direct path, with integral values
+        xt::xtensor<int, 1> ia = xt::arange<int>(100) % 7 - 3;
+        xt::xtensor<int, 1> iv = xt::arange<int>(13) - 6;
+        auto ifull = xt::convolve(ia, iv, xt::convolve_mode::full());
+        EXPECT_EQ(ifull, naive_convolve(ia, iv));
+        auto ivalid = xt::convolve(ia, iv, xt::convolve_mode::valid());
+        EXPECT_EQ(ivalid, xt::view(naive_convolve(ia, iv), xt::range(12, 100)));
+
+        // FFT path
+        std::size_t nv = XTENSOR_CONVOLVE_FFT_THRESHOLD + 3;
+        xt::xtensor<double, 1> a = xt::cos(xt::arange<double>(5000.) * 0.01);
+        xt::xtensor<double, 1> v = xt::arange<double>(static_cast<double>(nv)) / static_cast<double>(nv);
+        xt::xtensor<double, 1> expected = naive_convolve(a, v);
+        auto full = xt::convolve(a, v, xt::convolve_mode::full());
+        EXPECT_EQ(full.size(), expected.size());
+        EXPECT_TRUE(xt::allclose(full, expected, 1e-9, 1e-9));
+        auto result = xt::convolve(v, a, xt::convolve_mode::valid());
+        EXPECT_EQ(result.size(), 5000 - nv + 1);
+        EXPECT_TRUE(xt::allclose(result, xt::view(expected, xt::range(nv - 1, 5000)), 1e-9, 1e-9));
+    }
+
+    TEST(xmath, convolve_same)
+    {
+        xt::xtensor<double, 1> x = { 1.0, 2.0, 3.0 };
+        xt::xtensor<double, 1> y = { 0.0, 1.0, 0.5 };
+        xt::xtensor<double, 1> expected = { 1.0, 2.5, 4.0 };
+        EXPECT_EQ(xt::convolve(x, y, xt::convolve_mode::same()), expected);
+
+        xt::xtensor<double, 1> z = { 1.0, 1.0, 1.0, 1.0 };
+        xt::xtensor<double, 1> expected_even = { 3.0, 6.0, 6.0, 5.0 };
+        EXPECT_EQ(xt::convolve(x, z, xt::convolve_mode::same()), expected_even);
+    }
+
+    TEST(xmath, lazy_where)
+    {
+        xarray<double> a = {{1., -2., 3.}, {-4., 5., -6.}};
+        xarray<double> row = {1., 0., 2.};
+
+        xarray<double> res = lazy_where(a > 0., log(a), 0.);
+        xarray<double> expected = where(a > 0., log(a), 0.);
+        EXPECT_EQ(res, expected);
+
+        // The condition and the branches are broadcast
+        xarray<double> res2 = lazy_where(row > 0.5, a, -a);
+        xarray<double> expected2 = where(row > 0.5, a, -a);
+        EXPECT_EQ(res2, expected2);
+
+        // The branches are only evaluated where they are selected
+        std::size_t calls = 0;
+        auto counted = make_lambda_xfunction([&calls](double x) { ++calls; return 2. * x; }, a);
+        xarray<double> res3 = lazy_where(a > 0., counted, a, exec::seq);
+        EXPECT_EQ(calls, 3u);
+        EXPECT_EQ(res3, where(a > 0., 2. * a, a));
+
+        xthread_pool pool(3);
+        xarray<double> big = fmod(arange<double>(10000.), 7.) - 3.;
+        xarray<double> res4 = lazy_where(big > 2., sqrt(big), big, exec::par(pool));
+        xarray<double> expected4 = where(big > 2., sqrt(big), big);
+        EXPECT_EQ(res4, expected4);
+    }
 }
@@ -0,0 +1,192 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xmatmul.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Small integers, so that the products are exact in floating point
+        template <class T>
+        xarray<T> matmul_operand(std::size_t m, std::size_t n, int seed)
+        {
+            xarray<T> res = xarray<T>::from_shape({m, n});
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    res(i, j) = static_cast<T>(static_cast<int>((i * 7 + j * 3 + static_cast<std::size_t>(seed)) % 11) - 5);
+                }
+            }
+            return res;
+        }
+
+        template <class E1, class E2>
+        xarray<double> naive_matmul(const E1& a, const E2& b)
+        {
+            std::size_t m = a.shape()[0], k = a.shape()[1], n = b.shape()[1];
+            xarray<double> res = zeros<double>({m, n});
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        res(i, j) += a(i, p) * b(p, j);
+                    }
+                }
+            }
+            return res;
+        }
+    }
+
+    TEST(xmatmul, matrices)
+    {
+        // Larger than the blocks along the three dimensions
+        auto a = matmul_operand<double>(131, 300, 1);
+        auto b = matmul_operand<double>(300, 37, 2);
+        EXPECT_EQ(matmul(a, b), naive_matmul(a, b));
+        EXPECT_EQ(matmul(a, b, exec::par()), naive_matmul(a, b));
+
+        auto bt = matmul_operand<double>(37, 300, 3);
+        EXPECT_EQ(matmul(a, transpose(bt)), naive_matmul(a, xarray<double>(transpose(bt))));
+        EXPECT_EQ(matmul(a + 1., b), naive_matmul(xarray<double>(a + 1.), b));
+
+        auto ai = matmul_operand<int>(5, 7, 4);
+        auto bi = matmul_operand<int>(7, 3, 5);
+        xarray<int> ri = matmul(ai, bi);
+        EXPECT_EQ(ri, xarray<int>(naive_matmul(ai, bi)));
+
+        xarray<float> af = {{1.f, 2.f}, {3.f, 4.f}};
+        xtensor<double, 1> x = {1., -1.};
+        auto r = matmul(af, x);
+        EXPECT_TRUE((std::is_same<decltype(r)::value_type, double>::value));
+        EXPECT_EQ(r, (xarray<double>{-1., -1.}));
+        EXPECT_EQ(matmul(x, af), (xarray<double>{-2., -2.}));
+
+        XT_EXPECT_THROW(matmul(a, a), std::runtime_error);
+    }
+
+    TEST(xmatmul, stacks)
+    {
+        xarray<double> a = arange<double>(2 * 3 * 4).reshape({2, 1, 3, 4});
+        xarray<double> b = arange<double>(3 * 4 * 2).reshape({3, 4, 2});
+        xarray<double> r = matmul(a, b);
+        ASSERT_EQ(r.shape(), (xarray<double>::shape_type{2, 3, 3, 2}));
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                xarray<double> ai = view(a, i, 0, all(), all());
+                xarray<double> bj = view(b, j, all(), all());
+                EXPECT_EQ(xarray<double>(view(r, i, j, all(), all())), naive_matmul(ai, bj));
+            }
+        }
+    }
+
+    TEST(xmatmul, tensordot)
+    {
+        xarray<double> a = arange<double>(3 * 4 * 5).reshape({3, 4, 5}) - 30.;
+        xarray<double> b = arange<double>(4 * 3 * 2).reshape({4, 3, 2}) - 12.;
+
+        xarray<double> r = tensordot(a, b, {1, 0}, {0, 1});
+        ASSERT_EQ(r.shape(), (xarray<double>::shape_type{5, 2}));
+        xarray<double> expected = zeros<double>({5, 2});
+        for (std::size_t k = 0; k < 5; ++k)
+        {
+            for (std::size_t l = 0; l < 2; ++l)
+            {
+                for (std::size_t i = 0; i < 3; ++i)
+                {
+                    for (std::size_t j = 0; j < 4; ++j)
+                    {
+                        expected(k, l) += a(i, j, k) * b(j, i, l);
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(r, expected);
+
+        xarray<double> c = arange<double>(5 * 6).reshape({5, 6});
+        xarray<double> r1 = tensordot(a, c, 1);
+        ASSERT_EQ(r1.shape(), (xarray<double>::shape_type{3, 4, 6}));
+        xarray<double> flat = a;
+        flat.reshape({12, 5});
+        xarray<double> r1_flat = r1;
+        r1_flat.reshape({12, 6});
+        EXPECT_EQ(r1_flat, naive_matmul(flat, c));
+
+        xarray<double> full = tensordot(a, a, 3);
+        EXPECT_EQ(full.dimension(), std::size_t(0));
+        EXPECT_EQ(full(), sum(a * a)());
+
+        XT_EXPECT_THROW(tensordot(a, b, {2}, {0}), std::runtime_error);
+        XT_EXPECT_THROW(tensordot(a, b, {0, 0}, {1, 0}), std::runtime_error);
+        XT_EXPECT_THROW(tensordot(a, b, 4), std::runtime_error);
+    }
+
+    TEST(xmatmul, cov)
+    {
+        xarray<int> x = {{0, 1, 2}, {2, 1, 0}, {1, 1, 4}};
+        xtensor<double, 2> expected = {{1., -1., 1.5}, {-1., 1., -1.5}, {1.5, -1.5, 3.}};
+        EXPECT_EQ(expected, cov(x, true));
+        EXPECT_EQ(expected, cov(xarray<int>(transpose(x)), false));
+        EXPECT_EQ(cov(x, true), cov(x, true, xt::exec::seq));
+
+        xtensor<double, 2> r = corrcoef(x);
+        EXPECT_EQ(r(0, 1), -1.);
+        EXPECT_EQ(r(1, 1), 1.);
+        EXPECT_DOUBLE_EQ(r(0, 2), 1.5 / std::sqrt(3.));
+
+        // several blocks of variables, with observations whose means and
+        // products are exact
+        std::size_t n = 211, k = 8;
+        xarray<double> y = xarray<double>::from_shape({k, n});
+        for (std::size_t p = 0; p < k; ++p)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                y(p, i) = static_cast<double>((i * 7 + p * p * 3) % 5);
+            }
+        }
+        auto c = cov(y, false);
+        ASSERT_EQ(c.shape()[0], n);
+        bool exact = true;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                double mi = 0., mj = 0., s = 0.;
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    mi += y(p, i);
+                    mj += y(p, j);
+                }
+                mi /= double(k);
+                mj /= double(k);
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    s += (y(p, i) - mi) * (y(p, j) - mj);
+                }
+                exact = exact && c(i, j) == s / double(k - 1);
+            }
+        }
+        EXPECT_TRUE(exact);
+        EXPECT_EQ(c, cov(xarray<double>(transpose(y)), true, xt::exec::par()));
+    }
+
+}
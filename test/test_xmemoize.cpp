@@ -0,0 +1,102 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <atomic>
+#include <cstddef>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xmemoize.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xvectorize.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        std::atomic<std::size_t> n_calls(0);
+
+        double counted_twice(double x)
+        {
+            ++n_calls;
+            return 2. * x;
+        }
+    }
+
+    TEST(xmemoize, values)
+    {
+        xtensor<double, 2> a = arange<double>(-300., 300.).reshape({20, 30});
+        xtensor<double, 2> b = ones<double>({20, 30}) * 0.5;
+        auto d = memoize(a - b);
+        xtensor<double, 2> res = d * d + xt::abs(d);
+        xtensor<double, 2> expected = (a - b) * (a - b) + xt::abs(a - b);
+        EXPECT_EQ(res, expected);
+        EXPECT_EQ(d(3, 4), a(3, 4) - b(3, 4));
+        EXPECT_EQ(d.shape(), a.shape());
+
+        // The values are computed again at each assignment
+        a(0, 0) = 10.;
+        res = d * d + xt::abs(d);
+        EXPECT_EQ(res(0, 0), 9.5 * 9.5 + 9.5);
+
+        // Copies share their state and sizes not divisible by the block size
+        xarray<double> c = arange<double>(1001.);
+        auto m = memoize(c * 3.);
+        auto m2 = m;
+        xarray<double> r = m - m2 + m;
+        EXPECT_EQ(r, c * 3.);
+    }
+
+    TEST(xmemoize, evaluations)
+    {
+        auto f = vectorize(counted_twice);
+        xtensor<double, 1> a = arange<double>(500.);
+
+        n_calls = 0;
+        xtensor<double, 1> res = f(a) * f(a) + f(a);
+        EXPECT_EQ(n_calls.load(), std::size_t(1500));
+
+        n_calls = 0;
+        auto m = memoize(f(a));
+        res = m * m + m;
+        EXPECT_EQ(n_calls.load(), std::size_t(500));
+        EXPECT_EQ(res(7), 14. * 14. + 14.);
+
+        // Nested memoized expressions
+        n_calls = 0;
+        auto mm = memoize(m * m);
+        res = mm + mm + m;
+        EXPECT_EQ(n_calls.load(), std::size_t(500));
+        EXPECT_EQ(res(3), 36. + 36. + 6.);
+    }
+
+    TEST(xmemoize, non_linear)
+    {
+        xtensor<double, 2> a = arange<double>(12.).reshape({3, 4});
+        xtensor<double, 1> row = {1., 2., 3., 4.};
+        auto d = memoize(a * 2.);
+
+        // Broadcasting and strided assignments are forwarded
+        xtensor<double, 2> res = d + row;
+        EXPECT_EQ(res, a * 2. + row);
+
+        xtensor<double, 2> dst = zeros<double>({3, 8});
+        auto v = view(dst, all(), range(0, 8, 2));
+        v = d * d;
+        EXPECT_EQ(view(dst, all(), range(0, 8, 2)), a * a * 4.);
+        EXPECT_EQ(view(dst, all(), range(1, 8, 2)), zeros<double>({3, 4}));
+
+        xarray<double> it_res = zeros<double>({3, 4});
+        std::copy(d.cbegin(), d.cend(), it_res.begin());
+        EXPECT_EQ(it_res, a * 2.);
+    }
+}
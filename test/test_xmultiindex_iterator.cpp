@@ -1,7 +1,10 @@
 #include "test_common.hpp"
+#include <array>
+#include <atomic>
 #include <vector>
 
 #include "xtensor/xmultiindex_iterator.hpp"
+#include "xtensor/xtensor.hpp"
 
 namespace xt
 {
@@ -32,6 +35,67 @@ TEST_SUITE("xmultiindex_iterator")
         }
         EXPECT_TRUE(iter==end);
     }
+
+    TEST_CASE("range")
+    {
+        using shape_type = std::vector<std::size_t>;
+        shape_type roi_begin{2,3,4};
+        shape_type roi_end{4,5,7};
+        auto r = make_multiindex_range<shape_type>(roi_begin, roi_end);
+        EXPECT_EQ(r.size(), 12u);
+        EXPECT_EQ(r.run_length(), 3u);
+        EXPECT_EQ(r.run_count(), 4u);
+
+        std::vector<shape_type> expected(r.begin(), r.end());
+        EXPECT_EQ(expected.size(), 12u);
+        EXPECT_EQ(*r.iterator_at(7), expected[7]);
+        EXPECT_EQ(r.iterator_at(7).linear_index(), 7u);
+        EXPECT_TRUE(r.iterator_at(12) == r.end());
+
+        std::vector<shape_type> runs;
+        r.for_each_run([&runs](const shape_type& idx, std::size_t n)
+        {
+            EXPECT_EQ(n, 3u);
+            runs.push_back(idx);
+        });
+        EXPECT_EQ(runs.size(), 4u);
+        for (std::size_t i = 0; i < runs.size(); ++i)
+        {
+            EXPECT_EQ(runs[i], expected[3 * i]);
+        }
+
+        std::vector<shape_type> visited;
+        r.for_each([&visited](const shape_type& idx) { visited.push_back(idx); });
+        EXPECT_EQ(visited, expected);
+    }
+
+    TEST_CASE("fixed_rank")
+    {
+        xtensor<double, 3> a = xtensor<double, 3>::from_shape({4, 5, 6});
+        auto r = make_multiindex_range(a.shape());
+        using index_type = typename decltype(r)::index_type;
+        EXPECT_TRUE((std::is_same<index_type, std::array<std::size_t, 3>>::value));
+
+        xthread_pool pool(3);
+        r.for_each_run([&a](const index_type& idx, std::size_t n)
+        {
+            double* p = &a.element(idx.cbegin(), idx.cend());
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                p[k] = double(100 * idx[0] + 10 * idx[1] + idx[2] + k);
+            }
+        }, exec::par(pool));
+
+        std::atomic<std::size_t> mismatches(0);
+        r.for_each([&a, &mismatches](const index_type& idx)
+        {
+            if (a(idx[0], idx[1], idx[2]) != double(100 * idx[0] + 10 * idx[1] + idx[2]))
+            {
+                ++mismatches;
+            }
+        }, exec::par(pool));
+        EXPECT_EQ(mismatches.load(), 0u);
+    }
 }
 
 }
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
 #include <xtensor/xindex_view.hpp>
 
 #include "xtl/xtype_traits.hpp"
@@ -218,6 +219,54 @@ namespace xt
     }
 
 
+    TEST(xnanfunctions, contiguous_reductions)
+    {
+        // Long enough for the vectorized accumulations, with a tail
+        xarray<double> a = xt::arange<double>(1000.0);
+        xarray<short> sa = xt::arange<short>(1000);
+        double sum = 0.;
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (i % 7 == 3)
+            {
+                a(i) = nanv;
+            }
+            else
+            {
+                sum += a(i);
+                ++count;
+            }
+        }
+
+        EXPECT_EQ(nansum(a, evaluation_strategy::immediate)(), sum);
+        EXPECT_EQ(nansum(a)(), sum);
+        EXPECT_EQ(nanmin(a, evaluation_strategy::immediate)(), 0.);
+        EXPECT_EQ(nanmax(a, evaluation_strategy::immediate)(), 999.);
+        a(0) = nanv;
+        EXPECT_EQ(nanmin(a, evaluation_strategy::immediate)(), 1.);
+        a(0) = 0.;
+
+        EXPECT_DOUBLE_EQ(nanmean(a, evaluation_strategy::immediate)(), sum / double(count));
+        EXPECT_DOUBLE_EQ(nanmean(a)(), sum / double(count));
+        EXPECT_DOUBLE_EQ(nanmean(sa, evaluation_strategy::immediate)(), 499.5);
+
+        xarray<float> fa = xt::ones<float>({3, 100});
+        xt::view(fa, 1, xt::range(0, 50)) = static_cast<float>(nanv);
+        xarray<double> efa = {1., 1., 1.};
+        EXPECT_EQ(nanmean(fa, {1}, evaluation_strategy::immediate), efa);
+        EXPECT_EQ(nanmean(fa, {1}), efa);
+        EXPECT_EQ(nanmean(fa, {0, 1}, evaluation_strategy::immediate)(), 1.);
+
+        xarray<double> n = xt::ones<double>({40}) * nanv;
+        EXPECT_EQ(nansum(n, evaluation_strategy::immediate)(), 0.);
+        EXPECT_EQ(nanprod(n, evaluation_strategy::immediate)(), 1.);
+        EXPECT_TRUE(std::isnan(nanmin(n, evaluation_strategy::immediate)()));
+        EXPECT_TRUE(std::isnan(nanmax(n, evaluation_strategy::immediate)()));
+        EXPECT_TRUE(std::isnan(nanmean(n, evaluation_strategy::immediate)()));
+        EXPECT_TRUE(std::isnan(nanmean(n)()));
+    }
+
     TEST(xnanfunctions, nanvar)
     {
         auto as = nanvar(nantest::aN)();
@@ -185,4 +185,44 @@ namespace xt
         EXPECT_EQ(norm_induced_l1(a, evaluation_strategy::immediate)(), 6.0);
         EXPECT_EQ(norm_induced_linf(a, evaluation_strategy::immediate)(), 7.0);
     }
+
+    TEST(xnorm, contiguous_kernels)
+    {
+        // Long enough to go through the multi-accumulator kernels and their tails
+        xarray<double> a = arange<double>(-50., 53.);
+        a.reshape({1, 103});
+        EXPECT_EQ(norm_l0(a)(), 102u);
+        EXPECT_EQ(norm_l1(a)(), 2653.);
+        EXPECT_EQ(norm_sq(a)(), 91155.);
+        EXPECT_EQ(norm_linf(a)(), 52.);
+        EXPECT_EQ(norm_lp_to_p(a, 1.)(), 2653.);
+        EXPECT_EQ(norm_lp_to_p(a, 2.)(), 91155.);
+        EXPECT_EQ(norm_l1(a, {1}, evaluation_strategy::immediate)(0), 2653.);
+        EXPECT_EQ(norm_linf(a, {0})(0, 102), 52.);
+
+        xarray<int> b = {{-3, 1, 2}, {4, -6, 0}};
+        EXPECT_EQ(norm_l1(b)(), 16);
+        EXPECT_EQ(norm_sq(b, {1}), (xarray<long long>{14, 52}));
+        EXPECT_EQ(norm_linf(b, {0}, evaluation_strategy::immediate), (xarray<int>{4, 6, 2}));
+    }
+
+    TEST(xnorm, l2_scaled)
+    {
+        double big = std::ldexp(1., 600);
+        xarray<double> a = {{3. * big, 4. * big}, {0., 0.}};
+        EXPECT_TRUE(std::isinf(norm_l2(a)()));
+        EXPECT_EQ(norm_l2_scaled(a)(), 5. * big);
+        EXPECT_EQ(norm_l2_scaled(a, {1}), (xarray<double>{5. * big, 0.}));
+
+        double small = std::ldexp(1., -600);
+        xarray<double> b = {3. * small, 4. * small};
+        EXPECT_EQ(norm_l2(b)(), 0.);
+        EXPECT_EQ(norm_l2_scaled(b)(), 5. * small);
+
+        xarray<std::complex<double>> c = {std::complex<double>(3. * big, 0.), std::complex<double>(0., 4. * big)};
+        EXPECT_EQ(norm_l2_scaled(c)(), 5. * big);
+
+        xarray<double> d = {1., std::numeric_limits<double>::infinity()};
+        EXPECT_TRUE(std::isinf(norm_l2_scaled(d)()));
+    }
 }  // namespace xt
@@ -11,9 +11,15 @@
 
 #include "xtensor/xnpy.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
 
 #include <fstream>
 #include <cstdint>
+#include <sstream>
 
 namespace xt
 {
@@ -83,6 +89,37 @@ namespace xt
         EXPECT_TRUE(all(equal(iarr1d, iarr1d_loaded)));
     }
 
+    TEST(xnpy, load_as)
+    {
+        auto darr = load_npy<double>(get_load_filename("files/xnpy_files/double"));
+        for (std::string endianness : {".le.npy", ".be.npy"})
+        {
+            auto dswapped = load_npy_as<double>("files/xnpy_files/double" + endianness);
+            EXPECT_TRUE(all(equal(dswapped, darr)));
+            auto fconverted = load_npy_as<float>("files/xnpy_files/double" + endianness);
+            EXPECT_TRUE(all(equal(fconverted, xt::cast<float>(darr))));
+
+            auto fortran = load_npy_as<float, layout_type::column_major>("files/xnpy_files/double_fortran" + endianness);
+            EXPECT_EQ(fortran.layout(), layout_type::column_major);
+            EXPECT_TRUE(all(equal(fortran, xt::cast<float>(darr))));
+
+            auto iarr = load_npy_as<std::int64_t>("files/xnpy_files/int" + endianness);
+            EXPECT_TRUE(all(equal(iarr, xarray<std::int64_t>({3, 4, 5, 6, 7}))));
+            auto uarr = load_npy_as<double>("files/xnpy_files/unsignedlong" + endianness);
+            EXPECT_TRUE(all(equal(uarr, xt::cast<double>(load_npy<unsigned long>(get_load_filename("files/xnpy_files/unsignedlong"))))));
+            auto barr = load_npy_as<int>("files/xnpy_files/bool" + endianness);
+            EXPECT_TRUE(all(equal(barr, xt::cast<int>(load_npy<bool>(get_load_filename("files/xnpy_files/bool"))))));
+        }
+
+        xarray<double> large = xt::arange<double>(20000.);
+        std::stringstream stream(dump_npy(large));
+        auto ilarge = load_npy_as<int>(stream);
+        EXPECT_TRUE(all(equal(ilarge, xt::arange<int>(20000))));
+
+        std::stringstream cstream(dump_npy(xarray<std::complex<double>>({1., 2.})));
+        XT_EXPECT_THROW(load_npy_as<double>(cstream), std::runtime_error);
+    }
+
     bool compare_binary_files(std::string fn1, std::string fn2)
     {
         std::ifstream stream1(fn1, std::ios::in | std::ios::binary);
@@ -150,6 +187,302 @@ namespace xt
         std::remove(filename.c_str());
     }
 
+    TEST(xnpy, dump_strided)
+    {
+        xarray<double> a = xt::arange<double>(5 * 6 * 7).reshape({5, 6, 7});
+        xarray<double, layout_type::column_major> ca = a;
+
+        auto check = [](const auto& e) {
+            xarray<double> expected = e;
+            EXPECT_EQ(dump_npy(e), dump_npy(expected));
+            std::stringstream stream(dump_npy(e));
+            EXPECT_EQ(load_npy<double>(stream), expected);
+        };
+
+        check(view(a, range(1, 4), all(), all()));
+        check(view(a, all(), range(1, 5), range(2, 6)));
+        check(view(a, range(0, 5, 2), 3, all()));
+        check(view(a, all(), all(), range(6, placeholders::_, -1)));
+        check(view(ca, all(), range(1, 3), all()));
+        check(strided_view(a, {all(), newaxis(), range(0, 6, 3), all()}));
+
+        std::stringstream tstream(dump_npy(transpose(a)));
+        xarray<double> texpected = transpose(a);
+        EXPECT_EQ(load_npy<double>(tstream), texpected);
+
+        xarray<double> big = xt::arange<double>(3 * 20000).reshape({3, 20000});
+        check(view(big, range(0, 3, 2), all()));
+        check(view(big, all(), range(1, 19999)));
+
+        xarray<bool> b = {{true, false, true}, {false, false, true}};
+        xarray<bool> bexpected = view(b, all(), range(1, 3));
+        EXPECT_EQ(dump_npy(view(b, all(), range(1, 3))), dump_npy(bexpected));
+    }
+
+#if defined(XTENSOR_NPY_HAS_MMAP)
+    TEST(xnpy, load_mmap)
+    {
+        auto darr = load_npy<double>(get_load_filename("files/xnpy_files/double"));
+        auto dmap = load_npy_mmap<double>(get_load_filename("files/xnpy_files/double"));
+        EXPECT_EQ(dmap.shape(), darr.shape());
+        EXPECT_TRUE(all(equal(darr, dmap)));
+
+        auto dfarr = load_npy<double, layout_type::column_major>(get_load_filename("files/xnpy_files/double_fortran"));
+        auto dfmap = load_npy_mmap<double, layout_type::column_major>(get_load_filename("files/xnpy_files/double_fortran"));
+        EXPECT_EQ(dfmap.layout(), layout_type::column_major);
+        EXPECT_TRUE(all(equal(dfarr, dfmap)));
+
+        XT_EXPECT_THROW(load_npy_mmap<int>(get_load_filename("files/xnpy_files/double")), std::runtime_error);
+        std::string fortran_filename = get_load_filename("files/xnpy_files/double_fortran");
+        XT_EXPECT_THROW((load_npy_mmap<double, layout_type::row_major>(fortran_filename)), std::runtime_error);
+
+        std::string filename = get_dump_filename(2);
+        xtensor<std::int64_t, 2> iarr = {{1, 2, 3}, {4, 5, 6}};
+        dump_npy(filename, iarr);
+        {
+            // Changes to a copy-on-write mapping are not written to the file
+            auto cow = load_npy_mmap<std::int64_t>(filename, npy_mmap_mode::copy_on_write);
+            cow(1, 2) = 60;
+            EXPECT_EQ(cow(1, 2), 60);
+            EXPECT_TRUE(all(equal(load_npy<std::int64_t>(filename), iarr)));
+        }
+        {
+            auto rw = load_npy_mmap<std::int64_t>(filename, npy_mmap_mode::read_write);
+            auto copy = rw;
+            rw(0, 0) = 10;
+            EXPECT_EQ(copy(0, 0), 10);
+        }
+        iarr(0, 0) = 10;
+        EXPECT_TRUE(all(equal(load_npy<std::int64_t>(filename), iarr)));
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, create_mmap)
+    {
+        std::string filename = get_dump_filename(3);
+        xarray<double> expected = {{0., 1., 2.}, {10., 11., 12.}};
+        {
+            auto out = create_npy_mmap<double>(filename, {2, 3});
+            EXPECT_EQ(out.shape(), expected.shape());
+            EXPECT_TRUE(all(equal(out, 0.)));
+            for (std::size_t i = 0; i < 2; ++i)
+            {
+                xt::view(out, i) = xt::arange<double>(3.) + 10. * static_cast<double>(i);
+            }
+        }
+        EXPECT_TRUE(all(equal(load_npy<double>(filename), expected)));
+        EXPECT_EQ(read_file(filename), dump_npy(expected));
+
+        {
+            std::vector<std::size_t> shape = {2, 3};
+            auto out = create_npy_mmap<double>(filename, shape, layout_type::column_major);
+            EXPECT_EQ(out.layout(), layout_type::column_major);
+            xt::noalias(out) = expected;
+        }
+        auto loaded = load_npy<double, layout_type::column_major>(filename);
+        EXPECT_TRUE(all(equal(loaded, expected)));
+        std::remove(filename.c_str());
+    }
+#endif
+
+    TEST(xnpy, writer)
+    {
+        std::string filename = get_dump_filename(4);
+        xarray<double> expected = {{0., 1., 2.}, {3., 4., 5.}, {6., 7., 8.}, {9., 10., 11.}};
+        {
+            npy_writer<double> writer(filename, {3});
+            xtensor<double, 1> frame = {0., 1., 2.};
+            writer.append(frame);
+            xarray<double, layout_type::column_major> frames = {{3., 4., 5.}, {6., 7., 8.}};
+            writer.append(frames);
+            EXPECT_EQ(writer.rows(), 3u);
+            writer.flush();
+            EXPECT_TRUE(all(equal(load_npy<double>(filename), xt::view(expected, xt::range(0, 3)))));
+
+            XT_EXPECT_THROW(writer.append(xtensor<double, 1>({1., 2.})), std::runtime_error);
+            XT_EXPECT_THROW(writer.append(xtensor<double, 3>::from_shape({1, 1, 3})), std::runtime_error);
+            writer.append(xt::arange<int>(9, 12));
+        }
+        EXPECT_EQ(read_file(filename), dump_npy(expected));
+
+        {
+            npy_writer<int> writer(filename, std::vector<std::size_t>());
+            writer.append(xt::arange<int>(5));
+            writer.close();
+            EXPECT_FALSE(writer.is_open());
+            XT_EXPECT_THROW(writer.append(xt::arange<int>(1)), std::runtime_error);
+        }
+        EXPECT_TRUE(all(equal(load_npy<int>(filename), xt::arange<int>(5))));
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, load_slice)
+    {
+        std::string filename = get_dump_filename(5);
+        xarray<double> a = xt::reshape_view(xt::arange<double>(60.), {3, 4, 5});
+        dump_npy(filename, a);
+
+        auto rows = load_npy_slice<double>(filename, xt::range(1, 3));
+        EXPECT_EQ(rows.layout(), layout_type::row_major);
+        EXPECT_TRUE(all(equal(rows, xt::view(a, xt::range(1, 3)))));
+
+        auto inner = load_npy_slice<double>(filename, xt::all(), xt::range(1, 3), xt::range(0, 5, 2));
+        EXPECT_TRUE(all(equal(inner, xt::view(a, xt::all(), xt::range(1, 3), xt::range(0, 5, 2)))));
+
+        auto squeezed = load_npy_slice<double, layout_type::row_major>(filename, 2, xt::keep(3, 0), -1);
+        EXPECT_EQ(squeezed.dimension(), 1u);
+        EXPECT_TRUE(all(equal(squeezed, xt::view(a, 2, xt::keep(3, 0), -1))));
+
+        auto whole = load_npy_slice<double>(filename);
+        EXPECT_TRUE(all(equal(whole, a)));
+
+        auto empty = load_npy_slice<double>(filename, xt::range(2, 2));
+        EXPECT_EQ(empty.size(), 0u);
+
+        XT_EXPECT_THROW(load_npy_slice<double>(filename, 3), std::out_of_range);
+        XT_EXPECT_THROW(load_npy_slice<double>(filename, 0, 0, 0, 0), std::runtime_error);
+        XT_EXPECT_THROW(load_npy_slice<float>(filename, 0), std::runtime_error);
+
+        xarray<double, layout_type::column_major> f = a;
+        dump_npy(filename, f);
+        auto fslice = load_npy_slice<double, layout_type::column_major>(filename, xt::range(0, 2), 1);
+        EXPECT_EQ(fslice.layout(), layout_type::column_major);
+        EXPECT_TRUE(all(equal(fslice, xt::view(a, xt::range(0, 2), 1))));
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, load_options)
+    {
+        std::string filename = get_dump_filename(6);
+        xarray<double> a = xt::reshape_view(xt::arange<double>(30000.), {30, 1000});
+        dump_npy(filename, a);
+
+        npy_read_options options;
+        options.chunk_size = 10000;
+        options.queue_depth = 4;
+        EXPECT_EQ(load_npy<double>(filename, options), a);
+
+        auto rows = load_npy_slice<double>(filename, options, xt::range(3, 27, 4), xt::range(10, 990));
+        xarray<double> expected = xt::view(a, xt::range(3, 27, 4), xt::range(10, 990));
+        EXPECT_EQ(rows, expected);
+
+        options.direct = true;
+        options.queue_depth = 1;
+        EXPECT_EQ(load_npy<double>(filename, options), a);
+        options.queue_depth = 8;
+        EXPECT_EQ(load_npy<double>(filename, options), a);
+        EXPECT_EQ(load_npy_slice<double>(filename, options, xt::range(3, 27, 4), xt::range(10, 990)), expected);
+
+        options.chunk_size = 0;
+        XT_EXPECT_THROW(load_npy<double>(filename, options), std::runtime_error);
+
+        // Reads past the end of a truncated file fail
+        std::string data = read_file(filename);
+        {
+            std::ofstream out(filename, std::ofstream::binary);
+            out.write(data.data(), static_cast<std::streamsize>(data.size() / 2));
+        }
+        options.chunk_size = 10000;
+        XT_EXPECT_THROW(load_npy<double>(filename, options), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, npy_source)
+    {
+        std::string filename = get_dump_filename(7);
+        xarray<double> a = xt::reshape_view(xt::arange<double>(6000.), {20, 300});
+        dump_npy(filename, a);
+
+        npy_read_options options;
+        options.chunk_size = 1000;
+        auto source = npy_source<double>(filename, options);
+        EXPECT_EQ(source.shape(), a.shape());
+        EXPECT_EQ(source(3, 7), a(3, 7));
+        EXPECT_DOUBLE_EQ(xt::sum(source)(), xt::sum(a)());
+
+        xarray<double> copy = source;
+        EXPECT_EQ(copy, a);
+        xarray<double, layout_type::column_major> ccopy = source;
+        EXPECT_EQ(ccopy, a);
+        xarray<double> shifted = source + 1.;
+        EXPECT_EQ(shifted, a + 1.);
+        xarray<double> rows = xt::sum(source, {1});
+        EXPECT_EQ(rows, xt::sum(a, {1}));
+
+        xarray<double, layout_type::column_major> f = a;
+        dump_npy(filename, f);
+        auto fsource = npy_source<double>(filename, options);
+        xarray<double, layout_type::column_major> fcopy = fsource;
+        EXPECT_EQ(fcopy, a);
+        EXPECT_DOUBLE_EQ(xt::sum(fsource)(), xt::sum(a)());
+
+        XT_EXPECT_THROW(npy_source<float>(filename), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    namespace
+    {
+        std::string make_npy(const std::string& dict, const std::string& data)
+        {
+            std::string header = dict + "\n";
+            std::string result("\x93NUMPY\x01\x00", 8);
+            result += char(header.size() & 0xff);
+            result += char(header.size() >> 8);
+            return result + header + data;
+        }
+    }
+
+    TEST(xnpy, parse_header)
+    {
+        std::int32_t values[6] = {0, 1, 2, 3, 4, 5};
+        std::string data(reinterpret_cast<const char*>(values), sizeof(values));
+        std::string descr = xtl::endianness() == xtl::endian::little_endian ? "<i4" : ">i4";
+        xarray<int> expected = {{0, 1, 2}, {3, 4, 5}};
+
+        std::stringstream reordered(make_npy("{'shape': (2, 3), 'fortran_order': False, 'descr': '" + descr + "'}", data));
+        EXPECT_EQ(load_npy<int>(reordered), expected);
+
+        std::stringstream quoted(make_npy("{\"descr\":\"" + descr + "\",\"fortran_order\":False,\"shape\":(2L,3L),}   ", data));
+        EXPECT_EQ(load_npy<int>(quoted), expected);
+
+        std::stringstream flat(make_npy("{'descr': '" + descr + "', 'fortran_order': False, 'shape': (6,), }", data));
+        EXPECT_EQ(load_npy<int>(flat).shape().size(), 1u);
+
+        std::stringstream scalar(make_npy("{'descr': '" + descr + "', 'fortran_order': False, 'shape': (), }", data));
+        EXPECT_EQ(load_npy<int>(scalar).dimension(), 0u);
+
+        std::stringstream missing(make_npy("{'descr': '" + descr + "', 'shape': (6,), }", data));
+        XT_EXPECT_THROW(load_npy<int>(missing), std::runtime_error);
+        std::stringstream bad_descr(make_npy("{'descr': 'i4', 'fortran_order': False, 'shape': (6,), }", data));
+        XT_EXPECT_THROW(load_npy<int>(bad_descr), std::runtime_error);
+        std::stringstream bad_shape(make_npy("{'descr': '" + descr + "', 'fortran_order': False, 'shape': (6,,), }", data));
+        XT_EXPECT_THROW(load_npy<int>(bad_shape), std::runtime_error);
+        std::stringstream bad_order(make_npy("{'descr': '" + descr + "', 'fortran_order': 0, 'shape': (6,), }", data));
+        XT_EXPECT_THROW(load_npy<int>(bad_order), std::runtime_error);
+        std::stringstream trailing(make_npy("{'descr': '" + descr + "', 'fortran_order': False, 'shape': (6,), } x", data));
+        XT_EXPECT_THROW(load_npy<int>(trailing), std::runtime_error);
+
+        std::string dumped = dump_npy(expected);
+        EXPECT_EQ(dumped.size() % 64, sizeof(values) % 64);
+        std::string dict = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': (2, 3), }";
+        EXPECT_EQ(dumped.substr(10, dict.size()), dict);
+        std::string dict1 = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': (3,), }";
+        EXPECT_EQ(dump_npy(xt::arange<int>(3)).substr(10, dict1.size()), dict1);
+    }
+
+    TEST(xnpy, typestring)
+    {
+        static_assert(detail::npy_typestring<float>::value[1] == 'f', "typestrings are built at compile time");
+        std::string endian = xtl::endianness() == xtl::endian::little_endian ? "<" : ">";
+        EXPECT_EQ(std::string(detail::npy_typestring<double>::value), endian + "f8");
+        EXPECT_EQ(std::string(detail::npy_typestring<std::uint16_t>::value), endian + "u2");
+        EXPECT_EQ(std::string(detail::npy_typestring<std::complex<double>>::value), endian + "c16");
+        EXPECT_EQ(std::string(detail::npy_typestring<bool>::value), "|b1");
+        EXPECT_EQ(std::string(detail::npy_typestring<std::int8_t>::value), "|i1");
+        EXPECT_EQ(detail::build_typestring<std::int64_t>(), endian + "i8");
+        XT_EXPECT_THROW(detail::build_typestring<std::string>(), std::runtime_error);
+    }
+
     TEST(xnpy, xfunction_cast)
     {
         // compilation test, cf: https://github.com/xtensor-stack/xtensor/issues/1070
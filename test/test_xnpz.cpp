@@ -0,0 +1,98 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include "xtensor/xnpz.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+namespace xt
+{
+    std::string endianness_suffix()
+    {
+        switch(xtl::endianness())
+        {
+        case xtl::endian::big_endian:
+            return ".be";
+        case xtl::endian::little_endian:
+            return ".le";
+        default:
+            return ".unsupported";
+        }
+    }
+
+    TEST(xnpz, load)
+    {
+        // Written by zipfile from the npy test files, double and
+        // bool_fortran being stored and int deflated
+        npz_file npz = load_npz("files/xnpz_files/arrays" + endianness_suffix() + ".npz");
+        EXPECT_EQ(npz.size(), 3u);
+        EXPECT_EQ(npz.names(), (std::vector<std::string>{"double", "int", "bool_fortran"}));
+        EXPECT_TRUE(npz.contains("double"));
+        EXPECT_FALSE(npz.contains("float"));
+
+        auto darr = npz.get<double>("double");
+        auto darr_npy = load_npy<double>("files/xnpy_files/double" + endianness_suffix() + ".npy");
+        EXPECT_TRUE(all(equal(darr, darr_npy)));
+
+        auto barr = npz.get<bool, layout_type::column_major>("bool_fortran");
+        EXPECT_EQ(barr.layout(), layout_type::column_major);
+        EXPECT_EQ(barr.shape(), (std::vector<std::size_t>{3, 3, 3}));
+
+#if defined(XTENSOR_USE_ZLIB)
+        auto iarr = npz.get<int>("int");
+        EXPECT_TRUE(all(equal(iarr, xarray<int>({3, 4, 5, 6, 7}))));
+#else
+        XT_EXPECT_THROW(npz.get<int>("int"), std::runtime_error);
+#endif
+        XT_EXPECT_THROW(npz.get<double>("float"), std::runtime_error);
+        XT_EXPECT_THROW(npz.get<float>("double"), std::runtime_error);
+    }
+
+    TEST(xnpz, dump)
+    {
+        std::string filename = "files/xnpz_files/test_dump.npz";
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<std::int64_t, layout_type::column_major> b = {{1, 2}, {3, 4}};
+        xarray<std::uint8_t> c = {7, 8, 9};
+        dump_npz(filename, "a", a, "b", b, "c", c);
+
+        npz_file npz(filename);
+        EXPECT_EQ(npz.names(), (std::vector<std::string>{"a", "b", "c"}));
+        auto la = npz.get<double>("a");
+        EXPECT_TRUE(all(equal(la, a)));
+        // Stored members are aligned, and adapted on the mapped archive
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(la.data()) % 64, 0u);
+        auto lb = npz.get<std::int64_t, layout_type::column_major>("b");
+        EXPECT_TRUE(all(equal(lb, b)));
+        EXPECT_TRUE(all(equal(npz.get<std::uint8_t>("c"), c)));
+
+#if defined(XTENSOR_USE_ZLIB)
+        {
+            npz_writer writer(filename, true);
+            writer.add("zeros", xt::zeros<float>({100, 100}));
+            writer.add("a", a);
+        }
+        npz_file compressed(filename);
+        EXPECT_TRUE(all(equal(compressed.get<float>("zeros"), 0.f)));
+        auto la1 = compressed.get<double>("a");
+        auto la2 = compressed.get<double>("a");
+        EXPECT_TRUE(all(equal(la1, a)));
+        // Deflated members are decompressed once
+        EXPECT_EQ(la1.data(), la2.data());
+#else
+        XT_EXPECT_THROW(npz_writer(filename, true), std::runtime_error);
+#endif
+        std::remove(filename.c_str());
+    }
+}
@@ -11,7 +11,11 @@
 #include "test_common.hpp"
 #include "test_common_macros.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
@@ -470,6 +474,56 @@ namespace xt
             EXPECT_TRUE(all(equal(a, b)));
         }
 
+        TEST_CASE("any_all_large")
+        {
+            // Long enough to be searched by blocks, and concurrently
+            // when a parallel backend is enabled
+            std::size_t n = 300000;
+            xtensor<double, 1> a = xtensor<double, 1>::from_shape({n});
+            std::fill(a.begin(), a.end(), 1.);
+            EXPECT_TRUE(all(a));
+            EXPECT_TRUE(all(a > 0.));
+            EXPECT_FALSE(any(a - 1.));
+            EXPECT_FALSE(any(equal(a, 2.)));
+
+            for (std::size_t i : {std::size_t(0), std::size_t(1029), n - 1})
+            {
+                a(i) = 0.;
+                EXPECT_FALSE(all(a));
+                EXPECT_FALSE(all(a > 0.));
+                EXPECT_TRUE(any(a - 1.));
+                EXPECT_TRUE(any(equal(a, 0.)));
+                a(i) = 1.;
+            }
+
+            xarray<double, layout_type::column_major> b = {{1., 0.}, {1., 1.}};
+            EXPECT_FALSE(all(b));
+            EXPECT_TRUE(any(b));
+        }
+
+        TEST_CASE("equality_large")
+        {
+            std::size_t n = 300000;
+            xtensor<int, 1> a = xtensor<int, 1>::from_shape({n});
+            std::iota(a.begin(), a.end(), 0);
+            xtensor<int, 1> b = a;
+            EXPECT_TRUE(a == b);
+            EXPECT_TRUE(a + 1 == b + 1);
+            b(n - 1) = 0;
+            EXPECT_FALSE(a == b);
+            EXPECT_TRUE(a != b);
+            EXPECT_FALSE(a + 1 == b + 1);
+
+            xtensor<double, 1> c = a;
+            EXPECT_TRUE(a == c);
+
+            xarray<int, layout_type::row_major> d = {{1, 2, 3}, {4, 5, 6}};
+            xarray<int, layout_type::column_major> e = {{1, 2, 3}, {4, 5, 6}};
+            EXPECT_TRUE(d == e);
+            e(1, 0) = 0;
+            EXPECT_FALSE(d == e);
+        }
+
         TEST_CASE_TEMPLATE("nonzero", TypeParam, XOPERATION_TEST_TYPES)
         {
             using int_container_2d = xop_test::rebind_container_t<TypeParam, int>;
@@ -585,6 +639,29 @@ namespace xt
             EXPECT_EQ(last_idx, d_nz.back());
         }
 
+        TEST_CASE_TEMPLATE("argwhere_traversal", TypeParam, XOPERATION_TEST_TYPES)
+        {
+            using index_type = xindex_type_t<typename TypeParam::shape_type>;
+            TypeParam a = {{3., 0., 5., 1.}, {0., 7., 2., 8.}, {4., 0., 6., 9.}};
+            xtensor<double, 1> row = {2., 1., 5., 1.};
+
+            // Linear traversal
+            std::vector<index_type> expected_r = {{0, 0}, {0, 2}, {1, 1}, {1, 2}, {1, 3}, {2, 0}, {2, 2}, {2, 3}};
+            EXPECT_EQ(expected_r, argwhere<layout_type::row_major>(a > 1.));
+            std::vector<index_type> expected_c = {{0, 0}, {2, 0}, {1, 1}, {0, 2}, {1, 2}, {2, 2}, {1, 3}, {2, 3}};
+            EXPECT_EQ(expected_c, argwhere<layout_type::column_major>(a > 1.));
+
+            // Broadcasting condition, traversed with steppers
+            std::vector<index_type> expected_b = {{0, 0}, {1, 1}, {1, 3}, {2, 0}, {2, 2}, {2, 3}};
+            EXPECT_EQ(expected_b, argwhere<layout_type::row_major>(a > row));
+            std::vector<index_type> expected_bc = {{0, 0}, {2, 0}, {1, 1}, {2, 2}, {1, 3}, {2, 3}};
+            EXPECT_EQ(expected_bc, argwhere<layout_type::column_major>(a > row));
+
+            std::vector<std::vector<std::size_t>> expected_nz = {{0, 1, 1, 2, 2, 2}, {0, 1, 3, 0, 2, 3}};
+            EXPECT_EQ(expected_nz, nonzero(a > row));
+            EXPECT_EQ(std::size_t(0), argwhere(a > 10.).size());
+        }
+
         TEST_CASE_TEMPLATE("cast", TypeParam, XOPERATION_TEST_TYPES)
         {
             using int_container_t = xop_test::rebind_container_t<TypeParam, int>;
@@ -596,6 +673,51 @@ namespace xt
             EXPECT_EQ(ref, actual);
         }
 
+        TEST_CASE("cast_conversion")
+        {
+            xarray<int> a = {{-3, 1 << 24 | 1, 7}, {100000, -5, 0}};
+            xarray<float> f = cast<float>(a);
+            xarray<double> d = cast<float>(a);
+            xarray<int> b = cast<int>(xarray<double>{{-2.5, 3.7, 1e3}, {0.2, -0.9, 8.}});
+            xarray<int> expected_b = {{-2, 3, 1000}, {0, 0, 8}};
+            bool same = true;
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                same = same && f.flat(i) == static_cast<float>(a.flat(i))
+                            && d.flat(i) == static_cast<double>(static_cast<float>(a.flat(i)));
+            }
+            EXPECT_TRUE(same);
+            EXPECT_EQ(b, expected_b);
+#if defined(XTENSOR_USE_XSIMD)
+            using functor_type = detail::cast<float>::functor;
+            EXPECT_TRUE((has_simd_apply<functor_type, xt_simd::simd_type<float>>::value));
+            EXPECT_FALSE((has_simd_apply<functor_type, xt_simd::simd_type<double>>::value));
+#endif
+        }
+
+        TEST_CASE("saturate_cast")
+        {
+            xarray<double> a = {-1., 3.7, 300., std::numeric_limits<double>::quiet_NaN(), 1e300, -1e300};
+            xarray<std::uint8_t> b = saturate_cast<std::uint8_t>(a);
+            xarray<std::uint8_t> expected_b = {0, 3, 255, 0, 255, 0};
+            EXPECT_EQ(b, expected_b);
+
+            xarray<std::int64_t> c = saturate_cast<std::int64_t>(a);
+            EXPECT_EQ(c(4), (std::numeric_limits<std::int64_t>::max)());
+            EXPECT_EQ(c(5), (std::numeric_limits<std::int64_t>::min)());
+
+            xarray<int> i = {-200, -1, 100, 70000};
+            xarray<std::int8_t> i8 = saturate_cast<std::int8_t>(i);
+            xarray<std::int8_t> expected_i8 = {-128, -1, 100, 127};
+            EXPECT_EQ(i8, expected_i8);
+            xarray<unsigned int> u = saturate_cast<unsigned int>(i);
+            xarray<unsigned int> expected_u = {0u, 0u, 100u, 70000u};
+            EXPECT_EQ(u, expected_u);
+            xarray<int> back = saturate_cast<int>(xarray<std::uint64_t>{5u, std::uint64_t(1) << 40});
+            xarray<int> expected_back = {5, (std::numeric_limits<int>::max)()};
+            EXPECT_EQ(back, expected_back);
+        }
+
         TEST_CASE_TEMPLATE("cast_custom_type", TypeParam, XOPERATION_TEST_TYPES)
         {
             using vtype_container_t = xop_test::rebind_container_t<TypeParam, vtype>;
@@ -818,6 +940,28 @@ namespace xt
 
         }
 
+        TEST(operation, narrow_integer_assign)
+        {
+            using uchar = unsigned char;
+            xt::xarray<uchar> a = { uchar(200), uchar(15), uchar(255) };
+            xt::xarray<uchar> b = { uchar(100), uchar(51), uchar(1) };
+
+            auto fw = (a + b) & ~(b * 3);
+            auto fs = a >> 1;
+            using wrapping_traits = xassign_traits<xt::xarray<uchar>, decltype(fw)>;
+            using shift_traits = xassign_traits<xt::xarray<uchar>, decltype(fs)>;
+            EXPECT_TRUE((std::is_same<typename wrapping_traits::requested_value_type, uchar>::value));
+            EXPECT_TRUE((std::is_same<typename shift_traits::requested_value_type, int>::value));
+
+            xt::xarray<uchar> res = (a + b) & ~(b * 3);
+            xt::xarray<uchar> exp = { uchar(44 & ~44), uchar(66 & ~153), uchar(0 & ~3) };
+            EXPECT_EQ(res, exp);
+
+            xt::xarray<uchar> res1 = a - 300;
+            xt::xarray<uchar> exp1 = { uchar(156), uchar(227), uchar(211) };
+            EXPECT_EQ(res1, exp1);
+        }
+
         TEST_CASE("left_shift")
         {
             xarray<int> arr({5,1, 1000});
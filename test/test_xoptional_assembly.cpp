@@ -7,9 +7,15 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "test_common_macros.hpp"
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbit_vector.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xio.hpp"
 #include "xtensor/xoptional_assembly.hpp"
 
@@ -533,4 +539,99 @@ namespace xt
         dyn_opt_ass_type g = opt(2, true) * a;
         EXPECT_EQ(res, f);
     }
+    TEST(xoptional_assembly, bit_flags)
+    {
+        using bit_opt_ass_type = xoptional_assembly<xarray<double>, xbit_array<>>;
+        using opt = xtl::xoptional<double>;
+        bit_opt_ass_type a = {{opt(1.), opt(2., false), opt(3., false), opt(4.)},
+                              {opt(5., false), opt(6.), opt(7.), opt(8., false)}};
+        bit_opt_ass_type b = {{opt(1.), opt(2.), opt(3., false), opt(4., false)},
+                              {opt(5., false), opt(6.), opt(7.), opt(8.)}};
+        EXPECT_EQ(a.has_value().storage().block_count(), 1u);
+
+        bit_opt_ass_type res = a + b * 2.;
+        EXPECT_EQ(res(0, 0), opt(3.));
+        EXPECT_FALSE(res(0, 1).has_value());
+        EXPECT_FALSE(res(0, 3).has_value());
+        EXPECT_EQ(res(1, 1), opt(18.));
+        EXPECT_EQ(res(1, 2), opt(21.));
+        EXPECT_FALSE(res(1, 3).has_value());
+        EXPECT_EQ(res.has_value().storage().count(), 3u);
+
+        // flags spanning several blocks, combined with byte flags
+        xarray<double> values = arange<double>(200.);
+        bit_opt_ass_type c(values);
+        opt_ass_type d(arange<int>(200));
+        for (std::size_t i = 0; i < 200; i += 3)
+        {
+            c(i) = xtl::missing<double>();
+        }
+        for (std::size_t i = 0; i < 200; i += 5)
+        {
+            d(i) = xtl::missing<int>();
+        }
+        bit_opt_ass_type e = c + c;
+        EXPECT_EQ(e.has_value().storage().count(), 133u);
+        bit_opt_ass_type f = c * d;
+        EXPECT_EQ(f.has_value().storage().count(), 107u);
+        EXPECT_EQ(f(7), opt(49.));
+    }
+
+    TEST(xoptional_assembly, dense_flags)
+    {
+        using dense_opt_ass_type = xoptional_assembly<xarray<double>, xarray<bool>>;
+        using opt = xtl::xoptional<double>;
+        xarray<double> values = arange<double>(100.);
+        xarray<double> doubled = values * 2.;
+        dense_opt_ass_type a(values);
+        dense_opt_ass_type b(doubled);
+        for (std::size_t i = 0; i < 100; i += 4)
+        {
+            a(i) = xtl::missing<double>();
+        }
+        for (std::size_t i = 0; i < 100; i += 6)
+        {
+            b(i) = xtl::missing<double>();
+        }
+
+        dense_opt_ass_type res = a + b;
+        EXPECT_EQ(res(1), opt(3.));
+        EXPECT_FALSE(res(4).has_value());
+        EXPECT_FALSE(res(6).has_value());
+        EXPECT_EQ(std::count(res.has_value().cbegin(), res.has_value().cend(), true), 67);
+
+        dense_opt_ass_type res2 = a * 2. + b;
+        EXPECT_EQ(res2(5), opt(20.));
+        EXPECT_EQ(std::count(res2.has_value().cbegin(), res2.has_value().cend(), true), 67);
+
+        // broadcast operands take the generic path
+        dense_opt_ass_type c = {opt(1.)};
+        dense_opt_ass_type res3 = a + c;
+        EXPECT_EQ(res3(3), opt(4.));
+        EXPECT_EQ(std::count(res3.has_value().cbegin(), res3.has_value().cend(), true), 75);
+    }
+
+    TEST(xoptional_assembly, adapt_bitmap)
+    {
+        using opt = xtl::xoptional<double>;
+        std::vector<double> values = {1., 2., 3., 4., 5., 6.};
+        // elements 0, 1, 3 and 4 are valid, starting at bit 2 of the bitmap
+        std::vector<std::uint8_t> bitmap = {0x6c};
+        auto a = adapt_bitmap(values.data(), bitmap.data(), 2, std::vector<std::size_t>{2, 3});
+        EXPECT_EQ(a(0, 0), opt(1.));
+        EXPECT_FALSE(a(0, 2).has_value());
+        EXPECT_EQ(a(1, 1), opt(5.));
+        EXPECT_FALSE(a(1, 2).has_value());
+        EXPECT_EQ(a.has_value().storage().count(), 4u);
+
+        // writes go to the adapted buffers
+        a(1, 2) = 7.;
+        EXPECT_EQ(values[5], 7.);
+        EXPECT_EQ(bitmap[0], 0xec);
+
+        // a null bitmap stands for an array without missing values
+        auto b = adapt_bitmap(values.data(), static_cast<const std::uint8_t*>(nullptr), 0, std::vector<std::size_t>{6});
+        EXPECT_EQ(b.has_value().storage().count(), 6u);
+        EXPECT_EQ(b(5), opt(7.));
+    }
 }
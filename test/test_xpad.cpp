@@ -247,6 +247,40 @@ namespace xt
         EXPECT_EQ(b, c);
     }
 
+    TEST(xpad, pad_view)
+    {
+        xt::xtensor<int, 2> a = {{0, 1, 2, 3},
+                                 {4, 5, 6, 7},
+                                 {8, 9, 10, 11}};
+        std::vector<std::vector<std::size_t>> pw = {{2, 1}, {3, 2}};
+        xt::pad_mode modes[] = {xt::pad_mode::constant, xt::pad_mode::symmetric, xt::pad_mode::reflect,
+                                xt::pad_mode::wrap, xt::pad_mode::periodic};
+
+        for (auto mode : modes)
+        {
+            xt::xtensor<int, 2> expected = xt::pad(a, pw, mode, 7);
+            auto v = xt::pad_view(a, pw, mode, 7);
+            EXPECT_EQ(v.shape(0), expected.shape(0));
+            EXPECT_EQ(v.shape(1), expected.shape(1));
+            bool same = true;
+            for (std::size_t i = 0; i < expected.shape(0); ++i)
+            {
+                for (std::size_t j = 0; j < expected.shape(1); ++j)
+                {
+                    same = same && v(i, j) == expected(i, j);
+                }
+            }
+            EXPECT_TRUE(same);
+
+            xt::xtensor<int, 2> t = v;
+            EXPECT_EQ(t, expected);
+            xt::xarray<int> r = xt::pad_view(xt::xarray<int>(a), 2, mode);
+            EXPECT_EQ(r, xt::pad(a, 2, mode));
+            xt::xtensor<int, 2> s = xt::pad_view(a, {1, 2}, mode) + 1;
+            EXPECT_EQ(s, xt::pad(a, {1, 2}, mode) + 1);
+        }
+    }
+
     TEST(xpad, tile_a)
     {
         xt::xtensor<size_t, 1> a = xt::arange<size_t>(3);
@@ -351,4 +385,33 @@ namespace xt
                                         {0., 0., 0., 1.}}};
         EXPECT_EQ(m, expected);
     }
+
+    TEST(xpad, tile_g)
+    {
+        xt::xtensor<int, 3> a = xt::reshape_view(xt::arange<int>(24), {2, 3, 4});
+        xt::xtensor<int, 3, xt::layout_type::column_major> c = a;
+        std::vector<std::size_t> reps = {2, 1, 3};
+
+        xt::xtensor<int, 3> expected = xt::xtensor<int, 3>::from_shape({4, 3, 12});
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                for (std::size_t k = 0; k < 12; ++k)
+                {
+                    expected(i, j, k) = a(i % 2, j, k % 4);
+                }
+            }
+        }
+
+        xt::xtensor<int, 3> r = xt::tile(a, reps);
+        EXPECT_EQ(r, expected);
+        xt::xtensor<int, 3, xt::layout_type::column_major> rc = xt::tile(c, reps);
+        EXPECT_EQ(rc, expected);
+        xt::xtensor<int, 3> rf = xt::tile(a + 1, reps);
+        EXPECT_EQ(rf, expected + 1);
+        auto v = xt::view(a, xt::all(), xt::range(1, 3), xt::all());
+        xt::xtensor<int, 3> rv = xt::tile(v, reps);
+        EXPECT_EQ(rv, xt::view(expected, xt::all(), xt::range(1, 3), xt::all()));
+    }
 }
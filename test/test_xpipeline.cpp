@@ -0,0 +1,83 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xpipeline.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xpipeline, evaluate)
+    {
+        xarray<double> a = arange<double>(-500., 500.) * 0.25;
+        xarray<double> b = ones<double>({1000}) * 0.5;
+        a.reshape({25, 40});
+        b.reshape({25, 40});
+
+        xpipeline<double> p;
+        auto x = p.input(a);
+        auto y = p.input(b);
+        auto d = p.apply(pipeline_op::subtract, x, y);
+        auto s = p.apply(pipeline_op::square, d);
+        auto r = p.apply(pipeline_op::add, p.apply(pipeline_op::multiply, s, p.scalar(2.)),
+                         p.apply(pipeline_op::abs, d));
+        EXPECT_EQ(p.size(), std::size_t(1000));
+        EXPECT_EQ(p.dimension(), std::size_t(2));
+
+        xarray<double> res;
+        p.assign_to(r, res);
+        xarray<double> expected = xt::square(a - b) * 2. + xt::abs(a - b);
+        EXPECT_EQ(res, expected);
+
+        // Intermediate nodes, inputs and deep chains reusing the buffers
+        p.assign_to(d, res);
+        EXPECT_EQ(res, a - b);
+        p.assign_to(x, res);
+        EXPECT_EQ(res, a);
+        auto c = x;
+        for (int i = 0; i < 10; ++i)
+        {
+            c = p.apply(pipeline_op::maximum, p.apply(pipeline_op::negate, c), y);
+        }
+        p.assign_to(c, res);
+        xarray<double> chain = a;
+        for (int i = 0; i < 10; ++i)
+        {
+            chain = xt::maximum(-chain, b);
+        }
+        EXPECT_EQ(res, chain);
+
+        auto e = p.apply(pipeline_op::exp, p.apply(pipeline_op::divide, x, p.scalar(100.)));
+        xtensor<double, 2, layout_type::column_major> cres;
+        p.assign_to(e, cres);
+        EXPECT_EQ(cres(3, 7), std::exp(a(3, 7) / 100.));
+    }
+
+    TEST(xpipeline, errors)
+    {
+        xtensor<double, 2> a = zeros<double>({3, 4});
+        xtensor<double, 2> b = zeros<double>({4, 3});
+        xtensor<double, 2, layout_type::column_major> c = zeros<double>({3, 4});
+
+        xpipeline<double> p;
+        auto x = p.input(a);
+        XT_EXPECT_THROW(p.input(b), std::runtime_error);
+        XT_EXPECT_THROW(p.input(c), std::runtime_error);
+        XT_EXPECT_THROW(p.apply(pipeline_op::add, x), std::invalid_argument);
+        XT_EXPECT_THROW(p.apply(pipeline_op::exp, x, x), std::invalid_argument);
+        XT_EXPECT_THROW(p.apply(pipeline_op::exp, x + 5), std::out_of_range);
+    }
+}
@@ -0,0 +1,138 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xprofiler.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+#if defined(XTENSOR_EXPRESSION_PROFILING)
+    namespace
+    {
+        const profiling::profile_record* find_record(const std::vector<profiling::profile_record>& records,
+                                                     const std::string& stack)
+        {
+            for (const auto& r : records)
+            {
+                if (r.stack == stack)
+                {
+                    return &r;
+                }
+            }
+            return nullptr;
+        }
+
+        // Enables the profiler with a given sample period for the duration of a test
+        struct profiling_guard
+        {
+            explicit profiling_guard(std::size_t period)
+                : m_period(profiling::sample_period())
+            {
+                profiling::reset();
+                profiling::set_sample_period(period);
+                profiling::enable();
+            }
+
+            ~profiling_guard()
+            {
+                profiling::disable();
+                profiling::set_sample_period(m_period);
+                profiling::reset();
+            }
+
+            std::size_t m_period;
+        };
+    }
+
+    TEST(xprofiler, nested_nodes)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = a + 1.;
+        xarray<double> res;
+        profiling_guard guard(1);
+        res = a * b + a;
+        profiling::disable();
+        EXPECT_EQ(res, a * b + a);
+        auto records = profiling::records();
+        const auto* root = find_record(records, "xfunction<plus>");
+        const auto* child = find_record(records, "xfunction<plus>;xfunction<multiplies>");
+        ASSERT_TRUE(root != nullptr);
+        ASSERT_TRUE(child != nullptr);
+        EXPECT_EQ(root->samples, res.size());
+        EXPECT_EQ(child->samples, res.size());
+        EXPECT_TRUE(root->time >= 0.);
+    }
+
+    TEST(xprofiler, sampling)
+    {
+        xarray<double> a = xt::ones<double>({64});
+        xarray<double> res;
+        profiling_guard guard(16);
+        res = xt::exp(a) + a;
+        profiling::disable();
+        auto records = profiling::records();
+        ASSERT_EQ(records.size(), 2u);
+        EXPECT_EQ(records[0].samples, 4u);
+        EXPECT_EQ(records[0].stack, "xfunction<plus>");
+        EXPECT_EQ(records[1].stack.find("xfunction<plus>;xfunction<exp"), 0u);
+
+        profiling::reset();
+        res = xt::exp(a) + a;
+        EXPECT_TRUE(profiling::records().empty());
+    }
+
+    TEST(xprofiler, reducers_and_views)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        profiling_guard guard(1);
+        xarray<double> s = xt::sum(a, {0}, evaluation_strategy::immediate);
+        xarray<double> v = view(a, keep(0, 1), 1) * 2.;
+        xarray<double> l = xt::sum(a * 2., {1});
+        profiling::disable();
+        EXPECT_EQ(s, xt::sum(a, {0}));
+        auto records = profiling::records();
+        const auto* immediate = find_record(records, "reduce_immediate<plus>");
+        ASSERT_TRUE(immediate != nullptr);
+        EXPECT_EQ(immediate->samples, 1u);
+        EXPECT_TRUE(find_record(records, "xfunction<multiplies>;xview") != nullptr);
+        const auto* lazy = find_record(records, "xreducer<plus>;xfunction<multiplies>");
+        ASSERT_TRUE(lazy != nullptr);
+        EXPECT_EQ(lazy->samples, a.size());
+    }
+
+    TEST(xprofiler, report)
+    {
+        xarray<double> a = {1., 2., 3.};
+        profiling_guard guard(1);
+        xarray<double> res = a + a;
+        profiling::disable();
+        std::ostringstream out;
+        profiling::report(out);
+        std::string line = out.str();
+        EXPECT_EQ(line.find("xfunction<plus> "), 0u);
+        EXPECT_EQ(line.back(), '\n');
+        EXPECT_EQ(line.find('\n'), line.size() - 1);
+    }
+#endif
+
+    TEST(xprofiler, node_name)
+    {
+        EXPECT_EQ(std::string(profiling::node_name<profiling::view_node, void>()), "xview");
+        EXPECT_EQ(std::string(profiling::node_name<profiling::function_node, detail::plus>()), "xfunction<plus>");
+    }
+}
@@ -7,7 +7,9 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include "test_common_macros.hpp"
 #include "test_common_macros.hpp"
@@ -250,4 +252,199 @@ namespace xt
         auto r2 = xt::random::permutation(ac1);
         EXPECT_EQ(a1, r2);
     }
+
+    TEST(xrandom, philox4x32)
+    {
+        // Known answers of the reference implementation of Philox4x32-10
+        random::philox4x32 zero(0);
+        random::philox4x32::block_type b = zero.block(0);
+        EXPECT_EQ(b[0], 0x6627e8d5u);
+        EXPECT_EQ(b[1], 0xe169c58du);
+        EXPECT_EQ(b[2], 0xbc57ac4cu);
+        EXPECT_EQ(b[3], 0x9b00dbd8u);
+
+        random::philox4x32 ones(0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull);
+        b = ones.block(0xFFFFFFFFFFFFFFFFull);
+        EXPECT_EQ(b[0], 0x408f276du);
+        EXPECT_EQ(b[1], 0x41c83b0eu);
+        EXPECT_EQ(b[2], 0xa20bc7c6u);
+        EXPECT_EQ(b[3], 0x6d5451fdu);
+
+        random::philox4x32 e1(42), e2(42);
+        e2.discard(6);
+        e1();
+        e1();
+        e1();
+        e1();
+        e1();
+        e1();
+        EXPECT_EQ(e1(), e2());
+        EXPECT_EQ(e1.counter(), 2u);
+        EXPECT_EQ(e2(), e1.block(1)[3]);
+    }
+
+    TEST(xrandom, philox_rand)
+    {
+        random::philox4x32 engine(1234);
+        auto r = random::rand<double>({4, 5}, 0., 1., engine);
+        xarray<double> a = r;
+        xarray<double> b = r;
+        EXPECT_EQ(a, b);
+        EXPECT_TRUE(all(a >= 0.) && all(a < 1.));
+        EXPECT_NE(a(0, 0), a(0, 1));
+
+        // The values depend on the flat index only
+        xarray<double, layout_type::column_major> c = r;
+        EXPECT_EQ(a, c);
+        random::philox4x32 engine_1d(1234);
+        xtensor<double, 1> flat = random::rand<double>({20}, 0., 1., engine_1d);
+        EXPECT_EQ(flatten(a), flat);
+        EXPECT_EQ(r(2, 3), flat(13));
+        xarray<double> v = view(r, range(1, 3), all());
+        EXPECT_EQ(v, view(a, range(1, 3), all()));
+        xarray<double> sum = r + r;
+        EXPECT_EQ(sum, a + a);
+        xarray<double, layout_type::column_major> csum = r + c;
+        EXPECT_EQ(csum, a + a);
+
+        // The engine is moved past the blocks used by r
+        xarray<double> other = random::rand<double>({4, 5}, 0., 1., engine);
+        EXPECT_NE(a, other);
+        random::philox4x32 replay(1234);
+        replay.set_counter(10);
+        xarray<double> same = random::rand<double>({4, 5}, 0., 1., replay);
+        EXPECT_EQ(other, same);
+
+        random::philox4x32 fengine(7);
+        xtensor<float, 2> f = random::rand<float>({30, 7}, -2.f, 3.f, fengine);
+        EXPECT_TRUE(all(f >= -2.f) && all(f < 3.f));
+        EXPECT_LT(std::abs(mean(f)() - 0.5f), 0.5f);
+    }
+
+    TEST(xrandom, philox_randn)
+    {
+        random::philox4x32 engine(99, 3);
+        xtensor<double, 1> a = random::randn<double>({10001}, 2., 3., engine);
+        EXPECT_LT(std::abs(mean(a)() - 2.), 0.1);
+        EXPECT_LT(std::abs(stddev(a)() - 3.), 0.1);
+
+        random::philox4x32 same(99, 3);
+        auto r = random::randn<double>({10001}, 2., 3., same);
+        EXPECT_EQ(r(10000), a(10000));
+        EXPECT_EQ(r(5), a(5));
+
+        random::philox4x32 fengine(5);
+        xtensor<float, 2> f = random::randn<float>({101, 3}, 0.f, 1.f, fengine);
+        EXPECT_LT(std::abs(mean(f)()), 0.2f);
+    }
+
+    TEST(xrandom, fill)
+    {
+        xtensor<double, 2> a = zeros<double>({30, 41});
+        const double* data = a.data();
+        random::seed(12);
+        random::fill_rand(a, 2., 3.);
+        EXPECT_EQ(a.data(), data);
+        EXPECT_TRUE(all(a >= 2.) && all(a < 3.));
+        random::seed(12);
+        xtensor<double, 2> ref = random::rand<double>({30, 41}, 2., 3.);
+        EXPECT_EQ(a, ref);
+
+        xarray<int> i = zeros<int>({7, 9});
+        random::fill_randint(i, -3, 4);
+        EXPECT_TRUE(all(i >= -3) && all(i < 4));
+
+        xtensor<double, 1> n = zeros<double>({10001});
+        random::fill_randn(n, 2., 3.);
+        EXPECT_LT(std::abs(mean(n)() - 2.), 0.1);
+        EXPECT_LT(std::abs(stddev(n)() - 3.), 0.1);
+
+        // Views are filled through a buffer
+        xarray<float> f = zeros<float>({6, 5});
+        auto v = view(f, all(), range(1, 4));
+        random::fill_randn(v, 0.f, 1.f);
+        EXPECT_TRUE(all(equal(view(f, all(), 0), 0.f)));
+        EXPECT_TRUE(all(equal(view(f, all(), 4), 0.f)));
+        EXPECT_TRUE(all(not_equal(v, 0.f)));
+    }
+
+    TEST(xrandom, philox_fill)
+    {
+        random::philox4x32 e1(5), e2(5);
+        xtensor<double, 2> a = zeros<double>({9, 7});
+        random::fill_randn(a, 1., 2., e1);
+        xtensor<double, 2> ref = random::randn<double>({9, 7}, 1., 2., e2);
+        EXPECT_EQ(a, ref);
+
+        xarray<double, layout_type::column_major> c = zeros<double>({9, 7});
+        random::fill_rand(c, 0., 1., e1);
+        xtensor<double, 2> cref = random::rand<double>({9, 7}, 0., 1., e2);
+        EXPECT_EQ(c, cref);
+        EXPECT_EQ(e1.counter(), e2.counter());
+    }
+
+    TEST(xrandom, choice_floyd)
+    {
+        xtensor<int, 1> a = arange<int>(1000);
+        xtensor<int, 1> c = random::choice(a, 300, false);
+        EXPECT_TRUE(all(isin(c, a)));
+        EXPECT_FALSE(std::is_sorted(c.begin(), c.end()));
+        std::vector<int> u(c.begin(), c.end());
+        std::sort(u.begin(), u.end());
+        EXPECT_TRUE(std::adjacent_find(u.begin(), u.end()) == u.end());
+
+        xtensor<int, 1> all_elements = random::choice(a, 1000, false);
+        std::sort(all_elements.begin(), all_elements.end());
+        EXPECT_EQ(all_elements, a);
+        EXPECT_EQ(random::choice(a, 0, false).size(), 0u);
+    }
+
+    TEST(xrandom, shuffle_rows)
+    {
+        xtensor<int, 2> a = arange<int>(60).reshape({20, 3});
+        xarray<int, layout_type::column_major> b = a;
+        random::seed(3);
+        random::shuffle(a);
+        random::seed(3);
+        random::shuffle(b);
+        EXPECT_EQ(a, b);
+        EXPECT_TRUE(all(equal(view(a, all(), 1), view(a, all(), 0) + 1)));
+        xtensor<int, 1> first = view(a, all(), 0);
+        std::sort(first.begin(), first.end());
+        EXPECT_EQ(first, arange<int>(0, 60, 3));
+    }
+
+    TEST(xrandom, philox_shuffle)
+    {
+        // Large enough to be split into several buckets
+        std::size_t n = 200000;
+        xtensor<double, 1> a = arange<double>(double(n));
+        xtensor<double, 1> b = a;
+        random::philox4x32 e1(17), e2(17);
+        random::shuffle(a, e1);
+        random::shuffle(b, e2);
+        EXPECT_EQ(a, b);
+        EXPECT_FALSE(std::is_sorted(a.begin(), a.end()));
+        EXPECT_LT(std::abs(mean(view(a, range(0, 1000)))() - double(n) / 2.), double(n) / 20.);
+        std::sort(a.begin(), a.end());
+        EXPECT_EQ(a, arange<double>(double(n)));
+
+        xtensor<int, 2> r = arange<int>(3 * 70000).reshape({70000, 3});
+        random::shuffle(r, e1);
+        EXPECT_TRUE(all(equal(view(r, all(), 2), view(r, all(), 0) + 2)));
+        xtensor<int, 1> first = view(r, all(), 0);
+        std::sort(first.begin(), first.end());
+        EXPECT_EQ(first, arange<int>(0, 3 * 70000, 3));
+
+        // Small and non contiguous expressions
+        xtensor<int, 1> s = arange<int>(10);
+        random::shuffle(s, e1);
+        std::vector<int> sorted(s.begin(), s.end());
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), arange<int>(10).begin()));
+
+        xtensor<int, 1> p = random::permutation(1000, e1);
+        std::sort(p.begin(), p.end());
+        EXPECT_EQ(p, arange<int>(1000));
+    }
 }
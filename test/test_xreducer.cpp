@@ -688,6 +688,126 @@ namespace xt
         xtensor<double, 2> input
             {{-1.0, 0.0}, {1.0, 0.0}};
         EXPECT_EQ(minmax(input)(), (A{-1.0, 1.0}));
+
+        // Long enough for the contiguous kernel, NaN values are skipped
+        xtensor<double, 1> data = xt::fmod(xt::arange<double>(1000.) * 0.37, 10.) - 1.;
+        data(517) = std::numeric_limits<double>::quiet_NaN();
+        data(3) = -7.;
+        data(998) = 12.;
+        EXPECT_EQ(minmax(data)(), (A{-7., 12.}));
+        EXPECT_EQ(minmax(data, evaluation_strategy::immediate)(), (A{-7., 12.}));
+        EXPECT_EQ(minmax(2. * data)(), (A{-14., 24.}));
+
+        xtensor<int, 1> idata = xt::arange<int>(-300, 701);
+        EXPECT_EQ(minmax(idata)(), (std::array<int, 2>{-300, 700}));
+    }
+
+    TEST(xreducer, where_mask)
+    {
+        xarray<double> a = {{1., -2., 3.}, {-4., 5., 6.}};
+        xarray<bool> m = a > 0.;
+
+        EXPECT_EQ(sum(a, where_mask(m))(), 15.);
+        EXPECT_EQ(sum(a, where_mask(a < 0.))(), -6.);
+        xarray<double> s1 = sum(a, {1}, where_mask(m));
+        EXPECT_EQ(s1, (xarray<double>{4., 11.}));
+        xarray<double> s0 = sum(a, 0, where_mask(m), evaluation_strategy::immediate);
+        EXPECT_EQ(s0, (xarray<double>{1., 5., 9.}));
+        EXPECT_EQ(prod(a, where_mask(m))(), 90.);
+        EXPECT_EQ(amin(a, where_mask(m))(), 1.);
+        EXPECT_EQ(amax(a, where_mask(a < 0.))(), -2.);
+
+        // The mask is broadcast to the shape of the expression
+        xarray<bool> columns = {true, false, true};
+        xarray<double> means = mean(a, {0}, where_mask(columns));
+        EXPECT_EQ(means(0), -1.5);
+        EXPECT_TRUE(std::isnan(means(1)));
+        EXPECT_EQ(means(2), 4.5);
+        EXPECT_EQ(mean(a, where_mask(m))(), 15. / 4.);
+
+        xarray<int> ia = {{1, 2}, {3, 4}};
+        EXPECT_EQ(sum(ia, where_mask(equal(ia % 2, 0)))(), 6);
+    }
+
+    TEST(xreducer, moments)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(4. * 5. * 6.), 7.) * 0.5 + 1e6;
+        a.reshape({4, 5, 6});
+
+        auto means = [](const auto& m)
+        {
+            xt::xarray<double> res = xt::zeros<double>(m.shape());
+            std::transform(m.cbegin(), m.cend(), res.begin(), [](const xmoments<double>& v) { return v.mean; });
+            return res;
+        };
+        auto variances = [](const auto& m)
+        {
+            xt::xarray<double> res = xt::zeros<double>(m.shape());
+            std::transform(m.cbegin(), m.cend(), res.begin(), [](const xmoments<double>& v) { return v.variance(); });
+            return res;
+        };
+
+        std::vector<std::vector<std::size_t>> all_axes = {{0}, {1}, {2}, {0, 2}, {0, 1, 2}};
+        for (const auto& axes : all_axes)
+        {
+            auto lazy = xt::moments(a, axes);
+            auto immediate = xt::moments(a, axes, xt::evaluation_strategy::immediate);
+            xt::xarray<double> expected_mean = xt::mean(a, axes);
+            xt::xarray<double> expected_var = xt::variance(a, axes);
+            EXPECT_TRUE(xt::allclose(means(lazy), expected_mean));
+            EXPECT_TRUE(xt::allclose(variances(lazy), expected_var));
+            EXPECT_TRUE(xt::allclose(means(immediate), expected_mean));
+            EXPECT_TRUE(xt::allclose(variances(immediate), expected_var));
+        }
+
+        auto kd = xt::moments(a, {1}, xt::keep_dims | xt::evaluation_strategy::immediate);
+        EXPECT_EQ(kd.shape(), (std::vector<std::size_t>{4, 1, 6}));
+        EXPECT_EQ(kd(0, 0, 0).count, 5u);
+
+        xt::xarray<int> ia = {{1, 2, 3, 4}, {2, 4, 6, 8}};
+        auto im = xt::moments(ia, {1});
+        EXPECT_DOUBLE_EQ(im(0).mean, 2.5);
+        EXPECT_DOUBLE_EQ(im(1).variance(), 5.);
+        EXPECT_DOUBLE_EQ(im(1).variance(1), 20. / 3.);
+        EXPECT_DOUBLE_EQ(xt::moments(ia)().stddev(), std::sqrt(xt::variance(ia)()));
+
+        // Partial results of a parallel reduction are merged
+        xt::xarray<double> tall = xt::fmod(xt::arange<double>(200000. * 2.), 5.);
+        tall.reshape({200000, 2});
+        auto tm = xt::moments(tall, {0}, xt::evaluation_strategy::immediate);
+        EXPECT_TRUE(xt::allclose(variances(tm), xt::variance(tall, {0})));
+        EXPECT_LT(std::abs(xt::moments(tall, xt::evaluation_strategy::immediate)().variance() - 2.), 1e-9);
+    }
+
+    TEST(xreducer, reduce_many)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(60.), 7.) - 3.;
+        a.reshape({3, 4, 5});
+
+        auto min_f = make_xreducer_functor(math::minimum<>(), const_value<double>(std::numeric_limits<double>::max()));
+        auto max_f = make_xreducer_functor(math::maximum<>(), const_value<double>(std::numeric_limits<double>::lowest()));
+        auto sum_f = make_xreducer_functor(std::plus<double>(), const_value<double>(0.));
+        auto count_f = make_xreducer_functor([](std::size_t c, double v) { return v != 0. ? c + 1 : c; },
+                                             const_value<std::size_t>(0), std::plus<std::size_t>());
+        auto functors = std::make_tuple(min_f, max_f, sum_f, count_f);
+
+        auto res = reduce_many(functors, a, {1, 2});
+        EXPECT_EQ(std::get<0>(res), amin(a, {1, 2}));
+        EXPECT_EQ(std::get<1>(res), amax(a, {1, 2}));
+        EXPECT_EQ(std::get<2>(res), sum(a, {1, 2}));
+        EXPECT_EQ(std::get<3>(res), count_nonzero(a, {1, 2}));
+        bool same_type = std::is_same<std::decay_t<decltype(std::get<3>(res))>::value_type, std::size_t>::value;
+        EXPECT_TRUE(same_type);
+
+        std::vector<std::size_t> axes = {0};
+        auto kd = reduce_many(functors, a, axes, keep_dims);
+        EXPECT_EQ(std::get<0>(kd), amin(a, {0}, keep_dims));
+        EXPECT_EQ(std::get<2>(kd), sum(a, {0}, keep_dims));
+
+        xt::xtensor<double, 2> t = xt::view(a, 0);
+        auto all = reduce_many(std::make_tuple(sum_f, [](double x, double y) { return x * y; }), t);
+        EXPECT_EQ(std::get<0>(all)(), sum(t)());
+        EXPECT_EQ(std::get<1>(all)(), reduce([](double x, double y) { return x * y; }, t)());
     }
 
     TEST(xreducer, immediate)
@@ -1085,4 +1205,183 @@ namespace xt
         xt::xtensor_fixed<float, xt::xshape<3>> res1 = res;
         EXPECT_EQ(res1, a * 2.);
     }
+
+    // Large enough to take the parallel paths of the immediate reduction when
+    // a parallel backend is enabled.
+    TEST(xreducer, immediate_large)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(4. * 300. * 120.), 7.);
+        a.reshape({4, 300, 120});
+
+        std::vector<std::vector<std::size_t>> all_axes = {{0}, {1}, {2}, {0, 1}, {1, 2}, {0, 2}, {0, 1, 2}};
+        for (const auto& axes : all_axes)
+        {
+            xt::xarray<double> lazy = xt::sum(a, axes);
+            xt::xarray<double> immediate = xt::sum(a, axes, xt::evaluation_strategy::immediate);
+            EXPECT_EQ(lazy, immediate);
+        }
+
+        xt::xarray<double, xt::layout_type::column_major> ca = a;
+        for (const auto& axes : all_axes)
+        {
+            xt::xarray<double, xt::layout_type::column_major> lazy = xt::sum(ca, axes);
+            xt::xarray<double, xt::layout_type::column_major> immediate = xt::sum(ca, axes, xt::evaluation_strategy::immediate);
+            EXPECT_EQ(lazy, immediate);
+        }
+
+        xt::xarray<double> tall = xt::fmod(xt::arange<double>(200000. * 2.), 5.);
+        tall.reshape({200000, 2});
+        EXPECT_EQ(xt::sum(tall, {0}), xt::sum(tall, {0}, xt::evaluation_strategy::immediate));
+
+        xt::xarray<double> wide = xt::fmod(xt::arange<double>(3. * 40000.), 3.);
+        wide.reshape({3, 40000});
+        EXPECT_EQ(xt::sum(wide, {0}), xt::sum(wide, {0}, xt::evaluation_strategy::immediate));
+        EXPECT_EQ(xt::sum(wide, {1}), xt::sum(wide, {1}, xt::evaluation_strategy::immediate));
+        EXPECT_EQ(xt::sum(wide, {1}, xt::initial(2.)), xt::sum(wide, {1}, xt::initial(2.) | xt::evaluation_strategy::immediate));
+        EXPECT_EQ(xt::amax(wide, {0, 1}, xt::evaluation_strategy::immediate)(), 2.);
+    }
+
+    TEST(xreducer, immediate_contiguous_functors)
+    {
+        // Odd extents exercise the peeling and the tail of the vectorized loop
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(5. * 37. * 131.), 9.) - 4.;
+        a.reshape({5, 37, 131});
+        xt::xarray<int> ia = xt::cast<int>(a);
+
+        std::vector<std::vector<std::size_t>> all_axes = {{2}, {1, 2}, {0, 1, 2}, {0}};
+        for (const auto& axes : all_axes)
+        {
+            EXPECT_EQ(xt::sum(a, axes), xt::sum(a, axes, xt::evaluation_strategy::immediate));
+            EXPECT_EQ(xt::amin(a, axes), xt::amin(a, axes, xt::evaluation_strategy::immediate));
+            EXPECT_EQ(xt::amax(a, axes), xt::amax(a, axes, xt::evaluation_strategy::immediate));
+            EXPECT_EQ(xt::mean(a, axes), xt::mean(a, axes, xt::evaluation_strategy::immediate));
+            EXPECT_EQ(xt::sum(ia, axes), xt::sum(ia, axes, xt::evaluation_strategy::immediate));
+            EXPECT_EQ(xt::amax(ia, axes), xt::amax(ia, axes, xt::evaluation_strategy::immediate));
+        }
+
+        xt::xarray<double> p = xt::ones<double>({3, 129}) * 2.;
+        EXPECT_EQ(xt::prod(p, {1}), xt::prod(p, {1}, xt::evaluation_strategy::immediate));
+        EXPECT_EQ(xt::prod(p, {1}, xt::evaluation_strategy::immediate)(0), std::pow(2., 129.));
+
+        xt::xarray<double> small = {1., 2., 3.};
+        EXPECT_EQ(xt::sum(small, {0}, xt::evaluation_strategy::immediate)(), 6.);
+
+        xt::xarray<std::complex<double>> c = xt::ones<double>({3, 133}) * std::complex<double>(1., -2.);
+        xt::xarray<std::complex<double>> ec = {std::complex<double>(133., -266.),
+                                               std::complex<double>(133., -266.),
+                                               std::complex<double>(133., -266.)};
+        EXPECT_EQ(xt::sum(c, {1}, xt::evaluation_strategy::immediate), ec);
+        EXPECT_EQ(xt::sum(c, xt::evaluation_strategy::immediate)(), std::complex<double>(399., -798.));
+    }
+
+    TEST(xreducer, summation)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(4. * 30. * 20.), 7.);
+        a.reshape({4, 30, 20});
+        xt::xarray<double, xt::layout_type::column_major> ca = a;
+
+        std::vector<std::vector<std::size_t>> all_axes = {{0}, {1}, {2}, {0, 1}, {1, 2}, {0, 2}, {0, 1, 2}};
+        for (const auto& axes : all_axes)
+        {
+            xt::xarray<double> expected = xt::sum(a, axes);
+            EXPECT_EQ(expected, xt::sum(a, axes, xt::summation::pairwise));
+            EXPECT_EQ(expected, xt::sum(a, axes, xt::summation::kahan));
+            EXPECT_EQ(expected, xt::sum(ca, axes, xt::summation::pairwise));
+            EXPECT_EQ(expected, xt::sum(ca, axes, xt::summation::kahan | xt::evaluation_strategy::immediate));
+        }
+
+        EXPECT_EQ(xt::sum(a, {1}, xt::keep_dims), xt::sum(a, {1}, xt::keep_dims | xt::summation::kahan));
+        EXPECT_EQ(xt::sum(a, {2}, xt::initial(3.)), xt::sum(a, {2}, xt::initial(3.) | xt::summation::pairwise));
+        EXPECT_EQ(xt::sum(a)(), xt::sum(a, xt::summation::pairwise)());
+        EXPECT_EQ(xt::mean(a, {0, 2}), xt::mean(a, {0, 2}, xt::summation::pairwise));
+        EXPECT_TRUE(xt::allclose(xt::variance(a, {1}), xt::variance(a, {1}, xt::summation::kahan)));
+    }
+
+    TEST(xreducer, summation_accuracy)
+    {
+        xt::xtensor<float, 2> a = xt::ones<float>({2, 1000000}) * 0.1f;
+        xt::xtensor<float, 1> pairwise = xt::sum(a, {1}, xt::summation::pairwise);
+        xt::xtensor<float, 1> kahan = xt::sum(a, {1}, xt::summation::kahan);
+        double expected = 1000000. * static_cast<double>(0.1f);
+        EXPECT_LT(std::abs(pairwise(0) - expected), 0.1);
+        EXPECT_LT(std::abs(kahan(1) - expected), 0.01);
+        EXPECT_LT(std::abs(xt::mean(a, xt::summation::kahan)() - static_cast<double>(0.1f)), 1e-8);
+
+        xt::xtensor<float, 2> t = xt::transpose(a);
+        xt::xtensor<float, 1> kahan_strided = xt::sum(t, {0}, xt::summation::kahan);
+        EXPECT_EQ(kahan, kahan_strided);
+    }
+
+    TEST(xreducer, lazy_streaming_assign)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(120.), 7.) - 3.;
+        a.reshape({4, 5, 6});
+        xt::xarray<double, layout_type::column_major> c = a;
+
+        auto check = [](const auto& res, const auto& red) {
+            EXPECT_TRUE(std::equal(res.shape().cbegin(), res.shape().cend(), red.shape().cbegin()));
+            EXPECT_TRUE(std::equal(res.begin(), res.end(), red.begin()));
+        };
+
+        xt::xarray<double> s0 = sum(a, {0});
+        check(s0, sum(a, {0}));
+        xt::xarray<double> s01 = sum(a, {0, 1});
+        check(s01, sum(a, {0, 1}));
+        xt::xarray<double> s1 = sum(a, {1}, keep_dims | xt::initial(2.));
+        check(s1, sum(a, {1}, keep_dims | xt::initial(2.)));
+        xt::xtensor<std::size_t, 2> n0 = count_nonzero(a, {0});
+        check(n0, count_nonzero(a, {0}));
+
+        xt::xarray<double> c2 = sum(c, {2});
+        check(c2, sum(c, {2}));
+        xt::xarray<double> c12 = amax(c, {1, 2});
+        check(c12, amax(c, {1, 2}));
+
+        xt::xtensor<int, 2> i = xt::ones<int>({3000, 40});
+        xt::xtensor<long long, 1> ir = sum(i, {0});
+        EXPECT_EQ(ir(0), 3000ll);
+        EXPECT_EQ(ir(39), 3000ll);
+    }
+
+    TEST(xreducer, fused_expression)
+    {
+        xt::xarray<double> a = xt::fmod(xt::arange<double>(3000.), 11.);
+        xt::xarray<double> b = xt::fmod(xt::arange<double>(3000.), 5.);
+        a.reshape({60, 50});
+        b.reshape({60, 50});
+        xt::xarray<double> d = xt::square(a - b);
+        double expected = sum(d)();
+
+        EXPECT_EQ(sum(xt::square(a - b))(), expected);
+        EXPECT_EQ(sum(xt::square(a - b), xt::evaluation_strategy::immediate)(), expected);
+        EXPECT_EQ(sum(xt::square(a - b), {0, 1}, keep_dims | xt::evaluation_strategy::immediate)(0, 0), expected);
+        EXPECT_EQ(sum(xt::square(a - b), xt::initial(2.) | xt::evaluation_strategy::immediate)(), expected + 2.);
+        EXPECT_EQ(sum(xt::square(a - b), xt::initial(2.))(), expected + 2.);
+        EXPECT_EQ(amax(a - b, xt::evaluation_strategy::immediate)(), amax(xt::eval(a - b))());
+
+        // The reduction functor sees the values of the expression
+        xt::xarray<int> ia = xt::cast<int>(a);
+        xt::xarray<int> ib = xt::cast<int>(b);
+        xt::xarray<std::size_t> nz = count_nonzero(ia - ib, xt::evaluation_strategy::immediate);
+        EXPECT_EQ(nz(), count_nonzero(xt::eval(ia - ib))());
+        xt::xarray<long long> ls = sum<long long>(ia * ib, xt::evaluation_strategy::immediate);
+        EXPECT_EQ(ls(), static_cast<long long>(sum(a * b)()));
+
+        // Column-major operands and non-contiguous views are evaluated
+        xt::xarray<double, layout_type::column_major> ca = a;
+        xt::xarray<double, layout_type::column_major> cb = b;
+        EXPECT_EQ(sum(xt::square(ca - cb), xt::evaluation_strategy::immediate)(), expected);
+        EXPECT_EQ(sum(xt::square(ca - b))(), expected);
+        xt::xtensor<double, 1> ca1 = xt::flatten(ca);
+        EXPECT_EQ(sum(ca1 * 2., xt::evaluation_strategy::immediate)(), 2. * sum(a)());
+        auto va = xt::view(a, xt::all(), xt::range(0, 50, 2));
+        auto vb = xt::view(b, xt::all(), xt::range(0, 50, 2));
+        xt::xarray<double> vd = xt::square(va - vb);
+        EXPECT_EQ(sum(xt::square(va - vb), xt::evaluation_strategy::immediate)(), sum(vd)());
+        EXPECT_EQ(sum(xt::square(va - vb))(), sum(vd)());
+
+        // Partial reductions are unchanged
+        xt::xarray<double> s0 = sum(xt::square(a - b), {0}, xt::evaluation_strategy::immediate);
+        EXPECT_EQ(s0, sum(d, {0}));
+    }
 }
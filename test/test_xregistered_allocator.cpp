@@ -0,0 +1,133 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xregistered_allocator.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        struct registration_log
+        {
+            std::map<void*, std::size_t> regions;
+            std::size_t registrations = 0;
+            bool fail = false;
+
+            std::shared_ptr<memory_registry> make_registry()
+            {
+                return std::make_shared<memory_registry>(
+                    [this](void* p, std::size_t size)
+                    {
+                        if (fail)
+                        {
+                            throw std::runtime_error("registration failed");
+                        }
+                        regions[p] = size;
+                        ++registrations;
+                    },
+                    [this](void* p, std::size_t)
+                    {
+                        regions.erase(p);
+                    });
+            }
+
+            bool contains(const void* p, std::size_t bytes) const
+            {
+                for (const auto& r : regions)
+                {
+                    const char* first = static_cast<const char*>(r.first);
+                    const char* q = static_cast<const char*>(p);
+                    if (first <= q && q + bytes <= first + r.second)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+    }
+
+    TEST(registered_allocator, registration)
+    {
+        registration_log log;
+        auto registry = log.make_registry();
+        {
+            xregistered_tensor<double, 2> t(std::array<std::size_t, 2>{3, 5}, 1.,
+                                            layout_type::row_major);
+            EXPECT_EQ(log.registrations, 0u);
+        }
+        {
+            using tensor_type = xregistered_tensor<double, 2>;
+            tensor_type::storage_type storage(15, 2., registered_allocator<double>(registry));
+            EXPECT_EQ(log.registrations, 1u);
+            EXPECT_TRUE(log.contains(storage.data(), 15 * sizeof(double)));
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(storage.data()) % XTENSOR_REGISTERED_ALIGNMENT, 0u);
+            EXPECT_EQ(registry->registered(), 1u);
+
+            auto copy = storage;
+            EXPECT_EQ(registry->registered(), 2u);
+            EXPECT_TRUE(log.contains(copy.data(), 15 * sizeof(double)));
+        }
+        EXPECT_TRUE(log.regions.empty());
+        EXPECT_EQ(registry->registered(), 0u);
+
+        log.fail = true;
+        registered_allocator<float> alloc(registry);
+        XT_EXPECT_THROW(alloc.allocate(4), std::runtime_error);
+        EXPECT_EQ(registry->registered(), 0u);
+    }
+
+    TEST(registered_allocator, default_registry)
+    {
+        registration_log log;
+        auto previous = memory_registry::set_default(log.make_registry());
+        {
+            xregistered_array<int> a = arange<int>(100);
+            a.reshape({10, 10});
+            EXPECT_TRUE(log.contains(a.data(), a.size() * sizeof(int)));
+            xregistered_array<int> b = a + 1;
+            EXPECT_TRUE(log.contains(b.data(), b.size() * sizeof(int)));
+            EXPECT_EQ(b(9, 9), 100);
+
+            // Buffers go back to their own registry
+            memory_registry::set_default(previous);
+            b.resize({20, 20});
+            EXPECT_TRUE(log.contains(b.data(), b.size() * sizeof(int)));
+        }
+        EXPECT_TRUE(log.regions.empty());
+        EXPECT_EQ(memory_registry::get_default(), previous);
+
+        // Replacing the allocation too
+        std::size_t allocated = 0;
+        auto custom = std::make_shared<memory_registry>(
+            [&allocated](std::size_t size) -> void*
+            {
+                allocated += size;
+                return std::allocator<char>().allocate(size);
+            },
+            [&allocated](void* p, std::size_t size)
+            {
+                allocated -= size;
+                std::allocator<char>().deallocate(static_cast<char*>(p), size);
+            });
+        {
+            uvector<char, registered_allocator<char>> v(10, 'a', registered_allocator<char>(custom));
+            EXPECT_EQ(allocated, std::size_t(XTENSOR_REGISTERED_ALIGNMENT));
+        }
+        EXPECT_EQ(allocated, 0u);
+    }
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <stdexcept>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xrolling.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xrolling, one_dimension)
+    {
+        xarray<int> a = {3, -1, 4, 1, -5, 9, 2, -6};
+
+        EXPECT_EQ(rolling_sum(a, 3), (xarray<int>{6, 4, 0, 5, 6, 5}));
+        EXPECT_EQ(rolling_mean(a, 2), (xarray<double>{1., 1.5, 2.5, -2., 2., 5.5, -2.}));
+        EXPECT_EQ(rolling_min(a, 3), (xarray<int>{-1, -1, -5, -5, -5, -6}));
+        EXPECT_EQ(rolling_max(a, 3), (xarray<int>{4, 4, 4, 9, 9, 9}));
+        EXPECT_EQ(rolling_var(a, 2), (xarray<double>{4., 6.25, 2.25, 9., 49., 12.25, 16.}));
+        EXPECT_EQ(rolling_std(a, 2), (xarray<double>{2., 2.5, 1.5, 3., 7., 3.5, 4.}));
+
+        EXPECT_EQ(rolling_sum(a, 8), (xarray<int>{7}));
+        EXPECT_EQ(rolling_max(a, 1), a);
+
+        XT_EXPECT_THROW(rolling_sum(a, 0), std::runtime_error);
+        XT_EXPECT_THROW(rolling_sum(a, 9), std::runtime_error);
+    }
+
+    TEST(xrolling, axes)
+    {
+        // More lanes than a block, along the first and the last axes
+        xarray<double> a = fmod(arange<double>(7. * 300.), 13.) - 6.;
+        a.reshape({7, 300});
+        const std::size_t w = 3;
+
+        auto naive = [&](std::size_t axis)
+        {
+            xarray<double> s, lo, hi, var;
+            for (std::size_t p = 0; p + w <= a.shape()[axis]; ++p)
+            {
+                xarray<double> win = axis == 0 ? xarray<double>(view(a, range(p, p + w), all()))
+                                               : xarray<double>(view(a, all(), range(p, p + w)));
+                xarray<double> s1 = sum(win, {axis});
+                xarray<double> lo1 = amin(win, {axis});
+                xarray<double> hi1 = amax(win, {axis});
+                xarray<double> v1 = variance(win, {axis});
+                s = p == 0 ? xarray<double>(expand_dims(s1, axis)) : xarray<double>(concatenate(xtuple(s, expand_dims(s1, axis)), axis));
+                lo = p == 0 ? xarray<double>(expand_dims(lo1, axis)) : xarray<double>(concatenate(xtuple(lo, expand_dims(lo1, axis)), axis));
+                hi = p == 0 ? xarray<double>(expand_dims(hi1, axis)) : xarray<double>(concatenate(xtuple(hi, expand_dims(hi1, axis)), axis));
+                var = p == 0 ? xarray<double>(expand_dims(v1, axis)) : xarray<double>(concatenate(xtuple(var, expand_dims(v1, axis)), axis));
+            }
+            return std::make_tuple(s, lo, hi, var);
+        };
+
+        auto rows = naive(0);
+        EXPECT_EQ(rolling_sum(a, w, 0), std::get<0>(rows));
+        EXPECT_EQ(rolling_min(a, w, 0), std::get<1>(rows));
+        EXPECT_EQ(rolling_max(a, w, 0, exec::par()), std::get<2>(rows));
+        EXPECT_TRUE(allclose(rolling_var(a, w, 0), std::get<3>(rows)));
+
+        auto cols = naive(1);
+        EXPECT_EQ(rolling_sum(a, w, -1, exec::par()), std::get<0>(cols));
+        EXPECT_EQ(rolling_min(a, w), std::get<1>(cols));
+        EXPECT_EQ(rolling_max(a, w), std::get<2>(cols));
+        EXPECT_TRUE(allclose(rolling_var(a, w, 1), std::get<3>(cols)));
+
+        // Lazy operand, and the middle axis of a 3D xtensor
+        xtensor<int, 3> t = arange<int>(2 * 5 * 3).reshape({2, 5, 3});
+        auto ts = rolling_sum(t * 2, 2, 1);
+        ASSERT_EQ(ts.shape(), (xarray<int>::shape_type{2, 4, 3}));
+        EXPECT_EQ(ts(1, 2, 1), 2 * (t(1, 2, 1) + t(1, 3, 1)));
+        EXPECT_EQ(rolling_mean(t, 5, 1)(0, 0, 2), 8.);
+    }
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include "xtensor/xserialize.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace xt
+{
+    TEST(xserialize, round_trip)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        std::stringstream ss;
+        serialize(ss, a);
+        auto b = deserialize<double>(ss);
+        EXPECT_EQ(a, b);
+
+        xtensor<int, 3> t = {{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}};
+        std::stringstream ts;
+        serialize(ts, t);
+        auto u = deserialize<int>(ts);
+        EXPECT_EQ(t, u);
+
+        xarray<bool> m = {true, false, true};
+        std::stringstream ms;
+        serialize(ms, m);
+        EXPECT_EQ(m, deserialize<bool>(ms));
+    }
+
+    TEST(xserialize, layout)
+    {
+        xarray<double, layout_type::column_major> a = {{1., 2., 3.}, {4., 5., 6.}};
+        std::stringstream ss;
+        serialize(ss, a);
+        std::string record = ss.str();
+        EXPECT_EQ(static_cast<layout_type>(record[8]), layout_type::column_major);
+
+        auto b = deserialize<double, layout_type::row_major>(ss);
+        EXPECT_EQ(a, b);
+
+        std::stringstream vs;
+        serialize(vs, view(a, all(), 1));
+        auto v = deserialize<double>(vs);
+        xarray<double> expected = {2., 5.};
+        EXPECT_EQ(v, expected);
+    }
+
+    TEST(xserialize, adapt_serialized)
+    {
+        xarray<float, layout_type::column_major> a = {{1.f, 2.f}, {3.f, 4.f}, {5.f, 6.f}};
+        std::stringstream ss;
+        serialize(ss, a, 32);
+        std::string record = ss.str();
+        std::uint32_t data_offset;
+        std::memcpy(&data_offset, record.data() + 20, 4);
+        EXPECT_EQ(data_offset % 32, 0u);
+        EXPECT_EQ(record.size(), data_offset + 6 * sizeof(float));
+
+        std::vector<double> storage(record.size() / sizeof(double) + 1);
+        std::memcpy(storage.data(), record.data(), record.size());
+        const char* buffer = reinterpret_cast<const char*>(storage.data());
+        auto b = adapt_serialized<float>(buffer, record.size());
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(b.data(), reinterpret_cast<const float*>(buffer + data_offset));
+
+        char* mbuffer = reinterpret_cast<char*>(storage.data());
+        auto c = adapt_serialized<float>(mbuffer, record.size());
+        c(2, 1) = 12.f;
+        EXPECT_EQ(b(2, 1), 12.f);
+    }
+
+    TEST(xserialize, errors)
+    {
+        xarray<double> a = {1., 2., 3.};
+        std::stringstream ss;
+        serialize(ss, a);
+        std::string record = ss.str();
+        XT_EXPECT_THROW(deserialize<int>(ss), std::runtime_error);
+        XT_EXPECT_THROW(adapt_serialized<double>(record.data(), record.size() - 1), std::runtime_error);
+
+        std::stringstream bad("not a record at all, clearly");
+        XT_EXPECT_THROW(deserialize<double>(bad), std::runtime_error);
+        XT_EXPECT_THROW(serialize(ss, a, 3), std::runtime_error);
+    }
+}
@@ -9,11 +9,15 @@
 
 #include "test_common_macros.hpp"
 
+#include <algorithm>
 #include <cstddef>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xset_operation.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -25,6 +29,18 @@ namespace xt
         EXPECT_EQ(xt::isin(a, b), res);
         EXPECT_EQ(xt::isin(a, b.begin(), b.end()), res);
         EXPECT_EQ(xt::isin(a, {1, 2}), res);
+        EXPECT_EQ(xt::isin(a, {1., 2.}), res);
+        EXPECT_EQ(xt::isin(xt::cast<double>(a), xt::xtensor<int, 1>{1, 2}), res);
+
+        xt::xtensor<int, 1> big = xt::arange<int>(1000) * 3;
+        xt::xtensor<int, 1> values = xt::arange<int>(-10, 3000);
+        xt::xtensor<bool, 1> expected = values >= 0 && values < 2998 && xt::equal(values % 3, 0);
+        EXPECT_EQ(xt::isin(values, big), expected);
+        EXPECT_EQ(xt::isin(values, big.begin(), big.end()), expected);
+
+        xt::xtensor<double, 1> zeros = {-0., 1.};
+        xt::xtensor<bool, 1> zeros_res = {true, false};
+        EXPECT_EQ(xt::isin(zeros, {0.}), zeros_res);
     }
 
     TEST(xset_operation, in1d)
@@ -46,5 +62,43 @@ namespace xt
         EXPECT_EQ(xt::searchsorted(a, v), res_right);
         EXPECT_EQ(xt::searchsorted(a, v, true), res_right);
         EXPECT_EQ(xt::searchsorted(a, v, false), res_left);
+
+        auto index = xt::make_sorted_index(a);
+        EXPECT_EQ(index.size(), a.size());
+        EXPECT_EQ(xt::searchsorted(index, v), res_right);
+        EXPECT_EQ(xt::searchsorted(index, v, false), res_left);
+    }
+
+    TEST(xset_operation, searchsorted_large)
+    {
+        // Sorted values with repeats, and queries inside and outside of them
+        xt::xtensor<int, 1> a = xt::arange<int>(1000) / 3 * 2;
+        xt::xtensor<int, 2> v = xt::reshape_view(xt::arange<int>(-5, 700) * 7 % 701 - 10, {15, 47});
+        xt::xtensor<std::size_t, 2> lower = xt::empty<std::size_t>(v.shape());
+        xt::xtensor<std::size_t, 2> upper = xt::empty<std::size_t>(v.shape());
+        std::transform(v.cbegin(), v.cend(), lower.begin(), [&a](int x) {
+            return static_cast<std::size_t>(std::lower_bound(a.cbegin(), a.cend(), x) - a.cbegin()); });
+        std::transform(v.cbegin(), v.cend(), upper.begin(), [&a](int x) {
+            return static_cast<std::size_t>(std::upper_bound(a.cbegin(), a.cend(), x) - a.cbegin()); });
+
+        EXPECT_EQ(xt::searchsorted(a, v), lower);
+        EXPECT_EQ(xt::searchsorted(a, v, false), upper);
+        EXPECT_EQ(xt::searchsorted(a + 0, v), lower);
+
+        auto index = xt::make_sorted_index(a);
+        EXPECT_EQ(xt::searchsorted(index, v), lower);
+        EXPECT_EQ(xt::searchsorted(index, v, false), upper);
+
+        // Strided sorted values
+        xt::xtensor<int, 1> b = xt::arange<int>(2000) / 3 * 2;
+        auto strided = xt::view(b, xt::range(0, 2000, 2));
+        xt::xtensor<std::size_t, 2> strided_lower = xt::empty<std::size_t>(v.shape());
+        std::transform(v.cbegin(), v.cend(), strided_lower.begin(), [&strided](int x) {
+            return static_cast<std::size_t>(std::lower_bound(strided.cbegin(), strided.cend(), x) - strided.cbegin()); });
+        EXPECT_EQ(xt::searchsorted(strided, v), strided_lower);
+
+        xt::xtensor<int, 1> empty = xt::xtensor<int, 1>::from_shape({0});
+        EXPECT_EQ(xt::searchsorted(empty, v), xt::zeros<std::size_t>(v.shape()));
+        EXPECT_EQ(xt::searchsorted(xt::make_sorted_index(empty), v), xt::zeros<std::size_t>(v.shape()));
     }
 }
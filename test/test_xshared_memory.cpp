@@ -0,0 +1,69 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xshared_memory.hpp"
+
+namespace xt
+{
+#if defined(XTENSOR_HAS_SHARED_MEMORY)
+    TEST(xshared_memory, named)
+    {
+        std::string name = "/xtensor_test_" + std::to_string(::getpid());
+        xarray<double> expected = arange<double>(12.);
+        expected.reshape({3, 4});
+        {
+            auto a = create_shared_array<double>(name, {3, 4});
+            EXPECT_EQ(a, zeros<double>({3, 4}));
+            a = expected;
+
+            // Attached by name, without copy
+            auto b = attach_shared_array<double>(name);
+            EXPECT_EQ(b, expected);
+            EXPECT_EQ(b.layout(), XTENSOR_DEFAULT_LAYOUT);
+            auto c = attach_shared_array<double>(name, shm_mode::read_write);
+            c(1, 2) = -1.;
+            EXPECT_EQ(a(1, 2), -1.);
+            EXPECT_EQ(b(1, 2), -1.);
+
+            XT_EXPECT_THROW(attach_shared_array<float>(name), std::runtime_error);
+            XT_EXPECT_THROW(create_shared_array<double>(name, {2}), std::runtime_error);
+        }
+        xshared_memory::remove(name);
+        XT_EXPECT_THROW(attach_shared_array<double>(name), std::runtime_error);
+    }
+
+#if defined(XTENSOR_HAS_MEMFD)
+    TEST(xshared_memory, anonymous)
+    {
+        std::vector<std::size_t> shape = {5, 2};
+        auto segment = std::make_shared<xshared_memory>(shared_array_bytes<int>(shape));
+        auto a = adapt_shared_array<int>(segment, shape, layout_type::column_major);
+        xarray<int> values = arange<int>(10);
+        values.reshape({5, 2});
+        a = values;
+
+        // A process receiving the file descriptor maps the same memory
+        auto attached = std::make_shared<xshared_memory>(segment->fd(), shm_mode::read_only);
+        auto b = attach_shared_array<int, layout_type::column_major>(attached);
+        EXPECT_EQ(b, a);
+        EXPECT_NE(b.data(), a.data());
+        XT_EXPECT_THROW((attach_shared_array<int, layout_type::row_major>(attached)), std::runtime_error);
+        XT_EXPECT_THROW(adapt_shared_array<int>(attached, shape), std::runtime_error);
+    }
+#endif
+#endif
+}
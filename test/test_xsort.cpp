@@ -7,9 +7,21 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
 #include "test_common_macros.hpp"
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xio.hpp"
@@ -17,6 +29,7 @@
 #include "xtensor/xview.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xslice.hpp"
+#include "xtensor/xstrided_view.hpp"
 #include "xtensor/xsort.hpp"
 
 namespace xt
@@ -113,6 +126,43 @@ namespace xt
         }
     }
 
+    TEST(xsort, lexsort)
+    {
+        {
+            // numpy.lexsort((first_names, surnames))
+            xt::xtensor<int, 1> first_names = {3, 1, 2, 1, 3};
+            xt::xtensor<double, 1> surnames = {2.5, 1.5, 2.5, 1.5, 0.5};
+            xt::xtensor<std::size_t, 1> expected = {4, 1, 3, 2, 0};
+            EXPECT_EQ(xt::lexsort(first_names, surnames), expected);
+
+            xt::xtensor<double, 2> keys = {{3, 1, 2, 1, 3}, {2.5, 1.5, 2.5, 1.5, 0.5}};
+            EXPECT_EQ(xt::lexsort(keys), expected);
+
+            xt::xtensor<std::size_t, 1> single = {1, 3, 2, 0, 4};
+            EXPECT_EQ(xt::lexsort(first_names), single);
+            EXPECT_EQ(xt::lexsort(xt::view(keys, 0)), single);
+
+            xt::xtensor<int, 1> shorter = {1, 2};
+            XT_EXPECT_THROW(xt::lexsort(first_names, shorter), std::runtime_error);
+        }
+
+        {
+            // Long enough keys for the radix passes, with many ties
+            std::size_t n = 5000;
+            xt::xtensor<int, 1> k1 = xt::arange<int>(static_cast<int>(n)) * 7919 % 13;
+            xt::xtensor<int, 1> k2_int = xt::arange<int>(static_cast<int>(n)) * 31 % 7 - 3;
+            xt::xtensor<float, 1> k2 = xt::cast<float>(k2_int);
+            xt::xtensor<std::int64_t, 1> k3 = xt::arange<std::int64_t>(static_cast<std::int64_t>(n)) % 5;
+            std::vector<std::size_t> expected(n);
+            std::iota(expected.begin(), expected.end(), std::size_t(0));
+            std::stable_sort(expected.begin(), expected.end(), [&](std::size_t x, std::size_t y) {
+                return std::make_tuple(k3[x], k2[x], k1[x]) < std::make_tuple(k3[y], k2[y], k1[y]);
+            });
+            auto res = xt::lexsort(k1, k2, k3);
+            EXPECT_TRUE(std::equal(res.cbegin(), res.cend(), expected.cbegin()));
+        }
+    }
+
     TEST(xsort, flatten_argsort)
     {
         {
@@ -220,6 +270,292 @@ namespace xt
         EXPECT_EQ(ex_6, argmax(c, 1));
     }
 
+    TEST(xsort, sort_axes)
+    {
+        xarray<double> a = xt::fmod(xt::arange<double>(3 * 37 * 19) * 7., 11.);
+        a.reshape({3, 37, 19});
+        xarray<double, layout_type::column_major> c = a;
+        std::array<std::size_t, 2> kth = {2, 0};
+
+        // Checks the results for each lane along the axis against the sorted lane
+        auto check = [&a, &kth](const auto& input, std::size_t axis) {
+            auto sorted = xt::sort(input, static_cast<std::ptrdiff_t>(axis));
+            auto inds = xt::argsort(input, static_cast<std::ptrdiff_t>(axis));
+            auto part = xt::partition(input, kth, static_cast<std::ptrdiff_t>(axis));
+            auto part_inds = xt::argpartition(input, kth, static_cast<std::ptrdiff_t>(axis));
+            auto med = xt::median(input, static_cast<std::ptrdiff_t>(axis));
+            std::size_t ax0 = axis == 0 ? 1 : 0;
+            std::size_t ax1 = axis == 2 ? 1 : 2;
+            std::size_t n = a.shape()[axis];
+            bool ok = true;
+            for (std::size_t i = 0; i < a.shape()[ax0]; ++i)
+            {
+                for (std::size_t j = 0; j < a.shape()[ax1]; ++j)
+                {
+                    xstrided_slice_vector sv(3);
+                    sv[axis] = xt::all();
+                    sv[ax0] = static_cast<std::ptrdiff_t>(i);
+                    sv[ax1] = static_cast<std::ptrdiff_t>(j);
+                    std::vector<double> ref;
+                    auto line = xt::strided_view(a, sv);
+                    std::copy(line.begin(), line.end(), std::back_inserter(ref));
+                    std::sort(ref.begin(), ref.end());
+
+                    auto sorted_line = xt::strided_view(sorted, sv);
+                    auto inds_line = xt::strided_view(inds, sv);
+                    auto part_line = xt::strided_view(part, sv);
+                    auto part_inds_line = xt::strided_view(part_inds, sv);
+                    ok = ok && std::equal(ref.begin(), ref.end(), sorted_line.begin());
+                    for (std::size_t k = 0; k < n; ++k)
+                    {
+                        ok = ok && line(inds_line(k)) == ref[k];
+                    }
+                    for (std::size_t k : kth)
+                    {
+                        ok = ok && part_line(k) == ref[k] && line(part_inds_line(k)) == ref[k];
+                    }
+                    double ref_med = n % 2 == 0 ? (ref[n / 2 - 1] + ref[n / 2]) / 2. : ref[n / 2];
+                    ok = ok && med(i, j) == ref_med;
+                }
+            }
+            return ok;
+        };
+
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            EXPECT_TRUE(check(a, axis));
+            EXPECT_TRUE(check(c, axis));
+            EXPECT_TRUE(check(a + 0., axis));
+        }
+    }
+
+    TEST(xsort, topk)
+    {
+        xarray<double> a = xt::fmod(xt::arange<double>(3 * 37 * 19) * 7., 11.);
+        a.reshape({3, 37, 19});
+        xarray<double, layout_type::column_major> c = a;
+
+        // Checks each lane against the stable sort of the lane by comp
+        auto check = [&a](const auto& input, std::size_t axis, std::size_t k, auto comp) {
+            auto best = xt::topk(input, k, static_cast<std::ptrdiff_t>(axis), comp);
+            auto inds = xt::argtopk(input, k, static_cast<std::ptrdiff_t>(axis), comp);
+            std::size_t ax0 = axis == 0 ? 1 : 0;
+            std::size_t ax1 = axis == 2 ? 1 : 2;
+            bool ok = best.shape()[axis] == k && inds.shape()[axis] == k;
+            for (std::size_t i = 0; i < a.shape()[ax0]; ++i)
+            {
+                for (std::size_t j = 0; j < a.shape()[ax1]; ++j)
+                {
+                    xstrided_slice_vector sv(3);
+                    sv[axis] = xt::all();
+                    sv[ax0] = static_cast<std::ptrdiff_t>(i);
+                    sv[ax1] = static_cast<std::ptrdiff_t>(j);
+                    auto line = xt::strided_view(a, sv);
+                    std::vector<std::size_t> ref(line.size());
+                    std::iota(ref.begin(), ref.end(), std::size_t(0));
+                    std::stable_sort(ref.begin(), ref.end(), [&](std::size_t p, std::size_t q) { return comp(line(p), line(q)); });
+
+                    auto best_line = xt::strided_view(best, sv);
+                    auto inds_line = xt::strided_view(inds, sv);
+                    for (std::size_t r = 0; r < k; ++r)
+                    {
+                        ok = ok && inds_line(r) == ref[r] && best_line(r) == line(ref[r]);
+                    }
+                }
+            }
+            return ok;
+        };
+
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            for (std::size_t k : {std::size_t(0), std::size_t(1), std::size_t(3)})
+            {
+                EXPECT_TRUE(check(a, axis, k, std::greater<>()));
+                EXPECT_TRUE(check(c, axis, k, std::less<>()));
+                EXPECT_TRUE(check(a + 0., axis, k, std::greater<>()));
+            }
+            EXPECT_TRUE(check(a, axis, a.shape()[axis], std::greater<>()));
+            XT_EXPECT_THROW(xt::topk(a, a.shape()[axis] + 1, static_cast<std::ptrdiff_t>(axis)), std::runtime_error);
+        }
+
+        xtensor<int, 1> v = {3, 9, -1, 9, 4, 0, 7};
+        xtensor<int, 1> v_top = {9, 9, 7};
+        xtensor<std::size_t, 1> v_inds = {1, 3, 6};
+        EXPECT_EQ(xt::topk(v, 3), v_top);
+        EXPECT_EQ(xt::argtopk(v, 3), v_inds);
+        xtensor<int, 1> v_bottom = {-1, 0};
+        EXPECT_EQ(xt::topk(v, 2, 0, std::less<>()), v_bottom);
+    }
+
+    TEST(xsort, sort_policy)
+    {
+        xtensor<double, 1> a = xt::fmod(xt::arange<double>(1000000.) * 7919., 65521.);
+        std::vector<double> ref(a.cbegin(), a.cend());
+        std::sort(ref.begin(), ref.end());
+
+        xthread_pool pool(3);
+        auto check_sorted = [&ref](const auto& values) {
+            return std::equal(ref.begin(), ref.end(), values.begin());
+        };
+        auto check_argsorted = [&ref, &a](const auto& inds) {
+            bool ok = true;
+            for (std::size_t i = 0; i < ref.size(); ++i)
+            {
+                ok = ok && a(inds(i)) == ref[i];
+            }
+            return ok;
+        };
+
+        EXPECT_TRUE(check_sorted(xt::sort(a, xnone(), exec::par(pool))));
+        EXPECT_TRUE(check_sorted(xt::sort(a, 0, exec::par(pool))));
+        EXPECT_TRUE(check_sorted(xt::sort(a, xnone(), exec::seq)));
+        EXPECT_TRUE(check_argsorted(xt::argsort(a, xnone(), exec::par(pool))));
+        EXPECT_TRUE(check_argsorted(xt::argsort(a, 0, exec::par(pool))));
+
+        // Few long lanes are each sorted in parallel
+        xtensor<double, 2> b = xt::reshape_view(a, {2, 500000});
+        auto sb = xt::sort(b, 1, exec::par(pool));
+        auto ib = xt::argsort(b, 1, exec::par(pool));
+        EXPECT_EQ(sb, xt::sort(b, 1));
+        EXPECT_EQ(xt::view(sb, 1, xt::range(0, 10)), xt::view(xt::sort(xt::view(b, 1)), xt::range(0, 10)));
+        bool ok = true;
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 500000; ++j)
+            {
+                ok = ok && b(i, ib(i, j)) == sb(i, j);
+            }
+        }
+        EXPECT_TRUE(ok);
+
+        xtensor<double, 2> c = xt::reshape_view(a, {1000, 1000});
+        EXPECT_EQ(xt::sort(c, 0, exec::par(pool)), xt::sort(c, 0));
+        EXPECT_EQ(xt::argsort(c, 1, exec::par(pool)), xt::argsort(c, 1));
+    }
+
+    template <class T>
+    void check_radix_sort(const xtensor<T, 1>& a)
+    {
+        std::vector<T> ref(a.cbegin(), a.cend());
+        std::sort(ref.begin(), ref.end());
+        auto sorted = xt::sort(a);
+        EXPECT_TRUE(std::equal(ref.begin(), ref.end(), sorted.begin()));
+
+        std::vector<std::size_t> ref_inds(a.size());
+        std::iota(ref_inds.begin(), ref_inds.end(), std::size_t(0));
+        std::stable_sort(ref_inds.begin(), ref_inds.end(), [&a](std::size_t i, std::size_t j) { return a(i) < a(j); });
+        auto inds = xt::argsort(a, 0, sorting_method::stable);
+        EXPECT_TRUE(std::equal(ref_inds.begin(), ref_inds.end(), inds.begin()));
+    }
+
+    TEST(xsort, radix)
+    {
+        xtensor<int, 1> i = xt::arange<int>(-3000, 3000) * 7919 % 1001;
+        check_radix_sort(i);
+        check_radix_sort(xtensor<std::int64_t, 1>(xt::cast<std::int64_t>(i) * (std::int64_t(1) << 40)));
+        check_radix_sort(xtensor<std::uint32_t, 1>(xt::cast<std::uint32_t>(i + 1000) * 4000007u));
+        check_radix_sort(xtensor<std::int8_t, 1>(xt::cast<std::int8_t>(i % 100)));
+        check_radix_sort(xtensor<float, 1>(xt::cast<float>(i) / 7.f));
+        check_radix_sort(xtensor<double, 1>(xt::cast<double>(i) * -1e-300));
+
+        // Short lanes and types without radix sort
+        check_radix_sort(xtensor<double, 1>(xt::cast<double>(xt::view(i, xt::range(0, 100)))));
+        check_radix_sort(xtensor<long double, 1>(xt::cast<long double>(i)));
+
+        xtensor<double, 1> z = xt::zeros<double>({1800});
+        for (std::size_t k = 0; k < 1800; k += 6)
+        {
+            z(k + 1) = -0.;
+            z(k + 2) = 1.;
+            z(k + 3) = -1.;
+            z(k + 5) = -0.;
+        }
+        auto sz = xt::sort(z);
+        EXPECT_EQ(sz(0), -1.);
+        EXPECT_EQ(sz(z.size() - 1), 1.);
+        EXPECT_TRUE(xt::all(xt::equal(xt::view(sz, xt::range(300, 1500)), 0.)));
+
+        xthread_pool pool(3);
+        xtensor<std::uint32_t, 1> u = xt::arange<std::uint32_t>(400000) * 2654435761u % 1000u;
+        auto ref = xt::argsort(u, 0, sorting_method::stable);
+        EXPECT_EQ(xt::argsort(u, xnone(), exec::par(pool), sorting_method::stable), ref);
+        EXPECT_EQ(xt::argsort(u, 0, exec::par(pool), sorting_method::stable), ref);
+        EXPECT_EQ(xt::sort(u, 0, exec::par(pool)), xt::sort(u));
+
+        xtensor<std::uint32_t, 2> v = xt::reshape_view(u, {2000, 200});
+        xtensor<std::uint32_t, 2> vt = xt::transpose(v);
+        EXPECT_EQ(xt::argsort(v, 0, sorting_method::stable), xt::transpose(xt::argsort(vt, 1, sorting_method::stable)));
+        EXPECT_EQ(xt::sort(v, 0), xt::transpose(xt::sort(vt, 1)));
+    }
+
+    TEST(xsort, argminmax_axes)
+    {
+        xarray<int> a = xt::fmod(xt::arange<int>(4 * 5 * 6) * 7, 5);
+        a.reshape({4, 5, 6});
+        xarray<int, layout_type::column_major> c = a;
+
+        // Brute force reference: the first extremum of each line along the axis.
+        auto check = [&a](const auto& input, std::size_t axis) {
+            auto amin_res = argmin(input, static_cast<std::ptrdiff_t>(axis));
+            auto amax_res = argmax(input, static_cast<std::ptrdiff_t>(axis));
+            std::size_t ax0 = axis == 0 ? 1 : 0;
+            std::size_t ax1 = axis == 2 ? 1 : 2;
+            bool ok = true;
+            for (std::size_t i = 0; i < a.shape()[ax0]; ++i)
+            {
+                for (std::size_t j = 0; j < a.shape()[ax1]; ++j)
+                {
+                    xstrided_slice_vector sv(3);
+                    sv[axis] = xt::all();
+                    sv[ax0] = static_cast<std::ptrdiff_t>(i);
+                    sv[ax1] = static_cast<std::ptrdiff_t>(j);
+                    auto line = xt::strided_view(a, sv);
+                    auto min_idx = std::distance(line.begin(), std::min_element(line.begin(), line.end()));
+                    auto max_idx = std::distance(line.begin(), std::max_element(line.begin(), line.end()));
+                    ok = ok && amin_res(i, j) == static_cast<std::size_t>(min_idx);
+                    ok = ok && amax_res(i, j) == static_cast<std::size_t>(max_idx);
+                }
+            }
+            return ok;
+        };
+
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            EXPECT_TRUE(check(a, axis));
+            EXPECT_TRUE(check(c, axis));
+        }
+
+        xarray<double> d = {2., 5., 1., 5., 1.};
+        EXPECT_EQ(argmax(d, 0)(), 1u);
+        EXPECT_EQ(argmin(d, 0)(), 2u);
+
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> n0 = {nan, 1., -1.};
+        xarray<double> n1 = {1., nan, -1., -1.};
+        EXPECT_EQ(argmin(n0)(), 0u);
+        EXPECT_EQ(argmin(n1)(), 2u);
+        EXPECT_EQ(argmax(n1, 0)(), 0u);
+    }
+
+    TEST(xsort, argminmax_large)
+    {
+        xtensor<double, 1> a = xt::fmod(xt::arange<double>(100000.), 1000.);
+        a(61234) = -1.;
+        a(81234) = -1.;
+        a(40000) = 2000.;
+        a(90000) = 2000.;
+        EXPECT_EQ(argmin(a)(), 61234u);
+        EXPECT_EQ(argmax(a)(), 40000u);
+
+        xtensor<double, 2> b = xt::reshape_view(a, {50, 2000});
+        auto bmin = argmin(b, 1);
+        EXPECT_EQ(bmin(30), 1234u);
+        EXPECT_EQ(bmin(0), 0u);
+        auto bmax = argmax(b, 0);
+        EXPECT_EQ(bmax(999), 0u);
+        EXPECT_EQ(bmax(0), 20u);
+    }
+
     TEST(xsort, sort_large_prob)
     {
         for (std::size_t i = 0; i < 20; ++i)
@@ -301,6 +637,94 @@ namespace xt
         auto e = xt::unique(xt::where(xt::greater(b,2), 1, 0));
         xarray<double> ex = {0, 1};
         EXPECT_EQ(e, ex);
+
+        // Few distinct values, deduplicated with a hash set; -0 equals 0
+        xtensor<double, 1> h = xt::fmod(xt::arange<double>(10000.) * 7., 23.) - 11.;
+        h(3) = -0.;
+        xtensor<double, 1> hx = xt::arange<double>(-11., 12.);
+        EXPECT_EQ(unique(h), hx);
+        EXPECT_EQ(unique(h + 0.), hx);
+    }
+
+    TEST(xsort, unique_inverse_counts)
+    {
+        xarray<int> a = {{3, 1, 3}, {-2, 1, 3}};
+        auto u = xt::unique(a, true, true);
+        xtensor<int, 1> values = {-2, 1, 3};
+        xtensor<std::size_t, 1> inverse = {2, 1, 2, 0, 1, 2};
+        xtensor<std::size_t, 1> counts = {1, 2, 3};
+        EXPECT_EQ(u.values, values);
+        EXPECT_EQ(u.inverse, inverse);
+        EXPECT_EQ(u.counts, counts);
+
+        auto v = xt::unique(a, false);
+        EXPECT_EQ(v.values, values);
+        EXPECT_EQ(v.inverse.size(), 0u);
+        EXPECT_EQ(v.counts.size(), 0u);
+
+        xtensor<double, 1> h = xt::fmod(xt::arange<double>(10000.) * 7., 23.);
+        auto w = xt::unique(h, true, true);
+        EXPECT_EQ(w.values, unique(h));
+        EXPECT_EQ(xt::sum(w.counts)(), h.size());
+        bool same = true;
+        for (std::size_t i = 0; i < h.size(); ++i)
+        {
+            same = same && w.values(w.inverse(i)) == h(i);
+        }
+        EXPECT_TRUE(same);
+    }
+
+    TEST(xsort, hash_rows)
+    {
+        xarray<double> a = {{1., -0., 3.}, {1., 0., 3.}, {1., 3., 0.}, {2., 0., 3.}};
+        auto h = hash_rows(a);
+        EXPECT_EQ(h.size(), 4u);
+        EXPECT_EQ(h(0), h(1));
+        EXPECT_NE(h(0), h(2));
+        EXPECT_NE(h(0), h(3));
+
+        xtensor<double, 2, layout_type::column_major> c = a;
+        EXPECT_EQ(hash_rows(c), h);
+        XT_EXPECT_THROW(hash_rows(xarray<double>({1., 2.})), std::runtime_error);
+    }
+
+    TEST(xsort, group_rows)
+    {
+        xtensor<int, 2> keys = {{1, 2}, {3, 4}, {1, 2}, {0, 9}, {3, 4}, {1, 2}};
+        auto g = group_rows(keys);
+        xtensor<std::size_t, 1> first = {0, 1, 3};
+        xtensor<std::size_t, 1> inverse = {0, 1, 0, 2, 1, 0};
+        xtensor<std::size_t, 1> counts = {3, 2, 1};
+        EXPECT_EQ(g.first, first);
+        EXPECT_EQ(g.inverse, inverse);
+        EXPECT_EQ(g.counts, counts);
+
+        xtensor<int, 2> empty = xtensor<int, 2>::from_shape({0, 2});
+        auto e = group_rows(empty);
+        EXPECT_EQ(e.first.size(), 0u);
+        EXPECT_EQ(e.inverse.size(), 0u);
+    }
+
+    TEST(xsort, unique_rows)
+    {
+        xarray<int> keys = {{3, 1}, {1, 2}, {3, 1}, {1, 0}, {1, 2}};
+        xtensor<int, 2> expected = {{1, 0}, {1, 2}, {3, 1}};
+        EXPECT_EQ(unique_rows(keys), expected);
+
+        // many rows with few distinct values, wider than a register
+        xtensor<std::size_t, 2> wide = xtensor<std::size_t, 2>::from_shape({1000, 17});
+        for (std::size_t i = 0; i < wide.shape()[0]; ++i)
+        {
+            for (std::size_t j = 0; j < wide.shape()[1]; ++j)
+            {
+                wide(i, j) = (i * 7) % 13 + j;
+            }
+        }
+        auto u = unique_rows(wide);
+        EXPECT_EQ(u.shape()[0], 13u);
+        EXPECT_EQ(u(0, 0), 0u);
+        EXPECT_EQ(u(12, 16), 28u);
+        EXPECT_EQ(group_rows(wide).first.size(), 13u);
     }
 
     TEST(xsort, setdiff1d)
@@ -318,6 +742,13 @@ namespace xt
             xarray<size_t> out = {2,3,5,6,7};
             EXPECT_EQ(setdiff1d(ar1, ar2), out);
         }
+
+        {
+            xtensor<int, 1> ar1 = xt::arange<int>(10000) % 101;
+            xtensor<double, 1> ar2 = xt::arange<double>(0., 101., 2.);
+            xtensor<int, 1> out = xt::arange<int>(1, 101, 2);
+            EXPECT_EQ(setdiff1d(ar1, ar2), out);
+        }
     }
 
     template <class T>
@@ -378,6 +809,40 @@ namespace xt
         EXPECT_TRUE(check_argpartition(b, r2, 2));
     }
 
+    TEST(xsort, partition_many_kth)
+    {
+        xarray<double> a = xt::fmod(xt::arange<double>(7 * 401) * 37., 101.);
+        a.reshape({7, 401});
+        std::vector<std::size_t> kth;
+        for (std::size_t p = 1; p < 100; ++p)
+        {
+            kth.push_back(p * 400 / 100);
+        }
+        kth.push_back(kth.front());
+        kth.push_back(0);
+        kth.push_back(400);
+
+        xthread_pool pool(3);
+        auto sorted = xt::sort(a, 1);
+        auto part = xt::partition(a, kth, 1);
+        auto part_par = xt::partition(a, kth, 1, exec::par(pool));
+        auto inds = xt::argpartition(a, kth, 1, exec::par(pool));
+        auto flat_sorted = xt::sort(a, xnone());
+        auto flat_part = xt::partition(a, kth, xnone());
+        auto flat_inds = xt::argpartition(a, kth, xnone());
+        for (std::size_t k : kth)
+        {
+            for (std::size_t i = 0; i < a.shape()[0]; ++i)
+            {
+                EXPECT_EQ(part(i, k), sorted(i, k));
+                EXPECT_EQ(part_par(i, k), sorted(i, k));
+                EXPECT_EQ(a(i, inds(i, k)), sorted(i, k));
+            }
+            EXPECT_EQ(flat_part(k), flat_sorted(k));
+            EXPECT_EQ(a.flat(flat_inds(k)), flat_sorted(k));
+        }
+    }
+
     TEST(xsort, median)
     {
         xt::xtensor<float, 2> a = {{ 3, 4, 2, 1},
@@ -396,4 +861,61 @@ namespace xt
         EXPECT_EQ(ma0, ma0_exp);
         EXPECT_EQ(ma1, ma1_exp);
     }
+
+    TEST(xsort, quantile)
+    {
+        xtensor<int, 1> v = xt::arange<int>(10, 0, -1);
+        auto q = xt::quantile(v, {0.5, 0.9, 0.99});
+        EXPECT_EQ(q.size(), 3u);
+        EXPECT_DOUBLE_EQ(q(0), 5.5);
+        EXPECT_DOUBLE_EQ(q(1), 9.1);
+        EXPECT_DOUBLE_EQ(q(2), 9.91);
+        XT_EXPECT_THROW(xt::quantile(v, {1.5}), std::runtime_error);
+
+        xarray<double> a = xt::fmod(xt::arange<double>(3 * 37 * 19) * 7., 11.);
+        a.reshape({3, 37, 19});
+        xarray<double, layout_type::column_major> c = a;
+        std::array<double, 6> probs = {0.99, 0., 0.25, 0.5, 1., 0.9};
+
+        // Checks the quantiles of each lane along the axis against the sorted lane
+        auto check = [&a, &probs](const auto& input, std::size_t axis) {
+            auto res = xt::quantile(input, probs, static_cast<std::ptrdiff_t>(axis));
+            auto med = xt::median(input, static_cast<std::ptrdiff_t>(axis));
+            std::size_t ax0 = axis == 0 ? 1 : 0;
+            std::size_t ax1 = axis == 2 ? 1 : 2;
+            std::size_t n = a.shape()[axis];
+            bool ok = res.dimension() == 3 && res.shape()[0] == probs.size();
+            for (std::size_t i = 0; i < a.shape()[ax0]; ++i)
+            {
+                for (std::size_t j = 0; j < a.shape()[ax1]; ++j)
+                {
+                    xstrided_slice_vector sv(3);
+                    sv[axis] = xt::all();
+                    sv[ax0] = static_cast<std::ptrdiff_t>(i);
+                    sv[ax1] = static_cast<std::ptrdiff_t>(j);
+                    std::vector<double> ref;
+                    auto line = xt::strided_view(a, sv);
+                    std::copy(line.begin(), line.end(), std::back_inserter(ref));
+                    std::sort(ref.begin(), ref.end());
+                    for (std::size_t k = 0; k < probs.size(); ++k)
+                    {
+                        double h = static_cast<double>(n - 1) * probs[k];
+                        std::size_t lo = static_cast<std::size_t>(h);
+                        std::size_t hi = (std::min)(lo + 1, n - 1);
+                        double expected = ref[lo] + (ref[hi] - ref[lo]) * (h - static_cast<double>(lo));
+                        ok = ok && std::abs(res(k, i, j) - expected) < 1e-12;
+                    }
+                    ok = ok && res(3, i, j) == med(i, j);
+                }
+            }
+            return ok;
+        };
+
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            EXPECT_TRUE(check(a, axis));
+            EXPECT_TRUE(check(c, axis));
+            EXPECT_TRUE(check(a + 0., axis));
+        }
+    }
 }
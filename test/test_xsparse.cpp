@@ -0,0 +1,146 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xsparse.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xsparse, construction)
+    {
+        xarray<double> a = {{0., 2., 0.}, {0., 0., 0.}, {3., 0., 4.}};
+        xsparse_array<double> s(a);
+        EXPECT_EQ(s.nnz(), 3u);
+        EXPECT_EQ(s.dimension(), 2u);
+        EXPECT_EQ(s.indices(), (std::vector<std::size_t>{1, 6, 8}));
+        EXPECT_EQ(s.coords(1), (xsparse_array<double>::shape_type{2, 0}));
+        EXPECT_EQ(s(0, 1), 2.);
+        EXPECT_EQ(s(1, 1), 0.);
+        EXPECT_EQ(s(2, 2), 4.);
+        EXPECT_EQ(s.to_dense(), a);
+
+        // Unsorted indices, with duplicates
+        xsparse_array<double> t({3, 3}, {8, 1, 6, 8}, {1., 2., 3., 3.});
+        EXPECT_EQ(t.indices(), s.indices());
+        EXPECT_EQ(t.values(), s.values());
+
+        t.values()[0] = 0.;
+        t.prune();
+        EXPECT_EQ(t.nnz(), 2u);
+        EXPECT_EQ(t(0, 1), 0.);
+
+        XT_EXPECT_THROW(xsparse_array<double>({2, 2}, {4}, {1.}), std::out_of_range);
+    }
+
+    TEST(xsparse, expression)
+    {
+        xarray<double> a = {{0., 2., 0.}, {0., 0., 0.}, {3., 0., 4.}};
+        xsparse_array<double> s(a);
+
+        xarray<double> b = s + a;
+        EXPECT_EQ(b, 2. * a);
+
+        xarray<double> row = {1., 2., 3.};
+        xarray<double> c = s * row;
+        EXPECT_EQ(c, a * row);
+
+        xarray<double> d = s;
+        EXPECT_EQ(d, a);
+        EXPECT_EQ(sum(s)(), 9.);
+    }
+
+    TEST(xsparse, map)
+    {
+        xarray<double> a = {{0., 2.}, {-3., 0.}};
+        xsparse_array<double> s(a);
+
+        auto twice = sparse_map([](double x) { return 2. * x; }, s);
+        EXPECT_EQ(twice.nnz(), 2u);
+        EXPECT_EQ(twice.to_dense(), 2. * a);
+
+        auto shifted = sparse_map([](double x) { return x + 1.; }, s);
+        EXPECT_EQ(shifted.nnz(), 4u);
+        EXPECT_EQ(shifted.to_dense(), a + 1.);
+    }
+
+    TEST(xsparse, binary)
+    {
+        xarray<int> a = {{1, 0, 0}, {0, 2, 0}};
+        xarray<int> b = {{0, 0, 5}, {0, -2, 0}};
+        xsparse_array<int> sa(a);
+        xsparse_array<int> sb(b);
+
+        auto sum_ab = sparse_add(sa, sb);
+        EXPECT_EQ(sum_ab.nnz(), 2u);
+        EXPECT_EQ(sum_ab.to_dense(), a + b);
+
+        auto diff_ab = sparse_subtract(sa, sb);
+        EXPECT_EQ(diff_ab.to_dense(), a - b);
+
+        auto prod_ab = sparse_multiply(sa, sb);
+        EXPECT_EQ(prod_ab.nnz(), 1u);
+        EXPECT_EQ(prod_ab.to_dense(), a * b);
+
+        xarray<double> dense = {{2., 3., 4.}, {5., 6., 7.}};
+        auto prod_dense = sparse_multiply(sa, dense);
+        EXPECT_EQ(prod_dense.nnz(), 2u);
+        EXPECT_EQ(prod_dense(0, 0), 2.);
+        EXPECT_EQ(prod_dense(1, 1), 12.);
+
+        xsparse_array<int> sc(xsparse_array<int>::shape_type{3, 2});
+        XT_EXPECT_THROW(sparse_add(sa, sc), broadcast_error);
+    }
+
+    TEST(xsparse, reducers)
+    {
+        xarray<double> a = {{{0., 1.}, {0., 0.}}, {{2., 0.}, {0., 3.}}};
+        xsparse_array<double> s(a);
+        EXPECT_EQ(sparse_sum(s), 6.);
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<double> expected = sum(a, {axis});
+            EXPECT_EQ(sparse_sum(s, axis), expected);
+        }
+    }
+
+    TEST(xsparse, csr)
+    {
+        xarray<double> a = {{0., 2., 0.}, {0., 0., 0.}, {3., 0., 4.}, {0., 1., 0.}};
+        xcsr_matrix<double> m(a);
+        EXPECT_EQ(m.nnz(), 4u);
+        EXPECT_EQ(m.indptr(), (std::vector<std::size_t>{0, 1, 1, 3, 4}));
+        EXPECT_EQ(m.indices(), (std::vector<std::size_t>{1, 0, 2, 1}));
+        EXPECT_EQ(m(2, 2), 4.);
+        EXPECT_EQ(m(1, 0), 0.);
+        EXPECT_EQ(m.to_dense(), a);
+        EXPECT_EQ(xsparse_array<double>(m).to_dense(), a);
+
+        xarray<double> b = m;
+        EXPECT_EQ(b, a);
+
+        xtensor<double, 1> x = {1., 2., 3.};
+        xarray<double> y = sparse_dot(m, x);
+        xarray<double> expected_y = {4., 0., 15., 2.};
+        EXPECT_EQ(y, expected_y);
+
+        xarray<double> X = {{1., 0.}, {2., 1.}, {3., -1.}};
+        xarray<double> Y = sparse_dot(xsparse_array<double>(a), X);
+        xarray<double> expected_Y = {{4., 2.}, {0., 0.}, {15., -4.}, {2., 1.}};
+        EXPECT_EQ(Y, expected_Y);
+
+        XT_EXPECT_THROW(sparse_dot(m, xarray<double>::from_shape({4})), std::runtime_error);
+    }
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <complex>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xsplit_complex.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    using namespace std::complex_literals;
+    using split_array = xsplit_complex<xarray<double>>;
+
+    TEST(xsplit_complex, construction)
+    {
+        xarray<std::complex<double>> a = {{1. + 2.i, 3. - 4.i, 1.i},
+                                          {-1. + 0.i, 2. + 2.i, 5. - 1.i}};
+        split_array s(a);
+        EXPECT_EQ(s.shape(), a.shape());
+        EXPECT_EQ(s.size(), 6u);
+        EXPECT_EQ(s.dimension(), 2u);
+        EXPECT_EQ(s(0, 1), a(0, 1));
+        EXPECT_EQ(s(1, 2), a(1, 2));
+
+        xarray<double> re = {{1., 3., 0.}, {-1., 2., 5.}};
+        xarray<double> im = {{2., -4., 1.}, {0., 2., -1.}};
+        EXPECT_EQ(real(s), re);
+        EXPECT_EQ(imag(s), im);
+
+        split_array p(re, im);
+        EXPECT_EQ(p(0, 1), std::complex<double>(3., -4.));
+        xarray<double> bad = {1., 2.};
+        XT_EXPECT_THROW(split_array(re, bad), std::runtime_error);
+
+        xarray<std::complex<double>> back = s.expression();
+        EXPECT_EQ(back, a);
+
+        xtensor<double, 1> d = {1., 2., 3.};
+        auto t = split_complex(d);
+        EXPECT_EQ(t(1), std::complex<double>(2., 0.));
+        EXPECT_TRUE((std::is_same<decltype(t)::container_type, xtensor<double, 1>>::value));
+    }
+
+    TEST(xsplit_complex, parts)
+    {
+        split_array s(split_array::shape_type({2, 3}));
+        real(s) = xt::arange<double>(6.).reshape({2, 3});
+        imag(s).fill(1.);
+        EXPECT_EQ(s(1, 2), std::complex<double>(5., 1.));
+        // The parts are contiguous containers
+        EXPECT_EQ(real(s).data() + 1, &real(s)(0, 1));
+
+        const split_array& cs = s;
+        EXPECT_EQ(&real(cs), &s.real());
+        xarray<double> moved = real(std::move(s));
+        EXPECT_EQ(moved(1, 1), 4.);
+    }
+
+    TEST(xsplit_complex, assign)
+    {
+        xarray<std::complex<double>> a = {1. + 2.i, 3. - 4.i, 1.i, -2. + 0.5i};
+        split_array s;
+        s = a * a;
+        xarray<std::complex<double>> ea = a * a;
+        EXPECT_EQ(s.shape(), ea.shape());
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(s(i), ea(i));
+        }
+        // Real expressions have a null imaginary part
+        s = xt::ones<double>({2, 2});
+        EXPECT_EQ(s(1, 1), std::complex<double>(1., 0.));
+
+        xsplit_complex<xarray<double, layout_type::column_major>> c = xt::arange<double>(6.).reshape({2, 3});
+        EXPECT_EQ(c(1, 0), std::complex<double>(3., 0.));
+        EXPECT_EQ(real(c)(1, 0), 3.);
+    }
+
+    TEST(xsplit_complex, functions)
+    {
+        xarray<std::complex<double>> a = {1. + 2.i, 3. - 4.i, 1.i, -2. + 0.5i, -1. - 1.i};
+        split_array s(a);
+        xarray<double> r = abs(s);
+        xarray<double> n = norm(s);
+        xarray<double> g = arg(s);
+        xarray<std::complex<double>> c = conj(s);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(r(i), std::abs(a(i)));
+            EXPECT_DOUBLE_EQ(n(i), std::norm(a(i)));
+            EXPECT_DOUBLE_EQ(g(i), std::arg(a(i)));
+            EXPECT_EQ(c(i), std::conj(a(i)));
+        }
+        xarray<double> rr = norm(split_array(a));
+        EXPECT_EQ(rr, n);
+    }
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xpad.hpp"
+#include "xtensor/xstencil.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Applies a 2D stencil with integral weights steps times, padding
+        // the grid with xt::pad before each step
+        xarray<double> naive_stencil_2d(xarray<double> a, const xstencil<double>& st, std::size_t steps, pad_mode mode)
+        {
+            std::vector<std::vector<std::size_t>> width = {{st.lower_halo(0), st.upper_halo(0)},
+                                                           {st.lower_halo(1), st.upper_halo(1)}};
+            for (std::size_t s = 0; s < steps; ++s)
+            {
+                xarray<double> p = pad(a, width, mode, 0.);
+                xarray<double> res = zeros<double>(a.shape());
+                for (std::size_t i = 0; i < a.shape()[0]; ++i)
+                {
+                    for (std::size_t j = 0; j < a.shape()[1]; ++j)
+                    {
+                        for (std::size_t t = 0; t < st.size(); ++t)
+                        {
+                            std::size_t pi = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(i + st.lower_halo(0)) + st.offsets()[t][0]);
+                            std::size_t pj = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(j + st.lower_halo(1)) + st.offsets()[t][1]);
+                            res(i, j) += st.weights()[t] * p(pi, pj);
+                        }
+                    }
+                }
+                a = res;
+            }
+            return a;
+        }
+    }
+
+    TEST(xstencil, stencil)
+    {
+        auto st = stencil({{0, 0}, {-1, 0}, {2, 0}, {0, -3}}, {1., 2., 3., 4.});
+        EXPECT_EQ(st.dimension(), 2u);
+        EXPECT_EQ(st.size(), 4u);
+        EXPECT_EQ(st.lower_halo(0), 1u);
+        EXPECT_EQ(st.upper_halo(0), 2u);
+        EXPECT_EQ(st.lower_halo(1), 3u);
+        EXPECT_EQ(st.upper_halo(1), 0u);
+
+        XT_EXPECT_THROW(stencil({{0, 0}, {1}}, {1., 2.}), std::runtime_error);
+        XT_EXPECT_THROW(stencil({{0, 0}, {1, 0}}, {1.}), std::runtime_error);
+    }
+
+    TEST(xstencil, apply_stencil)
+    {
+        auto lap = stencil({{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}}, {-4., 1., 1., 1., 1.});
+        xarray<double> a = fmod(arange<double>(37. * 45.), 7.) - 3.;
+        a.reshape({37, 45});
+
+        xarray<double> res;
+        apply_stencil(res, a, lap);
+        EXPECT_EQ(res, naive_stencil_2d(a, lap, 1, pad_mode::constant));
+
+        apply_stencil(res, a, lap, 3, pad_mode::wrap);
+        EXPECT_EQ(res, naive_stencil_2d(a, lap, 3, pad_mode::wrap));
+
+        auto skew = stencil({{0, 0}, {-2, 1}, {1, -1}}, {2., -1., 1.});
+        apply_stencil(res, a, skew, 2, pad_mode::reflect, exec::par());
+        EXPECT_EQ(res, naive_stencil_2d(a, skew, 2, pad_mode::reflect));
+
+        // In place, into an xtensor
+        xtensor<double, 2> t = a;
+        apply_stencil(t, t, lap, 1, pad_mode::symmetric);
+        EXPECT_EQ(xarray<double>(t), naive_stencil_2d(a, lap, 1, pad_mode::symmetric));
+
+        // 1D, with integral values
+        xarray<int> line = {1, 2, 4, 8, 16};
+        xarray<int> line_res;
+        apply_stencil(line_res, line, stencil({{-1}, {1}}, {1, -1}));
+        EXPECT_EQ(line_res, (xarray<int>{-2, -3, -6, -12, 8}));
+
+        // 7-point stencil on a 3D grid
+        xarray<double> cube = fmod(arange<double>(4. * 5. * 6.), 5.);
+        cube.reshape({4, 5, 6});
+        auto seven = stencil({{0, 0, 0}, {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}},
+                             {-6., 1., 1., 1., 1., 1., 1.});
+        xarray<double> cube_res;
+        apply_stencil(cube_res, cube, seven);
+        xarray<double> p = pad(cube, 1);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                for (std::size_t k = 0; k < 6; ++k)
+                {
+                    double expected = -6. * p(i + 1, j + 1, k + 1) + p(i, j + 1, k + 1) + p(i + 2, j + 1, k + 1)
+                                      + p(i + 1, j, k + 1) + p(i + 1, j + 2, k + 1) + p(i + 1, j + 1, k) + p(i + 1, j + 1, k + 2);
+                    EXPECT_EQ(cube_res(i, j, k), expected);
+                }
+            }
+        }
+
+        XT_EXPECT_THROW(apply_stencil(res, cube, lap), std::runtime_error);
+        XT_EXPECT_THROW(apply_stencil(line_res, line, stencil({{-6}}, {1}), 1, pad_mode::wrap), std::runtime_error);
+    }
+
+    TEST(xstencil, temporal_blocking)
+    {
+        // Enough rows for several tiles, then rows too long to be tiled
+        auto st = stencil({{0, 0}, {-1, 0}, {2, 0}, {0, -1}, {0, 1}}, {1., 1., -1., 1., -1.});
+        xarray<double> a = fmod(arange<double>(1000. * 30.), 5.) - 2.;
+        a.reshape({1000, 30});
+        xarray<double> res;
+        apply_stencil(res, a, st, 4);
+        EXPECT_EQ(res, naive_stencil_2d(a, st, 4, pad_mode::constant));
+        xarray<double> par_res;
+        apply_stencil(par_res, a, st, 4, pad_mode::constant, exec::par());
+        EXPECT_EQ(par_res, res);
+
+        xarray<double> b = fmod(arange<double>(3. * 20000.), 3.);
+        b.reshape({3, 20000});
+        apply_stencil(res, b, st, 2);
+        EXPECT_EQ(res, naive_stencil_2d(b, st, 2, pad_mode::constant));
+    }
+}
@@ -11,7 +11,11 @@
 #include "test_common_macros.hpp"
 #include "xtensor/xtensor_config.hpp"
 #include "xtensor/xstorage.hpp"
+#include <complex>
+#include <cstdint>
+#include <cstring>
 #include <numeric>
+#include <string>
 
 namespace xt
 {
@@ -53,6 +57,93 @@ namespace xt
         }
     }
 
+    // Counts the blocks it allocates
+    template <class T>
+    struct counting_allocator : std::allocator<T>
+    {
+        template <class U>
+        struct rebind
+        {
+            using other = counting_allocator<U>;
+        };
+
+        counting_allocator() = default;
+
+        template <class U>
+        counting_allocator(const counting_allocator<U>&)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            ++count();
+            return std::allocator<T>::allocate(n);
+        }
+
+        static std::size_t& count()
+        {
+            static std::size_t c = 0;
+            return c;
+        }
+    };
+
+    TEST(uvector, capacity)
+    {
+        using counted_type = uvector<double, counting_allocator<double>>;
+        counting_allocator<double>::count() = 0;
+        counted_type a(100);
+        EXPECT_EQ(size_t(100), a.capacity());
+
+        // Resizing within the capacity reuses the buffer
+        a[10] = 2.5;
+        a.resize(50);
+        a.resize(100);
+        EXPECT_EQ(size_t(1), counting_allocator<double>::count());
+        EXPECT_EQ(size_t(100), a.capacity());
+        EXPECT_EQ(2.5, a[10]);
+
+        a.resize(150);
+        EXPECT_EQ(size_t(2), counting_allocator<double>::count());
+        EXPECT_EQ(size_t(150), a.capacity());
+
+        a.resize(20);
+        std::iota(a.begin(), a.end(), 0.);
+        a.reserve(40);
+        EXPECT_EQ(size_t(150), a.capacity());
+        a.shrink_to_fit();
+        EXPECT_EQ(size_t(20), a.capacity());
+        EXPECT_EQ(19., a[19]);
+        a.reserve(60);
+        EXPECT_EQ(size_t(60), a.capacity());
+        EXPECT_EQ(size_t(20), a.size());
+        EXPECT_EQ(19., a[19]);
+
+        a.clear();
+        EXPECT_EQ(size_t(60), a.capacity());
+        a.shrink_to_fit();
+        EXPECT_EQ(size_t(0), a.capacity());
+        EXPECT_TRUE(a.data() == nullptr);
+
+        counted_type b(a);
+        b.resize(30);
+        counted_type c(std::move(b));
+        EXPECT_EQ(size_t(30), c.capacity());
+        EXPECT_EQ(size_t(0), b.capacity());
+        c = a;
+        EXPECT_EQ(size_t(30), c.capacity());
+        EXPECT_EQ(size_t(0), c.size());
+
+        uvector<std::string> s(3, std::string(40, 'x'));
+        s.resize(1);
+        s.resize(3);
+        EXPECT_EQ(std::string(40, 'x'), s[0]);
+        EXPECT_EQ(std::string(), s[2]);
+        s.reserve(10);
+        EXPECT_EQ(std::string(40, 'x'), s[0]);
+        s.shrink_to_fit();
+        EXPECT_EQ(size_t(3), s.capacity());
+    }
+
     TEST(uvector, access)
     {
         vector_type a(10);
@@ -83,6 +174,117 @@ namespace xt
         }
     }
 
+    // Fills the blocks it allocates with a known pattern, to check that
+    // uninitialized containers do not write to their buffer.
+    template <class T>
+    struct pattern_allocator : std::allocator<T>
+    {
+        template <class U>
+        struct rebind
+        {
+            using other = pattern_allocator<U>;
+        };
+
+        pattern_allocator() = default;
+
+        template <class U>
+        pattern_allocator(const pattern_allocator<U>&)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            T* p = std::allocator<T>::allocate(n);
+            std::memset(static_cast<void*>(p), 0x5A, n * sizeof(T));
+            return p;
+        }
+    };
+
+    TEST(uvector, uninitialized)
+    {
+        int pattern;
+        std::memset(&pattern, 0x5A, sizeof(int));
+
+        uvector<int, pattern_allocator<int>> a(100, uninitialized);
+        EXPECT_EQ(size_t(100), a.size());
+        EXPECT_EQ(pattern, a[42]);
+
+        a.resize(1000, uninitialized);
+        EXPECT_EQ(size_t(1000), a.size());
+        EXPECT_EQ(pattern, a[999]);
+
+        uvector<std::complex<double>> b(10, uninitialized);
+        EXPECT_EQ(std::complex<double>(), b[3]);
+        b.resize(20, uninitialized);
+        EXPECT_EQ(std::complex<double>(), b[19]);
+    }
+
+    /**************
+     * allocators *
+     **************/
+
+    TEST(first_touch_allocator, uvector)
+    {
+        using allocator_type = first_touch_allocator<double>;
+        uvector<double, allocator_type> a(100000, 1.5);
+        EXPECT_EQ(size_t(100000), a.size());
+        EXPECT_EQ(1.5, a[54321]);
+
+        a.resize(10);
+        std::iota(a.begin(), a.end(), 0.);
+        uvector<double, allocator_type> b = a;
+        EXPECT_EQ(b, a);
+
+        using rebound_type = std::allocator_traits<allocator_type>::rebind_alloc<int>;
+        bool same_type = std::is_same<rebound_type, first_touch_allocator<int>>::value;
+        EXPECT_TRUE(same_type);
+        EXPECT_TRUE(allocator_type() == first_touch_allocator<int>());
+    }
+
+    TEST(first_touch_allocator, first_touch)
+    {
+        xthread_pool pool(2);
+        std::allocator<double> alloc;
+        std::size_t n = 100000;
+        double* p = alloc.allocate(n);
+        first_touch(p, n, exec::par(pool));
+        std::fill(p, p + n, 2.);
+        EXPECT_EQ(2., p[n - 1]);
+        alloc.deallocate(p, n);
+    }
+
+#if defined(XTENSOR_USE_NUMA)
+    TEST(numa_interleave_allocator, uvector)
+    {
+        using allocator_type = numa_interleave_allocator<double>;
+        uvector<double, allocator_type> a(100000, 1.5);
+        EXPECT_EQ(1.5, a[54321]);
+        uvector<double, allocator_type> b(10, 2.5);
+        EXPECT_EQ(2.5, b[9]);
+        b = a;
+        EXPECT_EQ(b, a);
+    }
+#endif
+
+    TEST(huge_page_allocator, uvector)
+    {
+        using allocator_type = huge_page_allocator<double>;
+        std::size_t n = 3 * allocator_type::min_size() / sizeof(double);
+        uvector<double, allocator_type> a(n, 1.5);
+        EXPECT_EQ(1.5, a[n - 1]);
+#if defined(__linux__)
+        EXPECT_EQ(std::size_t(0), reinterpret_cast<std::uintptr_t>(a.data()) % allocator_type::huge_page_size());
+#endif
+        uvector<double, allocator_type> b(10, 2.5);
+        EXPECT_EQ(2.5, b[9]);
+        b = a;
+        EXPECT_EQ(b, a);
+        a.resize(n / 2);
+        a.shrink_to_fit();
+        EXPECT_EQ(1.5, a[n / 2 - 1]);
+        EXPECT_TRUE(allocator_type() == huge_page_allocator<int>());
+    }
+
     /***********
      * svector *
      ***********/
@@ -0,0 +1,88 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <stdexcept>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xstream_pipeline.hpp"
+#include "xtensor/xstreaming_reducer.hpp"
+
+namespace xt
+{
+    TEST(xstream_pipeline, run)
+    {
+        const std::size_t nb_batches = 50;
+        std::size_t produced = 0;
+        std::size_t consumed = 0;
+        bool ordered = true;
+        std::set<const double*> buffers;
+        auto acc = make_streaming_reducer<double>(std::plus<double>(), {0});
+
+        xstream_pipeline<xarray<double>> p(1);
+        p.source([&](xarray<double>& b) {
+             if (produced == nb_batches)
+             {
+                 return false;
+             }
+             b.resize({4, 3});
+             b.fill(double(produced++));
+             return true;
+         })
+         .stage([](xarray<double>& b) { b += 1.; })
+         .stage([](xarray<double>& b) { exp_inplace(b); })
+         .sink([&](const xarray<double>& b) {
+             double value = std::exp(double(consumed + 1));
+             ordered = ordered && std::abs(b(0, 0) - value) <= 1e-12 * value;
+             buffers.insert(b.data());
+             acc.update(b);
+             ++consumed;
+         });
+
+        EXPECT_EQ(p.stages(), 2u);
+        EXPECT_EQ(p.run(), nb_batches);
+        EXPECT_EQ(consumed, nb_batches);
+        EXPECT_TRUE(ordered);
+        EXPECT_LE(buffers.size(), p.buffers());
+
+        xarray<double> expected = zeros<double>({3});
+        for (std::size_t i = 0; i < nb_batches; ++i)
+        {
+            expected += 4. * std::exp(double(i + 1));
+        }
+        EXPECT_TRUE(allclose(acc.result(), expected));
+    }
+
+    TEST(xstream_pipeline, error)
+    {
+        std::size_t produced = 0;
+        xstream_pipeline<xarray<double>> p;
+        p.source([&](xarray<double>& b) {
+             b.resize({1});
+             b(0) = double(produced++);
+             return true;
+         })
+         .stage([](xarray<double>& b) {
+             if (b(0) == 10.)
+             {
+                 throw std::runtime_error("stage failure");
+             }
+         });
+        XT_EXPECT_THROW(p.run(), std::runtime_error);
+
+        xstream_pipeline<xarray<double>> empty;
+        XT_EXPECT_THROW(empty.run(), std::logic_error);
+    }
+}
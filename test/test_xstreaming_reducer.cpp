@@ -0,0 +1,126 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunked_view.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xstreaming_reducer.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        xarray<double> make_frames()
+        {
+            xarray<double> a = xt::fmod(xt::arange<double>(240.), 11.) - 5.;
+            a.reshape({12, 4, 5});
+            return a;
+        }
+    }
+
+    TEST(xstreaming_reducer, update)
+    {
+        xarray<double> a = make_frames();
+        auto running_sum = make_streaming_reducer<double>(std::plus<double>(), {0});
+        auto running_min = make_streaming_reducer<double>(
+            make_xreducer_functor(math::minimum<>(), const_value<double>(std::numeric_limits<double>::max())), {0});
+        EXPECT_TRUE(running_sum.empty());
+        XT_EXPECT_THROW(running_sum.result(), std::runtime_error);
+
+        for (std::size_t i = 0; i < 12; i += 3)
+        {
+            auto frames = view(a, range(i, i + 3));
+            running_sum.update(frames);
+            running_min.update(frames);
+        }
+        EXPECT_EQ(running_sum.batches(), 4u);
+        EXPECT_EQ(running_sum.result(), sum(a, {0}));
+        EXPECT_EQ(running_min.result(), amin(a, {0}));
+
+        xarray<double> frame = view(a, 0);
+        XT_EXPECT_THROW(running_sum.update(view(frame, range(0, 2))), std::runtime_error);
+
+        running_sum.reset();
+        EXPECT_TRUE(running_sum.empty());
+        running_sum.update(a);
+        EXPECT_EQ(running_sum.result(), sum(a, {0}));
+    }
+
+    TEST(xstreaming_reducer, options)
+    {
+        xarray<double> a = make_frames();
+        auto s = make_streaming_reducer<double>(std::plus<double>(), {0, -1}, keep_dims | xt::initial(3.));
+        s.update(view(a, range(0, 5)));
+        s.update(view(a, range(5, 12)));
+        EXPECT_EQ(s.result(), sum(a, {0, 2}, keep_dims | xt::initial(3.)));
+
+        auto count = make_streaming_reducer<double>(
+            make_xreducer_functor([](std::size_t c, double v) { return v > 0. ? c + 1 : c; },
+                                  const_value<std::size_t>(0), std::plus<std::size_t>()),
+            std::vector<std::size_t>{0, 1});
+        count.update(view(a, range(0, 7)));
+        count.update(view(a, range(7, 12)));
+        xtensor<std::size_t, 1> expected = sum(cast<std::size_t>(a > 0.), {0, 1});
+        EXPECT_EQ(count.result(), expected);
+    }
+
+    TEST(xstreaming_reducer, merge)
+    {
+        xarray<double> a = make_frames();
+        auto make = []() { return make_streaming_reducer<double>(std::plus<double>(), {0}); };
+        std::vector<decltype(make())> partials(3, make());
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < partials.size(); ++t)
+        {
+            workers.emplace_back([&a, &partials, t]()
+            {
+                for (std::size_t i = t; i < 12; i += 3)
+                {
+                    partials[t].update(view(a, range(i, i + 1)));
+                }
+            });
+        }
+        for (auto& w : workers)
+        {
+            w.join();
+        }
+
+        auto total = make();
+        for (const auto& p : partials)
+        {
+            total.merge(p);
+        }
+        total.merge(make());
+        EXPECT_EQ(total.batches(), 12u);
+        EXPECT_EQ(total.result(), sum(a, {0}));
+    }
+
+    TEST(xstreaming_reducer, chunks)
+    {
+        xarray<double> a = make_frames();
+        std::vector<std::size_t> chunk_shape = {5, 4, 5};
+        auto chunked = as_chunked(a, chunk_shape);
+        auto s = make_streaming_reducer<double>(std::plus<double>(), {0});
+        for (auto it = chunked.chunk_begin(); it != chunked.chunk_end(); ++it)
+        {
+            s.update(*it);
+        }
+        EXPECT_EQ(s.result(), sum(a, {0}));
+    }
+}
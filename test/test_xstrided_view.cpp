@@ -729,6 +729,33 @@ namespace xt
         EXPECT_EQ(res, exp);
     }
 
+    TEST(xstrided_view, reshape_view_zero_copy)
+    {
+        bool truthy = is_zero_copy_reshape<xarray<double, layout_type::row_major>, layout_type::row_major>::value;
+        EXPECT_TRUE(truthy);
+        truthy = is_zero_copy_reshape<const xtensor<double, 2, layout_type::column_major>&, layout_type::column_major>::value;
+        EXPECT_TRUE(truthy);
+        truthy = is_zero_copy_reshape<xarray<double, layout_type::row_major>, layout_type::column_major>::value;
+        EXPECT_FALSE(truthy);
+        truthy = is_zero_copy_reshape<xarray<double, layout_type::dynamic>, layout_type::row_major>::value;
+        EXPECT_FALSE(truthy);
+
+        xtensor<double, 2> a = arange<double>(12).reshape({3, 4});
+        auto v = reshape_view<layout_type::row_major>(a, {2, 6});
+        EXPECT_EQ(&v(0, 0), a.data());
+        EXPECT_EQ(&v(1, 5), a.data() + 11);
+        EXPECT_EQ(&(*v.linear_begin()), a.data());
+        v(1, 0) = -1.;
+        EXPECT_EQ(a(1, 2), -1.);
+
+        auto sv = view(a, all(), range(0, 2));
+        truthy = is_zero_copy_reshape<decltype(sv), layout_type::row_major>::value;
+        EXPECT_FALSE(truthy);
+        xtensor<double, 1> res = reshape_view<layout_type::row_major>(sv, {6});
+        xtensor<double, 1> expected = {0., 1., 4., 5., 8., 9.};
+        EXPECT_EQ(res, expected);
+    }
+
     TEST(xstrided_view, on_xview)
     {
         xarray<double> a = {0, 1, 2, 3, 4, 5, 6, 7, 8};
@@ -202,6 +202,37 @@ namespace xt
         }
     }
 
+    TEST(xstrides, unravel_plan)
+    {
+        using shape_type = std::array<std::size_t, 4>;
+        shape_type shape = { 7, 1, 13, 641 };
+        std::vector<std::size_t> flat = { 0, 1, 640, 641, 5000, 58330, 58331 };
+
+        for (layout_type l : { layout_type::row_major, layout_type::column_major })
+        {
+            auto plan = unravel_plan(shape, l);
+            EXPECT_EQ(plan.dimension(), std::size_t(4));
+            auto indices = plan.unravel_indices(flat);
+            auto expected = unravel_indices(flat, shape, l);
+            for (std::size_t i = 0; i < flat.size(); ++i)
+            {
+                auto ref = unravel_index(flat[i], shape, l);
+                EXPECT_EQ(plan(static_cast<std::ptrdiff_t>(flat[i])), ref);
+                EXPECT_EQ(indices[i], ref);
+                EXPECT_EQ(expected[i], ref);
+                EXPECT_EQ(ravel_index(ref, shape, l), flat[i]);
+            }
+        }
+
+        xt::dynamic_shape<std::ptrdiff_t> strides = { 6, 0, 3, 1 };
+        xunravel_plan<xt::dynamic_shape<std::ptrdiff_t>> splan(strides, layout_type::row_major);
+        xt::dynamic_shape<std::ptrdiff_t> index(4);
+        splan.unravel(17, index);
+        EXPECT_EQ(index, unravel_from_strides(std::ptrdiff_t(17), strides, layout_type::row_major));
+
+        XT_EXPECT_THROW(unravel_plan(shape, layout_type::dynamic), std::runtime_error);
+    }
+
     TEST(xstrides, do_match_strides)
     {
         using vector_type = std::vector<std::size_t>;
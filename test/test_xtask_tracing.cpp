@@ -0,0 +1,123 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_common_macros.hpp"
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xtask_tracing.hpp"
+
+namespace xt
+{
+#if defined(XTENSOR_TASK_TRACING)
+    namespace
+    {
+        // Records the events of the parallel loops for the duration of a test
+        struct tracing_guard
+        {
+            tracing_guard()
+            {
+                task_tracing::clear();
+                task_tracing::enable();
+            }
+
+            ~tracing_guard()
+            {
+                task_tracing::disable();
+                task_tracing::clear();
+            }
+        };
+
+        std::vector<task_tracing::event> events_named(const std::string& name)
+        {
+            std::vector<task_tracing::event> res;
+            for (const auto& e : task_tracing::events())
+            {
+                if (name == e.name)
+                {
+                    res.push_back(e);
+                }
+            }
+            return res;
+        }
+    }
+
+    TEST(xtask_tracing, disabled)
+    {
+        xthread_pool pool(2);
+        task_tracing::clear();
+        exec::par(pool).for_range(0, 1000, 1, [](std::size_t, std::size_t) {});
+        EXPECT_TRUE(task_tracing::events().empty());
+    }
+
+    TEST(xtask_tracing, for_range)
+    {
+        xthread_pool pool(2);
+        tracing_guard guard;
+        exec::par(pool, 0, 100).for_range(0, 1000, 1, [](std::size_t, std::size_t) {});
+        task_tracing::disable();
+
+        auto loops = events_named("parallel_policy");
+        ASSERT_TRUE(loops.size() == 1u);
+        EXPECT_EQ(loops[0].elements, 1000u);
+
+        auto tasks = events_named("pool_task");
+        EXPECT_TRUE(tasks.size() > 1u);
+        std::size_t elements = 0;
+        for (const auto& t : tasks)
+        {
+            elements += t.elements;
+            EXPECT_TRUE(t.start >= loops[0].start);
+            EXPECT_TRUE(t.start + t.duration <= loops[0].start + loops[0].duration);
+        }
+        EXPECT_EQ(elements, 1000u);
+    }
+
+    TEST(xtask_tracing, assign)
+    {
+        xthread_pool pool(2);
+        xarray<double> a = arange<double>(10007.);
+        xarray<double> res = zeros<double>({10007});
+        tracing_guard guard;
+        noalias(res).assign(a * 2., exec::par(pool));
+        task_tracing::disable();
+        EXPECT_EQ(res, a * 2.);
+
+        std::size_t elements = 0;
+        for (const auto& t : events_named("pool_task"))
+        {
+            elements += t.elements;
+        }
+        EXPECT_EQ(elements, events_named("parallel_policy").at(0).elements);
+    }
+
+    TEST(xtask_tracing, chrome_trace)
+    {
+        xthread_pool pool(1);
+        tracing_guard guard;
+        exec::par(pool, 0, 10).for_range(0, 20, 1, [](std::size_t, std::size_t) {});
+        task_tracing::disable();
+        std::ostringstream out;
+        task_tracing::write_chrome_trace(out);
+        std::string trace = out.str();
+        EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+        EXPECT_TRUE(trace.find("{\"name\":\"parallel_policy\",\"cat\":\"xtensor\",\"ph\":\"X\"") != std::string::npos);
+        EXPECT_TRUE(trace.find("\"args\":{\"elements\":20}}") != std::string::npos);
+        EXPECT_TRUE(trace.find("\"args\":{\"elements\":10}}") != std::string::npos);
+        EXPECT_EQ(trace.substr(trace.size() - 3), std::string("]}\n"));
+    }
+#endif
+}
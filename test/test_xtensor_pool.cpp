@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <utility>
+
+#include "test_common_macros.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor_pool.hpp"
+
+namespace xt
+{
+    TEST(tensor_pool, reuse)
+    {
+        using pool_type = tensor_pool<float, 3>;
+        pool_type pool;
+        pool_type::shape_type shape = {2, 3, 4};
+        xtensor<float, 3> input = ones<float>(shape);
+
+        const float* data = nullptr;
+        {
+            auto t = pool.acquire(shape, 2.f);
+            EXPECT_EQ(t.shape(), shape);
+            EXPECT_EQ(t(1, 2, 3), 2.f);
+            data = t.data();
+            EXPECT_EQ(pool.cached(), 0u);
+        }
+        EXPECT_EQ(pool.cached(), 1u);
+
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            auto t = pool.acquire(shape);
+            EXPECT_EQ(t.data(), data);
+            noalias(t) = input + static_cast<float>(i);
+            EXPECT_EQ(t.data(), data);
+            EXPECT_EQ(t(1, 1, 1), 1.f + static_cast<float>(i));
+        }
+
+        // Copies and moves keep their buffers in the pool
+        {
+            auto t = pool.acquire(shape, 1.f);
+            auto u = t;
+            EXPECT_TRUE(u.data() != t.data());
+            EXPECT_TRUE(u.storage().get_allocator() == pool.get_allocator());
+            auto w = std::move(t);
+            EXPECT_EQ(w.data(), data);
+        }
+        EXPECT_EQ(pool.cached(), 2u);
+
+        // Pooled buffers are keyed by size
+        auto other = pool.acquire({4, 3, 2});
+        EXPECT_EQ(pool.cached(), 1u);
+        pool.release();
+        EXPECT_EQ(pool.cached(), 0u);
+        pool.reserve({1, 5, 5}, 3);
+        EXPECT_EQ(pool.cached(), 3u);
+    }
+
+    TEST(tensor_pool, max_cached)
+    {
+        tensor_pool<double, 2> pool(1);
+        {
+            auto a = pool.acquire({3, 3});
+            auto b = pool.acquire({3, 3});
+        }
+        EXPECT_EQ(pool.cached(), 1u);
+
+        // Tensors may outlive their pool
+        tensor_pool<double, 2>::tensor_type t;
+        {
+            tensor_pool<double, 2> local;
+            t = local.acquire({2, 2}, 1.);
+        }
+        t.resize({4, 4});
+        t.fill(2.);
+        EXPECT_EQ(t(3, 3), 2.);
+    }
+}
@@ -11,6 +11,9 @@
 #include <type_traits>
 #include <tuple>
 #include <complex>
+#include <string>
+#include <typeindex>
+#include <vector>
 
 #include "test_common_macros.hpp"
 #include "test_common_macros.hpp"
@@ -222,6 +225,53 @@ namespace xt
         XT_EXPECT_NO_THROW(arr_t c = a);
     }
 
+    TEST(utils, allocation_statistics)
+    {
+        using arr_t = xarray<double, layout_type::row_major,
+                             tracking_allocator<double, std::allocator<double>, alloc_tracking::policy::count>>;
+        using int_arr_t = xarray<int, layout_type::row_major,
+                                 tracking_allocator<int, std::allocator<int>, alloc_tracking::policy::count>>;
+
+        std::vector<std::string> tags;
+        alloc_tracking::reset_stats();
+        alloc_tracking::set_callback([&tags](const alloc_tracking::event& e)
+        {
+            if (!e.deallocation && *e.type == typeid(double))
+            {
+                tags.push_back(e.tag == nullptr ? "" : e.tag);
+            }
+        });
+        alloc_tracking::enable();
+        {
+            arr_t a = {{1, 2, 3}, {5, 6, 7}};
+            {
+                alloc_tracking::scoped_tag tag("stage");
+                arr_t b = a + 1.;
+                int_arr_t c = {1, 2};
+            }
+            auto s = alloc_tracking::stats();
+            EXPECT_EQ(s.allocations, 3u);
+            EXPECT_EQ(s.deallocations, 2u);
+            EXPECT_EQ(s.allocated_bytes, 12 * sizeof(double) + 2 * sizeof(int));
+            EXPECT_EQ(s.live_bytes, 6 * sizeof(double));
+            EXPECT_EQ(s.peak_live_bytes, 12 * sizeof(double) + 2 * sizeof(int));
+        }
+        alloc_tracking::disable();
+        alloc_tracking::set_callback(alloc_tracking::callback_type());
+
+        EXPECT_EQ(alloc_tracking::stats().live_bytes, 0u);
+        auto by_type = alloc_tracking::type_stats();
+        EXPECT_EQ(by_type[std::type_index(typeid(double))].allocations, 2u);
+        EXPECT_EQ(by_type[std::type_index(typeid(int))].allocated_bytes, 2 * sizeof(int));
+        auto by_tag = alloc_tracking::tag_stats();
+        EXPECT_EQ(by_tag.size(), 1u);
+        EXPECT_EQ(by_tag["stage"].allocations, 2u);
+        EXPECT_EQ(tags, std::vector<std::string>({"", "stage"}));
+
+        alloc_tracking::reset_stats();
+        EXPECT_EQ(alloc_tracking::stats().allocations, 0u);
+    }
+
     TEST(utils, static_dimension)
     {
         std::ptrdiff_t sdim = static_dimension<std::vector<int>>::value;
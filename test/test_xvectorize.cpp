@@ -69,4 +69,25 @@ namespace xt
         a = vecfunc();
         EXPECT_EQ(size_t(0), a.dimension());
     }
+
+    TEST(xvectorize, generic_lambda)
+    {
+        auto lambda = [](const auto& d1, const auto& d2) -> decltype(d1 * d2 + d1) { return d1 * d2 + d1; };
+        auto vec_lambda = vectorize(lambda);
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {2., 3., 4.};
+        xarray<double> c = vec_lambda(a, b);
+        xarray<double> expected = {{3., 8., 15.}, {12., 20., 30.}};
+        EXPECT_EQ(expected, c);
+
+        using functor_type = typename decltype(vec_lambda(a, b))::functor_type;
+        EXPECT_TRUE((has_simd_apply<functor_type, double>::value));
+    }
+
+    TEST(xvectorize, scalar_lambda)
+    {
+        auto lambda = [](double d1, double d2) { return d1 + d2; };
+        using functor_type = typename decltype(vectorize(lambda)(std::declval<xarray<double>&>(), 1.))::functor_type;
+        EXPECT_FALSE((has_simd_apply<functor_type, double>::value));
+    }
 }
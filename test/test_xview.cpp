@@ -1406,6 +1406,31 @@ namespace xt
         EXPECT_EQ(arr(1, 0), 100.0);
     }
 
+    TEST(xview, assign_scalar_to_runtime_contiguous_view)
+    {
+        xt::xtensor<double, 3> arr = xt::zeros<double>({3, 4, 5});
+
+        // The trailing range covers its dimension, the view is contiguous
+        auto full = xt::view(arr, 1, xt::all(), xt::range(0, 5));
+        EXPECT_EQ(decltype(full)::static_layout, layout_type::dynamic);
+        EXPECT_TRUE(full.is_contiguous());
+        full = 2.;
+        full += 1.;
+        full *= 2.;
+        EXPECT_TRUE(std::all_of(full.cbegin(), full.cend(), [](double d) { return d == 6.; }));
+        EXPECT_EQ(arr(0, 3, 4), 0.);
+        EXPECT_EQ(arr(2, 0, 0), 0.);
+
+        auto partial = xt::view(arr, 2, xt::all(), xt::range(1, 3));
+        EXPECT_FALSE(partial.is_contiguous());
+        partial = 1.;
+        partial -= 3.;
+        EXPECT_TRUE(std::all_of(partial.cbegin(), partial.cend(), [](double d) { return d == -2.; }));
+        EXPECT_EQ(arr(2, 0, 0), 0.);
+        EXPECT_EQ(arr(2, 3, 2), -2.);
+        EXPECT_EQ(arr(2, 3, 3), 0.);
+    }
+
     TEST(xview, keep_assign)
     {
         xt::xtensor<int, 2> a = { {1, 2, 3, 4},
@@ -1435,6 +1460,36 @@ namespace xt
         EXPECT_EQ(assgment, expv);
     }
 
+    TEST(xview, nested_view_access)
+    {
+        xt::xarray<int> a = xt::arange<int>(4 * 6 * 8).reshape({4, 6, 8});
+        auto v1 = xt::view(a, xt::range(1, 4), xt::range(5, 0, -2), xt::all());
+        auto v2 = xt::view(v1, xt::all(), 1, xt::range(2, 8, 3));
+        auto v3 = xt::view(v2, 1);
+
+        EXPECT_EQ(v2.shape(), (std::vector<std::size_t>{3, 2}));
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t k = 0; k < 2; ++k)
+            {
+                int expected = a(i + 1, 3, 2 + 3 * k);
+                EXPECT_EQ(v2(i, k), expected);
+                EXPECT_EQ(v2.unchecked(i, k), expected);
+            }
+        }
+        EXPECT_EQ(v3(1), a(2, 3, 5));
+        // Extra indices are dropped
+        EXPECT_EQ(v2(5, 2, 1), a(3, 3, 5));
+
+        v2(2, 1) = -1;
+        EXPECT_EQ(a(3, 3, 5), -1);
+
+        xt::xtensor<int, 3> t = a;
+        const auto& ct = t;
+        auto cv = xt::view(xt::view(ct, xt::range(1, 3)), xt::all(), 2);
+        EXPECT_EQ(cv(1, 4), t(2, 2, 4));
+    }
+
     TEST(xview, view_on_fixed)
     {
         xt::xtensor_fixed<double, xt::xshape<3>> a{1./8, 1, -1./8};
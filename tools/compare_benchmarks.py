@@ -0,0 +1,199 @@
+#!/usr/bin/env python
+
+# Stores the JSON results of benchmark_xtensor as per machine baselines and
+# compares new results against them.
+#
+#   benchmark_xtensor --benchmark_repetitions=10 \
+#       --benchmark_out=results.json --benchmark_out_format=json
+#   compare_benchmarks.py save results.json
+#   compare_benchmarks.py compare results.json
+#
+# A benchmark regresses when its median time grows by more than the
+# threshold and a Mann-Whitney U test over the repetitions rejects the
+# hypothesis that both runs have the same distribution. With less than
+# MIN_REPETITIONS repetitions only the threshold is checked.
+#
+# The xtensor benchmarks are also compared with the raw loop or std::
+# reference of the same run (e.g. xview_access_calc with raw_access_calc),
+# and a regression of that ratio is reported as well: it is less sensitive
+# to the state of the machine than the absolute timings.
+
+import argparse
+import json
+import math
+import os
+import re
+import shutil
+import sys
+
+MIN_REPETITIONS = 5
+
+# (xtensor benchmark, reference) name patterns; the reference name is
+# obtained by substitution and must exist in the same results.
+REFERENCE_RULES = [
+    (r'_x_', r'_c_'),
+    (r'^xview_access', r'raw_access'),
+    (r'^unchecked_access', r'raw_access'),
+    (r'^simplearray_access', r'raw_access'),
+    (r'^jumping_access_unchecked', r'jumping_access_simplearray'),
+]
+
+AGGREGATE_SUFFIXES = ('_mean', '_median', '_stddev', '_cv')
+
+
+def machine_id(results):
+    context = results.get('context', {})
+    name = '%s-%scpu-%smhz' % (context.get('host_name', 'unknown'),
+                               context.get('num_cpus', 0),
+                               int(context.get('mhz_per_cpu', 0)))
+    return re.sub(r'[^A-Za-z0-9_.-]', '_', name)
+
+
+def load_samples(path):
+    """Returns the machine id of the results and the real times of the
+    repetitions of each benchmark, in nanoseconds."""
+    with open(path) as fp:
+        results = json.load(fp)
+    units = {'ns': 1., 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    samples = {}
+    for b in results.get('benchmarks', []):
+        if b.get('run_type', 'iteration') != 'iteration' or b.get('error_occurred'):
+            continue
+        name = b.get('run_name', b['name'])
+        if 'run_type' not in b and name.endswith(AGGREGATE_SUFFIXES):
+            continue
+        time = b['real_time'] * units[b.get('time_unit', 'ns')]
+        samples.setdefault(name, []).append(time)
+    return machine_id(results), samples
+
+
+def median(values):
+    v = sorted(values)
+    n = len(v)
+    return v[n // 2] if n % 2 else 0.5 * (v[n // 2 - 1] + v[n // 2])
+
+
+def mann_whitney_p(a, b):
+    """Two-sided p-value of the Mann-Whitney U test, normal approximation
+    with tie correction."""
+    n1, n2 = len(a), len(b)
+    values = sorted([(x, 0) for x in a] + [(x, 1) for x in b])
+    ranks = [0.] * len(values)
+    ties = 0.
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = 0.5 * (i + j) + 1.
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+    r1 = sum(r for r, (_, g) in zip(ranks, values) if g == 0)
+    u = r1 - n1 * (n1 + 1) / 2.
+    n = n1 + n2
+    sigma2 = n1 * n2 / 12. * ((n + 1) - ties / (n * (n - 1)))
+    if sigma2 <= 0.:
+        return 1.
+    z = (abs(u - n1 * n2 / 2.) - 0.5) / math.sqrt(sigma2)
+    return math.erfc(max(z, 0.) / math.sqrt(2.))
+
+
+def compare_samples(old, new, threshold, alpha):
+    """Returns the relative change of the medians and whether it is a
+    significant regression."""
+    change = median(new) / median(old) - 1.
+    if change <= threshold:
+        return change, None, False
+    if len(old) < MIN_REPETITIONS or len(new) < MIN_REPETITIONS:
+        return change, None, True
+    p = mann_whitney_p(old, new)
+    return change, p, p < alpha
+
+
+def reference_of(name, samples):
+    base, sep, args = name.partition('/')
+    for pattern, repl in REFERENCE_RULES:
+        if re.search(pattern, base):
+            ref = re.sub(pattern, repl, base, count=1) + sep + args
+            if ref in samples and ref != name:
+                return ref
+    return None
+
+
+def baseline_path(args, machine):
+    return os.path.join(args.baselines, (args.machine or machine) + '.json')
+
+
+def save(args):
+    machine, _ = load_samples(args.results)
+    path = baseline_path(args, machine)
+    if not os.path.isdir(args.baselines):
+        os.makedirs(args.baselines)
+    shutil.copyfile(args.results, path)
+    print('Saved baseline %s' % path)
+    return 0
+
+
+def compare(args):
+    machine, new = load_samples(args.results)
+    path = baseline_path(args, machine)
+    if not os.path.exists(path):
+        print('No baseline for %s, run "save" first' % (args.machine or machine))
+        return 2
+    _, old = load_samples(path)
+
+    regressions = []
+    rows = []
+    for name in sorted(set(old) & set(new)):
+        change, p, regressed = compare_samples(old[name], new[name], args.threshold, args.alpha)
+        ref = reference_of(name, new)
+        ratio = ''
+        if ref is not None and ref in old:
+            old_ratio = [x / median(old[ref]) for x in old[name]]
+            new_ratio = [x / median(new[ref]) for x in new[name]]
+            rchange, _, rregressed = compare_samples(old_ratio, new_ratio, args.threshold, args.alpha)
+            ratio = '%.2fx %s %+.1f%%' % (median(new_ratio), ref, 100. * rchange)
+            if rregressed:
+                regressions.append('%s (relative to %s)' % (name, ref))
+        if regressed:
+            regressions.append(name)
+        rows.append((name, median(old[name]), median(new[name]), change, p, regressed, ratio))
+
+    width = max([len(r[0]) for r in rows] + [9])
+    print('%-*s %14s %14s %9s %8s  %s' % (width, 'Benchmark', 'Baseline (ns)', 'Current (ns)',
+                                           'Change', 'p-value', 'vs reference'))
+    for name, o, n, change, p, regressed, ratio in rows:
+        print('%-*s %14.1f %14.1f %+8.1f%% %8s  %s%s' % (width, name, o, n, 100. * change,
+                                                        '-' if p is None else '%.3f' % p,
+                                                        ratio, '  REGRESSION' if regressed else ''))
+    for name in sorted(set(new) - set(old)):
+        print('%-*s %14s %14.1f' % (width, name, 'new', median(new[name])))
+
+    if regressions:
+        print('\n%d regression(s):' % len(regressions))
+        for r in regressions:
+            print('  ' + r)
+        return 1
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark baselines and regression gate')
+    parser.add_argument('command', choices=['save', 'compare'])
+    parser.add_argument('results', help='JSON output of benchmark_xtensor')
+    parser.add_argument('--baselines', default='benchmark_baselines',
+                        help='directory of the per machine baselines')
+    parser.add_argument('--machine', default=None,
+                        help='machine name, derived from the results context by default')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='minimal relative slowdown of the median reported as a regression')
+    parser.add_argument('--alpha', type=float, default=0.05,
+                        help='significance level of the Mann-Whitney U test')
+    args = parser.parse_args()
+    return save(args) if args.command == 'save' else compare(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())